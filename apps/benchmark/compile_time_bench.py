@@ -0,0 +1,193 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the compile time of a fixed corpus of models, per phase of the pipeline.
+
+Every model is built from scratch with relay.build and the VM compiler, each in a fresh process
+so that the peak memory is that of the build alone. The passes are profiled with the PassProfiler
+instrument, and their exclusive times are attributed to:
+
+  - relay_passes: the Relay passes, e.g. FuseOps or FoldConstant;
+  - te_lowering: the TECompiler lowering of the primitive functions to TIR, i.e. LowerTensorExpr
+    without the TIR passes it runs;
+  - tir_passes: the TIR passes, summed over the threads the lowering runs them on;
+  - codegen_and_other: the rest of the build, mostly the LLVM code generation.
+
+The frontend time is that of constructing the Relay module and its parameters. Use the output
+of "--output" as the "--baseline" of a later run to report the builds more than the tolerance
+slower, with a non-zero exit code.
+"""
+import argparse
+import json
+import multiprocessing
+import resource
+import sys
+import time
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+from tvm.ir.instrument import PassProfiler
+
+
+def bert(num_layers=4, seq_len=128, hidden=768, heads=12):
+    """A BERT encoder built from the Relay ops, as the frontends import it"""
+    head_dim = hidden // heads
+
+    def weight(name, shape):
+        return relay.var(name, shape=shape)
+
+    def layer_norm(x, name):
+        gamma, beta = weight(name + "_gamma", (hidden,)), weight(name + "_beta", (hidden,))
+        return relay.nn.layer_norm(x, gamma, beta)
+
+    def split_heads(x):
+        return relay.transpose(relay.reshape(x, (seq_len, heads, head_dim)), (1, 0, 2))
+
+    x = relay.var("data", shape=(seq_len, hidden))
+    for i in range(num_layers):
+        name = "layer%d" % i
+        q, k, v = [
+            split_heads(relay.nn.dense(x, weight("%s_w%s" % (name, n), (hidden, hidden))))
+            for n in "qkv"
+        ]
+        scores = relay.nn.batch_matmul(q, k) * relay.const(1 / head_dim ** 0.5)
+        context = relay.nn.batch_matmul(relay.nn.softmax(scores), relay.transpose(v, (0, 2, 1)))
+        context = relay.reshape(relay.transpose(context, (1, 0, 2)), (seq_len, hidden))
+        x = layer_norm(x + relay.nn.dense(context, weight(name + "_wo", (hidden, hidden))), name)
+        ffn = relay.nn.dense(x, weight(name + "_w1", (4 * hidden, hidden)))
+        ffn = ffn * relay.sigmoid(ffn * relay.const(1.702))
+        ffn = relay.nn.dense(ffn, weight(name + "_w2", (hidden, 4 * hidden)))
+        x = layer_norm(x + ffn, name + "_ffn")
+    return testing.create_workload(relay.Function(relay.analysis.free_vars(x), x))
+
+
+MODELS = {
+    "resnet-18": lambda: testing.resnet.get_workload(num_layers=18),
+    "resnet-50": lambda: testing.resnet.get_workload(num_layers=50),
+    "mobilenet": testing.mobilenet.get_workload,
+    "bert": bert,
+    "lstm": lambda: testing.lstm.get_workload(iterations=8, num_hidden=512),
+}
+
+
+def attribute_phases(trace):
+    """Sum the exclusive times of the passes of a Chrome trace by phase, in seconds"""
+    events = sorted(trace["traceEvents"], key=lambda e: (e["tid"], e["ts"], -e["dur"]))
+    phases = {"relay_passes": 0.0, "te_lowering": 0.0, "tir_passes": 0.0}
+    main_tid = min(events, key=lambda e: e["ts"])["tid"] if events else 0
+    main_total = 0.0
+    stack = []
+    for event in events:
+        while stack and (
+            stack[-1]["tid"] != event["tid"] or stack[-1]["ts"] + stack[-1]["dur"] <= event["ts"]
+        ):
+            stack.pop()
+        if stack:
+            # The exclusive time of the parent excludes the child, on the same thread.
+            stack[-1]["self"] -= event["dur"]
+        elif event["tid"] == main_tid:
+            main_total += event["dur"]
+        event["self"] = event["dur"]
+        stack.append(event)
+    for event in events:
+        name = event["name"]
+        if name.startswith("tir."):
+            phase = "tir_passes"
+        elif name == "LowerTensorExpr":
+            phase = "te_lowering"
+        else:
+            phase = "relay_passes"
+        phases[phase] += event["self"] * 1e-6
+    return phases, main_total * 1e-6
+
+
+def compile_model(args):
+    """Build a model with an executor in this process, returning the record of the build"""
+    name, executor, target = args
+    tic = time.time()
+    mod, params = MODELS[name]()
+    frontend = time.time() - tic
+
+    profiler = PassProfiler(count_nodes=False)
+    tic = time.time()
+    with tvm.transform.PassContext(opt_level=3, instruments=[profiler]):
+        if executor == "graph":
+            relay.build(mod, target=target, params=params)
+        else:
+            relay.vm.compile(mod, target=target, params=params)
+    total = time.time() - tic
+    phases, passes_total = attribute_phases(json.loads(profiler.chrome_trace()))
+    record = {"model": name, "executor": executor, "target": target, "frontend": frontend}
+    record.update(phases)
+    record["codegen_and_other"] = max(0.0, total - passes_total)
+    record["total"] = total
+    record["peak_rss_kb"] = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return record
+
+
+def run_isolated(name, executor, target):
+    # A fresh process per build, for the peak memory and to start from cold caches.
+    with multiprocessing.get_context("spawn").Pool(1) as pool:
+        return pool.apply(compile_model, ((name, executor, target),))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--models", type=str, nargs="*", default=None, help="Default to all")
+    parser.add_argument("--executors", type=str, nargs="*", default=["graph", "vm"])
+    parser.add_argument("--output", type=str, default=None, help="Save the records as JSON")
+    parser.add_argument("--baseline", type=str, default=None, help="Records to compare to")
+    parser.add_argument("--tolerance", type=float, default=0.1)
+    args = parser.parse_args()
+
+    columns = ["frontend", "relay_passes", "te_lowering", "tir_passes", "codegen_and_other"]
+    print(
+        "%-10s %-6s " % ("Model", "Exec")
+        + " ".join("%12s" % c[:12] for c in columns + ["total"])
+        + " %10s" % "peak MB"
+    )
+    records = []
+    for name in args.models or list(MODELS):
+        for executor in args.executors:
+            record = run_isolated(name, executor, args.target)
+            records.append(record)
+            print(
+                "%-10s %-6s " % (name, executor)
+                + " ".join("%12.2f" % record[c] for c in columns + ["total"])
+                + " %10.0f" % (record["peak_rss_kb"] / 1024)
+            )
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(records, f, indent=2)
+    if args.baseline:
+        with open(args.baseline) as f:
+            previous = {(r["model"], r["executor"]): r["total"] for r in json.load(f)}
+        regressions = [
+            r
+            for r in records
+            if (r["model"], r["executor"]) in previous
+            and r["total"] > previous[(r["model"], r["executor"])] * (1 + args.tolerance)
+        ]
+        for r in regressions:
+            print(
+                "Regression: %s (%s) %.2f s vs %.2f s"
+                % (r["model"], r["executor"], r["total"], previous[(r["model"], r["executor"])])
+            )
+        if regressions:
+            sys.exit(1)
@@ -0,0 +1,291 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime_bench.cc
+ * \brief End-to-end inference benchmark of the C++ runtime, without Python or RPC.
+ *
+ * Loads a model exported by `tvm.relay.build` (graph executor) or `tvm.relay.vm.compile` (VM)
+ * and reports the cold start time, the latency percentiles of one client, the throughput of N
+ * concurrent clients and the peak resident memory, as one JSON object on stdout.
+ *
+ * Usage:
+ *   runtime_bench --lib model.so [--executor graph|vm] [--code model.ro] [--params model.params]
+ *                 [--input name:1x3x224x224:float32]... [--device-type 1] [--device-id 0]
+ *                 [--warmup 10] [--iters 100] [--clients 1] [--threads 0] [--affinity 1]
+ *                 [--schedule static|work_stealing]
+ */
+#include <dlpack/dlpack.h>
+#include <sys/resource.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tvm::runtime;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct InputSpec {
+  std::string name;
+  std::vector<int64_t> shape;
+  DLDataType dtype;
+};
+
+struct Options {
+  std::string executor = "graph";
+  std::string lib;
+  std::string code;
+  std::string params;
+  std::vector<InputSpec> inputs;
+  int device_type = kDLCPU;
+  int device_id = 0;
+  int warmup = 10;
+  int iters = 100;
+  int clients = 1;
+  int threads = 0;
+  int affinity = 1;
+  std::string schedule = "static";
+};
+
+double Seconds(Clock::time_point tic) {
+  return std::chrono::duration<double>(Clock::now() - tic).count();
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream fs(path, std::ios::in | std::ios::binary);
+  ICHECK(!fs.fail()) << "Cannot open " << path;
+  return std::string(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+}
+
+// Parse "name:1x3x224x224:float32".
+InputSpec ParseInput(const std::string& spec) {
+  size_t first = spec.find(':');
+  size_t last = spec.rfind(':');
+  ICHECK(first != std::string::npos && last != first) << "Invalid input " << spec;
+  InputSpec input;
+  input.name = spec.substr(0, first);
+  std::istringstream shape(spec.substr(first + 1, last - first - 1));
+  for (std::string dim; std::getline(shape, dim, 'x');) {
+    input.shape.push_back(std::stoll(dim));
+  }
+  input.dtype = String2DLDataType(spec.substr(last + 1));
+  return input;
+}
+
+Options ParseOptions(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string key = argv[i];
+    ICHECK(i + 1 < argc) << "Missing the value of " << key;
+    std::string value = argv[++i];
+    if (key == "--executor") {
+      opts.executor = value;
+    } else if (key == "--lib") {
+      opts.lib = value;
+    } else if (key == "--code") {
+      opts.code = value;
+    } else if (key == "--params") {
+      opts.params = value;
+    } else if (key == "--input") {
+      opts.inputs.push_back(ParseInput(value));
+    } else if (key == "--device-type") {
+      opts.device_type = std::stoi(value);
+    } else if (key == "--device-id") {
+      opts.device_id = std::stoi(value);
+    } else if (key == "--warmup") {
+      opts.warmup = std::stoi(value);
+    } else if (key == "--iters") {
+      opts.iters = std::stoi(value);
+    } else if (key == "--clients") {
+      opts.clients = std::stoi(value);
+    } else if (key == "--threads") {
+      opts.threads = std::stoi(value);
+    } else if (key == "--affinity") {
+      opts.affinity = std::stoi(value);
+    } else if (key == "--schedule") {
+      opts.schedule = value;
+    } else {
+      LOG(FATAL) << "Unknown option " << key;
+    }
+  }
+  ICHECK(!opts.lib.empty()) << "--lib is required";
+  ICHECK(opts.executor == "graph" || opts.executor == "vm")
+      << "Unknown executor " << opts.executor << ", expected graph or vm";
+  ICHECK(opts.executor != "vm" || !opts.code.empty()) << "--code is required by the VM";
+  ICHECK_GT(opts.iters, 0);
+  ICHECK_GT(opts.clients, 0);
+  return opts;
+}
+
+// A zero-filled input, copied to the device.
+NDArray MakeInput(const InputSpec& input, Device dev) {
+  NDArray cpu = NDArray::Empty(input.shape, input.dtype, {kDLCPU, 0});
+  size_t nbytes = GetDataSize(*cpu.operator->());
+  std::fill_n(static_cast<char*>(cpu->data), nbytes, 0);
+  return cpu.CopyTo(dev);
+}
+
+/*! \brief One executor instance, used by a single client thread. */
+class Session {
+ public:
+  Session(const Options& opts, Module lib, const std::string& code, const std::string& params)
+      : dev_{static_cast<DLDeviceType>(opts.device_type), opts.device_id} {
+    if (opts.executor == "graph") {
+      PackedFunc create = lib.GetFunction("default");
+      ICHECK(create != nullptr) << "The library has no graph executor factory";
+      executor_ = create(dev_);
+      if (!params.empty()) {
+        executor_.GetFunction("load_params")(TVMByteArray{params.data(), params.size()});
+      }
+      PackedFunc set_input = executor_.GetFunction("set_input");
+      for (const InputSpec& input : opts.inputs) {
+        set_input(input.name, MakeInput(input, dev_));
+      }
+      run_ = executor_.GetFunction("run");
+    } else {
+      Module exec = (*Registry::Get("runtime.Load_Executable"))(code, lib);
+      executor_ = (*Registry::Get("runtime._VirtualMachine"))(exec);
+      // The pooled allocator, as in deployment.
+      executor_.GetFunction("init")(opts.device_type, opts.device_id, 2);
+      int arity = exec.GetFunction("get_function_arity")("main");
+      PackedFunc param_name = exec.GetFunction("get_function_param_name");
+      std::vector<NDArray> args;
+      for (int i = 0; i < arity; ++i) {
+        std::string name = param_name("main", i);
+        auto it = std::find_if(opts.inputs.begin(), opts.inputs.end(),
+                               [&](const InputSpec& input) { return input.name == name; });
+        ICHECK(it != opts.inputs.end()) << "Missing the --input of " << name;
+        args.push_back(MakeInput(*it, dev_));
+      }
+      std::vector<TVMValue> values(arity + 1);
+      std::vector<int> codes(arity + 1);
+      TVMArgsSetter setter(values.data(), codes.data());
+      std::string main = "main";
+      setter(0, main);
+      for (int i = 0; i < arity; ++i) {
+        setter(i + 1, args[i]);
+      }
+      TVMRetValue rv;
+      executor_.GetFunction("set_input").CallPacked(TVMArgs(values.data(), codes.data(), arity + 1),
+                                                    &rv);
+      PackedFunc invoke = executor_.GetFunction("invoke");
+      run_ = PackedFunc([invoke](TVMArgs args, TVMRetValue* rv) { invoke("main"); });
+    }
+  }
+
+  /*! \brief Run one inference, waiting for the device. */
+  void Run() {
+    run_();
+    TVMSynchronize(dev_.device_type, dev_.device_id, nullptr);
+  }
+
+ private:
+  Device dev_;
+  Module executor_;
+  PackedFunc run_;
+};
+
+void ConfigThreadPool(const Options& opts) {
+  // The thread pool is per client thread.
+  (*Registry::Get("runtime.config_threadpool"))(opts.affinity, opts.threads, opts.schedule);
+}
+
+double Percentile(const std::vector<double>& sorted, double q) {
+  size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+  return sorted[index];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts = ParseOptions(argc, argv);
+  ConfigThreadPool(opts);
+
+  // Cold start: loading the library, creating the executor and the first inference.
+  Clock::time_point tic = Clock::now();
+  Module lib = Module::LoadFromFile(opts.lib);
+  std::string code = opts.code.empty() ? "" : ReadFile(opts.code);
+  std::string params = opts.params.empty() ? "" : ReadFile(opts.params);
+  std::unique_ptr<Session> session(new Session(opts, lib, code, params));
+  session->Run();
+  double cold_start = Seconds(tic);
+
+  for (int i = 0; i < opts.warmup; ++i) {
+    session->Run();
+  }
+  std::vector<double> latencies;
+  for (int i = 0; i < opts.iters; ++i) {
+    tic = Clock::now();
+    session->Run();
+    latencies.push_back(Seconds(tic));
+  }
+  std::sort(latencies.begin(), latencies.end());
+  double mean = 0;
+  for (double latency : latencies) mean += latency / latencies.size();
+
+  // Throughput: every client runs its own executor on the shared library.
+  std::vector<std::unique_ptr<Session>> sessions;
+  sessions.push_back(std::move(session));
+  for (int i = 1; i < opts.clients; ++i) {
+    sessions.emplace_back(new Session(opts, lib, code, params));
+  }
+  std::vector<std::thread> clients;
+  tic = Clock::now();
+  for (int i = 0; i < opts.clients; ++i) {
+    clients.emplace_back([&opts, &sessions, i]() {
+      ConfigThreadPool(opts);
+      for (int j = 0; j < opts.warmup + opts.iters; ++j) {
+        sessions[i]->Run();
+      }
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  double throughput = opts.clients * (opts.warmup + opts.iters) / Seconds(tic);
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  std::cout << "{\"executor\": \"" << opts.executor << "\", \"cold_start_ms\": " << cold_start * 1e3
+            << ", \"mean_ms\": " << mean * 1e3
+            << ", \"p50_ms\": " << Percentile(latencies, 0.5) * 1e3
+            << ", \"p90_ms\": " << Percentile(latencies, 0.9) * 1e3
+            << ", \"p99_ms\": " << Percentile(latencies, 0.99) * 1e3
+            << ", \"max_ms\": " << latencies.back() * 1e3 << ", \"clients\": " << opts.clients
+            << ", \"throughput_per_s\": " << throughput
+            << ", \"peak_rss_kb\": " << usage.ru_maxrss << "}" << std::endl;
+  return 0;
+}
@@ -0,0 +1,71 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the row reductions of softmax and layer_norm over row lengths.
+
+The rows are reduced across the threads of a block, with warp shuffles within a warp
+and, for the blocks of several warps, through shared memory between the warps.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def build(op, rows, cols, target):
+    x = relay.var("x", shape=(rows, cols))
+    if op == "softmax":
+        y = relay.nn.softmax(x)
+    else:
+        gamma = relay.const(np.ones((cols,), dtype="float32"))
+        beta = relay.const(np.zeros((cols,), dtype="float32"))
+        y = relay.nn.layer_norm(x, gamma, beta)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    with tvm.transform.PassContext(opt_level=3):
+        return relay.build(mod, target=target)
+
+
+def benchmark(lib, rows, cols, dev, number, repeat):
+    module = graph_executor.GraphModule(lib["default"](dev))
+    module.set_input("x", np.random.uniform(size=(rows, cols)).astype("float32"))
+    timer = module.module.time_evaluator("run", dev, number=number, repeat=repeat)
+    return min(timer().results)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--rows", type=int, default=4096)
+    parser.add_argument(
+        "--cols", type=int, nargs="+", default=[64, 256, 1024, 4096, 16384], help="Row lengths."
+    )
+    parser.add_argument("--target", type=str, default="cuda")
+    parser.add_argument("--number", type=int, default=100)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    dev = tvm.device(args.target, 0)
+    print("%-12s %8s %12s %10s" % ("Op", "Cols", "us/run", "GB/s"))
+    print("-" * 45)
+    for op in ["softmax", "layer_norm"]:
+        for cols in args.cols:
+            lib = build(op, args.rows, cols, args.target)
+            cost = benchmark(lib, args.rows, cols, dev, args.number, args.repeat)
+            # One read and one write of the input.
+            gbps = 2 * args.rows * cols * 4 / cost / 1e9
+            print("%-12s %8d %12.2f %10.1f" % (op, cols, cost * 1e6, gbps))
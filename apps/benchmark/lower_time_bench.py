@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the compile time of the lowering, in PrimFuncs lowered per second.
+
+The workloads are tiled schedules whose index expressions keep the arithmetic simplifier
+busy: a tiled matmul, a tiled conv2d with padding, and a split elementwise tail.
+"""
+import argparse
+import timeit
+
+import tvm
+from tvm import te, topi
+
+
+def matmul(n, tile):
+    A = te.placeholder((n, n), name="A")
+    B = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    C = te.compute((n, n), lambda i, j: te.sum(A[i, k] * B[k, j], axis=k), name="C")
+    s = te.create_schedule(C.op)
+    i, j = s[C].op.axis
+    io, jo, ii, ji = s[C].tile(i, j, tile, tile)
+    ko, ki = s[C].split(s[C].op.reduce_axis[0], factor=tile)
+    s[C].reorder(io, jo, ko, ii, ki, ji)
+    s[C].vectorize(ji)
+    return s, [A, B, C]
+
+
+def conv2d(n, tile):
+    data = te.placeholder((1, 64, n, n), name="data")
+    kernel = te.placeholder((64, 64, 3, 3), name="kernel")
+    out = topi.nn.conv2d_nchw(data, kernel, 1, 1, 1)
+    s = te.create_schedule(out.op)
+    _, c, h, w = s[out].op.axis
+    co, ci = s[out].split(c, factor=tile)
+    ho, wo, hi, wi = s[out].tile(h, w, tile, tile)
+    s[out].reorder(co, ho, wo, ci, hi, wi)
+    s[s[out].op.input_tensors[0]].compute_at(s[out], wo)
+    return s, [data, kernel, out]
+
+
+def elementwise(n, tile):
+    A = te.placeholder((n, n + 3), name="A")
+    B = te.compute(A.shape, lambda i, j: A[i, j] * 2 + 1, name="B")
+    s = te.create_schedule(B.op)
+    fused = s[B].fuse(*s[B].op.axis)
+    _, inner = s[B].split(fused, factor=tile)
+    s[B].vectorize(inner)
+    return s, [A, B]
+
+
+WORKLOADS = {"matmul": matmul, "conv2d": conv2d, "elementwise": elementwise}
+
+
+def lowering_rate(workload, n, tile, repeat):
+    def lower():
+        s, args = WORKLOADS[workload](n, tile)
+        tvm.lower(s, args)
+
+    lower()
+    times = timeit.repeat(lower, number=1, repeat=repeat)
+    return 1.0 / min(times)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--size", type=int, default=224)
+    parser.add_argument("--tile", type=int, default=8)
+    parser.add_argument("--repeat", type=int, default=10)
+    args = parser.parse_args()
+
+    print("%-12s %16s" % ("workload", "PrimFuncs / s"))
+    for name in WORKLOADS:
+        rate = lowering_rate(name, args.size, args.tile, args.repeat)
+        print("%-12s %16.2f" % (name, rate))
@@ -0,0 +1,67 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the per-operator dispatch cost of the graph executor.
+
+The model is a chain of tiny elementwise operators, kept unfused, so the run time is
+dominated by the calls of the operators rather than by their kernels. The operators are
+called on the arguments packed once when the executor is set up, and the time per run is
+divided by the number of operators to estimate the cost of dispatching one of them.
+"""
+import argparse
+import json
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def build(depth):
+    x = relay.var("x", shape=(1, 4), dtype="float32")
+    y = x
+    for i in range(depth):
+        y = relay.add(y, relay.const(float(i)))
+        y = relay.nn.relu(y) if i % 2 else relay.negative(y)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    # opt_level=0 keeps the operators unfused: one packed call per operator.
+    with tvm.transform.PassContext(opt_level=0):
+        return relay.build(mod, target="llvm")
+
+
+def benchmark(lib, number, repeat):
+    module = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    module.set_input("x", np.random.uniform(size=(1, 4)).astype("float32"))
+    module.run()
+    num_ops = sum(node["op"] == "tvm_op" for node in json.loads(lib.get_graph_json())["nodes"])
+    times = timeit.repeat(module.run, number=number, repeat=repeat)
+    return min(times) / number, num_ops
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--depths", type=int, nargs="+", default=[64, 512, 2048])
+    parser.add_argument("--number", type=int, default=100)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("%-10s %10s %12s %10s" % ("Depth", "Operators", "us/run", "ns/op"))
+    print("-" * 45)
+    for depth in args.depths:
+        cost, num_ops = benchmark(build(depth), args.number, args.repeat)
+        print("%-10d %10d %12.2f %10.2f" % (depth, num_ops, cost * 1e6, cost * 1e9 / num_ops))
@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the CPU sort library behind argsort and topk.
+
+The rows are sorted by "tvm.contrib.sort", with one thread and with the whole thread pool,
+against the full stable sort of each row the library used to run, reproduced with numpy.
+Use, e.g., "--rows 1 --length 1000000 --k 100" for a topk over one row of candidates.
+"""
+import argparse
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+
+
+def build(rows, length, k, dtype):
+    data = te.placeholder((rows, length), name="data", dtype=dtype)
+    if k > 0:
+        outs = topi.topk(data, k=k, ret_type="both", dtype="int32")
+    else:
+        outs = [topi.argsort(data, is_ascend=False, dtype="int32")]
+    s = te.create_schedule([out.op for out in outs])
+    return tvm.build(s, [data] + outs, "llvm"), [[int(d) for d in out.shape] for out in outs]
+
+
+def reference(np_data, k):
+    indices = np.argsort(-np_data, axis=-1, kind="stable")
+    return indices[:, :k] if k > 0 else indices
+
+
+def benchmark(func, out_shapes, np_data, k, number, repeat):
+    data = tvm.nd.array(np_data)
+    outs = [tvm.nd.empty(shape, dtype, tvm.cpu()) for shape, dtype in out_shapes]
+    func(data, *outs)
+    np.testing.assert_equal(outs[-1].numpy(), reference(np_data, k))
+    times = timeit.repeat(lambda: func(data, *outs), number=number, repeat=repeat)
+    return min(times) / number
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--rows", type=int, default=4)
+    parser.add_argument("--length", type=int, default=1 << 20)
+    parser.add_argument("--k", type=int, default=100, help="Sort the whole rows if k < 1.")
+    parser.add_argument("--dtype", type=str, default="float32")
+    parser.add_argument("--number", type=int, default=5)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    np_data = np.random.uniform(size=(args.rows, args.length)).astype(args.dtype)
+    func, shapes = build(args.rows, args.length, args.k, args.dtype)
+    dtypes = [args.dtype, "int32"] if args.k > 0 else ["int32"]
+    out_shapes = list(zip(shapes, dtypes))
+    config_threadpool = tvm.get_global_func("runtime.config_threadpool")
+
+    print("%-20s %12s" % ("Sort", "ms/run"))
+    print("-" * 33)
+    times = timeit.repeat(lambda: reference(np_data, args.k), number=args.number, repeat=1)
+    print("%-20s %12.2f" % ("stable sort", min(times) / args.number * 1e3))
+    for name, num_threads in [("tvm, 1 thread", 1), ("tvm, all threads", 0)]:
+        config_threadpool(1, num_threads)
+        cost = benchmark(func, out_shapes, np_data, args.k, args.number, args.repeat)
+        print("%-20s %12.2f" % (name, cost * 1e3))
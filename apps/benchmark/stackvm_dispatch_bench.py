@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the dispatch overhead of the StackVM host interpreter.
+
+The host function launches the no-op "testing.nop" packed function in a loop,
+as the host code of a launch-heavy model does, so the run time is dominated by
+the argument setup and the dispatch of the interpreter. Each mode is compared with the original
+StackVM: no superinstructions and the central switch loop.
+"""
+import argparse
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def build(num_args, superinstructions):
+    n = te.size_var("n")
+    Ab = tvm.tir.decl_buffer((n,), "int64")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n, "i") as i:
+        ib.emit(tvm.tir.call_packed("testing.nop", *[A[i] + k for k in range(num_args)]))
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([Ab], ib.get()).with_attr("global_symbol", "f"))
+    config = {"tir.stackvm_superinstructions": superinstructions}
+    with tvm.transform.PassContext(config=config):
+        return tvm.driver.build(mod, target="stackvm")
+
+
+def benchmark(f, threaded, length, number, repeat):
+    tvm.get_global_func("runtime.StackVMSetThreadedDispatch")(threaded)
+    a = tvm.nd.array(np.zeros(length, dtype="int64"))
+    f(a)
+    times = timeit.repeat(lambda: f(a), number=number, repeat=repeat)
+    return min(times) / number
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--num-args", type=int, default=4, help="The arguments of each call.")
+    parser.add_argument("--length", type=int, default=1000, help="The calls of each run.")
+    parser.add_argument("--number", type=int, default=20)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("%-30s %12s %14s %8s" % ("Mode", "us/run", "ns/call", "speedup"))
+    print("-" * 67)
+    baseline = None
+    for superinstructions, threaded in [(False, False), (False, True), (True, False), (True, True)]:
+        f = build(args.num_args, superinstructions)
+        cost = benchmark(f, threaded, args.length, args.number, args.repeat)
+        baseline = baseline or cost
+        name = "super=%s threaded=%s" % (superinstructions, threaded)
+        print(
+            "%-30s %12.2f %14.2f %7.2fx"
+            % (name, cost * 1e6, cost * 1e9 / args.length, baseline / cost)
+        )
+    tvm.get_global_func("runtime.StackVMSetThreadedDispatch")(True)
@@ -0,0 +1,213 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Microbenchmarks of the TOPI kernels, to catch schedule regressions across commits.
+
+Every registered configuration is a single relay operator, built with the strategy of the
+target, i.e. the default schedules, and with the tuned schedules of an AutoTVM log when one is
+given. The kernels are timed with `time_evaluator` and reported with their achieved GFLOP/s and
+GB/s, the latter counting the compulsory traffic of the inputs and outputs only. Given the peaks
+of the target, the efficiency is the achieved GFLOP/s relative to the roofline bound
+min(peak GFLOP/s, arithmetic intensity * peak GB/s).
+
+Use, e.g., "--target 'llvm -mcpu=skylake-avx512' --peak-gflops 3000 --peak-gbps 100
+--output results.json", then "--baseline results.json" on a later commit to report the kernels
+that got slower by more than the tolerance, with a non-zero exit code.
+"""
+import argparse
+import json
+import sys
+
+import numpy as np
+
+import tvm
+from tvm import autotvm, relay
+from tvm.contrib import graph_executor
+
+# name -> function returning (relay expression, input name -> (shape, dtype), flops)
+BENCHMARKS = {}
+
+
+def register(name):
+    """Register the configuration of a microbenchmark"""
+
+    def _register(func):
+        assert name not in BENCHMARKS, "%s is registered already" % name
+        BENCHMARKS[name] = func
+        return func
+
+    return _register
+
+
+def _var(inputs, name, shape, dtype="float32"):
+    inputs[name] = (shape, dtype)
+    return relay.var(name, shape=shape, dtype=dtype)
+
+
+def _prod(shape):
+    return int(np.prod(shape))
+
+
+def _register_conv2d(name, batch, in_channel, size, out_channel, kernel, stride, padding):
+    @register(name)
+    def _conv2d():
+        inputs = {}
+        data = _var(inputs, "data", (batch, in_channel, size, size))
+        weight = _var(inputs, "weight", (out_channel, in_channel, kernel, kernel))
+        out = relay.nn.conv2d(
+            data,
+            weight,
+            strides=(stride, stride),
+            padding=(padding, padding),
+            channels=out_channel,
+            kernel_size=(kernel, kernel),
+        )
+        out_size = (size + 2 * padding - kernel) // stride + 1
+        flops = 2 * batch * out_channel * out_size * out_size * in_channel * kernel * kernel
+        return out, inputs, flops
+
+
+def _register_dense(name, batch, in_dim, out_dim):
+    @register(name)
+    def _dense():
+        inputs = {}
+        data = _var(inputs, "data", (batch, in_dim))
+        weight = _var(inputs, "weight", (out_dim, in_dim))
+        return relay.nn.dense(data, weight), inputs, 2 * batch * in_dim * out_dim
+
+
+def _register_unary(name, shape, make_op, flops_per_element):
+    @register(name)
+    def _unary():
+        inputs = {}
+        data = _var(inputs, "data", shape)
+        return make_op(data), inputs, flops_per_element * _prod(shape)
+
+
+_register_conv2d("conv2d_resnet_3x3", 1, 64, 56, 64, 3, 1, 1)
+_register_conv2d("conv2d_resnet_1x1", 1, 256, 56, 64, 1, 1, 0)
+_register_conv2d("conv2d_resnet_stride2", 1, 128, 28, 256, 3, 2, 1)
+_register_dense("dense_bert", 128, 768, 3072)
+_register_dense("dense_batch1", 1, 2048, 1000)
+_register_unary("softmax", (128, 1024), lambda x: relay.nn.softmax(x, axis=-1), 5)
+_register_unary("sum_rows", (1024, 1024), lambda x: relay.sum(x, axis=1), 1)
+_register_unary("max_cols", (1024, 1024), lambda x: relay.max(x, axis=0), 1)
+_register_unary("mean_all", (64, 64, 256), relay.mean, 1)
+_register_unary("transpose", (1024, 1024), relay.transpose, 0)
+_register_unary(
+    "layout_transform_nchw16c",
+    (1, 256, 56, 56),
+    lambda x: relay.layout_transform(x, "NCHW", "NCHW16c"),
+    0,
+)
+
+
+def run_benchmark(name, target, records, number, repeat):
+    """Build and time a registered microbenchmark.
+
+    Returns
+    -------
+    result : dict
+        The time in ms, the GFLOP/s and the GB/s of the kernel.
+    """
+    expr, inputs, flops = BENCHMARKS[name]()
+    mod = tvm.IRModule.from_expr(relay.Function(relay.analysis.free_vars(expr), expr))
+    with autotvm.apply_history_best(records):
+        with tvm.transform.PassContext(opt_level=3):
+            lib = relay.build(mod, target=target)
+    dev = tvm.device(str(target), 0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    for input_name, (shape, dtype) in inputs.items():
+        module.set_input(input_name, np.random.uniform(size=shape).astype(dtype))
+    ftimer = module.module.time_evaluator("run", dev, number=number, repeat=repeat)
+    seconds = float(np.median(ftimer().results))
+
+    out_type = mod["main"].checked_type.ret_type
+    nbytes = _prod(out_type.shape) * np.dtype(out_type.dtype).itemsize
+    for shape, dtype in inputs.values():
+        nbytes += _prod(shape) * np.dtype(dtype).itemsize
+    return {
+        "ms": seconds * 1e3,
+        "gflops": flops / seconds / 1e9,
+        "gbps": nbytes / seconds / 1e9,
+        "intensity": flops / nbytes,
+    }
+
+
+def efficiency(result, peak_gflops, peak_gbps):
+    """The achieved GFLOP/s relative to the roofline bound, or the bandwidth for no-flop kernels"""
+    if result["intensity"] == 0:
+        return result["gbps"] / peak_gbps
+    return result["gflops"] / min(peak_gflops, result["intensity"] * peak_gbps)
+
+
+def find_regressions(results, baseline, tolerance):
+    """The (name, schedule, ms, baseline ms) of the kernels slower than the baseline"""
+    previous = {(res["name"], res["schedule"]): res["ms"] for res in baseline}
+    regressions = []
+    for res in results:
+        key = (res["name"], res["schedule"])
+        if key in previous and res["ms"] > previous[key] * (1 + tolerance):
+            regressions.append((res["name"], res["schedule"], res["ms"], previous[key]))
+    return regressions
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--ops", type=str, nargs="*", default=None, help="Default to all of them")
+    parser.add_argument("--tuning-records", type=str, default=None, help="An AutoTVM log")
+    parser.add_argument("--peak-gflops", type=float, default=None)
+    parser.add_argument("--peak-gbps", type=float, default=None)
+    parser.add_argument("--number", type=int, default=10)
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument("--output", type=str, default=None, help="Save the results as JSON")
+    parser.add_argument("--baseline", type=str, default=None, help="Results to compare to")
+    parser.add_argument("--tolerance", type=float, default=0.1)
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target)
+    schedules = [("default", None)]
+    if args.tuning_records:
+        schedules.append(("tuned", args.tuning_records))
+
+    results = []
+    print("%-28s %-8s %10s %10s %10s %6s" % ("Op", "Schedule", "ms", "GFLOP/s", "GB/s", "Eff"))
+    print("-" * 78)
+    for name in args.ops or sorted(BENCHMARKS):
+        for schedule, records in schedules:
+            res = run_benchmark(name, target, records, args.number, args.repeat)
+            res.update({"name": name, "schedule": schedule, "target": str(target)})
+            eff = ""
+            if args.peak_gflops and args.peak_gbps:
+                res["efficiency"] = efficiency(res, args.peak_gflops, args.peak_gbps)
+                eff = "%.2f" % res["efficiency"]
+            results.append(res)
+            print(
+                "%-28s %-8s %10.4f %10.2f %10.2f %6s"
+                % (name, schedule, res["ms"], res["gflops"], res["gbps"], eff)
+            )
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = find_regressions(results, json.load(f), args.tolerance)
+        for name, schedule, ms, baseline_ms in regressions:
+            print("Regression: %s (%s) %.4f ms vs %.4f ms" % (name, schedule, ms, baseline_ms))
+        if regressions:
+            sys.exit(1)
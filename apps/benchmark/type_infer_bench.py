@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the compile time of a Relay pass pipeline under type inference.
+
+Most passes of the pipeline below rewrite a small part of the model and are followed by a type
+inference of the whole module. With "relay.InferType.incremental", the dataflow subexpressions
+typed by the previous inference keep their types, and only the rewritten regions are solved.
+"""
+import argparse
+import timeit
+
+import tvm
+from tvm import relay
+from tvm.relay import testing
+
+
+def pipeline():
+    return tvm.transform.Sequential(
+        [
+            relay.transform.InferType(),
+            relay.transform.SimplifyInference(),
+            relay.transform.FoldConstant(),
+            relay.transform.SimplifyExpr(),
+            relay.transform.FoldScaleAxis(),
+            relay.transform.CanonicalizeOps(),
+            relay.transform.FoldConstant(),
+            relay.transform.EliminateCommonSubexpr(),
+            relay.transform.InferType(),
+        ]
+    )
+
+
+def benchmark(mod, params, incremental, repeat):
+    mod = relay.build_module.bind_params_by_name(mod["main"], params)
+    mod = tvm.IRModule.from_expr(mod)
+    config = {"relay.InferType.incremental": incremental}
+
+    def run():
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            pipeline()(mod)
+
+    return min(timeit.repeat(run, number=1, repeat=repeat))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--model", type=str, default="resnet", choices=["resnet", "mobilenet"])
+    parser.add_argument("--num-layers", type=int, default=50)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    if args.model == "resnet":
+        mod, params = testing.resnet.get_workload(num_layers=args.num_layers)
+    else:
+        mod, params = testing.mobilenet.get_workload()
+
+    print("%-20s %12s" % ("Type inference", "s/pipeline"))
+    print("-" * 33)
+    for name, incremental in [("full", False), ("incremental", True)]:
+        print("%-20s %12.3f" % (name, benchmark(mod, params, incremental, args.repeat)))
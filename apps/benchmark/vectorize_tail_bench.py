@@ -0,0 +1,68 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the tail handling of vectorized loops.
+
+The kernel is an elementwise operator over rows with an odd number of channels,
+vectorized by a split that does not divide the channels. By default the bound check
+of the split scalarizes the whole vectorized loop; with "tir.vectorize_predicate_tail"
+it becomes a masked load and store. Use a target such as
+"llvm -mcpu=skylake-avx512" to get mask registers.
+"""
+import argparse
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def build(rows, channels, lanes, target, predicate_tail):
+    A = te.placeholder((rows, channels), name="A")
+    B = te.compute((rows, channels), lambda i, j: A[i, j] * 2 + 1, name="B")
+    s = te.create_schedule(B.op)
+    _, ji = s[B].split(B.op.axis[1], factor=lanes)
+    s[B].vectorize(ji)
+    with tvm.transform.PassContext(config={"tir.vectorize_predicate_tail": predicate_tail}):
+        return tvm.build(s, [A, B], target)
+
+
+def benchmark(func, rows, channels, number, repeat):
+    a = tvm.nd.array(np.random.uniform(size=(rows, channels)).astype("float32"))
+    b = tvm.nd.array(np.zeros((rows, channels), dtype="float32"))
+    func(a, b)
+    np.testing.assert_allclose(b.numpy(), a.numpy() * 2 + 1, rtol=1e-5)
+    times = timeit.repeat(lambda: func(a, b), number=number, repeat=repeat)
+    return min(times) / number
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--rows", type=int, default=4096)
+    parser.add_argument("--channels", type=int, default=67, help="An odd number of channels.")
+    parser.add_argument("--lanes", type=int, default=16)
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--number", type=int, default=100)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    print("%-20s %12s" % ("Tail", "us/run"))
+    print("-" * 33)
+    for name, predicate_tail in [("scalar", False), ("predicated", True)]:
+        func = build(args.rows, args.channels, args.lanes, args.target, predicate_tail)
+        cost = benchmark(func, args.rows, args.channels, args.number, args.repeat)
+        print("%-20s %12.2f" % (name, cost * 1e6))
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the detection post-processing of a model, apart from its backbone.
+
+The boxes a detection head would output, [class_id, score, x1, y1, x2, y2] per anchor, are
+generated at random and run through get_valid_counts alone, then through get_valid_counts
+followed by non_max_suppression, as the SSD-style models do.
+Use, e.g., "--target cuda --anchors 8732 --top-k 400" for the post-processing of SSD300.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+
+
+def get_boxes(batch, anchors, num_classes):
+    corners = np.random.uniform(0, 300, size=(batch, anchors, 2))
+    sizes = np.random.uniform(10, 100, size=(batch, anchors, 2))
+    return np.concatenate(
+        [
+            np.random.randint(0, num_classes, size=(batch, anchors, 1)),
+            np.random.uniform(0, 1, size=(batch, anchors, 1)),
+            corners,
+            corners + sizes,
+        ],
+        axis=2,
+    ).astype("float32")
+
+
+def get_postprocess(shape, with_nms, args):
+    data = relay.var("data", shape=shape)
+    valid_count, boxes, indices = relay.vision.get_valid_counts(
+        data, score_threshold=args.score_threshold, id_index=0, score_index=1
+    )
+    if not with_nms:
+        return relay.Function([data], relay.Tuple([valid_count, boxes, indices]))
+    out = relay.vision.non_max_suppression(
+        boxes,
+        valid_count,
+        indices,
+        max_output_size=args.max_output_size,
+        iou_threshold=args.iou_threshold,
+        force_suppress=False,
+        top_k=args.top_k,
+        coord_start=2,
+        score_index=1,
+        id_index=0,
+        return_indices=False,
+    )
+    return relay.Function([data], out)
+
+
+def benchmark(func, np_data, target, repeat):
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(tvm.IRModule.from_expr(func), target=target)
+    dev = tvm.device(str(target), 0)
+    module = graph_executor.GraphModule(lib["default"](dev))
+    module.set_input("data", np_data)
+    ftimer = module.module.time_evaluator("run", dev, number=10, repeat=repeat)
+    # multiply 1000 for converting to millisecond
+    return np.array(ftimer().results) * 1000
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm")
+    parser.add_argument("--batch", type=int, default=1)
+    parser.add_argument("--anchors", type=int, default=8732)
+    parser.add_argument("--classes", type=int, default=21)
+    parser.add_argument("--score-threshold", type=float, default=0.5)
+    parser.add_argument("--iou-threshold", type=float, default=0.45)
+    parser.add_argument("--top-k", type=int, default=400)
+    parser.add_argument("--max-output-size", type=int, default=-1)
+    parser.add_argument("--repeat", type=int, default=3)
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target)
+    np_data = get_boxes(args.batch, args.anchors, args.classes)
+
+    print("%-30s %-19s (%s)" % ("Stage", "ms/run", "std"))
+    print("-" * 60)
+    for name, with_nms in [("get_valid_counts", False), ("get_valid_counts + nms", True)]:
+        func = get_postprocess(np_data.shape, with_nms, args)
+        prof_res = benchmark(func, np_data, target, args.repeat)
+        print(
+            "%-30s %-19s (%s)" % (name, "%.3f ms" % np.mean(prof_res), "%.3f ms" % np.std(prof_res))
+        )
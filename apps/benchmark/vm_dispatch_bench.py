@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the dispatch overhead of the Relay VM interpreter.
+
+The model is a chain of tiny elementwise operators on a tensor with a dynamic
+leading dimension, so the run time is dominated by the interpreter rather than
+by the kernels. The time per invocation is divided by the number of bytecode
+instructions of the function to estimate the cost of dispatching one instruction
+under each dispatch mode.
+"""
+import argparse
+import re
+import timeit
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.runtime import vm as vm_rt
+
+
+def build(depth):
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    y = x
+    for i in range(depth):
+        y = relay.add(y, relay.const(float(i)))
+        y = relay.nn.relu(y) if i % 2 else relay.negative(y)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    # opt_level=0 keeps the operators unfused: one packed call per operator.
+    with tvm.transform.PassContext(opt_level=0):
+        return relay.vm.compile(mod, target="llvm")
+
+
+def instruction_count(exe, func_name):
+    match = re.search(
+        r"VM Function\[\d+\]: %s\(.*?\n.*?# instruction count = (\d+)" % func_name,
+        exe.bytecode,
+        re.S,
+    )
+    return int(match.group(1))
+
+
+def benchmark(exe, superinstructions, threaded, number, repeat):
+    vm = vm_rt.VirtualMachine(exe, tvm.cpu())
+    vm.configure_dispatch(superinstructions, threaded)
+    data = tvm.nd.array(np.random.uniform(size=(2, 4)).astype("float32"))
+    vm.set_input("main", data)
+    vm.invoke("main")
+    times = timeit.repeat(lambda: vm.invoke("main"), number=number, repeat=repeat)
+    return min(times) / number
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--depth", type=int, default=64, help="The number of operator pairs.")
+    parser.add_argument("--number", type=int, default=200)
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    exe = build(args.depth)
+    num_instrs = instruction_count(exe, "main")
+    print("%-30s %12s %14s" % ("Mode", "us/invoke", "ns/instruction"))
+    print("-" * 58)
+    for superinstructions, threaded in [(False, False), (False, True), (True, False), (True, True)]:
+        name = "super=%s threaded=%s" % (superinstructions, threaded)
+        cost = benchmark(exe, superinstructions, threaded, args.number, args.repeat)
+        print("%-30s %12.2f %14.2f" % (name, cost * 1e6, cost * 1e9 / num_instrs))
@@ -108,6 +108,14 @@ set(USE_GRAPH_EXECUTOR_CUDA_GRAPH OFF)
 # Whether to enable the profiler for the graph executor and vm
 set(USE_PROFILER ON)
 
+# Whether to enable the pipeline executor, running the stages of a split model on
+# their own devices and threads
+set(USE_PIPELINE_EXECUTOR OFF)
+
+# Whether to enable the AOT executor, running the models compiled ahead of time
+# with the C++ runtime
+set(USE_AOT_EXECUTOR ON)
+
 # Whether enable uTVM standalone runtime
 set(USE_MICRO_STANDALONE_RUNTIME OFF)
 
@@ -186,6 +194,9 @@ set(USE_CUDNN OFF)
 # Whether use cuBLAS
 set(USE_CUBLAS OFF)
 
+# Whether to collect CUDA hardware events in the profiler with CUPTI
+set(USE_CUPTI OFF)
+
 # Whether use MIOpen
 set(USE_MIOPEN OFF)
 
@@ -238,6 +249,10 @@ set(USE_TENSORRT_RUNTIME OFF)
 # Whether use VITIS-AI codegen
 set(USE_VITIS_AI OFF)
 
+# Whether to build the CMSIS-NN codegen, offloading the int8 operators of the
+# microTVM models to the CMSIS-NN kernels of the Cortex-M cores
+set(USE_CMSISNN OFF)
+
 # Build Verilator codegen and runtime
 set(USE_VERILATOR OFF)
 
@@ -288,6 +303,14 @@ set(USE_BNNS OFF)
 # - OFF: disable libbacktrace
 set(USE_LIBBACKTRACE AUTO)
 
+# Whether to compress the binaries of the imported modules embedded in the exported
+# libraries with zstd, see the compression_level argument of export_library.
+# Possible values:
+# - ON: enable zstd, found in the system paths
+# - OFF: disable zstd
+# - /path/to/zstd: the root of the zstd installation
+set(USE_ZSTD OFF)
+
 # Whether to build static libtvm_runtime.a, the default is to build the dynamic
 # version: libtvm_runtime.so.
 #
@@ -56,6 +56,14 @@ if(USE_CUDA)
     endif()
   endif(USE_CUBLAS)
 
+  if(USE_CUPTI)
+    message(STATUS "Build with CUPTI support")
+    include_directories(SYSTEM ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/include)
+    file(GLOB CONTRIB_CUPTI_SRCS src/runtime/contrib/cupti/*.cc)
+    list(APPEND RUNTIME_SRCS ${CONTRIB_CUPTI_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUPTI_LIBRARY})
+  endif(USE_CUPTI)
+
   if(USE_THRUST)
     message(STATUS "Build with Thrust support")
     cmake_minimum_required(VERSION 3.13) # to compile CUDA code
@@ -72,8 +80,9 @@ if(USE_CUDA)
     if(CUDAToolkit_VERSION_MAJOR LESS "10")
       message(FATAL_ERROR "CUDA Graph requires CUDA 10 or above, got=" ${CUDAToolkit_VERSION})
     endif()
-    message(STATUS "Build with Graph executor with CUDA Graph support...")
-    file(GLOB RUNTIME_CUDA_GRAPH_SRCS src/runtime/graph_executor/cuda_graph/*.cc)
+    message(STATUS "Build with Graph executor and VM with CUDA Graph support...")
+    file(GLOB RUNTIME_CUDA_GRAPH_SRCS src/runtime/graph_executor/cuda_graph/*.cc
+                                      src/runtime/vm/cuda_graph/*.cc)
     list(APPEND RUNTIME_SRCS ${RUNTIME_CUDA_GRAPH_SRCS})
   endif()
 else(USE_CUDA)
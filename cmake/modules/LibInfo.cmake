@@ -68,12 +68,14 @@ function(add_lib_info src_file)
     TVM_INFO_USE_DNNL_CODEGEN="${USE_DNNL_CODEGEN}"
     TVM_INFO_USE_CUDNN="${USE_CUDNN}"
     TVM_INFO_USE_CUBLAS="${USE_CUBLAS}"
+    TVM_INFO_USE_CUPTI="${USE_CUPTI}"
     TVM_INFO_USE_THRUST="${USE_THRUST}"
     TVM_INFO_USE_MIOPEN="${USE_MIOPEN}"
     TVM_INFO_USE_ROCBLAS="${USE_ROCBLAS}"
     TVM_INFO_USE_SORT="${USE_SORT}"
     TVM_INFO_USE_NNPACK="${USE_NNPACK}"
     TVM_INFO_USE_RANDOM="${USE_RANDOM}"
+    TVM_INFO_USE_ZSTD="${USE_ZSTD}"
     TVM_INFO_USE_MICRO_STANDALONE_RUNTIME="${USE_MICRO_STANDALONE_RUNTIME}"
     TVM_INFO_USE_CPP_RPC="${USE_CPP_RPC}"
     TVM_INFO_USE_TFLITE="${USE_TFLITE}"
@@ -0,0 +1,41 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# This script configures the zstd compression of the module binaries embedded in exported
+# libraries.
+
+if(USE_ZSTD)
+  if(USE_ZSTD STREQUAL "ON")
+    find_path(ZSTD_INCLUDE_DIR zstd.h)
+  else()
+    find_path(ZSTD_INCLUDE_DIR zstd.h HINTS ${USE_ZSTD}/include NO_DEFAULT_PATH)
+  endif()
+  find_library(ZSTD_LIBRARY NAMES zstd HINTS ${USE_ZSTD}/lib)
+  if(NOT ZSTD_INCLUDE_DIR OR NOT ZSTD_LIBRARY)
+    message(FATAL_ERROR "Cannot find zstd, USE_ZSTD=" ${USE_ZSTD})
+  endif()
+  message(STATUS "Build with zstd compressed module binaries: " ${ZSTD_LIBRARY})
+  target_include_directories(tvm_objs PRIVATE ${ZSTD_INCLUDE_DIR})
+  target_include_directories(tvm_runtime_objs PRIVATE ${ZSTD_INCLUDE_DIR})
+  target_link_libraries(tvm PRIVATE ${ZSTD_LIBRARY})
+  target_link_libraries(tvm_runtime PRIVATE ${ZSTD_LIBRARY})
+  target_compile_definitions(tvm_objs PRIVATE TVM_USE_ZSTD=1)
+  target_compile_definitions(tvm_runtime_objs PRIVATE TVM_USE_ZSTD=1)
+else()
+  target_compile_definitions(tvm_objs PRIVATE TVM_USE_ZSTD=0)
+  target_compile_definitions(tvm_runtime_objs PRIVATE TVM_USE_ZSTD=0)
+endif()
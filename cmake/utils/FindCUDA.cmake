@@ -37,6 +37,7 @@
 # - CUDA_CUDNN_INCLUDE_DIRS
 # - CUDA_CUDNN_LIBRARY
 # - CUDA_CUBLAS_LIBRARY
+# - CUDA_CUPTI_LIBRARY
 #
 macro(find_cuda use_cuda use_cudnn)
   set(__use_cuda ${use_cuda})
@@ -73,6 +74,9 @@ macro(find_cuda use_cuda use_cudnn)
       find_library(CUDA_CUBLASLT_LIBRARY cublaslt
         ${CUDA_TOOLKIT_ROOT_DIR}/lib/x64
         ${CUDA_TOOLKIT_ROOT_DIR}/lib/Win32)
+      find_library(CUDA_CUPTI_LIBRARY cupti
+        ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib64
+        ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/libx64)
     else(MSVC)
       find_library(_CUDA_CUDA_LIBRARY cuda
         PATHS ${CUDA_TOOLKIT_ROOT_DIR}
@@ -95,6 +99,10 @@ macro(find_cuda use_cuda use_cudnn)
         ${CUDA_TOOLKIT_ROOT_DIR}/lib64
         ${CUDA_TOOLKIT_ROOT_DIR}/lib
         NO_DEFAULT_PATH)
+      find_library(CUDA_CUPTI_LIBRARY cupti
+        ${CUDA_TOOLKIT_ROOT_DIR}/extras/CUPTI/lib64
+        ${CUDA_TOOLKIT_ROOT_DIR}/lib64
+        NO_DEFAULT_PATH)
     endif(MSVC)
 
     # find cuDNN
@@ -131,5 +139,6 @@ macro(find_cuda use_cuda use_cudnn)
     message(STATUS "Found CUDA_CUDNN_LIBRARY=" ${CUDA_CUDNN_LIBRARY})
     message(STATUS "Found CUDA_CUBLAS_LIBRARY=" ${CUDA_CUBLAS_LIBRARY})
     message(STATUS "Found CUDA_CUBLASLT_LIBRARY=" ${CUDA_CUBLASLT_LIBRARY})
+    message(STATUS "Found CUDA_CUPTI_LIBRARY=" ${CUDA_CUPTI_LIBRARY})
   endif(CUDA_FOUND)
 endmacro(find_cuda)
@@ -21,7 +21,7 @@ Get Started with TVM Go
 from __future__ import absolute_import, print_function
 
 import tvm
-from tvm import te
+from tvm import te, relay
 import numpy as np
 
 # Global declarations of environment.
@@ -55,3 +55,11 @@ from tvm.contrib import utils
 
 fadd.save("deploy.o")
 cc.create_shared("deploy.so", ["deploy.o"])
+
+######################################################################
+# Save a Graph Executor Module
+# ----------------------------
+x = relay.var("x", shape=(4,), dtype="float32")
+y = relay.var("y", shape=(4,), dtype="float32")
+graph_lib = relay.build(tvm.IRModule.from_expr(relay.Function([x, y], x + y)), target=tgt)
+graph_lib.export_library("deploy_graph.so")
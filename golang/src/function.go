@@ -187,27 +187,25 @@ func nativeTVMFuncFree(funp *Function) (retVal int32) {
 
 // nativeToGoSlice converts native TVMValue array to Golang slice of TVMValue
 //
-//
-func nativeToGoSlice(nargValues (*C.void), argValues []*Value, typeCodes []int32) {
+// The values are copied from Go, with no cgo call per value.
+func nativeToGoSlice(nargValues unsafe.Pointer, argValues []*Value, typeCodes []int32) {
+    nvals := (*[1<<28] C.TVMValue)(nargValues)[:len(argValues):len(argValues)]
     for ii := range argValues {
-        C._TVMValueNativeGet(unsafe.Pointer(argValues[ii].nativeCPtr()),
-                             unsafe.Pointer(nargValues),
-                             C.int(int32(ii)))
+        *(*C.TVMValue)(unsafe.Pointer(argValues[ii].nativeCPtr())) = nvals[ii]
         argValues[ii].dtype = typeCodes[ii]
     }
 }
 
 // nativeFromGoSlice converts golang slice of TVMValue to native TVMValue array.
 //
-//
-func nativeFromGoSlice(argValues []*Value) (nptr (*C.void)) {
-    nargValues := ((uintptr)(C.malloc(C.ulong(C.sizeof_TVMValue * len(argValues)))))
+// The array holds no Go pointer, it is passed to the native API as is and
+// released by the garbage collector.
+func nativeFromGoSlice(argValues []*Value) (nargValues []C.TVMValue) {
+    // One value at least, to always have an address to pass.
+    nargValues = make([]C.TVMValue, len(argValues) + 1)
     for ii := range argValues {
-        C._TVMValueNativeSet(unsafe.Pointer(nargValues),
-                             unsafe.Pointer(argValues[ii].nativeCPtr()),
-                             C.int(int32(ii)))
+        nargValues[ii] = *(*C.TVMValue)(unsafe.Pointer(argValues[ii].nativeCPtr()))
     }
-    nptr = (*C.void)(unsafe.Pointer(nargValues))
     return
 }
 
@@ -228,20 +226,23 @@ func nativeTVMFuncCall(funp *Function, argValues []*Value, typeCodes []int32,
                  retValues []*Value, retTypeCode *int32) (err error) {
     nargValues := nativeFromGoSlice(argValues)
     nretValues := nativeFromGoSlice(retValues)
+    // The last error is thread local, the goroutine must not move to another
+    // thread before reading it.
+    runtime.LockOSThread()
+    defer runtime.UnlockOSThread()
 	result := (int32)(C.TVMFuncCall(C.TVMFunctionHandle(*funp),
-                                    (*C.TVMValue)(unsafe.Pointer(nargValues)),
+                                    &nargValues[0],
                                     (*C.int)(unsafe.Pointer(&(typeCodes[0]))),
                                     C.int(len(argValues)),
-                                    (*C.TVMValue)(unsafe.Pointer(nretValues)),
+                                    &nretValues[0],
                                     (*C.int)(unsafe.Pointer(retTypeCode))))
-    nativeToGoSlice(nargValues, argValues, typeCodes)
-    nativeToGoSlice(nretValues, retValues, (*[1<<31] int32)(unsafe.Pointer(retTypeCode))[:1:1])
-    C.free(unsafe.Pointer(nargValues))
-    C.free(unsafe.Pointer(nretValues))
-
     if result != 0 {
 	    err = errors.New(getTVMLastError())
+        return
     }
+    nativeToGoSlice(unsafe.Pointer(&nargValues[0]), argValues, typeCodes)
+    nativeToGoSlice(unsafe.Pointer(&nretValues[0]), retValues,
+                    (*[1<<31] int32)(unsafe.Pointer(retTypeCode))[:1:1])
     return
 }
 
@@ -265,7 +266,7 @@ func goTVMCallback(args C.native_voidp, typeCodes C.native_voidp, numArgs int32,
     }
 
     // Prepare arguments for golang callback function
-    nativeToGoSlice((*C.void)(unsafe.Pointer(args)), argValues,
+    nativeToGoSlice(unsafe.Pointer(args), argValues,
                     (*[1<<31] int32)(unsafe.Pointer(typeCodes))[:numArgs:numArgs])
     cbargs := argValues
 
@@ -312,9 +313,8 @@ func goTVMCallback(args C.native_voidp, typeCodes C.native_voidp, numArgs int32,
         retValues[0].isLocal = false
 
         apiRet := (int32) (C.TVMCFuncSetReturn(C.TVMRetValueHandle(retArg),
-                                               (*C.TVMValue)(unsafe.Pointer(nretValues)),
+                                               &nretValues[0],
                                                (*C.int)(unsafe.Pointer(&retTypeCode)), 1))
-        C.free(unsafe.Pointer(nretValues))
         if apiRet != 0 {
             errStr := string("TVMCFuncSetReturn failed ")
             setTVMLastError(errStr)
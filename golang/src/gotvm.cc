@@ -135,36 +135,6 @@ int _TVMFuncListGlobalNames(_gostring_* names) {
   return result;
 }
 
-// Helpers for TVMValue
-
-/*!
- * \brief Native helper to copy TVMValue from golang slice to native array.
- * this helper is need as underlying momory for golang slice is not continueous.
- *
- * \param to_ptr is the native pointer of TVMValue array.
- * \param from_ptr pointer to TVMValue in golang slice.
- * \param array index in native array.
- */
-void _TVMValueNativeSet(void* to_ptr, void* from_ptr, int ind) {
-  TVMValue* from_p = reinterpret_cast<TVMValue*>(from_ptr);
-  TVMValue* to_p = reinterpret_cast<TVMValue*>(to_ptr);
-  memcpy(to_p + ind, from_p, sizeof(TVMValue));
-}
-
-/*!
- * \brief Native helper to copy TVMValue from golang slice to native array.
- * this helper is need as underlying momory for golang slice is not continueous.
- *
- * \param to_ptr pointer to TVMValue in golang slice.
- * \param from_ptr is the native pointer of TVMValue array.
- * \param array index in native array.
- */
-void _TVMValueNativeGet(void* to_ptr, void* from_ptr, int ind) {
-  TVMValue* from_p = reinterpret_cast<TVMValue*>(from_ptr);
-  TVMValue* to_p = reinterpret_cast<TVMValue*>(to_ptr);
-  memcpy(to_p, from_p + ind, sizeof(TVMValue));
-}
-
 extern int goTVMCallback(void*, void*, int, void*, void*);
 
 /*!
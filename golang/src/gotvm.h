@@ -47,9 +47,6 @@ extern char* _TVM_VERSION(void);
 // Wrappers : For incompatible cgo API.
 // To handle array of strings wrapped into __gostring__
 extern int _TVMFuncListGlobalNames(void*);
-// To handle TVMValue slice to/from native sequential TVMValue array.
-extern void _TVMValueNativeSet(void* to, void* from, int index);
-extern void _TVMValueNativeGet(void* to, void* from, int index);
 
 // Callbacks
 extern int _ConvertFunction(void* fptr, void* funp);
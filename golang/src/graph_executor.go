@@ -0,0 +1,296 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief gotvm package source for the graph executor interface.
+ * \file graph_executor.go
+ */
+
+package gotvm
+
+//#include "gotvm.h"
+import "C"
+
+import (
+    "fmt"
+    "runtime"
+)
+
+// GraphModule wraps a graph executor module.
+//
+// The functions of the executor are looked up once, at creation.
+//
+// A GraphModule must not be used from several goroutines at the same time,
+// use a GraphExecutorPool to run inferences concurrently.
+type GraphModule struct {
+    // Module is the graph executor module.
+    Module *Module
+    fsetInput *Function
+    fsetInputZeroCopy *Function
+    fsetOutputZeroCopy *Function
+    frun *Function
+    fgetOutput *Function
+    fgetNumOutputs *Function
+}
+
+// NewGraphModule wraps the given graph executor module.
+//
+// `mod` is the executor, e.g. returned by tvm.graph_executor.create.
+//
+// returns pointer to GraphModule and err if any.
+func NewGraphModule(mod *Module) (retVal *GraphModule, err error) {
+    gmod := &GraphModule{Module: mod}
+    funcs := []struct {
+        name string
+        fptr **Function
+    }{
+        {"set_input", &gmod.fsetInput},
+        {"set_input_zero_copy", &gmod.fsetInputZeroCopy},
+        {"set_output_zero_copy", &gmod.fsetOutputZeroCopy},
+        {"run", &gmod.frun},
+        {"get_output", &gmod.fgetOutput},
+        {"get_num_outputs", &gmod.fgetNumOutputs},
+    }
+    for _, f := range funcs {
+        if *f.fptr, err = mod.GetFunction(f.name); err != nil {
+            return
+        }
+        if **f.fptr == 0 {
+            err = fmt.Errorf("Not a graph executor module, no function %v", f.name)
+            return
+        }
+    }
+    retVal = gmod
+    return
+}
+
+// SetInput copies the given Array into an input.
+//
+// `key` is the input name (string) or index (int).
+//
+// `value` is the input Array.
+//
+// returns err if any.
+func (gmod *GraphModule) SetInput(key interface{}, value *Array) (err error) {
+    _, err = gmod.fsetInput.Invoke(key, value)
+    return
+}
+
+// SetInputZeroCopy binds the given Array as an input, without copying.
+//
+// The Array must be on the device of the input and aligned, as the ones from Empty.
+// It is read by every Run until another one is bound.
+//
+// `key` is the input name (string) or index (int).
+//
+// `value` is the input Array.
+//
+// returns err if any.
+func (gmod *GraphModule) SetInputZeroCopy(key interface{}, value *Array) (err error) {
+    _, err = gmod.fsetInputZeroCopy.Invoke(key, value)
+    return
+}
+
+// SetOutputZeroCopy binds the given Array as an output, without copying.
+//
+// Run writes the output in the Array until another one is bound.
+// The executor holds a reference to the Array while it is bound.
+//
+// `index` is the output index.
+//
+// `value` is the output Array.
+//
+// returns err if any.
+func (gmod *GraphModule) SetOutputZeroCopy(index int, value *Array) (err error) {
+    // The Arrays from Empty are NDArray containers, the executor keeps a reference.
+    arg := newTVMValue()
+    arg.setVHandle(value.nativeCPtr())
+    arg.dtype = KNDArrayContainer
+    _, err = gmod.fsetOutputZeroCopy.Invoke(index, arg)
+    return
+}
+
+// Run executes the graph.
+//
+// returns err if any.
+func (gmod *GraphModule) Run() (err error) {
+    _, err = gmod.frun.Invoke()
+    return
+}
+
+// GetOutput copies an output into the given Array.
+//
+// `index` is the output index.
+//
+// `out` is the Array to copy the output to.
+//
+// returns err if any.
+func (gmod *GraphModule) GetOutput(index int, out *Array) (err error) {
+    _, err = gmod.fgetOutput.Invoke(index, out)
+    return
+}
+
+// GetNumOutputs returns the number of outputs of the graph and err if any.
+func (gmod *GraphModule) GetNumOutputs() (retVal int64, err error) {
+    ret, err := gmod.fgetNumOutputs.Invoke()
+    if err != nil {
+        return
+    }
+    retVal = ret.AsInt64()
+    return
+}
+
+// GraphExecutorPool holds graph executors of a module that run concurrently.
+//
+// The executors share the params and the code of the module, each of them only
+// owns the storage of its activations. The pool is safe for concurrent use:
+// each goroutine acquires an executor for the duration of an inference.
+type GraphExecutorPool struct {
+    executors []*GraphModule
+    idle chan *GraphModule
+}
+
+// NewGraphExecutorPool creates the executors of a module built by relay.build.
+//
+// `lib` is the module, e.g. loaded by LoadModuleFromFile from an exported library.
+//
+// `numExecutors` is the number of executors, i.e. of concurrent inferences.
+//
+// `devs` are the devices to run on. Default value is '{KDLCPU, 0}'
+//
+// returns pointer to GraphExecutorPool and err if any.
+func NewGraphExecutorPool(lib *Module, numExecutors int,
+                          devs ...Device) (retVal *GraphExecutorPool, err error) {
+    if numExecutors < 1 {
+        err = fmt.Errorf("Invalid number of executors: %v", numExecutors)
+        return
+    }
+    fcreate, err := lib.GetFunction("create_pool")
+    if err != nil {
+        return
+    }
+    if *fcreate == 0 {
+        err = fmt.Errorf("Not a graph executor factory module, no function create_pool")
+        return
+    }
+    if len(devs) == 0 {
+        devs = []Device{CPU(0)}
+    }
+    args := []interface{}{numExecutors}
+    for _, dev := range devs {
+        args = append(args, dev)
+    }
+    ret, err := fcreate.Invoke(args...)
+    if err != nil {
+        return
+    }
+    mods, err := moduleArrayFromValue(ret)
+    if err != nil {
+        return
+    }
+
+    pool := &GraphExecutorPool{idle: make(chan *GraphModule, len(mods))}
+    for _, mod := range mods {
+        var gmod *GraphModule
+        if gmod, err = NewGraphModule(mod); err != nil {
+            return
+        }
+        pool.executors = append(pool.executors, gmod)
+        pool.idle <- gmod
+    }
+    retVal = pool
+    return
+}
+
+// Size returns the number of executors in the pool.
+func (pool *GraphExecutorPool) Size() int {
+    return len(pool.executors)
+}
+
+// Acquire takes an idle executor out of the pool, waiting for one if none is idle.
+//
+// The executor must be given back with Release.
+func (pool *GraphExecutorPool) Acquire() (retVal *GraphModule) {
+    retVal = <-pool.idle
+    return
+}
+
+// Release gives an executor taken by Acquire back to the pool.
+func (pool *GraphExecutorPool) Release(gmod *GraphModule) {
+    pool.idle <- gmod
+}
+
+// Do runs the given function with an executor of the pool.
+//
+// `fn` sets the inputs, runs and reads the outputs of the executor.
+//
+// returns the err from fn if any.
+func (pool *GraphExecutorPool) Do(fn func(gmod *GraphModule) error) (err error) {
+    gmod := pool.Acquire()
+    defer pool.Release(gmod)
+    err = fn(gmod)
+    return
+}
+
+// moduleArrayFromValue unpacks the Modules of an Array<Module> object.
+//
+// `val` is the Value holding the object, released here.
+//
+// returns the slice of Module and err if any.
+func moduleArrayFromValue(val *Value) (retVal []*Module, err error) {
+    if val.dtype != KObjectHandle {
+        err = fmt.Errorf("Expect an array of modules, got type code %v", val.dtype)
+        return
+    }
+    handle := val.getVHandle()
+    defer C.TVMObjectFree(C.TVMObjectHandle(handle))
+
+    fsize, err := GetGlobalFunction("runtime.ArraySize")
+    if err != nil {
+        return
+    }
+    fgetItem, err := GetGlobalFunction("runtime.ArrayGetItem")
+    if err != nil {
+        return
+    }
+    arrayArg := func() (*Value) {
+        arg := newTVMValue()
+        arg.setVObjectHandle(handle)
+        return arg
+    }
+    size, err := fsize.Invoke(arrayArg())
+    if err != nil {
+        return
+    }
+    for ii := int64(0); ii < size.AsInt64(); ii++ {
+        var item *Value
+        if item, err = fgetItem.Invoke(arrayArg(), ii); err != nil {
+            return
+        }
+        mhandle := new(Module)
+        *mhandle = item.getVMHandle()
+        finalizer := func(mhandle *Module) {
+            nativeTVMModFree(mhandle)
+            mhandle = nil
+        }
+        runtime.SetFinalizer(mhandle, finalizer)
+        retVal = append(retVal, mhandle)
+    }
+    return
+}
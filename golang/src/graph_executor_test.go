@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief gotvm package
+ * \file graph_executor_test.go
+ */
+
+
+package gotvm
+
+import (
+    "fmt"
+    "runtime"
+    "sync"
+    "testing"
+)
+
+// Check the slice view of an Array shares its data.
+func TestArraySliceView(t *testing.T) {
+    arr, err := Empty([]int64{2, 2}, "float32")
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    view, err := arr.AsSliceView()
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    copy(view.([]float32), []float32{1, 2, 3, 4})
+
+    data, err := arr.AsSlice()
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    for ii, val := range data.([]float32) {
+        if val != float32(ii + 1) {
+            t.Errorf("Slice view mismatch at %v: %v\n", ii, val)
+            return
+        }
+    }
+}
+
+// Run the executors of a pool from concurrent goroutines,
+// with inputs and outputs bound without copy.
+// deploy_graph.so computes x + y for two float32 inputs of shape (4,).
+func TestGraphExecutorPool(t *testing.T) {
+    lib, err := LoadModuleFromFile("./deploy_graph.so")
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    pool, err := NewGraphExecutorPool(lib, 2, CPU(0))
+    if err != nil {
+        t.Error(err.Error())
+        return
+    }
+    if pool.Size() != 2 {
+        t.Errorf("Expected 2 executors, got %v\n", pool.Size())
+        return
+    }
+
+    numRuns := 8
+    errs := make(chan error, numRuns)
+    var wg sync.WaitGroup
+    for run := 0; run < numRuns; run++ {
+        wg.Add(1)
+        go func(run int) {
+            defer wg.Done()
+            errs <- pool.Do(func(gmod *GraphModule) error {
+                x, _ := Empty([]int64{4}, "float32")
+                y, _ := Empty([]int64{4}, "float32")
+                out, _ := Empty([]int64{4}, "float32")
+                xview, _ := x.AsSliceView()
+                yview, _ := y.AsSliceView()
+                for ii := 0; ii < 4; ii++ {
+                    xview.([]float32)[ii] = float32(run)
+                    yview.([]float32)[ii] = float32(ii)
+                }
+                if err := gmod.SetInputZeroCopy("x", x); err != nil {
+                    return err
+                }
+                if err := gmod.SetInputZeroCopy("y", y); err != nil {
+                    return err
+                }
+                if err := gmod.SetOutputZeroCopy(0, out); err != nil {
+                    return err
+                }
+                if err := gmod.Run(); err != nil {
+                    return err
+                }
+                outview, _ := out.AsSliceView()
+                for ii, val := range outview.([]float32) {
+                    if val != float32(run + ii) {
+                        return fmt.Errorf("Run %v output mismatch at %v: %v", run, ii, val)
+                    }
+                }
+                // The views don't keep the arrays alive.
+                runtime.KeepAlive(x)
+                runtime.KeepAlive(y)
+                runtime.KeepAlive(out)
+                return nil
+            })
+        }(run)
+    }
+    wg.Wait()
+    close(errs)
+    for err := range errs {
+        if err != nil {
+            t.Error(err.Error())
+        }
+    }
+}
@@ -219,6 +219,63 @@ func (parray Array) AsSlice() (retVal interface{}, err error) {
     return
 }
 
+// maxSliceViewLen is the maximum number of elements of a slice viewing an Array.
+const maxSliceViewLen = 1 << 28
+
+// AsSliceView returns a slice viewing the data inside Array, without copying.
+//
+// The Array must be on the CPU. Writes to the slice are seen by TVM and conversely,
+// e.g. an input bound with SetInputZeroCopy can be filled through the slice
+// and an output bound with SetOutputZeroCopy read from it.
+//
+// The slice doesn't keep the Array alive: the Array mustn't be released
+// (e.g. collected) while the slice is in use, see runtime.KeepAlive.
+//
+// returns the slice of Array data type and err if any.
+func (parray Array) AsSliceView() (retVal interface{}, err error) {
+    if parray.GetDevice().DeviceType != KDLCPU {
+        err = fmt.Errorf("Only CPU arrays can be viewed as slices")
+        return
+    }
+    shape := parray.GetShape()
+    size := int64(1)
+    for ii := range shape {
+        size *= shape[ii]
+    }
+    if size > maxSliceViewLen {
+        err = fmt.Errorf("Array too large to be viewed as a slice : %v", size)
+        return
+    }
+    tensor := (*C.DLTensor)(unsafe.Pointer(parray))
+    data := unsafe.Pointer(uintptr(tensor.data) + uintptr(tensor.byte_offset))
+
+    switch parray.GetDType() {
+        case "int8":
+            retVal = (*[maxSliceViewLen] int8)(data)[:size:size]
+        case "int16":
+            retVal = (*[maxSliceViewLen] int16)(data)[:size:size]
+        case "int32":
+            retVal = (*[maxSliceViewLen] int32)(data)[:size:size]
+        case "int64":
+            retVal = (*[maxSliceViewLen] int64)(data)[:size:size]
+        case "uint8":
+            retVal = (*[maxSliceViewLen] uint8)(data)[:size:size]
+        case "uint16":
+            retVal = (*[maxSliceViewLen] uint16)(data)[:size:size]
+        case "uint32":
+            retVal = (*[maxSliceViewLen] uint32)(data)[:size:size]
+        case "uint64":
+            retVal = (*[maxSliceViewLen] uint64)(data)[:size:size]
+        case "float32":
+            retVal = (*[maxSliceViewLen] float32)(data)[:size:size]
+        case "float64":
+            retVal = (*[maxSliceViewLen] float64)(data)[:size:size]
+        default:
+            err = fmt.Errorf("Given type not supported : %v", parray.GetDType())
+    }
+    return
+}
+
 // GetNdim returns the number of dimentions in Array
 func (parray Array) GetNdim() (retVal int32) {
     retVal = int32(((*C.DLTensor)(unsafe.Pointer(parray))).ndim)
@@ -281,6 +281,26 @@ func (tvmval *Value) getVBHandle() (retVal ByteArray) {
     return
 }
 
+// setVDevice is used to set Device in Value.
+//
+// `val` is the Device, e.g. passed to create the executors of a module.
+func (tvmval *Value) setVDevice(val Device) {
+    valp := (*C.DLDevice)(unsafe.Pointer(tvmval.nativeCPtr()))
+    valp.device_type = C.DLDeviceType(val.DeviceType)
+    valp.device_id = C.int(val.DeviceID)
+    tvmval.dtype = KDLDevice
+    return
+}
+
+// setVObjectHandle is used to set an object handle in Value.
+//
+// The object is borrowed, the Value doesn't release it.
+func (tvmval *Value) setVObjectHandle(val uintptr) {
+    tvmval.setVHandle(val)
+    tvmval.dtype = KObjectHandle
+    return
+}
+
 // setValue is used to set the given value in Value.
 //
 // `val` is value of types accepted by Value container or native union.
@@ -322,6 +342,8 @@ func (tvmval *Value) setValue(val interface{}) (retVal int32, err error) {
             tvmval.setVBHandle(barray)
         case *Array:
             tvmval.setVAHandle(*(val.(*Array)))
+        case Device:
+            tvmval.setVDevice(val.(Device))
         case func (args ...*Value) (interface{}, error):
             fhandle, apierr := ConvertFunction(val)
             if apierr != nil {
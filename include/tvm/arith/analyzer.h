@@ -273,6 +273,8 @@ class RewriteSimplifier {
   friend class Analyzer;
   friend class ConstraintContext;
   friend class CanonicalSimplifier;
+  /*! \brief Drop the cached simplifications, on a change of the bounds of a var. */
+  void ClearCache();
   explicit RewriteSimplifier(Analyzer* parent);
   TVM_DLL ~RewriteSimplifier();
   class Impl;
@@ -304,6 +306,13 @@ class CanonicalSimplifier {
  private:
   friend class Analyzer;
   friend class ConstraintContext;
+  /*!
+   * \brief Enter a constraint scope of the cached simplifications.
+   * \return The function exiting the scope.
+   */
+  std::function<void()> EnterCacheScope();
+  /*! \brief Drop the cached simplifications, on a change of the bounds of a var. */
+  void ClearCache();
   explicit CanonicalSimplifier(Analyzer* parent);
   TVM_DLL ~CanonicalSimplifier();
   class Impl;
@@ -165,6 +165,8 @@ class AccessAnalyzer : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(AccessAnalyzer, ObjectRef, AccessAnalyzerNode);
 };
 
+class InferBoundCache;
+
 /*! \brief The auto-scheduler's computational graph and related program analyses. */
 class ComputeDAGNode : public Object {
  public:
@@ -181,6 +183,11 @@ class ComputeDAGNode : public Object {
   State init_state;
   /*! \brief The static read-write access analyzer. */
   AccessAnalyzer access_analyzer;
+  /*!
+   * \brief The bound information inferred on this ComputeDAG, keyed by the transform steps of
+   * the states. It is shared by the threads inferring bounds concurrently.
+   */
+  std::shared_ptr<InferBoundCache> infer_bound_cache;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("tensors", &tensors);
@@ -275,6 +282,8 @@ class ComputeDAG : public ObjectRef {
    * We can call this function to infer and fill all the bound information.
    * This function calls TVM InferBound pass internally to get the bound.
    * The returned state of this function is guaranteed to have complete bound information.
+   * The bound information is cached by the transform steps of the state, so inferring the bound
+   * of a state with the same steps again does not call the InferBound pass.
    * \param state The input state.
    * \return The State with complete bound information
    */
@@ -284,7 +293,8 @@ class ComputeDAG : public ObjectRef {
    * \brief Fill the correct bound information for the given states by calling ir_pass::InferBound.
    * The states can lose complete bound information after some transform steps (e.g., compute_at).
    * We can call this function to infer and fill all the bound information.
-   * This function calls TVM InferBound pass internally to get the bound.
+   * This function calls TVM InferBound pass internally to get the bound, for the states in
+   * parallel.
    * The returned state of this function is guaranteed to have complete bound information.
    * \param states The input states.
    * \return The States with complete bound information.
@@ -30,6 +30,7 @@
 #include <tvm/node/node.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <random>
 #include <vector>
 
 namespace tvm {
@@ -159,6 +160,101 @@ class PythonBasedModel : public CostModel {
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PythonBasedModel, CostModel, PythonBasedModelNode);
 };
 
+/*!
+ * \brief A gradient boosted tree model trained and evaluated in c++.
+ *  Like the python XGBModel, it predicts the normalized throughput of a program as the sum
+ *  of the predictions for its per-store feature vectors. The trees are oblivious: all the
+ *  nodes of a level split on the same feature and threshold, so that a batch of feature
+ *  vectors is evaluated with branch free loops. Every update adds boosting rounds fitted on
+ *  all the measurements seen so far to the existing trees.
+ */
+class GBDTModelNode : public CostModelNode {
+ public:
+  /*! \brief An oblivious decision tree. */
+  struct Tree {
+    /*! \brief The feature tested by each level. */
+    std::vector<int> features;
+    /*! \brief The threshold of each level, a vector goes right when its feature is greater. */
+    std::vector<float> thresholds;
+    /*! \brief The values of the leaves, indexed by the bits of the decisions of each level. */
+    std::vector<float> leaves;
+  };
+
+  /*! \brief Predict random scores until this number of measurements is reached. */
+  int num_warmup_sample;
+  /*! \brief The depth of the trees. */
+  int max_depth;
+  /*! \brief The number of trees added by an update. */
+  int num_rounds_per_update;
+  /*!
+   * \brief The maximum number of trees. The ensemble is trained again from scratch, with half
+   *  this number of trees, when an update would exceed it.
+   */
+  int max_num_trees;
+  /*! \brief The number of histogram bins of a feature. */
+  int num_bins;
+  /*! \brief The shrinkage applied to the leaves of a new tree. */
+  double learning_rate;
+  /*! \brief The L2 regularization of the leaf values. */
+  double reg_lambda;
+  /*! \brief The trees of the ensemble. */
+  std::vector<Tree> trees;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("num_warmup_sample", &num_warmup_sample);
+    v->Visit("max_depth", &max_depth);
+    v->Visit("num_rounds_per_update", &num_rounds_per_update);
+    v->Visit("max_num_trees", &max_num_trees);
+    v->Visit("num_bins", &num_bins);
+    v->Visit("learning_rate", &learning_rate);
+    v->Visit("reg_lambda", &reg_lambda);
+  }
+
+  void Update(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results) final;
+
+  void Predict(const SearchTask& task, const Array<State>& states,
+               std::vector<float>* scores) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.GBDTModel";
+  TVM_DECLARE_FINAL_OBJECT_INFO(GBDTModelNode, CostModelNode);
+
+ private:
+  /*! \brief Fit num_rounds new trees on the training data. */
+  void Train(int num_rounds);
+
+  /*! \brief The measurements seen so far. */
+  Array<MeasureInput> inputs_;
+  Array<MeasureResult> results_;
+  /*! \brief The features of the measured states. */
+  std::vector<std::vector<float>> features_;
+  /*! \brief The normalized throughputs of the measured states. */
+  std::vector<float> throughputs_;
+  /*! \brief The generator of the scores predicted during the warm up. */
+  std::mt19937 rand_gen_{0};
+};
+
+/*!
+ * \brief Managed reference to GBDTModelNode.
+ * \sa GBDTModelNode
+ */
+class GBDTModel : public CostModel {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param num_warmup_sample Predict random scores until this number of measurements.
+   * \param max_depth The depth of the trees.
+   * \param num_rounds_per_update The number of trees added by an update.
+   * \param max_num_trees The maximum number of trees before training again from scratch.
+   * \param num_bins The number of histogram bins of a feature.
+   * \param learning_rate The shrinkage applied to the leaves of a new tree.
+   * \param reg_lambda The L2 regularization of the leaf values.
+   */
+  GBDTModel(int num_warmup_sample, int max_depth, int num_rounds_per_update, int max_num_trees,
+            int num_bins, double learning_rate, double reg_lambda);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(GBDTModel, CostModel, GBDTModelNode);
+};
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
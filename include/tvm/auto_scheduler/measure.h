@@ -126,6 +126,11 @@ class BuildResultNode : public Object {
   String error_msg;
   /*! \brief The time cost of build. */
   double time_cost;
+  /*!
+   * \brief The LLVM IR of the built module, for the in-memory builds JITed by the runner instead
+   * of being exported to `filename`. Empty otherwise.
+   */
+  String module_ir;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("filename", &filename);
@@ -133,6 +138,7 @@ class BuildResultNode : public Object {
     v->Visit("error_no", &error_no);
     v->Visit("error_msg", &error_msg);
     v->Visit("time_cost", &time_cost);
+    v->Visit("module_ir", &module_ir);
   }
 
   static constexpr const char* _type_key = "auto_scheduler.BuildResult";
@@ -152,9 +158,10 @@ class BuildResult : public ObjectRef {
    * \param error_no The error code.
    * \param error_msg The error message if there is any error.
    * \param time_cost The time cost of build.
+   * \param module_ir The LLVM IR of an in-memory build.
    */
   BuildResult(String filename, Array<te::Tensor> args, int error_no, String error_msg,
-              double time_cost);
+              double time_cost, String module_ir = "");
   TVM_DEFINE_OBJECT_REF_METHODS(BuildResult, ObjectRef, BuildResultNode);
 };
 
@@ -308,6 +315,23 @@ class ProgramRunnerNode : public Object {
   double cooldown_interval;
   /*! \brief Whether to flush cache on CPU between repeated measurements. */
   bool enable_cpu_cache_flush;
+  /*!
+   * \brief The maximum number of times to repeat the measurement, until the confidence interval
+   *  of the mean is within max_rel_ci of it. 0 repeats it exactly `repeat` times.
+   */
+  int max_repeat{0};
+  /*! \brief The target half width of the confidence interval, relative to the mean. */
+  double max_rel_ci{0.02};
+  /*!
+   * \brief Stop measuring a program once its cost is cutoff_ratio times the best cost of its
+   *  task. 0 measures every program in full.
+   */
+  double cutoff_ratio{0};
+  /*!
+   * \brief The cost in seconds past which the programs of the next Run are not measured further.
+   *  Set by the ProgramMeasurer from cutoff_ratio before each Run, 0 for no cutoff.
+   */
+  double cutoff{0};
 
   /*!
    * \brief Run measurement and return results.
@@ -391,9 +415,14 @@ class LocalRunner : public ProgramRunner {
    * \param min_repeat_ms The minimum duration of one repeat in milliseconds.
    * \param cooldown_interval The cool down interval between two measurements.
    * \param enable_cpu_cache_flush Whether to flush cache on CPU between repeated measurements.
+   * \param max_repeat The maximum number of times to repeat the measurement.
+   * \param max_rel_ci The target half width of the confidence interval of the mean.
+   * \param cutoff_ratio The ratio of the best cost of a task past which a program is not measured
+   * further.
    */
   LocalRunner(int timeout, int number, int repeat, int min_repeat_ms, double cooldown_interval,
-              bool enable_cpu_cache_flush);
+              bool enable_cpu_cache_flush, int max_repeat = 0, double max_rel_ci = 0.02,
+              double cutoff_ratio = 0);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(LocalRunner, ProgramRunner, LocalRunnerNode);
 };
@@ -415,6 +444,12 @@ class RPCRunnerNode : public ProgramRunnerNode {
   int priority;
   /*! \brief The number of tasks run in parallel. */
   int n_parallel;
+  /*!
+   * \brief The number of programs measured in the same remote session. They are uploaded and
+   *  measured by pipelined calls, the results are received in order. 1 measures each program
+   *  in its own session, 0 sizes the batches from the queue of the tracker.
+   */
+  int batch_size;
 
   Array<MeasureResult> Run(const Array<MeasureInput>& inputs,
                            const Array<BuildResult>& build_results, int verbose) final;
@@ -443,10 +478,16 @@ class RPCRunner : public ProgramRunner {
    * \param min_repeat_ms The minimum duration of one repeat in milliseconds.
    * \param cooldown_interval The cool down interval between two measurements.
    * \param enable_cpu_cache_flush Whether to flush cache on CPU between repeated measurements.
+   * \param batch_size The number of programs measured in the same remote session.
+   * \param max_repeat The maximum number of times to repeat the measurement.
+   * \param max_rel_ci The target half width of the confidence interval of the mean.
+   * \param cutoff_ratio The ratio of the best cost of a task past which a program is not measured
+   * further.
    */
   RPCRunner(const String& key, const String& host, int port, int priority, int n_parallel,
             int timeout, int number, int repeat, int min_repeat_ms, double cooldown_interval,
-            bool enable_cpu_cache_flush);
+            bool enable_cpu_cache_flush, int batch_size = 1, int max_repeat = 0,
+            double max_rel_ci = 0.02, double cutoff_ratio = 0);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RPCRunner, ProgramRunner, RPCRunnerNode);
 };
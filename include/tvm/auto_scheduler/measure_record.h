@@ -29,7 +29,9 @@
 
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace auto_scheduler {
@@ -113,6 +115,136 @@ class RecordReader : public ObjectRef {
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RecordReader, ObjectRef, RecordReaderNode);
 };
 
+/*!
+ * \brief An append-only binary store of measure records, indexed by workload key and target.
+ *
+ *  Every entry holds the workload key, the target and the mean cost of its record next to the
+ *  json record, so that the index of the best records of every workload is built without
+ *  parsing the records. The index is saved next to the database and only the entries appended
+ *  since are scanned when the database is opened. Several processes can append to the same
+ *  database, the entries appended by others are picked up by Refresh.
+ */
+class RecordDatabaseNode : public Object {
+ public:
+  /*! \brief The path of the database file. */
+  String path;
+  /*! \brief The number of best records indexed for every workload key and target. */
+  int top_k;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path", &path);
+    v->Visit("top_k", &top_k);
+  }
+
+  /*!
+   * \brief Append measure records to the database.
+   * \param inputs The MeasureInputs to be written.
+   * \param results The MeasureResults to be written.
+   */
+  void Append(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results);
+
+  /*! \brief Index the entries appended to the database since the last refresh. */
+  void Refresh();
+
+  /*!
+   * \brief Get the best records of a workload on a target, by increasing mean cost. Only the
+   *  records of successful measurements are indexed.
+   * \param workload_key The workload key.
+   * \param target The string of the target.
+   * \param k The maximum number of records, at most top_k.
+   * \return The MeasureInputs and MeasureResults of the best records.
+   */
+  std::pair<Array<MeasureInput>, Array<MeasureResult>> GetTopK(const std::string& workload_key,
+                                                               const std::string& target, int k);
+
+  /*!
+   * \brief Get the best record of every workload key and target of the database.
+   * \return The MeasureInputs and MeasureResults of the best records.
+   */
+  std::pair<Array<MeasureInput>, Array<MeasureResult>> GetBestRecords();
+
+  /*! \brief Save the index next to the database, so that the next opening does not scan it. */
+  void SaveIndex();
+
+  /*!
+   * \brief Write the indexed records to a new database, dropping the others.
+   * \param out_path The path of the new database.
+   */
+  void Compact(const std::string& out_path);
+
+  static constexpr const char* _type_key = "auto_scheduler.RecordDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RecordDatabaseNode, Object);
+
+ private:
+  /*! \brief The best entries of a workload key and target. */
+  struct IndexEntry {
+    std::string workload_key;
+    std::string target;
+    /*! \brief The mean costs and offsets of the best entries, by increasing cost. */
+    std::vector<std::pair<double, uint64_t>> best;
+  };
+
+  /*! \brief Add an entry to the index. */
+  void Index(const std::string& workload_key, const std::string& target, double cost,
+             uint64_t offset);
+  /*! \brief Read the record of the entry at an offset. */
+  void ReadEntry(std::ifstream* is, uint64_t offset, MeasureInputNode* inp,
+                 MeasureResultNode* res) const;
+  /*! \brief Load the saved index, return whether it is valid for this database. */
+  bool LoadIndex();
+
+  /*! \brief The index, keyed by the workload key and the target. */
+  std::unordered_map<std::string, IndexEntry> index_;
+  /*! \brief The size of the database file covered by the index. */
+  uint64_t indexed_size_ = 0;
+
+  friend class RecordDatabase;
+};
+
+/*!
+ * \brief Managed reference to RecordDatabaseNode.
+ * \sa RecordDatabaseNode
+ */
+class RecordDatabase : public ObjectRef {
+ public:
+  /*!
+   * \brief Open a database, creating it if it does not exist.
+   * \param path The path of the database file.
+   * \param top_k The number of best records indexed for every workload key and target.
+   */
+  RecordDatabase(String path, int top_k);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RecordDatabase, ObjectRef, RecordDatabaseNode);
+};
+
+/*! \brief Callback for appending the input and results of measurements to a RecordDatabase */
+class RecordToDatabaseNode : public MeasureCallbackNode {
+ public:
+  /*! \brief The database. */
+  RecordDatabase database;
+
+  void Callback(const SearchPolicy& policy, const Array<MeasureInput>& inputs,
+                const Array<MeasureResult>& results) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.RecordToDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RecordToDatabaseNode, MeasureCallbackNode);
+};
+
+/*!
+ * \brief Managed reference to RecordToDatabaseNode.
+ * \sa RecordToDatabaseNode
+ */
+class RecordToDatabase : public MeasureCallback {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param database The database to append to.
+   */
+  explicit RecordToDatabase(RecordDatabase database);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(RecordToDatabase, MeasureCallback, RecordToDatabaseNode);
+};
+
 /*!
  * \brief Append measure records to an output stream.
  * \param os A pointer to a output stream.
@@ -168,6 +168,21 @@ class SearchPolicyNode : public Object {
    */
   void PreloadMeasuredStates(const String& log_file);
 
+  /*!
+   * \brief Preload the states measured for similar workloads, i.e. the same compute function or
+   *  compute DAG with different shapes, as starting points of the search. The transform steps of
+   *  the records are replayed on the current compute DAG with the split lengths adapted to the
+   *  new iterator extents. The adapted states are not marked as measured, so they can still be
+   *  measured for the current workload.
+   * \param log_file The name of the record log file.
+   * \param max_states The maximum number of states to load.
+   * \return The adapted states paired with the results measured for their source workloads.
+   *  The tasks of the inputs hold the current compute DAG with the workload key of the source
+   *  workload, so that the throughputs can be normalized per source workload.
+   */
+  std::pair<Array<MeasureInput>, Array<MeasureResult>> PreloadSimilarStates(
+      const String& log_file, int max_states);
+
   /*!
    * \brief Call SearchCallback with the current SearchPolicyNode
    * \param callbacks SearchCallback to be called.
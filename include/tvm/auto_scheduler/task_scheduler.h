@@ -0,0 +1,232 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/auto_scheduler/task_scheduler.h
+ * \brief The task scheduler that allocates the measurement trials when tuning multiple tasks
+ * together.
+ *
+ * The tasks can come from several models: the tasks of the same workload and target are tuned
+ * once, with the sum of their weights, i.e. of the number of times they are called in all the
+ * models. The trials are then allocated over the whole fleet to minimize the weighted sum of the
+ * latencies of the tasks.
+ *
+ * The details of the "gradient" strategy can be found in the section 6 of this paper:
+ * L. Zheng, C. Jia, M. Sun, Z. Wu, C. Yu, et al. "Ansor : Generating High-Performance Tensor
+ * Programs for Deep Learning." (OSDI 2020).
+ */
+
+#ifndef TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
+#define TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
+
+#include <tvm/auto_scheduler/measure.h>
+#include <tvm/auto_scheduler/search_policy.h>
+#include <tvm/auto_scheduler/search_task.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace auto_scheduler {
+
+/*! \brief The task scheduler that allocates the measurement trials among tasks. */
+class TaskSchedulerNode : public Object {
+ public:
+  /*! \brief The tasks to tune, one per workload and target. */
+  Array<SearchTask> tasks;
+  /*! \brief The weight of each task, the sum of the weights of its duplicates. */
+  std::vector<double> task_weights;
+  /*!
+   * \brief The objective minimized, taking the best costs of the tasks. The weighted sum of the
+   *  costs if null.
+   */
+  PackedFunc objective_func;
+  /*! \brief The scheduling strategy, "round-robin" or "gradient". */
+  String strategy;
+  /*! \brief The weight of the backward gradient in the "gradient" strategy. */
+  double alpha;
+  /*! \brief The speed ratio above which a task is not similar to the others of its group. */
+  double beta;
+  /*! \brief The number of rounds the backward gradient is computed over. */
+  int backward_window_size;
+
+  /*! \brief The number of total measurement trials. */
+  int num_measure_trials{0};
+  /*! \brief The number of programs measured in each round of a task. */
+  int num_measures_per_round{0};
+  /*! \brief Stop tuning when the score has not improved in this number of trials. */
+  int early_stopping_all{0};
+  /*! \brief Stop tuning a task when its cost has not improved in this number of trials. */
+  int early_stopping_task{0};
+  /*! \brief Verbosity level. 0 for silent. */
+  int verbose{0};
+
+  /*! \brief The number of rounds each task is tuned. */
+  std::vector<int> task_cts;
+  /*! \brief The round each task found its best cost. */
+  std::vector<int> task_best_cts;
+  /*! \brief The best cost of each task after each of its rounds. */
+  std::vector<std::vector<double>> task_costs_history;
+  /*! \brief The best cost of each task. */
+  std::vector<double> best_costs;
+  /*! \brief The tasks not tuned further, fully explored or not improving. */
+  std::unordered_set<int> dead_tasks;
+
+  /*! \brief The number of trials measured. */
+  int ct{0};
+  /*! \brief The number of trials when the best score was reached. */
+  int best_ct{0};
+  /*! \brief The current value of the objective. */
+  double cur_score{0};
+  /*! \brief The best value of the objective. */
+  double best_score{0};
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("tasks", &tasks);
+    v->Visit("strategy", &strategy);
+    v->Visit("num_measures_per_round", &num_measures_per_round);
+    v->Visit("ct", &ct);
+    v->Visit("best_ct", &best_ct);
+    v->Visit("cur_score", &cur_score);
+    v->Visit("best_score", &best_score);
+  }
+
+  /*!
+   * \brief Get the index of the task of the same workload and target as a task.
+   * \param task The task.
+   * \return The index in `tasks`, -1 if none.
+   */
+  int TaskIndex(const SearchTask& task) const;
+
+  /*!
+   * \brief Start a tuning session, keeping the rounds restored or tuned before.
+   * \param num_measure_trials The number of total measurement trials.
+   * \param num_measures_per_round The number of programs measured in each round of a task.
+   * \param early_stopping_all Stop tuning when the score has not improved in this number of
+   * trials, negative for never.
+   * \param early_stopping_task Stop tuning a task when its cost has not improved in this number
+   * of trials, negative for never.
+   * \param verbose Verbosity level. 0 for silent.
+   */
+  void Prepare(int num_measure_trials, int num_measures_per_round, int early_stopping_all,
+               int early_stopping_task, int verbose);
+
+  /*!
+   * \brief Restore the rounds and the best costs of the tasks from a record log file.
+   * \param log_file The name of the record log file.
+   */
+  void RestoreStatus(const String& log_file);
+
+  /*!
+   * \brief Choose the task to tune in the next round. The tasks never tuned are chosen first.
+   * \return The index of the task, -1 when the tuning is over.
+   */
+  int NextTask();
+
+  /*!
+   * \brief Record a round of a task.
+   * \param task_idx The index of the task.
+   * \param inputs The programs measured in the round.
+   * \param results The results of the programs.
+   */
+  void Update(int task_idx, const Array<MeasureInput>& inputs, const Array<MeasureResult>& results);
+
+  /*!
+   * \brief Tune the tasks until the tuning is over.
+   * \param search_policies The search policy of each task.
+   * \param measurer The measurer of the programs.
+   */
+  void Tune(const Array<SearchPolicy>& search_policies, ProgramMeasurer measurer);
+
+  /*!
+   * \brief Compute the objective.
+   * \param costs The cost of each task.
+   * \return The value of the objective.
+   */
+  double ComputeScore(const std::vector<double>& costs) const;
+
+  static constexpr const char* _type_key = "auto_scheduler.TaskScheduler";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TaskSchedulerNode, Object);
+
+ private:
+  /*! \brief The gradient of the objective with respect to the trials of a task. */
+  double Gradient(int task_idx) const;
+  /*! \brief Remove a task from its similarity group when it is slower than the group. */
+  void AdjustSimilarityGroup(int task_idx);
+
+  /*! \brief The index of the task of each workload and target. */
+  std::unordered_map<std::string, int> task_index_;
+  /*! \brief The similarity tag of each task, empty if similar to no other task. */
+  std::vector<std::string> task_tags_;
+  /*! \brief The tasks of each similarity tag. */
+  std::unordered_map<std::string, std::vector<int>> group_task_ids_;
+  /*! \brief Whether every task has been tuned once in this session. */
+  bool warmed_up_{false};
+  /*! \brief Whether the tuning stopped early. */
+  bool stopped_{false};
+  /*! \brief The task chosen last by the "round-robin" strategy. */
+  int rr_task_idx_{-1};
+  /*! \brief The random generator choosing among tasks of equal gradients. */
+  std::mt19937 rand_gen_{0};
+
+  friend class TaskScheduler;
+};
+
+/*!
+ * \brief Managed reference to TaskSchedulerNode.
+ * \sa TaskSchedulerNode
+ */
+class TaskScheduler : public ObjectRef {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param tasks The tasks to tune, possibly from several models. The tasks of the same workload
+   * and target are tuned once.
+   * \param task_weights The weight of each task, e.g. the number of times it is called. All 1 if
+   * empty.
+   * \param objective_func The objective minimized, taking the best costs of the tasks. The
+   * weighted sum of the costs if null.
+   * \param strategy The scheduling strategy, "round-robin" or "gradient".
+   * \param alpha The weight of the backward gradient in the "gradient" strategy.
+   * \param beta The speed ratio above which a task is not similar to the others of its group.
+   * \param backward_window_size The number of rounds the backward gradient is computed over.
+   */
+  TaskScheduler(Array<SearchTask> tasks, Array<FloatImm> task_weights,
+                PackedFunc objective_func, String strategy, double alpha, double beta,
+                int backward_window_size);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(TaskScheduler, ObjectRef, TaskSchedulerNode);
+};
+
+/*!
+ * \brief Derive the tag of a compute DAG for the similarity check of tasks, from the
+ *  "auto_scheduler_task_scheduler_tag" attributes of its operations and its flop count.
+ * \param dag The compute DAG.
+ * \param log_base The base of the log normalizing the flop count.
+ * \return The tag, empty if the DAG is similar to no other DAG.
+ */
+std::string DeriveSimilarityTag(const ComputeDAG& dag, double log_base = 1.618);
+
+}  // namespace auto_scheduler
+}  // namespace tvm
+
+#endif  // TVM_AUTO_SCHEDULER_TASK_SCHEDULER_H_
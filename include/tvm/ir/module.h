@@ -33,6 +33,7 @@
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -367,5 +368,66 @@ TVM_DLL String PrettyPrint(const ObjectRef& node);
  */
 TVM_DLL String AsText(const ObjectRef& node, bool show_meta_data = true,
                       runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr);
+
+/*!
+ * \brief Render the node as a string in the text format, with the meta data kept aside.
+ *
+ *  The text has no metadata section: the nodes it refers to as `meta[type_key][index]`, e.g. the
+ *  constants, are returned instead, to be saved in the binary format and given back to the
+ *  parser as the initial meta table.
+ *
+ * \param node The node to be rendered.
+ * \param meta_table The meta data of the text, by type key.
+ * \param annotate An optional callback function for attaching
+ *        additional comment block to an expr.
+ *
+ * \sa AsText.
+ * \return The text representation.
+ */
+TVM_DLL String AsTextWithMetaTable(const ObjectRef& node, Map<String, Array<ObjectRef>>* meta_table,
+                                   runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr);
+
+/*!
+ * \brief Write the node in the text format to a stream, e.g. to dump a module too large to be
+ *        rendered as a string.
+ *
+ *  The type definitions and functions of a module are printed by printers of their own, a few at
+ *  a time and in parallel, and written in order. The text parses to the module of AsText, but for
+ *  the names of the local variables and the meta nodes shared by several functions, which are
+ *  stored once per function.
+ *
+ * \param os The stream to write to.
+ * \param node The node to be rendered.
+ * \param show_meta_data Whether to print meta data section.
+ * \param annotate An optional callback function for attaching
+ *        additional comment block to an expr, the functions are then printed one at a time.
+ * \param num_threads The number of functions printed at once, 0 for the number of cores.
+ * \param elide_constant_bytes The constants of more bytes are printed as
+ *        `meta[relay.Constant][elided]` and left out of the meta data, 0 to keep all of them.
+ *        The text of elided constants does not parse.
+ *
+ * \sa AsText.
+ */
+TVM_DLL void PrintText(std::ostream& os, const ObjectRef& node, bool show_meta_data = true,
+                       runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr,
+                       int num_threads = 1, int64_t elide_constant_bytes = 0);
+
+/*!
+ * \brief Write the node in the text format to a file, with PrintText.
+ *
+ * \param node The node to be rendered.
+ * \param file_name The file to write to.
+ * \param show_meta_data Whether to print meta data section.
+ * \param annotate An optional callback function for attaching
+ *        additional comment block to an expr.
+ * \param num_threads The number of functions printed at once, 0 for the number of cores.
+ * \param elide_constant_bytes The constants of more bytes are elided, 0 to keep all of them.
+ *
+ * \sa PrintText.
+ */
+TVM_DLL void SaveText(const ObjectRef& node, const std::string& file_name,
+                      bool show_meta_data = true,
+                      runtime::TypedPackedFunc<String(ObjectRef)> annotate = nullptr,
+                      int num_threads = 1, int64_t elide_constant_bytes = 0);
 }  // namespace tvm
 #endif  // TVM_IR_MODULE_H_
@@ -29,6 +29,10 @@
 
 #include <string>
 
+namespace dmlc {
+class Stream;
+}  // namespace dmlc
+
 namespace tvm {
 /*!
  * \brief save the node as well as all the node it depends on as json.
@@ -47,5 +51,54 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief Save the node as well as all the nodes it depends on in a compact binary format.
+ *
+ *  Like SaveJSON, any TVM object can be saved. The format stores the field names
+ *  once per type and the tensors as raw data, aligned so that they can be mapped
+ *  in place by LoadBinaryFromFile.
+ *
+ * \param strm The stream to write to.
+ * \param node The node to save.
+ */
+TVM_DLL void SaveBinary(dmlc::Stream* strm, const runtime::ObjectRef& node);
+
+/*!
+ * \brief Save the node in the binary format.
+ * \param node The node to save.
+ * \return The bytes of the node.
+ */
+TVM_DLL std::string SaveBinary(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Save the node in the binary format to a file.
+ * \param file_name The name of the file.
+ * \param node The node to save.
+ */
+TVM_DLL void SaveBinaryToFile(const std::string& file_name, const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load a node saved by SaveBinary from a stream.
+ * \param strm The stream to read from, it is read sequentially.
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(dmlc::Stream* strm);
+
+/*!
+ * \brief Load a node saved by SaveBinary.
+ * \param blob The bytes of the node.
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(std::string blob);
+
+/*!
+ * \brief Load a node saved by SaveBinaryToFile.
+ * \param file_name The name of the file.
+ * \param use_mmap Whether the tensors point into a copy-on-write mapping of the file
+ *  instead of being copied, the mapping lives as long as the tensors.
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinaryFromFile(const std::string& file_name, bool use_mmap);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
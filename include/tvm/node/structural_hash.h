@@ -25,9 +25,12 @@
 
 #include <tvm/node/functor.h>
 #include <tvm/runtime/data_type.h>
+#include <tvm/support/with.h>
 
 #include <functional>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace tvm {
 
@@ -199,5 +202,82 @@ class SHashReducer {
   bool map_free_vars_;
 };
 
+/*!
+ * \brief Memoized hash values of subtrees, shared by StructuralHash calls.
+ *
+ *  Only the hash of subtrees which do not depend on their context is kept:
+ *  subtrees without free variables, variable definitions or graph nodes, such
+ *  as types, attributes and constants. Their hash is reused by any later hash
+ *  computed while the cache is the current one, which makes re-hashing a
+ *  function sharing large constants with previously hashed ones cheap.
+ *
+ *  The cache holds a reference to each node it records, so a node can only be
+ *  mutated through copy-on-write after being hashed, which creates a new node
+ *  and leaves the recorded one unchanged. Code mutating nodes in place while it
+ *  holds their only other reference must not use the cache.
+ */
+class SHashCacheNode : public runtime::Object {
+ public:
+  /*! \brief Number of lookups which found a recorded hash. */
+  int64_t hits{0};
+
+  /*!
+   * \brief Lookup the recorded hash of a node.
+   * \param key The node.
+   * \param hashed_value The recorded hash.
+   * \return Whether the node was recorded.
+   */
+  TVM_DLL bool Lookup(const ObjectRef& key, size_t* hashed_value);
+  /*!
+   * \brief Record the hash of a node.
+   * \param key The node.
+   * \param hashed_value The hash of the node.
+   */
+  TVM_DLL void Insert(const ObjectRef& key, size_t hashed_value);
+  /*! \return The number of recorded nodes. */
+  TVM_DLL size_t size();
+  /*! \brief Forget all the recorded nodes. */
+  TVM_DLL void Clear();
+
+  static constexpr const char* _type_key = "node.SHashCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SHashCacheNode, runtime::Object);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<ObjectRef, size_t, runtime::ObjectPtrHash, runtime::ObjectPtrEqual> table_;
+};
+
+/*!
+ * \brief Managed reference to SHashCacheNode.
+ *
+ *  The cache is opt-in: StructuralHash uses it within a scope
+ *
+ * \code
+ *  SHashCache cache = SHashCache::Create();
+ *  {
+ *    With<SHashCache> scope(cache);
+ *    size_t hash = StructuralHash()(func);
+ *  }
+ * \endcode
+ *
+ *  The scope is thread local, the same cache can be entered by several threads.
+ */
+class SHashCache : public ObjectRef {
+ public:
+  /*! \return A new empty cache. */
+  TVM_DLL static SHashCache Create();
+  /*! \return The cache of the innermost scope of the thread, nullptr if there is none. */
+  TVM_DLL static SHashCacheNode* Current();
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(SHashCache, ObjectRef, SHashCacheNode);
+
+ private:
+  // enable with syntax.
+  friend class With<SHashCache>;
+  friend class SHashCacheInternal;
+  TVM_DLL void EnterWithScope();
+  TVM_DLL void ExitWithScope();
+};
+
 }  // namespace tvm
 #endif  // TVM_NODE_STRUCTURAL_HASH_H_
@@ -23,6 +23,7 @@
  * \file parser.h
  * \brief A parser for TVM IR.
  */
+#include <tvm/ir/module.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
@@ -32,8 +33,18 @@
 namespace tvm {
 namespace parser {
 
+/*!
+ * \brief Parse a module in the text format.
+ * \param file_name The name of the source.
+ * \param file_content The text.
+ * \param init_module The module to add the definitions to, a new one if undefined.
+ * \param init_meta_table The meta data referred to by the text when it has no metadata section,
+ *  e.g. saved aside by AsTextWithMetaTable.
+ * \return The parsed module.
+ */
 IRModule ParseModule(std::string file_name, std::string file_content,
-                     Optional<IRModule> init_module = Optional<IRModule>());
+                     Optional<IRModule> init_module = Optional<IRModule>(),
+                     Optional<Map<String, Array<ObjectRef>>> init_meta_table = NullOpt);
 
 }  // namespace parser
 }  // namespace tvm
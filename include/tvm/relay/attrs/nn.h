@@ -1244,6 +1244,21 @@ struct LayerNormAttrs : public tvm::AttrsNode<LayerNormAttrs> {
   }
 };  // struct LayerNormAttrs
 
+/*! \brief Attributes used in rms_norm operator */
+struct RMSNormAttrs : public tvm::AttrsNode<RMSNormAttrs> {
+  int axis;
+  double epsilon;
+  bool scale;
+
+  TVM_DECLARE_ATTRS(RMSNormAttrs, "relay.attrs.RMSNormAttrs") {
+    TVM_ATTR_FIELD(axis).set_default(-1).describe("Specify which shape axis to normalize over.");
+    TVM_ATTR_FIELD(epsilon).set_default(1e-5).describe(
+        "Small float added to the mean square to avoid dividing by zero");
+    TVM_ATTR_FIELD(scale).set_default(true).describe(
+        "If true, multiply by gamma; otherwise, gamma is ignored.");
+  }
+};  // struct RMSNormAttrs
+
 /*! \brief Attributes used in group_norm operator */
 struct GroupNormAttrs : public tvm::AttrsNode<GroupNormAttrs> {
   int num_groups;
@@ -1463,6 +1478,20 @@ struct NLLLossAttrs : public tvm::AttrsNode<NLLLossAttrs> {
   }
 };  // struct NLLLossAttrs
 
+/*! \brief Attributes used in the fused attention operator */
+struct AttentionAttrs : public tvm::AttrsNode<AttentionAttrs> {
+  double scale;
+  bool causal;
+
+  TVM_DECLARE_ATTRS(AttentionAttrs, "relay.attrs.AttentionAttrs") {
+    TVM_ATTR_FIELD(scale).set_default(0).describe(
+        "The scale of the scores before the softmax, 0 for 1 / sqrt(head dimension).");
+    TVM_ATTR_FIELD(causal).set_default(false).describe(
+        "Whether a query only attends to the keys up to its position, the last query being "
+        "aligned with the last key.");
+  }
+};  // struct AttentionAttrs
+
 }  // namespace relay
 }  // namespace tvm
 #endif  // TVM_RELAY_ATTRS_NN_H_
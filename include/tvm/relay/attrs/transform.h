@@ -178,6 +178,28 @@ struct TakeAttrs : public tvm::AttrsNode<TakeAttrs> {
   }
 };
 
+/*! \brief Attributes used in embedding_bag operator */
+struct EmbeddingBagAttrs : public tvm::AttrsNode<EmbeddingBagAttrs> {
+  String mode;
+
+  TVM_DECLARE_ATTRS(EmbeddingBagAttrs, "relay.attrs.EmbeddingBagAttrs") {
+    TVM_ATTR_FIELD(mode).set_default("sum").describe(
+        "How the rows of a bag are reduced."
+        "sum - the sum of the rows, scaled by the per sample weights (default)"
+        "mean - the mean of the rows, zero for an empty bag"
+        "max - the maximum of the rows, zero for an empty bag");
+  }
+};
+
+/*! \brief Attributes used in einsum operator */
+struct EinsumAttrs : public tvm::AttrsNode<EinsumAttrs> {
+  String equation;
+
+  TVM_DECLARE_ATTRS(EinsumAttrs, "relay.attrs.EinsumAttrs") {
+    TVM_ATTR_FIELD(equation).describe("The einsum expression string");
+  }
+};
+
 /*! \brief Attributes that specify a tensor */
 struct InitOpAttrs : public tvm::AttrsNode<InitOpAttrs> {
   Optional<Array<Integer>> shape;
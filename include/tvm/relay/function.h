@@ -145,8 +145,26 @@ constexpr const char* kInline = "Inline";
 /*! \brief Indicate the function was created by the Pattern Partitioning Pass. */
 constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
 
+/*!
+ * \brief Mark a primitive function made of independent fused functions by HorizontalFuseOps,
+ *  whose kernels can be packed into a single launch.
+ */
+constexpr const char* kHorizontalFusion = "HorizontalFusion";
+
 /*! \brief Mark the function as only composed of reshape operations. */
 constexpr const char* kReshapeOnly = "relay.reshape_only";
+
+/*!
+ * \brief The storage scope of the outputs of a primitive function, e.g. "global.texture" for
+ *  the 2D images of OpenCL. The outputs are in flat global memory when it is not set.
+ */
+constexpr const char* kOutputStorageScope = "relay.output_storage_scope";
+
+/*!
+ * \brief Mark the call of a lowered function which only has elementwise and broadcast
+ *  operations, so that its output can be written over an argument of the same type.
+ */
+constexpr const char* kInplace = "relay.inplace";
 }  // namespace attr
 
 }  // namespace relay
@@ -100,6 +100,19 @@ struct DequantizeAttrs : public tvm::AttrsNode<DequantizeAttrs> {
   }
 };
 
+/*! \brief Attribute for the dense operator with packed int4 weights */
+struct DenseInt4Attrs : public tvm::AttrsNode<DenseInt4Attrs> {
+  IndexExpr units;
+  DataType out_dtype;
+
+  TVM_DECLARE_ATTRS(DenseInt4Attrs, "relay.attrs.DenseInt4Attrs") {
+    TVM_ATTR_FIELD(units).describe("Number of hidden units of the dense transformation.");
+    TVM_ATTR_FIELD(out_dtype)
+        .set_default(NullValue<DataType>())
+        .describe("Output data type, the type of the data if not set.");
+  }
+};
+
 }  // namespace qnn
 }  // namespace relay
 }  // namespace tvm
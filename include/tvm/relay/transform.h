@@ -113,6 +113,33 @@ TVM_DLL Pass SplitArgs(int max_function_args);
  */
 TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
 
+/*!
+ * \brief Merge the calls to independent injective fused functions at the same depth of
+ * the dataflow graph into calls to a single fused function returning a tuple.
+ *
+ * This reduces the number of kernel launches of models made of many small towers.
+ * It runs after FuseOps and is only enabled at opt_level 4 or when required.
+ *
+ * \param max_group_size The maximum number of fused functions merged together.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass HorizontalFuseOps(int max_group_size = 16);
+
+/*!
+ * \brief Rewrite main to compute only the new frames of a stream along a time axis.
+ *
+ * The first input of main becomes a chunk of hop new frames. The causal conv1d and the
+ * 1D pools keep the frames they still need in state inputs, returned updated after the
+ * outputs of main.
+ *
+ * \param hop The number of new frames of each call.
+ * \param time_axis The time axis of the first input of main.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass ToStreaming(int hop, int time_axis = 2);
+
 /*!
  * \brief The inverse operation of FuseOps. It transforms a fused program returned by
  * FuseOps into the program before FuseOps. (i.e. x == DefuseOps(FuseOps(x)))
@@ -131,6 +158,23 @@ TVM_DLL Pass DefuseOps();
  */
 TVM_DLL Pass RewriteAnnotatedOps(int fallback_device);
 
+/*!
+ * \brief Annotate the calls of main to run on the fallback device or on a second device,
+ * minimizing the latency of the calls and of the copies between the devices.
+ *
+ * The calls already annotated with on_device keep their device.
+ *
+ * \param fallback_device The fallback device, the calls placed there are not annotated.
+ * \param device The second device.
+ * \param cost_fn Returns the latency in microseconds of a call on a device type.
+ * \param transfer_gbps The bandwidth of the copies between the devices, in GB/s.
+ * \param transfer_latency_us The fixed latency of a copy, in microseconds.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass AutoDevicePlacement(int fallback_device, int device, runtime::PackedFunc cost_fn,
+                                 double transfer_gbps, double transfer_latency_us);
+
 /*!
  * \brief Turn an expression to Basic Block Normal Form.
  *
@@ -213,6 +257,10 @@ TVM_DLL Pass PartialEval();
  * of a batch norm which is indexed at tuple index 0 will be unpacked into a
  * number of simplified operators.
  *
+ * layer_norm and rms_norm are decomposed as well, unless the
+ * `relay.SimplifyInference.keep_norm` config is set, which keeps them for their
+ * single-pass fused kernels.
+ *
  * \return The Pass.
  */
 TVM_DLL Pass SimplifyInference();
@@ -235,6 +283,25 @@ TVM_DLL Pass FastMath();
  */
 TVM_DLL Pass DynamicToStatic();
 
+/*!
+ * \brief Specialize the main function for buckets of the extent of a dynamic input dimension.
+ *
+ * Main is copied once per bucket, with the dynamic dimension of the inputs typed as the bucket
+ * upper bound, and dispatches on the extent at run time: the inputs are padded to the smallest
+ * bucket the extent fits in, and the output dimensions of the bucket extent are sliced back. The
+ * extents beyond the last bucket run the generic function. Only valid for the models whose
+ * outputs at the valid positions do not depend on the padding.
+ *
+ * \param inputs The names of the inputs to bucket, mapped to their dynamic dimension. Every
+ * input is padded to the bucket of the largest extent among them.
+ * \param buckets The upper bounds of the buckets.
+ * \param pad_value The value the inputs are padded with.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass BucketDynamicShape(Map<String, Integer> inputs, Array<Integer> buckets,
+                                double pad_value = 0.0);
+
 /*!
  * \brief Infer the type of an expression.
  *
@@ -251,6 +318,10 @@ TVM_DLL Pass InferType();
  * two expressions evaluated to an identical value, a single variable is created
  * and these two expressions are replaced by this variable.
  *
+ * The calls to commutative operators with swapped arguments, the reshapes of an input to the
+ * same shape, the transposes by the same permutation and the calls to equal primitive functions
+ * are identical as well. The bodies of the primitive functions are visited, e.g. after FuseOps.
+ *
  * \param fskip The callback argument that allows to skip certain expressions.
  *
  * \return The pass.
@@ -330,6 +401,15 @@ TVM_DLL Pass CanonicalizeOps();
  */
 TVM_DLL Pass AlterOpLayout();
 
+/*!
+ * \brief Move the regions of elementwise and broadcast operators to the layout that needs the
+ * fewest layout_transforms at their boundary, e.g. the blocked layout of the convolutions around
+ * them after AlterOpLayout or ConvertLayout.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass MinimizeLayoutTransform();
+
 /*!
  * \brief Do layout rewrite according to the tile structure created by auto-scheduler.
  * \return The pass
@@ -426,6 +506,14 @@ TVM_DLL Pass RemoveUnusedFunctions(Array<runtime::String> entry_functions);
  */
 TVM_DLL Pass SimplifyExpr();
 
+/*!
+ * \brief Rewrite the attention computed as batch_matmul, softmax and batch_matmul, with an
+ * optional scaling of the scores by a constant, into the fused nn.attention operator.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass FuseAttention();
+
 /*!
  * \brief A pass for manifesting explicit memory allocations and rewriting
  * specific dialects.
@@ -437,6 +525,30 @@ TVM_DLL Pass SimplifyExpr();
  */
 TVM_DLL Pass ManifestAlloc(Target target_host, Map<tvm::Integer, tvm::Target> targets);
 
+/*!
+ * \brief Pack the storages of constant size allocated by the VM dialect into a
+ * few arenas, reusing memory between storages whose live ranges do not overlap.
+ *
+ * \note This pass must run after ManifestAlloc.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass PlanStaticMemory();
+
+/*!
+ * \brief Recompute the intermediates of the dataflow functions kept alive the longest, e.g. the
+ * forward activations read by a backward pass, until the bytes live at once fit the budget.
+ *
+ * The intermediates freeing the most bytes per multiply-accumulate recomputed are picked first,
+ * the others stay checkpointed. The build runs this pass after FuseOps when the
+ * `relay.backend.remat_memory_budget` option of the pass context is positive.
+ *
+ * \param memory_budget The bytes of intermediates allowed to be live at once.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass Rematerialize(int64_t memory_budget);
+
 }  // namespace transform
 
 /*!
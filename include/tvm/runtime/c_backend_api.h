@@ -166,6 +166,25 @@ TVM_DLL int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv);
  */
 TVM_DLL int TVMBackendRunOnce(void** handle, int (*f)(void*), void* cdata, int nbytes);
 
+/*!
+ * \brief Backend function called by the AOT executor before an operator call,
+ *  when the operators are profiled. Provided by the CRT AOT executor.
+ *
+ * \param call_index The index of the call in the run function.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendProfileBegin(int32_t call_index);
+
+/*!
+ * \brief Backend function called by the AOT executor after an operator call,
+ *  when the operators are profiled. Provided by the CRT AOT executor.
+ *
+ * \param call_index The index of the call in the run function.
+ * \param name The name of the called operator.
+ * \return 0 when no error is thrown, -1 when failure happens
+ */
+TVM_DLL int TVMBackendProfileEnd(int32_t call_index, const char* name);
+
 #ifdef __cplusplus
 }  // TVM_EXTERN_C
 #endif
@@ -170,6 +170,8 @@ typedef void* TVMRetValueHandle;
  * can be NULL, which indicates the default one.
  */
 typedef void* TVMStreamHandle;
+/*! \brief The event handle of a device, recording the completion of the work on a stream */
+typedef void* TVMEventHandle;
 /*! \brief Handle to Object. */
 typedef void* TVMObjectHandle;
 
@@ -503,6 +505,48 @@ TVM_DLL int TVMSynchronize(int device_type, int device_id, TVMStreamHandle strea
 TVM_DLL int TVMStreamStreamSynchronize(int device_type, int device_id, TVMStreamHandle src,
                                        TVMStreamHandle dst);
 
+/*!
+ * \brief Create a new event.
+ *
+ * \param device_type The device type.
+ * \param device_id The device id.
+ * \param out The new event handle.
+ * \return 0 when success, nonzero when failure happens
+ */
+TVM_DLL int TVMEventCreate(int device_type, int device_id, TVMEventHandle* out);
+
+/*!
+ * \brief Free a created event handle.
+ *
+ * \param device_type The device type.
+ * \param device_id The device id.
+ * \param event The event to be freed.
+ * \return 0 when success, nonzero when failure happens
+ */
+TVM_DLL int TVMEventFree(int device_type, int device_id, TVMEventHandle event);
+
+/*!
+ * \brief Record an event on a stream, completed when the work enqueued before it completes.
+ *
+ * \param device_type The device type.
+ * \param device_id The device id.
+ * \param event The event.
+ * \param stream The stream the event is recorded on.
+ * \return 0 when success, nonzero when failure happens
+ */
+TVM_DLL int TVMEventRecord(int device_type, int device_id, TVMEventHandle event,
+                           TVMStreamHandle stream);
+
+/*!
+ * \brief Wait until the work recorded by an event completes.
+ *
+ * \param device_type The device type.
+ * \param device_id The device id.
+ * \param event The event to be synchronized.
+ * \return 0 when success, nonzero when failure happens
+ */
+TVM_DLL int TVMEventSynchronize(int device_type, int device_id, TVMEventHandle event);
+
 /*!
  * \brief Get the type_index from an object.
  *
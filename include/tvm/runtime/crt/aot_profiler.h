@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file aot_profiler.h
+ * \brief Cycle counts of the operator calls of an AOT run.
+ *
+ * When a model is compiled with the "relay.backend.aot_profile" option, the AOT run function
+ * calls TVMBackendProfileBegin and TVMBackendProfileEnd around each operator. The cycles of
+ * the calls of the last run are kept in a static buffer, read from the device or through RPC.
+ */
+#ifndef TVM_RUNTIME_CRT_AOT_PROFILER_H_
+#define TVM_RUNTIME_CRT_AOT_PROFILER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+
+/*!
+ * \brief Get the number of operator calls profiled in the last run.
+ * \return The number of calls.
+ */
+uint32_t TVMAotProfiler_GetNumCalls();
+
+/*!
+ * \brief Get the profile of an operator call of the last run.
+ * \param call_index The index of the call.
+ * \param name Pointer to write the name of the operator into.
+ * \param cycles Pointer to write the cycles spent in the call into.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TVMAotProfiler_GetCall(uint32_t call_index, const char** name, uint64_t* cycles);
+
+/*!
+ * \brief Register the "tvm.aot_profiler.*" PackedFuncs, which read the profile through RPC.
+ */
+tvm_crt_error_t TVMAotProfiler_Register();
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_AOT_PROFILER_H_
@@ -56,6 +56,49 @@ typedef struct TVMGraphExecutorGraphAttr {
 
 typedef struct TVMGraphExecutor TVMGraphExecutor;
 
+/*! \brief An output of a node in a graph descriptor. */
+typedef struct TVMGraphExecutorEntryDescriptor {
+  uint32_t node_id;
+  uint32_t index;
+} TVMGraphExecutorEntryDescriptor;
+
+/*! \brief A node of a graph descriptor. */
+typedef struct TVMGraphExecutorNodeDescriptor {
+  /*! \brief "null" for the inputs and the params, "tvm_op" for the operators. */
+  const char* op_type;
+  const char* name;
+  /*! \brief The attributes of an operator, func_name is NULL for the other nodes. */
+  const char* func_name;
+  uint32_t num_inputs;
+  uint32_t num_outputs;
+  uint32_t flatten_data;
+  const TVMGraphExecutorEntryDescriptor* inputs;
+  uint32_t inputs_count;
+} TVMGraphExecutorNodeDescriptor;
+
+/*!
+ * \brief A graph compiled in the application, the graph executor reads it without parsing.
+ *
+ *  It holds the fields of the graph JSON, the attributes are given for each of the
+ *  entries_count entries, and the shapes of the entries follow each other in shape.
+ *  The descriptors are generated by tvm.micro.generate_graph_descriptor.
+ */
+typedef struct TVMGraphExecutorGraphDescriptor {
+  const TVMGraphExecutorNodeDescriptor* nodes;
+  uint32_t nodes_count;
+  const uint32_t* arg_nodes;
+  uint32_t arg_nodes_count;
+  const uint32_t* node_row_ptr;
+  uint32_t node_row_ptr_count;
+  const TVMGraphExecutorEntryDescriptor* heads;
+  uint32_t heads_count;
+  const uint32_t* storage_id;
+  const char* const* dltype;
+  const uint32_t* ndim;
+  const int64_t* shape;
+  uint32_t entries_count;
+} TVMGraphExecutorGraphDescriptor;
+
 // public functions
 /*!
  * \brief Allocate a new GraphExecutor with TVMPlatformMemoryAllocate and initialize it.
@@ -69,6 +112,20 @@ typedef struct TVMGraphExecutor TVMGraphExecutor;
 int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
                             const DLDevice* devices, TVMGraphExecutor** executor);
 
+/*!
+ * \brief Allocate a new GraphExecutor with TVMPlatformMemoryAllocate and initialize it
+ *  from a graph descriptor, without parsing a graph JSON.
+ *
+ * \param graph The graph descriptor.
+ * \param module_handle TVM Module that exposes the functions to call.
+ * \param devices runtime execution device.
+ * \param executor Pointer which receives a pointer to the newly-created instance.
+ * \return 0 if successful.
+ */
+int TVMGraphExecutor_CreateFromDescriptor(const TVMGraphExecutorGraphDescriptor* graph,
+                                          TVMModuleHandle module_handle, const DLDevice* devices,
+                                          TVMGraphExecutor** executor);
+
 int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name);
 
 /*!
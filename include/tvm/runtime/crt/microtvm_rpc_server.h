@@ -61,6 +61,8 @@ microtvm_rpc_server_t MicroTVMRpcServerInit(microtvm_rpc_channel_write_t write_f
                                             void* write_func_ctx);
 
 /*! \brief Do any tasks suitable for the main thread, and maybe process new incoming data.
+ *
+ * The data committed to the receive ring buffer is processed first, then `new_data`.
  *
  * \param server The TVM RPC Server pointer.
  * \param new_data If not nullptr, a pointer to a buffer pointer, which should point at new input
@@ -72,6 +74,27 @@ microtvm_rpc_server_t MicroTVMRpcServerInit(microtvm_rpc_channel_write_t write_f
 tvm_crt_error_t MicroTVMRpcServerLoop(microtvm_rpc_server_t server, uint8_t** new_data,
                                       size_t* new_data_size_bytes);
 
+/*! \brief Get the contiguous free region of the receive ring buffer of the server.
+ *
+ * Lets a DMA engine or an interrupt handler write the received data in place, to be processed by
+ * the next calls to MicroTVMRpcServerLoop. The ring buffer size is set by
+ * TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES in crt_config.h.
+ *
+ * \param server The TVM RPC Server pointer.
+ * \param region Set to the start of the free region.
+ * \return The size of the free region, in bytes. 0 when the ring buffer is full.
+ */
+size_t MicroTVMRpcServerReceiveRegion(microtvm_rpc_server_t server, uint8_t** region);
+
+/*! \brief Mark data written in the region returned by MicroTVMRpcServerReceiveRegion as received.
+ *
+ * Can be called from an interrupt handler, while the main thread runs MicroTVMRpcServerLoop.
+ *
+ * \param server The TVM RPC Server pointer.
+ * \param num_bytes The number of bytes written, at most the size of the region.
+ */
+void MicroTVMRpcServerReceiveCommit(microtvm_rpc_server_t server, size_t num_bytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -97,6 +97,19 @@ tvm_crt_error_t TVMPlatformTimerStart();
  */
 tvm_crt_error_t TVMPlatformTimerStop(double* elapsed_time_seconds);
 
+/*! \brief Read a free running cycle counter of the device.
+ *
+ * The counter is read around each operator call when the AOT executor profiles the
+ * operators, it should be cheap to read and wrap around as an unsigned integer. It does
+ * not need to count CPU cycles exactly, any fixed frequency counter may be used.
+ *
+ * This function does not need to be implemented unless the operators are profiled.
+ *
+ * \param cycles Pointer to write the counter value into.
+ * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+ */
+tvm_crt_error_t TVMPlatformReadCycleCounter(uint64_t* cycles);
+
 /*! \brief Fill a buffer with random data.
  *
  * Cryptographically-secure random data is NOT required. This function is intended for use
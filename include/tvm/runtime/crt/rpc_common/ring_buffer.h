@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/runtime/crt/rpc_common/ring_buffer.h
+ * \brief Defines a ring buffer receiving the RPC traffic on the device.
+ *
+ * The buffer hands out the contiguous free regions of its storage, so that a DMA engine or an
+ * interrupt handler can write the received bytes in place, while the main loop unframes them
+ * from the contiguous filled regions. The write side and the read side each update only their
+ * own cursor, so one producer and one consumer can use it without a lock.
+ */
+
+#ifndef TVM_RUNTIME_CRT_RPC_COMMON_RING_BUFFER_H_
+#define TVM_RUNTIME_CRT_RPC_COMMON_RING_BUFFER_H_
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+namespace tvm {
+namespace runtime {
+namespace micro_rpc {
+
+class RingBuffer {
+ public:
+  /*!
+   * \brief Construct a RingBuffer.
+   * \param data The storage of the buffer.
+   * \param data_size_bytes The size of the storage, in bytes. Must be a power of 2.
+   */
+  RingBuffer(uint8_t* data, size_t data_size_bytes)
+      : data_{data}, capacity_{data_size_bytes}, write_cursor_{0}, read_cursor_{0} {}
+
+  /*!
+   * \brief Get the contiguous free region following the written bytes.
+   * \param region Set to the start of the region.
+   * \return The size of the region, in bytes. 0 when the buffer is full.
+   */
+  size_t WriteRegion(uint8_t** region) const;
+
+  /*!
+   * \brief Mark bytes written in the region returned by WriteRegion as available to read.
+   * \param data_size_bytes The number of bytes written, at most the size of the region.
+   */
+  void CommitWrite(size_t data_size_bytes);
+
+  /*!
+   * \brief Copy data into the buffer.
+   * \param data The data to write.
+   * \param data_size_bytes The number of bytes in data.
+   * \return The number of bytes copied, less than data_size_bytes when the buffer is full.
+   */
+  size_t Write(const uint8_t* data, size_t data_size_bytes);
+
+  /*!
+   * \brief Get the contiguous region of bytes available to read.
+   * \param region Set to the start of the region.
+   * \return The size of the region, in bytes. 0 when the buffer is empty.
+   */
+  size_t ReadRegion(const uint8_t** region) const;
+
+  /*!
+   * \brief Release bytes read from the region returned by ReadRegion.
+   * \param data_size_bytes The number of bytes read, at most the size of the region.
+   */
+  void CommitRead(size_t data_size_bytes);
+
+  /*! \brief The number of bytes available to read. */
+  size_t ReadAvailable() const { return write_cursor_ - read_cursor_; }
+
+  /*! \brief The number of free bytes. */
+  size_t WriteAvailable() const { return capacity_ - ReadAvailable(); }
+
+ private:
+  /*! \brief pointer to data buffer. */
+  uint8_t* data_;
+
+  /*! \brief The total number of bytes available in data_. Always a power of 2. */
+  size_t capacity_;
+
+  /*! \brief The number of bytes ever written, the write position modulo capacity_. */
+  volatile size_t write_cursor_;
+
+  /*! \brief The number of bytes ever read, the read position modulo capacity_. */
+  volatile size_t read_cursor_;
+};
+
+}  // namespace micro_rpc
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CRT_RPC_COMMON_RING_BUFFER_H_
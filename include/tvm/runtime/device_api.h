@@ -117,6 +117,10 @@ class TVM_DLL DeviceAPI {
    * \brief copy data from one place to another
    * \note This API is designed to support special memory with shape dependent layout.
    *       We pass in DLTensor* with shape information to support these cases.
+   *
+   *  The arrays may be strided, e.g. a slice of a batch, in which case both must have the same
+   *  shape and dtype. A strided copy is decomposed into 2D copies of rows that are contiguous in
+   *  both arrays, see CopyDataFromTo2D, so that no staging copy is made.
    * \param from The source array.
    * \param to The target array.
    * \param stream Optional stream object.
@@ -163,6 +167,32 @@ class TVM_DLL DeviceAPI {
    */
   virtual void SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst);
   /*!
+   * \brief Create an event, which records the completion of the work enqueued on a stream.
+   *
+   *  The default events wait for the whole stream they are recorded on.
+   * \param dev The device of the event.
+   * \return The event.
+   */
+  virtual TVMEventHandle CreateEvent(Device dev);
+  /*!
+   * \brief Free an event.
+   * \param dev The device of the event.
+   * \param event The event to be freed.
+   */
+  virtual void FreeEvent(Device dev, TVMEventHandle event);
+  /*!
+   * \brief Record an event on a stream, completed when the work enqueued before it is.
+   * \param dev The device of the event and the stream.
+   * \param event The event.
+   * \param stream The stream, nullptr for the default stream.
+   */
+  virtual void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream);
+  /*!
+   * \brief Wait until the work recorded by an event completes.
+   * \param dev The device of the event.
+   * \param event The event.
+   */
+  virtual void EventSync(Device dev, TVMEventHandle event);  /*!
    * \brief Allocate temporal workspace for backend execution.
    *
    *  \note We have the following assumption about backend temporal
@@ -221,6 +251,27 @@ class TVM_DLL DeviceAPI {
   virtual void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset,
                               size_t num_bytes, Device dev_from, Device dev_to,
                               DLDataType type_hint, TVMStreamHandle stream);
+  /*!
+   * \brief copy rows of data from one place to another, the rows being evenly spaced in both.
+   *
+   *  The default implementation copies the rows one by one with the flat CopyDataFromTo.
+   * \param from The source array.
+   * \param from_offset The byte offeset of the first row in the from.
+   * \param from_pitch The bytes between the starts of two rows in the from.
+   * \param to The target array.
+   * \param to_offset The byte offset of the first row in the to.
+   * \param to_pitch The bytes between the starts of two rows in the to.
+   * \param width The size of a row in bytes, not greater than the pitches.
+   * \param height The number of rows.
+   * \param dev_from The source device
+   * \param dev_to The target device
+   * \param type_hint The type of elements, only neded by certain backends.
+   * \param stream Optional stream object.
+   */
+  virtual void CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch, void* to,
+                                size_t to_offset, size_t to_pitch, size_t width, size_t height,
+                                Device dev_from, Device dev_to, DLDataType type_hint,
+                                TVMStreamHandle stream);
 };
 
 /*! \brief The device type bigger than this is RPC device */
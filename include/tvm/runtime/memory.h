@@ -40,13 +40,78 @@ namespace runtime {
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args);
 
+/*!
+ * \brief A scope in which make_object allocates the small objects from a thread-local arena.
+ *
+ *  The arena hands out the memory of large chunks in order, and frees a chunk once all the
+ *  objects allocated in it are freed. This saves the allocator calls and keeps the objects
+ *  created together close in memory, e.g. the short-lived nodes of a compiler pass. The objects
+ *  can outlive the scope and be freed from any thread: they keep their chunk alive.
+ *
+ *  A thread-confined scope also updates the reference counters of the objects it allocates
+ *  without atomic operations, until the scope exits. Until then, these objects must only be
+ *  referenced from the thread of the scope: support::parallel_for runs its tasks on the calling
+ *  thread in such a scope. The objects outliving the scope are shared as any other object after
+ *  it, and the memory of the objects freed in the scope is kept until it exits.
+ *
+ * \code
+ *
+ *  {
+ *    ObjectArenaScope arena_scope;
+ *    // The nodes created here are allocated from the arena.
+ *  }
+ *
+ * \endcode
+ * \note A chunk is only freed with all its objects, so the scope suits the passes creating many
+ *  temporary objects rather than a few long-lived ones.
+ */
+class ObjectArenaScope {
+ public:
+  /*!
+   * \brief Enter the scope.
+   * \param thread_confined Whether the objects are referenced only from the current thread until
+   * the scope exits.
+   */
+  TVM_DLL explicit ObjectArenaScope(bool thread_confined = false);
+  TVM_DLL ~ObjectArenaScope();
+  ObjectArenaScope(const ObjectArenaScope&) = delete;
+  ObjectArenaScope& operator=(const ObjectArenaScope&) = delete;
+
+ private:
+  /*! \brief Whether the scope is thread-confined. */
+  bool thread_confined_;
+};
+
+/*!
+ * \brief Allocate memory from the arena of the current thread.
+ * \param size The size of the memory.
+ * \param alignment The alignment of the memory.
+ * \return The memory, nullptr when no ObjectArenaScope is active or the size is too large.
+ */
+TVM_DLL void* ObjectArenaAlloc(size_t size, size_t alignment);
+
+/*!
+ * \brief Free memory allocated by ObjectArenaAlloc, from any thread.
+ * \param data The memory.
+ */
+TVM_DLL void ObjectArenaFree(void* data);
+
+/*!
+ * \brief Confine a new object allocated from the arena to the current thread, when the current
+ * thread is in a thread-confined ObjectArenaScope.
+ * \param obj The object.
+ */
+TVM_DLL void ObjectArenaTrack(Object* obj);
+
+/*! \return Whether the current thread is in a thread-confined ObjectArenaScope. */
+TVM_DLL bool ObjectArenaIsThreadConfined();
+
 // Detail implementations after this
 //
 // The current design allows swapping the
 // allocator pattern when necessary.
 //
 // Possible future allocator optimizations:
-// - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
 // - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
 
@@ -191,13 +256,74 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+// Allocator that constructs an object in the memory given by the arena of the current thread.
+class ArenaObjAllocator : public ObjAllocatorBase<ArenaObjAllocator> {
+ public:
+  explicit ArenaObjAllocator(void* data) : data_(data) {}
+
+  template <typename T>
+  class Handler {
+   public:
+    template <typename... Args>
+    static T* New(ArenaObjAllocator* self, Args&&... args) {
+      return new (self->data_) T(std::forward<Args>(args)...);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      ObjectArenaFree(tptr);
+    }
+  };
+
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    template <typename... Args>
+    static ArrayType* New(ArenaObjAllocator* self, size_t num_elems, Args&&... args) {
+      return new (self->data_) ArrayType(std::forward<Args>(args)...);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      ObjectArenaFree(tptr);
+    }
+  };
+
+ private:
+  /*! \brief The memory of the object to be allocated. */
+  void* data_;
+};
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
+  if (void* data = ObjectArenaAlloc(sizeof(T), alignof(T))) {
+    ObjectPtr<T> ptr = ArenaObjAllocator(data).make_object<T>(std::forward<Args>(args)...);
+    ObjectArenaTrack(ptr.get());
+    return ptr;
+  }
   return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
+  static_assert(alignof(ArrayType) % alignof(ElemType) == 0 &&
+                    sizeof(ArrayType) % alignof(ElemType) == 0,
+                "element alignment constraint");
+  size_t size = sizeof(ArrayType) + num_elems * sizeof(ElemType);
+  if (void* data = ObjectArenaAlloc(size, alignof(ArrayType))) {
+    ObjectPtr<ArrayType> ptr = ArenaObjAllocator(data).make_inplace_array<ArrayType, ElemType>(
+        num_elems, std::forward<Args>(args)...);
+    ObjectArenaTrack(ptr.get());
+    return ptr;
+  }
   return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
                                                                       std::forward<Args>(args)...);
 }
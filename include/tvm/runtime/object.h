@@ -259,6 +259,11 @@ class TVM_DLL Object {
   uint32_t type_index_{0};
   /*! \brief The internal reference counter */
   RefCounterType ref_counter_{0};
+  /*!
+   * \brief The bit of the reference counter marking an object referenced only from the thread
+   * creating it, whose counter is updated without atomic operations. See ObjectArenaScope.
+   */
+  static constexpr int32_t kThreadConfinedBit = 1 << 30;
   /*!
    * \brief deleter of this object to enable customized allocation.
    * If the deleter is nullptr, no deletion will be performed.
@@ -789,10 +794,23 @@ struct ObjectPtrEqual {
 // Object reference counting.
 #if TVM_OBJECT_ATOMIC_REF_COUNTER
 
-inline void Object::IncRef() { ref_counter_.fetch_add(1, std::memory_order_relaxed); }
+inline void Object::IncRef() {
+  int32_t count = ref_counter_.load(std::memory_order_relaxed);
+  if (count & kThreadConfinedBit) {
+    ref_counter_.store(count + 1, std::memory_order_relaxed);
+  } else {
+    ref_counter_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
 
 inline void Object::DecRef() {
-  if (ref_counter_.fetch_sub(1, std::memory_order_release) == 1) {
+  int32_t count = ref_counter_.load(std::memory_order_relaxed);
+  if (count & kThreadConfinedBit) {
+    ref_counter_.store(count - 1, std::memory_order_relaxed);
+    if (count - 1 == kThreadConfinedBit && this->deleter_ != nullptr) {
+      (*this->deleter_)(this);
+    }
+  } else if (ref_counter_.fetch_sub(1, std::memory_order_release) == 1) {
     std::atomic_thread_fence(std::memory_order_acquire);
     if (this->deleter_ != nullptr) {
       (*this->deleter_)(this);
@@ -800,7 +818,9 @@ inline void Object::DecRef() {
   }
 }
 
-inline int Object::use_count() const { return ref_counter_.load(std::memory_order_relaxed); }
+inline int Object::use_count() const {
+  return ref_counter_.load(std::memory_order_relaxed) & ~kThreadConfinedBit;
+}
 
 #else
 
@@ -171,6 +171,14 @@ class ReportNode : public Object {
    * because these metrics include the overhead of the executor.
    */
   Map<String, Map<String, ObjectRef>> device_metrics;
+  /*! \brief Regions of time recorded when the profiler records a timeline,
+   *  ordered by start time. Empty otherwise.
+   *
+   * Each element has a "Name", the "Process" (e.g. the device) and "Thread"
+   * (e.g. the worker or the stream) it is shown on, a "Category", and its
+   * "Start (us)" since the start of the profiler and "Duration (us)".
+   */
+  Array<Map<String, ObjectRef>> timeline;
   /*! \brief Output `calls` in CSV format.
    *
    * Note that this does not include `device_metrics`, it only includes per-call metrics.
@@ -184,6 +192,14 @@ class ReportNode : public Object {
    *  `aggregate` is true.
    */
   String AsTable(bool sort = true, bool aggregate = true) const;
+  /*! \brief Output `timeline` in the Chrome trace event JSON format, which can
+   *  be loaded in chrome://tracing or https://ui.perfetto.dev.
+   */
+  String AsChromeTrace() const;
+  /*! \brief Output `timeline` as a binary Perfetto trace (a serialized
+   *  `perfetto.protos.Trace` of track events).
+   */
+  std::string AsPerfetto() const;
 
   static constexpr const char* _type_key = "runtime.profiling.Report";
   TVM_DECLARE_FINAL_OBJECT_INFO(ReportNode, Object);
@@ -194,12 +210,56 @@ class Report : public ObjectRef {
   /*! Construct a Report from a set of calls (with associated metrics) and per-device metrics.
    * \param calls Function calls and associated metrics.
    * \param device_metrics Per-device metrics for overall execution.
+   * \param timeline Regions of time recorded during execution.
    */
   explicit Report(Array<Map<String, ObjectRef>> calls,
-                  Map<String, Map<String, ObjectRef>> device_metrics);
+                  Map<String, Map<String, ObjectRef>> device_metrics,
+                  Array<Map<String, ObjectRef>> timeline = {});
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(Report, ObjectRef, ReportNode);
 };
 
+/*! \brief Interface for collecting additional metrics, e.g. hardware counters,
+ *  around each call and over the whole run of a `Profiler`.
+ *
+ * A collector is initialized once with the devices of the profiling run. For
+ * every region profiled on a device, `Start` is called before the region and
+ * `Stop` after it with the object returned by `Start`. `Start` may return a
+ * null object when the device is not supported by the collector, in which case
+ * `Stop` is not called. Like timers, `Start` and `Stop` should be as
+ * lightweight as possible, since their overhead is included in the execution
+ * time of the profiled region.
+ *
+ * Metrics returned by `Stop` appear as extra columns of the `Report`.
+ */
+class MetricCollectorNode : public Object {
+ public:
+  /*! \brief Initialize the collector for a profiling run.
+   * \param devs The devices profiled in the run.
+   */
+  virtual void Init(const std::vector<Device>& devs) = 0;
+  /*! \brief Start collecting metrics for a region running on a device.
+   * \param dev The device the region runs on.
+   * \return The state passed to `Stop`, or a null object if `dev` is not supported.
+   */
+  virtual ObjectRef Start(Device dev) = 0;
+  /*! \brief Stop collecting metrics for a region.
+   * \param obj The object returned by the matching `Start`.
+   * \return The metrics collected for the region, keyed by their column name.
+   */
+  virtual Map<String, ObjectRef> Stop(ObjectRef obj) = 0;
+
+  virtual ~MetricCollectorNode() {}
+
+  static constexpr const char* _type_key = "runtime.profiling.MetricCollector";
+  TVM_DECLARE_BASE_OBJECT_INFO(MetricCollectorNode, Object);
+};
+
+/*! \brief Wrapper for `MetricCollectorNode`. */
+class MetricCollector : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(MetricCollector, ObjectRef, MetricCollectorNode);
+};
+
 /*! Information about a single function or operator call. */
 struct CallFrame {
   /*! Device on which the call was made */
@@ -210,8 +270,44 @@ struct CallFrame {
   Timer timer;
   /*! Extra performance metrics */
   std::unordered_map<std::string, ObjectRef> extra_metrics;
+  /*! The state of the metric collectors started for this call */
+  std::vector<std::pair<MetricCollector, ObjectRef>> extra_collectors;
+  /*! Host time of the start of the call, see `TimelineNanos` */
+  int64_t start_ns{0};
+  /*! Timeline id of the thread which made the call */
+  int thread_id{0};
 };
 
+/*! \brief A region of time recorded on a thread while a timeline is recorded. */
+struct TimelineEvent {
+  /*! Name of the region */
+  std::string name;
+  /*! Timeline id of the thread the region ran on, see `TimelineThreadId` */
+  int thread_id;
+  /*! Start of the region, see `TimelineNanos` */
+  int64_t begin_ns;
+  /*! End of the region */
+  int64_t end_ns;
+};
+
+/*! \brief The host clock of timelines, in nanoseconds. */
+TVM_DLL int64_t TimelineNanos();
+/*! \brief Whether a profiler is currently recording a timeline.
+ *
+ * Code running on threads which are not visible to the profiler, like the
+ * tasks of the thread pool, should only call `RecordTimelineEvent` when this
+ * is true.
+ */
+TVM_DLL bool IsTimelineRecording();
+/*! \brief Record a region of time run by the calling thread.
+ * \param name The name of the region.
+ * \param begin_ns The start of the region, from `TimelineNanos`.
+ * \param end_ns The end of the region, from `TimelineNanos`.
+ */
+TVM_DLL void RecordTimelineEvent(std::string name, int64_t begin_ns, int64_t end_ns);
+/*! \brief A small sequential id of the calling thread, used to name its timeline track. */
+TVM_DLL int TimelineThreadId();
+
 /*! Runtime profiler for function and/or operator calls. Used in the graph
  * runtime and VM to provide profiling information for all operators.
  *
@@ -229,9 +325,24 @@ struct CallFrame {
  * prof.Stop();
  * std::cout << prof.Report << std::endl; // print profiling report
  * \endcode
+ *
+ * Additional metrics, like hardware performance counters, are collected by
+ * passing `MetricCollector`s to the constructor.
+ *
+ * When recording a timeline, the report also holds the start and end of every
+ * call on the track of its device, and of the tasks the thread pool ran on each
+ * worker, to look at the overlap and the gaps between them.
  */
 class Profiler {
  public:
+  /*! \brief Create a profiler.
+   * \param collectors Additional metric collectors, started and stopped
+   *                   around every call and over the whole run.
+   * \param record_timeline Whether to record the timeline of the calls and of
+   *                        the parallel tasks between `Start` and `Stop`.
+   */
+  explicit Profiler(std::vector<MetricCollector> collectors = {}, bool record_timeline = false)
+      : collectors_(std::move(collectors)), record_timeline_(record_timeline) {}
   /*! \brief Start the profiler.
    * \param devs The list of devices the profiler will be running on. Should
    *             include all devices used by profiled operators.
@@ -273,6 +384,22 @@ class Profiler {
   bool IsRunning() const { return !global_timers_.empty(); }
 
  private:
+  /*! \brief Start every collector for dev, returning the started ones. */
+  std::vector<std::pair<MetricCollector, ObjectRef>> StartCollectors(Device dev);
+  /*! \brief Stop started collectors, adding their metrics to metrics. */
+  static void StopCollectors(const std::vector<std::pair<MetricCollector, ObjectRef>>& started,
+                             std::unordered_map<std::string, ObjectRef>* metrics);
+
+  std::vector<MetricCollector> collectors_;
+  bool record_timeline_;
+  /*! \brief The host time of Start and Stop when recording a timeline. */
+  int64_t timeline_start_ns_{0};
+  int64_t timeline_stop_ns_{0};
+  /*! \brief The events of other threads recorded between Start and Stop. */
+  std::vector<TimelineEvent> thread_events_;
+  /*! \brief Metrics of the collectors over the whole run, per device. */
+  std::vector<std::vector<std::pair<MetricCollector, ObjectRef>>> global_collectors_;
+  std::vector<std::unordered_map<std::string, ObjectRef>> global_metrics_;
   std::vector<std::pair<Device, Timer>> global_timers_;
   std::vector<CallFrame> calls_;
   std::stack<CallFrame> in_flight_;
@@ -301,6 +301,7 @@ class Registry {
    * \param name The name of the function.
    * \return pointer to the registered function,
    *   nullptr if it does not exist.
+   * \note The lookup does not take a lock, it can be called concurrently with the registrations.
    */
   TVM_DLL static const PackedFunc* Get(const std::string& name);  // NOLINT(*)
   /*!
@@ -309,8 +310,48 @@ class Registry {
    */
   TVM_DLL static std::vector<std::string> ListNames();
 
-  // Internal class.
+  // Internal classes.
   struct Manager;
+  struct Entry;
+
+  /*!
+   * \brief A handle of the global function registered under a name.
+   *
+   *  The handle stays valid for the lifetime of the program, and follows the overrides and
+   *  removals of the function, so it can be looked up once and cached by the callers on a hot
+   *  path, instead of looking up the function on each call.
+   *
+   * \code
+   *
+   * static const Registry::Handle handle = Registry::GetHandle("runtime.MyFunc");
+   * const PackedFunc* f = handle.Get();
+   * ICHECK(f != nullptr) << "runtime.MyFunc is not registered";
+   *
+   * \endcode
+   */
+  class Handle {
+   public:
+    /*!
+     * \brief Get the function currently registered under the name.
+     * \return pointer to the registered function, nullptr if it does not exist.
+     */
+    TVM_DLL const PackedFunc* Get() const;
+    /*! \return The name of the function. */
+    TVM_DLL const std::string& name() const;
+
+   private:
+    explicit Handle(const Entry* entry) : entry_(entry) {}
+    /*! \brief The entry of the name in the registry */
+    const Entry* entry_;
+    friend class Registry;
+  };
+
+  /*!
+   * \brief Get the handle of a global function name.
+   * \param name The name of the function, which need not be registered yet.
+   * \return The handle.
+   */
+  TVM_DLL static Handle GetHandle(const std::string& name);
 
  protected:
   /*! \brief name of the function */
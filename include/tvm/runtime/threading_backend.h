@@ -26,6 +26,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace tvm {
@@ -75,10 +76,13 @@ class ThreadGroup {
    *        If  `true`, worker0 will not be launched in a new thread and
    *        `worker_callback` will only be called for values >= 1. This
    *        allows use of the main thread as a worker.
+   * \param cpus The cpu ids the workers are bound to, in the order of the worker ids.
+   *        If not empty, it takes precedence over `mode`.
    *
    * \return The number of workers to use.
    */
-  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0);
+  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
+                const std::vector<unsigned int>& cpus = {});
 
  private:
   Impl* impl_;
@@ -94,6 +98,81 @@ void Yield();
  */
 int MaxConcurrency();
 
+/*!
+ * \brief Get the cpus of a NUMA node.
+ * \param node The id of the NUMA node.
+ * \return The cpu ids of the node, empty if it cannot be determined on this platform.
+ */
+std::vector<unsigned int> NUMANodeCPUs(int node);
+
+/*!
+ * \return The number of NUMA nodes of the system, 1 if it cannot be determined on this platform.
+ */
+int NUMANodeCount();
+
+/*!
+ * \brief Place the CPU allocations of the calling thread on a NUMA node.
+ *
+ *  The CPU device allocations of a page or more are bound to the node before their pages are
+ *  touched, so that the storage of an executor created on the thread is local to the cores that
+ *  run it. The smaller allocations share pages and keep the default policy.
+ *
+ * \param node The id of the NUMA node, -1 for the default policy of the system.
+ * \return The node the allocations were placed on before.
+ */
+int SetAllocNUMANode(int node);
+
+/*!
+ * \return The NUMA node the CPU allocations of the calling thread are placed on, -1 for the
+ *  default policy of the system.
+ */
+int GetAllocNUMANode();
+
+/*!
+ * \brief Create a named thread pool with one worker bound to each of the given cpus.
+ *
+ *  Unlike the default pool of a thread, a named pool can be shared by several threads,
+ *  whose parallel requests are then served one at a time.
+ *
+ * \param name The name of the pool.
+ * \param cpus The cpu ids the workers are bound to.
+ * \param numa_node The NUMA node of the cpus, or -1. The allocations of the workers, and of the
+ *  threads in a ThreadPoolScope of the pool, are then placed on the node.
+ */
+void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus,
+                      int numa_node = -1);
+
+/*!
+ * \brief Routes the parallel requests of the calling thread to a named thread pool
+ *  during the lifetime of the scope.
+ *
+ * \code
+ *
+ *  void Executor::Run() {
+ *    threading::ThreadPoolScope scope(thread_pool_name_);
+ *    // TVMBackendParallelLaunch in here runs on the named pool.
+ *  }
+ *
+ * \endcode
+ */
+class ThreadPoolScope {
+ public:
+  /*!
+   * \param name The name of the pool created by CreateThreadPool.
+   *        An empty name keeps the current pool.
+   */
+  explicit ThreadPoolScope(const std::string& name);
+  ~ThreadPoolScope();
+
+ private:
+  /*! \brief The pool requests were routed to before entering the scope. */
+  void* prev_pool_{nullptr};
+  /*! \brief The NUMA node the allocations were placed on before entering the scope. */
+  int prev_numa_node_{-1};
+  /*! \brief Whether the scope changed the pool. */
+  bool active_{false};
+};
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
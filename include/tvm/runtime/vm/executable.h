@@ -31,7 +31,10 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/vm/bytecode.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -53,6 +56,15 @@ struct VMFunction;
  *  - Primitive name section, containing the function name of the primitive ops
  *  used by the virtual machine.
  *  - Code section, handling the VM functions and bytecode.
+ *
+ * The constants and the bytecode of the functions are stored with offset tables,
+ * so that a loaded executable only deserializes them on first use, see
+ * GetConstant and GetVMFunction.
+ *
+ * The executable is immutable once built or loaded and can be shared by the VMs
+ * of several threads: the kernels looked up in the library and the constants
+ * copied to the devices are kept in it, see GetPackedFuncs and GetDeviceConstant,
+ * so that a VM only holds its frames and registers.
  */
 class Executable : public ModuleNode {
  public:
@@ -172,12 +184,49 @@ class Executable : public ModuleNode {
    */
   std::string GetFunctionParameterName(std::string func, uint32_t index) const;
 
+  /*!
+   * \brief Get a VM function, decoding its bytecode on first use in a loaded executable.
+   * \param index The index of the function in the function table.
+   * \return The function.
+   * \note The name and parameters of the functions in `functions` are always loaded,
+   *  their instructions are only valid once returned by this function.
+   */
+  const VMFunction& GetVMFunction(Index index) const;
+
+  /*!
+   * \brief Get a constant, deserializing it on first use in a loaded executable.
+   * \param index The index of the constant in the constant pool.
+   * \return The constant.
+   */
+  const ObjectRef& GetConstant(Index index) const;
+
+  /*!
+   * \brief Get a constant on a device, copied on first use and shared by the VMs of the
+   *  executable.
+   * \param index The index of the constant in the constant pool.
+   * \param dev The device.
+   * \return The constant on the device.
+   */
+  ObjectRef GetDeviceConstant(Index index, Device dev) const;
+
+  /*!
+   * \brief Get the kernels of the primitive functions, looked up in the library on first use.
+   * \return The kernel of each index of `primitive_map`.
+   */
+  const std::vector<PackedFunc>& GetPackedFuncs() const;
+
+  /*! \brief Deserialize all the constants and functions which were not used yet. */
+  void LoadAllSections() const;
+
+  /*! \brief The number of constants and functions which were deserialized. */
+  std::pair<size_t, size_t> NumLoadedSections() const;
+
   virtual ~Executable() {}
 
   const char* type_key() const final { return "VMExecutable"; }
 
-  /*! \brief The global constant pool. */
-  std::vector<ObjectRef> constants;
+  /*! \brief The global constant pool, filled in on demand by GetConstant. */
+  mutable std::vector<ObjectRef> constants;
   /*! \brief A map from globals (as strings) to their index in the function map. */
   std::unordered_map<std::string, Index> global_map;
   /*! \brief A mapping from the packed function (as string) to the index that
@@ -186,8 +235,8 @@ class Executable : public ModuleNode {
   std::unordered_map<std::string, Index> primitive_map;
   /*! \brief The structural hashes of the operators in this function. */
   std::map<Index, Map<String, ObjectRef>> op_attrs;
-  /*! \brief The virtual machine's function table. */
-  std::vector<VMFunction> functions;
+  /*! \brief The virtual machine's function table, decoded on demand by GetVMFunction. */
+  mutable std::vector<VMFunction> functions;
   /*! \brief The device type for each constant. */
   std::vector<Index> const_device_type;
 
@@ -232,7 +281,7 @@ class Executable : public ModuleNode {
    *
    * \param strm The input stream.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(dmlc::SeekStream* strm);
 
   /*!
    * \brief Load primitive op names.
@@ -246,10 +295,37 @@ class Executable : public ModuleNode {
    *
    * \param strm The input stream.
    */
-  void LoadCodeSection(dmlc::Stream* strm);
+  void LoadCodeSection(dmlc::SeekStream* strm);
+
+  /*! \brief Deserialize a constant of a loaded executable. */
+  void LoadConstant(Index index) const;
+
+  /*! \brief Decode the instructions of a function of a loaded executable. */
+  void LoadFunction(Index index) const;
+
+  /*! \brief A constant or function which is deserialized on first use. */
+  struct LazyEntry {
+    /*! \brief The range of its serialized form in code_. */
+    size_t begin{0};
+    size_t end{0};
+    /*! \brief The number of instructions of a function. */
+    size_t num_instructions{0};
+    std::atomic<bool> loaded{false};
+  };
 
   /*! \brief The serialized bytecode. */
   std::string code_;
+  /*! \brief The entries of a loaded executable, nullptr when everything is loaded. */
+  std::unique_ptr<LazyEntry[]> lazy_constants_;
+  std::unique_ptr<LazyEntry[]> lazy_functions_;
+  /*! \brief Serializes the deserialization of the entries. */
+  mutable std::mutex lazy_mutex_;
+  /*! \brief The kernels of the primitive functions, empty until GetPackedFuncs. */
+  mutable std::vector<PackedFunc> packed_funcs_;
+  /*! \brief The constants of each device, keyed by the type and id of the device. */
+  mutable std::map<std::pair<int, int>, std::vector<ObjectRef>> device_constants_;
+  /*! \brief Guards packed_funcs_ and device_constants_. */
+  mutable std::mutex shared_mutex_;
 };
 
 }  // namespace vm
@@ -41,6 +41,10 @@
 
 namespace tvm {
 namespace runtime {
+
+class OpLatencySampler;
+class ResultCache;
+
 namespace vm {
 
 /*!
@@ -123,6 +127,13 @@ struct VMFrame {
   /*! \brief Register in caller's frame to put return value */
   RegName caller_return_register;
 
+  /*! \brief The slot of the function in the result cache, -1 if the result is not memoized. */
+  int64_t cache_slot{-1};
+  /*! \brief The hash of the arguments the result is memoized with. */
+  uint64_t cache_key{0};
+  /*! \brief The tensors of the arguments the result is memoized with. */
+  std::vector<NDArray> cache_inputs;
+
   VMFrame(Index pc, Index func_index, Index args, const Instruction* code, Index register_file_size)
       : pc(pc),
         func_index(func_index),
@@ -132,6 +143,17 @@ struct VMFrame {
         caller_return_register(0) {}
 };
 
+/*!
+ * \brief A run of allocation instructions, optionally closed by an InvokePacked,
+ * executed by a single dispatch of the interpreter.
+ */
+struct SuperInstruction {
+  /*! \brief The number of instructions in the run, 0 if no run starts at this pc. */
+  Index length{0};
+  /*! \brief The storage registers only read inside the run, which are not written back. */
+  std::vector<RegName> local_storages;
+};
+
 /*!
  * \brief The virtual machine.
  *
@@ -176,6 +198,17 @@ class VirtualMachine : public runtime::ModuleNode {
    */
   virtual void LoadExecutable(const Executable* exec);
 
+  /*!
+   * \brief Create a VM of the same executable, devices and configuration, with its own frames,
+   *  registers and inputs.
+   *
+   *  The kernels and the device constants are shared through the executable, so that a VM per
+   *  thread is cheap to create. The clone does not sample latencies nor return bound outputs, and
+   *  the executable must outlive it.
+   * \return The new VM.
+   */
+  ObjectPtr<VirtualMachine> Clone() const;
+
  protected:
   /*! \brief Push a call frame on to the call stack. */
   void PushFrame(Index arg_count, Index ret_pc, const VMFunction& vm_func);
@@ -248,6 +281,45 @@ class VirtualMachine : public runtime::ModuleNode {
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
 
+  /*!
+   * \brief Configure how the dispatch loop runs the bytecode.
+   * \param superinstructions Whether to execute the runs of allocations ending in an
+   *  InvokePacked as superinstructions.
+   * \param threaded Whether to jump from handler to handler through a computed goto
+   *  table instead of the central switch, when the compiler supports it.
+   */
+  void ConfigureDispatch(bool superinstructions, bool threaded);
+
+  /*! \brief Find the superinstruction runs of a function. */
+  static std::vector<SuperInstruction> BuildSuperInstructions(const VMFunction& func);
+
+  /*! \brief Execute the superinstruction starting at the current pc. */
+  void RunSuperInstruction(const SuperInstruction& super);
+
+  /*! \brief Execute an AllocStorage instruction. */
+  Storage ExecAllocStorage(const Instruction& instr);
+
+  /*! \brief Execute an AllocTensor or AllocTensorReg instruction on the given storage. */
+  NDArray ExecAllocTensor(const Instruction& instr, const Storage& storage);
+
+  /*! \brief Execute an InvokePacked instruction. */
+  void ExecInvokePacked(const Instruction& instr);
+
+  /*!
+   * \brief Have the invocations of a function return the given arrays, which its kernels write
+   *  into instead of the tensors the function allocates for its outputs.
+   *
+   *  The outputs are traced from the Ret of the function to the AllocTensor instructions. The
+   *  functions with control flow, and the outputs which are parameters, constants or reshapes,
+   *  cannot be bound.
+   * \param func_name The name of the function.
+   * \param outputs The arrays, one per output, none to allocate the outputs again.
+   */
+  void SetOutputs(const std::string& func_name, const std::vector<NDArray>& outputs);
+
+  /*! \brief Point code_ to the given instructions, with their superinstructions if any. */
+  void SetCode(const Instruction* code);
+
   /*! \brief Get device from the device list based on a given device type. */
   Device GetDevice(Index device_type) const;
 
@@ -258,6 +330,18 @@ class VirtualMachine : public runtime::ModuleNode {
    */
   void InvokeGlobal(const VMFunction& func, const std::vector<ObjectRef>& args);
 
+  /*!
+   * \brief Invoke a global, unless its result is memoized for the arguments.
+   *
+   *  On a miss of a memoized function, the result is memoized when the function returns.
+   * \param func_index The index of the function.
+   * \param args The arguments.
+   * \param result The memoized result on a hit.
+   * \return Whether the result was memoized, no frame is pushed then.
+   */
+  bool InvokeGlobalCached(Index func_index, const std::vector<ObjectRef>& args,
+                          ObjectRef* result);
+
  protected:
   /*! \brief The virtual machine's packed function table. */
   std::vector<PackedFunc> packed_funcs_;
@@ -284,6 +368,42 @@ class VirtualMachine : public runtime::ModuleNode {
    * object to avoid rellocation of constants during inference.
    */
   std::vector<ObjectRef> const_pool_;
+  /*!
+   * \brief Whether the tensor constants are interned in the process-wide constant store, so
+   *  that the VMs of the process share the identical ones, set by "share_constants".
+   */
+  bool share_constants_{false};
+  /*! \brief The named thread pool the kernels run on, empty for the default pool. */
+  std::string thread_pool_;
+  /*! \brief Whether the runs of allocations are executed as superinstructions. */
+  bool superinstructions_{false};
+  /*! \brief The superinstructions of each invoked function, keyed by its code, when enabled. */
+  std::unordered_map<const Instruction*, std::vector<SuperInstruction>> super_instructions_;
+  /*! \brief The superinstructions of the current function, nullptr if none. */
+  const SuperInstruction* supers_{nullptr};
+  /*! \brief Whether the dispatch loop uses computed gotos. */
+  bool threaded_dispatch_{false};
+  /*!
+   * \brief When set, the storages and device copies created by the dispatch loop are
+   *  appended to it, so that their memory outlives the invocation.
+   */
+  std::vector<ObjectRef>* retained_objects_{nullptr};
+  /*!
+   * \brief Latency histograms of the kernels of the sampled invocations, set by the
+   *  "set_sampling_interval" function.
+   */
+  std::shared_ptr<OpLatencySampler> sampler_;
+  /*! \brief Whether the kernels of the invocation in flight are timed. */
+  bool sampling_{false};
+  /*!
+   * \brief The memoized results of the functions set by the "set_result_cache" function,
+   *  keyed by the content of their arguments.
+   */
+  std::shared_ptr<ResultCache> result_cache_;
+  /*! \brief The slot in result_cache_ of each memoized function, by function index. */
+  std::unordered_map<Index, int64_t> cached_functions_;
+  /*! \brief The arrays set by SetOutputs, keyed by the instruction allocating the output. */
+  std::unordered_map<const Instruction*, NDArray> bound_outputs_;
 };
 
 }  // namespace vm
@@ -187,6 +187,13 @@ TVM_DLL size_t CalculateExprComplexity(const PrimExpr& expr);
 TVM_DLL size_t CalculateWorkspaceBytes(const PrimFunc& func,
                                        const Integer& workspace_byte_alignment);
 
+/*!
+ * \brief Estimate the bank conflicts of the shared buffers of a PrimFunc before StorageFlatten.
+ * \param func The PrimFunc, with its shared buffers realized.
+ * \return The worst bank conflict degree of the warp accesses of each shared buffer, 1 for none.
+ */
+TVM_DLL Map<Buffer, Integer> SharedMemoryBankConflicts(const PrimFunc& func);
+
 /*!
  * \brief Detect the lowest common ancestor(LCA) of buffer access, including both high-level
  *        access(BufferLoad, BufferStore) and low-level access(Load, Store and opaque access).
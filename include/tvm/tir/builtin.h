@@ -555,6 +555,80 @@ TVM_DLL const Op& tvm_mma_sync();
  */
 TVM_DLL const Op& tvm_bmma_sync();
 
+/*!
+ * \brief tvm intrinsic for the sparse tensor core mma of 2:4 structured sparse matrices.
+ *
+ *  void ptx_mma_sp(StringImm shape, StringImm A_layout, StringImm B_layout,
+ *                  StringImm A_dtype, StringImm B_dtype, StringImm C_dtype,
+ *                  Var multiplicand_a, Expr a_index,
+ *                  Var multiplicand_b, Expr b_index,
+ *                  Var accumulator, Expr c_index,
+ *                  Var metadata, Expr meta_index,
+ *                  IntImm sparse_selector) {
+ *    // The buffers hold the fragments of the thread, A compressed to half of its columns.
+ *    // metadata holds the 2-bit column indices of the nonzeros of the groups of four.
+ *    asm("mma.sp.sync.aligned.{shape}.row.col.{C_dtype}.{A_dtype}.{B_dtype}.{C_dtype} "
+ *        "{accumulator}, {multiplicand_a}, {multiplicand_b}, {accumulator}, "
+ *        "metadata, sparse_selector;");
+ *  }
+ */
+TVM_DLL const Op& ptx_mma_sp();
+
+/*!
+ * \brief tvm intrinsic for the tensor core mma of the registers of a warp.
+ *
+ *  void ptx_mma(StringImm shape, StringImm A_layout, StringImm B_layout,
+ *               StringImm A_dtype, StringImm B_dtype, StringImm C_dtype,
+ *               Var multiplicand_a, Expr a_index,
+ *               Var multiplicand_b, Expr b_index,
+ *               Var accumulator, Expr c_index) {
+ *    // The buffers hold the fragments of the thread.
+ *    asm("mma.sync.aligned.{shape}.row.col.{C_dtype}.{A_dtype}.{B_dtype}.{C_dtype} "
+ *        "{accumulator}, {multiplicand_a}, {multiplicand_b}, {accumulator};");
+ *  }
+ */
+TVM_DLL const Op& ptx_mma();
+
+/*!
+ * \brief tvm intrinsic loading 8x8 matrices of 16-bit elements of shared memory into the
+ *  fragments of a warp.
+ *
+ *  void ptx_ldmatrix(Bool trans, IntImm num, Var local_ptr, Expr local_index,
+ *                    Var smem_ptr, Expr smem_index) {
+ *    // num is 1, 2 or 4. Each lane gives the address of a row, of the matrix lane / 8.
+ *    asm("ldmatrix.sync.aligned.m8n8.x{num}{.trans}.shared.b16 {local_ptr}, [smem_ptr];");
+ *  }
+ */
+TVM_DLL const Op& ptx_ldmatrix();
+
+/*!
+ * \brief tvm intrinsic for the async copy of global memory into shared memory of CUDA sm_80.
+ *
+ *  void ptx_cp_async(Expr dst_access_ptr, Expr src_access_ptr, IntImm bytes) {
+ *    // bytes is 4, 8 or 16, the copy completes with its commit group.
+ *    asm("cp.async.{ca|cg}.shared.global [dst], [src], bytes;");
+ *  }
+ */
+TVM_DLL const Op& ptx_cp_async();
+
+/*!
+ * \brief tvm intrinsic committing the pending async copies of the thread as a group.
+ *
+ *  void ptx_commit_group() {
+ *    asm("cp.async.commit_group;");
+ *  }
+ */
+TVM_DLL const Op& ptx_commit_group();
+
+/*!
+ * \brief tvm intrinsic waiting until at most n commit groups of the thread are pending.
+ *
+ *  void ptx_wait_group(IntImm n) {
+ *    asm("cp.async.wait_group n;");
+ *  }
+ */
+TVM_DLL const Op& ptx_wait_group();
+
 /*!
  * \brief tvm intrinsic for tensor core fill_fragment operators.
  *
@@ -580,6 +654,20 @@ TVM_DLL const Op& tvm_fill_fragment();
  */
 TVM_DLL const Op& tvm_store_matrix_sync();
 
+/*!
+ * \brief Configure the tile registers of Intel AMX.
+ *
+ *  void amx_tile_config(UIntImm rows_0, UIntImm colsb_0,
+ *                       UIntImm rows_1, UIntImm colsb_1, ...) {
+ *    // Tile i holds rows_i rows of colsb_i bytes, the palette is 1.
+ *    _tile_loadconfig(config);
+ *  }
+ *
+ *  The configuration is loaded once at the entry of the enclosing function, so all the
+ *  calls of a function must use the same configuration.
+ */
+TVM_DLL const Op& amx_tile_config();
+
 // TODO(tvm-team) replace the usage of the vector operations by Shuffle.
 /*!
  * \brief Get the high level half of the vector
@@ -268,6 +268,14 @@ constexpr const char* kNoAlias = "tir.noalias";
  */
 constexpr const char* kIsEntryFunc = "tir.is_entry_func";
 
+/*!
+ * \brief Mark the function as lowered from independent computations, whose
+ *  kernels can be packed into a single kernel by HorizontalFuseKernels.
+ *
+ * Type: Integer
+ */
+constexpr const char* kHorizontalFusion = "tir.horizontal_fusion";
+
 /*!
  * \brief Parameters used in the module that should be linked by the codegen.
  *
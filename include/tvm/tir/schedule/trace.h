@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_TIR_SCHEDULE_TRACE_H_
+#define TVM_TIR_SCHEDULE_TRACE_H_
+
+#include <tvm/node/node.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+
+namespace tvm {
+namespace tir {
+
+class Schedule;
+
+/**************** Instruction ****************/
+
+/*!
+ * \brief A schedule instruction, i.e. an invocation of a schedule primitive recorded in a trace
+ *
+ * The inputs are the random variables the primitive is invoked with, or `None` for an omitted
+ * random variable. The attributes are the other arguments, e.g. the name of a block or a
+ * storage scope. The outputs are the random variables the primitive returns.
+ */
+class InstructionNode : public runtime::Object {
+ public:
+  /*! \brief The name of the schedule primitive, e.g. "Split" */
+  String kind;
+  /*! \brief The random variables the primitive is invoked with */
+  Array<ObjectRef> inputs;
+  /*! \brief The non-random-variable arguments of the primitive */
+  Array<ObjectRef> attrs;
+  /*! \brief The random variables the primitive returns */
+  Array<ObjectRef> outputs;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("kind", &kind);
+    v->Visit("inputs", &inputs);
+    v->Visit("attrs", &attrs);
+    v->Visit("outputs", &outputs);
+  }
+
+  static constexpr const char* _type_key = "tir.Instruction";
+  TVM_DECLARE_FINAL_OBJECT_INFO(InstructionNode, runtime::Object);
+};
+
+/*!
+ * \brief Managed reference to InstructionNode
+ * \sa InstructionNode
+ */
+class Instruction : public runtime::ObjectRef {
+ public:
+  /*!
+   * \brief Constructor
+   * \param kind The name of the schedule primitive
+   * \param inputs The random variables the primitive is invoked with
+   * \param attrs The non-random-variable arguments of the primitive
+   * \param outputs The random variables the primitive returns
+   */
+  TVM_DLL explicit Instruction(String kind, Array<ObjectRef> inputs, Array<ObjectRef> attrs,
+                               Array<ObjectRef> outputs);
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(Instruction, runtime::ObjectRef, InstructionNode);
+};
+
+/**************** Trace ****************/
+
+/*!
+ * \brief The trace of a schedule, i.e. the sequence of the instructions applied to it
+ *
+ * A trace is replayed on a fresh schedule of the same IRModule to reproduce the scheduled
+ * IRModule, where the random variables of the trace are mapped to the ones their replayed
+ * instructions create.
+ */
+class TraceNode : public runtime::Object {
+ public:
+  /*! \brief The instructions, in the order they are applied */
+  Array<Instruction> insts;
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("insts", &insts); }
+
+  static constexpr const char* _type_key = "tir.Trace";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TraceNode, runtime::Object);
+
+ public:
+  /*!
+   * \brief Append an instruction to the end of the trace
+   * \param inst The instruction to be appended
+   */
+  TVM_DLL void Append(Instruction inst);
+  /*!
+   * \brief Apply the trace to a schedule
+   * \param sch The schedule to be applied onto, usually a fresh schedule of the IRModule the trace
+   * is recorded on
+   */
+  TVM_DLL void ApplyToSchedule(Schedule sch) const;
+  /*!
+   * \brief Serialize the trace as a sequence of python statements
+   * \return The python statements, one per instruction, invoking the methods of `sch`
+   */
+  TVM_DLL Array<String> AsPython() const;
+};
+
+/*!
+ * \brief Managed reference to TraceNode
+ * \sa TraceNode
+ */
+class Trace : public runtime::ObjectRef {
+ public:
+  /*! \brief Default constructor, creating an empty trace */
+  TVM_DLL Trace();
+  /*!
+   * \brief Constructor
+   * \param insts The instructions of the trace
+   */
+  TVM_DLL explicit Trace(Array<Instruction> insts);
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(Trace, runtime::ObjectRef, TraceNode);
+};
+
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_SCHEDULE_TRACE_H_
@@ -1335,6 +1335,13 @@ constexpr const char* hand_threaded = "hand_threaded";
  *       if (mask & 2) the write region should be detected.
  */
 constexpr const char* script_parsing_detect_access = "tir.script_parsing_detect_access";
+
+/*!
+ * \brief Mark a loop, annotated on the For, to be vectorized by the backend with length
+ *  agnostic scalable vectors (e.g. SVE, RVV), with the tail handled by predication.
+ *  The loop is kept serial in TIR instead of being expanded to fixed width lanes.
+ */
+constexpr const char* scalable_vectorize = "tir.scalable_vectorize";
 /*!
  * \brief Check if attr_key is a pragma key extension
  * \param attr_key The attr key to be compared
@@ -63,6 +63,38 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Insert software prefetches for the strided loads of the innermost CPU loops.
+ *
+ *  A load whose address advances by at least a cache line per iteration is prefetched a
+ *  number of iterations ahead derived from the memory latency and the cost of an iteration,
+ *  see the "tir.InjectSoftwarePrefetch" pass config. Only the functions of LLVM targets are
+ *  changed.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
+/*!
+ * \brief Tile the unscheduled reduction loop nests of the CPU functions for the caches.
+ *
+ *  The spatial loops are tiled for the L2 and L1 caches given by the "l1-cache-size" and
+ *  "l2-cache-size" attributes of the target, in bytes, and the unit stride point loop is
+ *  vectorized. Run VectorizeLoop after it.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass AutoTile();
+
+/*!
+ * \brief Pad the rows of the shared buffers to reduce the bank conflicts of their warp accesses.
+ *
+ *  Runs before StorageFlatten. The buffers aligned by the schedule are left as is.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass PadSharedMemory();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -108,6 +140,12 @@ TVM_DLL Pass LiftAttrScope(String attr_key);
 /*!
  * \brief partition loops in the stmt.
  *
+ * The "tir.LoopPartition" PassContext config selects the conditions partitioned on. With
+ * partition_if_then_else the conjuncts of the if_then_else and if conditions are, besides
+ * the likely ones, and max_code_growth bounds the growth of the function. With
+ * record_decisions the partitions are listed in the "tir.loop_partition_decisions" attribute
+ * of the function, for a pass instrument to inspect.
+ *
  * \return The pass.
  */
 TVM_DLL Pass LoopPartition();
@@ -115,6 +153,14 @@ TVM_DLL Pass LoopPartition();
 /*!
  * \brief Lower vectorization loops.
  *
+ * With the "tir.vectorize_scalable" PassContext option, the vectorized loops are kept serial
+ * and annotated with attr::scalable_vectorize, for the LLVM backend to emit length agnostic
+ * (vscale based) vectors with a predicated tail.
+ *
+ * With the "tir.vectorize_predicate_tail" PassContext option, the stores guarded by a vector
+ * condition, such as the bound check of a split that does not divide its extent, become
+ * predicated stores instead of a scalarized loop.
+ *
  * \param enable_vectorize Whether vectorization is enabled.
  *
  * \return The pass.
@@ -251,6 +297,14 @@ TVM_DLL Pass LowerCustomDatatypes();
  */
 TVM_DLL Pass DecorateDeviceScope();
 
+/*!
+ * \brief Pack the consecutive independent kernels of the functions marked with
+ *  attr::kHorizontalFusion into single kernels, dispatching on the block index.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass HorizontalFuseKernels();
+
 /*!
  * \brief Split the function into a host function and device functions.
  *
@@ -357,6 +411,30 @@ TVM_DLL Pass PointerValueTypeRewrite();
  */
 TVM_DLL Pass HoistIfThenElse();
 
+/*!
+ * \brief Hoist the loop invariant expressions out of the loops into LetStmts.
+ *
+ *  The maximal pure subexpressions of a loop body that use no var defined in the loop, and
+ *  that cannot trap, are bound right outside the outermost loop they are invariant in. With
+ *  record_stats in the "tir.LoopInvariantCodeMotion" pass config, the number of operations
+ *  removed from the loops is recorded in the "tir.licm_removed_ops" attribute of the function.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass LoopInvariantCodeMotion();
+
+/*!
+ * \brief Bind the repeated pure expressions to LetStmts.
+ *
+ *  The repeated scalar expressions that are pure and cannot trap are replaced from the largest
+ *  one with new vars, bound at the top of the scope of the statements they appear in, see the
+ *  "tir.CommonSubexprElim" pass config. tvm.build runs it on the functions generated as C-like
+ *  source unless "tir.disable_cse" is set.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass CommonSubexprElim();
+
 /*!
  * \brief Lower block init stmt into IfThenElse stmts
  * \return The pass.
@@ -19,7 +19,7 @@
 
 /*!
  * \file cuda/normalization.h
- * \brief CUDA schedule for LRN and l2 normalization operations
+ * \brief CUDA schedule for LRN, l2, layer and RMS normalization operations
  */
 #ifndef TVM_TOPI_CUDA_NORMALIZATION_H_
 #define TVM_TOPI_CUDA_NORMALIZATION_H_
@@ -27,6 +27,9 @@
 #include <tvm/target/generic_func.h>
 #include <tvm/te/operation.h>
 #include <tvm/te/schedule_pass.h>
+#include <tvm/topi/cuda/injective.h>
+#include <tvm/topi/detail/fuse.h>
+#include <tvm/topi/nn/layer_norm.h>
 #include <tvm/topi/tags.h>
 
 namespace tvm {
@@ -69,6 +72,72 @@ inline Schedule schedule_lrn(const Array<Tensor>& outs) {
   return s;
 }
 
+/*!
+ * \brief Create a CUDA schedule for layer_norm and rms_norm, with the injective producers of the
+ * data, e.g. a residual add, fused into the kernel
+ *
+ * When the normalization is over the innermost axis, a thread block normalizes a row: the
+ * statistics are reduced across the threads of the block and the row is normalized by the same
+ * threads, so the data is read from global memory twice and written once, in one kernel.
+ * Otherwise the statistics and the output are computed by two kernels.
+ *
+ * \param target The target to generate a schedule for.
+ * \param outs The output tensors.
+ *
+ * \return A schedule for the given ops.
+ */
+inline Schedule schedule_layer_norm(const Target& target, const Array<Tensor>& outs) {
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  Schedule s = create_schedule(out_ops);
+  Tensor out = outs[0];
+  ICHECK(out->op->tag == nn::kLayerNorm || out->op->tag == nn::kRMSNorm)
+      << "schedule_layer_norm expects a layer_norm or rms_norm output, got " << out->op->tag;
+  Operation stats;
+  for (const Tensor& t : out->op->InputTensors()) {
+    if (t->op->tag == kCommReduce) stats = t->op;
+  }
+  ICHECK(stats.defined());
+  tvm::te::AutoInlineInjective(s);
+
+  const auto* out_op = out->op.as<ComputeOpNode>();
+  const auto* stats_op = stats.as<ComputeOpNode>();
+  int axis = Downcast<Integer>(out_op->attrs["axis"])->value;
+  int ndim = static_cast<int>(out_op->axis.size());
+  // Four warps per row on CUDA, as the rows of transformers are long.
+  int num_thread = 64;
+  if (target->kind->name == "cuda") {
+    num_thread = 4 * target->GetAttr<Integer>("thread_warp_size", 32).value()->value;
+  }
+  IterVar block_x = tvm::te::thread_axis(Range(), "blockIdx.x");
+  IterVar thread_x = tvm::te::thread_axis(Range(0, num_thread), "threadIdx.x");
+  if (axis == ndim - 1) {
+    Array<IterVar> rows(out_op->axis.begin(), out_op->axis.end() - 1);
+    IterVar tx, xi;
+    s[out].split_by_nparts(out_op->axis[axis], num_thread, &tx, &xi);
+    if (!rows.empty()) {
+      IterVar row = detail::Fuse(s[out], rows);
+      s[out].bind(row, block_x);
+    }
+    s[out].bind(tx, thread_x);
+
+    IterVar ko, ki;
+    s[stats].split_by_nparts(stats_op->reduce_axis[0], num_thread, &ko, &ki);
+    s[stats].bind(ko, thread_x);
+    s[stats].compute_at(s[out], tx);
+  } else {
+    IterVar fused = detail::Fuse(s[stats], stats_op->axis);
+    IterVar bx, tx;
+    s[stats].split(fused, num_thread, &bx, &tx);
+    s[stats].bind(bx, block_x);
+    s[stats].bind(tx, thread_axis(Range(0, num_thread), "threadIdx.x"));
+    schedule_injective_from_existing(s, out);
+  }
+  return s;
+}
+
 }  // namespace cuda
 }  // namespace topi
 }  // namespace tvm
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief Batch matmul op constructions
+ * \file nn/batch_matmul.h
+ */
+#ifndef TVM_TOPI_NN_BATCH_MATMUL_H_
+#define TVM_TOPI_NN_BATCH_MATMUL_H_
+
+#include <tvm/te/operation.h>
+#include <tvm/topi/tags.h>
+
+#include <string>
+
+namespace tvm {
+namespace topi {
+namespace nn {
+
+using namespace tvm::te;
+
+/*!
+ * \brief Creates an operation that calculates x * y^T for each batch
+ *
+ * \param x Tensor with shape [batch, M, K]
+ * \param y Tensor with shape [batch, N, K]. Either batch dimension may be 1, in which case it is
+ * broadcast to the other.
+ * \param out_dtype Output data type. Used for mixed precision.
+ *
+ * \return Tensor with shape [batch, M, N]
+ */
+inline tvm::te::Tensor batch_matmul(const tvm::te::Tensor& x, const tvm::te::Tensor& y,
+                                    const DataType& out_dtype) {
+  ICHECK_EQ(x->shape.size(), 3) << "batch_matmul requires 3-D x";
+  ICHECK_EQ(y->shape.size(), 3) << "batch_matmul requires 3-D y";
+
+  bool broadcast_x = is_const_int(x->shape[0], 1);
+  bool broadcast_y = is_const_int(y->shape[0], 1);
+  auto batch = broadcast_x ? y->shape[0] : x->shape[0];
+  auto k = tvm::te::reduce_axis(Range(0, x->shape[2]), "k");
+  return tvm::te::compute(
+      {batch, x->shape[1], y->shape[1]},
+      [&](Var b, Var i, Var j) {
+        PrimExpr xb = broadcast_x ? PrimExpr(0) : PrimExpr(b);
+        PrimExpr yb = broadcast_y ? PrimExpr(0) : PrimExpr(b);
+        return tvm::sum(
+            tvm::cast(out_dtype, x(xb, i, k)) * tvm::cast(out_dtype, y(yb, j, k)), {k});
+      },
+      "T_batch_matmul", "batch_matmul");
+}
+
+}  // namespace nn
+}  // namespace topi
+}  // namespace tvm
+#endif  // TVM_TOPI_NN_BATCH_MATMUL_H_
@@ -0,0 +1,400 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief Convolutions formulated as implicit GEMMs
+ * \file nn/implicit_gemm.h
+ *
+ * A convolution is the GEMM out[m, co] = sum_k patch[m, k] * weight[co, k], where m enumerates the
+ * output pixels (the batch and the output spatial positions) and k the taps of the kernel (the
+ * input channels and the kernel spatial positions). Unlike im2col, the patch matrix is only an
+ * index mapping onto the data: the schedules compute its tiles on the fly, e.g. in the shared
+ * memory load of a tensor core GEMM or in a cache-resident buffer in front of a dot product
+ * intrinsic, so that it is never materialized.
+ */
+#ifndef TVM_TOPI_NN_IMPLICIT_GEMM_H_
+#define TVM_TOPI_NN_IMPLICIT_GEMM_H_
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/te/operation.h>
+#include <tvm/topi/tags.h>
+
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace topi {
+namespace detail {
+
+using namespace tvm::te;
+
+/*! \brief The axes of a convolution data layout, e.g. "NHWC" or "NCDHW" */
+struct ConvLayoutAxes {
+  /*! \brief The axis of the batch */
+  int batch;
+  /*! \brief The axis of the channels */
+  int channel;
+  /*! \brief The spatial axes, in the order of the layout */
+  std::vector<int> spatial;
+  /*! \brief The names of the spatial axes, e.g. "HW" */
+  std::string spatial_names;
+  /*! \brief Whether the channels are the innermost axis */
+  bool channel_last;
+};
+
+inline ConvLayoutAxes ParseConvLayout(const std::string& layout) {
+  size_t batch = layout.find('N');
+  size_t channel = layout.find('C');
+  ICHECK(batch != std::string::npos && channel != std::string::npos)
+      << "The implicit GEMM does not support the data layout " << layout;
+  ConvLayoutAxes axes;
+  axes.batch = batch;
+  axes.channel = channel;
+  for (size_t i = 0; i < layout.size(); ++i) {
+    char c = layout[i];
+    if (c == 'D' || c == 'H' || c == 'W') {
+      axes.spatial.push_back(i);
+      axes.spatial_names.push_back(c);
+    } else {
+      ICHECK(c == 'N' || c == 'C') << "The implicit GEMM does not support the data layout "
+                                   << layout;
+    }
+  }
+  ICHECK(!axes.spatial.empty()) << "The data layout " << layout << " has no spatial axis";
+  axes.channel_last = axes.channel == static_cast<int>(layout.size()) - 1;
+  return axes;
+}
+
+/*! \brief Round up to a multiple of a constant */
+inline PrimExpr RoundUp(const PrimExpr& value, int multiple) {
+  if (multiple == 1) {
+    return value;
+  }
+  arith::Analyzer analyzer;
+  return analyzer.Simplify(floordiv(value + (multiple - 1), multiple) * multiple);
+}
+
+/*!
+ * \brief Split a flattened index into the indices of a row-major shape
+ * \param index The flattened index.
+ * \param shape The row-major shape.
+ */
+inline Array<PrimExpr> Unflatten(PrimExpr index, const Array<PrimExpr>& shape) {
+  std::vector<PrimExpr> indices(shape.size());
+  for (int i = static_cast<int>(shape.size()) - 1; i > 0; --i) {
+    indices[i] = floormod(index, shape[i]);
+    index = floordiv(index, shape[i]);
+  }
+  indices[0] = index;
+  return Array<PrimExpr>(indices.begin(), indices.end());
+}
+
+/*!
+ * \brief The shape the reduction index of an implicit GEMM is flattened from, the kernel spatial
+ * axes then the input channels when the data is channel last, the other way around otherwise, so
+ * that consecutive taps read consecutive data
+ */
+inline Array<PrimExpr> ReductionShape(const ConvLayoutAxes& axes, const PrimExpr& in_channel,
+                                      const Array<PrimExpr>& kernel_size) {
+  Array<PrimExpr> shape;
+  if (!axes.channel_last) {
+    shape.push_back(in_channel);
+  }
+  for (const PrimExpr& k : kernel_size) {
+    shape.push_back(k);
+  }
+  if (axes.channel_last) {
+    shape.push_back(in_channel);
+  }
+  return shape;
+}
+
+}  // namespace detail
+
+namespace nn {
+
+using namespace tvm::te;
+
+/*! \brief The tag of the patch matrix of an implicit GEMM */
+constexpr const char* kImplicitGemmPatch = "implicit_gemm_patch";
+/*! \brief The tag of the weight matrix of an implicit GEMM */
+constexpr const char* kImplicitGemmWeight = "implicit_gemm_weight";
+/*! \brief The tag of the GEMM of an implicit GEMM convolution */
+constexpr const char* kImplicitGemm = "implicit_gemm";
+
+/*!
+ * \brief Compute the output spatial shape of a convolution
+ *
+ * \param data_spatial The input spatial shape.
+ * \param kernel_size The kernel spatial shape.
+ * \param strides The strides.
+ * \param padding The padding before each spatial axis, then after each spatial axis.
+ * \param dilation The dilation.
+ * \param transposed Whether the convolution is transposed, in which case the output padding is
+ * subtracted from the padding after.
+ *
+ * \return The output spatial shape.
+ */
+inline Array<PrimExpr> conv_output_spatial(const Array<PrimExpr>& data_spatial,
+                                           const Array<PrimExpr>& kernel_size,
+                                           const Array<PrimExpr>& strides,
+                                           const Array<PrimExpr>& padding,
+                                           const Array<PrimExpr>& dilation, bool transposed) {
+  size_t ndim = data_spatial.size();
+  ICHECK_EQ(kernel_size.size(), ndim);
+  ICHECK_EQ(strides.size(), ndim);
+  ICHECK_EQ(padding.size(), 2 * ndim);
+  ICHECK_EQ(dilation.size(), ndim);
+  arith::Analyzer analyzer;
+  Array<PrimExpr> out;
+  for (size_t i = 0; i < ndim; ++i) {
+    PrimExpr extent = (kernel_size[i] - 1) * dilation[i] + 1;
+    PrimExpr pad = padding[i] + padding[i + ndim];
+    if (transposed) {
+      out.push_back(analyzer.Simplify((data_spatial[i] - 1) * strides[i] - pad + extent));
+    } else {
+      out.push_back(
+          analyzer.Simplify(indexdiv(data_spatial[i] + pad - extent, strides[i]) + 1));
+    }
+  }
+  return out;
+}
+
+/*!
+ * \brief Create the patch matrix of an implicit GEMM convolution
+ *
+ * \param data The input, in the layout given by layout.
+ * \param kernel_size The kernel spatial shape.
+ * \param strides The strides.
+ * \param padding The padding before each spatial axis, then after each spatial axis.
+ * \param dilation The dilation.
+ * \param layout The layout of data, e.g. "NHWC" or "NCDHW".
+ * \param transposed Whether the convolution is transposed, i.e. the gradient of a convolution of
+ * the given strides, padding and dilation with respect to its input.
+ * \param m_multiple The number of rows is padded with zeros to a multiple of it.
+ * \param k_multiple The number of columns is padded with zeros to a multiple of it.
+ *
+ * \return Tensor with shape [batch * prod(output spatial shape), in_channel * prod(kernel_size)],
+ * reading the data on the fly.
+ */
+inline Tensor implicit_gemm_patch(const Tensor& data, const Array<PrimExpr>& kernel_size,
+                                  const Array<PrimExpr>& strides, const Array<PrimExpr>& padding,
+                                  const Array<PrimExpr>& dilation, const std::string& layout,
+                                  bool transposed = false, int m_multiple = 1,
+                                  int k_multiple = 1) {
+  detail::ConvLayoutAxes axes = detail::ParseConvLayout(layout);
+  size_t ndim = axes.spatial.size();
+  ICHECK_EQ(data->shape.size(), ndim + 2) << "The data does not match the layout " << layout;
+  Array<PrimExpr> data_spatial;
+  for (int axis : axes.spatial) {
+    data_spatial.push_back(data->shape[axis]);
+  }
+  Array<PrimExpr> out_spatial =
+      conv_output_spatial(data_spatial, kernel_size, strides, padding, dilation, transposed);
+
+  Array<PrimExpr> row_shape{data->shape[axes.batch]};
+  for (const PrimExpr& dim : out_spatial) {
+    row_shape.push_back(dim);
+  }
+  PrimExpr in_channel = data->shape[axes.channel];
+  Array<PrimExpr> col_shape = detail::ReductionShape(axes, in_channel, kernel_size);
+  PrimExpr rows = 1, cols = 1;
+  for (const PrimExpr& dim : row_shape) rows = rows * dim;
+  for (const PrimExpr& dim : col_shape) cols = cols * dim;
+  arith::Analyzer analyzer;
+  rows = analyzer.Simplify(rows);
+  cols = analyzer.Simplify(cols);
+
+  return compute(
+      {detail::RoundUp(rows, m_multiple), detail::RoundUp(cols, k_multiple)},
+      [&](const Var& m, const Var& k) {
+        Array<PrimExpr> row = detail::Unflatten(m, row_shape);
+        Array<PrimExpr> col = detail::Unflatten(k, col_shape);
+        PrimExpr channel = axes.channel_last ? col[ndim] : col[0];
+        int tap_offset = axes.channel_last ? 0 : 1;
+
+        Array<PrimExpr> indices(ndim + 2, PrimExpr(0));
+        indices.Set(axes.batch, row[0]);
+        indices.Set(axes.channel, channel);
+        PrimExpr valid = const_true();
+        if (m_multiple > 1) valid = tir::And(valid, m < rows);
+        if (k_multiple > 1) valid = tir::And(valid, k < cols);
+        for (size_t i = 0; i < ndim; ++i) {
+          PrimExpr tap = col[i + tap_offset] * dilation[i];
+          PrimExpr index;
+          if (transposed) {
+            // The output position out is fed by the input position in with
+            // out = in * stride - pad + tap.
+            PrimExpr offset = row[i + 1] + padding[i] - tap;
+            index = floordiv(offset, strides[i]);
+            valid = tir::And(valid, tir::And(offset >= 0, floormod(offset, strides[i]) == 0));
+          } else {
+            index = row[i + 1] * strides[i] - padding[i] + tap;
+            valid = tir::And(valid, index >= 0);
+          }
+          valid = tir::And(valid, index < data_spatial[i]);
+          indices.Set(axes.spatial[i], index);
+        }
+        return tvm::if_then_else(valid, data(indices), make_zero(data->dtype));
+      },
+      "implicit_gemm_patch", kImplicitGemmPatch);
+}
+
+/*!
+ * \brief Create the weight matrix of an implicit GEMM convolution
+ *
+ * \param kernel The kernel, in the layout given by kernel_layout.
+ * \param layout The layout of the data, e.g. "NHWC", deciding the order of the taps.
+ * \param kernel_layout The layout of kernel, e.g. "HWIO", where I are the input channels of the
+ * data and O the output channels, also for a transposed convolution.
+ * \param n_multiple The number of rows is padded with zeros to a multiple of it.
+ * \param k_multiple The number of columns is padded with zeros to a multiple of it.
+ *
+ * \return Tensor with shape [out_channel, in_channel * prod(kernel_size)], with the columns in the
+ * order of the columns of implicit_gemm_patch.
+ */
+inline Tensor implicit_gemm_weight(const Tensor& kernel, const std::string& layout,
+                                   const std::string& kernel_layout, int n_multiple = 1,
+                                   int k_multiple = 1) {
+  detail::ConvLayoutAxes axes = detail::ParseConvLayout(layout);
+  size_t ndim = axes.spatial.size();
+  ICHECK_EQ(kernel_layout.size(), ndim + 2)
+      << "The kernel layout " << kernel_layout << " does not match the data layout " << layout;
+  ICHECK_EQ(kernel->shape.size(), ndim + 2)
+      << "The kernel does not match the layout " << kernel_layout;
+  size_t out_axis = kernel_layout.find('O');
+  size_t in_axis = kernel_layout.find('I');
+  ICHECK(out_axis != std::string::npos && in_axis != std::string::npos)
+      << "The implicit GEMM does not support the kernel layout " << kernel_layout;
+  std::vector<size_t> spatial_axes;
+  Array<PrimExpr> kernel_size;
+  for (char name : axes.spatial_names) {
+    size_t axis = kernel_layout.find(name);
+    ICHECK(axis != std::string::npos)
+        << "The kernel layout " << kernel_layout << " has no axis " << name;
+    spatial_axes.push_back(axis);
+    kernel_size.push_back(kernel->shape[axis]);
+  }
+  PrimExpr out_channel = kernel->shape[out_axis];
+  Array<PrimExpr> col_shape = detail::ReductionShape(axes, kernel->shape[in_axis], kernel_size);
+  PrimExpr cols = 1;
+  for (const PrimExpr& dim : col_shape) cols = cols * dim;
+  arith::Analyzer analyzer;
+  cols = analyzer.Simplify(cols);
+
+  return compute(
+      {detail::RoundUp(out_channel, n_multiple), detail::RoundUp(cols, k_multiple)},
+      [&](const Var& n, const Var& k) {
+        Array<PrimExpr> col = detail::Unflatten(k, col_shape);
+        int tap_offset = axes.channel_last ? 0 : 1;
+        Array<PrimExpr> indices(ndim + 2, PrimExpr(0));
+        indices.Set(out_axis, n);
+        indices.Set(in_axis, axes.channel_last ? col[ndim] : col[0]);
+        for (size_t i = 0; i < ndim; ++i) {
+          indices.Set(spatial_axes[i], col[i + tap_offset]);
+        }
+        if (n_multiple == 1 && k_multiple == 1) {
+          return kernel(indices);
+        }
+        return tvm::if_then_else(tir::And(n < out_channel, k < cols), kernel(indices),
+                                 make_zero(kernel->dtype));
+      },
+      "implicit_gemm_weight", kImplicitGemmWeight);
+}
+
+/*!
+ * \brief Create the output of an implicit GEMM convolution from its GEMM
+ *
+ * \param gemm The GEMM of the patch and the weight matrices, possibly padded.
+ * \param out_shape The shape of the output, in the layout given by layout.
+ * \param layout The layout of the output, e.g. "NHWC".
+ *
+ * \return The output, a view of gemm.
+ */
+inline Tensor implicit_gemm_output(const Tensor& gemm, const Array<PrimExpr>& out_shape,
+                                   const std::string& layout) {
+  detail::ConvLayoutAxes axes = detail::ParseConvLayout(layout);
+  return compute(
+      out_shape,
+      [&](const Array<Var>& indices) {
+        PrimExpr m = indices[axes.batch];
+        for (int axis : axes.spatial) {
+          m = m * out_shape[axis] + indices[axis];
+        }
+        return gemm(m, indices[axes.channel]);
+      },
+      "T_conv", kInjective);
+}
+
+/*!
+ * \brief Creates an operation computing a convolution as an implicit GEMM
+ *
+ * \param data The input, in the layout given by layout.
+ * \param kernel The kernel, in the layout given by kernel_layout.
+ * \param strides The strides.
+ * \param padding The padding before each spatial axis, then after each spatial axis.
+ * \param dilation The dilation.
+ * \param layout The layout of data and of the output, e.g. "NHWC" or "NCDHW".
+ * \param kernel_layout The layout of kernel, e.g. "HWIO" or "OIDHW".
+ * \param out_dtype The output data type.
+ * \param transposed Whether the convolution is transposed, in which case the output padding is
+ * subtracted from the padding after.
+ *
+ * \return The output, in the layout given by layout.
+ */
+inline Tensor conv_implicit_gemm(const Tensor& data, const Tensor& kernel,
+                                 const Array<PrimExpr>& strides, const Array<PrimExpr>& padding,
+                                 const Array<PrimExpr>& dilation, const std::string& layout,
+                                 const std::string& kernel_layout, DataType out_dtype,
+                                 bool transposed = false) {
+  detail::ConvLayoutAxes axes = detail::ParseConvLayout(layout);
+  // Checks the kernel layout against the data layout.
+  Tensor weight = implicit_gemm_weight(kernel, layout, kernel_layout);
+  Array<PrimExpr> data_spatial, kernel_size;
+  for (size_t i = 0; i < axes.spatial.size(); ++i) {
+    data_spatial.push_back(data->shape[axes.spatial[i]]);
+    kernel_size.push_back(kernel->shape[kernel_layout.find(axes.spatial_names[i])]);
+  }
+  Tensor patch =
+      implicit_gemm_patch(data, kernel_size, strides, padding, dilation, layout, transposed);
+
+  IterVar k = reduce_axis(Range(0, patch->shape[1]), "k");
+  Tensor gemm = compute(
+      {patch->shape[0], weight->shape[0]},
+      [&](const Var& m, const Var& n) {
+        return tvm::sum(tvm::cast(out_dtype, patch(m, k)) * tvm::cast(out_dtype, weight(n, k)),
+                        {k});
+      },
+      "T_implicit_gemm", kImplicitGemm);
+
+  Array<PrimExpr> out_spatial =
+      conv_output_spatial(data_spatial, kernel_size, strides, padding, dilation, transposed);
+  Array<PrimExpr> out_shape(layout.size(), PrimExpr(0));
+  out_shape.Set(axes.batch, data->shape[axes.batch]);
+  out_shape.Set(axes.channel, weight->shape[0]);
+  for (size_t i = 0; i < axes.spatial.size(); ++i) {
+    out_shape.Set(axes.spatial[i], out_spatial[i]);
+  }
+  return implicit_gemm_output(gemm, out_shape, layout);
+}
+
+}  // namespace nn
+}  // namespace topi
+}  // namespace tvm
+#endif  // TVM_TOPI_NN_IMPLICIT_GEMM_H_
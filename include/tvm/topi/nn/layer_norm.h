@@ -0,0 +1,215 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief Layer normalization and RMS normalization op constructions
+ * \file nn/layer_norm.h
+ */
+#ifndef TVM_TOPI_NN_LAYER_NORM_H_
+#define TVM_TOPI_NN_LAYER_NORM_H_
+
+#include <tvm/te/operation.h>
+#include <tvm/topi/reduction.h>
+#include <tvm/topi/tags.h>
+
+#include <string>
+
+namespace tvm {
+namespace topi {
+namespace nn {
+
+using namespace tvm::te;
+
+/*! \brief The tag of the output of layer_norm */
+constexpr const char* kLayerNorm = "layer_norm";
+/*! \brief The tag of the output of rms_norm */
+constexpr const char* kRMSNorm = "rms_norm";
+
+/*!
+ * \brief The data type the statistics of a normalization are accumulated in, float32 for the
+ * narrower floating point types
+ */
+inline DataType NormAccumulateType(DataType dtype) {
+  return dtype.is_float() && dtype.bits() >= 32 ? dtype : DataType::Float(32);
+}
+
+/*!
+ * \brief Create the reducer computing the (count, mean, M2) statistics of Welford's online
+ * algorithm, so that the mean and the variance are computed in a single pass over the data.
+ * Partial statistics are merged as in Chan et al., which makes the reducer valid for rfactor and
+ * cross-thread reductions.
+ */
+inline FCommReduce MakeWelfordReducer() {
+  auto fcombine = [](Array<Var> lhs, Array<Var> rhs) {
+    PrimExpr count = lhs[0] + rhs[0];
+    PrimExpr delta = rhs[1] - lhs[1];
+    // The weight of the right-hand side, zero when both sides are empty.
+    PrimExpr weight = rhs[0] / tvm::max(count, make_const(count.dtype(), 1));
+    Array<PrimExpr> result;
+    result.push_back(count);                                              // count
+    result.push_back(lhs[1] + delta * weight);                            // mean
+    result.push_back(lhs[2] + rhs[2] + delta * delta * lhs[0] * weight);  // M2
+    return result;
+  };
+  auto fidentity = [](std::vector<DataType> types) {
+    Array<PrimExpr> result;
+    for (const DataType& type : types) {
+      result.push_back(make_zero(type));
+    }
+    return result;
+  };
+  return MakeCommReducer(fcombine, fidentity, "welford");
+}
+
+/*!
+ * \brief The shape of the statistics of a normalization over an axis, i.e. the shape without
+ * the axis
+ */
+inline Array<PrimExpr> NormStatsShape(const Array<PrimExpr>& shape, int axis) {
+  Array<PrimExpr> stats_shape;
+  for (int i = 0; i < static_cast<int>(shape.size()); ++i) {
+    if (i != axis) stats_shape.push_back(shape[i]);
+  }
+  return stats_shape;
+}
+
+/*!
+ * \brief The indices of the statistics of a normalization for the indices of the data
+ */
+inline Array<PrimExpr> NormStatsIndices(const Array<Var>& indices, int axis) {
+  Array<PrimExpr> stats_indices;
+  for (int i = 0; i < static_cast<int>(indices.size()); ++i) {
+    if (i != axis) stats_indices.push_back(indices[i]);
+  }
+  return stats_indices;
+}
+
+/*!
+ * \brief The indices of the data for the indices of the statistics and the reduction axis
+ */
+inline Array<PrimExpr> NormDataIndices(const Array<Var>& indices, const IterVar& k, int axis) {
+  Array<PrimExpr> data_indices;
+  for (int i = 0, j = 0; i <= static_cast<int>(indices.size()); ++i) {
+    data_indices.push_back(i == axis ? PrimExpr(k->var) : PrimExpr(indices[j++]));
+  }
+  return data_indices;
+}
+
+/*!
+ * \brief Layer normalization inference operator
+ *
+ * The mean and the variance are computed together by a single Welford reduction over the axis,
+ * accumulated in float32 for the narrower floating point types, and the output is computed from
+ * them by one elementwise pass.
+ *
+ * \param data The input tensor
+ * \param gamma The scale, a 1-D tensor of the size of the axis
+ * \param beta The offset, a 1-D tensor of the size of the axis
+ * \param axis The axis to normalize over
+ * \param epsilon Small float added to the variance to avoid dividing by zero
+ * \param center Whether to add beta
+ * \param scale Whether to multiply by gamma
+ * \param name The name of the operation
+ * \param tag The tag to mark the operation
+ *
+ * \return A Tensor whose op member is the layer normalization operation
+ */
+inline Tensor layer_norm(const Tensor& data, const Tensor& gamma, const Tensor& beta, int axis,
+                         double epsilon, bool center = true, bool scale = true,
+                         std::string name = "T_layer_norm", std::string tag = kLayerNorm) {
+  int ndim = static_cast<int>(data->shape.size());
+  if (axis < 0) axis += ndim;
+  ICHECK(axis >= 0 && axis < ndim) << "layer_norm axis " << axis << " out of range";
+  DataType acc_dtype = NormAccumulateType(data->dtype);
+  auto k = reduce_axis(Range(0, data->shape[axis]), "k");
+  auto reducer = MakeWelfordReducer();
+  Array<Tensor> stats = tvm::te::compute(
+      NormStatsShape(data->shape, axis),
+      [&](const Array<Var>& indices) {
+        PrimExpr x = cast(acc_dtype, data(NormDataIndices(indices, k, axis)));
+        return reducer({make_const(acc_dtype, 1), x, make_zero(acc_dtype)}, {k}, nullptr);
+      },
+      name + "_stats", kCommReduce);
+  Tensor mean = stats[1];
+  Tensor m2 = stats[2];
+
+  PrimExpr size = cast(acc_dtype, data->shape[axis]);
+  PrimExpr eps = make_const(acc_dtype, epsilon);
+  Map<String, ObjectRef> attrs{{"axis", Integer(axis)}};
+  return tvm::te::compute(
+      data->shape,
+      [&](const Array<Var>& indices) {
+        Array<PrimExpr> stats_indices = NormStatsIndices(indices, axis);
+        PrimExpr inv_std = tvm::rsqrt(m2(stats_indices) / size + eps);
+        PrimExpr out = (cast(acc_dtype, data(indices)) - mean(stats_indices)) * inv_std;
+        if (scale) out = out * cast(acc_dtype, gamma(indices[axis]));
+        if (center) out = out + cast(acc_dtype, beta(indices[axis]));
+        return cast(data->dtype, out);
+      },
+      name, tag, attrs);
+}
+
+/*!
+ * \brief Root mean square normalization inference operator, i.e. the data divided by the root
+ * mean square over the axis and multiplied by gamma
+ *
+ * \param data The input tensor
+ * \param gamma The scale, a 1-D tensor of the size of the axis
+ * \param axis The axis to normalize over
+ * \param epsilon Small float added to the mean square to avoid dividing by zero
+ * \param scale Whether to multiply by gamma
+ * \param name The name of the operation
+ * \param tag The tag to mark the operation
+ *
+ * \return A Tensor whose op member is the RMS normalization operation
+ */
+inline Tensor rms_norm(const Tensor& data, const Tensor& gamma, int axis, double epsilon,
+                       bool scale = true, std::string name = "T_rms_norm",
+                       std::string tag = kRMSNorm) {
+  int ndim = static_cast<int>(data->shape.size());
+  if (axis < 0) axis += ndim;
+  ICHECK(axis >= 0 && axis < ndim) << "rms_norm axis " << axis << " out of range";
+  DataType acc_dtype = NormAccumulateType(data->dtype);
+  auto k = reduce_axis(Range(0, data->shape[axis]), "k");
+  Tensor square_sum = tvm::te::compute(
+      NormStatsShape(data->shape, axis),
+      [&](const Array<Var>& indices) {
+        PrimExpr x = cast(acc_dtype, data(NormDataIndices(indices, k, axis)));
+        return tvm::sum(x * x, {k});
+      },
+      name + "_stats", kCommReduce);
+
+  PrimExpr size = cast(acc_dtype, data->shape[axis]);
+  PrimExpr eps = make_const(acc_dtype, epsilon);
+  Map<String, ObjectRef> attrs{{"axis", Integer(axis)}};
+  return tvm::te::compute(
+      data->shape,
+      [&](const Array<Var>& indices) {
+        PrimExpr inv_rms = tvm::rsqrt(square_sum(NormStatsIndices(indices, axis)) / size + eps);
+        PrimExpr out = cast(acc_dtype, data(indices)) * inv_rms;
+        if (scale) out = out * cast(acc_dtype, gamma(indices[axis]));
+        return cast(data->dtype, out);
+      },
+      name, tag, attrs);
+}
+
+}  // namespace nn
+}  // namespace topi
+}  // namespace tvm
+#endif  // TVM_TOPI_NN_LAYER_NORM_H_
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file x86/normalization.h
+ * \brief x86 schedule for layer and RMS normalization operations
+ */
+#ifndef TVM_TOPI_X86_NORMALIZATION_H_
+#define TVM_TOPI_X86_NORMALIZATION_H_
+
+#include <tvm/target/generic_func.h>
+#include <tvm/te/operation.h>
+#include <tvm/te/schedule_pass.h>
+#include <tvm/topi/detail/fuse.h>
+#include <tvm/topi/nn/layer_norm.h>
+#include <tvm/topi/tags.h>
+#include <tvm/topi/x86/injective.h>
+
+namespace tvm {
+namespace topi {
+
+using namespace tvm::te;
+
+namespace x86 {
+/*!
+ * \brief Create an x86 schedule for layer_norm and rms_norm, with the injective producers of the
+ * data, e.g. a residual add, fused into the loop
+ *
+ * When the normalization is over the innermost axis, the rows are normalized in parallel: the
+ * statistics of a row are computed right before the row is normalized, while it is still in the
+ * cache, and the normalization of the row is vectorized.
+ *
+ * \param target The target to generate a schedule for.
+ * \param outs The output tensors.
+ *
+ * \return A schedule for the given ops.
+ */
+inline Schedule schedule_layer_norm(const Target& target, const Array<Tensor>& outs) {
+  Array<Operation> out_ops;
+  for (auto t : outs) {
+    out_ops.push_back(t->op);
+  }
+  Schedule s = create_schedule(out_ops);
+  Tensor out = outs[0];
+  ICHECK(out->op->tag == nn::kLayerNorm || out->op->tag == nn::kRMSNorm)
+      << "schedule_layer_norm expects a layer_norm or rms_norm output, got " << out->op->tag;
+  Operation stats;
+  for (const Tensor& t : out->op->InputTensors()) {
+    if (t->op->tag == kCommReduce) stats = t->op;
+  }
+  ICHECK(stats.defined());
+  tvm::te::AutoInlineInjective(s);
+
+  const auto* out_op = out->op.as<ComputeOpNode>();
+  int axis = Downcast<Integer>(out_op->attrs["axis"])->value;
+  int ndim = static_cast<int>(out_op->axis.size());
+  if (axis == ndim - 1 && ndim > 1) {
+    Array<IterVar> rows(out_op->axis.begin(), out_op->axis.end() - 1);
+    IterVar row = detail::Fuse(s[out], rows);
+    s[out].parallel(row);
+    IterVar xo, xi;
+    s[out].split(out_op->axis[axis], 16, &xo, &xi);
+    s[out].vectorize(xi);
+    s[stats].compute_at(s[out], row);
+  } else {
+    const auto* stats_op = stats.as<ComputeOpNode>();
+    if (!stats_op->axis.empty()) {
+      s[stats].parallel(detail::Fuse(s[stats], stats_op->axis));
+    }
+    schedule_injective_from_existing(s, out);
+  }
+  return s;
+}
+
+}  // namespace x86
+}  // namespace topi
+}  // namespace tvm
+#endif  // TVM_TOPI_X86_NORMALIZATION_H_
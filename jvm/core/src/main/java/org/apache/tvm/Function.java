@@ -228,10 +228,72 @@ public class Function extends TVMValue {
    * @return the result.
    */
   public TVMValue call(Object... args) {
-    for (Object arg : args) {
-      pushArgToStack(arg);
+    // The arguments are encoded here and passed in a single native call,
+    // rather than pushed one by one.
+    long[] values = new long[args.length];
+    int[] typeCodes = new int[args.length];
+    Object[] refs = new Object[args.length];
+    for (int i = 0; i < args.length; ++i) {
+      encodeArg(args[i], i, values, typeCodes, refs);
+    }
+    Base.RefTVMValue ret = new Base.RefTVMValue();
+    Base.checkCall(Base._LIB.tvmFuncCallBatched(handle, values, typeCodes, refs, ret));
+    return ret.value;
+  }
+
+  private static void encodeArg(Object arg, int i, long[] values, int[] typeCodes,
+      Object[] refs) {
+    if (arg instanceof Integer || arg instanceof Long) {
+      values[i] = ((Number) arg).longValue();
+      typeCodes[i] = ArgTypeCode.INT.id;
+    } else if (arg instanceof Float || arg instanceof Double) {
+      values[i] = Double.doubleToRawLongBits(((Number) arg).doubleValue());
+      typeCodes[i] = ArgTypeCode.FLOAT.id;
+    } else if (arg instanceof String) {
+      refs[i] = arg;
+      typeCodes[i] = ArgTypeCode.STR.id;
+    } else if (arg instanceof byte[]) {
+      refs[i] = arg;
+      typeCodes[i] = ArgTypeCode.BYTES.id;
+    } else if (arg instanceof NDArrayBase) {
+      NDArrayBase nd = (NDArrayBase) arg;
+      values[i] = nd.handle;
+      typeCodes[i] = nd.isView ? ArgTypeCode.ARRAY_HANDLE.id : ArgTypeCode.NDARRAY_CONTAINER.id;
+    } else if (arg instanceof Module) {
+      values[i] = ((Module) arg).handle;
+      typeCodes[i] = ArgTypeCode.MODULE_HANDLE.id;
+    } else if (arg instanceof Function) {
+      values[i] = ((Function) arg).handle;
+      typeCodes[i] = ArgTypeCode.FUNC_HANDLE.id;
+    } else if (arg instanceof TVMValue) {
+      TVMValue tvmArg = (TVMValue) arg;
+      switch (tvmArg.typeCode) {
+        case UINT:
+        case INT:
+          encodeArg(tvmArg.asLong(), i, values, typeCodes, refs);
+          break;
+        case FLOAT:
+          encodeArg(tvmArg.asDouble(), i, values, typeCodes, refs);
+          break;
+        case STR:
+          encodeArg(tvmArg.asString(), i, values, typeCodes, refs);
+          break;
+        case BYTES:
+          encodeArg(tvmArg.asBytes(), i, values, typeCodes, refs);
+          break;
+        case HANDLE:
+        case ARRAY_HANDLE:
+        case MODULE_HANDLE:
+        case FUNC_HANDLE:
+          values[i] = tvmArg.asHandle();
+          typeCodes[i] = tvmArg.typeCode.id;
+          break;
+        default:
+          throw new IllegalArgumentException("Invalid argument: " + arg);
+      }
+    } else {
+      throw new IllegalArgumentException("Invalid argument: " + arg);
     }
-    return invoke();
   }
 
   private static void pushArgToStack(Object arg) {
@@ -45,6 +45,9 @@ class LibInfo {
 
   native int tvmFuncCall(long handle, Base.RefTVMValue retVal);
 
+  native int tvmFuncCallBatched(long handle, long[] values, int[] typeCodes, Object[] refs,
+      Base.RefTVMValue retVal);
+
   native int tvmFuncCreateFromCFunc(Function.Callback function, Base.RefLong handle);
 
   native int tvmFuncRegisterGlobal(String name, long handle, int override);
@@ -71,6 +74,11 @@ class LibInfo {
 
   native int tvmArrayCopyToJArray(long from, byte[] to);
 
+  native int tvmArrayFromDirectBuffer(java.nio.ByteBuffer buffer, long[] shape, int dtypeCode,
+      int dtypeBits, int dtypeLanes, Base.RefLong refHandle);
+
+  native java.nio.ByteBuffer tvmArrayGetDirectBuffer(long handle);
+
   // Device
   native int tvmSynchronize(int deviceType, int deviceId);
 }
@@ -415,6 +415,53 @@ public class NDArray extends NDArrayBase {
     return empty(shape, new TVMType("float32", 1), dev);
   }
 
+  /**
+   * Create an array on cpu sharing the memory of a direct buffer, without copying.
+   * The buffer is kept alive until the array is released.
+   * The data of the array starts at the position of the buffer,
+   * which should be aligned for the arrays bound to a graph executor without copy.
+   * @param buffer The direct buffer, in native byte order.
+   * @param shape The shape of the array.
+   * @param dtype The data type of the array.
+   * @return The array viewing the buffer.
+   */
+  public static NDArray fromDirectByteBuffer(ByteBuffer buffer, long[] shape, TVMType dtype) {
+    if (!buffer.isDirect()) {
+      throw new IllegalArgumentException("Expect a direct buffer");
+    }
+    Base.RefLong refHandle = new Base.RefLong();
+    Base.checkCall(Base._LIB.tvmArrayFromDirectBuffer(
+        buffer.slice(), shape, dtype.typeCode, dtype.bits, dtype.lanes, refHandle));
+    return new NDArray(refHandle.value, false, dtype, new Device(1, 0));
+  }
+
+  /**
+   * Create a float32 array on cpu sharing the memory of a direct buffer, without copying.
+   * @param buffer The direct buffer, in native byte order.
+   * @param shape The shape of the array.
+   * @return The array viewing the buffer.
+   */
+  public static NDArray fromDirectByteBuffer(ByteBuffer buffer, long[] shape) {
+    return fromDirectByteBuffer(buffer, shape, new TVMType("float32", 1));
+  }
+
+  /**
+   * Get a direct buffer sharing the memory of the array, without copying.
+   * The buffer is only valid as long as the array is not released.
+   * @return The direct buffer in little endian order.
+   */
+  public ByteBuffer asDirectByteBuffer() {
+    if (device.deviceType != 1) {
+      throw new IllegalStateException("Only cpu arrays can be viewed as direct buffers");
+    }
+    ByteBuffer bb = Base._LIB.tvmArrayGetDirectBuffer(handle);
+    if (bb == null) {
+      throw new IllegalStateException("The JVM does not support direct buffer access");
+    }
+    bb.order(ByteOrder.LITTLE_ENDIAN);
+    return bb;
+  }
+
   private static ByteBuffer wrapBytes(byte[] bytes) {
     ByteBuffer bb = ByteBuffer.wrap(bytes);
     bb.order(ByteOrder.LITTLE_ENDIAN);
@@ -86,7 +86,7 @@ public class GraphModule {
       input = NDArray.empty(value.shape(), device);
       value.copyTo(input);
     }
-    fsetInput.pushArg(key).pushArg(input).invoke();
+    fsetInput.call(key, input);
     return this;
   }
 
@@ -102,7 +102,7 @@ public class GraphModule {
       input = NDArray.empty(value.shape(), device);
       value.copyTo(input);
     }
-    fsetInput.pushArg(key).pushArg(input).invoke();
+    fsetInput.call(key, input);
     return this;
   }
 
@@ -122,7 +122,7 @@ public class GraphModule {
    * @return out.
    */
   public NDArray getInput(int index, NDArray out) {
-    fgetInput.pushArg(index).pushArg(out).invoke();
+    fgetInput.call(index, out);
     return out;
   }
 
@@ -133,7 +133,7 @@ public class GraphModule {
    * @return out.
    */
   public NDArray getOutput(int index, NDArray out) {
-    fgetOutput.pushArg(index).pushArg(out).invoke();
+    fgetOutput.call(index, out);
     return out;
   }
 
@@ -145,7 +145,7 @@ public class GraphModule {
    */
   public NDArray debugGetOutput(String node, NDArray out) {
     if (fdebugGetOutput != null) {
-      fdebugGetOutput.pushArg(node).pushArg(out).invoke();
+      fdebugGetOutput.call(node, out);
     } else {
       throw new RuntimeException("Please compile runtime with USE_GRAPH_EXECUTOR_DEBUG = 0");
     }
@@ -160,7 +160,7 @@ public class GraphModule {
    */
   public NDArray debugGetOutput(int node, NDArray out) {
     if (fdebugGetOutput != null) {
-      fdebugGetOutput.pushArg(node).pushArg(out).invoke();
+      fdebugGetOutput.call(node, out);
     } else {
       throw new RuntimeException("Please compile runtime with USE_GRAPH_EXECUTOR_DEBUG = 0");
     }
@@ -173,7 +173,7 @@ public class GraphModule {
    * @return self.
    */
   public GraphModule loadParams(byte[] params) {
-    floadParams.pushArg(params).invoke();
+    floadParams.call(params);
     return this;
   }
 
@@ -120,4 +120,26 @@ public class FunctionTest {
     func.release();
     myFunc.release();
   }
+
+  @Test
+  public void test_call_mixed_args() {
+    final long[] shape = new long[]{2};
+    Function func = Function.convertFunc(new Function.Callback() {
+      @Override public Object invoke(TVMValue... args) {
+        NDArray arr = NDArray.empty(shape, new TVMType("float32"));
+        args[3].asNDArray().copyTo(arr);
+        float[] nativeArr = arr.asFloatArray();
+        arr.release();
+        double sum = args[0].asLong() + args[1].asDouble() + nativeArr[0] + nativeArr[1];
+        return args[2].asString() + sum + args[4].asBytes().length;
+      }
+    });
+    NDArray arr = NDArray.empty(shape, new TVMType("float32"));
+    arr.copyFrom(new float[]{2f, 3f});
+    TVMValue res = func.call(1, 0.5, "sum=", arr, new byte[]{1, 2});
+    assertEquals("sum=6.52", res.asString());
+    res.release();
+    arr.release();
+    func.release();
+  }
 }
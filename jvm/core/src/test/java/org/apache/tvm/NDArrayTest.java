@@ -19,6 +19,9 @@ package org.apache.tvm;
 
 import org.junit.Test;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
 import static org.junit.Assert.*;
 
 public class NDArrayTest {
@@ -77,4 +80,18 @@ public class NDArrayTest {
     assertArrayEquals(new char[]{65535, 2, 3, 4}, ndarray.asCharArray());
     ndarray.release();
   }
+
+  @Test
+  public void test_direct_byte_buffer() {
+    ByteBuffer buffer = ByteBuffer.allocateDirect(16).order(ByteOrder.LITTLE_ENDIAN);
+    buffer.asFloatBuffer().put(new float[]{1, 2, 3, 4});
+    NDArray ndarray = NDArray.fromDirectByteBuffer(buffer, new long[]{2, 2});
+    assertArrayEquals(new float[]{1f, 2f, 3f, 4f}, ndarray.asFloatArray(), 1e-3f);
+    // The array and the buffer share the memory.
+    ndarray.copyFrom(new float[]{5, 6, 7, 8});
+    assertEquals(8f, buffer.getFloat(12), 1e-3f);
+    ndarray.asDirectByteBuffer().putFloat(0, 9f);
+    assertArrayEquals(new float[]{9f, 6f, 7f, 8f}, ndarray.asFloatArray(), 1e-3f);
+    ndarray.release();
+  }
 }
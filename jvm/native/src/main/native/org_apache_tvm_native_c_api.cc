@@ -173,6 +173,32 @@ JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmFuncGetGlobal(JNIEnv* env,
   return ret;
 }
 
+// Release the strings and bytes passed to a call.
+static void releasePushedArgs(
+    JNIEnv* env, const std::vector<std::pair<jstring, const char*> >& pushedStrs,
+    const std::vector<std::pair<jbyteArray, TVMByteArray*> >& pushedBytes) {
+  for (auto iter = pushedStrs.cbegin(); iter != pushedStrs.cend(); iter++) {
+    env->ReleaseStringUTFChars(iter->first, iter->second);
+    env->DeleteGlobalRef(iter->first);
+  }
+  for (auto iter = pushedBytes.cbegin(); iter != pushedBytes.cend(); iter++) {
+    env->ReleaseByteArrayElements(
+        iter->first, reinterpret_cast<jbyte*>(const_cast<char*>(iter->second->data)), 0);
+    env->DeleteGlobalRef(iter->first);
+    delete iter->second;
+  }
+}
+
+// Return the TVMValue object of a call to Java.
+static void setRetValue(JNIEnv* env, jobject jretVal, TVMValue retVal, int retTypeCode) {
+  jclass refTVMValueCls = env->FindClass("org/apache/tvm/Base$RefTVMValue");
+  jfieldID refTVMValueFid = env->GetFieldID(refTVMValueCls, "value", "Lorg/apache/tvm/TVMValue;");
+
+  env->SetObjectField(jretVal, refTVMValueFid, tvmRetValueToJava(env, retVal, retTypeCode));
+
+  env->DeleteLocalRef(refTVMValueCls);
+}
+
 JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmFuncCall(JNIEnv* env, jobject obj,
                                                                jlong jhandle, jobject jretVal) {
   TVMFuncArgsThreadLocalEntry* e = TVMFuncArgsThreadLocalStore::Get();
@@ -200,25 +226,70 @@ JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmFuncCall(JNIEnv* env, jobj
     return ret;
   }
 
-  for (auto iter = pushedStrs.cbegin(); iter != pushedStrs.cend(); iter++) {
-    env->ReleaseStringUTFChars(iter->first, iter->second);
-    env->DeleteGlobalRef(iter->first);
-  }
-  for (auto iter = pushedBytes.cbegin(); iter != pushedBytes.cend(); iter++) {
-    env->ReleaseByteArrayElements(
-        iter->first, reinterpret_cast<jbyte*>(const_cast<char*>(iter->second->data)), 0);
-    env->DeleteGlobalRef(iter->first);
-    delete iter->second;
-  }
+  releasePushedArgs(env, pushedStrs, pushedBytes);
+  setRetValue(env, jretVal, retVal, retTypeCode);
 
-  // return TVMValue object to Java
-  jclass refTVMValueCls = env->FindClass("org/apache/tvm/Base$RefTVMValue");
-  jfieldID refTVMValueFid = env->GetFieldID(refTVMValueCls, "value", "Lorg/apache/tvm/TVMValue;");
-
-  env->SetObjectField(jretVal, refTVMValueFid, tvmRetValueToJava(env, retVal, retTypeCode));
+  return ret;
+}
 
-  env->DeleteLocalRef(refTVMValueCls);
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmFuncCallBatched(JNIEnv* env, jobject obj,
+                                                                      jlong jhandle,
+                                                                      jlongArray jvalues,
+                                                                      jintArray jtypes,
+                                                                      jobjectArray jrefs,
+                                                                      jobject jretVal) {
+  TVMFuncArgsThreadLocalEntry* e = TVMFuncArgsThreadLocalStore::Get();
+  // The arguments pushed one by one before the call come first.
+  std::vector<TVMValue> argValues;
+  std::vector<int> argTypes;
+  std::vector<std::pair<jstring, const char*> > pushedStrs;
+  std::vector<std::pair<jbyteArray, TVMByteArray*> > pushedBytes;
+  argValues.swap(e->tvmFuncArgValues);
+  argTypes.swap(e->tvmFuncArgTypes);
+  pushedStrs.swap(e->tvmFuncArgPushedStrs);
+  pushedBytes.swap(e->tvmFuncArgPushedBytes);
+
+  const size_t numPushed = argValues.size();
+  const jsize numArgs = env->GetArrayLength(jvalues);
+  argValues.resize(numPushed + numArgs);
+  argTypes.resize(numPushed + numArgs);
+  // TVMValue and jlong are both 8 bytes, the values are copied in place.
+  static_assert(sizeof(TVMValue) == sizeof(jlong), "TVMValue must be 8 bytes");
+  env->GetLongArrayRegion(jvalues, 0, numArgs, reinterpret_cast<jlong*>(&argValues[numPushed]));
+  env->GetIntArrayRegion(jtypes, 0, numArgs, reinterpret_cast<jint*>(&argTypes[numPushed]));
+
+  // The strings and bytes are passed as objects, converted here.
+  if (!env->IsSameObject(jrefs, nullptr)) {
+    for (jsize i = 0; i < numArgs; ++i) {
+      TVMValue& value = argValues[numPushed + i];
+      int typeCode = argTypes[numPushed + i];
+      if (typeCode != kTVMStr && typeCode != kTVMBytes) continue;
+      jobject ref = env->GetObjectArrayElement(jrefs, i);
+      if (typeCode == kTVMStr) {
+        jstring garg = reinterpret_cast<jstring>(env->NewGlobalRef(ref));
+        value.v_str = env->GetStringUTFChars(garg, 0);
+        pushedStrs.push_back(std::make_pair(garg, value.v_str));
+      } else {
+        jbyteArray garg = reinterpret_cast<jbyteArray>(env->NewGlobalRef(ref));
+        TVMByteArray* byteArray = new TVMByteArray();
+        byteArray->size = static_cast<size_t>(env->GetArrayLength(garg));
+        byteArray->data = reinterpret_cast<const char*>(env->GetByteArrayElements(garg, 0));
+        value.v_handle = reinterpret_cast<void*>(byteArray);
+        pushedBytes.push_back(std::make_pair(garg, byteArray));
+      }
+      env->DeleteLocalRef(ref);
+    }
+  }
 
+  TVMValue retVal;
+  int retTypeCode;
+  int ret = TVMFuncCall(reinterpret_cast<TVMFunctionHandle>(jhandle), argValues.data(),
+                        argTypes.data(), static_cast<int>(argValues.size()), &retVal, &retTypeCode);
+  releasePushedArgs(env, pushedStrs, pushedBytes);
+  if (ret != 0) {
+    return ret;
+  }
+  setRetValue(env, jretVal, retVal, retTypeCode);
   return ret;
 }
 
@@ -453,6 +524,84 @@ JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayCopyToJArray(JNIEnv*
   return ret;
 }
 
+// The direct ByteBuffer an NDArray created by tvmArrayFromDirectBuffer views, released with it.
+static void directBufferDeleter(DLManagedTensor* tensor) {
+  JNIEnv* env;
+  int jniStatus = _jvm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+  if (jniStatus == JNI_EDETACHED) {
+#ifdef TVM4J_ANDROID
+    _jvm->AttachCurrentThread(&env, nullptr);
+#else
+    _jvm->AttachCurrentThread(reinterpret_cast<void**>(&env), nullptr);
+#endif
+  } else {
+    CHECK(jniStatus == JNI_OK);
+  }
+  env->DeleteGlobalRef(reinterpret_cast<jobject>(tensor->manager_ctx));
+  delete[] tensor->dl_tensor.shape;
+  delete tensor;
+}
+
+JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmArrayFromDirectBuffer(
+    JNIEnv* env, jobject obj, jobject jbuffer, jlongArray jshape, jint jdtypeCode, jint jdtypeBits,
+    jint jdtypeLanes, jobject jret) {
+  void* data = env->GetDirectBufferAddress(jbuffer);
+  if (data == nullptr) {
+    TVMAPISetLastError("The ByteBuffer is not direct");
+    return -1;
+  }
+  int ndim = static_cast<int>(env->GetArrayLength(jshape));
+  int64_t numElements = 1;
+  int64_t* shape = new int64_t[ndim];
+  env->GetLongArrayRegion(jshape, 0, ndim, reinterpret_cast<jlong*>(shape));
+  for (int i = 0; i < ndim; ++i) {
+    numElements *= shape[i];
+  }
+  int64_t numBytes = (numElements * jdtypeBits * jdtypeLanes + 7) / 8;
+  if (numBytes > env->GetDirectBufferCapacity(jbuffer)) {
+    delete[] shape;
+    TVMAPISetLastError("The ByteBuffer is smaller than the array");
+    return -1;
+  }
+
+  DLManagedTensor* tensor = new DLManagedTensor();
+  tensor->dl_tensor.data = data;
+  tensor->dl_tensor.device = DLDevice{kDLCPU, 0};
+  tensor->dl_tensor.ndim = ndim;
+  tensor->dl_tensor.dtype.code = static_cast<uint8_t>(jdtypeCode);
+  tensor->dl_tensor.dtype.bits = static_cast<uint8_t>(jdtypeBits);
+  tensor->dl_tensor.dtype.lanes = static_cast<uint16_t>(jdtypeLanes);
+  tensor->dl_tensor.shape = shape;
+  tensor->dl_tensor.strides = nullptr;
+  tensor->dl_tensor.byte_offset = 0;
+  // The array keeps the buffer alive.
+  tensor->manager_ctx = reinterpret_cast<void*>(env->NewGlobalRef(jbuffer));
+  tensor->deleter = directBufferDeleter;
+
+  TVMArrayHandle out;
+  int ret = TVMArrayFromDLPack(tensor, &out);
+  if (ret != 0) {
+    env->DeleteGlobalRef(reinterpret_cast<jobject>(tensor->manager_ctx));
+    delete[] shape;
+    delete tensor;
+    return ret;
+  }
+  setLongField(env, jret, reinterpret_cast<jlong>(out));
+  return 0;
+}
+
+JNIEXPORT jobject JNICALL Java_org_apache_tvm_LibInfo_tvmArrayGetDirectBuffer(JNIEnv* env,
+                                                                              jobject obj,
+                                                                              jlong jhandle) {
+  DLTensor* array = reinterpret_cast<DLTensor*>(jhandle);
+  int64_t numElements = 1;
+  for (int i = 0; i < array->ndim; ++i) {
+    numElements *= array->shape[i];
+  }
+  int64_t numBytes = (numElements * array->dtype.bits * array->dtype.lanes + 7) / 8;
+  return env->NewDirectByteBuffer(static_cast<char*>(array->data) + array->byte_offset, numBytes);
+}
+
 // Device
 JNIEXPORT jint JNICALL Java_org_apache_tvm_LibInfo_tvmSynchronize(JNIEnv* env, jint deviceType,
                                                                   jint deviceId) {
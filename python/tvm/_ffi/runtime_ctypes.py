@@ -439,6 +439,53 @@ class Device(ctypes.Structure):
         """
         check_call(_LIB.TVMSynchronize(self.device_type, self.device_id, stream))
 
+    def create_raw_event(self):
+        """Create a new event at the context.
+
+        User should free the event after use.
+
+        Returns
+        -------
+        event : TVMEventHandle
+            The created event.
+        """
+        event = ctypes.c_void_p()
+        check_call(_LIB.TVMEventCreate(self.device_type, self.device_id, ctypes.byref(event)))
+        return event
+
+    def free_raw_event(self, event):
+        """Free a created event handle.
+
+        Parameters
+        ----------
+        event : TVMEventHandle
+            The event which should to be released.
+        """
+        check_call(_LIB.TVMEventFree(self.device_type, self.device_id, event))
+
+    def record_event(self, event, stream=None):
+        """Record an event on a stream, completed when the jobs enqueued before it finish.
+
+        Parameters
+        ----------
+        event : TVMEventHandle
+            The event to record.
+
+        stream : TVMStreamHandle
+            The stream, None for the default stream.
+        """
+        check_call(_LIB.TVMEventRecord(self.device_type, self.device_id, event, stream))
+
+    def sync_event(self, event):
+        """Synchronize until the jobs recorded by an event finished.
+
+        Parameters
+        ----------
+        event : TVMEventHandle
+            The event to wait for.
+        """
+        check_call(_LIB.TVMEventSynchronize(self.device_type, self.device_id, event))
+
     def __eq__(self, other):
         return (
             isinstance(other, Device)
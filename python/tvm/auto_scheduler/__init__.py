@@ -19,6 +19,7 @@
 
 from . import compute_dag
 from . import dispatcher
+from . import distributed
 from . import feature
 from . import loop_state
 from . import measure
@@ -32,8 +33,9 @@ from . import workload_registry
 
 # Shortcut
 from .compute_dag import ComputeDAG, LayoutRewriteOption, get_shape_from_rewritten_layout
-from .cost_model import RandomModel, XGBModel
+from .cost_model import RandomModel, XGBModel, GBDTModel
 from .dispatcher import DispatchContext, ApplyHistoryBest, ApplyHistoryBestOrSample
+from .distributed import TuningCoordinator, TuningWorker
 from .measure import (
     MeasureInput,
     MeasureResult,
@@ -43,7 +45,15 @@ from .measure import (
     LocalRPCMeasureContext,
     register_task_input_check_func,
 )
-from .measure_record import RecordToFile, RecordReader, load_best_record, load_records, save_records
+from .measure_record import (
+    RecordToFile,
+    RecordReader,
+    RecordDatabase,
+    RecordToDatabase,
+    load_best_record,
+    load_records,
+    save_records,
+)
 from .relay_integration import (
     extract_tasks,
     remove_index_check,
@@ -56,6 +66,8 @@ from .search_policy import (
     SketchPolicy,
     PreloadMeasuredStates,
     PreloadCustomSketchRule,
+    PreloadSimilarStates,
+    sparse_dense_sketch_rule,
 )
 from .task_scheduler import TaskScheduler
 from .workload_registry import register_workload, make_workload_key
@@ -203,6 +203,39 @@ class ComputeDAG(Object):
                 updated_state.stage_id_map[k] = v
         return updated_state
 
+    def infer_bound_from_states(self, states):
+        """
+        Infer and fill the bound of all iterators of a batch of states, in parallel.
+
+        The bound information is cached by the transform steps of the states, so states with
+        the same steps as a state inferred before on this DAG are not inferred again.
+
+        Parameters
+        ----------
+        states : List[Union[State, StateObject]]
+            The states from which we get transform steps.
+
+        Returns
+        -------
+        updated_states : List[Optional[State]]
+            The States with complete bound information, or None for a state whose bound
+            inference fails.
+        """
+        state_objs = [s if isinstance(s, StateObject) else s.state_object for s in states]
+        updated_states = []
+        for state, state_obj in zip(
+            states, _ffi_api.ComputeDAGInferBoundFromStates(self, state_objs)
+        ):
+            if state_obj is None:
+                updated_states.append(None)
+                continue
+            updated_state = State(state_obj, self)
+            if isinstance(state, State):
+                for k, v in state.stage_id_map.items():
+                    updated_state.stage_id_map[k] = v
+            updated_states.append(updated_state)
+        return updated_states
+
     def rewrite_layout_from_state(self, state):
         """
         Rewrite the layout of the DAG according to the history transform steps of a state.
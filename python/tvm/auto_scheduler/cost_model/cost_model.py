@@ -84,6 +84,85 @@ def random_fill_float(size, return_ptr):
     array_wrapper[:] = np.random.uniform(0, 1, (size,))
 
 
+@tvm._ffi.register_object("auto_scheduler.GBDTModel")
+class GBDTModel(CostModel):
+    """A gradient boosted tree model trained and evaluated in c++.
+
+    Like XGBModel, it predicts the normalized throughput of a program as the sum of the
+    predictions for its per-store feature vectors. It does not depend on xgboost, and its
+    predictions do not go through python during the search. Every update adds
+    `num_rounds_per_update` trees fitted on all the measurements so far.
+
+    Parameters
+    ----------
+    num_warmup_sample : int
+        Predict random scores until this number of measurements is reached.
+    max_depth : int
+        The depth of the trees, at most 10.
+    num_rounds_per_update : int
+        The number of trees added by an update.
+    max_num_trees : int
+        The maximum number of trees. The model is trained again from scratch with half this
+        number of trees when an update would exceed it.
+    num_bins : int
+        The number of histogram bins of a feature, at most 256.
+    learning_rate : float
+        The shrinkage applied to the leaves of a new tree.
+    reg_lambda : float
+        The L2 regularization of the leaf values.
+    """
+
+    def __init__(
+        self,
+        num_warmup_sample=100,
+        max_depth=6,
+        num_rounds_per_update=40,
+        max_num_trees=400,
+        num_bins=64,
+        learning_rate=0.3,
+        reg_lambda=1.0,
+    ):
+        self.__init_handle_by_constructor__(
+            _ffi_api.GBDTModel,
+            num_warmup_sample,
+            max_depth,
+            num_rounds_per_update,
+            max_num_trees,
+            num_bins,
+            learning_rate,
+            reg_lambda,
+        )
+
+    def update(self, inputs, results):
+        """Update the cost model according to new measurement results (training data).
+
+        Parameters
+        ----------
+        inputs : List[auto_scheduler.measure.MeasureInput]
+            The measurement inputs
+        results : List[auto_scheduler.measure.MeasureResult]
+            The measurement results
+        """
+        _ffi_api.CostModelUpdate(self, inputs, results)
+
+    def predict(self, search_task, states):
+        """Predict the scores of states
+
+        Parameters
+        ----------
+        search_task : SearchTask
+            The search task of states
+        states : List[State]
+            The input states
+
+        Returns
+        -------
+        scores: List[float]
+            The predicted scores for all states
+        """
+        return [x.value for x in _ffi_api.CostModelPredict(self, search_task, states)]
+
+
 @tvm._ffi.register_object("auto_scheduler.PythonBasedModel")
 class PythonBasedModel(CostModel):
     """Base class for cost models implemented in python"""
@@ -32,7 +32,7 @@ from tvm.contrib.utils import tempdir
 from tvm.tir.expr import FloatImm
 from .cost_model import RandomModel, XGBModel
 from .measure import LocalRPCMeasureContext
-from .measure_record import RecordToFile, load_records
+from .measure_record import RecordDatabase, RecordToFile, load_records
 from .search_policy import PreloadMeasuredStates, SketchPolicy
 from .search_task import SearchTask, TuningOptions
 from .utils import calc_workload_dis_factor, decode_workload_key
@@ -130,11 +130,12 @@ class ApplyHistoryBest(DispatchContext):
 
     Parameters
     ----------
-    records : str or iterator of (auto_scheduler.measure.MeasureInput,\
-                                  auto_scheduler.measure.MeasureResult)
+    records : str, RecordDatabase or iterator of (auto_scheduler.measure.MeasureInput,\
+                                                  auto_scheduler.measure.MeasureResult)
         Collection of tuning records.
         If is str, then it should be the filename of a records log file.
-        Each row of this file is an encoded record pair. Otherwise, it is an iterator.
+        Each row of this file is an encoded record pair. If it is a RecordDatabase, only its
+        best record of every workload is loaded. Otherwise, it is an iterator.
     n_lines: Optional[int]
         if it is not None, only load the first `n_lines` lines of log.
     include_compatible: bool
@@ -188,11 +189,12 @@ class ApplyHistoryBest(DispatchContext):
 
         Parameters
         ----------
-        records : str or iterator of (auto_scheduler.measure.MeasureInput,\
-                                      auto_scheduler.measure.MeasureResult)
+        records : str, RecordDatabase or iterator of (auto_scheduler.measure.MeasureInput,\
+                                                      auto_scheduler.measure.MeasureResult)
             Collection of tuning records.
             If is str, then it should be the filename of a records log file.
-            Each row of this file is an encoded record pair. Otherwise, it is an iterator.
+            Each row of this file is an encoded record pair. If it is a RecordDatabase, only
+            its best record of every workload is loaded. Otherwise, it is an iterator.
         n_lines: Optional[int]
             if it is not None, only load the first `n_lines` lines of log
         """
@@ -201,6 +203,8 @@ class ApplyHistoryBest(DispatchContext):
 
         if isinstance(records, str):
             records = load_records(records)
+        elif isinstance(records, RecordDatabase):
+            records = records.best_records()
 
         if not records:
             return
@@ -0,0 +1,393 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""
+Distributed tuning of search tasks across worker nodes.
+
+A :any:`TuningCoordinator` shards a list of search tasks across :any:`TuningWorker`
+processes, which can run on different nodes and measure with their own builders and
+runners. The coordinator is the only writer of the log file, the central store of the
+measurement records.
+
+The workers send the records of every measured batch to the coordinator, which forwards
+them to the other workers, so that the cost model of every worker is trained on the
+measurements of all the tasks.
+
+A worker which disconnects or stops sending heartbeats is dropped, and its task is given
+to another worker. The new worker preloads the records already measured for the task, and
+only measures its remaining trials.
+"""
+
+import collections
+import logging
+import os
+import queue
+import socket
+import tempfile
+import threading
+import time
+from multiprocessing import AuthenticationError
+from multiprocessing.connection import Client, Listener, wait
+
+from .cost_model import RandomModel, XGBModel, GBDTModel
+from .measure import PythonBasedMeasureCallback
+from .measure_record import RecordReader, dump_record_to_string, load_record_from_string
+from .measure_record import save_records
+from .search_policy import SketchPolicy, PreloadMeasuredStates
+from .search_task import TuningOptions
+
+logger = logging.getLogger("auto_scheduler")
+
+DEFAULT_AUTHKEY = b"auto_scheduler"
+
+
+class _WorkerConnection:
+    """The state of a connected worker on the coordinator."""
+
+    def __init__(self, conn):
+        self.conn = conn
+        self.name = "unknown"
+        self.task_idx = None
+        self.last_seen = time.time()
+        # The records of the other workers not yet sent to this worker.
+        self.outbox = []
+
+
+class TuningCoordinator:
+    """Shard search tasks across tuning workers.
+
+    The coordinator listens for :any:`TuningWorker` connections and gives every worker one
+    task at a time, until the records of every task reach `num_measure_trials_per_task`.
+    The records already in `log_file` count toward the trials of their task, so an
+    interrupted coordinator resumes where it stopped.
+
+    Parameters
+    ----------
+    tasks : List[SearchTask]
+        The tasks to tune.
+    num_measure_trials_per_task : int
+        The number of measurement trials of each task.
+    log_file : str
+        The file which stores the measurement records of all the tasks.
+    address : Tuple[str, int]
+        The address to listen to. The port is chosen by the system if it is 0.
+    authkey : bytes
+        The key the workers authenticate with.
+    heartbeat_timeout : float
+        The number of seconds after which a silent worker is considered dead. The workers
+        also report at the end of every measurement round, which must take less time.
+    """
+
+    def __init__(
+        self,
+        tasks,
+        num_measure_trials_per_task,
+        log_file,
+        address=("0.0.0.0", 9195),
+        authkey=DEFAULT_AUTHKEY,
+        heartbeat_timeout=120.0,
+    ):
+        self.tasks = list(tasks)
+        self.num_measure_trials_per_task = num_measure_trials_per_task
+        self.log_file = log_file
+        self.heartbeat_timeout = heartbeat_timeout
+        self._listener = Listener(address, authkey=authkey)
+        # The address the workers connect to, with the port chosen when 0 is given.
+        self.address = self._listener.address
+
+        self._records = [[] for _ in self.tasks]
+        if os.path.isfile(log_file):
+            task_idx = {task.workload_key: i for i, task in enumerate(self.tasks)}
+            for inp, res in RecordReader(log_file):
+                idx = task_idx.get(inp.task.workload_key)
+                if idx is not None:
+                    self._records[idx].append(dump_record_to_string(inp, res))
+        self._pending = collections.deque()
+        self._done = set()
+        for idx in range(len(self.tasks)):
+            if self.num_measured(idx) < num_measure_trials_per_task:
+                self._pending.append(idx)
+            else:
+                self._done.add(idx)
+        self._workers = {}
+
+    def num_measured(self, task_idx):
+        """The number of records of a task."""
+        return len(self._records[task_idx])
+
+    def run(self):
+        """Serve the workers until all the tasks are tuned."""
+        listener = self._listener
+        new_conns = queue.Queue()
+        closed = threading.Event()
+
+        def accept():
+            while True:
+                try:
+                    new_conns.put(listener.accept())
+                except AuthenticationError:
+                    logger.warning("TuningCoordinator: A worker failed to authenticate.")
+                except (OSError, EOFError):
+                    if closed.is_set():
+                        return
+
+        threading.Thread(target=accept, daemon=True).start()
+        logger.info("TuningCoordinator: Listening to %s:%d", *self.address)
+
+        with open(self.log_file, "a") as log:
+            finish_time = None
+            while finish_time is None or (
+                self._workers and time.time() - finish_time < self.heartbeat_timeout
+            ):
+                while not new_conns.empty():
+                    conn = new_conns.get()
+                    self._workers[conn] = _WorkerConnection(conn)
+                for conn in wait(list(self._workers), timeout=1.0):
+                    worker = self._workers[conn]
+                    try:
+                        reply = self._handle(worker, conn.recv(), log)
+                        conn.send(reply)
+                    except (EOFError, OSError):
+                        self._drop(worker)
+                now = time.time()
+                for worker in list(self._workers.values()):
+                    if now - worker.last_seen > self.heartbeat_timeout:
+                        self._drop(worker)
+                if finish_time is None and len(self._done) == len(self.tasks):
+                    # Give the connected workers the time to ask for a task and stop.
+                    finish_time = now
+
+        for worker in list(self._workers.values()):
+            worker.conn.close()
+        self._workers.clear()
+        closed.set()
+        listener.close()
+        logger.info("TuningCoordinator: All the tasks are tuned.")
+
+    def _handle(self, worker, msg, log):
+        worker.last_seen = time.time()
+        kind = msg[0]
+        if kind == "hello":
+            worker.name = msg[1]
+            logger.info("TuningCoordinator: Worker %s joined.", worker.name)
+            return ("welcome", self.tasks)
+        if kind == "request":
+            if self._pending:
+                idx = self._pending.popleft()
+                num_trials = self.num_measure_trials_per_task - self.num_measured(idx)
+                worker.task_idx = idx
+                logger.info("TuningCoordinator: Task %d is given to worker %s.", idx, worker.name)
+                return ("task", idx, num_trials, list(self._records[idx]))
+            if len(self._done) == len(self.tasks):
+                return ("stop",)
+            # The remaining tasks are being tuned, and come back if their worker dies.
+            return ("wait", 1.0)
+        if kind == "records":
+            _, idx, records = msg
+            self._records[idx].extend(records)
+            log.writelines(records)
+            log.flush()
+            for other in self._workers.values():
+                if other is not worker:
+                    other.outbox.extend(records)
+        elif kind == "done":
+            self._done.add(msg[1])
+            worker.task_idx = None
+            logger.info(
+                "TuningCoordinator: Task %d is tuned, %d/%d done.",
+                msg[1],
+                len(self._done),
+                len(self.tasks),
+            )
+        elif kind != "heartbeat":
+            raise ValueError("Invalid message: " + str(kind))
+        records, worker.outbox = worker.outbox, []
+        return ("records", records)
+
+    def _drop(self, worker):
+        if worker.task_idx is not None and worker.task_idx not in self._done:
+            logger.warning(
+                "TuningCoordinator: Worker %s is lost, task %d is given back.",
+                worker.name,
+                worker.task_idx,
+            )
+            self._pending.appendleft(worker.task_idx)
+        worker.conn.close()
+        del self._workers[worker.conn]
+
+
+class _ForwardRecords(PythonBasedMeasureCallback):
+    """Send the measured records to the coordinator and train on the records of the others."""
+
+    def __init__(self, worker, task_idx):
+        super().__init__()
+        self.worker = worker
+        self.task_idx = task_idx
+
+    def callback(self, policy, inputs, results):
+        records = [dump_record_to_string(inp, res) for inp, res in zip(inputs, results)]
+        self.worker.call(("records", self.task_idx, records))
+        self.worker.update_from_others()
+
+
+class TuningWorker:
+    """Tune the tasks given by a :any:`TuningCoordinator`.
+
+    The worker tunes one task at a time with a :any:`SketchPolicy`, measuring with its own
+    builder and runner. Its cost model is shared by all the tasks it tunes, and is also
+    trained on the records measured by the other workers.
+
+    Parameters
+    ----------
+    address : Tuple[str, int]
+        The address of the coordinator.
+    authkey : bytes
+        The key to authenticate with the coordinator.
+    name : Optional[str]
+        The name of the worker in the logs of the coordinator, the host name by default.
+    builder : Union[ProgramBuilder, str] = "local"
+        The builder of the measured programs.
+    runner : Union[ProgramRunner, str] = "local"
+        The runner of the measured programs.
+    cost_model : Union[CostModel, str] = "xgb"
+        The cost model, or one of "xgb", "gbdt" and "random".
+    num_measures_per_round : int = 64
+        The number of programs measured at once.
+    search_policy_params : Optional[Dict[str, Any]]
+        The parameters of the search policy.
+    heartbeat_interval : float = 10.0
+        The number of seconds between two heartbeats. It must be smaller than the heartbeat
+        timeout of the coordinator.
+    verbose : int = 1
+        The verbosity level. 0 for silent.
+    """
+
+    def __init__(
+        self,
+        address,
+        authkey=DEFAULT_AUTHKEY,
+        name=None,
+        builder="local",
+        runner="local",
+        cost_model="xgb",
+        num_measures_per_round=64,
+        search_policy_params=None,
+        heartbeat_interval=10.0,
+        verbose=1,
+    ):
+        self.address = address
+        self.authkey = authkey
+        self.name = name or socket.gethostname()
+        self.builder = builder
+        self.runner = runner
+        self.cost_model = cost_model
+        self.num_measures_per_round = num_measures_per_round
+        self.search_policy_params = search_policy_params
+        self.heartbeat_interval = heartbeat_interval
+        self.verbose = verbose
+
+        self._conn = None
+        self._lock = threading.Lock()
+        self._inbox = []
+
+    def call(self, msg):
+        """Send a message to the coordinator and return its reply."""
+        with self._lock:
+            self._conn.send(msg)
+            reply = self._conn.recv()
+            if reply[0] == "records":
+                self._inbox.extend(reply[1])
+            return reply
+
+    def update_from_others(self):
+        """Update the cost model with the records received from the other workers."""
+        with self._lock:
+            records, self._inbox = self._inbox, []
+        if records:
+            inputs, results = zip(*[load_record_from_string(record) for record in records])
+            self.cost_model.update(list(inputs), list(results))
+
+    def run(self):
+        """Tune the tasks given by the coordinator until they are all tuned."""
+        self._conn = Client(self.address, authkey=self.authkey)
+        stop = threading.Event()
+        try:
+            # Receiving the tasks registers their workloads, which the records need.
+            tasks = self.call(("hello", self.name))[1]
+            if isinstance(self.cost_model, str):
+                self.cost_model = self._make_cost_model(self.cost_model)
+
+            def heartbeat():
+                while not stop.wait(self.heartbeat_interval):
+                    try:
+                        self.call(("heartbeat",))
+                    except (EOFError, OSError):
+                        return
+
+            threading.Thread(target=heartbeat, daemon=True).start()
+            while True:
+                reply = self.call(("request",))
+                if reply[0] == "stop":
+                    break
+                if reply[0] == "wait":
+                    time.sleep(reply[1])
+                    continue
+                _, idx, num_trials, records = reply
+                self.update_from_others()
+                self._tune(tasks[idx], idx, num_trials, records)
+                self.call(("done", idx))
+        finally:
+            stop.set()
+            with self._lock:
+                self._conn.close()
+
+    def _make_cost_model(self, model_type):
+        if model_type == "xgb":
+            return XGBModel()
+        if model_type == "gbdt":
+            return GBDTModel()
+        if model_type == "random":
+            return RandomModel()
+        raise ValueError("Invalid cost model: " + model_type)
+
+    def _tune(self, task, task_idx, num_trials, records):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            init_search_callbacks = None
+            if records:
+                # The task was started by a worker which died, its measured states are
+                # loaded so that they are not measured again.
+                inputs, results = zip(*[load_record_from_string(record) for record in records])
+                preload_file = os.path.join(tmpdir, "preload.json")
+                save_records(preload_file, list(inputs), list(results))
+                init_search_callbacks = [PreloadMeasuredStates(preload_file)]
+                self.cost_model.update(list(inputs), list(results))
+            policy = SketchPolicy(
+                task,
+                self.cost_model,
+                params=self.search_policy_params,
+                verbose=self.verbose,
+                init_search_callbacks=init_search_callbacks,
+            )
+            tuning_options = TuningOptions(
+                num_measure_trials=num_trials,
+                num_measures_per_round=self.num_measures_per_round,
+                builder=self.builder,
+                runner=self.runner,
+                measure_callbacks=[_ForwardRecords(self, task_idx)],
+                verbose=self.verbose,
+            )
+            task.tune(tuning_options, search_policy=policy)
@@ -252,3 +252,17 @@ def get_per_store_feature_names(max_n_bufs: Optional[int] = None) -> List[str]:
         The names of elements in the flatten feature vector
     """
     return _ffi_api.GetPerStoreFeatureNames(max_n_bufs or DEFAULT_MAX_N_BUFS)
+
+
+def reset_feature_cache(capacity: int = 1 << 16):
+    """Clear the cache of the features extracted from states and set its capacity.
+
+    The features of a state are cached by its task and its transform steps, so that the states
+    evaluated again by the search policies are only lowered once.
+
+    Parameters
+    ----------
+    capacity: int
+        The maximum number of states cached, 0 to disable the cache
+    """
+    _ffi_api.ResetFeatureCache(capacity)
@@ -32,6 +32,7 @@ We implement these in python to utilize python's multiprocessing and error handl
 """
 
 import os
+import json
 import time
 import shutil
 import tempfile
@@ -39,6 +40,7 @@ import multiprocessing
 import logging
 
 import tvm._ffi
+from tvm import rpc
 from tvm.runtime import Object, module, ndarray
 from tvm.driver import build_module
 from tvm.ir import transform
@@ -164,14 +166,17 @@ class BuildResult(Object):
         The error message if there is any error.
     time_cost : float
         The time cost of build.
+    module_ir : Optional[str]
+        The LLVM IR of an in-memory build, JITed by the runner instead of loading `filename`.
     """
 
-    def __init__(self, filename, args, error_no, error_msg, time_cost):
+    def __init__(self, filename, args, error_no, error_msg, time_cost, module_ir=None):
         filename = filename if filename else ""
         error_msg = error_msg if error_msg else ""
+        module_ir = module_ir if module_ir else ""
 
         self.__init_handle_by_constructor__(
-            _ffi_api.BuildResult, filename, args, error_no, error_msg, time_cost
+            _ffi_api.BuildResult, filename, args, error_no, error_msg, time_cost, module_ir
         )
 
 
@@ -327,6 +332,9 @@ class LocalBuilder(ProgramBuilder):
     build_func: callable or str = "default"
         If is 'default', use default build function
         If is 'ndk', use function for android ndk
+        If is 'jit', keep the programs built for the llvm target in memory, as LLVM IR the
+        LocalRunner JITs, instead of exporting and linking them into libraries. The other
+        programs are exported as for 'default'. Only the LocalRunner measures these builds.
         If is callable, use it as custom build function, expect lib_format field.
     """
 
@@ -337,6 +345,9 @@ class LocalBuilder(ProgramBuilder):
         elif build_func == "ndk":
             BuildFunc.name = "ndk"
             BuildFunc.build_func = ndk.create_shared
+        elif build_func == "jit":
+            BuildFunc.name = "jit"
+            BuildFunc.build_func = tar.tar
         elif callable(build_func):
             BuildFunc.name = "custom"
             BuildFunc.build_func = build_func
@@ -381,6 +392,16 @@ class LocalRunner(ProgramRunner):
         its actual latency during end-to-end inference.
         To make this option effective, the argument `number` should also be set to 1.
         This is only has effect on CPU task.
+    max_repeat : int = 0
+        The maximum number of times to repeat the measurement. When it is larger than `repeat`,
+        the measurement is repeated past `repeat` until the 95% confidence interval of the mean
+        cost is within `max_rel_ci` of the mean, and the outliers are rejected from the costs.
+    max_rel_ci : float = 0.02
+        The target half width of the confidence interval, relative to the mean cost.
+    cutoff_ratio : float = 0.0
+        Stop measuring a program once its cost is this many times the best cost of its task so
+        far, e.g. 10 for the programs 10x slower. The costs reported are then fewer than
+        `repeat`. 0 measures every program in full.
     """
 
     def __init__(
@@ -391,6 +412,9 @@ class LocalRunner(ProgramRunner):
         min_repeat_ms=100,
         cooldown_interval=0.0,
         enable_cpu_cache_flush=False,
+        max_repeat=0,
+        max_rel_ci=0.02,
+        cutoff_ratio=0.0,
     ):
         if enable_cpu_cache_flush:
             number = 1
@@ -404,6 +428,9 @@ class LocalRunner(ProgramRunner):
             min_repeat_ms,
             cooldown_interval,
             enable_cpu_cache_flush,
+            max_repeat,
+            max_rel_ci,
+            cutoff_ratio,
         )
 
 
@@ -452,6 +479,22 @@ class RPCRunner(ProgramRunner):
         its actual latency during end-to-end inference.
         To make this option effective, the argument `number` should also be set to 1.
         This is only has effect on CPU task.
+    max_repeat : int = 0
+        The maximum number of times to repeat the measurement. When it is larger than `repeat`,
+        the measurement is repeated past `repeat` until the 95% confidence interval of the mean
+        cost is within `max_rel_ci` of the mean, and the outliers are rejected from the costs.
+    max_rel_ci : float = 0.02
+        The target half width of the confidence interval, relative to the mean cost.
+    cutoff_ratio : float = 0.0
+        Stop measuring a program once its cost is this many times the best cost of its task so
+        far, e.g. 10 for the programs 10x slower. The costs reported are then fewer than
+        `repeat`. 0 measures every program in full.
+    batch_size : int = 1
+        The number of programs measured in the same remote session. The programs are
+        uploaded and measured back-to-back by the server, each in its own process with
+        the `timeout`, and the results are streamed back. 1 measures each program in its
+        own session, 0 sizes the batches from the queue of the tracker, to give a batch
+        to each available device.
     """
 
     def __init__(
@@ -467,6 +510,10 @@ class RPCRunner(ProgramRunner):
         min_repeat_ms=100,
         cooldown_interval=0.0,
         enable_cpu_cache_flush=False,
+        batch_size=1,
+        max_repeat=0,
+        max_rel_ci=0.02,
+        cutoff_ratio=0.0,
     ):
         self.__init_handle_by_constructor__(
             _ffi_api.RPCRunner,
@@ -481,6 +528,10 @@ class RPCRunner(ProgramRunner):
             min_repeat_ms,
             cooldown_interval,
             enable_cpu_cache_flush,
+            batch_size,
+            max_repeat,
+            max_rel_ci,
+            cutoff_ratio,
         )
 
         if check_remote(key, host, port, priority, timeout):
@@ -531,6 +582,18 @@ class LocalRPCMeasureContext:
         its actual latency during end-to-end inference.
         To make this option effective, the argument `number` should also be set to 1.
         This is only has effect on CPU task.
+    max_repeat : int = 0
+        The maximum number of times to repeat the measurement. When it is larger than `repeat`,
+        the measurement is repeated past `repeat` until the 95% confidence interval of the mean
+        cost is within `max_rel_ci` of the mean, and the outliers are rejected from the costs.
+    max_rel_ci : float = 0.02
+        The target half width of the confidence interval, relative to the mean cost.
+    cutoff_ratio : float = 0.0
+        Stop measuring a program once its cost is this many times the best cost of its task so
+        far, e.g. 10 for the programs 10x slower. The costs reported are then fewer than
+        `repeat`. 0 measures every program in full.
+    batch_size : int = 1
+        The number of programs measured in the same session of the local server.
     """
 
     def __init__(
@@ -543,6 +606,10 @@ class LocalRPCMeasureContext:
         min_repeat_ms=0,
         cooldown_interval=0.0,
         enable_cpu_cache_flush=False,
+        batch_size=1,
+        max_repeat=0,
+        max_rel_ci=0.02,
+        cutoff_ratio=0.0,
     ):
         # pylint: disable=import-outside-toplevel
         from tvm.rpc.tracker import Tracker
@@ -573,6 +640,10 @@ class LocalRPCMeasureContext:
             min_repeat_ms,
             cooldown_interval,
             enable_cpu_cache_flush,
+            batch_size,
+            max_repeat,
+            max_rel_ci,
+            cutoff_ratio,
         )
         # Wait for the processes to start
         time.sleep(0.5)
@@ -599,7 +670,14 @@ class MeasureErrorNo(object):
     UNKNOWN_ERROR = 8  # Unknown error
 
 
-def _timed_func(inp_serialized, build_func, verbose):
+def _in_memory_ir(func):
+    """The LLVM IR of a built module the runner can JIT in memory, None if it has to be exported"""
+    if func.type_key != "llvm" or func.imported_modules:
+        return None
+    return func.get_source("ll")
+
+
+def _timed_func(inp_serialized, build_func, verbose, in_memory=False):
     tic = time.time()
     inp = MeasureInput.deserialize(inp_serialized)
     task = inp.task
@@ -610,6 +688,7 @@ def _timed_func(inp_serialized, build_func, verbose):
     error_no = MeasureErrorNo.NO_ERROR
     error_msg = None
     args = []
+    module_ir = None
 
     try:
         sch, args = task.compute_dag.apply_steps_from_state(
@@ -620,20 +699,19 @@ def _timed_func(inp_serialized, build_func, verbose):
         error_no = MeasureErrorNo.INSTANTIATION_ERROR
         error_msg = make_traceback_info()
 
+    filename = ""
     if error_no == 0:
-        dirname = tempfile.mkdtemp()
-        filename = os.path.join(dirname, "tmp_func." + build_func.output_format)
-
         try:
             with transform.PassContext():
                 func = build_module.build(sch, args, target=task.target)
-            func.export_library(filename, build_func)
+            module_ir = _in_memory_ir(func) if in_memory else None
+            if module_ir is None:
+                filename = os.path.join(tempfile.mkdtemp(), "tmp_func." + build_func.output_format)
+                func.export_library(filename, build_func)
         # pylint: disable=broad-except
         except Exception:
             error_no = MeasureErrorNo.COMPILE_HOST
             error_msg = make_traceback_info()
-    else:
-        filename = ""
 
     if verbose >= 1:
         if error_no == MeasureErrorNo.NO_ERROR:
@@ -641,7 +719,7 @@ def _timed_func(inp_serialized, build_func, verbose):
         else:
             print(".E", end="", flush=True)  # Build error
 
-    return filename, args, error_no, error_msg, time.time() - tic
+    return filename, args, error_no, error_msg, time.time() - tic, module_ir
 
 
 def local_build_worker(args):
@@ -662,9 +740,10 @@ def local_build_worker(args):
     assert build_func == BuildFunc.name, (
         "BuildFunc.name: " + BuildFunc.name + ", but args is: " + build_func
     )
+    in_memory = build_func == "jit"
     build_func = BuildFunc.build_func
 
-    res = call_func_with_timeout(timeout, _timed_func, args=(inp, build_func, verbose))
+    res = call_func_with_timeout(timeout, _timed_func, args=(inp, build_func, verbose, in_memory))
     if isinstance(res, TimeoutError):
         if verbose >= 1:
             print(".T", end="", flush=True)  # Build timeout
@@ -817,6 +896,29 @@ def prepare_input_map(args):
     return tensor_input_map
 
 
+def _time_evaluator(
+    func, dev, number, repeat, min_repeat_ms, enable_cpu_cache_flush, max_repeat, max_rel_ci, cutoff
+):
+    """The time evaluator of the entry function of a module, adaptive with `max_repeat`."""
+    # Limitation:
+    # We can not get PackFunction directly in the remote mode as it is wrapped
+    # under the std::function. We could lift the restriction later once we fold
+    # the PackedFunc as an object. Currently, we pass function name to work
+    # around it.
+    f_prepare = "cache_flush_cpu_non_first_arg" if enable_cpu_cache_flush else ""
+    return func.time_evaluator(
+        func.entry_name,
+        dev,
+        number=number,
+        repeat=repeat,
+        min_repeat_ms=min_repeat_ms,
+        f_preproc=f_prepare,
+        max_repeat=max_repeat,
+        max_rel_ci=max_rel_ci,
+        cutoff=cutoff,
+    )
+
+
 def _timed_eval_func(
     inp_serialized,
     build_res,
@@ -825,6 +927,9 @@ def _timed_eval_func(
     min_repeat_ms,
     cooldown_interval,
     enable_cpu_cache_flush,
+    max_repeat,
+    max_rel_ci,
+    cutoff,
     verbose,
 ):
     # pylint: disable=import-outside-toplevel
@@ -836,21 +941,23 @@ def _timed_eval_func(
     error_no = 0
     error_msg = None
     try:
-        func = module.load_module(build_res.filename)
+        if build_res.module_ir:
+            # JIT the in-memory build, lazily compiling the functions called with the ORC JIT.
+            jit = "orc" if tvm.target.codegen.llvm_version_major() >= 13 else "mcjit"
+            func = tvm.get_global_func("target.llvm_load_ir")(build_res.module_ir, jit)
+        else:
+            func = module.load_module(build_res.filename)
         dev = ndarray.device(str(inp.task.target), 0)
-        # Limitation:
-        # We can not get PackFunction directly in the remote mode as it is wrapped
-        # under the std::function. We could lift the restriction later once we fold
-        # the PackedFunc as an object. Currently, we pass function name to work
-        # around it.
-        f_prepare = "cache_flush_cpu_non_first_arg" if enable_cpu_cache_flush else ""
-        time_f = func.time_evaluator(
-            func.entry_name,
+        time_f = _time_evaluator(
+            func,
             dev,
-            number=number,
-            repeat=repeat,
-            min_repeat_ms=min_repeat_ms,
-            f_preproc=f_prepare,
+            number,
+            repeat,
+            min_repeat_ms,
+            enable_cpu_cache_flush,
+            max_repeat,
+            max_rel_ci,
+            cutoff,
         )
     # pylint: disable=broad-except
     except Exception:
@@ -897,7 +1004,8 @@ def _timed_eval_func(
             error_no = MeasureErrorNo.RUNTIME_DEVICE
             error_msg = make_traceback_info()
 
-    shutil.rmtree(os.path.dirname(build_res.filename))
+    if build_res.filename:
+        shutil.rmtree(os.path.dirname(build_res.filename))
     toc = time.time()
     time.sleep(cooldown_interval)
 
@@ -920,6 +1028,9 @@ def local_run(
     cooldown_interval=0,
     enable_cpu_cache_flush=False,
     verbose=1,
+    max_repeat=0,
+    max_rel_ci=0.02,
+    cutoff=0.0,
 ):
     """
     Run function of LocalRunner to test the performance of the input BuildResults.
@@ -957,6 +1068,15 @@ def local_run(
         its actual latency during end-to-end inference.
         To make this option effective, the argument `number` should also be set to 1.
         This is only has effect on CPU task.
+    max_repeat : int = 0
+        The maximum number of times to repeat the measurement. When it is larger than `repeat`,
+        the measurement is repeated past `repeat` until the 95% confidence interval of the mean
+        cost is within `max_rel_ci` of the mean, and the outliers are rejected from the costs.
+    max_rel_ci : float = 0.02
+        The target half width of the confidence interval, relative to the mean cost.
+    cutoff : float = 0.0
+        The cost in seconds past which a program is not measured further, derived from the
+        best cost of the task by the runner. 0 measures every program in full.
     verbose: int = 1
         Verbosity level. 0 for silent, 1 to output information during program measuring.
 
@@ -989,6 +1109,9 @@ def local_run(
                     min_repeat_ms,
                     cooldown_interval,
                     enable_cpu_cache_flush,
+                    max_repeat,
+                    max_rel_ci,
+                    cutoff,
                     verbose,
                 ),
                 add_thread_wrapper=True,
@@ -1035,6 +1158,9 @@ def _timed_rpc_run(
     min_repeat_ms,
     cooldown_interval,
     enable_cpu_cache_flush,
+    max_repeat,
+    max_rel_ci,
+    cutoff,
     verbose,
 ):
     # pylint: disable=import-outside-toplevel
@@ -1047,23 +1173,21 @@ def _timed_rpc_run(
     error_msg = None
     try:
         # upload built module
+        assert build_res.filename, "The in-memory builds can only be measured by LocalRunner"
         remote = request_remote(key, host, port, priority, timeout)
         remote.upload(build_res.filename)
         func = remote.load_module(os.path.split(build_res.filename)[1])
         dev = remote.device(str(inp.task.target), 0)
-        # Limitation:
-        # We can not get PackFunction directly in the remote mode as it is wrapped
-        # under the std::function. We could lift the restriction later once we fold
-        # the PackedFunc as an object. Currently, we pass function name to work
-        # around it.
-        f_prepare = "cache_flush_cpu_non_first_arg" if enable_cpu_cache_flush else ""
-        time_f = func.time_evaluator(
-            func.entry_name,
+        time_f = _time_evaluator(
+            func,
             dev,
-            number=number,
-            repeat=repeat,
-            min_repeat_ms=min_repeat_ms,
-            f_preproc=f_prepare,
+            number,
+            repeat,
+            min_repeat_ms,
+            enable_cpu_cache_flush,
+            max_repeat,
+            max_rel_ci,
+            cutoff,
         )
     # pylint: disable=broad-except
     except Exception:
@@ -1126,7 +1250,8 @@ def _timed_rpc_run(
             error_no = MeasureErrorNo.RUNTIME_DEVICE
             error_msg = make_traceback_info()
 
-    shutil.rmtree(os.path.dirname(build_res.filename))
+    if build_res.filename:
+        shutil.rmtree(os.path.dirname(build_res.filename))
     toc = time.time()
 
     time.sleep(cooldown_interval)
@@ -1152,7 +1277,7 @@ def _rpc_run_worker(args):
     res : MeasureResult
         The measure result of this Runner thread.
     """
-    _, build_res, _, _, _, _, timeout, _, _, _, _, _, verbose = args
+    _, build_res, _, _, _, _, timeout, _, _, _, _, _, _, _, _, verbose = args
     if build_res.error_no != MeasureErrorNo.NO_ERROR:
         return (
             (MAX_FLOAT,),
@@ -1187,6 +1312,147 @@ def _rpc_run_worker(args):
     return res
 
 
+def _rpc_run_batch(
+    inputs_serialized,
+    build_results,
+    key,
+    host,
+    port,
+    priority,
+    timeout,
+    number,
+    repeat,
+    min_repeat_ms,
+    cooldown_interval,
+    enable_cpu_cache_flush,
+    max_repeat,
+    max_rel_ci,
+    cutoff,
+    verbose,
+):
+    """Measure several programs in one remote session.
+
+    All the modules are uploaded and measured by pipelined calls to the
+    "tvm.rpc.server.measure_module" function of the server, which measures each of them in
+    its own process with the timeout.
+
+    Returns
+    -------
+    res : Optional[List[Tuple]]
+        The results in the same format as _timed_rpc_run, None when the server does not
+        have the measurement function.
+    """
+    assert all(
+        build_res.filename for build_res in build_results
+    ), "The in-memory builds can only be measured by LocalRunner"
+    tic = time.time()
+    remote = request_remote(key, host, port, priority, timeout * (len(build_results) + 1))
+    try:
+        fmeasure = remote.get_function("tvm.rpc.server.measure_module")
+    except AttributeError:
+        return None
+    fupload = remote.get_function("tvm.rpc.server.upload")
+    config = json.dumps(
+        {
+            "number": number,
+            "repeat": repeat,
+            "min_repeat_ms": min_repeat_ms,
+            "f_preproc": "cache_flush_cpu_non_first_arg" if enable_cpu_cache_flush else "",
+            "max_repeat": max_repeat,
+            "max_rel_ci": max_rel_ci,
+            "cutoff": cutoff,
+        }
+    )
+
+    futures = []
+    for inp_serialized, build_res in zip(inputs_serialized, build_results):
+        inp = MeasureInput.deserialize(inp_serialized)
+        dev = remote.device(str(inp.task.target), 0)
+        file_name = os.path.split(build_res.filename)[1]
+        with open(build_res.filename, "rb") as f:
+            remote.call_async(fupload, file_name, bytearray(f.read()))
+        arg_info = json.dumps([(get_const_tuple(arg.shape), arg.dtype) for arg in build_res.args])
+        futures.append(
+            remote.call_async(fmeasure, file_name, arg_info, dev, config, timeout)
+        )
+
+    error_codes = {
+        "load_error": MeasureErrorNo.COMPILE_DEVICE,
+        "run_error": MeasureErrorNo.RUNTIME_DEVICE,
+        "timeout": MeasureErrorNo.RUN_TIMEOUT,
+    }
+    results = []
+    for future, build_res in zip(futures, build_results):
+        costs, error_no, error_msg = (MAX_FLOAT,), MeasureErrorNo.NO_ERROR, None
+        try:
+            res = json.loads(future.get())
+            if res["status"] == "ok":
+                costs = tuple(res["value"])
+            else:
+                error_no, error_msg = error_codes[res["status"]], res["value"]
+        # pylint: disable=broad-except
+        except Exception:
+            error_no, error_msg = MeasureErrorNo.RUNTIME_DEVICE, make_traceback_info()
+        toc = time.time()
+        results.append((costs, error_no, error_msg, toc - tic + build_res.time_cost, toc))
+        tic = toc
+        if verbose >= 1:
+            print("*" if error_no == MeasureErrorNo.NO_ERROR else "*E", end="")
+
+    try:
+        for build_res in build_results:
+            remote.remove(build_res.filename)
+            remote.remove(os.path.splitext(build_res.filename)[0] + ".so")
+        remote.remove("")
+    # pylint: disable=broad-except
+    except Exception:
+        pass
+    for build_res in build_results:
+        shutil.rmtree(os.path.dirname(build_res.filename))
+    time.sleep(cooldown_interval)
+    return results
+
+
+def _rpc_run_batch_worker(args):
+    """Function to be ran in the RPCRunner thread pool, measures a batch of programs.
+
+    Parameters
+    ----------
+    args : Tuple[List[MeasureInput], List[BuildResult], ...]
+        The inputs and build results of the batch plus the rest of the arguments to
+        `rpc_runner_run`.
+
+    Returns
+    -------
+    res : List[Tuple]
+        The measure results of the batch.
+    """
+    inputs, build_results, _, _, _, _, timeout, _, _, _, _, _, _, _, _, verbose = args
+    res = call_func_with_timeout(timeout * (len(build_results) + 1), _rpc_run_batch, args=args)
+    if res is None:
+        # The server can only measure a program per session.
+        return [
+            _rpc_run_worker((inp, build_res) + args[2:])
+            for inp, build_res in zip(inputs, build_results)
+        ]
+    if isinstance(res, Exception):
+        if verbose >= 1:
+            print("*E" * len(build_results), end="")
+        return [
+            (
+                (MAX_FLOAT,),
+                MeasureErrorNo.RUN_TIMEOUT
+                if isinstance(res, TimeoutError)
+                else MeasureErrorNo.RUNTIME_DEVICE,
+                str(res),
+                build_res.time_cost + timeout,
+                time.time(),
+            )
+            for build_res in build_results
+        ]
+    return res
+
+
 @tvm._ffi.register_func("auto_scheduler.rpc_runner.run")
 def rpc_runner_run(
     inputs,
@@ -1203,6 +1469,10 @@ def rpc_runner_run(
     cooldown_interval=0.0,
     enable_cpu_cache_flush=False,
     verbose=1,
+    batch_size=1,
+    max_repeat=0,
+    max_rel_ci=0.02,
+    cutoff=0.0,
 ):
     """Run function of RPCRunner to test the performance of the input BuildResults.
 
@@ -1249,8 +1519,19 @@ def rpc_runner_run(
         its actual latency during end-to-end inference.
         To make this option effective, the argument `number` should also be set to 1.
         This is only has effect on CPU task.
+    max_repeat : int = 0
+        The maximum number of times to repeat the measurement. When it is larger than `repeat`,
+        the measurement is repeated past `repeat` until the 95% confidence interval of the mean
+        cost is within `max_rel_ci` of the mean, and the outliers are rejected from the costs.
+    max_rel_ci : float = 0.02
+        The target half width of the confidence interval, relative to the mean cost.
+    cutoff : float = 0.0
+        The cost in seconds past which a program is not measured further, derived from the
+        best cost of the task by the runner. 0 measures every program in full.
     verbose: int = 1
         Verbosity level. 0 for silent, 1 to output information during program measuring.
+    batch_size : int = 1
+        The number of programs measured in the same remote session.
 
     Returns
     -------
@@ -1258,6 +1539,31 @@ def rpc_runner_run(
         The measure results of these MeasureInputs.
     """
     assert len(inputs) == len(build_results), "Measure input size should be equal to build results"
+    if batch_size == 0:
+        batch_size = _auto_batch_size(len(inputs), key, host, port, n_parallel)
+    if batch_size > 1:
+        return _rpc_runner_run_batch(
+            inputs,
+            build_results,
+            batch_size,
+            n_parallel,
+            (
+                key,
+                host,
+                port,
+                priority,
+                timeout,
+                number,
+                repeat,
+                min_repeat_ms,
+                cooldown_interval,
+                enable_cpu_cache_flush,
+                max_repeat,
+                max_rel_ci,
+                cutoff,
+                verbose,
+            ),
+        )
     # This pool is not doing computationally intensive work, so we can use threads
     pool = multiprocessing.pool.ThreadPool(n_parallel)
     tuple_res = pool.map(
@@ -1276,6 +1582,9 @@ def rpc_runner_run(
                 min_repeat_ms,
                 cooldown_interval,
                 enable_cpu_cache_flush,
+                max_repeat,
+                max_rel_ci,
+                cutoff,
                 verbose,
             )
             for inp, build_res in zip(inputs, build_results)
@@ -1293,3 +1602,67 @@ def rpc_runner_run(
         print("")
 
     return results
+
+
+def _auto_batch_size(num_inputs, key, host, port, n_parallel):
+    """The batch size that spreads the inputs over the available devices of the key.
+
+    The devices are the servers of the key in the tracker, minus the requests already
+    waiting for them, and at most n_parallel.
+    """
+    try:
+        queue_info = rpc.connect_tracker(host, port).summary()["queue_info"].get(key, {})
+    # pylint: disable=broad-except
+    except Exception:
+        queue_info = {}
+    num_devices = queue_info.get("servers", queue_info.get("free", 1))
+    num_devices = max(1, min(n_parallel, num_devices - queue_info.get("pending", 0)))
+    return max(1, (num_inputs + num_devices - 1) // num_devices)
+
+
+def _rpc_runner_run_batch(inputs, build_results, batch_size, n_parallel, run_args):
+    """Run function of RPCRunner that measures batches of programs per remote session.
+    The programs with task inputs, which are not on the server, are measured one per session.
+    """
+    verbose = run_args[-1]
+    tuple_res = [None] * len(inputs)
+    batches = []
+    singles = []
+    for i, (inp, build_res) in enumerate(zip(inputs, build_results)):
+        if build_res.error_no != MeasureErrorNo.NO_ERROR:
+            tuple_res[i] = _rpc_run_worker((inp.serialize(), build_res) + run_args)
+        elif inp.task.task_input_names:
+            singles.append(i)
+        elif batches and len(batches[-1]) < batch_size:
+            batches[-1].append(i)
+        else:
+            batches.append([i])
+
+    # This pool is not doing computationally intensive work, so we can use threads
+    pool = multiprocessing.pool.ThreadPool(n_parallel)
+    batch_res = pool.map(
+        _rpc_run_batch_worker,
+        [
+            ([inputs[i].serialize() for i in batch], [build_results[i] for i in batch]) + run_args
+            for batch in batches
+        ],
+    )
+    single_res = pool.map(
+        _rpc_run_worker, [(inputs[i].serialize(), build_results[i]) + run_args for i in singles]
+    )
+    pool.terminate()
+    pool.join()
+    del pool
+
+    for batch, res in zip(batches, batch_res):
+        for i, r in zip(batch, res):
+            tuple_res[i] = r
+    for i, r in zip(singles, single_res):
+        tuple_res[i] = r
+
+    results = [MeasureResult(*res) for res in tuple_res]
+
+    if verbose >= 1:
+        print("")
+
+    return results
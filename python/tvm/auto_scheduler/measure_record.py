@@ -134,6 +134,115 @@ class RecordReader(Object):
             yield ret[0], ret[1]  # (input, result)
 
 
+@tvm._ffi.register_object("auto_scheduler.RecordDatabase")
+class RecordDatabase(Object):
+    """
+    An append-only binary store of measurement records, indexed by workload key and target.
+
+    The `top_k` best records of every workload key and target are indexed, so that they
+    are loaded without reading the other records. Several processes can append to the
+    same database.
+
+    Parameters
+    ----------
+    path : str
+        The path of the database file. It is created if it does not exist.
+    top_k : int
+        The number of best records indexed for every workload key and target.
+    """
+
+    def __init__(self, path, top_k=8):
+        dirname = os.path.dirname(os.path.abspath(path))
+        if not os.path.exists(dirname):
+            os.makedirs(dirname)
+        self.__init_handle_by_constructor__(_ffi_api.RecordDatabase, path, top_k)
+
+    def append(self, inputs, results):
+        """Append measurement records to the database.
+
+        Parameters
+        ----------
+        inputs: List[MeasureInputs]
+            The MeasureInputs to be written.
+        results: List[MeasureResults]
+            The MeasureResults to be written.
+        """
+        _ffi_api.RecordDatabaseAppend(self, inputs, results)
+
+    def get_top_k(self, workload_key, target, k=1):
+        """Get the best records of a workload on a target.
+
+        Parameters
+        ----------
+        workload_key : str
+            The workload key.
+        target : Union[tvm.target.Target, str]
+            The target.
+        k : int
+            The maximum number of records, at most `top_k`.
+
+        Returns
+        -------
+        records : List[Tuple[MeasureInput, MeasureResult]]
+            The records of the successful measurements, by increasing mean cost.
+        """
+        inputs, results = _ffi_api.RecordDatabaseGetTopK(self, workload_key, str(target), k)
+        return list(zip(inputs, results))
+
+    def best_records(self):
+        """Get the best record of every workload key and target.
+
+        Returns
+        -------
+        records : List[Tuple[MeasureInput, MeasureResult]]
+            The best records.
+        """
+        inputs, results = _ffi_api.RecordDatabaseGetBestRecords(self)
+        return list(zip(inputs, results))
+
+    def save_index(self):
+        """Save the index next to the database, so that opening it again is fast."""
+        _ffi_api.RecordDatabaseSaveIndex(self)
+
+    def compact(self, out_path):
+        """Write the indexed records to a new database, dropping the others.
+
+        Parameters
+        ----------
+        out_path : str
+            The path of the new database.
+        """
+        _ffi_api.RecordDatabaseCompact(self, out_path)
+
+    def import_records(self, filename):
+        """Append the records of a json log file.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the log file.
+        """
+        inputs, results = RecordReader(filename).read_lines()
+        self.append(inputs, results)
+
+
+@tvm._ffi.register_object("auto_scheduler.RecordToDatabase")
+class RecordToDatabase(MeasureCallback):
+    """
+    A measurement callback that appends measurement records to a :any:`RecordDatabase`.
+
+    Parameters
+    ----------
+    database : Union[RecordDatabase, str]
+        The database, or the path of the database.
+    """
+
+    def __init__(self, database):
+        if isinstance(database, str):
+            database = RecordDatabase(database)
+        self.__init_handle_by_constructor__(_ffi_api.RecordToDatabase, database)
+
+
 def load_record_from_string(record):
     """
     Load the measure record from string.
@@ -344,9 +453,12 @@ def distill_record_file(in_file, out_file):
 def main():
     """The main function for CLI."""
     parser = argparse.ArgumentParser()
-    parser.add_argument("--mode", choices=["distill"], default="distill")
+    parser.add_argument("--mode", choices=["distill", "import", "compact"], default="distill")
     parser.add_argument("-i", "--input", type=str, help="input file")
     parser.add_argument("-o", "--output", type=str, default=None, help="output file")
+    parser.add_argument(
+        "--top-k", type=int, default=8, help="the number of best records kept per workload"
+    )
 
     args = parser.parse_args()
     logging.basicConfig()
@@ -355,12 +467,24 @@ def main():
     if args.mode == "distill":
         args.output = args.output or args.input + ".best.json"
         distill_record_file(args.input, args.output)
+    elif args.mode == "import":
+        args.output = args.output or args.input + ".db"
+        database = RecordDatabase(args.output, args.top_k)
+        database.import_records(args.input)
+        database.save_index()
+    elif args.mode == "compact":
+        args.output = args.output or args.input + ".compact"
+        RecordDatabase(args.input, args.top_k).compact(args.output)
 
 
 """
 Usage:
 * Distill the best entries from a large log file
 e.g. python -m tvm.auto_scheduler.measure_record --mode distill -i input.json
+* Import a log file to a record database
+e.g. python -m tvm.auto_scheduler.measure_record --mode import -i input.json -o records.db
+* Keep the best records of a record database
+e.g. python -m tvm.auto_scheduler.measure_record --mode compact -i records.db --top-k 4
 """
 if __name__ == "__main__":
     main()
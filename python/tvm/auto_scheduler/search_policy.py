@@ -34,6 +34,7 @@ import random
 import tvm._ffi
 from tvm.runtime import Object
 from .cost_model import RandomModel
+from .loop_state import State
 from . import _ffi_api
 
 
@@ -61,6 +62,28 @@ class PreloadMeasuredStates(SearchCallback):
         self.__init_handle_by_constructor__(_ffi_api.PreloadMeasuredStates, filename)
 
 
+@tvm._ffi.register_object("auto_scheduler.PreloadSimilarStates")
+class PreloadSimilarStates(SearchCallback):
+    """A SearchCallback for SketchPolicy to warm start the search with the records of similar
+    workloads, i.e. the same compute function or compute DAG with different shapes.
+
+    The transform steps of the best records are replayed on the compute DAG of the task, with
+    the split lengths adapted to the new iterator extents. The adapted states are used as
+    starting points of the evolutionary search and to update the cost model. They are not
+    marked as measured, so they can still be measured for the task.
+
+    Parameters
+    ----------
+    filename : str
+        The name of the record file.
+    max_states : int = 64
+        The maximum number of states to load.
+    """
+
+    def __init__(self, filename, max_states=64):
+        self.__init_handle_by_constructor__(_ffi_api.PreloadSimilarStates, filename, max_states)
+
+
 @tvm._ffi.register_object("auto_scheduler.PreloadCustomSketchRule")
 class PreloadCustomSketchRule(SearchCallback):
     """
@@ -94,6 +117,71 @@ class PreloadCustomSketchRule(SearchCallback):
         )
 
 
+# The tags of the stages of topi.nn.sparse_dense with a BSR weight.
+SPARSE_DENSE_TAGS = ("sparse_dense_sp_rhs_bsrmm", "sparse_dense_sp_rhs_bsrmm_block")
+
+
+def _sparse_dense_meet_condition(search_policy, state, stage_id):
+    state = State(state, search_policy.search_task.compute_dag)
+    if state.stages[stage_id].op.tag in SPARSE_DENSE_TAGS:
+        return PreloadCustomSketchRule.APPLY_AND_SKIP_REST
+    return PreloadCustomSketchRule.PASS
+
+
+def _sparse_dense_apply(search_policy, state, stage_id):
+    s0 = State(state, search_policy.search_task.compute_dag)
+    if s0.stages[stage_id].op.tag == "sparse_dense_sp_rhs_bsrmm_block":
+        return [s0.state_object, stage_id - 1]
+
+    sparse_dense = s0.stages[stage_id].op
+    sparse_dense_block = s0.stages[stage_id - 1].op
+    consumer = sparse_dense
+    # Inline the output stage into a single elementwise consumer.
+    consumers = _ffi_api.SearchPolicyUtilsGetConsumers(
+        search_policy.search_task, s0.state_object, stage_id
+    )
+    if len(consumers) == 1:
+        consumer_id = int(consumers.items()[0][0])
+        if _ffi_api.SearchPolicyUtilsIsElementwiseMatch(
+            search_policy.search_task, s0.state_object, stage_id, consumer_id
+        ):
+            consumer = s0.stages[consumer_id].op
+            s0.compute_inline(sparse_dense)
+
+    # Tile the rows of the data and the block rows of the weight, the row offsets and the
+    # blocks stay innermost.
+    i, nb_j, j, row_offset, c = s0[sparse_dense_block].iters
+    m, n = s0[consumer].iters
+    i0, i1, i2 = s0.split(sparse_dense_block, i, [None, None])
+    m0, m1 = s0.follow_split(consumer, m, len(s0.transform_steps) - 1, 1)
+    j0, j1 = s0.split(sparse_dense_block, nb_j, [None])
+    n0, n1 = s0.follow_split(consumer, n, len(s0.transform_steps) - 1, 1)
+    s0.reorder(sparse_dense_block, [i0, j0, i1, j1, row_offset, i2, j, c])
+    s0.reorder(consumer, [m0, n0, m1, n1])
+    s0.compute_at(sparse_dense_block, consumer, n0)
+    return [[s0.state_object, stage_id - 2]]
+
+
+def sparse_dense_sketch_rule():
+    """The sketch rule of the sparse dense with a BSR weight on CPU.
+
+    The default rules cannot tile the indirect reduction of the sparse dense, the rule tiles
+    the data rows and the block rows of the weight and leaves the split lengths to the search.
+    The task scheduler adds it to the tasks with a sparse dense.
+
+    Returns
+    -------
+    rule : PreloadCustomSketchRule
+        The sketch rule.
+    """
+    return PreloadCustomSketchRule(_sparse_dense_meet_condition, _sparse_dense_apply, "SparseDense")
+
+
+def has_sparse_dense(task):
+    """Whether the compute DAG of a task has a sparse dense for sparse_dense_sketch_rule."""
+    return any(op.tag in SPARSE_DENSE_TAGS for op in task.compute_dag.ops)
+
+
 @tvm._ffi.register_object("auto_scheduler.SearchPolicy")
 class SearchPolicy(Object):
     """The base class of search policies."""
@@ -184,6 +272,7 @@ class SketchPolicy(SearchPolicy):
         "evolutionary_search_population": 2048,
         "evolutionary_search_num_iters": 4,
         "evolutionary_search_mutation_prob": 0.85,
+        "evolutionary_search_predict_batch_size": 512,
         "cpu_multi_level_tiling_structure": "SSRSRS",
         "gpu_multi_level_tiling_structure": "SSSRRSRS",
         # Notice: the default thread bind policy of GPU assumes the tiling structure to have at
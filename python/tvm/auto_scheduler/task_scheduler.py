@@ -24,14 +24,13 @@ Programs for Deep Learning." (OSDI 2020).
 """
 import os
 import time
-import math
 import logging
 
 import numpy as np
 
 from .search_policy import SearchPolicy, SketchPolicy, PreloadMeasuredStates
-from .cost_model import RandomModel, XGBModel
-from .utils import array_mean
+from .search_policy import sparse_dense_sketch_rule, has_sparse_dense
+from .cost_model import RandomModel, XGBModel, GBDTModel
 from .measure import ProgramMeasurer
 from .measure_record import RecordReader
 from . import _ffi_api
@@ -97,6 +96,12 @@ def make_search_policies(
             elif load_log_file:
                 logger.info("TaskScheduler: Reload measured states and train the model...")
                 cost_model.update_from_file(load_log_file)
+        elif model_type == "gbdt":
+            cost_model = GBDTModel(num_warmup_sample=len(tasks) * num_measures_per_round)
+            if load_log_file:
+                logger.info("TaskScheduler: Reload measured states and train the model...")
+                inputs, results = RecordReader(load_log_file).read_lines()
+                cost_model.update(inputs, results)
         elif model_type == "random":
             cost_model = RandomModel()
         else:
@@ -107,14 +112,20 @@ def make_search_policies(
                 # use the log file to restore the status of search policies.
                 init_search_callbacks = [PreloadMeasuredStates(load_log_file)]
             else:
-                init_search_callbacks = None
+                init_search_callbacks = []
+
+            def task_callbacks(task):
+                if task.target.kind.name == "llvm" and has_sparse_dense(task):
+                    return init_search_callbacks + [sparse_dense_sketch_rule()]
+                return init_search_callbacks or None
+
             search_policies = [
                 SketchPolicy(
                     task,
                     cost_model,
                     params=search_policy_params,
                     verbose=verbose,
-                    init_search_callbacks=init_search_callbacks,
+                    init_search_callbacks=task_callbacks(task),
                 )
                 for task in tasks
             ]
@@ -150,14 +161,7 @@ def derive_similarity_tag(dag, log_base=1.618):
     tag: str
         The tag of this computational DAG.
     """
-    ret = ""
-    for op in dag.ops:
-        tag = op.attrs.get("auto_scheduler_task_scheduler_tag", None)
-        if tag:
-            ret += op.attrs["auto_scheduler_task_scheduler_tag"] + "_"
-    if ret:
-        ret += "%d" % int(math.log(dag.flop_ct + 1, log_base))
-    return ret
+    return str(_ffi_api.DeriveSimilarityTag(dag, log_base))
 
 
 class TaskScheduler:
@@ -165,10 +169,14 @@ class TaskScheduler:
     Allocate the time resources when tuning multiple tasks together.
     This implements two strategies: "round-robin" and "gradient".
 
+    The allocation runs natively. The tasks of the same workload and target are tuned once, with
+    the sum of their weights: the tasks extracted from several models can be given together to
+    share the trials of their common workloads, and allocate the trials for the whole fleet.
+
     Parameters
     ----------
     tasks: List[SearchTask]
-        All tasks to tune
+        All tasks to tune, possibly from several models.
     task_weights: Optional[List[float]]
         The weights of tasks.
         If provided, the task scheduler will set the objective function to
@@ -176,6 +184,8 @@ class TaskScheduler:
         and the lantecy[t] is the lantecy of the task.
         If not provided, the task scheduer will assign equal weights to all
         tasks (i.e., the objective function is sum(latency[t])).
+        The weights of the tasks of the same workload are summed, e.g. the number of times it
+        is called in all the models, each times the weight of its model.
     objective_func: Optional[Callable[List[float] -> float]]
         The objective function to be minimized.
         The objective function accepts the current latencies of all tasks and returns the
@@ -202,6 +212,7 @@ class TaskScheduler:
     callbacks: Optional[List[TaskSchedulerCallback]]
         The task scheduler callbacks that will be called before and after tuning a task.
         If None, PrintTableInfo and LogEstimatedLatency callback will be used.
+        Without callbacks, the whole tuning loop runs natively.
     """
 
     def __init__(
@@ -218,14 +229,18 @@ class TaskScheduler:
         backward_window_size: int = 3,
         callbacks=None,
     ):
-        self.tasks = tasks
+        assert len(tasks) != 0, "No tasks"
+        assert strategy in ["round-robin", "gradient"]
+
+        weights = [_to_float(w) for w in task_weights] if task_weights else []
+        objective = None
         if objective_func:  # use custom objective function
-            self.objective_func = objective_func
-        else:  # use weighted sum
-            if task_weights:
-                self.objective_func = lambda costs: sum(c * w for c, w in zip(costs, task_weights))
-            else:
-                self.objective_func = sum
+            objective = lambda costs: float(objective_func([cost.value for cost in costs]))
+        self._scheduler = _ffi_api.TaskScheduler(
+            tasks, weights, objective, strategy, alpha, beta, backward_window_size
+        )
+        # the tasks of the same workload are merged
+        self.tasks = list(self._scheduler.tasks)
 
         self.strategy = strategy
         self.load_log_file = load_log_file
@@ -240,43 +255,74 @@ class TaskScheduler:
             else [PrintTableInfo(), LogEstimatedLatency("total_latency.tsv")]
         )
 
-        assert len(self.tasks) != 0, "No tasks"
-        assert self.strategy in ["round-robin", "gradient"]
-
-        # task_cts[i] saves how many times task i is tuned
-        self.task_cts = [0 for _ in range(len(self.tasks))]
-
-        # task_best_cts[i] saves the round task i found the best latency
-        self.task_best_cts = [0 for _ in range(len(self.tasks))]
+        self.tune_option = self.measurer = self.search_policies = None
+        self.tic = None
 
-        # task_costs_history[i] saves the latency history of task i
-        self.task_costs_history = [[] for _ in range(len(self.tasks))]
+    def task_index(self, task):
+        """Get the index of the task tuned for a task, the one of the same workload and target.
 
-        # best_costs[i] saves the best latency of task i
-        self.best_costs = 1e10 * np.ones(len(self.tasks))
-        self.cur_score = self._compute_score(self.best_costs)
+        Parameters
+        ----------
+        task: SearchTask
+            The task, e.g. of one of the models.
 
-        self.tune_option = self.measurer = self.search_policies = None
-        self.ct = self.best_ct = self.best_score = self.tic = None
-        self.num_measures_per_round = None
-        self.dead_tasks = set()
-
-        # Build similarity groups
-        self.task_tags = []  # task_id -> tag
-        self.tag_to_group_id = {}  # tag -> group_id
-        self.group_task_ids = []  # group_id -> all task ids in this group
-        self.flop_cts = []  # task_id -> the number of floating ops
-        for i, task in enumerate(self.tasks):
-            tag = derive_similarity_tag(task.compute_dag)
-            self.task_tags.append(tag)
-            self.flop_cts.append(task.compute_dag.flop_ct)
-            if not tag:
-                continue
-
-            if tag not in self.tag_to_group_id:
-                self.tag_to_group_id[tag] = len(self.tag_to_group_id)
-                self.group_task_ids.append([])
-            self.group_task_ids[self.tag_to_group_id[tag]].append(i)
+        Returns
+        -------
+        index: Optional[int]
+            The index in `tasks`, None if the task is not tuned.
+        """
+        index = _ffi_api.TaskSchedulerTaskIndex(self._scheduler, task)
+        return None if index < 0 else index
+
+    @property
+    def task_weights(self):
+        """The weight of each task, summed over the tasks of the same workload."""
+        return [w.value for w in _ffi_api.TaskSchedulerGetStatus(self._scheduler)[0]]
+
+    @property
+    def best_costs(self):
+        """The best latency of each task."""
+        costs = _ffi_api.TaskSchedulerGetStatus(self._scheduler)[1]
+        return np.array([cost.value for cost in costs])
+
+    @best_costs.setter
+    def best_costs(self, costs):
+        _ffi_api.TaskSchedulerSetBestCosts(self._scheduler, [float(cost) for cost in costs])
+
+    @property
+    def task_cts(self):
+        """The number of rounds each task is tuned."""
+        return [int(ct) for ct in _ffi_api.TaskSchedulerGetStatus(self._scheduler)[2]]
+
+    @property
+    def dead_tasks(self):
+        """The tasks not tuned further."""
+        return {int(idx) for idx in _ffi_api.TaskSchedulerGetStatus(self._scheduler)[3]}
+
+    @property
+    def num_measures_per_round(self):
+        """The number of programs measured in each round of a task."""
+        return self._scheduler.num_measures_per_round
+
+    @property
+    def ct(self):
+        """The number of trials measured."""
+        return self._scheduler.ct
+
+    @property
+    def best_ct(self):
+        """The number of trials when the best score was reached."""
+        return self._scheduler.best_ct
+
+    @property
+    def cur_score(self):
+        """The current value of the objective."""
+        return self._scheduler.cur_score
+
+    @property
+    def best_score(self):
+        """The best value of the objective."""
+        return self._scheduler.best_score
 
     def tune(
         self,
@@ -297,6 +343,7 @@ class TaskScheduler:
             If it is str,
             "default" for the default policy (SketchPolicy + XGBModel),
             "sketch.xgb" for SketchPolicy + XGBModel,
+            "sketch.gbdt" for SketchPolicy + GBDTModel,
             "sketch.random" for SketchPolicy + RandomModel.
         search_policy_params : Optional[Dict[str, Any]]
             The parameters of the search policy
@@ -308,139 +355,57 @@ class TaskScheduler:
         """
         # init members
         self.tune_option = tune_option
-        self.early_stopping_all = (
-            1e20 if tune_option.early_stopping < 0 else tune_option.early_stopping
-        )
-        self.early_stopping_task = (
-            1e20 if per_task_early_stopping is None else per_task_early_stopping
-        )
-
         self.measurer = ProgramMeasurer(
             tune_option.builder,
             tune_option.runner,
             tune_option.measure_callbacks,
             tune_option.verbose,
         )
-        self.ct = self.best_ct = 0
         self.tic = time.time()
 
         # reset num_measures_per_round to make sure every task is tuned at least once
-        self.num_measures_per_round = min(
+        num_measures_per_round = min(
             tune_option.num_measures_per_round, tune_option.num_measure_trials // len(self.tasks)
         )
-        if self.num_measures_per_round <= 0:
+        if num_measures_per_round <= 0:
             raise ValueError(
                 "num_measure_trials is too small. Please set it to a higher value."
                 f"It should be at least {len(self.tasks)} for this model."
             )
+        _ffi_api.TaskSchedulerPrepare(
+            self._scheduler,
+            tune_option.num_measure_trials,
+            num_measures_per_round,
+            tune_option.early_stopping,
+            -1 if per_task_early_stopping is None else per_task_early_stopping,
+            tune_option.verbose,
+        )
 
         # restore the status of the task scheduler from a log file
         if self.load_log_file:
-            self._restore_status(self.load_log_file, self.num_measures_per_round)
+            _ffi_api.TaskSchedulerRestoreStatus(self._scheduler, self.load_log_file)
 
         # make one search policy for one task
         self.search_policies = make_search_policies(
             search_policy,
             search_policy_params,
             self.tasks,
-            self.num_measures_per_round,
+            num_measures_per_round,
             tune_option.verbose,
             self.load_model_file,
             self.load_log_file,
             adapative_training,
         )
 
-        # do a round robin first to warm up
-        for idx in range(len(self.tasks)):
-            # skip warming up this task if it has been tuned before (restored from the log file)
-            if not self.task_cts[idx]:
-                self._tune_task(idx)
-        self.best_ct = self.ct
-        self.best_score = self.cur_score
-
-        # use the specific strategy to choose workload to tune
-        task_idx = -1
-        while self.ct < tune_option.num_measure_trials and len(self.dead_tasks) < len(self.tasks):
-            if self.strategy == "round-robin":
-                task_idx = (task_idx + 1) % len(self.tasks)
-                while task_idx in self.dead_tasks:
-                    task_idx = (task_idx + 1) % len(self.tasks)
-            elif self.strategy == "gradient":
-                gradients = []
-                for i in range(len(self.tasks)):
-                    if i in self.dead_tasks:
-                        gradients.append(0)
-                        continue
-
-                    # compute gradient from chain rule : (delta f / delta g_i)
-                    delta = 1e-4
-                    new_costs = list(self.best_costs)
-                    new_costs[i] -= delta
-                    chain_grad = (
-                        self._compute_score(self.best_costs) - self._compute_score(new_costs)
-                    ) / delta
-
-                    # compute (g_i(t_i) - g(t_i - \Delta t)) / (\Delta t)
-                    if (
-                        self.task_cts[i] - 1 < len(self.task_costs_history[i])
-                        and self.task_cts[i] - 1 - self.backward_window_size >= 0
-                    ):
-                        backward_grad = (
-                            self.task_costs_history[i][self.task_cts[i] - 1]
-                            - self.task_costs_history[i][
-                                self.task_cts[i] - 1 - self.backward_window_size
-                            ]
-                        ) / self.backward_window_size
-                    else:
-                        backward_grad = 0
-
-                    # compute (g_i(t_i + \Delta t) - g(t_i)) / (\Delta t)
-                    g_next_1 = self.best_costs[i] - (self.best_costs[i] / self.task_cts[i])
-
-                    g_next_2 = self.beta * 1e30
-                    group_id = self.tag_to_group_id.get(self.task_tags[i], None)
-                    if group_id is not None and len(self.group_task_ids[group_id]) > 1:
-                        best_flops = max(
-                            [
-                                self.flop_cts[j] / self.best_costs[j]
-                                for j in self.group_task_ids[group_id]
-                            ]
-                        )
-                        g_next_2 = self.beta * self.flop_cts[i] / best_flops
-
-                    g_next = min(g_next_1, g_next_2)
-                    forward_grad = g_next - self.best_costs[i]
-
-                    # combine all grads
-                    grad = chain_grad * (
-                        self.alpha * backward_grad + (1 - self.alpha) * forward_grad
-                    )
-                    assert grad <= 0
-                    gradients.append(grad)
-
-                if max(gradients) == min(gradients):
-                    task_idx = np.random.choice(len(gradients))
-                else:
-                    task_idx = np.argmin(gradients)
-            else:
-                raise ValueError("Invalid strategy: " + self.strategy)
+        if not self.callbacks:
+            _ffi_api.TaskSchedulerTune(self._scheduler, self.search_policies, self.measurer)
+            return
 
+        # warm up with a round robin, then use the specific strategy to choose workload to tune
+        task_idx = _ffi_api.TaskSchedulerNextTask(self._scheduler)
+        while task_idx >= 0:
             self._tune_task(task_idx)
-            self._adjust_similarity_group(task_idx)
-
-            if self.cur_score < self.best_score:
-                self.best_score = self.cur_score
-                self.best_ct = self.ct
-            elif self.ct - self.best_ct >= self.early_stopping_all and all(
-                cost < 1e9 for cost in self.best_costs
-            ):
-                if self.tune_option.verbose >= 1:
-                    print(
-                        "Stop early since no performance improvement in the last "
-                        + str(self.early_stopping_all)
-                        + " measurement trials."
-                    )
-                break
+            task_idx = _ffi_api.TaskSchedulerNextTask(self._scheduler)
 
     def _tune_task(self, task_idx):
         """Tune the select task for one round"""
@@ -452,91 +417,16 @@ class TaskScheduler:
         measure_inputs, measure_results = self.search_policies[task_idx].continue_search_one_round(
             self.num_measures_per_round, self.measurer
         )
-
-        self.task_cts[task_idx] += 1
-
-        for res in measure_results:
-            cost = array_mean(res.costs)
-            if cost < self.best_costs[task_idx]:
-                self.task_best_cts[task_idx] = self.task_cts[task_idx]
-                self.best_costs[task_idx] = cost
-
-        # Stop tuning this task in the rest of the process if its search space has been
-        # fully explored or it has no improvement for a long while.
-        no_change_trials = (
-            self.task_cts[task_idx] - self.task_best_cts[task_idx]
-        ) * self.num_measures_per_round
-        if len(measure_inputs) == 0 or no_change_trials > self.early_stopping_task:
-            self.dead_tasks.add(task_idx)
-
-        self.task_costs_history[task_idx].append(self.best_costs[task_idx])
-
-        self.ct += len(measure_inputs)
-        self.cur_score = self._compute_score(self.best_costs)
+        _ffi_api.TaskSchedulerUpdate(self._scheduler, task_idx, measure_inputs, measure_results)
 
         # Run post-tune callbacks
         for callback in self.callbacks:
             callback.post_tune(self, task_idx)
 
-    def _compute_score(self, costs):
-        """compute the objective function"""
-        return self.objective_func(costs)
-
-    def _adjust_similarity_group(self, task_idx):
-        """adjust the similarity group for the selected task"""
-        group_id = self.tag_to_group_id.get(self.task_tags[task_idx], None)
-        if group_id is None or len(self.group_task_ids[group_id]) <= 1:
-            return
 
-        group_ids = self.group_task_ids[group_id]
-        best_group_flops = max([self.flop_cts[j] / self.best_costs[j] for j in group_ids])
-        cur_flops = self.flop_cts[task_idx] / self.best_costs[task_idx]
-
-        # if we tune a task for many times but it still cannot achieve
-        # a similar speed to the fastest one in its group, this means this task
-        # is actually not similar to other tasks in its group.
-        # So we will remove it from its original group.
-        if cur_flops < best_group_flops / self.beta and self.task_cts[task_idx] > 5 + max(
-            self.task_cts[j] for j in group_ids if j != task_idx
-        ):
-            self.task_tags[task_idx] = None
-            group_ids.remove(task_idx)
-
-    def _restore_status(self, log_file, num_measures_per_round):
-        """restore task_cts and best_costs from a log file"""
-        str_target = str(self.tasks[0].target)
-        workload_key_to_task_id = {t.workload_key: i for i, t in enumerate(self.tasks)}
-        total_ct = -1
-
-        for total_ct, (inp, res) in enumerate(RecordReader(log_file)):
-            if str(inp.task.target) != str_target:
-                continue
-            task_idx = workload_key_to_task_id.get(inp.task.workload_key, None)
-            if task_idx is None:
-                continue
-
-            self.task_cts[task_idx] += 1
-
-            if res.error_no == 0:
-                cost = array_mean(res.costs)
-                if cost < self.best_costs[task_idx]:
-                    self.best_costs[task_idx] = cost
-                    self.task_best_cts[task_idx] = self.task_cts[task_idx]
-
-        for idx in range(len(self.tasks)):
-            if self.task_cts[idx] - self.task_best_cts[idx] > self.early_stopping_task:
-                self.dead_tasks.add(idx)
-
-            # The computation of taks_cts is just an estimation.
-            # The estimation may not be accurate if the log file is changed externally or
-            # `num_measures_per_round` is different from the last tuning.
-            self.task_cts[idx] = int(self.task_cts[idx] / num_measures_per_round + 0.5)
-            self.task_best_cts[idx] = int(self.task_best_cts[idx] / num_measures_per_round + 0.5)
-            self.task_costs_history[idx].append(self.best_costs[idx])
-
-        self.cur_score = self._compute_score(self.best_costs)
-
-        logger.info("TaskScheduler: Loaded %d measurement records from %s", total_ct + 1, log_file)
+def _to_float(value):
+    """Convert a weight, possibly an IntImm or a FloatImm, to a float."""
+    return float(value.value) if hasattr(value, "value") else float(value)
 
 
 class TaskSchedulerCallback:
@@ -579,26 +469,22 @@ class PrintTableInfo(TaskSchedulerCallback):
         print("-------------------------------------------------")
 
         # content
+        best_costs, task_cts = task_scheduler.best_costs, task_scheduler.task_cts
         for i in range(len(task_scheduler.tasks)):
             id_str = "%d" % i
-            latency_str = (
-                "%.3f" % (1e3 * task_scheduler.best_costs[i])
-                if task_scheduler.best_costs[i] < 1e9
-                else "-"
-            )
+            latency_str = "%.3f" % (1e3 * best_costs[i]) if best_costs[i] < 1e9 else "-"
             speed_str = (
-                "%.2f"
-                % (task_scheduler.tasks[i].compute_dag.flop_ct / task_scheduler.best_costs[i] / 1e9)
-                if task_scheduler.best_costs[i] < 1e9
+                "%.2f" % (task_scheduler.tasks[i].compute_dag.flop_ct / best_costs[i] / 1e9)
+                if best_costs[i] < 1e9
                 else "-"
             )
-            trials_str = "%d" % (task_scheduler.task_cts[i] * task_scheduler.num_measures_per_round)
+            trials_str = "%d" % (task_cts[i] * task_scheduler.num_measures_per_round)
             print("| %4s | %12s | % 14s | %6s |" % (id_str, latency_str, speed_str, trials_str))
         print("-------------------------------------------------")
 
         # overall info
-        if all(cost < 1e9 for cost in task_scheduler.best_costs):
-            total_latency_str = "%.3f" % (task_scheduler.cur_score.value * 1e3)
+        if all(cost < 1e9 for cost in best_costs):
+            total_latency_str = "%.3f" % (task_scheduler.cur_score * 1e3)
         else:
             total_latency_str = "-"
         print(
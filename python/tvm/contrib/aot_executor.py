@@ -0,0 +1,159 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Minimum graph executor that executes graph containing TVM PackedFunc."""
+"""Minimum AOT executor of the C++ runtime, running the models built with --executor=aot."""
+import tvm._ffi
+from tvm._ffi.base import string_types
+
+
+def create(executor_config, libmod, device):
+    """Create an AOT executor of a model
+
+    Parameters
+    ----------
+    executor_config : str
+        The configuration of the executor, given by the AOT codegen.
+
+    libmod : tvm.runtime.Module
+        The library with the run function of the model.
+
+    device : Device
+        The device to run the model on.
+
+    Returns
+    -------
+    aot_module : AotModule
+        The executor, its parameters need to be set before it is run.
+    """
+    assert isinstance(executor_config, string_types)
+    fcreate = tvm._ffi.get_global_func("tvm.aot_executor.create")
+    return AotModule(fcreate(executor_config, libmod, device))
+
+
+class AotModule(object):
+    """Wrapper of an AOT executor module.
+
+    A run is a single call of the run function of the model, the inputs, the
+    outputs, the parameters and the arena being allocated with the executor.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The executor module.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        lib = relay.build(mod, "llvm --executor=aot", params=params)
+        amod = aot_executor.AotModule(lib["default"](tvm.cpu()))
+        amod.set_input("x", data)
+        amod.run()
+        out = amod.get_output(0).numpy()
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._set_input = module["set_input"]
+        self._run = module["run"]
+        self._get_output = module["get_output"]
+        self._get_input = module["get_input"]
+        self._get_num_outputs = module["get_num_outputs"]
+        self._get_num_inputs = module["get_num_inputs"]
+        self._load_params = module["load_params"]
+
+    def set_input(self, key=None, value=None, **params):
+        """Set the inputs
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : the input value.
+           The input value
+
+        params : dict of str to NDArray
+           Additional arguments
+        """
+        if key is not None:
+            self._set_input(key, tvm.nd.array(value))
+        for k, v in params.items():
+            self._set_input(k, tvm.nd.array(v))
+
+    def run(self, **input_dict):
+        """Run the model
+
+        Parameters
+        ----------
+        input_dict: dict of str to NDArray
+            List of input values to be feed to
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self._run()
+
+    def get_num_outputs(self):
+        """Get the number of outputs"""
+        return self._get_num_outputs()
+
+    def get_num_inputs(self):
+        """Get the number of inputs"""
+        return self._get_num_inputs()
+
+    def get_input(self, index, out=None):
+        """Get the index-th input to out
+
+        Parameters
+        ----------
+        index : int or str
+            The input index or name
+
+        out : NDArray
+            The output array container
+        """
+        if out:
+            self._get_input(index).copyto(out)
+            return out
+        return self._get_input(index)
+
+    def get_output(self, index, out=None):
+        """Get the index-th output to out
+
+        Parameters
+        ----------
+        index : int
+            The output index
+
+        out : NDArray
+            The output array container
+        """
+        if out:
+            self._get_output(index, out)
+            return out
+        return self._get_output(index)
+
+    def load_params(self, params_bytes):
+        """Load the parameters from a blob of tvm.runtime.save_param_dict
+
+        Parameters
+        ----------
+        params_bytes : bytearray
+            The serialized parameter dict.
+        """
+        self._load_params(bytearray(params_bytes))
@@ -0,0 +1,103 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relay VM with CUDA Graph"""
+import json
+
+import tvm._ffi
+from tvm.runtime import vm
+
+
+class VirtualMachineCudaGraph(vm.VirtualMachine):
+    """Relay VM which launches its functions as CUDA graphs.
+
+    A function is captured into a CUDA graph the first time it is invoked with
+    a given signature of input shapes, and the graph is replayed by later
+    invocations with the same signature. Up to ``cache_size`` graphs are kept,
+    the least recently used ones are dropped beyond that.
+
+    Functions which cannot be captured, e.g. because they copy tensors back to
+    the host to compute shapes, or whose inputs are not on the GPU, are run
+    with kernel launches as by :py:class:`tvm.runtime.vm.VirtualMachine`.
+
+    Note
+    ----
+    The outputs returned by a replayed graph are overwritten by the next
+    invocation with the same input shapes. Copy them out to keep them.
+
+    Parameters
+    ----------
+    exe : Union[Executable, Module]
+        The executable.
+
+    device : Union[Device, List[Device]]
+        The devices to execute the VM code on, one of them a CUDA GPU.
+
+    memory_cfg : Optional[str]
+        The allocator behavior to use for the VM.
+
+    cache_size : int
+        The number of captured graphs to keep.
+    """
+
+    def __init__(self, exe, device, memory_cfg=None, cache_size=8):
+        vm.VirtualMachine.__init__(self, exe, device, memory_cfg)
+        self._invoke_cuda_graph = self.module["invoke_cuda_graph"]
+        self.module["set_cuda_graph_cache_size"](cache_size)
+
+    def _load_executable(self, exe):
+        fcreate = tvm._ffi.get_global_func("runtime._VirtualMachineCudaGraph", allow_missing=True)
+        if fcreate is None:
+            raise ValueError(
+                "To enable CUDA graph support (experimental), please set "
+                "'(USE_GRAPH_EXECUTOR_CUDA_GRAPH ON)' in config.cmake and rebuild TVM"
+            )
+        return fcreate(exe.mod)
+
+    def invoke(self, func_name, *args, **kwargs):
+        """Invoke a function, replaying its CUDA graph for known input shapes.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The arguments to the function.
+
+        kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
+            Named arguments to the function.
+
+        Returns
+        -------
+        result : Object
+            The output.
+        """
+        if args or kwargs:
+            self.set_input(func_name, *args, **kwargs)
+        return self._invoke_cuda_graph(func_name)
+
+    def stats(self):
+        """The counters of the CUDA graph cache.
+
+        Returns
+        -------
+        stats : dict of str to int
+            ``hits`` graph launches, ``captures`` graphs captured, ``fallbacks``
+            invocations run with kernel launches, ``evictions`` graphs dropped,
+            ``size`` and ``capacity`` of the cache.
+        """
+        return json.loads(self.module["get_cuda_graph_stats"]())
@@ -268,12 +268,20 @@ class GraphModuleDebug(graph_executor.GraphModule):
         ret = self._run_individual(number, repeat, min_repeat_ms)
         return ret.strip(",").split(",") if ret else []
 
-    def profile(self, **input_dict):
+    def profile(self, collectors=None, timeline=False, **input_dict):
         """Run forward execution of the graph and collect overall and per-op
         performance metrics.
 
         Parameters
         ----------
+        collectors : Optional[Sequence[MetricCollector]]
+            Extra metrics to collect, e.g. hardware counters with
+            :py:class:`tvm.runtime.profiling.PerfEventCollector`.
+
+        timeline : bool
+            Whether to record the timeline of the ops and of the parallel tasks
+            of the thread pool, see :py:meth:`Report.chrome_trace`.
+
         input_dict : dict of str to NDArray
             List of input values to be feed to
         Return
@@ -284,7 +292,7 @@ class GraphModuleDebug(graph_executor.GraphModule):
         if input_dict:
             self.set_input(**input_dict)
 
-        return self._profile()
+        return self._profile(collectors or [], timeline)
 
     def exit(self):
         """Exits the dump folder and all its contents"""
@@ -21,7 +21,7 @@ from tvm._ffi.base import py_str
 from tvm._ffi.libinfo import find_lib_path
 
 
-def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
+def create_tvmjs_wasm(output, objects, options=None, cc="emcc", simd=False, threads=False):
     """Create wasm that is supposed to run with the tvmjs.
 
     Parameters
@@ -37,6 +37,16 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
 
     cc : str, optional
         The compile string.
+
+    simd : bool, optional
+        Whether to enable the simd128 instructions, for the objects compiled with the
+        "webassembly/simd128" target.
+
+    threads : bool, optional
+        Whether to link a multi-threaded module, whose thread pool runs on Web Workers.
+        The runtime bitcode must be built with ``make WASM_THREADS=1`` and the objects
+        compiled with the "webassembly/simd128-threads" target. The module is loaded
+        with the emscripten loader instead of as a standalone (WASI) module.
     """
     cmd = [cc]
     cmd += ["-O3"]
@@ -44,8 +54,15 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc"):
     cmd += ["-std=c++14"]
     cmd += ["--no-entry"]
     cmd += ["-s", "ERROR_ON_UNDEFINED_SYMBOLS=0"]
-    cmd += ["-s", "STANDALONE_WASM=1"]
     cmd += ["-s", "ALLOW_MEMORY_GROWTH=1"]
+    if simd:
+        cmd += ["-msimd128"]
+    if threads:
+        cmd += ["-pthread"]
+        cmd += ["-s", "USE_PTHREADS=1"]
+        cmd += ["-s", "PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"]
+    else:
+        cmd += ["-s", "STANDALONE_WASM=1"]
 
     objects = [objects] if isinstance(objects, str) else objects
 
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Minimum graph executor that executes graph containing TVM PackedFunc."""
+import json
+
 import numpy as np
 import tvm._ffi
 
@@ -22,6 +24,8 @@ from tvm.rpc import _ffi_api as _rpc_ffi_api
 from tvm.rpc import base as rpc_base
 from tvm._ffi.base import string_types
 from tvm._ffi.runtime_ctypes import Device
+from tvm.runtime.object import Object
+from tvm.runtime.async_runner import AsyncRunner
 
 
 def create(graph_json_str, libmod, device):
@@ -111,6 +115,55 @@ def get_device(libmod, device):
     return device, num_rpc_dev, device_type_id
 
 
+def create_pool(lib, num_executors, device):
+    """Create executors of a built module that can run concurrently.
+
+    The executors share the params and the code of lib, each of them only owns
+    the storage of its activations. Different executors can be run from different
+    threads at the same time, a single executor cannot.
+
+    Parameters
+    ----------
+    lib : tvm.runtime.Module
+        The module built by relay.build.
+
+    num_executors : int
+        The number of executors.
+
+    device : Device or list of Device
+        The device to deploy the module.
+
+    Returns
+    -------
+    executors : List[GraphModule]
+        The executors.
+    """
+    if not isinstance(device, (list, tuple)):
+        device = [device]
+    return [GraphModule(m) for m in lib["create_pool"](num_executors, *device)]
+
+
+@tvm._ffi.register_object("runtime.ActivationArena")
+class ActivationArena(Object):
+    """The activation storage shared by executors run one at a time, e.g. the
+    models of a pipeline.
+
+    The arena holds one buffer per device, sized to the largest activation plan
+    of the executors joined by :py:func:`GraphModule.set_activation_arena`. The
+    executor running owns the arena, and overwrites the intermediate results of
+    the previous owner. The inputs, outputs and parameters of the executors are
+    never placed in the arena.
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(tvm._ffi.get_global_func("runtime.ActivationArena"))
+
+    @property
+    def reserved_bytes(self):
+        """The number of bytes the arena allocates over all the devices."""
+        return tvm._ffi.get_global_func("runtime.ActivationArenaReservedBytes")(self)
+
+
 class GraphModule(object):
     """Wrapper runtime module.
 
@@ -155,11 +208,13 @@ class GraphModule(object):
         self._set_input = module["set_input"]
         self._run = module["run"]
         self._get_output = module["get_output"]
+        self._double_buffered_inputs = False
         self._get_input = module["get_input"]
         self._get_num_outputs = module["get_num_outputs"]
         self._get_num_inputs = module["get_num_inputs"]
         self._load_params = module["load_params"]
         self._share_params = module["share_params"]
+        self._async_runner = None
 
     def set_input(self, key=None, value=None, **params):
         """Set inputs to the module via kwargs
@@ -175,6 +230,15 @@ class GraphModule(object):
         params : dict of str to NDArray
            Additional arguments
         """
+        if self._double_buffered_inputs:
+            # The copy goes to the spare buffers, not to the arrays get_input returns.
+            if key is not None:
+                self.set_input_async(key, value)
+            for k, v in params.items():
+                if self._get_input(k):
+                    self.set_input_async(k, v)
+            return
+
         if key is not None:
             v = self._get_input(key)
             if v is None:
@@ -205,6 +269,273 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def set_async_depth(self, max_in_flight):
+        """Set the maximum number of requests of :py:func:`run_async` not completed
+
+        Parameters
+        ----------
+        max_in_flight : int
+            The maximum number of requests submitted and not completed, 4 by default.
+        """
+        if self._async_runner is not None:
+            self._async_runner.wait_all()
+        self._async_runner = AsyncRunner(self.module["run_request"], max_in_flight)
+
+    def run_async(self, callback=None, block=True, **input_dict):
+        """Run the graph on a worker thread
+
+        The requests run one at a time in their submission order, with their own
+        inputs, and their outputs are copies, so the caller prepares the next
+        request while one runs. They must not be mixed with the synchronous
+        calls on this module before :py:func:`wait_async` returns.
+
+        Parameters
+        ----------
+        callback : Optional[Callable]
+            Called on the completion thread with the list of outputs, its return
+            value is the result of the future.
+
+        block : bool
+            Whether to wait while the maximum number of requests are not completed.
+
+        input_dict: dict of str to NDArray or np.ndarray
+            The inputs of the request.
+
+        Returns
+        -------
+        future : Optional[concurrent.futures.Future]
+            The future of the outputs, None when not blocking and the queue is full.
+        """
+        if self._async_runner is None:
+            self.set_async_depth(4)
+        inputs = {
+            k: v if isinstance(v, tvm.runtime.NDArray) else tvm.nd.array(v)
+            for k, v in input_dict.items()
+        }
+        return self._async_runner.submit(inputs, callback=callback, block=block)
+
+    def wait_async(self):
+        """Wait for the completion of the requests of :py:func:`run_async`"""
+        if self._async_runner is not None:
+            self._async_runner.wait_all()
+
+    def set_thread_pool(self, name):
+        """Run the operators of this module on a named thread pool
+
+        Parameters
+        ----------
+        name : str
+            The name of a pool created by :py:func:`tvm.runtime.thread_pool.create_thread_pool`,
+            or an empty string for the default pool of the calling thread.
+        """
+        self.module["set_thread_pool"](name)
+
+    def set_inter_op_parallelism(self, level):
+        """Let independent operators of the graph run concurrently
+
+        Parameters
+        ----------
+        level : int
+            The maximum number of operators running at the same time. With a level
+            greater than one, run dispatches the operators in dataflow order on the
+            thread pool; 1 restores sequential execution.
+        """
+        self.module["set_inter_op_parallelism"](level)
+
+    def set_input_async(self, key, value, stream=None):
+        """Queue the copy of an input on a stream without waiting for it
+
+        Copies from host memory to a CUDA GPU are staged through page-locked
+        buffers, so they do not wait for the work already queued on the stream.
+
+        Parameters
+        ----------
+        key : int or str
+           The input key
+
+        value : NDArray or numpy.ndarray
+           The input value
+
+        stream : Optional[ctypes.c_void_p]
+           The stream to copy on, as created by :py:func:`Device.create_raw_stream`,
+           None for the default stream. Must be None with double-buffered inputs.
+        """
+        if not isinstance(value, tvm.runtime.NDArray):
+            value = tvm.nd.array(value)
+        self.module["set_input_async"](key, value, stream)
+
+    def set_double_buffered_inputs(self, enable=True):
+        """Upload the inputs of the next run while the current one executes
+
+        When enabled, set_input copies to a spare set of input buffers on a
+        dedicated stream and returns without waiting. Run swaps the spare buffers
+        in once the uploads are done. get_input returns the inputs of the last run.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to double-buffer the inputs.
+        """
+        self.module["set_double_buffered_inputs"](enable)
+        self._double_buffered_inputs = enable
+
+    def link_output(self, index, key):
+        """Copy an output into an input at the end of each run
+
+        This carries the states of a stateful model, e.g. one rewritten by
+        :py:func:`tvm.relay.transform.ToStreaming`, from one run to the next.
+        The input keeps the value given with set_input until the first run.
+
+        Parameters
+        ----------
+        index : int
+            The output index.
+
+        key : int or str or None
+            The input index or name, None to remove the link of the output.
+        """
+        self.module["link_output"](index, -1 if key is None else key)
+
+    def resolve_inputs(self, names):
+        """Look up the indices of inputs once, to bind them by index on each request
+
+        Parameters
+        ----------
+        names : list of str
+            The input names.
+
+        Returns
+        -------
+        handles : tvm.runtime.ShapeTuple
+            The input indices, to pass to bind_inputs.
+        """
+        return self.module["resolve_inputs"](*names)
+
+    def bind_inputs(self, handles, values, zero_copy=False):
+        """Set a batch of inputs in one call
+
+        Parameters
+        ----------
+        handles : tvm.runtime.ShapeTuple or list of int
+            The input indices, e.g. returned by resolve_inputs.
+
+        values : list of tvm.nd.NDArray
+            The input values, one per index.
+
+        zero_copy : bool
+            Whether the graph refers to the values instead of copying them,
+            as with set_input_zero_copy. The values must then outlive the runs.
+        """
+        func = self.module["bind_inputs_zero_copy" if zero_copy else "bind_inputs"]
+        func(tvm.runtime.ShapeTuple(handles), *values)
+
+    def set_output_zero_copy(self, index, value):
+        """Have each run write an output into the given array
+
+        The graph writes the output into the array instead of its own storage,
+        which saves copying it out with get_output(index, out). get_output then
+        returns the array. The outputs that are inputs or parameters of the
+        graph, or linked with link_output, cannot be bound.
+
+        Parameters
+        ----------
+        index : int
+            The output index.
+
+        value : tvm.nd.NDArray or None
+            The array, of the shape, type, device and alignment of the output,
+            or None to write the output to the storage of the graph again.
+        """
+        self.module["set_output_zero_copy"](index, value)
+
+    def bind_outputs(self, indices, values):
+        """Bind a batch of outputs with set_output_zero_copy in one call
+
+        Parameters
+        ----------
+        indices : list of int
+            The output indices.
+
+        values : list of tvm.nd.NDArray
+            The arrays to write the outputs to, one per index.
+        """
+        self.module["bind_outputs_zero_copy"](tvm.runtime.ShapeTuple(indices), *values)
+
+    def set_num_streams(self, num_streams):
+        """Launch independent branches of the graph on separate device streams
+
+        Parameters
+        ----------
+        num_streams : int
+            The number of streams the operators are spread over. The branches
+            synchronize with events where they join, and the outputs are ready
+            on the default stream when run returns. 1 launches everything on
+            the current stream.
+        """
+        self.module["set_num_streams"](num_streams)
+
+    def set_sampling_interval(self, interval):
+        """Time the operators of one run out of interval
+
+        The latencies are accumulated in per-operator histograms which can be
+        read at any time with :py:func:`get_sampling_stats`. The other runs
+        only count the invocation, so this can be left on in deployment.
+
+        Parameters
+        ----------
+        interval : int
+            Sample one run every interval, 0 disables sampling. Resets the
+            histograms.
+        """
+        self.module["set_sampling_interval"](interval)
+
+    def get_sampling_stats(self):
+        """Get the latencies of the sampled runs
+
+        Returns
+        -------
+        stats : dict
+            The number of runs under "invocations", the latency of the sampled
+            runs under "total" and the latency of each operator under "ops".
+            Each latency has a "count" of samples and the "mean_us", "p50_us"
+            and "p99_us" statistics in microseconds.
+        """
+        return json.loads(self.module["get_sampling_stats"]())
+
+    def set_result_cache(self, max_bytes, outputs, inputs):
+        """Memoize the outputs of subgraphs for repeated inputs
+
+        The subgraph of an output node is made of the operators it depends on
+        which only feed the subgraph. When the key inputs the node depends on
+        hold data seen before, the subgraph is skipped and the outputs of the
+        node are copied from the cache. The other inputs, e.g. the parameters,
+        are assumed not to change. The entries are evicted in LRU order.
+
+        Parameters
+        ----------
+        max_bytes : int
+            The size of the cache in bytes, the inputs included. 0 disables
+            the cache. Clears the cache and its statistics.
+
+        outputs : list of str
+            The names of the graph nodes whose outputs are cached.
+
+        inputs : list of str
+            The names of the inputs the outputs are keyed by.
+        """
+        self.module["set_result_cache"](max_bytes, outputs, inputs)
+
+    def get_result_cache_stats(self):
+        """Get the statistics of the result cache
+
+        Returns
+        -------
+        stats : dict
+            The "hits", "misses", "evictions" and "hit_rate" of the lookups, and
+            the "entries" and "bytes" held out of "max_bytes".
+        """
+        return json.loads(self.module["get_result_cache_stats"]())
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -259,6 +590,27 @@ class GraphModule(object):
 
         return self._get_output(index)
 
+    def get_output_async(self, index, out, stream=None):
+        """Queue the copy of the index-th output to out on a stream
+
+        The copy only overlaps other work when out is in page-locked host memory,
+        i.e. allocated on the ``cuda_host`` device, ``Device(3, 0)``. Synchronize
+        the stream before reading out.
+
+        Parameters
+        ----------
+        index : int
+            The output index
+
+        out : NDArray
+            The output array container
+
+        stream : Optional[ctypes.c_void_p]
+            The stream to copy on, None for the default stream.
+        """
+        self.module["get_output_async"](index, out, stream)
+        return out
+
     def debug_get_output(self, node, out):
         """Run graph up to node and get the output to out
 
@@ -272,15 +624,42 @@ class GraphModule(object):
         """
         raise NotImplementedError("Please use debugger.debug_executor as graph_executor instead.")
 
-    def load_params(self, params_bytes):
+    def load_params(self, params_bytes, share=False):
         """Load parameters from serialized byte array of parameter dict.
 
         Parameters
         ----------
         params_bytes : bytearray
             The serialized parameter dict.
+
+        share : bool
+            Intern the parameters in the process-wide constant store: the
+            parameters identical to the ones another executor of the process
+            loaded with ``share=True`` on the same device share their memory.
+            The shared parameters must not be written to.
+        """
+        if share:
+            self.module["load_shared_params"](bytearray(params_bytes))
+        else:
+            self._load_params(bytearray(params_bytes))
+
+    def load_mapped_params(self, path, share=False):
+        """Load parameters from a file written by :py:func:`tvm.runtime.save_mapped_param_dict`.
+
+        The CPU parameters point into the memory mapped file instead of being
+        copied, so that executors of the same model share the memory of their
+        parameters through the page cache, even across processes.
+
+        Parameters
+        ----------
+        path : str
+            The parameter file.
+
+        share : bool
+            Intern the parameters in the process-wide constant store, see
+            :py:func:`load_params`.
         """
-        self._load_params(bytearray(params_bytes))
+        self.module["load_mapped_params"](path, share)
 
     def share_params(self, other, params_bytes):
         """Share parameters from pre-existing GraphExecutor instance.
@@ -295,6 +674,37 @@ class GraphModule(object):
         """
         self._share_params(other.module, bytearray(params_bytes))
 
+    def set_activation_arena(self, arena):
+        """Draw the activations from an arena shared with other executors.
+
+        The planned storage of this executor holding neither an input, an output
+        nor a parameter is released after its first run. Join all the executors
+        before running any of them, so that the arena is allocated once.
+
+        Parameters
+        ----------
+        arena : ActivationArena
+            The arena.
+        """
+        self.module["set_activation_arena"](arena)
+
+    def acquire_activation_arena(self):
+        """Take the ownership of the activation arena ahead of a run, which
+        invalidates the intermediate results of the previous owner. Run acquires
+        the arena implicitly."""
+        self.module["acquire_activation_arena"]()
+
+    def owns_activation_arena(self):
+        """Whether the arena holds the activations of this executor, i.e. no other
+        executor of the arena ran since its last run.
+
+        Returns
+        -------
+        owned : bool
+            False as well when the executor has no arena.
+        """
+        return bool(self.module["owns_activation_arena"]())
+
     def __getitem__(self, key):
         """Get internal module function
 
@@ -224,10 +224,12 @@ def ir_lower_vtcm():
 
     def get_alloc(stmt, align):
         assert isinstance(stmt, tvm.tir.Allocate)
+        dtype = tvm.runtime.DataType(stmt.dtype)
+        elem_bytes = (dtype.bits * dtype.lanes + 7) // 8
         return tvm.tir.call_extern(
             "handle",
             "HexagonBackendAllocateVTCM",
-            ft.reduce(lambda x, y: x * y, stmt.extents, 1),
+            ft.reduce(lambda x, y: x * y, stmt.extents, elem_bytes),
             align,
         )
 
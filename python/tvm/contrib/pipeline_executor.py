@@ -0,0 +1,417 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Pipeline executor that runs the stages of a split model on their own devices and threads.
+
+The model is split into a chain of stages, each built into a graph executor. The
+stages are connected by bounded queues, so that consecutive requests overlap:
+a stage runs a request while the next stage runs the previous one.
+
+.. code-block:: python
+
+    stages = pipeline_executor.split(mod)
+    pmod = pipeline_executor.build(stages, ["llvm", "cuda"], [tvm.cpu(), tvm.cuda()], params)
+    for x in requests:
+        pmod.set_input("x", x)
+        pmod.run()
+    outputs = [pmod.get_output() for _ in requests]
+    print(pmod.get_stats())
+"""
+import json
+
+import tvm._ffi
+from tvm import relay
+from tvm.relay.expr_functor import ExprMutator, ExprVisitor
+from . import graph_executor
+
+
+def pipeline_executor_enabled():
+    """Whether the pipeline executor is built into the runtime."""
+    return tvm._ffi.get_global_func("tvm.pipeline_executor.create", allow_missing=True) is not None
+
+
+def _backend_of(mod, call):
+    """The stage key of a call: the external compiler of the callee, or None for the host."""
+    if isinstance(call.op, tvm.ir.GlobalVar):
+        func = mod[call.op]
+        if func.attrs and "Compiler" in func.attrs:
+            return str(func.attrs["Compiler"])
+    return None
+
+
+class _StageAssigner(ExprVisitor):
+    """Assign the nodes of main to stages, in post order.
+
+    A new stage starts whenever the key of a call differs from the key of the previous call.
+    """
+
+    def __init__(self, key_fn):
+        super().__init__()
+        self.key_fn = key_fn
+        self.keys = []
+        self.stage_of = {}
+
+    def _current_stage(self):
+        if not self.keys:
+            self.keys.append(None)
+        return len(self.keys) - 1
+
+    def visit_function(self, fn):
+        # The functions called by main, e.g. the composites, stay whole in their stage.
+        pass
+
+    def visit_let(self, let):
+        raise ValueError("The pipeline executor only splits dataflow graphs, got a let")
+
+    def visit_if(self, ite):
+        raise ValueError("The pipeline executor only splits dataflow graphs, got an if")
+
+    def visit_call(self, call):
+        super().visit_call(call)
+        key = self.key_fn(call)
+        if not self.keys or self.keys[-1] != key:
+            self.keys.append(key)
+        self.stage_of[call] = len(self.keys) - 1
+
+    def visit_tuple(self, tup):
+        super().visit_tuple(tup)
+        self.stage_of[tup] = self._current_stage()
+
+    def visit_tuple_getitem(self, op):
+        super().visit_tuple_getitem(op)
+        # Project the tuples in the stage producing them, tuples are not passed between stages.
+        tup = op.tuple_value
+        self.stage_of[op] = self.stage_of[tup] if tup in self.stage_of else self._current_stage()
+
+
+class _StageExtractor(ExprMutator):
+    """Rebuild the nodes of a stage, reading the values of the other stages from new vars."""
+
+    def __init__(self, inputs):
+        super().__init__()
+        self.memo_map.update(inputs)
+
+    def visit_function(self, fn):
+        return fn
+
+
+def _operands(expr):
+    if isinstance(expr, relay.Call):
+        return list(expr.args)
+    if isinstance(expr, relay.Tuple):
+        return list(expr.fields)
+    if isinstance(expr, relay.TupleGetItem):
+        return [expr.tuple_value]
+    return []
+
+
+class PipelineStages:
+    """The stages of a split model and the values they pass to each other.
+
+    Attributes
+    ----------
+    mods : list of tvm.IRModule
+        The module of each stage.
+
+    input_names : list of str
+        The names of the inputs of the model, the value id of the i-th input is i.
+
+    stage_inputs : list of list of (str, int)
+        The name and the value id of the inputs of each stage.
+
+    stage_outputs : list of list of int
+        The value id of the outputs of each stage.
+
+    outputs : list of int
+        The value ids of the outputs of the model.
+
+    num_values : int
+        The number of values of a request.
+    """
+
+    def __init__(self, mods, input_names, stage_inputs, stage_outputs, outputs, num_values):
+        self.mods = mods
+        self.input_names = input_names
+        self.stage_inputs = stage_inputs
+        self.stage_outputs = stage_outputs
+        self.outputs = outputs
+        self.num_values = num_values
+
+    def config(self, params=None):
+        """The JSON configuration of the pipeline executor.
+
+        Parameters
+        ----------
+        params : Optional[dict of str to NDArray]
+            The parameters bound into the stages, which are not inputs of the pipeline.
+        """
+        params = params or {}
+        inputs = [(n, i) for i, n in enumerate(self.input_names) if n not in params]
+        stages = []
+        for inps, outs in zip(self.stage_inputs, self.stage_outputs):
+            inps = [(n, v) for n, v in inps if n not in params]
+            stages.append(
+                {
+                    "input_names": [n for n, _ in inps],
+                    "input_values": [v for _, v in inps],
+                    "output_values": outs,
+                }
+            )
+        return json.dumps(
+            {
+                "input_names": [n for n, _ in inputs],
+                "input_values": [v for _, v in inputs],
+                "output_values": self.outputs,
+                "num_values": self.num_values,
+                "stages": stages,
+            }
+        )
+
+
+def split(mod, key_fn=None):
+    """Split main into a chain of stages.
+
+    The calls of main are visited in post order and a new stage starts whenever the key of
+    a call differs from the key of the previous one. By default the key is the external
+    compiler of the callee, so that each run of subgraphs offloaded by PartitionGraph to
+    the same backend, and each run of host ops in between, makes a stage.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module to split, main must be a dataflow graph.
+
+    key_fn : Optional[Callable[[relay.Call], object]]
+        The stage key of a call.
+
+    Returns
+    -------
+    stages : PipelineStages
+        The stages of the pipeline.
+    """
+    mod = relay.transform.InferType()(mod)
+    main = mod["main"]
+    assigner = _StageAssigner(key_fn or (lambda call: _backend_of(mod, call)))
+    assigner.visit(main.body)
+    stage_of = assigner.stage_of
+    num_stages = max(len(assigner.keys), 1)
+
+    outputs = list(main.body.fields) if isinstance(main.body, relay.Tuple) else [main.body]
+    if isinstance(main.body, relay.Tuple):
+        del stage_of[main.body]
+    for out in outputs:
+        if out not in stage_of:
+            raise ValueError("The outputs of the pipeline must be computed by a stage")
+
+    value_ids = {param: i for i, param in enumerate(main.params)}
+    stage_nodes = [[] for _ in range(num_stages)]
+    # The nodes in post order, the values are read by the later stages only.
+    for node, stage in stage_of.items():
+        stage_nodes[stage].append(node)
+
+    stage_inputs = [[] for _ in range(num_stages)]
+    stage_outputs = [[] for _ in range(num_stages)]
+    read_later = set(outputs)
+    for stage in range(num_stages):
+        for node in stage_nodes[stage]:
+            for arg in _operands(node):
+                if isinstance(arg, relay.Var) or (arg in stage_of and stage_of[arg] < stage):
+                    read_later.add(arg)
+                    if arg not in stage_inputs[stage]:
+                        stage_inputs[stage].append(arg)
+    for stage in range(num_stages):
+        for node in stage_nodes[stage]:
+            if node in read_later:
+                if isinstance(node.checked_type, relay.TupleType):
+                    raise ValueError("The pipeline executor cannot pass tuples between stages")
+                value_ids[node] = len(value_ids)
+                stage_outputs[stage].append(node)
+
+    mods = []
+    for stage in range(num_stages):
+        inputs = {}
+        for arg in stage_inputs[stage]:
+            name = arg.name_hint if isinstance(arg, relay.Var) else "value_%d" % value_ids[arg]
+            inputs[arg] = relay.var(name, type_annotation=arg.checked_type)
+        if not stage_outputs[stage]:
+            raise ValueError("The stage %d computes nothing read by the later stages" % stage)
+        extractor = _StageExtractor(inputs)
+        fields = [extractor.visit(out) for out in stage_outputs[stage]]
+        body = fields[0] if len(fields) == 1 else relay.Tuple(fields)
+        stage_mod = tvm.IRModule.from_expr(relay.Function(list(inputs.values()), body))
+        for gvar in mod.get_global_vars():
+            if gvar.name_hint != "main":
+                stage_mod[gvar] = mod[gvar]
+        mods.append(stage_mod)
+
+    return PipelineStages(
+        mods,
+        [param.name_hint for param in main.params],
+        [
+            [(var.name_hint, value_ids[arg]) for arg, var in zip(args, stage_mod["main"].params)]
+            for args, stage_mod in zip(stage_inputs, mods)
+        ],
+        [[value_ids[node] for node in nodes] for nodes in stage_outputs],
+        [value_ids[out] for out in outputs],
+        len(value_ids),
+    )
+
+
+def build(stages, targets, devices, params=None, thread_pools=None, queue_capacity=2):
+    """Build the stages and create a pipeline executor.
+
+    Parameters
+    ----------
+    stages : PipelineStages
+        The stages returned by :py:func:`split`.
+
+    targets : list of (str or tvm.target.Target)
+        The target of each stage.
+
+    devices : list of tvm.runtime.Device
+        The device of each stage.
+
+    params : Optional[dict of str to NDArray]
+        The parameters of the model, bound into the stages reading them.
+
+    thread_pools : Optional[list of Optional[str]]
+        The thread pool of each stage, created with
+        :py:func:`tvm.runtime.thread_pool.create_thread_pool`, to run the CPU stages on
+        separate cores.
+
+    queue_capacity : int
+        The number of requests waiting in front of each stage.
+
+    Returns
+    -------
+    module : PipelineModule
+        The pipeline executor.
+    """
+    params = params or {}
+    num_stages = len(stages.mods)
+    if len(targets) != num_stages or len(devices) != num_stages:
+        raise ValueError("Expected a target and a device for each of the %d stages" % num_stages)
+    executors = []
+    for i, stage_mod in enumerate(stages.mods):
+        names = [param.name_hint for param in stage_mod["main"].params]
+        stage_params = {name: params[name] for name in names if name in params}
+        lib = relay.build(stage_mod, targets[i], params=stage_params)
+        executor = graph_executor.GraphModule(lib["default"](devices[i]))
+        if thread_pools and thread_pools[i]:
+            executor.set_thread_pool(thread_pools[i])
+        executors.append(executor.module)
+    return create(stages.config(params), executors, queue_capacity)
+
+
+def create(config, executors, queue_capacity=2):
+    """Create a pipeline executor from the executors of the stages.
+
+    Parameters
+    ----------
+    config : str
+        The JSON configuration of the stages, see :py:meth:`PipelineStages.config`.
+
+    executors : list of tvm.runtime.Module
+        The graph executor of each stage.
+
+    queue_capacity : int
+        The number of requests waiting in front of each stage.
+
+    Returns
+    -------
+    module : PipelineModule
+        The pipeline executor.
+    """
+    fcreate = tvm._ffi.get_global_func("tvm.pipeline_executor.create")
+    return PipelineModule(fcreate(config, queue_capacity, *executors))
+
+
+class PipelineModule(object):
+    """Wrapper runtime module of the pipeline executor.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The internal tvm module that holds the actual pipeline functions.
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._set_input = module["set_input"]
+        self._run = module["run"]
+        self._get_output = module["get_output"]
+        self._get_stats = module["get_stats"]
+        self._get_num_stages = module["get_num_stages"]
+
+    def set_input(self, key=None, value=None, **params):
+        """Set the inputs of the next request, they are kept for the later requests.
+
+        Parameters
+        ----------
+        key : str
+           The input name
+
+        value : NDArray or numpy.ndarray
+           The input value
+
+        params : dict of str to NDArray
+           Additional arguments
+        """
+        if key is not None:
+            if not isinstance(value, tvm.runtime.NDArray):
+                value = tvm.nd.array(value)
+            self._set_input(key, value)
+        for k, v in params.items():
+            self.set_input(k, v)
+
+    def run(self, **input_dict):
+        """Queue a request, without waiting for its outputs.
+
+        Parameters
+        ----------
+        input_dict: dict of str to NDArray
+            List of input values to be feed to
+        """
+        if input_dict:
+            self.set_input(**input_dict)
+        self._run()
+
+    def get_output(self):
+        """Wait for the outputs of the oldest request not returned yet.
+
+        Returns
+        -------
+        outputs : list of NDArray
+            The outputs of the request.
+        """
+        return list(self._get_output())
+
+    def get_stats(self):
+        """Get the time the stages spent on the requests, to re-partition the model.
+
+        Returns
+        -------
+        stats : dict
+            "stages" holds the runs and the mean, busy, idle and blocked time in
+            microseconds of each stage. "bottleneck" is the slowest stage, and
+            "balance" the ratio of its mean latency to the mean latency of the
+            stages, 1 when they are balanced.
+        """
+        return json.loads(self._get_stats())
+
+    @property
+    def num_stages(self):
+        return self._get_num_stages()
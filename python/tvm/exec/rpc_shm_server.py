@@ -0,0 +1,37 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""RPC server process of a ShmSession, serves the shared memory passed by the client."""
+import sys
+import logging
+
+from tvm.rpc import server, _ffi_api
+
+
+def main():
+    """Main server function"""
+    if len(sys.argv) != 2:
+        print("Usage: <shm_fd>")
+        return
+    temp = server._server_env([])
+    _ffi_api.ShmServerLoop(int(sys.argv[1]))
+    temp.remove()
+    logging.info("Finish serving the shared memory session")
+
+
+if __name__ == "__main__":
+    main()
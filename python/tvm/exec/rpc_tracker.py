@@ -23,7 +23,13 @@ from ..rpc.tracker import Tracker
 
 def main(args):
     """Main function"""
-    tracker = Tracker(args.host, port=args.port, port_end=args.port_end, silent=args.silent)
+    tracker = Tracker(
+        args.host,
+        port=args.port,
+        port_end=args.port_end,
+        silent=args.silent,
+        max_session_time=args.max_session_time,
+    )
     tracker.proc.join()
 
 
@@ -35,6 +41,12 @@ if __name__ == "__main__":
     parser.add_argument("--port", type=int, default=9190, help="The port of the RPC")
     parser.add_argument("--port-end", type=int, default=9199, help="The end search port of the RPC")
     parser.add_argument("--silent", action="store_true", help="Whether run in silent mode.")
+    parser.add_argument(
+        "--max-session-time",
+        type=float,
+        default=None,
+        help="Preempt the sessions running for longer than this number of seconds.",
+    )
     args = parser.parse_args()
     logging.basicConfig(level=logging.INFO)
     main(args)
@@ -18,6 +18,8 @@
 """Common data structures across all IR variants."""
 from .base import SourceName, Span, Node, EnvFunc, load_json, save_json
 from .base import structural_equal, assert_structural_equal, structural_hash
+from .base import StructuralHashCache
+from .base import save_binary, load_binary, save_binary_file, load_binary_file
 from .type import Type, TypeKind, PrimType, PointerType, TypeVar, GlobalTypeVar, TupleType
 from .type import TypeConstraint, FuncType, IncompleteType, RelayRefType
 from .tensor_type import TensorType
@@ -54,6 +54,64 @@ class Node(Object):
         """
         return _ffi_api.AsText(self, show_meta_data, annotate)
 
+    def astext_with_meta_table(self, annotate=None):
+        """Get the text format of the expression, with the meta data kept aside.
+
+        Parameters
+        ----------
+        annotate: Optional[Object->str]
+            Optionally annotate function to provide additional
+            information in the comment block.
+
+        Returns
+        -------
+        text : str
+            The text format of the expression, without metadata section.
+
+        meta_table : Map[str, Array[Object]]
+            The meta data the text refers to, e.g. the constants, to be given to
+            :py:func:`tvm.parser.parse` as ``init_meta_table``.
+        """
+        text, meta_table = _ffi_api.AsTextWithMetaTable(self, annotate)
+        return str(text), meta_table
+
+    def save_text(
+        self, file_name, show_meta_data=True, annotate=None, num_threads=1, elide_constant_bytes=0
+    ):
+        """Write the text format of the expression to a file, without rendering it as a string.
+
+        Parameters
+        ----------
+        file_name : str
+            The file to write to.
+
+        show_meta_data : bool
+            Whether to include meta data section in the text
+            if there is meta data.
+
+        annotate: Optional[Object->str]
+            Optionally annotate function to provide additional
+            information in the comment block, the functions are
+            then printed one at a time.
+
+        num_threads : int
+            The number of functions of a module printed at once,
+            0 for the number of cores.
+
+        elide_constant_bytes : int
+            The constants of more bytes are printed as ``meta[relay.Constant][elided]``
+            and left out of the meta data, 0 to keep all of them.
+
+        Notes
+        -----
+        Each function of a module is printed on its own, so the names of the
+        local variables can differ from the ones of :py:func:`astext`. The text
+        parses back to the same module unless constants are elided.
+        """
+        _ffi_api.SaveText(
+            self, file_name, show_meta_data, annotate, num_threads, elide_constant_bytes
+        )
+
     def __str__(self):
         return _ffi_api.PrettyPrint(self)
 
@@ -157,6 +215,75 @@ def save_json(node):
     return tvm.runtime._ffi_node_api.SaveJSON(node)
 
 
+def save_binary(node):
+    """Save tvm object in the compact binary format.
+
+    The binary format stores tensors as raw data and field names once per type,
+    it is smaller and faster to save and load than json.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    data : bytearray
+        The saved bytes.
+    """
+    return tvm.runtime._ffi_node_api.SaveBinary(node)
+
+
+def load_binary(data):
+    """Load tvm object saved by save_binary.
+
+    Parameters
+    ----------
+    data : bytearray
+        The saved bytes.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return tvm.runtime._ffi_node_api.LoadBinary(data)
+
+
+def save_binary_file(node, path):
+    """Save tvm object in the compact binary format to a file.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    path : str
+        The path of the file.
+    """
+    tvm.runtime._ffi_node_api.SaveBinaryToFile(path, node)
+
+
+def load_binary_file(path, use_mmap=True):
+    """Load tvm object saved by save_binary_file.
+
+    Parameters
+    ----------
+    path : str
+        The path of the file.
+
+    use_mmap : bool
+        Whether the tensors of the object point into a copy-on-write mapping of
+        the file instead of being copied.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return tvm.runtime._ffi_node_api.LoadBinaryFromFile(path, use_mmap)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -277,3 +404,47 @@ def structural_hash(node, map_free_vars=False):
     structrual_equal
     """
     return tvm.runtime._ffi_node_api.StructuralHash(node, map_free_vars)
+
+
+@tvm._ffi.register_object("node.SHashCache")
+class StructuralHashCache(Object):
+    """Cache of the structural hash of subtrees, shared by structural_hash calls.
+
+    The hash of the subtrees which do not depend on their context, such as
+    types, attributes and constants, is reused by the hashes computed within
+    the scope of the cache.
+
+    Example
+    -------
+    .. code-block:: python
+
+        cache = tvm.ir.StructuralHashCache()
+        with cache:
+            h0 = tvm.ir.structural_hash(func)
+            # Only the nodes which differ from func are hashed again.
+            h1 = tvm.ir.structural_hash(updated_func)
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(tvm.runtime._ffi_node_api.SHashCache)
+
+    def __enter__(self):
+        tvm.runtime._ffi_node_api.SHashCacheEnterScope(self)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        tvm.runtime._ffi_node_api.SHashCacheExitScope(self)
+
+    @property
+    def size(self):
+        """The number of recorded subtrees."""
+        return tvm.runtime._ffi_node_api.SHashCacheSize(self)
+
+    @property
+    def hits(self):
+        """The number of lookups which found a recorded hash."""
+        return tvm.runtime._ffi_node_api.SHashCacheHits(self)
+
+    def clear(self):
+        """Forget all the recorded subtrees."""
+        tvm.runtime._ffi_node_api.SHashCacheClear(self)
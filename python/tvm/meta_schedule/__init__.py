@@ -0,0 +1,29 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=unused-import
+"""Namespace for the meta schedule, which tunes TensorIR PrimFuncs over the traces of schedules."""
+from . import database
+from . import measure
+from . import mutator
+from . import search
+from . import space_generator
+
+from .database import Database, JSONDatabase, TuningRecord, workload_key
+from .measure import LocalBuilder, LocalRunner
+from .mutator import Mutator, MutateTileSize
+from .search import apply_best, tune_tir
+from .space_generator import ScheduleFn, SpaceGenerator, SpaceGeneratorUnion
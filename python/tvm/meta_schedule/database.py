@@ -0,0 +1,171 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The database of the tuning records of the meta schedule."""
+import json
+import os
+from typing import Dict, List, Optional, Tuple
+
+import tvm
+from tvm.ir import IRModule
+from tvm.tir.schedule import Trace
+
+
+def workload_key(mod: IRModule) -> str:
+    """Get the key of a workload in the database, i.e. the structural hash of its IRModule
+
+    Parameters
+    ----------
+    mod : IRModule
+        The workload
+
+    Returns
+    -------
+    key : str
+        The key of the workload
+    """
+    return "%016x" % tvm.ir.structural_hash(mod)
+
+
+class TuningRecord:
+    """The record of a measured schedule of a workload
+
+    Parameters
+    ----------
+    trace : Trace
+        The trace of the schedule
+    run_secs : List[float]
+        The measured running time of the scheduled workload, in seconds
+    workload : str
+        The key of the workload
+    target : str
+        The target the workload is measured on
+    """
+
+    def __init__(self, trace: Trace, run_secs: List[float], workload: str, target: str):
+        self.trace = trace
+        self.run_secs = [float(sec) for sec in run_secs]
+        self.workload = workload
+        self.target = str(target)
+
+    @property
+    def mean_run_secs(self) -> float:
+        """The mean of the measured running time"""
+        return sum(self.run_secs) / len(self.run_secs)
+
+    def as_json(self) -> str:
+        """Serialize the record as a line of json"""
+        return json.dumps(
+            {
+                "workload": self.workload,
+                "target": self.target,
+                "run_secs": self.run_secs,
+                "trace": tvm.ir.save_json(self.trace),
+            }
+        )
+
+    @staticmethod
+    def from_json(line: str) -> "TuningRecord":
+        """Deserialize a record from a line of json
+
+        Parameters
+        ----------
+        line : str
+            The line written by `as_json`
+
+        Returns
+        -------
+        record : TuningRecord
+            The record
+        """
+        obj = json.loads(line)
+        return TuningRecord(
+            tvm.ir.load_json(obj["trace"]), obj["run_secs"], obj["workload"], obj["target"]
+        )
+
+
+class Database:
+    """The base class of the databases of tuning records"""
+
+    def commit(self, record: TuningRecord) -> None:
+        """Add a record to the database
+
+        Parameters
+        ----------
+        record : TuningRecord
+            The record to be added
+        """
+        raise NotImplementedError
+
+    def get_top_k(self, workload: str, target, k: int = 1) -> List[TuningRecord]:
+        """Get the best records of a workload on a target
+
+        Parameters
+        ----------
+        workload : str
+            The key of the workload
+        target : Union[tvm.target.Target, str]
+            The target
+        k : int
+            The maximum number of records
+
+        Returns
+        -------
+        records : List[TuningRecord]
+            The records, by increasing mean running time
+        """
+        raise NotImplementedError
+
+
+class JSONDatabase(Database):
+    """A database keeping the records in memory, and appending them to a json log file, one
+    record per line, if a path is given. The records already in the file are loaded.
+
+    Parameters
+    ----------
+    path : Optional[str]
+        The path of the log file. It is created if it does not exist.
+    """
+
+    def __init__(self, path: Optional[str] = None):
+        self.path = path
+        self.records: Dict[Tuple[str, str], List[TuningRecord]] = {}
+        if path is None:
+            return
+        dirname = os.path.dirname(os.path.abspath(path))
+        if not os.path.exists(dirname):
+            os.makedirs(dirname)
+        if os.path.exists(path):
+            with open(path, "r") as log_file:
+                for line in log_file:
+                    if line.strip():
+                        self._add(TuningRecord.from_json(line))
+
+    def _add(self, record: TuningRecord) -> None:
+        self.records.setdefault((record.workload, record.target), []).append(record)
+
+    def commit(self, record: TuningRecord) -> None:
+        self._add(record)
+        if self.path is not None:
+            with open(self.path, "a") as log_file:
+                log_file.write(record.as_json() + "\n")
+
+    def get_top_k(self, workload: str, target, k: int = 1) -> List[TuningRecord]:
+        records = self.records.get((workload, str(target)), [])
+        return sorted(records, key=lambda record: record.mean_run_secs)[:k]
+
+    def __len__(self) -> int:
+        return sum(len(records) for records in self.records.values())
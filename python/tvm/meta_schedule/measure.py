@@ -0,0 +1,322 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The measurement of the scheduled workloads of the meta schedule.
+
+The builders and runners follow `tvm.auto_scheduler.LocalBuilder` and
+`tvm.auto_scheduler.LocalRunner`: they take the same options and produce the same
+`BuildResult` and `MeasureResult`, but they measure scheduled IRModules instead of the states of
+a ComputeDAG.
+"""
+import multiprocessing
+import multiprocessing.pool
+import os
+import shutil
+import tempfile
+import time
+from typing import List, Tuple
+
+import tvm
+from tvm.auto_scheduler.measure import MAX_FLOAT, BuildResult, MeasureErrorNo, MeasureResult
+from tvm.auto_scheduler.utils import call_func_with_timeout, make_traceback_info
+from tvm.contrib import ndk, tar
+from tvm.driver import build_module
+from tvm.ir import IRModule, transform
+from tvm.runtime import module, ndarray
+from tvm.target import Target
+
+
+def _entry_func(mod: IRModule) -> Tuple[str, tvm.tir.PrimFunc]:
+    funcs = [(gv, func) for gv, func in mod.functions.items() if isinstance(func, tvm.tir.PrimFunc)]
+    if len(funcs) != 1:
+        raise ValueError(f"Expect the workload to contain exactly one PrimFunc, but gets: {mod}")
+    gv, func = funcs[0]
+    if func.attrs is not None and "global_symbol" in func.attrs:
+        return str(func.attrs["global_symbol"]), func
+    return gv.name_hint, func.with_attr("global_symbol", gv.name_hint)
+
+
+def _timed_build(mod_json, target, build_func, verbose):
+    tic = time.time()
+    error_no = MeasureErrorNo.NO_ERROR
+    error_msg = None
+    dirname = tempfile.mkdtemp()
+    filename = os.path.join(dirname, "tmp_func." + build_func.output_format)
+    try:
+        _, func = _entry_func(tvm.ir.load_json(mod_json))
+        with transform.PassContext():
+            lib = build_module.build(func, target=Target(target))
+        lib.export_library(filename, build_func)
+    # pylint: disable=broad-except
+    except Exception:
+        error_no = MeasureErrorNo.COMPILE_HOST
+        error_msg = make_traceback_info()
+        shutil.rmtree(dirname)
+        filename = ""
+    if verbose >= 1:
+        print("." if error_no == MeasureErrorNo.NO_ERROR else ".E", end="", flush=True)
+    return filename, [], error_no, error_msg, time.time() - tic
+
+
+class LocalBuilder:
+    """LocalBuilder use local CPU cores to build scheduled workloads in parallel.
+
+    Parameters
+    ----------
+    timeout : int = 15
+        The timeout limit (in second) for each build thread.
+        This is used in a wrapper of the multiprocessing.Process.join().
+    n_parallel : int = multiprocessing.cpu_count()
+        Number of threads used to build in parallel.
+    build_func: callable or str = "default"
+        If is 'default', use default build function
+        If is 'ndk', use function for android ndk
+        If is callable, use it as custom build function, expect lib_format field.
+    """
+
+    def __init__(self, timeout=15, n_parallel=multiprocessing.cpu_count(), build_func="default"):
+        if build_func == "default":
+            build_func = tar.tar
+        elif build_func == "ndk":
+            build_func = ndk.create_shared
+        elif not callable(build_func):
+            raise ValueError("Invalid build_func" + build_func)
+        self.timeout = timeout
+        self.n_parallel = n_parallel
+        self.build_func = build_func
+
+    def _build_worker(self, args):
+        mod_json, target, verbose = args
+        res = call_func_with_timeout(
+            self.timeout, _timed_build, args=(mod_json, target, self.build_func, verbose)
+        )
+        if isinstance(res, TimeoutError):
+            if verbose >= 1:
+                print(".T", end="", flush=True)  # Build timeout
+            res = None, [], MeasureErrorNo.BUILD_TIMEOUT, None, self.timeout
+        elif isinstance(res, Exception):
+            if verbose >= 1:
+                print(".E", end="", flush=True)  # Build error
+            res = None, [], MeasureErrorNo.COMPILE_HOST, str(res), self.timeout
+        return res
+
+    def build(self, mods: List[IRModule], target, verbose=1) -> List[BuildResult]:
+        """Build the scheduled workloads to runnable modules.
+
+        Parameters
+        ----------
+        mods : List[IRModule]
+            The scheduled workloads to be built.
+        target : Union[tvm.target.Target, str]
+            The target to build for.
+        verbose: int = 1
+            Verbosity level. 0 for silent, 1 to output information during program building.
+
+        Returns
+        -------
+        res : List[BuildResult]
+            The build results of these workloads.
+        """
+        # This pool is not doing computationally intensive work, so we can use threads
+        pool = multiprocessing.pool.ThreadPool(self.n_parallel)
+        tuple_res = pool.map(
+            self._build_worker,
+            [(tvm.ir.save_json(mod), str(target), verbose) for mod in mods],
+        )
+        pool.terminate()
+        pool.join()
+        del pool
+        return [BuildResult(*res) for res in tuple_res]
+
+
+def _timed_run(
+    filename,
+    entry_name,
+    arg_info,
+    target,
+    number,
+    repeat,
+    min_repeat_ms,
+    cooldown_interval,
+    enable_cpu_cache_flush,
+    verbose,
+):
+    tic = time.time()
+    error_no = MeasureErrorNo.NO_ERROR
+    error_msg = None
+    try:
+        func = module.load_module(filename)
+        dev = ndarray.device(str(target), 0)
+        f_prepare = "cache_flush_cpu_non_first_arg" if enable_cpu_cache_flush else ""
+        time_f = func.time_evaluator(
+            entry_name,
+            dev,
+            number=number,
+            repeat=repeat,
+            min_repeat_ms=min_repeat_ms,
+            f_preproc=f_prepare,
+        )
+    # pylint: disable=broad-except
+    except Exception:
+        costs = (MAX_FLOAT,)
+        error_no = MeasureErrorNo.COMPILE_DEVICE
+        error_msg = make_traceback_info()
+
+    if error_no == MeasureErrorNo.NO_ERROR:
+        try:
+            random_fill = tvm.get_global_func("tvm.contrib.random.random_fill", True)
+            assert random_fill, "Please make sure USE_RANDOM is ON in the config.cmake"
+            args = []
+            for shape, dtype in arg_info:
+                empty_array = ndarray.empty(shape, dtype, dev)
+                random_fill(empty_array)
+                args.append(empty_array)
+            dev.sync()
+            costs = time_f(*args).results
+        # pylint: disable=broad-except
+        except Exception:
+            costs = (MAX_FLOAT,)
+            error_no = MeasureErrorNo.RUNTIME_DEVICE
+            error_msg = make_traceback_info()
+
+    toc = time.time()
+    time.sleep(cooldown_interval)
+    if verbose >= 1:
+        print("*" if error_no == MeasureErrorNo.NO_ERROR else "*E", end="", flush=True)
+    return costs, error_no, error_msg, toc - tic, toc
+
+
+class LocalRunner:
+    """LocalRunner that uses local CPU/GPU to measures the time cost of the built workloads.
+
+    Parameters
+    ----------
+    timeout : int = 10
+        The timeout limit (in second) for each run.
+        This is used in a wrapper of the multiprocessing.Process.join().
+    number : int = 3
+        The number of times to run the generated code for taking average.
+        We call these runs as one `repeat` of measurement.
+    repeat : int = 1
+        The number of times to repeat the measurement.
+    min_repeat_ms : int = 100
+        The minimum duration of one `repeat` in milliseconds.
+    cooldown_interval : float = 0.0
+        The cool down interval between two measurements.
+    enable_cpu_cache_flush: bool = False
+        Whether to flush cache on CPU between repeated measurements.
+    """
+
+    def __init__(
+        self,
+        timeout=10,
+        number=3,
+        repeat=1,
+        min_repeat_ms=100,
+        cooldown_interval=0.0,
+        enable_cpu_cache_flush=False,
+    ):
+        if enable_cpu_cache_flush:
+            number = 1
+            min_repeat_ms = 0
+        self.timeout = timeout
+        self.number = number
+        self.repeat = repeat
+        self.min_repeat_ms = min_repeat_ms
+        self.cooldown_interval = cooldown_interval
+        self.enable_cpu_cache_flush = enable_cpu_cache_flush
+
+    def run(
+        self, mods: List[IRModule], build_results: List[BuildResult], target, verbose=1
+    ) -> List[MeasureResult]:
+        """Measure the time cost of the built workloads.
+
+        Parameters
+        ----------
+        mods : List[IRModule]
+            The scheduled workloads, whose parameters are the arguments of the measurement.
+        build_results : List[BuildResult]
+            The build results of the workloads.
+        target : Union[tvm.target.Target, str]
+            The target the workloads are built for.
+        verbose: int = 1
+            Verbosity level. 0 for silent, 1 to output information during program measuring.
+
+        Returns
+        -------
+        res : List[MeasureResult]
+            The measure results of these workloads.
+        """
+        assert len(mods) == len(build_results), "Measure inputs should match the build results"
+        measure_results = []
+        for mod, build_res in zip(mods, build_results):
+            if build_res.error_no != MeasureErrorNo.NO_ERROR:
+                res = (
+                    (MAX_FLOAT,),
+                    build_res.error_no,
+                    build_res.error_msg,
+                    build_res.time_cost,
+                    time.time(),
+                )
+            else:
+                entry_name, func = _entry_func(mod)
+                buffers = [func.buffer_map[param] for param in func.params]
+                arg_info = [([int(dim) for dim in buf.shape], buf.dtype) for buf in buffers]
+                res = call_func_with_timeout(
+                    self.timeout,
+                    _timed_run,
+                    args=(
+                        build_res.filename,
+                        entry_name,
+                        arg_info,
+                        str(Target(target).kind.name),
+                        self.number,
+                        self.repeat,
+                        self.min_repeat_ms,
+                        self.cooldown_interval,
+                        self.enable_cpu_cache_flush,
+                        verbose,
+                    ),
+                    add_thread_wrapper=True,
+                )
+                if isinstance(res, TimeoutError):
+                    if verbose >= 1:
+                        print("*T", end="", flush=True)  # Run timeout
+                    res = (
+                        (MAX_FLOAT,),
+                        MeasureErrorNo.RUN_TIMEOUT,
+                        None,
+                        build_res.time_cost + self.timeout,
+                        time.time(),
+                    )
+                elif isinstance(res, Exception):
+                    if verbose >= 1:
+                        print("*E", end="", flush=True)  # Run error
+                    res = (
+                        (MAX_FLOAT,),
+                        MeasureErrorNo.RUNTIME_DEVICE,
+                        str(res),
+                        build_res.time_cost + self.timeout,
+                        time.time(),
+                    )
+                else:
+                    costs, error_no, error_msg, run_cost, timestamp = res
+                    res = costs, error_no, error_msg, run_cost + build_res.time_cost, timestamp
+                shutil.rmtree(os.path.dirname(build_res.filename))
+            measure_results.append(MeasureResult(*res))
+        if verbose >= 1:
+            print("", flush=True)
+        return measure_results
@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The mutators of the traces, which explore the neighbourhood of a schedule in the search."""
+import random
+from typing import List, Optional
+
+from tvm.tir import IntImm
+from tvm.tir.schedule import Instruction, Trace
+
+
+class Mutator:
+    """The base class of the mutators of traces"""
+
+    def apply(self, trace: Trace, rand_state: random.Random) -> Optional[Trace]:
+        """Mutate a trace
+
+        Parameters
+        ----------
+        trace : Trace
+            The trace to be mutated, which is left untouched
+        rand_state : random.Random
+            The random state of the search
+
+        Returns
+        -------
+        new_trace : Optional[Trace]
+            The mutated trace, or None if the trace cannot be mutated
+        """
+        raise NotImplementedError
+
+
+def _prime_factors(n: int) -> List[int]:
+    result = []
+    divisor = 2
+    while divisor * divisor <= n:
+        while n % divisor == 0:
+            result.append(divisor)
+            n //= divisor
+        divisor += 1
+    if n > 1:
+        result.append(n)
+    return result
+
+
+class MutateTileSize(Mutator):
+    """Mutate the factors of a split, whose factors are all given, by moving a prime factor of one
+    factor to another one. The product of the factors, i.e. the extent of the loop, is preserved,
+    so the mutated split is still a perfect tiling.
+    """
+
+    def apply(self, trace: Trace, rand_state: random.Random) -> Optional[Trace]:
+        insts = list(trace.insts)
+        candidates = [
+            i
+            for i, inst in enumerate(insts)
+            if inst.kind == "Split"
+            and len(inst.inputs) > 2
+            and all(isinstance(factor, IntImm) for factor in inst.inputs[1:])
+            and any(int(factor) > 1 for factor in inst.inputs[1:])
+        ]
+        if not candidates:
+            return None
+        inst_idx = rand_state.choice(candidates)
+        inst = insts[inst_idx]
+        factors = [int(factor) for factor in inst.inputs[1:]]
+        src = rand_state.choice([i for i, factor in enumerate(factors) if factor > 1])
+        dst = rand_state.choice([i for i in range(len(factors)) if i != src])
+        prime = rand_state.choice(_prime_factors(factors[src]))
+        factors[src] //= prime
+        factors[dst] *= prime
+        dtype = inst.inputs[1].dtype
+        insts[inst_idx] = Instruction(
+            inst.kind,
+            [inst.inputs[0]] + [IntImm(dtype, factor) for factor in factors],
+            inst.attrs,
+            inst.outputs,
+        )
+        return Trace(insts)
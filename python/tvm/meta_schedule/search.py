@@ -0,0 +1,188 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The search of the meta schedule.
+
+The search starts from the traces of the design space, measures them, and then repeatedly
+mutates the best measured traces to explore their neighbourhood. Every successful measurement
+is committed to the database, from which the best schedule of a workload is applied.
+"""
+import logging
+import random
+from typing import List, Optional, Union
+
+import tvm
+from tvm.error import TVMError
+from tvm.ir import IRModule
+from tvm.target import Target
+from tvm.tir import PrimFunc
+from tvm.tir.schedule import Schedule, Trace
+
+from .database import Database, JSONDatabase, TuningRecord, workload_key
+from .measure import LocalBuilder, LocalRunner
+from .mutator import Mutator, MutateTileSize
+from .space_generator import SpaceGenerator, _normalize_mod
+
+logger = logging.getLogger("meta_schedule")  # pylint: disable=invalid-name
+
+# The number of failed attempts of mutation allowed per candidate in a batch
+MAX_FAIL_PER_CANDIDATE = 16
+
+
+def _replay(mod: IRModule, trace: Trace) -> Optional[Schedule]:
+    sch = Schedule(mod, traced=True)
+    try:
+        trace.apply_to_schedule(sch)
+    except TVMError:
+        return None
+    return sch
+
+
+def apply_best(
+    func_or_mod: Union[PrimFunc, IRModule], target, database: Database
+) -> Optional[Schedule]:
+    """Apply the best record of a workload in the database
+
+    Parameters
+    ----------
+    func_or_mod : Union[PrimFunc, IRModule]
+        The workload
+    target : Union[tvm.target.Target, str]
+        The target the workload is tuned on
+    database : Database
+        The database of the tuning records
+
+    Returns
+    -------
+    sch : Optional[Schedule]
+        The schedule of the workload with the best record applied, or None if there is no record
+    """
+    mod = _normalize_mod(func_or_mod)
+    for record in database.get_top_k(workload_key(mod), str(Target(target)), 1):
+        return _replay(mod, record.trace)
+    return None
+
+
+def tune_tir(
+    func_or_mod: Union[PrimFunc, IRModule],
+    target,
+    space: SpaceGenerator,
+    *,
+    mutators: Optional[List[Mutator]] = None,
+    num_trials: int = 32,
+    batch_size: int = 8,
+    database: Optional[Database] = None,
+    builder: Optional[LocalBuilder] = None,
+    runner: Optional[LocalRunner] = None,
+    seed: Optional[int] = None,
+    verbose: int = 1,
+) -> Optional[Schedule]:
+    """Tune a TensorIR workload
+
+    Parameters
+    ----------
+    func_or_mod : Union[PrimFunc, IRModule]
+        The workload to be tuned
+    target : Union[tvm.target.Target, str]
+        The target to be tuned on
+    space : SpaceGenerator
+        The generator of the design space
+    mutators : Optional[List[Mutator]]
+        The mutators exploring the neighbourhood of the measured traces, `MutateTileSize` by
+        default
+    num_trials : int = 32
+        The maximum number of schedules to be measured
+    batch_size : int = 8
+        The number of schedules measured together
+    database : Optional[Database]
+        The database the records are committed to, an in-memory JSONDatabase by default
+    builder : Optional[LocalBuilder]
+        The builder of the schedules
+    runner : Optional[LocalRunner]
+        The runner of the schedules
+    seed : Optional[int]
+        The seed of the random state of the search
+    verbose: int = 1
+        Verbosity level. 0 for silent, 1 to output information during the search.
+
+    Returns
+    -------
+    sch : Optional[Schedule]
+        The best schedule of the workload, or None if no schedule is successfully measured
+    """
+    mod = _normalize_mod(func_or_mod)
+    target = Target(target)
+    mutators = [MutateTileSize()] if mutators is None else mutators
+    database = JSONDatabase() if database is None else database
+    builder = LocalBuilder() if builder is None else builder
+    runner = LocalRunner() if runner is None else runner
+    rand_state = random.Random(seed)
+    workload = workload_key(mod)
+
+    # The design space is measured first, then the neighbourhood of the best measured traces
+    pending = [sch for sch in space.generate(mod) if sch.trace is not None]
+    if not pending:
+        raise ValueError("The design space contains no traced schedule")
+    design_space = [sch.trace for sch in pending]
+    seen = set()
+    num_measured = 0
+    while num_measured < num_trials:
+        batch: List[Schedule] = []
+        num_fail = 0
+        max_fail = batch_size * MAX_FAIL_PER_CANDIDATE
+        while (
+            len(batch) < min(batch_size, num_trials - num_measured)
+            and (pending or num_fail < max_fail)
+            and (pending or mutators)
+        ):
+            if pending:
+                sch = pending.pop(0)
+            else:
+                parents = [
+                    record.trace for record in database.get_top_k(workload, target, batch_size)
+                ] or design_space
+                new_trace = rand_state.choice(mutators).apply(
+                    rand_state.choice(parents), rand_state
+                )
+                sch = _replay(mod, new_trace) if new_trace is not None else None
+                if sch is None:
+                    num_fail += 1
+                    continue
+            key = tvm.ir.structural_hash(sch.mod)
+            if key in seen:
+                num_fail += 1
+                continue
+            seen.add(key)
+            batch.append(sch)
+        if not batch:
+            break
+
+        mods = [sch.mod for sch in batch]
+        build_results = builder.build(mods, target, verbose)
+        measure_results = runner.run(mods, build_results, target, verbose)
+        for sch, res in zip(batch, measure_results):
+            if res.error_no == 0:
+                database.commit(
+                    TuningRecord(sch.trace, [cost.value for cost in res.costs], workload, target)
+                )
+            else:
+                logger.debug("Measurement failed with error no %d: %s", res.error_no, res.error_msg)
+        num_measured += len(batch)
+        if verbose >= 1:
+            best = database.get_top_k(workload, target, 1)
+            best_str = "%.6f ms" % (best[0].mean_run_secs * 1e3) if best else "N/A"
+            print("Measured %d / %d schedules. Best: %s" % (num_measured, num_trials, best_str))
+    return apply_best(mod, target, database)
@@ -0,0 +1,111 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The generators of the design spaces of a workload.
+
+A design space is represented by the traced schedules a generator returns: the search starts from
+their traces, and explores the neighbourhood of the best ones with the mutators.
+"""
+from typing import Callable, List, Optional, Union
+
+from tvm.ir import IRModule
+from tvm.tir import PrimFunc
+from tvm.tir.schedule import Schedule
+
+
+def _normalize_mod(func_or_mod: Union[PrimFunc, IRModule]) -> IRModule:
+    if isinstance(func_or_mod, PrimFunc):
+        return IRModule({"main": func_or_mod})
+    if isinstance(func_or_mod, IRModule):
+        return func_or_mod
+    raise TypeError(f"Expect a PrimFunc or an IRModule, but gets: {type(func_or_mod)}")
+
+
+class SpaceGenerator:
+    """The base class of the design space generators"""
+
+    def generate(self, mod: IRModule) -> List[Schedule]:
+        """Generate the design space of a workload
+
+        Parameters
+        ----------
+        mod : IRModule
+            The workload to be tuned
+
+        Returns
+        -------
+        design_space : List[Schedule]
+            The traced schedules of the workload, whose traces are the starting points of the search
+        """
+        raise NotImplementedError
+
+
+class ScheduleFn(SpaceGenerator):
+    """A design space generator that applies a user-provided function to a traced schedule
+
+    Parameters
+    ----------
+    sch_fn : Callable[[Schedule], Optional[Union[Schedule, List[Schedule]]]]
+        The function scheduling a workload. It either schedules the schedule in place and returns
+        None, or returns the schedules of the design space
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        def schedule_matmul(sch):
+            i, j, k = sch.get_loops(sch.get_block("C"))
+            i_0, i_1 = sch.split(i, factors=[8, 16])
+            j_0, j_1 = sch.split(j, factors=[8, 16])
+            sch.reorder(i_0, j_0, i_1, j_1)
+
+        space = ScheduleFn(schedule_matmul)
+    """
+
+    def __init__(
+        self,
+        sch_fn: Callable[[Schedule], Optional[Union[Schedule, List[Schedule]]]],
+    ):
+        self.sch_fn = sch_fn
+
+    def generate(self, mod: IRModule) -> List[Schedule]:
+        sch = Schedule(_normalize_mod(mod), traced=True)
+        result = self.sch_fn(sch)
+        if result is None:
+            return [sch]
+        if isinstance(result, Schedule):
+            return [result]
+        return list(result)
+
+
+class SpaceGeneratorUnion(SpaceGenerator):
+    """A design space generator that unions the design spaces of several generators
+
+    Parameters
+    ----------
+    space_generators : List[SpaceGenerator]
+        The generators to be unioned
+    """
+
+    def __init__(self, space_generators: List[SpaceGenerator]):
+        self.space_generators = list(space_generators)
+
+    def generate(self, mod: IRModule) -> List[Schedule]:
+        result = []
+        for space_generator in self.space_generators:
+            result.extend(space_generator.generate(mod))
+        return result
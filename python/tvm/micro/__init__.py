@@ -21,6 +21,7 @@ from .build import build_static_runtime, default_options, get_standalone_crt_dir
 from .build import get_standalone_crt_lib, Workspace
 from .compiler import Compiler, DefaultCompiler, Flasher
 from .debugger import GdbRemoteDebugger
+from .graph_descriptor import generate_graph_descriptor
 from .micro_library import MicroLibrary
 from .micro_binary import MicroBinary
 from .model_library_format import export_model_library_format, UnsupportedInModelLibraryFormatError
@@ -0,0 +1,124 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Generates a graph descriptor, a graph JSON compiled into the application for the CRT."""
+
+import json
+import textwrap
+
+
+def _c_string(value):
+    if value is None:
+        return "NULL"
+    return json.dumps(value)
+
+
+def _c_array(c_type, name, values):
+    """Define a static array, the empty arrays are NULL pointers."""
+    if not values:
+        return None, "NULL"
+    lines = [f"static const {c_type} {name}[] = {{"]
+    if c_type == "TVMGraphExecutorNodeDescriptor":
+        lines.extend(f"    {value}," for value in values)
+    else:
+        body = ", ".join(str(value) for value in values) + ","
+        lines.extend(textwrap.wrap(body, 100, initial_indent="    ", subsequent_indent="    "))
+    lines.append("};")
+    return "\n".join(lines), name
+
+
+def generate_graph_descriptor(graph_json, name="graph"):
+    """Generate the C source of a graph descriptor.
+
+    The CRT graph executor reads the descriptor with TVMGraphExecutor_CreateFromDescriptor,
+    without parsing the graph JSON at boot. The JSON loader can then be compiled out by
+    defining TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON.
+
+    Parameters
+    ----------
+    graph_json : str
+        The graph JSON created by tvm.relay.build().
+
+    name : str
+        The name of the TVMGraphExecutorGraphDescriptor defined by the source.
+
+    Returns
+    -------
+    str :
+        The C source defining the descriptor.
+    """
+    graph = json.loads(graph_json)
+    attrs = graph["attrs"]
+    definitions = []
+
+    def define(c_type, array_name, values):
+        definition, ref = _c_array(c_type, f"{name}_{array_name}", values)
+        if definition is not None:
+            definitions.append(definition)
+        return ref, len(values)
+
+    def entry(value):
+        return f"{{{value[0]}, {value[1]}}}"
+
+    nodes = []
+    for node_id, node in enumerate(graph["nodes"]):
+        inputs, num_node_inputs = define(
+            "TVMGraphExecutorEntryDescriptor",
+            f"node{node_id}_inputs",
+            [entry(e) for e in node["inputs"]],
+        )
+        node_attrs = node.get("attrs", {})
+        fields = [
+            _c_string(node["op"]),
+            _c_string(node["name"]),
+            _c_string(node_attrs.get("func_name")),
+            node_attrs.get("num_inputs", "0"),
+            node_attrs.get("num_outputs", "0"),
+            node_attrs.get("flatten_data", "0"),
+            inputs,
+            num_node_inputs,
+        ]
+        nodes.append(f"{{{', '.join(str(f) for f in fields)}}}")
+
+    shapes = attrs["shape"][1]
+    fields = [
+        define("TVMGraphExecutorNodeDescriptor", "nodes", nodes),
+        define("uint32_t", "arg_nodes", graph["arg_nodes"]),
+        define("uint32_t", "node_row_ptr", graph["node_row_ptr"]),
+        define("TVMGraphExecutorEntryDescriptor", "heads", [entry(e) for e in graph["heads"]]),
+    ]
+    storage_id = define("uint32_t", "storage_id", attrs["storage_id"][1])[0]
+    dltype = define("char* const", "dltype", [_c_string(t) for t in attrs["dltype"][1]])[0]
+    ndim = define("uint32_t", "ndim", [len(shape) for shape in shapes])[0]
+    shape = define("int64_t", "shape", [dim for shape in shapes for dim in shape])[0]
+
+    lines = [
+        "// Graph descriptor generated by tvm.micro.generate_graph_descriptor.",
+        "#include <tvm/runtime/crt/graph_executor.h>",
+        "",
+    ]
+    for definition in definitions:
+        lines.extend([definition, ""])
+    lines.append(f"const TVMGraphExecutorGraphDescriptor {name} = {{")
+    for ref, count in fields:
+        lines.append(f"    {ref},")
+        lines.append(f"    {count},")
+    for ref in [storage_id, dltype, ndim, shape]:
+        lines.append(f"    {ref},")
+    lines.append(f"    {len(shapes)},")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
@@ -32,6 +32,7 @@ from ..runtime import ndarray as _nd
 from ..relay.backend import executor_factory
 from ..relay import param_dict
 from ..tir import expr
+from .graph_descriptor import generate_graph_descriptor
 
 # This should be kept identical to runtime::symbol::tvm_module_main
 MAIN_FUNC_NAME_STR = "__tvm_main__"
@@ -154,6 +155,7 @@ def _build_function_memory_map(function_metadata):
         This will have two entries:
         1.) A list with one entry per function describing local memory it is using.
         2.) A global memory requirement if all functions are executed sequentially
+        With workspace pools, a third entry gives the bytes used in each pool.
     """
     device_max_workspace = dict()
     main_func_metadata = function_metadata[MAIN_FUNC_NAME_STR]
@@ -210,6 +212,11 @@ def _build_function_memory_map(function_metadata):
         "operator_functions": func_entries,
         "main": target_main_entries,
     }
+    if main_func_metadata.workspace_pool_sizes:
+        ret["workspace_pools"] = [
+            {"pool_name": str(pool_name), "used_size_bytes": int(size)}
+            for pool_name, size in main_func_metadata.workspace_pool_sizes.items()
+        ]
     return ret
 
 
@@ -276,6 +283,13 @@ def _export_graph_model_library_format(
         graph_config_dir.mkdir(parents=True)
         with open(graph_config_dir / "graph.json", "w") as f:
             f.write(mod.get_executor_config())
+        # The same graph for the applications which do not parse the JSON at boot.
+        with open(graph_config_dir / "graph_descriptor.c", "w") as f:
+            f.write(
+                generate_graph_descriptor(
+                    mod.get_executor_config(), f"tvmgen_{mod.libmod_name}_graph"
+                )
+            )
 
 
 class NonStaticShapeError(Exception):
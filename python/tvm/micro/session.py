@@ -65,6 +65,7 @@ class Session:
         transport_context_manager=None,
         session_name="micro-rpc",
         timeout_override=None,
+        max_batch_size_bytes=0,
     ):
         """Configure a new session.
 
@@ -84,12 +85,18 @@ class Session:
         timeout_override : TransportTimeouts
             If given, TransportTimeouts that govern the way Receive() behaves. If not given, this is
             determined by calling has_flow_control() on the transport.
+        max_batch_size_bytes : int
+            When not 0, the RPC requests sent before waiting for a reply are batched in messages of
+            at most this many bytes, which the device processes back to back. Must not exceed the
+            TVM_CRT_MAX_PACKET_SIZE_BYTES of the device, less the 3-byte session header. When 0,
+            every request is a message.
         """
         self.binary = binary
         self.flasher = flasher
         self.transport_context_manager = transport_context_manager
         self.session_name = session_name
         self.timeout_override = timeout_override
+        self.max_batch_size_bytes = max_batch_size_bytes
 
         self._rpc = None
         self._graph_executor = None
@@ -97,6 +104,24 @@ class Session:
     def get_system_lib(self):
         return self._rpc.get_function("runtime.SystemLib")()
 
+    def get_aot_profile(self, cycles_per_second):
+        """Read the cycles of the operator calls of the last AOT run on the device.
+
+        The model needs to be compiled with the "relay.backend.aot_profile" PassContext option
+        and the device needs to register the AOT profiler with ``TVMAotProfiler_Register``.
+
+        Parameters
+        ----------
+        cycles_per_second : float
+            The frequency of the cycle counter read by ``TVMPlatformReadCycleCounter``.
+
+        Returns
+        -------
+        report : tvm.runtime.profiling.Report
+            The cycles and durations of the operator calls.
+        """
+        return get_global_func("micro.GetAotProfile")(self._rpc._sess, float(cycles_per_second))
+
     def _wrap_transport_read(self, n, timeout_microsec):
         try:
             return self.transport.read(
@@ -141,6 +166,7 @@ class Session:
                     int(timeouts.session_start_retry_timeout_sec * 1e6),
                     int(timeouts.session_start_timeout_sec * 1e6),
                     int(timeouts.session_established_timeout_sec * 1e6),
+                    self.max_batch_size_bytes,
                 )
             )
             self.device = self._rpc.cpu(0)
@@ -16,6 +16,8 @@
 # under the License.
 # pylint: disable=invalid-name
 """The under development unified IR parsing infrastructure."""
+import os
+
 from .. import _ffi, Object
 from . import _ffi_api
 
@@ -26,8 +28,80 @@ class SourceMap(Object):
         return _ffi.get_global_func("SourceMapAdd")(self, name, content)
 
 
-def parse(source, source_name="from_string"):
-    return _ffi_api.ParseModule(source_name, source)
+def parse(source, source_name="from_string", init_module=None, init_meta_table=None):
+    """Parse a module in the text format.
+
+    Parameters
+    ----------
+    source : str
+        The text.
+
+    source_name : str
+        The name of the source, used in the diagnostics.
+
+    init_module : Optional[IRModule]
+        The module to add the definitions to.
+
+    init_meta_table : Optional[Map[str, Array[Object]]]
+        The meta data the text refers to when it has no metadata section, e.g. as
+        returned by ``astext_with_meta_table``.
+
+    Returns
+    -------
+    mod : IRModule
+        The parsed module.
+    """
+    return _ffi_api.ParseModule(source_name, source, init_module, init_meta_table)
+
+
+def save(node, path):
+    """Save a node in the text format, with its meta data in a side binary file.
+
+    Unlike the json metadata section, the binary file stores the constants as raw
+    data, which is much smaller and faster to load.
+
+    Parameters
+    ----------
+    node : Object
+        The node to save, e.g. an IRModule.
+
+    path : str
+        The path of the text, the meta data goes to ``path + ".meta"`` if any.
+    """
+    from ..ir.base import save_binary_file  # pylint: disable=import-outside-toplevel
+
+    text, meta_table = node.astext_with_meta_table()
+    with open(path, "w") as f:
+        f.write(text)
+    if len(meta_table) > 0:
+        save_binary_file(meta_table, path + ".meta")
+
+
+def load(path, use_mmap=True):
+    """Load a module saved by :py:func:`save`.
+
+    Parameters
+    ----------
+    path : str
+        The path of the text.
+
+    use_mmap : bool
+        Whether the constants point into a mapping of the meta data file
+        instead of being copied.
+
+    Returns
+    -------
+    mod : IRModule
+        The parsed module.
+    """
+    from ..ir.base import load_binary_file  # pylint: disable=import-outside-toplevel
+
+    with open(path) as f:
+        text = f.read()
+    meta_table = None
+    if os.path.exists(path + ".meta"):
+        meta_table = load_binary_file(path + ".meta", use_mmap)
+    return parse(text, path, init_meta_table=meta_table)
 
 
 def parse_expr(source):
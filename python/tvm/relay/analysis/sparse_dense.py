@@ -54,6 +54,43 @@ def _search_dense_op_weight(expr):
     return _ffi_api.search_dense_op_weight(expr)
 
 
+# The block sizes tried by select_block_size, (1, 1) being CSR.
+DEFAULT_BLOCK_SIZES = ((1, 1), (2, 1), (4, 1), (8, 1), (16, 1), (32, 1), (1, 4), (4, 4), (8, 4))
+
+
+def select_block_size(weight, candidates=DEFAULT_BLOCK_SIZES, index_cost=2.0):
+    """Choose the BSR block size of a weight minimizing the work of the sparse dense.
+
+    Larger blocks amortize the loads of the indices and vectorize, but store and multiply the
+    zeros inside them: each stored block costs its elements plus index_cost.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The 2-D dense weight.
+    candidates : Sequence[Tuple(int, int)]
+        The block sizes to try, those not dividing the shape of the weight are skipped.
+    index_cost : float
+        The cost of the indices of a block, in multiplications.
+
+    Returns
+    -------
+    block_size : Tuple(int, int)
+        The cheapest block size.
+    """
+    rows, cols = weight.shape
+    best, best_cost = (1, 1), None
+    for bs_r, bs_c in candidates:
+        if rows % bs_r != 0 or cols % bs_c != 0:
+            continue
+        blocks = weight.reshape(rows // bs_r, bs_r, cols // bs_c, bs_c)
+        nnz_blocks = np.count_nonzero(blocks.any(axis=(1, 3)))
+        cost = nnz_blocks * (bs_r * bs_c + index_cost)
+        if best_cost is None or cost < best_cost:
+            best, best_cost = (bs_r, bs_c), cost
+    return best
+
+
 def process_params(expr, params, block_size, sparsity_threshold):
     """[summary]
 
@@ -63,8 +100,8 @@ def process_params(expr, params, block_size, sparsity_threshold):
         Expr of the network
     params : Dict[String, tvm.nd.array]
         parameters of the network
-    block_size : Tuple(int, int)
-        Blocksize in BSR matrix
+    block_size : Optional[Tuple(int, int)]
+        Blocksize in BSR matrix, chosen per weight by :py:func:`select_block_size` when None
     sparsity_threshold : float
         Minimal sparsity requirement for converting to sparse operation
 
@@ -86,7 +123,8 @@ def process_params(expr, params, block_size, sparsity_threshold):
         w_np = params[name].numpy()
         sparsity = 1.0 - (np.count_nonzero(w_np) / w_np.size)
         if sparsity >= sparsity_threshold:
-            sparse_weight = sp.bsr_matrix(w_np, blocksize=block_size)
+            w_block_size = block_size or select_block_size(w_np)
+            sparse_weight = sp.bsr_matrix(w_np, blocksize=w_block_size)
             # remove dense weight
             del params[name]
             memo.weight_name.append(name)
@@ -102,8 +140,8 @@ def process_params(expr, params, block_size, sparsity_threshold):
             prefix = "sparse_dense_bsr_%d_%d_%d_%d_%d_%d_" % (
                 w_np.shape[0],
                 w_np.shape[1],
-                block_size[0],
-                block_size[1],
+                w_block_size[0],
+                w_block_size[1],
                 sparse_weight.indices.shape[0],
                 sparse_weight.indptr.shape[0],
             )
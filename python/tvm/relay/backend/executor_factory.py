@@ -75,6 +75,9 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
     ----------
     target : tvm.Target
         The Target used to build this module.
+    executor_config : str
+        The configuration of the AOT executor of the C++ runtime in json format,
+        empty when the model is built for the C runtime.
     libmod : tvm.Module
         The module of the corresponding function
     libmod_name: str
@@ -85,20 +88,34 @@ class AOTExecutorFactoryModule(ExecutorFactoryModule):
         This holds a map function names to their information
     """
 
-    def __init__(self, ir_mod, target, libmod, libmod_name, params, function_metadata):
+    def __init__(
+        self, ir_mod, target, executor_config, libmod, libmod_name, params, function_metadata
+    ):
         self.ir_mod = ir_mod
         self.target = target
+        self.executor_config = executor_config or None
         self.lib = libmod
         self.libmod_name = libmod_name
         self.params = params
         self.iter_cnt = 0
         self.function_metadata = function_metadata
+        if self.executor_config:
+            fcreate = get_global_func("tvm.aot_executor_factory.create")
+            args = []
+            for k, v in params.items():
+                args.append(k)
+                args.append(ndarray.array(v))
+            self.module = fcreate(self.executor_config, libmod, libmod_name, *args)
+
+    def export_library(self, file_name, fcompile=None, addons=None, **kwargs):
+        assert self.executor_config, "Only the models built for the C++ runtime are exported"
+        return self.module.export_library(file_name, fcompile, addons, **kwargs)
 
     def get_params(self):
         return self.params
 
     def get_executor_config(self):
-        return None
+        return self.executor_config
 
     def get_lib(self):
         return self.lib
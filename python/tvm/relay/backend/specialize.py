@@ -0,0 +1,260 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""
+Specialization of a dynamic-shape model on the input shapes seen at run time.
+
+A model exported with dynamic input shapes runs on the VM with kernels compiled for any shape.
+When the shapes are fixed for a deployment but unknown at export, the SpecializingExecutor
+records the shapes of the first run, specializes the model on them with DynamicToStatic and
+builds it statically in a background thread, then swaps the static executor in for the next runs
+of the same shapes. The static builds can be cached in a directory to be loaded by the next
+processes instead of being rebuilt.
+"""
+import hashlib
+import logging
+import os
+import threading
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.runtime import container
+from tvm.runtime import vm as vm_rt
+from tvm.target import Target
+from . import vm as _vm
+
+logger = logging.getLogger("specialize")
+
+
+def specialize_input_shapes(mod, input_shapes):
+    """Specialize the main function of a module on static input shapes.
+
+    The parameters of main are given the input shapes, then the shapes are propagated by
+    DynamicToStatic, turning the dynamic operators whose shape arguments become constant into
+    static ones.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module.
+
+    input_shapes : dict of str to tuple of int
+        The shape of the inputs, by name. The inputs not given keep their type.
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The specialized module.
+    """
+    func = mod["main"]
+    params = []
+    for param in func.params:
+        name = param.name_hint
+        if name in input_shapes:
+            dtype = param.checked_type.dtype
+            param = relay.var(name, shape=tuple(input_shapes[name]), dtype=dtype)
+        params.append(param)
+    body = relay.bind(func.body, dict(zip(func.params, params)))
+    mod = tvm.IRModule(dict(mod.functions), mod.type_definitions)
+    mod["main"] = relay.Function(params, body, None, func.type_params, func.attrs)
+    seq = tvm.transform.Sequential([relay.transform.InferType(), relay.transform.DynamicToStatic()])
+    with tvm.transform.PassContext(opt_level=3):
+        return seq(mod)
+
+
+class SpecializingExecutor(object):
+    """Run a dynamic-shape model, specialized on the input shapes seen at run time.
+
+    The first run of some input shapes is on the VM executable of the dynamic model, and starts
+    the static build of the model specialized on the shapes. The runs of the shapes after the
+    build use the graph executor of the static model. A specialized model keeping dynamic
+    operators, e.g. of data-dependent output shapes, is compiled for the VM instead.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The dynamic-shape model.
+
+    target : str or :any:`tvm.target.Target`
+        The build target.
+
+    device : :py:class:`~tvm.runtime.Device`
+        The device to run on.
+
+    params : dict of str to NDArray, optional
+        The parameters of the model, bound in it.
+
+    cache_dir : str, optional
+        The directory caching the static builds, loaded instead of being rebuilt when available.
+
+    background : bool
+        Whether to build the specialized models in a background thread. Otherwise the first run
+        of some shapes builds the specialized model and runs it.
+    """
+
+    def __init__(self, mod, target, device, params=None, cache_dir=None, background=True):
+        # pylint: disable=import-outside-toplevel
+        from tvm.relay.build_module import bind_params_by_name
+
+        if params:
+            mod = tvm.IRModule(dict(mod.functions), mod.type_definitions)
+            mod["main"] = bind_params_by_name(mod["main"], params)
+        self.mod = relay.transform.InferType()(mod)
+        self.target = Target(target) if isinstance(target, str) else target
+        self.device = device
+        self.cache_dir = cache_dir
+        self.background = background
+        self.input_names = [param.name_hint for param in self.mod["main"].params]
+
+        self._dynamic = vm_rt.VirtualMachine(_vm.compile(self.mod, self.target), device)
+        self._lock = threading.Lock()
+        self._specialized = {}
+        self._pending = {}
+        self._failed = set()
+        self._mod_hash = None
+
+    @property
+    def specialized_shapes(self):
+        """The input shapes whose specialized models are built, each a tuple of the shapes."""
+        with self._lock:
+            return list(self._specialized.keys())
+
+    def wait(self):
+        """Wait for the specialized models being built."""
+        with self._lock:
+            threads = list(self._pending.values())
+        for thread in threads:
+            thread.join()
+
+    def __call__(self, *args, **kwargs):
+        """Run the model.
+
+        Parameters
+        ----------
+        args : list of NDArray or numpy.ndarray
+            The inputs, in the order of the parameters of main.
+
+        kwargs : dict of str to NDArray or numpy.ndarray
+            The inputs, by name.
+
+        Returns
+        -------
+        result : NDArray or list of NDArray
+            The output, or the outputs of a model returning a tuple.
+        """
+        inputs = dict(zip(self.input_names, args))
+        inputs.update(kwargs)
+        inputs = {
+            name: tvm.nd.array(value, self.device) if isinstance(value, np.ndarray) else value
+            for name, value in inputs.items()
+        }
+        key = tuple(tuple(inputs[name].shape) for name in self.input_names)
+
+        with self._lock:
+            runner = self._specialized.get(key)
+            start = runner is None and key not in self._pending and key not in self._failed
+            if start:
+                thread = threading.Thread(target=self._specialize, args=(key,), daemon=True)
+                self._pending[key] = thread
+                if self.background:
+                    thread.start()
+        if start and not self.background:
+            thread.run()
+            runner = self._specialized.get(key)
+
+        if runner is not None:
+            return runner(inputs)
+        res = self._dynamic.run(*[inputs[name] for name in self.input_names])
+        return list(res) if isinstance(res, container.ADT) else res
+
+    def _specialize(self, key):
+        """Build the model specialized on the input shapes and swap it in."""
+        input_shapes = dict(zip(self.input_names, key))
+        runner = None
+        try:
+            runner = self._load_cached(key)
+            if runner is None:
+                runner = self._build(input_shapes, key)
+        # pylint: disable=broad-except
+        except Exception as err:
+            logger.warning("Cannot specialize on the input shapes %s: %s", input_shapes, err)
+        with self._lock:
+            if runner is None:
+                self._failed.add(key)
+            else:
+                self._specialized[key] = runner
+            del self._pending[key]
+
+    def _build(self, input_shapes, key):
+        """Build the specialized model, with the graph executor if it is fully static."""
+        mod = specialize_input_shapes(self.mod, input_shapes)
+        try:
+            with tvm.transform.PassContext(opt_level=3):
+                lib = relay.build(mod, target=self.target)
+        # pylint: disable=broad-except
+        except Exception:
+            # dynamic operators are left, e.g. of data-dependent output shapes
+            vm = vm_rt.VirtualMachine(_vm.compile(mod, self.target), self.device)
+
+            def _run_vm(inputs):
+                res = vm.run(*[inputs[name] for name in self.input_names])
+                return list(res) if isinstance(res, container.ADT) else res
+
+            return _run_vm
+        path = self._cache_path(key)
+        if path:
+            os.makedirs(self.cache_dir, exist_ok=True)
+            lib.export_library(path)
+        return self._graph_runner(lib)
+
+    def _graph_runner(self, lib):
+        """Make the run function of a static build."""
+        module = graph_executor.GraphModule(lib["default"](self.device))
+        lock = threading.Lock()
+
+        def _run_graph(inputs):
+            with lock:
+                module.set_input(**inputs)
+                module.run()
+                # the outputs of the executor are overwritten by the next run
+                outputs = [
+                    module.get_output(i).copyto(self.device)
+                    for i in range(module.get_num_outputs())
+                ]
+            return outputs[0] if len(outputs) == 1 else outputs
+
+        return _run_graph
+
+    def _load_cached(self, key):
+        """Load the cached static build of the input shapes, if any."""
+        path = self._cache_path(key)
+        if not path or not os.path.isfile(path):
+            return None
+        return self._graph_runner(tvm.runtime.load_module(path))
+
+    def _cache_path(self, key):
+        """The path of the cached static build of the input shapes."""
+        if not self.cache_dir:
+            return None
+        if self._mod_hash is None:
+            self._mod_hash = tvm.ir.structural_hash(self.mod)
+        digest = hashlib.sha256(
+            ("%d|%s|%s" % (self._mod_hash, str(self.target), str(key))).encode()
+        ).hexdigest()
+        return os.path.join(self.cache_dir, "specialized_%s.so" % digest[:32])
@@ -32,7 +32,7 @@ from tvm.target import Target
 from . import _vm
 
 
-def compile(mod, target=None, target_host=None, params=None):
+def compile(mod, target=None, target_host=None, params=None, shape_buckets=None):
     """Compile the module to VM executable. A helper function for VMCompiler.
 
     Parameters
@@ -58,6 +58,12 @@ def compile(mod, target=None, target_host=None, params=None):
         Input parameters to the graph that do not change
         during inference time. Used for constant folding.
 
+    shape_buckets : tuple of (dict of str to int, list of int), optional
+        The inputs to bucket, mapped to their dynamic dimension, and the upper bounds of the
+        buckets. Main is compiled once per bucket for the static extent of the bucket, and the
+        inputs are padded to the bucket their extent falls in at run time.
+        See :py:meth:`VMCompiler.set_shape_buckets`.
+
     Returns
     -------
     exec : tvm.runtime.vm.Executable
@@ -69,6 +75,8 @@ def compile(mod, target=None, target_host=None, params=None):
     compiler = VMCompiler()
     if params:
         compiler.set_params(params)
+    if shape_buckets:
+        compiler.set_shape_buckets(*shape_buckets)
     compiler.lower(mod, target)
     compiler.codegen()
     return compiler.get_exec()
@@ -83,6 +91,7 @@ class VMCompiler(object):
         self._codegen = self.mod["codegen"]
         self._get_exec = self.mod["get_executable"]
         self._set_params_func = self.mod["set_params"]
+        self._set_shape_buckets = self.mod["set_shape_buckets"]
         self._get_params_func = self.mod["get_params"]
         self._optimize = self.mod["optimize"]
 
@@ -102,6 +111,33 @@ class VMCompiler(object):
             inputs[name] = _expr.const(param)
         self._set_params_func(inputs)
 
+    def set_shape_buckets(self, inputs, buckets, pad_value=0.0):
+        """Compile main specialized for buckets of the extent of a dynamic input dimension.
+
+        The kernels of the inputs with an ``Any`` dimension are compiled for any extent, which
+        leaves their loops unspecialized. Instead main is compiled once per bucket, with the
+        dimension typed as the bucket upper bound, and dispatches on the extent at run time:
+        the inputs are padded to the smallest bucket the extent fits in, and the output
+        dimensions of the bucket extent are sliced back. The extents beyond the last bucket
+        run the generic kernels.
+
+        The padding is only valid for the models whose outputs at the valid positions do not
+        depend on it, e.g. the models taking an attention mask bucketed along with the tokens.
+
+        Parameters
+        ----------
+        inputs : dict of str to int
+            The names of the inputs to bucket, mapped to their dynamic dimension. Every input is
+            padded to the bucket of the largest extent among them.
+
+        buckets : list of int
+            The upper bounds of the buckets, e.g. ``[32, 64, 128, 256]``.
+
+        pad_value : float
+            The value the inputs are padded with.
+        """
+        self._set_shape_buckets(inputs, buckets, pad_value)
+
     def get_params(self):
         """Return the updated weights."""
         params = self._get_params_func()
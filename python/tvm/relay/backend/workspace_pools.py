@@ -0,0 +1,47 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Memory pools in which the AOT executor places its buffers at compile time."""
+import tvm._ffi
+from tvm.runtime import Object
+from . import _backend
+
+
+@tvm._ffi.register_object("relay.backend.PoolInfo")
+class PoolInfo(Object):
+    """A memory region of the device for the AOT executor.
+
+    The pools are given to tvm.relay.build with the PassContext option
+    "relay.backend.workspace_pools". The intermediate tensors and the operator
+    workspaces are placed in them at compile time, the cheapest pools first, so
+    that the generated code allocates no memory at run time. The application
+    passes the memory of each pool to tvm_runtime_run_with_pools, in the order of
+    their declaration, aligned to the workspace byte alignment of the target.
+
+    Parameters
+    ----------
+    pool_name : str
+        The name of the pool, e.g. "sram", a valid C identifier.
+
+    size_bytes : int
+        The size of the pool in bytes.
+
+    access_cost : int
+        The relative cost of an access to the pool.
+    """
+
+    def __init__(self, pool_name, size_bytes, access_cost=0):
+        self.__init_handle_by_constructor__(_backend.PoolInfo, pool_name, size_bytes, access_cost)
@@ -175,7 +175,8 @@ class BuildModule(object):
         # Get artifacts
         mod = self.get_module()
         params = self.get_params()
-        executor_config = self.get_graph_json() if executor == "graph" else None
+        # The AOT executor of the C++ runtime is configured as well, the C runtime is not
+        executor_config = self.get_graph_json() if executor in ("graph", "aot") else None
 
         return executor_config, mod, params
 
@@ -361,7 +362,7 @@ def build(ir_mod, target=None, target_host=None, params=None, mod_name="default"
 
         if executor == "aot":
             executor_factory = _executor_factory.AOTExecutorFactoryModule(
-                ir_mod, target, runtime_mod, mod_name, params, func_metadata
+                ir_mod, target, executor_config, runtime_mod, mod_name, params, func_metadata
             )
         elif executor == "graph":
             executor_factory = _executor_factory.GraphExecutorFactoryModule(
@@ -32,8 +32,9 @@ def convert(func, params, blocksize, sparsity_threshold):
         Expr will be optimized to sparse operation
     params : Dict[Srting, tvm.nd.array]
         Parameters of the Expr
-    blocksize : Tuple(int, int)
-        Blocksize for BSR matrix
+    blocksize : Optional[Tuple(int, int)]
+        Blocksize for BSR matrix. When None, the block size is chosen per weight by
+        :py:func:`tvm.relay.analysis.sparse_dense.select_block_size`.
     sparsity_threshold : float
         Minimal sparsity requirement for converting.
         If weight sparsity is lower than this threshold,
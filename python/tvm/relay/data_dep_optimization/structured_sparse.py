@@ -0,0 +1,151 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Prune dense weights to 2:4 structured sparsity, and compress them for the sparse tensor cores
+
+In a 2:4 sparse weight each group of four consecutive elements of a row has at most two
+nonzeros. The compressed weight keeps two values per group, and the metadata holds their
+2-bit column indices in the group, the layout of the operand A of the PTX mma.sp
+instructions (tir.ptx_mma_sp).
+"""
+import numpy as np
+
+import tvm
+from tvm.relay.analysis.sparse_dense import _search_dense_op_weight
+
+
+def _groups(weight):
+    rows, cols = weight.shape
+    assert cols % 4 == 0, "The rows of a 2:4 weight must have a multiple of four elements"
+    return weight.reshape(rows, cols // 4, 4)
+
+
+def is_2_4_sparse(weight):
+    """Whether each group of four consecutive elements of the rows has at most two nonzeros.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The 2-D weight.
+
+    Returns
+    -------
+    ret : bool
+    """
+    return bool(np.all(np.count_nonzero(_groups(weight), axis=2) <= 2))
+
+
+def prune_2_4(weight):
+    """Keep the two elements of largest magnitude of each group of four.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The 2-D weight.
+
+    Returns
+    -------
+    pruned : numpy.ndarray
+        The 2:4 sparse weight.
+    """
+    groups = _groups(weight)
+    smallest = np.argsort(np.abs(groups), axis=2, kind="stable")[:, :, :2]
+    pruned = groups.copy()
+    np.put_along_axis(pruned, smallest, 0, axis=2)
+    return pruned.reshape(weight.shape)
+
+
+def compress_2_4(weight):
+    """Compress a 2:4 sparse weight into its values and metadata.
+
+    Parameters
+    ----------
+    weight : numpy.ndarray
+        The 2-D 2:4 sparse weight of shape (rows, cols), cols a multiple of 16.
+
+    Returns
+    -------
+    values : numpy.ndarray
+        The kept values, of shape (rows, cols // 2), the two of each group in column order.
+        The groups with less than two nonzeros keep zeros.
+
+    metadata : numpy.ndarray
+        The uint16 metadata of shape (rows, cols // 16). Group g of a row has its two indices in
+        the bits 4 * (g % 4) to 4 * (g % 4) + 3 of element g // 4, the first index in the low
+        bits.
+    """
+    assert is_2_4_sparse(weight), "The weight is not 2:4 sparse"
+    rows, cols = weight.shape
+    assert cols % 16 == 0, "The rows of the weight must have a multiple of 16 elements"
+    groups = _groups(weight)
+    # Order the nonzeros first, in column order: the kept indices are sorted and distinct.
+    order = np.argsort(groups == 0, axis=2, kind="stable")[:, :, :2]
+    indices = np.sort(order, axis=2)
+    values = np.take_along_axis(groups, indices, axis=2).reshape(rows, cols // 2)
+    nibbles = (indices[:, :, 0] | (indices[:, :, 1] << 2)).astype("uint16")
+    nibbles = nibbles.reshape(rows, cols // 16, 4)
+    shifts = np.arange(4, dtype="uint16") * 4
+    metadata = np.bitwise_or.reduce(nibbles << shifts, axis=2).astype("uint16")
+    return values, metadata
+
+
+def decompress_2_4(values, metadata):
+    """The dense weight of the values and metadata of :py:func:`compress_2_4`."""
+    rows, half = values.shape
+    shifts = np.arange(4, dtype="uint16") * 4
+    nibbles = ((metadata[:, :, None] >> shifts) & 0xF).reshape(rows, half // 2)
+    indices = np.stack([nibbles & 0x3, nibbles >> 2], axis=2).astype("int64")
+    groups = np.zeros((rows, half // 2, 4), dtype=values.dtype)
+    np.put_along_axis(groups, indices, values.reshape(rows, half // 2, 2), axis=2)
+    return groups.reshape(rows, half * 2)
+
+
+def prune(func, params, prune_dense=False, min_size=4096):
+    """Find the weights of nn.dense that are 2:4 sparse, and optionally prune the others.
+
+    Parameters
+    ----------
+    func : relay.Expr
+        Expr with the dense operations.
+    params : Dict[String, tvm.nd.array]
+        Parameters of Expr.
+    prune_dense : bool
+        Prune the weights that are not 2:4 sparse, keeping the two elements of largest
+        magnitude of each group of four. This changes the results of the network.
+    min_size : int
+        The weights with fewer elements are left alone.
+
+    Returns
+    -------
+    params : Dict[String, tvm.nd.array]
+        The parameters with the pruned weights.
+    sparse_weights : List[String]
+        The names of the 2:4 sparse weights, whose rows are a multiple of 16 elements.
+    """
+    sparse_weights = []
+    for name in _search_dense_op_weight(func):
+        name = str(name)
+        if name not in params:
+            continue
+        w_np = params[name].numpy()
+        if w_np.ndim != 2 or w_np.size < min_size or w_np.shape[1] % 16 != 0:
+            continue
+        if not is_2_4_sparse(w_np):
+            if not prune_dense:
+                continue
+            params[name] = tvm.nd.array(prune_2_4(w_np))
+        sparse_weights.append(name)
+    return params, sparse_weights
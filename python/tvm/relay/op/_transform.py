@@ -80,7 +80,7 @@ def compute_strided_set(attrs, inputs, output_type):
 _reg.register_injective_schedule("strided_set")
 
 # layout_transform
-_reg.register_injective_schedule("layout_transform")
+_reg.register_schedule("layout_transform", strategy.schedule_layout_transform)
 _reg.register_pattern("layout_transform", OpPattern.INJECTIVE)
 _reg.register_injective_schedule("auto_scheduler_layout_transform")
 _reg.register_pattern("auto_scheduler_layout_transform", OpPattern.INJECTIVE)
@@ -178,6 +178,12 @@ def compute_unique(attrs, inputs, output_type):
 
 _reg.register_strategy("unique", strategy.unique_strategy)
 
+# embedding_bag
+_reg.register_strategy("embedding_bag", strategy.embedding_bag_strategy)
+
+# einsum
+_reg.register_injective_schedule("einsum")
+
 # invert_permutation
 _reg.register_strategy("invert_permutation", strategy.invert_permutation_strategy)
 _reg.register_shape_func("invert_permutation", False, elemwise_shape_func)
@@ -500,6 +506,25 @@ def legalize_dyn_topk(attrs, inputs, types):
     return topi.take_legalize(attrs, inputs, types)
 
 
+@_reg.register_legalize("einsum")
+def legalize_einsum(attrs, inputs, types):
+    """Legalize einsum op.
+    Parameters
+    ----------
+    attrs : tvm.ir.Attrs
+        Attributes of current op
+    inputs : list of tvm.relay.Expr
+        The args of the Relay expr to be legalized
+    types : list of types
+        List of input and output types
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The legalized expr
+    """
+    return topi.einsum_legalize(attrs, inputs, types)
+
+
 @script
 def _argwhere_shape_func_1d(condition):
     out = output_tensor((2,), "int64")
@@ -1125,6 +1150,22 @@ def _unique_with_counts_shape(data_shape):
     return (unique_shape, indices_shape, inverse_indices_shape, num_unique_shape, counts_shape)
 
 
+@script
+def _embedding_bag_shape_func(weight_shape, offsets_shape):
+    out = output_tensor((2,), "int64")
+    out[0] = offsets_shape[0]
+    out[1] = weight_shape[1]
+    return out
+
+
+@_reg.register_shape_func("embedding_bag", False)
+def embedding_bag_shape_func(attrs, inputs, _):
+    """
+    Shape func for embedding_bag operator.
+    """
+    return [_embedding_bag_shape_func(inputs[0], inputs[2])]
+
+
 @_reg.register_shape_func("unique", False)
 def unique_shape_func(attrs, inputs, _):
     """
@@ -0,0 +1,237 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument
+"""CMSIS-NN supported operators.
+
+The int8 operators of the microTVM models (convolution, depthwise convolution,
+fully connected and pooling) are offloaded to calls of the CMSIS-NN kernels,
+which use the DSP (SMLAD) or the MVE (Helium) instructions of the Cortex-M cores.
+"""
+import numpy as np
+
+import tvm
+from tvm.relay import transform
+from tvm.relay.build_module import bind_params_by_name
+
+from ...dataflow_pattern import is_constant, is_op, wildcard
+from .register import register_pattern_table
+
+
+def enabled():
+    """Check if the CMSIS-NN codegen is built in TVM.
+
+    Returns
+    -------
+    ret: bool
+        True if present, False if not.
+    """
+    return tvm.get_global_func("relay.ext.cmsisnn", True) is not None
+
+
+def partition_for_cmsisnn(mod, params=None, **opts):
+    """Partition the graph offloading the supported operators to CMSIS-NN.
+
+    Each supported operator is partitioned in its own function, so that the
+    memory planner of the executor places the tensors between the kernels.
+
+    Parameters
+    ----------
+    mod : Module
+        The module to run passes on.
+    params : Optional[Dict[str, NDArray]]
+        Constant input parameters.
+
+    Returns
+    -------
+    ret : annotated and partitioned module.
+    """
+    if params:
+        mod["main"] = bind_params_by_name(mod["main"], params)
+
+    seq = tvm.transform.Sequential(
+        [
+            transform.InferType(),
+            transform.MergeComposite(pattern_table()),
+            transform.AnnotateTarget("cmsisnn"),
+            transform.PartitionGraph(),
+        ]
+    )
+
+    return seq(mod)
+
+
+def _is_int8(expr):
+    return expr.checked_type.dtype == "int8"
+
+
+def _is_zero(expr):
+    return np.all(expr.data.numpy() == 0)
+
+
+def _check_pool(pool, data):
+    """The pooling kernels take one NHWC image, without the ceil mode and the dilation."""
+    attrs = pool.attrs
+    if attrs.layout != "NHWC" or attrs.ceil_mode or int(data.checked_type.shape[0]) != 1:
+        return False
+    return all(int(d) == 1 for d in attrs.dilation)
+
+
+def _find_call(extract, op_name):
+    call = extract
+    while call.op.name != op_name:
+        call = call.args[0]
+    return call
+
+
+def _check_activation(extract):
+    """The clip following a kernel is fused as its activation range."""
+    if extract.op.name != "clip":
+        return True
+    return extract.attrs.a_min >= -128 and extract.attrs.a_max <= 127
+
+
+def _check_pad(conv):
+    """A pad of the height and the width with the zero point is folded in the kernel."""
+    pad = conv.args[0]
+    if not isinstance(pad, tvm.relay.Call) or pad.op.name != "nn.pad":
+        return True
+    pad_width = [[int(p) for p in axis] for axis in pad.attrs.pad_width]
+    if pad.attrs.pad_mode != "constant" or pad_width[0] != [0, 0] or pad_width[3] != [0, 0]:
+        return False
+    if not isinstance(pad.args[1], tvm.relay.Constant):
+        return False
+    return int(pad.args[1].data.numpy()) == int(conv.args[2].data.numpy())
+
+
+@register_pattern_table("cmsisnn")
+def pattern_table():
+    """Get the CMSIS-NN pattern table."""
+
+    def qnn_conv2d_pattern():
+        """Create a quantized convolution (or depthwise convolution) pattern.
+
+        Returns
+        -------
+        pattern : dataflow_pattern.AltPattern
+            Denotes the convolution pattern.
+        """
+        pattern = is_op("nn.pad")(wildcard(), is_constant()) | wildcard()
+        pattern = is_op("qnn.conv2d")(
+            pattern, is_constant(), is_constant(), is_constant(), is_constant(), is_constant()
+        )
+        pattern = pattern.optional(lambda x: is_op("nn.bias_add")(x, is_constant()))
+        pattern = is_op("qnn.requantize")(
+            pattern, is_constant(), is_constant(), is_constant(), is_constant()
+        )
+        pattern = pattern.optional(is_op("clip"))
+        return pattern
+
+    def qnn_fully_connected_pattern():
+        """Create a quantized fully connected pattern.
+
+        Returns
+        -------
+        pattern : dataflow_pattern.AltPattern
+            Denotes the fully connected pattern.
+        """
+        pattern = is_op("qnn.dense")(
+            wildcard(), is_constant(), is_constant(), is_constant(), is_constant(), is_constant()
+        )
+        pattern = pattern.optional(lambda x: is_op("nn.bias_add")(x, is_constant()))
+        pattern = is_op("qnn.requantize")(
+            pattern, is_constant(), is_constant(), is_constant(), is_constant()
+        )
+        pattern = pattern.optional(is_op("clip"))
+        return pattern
+
+    def qnn_max_pool2d_pattern():
+        """Create an int8 max pooling pattern."""
+        pattern = is_op("nn.max_pool2d")(wildcard())
+        pattern = pattern.optional(is_op("clip"))
+        return pattern
+
+    def qnn_avg_pool2d_pattern():
+        """Create an int8 average pooling pattern, computed in int32 in Relay."""
+        pattern = is_op("cast")(wildcard())
+        pattern = is_op("nn.avg_pool2d")(pattern)
+        pattern = is_op("cast")(pattern)
+        pattern = pattern.optional(is_op("clip"))
+        return pattern
+
+    def check_qnn_conv2d(extract):
+        """Check the quantized convolution is supported by CMSIS-NN."""
+        if not _check_activation(extract):
+            return False
+        requantize = _find_call(extract, "qnn.requantize")
+        conv = _find_call(requantize, "qnn.conv2d")
+        attrs = conv.attrs
+        if requantize.attrs.out_dtype != "int8" or not _is_zero(requantize.args[2]):
+            return False
+        if not _is_int8(conv.args[0]) or not _is_int8(conv.args[1]):
+            return False
+        if attrs.data_layout != "NHWC" or not _is_zero(conv.args[3]):
+            return False
+        in_channels = int(conv.args[0].checked_type.shape[3])
+        if attrs.groups == 1:
+            if attrs.kernel_layout not in ["HWIO", "OHWI"]:
+                return False
+        elif attrs.groups != in_channels or attrs.kernel_layout != "HWOI":
+            return False
+        return _check_pad(conv)
+
+    def check_qnn_fully_connected(extract):
+        """Check the quantized fully connected is supported by CMSIS-NN."""
+        if not _check_activation(extract):
+            return False
+        requantize = _find_call(extract, "qnn.requantize")
+        dense = _find_call(requantize, "qnn.dense")
+        if requantize.attrs.out_dtype != "int8" or not _is_zero(requantize.args[2]):
+            return False
+        # The kernel only takes one scale for all the output channels.
+        if len(requantize.args[1].data.shape) != 0 or not _is_zero(dense.args[3]):
+            return False
+        return _is_int8(dense.args[0]) and _is_int8(dense.args[1])
+
+    def check_qnn_max_pool2d(extract):
+        """Check the int8 max pooling is supported by CMSIS-NN."""
+        if not _check_activation(extract):
+            return False
+        pool = _find_call(extract, "nn.max_pool2d")
+        return _is_int8(pool.args[0]) and _check_pool(pool, pool.args[0])
+
+    def check_qnn_avg_pool2d(extract):
+        """Check the int8 average pooling is supported by CMSIS-NN."""
+        if not _check_activation(extract):
+            return False
+        cast = _find_call(extract, "cast")
+        pool = cast.args[0]
+        attrs = pool.attrs
+        if cast.attrs.dtype != "int8" or not _is_int8(pool.args[0].args[0]):
+            return False
+        if pool.args[0].attrs.dtype != "int32":
+            return False
+        # The kernel only averages the elements inside of the input.
+        if attrs.count_include_pad and any(int(p) != 0 for p in attrs.padding):
+            return False
+        return _check_pool(pool, pool.args[0].args[0])
+
+    return [
+        ("cmsisnn.qnn_conv2d", qnn_conv2d_pattern(), check_qnn_conv2d),
+        ("cmsisnn.qnn_fully_connected", qnn_fully_connected_pattern(), check_qnn_fully_connected),
+        ("cmsisnn.qnn_max_pool2d", qnn_max_pool2d_pattern(), check_qnn_max_pool2d),
+        ("cmsisnn.qnn_avg_pool2d", qnn_avg_pool2d_pattern(), check_qnn_avg_pool2d),
+    ]
@@ -33,6 +33,7 @@ it is supported. For example:
 check the attributes of the op and decide if it should be offloaded to DNNL.
 """
 import tvm.ir
+from tvm import relay
 from ...dataflow_pattern import wildcard, is_op
 from .register import register_pattern_table
 
@@ -86,3 +87,90 @@ def pattern_table():
     conv2d_relu_pat = ("dnnl.conv2d_relu", make_pattern(with_bias=False))
     dnnl_patterns = [conv2d_bias_relu_pat, conv2d_relu_pat]
     return dnnl_patterns
+
+
+def _dnnl_function(mod, expr):
+    """The DNNL partitioned function called by expr, None for the other expressions."""
+    if not isinstance(expr, relay.Call) or not isinstance(expr.op, relay.GlobalVar):
+        return None
+    func = mod[expr.op]
+    if func.attrs is None or func.attrs.get("Compiler") != "dnnl":
+        return None
+    return func
+
+
+def propagate_blocked_layouts(mod):
+    """Let the DNNL partitions of main exchange the tensors in the blocked layouts of DNNL.
+
+    The outputs of a DNNL partition are reordered to the plain layout of TVM, and the inputs
+    of the next partition reordered back. For the outputs read only by other DNNL partitions
+    both reorders are skipped: the producer writes the blocked layout and the consumer reads
+    it, when the blocked tensor fits in the buffer of the plain one. The outputs of main and
+    the outputs read by other ops keep the plain layout.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The partitioned module.
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The module with the partitions marked by the dnnl_blocked_outputs and
+        dnnl_blocked_inputs attributes.
+    """
+    main = mod["main"]
+    # The (producer call, output index) of each value, and the readers of each value.
+    readers = {}
+    plain = set()
+
+    def output_of(expr):
+        if isinstance(expr, relay.TupleGetItem) and _dnnl_function(mod, expr.tuple):
+            return (expr.tuple, expr.index)
+        if _dnnl_function(mod, expr) and not isinstance(expr.checked_type, relay.TupleType):
+            return (expr, 0)
+        return None
+
+    def visit(expr):
+        if isinstance(expr, relay.Call):
+            consumer = expr if _dnnl_function(mod, expr) else None
+            for i, arg in enumerate(expr.args):
+                out = output_of(arg)
+                if out is None:
+                    continue
+                if consumer is None:
+                    plain.add(out)
+                else:
+                    readers.setdefault(out, []).append((consumer, i))
+        elif isinstance(expr, relay.Tuple):
+            for field in expr.fields:
+                out = output_of(field)
+                if out is not None:
+                    plain.add(out)
+
+    relay.analysis.post_order_visit(main.body, visit)
+    fields = main.body.fields if isinstance(main.body, relay.Tuple) else [main.body]
+    for field in fields:
+        out = output_of(field)
+        if out is not None:
+            plain.add(out)
+
+    blocked_outputs = {}
+    blocked_inputs = {}
+    for (producer, index), consumers in readers.items():
+        if (producer, index) in plain:
+            continue
+        blocked_outputs.setdefault(producer.op, set()).add(index)
+        for consumer, arg_index in consumers:
+            blocked_inputs.setdefault(consumer.op, set()).add(arg_index)
+
+    for gvar in set(blocked_outputs) | set(blocked_inputs):
+        func = mod[gvar]
+        if gvar in blocked_outputs:
+            outputs = sorted(blocked_outputs[gvar])
+            func = func.with_attr("dnnl_blocked_outputs", tvm.runtime.convert(outputs))
+        if gvar in blocked_inputs:
+            inputs = sorted(blocked_inputs[gvar])
+            func = func.with_attr("dnnl_blocked_inputs", tvm.runtime.convert(inputs))
+        mod[gvar] = func
+    return mod
@@ -85,6 +85,9 @@ def partition_for_tensorrt(
     use_implicit_batch=True,
     remove_no_mac_subgraphs=False,
     max_workspace_size=1 << 30,
+    optimization_profiles=None,
+    use_int8=False,
+    int8_calibration_dir=None,
 ):
     """Partition the graph greedily offloading supported operators to TensorRT.
 
@@ -108,6 +111,21 @@ def partition_for_tensorrt(
     max_workspace_size : Optional[int]
         How many bytes of workspace size to allow each subgraph to use for TensorRT engine creation.
         See TensorRT documentation for more info.
+    optimization_profiles : Optional[Dict[str, Tuple[Tuple[int], Tuple[int], Tuple[int]]]]
+        The (min, opt, max) shapes of inputs of main, usually with a dynamic batch dimension. Each
+        subgraph then builds a single engine serving all the shapes within these ranges, in the
+        background when the module is loaded, instead of an engine per batch size. The inputs of
+        the subgraphs computed from the inputs of main with a dynamic batch dimension get the batch
+        range of the profiles. Requires use_implicit_batch=False.
+    use_int8 : Optional[bool]
+        Build INT8 engines. The engines are calibrated on the inputs of the first runs of each
+        subgraph, TVM_TENSORRT_CALIBRATION_BATCHES of them (default 1), and run in the precision
+        of TVM_TENSORRT_USE_FP16 until then. With TVM_TENSORRT_CACHE_DIR set, the calibration
+        tables are saved there as "<subgraph>_int8.calib" and loaded by the next runtimes.
+    int8_calibration_dir : Optional[str]
+        The directory of the calibration tables of an offline calibration, e.g. the
+        TVM_TENSORRT_CACHE_DIR of a calibration run, embedded in the module so the subgraphs are
+        not calibrated at runtime. Requires use_int8=True.
     Returns
     -------
     mod_and_config : Tuple[Module, Dict[str, Any]]
@@ -131,6 +149,14 @@ def partition_for_tensorrt(
             )
             linked_version = (6, 0, 1)
         config["tensorrt_version"] = linked_version
+    if optimization_profiles and use_implicit_batch:
+        raise ValueError("The optimization profiles need use_implicit_batch=False.")
+    if int8_calibration_dir and not use_int8:
+        raise ValueError("The calibration tables need use_int8=True.")
+    if use_int8:
+        config["use_int8"] = True
+        if int8_calibration_dir:
+            config["int8_calibration_dir"] = int8_calibration_dir
 
     if params:
         mod["main"] = bind_params_by_name(mod["main"], params)
@@ -156,6 +182,8 @@ def partition_for_tensorrt(
     with tvm.transform.PassContext(opt_level=3, config={"relay.ext.tensorrt.options": config}):
         mod = seq(mod)
         mod = prune_tensorrt_subgraphs(mod)
+    if optimization_profiles:
+        config["optimization_profiles"] = get_subgraph_profiles(mod, optimization_profiles)
     return mod, config
 
 
@@ -1024,6 +1052,47 @@ def prune_tensorrt_subgraphs(mod):
     return new_mod
 
 
+def get_subgraph_profiles(mod, optimization_profiles):
+    """
+    Map the (min, opt, max) shapes of the inputs of main to the inputs of the TensorRT subgraphs.
+    The inputs of main passed to a subgraph keep their profile, the other inputs of the subgraphs
+    with a dynamic batch dimension get the batch range of all the profiles.
+    """
+    for name, shapes in optimization_profiles.items():
+        if len(shapes) != 3 or len({len(shape) for shape in shapes}) != 1:
+            raise ValueError("The profile of %s must be 3 shapes of the same rank." % name)
+    batch_range = (
+        min(shapes[0][0] for shapes in optimization_profiles.values()),
+        max(shapes[1][0] for shapes in optimization_profiles.values()),
+        max(shapes[2][0] for shapes in optimization_profiles.values()),
+    )
+    subgraph_profiles = {}
+
+    class ProfileMapper(ExprVisitor):
+        """Visits the calls of the TensorRT subgraphs in main."""
+
+        def visit_call(self, call):
+            if isinstance(call.op, GlobalVar):
+                func = mod[call.op]
+                if func.attrs and func.attrs["Compiler"] == "tensorrt":
+                    for param, arg in zip(func.params, call.args):
+                        shape = param.checked_type.shape
+                        if isinstance(arg, Var) and arg.name_hint in optimization_profiles:
+                            profile = optimization_profiles[arg.name_hint]
+                        elif len(shape) > 0 and isinstance(shape[0], tvm.tir.expr.Any):
+                            rest = [int(dim) for dim in shape[1:]]
+                            profile = [[dim] + rest for dim in batch_range]
+                        else:
+                            continue
+                        subgraph_profiles[param.name_hint] = [
+                            [int(dim) for dim in dims] for dims in profile
+                        ]
+            super().visit_call(call)
+
+    ProfileMapper().visit(mod["main"])
+    return subgraph_profiles
+
+
 class RemoveDropout(ExprMutator):
     """
     Removes all nn.dropout from an expr.
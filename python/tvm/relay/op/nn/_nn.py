@@ -608,6 +608,11 @@ reg.register_schedule("nn.lrn", strategy.schedule_lrn)
 reg.register_pattern("nn.lrn", OpPattern.OPAQUE)
 
 
+# layer_norm and rms_norm
+reg.register_schedule("nn.layer_norm", strategy.schedule_layer_norm)
+reg.register_schedule("nn.rms_norm", strategy.schedule_layer_norm)
+
+
 # upsampling
 @reg.register_compute("nn.upsampling")
 def compute_upsampling(attrs, inputs, out_dtype):
@@ -948,6 +953,11 @@ reg.register_injective_schedule("nn.space_to_depth")
 reg.register_pattern("nn.space_to_depth", OpPattern.INJECTIVE)
 
 
+# attention
+reg.register_strategy("nn.attention", strategy.attention_strategy)
+reg.register_pattern("nn.attention", OpPattern.OPAQUE)
+
+
 # correlation
 reg.register_strategy("nn.correlation", strategy.correlation_strategy)
 reg.register_pattern("nn.correlation", OpPattern.OUT_ELEMWISE_FUSABLE)
@@ -2075,6 +2075,43 @@ def layer_norm(data, gamma, beta, axis=-1, epsilon=1e-5, center=True, scale=True
     return _make.layer_norm(data, gamma, beta, axis, epsilon, center, scale)
 
 
+def rms_norm(data, gamma, axis=-1, epsilon=1e-5, scale=True):
+    r"""
+    Root mean square normalization, which scales the input by the reciprocal of its
+    root mean square over an axis, without centering it.
+
+    .. math::
+
+        out = \frac{data}{\sqrt{mean(data^2, axis)+\epsilon}} * gamma
+
+    Unlike batch normalization, the mean square is computed over the axis of each
+    example, and the statistics are the same in training and inference.
+
+    Parameters
+    ----------
+    data : tvm.relay.Expr
+        Input to which rms_norm will be applied.
+
+    gamma : tvm.relay.Expr
+        The gamma scale factor.
+
+    axis : int, optional, default=-1
+        The axis that should be normalized, typically the axis of the channels.
+
+    epsilon : double, optional, default=1e-5
+        Small float added to the mean square to avoid dividing by zero.
+
+    scale : boolean, optional, default=True
+        If True, multiply by gamma. If False, gamma is not used.
+
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The normalized data.
+    """
+    return _make.rms_norm(data, gamma, axis, epsilon, scale)
+
+
 def group_norm(data, gamma, beta, num_groups, axis=1, epsilon=1e-5, center=True, scale=True):
     r"""
     Group normalization normalizes over group of channels for each training examples.
@@ -2165,6 +2202,50 @@ def batch_matmul(x, y, out_dtype=""):
     return _make.batch_matmul(x, y, out_dtype)
 
 
+def attention(query, key, value, valid_length=None, scale=None, causal=False):
+    r"""
+    Computes the scaled dot-product attention of the queries over the keys.
+
+    .. math::
+
+        \mbox{attention}(q, k, v)[b, :, :] = \mbox{softmax}(
+            \mbox{scale} \cdot q[b, :, :] k[b, :, :]^T + \mbox{mask}[b]) v[b, :, :]
+
+    The scores are computed a tile of keys at a time with an online softmax, so that the
+    (q_seq, kv_seq) score matrix is never stored.
+
+    Parameters
+    ----------
+    query : tvm.relay.Expr
+        The queries, of shape (batch, q_seq, dim).
+
+    key : tvm.relay.Expr
+        The keys, of shape (batch, kv_seq, dim).
+
+    value : tvm.relay.Expr
+        The values, of shape (batch, kv_seq, value_dim).
+
+    valid_length : tvm.relay.Expr, optional
+        The number of valid keys of each batch, of shape (batch,), or a scalar for all the
+        batches. The keys from the valid length on are masked. All the keys are valid if None.
+
+    scale : float, optional
+        The scale of the scores before the softmax, 1 / sqrt(dim) if None.
+
+    causal : bool, optional
+        Whether a query only attends to the keys up to its position, the last query being
+        aligned with the last key.
+
+    Returns
+    -------
+    result: tvm.relay.Expr
+        The computed result, of shape (batch, q_seq, value_dim).
+    """
+    if valid_length is None:
+        valid_length = const(2 ** 31 - 1, "int32")
+    return _make.attention(query, key, value, valid_length, 0.0 if scale is None else scale, causal)
+
+
 # pylint: disable=no-else-return,inconsistent-return-statements
 def sparse_dense(dense_mat, sparse_mat, sparse_lhs=False):
     r"""
@@ -224,6 +224,16 @@ class TakeAttrs(Attrs):
     """Attributes for transform.take"""
 
 
+@tvm._ffi.register_object("relay.attrs.EmbeddingBagAttrs")
+class EmbeddingBagAttrs(Attrs):
+    """Attributes for transform.embedding_bag"""
+
+
+@tvm._ffi.register_object("relay.attrs.EinsumAttrs")
+class EinsumAttrs(Attrs):
+    """Attributes for transform.einsum"""
+
+
 @tvm._ffi.register_object("relay.attrs.InitOpAttrs")
 class InitOpAttrs(Attrs):
     """Attributes for ops specifying a tensor"""
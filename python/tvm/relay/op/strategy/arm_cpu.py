@@ -143,6 +143,15 @@ def conv2d_strategy_arm_cpu(attrs, inputs, out_type, target):
                         wrap_topi_schedule(topi.arm_cpu.schedule_conv2d_NHWC_quantized_native),
                         name="conv2d_NHWC_quantized_native.arm_cpu",
                     )
+                if has_dot_prod and data.dtype == "int8" and kernel.dtype == "int8":
+                    # Computes the patches on the fly instead of materializing im2col, picked
+                    # over the native GEMM once tuned faster.
+                    strategy.add_implementation(
+                        wrap_compute_conv2d(topi.arm_cpu.conv2d_nhwc_implicit_gemm_dotprod),
+                        wrap_topi_schedule(topi.arm_cpu.schedule_conv2d_nhwc_implicit_gemm_dotprod),
+                        name="conv2d_nhwc_implicit_gemm_dotprod.arm_cpu",
+                        plevel=5,
+                    )
                 if is_aarch64 and data.dtype in ["int8", "uint8"]:
                     strategy.add_implementation(
                         wrap_compute_conv2d(topi.arm_cpu.compute_conv2d_NHWC_quantized_interleaved),
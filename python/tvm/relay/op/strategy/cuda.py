@@ -127,6 +127,13 @@ def schedule_lrn_cuda(attrs, outs, target):
         return topi.cuda.schedule_lrn(outs)
 
 
+@schedule_layer_norm.register(["cuda", "gpu"])
+def schedule_layer_norm_cuda(attrs, outs, target):
+    """schedule layer_norm and rms_norm for cuda"""
+    with target:
+        return topi.cuda.schedule_layer_norm(outs)
+
+
 @conv2d_strategy.register(["cuda", "gpu"])
 def conv2d_strategy_cuda(attrs, inputs, out_type, target):
     """conv2d cuda strategy"""
@@ -242,6 +249,19 @@ def conv2d_strategy_cuda(attrs, inputs, out_type, target):
                     name="conv2d_nhwc_tensorcore.cuda",
                     plevel=20,
                 )
+            if (
+                target.kind.name == "cuda"
+                and nvcc.have_tensorcore(target=target)
+                and topi.cuda.implicit_gemm_tensorcore_applicable(data, kernel, CI, CO)
+            ):
+                # The implicit GEMM tiles the output pixels rather than the batch, so it also
+                # applies to the small batches the direct tensor core schedule does not.
+                strategy.add_implementation(
+                    wrap_compute_conv2d(topi.cuda.conv2d_nhwc_implicit_gemm_tensorcore),
+                    wrap_topi_schedule(topi.cuda.schedule_conv2d_nhwc_implicit_gemm_tensorcore),
+                    name="conv2d_nhwc_implicit_gemm_tensorcore.cuda",
+                    plevel=15,
+                )
 
             # register auto-scheduler implementations
             if is_auto_scheduler_enabled() and judge_winograd_auto_scheduler:
@@ -559,6 +579,21 @@ def conv2d_transpose_strategy_cuda(attrs, inputs, out_type, target):
         wrap_topi_schedule(topi.cuda.schedule_conv2d_transpose_nchw),
         name="conv2d_transpose_nchw.cuda",
     )
+    data, kernel = inputs
+    in_channel, out_channel, _, _ = get_const_tuple(kernel.shape)
+    if (
+        target.kind.name == "cuda"
+        and nvcc.have_tensorcore(target=target)
+        and topi.cuda.implicit_gemm_tensorcore_applicable(data, kernel, in_channel, out_channel)
+    ):
+        strategy.add_implementation(
+            wrap_compute_conv2d_transpose(
+                topi.cuda.conv2d_transpose_nchw_implicit_gemm_tensorcore
+            ),
+            wrap_topi_schedule(topi.cuda.schedule_conv2d_transpose_nchw_implicit_gemm_tensorcore),
+            name="conv2d_transpose_nchw_implicit_gemm_tensorcore.cuda",
+            plevel=15,
+        )
     return strategy
 
 
@@ -634,6 +669,15 @@ def conv3d_strategy_cuda(attrs, inputs, out_type, target):
                         name="conv3d_ndhwc_tensorcore.cuda",
                         plevel=20,
                     )
+                if topi.cuda.implicit_gemm_tensorcore_applicable(data, kernel, CI, CO):
+                    strategy.add_implementation(
+                        wrap_compute_conv3d(topi.cuda.conv3d_ndhwc_implicit_gemm_tensorcore),
+                        wrap_topi_schedule(
+                            topi.cuda.schedule_conv3d_ndhwc_implicit_gemm_tensorcore
+                        ),
+                        name="conv3d_ndhwc_implicit_gemm_tensorcore.cuda",
+                        plevel=15,
+                    )
 
     if target.kind.name == "cuda" and "cudnn" in target.libs:
         strategy.add_implementation(
@@ -814,6 +858,18 @@ def dense_strategy_cuda(attrs, inputs, out_type, target):
     return strategy
 
 
+@dense_int4_strategy.register(["cuda", "gpu"])
+def dense_int4_strategy_cuda(attrs, inputs, out_type, target):
+    """dense_int4 cuda strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_dense_int4(topi.nn.dense_int4),
+        wrap_topi_schedule(topi.cuda.schedule_dense_int4),
+        name="dense_int4.cuda",
+    )
+    return strategy
+
+
 @batch_matmul_strategy.register(["cuda", "gpu"])
 def batch_matmul_strategy_cuda(attrs, inputs, out_type, target):
     """batch_matmul cuda strategy"""
@@ -1107,6 +1163,18 @@ def proposal_strategy_cuda(attrs, inputs, out_type, target):
     return strategy
 
 
+@attention_strategy.register(["cuda", "gpu"])
+def attention_strategy_cuda(attrs, inputs, out_type, target):
+    """attention cuda strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_attention(topi.cuda.attention),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="attention.cuda",
+    )
+    return strategy
+
+
 @correlation_strategy.register(["cuda", "gpu"])
 def correlation_strategy_cuda(attrs, inputs, out_type, target):
     """correlation cuda strategy"""
@@ -1169,6 +1237,18 @@ def unique_strategy_cuda(attrs, inputs, out_type, target):
     return strategy
 
 
+@embedding_bag_strategy.register(["cuda", "gpu"])
+def embedding_bag_strategy_cuda(attrs, inputs, out_type, target):
+    """embedding_bag cuda strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_embedding_bag(topi.cuda.embedding_bag),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="embedding_bag.cuda",
+    )
+    return strategy
+
+
 @schedule_transpose.register(["cuda", "gpu", "rocm"])
 def schedule_transpose_cuda(attrs, outs, target):
     """
@@ -1176,19 +1256,22 @@ def schedule_transpose_cuda(attrs, outs, target):
     Dispatches to and optimized schedule if the transpose is standalone (not fused).
     """
     warp_size = int(Target.current(allow_none=False).thread_warp_size)
-    if (
-        isinstance(outs[0].op.input_tensors[0].op, te.PlaceholderOp)
-        and len(outs[0].shape) == 2
-        and (attrs.axes is None or (len(attrs.axes) == 2 and attrs.axes == [1, 0]))
-        and isinstance(outs[0].shape[0], (int, IntImm))
-        and outs[0].shape[0] >= warp_size
-        and isinstance(outs[0].shape[1], (int, IntImm))
-        and outs[0].shape[1] >= warp_size
-    ):
-        return topi.cuda.schedule_transpose(outs)
+    axes = tiled_transpose_axes(attrs, outs, warp_size)
+    if axes is not None:
+        return topi.cuda.schedule_transpose(outs, axes)
     return schedule_injective(attrs, outs, target)
 
 
+@schedule_layout_transform.register(["cuda", "gpu", "rocm"])
+def schedule_layout_transform_cuda(attrs, outs, target):
+    """
+    layout_transform cuda strategy
+    Dispatches to the transpose schedule if the layout_transform is standalone and permutes the
+    axes, e.g. from NCHW to NHWC.
+    """
+    return schedule_transpose_cuda(attrs, outs, target)
+
+
 @invert_permutation_strategy.register(["cuda", "gpu"])
 def invert_permutation_strategy_cuda(attrs, inputs, out_type, target):
     """invert_permutation cuda strategy"""
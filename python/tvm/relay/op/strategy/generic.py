@@ -19,7 +19,7 @@
 import logging
 import re
 
-from tvm import _ffi, ir, te, topi
+from tvm import _ffi, ir, te, tir, topi
 from tvm.target import generic_func, override_native_generic_func
 from tvm.topi.utils import get_const_float, get_const_int, get_const_tuple, get_float_tuple
 
@@ -200,6 +200,14 @@ def schedule_lrn(attrs, outs, target):
         return topi.generic.schedule_lrn(outs)
 
 
+# layer_norm
+@generic_func
+def schedule_layer_norm(attrs, outs, target):
+    """Schedule layer_norm and rms_norm op"""
+    with target:
+        return topi.generic.schedule_layer_norm(outs)
+
+
 # bitpack
 @generic_func
 def schedule_bitpack(attrs, outs, target):
@@ -793,6 +801,29 @@ def dense_pack_strategy(attrs, inputs, out_type, target):
     return strategy
 
 
+# qnn.dense_int4
+def wrap_compute_dense_int4(topi_compute):
+    """wrap dense_int4 topi compute"""
+
+    def _compute_dense_int4(attrs, inputs, out_type):
+        return [topi_compute(inputs[0], inputs[1], inputs[2], out_type.dtype)]
+
+    return _compute_dense_int4
+
+
+@override_native_generic_func("dense_int4_strategy")
+def dense_int4_strategy(attrs, inputs, out_type, target):
+    """dense_int4 generic strategy"""
+    logger.warning("dense_int4 is not optimized for this platform.")
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_dense_int4(topi.nn.dense_int4),
+        wrap_topi_schedule(topi.generic.schedule_dense),
+        name="dense_int4.generic",
+    )
+    return strategy
+
+
 # batch_matmul
 def wrap_compute_batch_matmul(topi_compute, need_auto_scheduler_layout=False, need_out_dtype=False):
     """wrap batch_matmul topi compute"""
@@ -1450,6 +1481,32 @@ def bitserial_dense_strategy(attrs, inputs, out_type, target):
     return strategy
 
 
+# attention
+def wrap_compute_attention(topi_compute):
+    """wrap attention topi compute"""
+
+    def _compute_attention(attrs, inputs, out_type):
+        return [
+            topi_compute(
+                inputs[0], inputs[1], inputs[2], inputs[3], attrs.scale, bool(attrs.causal)
+            )
+        ]
+
+    return _compute_attention
+
+
+@override_native_generic_func("attention_strategy")
+def attention_strategy(attrs, inputs, out_type, target):
+    """attention generic strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_attention(topi.nn.attention),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="attention.generic",
+    )
+    return strategy
+
+
 # correlation
 def wrap_compute_correlation(topi_compute):
     """wrap correlation topi compute"""
@@ -1641,6 +1698,27 @@ def unique_strategy(attrs, inputs, out_type, target):
     return strategy
 
 
+def wrap_compute_embedding_bag(topi_compute):
+    """Wrap embedding_bag topi compute"""
+
+    def _compute_embedding_bag(attrs, inputs, _):
+        return [topi_compute(inputs[0], inputs[1], inputs[2], inputs[3], attrs.mode)]
+
+    return _compute_embedding_bag
+
+
+@override_native_generic_func("embedding_bag_strategy")
+def embedding_bag_strategy(attrs, inputs, out_type, target):
+    """embedding_bag generic strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_embedding_bag(topi.embedding_bag),
+        wrap_topi_schedule(topi.generic.schedule_extern),
+        name="embedding_bag.generic",
+    )
+    return strategy
+
+
 @generic_func
 def schedule_transpose(attrs, outs, target):
     """schedule transpose"""
@@ -1648,6 +1726,43 @@ def schedule_transpose(attrs, outs, target):
         return schedule_injective(attrs, outs, target)
 
 
+@generic_func
+def schedule_layout_transform(attrs, outs, target):
+    """schedule layout_transform"""
+    with target:
+        return schedule_injective(attrs, outs, target)
+
+
+def tiled_transpose_axes(attrs, outs, min_extent):
+    """The input axis of each output axis of an unfused transpose, or layout_transform permuting
+    the axes, worth a tiled transpose schedule, i.e. moving the innermost axis and with both the
+    innermost output axis and the output axis reading the innermost input axis of at least
+    min_extent elements. None otherwise.
+    """
+    out = outs[0]
+    if len(outs) != 1 or not isinstance(out.op, te.ComputeOp) or len(out.op.input_tensors) != 1:
+        return None
+    if not isinstance(out.op.input_tensors[0].op, te.PlaceholderOp):
+        return None
+    ndim = len(out.shape)
+    if hasattr(attrs, "src_layout"):
+        src, dst = attrs.src_layout, attrs.dst_layout
+        # Only the layouts of primal axes, e.g. NCHW to NHWC, permute the axes.
+        if not (src.isupper() and dst.isupper() and sorted(src) == sorted(dst)):
+            return None
+        axes = [src.index(axis) for axis in dst]
+    elif attrs.axes is None:
+        axes = list(reversed(range(ndim)))
+    else:
+        axes = [get_const_int(axis) % ndim for axis in attrs.axes]
+    if ndim < 2 or axes[-1] == ndim - 1:
+        return None
+    for axis in [axes.index(ndim - 1), ndim - 1]:
+        if not isinstance(out.shape[axis], tir.IntImm) or out.shape[axis].value < min_extent:
+            return None
+    return axes
+
+
 # invert_permutation
 def wrap_compute_invert_permutation(topi_compute):
     """wrap invert_permutation topi compute"""
@@ -200,6 +200,13 @@ def dense_strategy_rocm(attrs, inputs, out_type, target):
             name="dense_rocblas.rocm",
             plevel=15,
         )
+    if topi.rocm.can_use_mfma(inputs[0], inputs[1], out_type.dtype, target):
+        strategy.add_implementation(
+            wrap_compute_dense(topi.rocm.dense_mfma),
+            wrap_topi_schedule(topi.rocm.schedule_dense_mfma),
+            name="dense_mfma.rocm",
+            plevel=12,
+        )
     return strategy
 
 
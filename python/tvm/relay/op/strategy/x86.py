@@ -39,6 +39,22 @@ def schedule_injective_cpu(attrs, outs, target):
         return topi.x86.schedule_injective(outs)
 
 
+@schedule_transpose.register("cpu")
+def schedule_transpose_cpu(attrs, outs, target):
+    """schedule transpose for x86, tiled for large unfused transposes"""
+    with target:
+        axes = tiled_transpose_axes(attrs, outs, topi.x86.TRANSPOSE_TILE)
+        if axes is not None:
+            return topi.x86.schedule_transpose(outs, axes)
+        return topi.x86.schedule_injective(outs)
+
+
+@schedule_layout_transform.register("cpu")
+def schedule_layout_transform_cpu(attrs, outs, target):
+    """schedule layout_transform for x86, tiled for large unfused permutations of the axes"""
+    return schedule_transpose_cpu(attrs, outs, target)
+
+
 @schedule_reduce.register("cpu")
 def schedule_reduce_cpu(attrs, outs, target):
     """schedule reduction ops for x86"""
@@ -103,6 +119,44 @@ def log_softmax_strategy_cpu(attrs, inputs, out_type, target):
     return strategy
 
 
+@schedule_layer_norm.register("cpu")
+def schedule_layer_norm_cpu(attrs, outs, target):
+    """schedule layer_norm and rms_norm for x86"""
+    with target:
+        return topi.x86.schedule_layer_norm(outs)
+
+
+def _is_winograd_applicable_cpu(data, kernel, stride_h, stride_w, dilation_h, dilation_w):
+    """Whether the NCHW conv2d can be computed by the x86 Winograd template"""
+    if len(kernel.shape) != 4 or is_auto_scheduler_enabled():
+        return False
+    if not all(isinstance(dim, int) for dim in get_const_tuple(data.shape)):
+        return False
+    _, _, kernel_h, kernel_w = get_const_tuple(kernel.shape)
+    return (
+        "float" in data.dtype
+        and "float" in kernel.dtype
+        and kernel_h == 3
+        and kernel_w == 3
+        and stride_h == 1
+        and stride_w == 1
+        and dilation_h == 1
+        and dilation_w == 1
+    )
+
+
+def _is_implicit_gemm_vnni_applicable(data, kernel, out_type, target):
+    """Whether the convolution can be computed by the x86 implicit GEMM VNNI templates"""
+    return (
+        not is_auto_scheduler_enabled()
+        and topi.x86.utils.target_has_vnni(target.mcpu)
+        and data.dtype == "uint8"
+        and kernel.dtype == "int8"
+        and out_type.dtype == "int32"
+        and all(isinstance(dim, int) for dim in get_const_tuple(data.shape))
+    )
+
+
 @conv2d_strategy.register("cpu")
 def conv2d_strategy_cpu(attrs, inputs, out_type, target):
     """conv2d x86 strategy"""
@@ -131,6 +185,17 @@ def conv2d_strategy_cpu(attrs, inputs, out_type, target):
                     wrap_topi_schedule(topi.x86.schedule_conv2d_nchw),
                     name="conv2d_nchw.x86",
                 )
+                if _is_winograd_applicable_cpu(
+                    data, kernel, stride_h, stride_w, dilation_h, dilation_w
+                ):
+                    # A lower priority than the direct convolution, so that Winograd is
+                    # only picked for the workloads it was tuned faster for.
+                    strategy.add_implementation(
+                        wrap_compute_conv2d(topi.x86.conv2d_nchw_winograd),
+                        wrap_topi_schedule(topi.x86.schedule_conv2d_nchw_winograd),
+                        name="conv2d_nchw_winograd.x86",
+                        plevel=5,
+                    )
         elif _NCHWc_matcher.match(layout):  # check if layout is NCHWxc
             assert _OIHWio_matcher.match(kernel_layout)  # check if kernel is OIHWio
             return conv2d_NCHWc_strategy_cpu(attrs, inputs, out_type, target)
@@ -143,6 +208,13 @@ def conv2d_strategy_cpu(attrs, inputs, out_type, target):
                 wrap_topi_schedule(topi.x86.schedule_conv2d_nhwc),
                 name="conv2d_nhwc.x86",
             )
+            if _is_implicit_gemm_vnni_applicable(data, kernel, out_type, target):
+                strategy.add_implementation(
+                    wrap_compute_conv2d(topi.x86.conv2d_nhwc_implicit_gemm_vnni),
+                    wrap_topi_schedule(topi.x86.schedule_conv2d_nhwc_implicit_gemm_vnni),
+                    name="conv2d_nhwc_implicit_gemm_vnni.x86",
+                    plevel=15,
+                )
 
             judge_winograd_auto_scheduler = False
             if len(kernel.shape) == 4:
@@ -288,6 +360,14 @@ def conv2d_transpose_strategy_cpu(attrs, inputs, out_type, target):
         wrap_topi_schedule(topi.x86.schedule_conv2d_transpose_nchw),
         name="conv2d_transpose_nchw.x86",
     )
+    data, kernel = inputs
+    if _is_implicit_gemm_vnni_applicable(data, kernel, out_type, target):
+        strategy.add_implementation(
+            wrap_compute_conv2d_transpose(topi.x86.conv2d_transpose_nchw_implicit_gemm_vnni),
+            wrap_topi_schedule(topi.x86.schedule_conv2d_transpose_nchw_implicit_gemm_vnni),
+            name="conv2d_transpose_nchw_implicit_gemm_vnni.x86",
+            plevel=15,
+        )
     return strategy
 
 
@@ -345,6 +425,14 @@ def conv3d_strategy_cpu(attrs, inputs, out_type, target):
                 wrap_topi_schedule(topi.x86.schedule_conv3d_ndhwc),
                 name="conv3d_ndhwc.x86",
             )
+            data, kernel = inputs
+            if _is_implicit_gemm_vnni_applicable(data, kernel, out_type, target):
+                strategy.add_implementation(
+                    wrap_compute_conv3d(topi.x86.conv3d_ndhwc_implicit_gemm_vnni),
+                    wrap_topi_schedule(topi.x86.schedule_conv3d_ndhwc_implicit_gemm_vnni),
+                    name="conv3d_ndhwc_implicit_gemm_vnni.x86",
+                    plevel=15,
+                )
         else:
             raise ValueError("Not support this layout {} yet".format(layout))
     return strategy
@@ -476,6 +564,25 @@ def dense_strategy_cpu(attrs, inputs, out_type, target):
             plevel=11,
         )
 
+    M, K = get_const_tuple(inputs[0].shape)
+    N = get_const_tuple(inputs[1].shape)[0]
+    if u8s8s32 and all(isinstance(d, int) for d in (M, N, K)):
+        amx_shape = M % 16 == 0 and N % 16 == 0 and K % 64 == 0
+        if topi.x86.utils.target_has_amx(target.mcpu) and amx_shape:
+            strategy.add_implementation(
+                wrap_compute_dense(topi.x86.dense_amx_int8),
+                wrap_topi_schedule(topi.x86.schedule_dense_amx_int8),
+                name="dense_amx_int8.x86",
+                plevel=12,
+            )
+        elif topi.x86.utils.target_has_vnni(target.mcpu) and N % 16 == 0 and K % 4 == 0:
+            strategy.add_implementation(
+                wrap_compute_dense(topi.x86.dense_vnni),
+                wrap_topi_schedule(topi.x86.schedule_dense_vnni),
+                name="dense_vnni.x86",
+                plevel=12,
+            )
+
     if "cblas" in target.libs:
         with SpecializedCondition(same_type and dtype in ["float32", "float64"]):
             strategy.add_implementation(
@@ -515,6 +622,18 @@ def dense_pack_strategy_cpu(attrs, inputs, out_type, target):
     return strategy
 
 
+@dense_int4_strategy.register("cpu")
+def dense_int4_strategy_cpu(attrs, inputs, out_type, target):
+    """dense_int4 x86 strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_dense_int4(topi.nn.dense_int4),
+        wrap_topi_schedule(topi.x86.schedule_dense_int4),
+        name="dense_int4.x86",
+    )
+    return strategy
+
+
 @batch_matmul_strategy.register("cpu")
 def batch_matmul_strategy_cpu(attrs, inputs, out_type, target):
     """batch_matmul x86 strategy"""
@@ -642,7 +761,13 @@ def conv2d_winograd_without_weight_transfrom_strategy_cpu(attrs, inputs, out_typ
     assert strides == (1, 1), "Do not support strides now"
     assert groups == 1, "Do not supoort arbitrary group number"
     strategy = _op.OpStrategy()
-    if layout == "NHWC":
+    if layout == "NCHW":
+        strategy.add_implementation(
+            wrap_compute_conv2d(topi.x86.conv2d_nchw_winograd),
+            wrap_topi_schedule(topi.x86.schedule_conv2d_nchw_winograd),
+            name="conv2d_nchw_winograd.x86",
+        )
+    elif layout == "NHWC":
         strategy.add_implementation(
             wrap_compute_conv2d(
                 topi.nn.conv2d_winograd_nhwc_without_weight_transform,
@@ -423,6 +423,40 @@ def take(data, indices, axis=None, batch_dims=0, mode="clip"):
     return _make.take(data, indices, batch_dims, axis, mode)
 
 
+def embedding_bag(weight, indices, offsets, per_sample_weights=None, mode="sum"):
+    """Reduce bags of rows of an embedding table, without materializing the gathered rows.
+
+    The bag b gathers the rows ``indices[offsets[b]:offsets[b + 1]]`` of the weight, the last
+    bag the rows up to the end of indices.
+
+    Parameters
+    ----------
+    weight : relay.Expr
+        2-D embedding table [num_embeddings, dim].
+
+    indices : relay.Expr
+        1-D integer tensor, the rows of the bags concatenated.
+
+    offsets : relay.Expr
+        1-D integer tensor [num_bags], the start of each bag in indices, in increasing order.
+
+    per_sample_weights : relay.Expr, optional
+        1-D tensor with the shape of indices scaling each row, only supported for the sum mode.
+
+    mode : str, optional
+        How the rows of a bag are reduced [sum, mean, max]. The mean and the maximum of an empty
+        bag are zero.
+
+    Returns
+    -------
+    ret : relay.Expr
+        The computed result, [num_bags, dim].
+    """
+    if per_sample_weights is None:
+        per_sample_weights = const(1.0)
+    return _make.embedding_bag(weight, indices, offsets, per_sample_weights, mode)
+
+
 def full(fill_value, shape=(), dtype=""):
     """Fill array with scalar value.
 
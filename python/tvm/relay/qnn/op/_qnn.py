@@ -21,7 +21,9 @@ from tvm import topi
 
 from ...op.op import register_compute
 from ...op.op import register_injective_schedule
+from ...op.op import register_strategy
 from ...op.op import register_pattern, OpPattern
+from ...op import strategy
 
 
 @register_compute("qnn.simulated_quantize")
@@ -50,3 +52,16 @@ def simulated_dequantize_compute(attrs, inputs, output_type):
 
 register_injective_schedule("qnn.simulated_dequantize")
 register_pattern("qnn.simulated_dequantize", OpPattern.ELEMWISE)
+
+
+@register_compute("qnn.pack_int4")
+def pack_int4_compute(attrs, inputs, output_type):
+    assert len(inputs) == 1
+    return [topi.nn.pack_int4(inputs[0])]
+
+
+register_injective_schedule("qnn.pack_int4")
+register_pattern("qnn.pack_int4", OpPattern.INJECTIVE)
+
+register_strategy("qnn.dense_int4", strategy.dense_int4_strategy)
+register_pattern("qnn.dense_int4", OpPattern.OUT_ELEMWISE_FUSABLE)
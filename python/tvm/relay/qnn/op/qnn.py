@@ -584,6 +584,52 @@ def dense(
     )
 
 
+def pack_int4(weight):
+    """Pack int4 values, held in int8, two per byte along the last axis.
+
+    Parameters
+    ----------
+    weight : tvm.relay.Expr
+        The int8 values in [-8, 7], the last axis of even size.
+
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The uint8 bytes, element 2i in the low nibble of byte i and 2i + 1 in its high nibble.
+    """
+    return _make.pack_int4(weight)
+
+
+def dense_int4(data, packed_weight, weight_scale, units=None, out_dtype=""):
+    """Dense with int4 weights, unpacked and scaled in the reduction.
+
+     .. math::
+
+     `Y = X * (W * scale)^T`
+
+    Parameters
+    ----------
+    data : tvm.relay.Expr
+        The float input, of shape (batch, in_dim).
+    packed_weight : tvm.relay.Expr
+        The weights packed by :py:func:`pack_int4`, of shape (units, in_dim // 2).
+    weight_scale : tvm.relay.Expr
+        The scale of the weights: a scalar, one per output channel (units,), or one per group
+        of in_dim // groups consecutive elements of each channel (units, groups). The groups
+        must be of even size.
+    units : int, optional
+        Number of hidden units of the dense transformation.
+    out_dtype : str, optional
+        The output type, the type of data by default.
+
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The computed result.
+    """
+    return _make.dense_int4(data, packed_weight, weight_scale, units, out_dtype)
+
+
 def mul(
     lhs, rhs, lhs_scale, lhs_zero_point, rhs_scale, rhs_zero_point, output_scale, output_zero_point
 ):
@@ -27,16 +27,20 @@ from . import _quantize
 from . import quantize
 from .. import op as _op
 from .. import expr as _expr
+from .. import function as _function
 from .. import analysis as _analysis
 from .. import build_module as _build_module
 from ...contrib import graph_executor
-from .kl_divergence import _find_scale_by_kl
+from .kl_divergence import _find_scale_by_kl_from_hist
 
 
 def _get_profile_runtime(mod):
     func = mod["main"]
     func = _quantize.CreateStatsCollector(func)
+    return _build_runtime(func)
 
+
+def _build_runtime(func):
     if tvm.target.Target.current():
         target = tvm.target.Target.current()
         dev = tvm.device(target.kind.name)
@@ -90,40 +94,101 @@ def collect_stats(mod, dataset, chunk_by=-1):
         yield [np.concatenate(output).reshape(-1) for output in outputs]
 
 
-def _kl_scale(mod, dataset):
-    cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with kl for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_kl, samples))
+# The number of bins of the histograms of the calibration.
+_NUM_BINS = 8001
 
-    def func(_):
-        scale = scales[func.scale_idx]
-        func.scale_idx += 1
-        return scale
 
-    func.scale_idx = 0
+def _histogram(data, thres, num_bins):
+    """The histogram of data over (-thres, thres), computed in the profile graph."""
+    flat = _op.reshape(data, [-1])
+    index = _op.floor((flat + _expr.const(thres)) * _expr.const(num_bins / (2 * thres)))
+    index = _op.cast(_op.clip(index, 0, num_bins - 1), "int32")
+    zeros = _op.zeros((num_bins,), "int32")
+    return _op.scatter_add(zeros, index, _op.ones_like(index), 0)
 
-    return func
 
+def _reduce_stats(func, reducers, dataset, accumulate):
+    """Run the reductions of the profiled tensors on every batch, accumulating their results.
 
-def _find_scale_by_percentile(arr, percentile=0.99999):
-    assert isinstance(arr, np.ndarray)
-    x = np.abs(arr)
-    max_k = int(x.size * percentile)
-    return np.partition(x, max_k)[max_k]
+    Only the accumulated results are kept, the profiled tensors stay in the graph executor.
+    """
+    body = _expr.Tuple(reducers)
+    runtime = _build_runtime(_function.Function(_analysis.free_vars(body), body))
+    results = None
+    for batch in dataset:
+        runtime.set_input(**batch)
+        runtime.run()
+        outputs = [runtime.get_output(i).numpy() for i in range(len(reducers))]
+        results = outputs if results is None else list(map(accumulate, results, outputs))
+    return results
 
 
-def _percentile_scale(mod, dataset):
-    cfg = quantize.current_qconfig()
-    chunk_by = cfg.calibrate_chunk_by
-    scales = []
-    for samples in collect_stats(mod, dataset, chunk_by):
-        logging.info("finding threshold with percentile for calibration...")
-        with mp.Pool() as pool:
-            scales += list(pool.map(_find_scale_by_percentile, samples))
+def collect_histograms(mod, dataset, num_bins=_NUM_BINS):
+    """Collect the histogram of every profiled tensor over the calibration dataset.
+
+    The statistics are reduced in the compiled profile graph: a first pass over the dataset
+    finds the range of each tensor, a second one accumulates their histograms over this range.
+    Only one histogram per tensor is kept in memory, not the tensors of every batch.
+
+    Parameters
+    ----------
+    mod: Module
+        The simulation graph after annotation.
+
+    dataset: Iterable[Dict[str, NDArray]]
+        The calibration dataset, it is iterated twice.
+
+    num_bins: int
+        The number of bins of the histograms.
+
+    Returns
+    -------
+    ret: List[Tuple[numpy.ndarray, numpy.ndarray]]
+        The histogram and the bin edges of each profiled tensor, in the order of collect_stats.
+    """
+    logging.info("collecting histograms for calibration...")
+    if not isinstance(dataset, (list, tuple)):
+        dataset = list(dataset)
+    func = _quantize.CreateStatsCollector(mod["main"])
+    tensors = list(func.body.fields)
+    maxes = _reduce_stats(func, [_op.max(_op.abs(t)) for t in tensors], dataset, np.maximum)
+    # An all zero tensor gets the range of the next float above zero.
+    thresholds = [max(float(m), np.finfo(np.float32).tiny) for m in maxes]
+    reducers = [_histogram(t, thres, num_bins) for t, thres in zip(tensors, thresholds)]
+    hists = _reduce_stats(func, reducers, dataset, lambda acc, hist: acc.astype(np.int64) + hist)
+    return [
+        (hist, np.linspace(-thres, thres, num_bins + 1, dtype=np.float32))
+        for hist, thres in zip(hists, thresholds)
+    ]
+
+
+def _kl_scale_from_hist(hist_and_edges):
+    hist, edges = hist_and_edges
+    # The KL minimization counts in int32, keep the shape of large histograms.
+    limit = np.iinfo(np.int32).max
+    if hist.max() > limit:
+        hist = (hist * (limit / hist.max())).astype(np.int64)
+    return _find_scale_by_kl_from_hist(hist, edges)
+
+
+def _percentile_scale_from_hist(hist_and_edges, percentile=0.99999):
+    """The percentile of the absolute values, at the precision of a bin."""
+    hist, edges = hist_and_edges
+    num_bins = hist.size
+    center = num_bins // 2
+    # Fold the symmetric histogram into the histogram of the absolute values.
+    abs_hist = hist[center:].astype(np.int64)
+    abs_hist[1:] += hist[: num_bins - center - 1][::-1][: abs_hist.size - 1]
+    count = np.cumsum(abs_hist)
+    k = int(np.searchsorted(count, percentile * count[-1]))
+    return float(edges[min(center + k + 1, num_bins)])
+
+
+def _histogram_scales(mod, dataset, find_scale):
+    stats = collect_histograms(mod, dataset)
+    logging.info("finding thresholds for calibration...")
+    with mp.Pool() as pool:
+        scales = list(pool.map(find_scale, stats))
 
     def func(_):
         scale = scales[func.scale_idx]
@@ -135,6 +200,14 @@ def _percentile_scale(mod, dataset):
     return func
 
 
+def _kl_scale(mod, dataset):
+    return _histogram_scales(mod, dataset, _kl_scale_from_hist)
+
+
+def _percentile_scale(mod, dataset):
+    return _histogram_scales(mod, dataset, _percentile_scale_from_hist)
+
+
 def _set_params(mod, input_scale_func, weight_scale_func):
     quantize_op = _op.get("relay.op.annotation.simulated_quantize")
     cfg = quantize.current_qconfig()
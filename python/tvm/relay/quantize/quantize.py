@@ -146,9 +146,11 @@ def qconfig(**kwargs):
         Number of bit for every kind of annotate field.
 
     calibrate_mode: str
-        The calibration mode. 'global_scale' or 'kl_divergence'.
+        The calibration mode. 'global_scale', 'kl_divergence' or 'percentile'.
         global_scale: use global scale
         kl_divergence: find scales by kl divergence on the dataset.
+        percentile: find scales by the percentile of the absolute values on the dataset.
+        Both dataset modes reduce the tensors into histograms in the compiled profile graph.
 
     global_scale: float
         The global scale for calibration.
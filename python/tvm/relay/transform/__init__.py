@@ -19,4 +19,7 @@
 # transformation passes
 from .transform import *
 from .recast import recast
+from .device_placement import AutoDevicePlacement, estimate_op_cost
+from .prune_partitions import PruneUnprofitablePartitions, estimate_partition_cost
+from .mixed_precision_search import auto_mixed_precision
 from . import fake_quantization_to_integer
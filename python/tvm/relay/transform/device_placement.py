@@ -0,0 +1,156 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Automatic placement of the calls of a model on two devices."""
+from collections import namedtuple
+
+import tvm
+from tvm import runtime
+from . import _ffi_api
+
+
+DeviceSpec = namedtuple("DeviceSpec", ["gflops", "gbps", "launch_us"])
+DeviceSpec.__doc__ = """The throughput of a device for the cost estimates of the ops.
+
+Parameters
+----------
+gflops : float
+    The peak arithmetic throughput, in GFLOP/s.
+
+gbps : float
+    The memory bandwidth, in GB/s.
+
+launch_us : float
+    The fixed latency of each op, e.g. a kernel launch, in microseconds.
+"""
+
+# Rough defaults, of a desktop CPU and a discrete GPU.
+DEFAULT_DEVICE_SPECS = {
+    runtime.Device.STR2MASK["cpu"]: DeviceSpec(gflops=100.0, gbps=20.0, launch_us=1.0),
+    runtime.Device.STR2MASK["cuda"]: DeviceSpec(gflops=5000.0, gbps=300.0, launch_us=10.0),
+    runtime.Device.STR2MASK["rocm"]: DeviceSpec(gflops=5000.0, gbps=300.0, launch_us=10.0),
+    runtime.Device.STR2MASK["opencl"]: DeviceSpec(gflops=1000.0, gbps=50.0, launch_us=20.0),
+}
+
+
+def _num_elements(ty):
+    if isinstance(ty, tvm.ir.TupleType):
+        return sum(_num_elements(field) for field in ty.fields)
+    num = 1
+    for dim in ty.shape:
+        if isinstance(dim, tvm.tir.IntImm):
+            num *= dim.value
+    return num
+
+
+def _num_bytes(ty):
+    if isinstance(ty, tvm.ir.TupleType):
+        return sum(_num_bytes(field) for field in ty.fields)
+    return _num_elements(ty) * tvm.runtime.DataType(ty.dtype).bits // 8
+
+
+def _num_flops(call):
+    """A rough count of the arithmetic of a call, one per output element for the simple ops."""
+    out = _num_elements(call.checked_type)
+    name = call.op.name if isinstance(call.op, tvm.ir.Op) else ""
+    if name in ("nn.dense", "nn.batch_matmul", "nn.matmul"):
+        return 2 * out * int(call.args[0].checked_type.shape[-1])
+    if name in ("nn.conv1d", "nn.conv2d", "nn.conv3d"):
+        weight = call.args[1].checked_type.shape
+        kernel_layout = call.attrs.kernel_layout
+        reduce = 1
+        for axis, dim in zip(kernel_layout, weight):
+            if axis != "O":
+                reduce *= int(dim)
+        return 2 * out * reduce
+    return out
+
+
+def estimate_op_cost(call, device_type, specs=None):
+    """Estimate the latency of a call with a roofline model of the device.
+
+    Parameters
+    ----------
+    call : tvm.relay.Call
+        The type checked call.
+
+    device_type : int
+        The device type.
+
+    specs : Optional[dict of int to DeviceSpec]
+        The throughput of each device type, DEFAULT_DEVICE_SPECS by default.
+
+    Returns
+    -------
+    cost : float
+        The estimated latency in microseconds, infinite on the unknown devices.
+    """
+    spec = (specs or DEFAULT_DEVICE_SPECS).get(device_type)
+    if spec is None:
+        return float("inf")
+    num_bytes = _num_bytes(call.checked_type)
+    for arg in call.args:
+        num_bytes += _num_bytes(arg.checked_type)
+    compute_us = _num_flops(call) / (spec.gflops * 1e3)
+    memory_us = num_bytes / (spec.gbps * 1e3)
+    return spec.launch_us + max(compute_us, memory_us)
+
+
+def AutoDevicePlacement(
+    device, fallback_device="cpu", cost_fn=None, transfer_gbps=12.0, transfer_latency_us=10.0
+):
+    """Annotate the calls of main to run on the fallback device or on a second device.
+
+    Each call costs its latency on its device, and each value read on the other device costs
+    a copy. The placement minimizing the sum of these costs, which is the latency of the
+    graph executor running the calls one after the other, is found with a minimum cut. The
+    calls placed on the second device are annotated with on_device, the calls already
+    annotated keep their device. Run the pass before building for both targets.
+
+    Parameters
+    ----------
+    device : str or tvm.runtime.Device
+        The second device, e.g. "cuda".
+
+    fallback_device : str or tvm.runtime.Device
+        The fallback device of the build, the calls placed there are not annotated.
+
+    cost_fn : Optional[Callable[[tvm.relay.Call, int], float]]
+        Returns the latency in microseconds of a call on a device type, e.g. measured by
+        running the op. :py:func:`estimate_op_cost` by default.
+
+    transfer_gbps : float
+        The bandwidth of the copies between the devices in GB/s, e.g. of the PCIe link.
+
+    transfer_latency_us : float
+        The fixed latency of a copy in microseconds.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for the device placement.
+    """
+
+    def device_type(dev):
+        return dev.device_type if isinstance(dev, runtime.Device) else tvm.device(dev).device_type
+
+    return _ffi_api.AutoDevicePlacement(
+        device_type(fallback_device),
+        device_type(device),
+        cost_fn or estimate_op_cost,
+        float(transfer_gbps),
+        float(transfer_latency_us),
+    )
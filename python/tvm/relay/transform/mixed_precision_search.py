@@ -0,0 +1,241 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Search of the calls to run in lower precision within an accuracy budget."""
+from collections import namedtuple
+
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from .device_placement import DEFAULT_DEVICE_SPECS, _num_bytes, _num_flops
+from .transform import InferType, ToMixedPrecision
+
+
+OpReport = namedtuple("OpReport", ["index", "op", "error", "speedup", "lowered"])
+OpReport.__doc__ = """The outcome of the search for a call of main.
+
+Parameters
+----------
+index : int
+    The position of the call in the post order of main.
+
+op : str
+    The name of the op.
+
+error : float
+    The relative error of the outputs of main with only this call in lower precision.
+
+speedup : float
+    The estimated speedup of the call in lower precision.
+
+lowered : bool
+    Whether the call is in lower precision in the converted module.
+"""
+
+
+def default_mixed_precision_type(target):
+    """The lower precision type with native support on a target.
+
+    bfloat16 on the CPUs with bfloat16 instructions, the x86 CPUs with AVX512-BF16 or AMX and
+    the ARM CPUs with the BF16 extension, float16 otherwise.
+    """
+    target = tvm.target.Target(target)
+    if target.kind.name == "llvm":
+        mattr = list(target.attrs["mattr"]) if "mattr" in target.attrs else []
+        mcpu = target.attrs["mcpu"] if "mcpu" in target.attrs else ""
+        if any(attr in mattr for attr in ("+avx512bf16", "+amx-bf16", "+bf16")) or mcpu in (
+            "cooperlake",
+            "sapphirerapids",
+        ):
+            return "bfloat16"
+    return "float16"
+
+
+def _is_fp32(ty):
+    if isinstance(ty, relay.TupleType):
+        return any(_is_fp32(field) for field in ty.fields)
+    return isinstance(ty, relay.TensorType) and ty.dtype == "float32"
+
+
+def estimate_speedup(call, device_type, mixed_precision_type, specs=None, lowp_flops_factor=2.0):
+    """Estimate the speedup of a call in lower precision with the roofline model of the device.
+
+    Parameters
+    ----------
+    call : tvm.relay.Call
+        The type checked call, in FP32.
+
+    device_type : int
+        The device type.
+
+    mixed_precision_type : str
+        The lower precision type.
+
+    specs : Optional[dict of int to DeviceSpec]
+        The throughput of each device type, DEFAULT_DEVICE_SPECS by default.
+
+    lowp_flops_factor : float
+        The arithmetic throughput in lower precision over the one in FP32.
+
+    Returns
+    -------
+    speedup : float
+        The latency in FP32 over the latency in lower precision.
+    """
+    spec = (specs or DEFAULT_DEVICE_SPECS).get(device_type)
+    if spec is None:
+        return 1.0
+    num_bytes = _num_bytes(call.checked_type)
+    for arg in call.args:
+        num_bytes += _num_bytes(arg.checked_type)
+    ratio = tvm.runtime.DataType(mixed_precision_type).bits / 32
+    flops_us = _num_flops(call) / (spec.gflops * 1e3)
+    memory_us = num_bytes / (spec.gbps * 1e3)
+    fp32 = spec.launch_us + max(flops_us, memory_us)
+    lowp = spec.launch_us + max(flops_us / lowp_flops_factor, memory_us * ratio)
+    return fp32 / lowp
+
+
+def _cast_outputs(expr, orig_type, new_type):
+    """Cast the outputs of main back to their FP32 types."""
+    if isinstance(orig_type, relay.TupleType):
+        return relay.Tuple(
+            [
+                _cast_outputs(relay.TupleGetItem(expr, i), orig, new)
+                for i, (orig, new) in enumerate(zip(orig_type.fields, new_type.fields))
+            ]
+        )
+    if orig_type.dtype != new_type.dtype:
+        return relay.cast(expr, orig_type.dtype)
+    return expr
+
+
+def _relative_error(reference, outputs):
+    error = 0.0
+    for ref_outs, outs in zip(reference, outputs):
+        for ref, out in zip(ref_outs, outs):
+            scale = max(float(np.max(np.abs(ref))), 1e-12) if ref.size else 1.0
+            diff = np.abs(ref.astype("float64") - out.astype("float64"))
+            error = max(error, float(np.max(diff)) / scale if diff.size else 0.0)
+    return error
+
+
+def auto_mixed_precision(
+    mod, dataset, params=None, mixed_precision_type=None, target="llvm", tolerance=1e-2, dev=None
+):
+    """Convert the calls of main to lower precision while the outputs stay within a tolerance.
+
+    Every call of main producing FP32 values is a candidate, the calls the default lists keep
+    in FP32 included. The error of each candidate alone in lower precision is measured on a
+    calibration dataset, then the candidates are lowered greedily by decreasing estimated
+    speedup, each one kept only if the error of the outputs with all the lowered calls stays
+    within the tolerance. The search builds and runs the model twice per candidate.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The FP32 module.
+
+    dataset : List[Dict[str, numpy.ndarray]]
+        The inputs of main for the calibration.
+
+    params : Optional[Dict[str, numpy.ndarray or tvm.nd.NDArray]]
+        The parameters bound to main before the conversion.
+
+    mixed_precision_type : Optional[str]
+        The lower precision type, :py:func:`default_mixed_precision_type` of the target by
+        default.
+
+    target : str or tvm.target.Target
+        The target running the calibration.
+
+    tolerance : float
+        The largest relative error of the outputs, over the max of their absolute value.
+
+    dev : Optional[tvm.runtime.Device]
+        The device running the calibration, the first one of the target by default.
+
+    Returns
+    -------
+    mod : tvm.IRModule
+        The converted module, its outputs keep their FP32 types.
+
+    report : List[OpReport]
+        The error and the speedup of each candidate.
+    """
+    # pylint: disable=import-outside-toplevel
+    from ..build_module import bind_params_by_name
+    from .mixed_precision import MIXED_PRECISION_ALWAYS, MIXED_PRECISION_NEVER
+
+    target = tvm.target.Target(target)
+    dev = dev or tvm.device(target.kind.name, 0)
+    mixed_precision_type = mixed_precision_type or default_mixed_precision_type(target)
+    mod = tvm.IRModule(mod.functions, mod.type_definitions)
+    if params:
+        mod["main"] = bind_params_by_name(mod["main"], params)
+    mod = InferType()(mod)
+    orig_type = mod["main"].checked_type.ret_type
+
+    calls = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and isinstance(expr.op, tvm.ir.Op):
+            if _is_fp32(expr.checked_type):
+                calls.append(expr)
+
+    relay.analysis.post_order_visit(mod["main"].body, visit)
+
+    def run(run_mod):
+        with tvm.transform.PassContext(opt_level=3):
+            lib = relay.build(run_mod, target=target)
+        gmod = graph_executor.GraphModule(lib["default"](dev))
+        outputs = []
+        for inputs in dataset:
+            gmod.run(**inputs)
+            outputs.append([gmod.get_output(i).numpy() for i in range(gmod.get_num_outputs())])
+        return outputs
+
+    def convert(lowered):
+        categories = {
+            call: MIXED_PRECISION_ALWAYS if call in lowered else MIXED_PRECISION_NEVER
+            for call in calls
+        }
+        new_mod = ToMixedPrecision(mixed_precision_type, 2, categories)(mod)
+        main = InferType()(new_mod)["main"]
+        body = _cast_outputs(main.body, orig_type, main.checked_type.ret_type)
+        new_mod["main"] = relay.Function(main.params, body)
+        return InferType()(new_mod)
+
+    reference = run(mod)
+    errors = [_relative_error(reference, run(convert({call}))) for call in calls]
+    device_type = dev.device_type
+    speedups = [estimate_speedup(call, device_type, mixed_precision_type) for call in calls]
+
+    lowered = set()
+    for i in sorted(range(len(calls)), key=lambda i: (-speedups[i], errors[i])):
+        if errors[i] > tolerance:
+            continue
+        trial = lowered | {calls[i]}
+        if _relative_error(reference, run(convert(trial))) <= tolerance:
+            lowered = trial
+
+    report = [
+        OpReport(i, call.op.name, errors[i], speedups[i], call in lowered)
+        for i, call in enumerate(calls)
+    ]
+    return convert(lowered), report
@@ -0,0 +1,188 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Return the partitions of the external codegens that are not profitable to TVM."""
+from collections import namedtuple
+
+import tvm
+from tvm import relay
+from ..expr_functor import ExprMutator
+from .transform import InferType, RemoveUnusedFunctions
+from .device_placement import DeviceSpec, estimate_op_cost, _num_bytes
+
+
+BackendSpec = namedtuple("BackendSpec", ["spec", "device"])
+BackendSpec.__doc__ = """The throughput of an external codegen for the cost estimates.
+
+Parameters
+----------
+spec : DeviceSpec
+    The throughput of the codegen. Its launch_us is paid once per partition, the ops of a
+    partition run in one engine.
+
+device : str
+    The device the codegen runs on, its inputs and outputs are copied when it differs from
+    the device running TVM.
+"""
+
+# Rough defaults, of the libraries on the devices of DEFAULT_DEVICE_SPECS.
+DEFAULT_BACKEND_SPECS = {
+    "tensorrt": BackendSpec(DeviceSpec(gflops=10000.0, gbps=300.0, launch_us=50.0), "cuda"),
+    "dnnl": BackendSpec(DeviceSpec(gflops=200.0, gbps=20.0, launch_us=5.0), "cpu"),
+    "arm_compute_lib": BackendSpec(DeviceSpec(gflops=150.0, gbps=20.0, launch_us=5.0), "cpu"),
+}
+
+
+def _device_type(dev):
+    return tvm.device(dev).device_type
+
+
+def _calls(func):
+    """The calls of the operators of func, the composite functions included."""
+    calls = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and isinstance(expr.op, tvm.ir.Op):
+            calls.append(expr)
+
+    relay.analysis.post_order_visit(func.body, visit)
+    return calls
+
+
+def estimate_partition_cost(func, compiler, device="cpu", backend_specs=None):
+    """Estimate the latency of a partition, with the roofline model of estimate_op_cost.
+
+    Parameters
+    ----------
+    func : tvm.relay.Function
+        The type checked partition.
+
+    compiler : Optional[str]
+        The external codegen running the partition, None for TVM.
+
+    device : str
+        The device running TVM.
+
+    backend_specs : Optional[dict of str to BackendSpec]
+        The throughput of each codegen, DEFAULT_BACKEND_SPECS by default.
+
+    Returns
+    -------
+    cost : float
+        The estimated latency in microseconds, without the copies of the inputs and outputs.
+        The codegens without a spec cost as much as TVM.
+    """
+    calls = _calls(func)
+    specs = backend_specs or DEFAULT_BACKEND_SPECS
+    if compiler is None or compiler not in specs:
+        return sum(estimate_op_cost(call, _device_type(device)) for call in calls)
+    spec = specs[compiler].spec
+    device_specs = {0: spec}
+    cost = sum(estimate_op_cost(call, 0, device_specs) - spec.launch_us for call in calls)
+    return spec.launch_us + cost
+
+
+def PruneUnprofitablePartitions(
+    cost_fn=None, device="cpu", backend_specs=None, transfer_gbps=12.0, transfer_latency_us=10.0
+):
+    """Run the partitions of the external codegens on TVM when offloading them is slower.
+
+    Each partition called by main costs its latency on its codegen, plus the copies of its
+    inputs and outputs when the codegen runs on another device than TVM, against its latency
+    on TVM. The partitions that are not faster on their codegen are inlined back into main.
+    Run the pass after PartitionGraph, MergeCompilerRegions having already merged the regions
+    that can be merged.
+
+    Parameters
+    ----------
+    cost_fn : Optional[Callable[[tvm.relay.Function, Optional[str]], float]]
+        Returns the latency in microseconds of a partition on a codegen, or on TVM for None,
+        e.g. measured by running it. :py:func:`estimate_partition_cost` by default.
+
+    device : str
+        The device running TVM.
+
+    backend_specs : Optional[dict of str to BackendSpec]
+        The throughput and the device of each codegen, DEFAULT_BACKEND_SPECS by default.
+
+    transfer_gbps : float
+        The bandwidth of the copies between the devices in GB/s.
+
+    transfer_latency_us : float
+        The fixed latency of a copy in microseconds.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass pruning the partitions.
+    """
+    specs = backend_specs or DEFAULT_BACKEND_SPECS
+
+    def cost(func, compiler):
+        if cost_fn is not None:
+            return cost_fn(func, compiler)
+        return estimate_partition_cost(func, compiler, device, specs)
+
+    def transfer_cost(func, compiler):
+        if compiler not in specs or _device_type(specs[compiler].device) == _device_type(device):
+            return 0.0
+        tensors = [param.checked_type for param in func.params] + [func.body.checked_type]
+        return sum(transfer_latency_us + _num_bytes(ty) / (transfer_gbps * 1e3) for ty in tensors)
+
+    def transform_module(mod, ctx):
+        mod = InferType()(mod)
+        to_inline = set()
+        for gvar, func in mod.functions.items():
+            if not isinstance(func, relay.Function) or func.attrs is None:
+                continue
+            compiler = func.attrs.get("Compiler")
+            if compiler is None:
+                continue
+            offload = cost(func, compiler) + transfer_cost(func, compiler)
+            if offload >= cost(func, None):
+                to_inline.add(gvar)
+        if not to_inline:
+            return mod
+
+        class Inliner(ExprMutator):
+            """Inline the calls of the pruned partitions, and of their composite functions."""
+
+            def __init__(self):
+                ExprMutator.__init__(self)
+                self.inlining = False
+
+            def visit_call(self, call):
+                func = None
+                if isinstance(call.op, relay.GlobalVar) and call.op in to_inline:
+                    func = mod[call.op]
+                elif self.inlining and isinstance(call.op, relay.Function):
+                    func = call.op
+                if func is None:
+                    return super().visit_call(call)
+                args = [self.visit(arg) for arg in call.args]
+                inlining, self.inlining = self.inlining, True
+                body = self.visit(func.body)
+                self.inlining = inlining
+                return relay.bind(body, dict(zip(func.params, args)))
+
+        new_mod = tvm.IRModule(mod.functions, mod.type_definitions)
+        new_mod["main"] = Inliner().visit(mod["main"])
+        new_mod = RemoveUnusedFunctions()(new_mod)
+        return InferType()(new_mod)
+
+    return tvm.transform.module_pass(
+        transform_module, opt_level=0, name="PruneUnprofitablePartitions"
+    )
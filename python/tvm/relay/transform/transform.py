@@ -91,6 +91,10 @@ class FunctionPass(tvm.ir.transform.Pass):
 def InferType():
     """Infer the type of an expr.
 
+    By default the dataflow subexpressions typed by an earlier inference keep their types, so
+    that only the regions rewritten since then are solved again. Set the
+    "relay.InferType.incremental" config to False to re-infer the whole functions.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -176,6 +180,10 @@ def SimplifyInference():
     Note that batch norms will only be simplified if their result is indexed at
     tuple index 0.
 
+    layer_norm and rms_norm are decomposed too, unless the
+    ``relay.SimplifyInference.keep_norm`` pass config is set, which keeps them for
+    their single-pass fused kernels.
+
     Returns
     -------
     ret: tvm.transform.Pass
@@ -285,6 +293,55 @@ def FuseOps(fuse_opt_level=-1):
     return _ffi_api.FuseOps(fuse_opt_level)
 
 
+def HorizontalFuseOps(max_group_size=16):
+    """Pack the calls to independent injective fused functions, at the same depth of the
+    dataflow graph, into calls to a single fused function returning a tuple. The kernels
+    of the packed functions are then launched together.
+
+    The pass runs after FuseOps, it is enabled at opt_level 4 or when it is required.
+
+    Parameters
+    ----------
+    max_group_size : int
+        The maximum number of fused functions packed together.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for horizontal fusion.
+    """
+    return _ffi_api.HorizontalFuseOps(max_group_size)
+
+
+def ToStreaming(hop, time_axis=2):
+    """Rewrite main to compute only the new frames of a stream along a time axis.
+
+    The first input of main becomes a chunk of ``hop`` new frames. The ops with a receptive
+    field along the time axis (nn.conv1d, nn.max_pool1d and nn.avg_pool1d) read the frames
+    they still need from state inputs named ``stream_state_<i>``, and main returns the next
+    states after its outputs. The convolutions must be causal, i.e. padded on the left only
+    by their receptive field minus their stride, and the states start as zeros. The other
+    ops on the stream must be elementwise or broadcast along the time axis.
+
+    Use :py:func:`tvm.contrib.graph_executor.GraphModule.link_output` to carry the states
+    from one run to the next.
+
+    Parameters
+    ----------
+    hop : int
+        The number of new frames of each call.
+
+    time_axis : int
+        The time axis of the first input of main.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for streaming.
+    """
+    return _ffi_api.ToStreaming(hop, time_axis)
+
+
 def DefuseOps():
     """The inverse operation of FuseOps. It transforms a fused program returned by FuseOps into the
     program before FuseOps. (i.e., x == DefuseOps(FuseOps(x)))
@@ -419,6 +476,21 @@ def AlterOpLayout():
     return _ffi_api.AlterOpLayout()
 
 
+def MinimizeLayoutTransform():
+    """Move the regions of elementwise and broadcast operators to the layout
+    that needs the fewest layout_transforms at their boundary.
+    AlterOpLayout and ConvertLayout choose the layout of each operator greedily,
+    which can leave such regions between two opposite layout_transforms, e.g.
+    NCHW16c -> NCHW and NCHW -> NCHW16c around an elementwise operator.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that minimizes the layout transforms.
+    """
+    return _ffi_api.MinimizeLayoutTransform()
+
+
 class LayoutConfig(object):
     """A structure for customizing the ConvertLayout pass."""
 
@@ -565,6 +637,46 @@ def RewriteAnnotatedOps(fallback_device):
     return _ffi_api.RewriteDeviceAnnotation(fallback_device)
 
 
+def PlanStaticMemory():
+    """Pack the storages of constant size allocated by the VM dialect into a few
+    arenas, reusing memory between storages whose live ranges do not overlap.
+
+    The VM compiler runs this pass when the ``relay.vm.plan_static_memory``
+    option of the pass context is set.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that plans the static allocations.
+    """
+    return _ffi_api.PlanStaticMemory()
+
+
+def Rematerialize(memory_budget):
+    """Recompute the intermediates of the dataflow functions kept alive the
+    longest, e.g. the forward activations read by a backward pass, until the
+    bytes live at once fit the budget.
+
+    The intermediates freeing the most bytes per multiply-accumulate recomputed
+    are picked first, the others stay checkpointed. The functions with let
+    bindings, conditions or closures are left untouched.
+
+    The build runs this pass after FuseOps when the
+    ``relay.backend.remat_memory_budget`` option of the pass context is positive.
+
+    Parameters
+    ----------
+    memory_budget : int
+        The bytes of intermediates allowed to be live at once.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that rematerializes the intermediates.
+    """
+    return _ffi_api.Rematerialize(memory_budget)
+
+
 def ToANormalForm():
     """Turn Graph Normal Form expression into A Normal Form Expression.
     The scope of the root expression is the global scope.
@@ -658,6 +770,11 @@ def ToGraphNormalForm():
 def EliminateCommonSubexpr(fskip=None):
     """Eliminate common subexpressions.
 
+    The calls to commutative operators with swapped arguments, the reshapes of an input to the
+    same shape, the transposes by the same permutation and the calls to equal primitive
+    functions are common subexpressions too. The bodies of the primitive functions are
+    visited, so the pass can run after FuseOps.
+
     Parameters
     ----------
     fskip: Callable
@@ -682,6 +799,13 @@ def PartialEvaluate():
     expression is provided. Otherwise, it will rely on the pass manager to
     carry out transformation.
 
+    The ``"relay.PartialEval"`` pass config bounds the evaluation: ``max_inlines``
+    function bodies are expanded at most, and the ones of more than
+    ``max_inline_size`` nodes are not, their calls are left to the runtime.
+    ``memoize`` evaluates the pure calls on static arguments once per arguments, and
+    ``record_specializations`` lists the calls expanded, memoized and left in the
+    ``"relay.partial_eval_specializations"`` attribute of each global function.
+
     Returns
     -------
     ret: tvm.transform.Pass
@@ -763,6 +887,38 @@ def DynamicToStatic():
     return _ffi_api.DynamicToStatic()
 
 
+def BucketDynamicShape(inputs, buckets, pad_value=0.0):
+    """Specialize the main function for buckets of the extent of a dynamic input dimension.
+
+    Main is copied once per bucket, with the dynamic dimension of the inputs typed as the
+    bucket upper bound, so that the kernels of each copy are compiled for a static extent. At
+    run time main pads the inputs to the smallest bucket the extent fits in, calls its copy and
+    slices the output dimensions of the bucket extent back. The extents beyond the last bucket
+    run the generic function.
+
+    The padding is only valid for the models whose outputs at the valid positions do not depend
+    on it, e.g. the models taking an attention mask bucketed along with the tokens.
+
+    Parameters
+    ----------
+    inputs : Dict[str, int]
+        The names of the inputs to bucket, mapped to their dynamic dimension. Every input is
+        padded to the bucket of the largest extent among them.
+
+    buckets : List[int]
+        The upper bounds of the buckets, e.g. ``[32, 64, 128, 256]``.
+
+    pad_value : float
+        The value the inputs are padded with.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass that buckets the dynamic shapes.
+    """
+    return _ffi_api.BucketDynamicShape(inputs, buckets, pad_value)
+
+
 def Inline():
     """Perform inlining on the given Relay IR module. The global functions that
     are marked as `inline` should be always inlined. A cost model will be
@@ -1147,6 +1303,20 @@ def SimplifyExpr():
     return _ffi_api.SimplifyExpr()
 
 
+def FuseAttention():
+    """
+    Rewrite the attention composed of nn.batch_matmul, nn.softmax and nn.batch_matmul,
+    with an optional multiplication or division of the scores by a constant scalar,
+    into the fused nn.attention operator.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered FuseAttention pass.
+    """
+    return _ffi_api.FuseAttention()
+
+
 def FoldExplicitPadding():
     """
     FoldExplicitPadding finds explict padding before an op that can support
@@ -1204,7 +1374,7 @@ def FakeQuantizationToInteger():
     return _ffi_api.FakeQuantizationToInteger()
 
 
-def ToMixedPrecision(mixed_precision_type="float16", missing_op_mode=1):
+def ToMixedPrecision(mixed_precision_type="float16", missing_op_mode=1, call_categories=None):
     """
     Automatic mixed precision rewriter. Rewrite an FP32 relay graph into a version
     where as many operations as possible are in the target mixed_precision_type.
@@ -1220,6 +1390,10 @@ def ToMixedPrecision(mixed_precision_type="float16", missing_op_mode=1):
         1: Allow missing ops but emit warnings.
         2: Allow missing ops and silently ignore them.
 
+    call_categories: Optional[Dict[tvm.relay.Call, int]]
+      The conversion category of some calls of the converted functions, replacing the one
+      of their op, e.g. MIXED_PRECISION_NEVER to keep a call in FP32.
+
     Returns
     -------
     ret : tvm.transform.Pass
@@ -1227,7 +1401,7 @@ def ToMixedPrecision(mixed_precision_type="float16", missing_op_mode=1):
     """
     if missing_op_mode < 0 or missing_op_mode > 2:
         raise ValueError("Missing op mode is either 0, 1, or 2")
-    return _ffi_api.ToMixedPrecision(mixed_precision_type, missing_op_mode)
+    return _ffi_api.ToMixedPrecision(mixed_precision_type, missing_op_mode, call_categories or {})
 
 
 def SplitArgs(max_function_args):
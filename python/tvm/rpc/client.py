@@ -19,6 +19,7 @@ import os
 import stat
 import socket
 import struct
+import sys
 import time
 
 import tvm._ffi
@@ -72,6 +73,29 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def call_async(self, func, *args):
+        """Call a remote function without waiting for its return.
+
+        Several calls can be in flight at the same time. The server runs them
+        in order, and any other request of the session first receives the
+        returns of the calls in flight.
+
+        Parameters
+        ----------
+        func : Function
+            A function of this session, e.g. from get_function or
+            a remote module.
+
+        args : list
+            The arguments of the call.
+
+        Returns
+        -------
+        future : RPCFuture
+            The pending result of the call.
+        """
+        return RPCFuture(_ffi_api.SendCall(func, *args))
+
     def device(self, dev_type, dev_id=0):
         """Construct a remote device.
 
@@ -230,6 +254,26 @@ class RPCSession(object):
         return self.device(15, dev_id)
 
 
+class RPCFuture(object):
+    """The pending result of a remote call sent by RPCSession.call_async.
+
+    Do not directly create the object, call RPCSession.call_async
+    """
+
+    def __init__(self, fwait):
+        self._fwait = fwait
+
+    def get(self):
+        """Wait for the return of the call.
+
+        Returns
+        -------
+        value : object
+            The return value of the call, the error of the call is raised.
+        """
+        return self._fwait()
+
+
 class LocalSession(RPCSession):
     """RPCSession interface backed by local environment.
 
@@ -276,6 +320,23 @@ class PopenSession(RPCSession):
         RPCSession.__init__(self, _popen_session(binary))
 
 
+class ShmSession(RPCSession):
+    """RPCSession to a new server process on the same host, over shared memory.
+
+    The requests and the array contents are copied through two rings in memory
+    shared with the server process, instead of a socket.
+
+    Parameters
+    ----------
+    capacity : int
+        The size in bytes of the ring of each direction, a power of two.
+    """
+
+    def __init__(self, capacity=1 << 24):
+        cmd = [sys.executable, "-m", "tvm.exec.rpc_shm_server"]
+        RPCSession.__init__(self, _ffi_api.CreateShmClient(capacity, *cmd))
+
+
 class TrackerSession(object):
     """Tracker client session.
 
@@ -314,6 +375,22 @@ class TrackerSession(object):
             raise RuntimeError("Invalid return value %s" % str(value))
         return value[1]
 
+    def preempt(self, addr):
+        """Ask a server to kill its current session.
+
+        Parameters
+        ----------
+        addr : Tuple[str, int]
+            The address of the server, as in the server_info of the summary.
+
+        Returns
+        -------
+        success : bool
+            Whether the tracker has a server with this address.
+        """
+        base.sendjson(self._sock, [base.TrackerCode.PREEMPT, list(addr)])
+        return base.recvjson(self._sock) == base.TrackerCode.SUCCESS
+
     def text_summary(self):
         """Get a text summary of the tracker."""
         data = self.summary()
@@ -35,6 +35,9 @@ import threading
 import multiprocessing
 import time
 import errno
+import json
+import signal
+import traceback
 import tvm._ffi
 
 from tvm._ffi.base import py_str
@@ -103,6 +106,17 @@ def _server_env(load_library, work_path=None):
         logger.info("Send linked module %s to client", path)
         return bytearray(open(path, "rb").read())
 
+    @tvm._ffi.register_func("tvm.rpc.server.measure_module", override=True)
+    def measure_module(file_name, arg_info, dev, config, timeout):
+        """Check and time a module uploaded in the workpath, in a child process if possible."""
+        path = temp.relpath(file_name)
+        arg_info = json.loads(arg_info)
+        config = json.loads(config)
+        status, value = _run_isolated(
+            lambda: _measure_module(path, arg_info, dev, **config), timeout
+        )
+        return json.dumps({"status": status, "value": value})
+
     libs = []
     load_library = load_library.split(":") if load_library else []
     for file_name in load_library:
@@ -113,6 +127,87 @@ def _server_env(load_library, work_path=None):
     return temp
 
 
+def _measure_module(
+    path,
+    arg_info,
+    dev,
+    number,
+    repeat,
+    min_repeat_ms,
+    f_preproc,
+    max_repeat=0,
+    max_rel_ci=0.02,
+    cutoff=0.0,
+):
+    """Load, check and time a module on random arguments."""
+    try:
+        m = _load_module(path)
+        time_f = m.time_evaluator(
+            m.entry_name,
+            dev,
+            number=number,
+            repeat=repeat,
+            min_repeat_ms=min_repeat_ms,
+            f_preproc=f_preproc,
+            max_repeat=max_repeat,
+            max_rel_ci=max_rel_ci,
+            cutoff=cutoff,
+        )
+    # pylint: disable=broad-except
+    except Exception:
+        return "load_error", traceback.format_exc()
+
+    try:
+        random_fill = tvm.get_global_func("tvm.contrib.random.random_fill", allow_missing=True)
+        assert random_fill, "Please make sure USE_RANDOM is ON in the config.cmake"
+        args = [tvm.nd.empty(shape, dtype, dev) for shape, dtype in arg_info]
+        for arg in args:
+            random_fill(arg)
+        dev.sync()
+        # First run for check that the kernel is correct
+        m.entry_func(*args)
+        dev.sync()
+        return "ok", list(time_f(*args).results)
+    # pylint: disable=broad-except
+    except Exception:
+        return "run_error", traceback.format_exc()
+
+
+def _run_isolated(func, timeout):
+    """Run func in a child process killed after timeout seconds.
+
+    The status of the result is "timeout" when the child is killed and "run_error"
+    when it exits without a result. func runs in the current process without fork.
+    """
+    if not hasattr(os, "fork"):
+        return func()
+    read_fd, write_fd = os.pipe()
+    pid = os.fork()
+    if pid == 0:
+        os.close(read_fd)
+        try:
+            result = func()
+        # pylint: disable=broad-except
+        except BaseException:
+            result = ("run_error", traceback.format_exc())
+        with os.fdopen(write_fd, "wb") as writer:
+            writer.write(json.dumps(result).encode())
+        os._exit(0)  # pylint: disable=protected-access
+
+    os.close(write_fd)
+    with os.fdopen(read_fd, "rb") as reader:
+        ready, _, _ = select.select([reader], [], [], timeout)
+        if not ready:
+            os.kill(pid, signal.SIGKILL)
+            os.waitpid(pid, 0)
+            return "timeout", None
+        data = reader.read()
+    _, exit_status = os.waitpid(pid, 0)
+    if not data:
+        return "run_error", "The measurement process exited with status %d" % exit_status
+    return tuple(json.loads(data.decode()))
+
+
 def _serve_loop(sock, addr, load_library, work_path=None):
     """Server loop"""
     sockfd = sock.fileno()
@@ -132,7 +227,20 @@ def _parse_server_opt(opts):
     return ret
 
 
-def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
+def _kill_session(server_proc):
+    """Kill the process of a session and its children."""
+    # pylint: disable=import-outside-toplevel
+    import psutil
+
+    parent = psutil.Process(server_proc.pid)
+    # terminate worker children
+    for child in parent.children(recursive=True):
+        child.terminate()
+    # terminate the worker
+    server_proc.terminate()
+
+
+def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr, ping_period=2):
     """Listening loop of the server."""
 
     def _accept_conn(listen_sock, tracker_conn, ping_period=2):
@@ -242,20 +350,44 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
         # close from our side.
         conn.close()
         # wait until server process finish or timeout
-        server_proc.join(opts.get("timeout", None))
+        tstart = time.time()
+        timeout = opts.get("timeout", None)
+        status = "ok"
+        while True:
+            elapsed = time.time() - tstart
+            wait_time = ping_period if timeout is None else min(ping_period, timeout - elapsed)
+            server_proc.join(max(wait_time, 0))
+            if not server_proc.is_alive():
+                break
+            elapsed = time.time() - tstart
+            if timeout is not None and elapsed >= timeout:
+                logger.info("Timeout in RPC session, kill..")
+                status = "timeout"
+                break
+            if tracker_conn:
+                try:
+                    base.sendjson(tracker_conn, [TrackerCode.UPDATE_INFO, {"serving": elapsed}])
+                    if base.recvjson(tracker_conn) == TrackerCode.PREEMPT:
+                        logger.info("RPC session preempted by the tracker, kill..")
+                        status = "preempted"
+                        break
+                except (socket.error, IOError):
+                    tracker_conn.close()
+                    tracker_conn = None
 
         if server_proc.is_alive():
-            logger.info("Timeout in RPC session, kill..")
-            # pylint: disable=import-outside-toplevel
-            import psutil
-
-            parent = psutil.Process(server_proc.pid)
-            # terminate worker children
-            for child in parent.children(recursive=True):
-                child.terminate()
-            # terminate the worker
-            server_proc.terminate()
+            _kill_session(server_proc)
+        elif server_proc.exitcode:
+            status = "error"
         work_path.remove()
+        if tracker_conn:
+            try:
+                info = {"last_session": {"time": time.time() - tstart, "status": status}}
+                base.sendjson(tracker_conn, [TrackerCode.UPDATE_INFO, info])
+                assert base.recvjson(tracker_conn) == TrackerCode.SUCCESS
+            except (socket.error, IOError):
+                tracker_conn.close()
+                tracker_conn = None
 
 
 def _connect_proxy_loop(addr, key, load_library):
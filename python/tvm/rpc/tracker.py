@@ -38,6 +38,16 @@ List of available APIs:
 - REQUEST: request a new resource from tracker
   - input: [TrackerCode.REQUEST, [key, user, priority]]
   - return: [TrackerCode.SUCCESS, [url, port, match-key]]
+- UPDATE_INFO: update the information of a server
+  - input: [TrackerCode.UPDATE_INFO, info-dict]
+  - return: TrackerCode.SUCCESS
+  - note: a server reports {"serving": seconds} periodically during a session,
+    the return is TrackerCode.PREEMPT if the session has to be killed.
+    It reports {"last_session": {"time": seconds, "status": status}} after it,
+    a status other than "ok" counts as a failure of the server.
+- PREEMPT: ask a server to kill its current session
+  - input: [TrackerCode.PREEMPT, [url, port]]
+  - return: TrackerCode.SUCCESS, or TrackerCode.FAIL if there is no such server
 """
 # pylint: disable=invalid-name
 
@@ -46,6 +56,7 @@ import heapq
 import logging
 import socket
 import threading
+import time
 import errno
 import struct
 import json
@@ -113,7 +124,11 @@ class Scheduler(object):
 
 
 class PriorityScheduler(Scheduler):
-    """Priority based scheduler, FIFO based on request order"""
+    """Priority based scheduler, FIFO based on request order.
+
+    A request gets the free resource with the lowest load score of its server,
+    the oldest one among equal scores.
+    """
 
     def __init__(self, key):
         self._key = key
@@ -124,11 +139,13 @@ class PriorityScheduler(Scheduler):
 
     def _schedule(self):
         while self._requests and self._values:
-            value = self._values.pop(0)
+            value = min(self._values, key=lambda x: x[0].load_score())
+            self._values.remove(value)
             item = heapq.heappop(self._requests)
             callback = item[-1]
             if callback(value[1:]):
                 value[0].pending_matchkeys.remove(value[-1])
+                value[0].num_active += 1
             else:
                 self._values.append(value)
 
@@ -172,6 +189,13 @@ class TCPEventHandler(tornado_util.TCPHandler):
         self.pending_matchkeys = set()
         self._tracker._connections.add(self)
         self.put_values = []
+        # load statistics of a server connection.
+        self.num_active = 0
+        self.num_sessions = 0
+        self.num_failures = 0
+        self.avg_session_time = 0.0
+        self.serving_time = None
+        self.preempt = False
 
     def name(self):
         """name of connection"""
@@ -179,7 +203,50 @@ class TCPEventHandler(tornado_util.TCPHandler):
 
     def summary(self):
         """Summary of this connection"""
-        return self._info
+        if self.num_sessions == 0 and self.num_active == 0:
+            return self._info
+        res = dict(self._info)
+        res["load"] = {
+            "active": self.num_active,
+            "sessions": self.num_sessions,
+            "failures": self.num_failures,
+            "avg_session_time": self.avg_session_time,
+            "serving_time": self.serving_time,
+        }
+        return res
+
+    def load_score(self):
+        """The expected time for this server to serve a new session, lower is better.
+
+        The average session time is inflated by the failure rate and the active sessions,
+        servers without finished sessions are tried first.
+        """
+        if self.num_sessions == 0:
+            return 0.0
+        health = (self.num_sessions - self.num_failures + 1.0) / (self.num_sessions + 1.0)
+        return self.avg_session_time * (self.num_active + 1) / health
+
+    def _update_load(self, info):
+        """Update the load statistics from the reports of a server, returns the reply."""
+        ret = TrackerCode.SUCCESS
+        if "serving" in info:
+            self.serving_time = info.pop("serving")
+            max_time = self._tracker.max_session_time
+            if self.preempt or (max_time is not None and self.serving_time > max_time):
+                logger.info("%s: preempt the session after %g s", self.name(), self.serving_time)
+                self.preempt = False
+                ret = TrackerCode.PREEMPT
+        if "last_session" in info:
+            last = info.pop("last_session")
+            self.serving_time = None
+            self.preempt = False
+            self.num_sessions += 1
+            if last["status"] != "ok":
+                self.num_failures += 1
+            # exponential moving average, the recent sessions are more representative.
+            alpha = 1.0 / min(self.num_sessions, 4)
+            self.avg_session_time += alpha * (last["time"] - self.avg_session_time)
+        return ret
 
     def _init_conn(self, message):
         """Initialize the connection"""
@@ -236,6 +303,8 @@ class TCPEventHandler(tornado_util.TCPHandler):
             key = args[1]
             port, matchkey = args[2]
             self.pending_matchkeys.add(matchkey)
+            # a server puts a new resource once its previous one is released.
+            self.num_active = max(self.num_active - 1, 0)
             # got custom address (from rpc server)
             if len(args) >= 4 and args[3] is not None:
                 value = (self, args[3], port, matchkey)
@@ -274,10 +343,16 @@ class TCPEventHandler(tornado_util.TCPHandler):
         elif code == TrackerCode.UPDATE_INFO:
             info = args[1]
             assert isinstance(info, dict)
-            if info["addr"][0] is None:
+            ret = self._update_load(info)
+            if "addr" in info and info["addr"][0] is None:
                 info["addr"][0] = self._addr[0]
             self._info.update(info)
-            self.ret_value(TrackerCode.SUCCESS)
+            self.ret_value(ret)
+        elif code == TrackerCode.PREEMPT:
+            if self._tracker.preempt(args[1]):
+                self.ret_value(TrackerCode.SUCCESS)
+            else:
+                self.ret_value(TrackerCode.FAIL)
         elif code == TrackerCode.SUMMARY:
             status = self._tracker.summary()
             self.ret_value([TrackerCode.SUCCESS, status])
@@ -296,8 +371,9 @@ class TCPEventHandler(tornado_util.TCPHandler):
 class TrackerServerHandler(object):
     """Tracker that tracks the resources."""
 
-    def __init__(self, sock, stop_key):
+    def __init__(self, sock, stop_key, max_session_time=None):
         self._scheduler_map = {}
+        self.max_session_time = max_session_time
         self._sock = sock
         self._sock.setblocking(0)
         self._ioloop = ioloop.IOLoop.current()
@@ -341,6 +417,15 @@ class TrackerServerHandler(object):
             for value in conn.put_values:
                 self._scheduler_map[key].remove(value)
 
+    def preempt(self, addr):
+        """Ask the server at addr to kill its current session."""
+        for conn in self._connections:
+            info = conn.summary()
+            if info.get("key", "").startswith("server") and list(info["addr"]) == list(addr):
+                conn.preempt = True
+                return True
+        return False
+
     def stop(self):
         """Safely stop tracker."""
         for conn in list(self._connections):
@@ -359,6 +444,10 @@ class TrackerServerHandler(object):
             res = conn.summary()
             if res.get("key", "").startswith("server"):
                 cinfo.append(res)
+                key = res["key"].split(":")[1]
+                if key in qinfo:
+                    qinfo[key]["servers"] = qinfo[key].get("servers", 0) + 1
+                    qinfo[key]["busy"] = qinfo[key].get("busy", 0) + conn.num_active
         return {"queue_info": qinfo, "server_info": cinfo}
 
     def run(self):
@@ -366,9 +455,9 @@ class TrackerServerHandler(object):
         self._ioloop.start()
 
 
-def _tracker_server(listen_sock, stop_key):
+def _tracker_server(listen_sock, stop_key, max_session_time):
     asyncio.set_event_loop(asyncio.new_event_loop())
-    handler = TrackerServerHandler(listen_sock, stop_key)
+    handler = TrackerServerHandler(listen_sock, stop_key, max_session_time)
     handler.run()
 
 
@@ -377,7 +466,7 @@ class PopenTrackerServerState(object):
 
     current = None
 
-    def __init__(self, host, port=9190, port_end=9199, silent=False):
+    def __init__(self, host, port=9190, port_end=9199, silent=False, max_session_time=None):
         if silent:
             logger.setLevel(logging.WARN)
 
@@ -397,16 +486,20 @@ class PopenTrackerServerState(object):
             raise ValueError("cannot bind to any port in [%d, %d)" % (port, port_end))
         logger.info("bind to %s:%d", host, self.port)
         sock.listen(1)
-        self.thread = threading.Thread(target=_tracker_server, args=(sock, self.stop_key))
+        self.thread = threading.Thread(
+            target=_tracker_server, args=(sock, self.stop_key, max_session_time)
+        )
         self.thread.start()
         self.host = host
 
 
-def _popen_start_tracker_server(host, port=9190, port_end=9199, silent=False):
+def _popen_start_tracker_server(
+    host, port=9190, port_end=9199, silent=False, max_session_time=None
+):
     # This is a function that will be sent to the
     # Popen worker to run on a separate process.
     # Create and start the server in a different thread
-    state = PopenTrackerServerState(host, port, port_end, silent)
+    state = PopenTrackerServerState(host, port, port_end, silent, max_session_time)
     PopenTrackerServerState.current = state
     # returns the port so that the main can get the port number.
     return (state.port, state.stop_key)
@@ -430,9 +523,14 @@ class Tracker(object):
 
     silent: bool, optional
         Whether run in silent mode
+
+    max_session_time: float, optional
+        The sessions running for longer than this number of seconds are preempted.
     """
 
-    def __init__(self, host="0.0.0.0", port=9190, port_end=9199, silent=False):
+    def __init__(
+        self, host="0.0.0.0", port=9190, port_end=9199, silent=False, max_session_time=None
+    ):
         if silent:
             logger.setLevel(logging.WARN)
         self.proc = PopenWorker()
@@ -444,6 +542,7 @@ class Tracker(object):
                 port,
                 port_end,
                 silent,
+                max_session_time,
             ],
         )
         # receive the port
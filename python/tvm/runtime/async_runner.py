@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Runner of the requests of an executor off the submitting thread."""
+import concurrent.futures
+
+from tvm._ffi.base import TVMError
+from . import _ffi_api
+
+
+class AsyncRunner(object):
+    """Run the requests of an executor on a worker thread.
+
+    The requests run in their submission order, one at a time, and their
+    results are delivered on a completion thread, so the submitting thread
+    prepares the next inputs while a request runs and the previous results
+    are processed.
+
+    Parameters
+    ----------
+    run : PackedFunc
+        The function running a request, e.g. the ``run_request`` function of
+        a graph executor module.
+
+    max_in_flight : int
+        The maximum number of requests submitted and not completed.
+    """
+
+    def __init__(self, run, max_in_flight=4):
+        self.module = _ffi_api.AsyncRunner(run, max_in_flight)
+        self.max_in_flight = max_in_flight
+        self._submit = self.module["submit"]
+        self._try_submit = self.module["try_submit"]
+        self._wait_all = self.module["wait_all"]
+        self._num_in_flight = self.module["num_in_flight"]
+
+    def submit(self, *args, callback=None, block=True):
+        """Submit a request.
+
+        Parameters
+        ----------
+        args : list
+            The arguments of the run function.
+
+        callback : Optional[Callable]
+            Called with the result of the request on the completion thread,
+            its return value is the result of the future.
+
+        block : bool
+            Whether to wait while max_in_flight requests are not completed.
+
+        Returns
+        -------
+        future : Optional[concurrent.futures.Future]
+            The future of the result, None when not blocking and the runner is full.
+        """
+        future = concurrent.futures.Future()
+
+        def _complete(result, error):
+            try:
+                if error:
+                    raise TVMError(error)
+                future.set_result(callback(result) if callback is not None else result)
+            except Exception as err:  # pylint: disable=broad-except
+                future.set_exception(err)
+
+        submit = self._submit if block else self._try_submit
+        if not submit(_complete, *args):
+            return None
+        return future
+
+    def wait_all(self):
+        """Wait for the completion of the submitted requests."""
+        self._wait_all()
+
+    @property
+    def num_in_flight(self):
+        """The number of requests submitted and not completed."""
+        return self._num_in_flight()
@@ -0,0 +1,54 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Configuration of the pages backing the CPU allocations."""
+from . import _ffi_api
+
+
+def config_huge_pages(mode="madvise", threshold=2 << 20):
+    """Back the large CPU allocations with huge pages
+
+    The tensors, parameters and storage pools of this size or more, allocated
+    after the call, are backed by huge pages when the system provides them,
+    which cuts the TLB misses of the kernels streaming over them. The mode can
+    also be set with the TVM_CPU_HUGE_PAGES and TVM_CPU_HUGE_PAGE_THRESHOLD
+    environment variables. It only has an effect on Linux.
+
+    Parameters
+    ----------
+    mode : str
+        "madvise" requests transparent huge pages, "hugetlb" maps 1GB then 2MB
+        pages of the hugetlbfs pool and falls back to "madvise" when the pool
+        is exhausted, "off" uses the default pages.
+
+    threshold : int
+        The size in bytes from which the allocations get huge pages, at least 2MB.
+    """
+    _ffi_api.cpu_configure_huge_pages(mode, threshold)
+
+
+def huge_page_stats():
+    """Report how much memory got huge pages
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The bytes mapped from hugetlbfs, advised as transparent huge pages and
+        refused huge pages since the start of the process; and the bytes of
+        the process the kernel currently backs with transparent huge pages
+        ("thp_resident_bytes") and hugetlbfs pages ("hugetlb_resident_bytes").
+    """
+    return {key: value.value for key, value in _ffi_api.cpu_huge_page_stats().items()}
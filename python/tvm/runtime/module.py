@@ -33,6 +33,59 @@ from . import _ffi_api
 # profile result of time evaluator
 ProfileResult = namedtuple("ProfileResult", ["mean", "results"])
 
+# profile result of the adaptive time evaluator, the outliers rejected from the results
+RobustProfileResult = namedtuple(
+    "RobustProfileResult", ["mean", "results", "median", "percentiles", "rel_ci", "outliers"]
+)
+
+
+def _quantile(sorted_costs, q):
+    """The q-quantile of sorted costs, interpolated linearly."""
+    pos = q * (len(sorted_costs) - 1)
+    lower = int(pos)
+    upper = min(lower + 1, len(sorted_costs) - 1)
+    return sorted_costs[lower] + (pos - lower) * (sorted_costs[upper] - sorted_costs[lower])
+
+
+def robust_profile_result(costs):
+    """Summarize the costs of repeated measurements, rejecting the outliers.
+
+    The outliers are the costs outside of the Tukey fences, 1.5 interquartile ranges away from
+    the quartiles, as the adaptive time evaluator does to decide when to stop repeating.
+
+    Parameters
+    ----------
+    costs : Sequence[float]
+        The costs of the repeated measurements.
+
+    Returns
+    -------
+    result : RobustProfileResult
+        The mean of the costs kept, the costs kept, their median, their 10th, 25th, 75th and
+        90th percentiles, the half width of the 95% confidence interval of their mean relative
+        to it, and the outliers.
+    """
+    sorted_costs = sorted(costs)
+    q1, q3 = _quantile(sorted_costs, 0.25), _quantile(sorted_costs, 0.75)
+    low, high = q1 - 1.5 * (q3 - q1), q3 + 1.5 * (q3 - q1)
+    results = tuple(c for c in costs if low <= c <= high)
+    outliers = tuple(c for c in costs if not low <= c <= high)
+    kept = sorted(results)
+    mean = sum(kept) / len(kept)
+    rel_ci = float("inf")
+    if len(kept) >= 2 and mean > 0:
+        var = sum((c - mean) ** 2 for c in kept) / (len(kept) - 1)
+        rel_ci = 1.96 * (var / len(kept)) ** 0.5 / mean
+    percentiles = {p: _quantile(kept, p / 100.0) for p in (10, 25, 75, 90)}
+    return RobustProfileResult(
+        mean=mean,
+        results=results,
+        median=_quantile(kept, 0.5),
+        percentiles=percentiles,
+        rel_ci=rel_ci,
+        outliers=outliers,
+    )
+
 
 class Module(object):
     """Runtime Module."""
@@ -169,7 +222,19 @@ class Module(object):
         """
         _ffi_api.ModuleSaveToFile(self, file_name, fmt)
 
-    def time_evaluator(self, func_name, dev, number=10, repeat=1, min_repeat_ms=0, f_preproc=""):
+    def time_evaluator(
+        self,
+        func_name,
+        dev,
+        number=10,
+        repeat=1,
+        min_repeat_ms=0,
+        f_preproc="",
+        max_repeat=0,
+        max_rel_ci=0.02,
+        warmup=1,
+        cutoff=0.0,
+    ):
         """Get an evaluator that measures time cost of running function.
 
         Parameters
@@ -200,37 +265,75 @@ class Module(object):
             will be automatically increased.
         f_preproc: str, optional
             The preprocess function name we want to execute before executing the time evaluator.
+            "cache_flush_cpu_non_first_arg" flushes the inputs from the CPU caches,
+            "cache_flush_cpu_buffer" evicts everything by writing over a large buffer.
+
+        max_repeat: int, optional
+            The maximum number of times to repeat the measurement. When it is larger than
+            `repeat`, the measurement is repeated past `repeat` until the 95% confidence interval
+            of the mean cost, outliers rejected, is within `max_rel_ci` of the mean.
+
+        max_rel_ci: float, optional
+            The target half width of the confidence interval, relative to the mean.
+
+        warmup: int, optional
+            The number of calls before the measurement, discarded.
+
+        cutoff: float, optional
+            The cost in seconds past which the measurement stops, e.g. a multiple of the best
+            cost known while tuning. The results then end with the first cost over the cutoff,
+            fewer than `repeat` of them. 0 never stops early.
 
         Note
         ----
-        The function will be invoked  (1 + number x repeat) times,
-        with the first call discarded in case there is lazy initialization.
+        The function will be invoked  (warmup + number x repeat) times,
+        with the first calls discarded in case there is lazy initialization.
 
         Returns
         -------
         ftimer : function
             The function that takes same argument as func and returns a ProfileResult.
-            The ProfileResult reports `repeat` time costs in seconds.
+            The ProfileResult reports `repeat` time costs in seconds. With `max_repeat`, it
+            returns a RobustProfileResult reporting the costs without the outliers, their
+            median and percentiles, and the confidence interval reached.
         """
         try:
-            feval = _ffi_api.RPCTimeEvaluator(
-                self,
-                func_name,
-                dev.device_type,
-                dev.device_id,
-                number,
-                repeat,
-                min_repeat_ms,
-                f_preproc,
-            )
+            if max_repeat > 0 or warmup != 1 or cutoff > 0:
+                feval = _ffi_api.RPCRobustTimeEvaluator(
+                    self,
+                    func_name,
+                    dev.device_type,
+                    dev.device_id,
+                    number,
+                    repeat,
+                    min_repeat_ms,
+                    f_preproc,
+                    max_repeat,
+                    max_rel_ci,
+                    warmup,
+                    cutoff,
+                )
+            else:
+                feval = _ffi_api.RPCTimeEvaluator(
+                    self,
+                    func_name,
+                    dev.device_type,
+                    dev.device_id,
+                    number,
+                    repeat,
+                    min_repeat_ms,
+                    f_preproc,
+                )
 
             def evaluator(*args):
                 """Internal wrapped evaluator."""
                 # Wrap feval so we can add more stats in future.
                 blob = feval(*args)
-                fmt = "@" + ("d" * repeat)
-                results = struct.unpack(fmt, blob)
-                mean = sum(results) / float(repeat)
+                num_results = len(blob) // struct.calcsize("d")
+                results = struct.unpack("@" + ("d" * num_results), blob)
+                if max_repeat > 0:
+                    return robust_profile_result(results)
+                mean = sum(results) / float(num_results)
                 return ProfileResult(mean=mean, results=results)
 
             return evaluator
@@ -269,7 +372,15 @@ class Module(object):
         is_dso_exportable = lambda m: (m.type_key == "llvm" or m.type_key == "c")
         return self._collect_from_import_tree(is_dso_exportable)
 
-    def export_library(self, file_name, fcompile=None, addons=None, workspace_dir=None, **kwargs):
+    def export_library(
+        self,
+        file_name,
+        fcompile=None,
+        addons=None,
+        workspace_dir=None,
+        compression_level=0,
+        **kwargs,
+    ):
         """
         Export the module and all imported modules into a single device library.
 
@@ -301,6 +412,13 @@ class Module(object):
             artifacts when exporting the module.
             If this is not provided a temporary dir will be created.
 
+        compression_level : int, optional
+            The zstd compression level of the binaries of the imported modules
+            embedded in the library, between 1 and 22. The binaries are
+            decompressed as they are loaded. The default 0 does not compress
+            them. Compressing requires TVM built with USE_ZSTD, and so does
+            loading the library.
+
         kwargs : dict, optional
             Additional arguments passed to fcompile
 
@@ -356,8 +474,15 @@ class Module(object):
                             object_format = "cu"
                     has_c_module = True
             path_obj = os.path.join(workspace_dir, f"lib{index}.{object_format}")
-            module.save(path_obj)
-            files.append(path_obj)
+            unit_files = []
+            if module.type_key == "llvm" and object_format == "o":
+                # the compilation units of a module built in parallel are emitted in parallel
+                unit_files = list(module.get_function("save_compile_units")(path_obj))
+            if unit_files:
+                files.extend(unit_files)
+            else:
+                module.save(path_obj)
+                files.append(path_obj)
             is_system_lib = (
                 module.type_key == "llvm" and module.get_function("__tvm_is_system_module")()
             )
@@ -379,13 +504,17 @@ class Module(object):
         if self.imported_modules:
             if enabled("llvm") and llvm_target_triple:
                 path_obj = os.path.join(workspace_dir, f"devc.{object_format}")
-                m = _ffi_api.ModulePackImportsToLLVM(self, is_system_lib, llvm_target_triple)
+                m = _ffi_api.ModulePackImportsToLLVM(
+                    self, is_system_lib, llvm_target_triple, compression_level
+                )
                 m.save(path_obj)
                 files.append(path_obj)
             else:
                 path_cc = os.path.join(workspace_dir, "devc.c")
                 with open(path_cc, "w") as f:
-                    f.write(_ffi_api.ModulePackImportsToC(self, is_system_lib))
+                    f.write(
+                        _ffi_api.ModulePackImportsToC(self, is_system_lib, compression_level)
+                    )
                 files.append(path_cc)
 
         # The imports could contain a c module but the object format could be tar
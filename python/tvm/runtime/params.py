@@ -67,3 +67,71 @@ def load_param_dict(param_bytes):
     if isinstance(param_bytes, (bytes, str)):
         param_bytes = bytearray(param_bytes)
     return _ffi_api.LoadParams(param_bytes)
+
+
+def save_mapped_param_dict(params, path):
+    """Save parameter dictionary to a file which can be memory mapped.
+
+    Unlike :py:func:`save_param_dict`, the tensors are aligned in the file so
+    that :py:func:`load_mapped_param_dict` and the GraphModule API
+    "load_mapped_params" can use them in place without copying them.
+
+    Parameters
+    ----------
+    params : dict of str to NDArray
+        The parameter dictionary.
+
+    path : str
+        The file to write.
+    """
+    transformed = {k: ndarray.array(v) for (k, v) in params.items()}
+    _ffi_api.SaveMappedParams(path, transformed)
+
+
+def load_mapped_param_dict(path):
+    """Load parameter dictionary from a file written by :py:func:`save_mapped_param_dict`.
+
+    The file is mapped copy-on-write and the returned CPU arrays point into the
+    mapping, so processes loading the same file share its memory until they
+    modify it.
+
+    Parameters
+    ----------
+    path : str
+        The file to load.
+
+    Returns
+    -------
+    params : dict of str to NDArray
+        The parameter dictionary.
+    """
+    return _ffi_api.LoadMappedParams(path)
+
+
+def constant_store_stats():
+    """Get the size of the process-wide store of the shared parameters.
+
+    The parameters loaded with ``share=True`` by the executors, and the
+    constants of the VMs sharing their constants, are kept once per content
+    in the store.
+
+    Returns
+    -------
+    num_arrays : int
+        The number of distinct arrays in the store.
+
+    num_bytes : int
+        The number of bytes of the arrays, on all devices.
+    """
+    return int(_ffi_api.ConstantStoreSize()), int(_ffi_api.ConstantStoreNumBytes())
+
+
+def prune_constant_store():
+    """Release the arrays of the constant store no executor refers to anymore.
+
+    Returns
+    -------
+    num_bytes : int
+        The number of bytes released.
+    """
+    return int(_ffi_api.ConstantStorePrune())
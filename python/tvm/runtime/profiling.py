@@ -16,6 +16,8 @@
 # under the License.
 """Registration of profiling objects in python."""
 
+import json
+
 from .. import _ffi
 from . import Object
 
@@ -33,6 +35,9 @@ class Report(Object):
 
     device_metrics : Dict[Device, Dict[str, Object]]
         Per-device metrics collected over the entire run.
+
+    timeline : Array[Dict[str, Object]]
+        Regions of time recorded when profiling with a timeline, ordered by start.
     """
 
     def csv(self):
@@ -46,3 +51,96 @@ class Report(Object):
             `calls` in CSV format.
         """
         return AsCSV(self)
+
+    def chrome_trace(self):
+        """Convert the timeline of this report into the Chrome trace event format.
+
+        The timeline is only recorded when profiling with ``timeline=True``. The
+        result can be loaded in chrome://tracing or https://ui.perfetto.dev.
+
+        Returns
+        -------
+        trace : str
+            The timeline as Chrome trace JSON.
+        """
+        return AsChromeTrace(self)
+
+    def perfetto(self):
+        """Convert the timeline of this report into a binary Perfetto trace.
+
+        Returns
+        -------
+        trace : bytes
+            The timeline as a serialized ``perfetto.protos.Trace``.
+        """
+        return AsPerfetto(self)
+
+
+@_ffi.register_object("runtime.profiling.MetricCollector")
+class MetricCollector(Object):
+    """Interface for user defined profiling metric collection."""
+
+
+@_ffi.register_object("runtime.profiling.PerfEventCollector")
+class PerfEventCollector(MetricCollector):
+    """Collect CPU hardware counters with Linux perf_event_open.
+
+    The counters of every thread of the process are summed. Counters are not
+    collected, with a warning, when the kernel does not allow it (see
+    /proc/sys/kernel/perf_event_paranoid).
+
+    Parameters
+    ----------
+    events : Optional[List[str]]
+        Names of the events to collect, as listed by ``perf list``, e.g.
+        "cycles", "instructions", "cache-misses", "branch-misses" or
+        "LLC-load-misses". Defaults to these five.
+    """
+
+    def __init__(self, events=None):
+        self.__init_handle_by_constructor__(
+            _ffi.get_global_func("runtime.profiling.PerfEventCollector"), events or []
+        )
+
+
+@_ffi.register_object("runtime.profiling.CuptiCollector")
+class CuptiCollector(MetricCollector):
+    """Collect CUDA hardware events with CUPTI.
+
+    Only available when TVM is built with USE_CUPTI.
+
+    Parameters
+    ----------
+    events : Optional[List[str]]
+        Names of the CUPTI events to collect, e.g. "inst_executed" or
+        "fb_subp0_read_sectors". Events not available on a device are skipped.
+    """
+
+    def __init__(self, events=None):
+        self.__init_handle_by_constructor__(
+            _ffi.get_global_func("runtime.profiling.CuptiCollector"), events or []
+        )
+
+
+def device_memory_usage():
+    """Report the device memory allocated by the runtime.
+
+    The tensors, the blocks of the workspace, VM and texture pools, cached
+    ones included, are accounted per device, with their live bytes, the peak
+    of the live bytes since :py:func:`reset_device_memory_peak` and the number
+    of allocations. The usage is split by category ("params", "activations",
+    "workspace", "vm_pool", "texture" and "ndarray" for the tensors allocated
+    outside of an executor) and by executor ("graph_executor", "vm" or "none").
+
+    Returns
+    -------
+    usage : Dict[str, Dict]
+        The "total", "by_category" and "by_executor" usage of each device,
+        keyed by the device, e.g. "cpu(0)".
+    """
+    return json.loads(DeviceMemoryUsage())
+
+
+def reset_device_memory_peak():
+    """Restart tracking the peaks of :py:func:`device_memory_usage` from the live bytes."""
+    ResetDeviceMemoryPeak()
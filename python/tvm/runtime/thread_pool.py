@@ -0,0 +1,155 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Configuration of the CPU thread pools used by parallel kernels."""
+from . import _ffi_api
+from .container import ShapeTuple
+
+
+def config_thread_pool(mode=1, nthreads=0, policy="static", chunks_per_worker=1):
+    """Configure the default thread pool of the calling thread.
+
+    Parameters
+    ----------
+    mode : int
+        The preferred CPU type, 1 for big cores and -1 for little cores.
+
+    nthreads : int
+        The number of workers to use, 0 uses all of them.
+
+    policy : str
+        How the tasks of a parallel region are distributed, "static" or "work_stealing".
+
+    chunks_per_worker : int
+        The number of tasks per worker a parallel region is split into in "work_stealing"
+        mode. Kernels that use a parallel barrier require 1.
+    """
+    _ffi_api.config_threadpool(mode, nthreads, policy, chunks_per_worker)
+
+
+def config_nested_parallel(enable):
+    """Let parallel regions launched from inside a running task use idle workers.
+
+    Parameters
+    ----------
+    enable : bool
+        If False, such regions run serially on the calling worker.
+    """
+    _ffi_api.config_threadpool_nested(enable)
+
+
+def config_idle_policy(policy="adaptive", max_spin_ns=200000):
+    """Configure how the idle workers of the default thread pool wait for work.
+
+    Parameters
+    ----------
+    policy : str
+        "fixed" yields TVM_THREAD_POOL_SPIN_COUNT times before parking. "adaptive" learns
+        the idle gap between parallel regions and spins, yields or parks to match it.
+
+    max_spin_ns : int
+        The longest a worker spins in "adaptive" mode before it parks.
+    """
+    _ffi_api.config_threadpool_idle(policy, max_spin_ns)
+
+
+def thread_pool_stats():
+    """Get the counters of the default thread pool of the calling thread.
+
+    Returns
+    -------
+    stats : Dict[str, Object]
+        The counters, such as the number of serialized nested launches,
+        the accumulated wakeup latency and the spin time wasted before parking.
+    """
+    return _ffi_api.threadpool_stats()
+
+
+def create_thread_pool(name, cpus=None, numa_node=None):
+    """Create a named thread pool with one worker bound to each given cpu.
+
+    Executors can be attached to the pool, e.g. with
+    :py:meth:`tvm.contrib.graph_executor.GraphModule.set_thread_pool`, so that
+    models co-located in one process do not share workers.
+
+    Parameters
+    ----------
+    name : str
+        The name of the pool.
+
+    cpus : Optional[List[int]]
+        The cpu ids to bind the workers to.
+
+    numa_node : Optional[int]
+        Use all cpus of this NUMA node instead of an explicit list. The buffers
+        the workers and the attached executors allocate while running are then
+        placed on the node.
+    """
+    if (cpus is None) == (numa_node is None):
+        raise ValueError("Exactly one of cpus and numa_node must be given")
+    _ffi_api.threadpool_create(
+        name, ShapeTuple(cpus or []), -1 if numa_node is None else numa_node
+    )
+
+
+def numa_node_count():
+    """Get the number of NUMA nodes of the system.
+
+    Returns
+    -------
+    count : int
+        The number of nodes, 1 if it cannot be determined.
+    """
+    return _ffi_api.numa_node_count()
+
+
+class NUMAAllocScope:
+    """Place the CPU allocations of the calling thread on a NUMA node
+
+    Executors created in the scope allocate their storage on the node, among
+    which the weights copied in with set_input or load_params. Creating one
+    executor per node in the scope of the node, attached to a pool created
+    with ``create_thread_pool(name, numa_node=node)``, keeps a replica of the
+    weights local to each socket. Executors sharing their weights with
+    share_params read them from the node of their owner instead.
+
+    Parameters
+    ----------
+    numa_node : int
+        The id of the NUMA node.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        for node in range(numa_node_count()):
+            create_thread_pool("node%d" % node, numa_node=node)
+            with NUMAAllocScope(node):
+                mod = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+                mod.load_params(params_bytes)
+            mod.set_thread_pool("node%d" % node)
+    """
+
+    def __init__(self, numa_node):
+        self.numa_node = numa_node
+        self._prev = -1
+
+    def __enter__(self):
+        self._prev = _ffi_api.numa_set_alloc_node(self.numa_node)
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        _ffi_api.numa_set_alloc_node(self._prev)
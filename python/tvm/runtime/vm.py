@@ -20,6 +20,8 @@ The Relay Virtual Machine runtime.
 
 Implements a Python interface to executing the compiled VM object.
 """
+import json
+
 import numpy as np
 
 import tvm
@@ -28,6 +30,7 @@ from tvm._ffi.runtime_ctypes import TVMByteArray
 from tvm._ffi import base as _base
 from .object import Object
 from . import _ffi_api, container
+from .async_runner import AsyncRunner
 from ..rpc.base import RPC_SESS_MASK
 
 
@@ -194,6 +197,21 @@ class Executable(object):
         """
         return self._get_stats()
 
+    @property
+    def num_loaded_sections(self):
+        """Get the number of constants and functions which have been deserialized.
+
+        A loaded executable only deserializes its constants and the bytecode of
+        its functions when they are first used.
+
+        Returns
+        -------
+        ret : Tuple[int, int]
+            The number of loaded constants and functions.
+        """
+        loaded = self.mod["get_num_loaded_sections"]()
+        return (int(loaded[0]), int(loaded[1]))
+
     @property
     def primitive_ops(self):
         """Get the name of the primitive ops contained in the executable.
@@ -290,7 +308,7 @@ class VirtualMachine(object):
 
     memory_cfg : str or Dict[tvm.runtime.Device, str], optional
         Config the type of memory allocator. The allocator type can be ["naive",
-        "pooled"]. If memory_cfg is None, all devices will use pooled allocator
+        "pooled", "size_class"]. If memory_cfg is None, all devices will use pooled allocator
         by default. If memory_cfg is string, all devices will use the specified
         allocator type. If memory_cfg is a dict, each device uses the allocator
         type specified in the dict, or pooled allocator if not specified in the
@@ -299,6 +317,12 @@ class VirtualMachine(object):
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    SIZE_CLASS_ALLOCATOR = 3
+    _ALLOCATOR_TYPES = {
+        "naive": NAIVE_ALLOCATOR,
+        "pooled": POOLED_ALLOCATOR,
+        "size_class": SIZE_CLASS_ALLOCATOR,
+    }
 
     def __init__(self, exe, device, memory_cfg=None):
         """
@@ -338,7 +362,12 @@ class VirtualMachine(object):
         if not isinstance(exe, Executable):
             exe = Executable(exe)
 
-        self.module = exe.mod["vm_load_executable"]()
+        self._bind_module(self._load_executable(exe), exe)
+        self._setup_device(device, memory_cfg)
+
+    def _bind_module(self, module, exe):
+        """Get the functions of the runtime VirtualMachine module."""
+        self.module = module
         self._exec = exe
         self._init = self.module["init"]
         self._invoke = self.module["invoke"]
@@ -346,7 +375,28 @@ class VirtualMachine(object):
         self._get_output = self.module["get_output"]
         self._get_num_outputs = self.module["get_num_outputs"]
         self._set_input = self.module["set_input"]
-        self._setup_device(device, memory_cfg)
+        self._async_runner = None
+
+    def clone(self):
+        """Create a VM running the same executable, e.g. one per serving thread.
+
+        The clone shares the devices, allocators, configuration, kernels and
+        device constants of this VM, and only owns its frames, registers, inputs
+        and outputs, so it is cheap to create. It does not sample latencies nor
+        return the outputs bound by :py:func:`set_outputs`.
+
+        Returns
+        -------
+        vm : VirtualMachine
+            The new VM.
+        """
+        vm = VirtualMachine.__new__(VirtualMachine)
+        vm._bind_module(self.module["clone"](), self._exec)
+        return vm
+
+    def _load_executable(self, exe):
+        """Create the runtime VirtualMachine module of an executable."""
+        return exe.mod["vm_load_executable"]()
 
     def _setup_device(self, dev, memory_cfg):
         """Init devices and allocators."""
@@ -367,9 +417,8 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
-            if memory_cfg == "naive":
-                default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            assert memory_cfg in VirtualMachine._ALLOCATOR_TYPES
+            default_alloc_type = VirtualMachine._ALLOCATOR_TYPES[memory_cfg]
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -381,6 +430,8 @@ class VirtualMachine(object):
             init_args.append(device.device_type % RPC_SESS_MASK)
             init_args.append(device.device_id)
             alloc_type = memory_cfg[device] if device in memory_cfg else default_alloc_type
+            if isinstance(alloc_type, str):
+                alloc_type = VirtualMachine._ALLOCATOR_TYPES[alloc_type]
             init_args.append(alloc_type)
         self._init(*init_args)
 
@@ -398,6 +449,10 @@ class VirtualMachine(object):
         kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
             Named arguments to the function.
         """
+        self._set_input(func_name, *self._convert_args(func_name, args, kwargs))
+
+    def _convert_args(self, func_name, args, kwargs):
+        """Convert the positional and named arguments of a function, in order."""
         if kwargs:
             # kwargs is a super set of the required function parameters. We
             # only find the ones that are needed.
@@ -416,8 +471,26 @@ class VirtualMachine(object):
                     new_args[i] = args[idx]
                     idx += 1
             args = new_args
-        cargs = convert(args)
-        self._set_input(func_name, *cargs)
+        return convert(args)
+
+    def set_outputs(self, func_name, *outputs):
+        """Have the invocations of a function return the given arrays
+
+        The kernels write the outputs into the arrays instead of the tensors
+        the function allocates, which saves copying them out of the results.
+        The functions with control flow, and the outputs that are parameters,
+        constants or reshapes, cannot be bound.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        outputs : list[tvm.runtime.NDArray]
+            The arrays, one per output, of the shape, type and device of the
+            outputs. No arrays to allocate the outputs again.
+        """
+        self.module["set_outputs"](func_name, *outputs)
 
     def invoke(self, func_name, *args, **kwargs):
         """Invoke a function.
@@ -460,6 +533,165 @@ class VirtualMachine(object):
         """
         return self.invoke("main", *args, **kwargs)
 
+    def set_async_depth(self, max_in_flight):
+        """Set the maximum number of requests of :py:func:`invoke_async` not completed.
+
+        Parameters
+        ----------
+        max_in_flight : int
+            The maximum number of requests submitted and not completed, 4 by default.
+        """
+        if self._async_runner is not None:
+            self._async_runner.wait_all()
+        self._async_runner = AsyncRunner(self.module["invoke_with_args"], max_in_flight)
+
+    def invoke_async(self, func_name, *args, callback=None, block=True, **kwargs):
+        """Invoke a function on a worker thread.
+
+        The requests run one at a time in their submission order, with their own
+        arguments, so the caller prepares the next request while one runs. They
+        must not be mixed with the synchronous calls on this VM before
+        :py:func:`wait_async` returns, use :py:func:`clone` for those.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The arguments to the function.
+
+        callback : Optional[Callable]
+            Called on the completion thread with the output, its return value
+            is the result of the future.
+
+        block : bool
+            Whether to wait while the maximum number of requests are not completed.
+
+        kwargs: dict of str to tvm.runtime.NDArray or np.ndarray
+            Named arguments to the function.
+
+        Returns
+        -------
+        future : Optional[concurrent.futures.Future]
+            The future of the output, None when not blocking and the queue is full.
+        """
+        if self._async_runner is None:
+            self.set_async_depth(4)
+        cargs = self._convert_args(func_name, args, kwargs)
+        return self._async_runner.submit(func_name, *cargs, callback=callback, block=block)
+
+    def run_async(self, *args, callback=None, block=True, **kwargs):
+        """Invoke the main function on a worker thread, see :py:func:`invoke_async`."""
+        return self.invoke_async("main", *args, callback=callback, block=block, **kwargs)
+
+    def wait_async(self):
+        """Wait for the completion of the requests of :py:func:`invoke_async`."""
+        if self._async_runner is not None:
+            self._async_runner.wait_all()
+
+    def set_thread_pool(self, name):
+        """Run the kernels invoked by this VM on a named thread pool.
+
+        Parameters
+        ----------
+        name : str
+            The name of a pool created by :py:func:`tvm.runtime.thread_pool.create_thread_pool`,
+            or an empty string for the default pool of the calling thread.
+        """
+        self.module["set_thread_pool"](name)
+
+    def share_constants(self, share=True):
+        """Intern the tensor constants in the process-wide constant store.
+
+        The VMs of the process sharing their constants keep a single copy of
+        the identical ones per device, e.g. the common weights of the variants
+        of a model. Must be called before the first invocation.
+
+        Parameters
+        ----------
+        share : bool
+            Whether to share the constants.
+        """
+        self.module["share_constants"](share)
+
+    def configure_dispatch(self, superinstructions=False, threaded=False):
+        """Configure how the interpreter dispatches bytecode.
+
+        Parameters
+        ----------
+        superinstructions : bool
+            Execute runs of allocations followed by a packed call as a single
+            fused step, skipping the registers of storages used only inside the run.
+
+        threaded : bool
+            Jump directly from one instruction handler to the next instead of
+            returning to a central switch. Only available with compilers that
+            support computed goto, otherwise a warning is emitted and it is ignored.
+        """
+        self.module["configure_dispatch"](superinstructions, threaded)
+
+    def set_sampling_interval(self, interval):
+        """Time the kernels of one invocation out of interval
+
+        The latencies are accumulated in per-kernel histograms which can be
+        read at any time with :py:func:`get_sampling_stats`. The other
+        invocations are only counted, so this can be left on in deployment.
+
+        Parameters
+        ----------
+        interval : int
+            Sample one invocation every interval, 0 disables sampling. Resets the
+            histograms.
+        """
+        self.module["set_sampling_interval"](interval)
+
+    def get_sampling_stats(self):
+        """Get the latencies of the sampled invocations
+
+        Returns
+        -------
+        stats : dict
+            The number of runs under "invocations", the latency of the sampled
+            invocations under "total" and the latency of each kernel under "ops".
+            Each latency has a "count" of samples and the "mean_us", "p50_us"
+            and "p99_us" statistics in microseconds.
+        """
+        return json.loads(self.module["get_sampling_stats"]())
+
+    def set_result_cache(self, max_bytes, func_names):
+        """Memoize the results of functions for repeated arguments
+
+        The result of a call to one of the functions, from another function
+        or from :py:func:`invoke`, is kept in a cache keyed by the content of
+        the tensor arguments. A call with arguments seen before returns the
+        cached result without running the function, the cached tensors are
+        shared and must not be written to. The entries are evicted in LRU
+        order. Invocations of a function with outputs set by
+        :py:func:`set_outputs` are not cached.
+
+        Parameters
+        ----------
+        max_bytes : int
+            The size of the cache in bytes, the arguments included. 0 disables
+            the cache. Clears the cache and its statistics.
+
+        func_names : list of str
+            The names of the global functions whose results are cached.
+        """
+        self.module["set_result_cache"](max_bytes, func_names)
+
+    def get_result_cache_stats(self):
+        """Get the statistics of the result cache
+
+        Returns
+        -------
+        stats : dict
+            The "hits", "misses", "evictions" and "hit_rate" of the lookups, and
+            the "entries" and "bytes" held out of "max_bytes".
+        """
+        return json.loads(self.module["get_result_cache_stats"]())
+
     def invoke_stateful(self, func_name, *args, **kwargs):
         """Invoke a function and ignore the returned result.
 
@@ -490,3 +722,137 @@ class VirtualMachine(object):
         outputs : List[NDArray]
         """
         return [self._get_output(i) for i in range(self._get_num_outputs())]
+
+
+def size_class_allocator_stats(device):
+    """Report the memory held by the size class allocator of a device.
+
+    Parameters
+    ----------
+    device : tvm.runtime.Device
+        A device whose VM allocator was created with ``memory_cfg="size_class"``.
+
+    Returns
+    -------
+    stats : Dict[str, float]
+        Byte counters, and the internal (rounding) and external (pooled free
+        memory) fragmentation as fractions.
+    """
+    return json.loads(_ffi_api.SizeClassAllocatorStats(device.device_type, device.device_id))
+
+
+class RequestBatcher(object):
+    """Coalesce concurrent requests to a VM function into batched invocations.
+
+    Requests submitted from several threads within the latency budget are
+    concatenated along their leading axis and run as a single invocation; the
+    outputs are split back per request. The function must accept and return
+    tensors with a dynamic leading batch dimension.
+
+    Parameters
+    ----------
+    vm : VirtualMachine
+        The virtual machine running the function. It must not be used
+        directly while the batcher is serving requests.
+
+    func_name : str
+        The name of the function to invoke.
+
+    max_batch_size : int
+        The maximum number of rows of a batched invocation.
+
+    timeout_us : int
+        How long, in microseconds, the oldest request waits for others to join.
+    """
+
+    def __init__(self, vm, func_name="main", max_batch_size=8, timeout_us=1000):
+        self.module = _ffi_api._VirtualMachineBatcher(
+            vm.module, func_name, max_batch_size, timeout_us
+        )
+        self._submit = self.module["submit"]
+
+    def submit(self, *args):
+        """Run one request, blocking until its batch has been executed.
+
+        Parameters
+        ----------
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The inputs of the request, each with a leading batch dimension.
+
+        Returns
+        -------
+        result : Object
+            The outputs of this request.
+        """
+        cargs = []
+        for arg in args:
+            if isinstance(arg, np.ndarray):
+                arg = tvm.nd.array(arg)
+            cargs.append(arg)
+        return self._submit(*cargs)
+
+    def stats(self):
+        """The number of batched invocations and of requests served so far."""
+        return {k: v.value for k, v in self.module["get_stats"]().items()}
+
+
+@tvm._ffi.register_object("vm.KVCache")
+class KVCache(Object):
+    """A preallocated tensor growing along its leading axis, e.g. the past
+    keys or values of an autoregressive decoder.
+
+    Appending the rows of a decoding step only copies them into the reserved
+    buffer, which is reallocated with twice the capacity once full. A cache
+    given as a VM input is passed as the view of its filled rows, without a
+    copy, so the invocations of the steps neither concatenate nor reallocate
+    the past rows.
+
+    Parameters
+    ----------
+    init_data : tvm.runtime.NDArray or numpy.ndarray
+        The rows the cache starts with. The cache is on its device.
+
+    capacity : int
+        The number of rows reserved.
+    """
+
+    def __init__(self, init_data, capacity):
+        if isinstance(init_data, np.ndarray):
+            init_data = tvm.nd.array(init_data)
+        self.__init_handle_by_constructor__(
+            tvm._ffi.get_global_func("vm.builtin.kv_cache_create"), init_data, capacity
+        )
+
+    def append(self, value):
+        """Append rows to the cache.
+
+        Parameters
+        ----------
+        value : tvm.runtime.NDArray or numpy.ndarray
+            The rows, of the shape of the cache except for the leading axis.
+        """
+        if isinstance(value, np.ndarray):
+            value = tvm.nd.array(value)
+        tvm._ffi.get_global_func("vm.builtin.kv_cache_append")(self, value)
+
+    def view(self):
+        """View the filled rows, sharing the memory of the cache.
+
+        Returns
+        -------
+        view : tvm.runtime.NDArray
+            The filled rows.
+        """
+        return tvm._ffi.get_global_func("vm.builtin.kv_cache_view")(self)
+
+    def reset(self):
+        """Empty the cache, keeping its buffer for the next sequence."""
+        tvm._ffi.get_global_func("vm.builtin.kv_cache_reset")(self)
+
+    def __len__(self):
+        return tvm._ffi.get_global_func("vm.builtin.kv_cache_fill_count")(self)
+
+    @property
+    def capacity(self):
+        """The number of rows the buffer holds."""
+        return tvm._ffi.get_global_func("vm.builtin.kv_cache_capacity")(self)
@@ -1022,6 +1022,30 @@ def asscript(input_ir, show_meta=False):
     return _ffi_api.AsTVMScript(input_ir, show_meta)
 
 
+def save_script(input_ir, file_name, show_meta=False, num_threads=0):
+    """Write a PrimFunc or IRModule to a file as python syntax script
+
+    The functions of a module are printed in parallel and written in order,
+    the script is the one of :py:func:`asscript`.
+
+    Parameters
+    ----------
+    input_ir : Union[PrimFunc, IRModule]
+        The PrimFunc or IRModule to be dumped
+
+    file_name : str
+        The file to write to
+
+    show_meta : bool
+        Whether show meta
+
+    num_threads : int
+        The number of functions printed at once, 0 for the number of cores
+    """
+
+    _ffi_api.SaveTVMScript(input_ir, file_name, show_meta, num_threads)
+
+
 def tir(script_in):
     """Decorate a python function or class as tvm script.
 
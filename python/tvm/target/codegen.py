@@ -74,3 +74,22 @@ def llvm_version_major(allow_none=False):
         if allow_none:
             return None
         raise RuntimeError("LLVM version is not available, please check if you build with LLVM")
+
+
+def llvm_write_pgo_profile(module, filename):
+    """Write the profile collected by an instrumented LLVM module.
+
+    The module is built with the ``tir.llvm_pgo_instrument`` PassContext option and run on
+    representative inputs. The profile written to `filename` is then attached to a rebuild of
+    the same IRModule with the ``tir.llvm_pgo_profile`` option, which gives the LLVM passes the
+    branch probabilities and loop trip counts of the profiling runs.
+
+    Parameters
+    ----------
+    module : runtime.Module
+        The instrumented LLVM module.
+
+    filename : str
+        The path of the indexed profile to write.
+    """
+    module.get_function("write_pgo_profile")(filename)
@@ -168,3 +168,21 @@ def detect_buffer_access_lca(func: PrimFunc) -> Dict[Buffer, Stmt]:
         Map from buffer to the LCA of all access to it.
     """
     return _ffi_api.detect_buffer_access_lca(func)  # pylint: disable=no-member
+
+
+def shared_memory_bank_conflicts(func: PrimFunc) -> Dict[Buffer, int]:
+    """Estimate the bank conflicts of the shared buffers of a function before StorageFlatten.
+
+    The accesses are evaluated for the lanes of the first warp, the other variables being 0.
+
+    Parameters
+    ----------
+    func: tvm.tir.PrimFunc
+        The function, with its shared buffers realized.
+
+    Returns
+    -------
+    result : Dict[Buffer, int]
+        The worst bank conflict degree of the warp accesses of each shared buffer, 1 for none.
+    """
+    return _ffi_api.shared_memory_bank_conflicts(func)  # pylint: disable=no-member
@@ -26,6 +26,7 @@ from tvm.tir import Block, For, IntImm, PrimFunc, Var
 
 from . import _ffi_api_schedule
 from .state import ScheduleState, StmtSRef
+from .trace import Trace
 
 
 @register_error
@@ -71,6 +72,7 @@ class Schedule(Object):
         *,
         debug_mode: Union[bool, int] = False,
         error_render_level: str = "detail",
+        traced: bool = False,
     ):
         """Construct a concrete TensorIR schedule from an IRModule or a PrimFunc
 
@@ -86,6 +88,9 @@ class Schedule(Object):
             "detail": Render a detailed error message, with the TIR and error locations printed
             "fast: Show a simple error message without rendering or string manipulation
             "none": Do not show any error message.
+        traced : bool = False
+            Record each schedule primitive applied into the trace of the schedule, which can be
+            replayed on another schedule of the same IRModule
 
         Note
         ----------
@@ -106,8 +111,12 @@ class Schedule(Object):
                 + f"{error_render_level}"
             )
         error_render_level = Schedule.ERROR_RENDER_LEVEL.get(error_render_level)  # type: ignore
+        if traced:
+            constructor = _ffi_api_schedule.TracedSchedule  # type: ignore # pylint: disable=no-member
+        else:
+            constructor = _ffi_api_schedule.ConcreteSchedule  # type: ignore # pylint: disable=no-member
         self.__init_handle_by_constructor__(
-            _ffi_api_schedule.ConcreteSchedule,  # type: ignore # pylint: disable=no-member
+            constructor,
             func_or_mod,
             debug_mode,
             error_render_level,
@@ -125,6 +134,11 @@ class Schedule(Object):
         """Returns the ScheduleState in the current schedule class"""
         return _ffi_api_schedule.ScheduleGetState(self)  # type: ignore # pylint: disable=no-member
 
+    @property
+    def trace(self) -> Optional[Trace]:
+        """Returns the trace of the schedule, or None if the schedule is not traced"""
+        return _ffi_api_schedule.ScheduleGetTrace(self)  # type: ignore # pylint: disable=no-member
+
     def copy(self) -> "Schedule":
         """Returns a copy of the schedule, including both the state and the symbol table,
         * guaranteeing that
@@ -257,7 +271,347 @@ class Schedule(Object):
         return _ffi_api_schedule.ScheduleGetLoops(self, block)  # type: ignore # pylint: disable=no-member
 
     ########## Schedule: loops manipulation ##########
+
+    def split(
+        self,
+        loop: LoopRV,
+        factors: List[Union[ExprRV, None]],
+    ) -> List[LoopRV]:
+        """Split a loop into a list of consecutive loops. It requires:
+
+        1) The loop can't have annotation or thread binding.
+
+        2) The loop must start with 0.
+
+        Predicates may be added to ensure the total loop numbers keeps unchanged.
+        In `factors`, at most one of the factors can be None, which will be automatically
+        inferred.
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop to be split
+
+        factors: List[Union[ExprRV, None]]
+            The splitting factors, at most one of which is None, which means that factor is
+            inferred.
+
+        Returns
+        -------
+        split_loops : List[LoopRV]
+            The new loops after split
+
+        Examples
+        --------
+
+        Before split, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def before_split(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, (128, 128))
+                with tir.block([128, 128], "B") as [vi, vj]:
+                    B[vi, vj] = A[vi, vj] * 2.0
+
+        Create the schedule and do split:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_split)
+            i, j = sch.get_loops(sch.get_block("B"))
+            sch.split(i, factors=[2, 64])
+            print(tvm.script.asscript(sch.mod["main"]))
+
+        After applying split, the IR becomes:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def after_split(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, (128, 128))
+                # the original loop is split into 2 loops
+                for i0, i1, j in tir.grid(2, 64, 128):
+                    with tir.block([128, 128], "B") as [vi, vj]:
+                        tir.bind(vi, ((i0*64) + i1))
+                        tir.bind(vj, j)
+                        B[vi, vj] = A[vi, vj] * 2.0
+
+        """
+        # it will be checked later in C++ implementation
+        # that there is at most one None in `factors`
+        return _ffi_api_schedule.ScheduleSplit(self, loop, factors)  # type: ignore # pylint: disable=no-member
+
+    def fuse(self, *loops: List[LoopRV]) -> LoopRV:
+        """Fuse a list of consecutive loops into one. It requires:
+
+        1) The loops can't have annotations or thread bindings.
+
+        2) The (i+1)-th loop must be the only child of the i-th loop.
+
+        3) All loops must start with 0.
+
+        Parameters
+        ----------
+        *loops : List[LoopRV]
+            The loops to be fused
+
+        Returns
+        -------
+        fused_loop : LoopRV
+            The new loop after fusion
+
+        Examples
+        --------
+
+        Before applying fuse, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def before_fuse(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, (128, 128))
+                with tir.block([128, 128], "B") as [vi, vj]:
+                    B[vi, vj] = A[vi, vj] * 2.0
+
+        Create the schedule and do fuse:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_fuse)
+            i, j = sch.get_loops(sch.get_block("B"))
+            sch.fuse(i, j)
+            print(tvm.script.asscript(sch.mod["main"]))
+
+        After applying fuse, the IR becomes:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def after_fuse(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, [128, 128])
+                # the 2 loops are fused into 1
+                for i_j_fused in tir.serial(0, 16384):
+                    with tir.block([128, 128], "B") as [vi, vj]:
+                        tir.bind(vi, tir.floordiv(i_j_fused, 128))
+                        tir.bind(vj, tir.floormod(i_j_fused, 128))
+                        B[vi, vj] = A[vi, vj] * 2.0
+
+        """
+        return _ffi_api_schedule.ScheduleFuse(self, loops)  # type: ignore # pylint: disable=no-member
+
+    def reorder(self, *ordered_loops: List[LoopRV]) -> None:
+        """Reorder a list of loops. It doesn't require the loops to be consecutive.
+        It requires:
+
+        1) The loops are in the same chain. That means: the loops can be ordered to [l_1, l_2, ... ,
+        l_n] where l_i is an ancestor of l_{i+1} and there are only single-branch loops between
+        l_1 and l_n (which also indicates they are under the same scope).
+
+        2) After reordering, the domain of an outer loop cannot depend on any of the inner loops.
+
+        3) For every block under the loop nests, its block binding must be affine, and the block
+        variables must be either data parallel or reduction.
+
+        4) No duplicated loops are allowed in the arguments.
+
+        Parameters
+        ----------
+        *ordered_loops : List[LoopRV]
+            The loops in the new order
+
+        Examples
+        --------
+
+        Before reorder, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def before_reorder(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, (128, 128))
+                with tir.block([128, 128], "B") as [vi, vj]:
+                    B[vi, vj] = A[vi, vj] * 2.0
+
+        Create the schedule and do reorder:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_reorder)
+            i, j = sch.get_loops(sch.get_block("B"))
+            sch.reorder(j, i)
+            print(tvm.script.asscript(sch.mod["main"]))
+
+        After applying reorder, the IR becomes:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def after_reorder(a: ty.handle, b: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.match_buffer(b, (128, 128))
+                # Here j and i are reordered
+                for j, i in tir.grid(128, 128):
+                    with tir.block([128, 128], "B") as [vi, vj]:
+                        tir.bind(vi, i)
+                        tir.bind(vj, j)
+                        B[vi, vj] = A[vi, vj] * 2.0
+
+        """
+        _ffi_api_schedule.ScheduleReorder(self, ordered_loops)  # type: ignore # pylint: disable=no-member
+
     ########## Schedule: compute location ##########
+
+    def compute_at(self, block: BlockRV, loop: LoopRV) -> None:
+        """Move a producer block under the specific loop, and regenerate the loops induced by the
+        block so that the buffer region produced by the producer block could cover those regions
+        read by the consumers under the given loop. It requires:
+
+        1) The block and the loop are under the same scope, and the loop is not an ancestor of
+        the block
+
+        2) The scope block has stage-pipeline property
+
+        3) All the consumers of the block are under the given loop, and all the producers of the
+        block run before the loop
+
+        Parameters
+        ----------
+        block : BlockRV
+            The block to be moved
+
+        loop: LoopRV
+            The loop where the block to be moved under
+
+        Examples
+        --------
+
+        Before compute-at, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def before_compute_at(a: ty.handle, c: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.alloc_buffer((128, 128))
+                C = tir.match_buffer(c, (128, 128))
+                with tir.block([128, 128], "B") as [vi, vj]:
+                    B[vi, vj] = A[vi, vj] * 2.0
+                with tir.block([128, 128], "C") as [vi, vj]:
+                    C[vi, vj] = B[vi, vj] + 1.0
+
+        Create the schedule and do compute-at:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_compute_at)
+            i, _ = sch.get_loops(sch.get_block("C"))
+            sch.compute_at(sch.get_block("B"), i)
+            print(tvm.script.asscript(sch.mod["main"]))
+
+        After applying compute-at, the IR becomes:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def after_compute_at(a: ty.handle, c: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.alloc_buffer((128, 128))
+                C = tir.match_buffer(c, (128, 128))
+                for i in tir.serial(0, 128):
+                    for ax0 in tir.serial(0, 128):
+                        with tir.block([128, 128], "B") as [vi, vj]:
+                            tir.bind(vi, i)
+                            tir.bind(vj, ax0)
+                            B[vi, vj] = A[vi, vj] * 2.0
+                    for j in tir.serial(0, 128):
+                        with tir.block([128, 128], "C") as [vi, vj]:
+                            tir.bind(vi, i)
+                            tir.bind(vj, j)
+                            C[vi, vj] = B[vi, vj] + 1.0
+
+        """
+        _ffi_api_schedule.ScheduleComputeAt(self, block, loop)  # type: ignore # pylint: disable=no-member
+
+    def reverse_compute_at(self, block: BlockRV, loop: LoopRV) -> None:
+        """Move a consumer block under the specific loop, and regenerate the loops induced by the
+        block so that the buffer region consumed by the consumer block could cover those regions
+        written by the producers under the given loop. It requires:
+
+        1) The block and the loop are under the same scope, and the loop is not an ancestor of
+        the block
+
+        2) The scope block has stage-pipeline property
+
+        3) All the producers of the block are under the given loop, and all the consumers of the
+        block run after the loop
+
+        4) The block reads the buffers of its producers with its data parallel block vars as
+        indices
+
+        Parameters
+        ----------
+        block : BlockRV
+            The block to be moved
+
+        loop: LoopRV
+            The loop where the block to be moved under
+
+        Examples
+        --------
+
+        Before reverse-compute-at, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def before_reverse_compute_at(a: ty.handle, c: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.alloc_buffer((128, 128))
+                C = tir.match_buffer(c, (128, 128))
+                with tir.block([128, 128], "B") as [vi, vj]:
+                    B[vi, vj] = A[vi, vj] * 2.0
+                with tir.block([128, 128], "C") as [vi, vj]:
+                    C[vi, vj] = B[vi, vj] + 1.0
+
+        Create the schedule and do reverse-compute-at:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_reverse_compute_at)
+            i, _ = sch.get_loops(sch.get_block("B"))
+            sch.reverse_compute_at(sch.get_block("C"), i)
+            print(tvm.script.asscript(sch.mod["main"]))
+
+        After applying reverse-compute-at, the IR becomes:
+
+        .. code-block:: python
+
+            @tvm.script.tir
+            def after_reverse_compute_at(a: ty.handle, c: ty.handle) -> None:
+                A = tir.match_buffer(a, (128, 128))
+                B = tir.alloc_buffer((128, 128))
+                C = tir.match_buffer(c, (128, 128))
+                for i in tir.serial(0, 128):
+                    for j in tir.serial(0, 128):
+                        with tir.block([128, 128], "B") as [vi, vj]:
+                            tir.bind(vi, i)
+                            tir.bind(vj, j)
+                            B[vi, vj] = A[vi, vj] * 2.0
+                    for ax0 in tir.serial(0, 128):
+                        with tir.block([128, 128], "C") as [vi, vj]:
+                            tir.bind(vi, i)
+                            tir.bind(vj, ax0)
+                            C[vi, vj] = B[vi, vj] + 1.0
+
+        """
+        _ffi_api_schedule.ScheduleReverseComputeAt(self, block, loop)  # type: ignore # pylint: disable=no-member
+
     def compute_inline(self, block: BlockRV) -> None:
         """Inline a block into its consumer(s). It requires:
 
@@ -376,7 +730,133 @@ class Schedule(Object):
         _ffi_api_schedule.ScheduleReverseComputeInline(self, block)  # type: ignore # pylint: disable=no-member
 
     ########## Schedule: loop binding/annotation ##########
+
+    def parallel(self, loop: LoopRV) -> None:
+        """Parallelize the input loop. It requires:
+
+        1) The scope block that the loop is in should have stage-pipeline property
+
+        2) All the blocks under the loop have affine bindings
+
+        3) For each block under the loop, the loop can only be contained in data-parallel block
+        iters' bindings
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop to be parallelized
+        """
+        _ffi_api_schedule.ScheduleParallel(self, loop)  # type: ignore # pylint: disable=no-member
+
+    def vectorize(self, loop: LoopRV) -> None:
+        """Vectorize the input loop. It requires:
+
+        1) The scope block that the loop is in should have stage-pipeline property
+
+        2) All the blocks under the loop have affine bindings
+
+        3) For each block under the loop, the loop can only be contained in data-parallel block
+        iters' bindings
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop to be vectorized
+        """
+        _ffi_api_schedule.ScheduleVectorize(self, loop)  # type: ignore # pylint: disable=no-member
+
+    def bind(self, loop: LoopRV, thread_axis: str) -> None:
+        """Bind the input loop to the given thread axis. It requires:
+
+        1) The scope block that the loop is in should have stage-pipeline property
+
+        2) All the blocks under the loop have affine bindings
+
+        3) For each block under the loop, the loop can only be contained in data-parallel block
+        iters' bindings. The reduction block iters cannot be bound yet, as the cross-thread
+        reduction of TensorIR is not lowered.
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop to be bound to the thread axis
+        thread_axis : str
+            The thread axis to be bound to the loop. Possible candidates:
+            - blockIdx.x/y/z
+            - threadIdx.x/y/z
+            - vthread
+        """
+        _ffi_api_schedule.ScheduleBind(self, loop, thread_axis)  # type: ignore # pylint: disable=no-member
+
+    def unroll(self, loop: LoopRV) -> None:
+        """Unroll the input loop. It requires nothing
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop to be unrolled
+        """
+        _ffi_api_schedule.ScheduleUnroll(self, loop)  # type: ignore # pylint: disable=no-member
+
     ########## Schedule: cache read/write ##########
+
+    def cache_read(self, block: BlockRV, read_buffer_index: int, storage_scope: str) -> BlockRV:
+        """Create a block that reads a buffer region into a read cache. It requires:
+
+        1) There is at most one block who writes the buffer in the scope.
+
+        2) The scope block have stage-pipeline property.
+
+        The cache stage is inserted into the body of the scope root, after the block that writes
+        the buffer and before the blocks that read it, and caches the region they read.
+
+        Parameters
+        ----------
+        block : BlockRV
+            The consumer block of the target buffer.
+        read_buffer_index: int
+            The index of the buffer in block's read region.
+        storage_scope: str
+            The target storage scope.
+
+        Returns
+        -------
+        cached_block : BlockRV
+            The block of the cache stage
+        """
+        return _ffi_api_schedule.ScheduleCacheRead(  # type: ignore # pylint: disable=no-member
+            self, block, read_buffer_index, storage_scope
+        )
+
+    def cache_write(self, block: BlockRV, write_buffer_index: int, storage_scope: str) -> BlockRV:
+        """Create a block that writes a buffer region into a write cache. It requires:
+
+        1) There is only one block who writes the target buffer.
+
+        2) The scope block have stage-pipeline property.
+
+        The block writes the cache instead, and the cache stage that writes it back is inserted
+        into the body of the scope root, after the block and before the blocks that read the
+        buffer.
+
+        Parameters
+        ----------
+        block : BlockRV
+            The producer block of the target buffer.
+        write_buffer_index: int
+            The index of the buffer in block's write region.
+        storage_scope: str
+            The target storage scope.
+
+        Returns
+        -------
+        cached_block : BlockRV
+            The block of the cache stage
+        """
+        return _ffi_api_schedule.ScheduleCacheWrite(  # type: ignore # pylint: disable=no-member
+            self, block, write_buffer_index, storage_scope
+        )
+
     ########## Schedule: reduction ##########
     ########## Schedule: blockize & tensorize ##########
 
@@ -384,3 +864,9 @@ class Schedule(Object):
 @_register_object("tir.ConcreteSchedule")
 class ConcreteSchedule(Schedule):
     """A concrete schedule class of TensorIR. Do not use directly, use tvm.tir.Schedule instead."""
+
+
+@_register_object("tir.TracedSchedule")
+class TracedSchedule(ConcreteSchedule):
+    """A traced schedule class of TensorIR.
+    Do not use directly, use tvm.tir.Schedule(..., traced=True) instead."""
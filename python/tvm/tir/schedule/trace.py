@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The trace of a TensorIR schedule"""
+from typing import Any, List, Optional
+
+from tvm._ffi import register_object as _register_object
+from tvm.runtime import Object
+
+from . import _ffi_api_schedule
+
+
+@_register_object("tir.Instruction")
+class Instruction(Object):
+    """A schedule instruction, i.e. an invocation of a schedule primitive recorded in a trace
+
+    Parameters
+    ----------
+    kind : str
+        The name of the schedule primitive, e.g. "Split"
+    inputs : List[Any]
+        The random variables the primitive is invoked with, None for an omitted one
+    attrs : List[Any]
+        The non-random-variable arguments of the primitive
+    outputs : List[Any]
+        The random variables the primitive returns
+    """
+
+    kind: str
+    inputs: List[Any]
+    attrs: List[Any]
+    outputs: List[Any]
+
+    def __init__(self, kind: str, inputs: List[Any], attrs: List[Any], outputs: List[Any]):
+        self.__init_handle_by_constructor__(
+            _ffi_api_schedule.Instruction,  # type: ignore # pylint: disable=no-member
+            kind,
+            inputs,
+            attrs,
+            outputs,
+        )
+
+
+@_register_object("tir.Trace")
+class Trace(Object):
+    """The trace of a schedule, i.e. the sequence of the instructions applied to it
+
+    A trace is replayed on a fresh schedule of the same IRModule to reproduce the scheduled
+    IRModule.
+
+    Parameters
+    ----------
+    insts : List[Instruction]
+        The instructions, in the order they are applied
+    """
+
+    insts: List[Instruction]
+
+    def __init__(self, insts: Optional[List[Instruction]] = None):
+        self.__init_handle_by_constructor__(
+            _ffi_api_schedule.Trace, insts  # type: ignore # pylint: disable=no-member
+        )
+
+    def append(self, inst: Instruction) -> None:
+        """Append an instruction to the end of the trace
+
+        Parameters
+        ----------
+        inst : Instruction
+            The instruction to be appended
+        """
+        _ffi_api_schedule.TraceAppend(self, inst)  # type: ignore # pylint: disable=no-member
+
+    def apply_to_schedule(self, sch) -> None:
+        """Apply the trace to a schedule
+
+        Parameters
+        ----------
+        sch : tvm.tir.Schedule
+            The schedule to be applied onto, usually a fresh schedule of the IRModule the trace is
+            recorded on
+        """
+        _ffi_api_schedule.TraceApplyToSchedule(self, sch)  # type: ignore # pylint: disable=no-member
+
+    def as_python(self) -> List[str]:
+        """Serialize the trace as a sequence of python statements
+
+        Returns
+        -------
+        stmts : List[str]
+            The python statements, one per instruction, invoking the methods of `sch`
+        """
+        return [str(s) for s in _ffi_api_schedule.TraceAsPython(self)]  # type: ignore # pylint: disable=no-member
+
+    def __str__(self) -> str:
+        return "\n".join(self.as_python())
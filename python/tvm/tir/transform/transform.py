@@ -73,6 +73,54 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()
 
 
+def InjectSoftwarePrefetch():
+    """Insert software prefetches for the strided loads of the innermost CPU loops.
+
+    A load whose address advances by at least a cache line per iteration is prefetched a
+    number of iterations ahead, derived from the memory latency and the cost of an iteration
+    unless the "tir.InjectSoftwarePrefetch" config sets the distance. Only the functions of
+    LLVM targets are changed. tvm.build runs it on the host functions with the
+    "tir.enable_software_prefetch" config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()
+
+
+def AutoTile():
+    """Tile the unscheduled reduction loop nests of the CPU functions for the caches.
+
+    The nests lowered from a reduction without schedule, such as the fallback of an untuned
+    operator, get their spatial loops tiled for the L2 and the L1 caches, the last reduction
+    loop tiled for the L1 cache and their unit stride loop vectorized. The cache sizes are
+    the "l1-cache-size" and "l2-cache-size" attributes of the target, in bytes. Run
+    VectorizeLoop after it. tvm.build runs it with the "tir.enable_auto_tile" config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.AutoTile()
+
+
+def PadSharedMemory():
+    """Pad the rows of the shared buffers to reduce the bank conflicts of their warp accesses.
+
+    Runs before StorageFlatten, the padding of a buffer being the one of least conflicts for
+    the lanes of the first warp. The buffers aligned by storage_align are left as is.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.PadSharedMemory()  # type: ignore
+
+
 def StorageFlatten(cache_line_size, create_bound_attribute=False):
     """Flatten the multi-dimensional read/write to 1D.
 
@@ -358,6 +406,18 @@ def MakeUnpackedAPI():
     return _ffi_api.MakeUnpackedAPI()
 
 
+def HorizontalFuseKernels():
+    """Pack the consecutive independent kernels of the functions marked with
+    tir.horizontal_fusion into single kernels, dispatching on the block index.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.HorizontalFuseKernels()
+
+
 def SplitHostDevice():
     """Split the function into a host function and device functions.
 
@@ -560,6 +620,48 @@ def HoistIfThenElse(variant=None):
         return _ffi_api.HoistIfThenElse()
 
 
+def LoopInvariantCodeMotion():
+    """Hoist the loop invariant expressions out of the loops into LetStmts.
+
+    The maximal pure subexpressions of a loop body that use no var defined in the loop, and
+    that cannot trap, are bound right outside the outermost loop they are invariant in.
+    With the config below, the number of operations removed from the loops is recorded in
+    the "tir.licm_removed_ops" attribute of each function:
+
+        config={"tir.LoopInvariantCodeMotion": {"record_stats": True}}
+
+    tvm.build runs it with the "tir.enable_loop_invariant_code_motion" config.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.LoopInvariantCodeMotion()
+
+
+def CommonSubexprElim():
+    """Bind the repeated pure expressions to LetStmts.
+
+    The repeated scalar expressions that are pure and cannot trap are replaced from the
+    largest one with new vars, bound at the top of the scope of the statements they appear
+    in. The granularity is set by the config below: the minimum number of operations of an
+    eliminated expression, and whether the expressions repeated across the statements of a
+    scope are eliminated, rather than within each statement only:
+
+        config={"tir.CommonSubexprElim": {"min_ops": 2, "cross_statement": True}}
+
+    tvm.build runs it on the functions generated as C-like source unless the
+    "tir.disable_cse" config is set.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.CommonSubexprElim()
+
+
 def LowerInitBlock():
     """Lower block init stmt into IfThenElse stmts
 
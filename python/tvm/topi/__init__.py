@@ -45,12 +45,14 @@ from .argwhere import *
 from .scan import *
 from .einsum import *
 from .unique import *
+from .embedding_bag import *
 from . import generic
 from . import nn
 from . import x86
 from . import cuda
 from . import gpu
 from . import arm_cpu
+from . import hexagon
 from . import mali
 from . import bifrost
 from . import intel_graphics
@@ -0,0 +1,48 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Implicit GEMM convolutions tensorized with the sdot instruction"""
+from tvm import autotvm
+
+from ..x86.conv_implicit_gemm import _implicit_gemm_int8, _schedule_implicit_gemm_int8
+from .tensor_intrin import dot_int8_int8_int32
+
+_DOTPROD_TAG = "implicit_gemm_dotprod"
+_DOTPROD_LANES = 4
+
+
+@autotvm.register_topi_compute("conv2d_nhwc_implicit_gemm_dotprod.arm_cpu")
+def conv2d_nhwc_implicit_gemm_dotprod(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute an int8 NHWC conv2d as an implicit GEMM with sdot"""
+    return _implicit_gemm_int8(
+        cfg,
+        data,
+        kernel,
+        strides,
+        padding,
+        dilation,
+        out_dtype,
+        ("NHWC", "HWIO"),
+        tag_name=_DOTPROD_TAG,
+        lanes=_DOTPROD_LANES,
+    )
+
+
+@autotvm.register_topi_schedule("conv2d_nhwc_implicit_gemm_dotprod.arm_cpu")
+def schedule_conv2d_nhwc_implicit_gemm_dotprod(cfg, outs):
+    """Create the schedule for conv2d_nhwc_implicit_gemm_dotprod"""
+    intrin = dot_int8_int8_int32(int32_lanes=_DOTPROD_LANES, dtype="int")
+    return _schedule_implicit_gemm_int8(cfg, outs, _DOTPROD_TAG, _DOTPROD_LANES, intrin)
@@ -37,10 +37,12 @@ from .reduction import schedule_reduce
 from .softmax import *
 from .injective import schedule_injective, schedule_elemwise, schedule_broadcast
 from .dense import *
+from .dense_int4 import schedule_dense_int4
 from .pooling import *
-from .nn import schedule_lrn
+from .nn import schedule_lrn, schedule_layer_norm
 from .batch_matmul import *
 from .batch_matmul_tensorcore import *
+from .attention import attention
 from .vision import *
 from .ssd import *
 from .nms import get_valid_counts, non_max_suppression, all_class_non_max_suppression
@@ -49,6 +51,7 @@ from .scatter import *
 from .sort import *
 from .conv2d_nhwc_tensorcore import *
 from .conv3d_ndhwc_tensorcore import *
+from .conv_implicit_gemm import *
 from .dense_tensorcore import *
 from .conv2d_hwnc_tensorcore import *
 from .correlation import *
@@ -59,3 +62,4 @@ from .scan import *
 from .sparse_reshape import *
 from .transform import *
 from .unique import *
+from .embedding_bag import *
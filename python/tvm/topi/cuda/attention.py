@@ -0,0 +1,167 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-locals, too-many-arguments, too-many-statements
+"""Fused scaled dot-product attention operator for CUDA"""
+import tvm
+from tvm import te
+
+from ..nn.attention import attention_key_end, attention_scale, attention_valid_length
+from ..utils import ceil_div, get_const_int
+
+
+def _attention_ir(query, key, value, valid_length, out, scale, causal, rows, block):
+    """Attention of a query per thread, the tiles of keys and values staged in shared memory."""
+    ib = tvm.tir.ir_builder.create()
+    batch, q_seq, dim = query.shape
+    kv_seq = key.shape[1]
+    dim = get_const_int(dim)
+    value_dim = get_const_int(value.shape[2])
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+
+    num_row_blocks = ceil_div(q_seq, rows)
+    tx = te.thread_axis("threadIdx.x")
+    bx = te.thread_axis("blockIdx.x")
+    ib.scope_attr(tx, "thread_extent", rows)
+    ib.scope_attr(bx, "thread_extent", batch * num_row_blocks)
+    b = bx // num_row_blocks
+    i0 = bx % num_row_blocks * rows
+    i = i0 + tx
+
+    length = attention_valid_length(ib, valid_length, b)
+    # The keys of the threads of the block end at the ones of the last query
+    block_end = attention_key_end(length, tvm.te.min(i0 + rows, q_seq) - 1, q_seq, kv_seq, causal)
+    end = attention_key_end(length, i, q_seq, kv_seq, causal)
+
+    key_tile = ib.allocate("float32", (block * dim,), name="key_tile", scope="shared")
+    value_tile = ib.allocate("float32", (block * value_dim,), name="value_tile", scope="shared")
+    acc = ib.allocate("float32", (value_dim,), name="acc", scope="local")
+    scores = ib.allocate("float32", (block,), name="scores", scope="local")
+    run_max = ib.allocate("float32", (1,), name="run_max", scope="local")
+    run_sum = ib.allocate("float32", (1,), name="run_sum", scope="local")
+    tile_max = ib.allocate("float32", (1,), name="tile_max", scope="local")
+    run_max[0] = tvm.tir.min_value("float32")
+    run_sum[0] = 0.0
+    with ib.for_range(0, value_dim, name="d") as d:
+        acc[d] = 0.0
+
+    with ib.for_range(0, ceil_div(block_end, block), name="jb") as jb:
+        j0 = jb * block
+        # Stage the tile of keys and values, shared by the queries of the block
+        with ib.for_range(0, ceil_div(block * dim, rows), name="e") as e:
+            idx = e * rows + tx
+            with ib.if_scope(idx < block * dim):
+                j = j0 + idx // dim
+                key_tile[idx] = tvm.tir.if_then_else(
+                    j < block_end, k[(b * kv_seq + j) * dim + idx % dim].astype("float32"), 0.0
+                )
+        with ib.for_range(0, ceil_div(block * value_dim, rows), name="e") as e:
+            idx = e * rows + tx
+            with ib.if_scope(idx < block * value_dim):
+                j = j0 + idx // value_dim
+                value_tile[idx] = tvm.tir.if_then_else(
+                    j < block_end,
+                    v[(b * kv_seq + j) * value_dim + idx % value_dim].astype("float32"),
+                    0.0,
+                )
+        ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+        num = tvm.te.min(block, end - j0)
+        with ib.if_scope(tvm.tir.all(i < q_seq, num > 0)):
+            tile_max[0] = run_max[0]
+            with ib.for_range(0, num, name="jj") as jj:
+                scores[jj] = 0.0
+                with ib.for_range(0, dim, name="d") as d:
+                    scores[jj] += (
+                        q[(b * q_seq + i) * dim + d].astype("float32") * key_tile[jj * dim + d]
+                    )
+                scores[jj] = scores[jj] * scale
+                tile_max[0] = tvm.te.max(tile_max[0], scores[jj])
+            correction = tvm.te.exp(run_max[0] - tile_max[0])
+            run_sum[0] = run_sum[0] * correction
+            with ib.for_range(0, value_dim, name="d") as d:
+                acc[d] = acc[d] * correction
+            with ib.for_range(0, num, name="jj") as jj:
+                p = tvm.te.exp(scores[jj] - tile_max[0])
+                run_sum[0] += p
+                with ib.for_range(0, value_dim, name="d") as d:
+                    acc[d] += p * value_tile[jj * value_dim + d]
+            run_max[0] = tile_max[0]
+        # The tiles are rewritten by the next iteration
+        ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+    with ib.if_scope(i < q_seq):
+        with ib.for_range(0, value_dim, name="d") as d:
+            o[(b * q_seq + i) * value_dim + d] = tvm.tir.if_then_else(
+                run_sum[0] > 0, acc[d] / run_sum[0], 0.0
+            ).astype(out.dtype)
+    return ib.get()
+
+
+def attention(query, key, value, valid_length, scale=None, causal=False):
+    """Fused scaled dot-product attention for CUDA.
+
+    A thread block computes the attention of a block of queries of a batch, a query per thread.
+    The keys and values are staged a tile at a time in shared memory, and the scores of a query
+    are folded into its output with an online softmax, so that the (q_seq, kv_seq) score matrix
+    is never stored.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        3-D with shape [batch, q_seq, dim]
+
+    key : tvm.te.Tensor
+        3-D with shape [batch, kv_seq, dim]
+
+    value : tvm.te.Tensor
+        3-D with shape [batch, kv_seq, value_dim]
+
+    valid_length : tvm.te.Tensor
+        1-D with shape [batch], or a scalar for all the batches, the number of valid keys.
+
+    scale : float, optional
+        The scale of the scores before the softmax, 1 / sqrt(dim) if None or 0.
+
+    causal : bool, optional
+        Whether a query only attends to the keys up to its position, the last query being
+        aligned with the last key.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        3-D with shape [batch, q_seq, value_dim]
+    """
+    scale = attention_scale(query, scale)
+    dim = get_const_int(query.shape[2])
+    value_dim = get_const_int(value.shape[2])
+    rows = 64
+    # Keep the tiles of keys and values within 32KB of shared memory
+    block = max(1, min(32, 8192 // (dim + value_dim)))
+    out_shape = [query.shape[0], query.shape[1], value.shape[2]]
+    return te.extern(
+        [out_shape],
+        [query, key, value, valid_length],
+        lambda ins, outs: _attention_ir(
+            ins[0], ins[1], ins[2], ins[3], outs[0], scale, causal, rows, block
+        ),
+        dtype=[query.dtype],
+        name="attention_gpu",
+        tag="attention_gpu",
+    )
@@ -0,0 +1,133 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name,too-many-arguments
+"""Implicit GEMM convolutions on tensor cores"""
+from tvm import te
+from tvm import autotvm
+
+from .. import nn
+from ..utils import traverse_inline, get_const_tuple
+from .dense_tensorcore import dense_tensorcore_cuda, _schedule_dense_tensorcore
+from .injective import schedule_injective_from_existing
+
+# The rows and the output channels are padded to multiples of 32 and the taps to multiples of
+# 16, so that all the wmma fragment shapes are applicable.
+_M_MULTIPLE = 32
+_N_MULTIPLE = 32
+_K_MULTIPLE = 16
+
+
+def implicit_gemm_tensorcore_applicable(data, kernel, in_channel, out_channel):
+    """Whether the implicit GEMM on tensor cores applies to a convolution. The channels are
+    required to be multiples of 8 so that the padding of the GEMM stays small."""
+    return (
+        data.dtype in ["float16", "int8", "uint8"]
+        and kernel.dtype == data.dtype
+        and in_channel % 8 == 0
+        and out_channel % 8 == 0
+    )
+
+
+def _implicit_gemm_tensorcore(
+    cfg, data, kernel, strides, padding, dilation, out_dtype, layouts, output_padding=None
+):
+    """Compute a convolution as an implicit GEMM on tensor cores. layouts are the layouts of the
+    data and of the kernel."""
+    layout, kernel_layout = layouts
+    patch, weight, out_shape = nn.implicit_gemm_operands(
+        data,
+        kernel,
+        strides,
+        padding,
+        dilation,
+        layout,
+        kernel_layout,
+        output_padding,
+        m_multiple=_M_MULTIPLE,
+        n_multiple=_N_MULTIPLE,
+        k_multiple=_K_MULTIPLE,
+    )
+    M, K = get_const_tuple(patch.shape)
+    N, _ = get_const_tuple(weight.shape)
+    cfg.add_flop(M * N * K * 2)
+    gemm = dense_tensorcore_cuda(patch, weight, None, out_dtype)
+    return nn.implicit_gemm_output(gemm, out_shape, layout)
+
+
+def _schedule_implicit_gemm_tensorcore(cfg, outs):
+    """Schedule an implicit GEMM convolution on tensor cores. The patch matrix is computed in the
+    loads of the GEMM tiles to shared memory, the output is gathered from the GEMM by a separate
+    kernel."""
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if op.tag == "dense_tensorcore":
+            gemm = op.output(0)
+            patch, weight = gemm.op.input_tensors
+            _schedule_dense_tensorcore(cfg, s, gemm, fuse_output=False)
+            s[patch].compute_inline()
+            s[weight].compute_inline()
+
+    traverse_inline(s, outs[0].op, _callback)
+    schedule_injective_from_existing(s, outs[0])
+    return s
+
+
+@autotvm.register_topi_compute("conv2d_nhwc_implicit_gemm_tensorcore.cuda")
+def conv2d_nhwc_implicit_gemm_tensorcore(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute a NHWC conv2d as an implicit GEMM on tensor cores"""
+    return _implicit_gemm_tensorcore(
+        cfg, data, kernel, strides, padding, dilation, out_dtype, ("NHWC", "HWIO")
+    )
+
+
+@autotvm.register_topi_schedule("conv2d_nhwc_implicit_gemm_tensorcore.cuda")
+def schedule_conv2d_nhwc_implicit_gemm_tensorcore(cfg, outs):
+    """Create the schedule for conv2d_nhwc_implicit_gemm_tensorcore"""
+    return _schedule_implicit_gemm_tensorcore(cfg, outs)
+
+
+@autotvm.register_topi_compute("conv3d_ndhwc_implicit_gemm_tensorcore.cuda")
+def conv3d_ndhwc_implicit_gemm_tensorcore(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute a NDHWC conv3d as an implicit GEMM on tensor cores"""
+    return _implicit_gemm_tensorcore(
+        cfg, data, kernel, strides, padding, dilation, out_dtype, ("NDHWC", "DHWIO")
+    )
+
+
+@autotvm.register_topi_schedule("conv3d_ndhwc_implicit_gemm_tensorcore.cuda")
+def schedule_conv3d_ndhwc_implicit_gemm_tensorcore(cfg, outs):
+    """Create the schedule for conv3d_ndhwc_implicit_gemm_tensorcore"""
+    return _schedule_implicit_gemm_tensorcore(cfg, outs)
+
+
+@autotvm.register_topi_compute("conv2d_transpose_nchw_implicit_gemm_tensorcore.cuda")
+def conv2d_transpose_nchw_implicit_gemm_tensorcore(
+    cfg, data, kernel, strides, padding, out_dtype, output_padding
+):
+    """Compute a NCHW conv2d_transpose as an implicit GEMM on tensor cores, without dilating the
+    data"""
+    return _implicit_gemm_tensorcore(
+        cfg, data, kernel, strides, padding, 1, out_dtype, ("NCHW", "IOHW"), output_padding
+    )
+
+
+@autotvm.register_topi_schedule("conv2d_transpose_nchw_implicit_gemm_tensorcore.cuda")
+def schedule_conv2d_transpose_nchw_implicit_gemm_tensorcore(cfg, outs):
+    """Create the schedule for conv2d_transpose_nchw_implicit_gemm_tensorcore"""
+    return _schedule_implicit_gemm_tensorcore(cfg, outs)
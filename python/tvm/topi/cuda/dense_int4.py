@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Schedule of the dense with int4 weights for CUDA"""
+from tvm import te
+from ..utils import traverse_inline
+
+
+def schedule_dense_int4(outs):
+    """Schedule the dense with int4 weights.
+
+    Each output is reduced by a block, its threads reading consecutive bytes of the weight row
+    and unpacking both nibbles, which suits the small batches of weight-only quantization.
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+        The computation graph description of qnn.dense_int4 in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+    num_thread = 64
+
+    def _callback(op):
+        if op.tag != "dense_int4":
+            return
+        dense = op.output(0)
+        kb, _ = s[dense].op.reduce_axis
+        _, kbi = s[dense].split(kb, factor=num_thread)
+        dense_rf = s.rfactor(dense, kbi)
+        s[dense_rf].unroll(s[dense_rf].op.reduce_axis[-1])
+        m, n = s[dense].op.axis
+        s[dense].bind(m, te.thread_axis("blockIdx.y"))
+        s[dense].bind(n, te.thread_axis("blockIdx.x"))
+        thread_x = te.thread_axis((0, num_thread), "threadIdx.x")
+        tx = s[dense].op.reduce_axis[0]
+        s[dense].bind(tx, thread_x)
+        s[dense_rf].compute_at(s[dense], tx)
+        s[dense].set_store_predicate(thread_x.var.equal(0))
+
+        out = outs[0]
+        if dense.op != out.op:
+            # The fused elementwise ops run as a second kernel.
+            fused = s[out].fuse(*s[out].op.axis)
+            bx, txo = s[out].split(fused, factor=num_thread)
+            s[out].bind(bx, te.thread_axis("blockIdx.x"))
+            s[out].bind(txo, te.thread_axis("threadIdx.x"))
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
@@ -93,8 +93,9 @@ def dense_tensorcore_cuda(data, weight, bias=None, out_dtype=None):
     return matmul
 
 
-def _schedule_dense_tensorcore(cfg, s, C):
-    """Schedule dense operator using Tensorcore"""
+def _schedule_dense_tensorcore(cfg, s, C, fuse_output=True):
+    """Schedule dense operator using Tensorcore. Unless fuse_output, the elementwise stages
+    after C are left to the caller to schedule as a separate kernel."""
     A, B = s[C].op.input_tensors
     batch, out_dim = get_const_tuple(C.shape)
     data_dtype = A.dtype
@@ -117,7 +118,7 @@ def _schedule_dense_tensorcore(cfg, s, C):
         cfg.fallback_with_reference_log(ref_log)
 
     # Deal with op fusion, such as bias and relu
-    if C.op not in s.outputs:
+    if fuse_output and C.op not in s.outputs:
         s[C].compute_inline()
         C = s.outputs[0].output(0)
 
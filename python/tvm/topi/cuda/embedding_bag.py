@@ -0,0 +1,112 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments, too-many-locals
+"""Embedding bag operator on CUDA"""
+from tvm import te, tir
+from ..utils import ceil_div
+from ..embedding_bag import (
+    _verify_embedding_bag_inputs,
+    _embedding_bag_bounds,
+    _embedding_bag_init,
+    _embedding_bag_update,
+    _embedding_bag_finalize,
+)
+
+_WARP_SIZE = 32
+# The number of bags, i.e. of warps, per thread block.
+_WARPS_PER_BLOCK = 4
+
+
+def _embedding_bag_ir(weight, indices, offsets, per_sample_weights, out, mode):
+    """Low level IR of embedding_bag on GPU: a warp reduces a bag, the threads of the warp
+    accumulating consecutive columns so that the loads of a row are coalesced."""
+    ib = tir.ir_builder.create()
+    weight_ptr = ib.buffer_ptr(weight)
+    indices_ptr = ib.buffer_ptr(indices)
+    offsets_ptr = ib.buffer_ptr(offsets)
+    psw_ptr = ib.buffer_ptr(per_sample_weights)
+    out_ptr = ib.buffer_ptr(out)
+
+    num_indices = indices.shape[0]
+    num_bags, dim = out.shape
+    dtype = out.dtype
+    scalar_scale = len(per_sample_weights.shape) == 0
+
+    bx = te.thread_axis("blockIdx.x")
+    ty = te.thread_axis("threadIdx.y")
+    tx = te.thread_axis("threadIdx.x")
+    ib.scope_attr(bx, "thread_extent", ceil_div(num_bags, _WARPS_PER_BLOCK))
+    ib.scope_attr(ty, "thread_extent", _WARPS_PER_BLOCK)
+    ib.scope_attr(tx, "thread_extent", _WARP_SIZE)
+    b = bx * _WARPS_PER_BLOCK + ty
+    acc = ib.allocate(dtype, (1,), name="acc", scope="local")
+
+    with ib.if_scope(b < num_bags):
+        begin, end = _embedding_bag_bounds(ib, offsets_ptr, num_bags, num_indices, b)
+        with ib.for_range(0, ceil_div(dim, _WARP_SIZE), name="jo") as jo:
+            j = jo * _WARP_SIZE + tx
+            with ib.if_scope(j < dim):
+                acc[0] = _embedding_bag_init(mode, dtype)
+                with ib.for_range(0, end - begin, name="i", dtype=begin.dtype) as i:
+                    pos = begin + i
+                    if mode != "sum":
+                        scale = None
+                    elif scalar_scale:
+                        scale = psw_ptr[0].astype(dtype)
+                    else:
+                        scale = psw_ptr[pos]
+                    row = indices_ptr[pos] * dim
+                    acc[0] = _embedding_bag_update(mode, acc[0], weight_ptr[row + j], scale)
+                out_ptr[b * dim + j] = _embedding_bag_finalize(mode, acc[0], end - begin)
+    return ib.get()
+
+
+def embedding_bag(weight, indices, offsets, per_sample_weights, mode="sum"):
+    """Reduce bags of rows of an embedding table on GPU, a warp per bag.
+
+    Parameters
+    ----------
+    weight : tvm.te.Tensor
+        2-D embedding table [num_embeddings, dim].
+
+    indices : tvm.te.Tensor
+        1-D integer tensor, the rows of the bags concatenated.
+
+    offsets : tvm.te.Tensor
+        1-D integer tensor [num_bags], the start of each bag in indices, in increasing order.
+
+    per_sample_weights : tvm.te.Tensor
+        1-D tensor with the shape of indices scaling each row in the sum mode, or a scalar
+        scaling all the rows in the sum mode and ignored otherwise.
+
+    mode : str
+        How the rows of a bag are reduced, "sum", "mean" or "max".
+
+    Returns
+    -------
+    out : tvm.te.Tensor
+        2-D tensor [num_bags, dim].
+    """
+    _verify_embedding_bag_inputs(weight, indices, offsets, per_sample_weights, mode)
+    return te.extern(
+        [(offsets.shape[0], weight.shape[1])],
+        [weight, indices, offsets, per_sample_weights],
+        lambda ins, outs: _embedding_bag_ir(ins[0], ins[1], ins[2], ins[3], outs[0], mode),
+        dtype=weight.dtype,
+        name="embedding_bag_gpu",
+        tag="embedding_bag_gpu",
+    )
@@ -364,6 +364,165 @@ def _nms_loop(
     return ib.get()
 
 
+# The number of boxes a word of the suppression bitmask covers.
+_MASK_WORD_BITS = 64
+# The maximum number of boxes per instance for which the bitmask NMS is used, its bitmask taking
+# num_boxes * num_boxes / 8 bytes per instance.
+_BITMASK_NMS_MAX_BOXES = 8192
+
+
+def _bitmask_nms_loop(mask, removed):
+    """Make a NMS loop, with the signature of _nms_loop, suppressing the boxes with a bitmask.
+
+    Instead of testing the boxes following each selected box in turn, the IoU of all the pairs of
+    boxes are first tested in parallel into the bitmask mask, of shape
+    [batch_size, num_boxes, ceil(num_boxes / 64)], the bit k of the row j telling whether the
+    box j suppresses the box k > j. A block per instance then scans the boxes in score order,
+    selecting the ones not suppressed yet and adding their row to the bitmask removed, of shape
+    [batch_size, ceil(num_boxes / 64)], of the suppressed boxes. The scan only reads and ORs
+    words instead of computing IoUs."""
+
+    def nms_loop(
+        ib,
+        batch_size,
+        top_k,
+        iou_threshold,
+        max_output_size,
+        valid_count,
+        on_new_valid_box_func,
+        on_new_invalidated_box_func,
+        needs_bbox_check_func,
+        calc_overlap_func,
+        out_scores,
+        num_valid_boxes,
+    ):
+        num_boxes = int(mask.shape[1])
+        num_words = int(mask.shape[2])
+        mask_ptr = ib.buffer_ptr(mask)
+        removed_ptr = ib.buffer_ptr(removed)
+        max_threads = int(tvm.target.Target.current(allow_none=False).max_num_threads)
+
+        def get_nkeep(i):
+            return if_then_else(
+                tvm.tir.all(top_k > 0, top_k < valid_count[i]), top_k, valid_count[i]
+            )
+
+        def removed_bit(i, j):
+            word = removed_ptr[i * num_words + j // _MASK_WORD_BITS]
+            bit = (j % _MASK_WORD_BITS).astype("uint64")
+            return (word >> bit) & tvm.tir.const(1, "uint64")
+
+        # Test the IoU of all the pairs of boxes, a thread per row of 64 bits of the mask.
+        with ib.new_scope():
+            bx = te.thread_axis("blockIdx.x")
+            by = te.thread_axis("blockIdx.y")
+            bz = te.thread_axis("blockIdx.z")
+            tx = te.thread_axis("threadIdx.x")
+            ib.scope_attr(bx, "thread_extent", num_words)
+            ib.scope_attr(by, "thread_extent", ceil_div(num_boxes, _MASK_WORD_BITS))
+            ib.scope_attr(bz, "thread_extent", batch_size)
+            ib.scope_attr(tx, "thread_extent", _MASK_WORD_BITS)
+            i = bz
+            j = by * _MASK_WORD_BITS + tx
+            bits = ib.allocate("uint64", (1,), name="bits", scope="local")
+            with ib.if_scope(tvm.tir.all(iou_threshold > 0, j < get_nkeep(i))):
+                bits[0] = tvm.tir.const(0, "uint64")
+                with ib.for_range(0, _MASK_WORD_BITS, name="t") as t:
+                    k = bx * _MASK_WORD_BITS + t
+                    with ib.if_scope(tvm.tir.all(k > j, k < get_nkeep(i))):
+                        with ib.if_scope(
+                            tvm.tir.all(out_scores[i, k] > 0, needs_bbox_check_func(i, j, k))
+                        ):
+                            with ib.if_scope(calc_overlap_func(i, j, k) >= iou_threshold):
+                                bit = tvm.tir.const(1, "uint64") << t.astype("uint64")
+                                bits[0] = bits[0] | bit
+                mask_ptr[(i * num_boxes + j) * num_words + bx] = bits[0]
+
+        # Select the boxes, a block per instance, the threads ORing the words of the rows.
+        with ib.new_scope():
+            nthread_tx = min(max_threads, num_words)
+            bx = te.thread_axis("blockIdx.x")
+            tx = te.thread_axis("threadIdx.x")
+            ib.scope_attr(bx, "thread_extent", batch_size)
+            ib.scope_attr(tx, "thread_extent", nthread_tx)
+            i = bx
+            num_iter_per_thread = ceil_div(num_words, nthread_tx)
+
+            with ib.for_range(0, num_iter_per_thread, name="_w") as _w:
+                w = _w * nthread_tx + tx
+                with ib.if_scope(w < num_words):
+                    removed_ptr[i * num_words + w] = tvm.tir.const(0, "uint64")
+            ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+            nkeep = get_nkeep(i)
+            max_output_size = if_then_else(max_output_size > 0, max_output_size, nkeep)
+            num_valid_boxes_local = ib.allocate(
+                "int32", (1,), name="num_valid_boxes_local", scope="local"
+            )
+            num_valid_boxes_local[0] = 0
+
+            with ib.if_scope(tvm.tir.all(iou_threshold > 0, valid_count[i] > 0)):
+                box_idx = ib.allocate("int32", (1,), name="box_idx", scope="local")
+                box_idx[0] = 0
+                with ib.while_loop(
+                    tvm.tir.all(box_idx[0] < nkeep, num_valid_boxes_local[0] < max_output_size)
+                ):
+                    j = box_idx[0]
+                    # The bit j of removed is only set by the boxes before j, all the threads
+                    # see the same value.
+                    with ib.if_scope(
+                        tvm.tir.all(out_scores[i, j] > -1.0, removed_bit(i, j) == 0)
+                    ):
+                        on_new_valid_box_func(ib, tx, num_valid_boxes_local[0], i, j)
+                        num_valid_boxes_local[0] += 1
+                        first_word = j // _MASK_WORD_BITS
+                        with ib.for_range(
+                            0, ceil_div(num_words - first_word, nthread_tx), name="_w"
+                        ) as _w:
+                            w = first_word + _w * nthread_tx + tx
+                            with ib.if_scope(w < num_words):
+                                removed_ptr[i * num_words + w] = (
+                                    removed_ptr[i * num_words + w]
+                                    | mask_ptr[(i * num_boxes + j) * num_words + w]
+                                )
+                    ib.emit(
+                        tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"]))
+                    )
+                    box_idx[0] += 1
+
+                # Invalidate the suppressed boxes, including the ones after the last box
+                # selected, as _nms_loop does.
+                with ib.for_range(0, ceil_div(nkeep, nthread_tx), name="_k") as _k:
+                    k = _k * nthread_tx + tx
+                    with ib.if_scope(tvm.tir.all(k < nkeep, removed_bit(i, k) == 1)):
+                        out_scores[i, k] = -1.0
+                        on_new_invalidated_box_func(i, k)
+
+                with ib.if_scope(tx + 0 == 0):
+                    num_valid_boxes[i] = num_valid_boxes_local[0]
+
+            with ib.else_scope():
+                num_valid_boxes[i] = 0
+
+        return ib.get()
+
+    return nms_loop
+
+
+def _use_bitmask_nms(num_anchors, top_k):
+    """The number of boxes per instance of the bitmask NMS, or None if it is not used, i.e. for
+    dynamic shapes, too many boxes or a target without 64 bits integers in kernels."""
+    target = tvm.target.Target.current(allow_none=False)
+    if target.kind.name not in ["cuda", "rocm"] or not isinstance(num_anchors, tvm.tir.IntImm):
+        return None
+    num_boxes = num_anchors.value
+    if 0 < top_k < num_boxes:
+        num_boxes = top_k
+    if num_boxes > _BITMASK_NMS_MAX_BOXES:
+        return None
+    return num_boxes
+
+
 def nms_ir(
     data,
     sorted_index,
@@ -383,6 +542,7 @@ def nms_ir(
     id_index,
     score_index,
     return_indices,
+    nms_loop=_nms_loop,
 ):
     """Low level IR routing for transform location in multibox_detection operator.
 
@@ -446,6 +606,9 @@ def nms_ir(
     return_indices : boolean
         Whether to return box indices in input data.
 
+    nms_loop : function
+        The core NMS loop, _nms_loop or the one of _bitmask_nms_loop.
+
     Returns
     -------
     stmt : Stmt
@@ -585,7 +748,7 @@ def nms_ir(
             out_class_ids[i, k] == out_class_ids[i, j],
         )
 
-    return _nms_loop(
+    return nms_loop(
         ib,
         batch_size,
         top_k,
@@ -698,16 +861,30 @@ def _run_nms(
     out_features_shape = (batch_size, num_anchors, num_features)
     box_indices_shape = score_shape
     num_valid_boxes_shape = (batch_size, 1)
-
-    return te.extern(
-        [
-            bbox_shape,
-            score_shape,
-            class_id_shape,
-            out_features_shape,
-            box_indices_shape,
-            num_valid_boxes_shape,
-        ],
+    out_shapes = [
+        bbox_shape,
+        score_shape,
+        class_id_shape,
+        out_features_shape,
+        box_indices_shape,
+        num_valid_boxes_shape,
+    ]
+    out_dtypes = [data.dtype, "float32", "float32", "float32", "int32", "int32"]
+
+    num_boxes = _use_bitmask_nms(num_anchors, top_k)
+    if num_boxes is not None:
+        # The bitmasks of the suppressed boxes, see _bitmask_nms_loop.
+        num_words = ceil_div(num_boxes, _MASK_WORD_BITS)
+        out_shapes += [(batch_size, num_boxes, num_words), (batch_size, num_words)]
+        out_dtypes += ["uint64", "uint64"]
+
+    def get_nms_loop(outs):
+        if num_boxes is None:
+            return _nms_loop
+        return _bitmask_nms_loop(outs[6], outs[7])
+
+    outs = te.extern(
+        out_shapes,
         [data, sort_tensor, valid_count, indices],
         lambda ins, outs: nms_ir(
             ins[0],
@@ -728,12 +905,14 @@ def _run_nms(
             id_index,
             score_index,
             return_indices,
+            get_nms_loop(outs),
         ),
-        dtype=[data.dtype, "float32", "float32", "float32", "int32", "int32"],
+        dtype=out_dtypes,
         in_buffers=[data_buf, sort_tensor_buf, valid_count_buf, indices_buf],
         name="nms",
         tag="nms",
     )
+    return outs[:6]
 
 
 def _concatenate_outputs(
@@ -18,6 +18,7 @@
 """scheduler functions for cuda backend"""
 from __future__ import absolute_import as _abs
 
+import tvm
 from .. import cpp
 
 
@@ -36,3 +37,21 @@ def schedule_lrn(outs):
         The computation schedule for the op.
     """
     return cpp.cuda.schedule_lrn(outs)
+
+
+def schedule_layer_norm(outs):
+    """Schedule for layer_norm and rms_norm
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of layer_norm or rms_norm
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    target = tvm.target.Target.current(allow_none=False)
+    return cpp.cuda.schedule_layer_norm(target, outs)
@@ -21,47 +21,67 @@ from ...target import Target
 from ..utils import traverse_inline
 
 
-def schedule_transpose(outs):
-    """Schedule a unfused transpose"""
+def schedule_transpose(outs, axes=None):
+    """Schedule a unfused transpose
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+        The transpose, or a layout_transform permuting the axes.
+
+    axes: list of int, optional
+        The input axis of each output axis, reversed by default as in a 2D transpose.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
     outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
     s = te.create_schedule([x.op for x in outs])
-    schedule_transpose_from_existing(s, outs[0])
+    schedule_transpose_from_existing(s, outs[0], axes)
     return s
 
 
-def schedule_transpose_from_existing(s, out):
+def schedule_transpose_from_existing(s, out, axes=None):
     """Schedule for transpose on the gpu.
 
     Roughly follows this:
-    https://developer.nvidia.com/blog/efficient-matrix-transpose-cuda-cc/, but
-    without the padding for shared memory. For better performance, we could
-    rewrite it in tir to add the padding. Also, rewriting in tir would allow
-    use to use warp shuffles instead of shared memory (see
-    https://github.com/bryancatanzaro/trove).
+    https://developer.nvidia.com/blog/efficient-matrix-transpose-cuda-cc/. A block transposes a
+    tile of warp_size x warp_size elements of the output axis reading the innermost input axis
+    and of the innermost output axis, through shared memory padded by an element per row so that
+    the threads of a warp reading a column of the tile hit distinct banks. The other axes are
+    fused into the blocks.
     """
 
     def _callback(op):
         # pylint: disable=invalid-name
-        m, n = s[op].op.axis
+        op_axes = list(s[op].op.axis)
+        ndim = len(op_axes)
+        perm = list(axes) if axes is not None else list(reversed(range(ndim)))
+        # The output axis reading the innermost input axis.
+        inner = perm.index(ndim - 1)
         warp_size = int(Target.current(allow_none=False).thread_warp_size)
-        no, ni = s[op].split(n, factor=warp_size)
-        mo, mi = s[op].split(m, factor=warp_size)
-        s[op].reorder(mo, no, mi, ni)
-        s[op].bind(mo, te.thread_axis("blockIdx.x"))
+        no, ni = s[op].split(op_axes[-1], factor=warp_size)
+        mo, mi = s[op].split(op_axes[inner], factor=warp_size)
+        outer = [axis for i, axis in enumerate(op_axes) if i not in (inner, ndim - 1)]
+        s[op].reorder(*outer, mo, no, mi, ni)
+        s[op].bind(s[op].fuse(*outer, mo), te.thread_axis("blockIdx.x"))
         s[op].bind(no, te.thread_axis("blockIdx.y"))
         c = s.cache_read(op.input_tensors[0], "shared", op)
         s[c].compute_at(s[op], no)
+        s[c].storage_align(s[c].op.axis[-2], warp_size, 1)
         thread_x = te.thread_axis("threadIdx.x")
         thread_y = te.thread_axis("threadIdx.y")
         s[op].bind(ni, thread_x)
         # This is a hack to make the scheduling language realize that this axis
         # can be scheduled.
-        a, _ = s[c].split(s[c].op.axis[1], factor=1)
+        a, _ = s[c].split(s[c].op.axis[-1], factor=1)
         s[c].bind(a, thread_x)
         # Use 4 warps per block. Slightly faster than 1 warp per block
         ao, _ = s[op].split(mi, nparts=4)
         s[op].bind(ao, thread_y)
-        ao, _ = s[c].split(s[c].op.axis[0], nparts=4)
+        ao, _ = s[c].split(s[c].op.axis[perm[-1]], nparts=4)
         s[c].bind(ao, thread_y)
 
     traverse_inline(s, out.op, _callback)
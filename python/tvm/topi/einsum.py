@@ -16,8 +16,15 @@
 # under the License.
 # pylint: disable=invalid-name,consider-using-enumerate,redefined-outer-name
 """Einsum operator"""
+import itertools
+
+import tvm
 from . import cpp
 
+# The maximum number of operands whose contraction path is searched exhaustively, the path of
+# more operands is built greedily.
+_OPTIMAL_PATH_MAX_OPERANDS = 5
+
 
 def einsum(subscripts, *operand):
     """Evaluates the Einstein summation convention on the operands.
@@ -42,3 +49,240 @@ def einsum(subscripts, *operand):
     """
 
     return cpp.einsum(subscripts, operand)
+
+
+def _parse_einsum(subscripts, ndims):
+    """Split the subscripts into the labels of each operand and of the output, None for the
+    subscripts the contraction path does not support, i.e. with ellipses or a label repeated in
+    an operand."""
+    subscripts = subscripts.replace(" ", "")
+    if "." in subscripts:
+        return None
+    if "->" in subscripts:
+        inputs, output = subscripts.split("->")
+    else:
+        inputs, output = subscripts, None
+    terms = inputs.split(",")
+    if len(terms) != len(ndims):
+        return None
+    for term, ndim in zip(terms, ndims):
+        if len(term) != ndim or len(set(term)) != len(term):
+            return None
+    if output is None:
+        labels = "".join(terms)
+        output = "".join(sorted(l for l in set(labels) if labels.count(l) == 1))
+    return terms, output
+
+
+def _size(labels, dims):
+    size = 1
+    for l in labels:
+        size *= dims[l]
+    return size
+
+
+def _contracted_labels(term_a, term_b, keep):
+    """The labels of the contraction of two terms, the ones kept by the output or another term"""
+    return "".join(l for l in dict.fromkeys(term_a + term_b) if l in keep)
+
+
+def _kept_labels(terms, output, excluded):
+    return set(output).union(*[set(t) for i, t in enumerate(terms) if i not in excluded])
+
+
+def _contraction_cost(terms, output, i, j, dims):
+    """The FLOPs and the result of the contraction of the terms i and j"""
+    result = _contracted_labels(terms[i], terms[j], _kept_labels(terms, output, (i, j)))
+    flops = _size(set(terms[i]) | set(terms[j]), dims)
+    return flops, result
+
+
+def _remove_pair(terms, i, j, result):
+    return [t for k, t in enumerate(terms) if k not in (i, j)] + [result]
+
+
+def _optimal_path(terms, output, dims):
+    """The path of least FLOPs, then of least largest intermediate, by exhaustive search"""
+    best = [None, None]
+
+    def search(terms, path, flops, largest):
+        if best[0] is not None and (flops, largest) >= best[0]:
+            return
+        if len(terms) == 1:
+            best[0], best[1] = (flops, largest), path
+            return
+        for i, j in itertools.combinations(range(len(terms)), 2):
+            pair_flops, result = _contraction_cost(terms, output, i, j, dims)
+            search(
+                _remove_pair(terms, i, j, result),
+                path + [(i, j)],
+                flops + pair_flops,
+                max(largest, _size(result, dims)),
+            )
+
+    search(terms, [], 0, 0)
+    return best[1]
+
+
+def _greedy_path(terms, output, dims):
+    """The path contracting at each step the pair removing the most elements, then of least
+    FLOPs"""
+    path = []
+    while len(terms) > 1:
+        candidates = []
+        for i, j in itertools.combinations(range(len(terms)), 2):
+            flops, result = _contraction_cost(terms, output, i, j, dims)
+            removed = _size(result, dims) - _size(terms[i], dims) - _size(terms[j], dims)
+            candidates.append(((removed, flops), (i, j), result))
+        _, (i, j), result = min(candidates)
+        path.append((i, j))
+        terms = _remove_pair(terms, i, j, result)
+    return path
+
+
+def einsum_path(subscripts, shapes):
+    """Find the order of the pairwise contractions of an einsum by their FLOPs and memory.
+
+    As numpy.einsum_path, each step of the path contracts two of the current operands, which
+    are removed from the list of operands, the result of the contraction being appended to it.
+    The path of up to 5 operands is searched exhaustively for the least FLOPs, then the smallest
+    largest intermediate, the path of more operands is built greedily.
+
+    Parameters
+    ----------
+    subscripts : string
+        The subscripts of the einsum, without ellipses.
+
+    shapes : list of tuple of int
+        The static shapes of the operands.
+
+    Returns
+    -------
+    path : list of tuple of int
+        The pairs of operands contracted in order.
+    """
+    parsed = _parse_einsum(subscripts, [len(shape) for shape in shapes])
+    if parsed is None:
+        raise ValueError("einsum_path does not support the subscripts " + subscripts)
+    terms, output = parsed
+    dims = {}
+    for term, shape in zip(terms, shapes):
+        for l, dim in zip(term, shape):
+            if dims.setdefault(l, int(dim)) != int(dim):
+                raise ValueError("einsum_path does not support broadcasting the label " + l)
+    if len(terms) <= _OPTIMAL_PATH_MAX_OPERANDS:
+        return _optimal_path(terms, output, dims)
+    return _greedy_path(terms, output, dims)
+
+
+def _permute(relay, expr, labels, order):
+    """Transpose expr of labels into the order, unless it is already in it"""
+    if labels == order:
+        return expr
+    return relay.transpose(expr, [labels.index(l) for l in order])
+
+
+def _gemm_layout(term_a, term_b, keep):
+    """The batch, rows, columns and reduction labels of the GEMM of two terms, ordered as in the
+    first one, and the number of transposes it needs"""
+    batch = "".join(l for l in term_a if l in term_b and l in keep)
+    rows = "".join(l for l in term_a if l not in term_b)
+    cols = "".join(l for l in term_b if l not in term_a)
+    reduce = "".join(l for l in term_a if l in term_b and l not in keep)
+    num_transposes = int(term_a != batch + rows + reduce) + int(term_b != batch + cols + reduce)
+    return (batch, rows, cols, reduce), num_transposes
+
+
+def _contract_pair(relay, operand_a, operand_b, keep, dims):
+    """Contract two operands (expr, labels) with a dense or a batch_matmul, or a broadcast
+    multiply if they share no label to reduce"""
+    operands = []
+    for (expr, term), other in [(operand_a, operand_b[1]), (operand_b, operand_a[1])]:
+        # Sum the labels of only one operand first, before they are broadcast.
+        summed = [i for i, l in enumerate(term) if l not in other and l not in keep]
+        if summed:
+            expr = relay.sum(expr, axis=summed)
+            term = "".join(l for l in term if l in other or l in keep)
+        operands.append((expr, term))
+    (expr_a, term_a), (expr_b, term_b) = operands
+
+    # Pick the order of the operands needing the fewest transposes.
+    layout, num_transposes = _gemm_layout(term_a, term_b, keep)
+    swapped_layout, swapped_transposes = _gemm_layout(term_b, term_a, keep)
+    if swapped_transposes < num_transposes:
+        (expr_a, term_a), (expr_b, term_b) = (expr_b, term_b), (expr_a, term_a)
+        layout = swapped_layout
+    batch, rows, cols, reduce = layout
+    result = batch + rows + cols
+
+    if not reduce:
+        lhs = _permute(relay, expr_a, term_a, batch + rows)
+        rhs = _permute(relay, expr_b, term_b, batch + cols)
+        lhs_shape = [dims[l] for l in batch + rows] + [1] * len(cols)
+        rhs_shape = [dims[l] for l in batch] + [1] * len(rows) + [dims[l] for l in cols]
+        out = relay.multiply(relay.reshape(lhs, lhs_shape), relay.reshape(rhs, rhs_shape))
+        return out, result
+
+    shape_b, shape_m, shape_n, shape_k = [_size(labels, dims) for labels in layout]
+    lhs = _permute(relay, expr_a, term_a, batch + rows + reduce)
+    rhs = _permute(relay, expr_b, term_b, batch + cols + reduce)
+    if batch:
+        lhs = relay.reshape(lhs, [shape_b, shape_m, shape_k])
+        rhs = relay.reshape(rhs, [shape_b, shape_n, shape_k])
+        out = relay.nn.batch_matmul(lhs, rhs)
+    else:
+        lhs = relay.reshape(lhs, [shape_m, shape_k])
+        rhs = relay.reshape(rhs, [shape_n, shape_k])
+        out = relay.nn.dense(lhs, rhs)
+    return relay.reshape(out, [dims[l] for l in result]), result
+
+
+@tvm.target.generic_func
+def einsum_legalize(attrs, inputs, types):
+    """Legalizes an einsum of several operands into pairwise contractions.
+
+    The contractions are done in the order of einsum_path, each mapped to a dense or a
+    batch_matmul of the operands transposed and reshaped into matrices, instead of a single
+    compute over all the labels of the einsum.
+
+    Parameters
+    ----------
+    attrs : tvm.ir.Attrs
+        Attributes of current op
+    inputs : list of tvm.relay.Expr
+        The args of the Relay expr to be legalized
+    types : list of types
+        List of input and output types
+    Returns
+    -------
+    result : tvm.relay.Expr
+        The legalized expr
+    """
+    relay = tvm.relay
+    tensor_types = types[0].fields
+    if len(tensor_types) < 2 or relay.ty.is_dynamic(types[0]):
+        return None
+    shapes = [[int(dim) for dim in t.shape] for t in tensor_types]
+    parsed = _parse_einsum(attrs.equation, [len(shape) for shape in shapes])
+    if parsed is None:
+        return None
+    terms, output = parsed
+    dims = {}
+    for term, shape in zip(terms, shapes):
+        for l, dim in zip(term, shape):
+            if dims.setdefault(l, dim) != dim:
+                # Broadcast labels are left to the einsum compute.
+                return None
+
+    data = inputs[0]
+    if isinstance(data, relay.Tuple):
+        exprs = list(data.fields)
+    else:
+        exprs = [relay.TupleGetItem(data, i) for i in range(len(terms))]
+    operands = list(zip(exprs, terms))
+    for i, j in einsum_path(attrs.equation, shapes):
+        remaining = [operand for k, operand in enumerate(operands) if k not in (i, j)]
+        keep = _kept_labels([term for _, term in remaining], output, ())
+        operands = remaining + [_contract_pair(relay, operands[i], operands[j], keep, dims)]
+    expr, term = operands[0]
+    return _permute(relay, expr, term, output)
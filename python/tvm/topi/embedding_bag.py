@@ -0,0 +1,168 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-arguments, too-many-locals
+"""Embedding bag operator"""
+import tvm
+from tvm import te, tir
+from .utils import ceil_div
+
+# The number of bytes prefetched per instruction, a cache line on the usual CPUs.
+_CACHE_LINE_BYTES = 64
+
+
+def _verify_embedding_bag_inputs(weight, indices, offsets, per_sample_weights, mode):
+    assert len(weight.shape) == 2, "weight of embedding_bag must be 2-D"
+    assert len(indices.shape) == 1, "indices of embedding_bag must be 1-D"
+    assert len(offsets.shape) == 1, "offsets of embedding_bag must be 1-D"
+    assert mode in ["sum", "mean", "max"], "embedding_bag does not support the mode " + mode
+    assert (
+        len(per_sample_weights.shape) == 0 or mode == "sum"
+    ), "per_sample_weights of embedding_bag are only supported for the sum mode"
+
+
+def _embedding_bag_bounds(ib, offsets, num_bags, num_indices, b):
+    """The range [begin, end) of the rows of the bag b in indices"""
+    begin = offsets[b]
+    end = tir.if_then_else(b + 1 < num_bags, offsets[b + 1], tir.Cast(begin.dtype, num_indices))
+    begin = ib.let("begin", begin)
+    end = ib.let("end", end)
+    return begin, end
+
+
+def _embedding_bag_init(mode, dtype):
+    """The identity of the reduction of a bag"""
+    if mode == "max":
+        return tir.min_value(dtype)
+    return tir.const(0, dtype)
+
+
+def _embedding_bag_update(mode, acc, row, scale):
+    """Accumulate a row into the reduction of a bag"""
+    if mode == "max":
+        return tir.max(acc, row)
+    if scale is None:
+        return acc + row
+    return acc + row * scale
+
+
+def _embedding_bag_finalize(mode, acc, count):
+    """The reduction of a bag of count rows, zero for an empty bag"""
+    if mode == "mean":
+        return acc / tir.max(count, 1).astype(acc.dtype)
+    if mode == "max":
+        return tir.Select(count > 0, acc, tir.const(0, acc.dtype))
+    return acc
+
+
+def _embedding_bag_ir(weight, indices, offsets, per_sample_weights, out, mode):
+    """Low level IR of embedding_bag on CPU: the bags are reduced in parallel, the rows of a bag
+    are accumulated into the output row by vector loads, and the next row of the bag is prefetched
+    while the current one is accumulated."""
+    ib = tir.ir_builder.create()
+    weight_ptr = ib.buffer_ptr(weight)
+    indices_ptr = ib.buffer_ptr(indices)
+    offsets_ptr = ib.buffer_ptr(offsets)
+    psw_ptr = ib.buffer_ptr(per_sample_weights)
+    out_ptr = ib.buffer_ptr(out)
+
+    num_indices = indices.shape[0]
+    num_bags, dim = out.shape
+    dtype = out.dtype
+    scalar_scale = len(per_sample_weights.shape) == 0
+    # Vectorize the rows, only possible for a static dimension.
+    row_kind = "vectorize" if isinstance(dim, tir.IntImm) else "serial"
+    line_elems = max(_CACHE_LINE_BYTES * 8 // tvm.runtime.DataType(dtype).bits, 1)
+
+    with ib.for_range(0, num_bags, kind="parallel", name="b") as b:
+        begin, end = _embedding_bag_bounds(ib, offsets_ptr, num_bags, num_indices, b)
+        with ib.for_range(0, dim, kind=row_kind, name="j") as j:
+            out_ptr[b * dim + j] = _embedding_bag_init(mode, dtype)
+
+        with ib.for_range(0, end - begin, name="i", dtype=begin.dtype) as i:
+            pos = begin + i
+            with ib.if_scope(pos + 1 < end):
+                next_row = indices_ptr[pos + 1] * dim
+                with ib.for_range(0, ceil_div(dim, line_elems), name="l") as l:
+                    ib.emit(
+                        tir.call_intrin(
+                            "int32",
+                            "tir.prefetch",
+                            tir.address_of(weight_ptr[next_row + l * line_elems]),
+                            0,
+                            3,
+                            1,
+                        )
+                    )
+            row = indices_ptr[pos] * dim
+            if mode != "sum":
+                scale = None
+            elif scalar_scale:
+                scale = psw_ptr[0].astype(dtype)
+            else:
+                scale = psw_ptr[pos]
+            with ib.for_range(0, dim, kind=row_kind, name="j") as j:
+                out_ptr[b * dim + j] = _embedding_bag_update(
+                    mode, out_ptr[b * dim + j], weight_ptr[row + j], scale
+                )
+
+        if mode != "sum":
+            with ib.for_range(0, dim, kind=row_kind, name="j") as j:
+                out_ptr[b * dim + j] = _embedding_bag_finalize(
+                    mode, out_ptr[b * dim + j], end - begin
+                )
+    return ib.get()
+
+
+def embedding_bag(weight, indices, offsets, per_sample_weights, mode="sum"):
+    """Reduce bags of rows of an embedding table, without materializing the gathered rows.
+
+    The bag b gathers the rows indices[offsets[b]:offsets[b + 1]] of the weight, the last bag
+    the rows up to the end of indices.
+
+    Parameters
+    ----------
+    weight : tvm.te.Tensor
+        2-D embedding table [num_embeddings, dim].
+
+    indices : tvm.te.Tensor
+        1-D integer tensor, the rows of the bags concatenated.
+
+    offsets : tvm.te.Tensor
+        1-D integer tensor [num_bags], the start of each bag in indices, in increasing order.
+
+    per_sample_weights : tvm.te.Tensor
+        1-D tensor with the shape of indices scaling each row in the sum mode, or a scalar
+        scaling all the rows in the sum mode and ignored otherwise.
+
+    mode : str
+        How the rows of a bag are reduced, "sum", "mean" or "max". The mean and the maximum of an
+        empty bag are zero.
+
+    Returns
+    -------
+    out : tvm.te.Tensor
+        2-D tensor [num_bags, dim].
+    """
+    _verify_embedding_bag_inputs(weight, indices, offsets, per_sample_weights, mode)
+    return te.extern(
+        [(offsets.shape[0], weight.shape[1])],
+        [weight, indices, offsets, per_sample_weights],
+        lambda ins, outs: _embedding_bag_ir(ins[0], ins[1], ins[2], ins[3], outs[0], mode),
+        dtype=weight.dtype,
+        name="embedding_bag",
+        tag="embedding_bag",
+    )
@@ -730,6 +730,23 @@ def schedule_lrn(outs):
     return _default_schedule(outs, False)
 
 
+def schedule_layer_norm(outs):
+    """Schedule for layer_norm and rms_norm
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of layer_norm or rms_norm
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    return _default_schedule(outs, True)
+
+
 def schedule_sparse_dense(outs):
     """Schedule for sparse_dense
 
@@ -0,0 +1,113 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Core kernel of dot product of 4 Int8 operations on Hexagon HVX"""
+import tvm
+from tvm import te
+
+
+def dot_32x1x4_uint8_int8_int32_hvx():
+    """
+    Int8 dot product by every 4 elements using the HVX vrmpy instruction in 128-byte mode.
+    This function takes two arrays of uint8 and int8 datatype -- data[4] and
+    kernel[32][4] -- and computes a dot product of data[4] with every
+    4 elements of kernels, resulting in output[32] of int32 datatype.
+    The pseudo code is as follows.
+    .. code-block:: c
+        void dot_32x1x4_uint8_int8_int32_hvx(uint8 data[4], int8 kernel[32][4],
+                int32 output[32]){
+            for (int i = 0; i < 32; i++){
+                output[i] = 0;
+                for (int k = 0; k < 4; k++){
+                    output[i] += data[k] * kernel[i][k]
+                }
+            }
+        }
+
+    Physically, the kernel array sits in an HVX vector register and
+    the data[4] is broadcasted to another HVX vector register. This
+    function returns a TensorIntrin that can be used to tensorize
+    a schedule, e.g. of an int8 dense or conv2d whose kernel is packed
+    as [..., 32, 4], compiled for a target with "+hvx-length128b".
+
+    Returns
+    -------
+    intrin : TensorIntrin
+        The Hexagon HVX int8 TensorIntrin that can be used in tensorizing schedule
+    """
+
+    int32_lanes = 32  # 32 int32 lanes in a 128-byte HVX vector
+    num_int8_elements = 4  # 4 int8 elements in int32
+    data = te.placeholder((num_int8_elements,), dtype="uint8", name="data")
+    kernel = te.placeholder((int32_lanes, num_int8_elements), dtype="int8", name="kernel")
+    k = te.reduce_axis((0, num_int8_elements), name="k")
+    C = te.compute(
+        (int32_lanes,),
+        lambda i: te.sum(data[k].astype("int32") * kernel[i, k].astype("int32"), axis=k),
+        name="C",
+    )
+
+    a_buffer = tvm.tir.decl_buffer(
+        data.shape, dtype="uint8", name="a_buffer", offset_factor=1, strides=[1]
+    )
+    b_buffer = tvm.tir.decl_buffer(
+        kernel.shape, dtype="int8", name="b_buffer", offset_factor=1, strides=[te.var("ldw"), 1]
+    )
+
+    def _intrin_func(ins, outs):
+        def _instr(index):
+            ib = tvm.tir.ir_builder.create()
+            if index == 1:
+                ib.emit(outs[0].vstore(0, tvm.tir.const(0, "int32x32")))
+                return ib.get()
+
+            a_uint8 = ins[0].vload([0], "uint8x4")
+            re_int32 = tvm.tir.call_intrin("int32", "tir.reinterpret", a_uint8)
+            vec_ai32 = re_int32.astype("int32x32")
+            vec_b = ins[1].vload([0, 0], "int8x128")
+            vec_bi32 = tvm.tir.call_intrin("int32x32", "tir.reinterpret", vec_b)
+
+            if index == 0:
+                quad_reduction = tvm.tir.call_llvm_pure_intrin(
+                    "int32x32",
+                    "llvm.hexagon.V6.vrmpybusv.128B",
+                    tvm.tir.const(0, "uint32"),
+                    vec_ai32,
+                    vec_bi32,
+                )
+            else:
+                quad_reduction = tvm.tir.call_llvm_pure_intrin(
+                    "int32x32",
+                    "llvm.hexagon.V6.vrmpybusv.acc.128B",
+                    tvm.tir.const(0, "uint32"),
+                    outs[0].vload([0], "int32x32"),
+                    vec_ai32,
+                    vec_bi32,
+                )
+            ib.emit(outs[0].vstore(0, quad_reduction))
+            return ib.get()
+
+        # body, reset, update
+        return _instr(0), _instr(1), _instr(2)
+
+    buffer_params = {"offset_factor": 1}
+    return te.decl_tensor_intrin(
+        C.op,
+        _intrin_func,
+        binds={data: a_buffer, kernel: b_buffer},
+        default_buffer_params=buffer_params,
+    )
@@ -39,9 +39,12 @@ from .bnn import *
 from .qnn import *
 from .upsampling import *
 from .local_response_norm import *
+from .layer_norm import *
+from .implicit_gemm import *
 from .bitserial_conv2d import *
 from .bitserial_dense import *
 from .batch_matmul import *
+from .attention import *
 from .sparse import *
 from .pad import *
 from .fifo_buffer import *
@@ -0,0 +1,173 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, too-many-locals, too-many-arguments
+"""Fused scaled dot-product attention operator"""
+import math
+
+import tvm
+from tvm import te
+
+from ..utils import ceil_div, get_const_int
+
+
+def attention_scale(query, scale):
+    """The scale of the attention scores, 1 / sqrt(head dimension) by default."""
+    if scale:
+        return float(scale)
+    return 1.0 / math.sqrt(get_const_int(query.shape[2]))
+
+
+def attention_valid_length(ib, valid_length, b):
+    """The valid length of batch b, from a valid_length of shape (batch,) or a scalar."""
+    ptr = ib.buffer_ptr(valid_length)
+    return ptr[b] if len(valid_length.shape) == 1 else ptr[0]
+
+
+def attention_key_end(length, i, q_seq, kv_seq, causal):
+    """The end of the keys the query i attends to.
+
+    Parameters
+    ----------
+    length : tvm.tir.PrimExpr
+        The valid length of the batch of the query.
+
+    i : tvm.tir.PrimExpr
+        The query index.
+
+    q_seq, kv_seq : tvm.tir.PrimExpr
+        The lengths of the queries and keys.
+
+    causal : bool
+        Whether the queries only attend to the keys up to their positions.
+
+    Returns
+    -------
+    end : tvm.tir.PrimExpr
+        The index from which the keys are masked.
+    """
+    end = tvm.te.min(kv_seq, length.astype("int32"))
+    if causal:
+        end = tvm.te.min(end, i + kv_seq - q_seq + 1)
+    return tvm.te.max(end, 0)
+
+
+def _attention_ir(query, key, value, valid_length, out, scale, causal, block):
+    """Attention of a query per parallel task, over tiles of keys with an online softmax."""
+    ib = tvm.tir.ir_builder.create()
+    batch, q_seq, dim = query.shape
+    kv_seq = key.shape[1]
+    value_dim = get_const_int(value.shape[2])
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+
+    with ib.for_range(0, batch * q_seq, kind="parallel", name="bi") as bi:
+        b = bi // q_seq
+        i = bi % q_seq
+        length = attention_valid_length(ib, valid_length, b)
+        end = attention_key_end(length, i, q_seq, kv_seq, causal)
+        acc = ib.allocate("float32", (value_dim,), name="acc", scope="local")
+        scores = ib.allocate("float32", (block,), name="scores", scope="local")
+        # The running max and sum of the exponentials of the scores
+        run_max = ib.allocate("float32", (1,), name="run_max", scope="local")
+        run_sum = ib.allocate("float32", (1,), name="run_sum", scope="local")
+        tile_max = ib.allocate("float32", (1,), name="tile_max", scope="local")
+        run_max[0] = tvm.tir.min_value("float32")
+        run_sum[0] = 0.0
+        with ib.for_range(0, value_dim, name="d") as d:
+            acc[d] = 0.0
+
+        with ib.for_range(0, ceil_div(end, block), name="jb") as jb:
+            j0 = jb * block
+            num = tvm.te.min(block, end - j0)
+            tile_max[0] = run_max[0]
+            with ib.for_range(0, num, name="jj") as jj:
+                scores[jj] = 0.0
+                with ib.for_range(0, dim, name="d") as d:
+                    scores[jj] += q[bi * dim + d].astype("float32") * k[
+                        (b * kv_seq + j0 + jj) * dim + d
+                    ].astype("float32")
+                scores[jj] = scores[jj] * scale
+                tile_max[0] = tvm.te.max(tile_max[0], scores[jj])
+            # Rescale what was accumulated with the previous max
+            correction = tvm.te.exp(run_max[0] - tile_max[0])
+            run_sum[0] = run_sum[0] * correction
+            with ib.for_range(0, value_dim, name="d") as d:
+                acc[d] = acc[d] * correction
+            with ib.for_range(0, num, name="jj") as jj:
+                p = tvm.te.exp(scores[jj] - tile_max[0])
+                run_sum[0] += p
+                with ib.for_range(0, value_dim, name="d") as d:
+                    acc[d] += p * v[(b * kv_seq + j0 + jj) * value_dim + d].astype("float32")
+            run_max[0] = tile_max[0]
+
+        with ib.for_range(0, value_dim, name="d") as d:
+            o[bi * value_dim + d] = tvm.tir.if_then_else(
+                run_sum[0] > 0, acc[d] / run_sum[0], 0.0
+            ).astype(out.dtype)
+    return ib.get()
+
+
+def attention(query, key, value, valid_length, scale=None, causal=False, block=64):
+    """Fused scaled dot-product attention.
+
+    The scores of a query are computed a tile of keys at a time and folded into the output
+    with an online softmax, so that the (q_seq, kv_seq) score matrix is never stored.
+    The queries are computed in parallel.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        3-D with shape [batch, q_seq, dim]
+
+    key : tvm.te.Tensor
+        3-D with shape [batch, kv_seq, dim]
+
+    value : tvm.te.Tensor
+        3-D with shape [batch, kv_seq, value_dim]
+
+    valid_length : tvm.te.Tensor
+        1-D with shape [batch], or a scalar for all the batches, the number of valid keys.
+
+    scale : float, optional
+        The scale of the scores before the softmax, 1 / sqrt(dim) if None or 0.
+
+    causal : bool, optional
+        Whether a query only attends to the keys up to its position, the last query being
+        aligned with the last key.
+
+    block : int, optional
+        The number of keys of a tile.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        3-D with shape [batch, q_seq, value_dim]
+    """
+    scale = attention_scale(query, scale)
+    out_shape = [query.shape[0], query.shape[1], value.shape[2]]
+    return te.extern(
+        [out_shape],
+        [query, key, value, valid_length],
+        lambda ins, outs: _attention_ir(
+            ins[0], ins[1], ins[2], ins[3], outs[0], scale, causal, block
+        ),
+        dtype=[query.dtype],
+        name="attention",
+        tag="attention",
+    )
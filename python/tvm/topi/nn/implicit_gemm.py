@@ -0,0 +1,277 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Convolutions formulated as implicit GEMMs.
+
+The convolution is the GEMM of a patch matrix, whose rows are the output pixels and whose
+columns are the taps of the kernel, with the kernel viewed as a matrix. The patch matrix only
+maps its indices onto the data: the schedules compute its tiles on the fly instead of
+materializing it as im2col does.
+"""
+from .. import cpp
+from ..utils import get_const_tuple
+from .utils import get_pad_tuple, get_pad_tuple3d
+
+
+def _conv_geometry(data, kernel, strides, padding, dilation, layout, kernel_layout, output_padding):
+    """Normalize the arguments of a convolution for the implicit GEMM"""
+    spatial_names = [c for c in layout if c in "DHW"]
+    ndim = len(spatial_names)
+    kernel_size = [get_const_tuple(kernel.shape)[kernel_layout.index(c)] for c in spatial_names]
+
+    def _tuple(value):
+        return (value,) * ndim if isinstance(value, int) else tuple(value)
+
+    if ndim == 2:
+        padding = get_pad_tuple(padding, kernel_size)
+    else:
+        padding = get_pad_tuple3d(padding, kernel_size)
+    padding = list(padding)
+    if output_padding is not None:
+        # The output padding of a transposed convolution extends the output at the end.
+        for i, opad in enumerate(_tuple(output_padding)):
+            padding[ndim + i] -= opad
+    return kernel_size, list(_tuple(strides)), padding, list(_tuple(dilation))
+
+
+def implicit_gemm_operands(
+    data,
+    kernel,
+    strides,
+    padding,
+    dilation,
+    layout,
+    kernel_layout,
+    output_padding=None,
+    m_multiple=1,
+    n_multiple=1,
+    k_multiple=1,
+):
+    """Create the operands of an implicit GEMM convolution.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        The input, in the layout given by layout.
+
+    kernel : tvm.te.Tensor
+        The kernel, in the layout given by kernel_layout, where I are the input channels of the
+        data and O the output channels, also for a transposed convolution.
+
+    strides : int or a list/tuple of ints
+        The strides.
+
+    padding : int or a list/tuple of ints
+        The padding.
+
+    dilation : int or a list/tuple of ints
+        The dilation.
+
+    layout : str
+        The layout of the data and of the output, e.g. "NHWC".
+
+    kernel_layout : str
+        The layout of the kernel, e.g. "HWIO".
+
+    output_padding : int or a list/tuple of ints, optional
+        The output padding of a transposed convolution, None for a convolution.
+
+    m_multiple, n_multiple, k_multiple : int
+        The rows, the output channels and the taps are padded with zeros to multiples of them.
+
+    Returns
+    -------
+    patch : tvm.te.Tensor
+        2-D patch matrix [rows, taps], reading the data on the fly.
+
+    weight : tvm.te.Tensor
+        2-D weight matrix [out_channel, taps].
+
+    out_shape : list
+        The shape of the convolution output.
+    """
+    transposed = output_padding is not None
+    kernel_size, strides, padding, dilation = _conv_geometry(
+        data, kernel, strides, padding, dilation, layout, kernel_layout, output_padding
+    )
+    patch = cpp.nn.implicit_gemm_patch(
+        data, kernel_size, strides, padding, dilation, layout, transposed, m_multiple, k_multiple
+    )
+    weight = cpp.nn.implicit_gemm_weight(kernel, layout, kernel_layout, n_multiple, k_multiple)
+
+    data_spatial = [data.shape[i] for i, c in enumerate(layout) if c in "DHW"]
+    out_spatial = list(
+        cpp.nn.conv_output_spatial(
+            data_spatial, kernel_size, strides, padding, dilation, transposed
+        )
+    )
+    out_shape = []
+    for c in layout:
+        if c == "N":
+            out_shape.append(data.shape[layout.index("N")])
+        elif c == "C":
+            out_shape.append(kernel.shape[kernel_layout.index("O")])
+        else:
+            out_shape.append(out_spatial.pop(0))
+    return patch, weight, out_shape
+
+
+def implicit_gemm_output(gemm, out_shape, layout):
+    """Create the output of an implicit GEMM convolution, a view of its (possibly padded) GEMM.
+
+    Parameters
+    ----------
+    gemm : tvm.te.Tensor
+        2-D GEMM [rows, out_channel] of the patch and the weight matrices.
+
+    out_shape : list
+        The shape of the output.
+
+    layout : str
+        The layout of the output, e.g. "NHWC".
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        The output in the given layout.
+    """
+    return cpp.nn.implicit_gemm_output(gemm, out_shape, layout)
+
+
+def conv2d_implicit_gemm(
+    data, kernel, strides, padding, dilation, layout="NHWC", kernel_layout="HWIO", out_dtype=None
+):
+    """2-D convolution computed as an implicit GEMM.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        4-D input in the layout given by layout.
+
+    kernel : tvm.te.Tensor
+        4-D kernel in the layout given by kernel_layout.
+
+    strides : int or a list/tuple of two ints
+        The strides.
+
+    padding : int or a list/tuple of 2 or 4 ints
+        The padding.
+
+    dilation : int or a list/tuple of two ints
+        The dilation.
+
+    layout : str
+        The layout of the data and of the output, "NHWC" or "NCHW".
+
+    kernel_layout : str
+        The layout of the kernel, e.g. "HWIO" or "OIHW".
+
+    out_dtype : str, optional
+        The output data type, the data type of data by default.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D output in the layout given by layout.
+    """
+    out_dtype = data.dtype if out_dtype is None else out_dtype
+    _, strides, padding, dilation = _conv_geometry(
+        data, kernel, strides, padding, dilation, layout, kernel_layout, None
+    )
+    return cpp.nn.conv_implicit_gemm(
+        data, kernel, strides, padding, dilation, layout, kernel_layout, out_dtype, False
+    )
+
+
+def conv3d_implicit_gemm(
+    data, kernel, strides, padding, dilation, layout="NDHWC", kernel_layout="DHWIO", out_dtype=None
+):
+    """3-D convolution computed as an implicit GEMM.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        5-D input in the layout given by layout.
+
+    kernel : tvm.te.Tensor
+        5-D kernel in the layout given by kernel_layout.
+
+    strides : int or a list/tuple of three ints
+        The strides.
+
+    padding : int or a list/tuple of 3 or 6 ints
+        The padding.
+
+    dilation : int or a list/tuple of three ints
+        The dilation.
+
+    layout : str
+        The layout of the data and of the output, "NDHWC" or "NCDHW".
+
+    kernel_layout : str
+        The layout of the kernel, e.g. "DHWIO" or "OIDHW".
+
+    out_dtype : str, optional
+        The output data type, the data type of data by default.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        5-D output in the layout given by layout.
+    """
+    out_dtype = data.dtype if out_dtype is None else out_dtype
+    _, strides, padding, dilation = _conv_geometry(
+        data, kernel, strides, padding, dilation, layout, kernel_layout, None
+    )
+    return cpp.nn.conv_implicit_gemm(
+        data, kernel, strides, padding, dilation, layout, kernel_layout, out_dtype, False
+    )
+
+
+def conv2d_transpose_implicit_gemm(data, kernel, strides, padding, out_dtype, output_padding):
+    """Transposed 2-D convolution computed as an implicit GEMM, without dilating the data.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        4-D input with shape [batch, in_channel, in_height, in_width].
+
+    kernel : tvm.te.Tensor
+        4-D kernel with shape [in_channel, out_channel, filter_height, filter_width].
+
+    strides : int or a list/tuple of two ints
+        The strides.
+
+    padding : int or a list/tuple of 2 or 4 ints
+        The padding.
+
+    out_dtype : str
+        The output data type.
+
+    output_padding : int or a list/tuple of two ints
+        The padding added to the end of the output.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D output with shape [batch, out_channel, out_height, out_width].
+    """
+    _, strides, padding, dilation = _conv_geometry(
+        data, kernel, strides, padding, 1, "NCHW", "IOHW", output_padding
+    )
+    return cpp.nn.conv_implicit_gemm(
+        data, kernel, strides, padding, dilation, "NCHW", "IOHW", out_dtype, True
+    )
@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Layer normalization and RMS normalization operators."""
+from .. import cpp
+
+
+def layer_norm(data, gamma, beta, axis=-1, epsilon=1e-5, center=True, scale=True):
+    """Layer normalization operator.
+
+    The mean and the variance over the axis are computed in a single pass with
+    Welford's algorithm, accumulated in float32 for the narrower float types.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D input tensor.
+
+    gamma : tvm.te.Tensor
+        1-D scale with the size of the axis.
+
+    beta : tvm.te.Tensor
+        1-D offset with the size of the axis.
+
+    axis : int
+        The axis to normalize over.
+
+    epsilon : float
+        Small float added to the variance to avoid dividing by zero.
+
+    center : bool
+        Whether to add beta.
+
+    scale : bool
+        Whether to multiply by gamma.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        N-D output with the same shape as data.
+    """
+    return cpp.nn.layer_norm(data, gamma, beta, axis, epsilon, center, scale)
+
+
+def rms_norm(data, gamma, axis=-1, epsilon=1e-5, scale=True):
+    """Root mean square normalization operator.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D input tensor.
+
+    gamma : tvm.te.Tensor
+        1-D scale with the size of the axis.
+
+    axis : int
+        The axis to normalize over.
+
+    epsilon : float
+        Small float added to the mean square to avoid dividing by zero.
+
+    scale : bool
+        Whether to multiply by gamma.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        N-D output with the same shape as data.
+    """
+    return cpp.nn.rms_norm(data, gamma, axis, epsilon, scale)
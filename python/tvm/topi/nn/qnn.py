@@ -188,3 +188,83 @@ def simulated_dequantize(data, in_dtype, input_scale=None, input_zero_point=None
         return intn_value
 
     return te.compute(data.shape, lambda *indices: _dispatch_sim_dequantize(data)[indices])
+
+
+@tvm.te.tag_scope(tag=topi.tag.INJECTIVE)
+def pack_int4(weight):
+    """Pack int4 values, held in int8, two per byte along the last axis.
+
+    Parameters
+    ----------
+    weight: tvm.te.Tensor
+        An N-D int8 tensor with values in [-8, 7], its last axis of even size.
+
+    Returns
+    -------
+    output: tvm.te.Tensor
+        The uint8 tensor with the last axis halved. Element 2i is in the low nibble of byte i
+        and element 2i + 1 in its high nibble.
+    """
+    oshape = list(weight.shape)
+    oshape[-1] = oshape[-1] // 2
+
+    def _pack(*indices):
+        lo = weight[indices[:-1] + (indices[-1] * 2,)].astype("uint8") & tir.const(0xF, "uint8")
+        hi = weight[indices[:-1] + (indices[-1] * 2 + 1,)].astype("uint8") & tir.const(0xF, "uint8")
+        return lo | (hi << tir.const(4, "uint8"))
+
+    return te.compute(oshape, _pack)
+
+
+def dense_int4(data, packed_weight, weight_scale, out_dtype=None):
+    """Dense with int4 weights, unpacked and scaled in the reduction.
+
+    Parameters
+    ----------
+    data: tvm.te.Tensor
+        2-D float tensor with shape [batch, in_dim].
+
+    packed_weight: tvm.te.Tensor
+        2-D uint8 tensor with shape [out_dim, in_dim // 2], packed by :py:func:`pack_int4`.
+
+    weight_scale: tvm.te.Tensor
+        The scale of the weights, with shape (), [out_dim] or [out_dim, groups] where each of
+        the groups covers in_dim // groups consecutive elements of the reduction.
+
+    out_dtype: Optional[str]
+        The output type, the type of data by default.
+
+    Returns
+    -------
+    output: tvm.te.Tensor
+        2-D tensor with shape [batch, out_dim].
+    """
+    assert len(data.shape) == 2 and len(packed_weight.shape) == 2
+    if out_dtype is None:
+        out_dtype = data.dtype
+    batch, in_dim = data.shape
+    out_dim, in_bytes = packed_weight.shape
+    kb = te.reduce_axis((0, in_bytes), name="kb")
+    ki = te.reduce_axis((0, 2), name="ki")
+
+    def _weight(n, byte, i):
+        # Sign extend the nibble: (v ^ 8) - 8 maps [8, 15] to [-8, -1].
+        nibble = (packed_weight[n, byte] >> (i * 4).astype("uint8")) & tir.const(0xF, "uint8")
+        value = (nibble ^ tir.const(8, "uint8")).astype("int32") - 8
+        k = byte * 2 + i
+        if len(weight_scale.shape) == 0:
+            scale = weight_scale()
+        elif len(weight_scale.shape) == 1:
+            scale = weight_scale[n]
+        else:
+            scale = weight_scale[n, k // (in_dim // weight_scale.shape[1])]
+        return value.astype(out_dtype) * scale.astype(out_dtype)
+
+    return te.compute(
+        (batch, out_dim),
+        lambda m, n: te.sum(
+            data[m, kb * 2 + ki].astype(out_dtype) * _weight(n, kb, ki), axis=[kb, ki]
+        ),
+        name="T_dense_int4",
+        tag="dense_int4",
+    )
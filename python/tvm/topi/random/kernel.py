@@ -94,37 +94,45 @@ _PERMUTATIONS = {
 }
 
 
-def _threefry(
-    irb, key_buf, key_offset, counter_buf, counter_offset, out_buf, out_offset, out_shape
-):
-    """IRBuilder code for running Threefry
+def _is_gpu():
+    target = tvm.target.Target.current(allow_none=True)
+    return target is not None and "gpu" in target.keys
 
-    Parameters
-    ----------
-    irb: IRBuilder
-        IRBuilder that this code will be generated for.
 
-    key_buf: BufferVar
-        Buffer to read the key from.
+def _threefry_full_key(irb, key_buf, key_offset, scope):
+    """IRBuilder code for the key schedule of Threefry
 
-    key_offset: number
-        Threefry will write to :code:`key_buf[key_offset:key_offset+4]`
+    The full key is composed of the original key with one element appended. The appended element
+    is the xor of all key words plus a constant, :code:`k_{N_W}` in the Skein paper.
+    """
+    nwords = 4
+    full_key = irb.allocate("uint64", nwords + 1, name="full_key", scope=scope)
+    for i in range(nwords):
+        full_key[i] = key_buf[key_offset + i]
+    full_key[nwords] = tvm.tir.const(0x1BD11BDAA9FC1A22, dtype="uint64")
+    for i in range(nwords):
+        full_key[nwords] ^= key_buf[key_offset + i]
+    return full_key
 
-    counter_buf: BufferVar
-        Buffer to read the counter from.
 
-    counter_offset: number
-        Threefry will write to :code:`counter_buf[counter_offset:counter_offset+4]`
+def _threefry(irb, full_key, counter):
+    """IRBuilder code for running Threefry on a single block
 
-    out_buf: BufferVar
-        Buffer to read the counter from.
+    Parameters
+    ----------
+    irb: IRBuilder
+        IRBuilder that this code will be generated for.
 
-    out_offset: number
-        Threefry will write to :code:`out_buf[out_offset:out_offset+4*product(out_shape)]`
+    full_key: BufferVar
+        The full key, see :py:func:`_threefry_full_key`.
 
-    out_shape: number
-        Determines the number of output states to generate. :code:`state[i]` will correspond to
-        counter+i.
+    counter: list of PrimExpr
+        The 4 words of the counter to hash.
+
+    Returns
+    -------
+    words: list of PrimExpr
+        The 4 words of the hash, to be read before running Threefry in the same scope again.
     """
     nrounds = 20
     nwords = 4
@@ -134,32 +142,14 @@ def _threefry(
 
     # The paper has constants for 32 bit threefry, but we keep the implementation simple by only
     # using 64-bit words.
-    assert key_buf.dtype == "uint64", "threefry only supports 64-bit keys"
-    assert key_buf.dtype == counter_buf.dtype, "threefry key and counter must be the same dtype"
-
-    def mix(a, b, rotation):
-        x = a + b  # wrapping
-        y = x ^ ((b << rotation) | (b >> (iwidth - rotation)))
-        return [x, y]
-
-    # temporary buffer for holding the results of _PERMUTATIONS
-    tmp = irb.allocate(out_buf.dtype, out_shape * nwords, name="tmp", scope="global")
-    tmp_offset = 0
-
-    # Initialize entire key. It is composed of the original key with one
-    # element appended. The appended element is the xor of all key words plus a
-    # constant.
-    full_key = irb.allocate("uint64", nwords + 1, name="full_key", scope="global")
-    for i in range(nwords):
-        full_key[i] = key_buf[key_offset + i]
-    # initial key constant, full_key[nwords] is equivalent to k_{N_W} in the Skein paper.
-    full_key[nwords] = tvm.tir.const(0x1BD11BDAA9FC1A22, dtype="uint64")
-    for i in range(nwords):
-        full_key[nwords] ^= key_buf[key_offset + i]
+    assert full_key.dtype == "uint64", "threefry only supports 64-bit keys"
 
-    with irb.for_range(0, out_shape, dtype="uint64", name="i") as i:
-        for j in range(nwords):
-            out_buf[out_offset + i * nwords + j] = counter_buf[counter_offset + j] + i
+    # The block lives in registers: the words are mixed in place and the permutations only rename
+    # them, so the indices into the block are all constant.
+    block = irb.allocate("uint64", nwords, name="block", scope="local")
+    for j in range(nwords):
+        block[j] = counter[j]
+    word = list(range(nwords))
 
     def key_schedule(s, i):
         # Threefry uses no tweak, so the key schedule is simple
@@ -167,27 +157,166 @@ def _threefry(
             return full_key[(s + i) % (nwords + 1)] + tvm.tir.const(s, dtype="uint64")
         return full_key[(s + i) % (nwords + 1)]
 
-    with irb.for_range(0, out_shape, name="l") as l:  # pylint: disable=invalid-name
-        for i in range(nrounds // 4):
-            for j in range(nwords):
-                out_buf[out_offset + l * nwords + j] += key_schedule(i, j)  # wrapping
-            for k in range(4):
-                for j in range(nwords // 2):
-                    (
-                        out_buf[out_offset + l * nwords + j * 2 + 0],
-                        out_buf[out_offset + l * nwords + j * 2 + 1],
-                    ) = mix(
-                        out_buf[out_offset + l * nwords + j * 2 + 0],
-                        out_buf[out_offset + l * nwords + j * 2 + 1],
-                        _ROTATIONS[nwords][(i * 4 + k) % 8][j],
-                    )
-                for j in range(nwords):
-                    tmp[tmp_offset + l * nwords + j] = out_buf[
-                        out_offset + l * nwords + _PERMUTATIONS[nwords][j]
-                    ]
-                # number of rounds is even, so out always contains the result
-                (out_buf, tmp) = (tmp, out_buf)
-                (out_offset, tmp_offset) = (tmp_offset, out_offset)
+    for i in range(nrounds // 4):
+        for j in range(nwords):
+            block[word[j]] += key_schedule(i, j)  # wrapping
+        for k in range(4):
+            for j in range(nwords // 2):
+                a, b = word[j * 2 + 0], word[j * 2 + 1]
+                rotation = _ROTATIONS[nwords][(i * 4 + k) % 8][j]
+                block[a] = block[a] + block[b]  # wrapping
+                block[b] = block[a] ^ ((block[b] << rotation) | (block[b] >> (iwidth - rotation)))
+            word = [word[_PERMUTATIONS[nwords][j]] for j in range(nwords)]
+    return [block[word[j]] for j in range(nwords)]
+
+
+def _threefry_state(irb, gen, out_len, scope):
+    """IRBuilder code for the generator state to generate `out_len` random numbers from
+
+    If there is not enough room left in the counter of `gen`, the path is extended, or the key
+    replaced when there is no room left in the path either, and the counter reset.
+    """
+    # Create a temporary array to hold the generator state we will use to create the random
+    # numbers. We cannot use gen because we may need to update the key + path if there is not
+    # enough room in the counter.
+    tmp = irb.allocate(gen.dtype, 10, name="tmp", scope=scope)
+
+    # TODO(tkonolige): for now we only use the last word of the counter for counting. It is too
+    # much work to figure out how to do 128 bit addition.
+
+    # Max value for counter should be 2**64-2 because we need to reserve a special value to
+    # indicate the counter is used up.
+    with irb.if_scope(gen[7] < tir.const(2 ** 64 - 1 - out_len, dtype=gen.dtype)):
+        for i in range(10):
+            tmp[i] = gen[i]
+    with irb.else_scope():
+        # no room left in the counter, we have to change the path or key
+        with irb.if_scope(tir.all(gen[8] == 0, gen[9] == 0)):
+            # out of room in the path, have to generate new key
+
+            # The paper says the counter that we will be hashing should be a special value of
+            # all ones.
+            full_key = _threefry_full_key(irb, gen, 0, scope)
+            ones = tir.const(0xFFFFFFFFFFFFFFFF, dtype=gen.dtype)
+            for i, word in enumerate(_threefry(irb, full_key, [ones] * 4)):
+                tmp[i] = word
+            tmp[4] = tir.const(0, dtype=gen.dtype)  # zero path, i.e. no path
+            tmp[5] = tir.const(0, dtype=gen.dtype)
+            tmp[6] = tir.const(0, dtype=gen.dtype)  # zero counter
+            tmp[7] = tir.const(0, dtype=gen.dtype)
+            tmp[8] = tir.const(1 << 63, dtype=gen.dtype)  # one in the leftmost position
+            tmp[9] = tir.const(0, dtype=gen.dtype)
+        with irb.else_scope():
+            tmp[0] = gen[0]
+            tmp[1] = gen[1]
+            tmp[2] = gen[2]
+            tmp[3] = gen[3]
+            tmp[4] = gen[4] | gen[8]  # add a 1 to the path
+            tmp[5] = gen[5] | gen[9]
+            tmp[6] = tir.const(0, dtype=gen.dtype)  # zero counter
+            tmp[7] = tir.const(0, dtype=gen.dtype)
+            _shift_right(irb, gen[8], gen[9], tmp, 8, tmp, 9)
+    return tmp
+
+
+def _threefry_generate(gen, params, out_shape, out_dtype, fmap, name):
+    """Generate a series of random values, each mapped by `fmap` before being stored
+
+    The blocks of 4 random numbers are independent, so they are generated in parallel: by the
+    threads of a parallel loop on CPU and by a thread per block on GPU, where each thread
+    recomputes the generator state instead of waiting for it. The random bits are never stored:
+    `fmap(word, params)` maps each 64-bit word to the output value, e.g. a float of a
+    distribution, from the buffers of the `params` tensors.
+    """
+    out_len = 1
+    for s in out_shape:
+        out_len *= int(s)
+    assert (
+        out_len <= 2 ** 64 - 1
+    ), f"Can only generate up to 2^64 random numbers, but {out_len} were requested."
+    nblocks = (out_len + 3) // 4
+    nfull = out_len // 4
+
+    def gen_ir(ins, outs):
+        irb = ir_builder.create()
+        gen = irb.buffer_ptr(ins[0])
+        param_bufs = [irb.buffer_ptr(param) for param in ins[1:]]
+        out_gen = irb.buffer_ptr(outs[0])
+        out_array = irb.buffer_ptr(outs[1])
+
+        # Check that unsigned arithmetic wraps, as it is required to implement threefry correctly.
+        irb.emit(
+            tvm.tir.AssertStmt(
+                tvm.tir.const(0xFFFFFFFFFFFFFFFF, "uint64") + tvm.tir.const(1, "uint64")
+                == tvm.tir.const(0, "uint64"),
+                tvm.tir.StringImm(
+                    "Unsigned integer arithmetic is not wrapping, but threefry requires wrapping."
+                ),
+                tvm.tir.Evaluate(0),
+            )
+        )
+
+        def generate_block(tmp, full_key, l):
+            block = tir.Cast(gen.dtype, l)
+            # Block l hashes the counter incremented by l, except the last partial block, which
+            # hashes the counter incremented by the number of values in the full blocks.
+            counter = [tmp[4 + j] + block for j in range(4)]
+            if nfull != nblocks:
+                remaining = [tmp[4], tmp[5], tmp[6], tmp[7] + tir.const(nfull * 4, gen.dtype)]
+                counter = [tir.Select(l < nfull, a, b) for a, b in zip(counter, remaining)]
+            for j, word in enumerate(_threefry(irb, full_key, counter)):
+                if nfull == nblocks or j < out_len % 4:
+                    out_array[l * 4 + j] = fmap(word, param_bufs)
+                else:
+                    with irb.if_scope(l < nfull):
+                        out_array[l * 4 + j] = fmap(word, param_bufs)
+
+        def update_gen(tmp):
+            out_gen[0] = tmp[0]  # key stays the same
+            out_gen[1] = tmp[1]
+            out_gen[2] = tmp[2]
+            out_gen[3] = tmp[3]
+            out_gen[4] = tmp[4]  # path stays the same
+            out_gen[5] = tmp[5]
+            out_gen[6] = tir.const(0, dtype=gen.dtype)  # unused, leave it as 0
+            # as we generate 4 random numbers for the remaining, increase by a full block for them.
+            out_gen[7] = tmp[7] + tir.const(nblocks * 4 if nfull != nblocks else out_len, gen.dtype)
+            out_gen[8] = tmp[8]  # path unchanged, so no update here
+            out_gen[9] = tmp[9]
+
+        if _is_gpu():
+            max_threads = int(tvm.target.Target.current(allow_none=False).max_num_threads)
+            nthreads = min(nblocks, max_threads)
+            tx = tvm.te.thread_axis("threadIdx.x")
+            bx = tvm.te.thread_axis("blockIdx.x")
+            irb.scope_attr(tx, "thread_extent", nthreads)
+            irb.scope_attr(bx, "thread_extent", (nblocks + nthreads - 1) // nthreads)
+            l = bx * nthreads + tx
+            tmp = _threefry_state(irb, gen, out_len, "local")
+            full_key = _threefry_full_key(irb, tmp, 0, "local")
+            with irb.if_scope(l < nblocks):
+                generate_block(tmp, full_key, l)
+            with irb.if_scope(l == 0):
+                update_gen(tmp)
+        else:
+            tmp = _threefry_state(irb, gen, out_len, "global")
+            full_key = _threefry_full_key(irb, tmp, 0, "global")
+            with irb.for_range(0, nblocks, kind="parallel", name="l") as l:
+                generate_block(tmp, full_key, l)
+            update_gen(tmp)
+
+        return irb.get()
+
+    out_gen = tvm.tir.decl_buffer((10,), name="out_gen", dtype="uint64")
+    out_array = tvm.tir.decl_buffer(out_shape, name="out_array", dtype=out_dtype)
+    return tvm.te.extern(
+        [out_gen.shape, out_array.shape],
+        [gen] + list(params),
+        gen_ir,
+        out_buffers=[out_gen, out_array],
+        name=name,
+        tag=name,
+    )
 
 
 def threefry_generate(gen, out_shape):
@@ -228,111 +357,8 @@ def threefry_generate(gen, out_shape):
     rand : Tensor[out_shape, uint64]
         Tensor of random numbers with shape `out_shape`.
     """
-    out_len = tir.const(1)
-    for s in out_shape:
-        out_len *= s
-    assert (
-        out_len.value <= 2 ** 64 - 1
-    ), f"Can only generate up to 2^64 random numbers, but {out_len} were requested."
-
-    def gen_ir(gen_ptr, out_gen_ptr, out_array_ptr):
-        irb = ir_builder.create()
-        gen = irb.buffer_ptr(gen_ptr)
-        out_gen = irb.buffer_ptr(out_gen_ptr)
-        out_array = irb.buffer_ptr(out_array_ptr)
-
-        # Check that unsigned arithmetic wraps, as it is required to implement threefry correctly.
-        irb.emit(
-            tvm.tir.AssertStmt(
-                tvm.tir.const(0xFFFFFFFFFFFFFFFF, "uint64") + tvm.tir.const(1, "uint64")
-                == tvm.tir.const(0, "uint64"),
-                tvm.tir.StringImm(
-                    "Unsigned integer arithmetic is not wrapping, but threefry requires wrapping."
-                ),
-                tvm.tir.Evaluate(0),
-            )
-        )
-
-        # Create a temporary array to hold the generator state we will use to create the random
-        # numbers. We cannot use gen because we may need to update the key + path if there is not
-        # enough room in the counter.
-        tmp = irb.allocate(gen.dtype, 10, name="tmp", scope="global")
-
-        # TODO(tkonolige): for now we only use the last word of the counter for counting. It is too
-        # much work to figure out how to do 128 bit addition.
-
-        # Max value for counter should be 2**64-2 because we need to reserve a special value to
-        # indicate the counter is used up.
-        with irb.if_scope(gen[7] < tir.const(2 ** 64 - 1, dtype=gen.dtype) - out_len):
-            for i in range(10):
-                tmp[i] = gen[i]
-        with irb.else_scope():
-            # no room left in the counter, we have to change the path or key
-            with irb.if_scope(gen[8] == 0 and gen[9] == 0):
-                # out of room in the path, have to generate new key
-
-                # The paper says the counter that we will be hashing should be a special value of
-                # all ones. We need to allocate some space for it because we cannot overwrite gen.
-                tmp_counter = irb.allocate(gen.dtype, 2, name="tmp_counter", scope="global")
-                tmp_counter[0] = tir.const(0xFFFFFFFFFFFFFFFF, dtype=gen.dtype)
-                tmp_counter[1] = tir.const(0xFFFFFFFFFFFFFFFF, dtype=gen.dtype)
-                _threefry(irb, gen, 0, tmp_counter, 0, tmp, 0, 1)
-                tmp[4] = tir.const(0, dtype=gen.dtype)  # zero path, i.e. no path
-                tmp[5] = tir.const(0, dtype=gen.dtype)
-                tmp[6] = tir.const(0, dtype=gen.dtype)  # zero counter
-                tmp[7] = tir.const(0, dtype=gen.dtype)
-                tmp[8] = tir.const(1 << 63, dtype=gen.dtype)  # one in the leftmost position
-                tmp[9] = tir.const(0, dtype=gen.dtype)
-            with irb.else_scope():
-                tmp[0] = gen[0]
-                tmp[1] = gen[1]
-                tmp[2] = gen[2]
-                tmp[3] = gen[3]
-                tmp[4] = gen[4] | gen[8]  # add a 1 to the path
-                tmp[5] = gen[5] | gen[9]
-                tmp[6] = tir.const(0, dtype=gen.dtype)  # zero counter
-                tmp[7] = tir.const(0, dtype=gen.dtype)
-                _shift_right(irb, gen[8], gen[9], tmp, 8, tmp, 9)
-
-        # Compute random values
-        if out_len.value >= 4:
-            _threefry(irb, tmp, 0, tmp, 4, out_array, 0, out_len // 4)
-        if out_len.value % 4 != 0:
-            remaining = irb.allocate(gen.dtype, 4, name="remaining", scope="global")
-            tmp[7] = tmp[7] + tir.Cast(gen.dtype, out_len // 4 * 4)  # increment counter
-            _threefry(irb, tmp, 0, tmp, 4, remaining, 0, 1)
-            with irb.for_range(0, out_len % 4, dtype="uint64", name="i") as i:
-                out_array[out_len // 4 * 4 + i] = remaining[i]
-
-        # Update generator state
-        out_gen[0] = tmp[0]  # key stays the same
-        out_gen[1] = tmp[1]
-        out_gen[2] = tmp[2]
-        out_gen[3] = tmp[3]
-        out_gen[4] = tmp[4]  # path stays the same
-        out_gen[5] = tmp[5]
-        out_gen[6] = tir.const(0, dtype=gen.dtype)  # unused, leave it as 0
-        if out_len.value % 4 != 0:
-            # increment counter for the remaining
-            # as we will generate 4 random numbers for the remaining, increase 4 here.
-            # the main increment was done before the second _threefry.
-            out_gen[7] = tmp[7] + tir.Cast(gen.dtype, 4)
-        else:
-            out_gen[7] = tmp[7] + tir.Cast(gen.dtype, out_len)  # increment counter
-        out_gen[8] = tmp[8]  # path unchanged, so no update here
-        out_gen[9] = tmp[9]
-
-        return irb.get()
-
-    out_gen = tvm.tir.decl_buffer((10,), name="out_gen", dtype="uint64")
-    out_array = tvm.tir.decl_buffer(out_shape, name="out_array", dtype="uint64")
-    return tvm.te.extern(
-        [out_gen.shape, out_array.shape],
-        [gen],
-        lambda ins, outs: gen_ir(ins[0], outs[0], outs[1]),
-        out_buffers=[out_gen, out_array],
-        name="threefry_generate",
-        tag="threefry_generate",
+    return _threefry_generate(
+        gen, [], out_shape, "uint64", lambda word, _: word, name="threefry_generate"
     )
 
 
@@ -381,10 +407,16 @@ def threefry_split(gen):
         gen = irb.buffer_ptr(gen_ptr)
         out_left = irb.buffer_ptr(out_left_ptr)
         out_right = irb.buffer_ptr(out_right_ptr)
+        scope = "global"
+        if _is_gpu():
+            irb.scope_attr(tvm.te.thread_axis("threadIdx.x"), "thread_extent", 1)
+            scope = "local"
 
-        with irb.if_scope(gen[8] == 0 and gen[9] == 0):
+        with irb.if_scope(tir.all(gen[8] == 0, gen[9] == 0)):
             # Generate new key because we have run out of room to extend the path
-            _threefry(irb, gen, 0, gen, 4, out_left, 0, 1)
+            full_key = _threefry_full_key(irb, gen, 0, scope)
+            for i, word in enumerate(_threefry(irb, full_key, [gen[4 + j] for j in range(4)])):
+                out_left[i] = word
             out_left[4] = tir.const(0, dtype=gen.dtype)
             out_left[5] = tir.const(0, dtype=gen.dtype)
             out_left[6] = tir.const(0, dtype=gen.dtype)  # counter gets zeroed
@@ -487,6 +519,9 @@ def uniform(gen, low, high, out_shape, out_dtype):
     (includes low, but excludes high). In other words, any value within the
     given interval is equally likely to be drawn by uniform.
 
+    The random bits are turned into samples as they are generated, in the same kernel, so they are
+    never stored.
+
     Parameters
     ----------
     gen : ThreefryKey
@@ -515,7 +550,6 @@ def uniform(gen, low, high, out_shape, out_dtype):
     out : Tensor[out_shape, out_dtype]
         Tensor of random numbers with shape `out_shape` and type `out_dtype`.
     """
-    new_gen, random_bits = threefry_generate(gen, out_shape)
     assert out_dtype in ("float32", "float64"), (
         "Only support float32 or float64 for now, got %s" % out_dtype
     )
@@ -528,19 +562,17 @@ def uniform(gen, low, high, out_shape, out_dtype):
         nbits = 64
         nfraction = 52
     nexp = nbits - nfraction - 1
-    random_bits = random_bits.astype(random_dtype)
 
-    fraction = tvm.topi.right_shift(
-        random_bits, tvm.tir.const(nbits - nfraction, dtype=random_dtype)
-    )
-    exponent = tvm.topi.left_shift(
-        tvm.topi.full(out_shape, random_dtype, (1 << (nexp - 1)) - 1),
-        tvm.tir.const(nfraction, dtype=random_dtype),
+    def standard_uniform(word, params):
+        low, high = params
+        random_bits = tir.Cast(random_dtype, word)
+        fraction = random_bits >> tir.const(nbits - nfraction, dtype=random_dtype)
+        exponent = tir.const(((1 << (nexp - 1)) - 1) << nfraction, dtype=random_dtype)
+        # The float of the exponent of 1 and of the random fraction, in [1, 2).
+        mantissa = tir.call_intrin(out_dtype, "tir.reinterpret", fraction | exponent)
+        standard_uniform_value = mantissa - tir.const(1, dtype=out_dtype)
+        return standard_uniform_value * (high[0] - low[0]) + low[0]
+
+    return _threefry_generate(
+        gen, [low, high], out_shape, out_dtype, standard_uniform, name="uniform"
     )
-    mantissa = tvm.topi.bitwise_or(fraction, exponent).astype(random_dtype)
-    standard_uniform_values = tvm.topi.reinterpret(mantissa, out_dtype) - tvm.tir.const(
-        1, dtype=out_dtype
-    )
-    uniform_values = tvm.topi.add(tvm.topi.multiply(standard_uniform_values, high - low), low)
-
-    return new_gen, uniform_values
@@ -16,12 +16,22 @@
 # under the License.
 # pylint: disable=invalid-name, unused-variable, unused-argument
 """Schedule for dense operator"""
+import tvm
 from tvm import te
 from tvm import autotvm
 from tvm.contrib import rocblas
 from .. import generic, nn
 from .. import tag
 from ..utils import traverse_inline
+from .tensor_intrin import (
+    WAVEFRONT_SIZE,
+    has_mfma,
+    mfma,
+    mfma_a_index,
+    mfma_b_index,
+    mfma_c_index,
+    mfma_num_elems,
+)
 
 
 @autotvm.register_topi_compute("dense.rocm")
@@ -141,3 +151,103 @@ def dense_rocblas(cfg, data, weight, bias=None, out_dtype=None):
 def schedule_dense_rocblas(_, outs):
     """Schedule for dense operator with rocm cblas"""
     return generic.schedule_extern(outs)
+
+
+# The MFMA of dense_mfma, the shape (m, n, k) of its tiles.
+MFMA_DENSE_SHAPE = (32, 32, 8)
+
+
+def _dense_mfma_ir(data, weight, bias, out, shape):
+    """One wavefront per tile of the output, accumulating along the reduction with MFMA."""
+    m, n, k = shape
+    a_elems, b_elems, c_elems = mfma_num_elems(shape)
+    in_dim = data.shape[1]
+    ib = tvm.tir.ir_builder.create()
+    tx = te.thread_axis("threadIdx.x")
+    bx = te.thread_axis("blockIdx.x")
+    by = te.thread_axis("blockIdx.y")
+    ib.scope_attr(tx, "thread_extent", WAVEFRONT_SIZE)
+    ib.scope_attr(bx, "thread_extent", out.shape[1] // n)
+    ib.scope_attr(by, "thread_extent", out.shape[0] // m)
+    out_ptr = ib.buffer_ptr(out)
+    bias_ptr = ib.buffer_ptr(bias) if bias is not None else None
+
+    acc = ib.allocate("float32", c_elems, name="acc", scope="local")
+    acc_ramp = tvm.tir.Ramp(0, 1, c_elems)
+    ib.emit(tvm.tir.Store(acc.asobject(), tvm.tir.const(0, "float32x%d" % c_elems), acc_ramp))
+    with ib.for_range(0, in_dim // k, name="ko") as ko:
+        row, a_k = mfma_a_index(tx, 0, shape)
+        b_k, col = mfma_b_index(tx, 0, shape)
+        a = data.vload([by * m + row, ko * k + a_k], "float16x%d" % a_elems)
+        b = weight.vload([bx * n + col, ko * k + b_k], "float16x%d" % b_elems)
+        c = tvm.tir.Load("float32x%d" % c_elems, acc.asobject(), acc_ramp)
+        ib.emit(tvm.tir.Store(acc.asobject(), mfma(a, b, c, "float16", shape), acc_ramp))
+    for j in range(c_elems):
+        row, col = mfma_c_index(tx, j, shape)
+        value = acc[j]
+        if bias is not None:
+            value = value + bias_ptr[bx * n + col].astype("float32")
+        out_ptr[by * m + row, bx * n + col] = value.astype(out.dtype)
+    return ib.get()
+
+
+def can_use_mfma(data, weight, out_dtype, target):
+    """Whether dense_mfma supports the dense on the target."""
+    if not has_mfma(target) or data.dtype != "float16" or weight.dtype != "float16":
+        return False
+    if out_dtype not in ["float16", "float32"]:
+        return False
+    shapes = list(data.shape) + list(weight.shape)
+    if not all(isinstance(dim, tvm.tir.IntImm) for dim in shapes):
+        return False
+    m, n, k = MFMA_DENSE_SHAPE
+    batch, in_dim = [int(dim) for dim in data.shape]
+    out_dim = int(weight.shape[0])
+    return batch % m == 0 and out_dim % n == 0 and in_dim % k == 0
+
+
+@autotvm.register_topi_compute("dense_mfma.rocm")
+def dense_mfma(cfg, data, weight, bias=None, out_dtype=None):
+    """Dense operator with float16 inputs on the matrix cores of the CDNA GPUs.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        2-D with shape [batch, in_dim], the batch a multiple of 32.
+
+    weight : tvm.te.Tensor
+        2-D with shape [out_dim, in_dim], out_dim a multiple of 32 and in_dim of 8.
+
+    bias : tvm.te.Tensor, optional
+        1-D with shape [out_dim]
+
+    out_dtype : str
+        The output type, float16 or float32. The accumulation is in float32.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        2-D with shape [batch, out_dim]
+    """
+    if out_dtype is None:
+        out_dtype = data.dtype
+    batch, in_dim = data.shape
+    out_dim, _ = weight.shape
+    cfg.add_flop(batch * in_dim * out_dim * 2)
+    ins = [data, weight] + ([bias] if bias is not None else [])
+    return te.extern(
+        (batch, out_dim),
+        ins,
+        lambda ins, outs: _dense_mfma_ir(
+            ins[0], ins[1], ins[2] if len(ins) > 2 else None, outs[0], MFMA_DENSE_SHAPE
+        ),
+        dtype=out_dtype,
+        name="dense_mfma",
+        tag="dense_mfma",
+    )
+
+
+@autotvm.register_topi_schedule("dense_mfma.rocm")
+def schedule_dense_mfma(_, outs):
+    """Schedule for dense_mfma"""
+    return generic.schedule_extern(outs)
@@ -0,0 +1,128 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The MFMA matrix core instructions of the AMD CDNA GPUs.
+
+An MFMA multiplies a m x k tile of A by a k x n tile of B into a m x n tile of C, the
+tiles being distributed over the 64 lanes of a wavefront. The helpers give the position
+in the tiles of the elements held by a lane, in the layout of the instructions without
+broadcast (cbsz, abid and blgp of 0).
+"""
+import tvm
+
+WAVEFRONT_SIZE = 64
+
+# The LLVM intrinsic of the input dtype and the shape (m, n, k).
+MFMA_INTRINSICS = {
+    ("float32", (32, 32, 2)): "llvm.amdgcn.mfma.f32.32x32x2f32",
+    ("float32", (16, 16, 4)): "llvm.amdgcn.mfma.f32.16x16x4f32",
+    ("float16", (32, 32, 8)): "llvm.amdgcn.mfma.f32.32x32x8f16",
+    ("float16", (16, 16, 16)): "llvm.amdgcn.mfma.f32.16x16x16f16",
+    ("int8", (32, 32, 8)): "llvm.amdgcn.mfma.i32.32x32x8i8",
+    ("int8", (16, 16, 16)): "llvm.amdgcn.mfma.i32.16x16x16i8",
+}
+
+# The GPUs with matrix cores.
+MFMA_MCPUS = ["gfx908", "gfx90a", "gfx940", "gfx941", "gfx942"]
+
+
+def has_mfma(target):
+    """Whether the target GPU has the MFMA instructions."""
+    return target.kind.name == "rocm" and target.mcpu in MFMA_MCPUS
+
+
+def mfma_num_elems(shape):
+    """The number of elements of A, of B and of C held by a lane.
+
+    Parameters
+    ----------
+    shape : tuple of int
+        The shape (m, n, k) of the instruction.
+
+    Returns
+    -------
+    a_elems, b_elems, c_elems : int
+    """
+    m, n, k = shape
+    return m * k // WAVEFRONT_SIZE, n * k // WAVEFRONT_SIZE, m * n // WAVEFRONT_SIZE
+
+
+def mfma_a_index(lane, i, shape):
+    """The (row, k) of the i-th element of A held by a lane."""
+    m, _, _ = shape
+    a_elems, _, _ = mfma_num_elems(shape)
+    return lane % m, (lane // m) * a_elems + i
+
+
+def mfma_b_index(lane, i, shape):
+    """The (k, col) of the i-th element of B held by a lane."""
+    _, n, _ = shape
+    _, b_elems, _ = mfma_num_elems(shape)
+    return (lane // n) * b_elems + i, lane % n
+
+
+def mfma_c_index(lane, j, shape):
+    """The (row, col) of the j-th element of C held by a lane.
+
+    The lanes of a column hold blocks of 4 consecutive rows, the blocks of the groups of lanes
+    interleaving along the rows.
+    """
+    _, n, _ = shape
+    groups = WAVEFRONT_SIZE // n
+    return (j // 4) * 4 * groups + (lane // n) * 4 + j % 4, lane % n
+
+
+def mfma(a, b, c, in_dtype, shape):
+    """Multiply-accumulate the fragments of a wavefront with an MFMA.
+
+    Parameters
+    ----------
+    a : PrimExpr
+        The elements of A held by the lane, a vector for more than one, the int8 packed in an
+        int32.
+
+    b : PrimExpr
+        The elements of B held by the lane, as for a.
+
+    c : PrimExpr
+        The elements of C held by the lane, a float32 or int32 vector.
+
+    in_dtype : str
+        The dtype of A and B.
+
+    shape : tuple of int
+        The shape (m, n, k) of the instruction.
+
+    Returns
+    -------
+    c : PrimExpr
+        The accumulated elements of C.
+    """
+    key = (in_dtype, tuple(shape))
+    if key not in MFMA_INTRINSICS:
+        raise ValueError("No MFMA of shape %s for %s" % (shape, in_dtype))
+    zero = tvm.tir.const(0, "int32")
+    return tvm.tir.call_llvm_pure_intrin(
+        c.dtype,
+        MFMA_INTRINSICS[key],
+        tvm.tir.const(0, "uint32"),
+        a,
+        b,
+        c,
+        zero,
+        zero,
+        zero,
+    )
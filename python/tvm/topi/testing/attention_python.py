@@ -0,0 +1,66 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Scaled dot-product attention in python"""
+import numpy as np
+
+
+def attention_python(query, key, value, valid_length=None, scale=None, causal=False):
+    """Scaled dot-product attention implemented in numpy.
+
+    Parameters
+    ----------
+    query : numpy.ndarray
+        3-D with shape [batch, q_seq, dim]
+
+    key : numpy.ndarray
+        3-D with shape [batch, kv_seq, dim]
+
+    value : numpy.ndarray
+        3-D with shape [batch, kv_seq, value_dim]
+
+    valid_length : numpy.ndarray, optional
+        1-D with shape [batch], or a scalar, the number of valid keys
+
+    scale : float, optional
+        The scale of the scores, 1 / sqrt(dim) if None
+
+    causal : bool, optional
+        Whether a query only attends to the keys up to its position
+
+    Returns
+    -------
+    out : numpy.ndarray
+        3-D with shape [batch, q_seq, value_dim]
+    """
+    batch, q_seq, dim = query.shape
+    kv_seq = key.shape[1]
+    scale = 1.0 / np.sqrt(dim) if not scale else scale
+    scores = np.matmul(query.astype("float32"), key.astype("float32").transpose(0, 2, 1)) * scale
+    mask = np.ones((batch, q_seq, kv_seq), dtype=bool)
+    if valid_length is not None:
+        lengths = np.broadcast_to(np.asarray(valid_length), (batch,))
+        mask &= np.arange(kv_seq)[None, None, :] < lengths[:, None, None]
+    if causal:
+        mask &= np.arange(kv_seq)[None, :] <= np.arange(q_seq)[:, None] + kv_seq - q_seq
+    scores = np.where(mask, scores, -np.inf)
+    row_max = np.max(scores, axis=-1, keepdims=True)
+    row_max = np.where(np.isfinite(row_max), row_max, 0)
+    probs = np.exp(scores - row_max)
+    row_sum = np.sum(probs, axis=-1, keepdims=True)
+    probs = probs / np.where(row_sum > 0, row_sum, 1)
+    return np.matmul(probs, value.astype("float32")).astype(query.dtype)
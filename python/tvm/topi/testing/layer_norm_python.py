@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Layer normalization and RMS normalization in python"""
+import numpy as np
+
+
+def _expand(param, ndim, axis):
+    shape = [1] * ndim
+    shape[axis] = -1
+    return param.reshape(shape)
+
+
+def layer_norm_python(data, gamma, beta, axis=-1, epsilon=1e-5, center=True, scale=True):
+    """Layer normalization operator in Python.
+
+    Parameters
+    ----------
+    data : numpy.ndarray
+        N-D input array
+
+    gamma : numpy.ndarray
+        1-D scale with the size of the axis
+
+    beta : numpy.ndarray
+        1-D offset with the size of the axis
+
+    axis : int
+        The axis to normalize over
+
+    epsilon : float
+        Small float added to the variance to avoid dividing by zero
+
+    center : bool
+        Whether to add beta
+
+    scale : bool
+        Whether to multiply by gamma
+
+    Returns
+    -------
+    result : numpy.ndarray
+        N-D array with the same shape as data
+    """
+    x = data.astype("float64")
+    axis = axis % data.ndim
+    mean = np.mean(x, axis=axis, keepdims=True)
+    var = np.var(x, axis=axis, keepdims=True)
+    result = (x - mean) / np.sqrt(var + epsilon)
+    if scale:
+        result = result * _expand(gamma.astype("float64"), data.ndim, axis)
+    if center:
+        result = result + _expand(beta.astype("float64"), data.ndim, axis)
+    return result.astype(data.dtype)
+
+
+def rms_norm_python(data, gamma, axis=-1, epsilon=1e-5, scale=True):
+    """Root mean square normalization operator in Python.
+
+    Parameters
+    ----------
+    data : numpy.ndarray
+        N-D input array
+
+    gamma : numpy.ndarray
+        1-D scale with the size of the axis
+
+    axis : int
+        The axis to normalize over
+
+    epsilon : float
+        Small float added to the mean square to avoid dividing by zero
+
+    scale : bool
+        Whether to multiply by gamma
+
+    Returns
+    -------
+    result : numpy.ndarray
+        N-D array with the same shape as data
+    """
+    x = data.astype("float64")
+    axis = axis % data.ndim
+    result = x / np.sqrt(np.mean(x * x, axis=axis, keepdims=True) + epsilon)
+    if scale:
+        result = result * _expand(gamma.astype("float64"), data.ndim, axis)
+    return result.astype(data.dtype)
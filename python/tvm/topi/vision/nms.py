@@ -344,19 +344,19 @@ def hybrid_nms(
         data.dtype,
     )
 
-    for i in range(batch_size):
+    for i in parallel(batch_size):
         if iou_threshold > 0:
             if valid_count[i] > 0:
                 # Reorder output
                 nkeep = valid_count[i]
                 if 0 < top_k < nkeep:
                     nkeep = top_k
-                for j in parallel(nkeep):
+                for j in range(nkeep):
                     for k in range(box_data_length):
                         output[i, j, k] = data[i, sorted_index[i, j], k]
                     box_indices[i, j] = sorted_index[i, j]
                 if 0 < top_k < valid_count[i]:
-                    for j in parallel(valid_count[i] - nkeep):
+                    for j in range(valid_count[i] - nkeep):
                         for k in range(box_data_length):
                             output[i, j + nkeep, k] = -one
                         box_indices[i, j + nkeep] = -1
@@ -455,13 +455,13 @@ def hybrid_nms(
                         num_valid_boxes += 1
 
         else:
-            for j in parallel(valid_count[i]):
+            for j in range(valid_count[i]):
                 for k in range(box_data_length):
                     output[i, j, k] = data[i, j, k]
                 box_indices[i, j] = j
 
         # Set invalid entry to be -1
-        for j in parallel(num_anchors - valid_count[i]):
+        for j in range(num_anchors - valid_count[i]):
             for k in range(box_data_length):
                 output[i, j + valid_count[i], k] = -one
             box_indices[i, j + valid_count[i]] = -1
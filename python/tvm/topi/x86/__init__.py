@@ -26,6 +26,8 @@ from .binarize_pack import schedule_binarize_pack
 from .binary_dense import schedule_binary_dense
 from .nn import *
 from .conv2d_int8 import *
+from .conv2d_winograd import *
+from .conv_implicit_gemm import *
 from .injective import *
 from .reduction import *
 from .pooling import schedule_pool, schedule_adaptive_pool
@@ -40,5 +42,7 @@ from .conv3d_transpose import *
 from .sparse import *
 from .conv2d_alter_op import *
 from .dense_alter_op import *
+from .dense_int4 import schedule_dense_int4
 from .scatter import *
 from .group_conv2d import *
+from .transform import *
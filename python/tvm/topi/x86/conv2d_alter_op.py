@@ -26,6 +26,7 @@ from tvm import relay
 from tvm import autotvm
 from .conv2d import _get_default_config
 from .conv2d_int8 import is_int8_hw_support, _get_default_config_int8
+from .conv2d_winograd import _infer_tile_size
 from ..utils import get_const_tuple
 from ..nn import conv2d_legalize, conv2d_alter_layout
 from ..nn.utils import get_pad_tuple
@@ -262,6 +263,40 @@ def _alter_conv2d_layout(attrs, inputs, tinfos, out_type):
             assert _OIHWio_matcher.match(kernel_layout)
         return relay.nn.contrib_depthwise_conv2d_nchwc(*inputs, **new_attrs)
 
+    if topi_tmpl == "conv2d_nchw_winograd.x86":
+        assert data_layout == "NCHW" and kernel_layout == "OIHW"
+        CO, CI, KH, KW = get_const_tuple(kernel_tensor.shape)
+        VC = cfg["tile_k"].size[-1]
+        if cfg.is_fallback:
+            tile_size = _infer_tile_size(data_tensor, kernel_tensor)
+        else:
+            tile_size = cfg["tile_size"].val
+
+        # Pre-compute the weight transform, FoldConstant folds it when the weight is bound.
+        weight_expr = relay.nn.contrib_conv2d_winograd_weight_transform(
+            inputs[1], tile_size=tile_size
+        )
+        weight_expr = relay.reshape(
+            weight_expr, newshape=(KH + tile_size - 1, KW + tile_size - 1, CO // VC, VC, CI)
+        )
+        weight_expr = relay.transpose(weight_expr, axes=[0, 1, 2, 4, 3])
+
+        new_attrs["tile_size"] = tile_size
+        new_attrs["channels"] = CO
+
+        new_kernel = te.placeholder(
+            (KH + tile_size - 1, KW + tile_size - 1, CO // VC, CI, VC), kernel_dtype
+        )
+        new_workload = autotvm.task.args_to_workload(
+            [data_tensor, new_kernel, strides, padding, dilation, out_dtype],
+            "conv2d_nchw_winograd.x86",
+        )
+        dispatch_ctx.update(target, new_workload, cfg)
+
+        return relay.nn.contrib_conv2d_winograd_without_weight_transform(
+            inputs[0], weight_expr, **new_attrs
+        )
+
     return None
 
 
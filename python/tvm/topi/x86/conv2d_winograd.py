@@ -0,0 +1,96 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name,unused-variable,unused-argument
+"""Winograd conv2d schedule for x86"""
+from tvm import te
+from tvm import autotvm
+from tvm.autotvm.task.space import OtherOptionEntity
+
+from ..utils import traverse_inline, get_const_tuple
+from ..arm_cpu.conv2d import _decl_winograd, _schedule_winograd
+
+# The output tile sizes tried by the tuner, i.e. F(2x2, 3x3), F(4x4, 3x3) and F(6x6, 3x3).
+# Larger tiles need fewer multiplications but transform larger input tiles and lose precision.
+WINOGRAD_TILE_SIZES = [4, 2, 6]
+
+
+def _infer_tile_size(data, kernel):
+    """The tile size of an untuned workload: F(4x4, 3x3) unless the output is too small
+    for 4x4 tiles to pay off."""
+    if len(kernel.shape) == 5:
+        # The kernel is pre-transformed, its tiles are (tile_size + 2) x (tile_size + 2).
+        return get_const_tuple(kernel.shape)[0] - 2
+    _, _, H, W = get_const_tuple(data.shape)
+    return 4 if H % 4 == 0 and W % 4 == 0 and H >= 8 else 2
+
+
+@autotvm.register_topi_compute("conv2d_nchw_winograd.x86")
+def conv2d_nchw_winograd(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute conv2d_nchw using Winograd, with the output tile size tuned per workload
+
+    Parameters
+    ----------
+    cfg: ConfigEntity
+        The config for this template
+
+    data : tvm.te.Tensor
+        4-D with shape [batch, in_channel, in_height, in_width]
+
+    kernel : tvm.te.Tensor
+        4-D with shape [num_filter, in_channel, 3, 3], or the pre-transformed kernel
+        of shape [alpha, alpha, num_filter // VC, in_channel, VC]
+
+    strides : int or a list/tuple of two ints
+        Stride size, must be 1
+
+    padding : int or a list/tuple of two or four ints
+        Padding size
+
+    dilation: int or a list/tuple of two ints
+        Dilation size
+
+    out_dtype : str
+        The output data type
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        4-D with shape [batch, out_channel, out_height, out_width]
+    """
+    cfg.define_knob("tile_size", WINOGRAD_TILE_SIZES)
+    if cfg.is_fallback:
+        cfg["tile_size"] = OtherOptionEntity(_infer_tile_size(data, kernel))
+    if len(kernel.shape) == 5:
+        # A pre-transformed kernel fixes the tile size.
+        tile_size = get_const_tuple(kernel.shape)[0] - 2
+    else:
+        tile_size = cfg["tile_size"].val
+    return _decl_winograd(cfg, data, kernel, strides, padding, dilation, out_dtype, tile_size)
+
+
+@autotvm.register_topi_schedule("conv2d_nchw_winograd.x86")
+def schedule_conv2d_nchw_winograd(cfg, outs):
+    """Create schedule for conv2d_nchw_winograd"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "winograd_conv2d_output" in op.tag:
+            output = op.output(0)
+            _schedule_winograd(cfg, s, output, outs[0])
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
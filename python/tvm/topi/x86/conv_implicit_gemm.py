@@ -0,0 +1,152 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name,too-many-arguments
+"""Implicit GEMM convolutions tensorized with the int8 dot product intrinsics"""
+from tvm import te
+from tvm import autotvm
+from tvm.autotvm.task.space import SplitEntity
+
+from .. import nn
+from ..utils import traverse_inline, get_const_tuple
+from .dense import _dense_int8_packed
+from .tensor_intrin import dot_16x1x16_uint8_int8_int32
+
+_VNNI_TAG = "implicit_gemm_vnni"
+_VNNI_LANES = 16
+
+
+def _implicit_gemm_int8(
+    cfg,
+    data,
+    kernel,
+    strides,
+    padding,
+    dilation,
+    out_dtype,
+    layouts,
+    output_padding=None,
+    tag_name=_VNNI_TAG,
+    lanes=_VNNI_LANES,
+):
+    """Compute an int8 convolution as an implicit GEMM whose output channels are packed by
+    lanes, the output width of the dot product intrinsic, and whose taps are padded to a
+    multiple of 4. layouts are the layouts of the data and of the kernel."""
+    layout, kernel_layout = layouts
+    patch, weight, out_shape = nn.implicit_gemm_operands(
+        data,
+        kernel,
+        strides,
+        padding,
+        dilation,
+        layout,
+        kernel_layout,
+        output_padding,
+        n_multiple=lanes,
+        k_multiple=4,
+    )
+    M, K = get_const_tuple(patch.shape)
+    N, _ = get_const_tuple(weight.shape)
+    cfg.define_split("tile_y", M, num_outputs=2, filter=lambda y: y.size[-1] <= 16)
+    if cfg.is_fallback:
+        tile_y = 8
+        while M % tile_y != 0:
+            tile_y //= 2
+        cfg["tile_y"] = SplitEntity([M // tile_y, tile_y])
+    cfg.add_flop(M * N * K * 2)
+    gemm = _dense_int8_packed(patch, weight, None, out_dtype, tag_name, lanes)
+    return nn.implicit_gemm_output(gemm, out_shape, layout)
+
+
+def _schedule_implicit_gemm_int8(cfg, outs, tag_name, lanes, intrin):
+    """Schedule an int8 implicit GEMM convolution. The patch matrix is computed for a tile of
+    rows at a time, in a buffer reused by all the output channels of the tile."""
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if op.tag == tag_name:
+            C = op.output(0)
+            patch, packed_weight = C.op.input_tensors
+            s[packed_weight.op.input_tensors[0]].compute_inline()
+            z, y, _, _ = s[packed_weight].op.axis
+            s[packed_weight].parallel(s[packed_weight].fuse(z, y))
+
+            y, x = s[C].op.axis
+            (k,) = s[C].op.reduce_axis
+            yo, yi = cfg["tile_y"].apply(s, C, y)
+            xo, xi = s[C].split(x, factor=lanes)
+            ko, ki = s[C].split(k, factor=4)
+            s[C].reorder(yo, xo, ko, yi, xi, ki)
+            s[C].unroll(yi)
+            s[C].tensorize(xi, intrin)
+            s[C].parallel(yo)
+            s[patch].compute_at(s[C], yo)
+
+    traverse_inline(s, outs[0].op, _callback)
+
+    out = outs[0]
+    axes = s[out].op.axis
+    s[out].parallel(s[out].fuse(*axes[:-1]))
+    return s
+
+
+@autotvm.register_topi_compute("conv2d_nhwc_implicit_gemm_vnni.x86")
+def conv2d_nhwc_implicit_gemm_vnni(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute an uint8 by int8 NHWC conv2d as an implicit GEMM with AVX-512 VNNI"""
+    return _implicit_gemm_int8(
+        cfg, data, kernel, strides, padding, dilation, out_dtype, ("NHWC", "HWIO")
+    )
+
+
+@autotvm.register_topi_schedule("conv2d_nhwc_implicit_gemm_vnni.x86")
+def schedule_conv2d_nhwc_implicit_gemm_vnni(cfg, outs):
+    """Create the schedule for conv2d_nhwc_implicit_gemm_vnni"""
+    intrin = dot_16x1x16_uint8_int8_int32()
+    return _schedule_implicit_gemm_int8(cfg, outs, _VNNI_TAG, _VNNI_LANES, intrin)
+
+
+@autotvm.register_topi_compute("conv3d_ndhwc_implicit_gemm_vnni.x86")
+def conv3d_ndhwc_implicit_gemm_vnni(cfg, data, kernel, strides, padding, dilation, out_dtype):
+    """Compute an uint8 by int8 NDHWC conv3d as an implicit GEMM with AVX-512 VNNI"""
+    return _implicit_gemm_int8(
+        cfg, data, kernel, strides, padding, dilation, out_dtype, ("NDHWC", "DHWIO")
+    )
+
+
+@autotvm.register_topi_schedule("conv3d_ndhwc_implicit_gemm_vnni.x86")
+def schedule_conv3d_ndhwc_implicit_gemm_vnni(cfg, outs):
+    """Create the schedule for conv3d_ndhwc_implicit_gemm_vnni"""
+    intrin = dot_16x1x16_uint8_int8_int32()
+    return _schedule_implicit_gemm_int8(cfg, outs, _VNNI_TAG, _VNNI_LANES, intrin)
+
+
+@autotvm.register_topi_compute("conv2d_transpose_nchw_implicit_gemm_vnni.x86")
+def conv2d_transpose_nchw_implicit_gemm_vnni(
+    cfg, data, kernel, strides, padding, out_dtype, output_padding
+):
+    """Compute an uint8 by int8 NCHW conv2d_transpose as an implicit GEMM with AVX-512 VNNI,
+    without dilating the data"""
+    return _implicit_gemm_int8(
+        cfg, data, kernel, strides, padding, 1, out_dtype, ("NCHW", "IOHW"), output_padding
+    )
+
+
+@autotvm.register_topi_schedule("conv2d_transpose_nchw_implicit_gemm_vnni.x86")
+def schedule_conv2d_transpose_nchw_implicit_gemm_vnni(cfg, outs):
+    """Create the schedule for conv2d_transpose_nchw_implicit_gemm_vnni"""
+    intrin = dot_16x1x16_uint8_int8_int32()
+    return _schedule_implicit_gemm_int8(cfg, outs, _VNNI_TAG, _VNNI_LANES, intrin)
@@ -27,6 +27,8 @@ from tvm.contrib import mkl
 from tvm.contrib import mkldnn
 
 from .utils import get_fp32_len
+from .tensor_intrin import dot_16x1x16_uint8_int8_int32
+from .tensor_intrin import dot_16x16x64_uint8_int8_int32_sapphirerapids
 from .. import generic, tag
 from ..utils import traverse_inline, get_const_tuple
 
@@ -280,6 +282,139 @@ def schedule_dense_pack(cfg, outs):
     return s
 
 
+def _dense_int8_packed(data, weight, bias, out_dtype, tag_name, lanes=16):
+    """Compute an int8 dense with the weight packed as columns of 4 consecutive elements of the
+    reduction, 16 columns being the layout consumed by vpdpbusd and tdpbusd."""
+    M, K = get_const_tuple(data.shape)
+    N, _ = get_const_tuple(weight.shape)
+    packed_weight = te.compute(
+        (N // lanes, K // 4, lanes, 4),
+        lambda z, y, x, w: weight[z * lanes + x, y * 4 + w],
+        name="packed_weight",
+    )
+
+    idxdiv = tvm.tir.indexdiv
+    idxmod = tvm.tir.indexmod
+    k = te.reduce_axis((0, K), name="k")
+    C = te.compute(
+        (M, N),
+        lambda y, x: te.sum(
+            data[y, k].astype("int32")
+            * packed_weight[idxdiv(x, lanes), idxdiv(k, 4), idxmod(x, lanes), idxmod(k, 4)].astype(
+                "int32"
+            ),
+            axis=k,
+        ),
+        tag=tag_name,
+    )
+    if bias is not None:
+        C = te.compute((M, N), lambda i, j: C[i, j] + bias[j].astype("int32"), tag=tag.BROADCAST)
+    if out_dtype != "int32":
+        C = te.compute((M, N), lambda i, j: C[i, j].astype(out_dtype), tag=tag.ELEMWISE)
+    return C
+
+
+def _schedule_dense_int8_output(s, C, O, tile_y):
+    """Schedule the elementwise stages after the dense and return the parallel axis."""
+    if C == O:
+        return None
+    y, x = s[O].op.axis
+    yo, yi = s[O].split(y, factor=tile_y)
+    xo, xi = s[O].split(x, factor=16)
+    s[O].reorder(yo, xo, yi, xi)
+    fused = s[O].fuse(yo, xo)
+    s[O].vectorize(xi)
+    s[O].parallel(fused)
+    s[C].compute_at(s[O], fused)
+    return fused
+
+
+@autotvm.register_topi_compute("dense_vnni.x86")
+def dense_vnni(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute an uint8 by int8 dense with AVX-512 VNNI. N must be a multiple of 16 and K of 4.
+    The weight is packed by the operator."""
+    if out_dtype is None:
+        out_dtype = "int32"
+    M, K = get_const_tuple(data.shape)
+    N, _ = get_const_tuple(weight.shape)
+    cfg.define_split("tile_y", M, num_outputs=2, filter=lambda y: y.size[-1] <= 16)
+    if cfg.is_fallback:
+        tile_y = 8
+        while M % tile_y != 0:
+            tile_y //= 2
+        cfg["tile_y"] = SplitEntity([M // tile_y, tile_y])
+    cfg.add_flop(M * N * K * 2)
+    return _dense_int8_packed(data, weight, bias, out_dtype, "dense_vnni")
+
+
+@autotvm.register_topi_schedule("dense_vnni.x86")
+def schedule_dense_vnni(cfg, outs):
+    """Create the schedule for dense_vnni"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "dense_vnni" in op.tag:
+            C = op.output(0)
+            packed_weight = C.op.input_tensors[1]
+            z, y, _, _ = s[packed_weight].op.axis
+            s[packed_weight].parallel(s[packed_weight].fuse(z, y))
+
+            tile_y = cfg["tile_y"].size[-1]
+            fused = _schedule_dense_int8_output(s, C, outs[0], tile_y)
+            y, x = s[C].op.axis
+            (k,) = s[C].op.reduce_axis
+            yo, yi = cfg["tile_y"].apply(s, C, y)
+            xo, xi = s[C].split(x, factor=16)
+            ko, ki = s[C].split(k, factor=4)
+            s[C].reorder(yo, xo, ko, yi, xi, ki)
+            s[C].unroll(yi)
+            s[C].tensorize(xi, dot_16x1x16_uint8_int8_int32())
+            if fused is None:
+                s[C].parallel(s[C].fuse(yo, xo))
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
+
+
+@autotvm.register_topi_compute("dense_amx_int8.x86")
+def dense_amx_int8(cfg, data, weight, bias=None, out_dtype=None):
+    """Compute an uint8 by int8 dense with AMX tiles. M and N must be multiples of 16 and K
+    of 64. The weight is packed by the operator."""
+    if out_dtype is None:
+        out_dtype = "int32"
+    M, K = get_const_tuple(data.shape)
+    N, _ = get_const_tuple(weight.shape)
+    cfg.add_flop(M * N * K * 2)
+    return _dense_int8_packed(data, weight, bias, out_dtype, "dense_amx_int8")
+
+
+@autotvm.register_topi_schedule("dense_amx_int8.x86")
+def schedule_dense_amx_int8(cfg, outs):
+    """Create the schedule for dense_amx_int8"""
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if "dense_amx_int8" in op.tag:
+            C = op.output(0)
+            packed_weight = C.op.input_tensors[1]
+            z, y, _, _ = s[packed_weight].op.axis
+            s[packed_weight].parallel(s[packed_weight].fuse(z, y))
+
+            fused = _schedule_dense_int8_output(s, C, outs[0], 16)
+            y, x = s[C].op.axis
+            (k,) = s[C].op.reduce_axis
+            yo, yi = s[C].split(y, factor=16)
+            xo, xi = s[C].split(x, factor=16)
+            ko, ki = s[C].split(k, factor=64)
+            s[C].reorder(yo, xo, ko, yi, xi, ki)
+            s[C].tensorize(yi, dot_16x16x64_uint8_int8_int32_sapphirerapids())
+            if fused is None:
+                s[C].parallel(s[C].fuse(yo, xo))
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
+
+
 def matmul_blas_common(cfg, tensor_a, tensor_b, bias, out_dtype, transpose_a, transpose_b, lib):
     """Compute matmul/dense using a BLAS library"""
     M, K = get_const_tuple(tensor_a.shape)
@@ -0,0 +1,59 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Schedule of the dense with int4 weights for CPUs"""
+from tvm import te
+from ..utils import traverse_inline, get_const_int
+
+
+def schedule_dense_int4(outs):
+    """Schedule the dense with int4 weights, unpacking the weights in registers.
+
+    The rows of the output are split into tiles of eight channels run in parallel, the two
+    nibbles of each weight byte are unpacked and consumed back to back.
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+        The computation graph description of qnn.dense_int4 in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+
+    def _callback(op):
+        if op.tag != "dense_int4":
+            return
+        dense = op.output(0)
+        out = outs[0]
+        m, n = s[out].op.axis
+        n_factor = 8 if get_const_int(out.shape[1]) % 8 == 0 else 1
+        no, ni = s[out].split(n, factor=n_factor)
+        s[out].reorder(m, no, ni)
+        s[out].parallel(s[out].fuse(m, no))
+        if dense.op != out.op:
+            s[dense].compute_at(s[out], ni)
+        kb, ki = s[dense].op.reduce_axis
+        s[dense].reorder(kb, ki)
+        s[dense].unroll(ki)
+
+    traverse_inline(s, outs[0].op, _callback)
+    return s
@@ -16,7 +16,9 @@
 # under the License.
 # pylint: disable=invalid-name,too-many-locals,unused-variable
 """x86 nn operators"""
+import tvm
 from tvm import te
+from .. import cpp
 
 
 def schedule_softmax(outs):
@@ -80,3 +82,21 @@ def schedule_softmax(outs):
         s[exp].compute_at(s[softmax], fused_outer_axes)
 
     return s
+
+
+def schedule_layer_norm(outs):
+    """Schedule for layer_norm and rms_norm
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+          The computation graph description of layer_norm or rms_norm
+          in the format of an array of tensors.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    target = tvm.target.Target.current(allow_none=False)
+    return cpp.x86.schedule_layer_norm(target, outs)
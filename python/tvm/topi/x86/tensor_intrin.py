@@ -20,18 +20,17 @@ import tvm
 from tvm import te
 import tvm.target.codegen
 
+from .utils import target_has_avx512, target_has_vnni
+
 
 def dot_16x1x16_uint8_int8_int32():
     """Dispatch the most optimized intrin depending on the target"""
     mcpu = tvm.target.Target.current().mcpu
 
-    assert mcpu in (
-        "skylake-avx512",
-        "cascadelake",
-    ), "An old Intel machine that does not have fast Int8 support."
-    if mcpu == "skylake-avx512":
+    assert target_has_avx512(mcpu), "An old Intel machine that does not have fast Int8 support."
+    if not target_has_vnni(mcpu):
         return dot_16x1x16_uint8_int8_int32_skylake()
-    # cascadelake
+    # cascadelake and later
     return dot_16x1x16_uint8_int8_int32_cascadelake()
 
 
@@ -326,3 +325,102 @@ def dot_16x1x16_uint8_int8_int32_cascadelake():
         binds={data: a_buffer, kernel: b_buffer},
         default_buffer_params=buffer_params,
     )
+
+
+def dot_16x16x64_uint8_int8_int32_sapphirerapids():
+    """
+    Int8 matrix multiplication of 16x64 by 64x16 using AMX Sapphire Rapids instructions.
+    This function takes a uint8 matrix data[16][64] and an int8 matrix kernel[16][16][4],
+    which holds the 64x16 right hand side as 16 rows of 16 groups of 4 consecutive
+    elements of a column, and computes output[16][16] of int32 datatype.
+    The pseudo code is as follows.
+    .. code-block:: c
+        void dot_16x16x64_uint8_int8_int32_sapphirerapids(uint8 data[16][64],
+                int8 kernel[16][16][4], int32 output[16][16]){
+            for (int i = 0; i < 16; i++){
+                for (int j = 0; j < 16; j++){
+                    output[i][j] = 0;
+                    for (int k = 0; k < 64; k++){
+                        output[i][j] += data[i][k] * kernel[k / 4][j][k % 4]
+                    }
+                }
+            }
+        }
+
+    Physically, the data, the kernel and the output each sit in a 1KB tile register, and
+    tdpbusd computes the whole product. The tile registers are configured by
+    amx_tile_config at the entry of the function that uses this intrinsic. A process must
+    call tvm.topi.x86.utils.amx_init before running the code.
+
+    Returns
+    -------
+    intrin : TensorIntrin
+        The Sapphire Rapids int8 TensorIntrin that can be used in tensorizing schedule
+    """
+
+    rows = 16  # 16 rows in a tile
+    num_int8_elements = 64  # 64 bytes per row of a tile
+    data = te.placeholder((rows, num_int8_elements), dtype="uint8", name="data")
+    kernel = te.placeholder((num_int8_elements // 4, rows, 4), dtype="int8", name="kernel")
+    k = te.reduce_axis((0, num_int8_elements), name="k")
+    C = te.compute(
+        (rows, rows),
+        lambda i, j: te.sum(
+            data[i, k].astype("int32")
+            * kernel[tvm.tir.indexdiv(k, 4), j, tvm.tir.indexmod(k, 4)].astype("int32"),
+            axis=k,
+        ),
+        name="C",
+    )
+
+    a_buffer = tvm.tir.decl_buffer(
+        data.shape, dtype="uint8", name="a_buffer", offset_factor=1, strides=[te.var("lda"), 1]
+    )
+    b_buffer = tvm.tir.decl_buffer(
+        kernel.shape,
+        dtype="int8",
+        name="b_buffer",
+        offset_factor=1,
+        strides=[te.var("ldb"), 4, 1],
+    )
+    c_buffer = tvm.tir.decl_buffer(
+        C.shape, dtype="int32", name="c_buffer", offset_factor=1, strides=[te.var("ldc"), 1]
+    )
+
+    def _amx(name, *args):
+        return tvm.tir.call_llvm_intrin("int32", name, tvm.tir.const(0, "uint32"), *args)
+
+    def _stride(buf, num_bytes):
+        return (buf.strides[0] * num_bytes).astype("int64")
+
+    # The tiles 0, 1 and 2 hold the output, the data and the kernel.
+    tile_c, tile_a, tile_b = [tvm.tir.const(i, "int8") for i in range(3)]
+
+    def _intrin_func(ins, outs):
+        def _instr(index):
+            ib = tvm.tir.ir_builder.create()
+            ib.emit(tvm.tir.call_intrin("int32", "tir.amx_tile_config", 16, 64, 16, 64, 16, 64))
+            c_ptr, c_stride = outs[0].access_ptr("rw"), _stride(outs[0], 4)
+            if index == 2:
+                ib.emit(_amx("llvm.x86.tileloadd64", tile_c, c_ptr, c_stride))
+            else:
+                ib.emit(_amx("llvm.x86.tilezero", tile_c))
+            if index != 1:
+                a_ptr, a_stride = ins[0].access_ptr("r"), _stride(ins[0], 1)
+                b_ptr, b_stride = ins[1].access_ptr("r"), _stride(ins[1], 1)
+                ib.emit(_amx("llvm.x86.tileloadd64", tile_a, a_ptr, a_stride))
+                ib.emit(_amx("llvm.x86.tileloadd64", tile_b, b_ptr, b_stride))
+                ib.emit(_amx("llvm.x86.tdpbusd", tile_c, tile_a, tile_b))
+            ib.emit(_amx("llvm.x86.tilestored64", tile_c, c_ptr, c_stride))
+            return ib.get()
+
+        # body, reset, update
+        return _instr(0), _instr(1), _instr(2)
+
+    buffer_params = {"offset_factor": 1}
+    return te.decl_tensor_intrin(
+        C.op,
+        _intrin_func,
+        binds={data: a_buffer, kernel: b_buffer, C: c_buffer},
+        default_buffer_params=buffer_params,
+    )
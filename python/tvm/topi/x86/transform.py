@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""x86 schedules of transforms"""
+import tvm
+from tvm import te
+from .utils import get_fp32_len
+
+# The side of the tiles a transpose works on at once, a tile of the input and of the output of
+# 32-bit elements taking 4KB each, well within the L1 cache.
+TRANSPOSE_TILE = 32
+
+
+def schedule_transpose_from_existing(sch, out, axes=None):
+    """Schedule a transpose, or a layout_transform permuting the axes, moving the innermost axis.
+
+    The injective schedule walks the output in order, so each load of the input jumps by the
+    stride of an input row. Here the output axis reading the innermost input axis and the
+    innermost output axis are tiled into TRANSPOSE_TILE x TRANSPOSE_TILE blocks, the input rows of
+    a block staying in cache while it is transposed, and the blocks are split further into
+    square micro-tiles of a vector, unrolled over the rows and vectorized over the columns so
+    that the in-register transposes are built out of the rows loaded.
+
+    Parameters
+    ----------
+    sch: Schedule
+         The schedule to update.
+    out: Tensor
+         The tensor representing the transpose.
+    axes: list of int, optional
+         The input axis of each output axis, reversed by default as in a 2D transpose.
+
+    Returns
+    -------
+    sch: Schedule
+         The updated schedule.
+    """
+    op_axes = list(sch[out].op.axis)
+    ndim = len(op_axes)
+    perm = list(axes) if axes is not None else list(reversed(range(ndim)))
+    # The output axis reading the innermost input axis.
+    inner = perm.index(ndim - 1)
+    lanes = max(get_fp32_len() * 32 // tvm.runtime.DataType(out.dtype).bits, 1)
+    lanes = min(lanes, TRANSPOSE_TILE)
+
+    mo, mi = sch[out].split(op_axes[inner], factor=TRANSPOSE_TILE)
+    no, ni = sch[out].split(op_axes[-1], factor=TRANSPOSE_TILE)
+    mio, mii = sch[out].split(mi, factor=lanes)
+    nio, nii = sch[out].split(ni, factor=lanes)
+    outer = [axis for i, axis in enumerate(op_axes) if i not in (inner, ndim - 1)]
+    sch[out].reorder(*outer, mo, no, mio, nio, mii, nii)
+    sch[out].parallel(sch[out].fuse(*outer, mo, no))
+    sch[out].unroll(mii)
+    sch[out].vectorize(nii)
+    return sch
+
+
+def schedule_transpose(outs, axes=None):
+    """Schedule of an unfused transpose on x86
+
+    Parameters
+    ----------
+    outs: Array of Tensor
+        The transpose, or a layout_transform permuting the axes.
+
+    axes: list of int, optional
+        The input axis of each output axis, reversed by default as in a 2D transpose.
+
+    Returns
+    -------
+    sch: Schedule
+        The computation schedule for the op.
+    """
+    outs = [outs] if isinstance(outs, te.tensor.Tensor) else outs
+    s = te.create_schedule([x.op for x in outs])
+    schedule_transpose_from_existing(s, outs[0], axes)
+    return s
@@ -15,12 +15,56 @@
 # specific language governing permissions and limitations
 # under the License.
 """Common x86 related utilities"""
+import ctypes
+import platform
+
 import tvm
 
 
+def target_has_avx512(mcpu):
+    """Whether the mcpu has AVX-512 with the BW extension."""
+    return mcpu in (
+        "skylake-avx512",
+        "cascadelake",
+        "cooperlake",
+        "icelake-client",
+        "icelake-server",
+        "tigerlake",
+        "sapphirerapids",
+    )
+
+
+def target_has_vnni(mcpu):
+    """Whether the mcpu has the AVX-512 VNNI instructions, e.g. vpdpbusd."""
+    return target_has_avx512(mcpu) and mcpu != "skylake-avx512"
+
+
+def target_has_amx(mcpu):
+    """Whether the mcpu has the AMX tile and int8 instructions."""
+    return mcpu == "sapphirerapids"
+
+
+def amx_init():
+    """Ask Linux for the permission to use the AMX tile data state in this process.
+
+    Since Linux 5.16, a process must request the permission before its first AMX
+    instruction, or it is killed by SIGILL.
+
+    Returns
+    -------
+    success : bool
+        Whether AMX can be used by this process.
+    """
+    if platform.system() != "Linux" or platform.machine() != "x86_64":
+        return False
+    sys_arch_prctl, arch_req_xcomp_perm, xfeature_xtiledata = 158, 0x1023, 18
+    libc = ctypes.CDLL(None, use_errno=True)
+    return libc.syscall(sys_arch_prctl, arch_req_xcomp_perm, xfeature_xtiledata) == 0
+
+
 def get_fp32_len():
     mcpu = tvm.target.Target.current().mcpu
     fp32_vec_len = 8
-    if mcpu in ("skylake-avx512", "cascadelake"):
+    if target_has_avx512(mcpu):
         fp32_vec_len = 16
     return fp32_vec_len
@@ -130,6 +130,9 @@ impl<'d, 's, T> From<&'d [T]> for Storage<'s> {
 /// `Tensor` is primarily a holder of data which can be operated on via TVM (via `DLTensor`) or
 /// converted to `ndarray::Array` for non-TVM processing.
 ///
+/// The conversions from a borrowed `ndarray::Array` or a `DLTensor`, as well as `as_array_view`,
+/// view the data without copy.
+///
 /// # Examples
 ///
 /// ```
@@ -239,6 +242,54 @@ impl<'a> Tensor<'a> {
         }
     }
 
+    /// Returns a `Tensor` viewing the data of this `Tensor`, without copy.
+    pub fn view(&self) -> Tensor<'_> {
+        Tensor {
+            data: Storage::View(
+                unsafe { slice::from_raw_parts_mut(self.data.as_mut_ptr(), self.data.size()) },
+                self.data.align(),
+            ),
+            device: self.device,
+            dtype: self.dtype,
+            size: self.size,
+            shape: self.shape.clone(),
+            strides: self.strides.clone(),
+            byte_offset: self.byte_offset,
+        }
+    }
+
+    /// Returns an `ndarray` view of the data of this `Tensor`, without copy.
+    pub fn as_array_view<T: 'static>(&self) -> Result<ndarray::ArrayViewD<'_, T>, ArrayError> {
+        let shape = self.array_shape::<T>()?;
+        unsafe {
+            let data = self.data.as_ptr().offset(self.byte_offset) as *const T;
+            Ok(ndarray::ArrayView::from_shape_ptr(shape, data))
+        }
+    }
+
+    /// Returns a mutable `ndarray` view of the data of this `Tensor`, without copy.
+    pub fn as_array_view_mut<T: 'static>(
+        &mut self,
+    ) -> Result<ndarray::ArrayViewMutD<'_, T>, ArrayError> {
+        let shape = self.array_shape::<T>()?;
+        unsafe {
+            let data = self.data.as_mut_ptr().offset(self.byte_offset) as *mut T;
+            Ok(ndarray::ArrayViewMut::from_shape_ptr(shape, data))
+        }
+    }
+
+    /// Returns the shape of this `Tensor` viewed as an `ndarray` of `T`.
+    fn array_shape<T: 'static>(&self) -> Result<ndarray::IxDyn, ArrayError> {
+        if !self.dtype.is_type::<T>() {
+            return Err(ArrayError::IncompatibleDataType(self.dtype));
+        }
+        if !self.is_contiguous() {
+            return Err(ArrayError::NotContiguous);
+        }
+        let shape: Vec<usize> = self.shape.iter().map(|&v| v as usize).collect();
+        Ok(ndarray::IxDyn(&shape))
+    }
+
     /// Returns an owned version of this `Tensor` via cloning.
     pub fn to_owned(&self) -> Tensor<'static> {
         let t = Tensor {
@@ -390,6 +441,11 @@ macro_rules! impl_tensor_from_ndarray {
                 Tensor::from_array_storage(arr, storage, $dtype_fn)
             }
         }
+        impl<'a, D: ndarray::Dimension> From<&'a mut ndarray::Array<$type, D>> for Tensor<'a> {
+            fn from(arr: &'a mut ndarray::Array<$type, D>) -> Self {
+                Tensor::from(&*arr)
+            }
+        }
     };
 }
 
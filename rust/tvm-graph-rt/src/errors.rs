@@ -52,4 +52,18 @@ pub enum ArrayError {
     IncompatibleDataType(DataType),
     #[error("Shape error when casting ndarray to TVM Array with shape {0:?}")]
     ShapeError(Vec<i64>),
+    #[error("Cannot view a non-contiguous Tensor as ndarray")]
+    NotContiguous,
+}
+
+#[derive(Debug, Error)]
+pub enum BindError {
+    #[error("Graph has no {0}")]
+    NotFound(String),
+    #[error("Cannot bind {0}: the tensor has shape {1:?} and dtype {2}, expected {3:?} and {4}")]
+    Mismatch(String, Vec<i64>, DataType, Vec<i64>, DataType),
+    #[error("Cannot bind {0}: the tensor is not contiguous")]
+    NotContiguous(String),
+    #[error("Cannot bind {0}: its storage is shared with other entries")]
+    SharedStorage(String),
 }
@@ -18,7 +18,13 @@
  */
 
 use std::{
-    cmp, collections::HashMap, convert::TryFrom, error::Error, iter::FromIterator, mem, str,
+    cmp,
+    collections::HashMap,
+    convert::TryFrom,
+    error::Error,
+    iter::FromIterator,
+    mem, str,
+    sync::{Condvar, Mutex},
 };
 
 use itertools::izip;
@@ -33,7 +39,7 @@ use serde_json;
 
 use tvm_sys::ffi::{DLDataTypeCode_kDLFloat, DLDataTypeCode_kDLInt, DLDataTypeCode_kDLUInt};
 
-use tvm_sys::{ffi::DLTensor, ArgValue, DataType, Device, DeviceType};
+use tvm_sys::{ffi::DLTensor, packed_func::PackedFunc, ArgValue, DataType, Device, DeviceType};
 
 use crate::{errors::*, Module, Storage, Tensor};
 
@@ -52,7 +58,7 @@ const _NDARRAY_LIST_MAGIC: u64 = 0xF7E5_8D4F_0504_9CB7;
 /// let graph_json = std::fs::read_to_string("graph.json").unwrap();
 /// let graph = Graph::try_from(&graph_json).unwrap();
 /// ```
-#[derive(Serialize, Deserialize, Debug)]
+#[derive(Serialize, Deserialize, Debug, Clone)]
 pub struct Graph {
     pub nodes: Vec<Node>,
     pub arg_nodes: Vec<usize>,
@@ -61,7 +67,7 @@ pub struct Graph {
     pub attrs: Option<HashMap<String, serde_json::Value>>,
 }
 
-#[derive(Serialize, Deserialize, Debug)]
+#[derive(Serialize, Deserialize, Debug, Clone)]
 pub struct Entry {
     pub id: usize,
     pub index: usize,
@@ -92,7 +98,7 @@ impl Graph {
     }
 }
 
-#[derive(Serialize, Deserialize, Debug)]
+#[derive(Serialize, Deserialize, Debug, Clone)]
 pub struct Node {
     pub op: String,
     pub name: String,
@@ -182,27 +188,198 @@ impl<'a> TryFrom<&'a str> for Graph {
 /// ```
 pub struct GraphExecutor<'m, 't> {
     graph: Graph,
-    op_execs: Vec<Box<dyn Fn() + 'm>>,
+    op_execs: Vec<OpExec<'m>>,
     tensors: Vec<Tensor<'t>>,
+    /// The storage id of each entry.
+    storage_ids: Vec<usize>,
+    /// The maximum number of operators run concurrently, 1 for sequential execution.
+    inter_op_parallelism: usize,
 }
 
 unsafe impl<'m, 't> Send for GraphExecutor<'m, 't> {}
 
+/// The call of an operator on the tensors of its entries.
+struct OpExec<'m> {
+    func_name: String,
+    func: &'m dyn PackedFunc,
+    flatten_data: bool,
+    /// The arguments, pointing into the tensors of `entries`.
+    args: Vec<DLTensor>,
+    /// The entry of each argument, the inputs followed by the outputs.
+    entries: Vec<usize>,
+    /// The number of input arguments.
+    num_inputs: usize,
+}
+
+// The operators run concurrently only write disjoint tensors, see `GraphExecutor::op_deps`.
+unsafe impl<'m> Sync for OpExec<'m> {}
+
+impl<'m> OpExec<'m> {
+    fn call(&self) -> Result<(), String> {
+        let args: Vec<ArgValue> = self.args.iter().map(|t| t.into()).collect();
+        (self.func)(&args)
+            .map(|_| ())
+            .map_err(|_| format!("Function {} failed to execute", self.func_name))
+    }
+}
+
 impl<'m, 't> GraphExecutor<'m, 't> {
     pub fn new<M: 'm + Module>(graph: Graph, lib: &'m M) -> Result<Self, Box<dyn Error>> {
         let tensors = Self::setup_storages(&graph)?;
         Ok(GraphExecutor {
             op_execs: Self::setup_op_execs(&graph, lib, &tensors)?,
+            storage_ids: graph.get_attr::<(String, Vec<usize>)>("storage_id")?.1,
             tensors,
             graph,
+            inter_op_parallelism: 1,
         })
     }
 
+    /// Creates executors of a graph which share the parameters, each of them only owns the
+    /// storage of its activations. Different executors can be run from different threads at the
+    /// same time, a single executor cannot.
+    ///
+    /// The parameters are bound without copy, see `set_input_zero_copy`, and must outlive the
+    /// executors.
+    pub fn new_pool<M: 'm + Module>(
+        graph: &Graph,
+        lib: &'m M,
+        params: &'t HashMap<String, Tensor>,
+        num_executors: usize,
+    ) -> Result<Vec<Self>, Box<dyn Error>> {
+        (0..num_executors)
+            .map(|_| {
+                let mut exec = Self::new(graph.clone(), lib)?;
+                for (name, param) in params {
+                    exec.set_input_zero_copy(name, param.view())?;
+                }
+                Ok(exec)
+            })
+            .collect()
+    }
+
+    /// Sets the maximum number of operators run concurrently, 1 for sequential execution.
+    ///
+    /// The operators run in dataflow order on scoped threads. The kernels of the operators run
+    /// concurrently share the parallel thread pool of the runtime: the parallel loops of the
+    /// kernel launched while the pool is busy run in the caller.
+    pub fn set_inter_op_parallelism(&mut self, level: usize) {
+        self.inter_op_parallelism = cmp::max(level, 1);
+    }
+
     /// Runs the computation graph.
+    ///
+    /// # Panics
+    ///
+    /// Panics if an operator fails.
     pub fn run(&mut self) {
-        self.op_execs.iter().for_each(|op_exec| {
-            op_exec();
+        if self.inter_op_parallelism > 1 && self.op_execs.len() > 1 {
+            if let Err(error) = self.run_dataflow() {
+                panic!("{}", error);
+            }
+        } else {
+            self.op_execs.iter().for_each(|op_exec| {
+                op_exec.call().unwrap_or_else(|error| panic!("{}", error));
+            });
+        }
+    }
+
+    /// Returns the operators each operator waits for: the producers of its inputs and, for
+    /// storage shared with earlier entries, their last writer and readers.
+    fn op_deps(&self) -> Vec<Vec<usize>> {
+        let num_storages = self.storage_ids.iter().max().map_or(0, |sid| sid + 1);
+        let mut last_writer: Vec<Option<usize>> = vec![None; num_storages];
+        let mut readers: Vec<Vec<usize>> = vec![Vec::new(); num_storages];
+        let mut deps: Vec<Vec<usize>> = vec![Vec::new(); self.op_execs.len()];
+        for (i, op) in self.op_execs.iter().enumerate() {
+            let (inputs, outputs) = op.entries.split_at(op.num_inputs);
+            for &entry in inputs {
+                let sid = self.storage_ids[entry];
+                deps[i].extend(last_writer[sid]);
+                readers[sid].push(i);
+            }
+            for &entry in outputs {
+                let sid = self.storage_ids[entry];
+                deps[i].extend(last_writer[sid]);
+                deps[i].extend(readers[sid].drain(..));
+                last_writer[sid] = Some(i);
+            }
+            deps[i].retain(|&dep| dep != i);
+            deps[i].sort_unstable();
+            deps[i].dedup();
+        }
+        deps
+    }
+
+    /// Runs the operators in dataflow order on `inter_op_parallelism` threads.
+    fn run_dataflow(&self) -> Result<(), String> {
+        struct State {
+            ready: Vec<usize>,
+            num_deps: Vec<usize>,
+            num_done: usize,
+            error: Option<String>,
+        }
+
+        let deps = self.op_deps();
+        let mut successors = vec![Vec::new(); deps.len()];
+        for (i, op_deps) in deps.iter().enumerate() {
+            for &dep in op_deps {
+                successors[dep].push(i);
+            }
+        }
+        let num_ops = self.op_execs.len();
+        let state = Mutex::new(State {
+            ready: (0..num_ops).filter(|&i| deps[i].is_empty()).rev().collect(),
+            num_deps: deps.iter().map(Vec::len).collect(),
+            num_done: 0,
+            error: None,
         });
+        let cond = Condvar::new();
+        let op_execs = &self.op_execs;
+
+        let worker = || {
+            let mut state_guard = state.lock().unwrap();
+            loop {
+                while state_guard.ready.is_empty()
+                    && state_guard.num_done < num_ops
+                    && state_guard.error.is_none()
+                {
+                    state_guard = cond.wait(state_guard).unwrap();
+                }
+                if state_guard.num_done == num_ops || state_guard.error.is_some() {
+                    return;
+                }
+                let op = state_guard.ready.pop().unwrap();
+                drop(state_guard);
+                let result = op_execs[op].call();
+                state_guard = state.lock().unwrap();
+                state_guard.num_done += 1;
+                if let Err(error) = result {
+                    state_guard.error = Some(error);
+                }
+                for &succ in &successors[op] {
+                    state_guard.num_deps[succ] -= 1;
+                    if state_guard.num_deps[succ] == 0 {
+                        state_guard.ready.push(succ);
+                    }
+                }
+                cond.notify_all();
+            }
+        };
+
+        let num_threads = cmp::min(self.inter_op_parallelism, num_ops);
+        crossbeam_utils::thread::scope(|scope| {
+            for _ in 1..num_threads {
+                scope.spawn(|_| worker());
+            }
+            worker();
+        })
+        .expect("inter-op worker panicked");
+
+        match state.into_inner().unwrap().error {
+            Some(error) => Err(error),
+            None => Ok(()),
+        }
     }
 
     /// Allocates `Storages` for each `storage_id` and returns `Tensor`s to hold each output.
@@ -253,12 +430,12 @@ impl<'m, 't> GraphExecutor<'m, 't> {
         Ok(tensors)
     }
 
-    /// Creates closures which represent the computation performed by this graph.
+    /// Creates the operator calls which represent the computation performed by this graph.
     fn setup_op_execs<M: 'm + Module>(
         graph: &Graph,
         lib: &'m M,
         tensors: &[Tensor<'t>],
-    ) -> Result<Vec<Box<dyn Fn() + 'm>>, Box<dyn Error + 'static>> {
+    ) -> Result<Vec<OpExec<'m>>, Box<dyn Error + 'static>> {
         if !graph.node_row_ptr.is_some() {
             return Err(GraphFormatError::MissingField("node_row_ptr").into());
         }
@@ -285,32 +462,25 @@ impl<'m, 't> GraphExecutor<'m, 't> {
             let func = lib
                 .get_function(&attrs.func_name)
                 .ok_or_else(|| FunctionNotFound(attrs.func_name.clone()))?;
-            let arg_indices = node
+            let entries = node
                 .inputs
                 .iter()
                 .map(|entry| graph.entry_index(entry))
-                .chain((0..attrs.num_outputs).map(|oi| Ok(node_row_ptr[i] + oi)));
-
-            let dl_tensors: Vec<DLTensor> = arg_indices
-                .map(|idx| {
-                    let tensor = &tensors[idx?];
-                    Ok(if attrs.flatten_data {
-                        Tensor::as_dltensor(tensor, true /* flatten */)
-                    } else {
-                        DLTensor::from(tensor)
-                    })
-                })
-                .collect::<Result<Vec<DLTensor>, GraphFormatError>>()?
-                .into();
-            let op: Box<dyn Fn()> = Box::new(move || {
-                let args: Vec<ArgValue> = dl_tensors
-                    .iter()
-                    .map(|t| t.into())
-                    .collect::<Vec<ArgValue>>();
-                let err_str = format!("Function {} failed to execute", attrs.func_name);
-                func(&args).expect(&err_str);
+                .chain((0..attrs.num_outputs).map(|oi| Ok(node_row_ptr[i] + oi)))
+                .collect::<Result<Vec<usize>, GraphFormatError>>()?;
+
+            let args: Vec<DLTensor> = entries
+                .iter()
+                .map(|&idx| Tensor::as_dltensor(&tensors[idx], attrs.flatten_data))
+                .collect();
+            op_execs.push(OpExec {
+                func_name: attrs.func_name,
+                func,
+                flatten_data: attrs.flatten_data,
+                args,
+                entries,
+                num_inputs: node.inputs.len(),
             });
-            op_execs.push(op);
         }
         Ok(op_execs)
     }
@@ -344,6 +514,75 @@ impl<'m, 't> GraphExecutor<'m, 't> {
         }
     }
 
+    /// Sets the input `name` to a tensor without copy, e.g. a view of an `ndarray::Array` or of a
+    /// `DLTensor`, which the operators then read in place until the input is set again.
+    pub fn set_input_zero_copy<S: AsRef<str>>(
+        &mut self,
+        name: S,
+        value: Tensor<'t>,
+    ) -> Result<(), BindError> {
+        let idx = self.get_input_index(name.as_ref());
+        let name = format!("input `{}`", name.as_ref());
+        let idx = idx.ok_or_else(|| BindError::NotFound(name.clone()))?;
+        self.bind_entry(&name, idx, value)
+    }
+
+    /// Sets the output `index` to a tensor without copy, which the operators then write in
+    /// place until the output is set again.
+    pub fn set_output_zero_copy(
+        &mut self,
+        index: usize,
+        value: Tensor<'t>,
+    ) -> Result<(), BindError> {
+        let name = format!("output {}", index);
+        let idx = self
+            .graph
+            .heads
+            .get(index)
+            .and_then(|entry| self.graph.entry_index(entry).ok())
+            .ok_or_else(|| BindError::NotFound(name.clone()))?;
+        self.bind_entry(&name, idx, value)
+    }
+
+    /// Replaces the tensor of an entry, pointing the arguments of the operators to it.
+    fn bind_entry(&mut self, name: &str, idx: usize, value: Tensor<'t>) -> Result<(), BindError> {
+        let current = &self.tensors[idx];
+        if value.dtype != current.dtype || value.shape != current.shape {
+            return Err(BindError::Mismatch(
+                name.to_string(),
+                value.shape.clone(),
+                value.dtype,
+                current.shape.clone(),
+                current.dtype,
+            ));
+        }
+        if !value.is_contiguous() {
+            return Err(BindError::NotContiguous(name.to_string()));
+        }
+        // The other entries of the storage, e.g. the reshapes run as "__nop", would keep
+        // pointing to the storage replaced.
+        let sid = self.storage_ids[idx];
+        if self
+            .storage_ids
+            .iter()
+            .filter(|&&other| other == sid)
+            .count()
+            > 1
+        {
+            return Err(BindError::SharedStorage(name.to_string()));
+        }
+        self.tensors[idx] = value;
+        let tensor = &self.tensors[idx];
+        for op in self.op_execs.iter_mut() {
+            for (arg, &entry) in op.args.iter_mut().zip(&op.entries) {
+                if entry == idx {
+                    *arg = tensor.as_dltensor(op.flatten_data);
+                }
+            }
+        }
+        Ok(())
+    }
+
     /// Returns the graph input with name `name`, if it exists.
     pub fn get_input<S: AsRef<str>>(&mut self, name: S) -> Option<&Tensor> {
         self.get_input_index(name.as_ref())
@@ -21,7 +21,7 @@ use std::{
     os::raw::{c_int, c_void},
     sync::{
         atomic::{AtomicUsize, Ordering},
-        Arc, Barrier,
+        Arc, Barrier, Mutex,
     },
     thread::{self, JoinHandle},
 };
@@ -30,6 +30,7 @@ use std::{
 use std::env;
 
 use crossbeam_channel::{bounded, Receiver, Sender};
+use lazy_static::lazy_static;
 use tvm_sys::ffi::TVMParallelGroupEnv;
 
 pub(crate) type FTVMParallelLambda =
@@ -125,7 +126,12 @@ struct ThreadPool {
     threads: Threads,
 }
 
-thread_local!(static THREAD_POOL: ThreadPool = ThreadPool::new());
+lazy_static! {
+    /// The pool shared by the threads of the process, e.g. the inter-op workers of
+    /// `GraphExecutor` and the executors run concurrently, so that their parallel loops do not
+    /// each start a thread per core. A launch while the pool runs another job runs in the caller.
+    static ref THREAD_POOL: Mutex<ThreadPool> = Mutex::new(ThreadPool::new());
+}
 
 impl ThreadPool {
     fn new() -> Self {
@@ -184,21 +190,26 @@ pub extern "C" fn TVMBackendParallelLaunch(
     cdata: *const c_void,
     num_task: usize,
 ) -> c_int {
-    if max_concurrency() < 2 {
-        let penv = TVMParallelGroupEnv {
-            sync_handle: std::ptr::null_mut(),
-            num_task: 1,
-        };
-        cb(0, &penv as *const _, cdata);
+    let pool = if max_concurrency() < 2 {
+        None
     } else {
-        THREAD_POOL.with(|pool| {
-            pool.launch(Job {
-                cb,
-                cdata,
-                req_num_tasks: num_task,
-                pending: Arc::new(AtomicUsize::new(0)),
-            });
-        });
+        // The tasks of two jobs interleaved on the workers could wait for each other's barrier.
+        THREAD_POOL.try_lock().ok()
+    };
+    match pool {
+        Some(pool) => pool.launch(Job {
+            cb,
+            cdata,
+            req_num_tasks: num_task,
+            pending: Arc::new(AtomicUsize::new(0)),
+        }),
+        None => {
+            let penv = TVMParallelGroupEnv {
+                sync_handle: std::ptr::null_mut(),
+                num_task: 1,
+            };
+            cb(0, &penv as *const _, cdata);
+        }
     }
     0
 }
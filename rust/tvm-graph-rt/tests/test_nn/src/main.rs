@@ -59,7 +59,7 @@ fn main() {
         &fs::read_to_string(concat!(env!("OUT_DIR"), "/test_nn/graph.json")).unwrap(),
     )
     .unwrap();
-    let mut exec = GraphExecutor::new(graph, &syslib).unwrap();
+    let mut exec = GraphExecutor::new(graph.clone(), &syslib).unwrap();
 
     let x = Array::from_shape_vec(
         (BATCH_SIZE, IN_DIM),
@@ -96,4 +96,28 @@ fn main() {
     check_sum!(exec, 0, expected_o0);
     check_sum!(exec, 1, expected_o1);
     check_sum!(exec, 2, dense);
+
+    // The executors of a pool share the parameters, and read and write the ndarrays in place.
+    let pool_params = tvm_graph_rt::load_param_dict(&params_bytes).unwrap();
+    let mut o0 = Array::<f32, _>::zeros((BATCH_SIZE, IN_DIM));
+    {
+        let mut pool = GraphExecutor::new_pool(&graph, &syslib, &pool_params, 2).unwrap();
+        pool[0].set_output_zero_copy(0, (&mut o0).into()).unwrap();
+        pool[1].set_inter_op_parallelism(2);
+        for exec in pool.iter_mut() {
+            exec.set_input_zero_copy("data", (&x).into()).unwrap();
+            exec.run();
+            check_sum!(exec, 0, expected_o0);
+            check_sum!(exec, 1, expected_o1);
+            check_sum!(exec, 2, dense);
+        }
+        let o1 = pool[1]
+            .get_output(1)
+            .unwrap()
+            .as_array_view::<f32>()
+            .unwrap();
+        check_sum!(o1, expected_o1);
+        assert!(pool[1].set_input_zero_copy("data", (&w).into()).is_err());
+    }
+    check_sum!(o0, expected_o0);
 }
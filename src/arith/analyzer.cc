@@ -52,6 +52,9 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
     this->Bind(var, range->min, allow_override);
   } else {
     this->const_int_bound.Bind(var, range, allow_override);
+    // the simplifications depend on the bounds of the vars.
+    this->rewrite_simplify.ClearCache();
+    this->canonical_simplify.ClearCache();
   }
   // skip modular_set
   // skip rewrite simplify
@@ -69,8 +72,10 @@ void ConstraintContext::EnterWithScope() {
   auto f0 = analyzer_->const_int_bound.EnterConstraint(constraint_);
   auto f1 = analyzer_->modular_set.EnterConstraint(constraint_);
   auto f2 = analyzer_->rewrite_simplify.EnterConstraint(constraint_);
+  auto f3 = analyzer_->canonical_simplify.EnterCacheScope();
   // recovery function.
-  exit_ = [f0, f1, f2]() {
+  exit_ = [f0, f1, f2, f3]() {
+    if (f3 != nullptr) f3();
     if (f2 != nullptr) f2();
     if (f1 != nullptr) f1();
     if (f0 != nullptr) f0();
@@ -1233,13 +1233,26 @@ PrimExpr CanonicalSimplifier::Impl::VisitExpr_(const CastNode* op) {
 }
 
 PrimExpr CanonicalSimplifier::operator()(const PrimExpr& expr) {
-  return impl_->CanonicalSimplify(expr);
+  if (expr->IsInstance<IntImmNode>() || expr->IsInstance<FloatImmNode>()) return expr;
+  bool use_cache = impl_->AtTopLevel();
+  PrimExpr res;
+  if (use_cache && impl_->LookupCache(expr, &res)) {
+    return res.defined() ? res : expr;
+  }
+  size_t epoch = impl_->cache_epoch();
+  res = impl_->CanonicalSimplify(expr);
+  if (use_cache) impl_->InsertCache(expr, res.same_as(expr) ? PrimExpr() : res, epoch);
+  return res;
 }
 
 void CanonicalSimplifier::Update(const Var& var, const PrimExpr& info, bool override) {
   impl_->Update(var, info, override);
 }
 
+std::function<void()> CanonicalSimplifier::EnterCacheScope() { return impl_->EnterCacheScope(); }
+
+void CanonicalSimplifier::ClearCache() { impl_->ClearCache(); }
+
 CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 CanonicalSimplifier::~CanonicalSimplifier() { delete impl_; }
@@ -115,6 +115,39 @@ void RewriteSimplifier::Impl::Update(const Var& var, const PrimExpr& info, bool
     }
   }
   var_map_[var] = info;
+  ClearCache();
+}
+
+bool RewriteSimplifier::Impl::LookupCache(const PrimExpr& expr, PrimExpr* result) {
+  const SimplifyCache& cache = caches_.back();
+  auto it = cache.find(expr);
+  if (it == cache.end()) return false;
+  *result = it->second;
+  return true;
+}
+
+void RewriteSimplifier::Impl::InsertCache(const PrimExpr& expr, const PrimExpr& result,
+                                          size_t epoch) {
+  if (epoch != cache_epoch_) return;
+  SimplifyCache& cache = caches_.back();
+  if (cache.size() >= kMaxCacheSize) cache.clear();
+  cache[expr] = result;
+}
+
+void RewriteSimplifier::Impl::ClearCache() {
+  for (SimplifyCache& cache : caches_) {
+    cache.clear();
+  }
+  ++cache_epoch_;
+}
+
+std::function<void()> RewriteSimplifier::Impl::EnterCacheScope() {
+  caches_.emplace_back();
+  size_t num_scopes = caches_.size();
+  return [num_scopes, this]() {
+    ICHECK_EQ(caches_.size(), num_scopes);
+    caches_.pop_back();
+  };
 }
 
 PrimExpr RewriteSimplifier::Impl::VisitExpr_(const AddNode* op) {
@@ -221,7 +254,9 @@ std::function<void()> RewriteSimplifier::Impl::EnterConstraint(const PrimExpr& c
   // so simplify the constarint as well
   literal_constraints_.push_back(operator()(constraint));
   size_t new_literal_size = literal_constraints_.size();
-  auto frecover = [old_literal_size, new_literal_size, this]() {
+  auto fexit_cache = EnterCacheScope();
+  auto frecover = [old_literal_size, new_literal_size, fexit_cache, this]() {
+    fexit_cache();
     ICHECK_EQ(literal_constraints_.size(), new_literal_size);
     literal_constraints_.resize(old_literal_size);
   };
@@ -1595,14 +1630,24 @@ PrimExpr RewriteSimplifier::Impl::VisitExpr_(const LetNode* op) {
 }
 
 PrimExpr RewriteSimplifier::operator()(const PrimExpr& expr) {
+  // the constants are their own simplification.
+  if (expr->IsInstance<IntImmNode>() || expr->IsInstance<FloatImmNode>()) return expr;
+  // the nested simplifications of a recursive rewrite depend on its depth, they are not cached.
+  bool use_cache = impl_->AtTopLevel();
+  PrimExpr res;
+  if (use_cache && impl_->LookupCache(expr, &res)) {
+    return res.defined() ? res : expr;
+  }
+  size_t epoch = impl_->cache_epoch();
   // Run simplification in post order
-  PrimExpr res = expr;
+  res = expr;
   int max_iter = 2;
   for (int i = 0; i < max_iter; ++i) {
     PrimExpr new_expr = impl_->operator()(res);
-    if (new_expr.same_as(res)) return res;
+    if (new_expr.same_as(res)) break;
     res = new_expr;
   }
+  if (use_cache) impl_->InsertCache(expr, res.same_as(expr) ? PrimExpr() : res, epoch);
   return res;
 }
 
@@ -1614,6 +1659,8 @@ std::function<void()> RewriteSimplifier::EnterConstraint(const PrimExpr& constra
   return impl_->EnterConstraint(constraint);
 }
 
+void RewriteSimplifier::ClearCache() { impl_->ClearCache(); }
+
 RewriteSimplifier::RewriteSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
 
 RewriteSimplifier::~RewriteSimplifier() { delete impl_; }
@@ -25,6 +25,8 @@
 #define TVM_ARITH_REWRITE_SIMPLIFY_H_
 
 #include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/tir/op.h>
 
 #include <unordered_map>
@@ -77,6 +79,33 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
 
   std::function<void()> EnterConstraint(const PrimExpr& constraint);
 
+  /*!
+   * \brief Look up the result of a top level simplification of expr.
+   * \param expr The expression to be simplified.
+   * \param result The cached result, undefined when expr is its own simplification.
+   * \return Whether expr was in the cache.
+   */
+  bool LookupCache(const PrimExpr& expr, PrimExpr* result);
+  /*!
+   * \brief Cache the result of a top level simplification of expr.
+   * \param expr The simplified expression.
+   * \param result The result.
+   * \param epoch The cache epoch when the simplification started, nothing is cached if the
+   *  bindings changed since.
+   */
+  void InsertCache(const PrimExpr& expr, const PrimExpr& result, size_t epoch);
+  /*! \brief Drop the cached results, on a change of the bindings. */
+  void ClearCache();
+  /*!
+   * \brief Enter a constraint scope of the cache.
+   * \return The function exiting the scope.
+   */
+  std::function<void()> EnterCacheScope();
+  /*! \return The epoch of the cache, increased on each ClearCache. */
+  size_t cache_epoch() const { return cache_epoch_; }
+  /*! \return Whether the simplification is at the top level, where its result is cached. */
+  bool AtTopLevel() const { return recur_depth_ == 0; }
+
  protected:
   /*! \brief internal structure for comparison. */
   enum CompareResult { kUnknown, kEQ, kGT, kGE, kLT, kLE, kNE };
@@ -87,6 +116,16 @@ class RewriteSimplifier::Impl : public IRMutatorWithAnalyzer {
 
   std::vector<PrimExpr> literal_constraints_;
 
+  // The results of the top level simplifications, one map per constraint scope. The results of
+  // an outer scope may be less simplified than what the constraint allows, only the innermost
+  // scope is looked up; the outer ones are kept for when the inner scopes exit.
+  using SimplifyCache = std::unordered_map<PrimExpr, PrimExpr, StructuralHash, StructuralEqual>;
+  std::vector<SimplifyCache> caches_{1};
+  // increased each time the cache is cleared.
+  size_t cache_epoch_{0};
+  // maximum number of results cached per scope.
+  static const constexpr size_t kMaxCacheSize = 8192;
+
   // maximum number of recursion allowed during a single pass.
   static const constexpr int kMaxRecurDepth = 5;
 
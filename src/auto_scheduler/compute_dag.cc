@@ -37,7 +37,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <mutex>
 #include <queue>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -697,6 +700,7 @@ ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
 
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->infer_bound_cache = std::make_shared<InferBoundCache>();
   data_ = std::move(node);
 }
 
@@ -724,6 +728,7 @@ ComputeDAG::ComputeDAG(const te::Schedule& sch) {
   node->access_analyzer = AccessAnalyzer(node->tensors);
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->infer_bound_cache = std::make_shared<InferBoundCache>();
   data_ = std::move(node);
 }
 
@@ -896,6 +901,8 @@ ComputeDAG ComputeDAG::RewriteLayout(Array<Step>* transform_steps,
       << "Call ComputeDAG::RewriteLayout with NoRewrite.";
   ComputeDAG new_dag = *this;
   ComputeDAGNode* p_dag = new_dag.CopyOnWrite();
+  // The rewritten DAG has different ops, so it does not share the bounds of this DAG
+  p_dag->infer_bound_cache = std::make_shared<InferBoundCache>();
 
   auto node = make_object<StateNode>();
   node->transform_steps = *transform_steps;
@@ -1299,6 +1306,55 @@ String ComputeDAG::PrintDAG(bool simple_mode) const {
   return String(ss.str());
 }
 
+/*!
+ * \brief The iterators with bound information of the stages of the states whose bound is
+ * inferred on a ComputeDAG. The bound of a stage depends on the stages consuming it, so the
+ * stages of a state are cached together, keyed by the transform steps of the state. Only the
+ * iterators are cached, since the ops of the stages are created again when a state is replayed.
+ */
+class InferBoundCache {
+ public:
+  /*! \brief The maximum number of the states cached. The cache is cleared when it is full. */
+  static constexpr size_t kMaxSize = 4096;
+
+  bool Lookup(const std::string& key, Array<Array<Iterator>>* stage_iters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+    *stage_iters = it->second;
+    return true;
+  }
+
+  void Insert(const std::string& key, Array<Array<Iterator>> stage_iters) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (map_.size() >= kMaxSize) {
+      map_.clear();
+    }
+    map_[key] = std::move(stage_iters);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, Array<Array<Iterator>>> map_;
+};
+
+/*! \brief Get the key of the transform steps in the InferBoundCache */
+std::string InferBoundCacheKey(const Array<Step>& transform_steps) {
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.BeginArray(false);
+  for (const auto& step : transform_steps) {
+    writer.WriteArraySeperator();
+    writer.BeginArray(false);
+    step->WriteToRecord(&writer);
+    writer.EndArray();
+  }
+  writer.EndArray();
+  return os.str();
+}
+
 State ComputeDAG::InferBound(const State& state) const {
   ICHECK(state->concrete) << "Only concrete state can be processed to get bound info.";
 
@@ -1319,6 +1375,22 @@ State ComputeDAG::InferBound(const State& state) const {
     pstate = ret_state.CopyOnWrite();
   }
 
+  InferBoundCache* cache = operator->()->infer_bound_cache.get();
+  std::string cache_key;
+  if (cache != nullptr) {
+    cache_key = InferBoundCacheKey(pstate->transform_steps);
+    Array<Array<Iterator>> stage_iters;
+    if (cache->Lookup(cache_key, &stage_iters)) {
+      ICHECK_EQ(stage_iters.size(), pstate->stages.size());
+      for (size_t i = 0; i < pstate->stages.size(); ++i) {
+        const Stage& stage = pstate->stages[i];
+        pstate->stages.Set(i, Stage(stage->op, stage->op_type, stage_iters[i], stage->compute_at,
+                                    stage->attrs));
+      }
+      return ret_state;
+    }
+  }
+
   Array<te::Stage> stages;
   StageToAxesMap stage_to_axes;
   te::Schedule sch;
@@ -1358,6 +1430,14 @@ State ComputeDAG::InferBound(const State& state) const {
         i, Stage(stage->op, stage->op_type, new_iters, stage->compute_at, stage->attrs));
   }
 
+  if (cache != nullptr) {
+    Array<Array<Iterator>> stage_iters;
+    stage_iters.reserve(pstate->stages.size());
+    for (const Stage& stage : pstate->stages) {
+      stage_iters.push_back(stage->iters);
+    }
+    cache->Insert(cache_key, std::move(stage_iters));
+  }
   return ret_state;
 }
 
@@ -1500,6 +1580,11 @@ TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGInferBoundFromState")
       return dag.InferBound(state);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGInferBoundFromStates")
+    .set_body_typed([](const ComputeDAG& dag, const Array<State>& states) {
+      return dag.InferBound(states);
+    });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGRewriteLayoutFromState")
     .set_body_typed([](const ComputeDAG& dag, const State& state) {
       Array<Step>* transform_steps = const_cast<Array<Step>*>(&state->transform_steps);
@@ -37,7 +37,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <list>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -1262,8 +1266,133 @@ void GetPerStoreFeatureName(int max_n_bufs, std::vector<std::string>* ret) {
   // section total : 3
 }
 
+/*!
+ * \brief The cache of the extracted features, shared by all the tasks.
+ *
+ * The search policies evaluate the same states again and again, e.g. the survivors of the
+ * evolutionary search in every round, and lowering a state is by far the most expensive part of
+ * its feature extraction. As the features are a pure function of the task and the transform steps
+ * of the state, they are cached by the two, so that a state is only lowered once. The failed
+ * extractions are cached as well, with empty features. The least recently used entries are evicted
+ * when the cache is full.
+ *
+ * The compute DAG of a task is identified by its address, as different DAGs may share a workload
+ * key, and the entries keep their DAG alive so that the address is not reused while cached.
+ */
+class FeatureCache {
+ public:
+  /*! \brief The global cache. */
+  static FeatureCache* Global() {
+    static FeatureCache* inst = new FeatureCache();
+    return inst;
+  }
+
+  /*!
+   * \brief The key of the features of a state.
+   * \param task The task of the state.
+   * \param state The state.
+   * \param max_n_bufs The maximum number of buffers in the features.
+   * \return The key.
+   */
+  static std::string Key(const SearchTask& task, const State& state, int max_n_bufs) {
+    std::ostringstream os;
+    const HardwareParams& hw = task->hardware_params;
+    auto pass_ctx = tvm::transform::PassContext::Current();
+    os << task->compute_dag.get() << ";" << task->target->str() << ";"
+       << static_cast<int>(task->layout_rewrite_option) << ";" << hw->cache_line_bytes << ","
+       << hw->max_shared_memory_per_block << "," << hw->max_local_memory_per_block << ","
+       << hw->max_threads_per_block << "," << hw->vector_unit_bytes << ","
+       << hw->max_vthread_extent << ";"
+       << pass_ctx->GetConfig<Bool>("tir.noalias", Bool(true)).value() << ","
+       << pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value() << ","
+       << pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value() << ";"
+       << max_n_bufs << ";";
+    dmlc::JSONWriter writer(&os);
+    writer.BeginArray(false);
+    for (const auto& step : state->transform_steps) {
+      writer.WriteArraySeperator();
+      writer.BeginArray(false);
+      step->WriteToRecord(&writer);
+      writer.EndArray();
+    }
+    writer.EndArray();
+    return os.str();
+  }
+
+  /*!
+   * \brief Look up the features of a key.
+   * \param key The key.
+   * \param feature The features found.
+   * \return Whether the key is found.
+   */
+  bool Get(const std::string& key, std::vector<float>* feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+    *feature = it->second.feature;
+    return true;
+  }
+
+  /*!
+   * \brief Add the features of a key.
+   * \param key The key.
+   * \param dag The compute DAG of the task the key is made of.
+   * \param feature The features.
+   */
+  void Put(const std::string& key, const ComputeDAG& dag, const std::vector<float>& feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || entries_.count(key)) {
+      return;
+    }
+    while (entries_.size() >= capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{feature, dag, lru_.begin()});
+  }
+
+  /*!
+   * \brief Clear the cache and set its capacity.
+   * \param capacity The maximum number of states cached, 0 to disable the cache.
+   */
+  void Reset(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+    capacity_ = capacity;
+  }
+
+ private:
+  struct Entry {
+    std::vector<float> feature;
+    ComputeDAG dag;
+    // The position of the key in lru_.
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  std::unordered_map<std::string, Entry> entries_;
+  // The keys, from the most to the least recently used.
+  std::list<std::string> lru_;
+  // The maximum number of entries.
+  size_t capacity_{1 << 16};
+  std::mutex mutex_;
+};
+
 void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
                                    std::vector<float>* feature, std::atomic<int>* error_ct) {
+  FeatureCache* cache = FeatureCache::Global();
+  std::string key = FeatureCache::Key(task, state, max_n_bufs);
+  if (cache->Get(key, feature)) {
+    if (feature->empty()) {
+      (*error_ct)++;
+    }
+    return;
+  }
+
   te::Schedule sch;
   Array<te::Tensor> tensors;
 
@@ -1329,8 +1458,10 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
     GetPerStoreFeature(prim_func->body, task->hardware_params->cache_line_bytes, max_n_bufs,
                        feature);
   } catch (Error& e) {
+    feature->clear();
     (*error_ct)++;
   }
+  cache->Put(key, task->compute_dag, *feature);
 }
 
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask& task,
@@ -1640,6 +1771,11 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromStates")
                                std::move(task_ids), &byte_data);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.ResetFeatureCache").set_body_typed([](int capacity) {
+  ICHECK_GE(capacity, 0);
+  FeatureCache::Global()->Reset(capacity);
+});
+
 TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       int max_n_bufs = args[0];
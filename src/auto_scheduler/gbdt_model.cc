@@ -0,0 +1,340 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_scheduler/gbdt_model.cc
+ * \brief A gradient boosted tree cost model trained and evaluated in c++.
+ *
+ *  The model is trained with the pack-sum square error of the python XGBModel: the score of
+ *  a state is the sum of the predictions for its per-store feature vectors, and the loss of
+ *  a state is its squared error weighted by its normalized throughput. The trees are grown
+ *  level by level on histograms of binned features.
+ */
+
+#include <tvm/auto_scheduler/cost_model.h>
+#include <tvm/auto_scheduler/feature.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace auto_scheduler {
+
+TVM_REGISTER_NODE_TYPE(GBDTModelNode);
+
+namespace {
+
+/*! \brief The maximum number of buffers of a feature vector, DEFAULT_MAX_N_BUFS in python. */
+constexpr int kMaxNumBufs = 5;
+/*! \brief The number of feature vectors evaluated together by the prediction. */
+constexpr int kBlockSize = 64;
+/*! \brief The maximum number of feature vectors sampled to compute the bins of a feature. */
+constexpr size_t kMaxBinSamples = 1 << 16;
+
+/*! \brief The per-store feature vectors of states, one row per store. */
+struct FeatureMatrix {
+  /*! \brief The length of a feature vector. */
+  int num_features = 0;
+  /*! \brief The feature vectors in row major order. */
+  std::vector<float> rows;
+  /*! \brief The state of each row. */
+  std::vector<int> row_state;
+  /*! \brief Whether the features of each state could be extracted. */
+  std::vector<bool> valid;
+
+  size_t num_rows() const { return row_state.size(); }
+};
+
+/*!
+ * \brief Flatten the features returned by GetPerStoreFeaturesFromStates. The features of a
+ *  state are the number of stores, followed by the feature vector of each store.
+ */
+FeatureMatrix Flatten(const std::vector<std::vector<float>>& features) {
+  FeatureMatrix m;
+  m.valid.assign(features.size(), false);
+  for (size_t i = 0; i < features.size(); ++i) {
+    const std::vector<float>& feature = features[i];
+    int num_stores = feature.empty() ? 0 : static_cast<int>(feature[0]);
+    if (num_stores <= 0) continue;
+    int num_features = static_cast<int>(feature.size() - 1) / num_stores;
+    if (m.num_features == 0) m.num_features = num_features;
+    ICHECK_EQ(m.num_features, num_features) << "Inconsistent lengths of feature vectors";
+    m.rows.insert(m.rows.end(), feature.begin() + 1, feature.end());
+    m.row_state.insert(m.row_state.end(), num_stores, static_cast<int>(i));
+    m.valid[i] = true;
+  }
+  return m;
+}
+
+/*!
+ * \brief Predict the rows of a feature matrix. A block of rows is transposed so that each
+ *  level of a tree compares contiguous values with no branch, which the compiler vectorizes.
+ */
+std::vector<float> PredictRows(const std::vector<GBDTModelNode::Tree>& trees,
+                               const FeatureMatrix& m) {
+  size_t num_rows = m.num_rows();
+  std::vector<float> preds(num_rows, 0.0f);
+  if (trees.empty() || num_rows == 0) return preds;
+  int num_features = m.num_features;
+  int num_blocks = static_cast<int>((num_rows + kBlockSize - 1) / kBlockSize);
+  support::parallel_for(0, num_blocks, [&](int block) {
+    size_t begin = static_cast<size_t>(block) * kBlockSize;
+    size_t size = std::min<size_t>(kBlockSize, num_rows - begin);
+    std::vector<float> columns(static_cast<size_t>(num_features) * kBlockSize, 0.0f);
+    for (size_t r = 0; r < size; ++r) {
+      const float* row = &m.rows[(begin + r) * num_features];
+      for (int f = 0; f < num_features; ++f) {
+        columns[f * kBlockSize + r] = row[f];
+      }
+    }
+    uint32_t index[kBlockSize];
+    float sum[kBlockSize] = {0.0f};
+    for (const GBDTModelNode::Tree& tree : trees) {
+      std::fill(index, index + kBlockSize, 0);
+      for (size_t d = 0; d < tree.features.size(); ++d) {
+        const float* column = &columns[tree.features[d] * kBlockSize];
+        float threshold = tree.thresholds[d];
+        for (int r = 0; r < kBlockSize; ++r) {
+          index[r] |= static_cast<uint32_t>(column[r] > threshold) << d;
+        }
+      }
+      const float* leaves = tree.leaves.data();
+      for (int r = 0; r < kBlockSize; ++r) {
+        sum[r] += leaves[index[r]];
+      }
+    }
+    std::copy(sum, sum + size, preds.begin() + begin);
+  });
+  return preds;
+}
+
+/*! \brief The features of a feature matrix, binned on the quantiles of their values. */
+struct BinnedFeatures {
+  /*! \brief The sorted edges of each feature, the bin of a value is the number of smaller edges. */
+  std::vector<std::vector<float>> edges;
+  /*! \brief The bins in column major order. */
+  std::vector<uint8_t> bins;
+
+  BinnedFeatures(const FeatureMatrix& m, int num_bins) {
+    size_t num_rows = m.num_rows();
+    int num_features = m.num_features;
+    size_t stride = std::max<size_t>(1, num_rows / kMaxBinSamples);
+    edges.resize(num_features);
+    bins.resize(num_rows * num_features);
+    support::parallel_for(0, num_features, [&](int f) {
+      std::vector<float> values;
+      for (size_t r = 0; r < num_rows; r += stride) {
+        values.push_back(m.rows[r * num_features + f]);
+      }
+      std::sort(values.begin(), values.end());
+      std::vector<float>& edge = edges[f];
+      for (int b = 1; b < num_bins; ++b) {
+        float value = values[values.size() * b / num_bins];
+        if (value > values.front() && (edge.empty() || value > edge.back())) {
+          edge.push_back(value);
+        }
+      }
+      // The first bin holds the values not greater than the smallest edge.
+      for (float& value : edge) {
+        value = *(std::lower_bound(values.begin(), values.end(), value) - 1);
+      }
+      edge.erase(std::unique(edge.begin(), edge.end()), edge.end());
+      uint8_t* column = &bins[f * num_rows];
+      for (size_t r = 0; r < num_rows; ++r) {
+        float value = m.rows[r * num_features + f];
+        column[r] = static_cast<uint8_t>(std::lower_bound(edge.begin(), edge.end(), value) -
+                                         edge.begin());
+      }
+    });
+  }
+};
+
+}  // namespace
+
+GBDTModel::GBDTModel(int num_warmup_sample, int max_depth, int num_rounds_per_update,
+                     int max_num_trees, int num_bins, double learning_rate, double reg_lambda) {
+  ICHECK(max_depth >= 0 && max_depth <= 10) << "The depth of the trees must be in [0, 10]";
+  ICHECK(num_bins >= 2 && num_bins <= 256) << "The number of bins must be in [2, 256]";
+  ICHECK_GT(num_rounds_per_update, 0);
+  ICHECK_GE(max_num_trees, num_rounds_per_update);
+  auto node = make_object<GBDTModelNode>();
+  node->num_warmup_sample = num_warmup_sample;
+  node->max_depth = max_depth;
+  node->num_rounds_per_update = num_rounds_per_update;
+  node->max_num_trees = max_num_trees;
+  node->num_bins = num_bins;
+  node->learning_rate = learning_rate;
+  node->reg_lambda = reg_lambda;
+  data_ = std::move(node);
+}
+
+void GBDTModelNode::Update(const Array<MeasureInput>& inputs,
+                           const Array<MeasureResult>& results) {
+  if (inputs.empty()) return;
+  ICHECK_EQ(inputs.size(), results.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs_.push_back(inputs[i]);
+    results_.push_back(results[i]);
+  }
+
+  // The throughputs are normalized again with the new measurements, only the features of the
+  // new states are extracted.
+  size_t num_cached = features_.size();
+  std::vector<std::vector<float>> features;
+  std::vector<int> task_ids;
+  GetPerStoreFeaturesFromMeasurePairs(inputs_, results_, num_cached, kMaxNumBufs, &features,
+                                      &throughputs_, &task_ids);
+  for (size_t i = 0; i < num_cached && i < features.size(); ++i) {
+    features[i] = std::move(features_[i]);
+  }
+  features_ = std::move(features);
+
+  if (static_cast<int>(trees.size()) + num_rounds_per_update > max_num_trees) {
+    trees.clear();
+    Train(max_num_trees / 2);
+  } else {
+    Train(num_rounds_per_update);
+  }
+}
+
+void GBDTModelNode::Train(int num_rounds) {
+  FeatureMatrix m = Flatten(features_);
+  size_t num_rows = m.num_rows();
+  if (num_rows == 0) return;
+  BinnedFeatures binned(m, num_bins);
+  int num_features = m.num_features;
+  double lambda = reg_lambda;
+
+  std::vector<float> row_preds = PredictRows(trees, m);
+  std::vector<double> state_preds(throughputs_.size());
+  std::vector<double> grad(num_rows), hess(num_rows);
+  std::vector<uint32_t> leaf(num_rows);
+
+  for (int round = 0; round < num_rounds; ++round) {
+    // The gradient of the pack-sum square error, weighted by the throughput.
+    std::fill(state_preds.begin(), state_preds.end(), 0.0);
+    for (size_t r = 0; r < num_rows; ++r) state_preds[m.row_state[r]] += row_preds[r];
+    for (size_t r = 0; r < num_rows; ++r) {
+      double label = throughputs_[m.row_state[r]];
+      grad[r] = label * (state_preds[m.row_state[r]] - label);
+      hess[r] = label;
+    }
+
+    Tree tree;
+    std::fill(leaf.begin(), leaf.end(), 0);
+    for (int depth = 0; depth < max_depth; ++depth) {
+      // All the leaves of a level are split on the same feature and bin.
+      size_t num_leaves = size_t(1) << depth;
+      std::vector<double> best_gains(num_features, 0.0);
+      std::vector<int> best_bins(num_features, -1);
+      support::parallel_for(0, num_features, [&](int f) {
+        const std::vector<float>& edges = binned.edges[f];
+        if (edges.empty()) return;
+        size_t num_feature_bins = edges.size() + 1;
+        const uint8_t* column = &binned.bins[f * num_rows];
+        std::vector<double> g(num_leaves * num_feature_bins, 0.0);
+        std::vector<double> h(num_leaves * num_feature_bins, 0.0);
+        for (size_t r = 0; r < num_rows; ++r) {
+          size_t k = leaf[r] * num_feature_bins + column[r];
+          g[k] += grad[r];
+          h[k] += hess[r];
+        }
+        std::vector<double> g_total(num_leaves, 0.0), h_total(num_leaves, 0.0);
+        for (size_t l = 0; l < num_leaves; ++l) {
+          for (size_t b = 0; b < num_feature_bins; ++b) {
+            g_total[l] += g[l * num_feature_bins + b];
+            h_total[l] += h[l * num_feature_bins + b];
+          }
+        }
+        std::vector<double> g_left(num_leaves, 0.0), h_left(num_leaves, 0.0);
+        for (size_t b = 0; b < edges.size(); ++b) {
+          double gain = 0.0;
+          for (size_t l = 0; l < num_leaves; ++l) {
+            g_left[l] += g[l * num_feature_bins + b];
+            h_left[l] += h[l * num_feature_bins + b];
+            double g_right = g_total[l] - g_left[l], h_right = h_total[l] - h_left[l];
+            gain += g_left[l] * g_left[l] / (h_left[l] + lambda) +
+                    g_right * g_right / (h_right + lambda) -
+                    g_total[l] * g_total[l] / (h_total[l] + lambda);
+          }
+          if (gain > best_gains[f]) {
+            best_gains[f] = gain;
+            best_bins[f] = static_cast<int>(b);
+          }
+        }
+      });
+      int best = static_cast<int>(std::max_element(best_gains.begin(), best_gains.end()) -
+                                  best_gains.begin());
+      if (best_bins[best] < 0) break;
+      tree.features.push_back(best);
+      tree.thresholds.push_back(binned.edges[best][best_bins[best]]);
+      const uint8_t* column = &binned.bins[best * num_rows];
+      for (size_t r = 0; r < num_rows; ++r) {
+        leaf[r] |= static_cast<uint32_t>(column[r] > best_bins[best]) << depth;
+      }
+    }
+
+    size_t num_leaves = size_t(1) << tree.features.size();
+    std::vector<double> g(num_leaves, 0.0), h(num_leaves, 0.0);
+    for (size_t r = 0; r < num_rows; ++r) {
+      g[leaf[r]] += grad[r];
+      h[leaf[r]] += hess[r];
+    }
+    tree.leaves.resize(num_leaves);
+    for (size_t l = 0; l < num_leaves; ++l) {
+      tree.leaves[l] = static_cast<float>(-learning_rate * g[l] / (h[l] + lambda));
+    }
+    for (size_t r = 0; r < num_rows; ++r) row_preds[r] += tree.leaves[leaf[r]];
+    trees.push_back(std::move(tree));
+  }
+}
+
+void GBDTModelNode::Predict(const SearchTask& task, const Array<State>& states,
+                            std::vector<float>* scores) {
+  std::vector<std::vector<float>> features;
+  GetPerStoreFeaturesFromStates(states, task, 0, kMaxNumBufs, &features);
+  FeatureMatrix m = Flatten(features);
+  scores->assign(states.size(), 0.0f);
+  if (trees.empty() || static_cast<int>(inputs_.size()) <= num_warmup_sample) {
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    for (float& score : *scores) score = dis(rand_gen_);
+  } else {
+    std::vector<float> preds = PredictRows(trees, m);
+    for (size_t r = 0; r < preds.size(); ++r) (*scores)[m.row_state[r]] += preds[r];
+  }
+  // Predict -inf for the invalid states that failed to be lowered.
+  for (size_t i = 0; i < states.size(); ++i) {
+    if (!m.valid[i]) (*scores)[i] = -INFINITY;
+  }
+}
+
+TVM_REGISTER_GLOBAL("auto_scheduler.GBDTModel")
+    .set_body_typed([](int num_warmup_sample, int max_depth, int num_rounds_per_update,
+                       int max_num_trees, int num_bins, double learning_rate, double reg_lambda) {
+      return GBDTModel(num_warmup_sample, max_depth, num_rounds_per_update, max_num_trees,
+                       num_bins, learning_rate, reg_lambda);
+    });
+
+}  // namespace auto_scheduler
+}  // namespace tvm
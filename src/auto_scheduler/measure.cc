@@ -74,13 +74,14 @@ MeasureInput MeasureInputNode::copy() const {
 }
 
 BuildResult::BuildResult(String filename, Array<te::Tensor> args, int error_no, String error_msg,
-                         double time_cost) {
+                         double time_cost, String module_ir) {
   auto node = make_object<BuildResultNode>();
   node->filename = std::move(filename);
   node->args = std::move(args);
   node->error_no = error_no;
   node->error_msg = std::move(error_msg);
   node->time_cost = time_cost;
+  node->module_ir = std::move(module_ir);
   data_ = std::move(node);
 }
 
@@ -127,7 +128,8 @@ Array<BuildResult> LocalBuilderNode::Build(const Array<MeasureInput>& inputs, in
 
 /********** LocalRunner **********/
 LocalRunner::LocalRunner(int timeout, int number, int repeat, int min_repeat_ms,
-                         double cooldown_interval, bool enable_cpu_cache_flush) {
+                         double cooldown_interval, bool enable_cpu_cache_flush, int max_repeat,
+                         double max_rel_ci, double cutoff_ratio) {
   ObjectPtr<LocalRunnerNode> node = make_object<LocalRunnerNode>();
   node->timeout = timeout;
   node->number = number;
@@ -135,6 +137,9 @@ LocalRunner::LocalRunner(int timeout, int number, int repeat, int min_repeat_ms,
   node->min_repeat_ms = min_repeat_ms;
   node->cooldown_interval = cooldown_interval;
   node->enable_cpu_cache_flush = enable_cpu_cache_flush;
+  node->max_repeat = max_repeat;
+  node->max_rel_ci = max_rel_ci;
+  node->cutoff_ratio = cutoff_ratio;
   data_ = std::move(node);
 }
 
@@ -143,7 +148,7 @@ Array<MeasureResult> LocalRunnerNode::Run(const Array<MeasureInput>& inputs,
   if (const auto* f = runtime::Registry::Get("auto_scheduler.local_runner.run")) {
     Array<MeasureResult> results =
         (*f)(inputs, build_results, timeout, number, repeat, min_repeat_ms, cooldown_interval,
-             enable_cpu_cache_flush, verbose);
+             enable_cpu_cache_flush, verbose, max_repeat, max_rel_ci, cutoff);
     return results;
   }
   LOG(FATAL) << "auto_scheduler.local_runner.run is not registered. "
@@ -155,7 +160,9 @@ Array<MeasureResult> LocalRunnerNode::Run(const Array<MeasureInput>& inputs,
 /********** RPCRunner **********/
 RPCRunner::RPCRunner(const String& key, const String& host, int port, int priority, int n_parallel,
                      int timeout, int number, int repeat, int min_repeat_ms,
-                     double cooldown_interval, bool enable_cpu_cache_flush) {
+                     double cooldown_interval, bool enable_cpu_cache_flush, int batch_size,
+                     int max_repeat, double max_rel_ci, double cutoff_ratio) {
+  ICHECK_GE(batch_size, 0);
   auto node = make_object<RPCRunnerNode>();
   node->key = key;
   node->host = host;
@@ -168,6 +175,10 @@ RPCRunner::RPCRunner(const String& key, const String& host, int port, int priori
   node->min_repeat_ms = min_repeat_ms;
   node->cooldown_interval = cooldown_interval;
   node->enable_cpu_cache_flush = enable_cpu_cache_flush;
+  node->batch_size = batch_size;
+  node->max_repeat = max_repeat;
+  node->max_rel_ci = max_rel_ci;
+  node->cutoff_ratio = cutoff_ratio;
   data_ = std::move(node);
 }
 
@@ -176,7 +187,8 @@ Array<MeasureResult> RPCRunnerNode::Run(const Array<MeasureInput>& inputs,
   if (const auto* f = runtime::Registry::Get("auto_scheduler.rpc_runner.run")) {
     Array<MeasureResult> results =
         (*f)(inputs, build_results, key, host, port, priority, n_parallel, timeout, number, repeat,
-             min_repeat_ms, cooldown_interval, enable_cpu_cache_flush, verbose);
+             min_repeat_ms, cooldown_interval, enable_cpu_cache_flush, verbose, batch_size,
+             max_repeat, max_rel_ci, cutoff);
     return results;
   } else {
     LOG(FATAL) << "auto_scheduler.rpc_runner.run is not registered. "
@@ -314,6 +326,14 @@ void ProgramMeasurerNode::SilentMeasure(const SearchTask& task, const Array<Meas
   results->clear();
   results->reserve(inputs.size());
 
+  // Stop measuring the programs far slower than the best one of the task
+  runner->cutoff = 0;
+  auto it = best_flops.find(task->workload_key);
+  if (runner->cutoff_ratio > 0 && it != best_flops.end() && it->second > 0 &&
+      task->compute_dag->flop_ct > 0) {
+    runner->cutoff = runner->cutoff_ratio * task->compute_dag->flop_ct / it->second;
+  }
+
   // Call builder and runner
   Array<BuildResult> build_res_batch = builder->Build(inputs, verbose);
   Array<MeasureResult> result_batch = runner->Run(inputs, build_res_batch, verbose);
@@ -372,8 +392,8 @@ TVM_REGISTER_GLOBAL("auto_scheduler.MeasureInput").set_body_typed([](SearchTask
 
 TVM_REGISTER_GLOBAL("auto_scheduler.BuildResult")
     .set_body_typed([](String filename, Array<te::Tensor> args, int error_no, String error_msg,
-                       double time_cost) {
-      return BuildResult(filename, args, error_no, error_msg, time_cost);
+                       double time_cost, String module_ir) {
+      return BuildResult(filename, args, error_no, error_msg, time_cost, module_ir);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.MeasureResult")
@@ -409,17 +429,20 @@ TVM_REGISTER_GLOBAL("auto_scheduler.LocalBuilder")
 
 TVM_REGISTER_GLOBAL("auto_scheduler.LocalRunner")
     .set_body_typed([](int timeout, int number, int repeat, int min_repeat_ms,
-                       double cooldown_interval, bool enable_cpu_cache_flush) {
+                       double cooldown_interval, bool enable_cpu_cache_flush, int max_repeat,
+                       double max_rel_ci, double cutoff_ratio) {
       return LocalRunner(timeout, number, repeat, min_repeat_ms, cooldown_interval,
-                         enable_cpu_cache_flush);
+                         enable_cpu_cache_flush, max_repeat, max_rel_ci, cutoff_ratio);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.RPCRunner")
     .set_body_typed([](const String& key, const String& host, int port, int priority,
                        int n_parallel, int timeout, int number, int repeat, int min_repeat_ms,
-                       double cooldown_interval, bool enable_cpu_cache_flush) {
+                       double cooldown_interval, bool enable_cpu_cache_flush, int batch_size,
+                       int max_repeat, double max_rel_ci, double cutoff_ratio) {
       return RPCRunner(key, host, port, priority, n_parallel, timeout, number, repeat,
-                       min_repeat_ms, cooldown_interval, enable_cpu_cache_flush);
+                       min_repeat_ms, cooldown_interval, enable_cpu_cache_flush, batch_size,
+                       max_repeat, max_rel_ci, cutoff_ratio);
     });
 
 }  // namespace auto_scheduler
@@ -0,0 +1,423 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_scheduler/record_database.cc
+ * \brief An indexed binary store of measure records.
+ *
+ *  The database file starts with kDatabaseMagic, followed by the entries:
+ *
+ *    uint32_t magic;              // kEntryMagic
+ *    uint32_t workload_key_size;
+ *    uint32_t target_size;
+ *    uint32_t record_size;
+ *    double   cost;               // the mean cost, infinity for a failed measurement
+ *    char     workload_key[workload_key_size];
+ *    char     target[target_size];
+ *    char     record[record_size];  // the json record, as in the log files
+ *
+ *  The index file, at the path of the database followed by ".index", holds the best entries
+ *  of every workload key and target, and the size of the database it covers. The numbers are
+ *  in the byte order of the host.
+ */
+
+#include <tvm/auto_scheduler/measure_record.h>
+#include <tvm/runtime/registry.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+namespace tvm {
+namespace auto_scheduler {
+
+TVM_REGISTER_NODE_TYPE(RecordDatabaseNode);
+TVM_REGISTER_OBJECT_TYPE(RecordToDatabaseNode);
+
+namespace {
+
+constexpr char kDatabaseMagic[8] = {'T', 'V', 'M', 'A', 'S', 'R', 'D', 'B'};
+constexpr char kIndexMagic[8] = {'T', 'V', 'M', 'A', 'S', 'I', 'D', 'X'};
+constexpr uint32_t kEntryMagic = 0x52454331;
+
+/*! \brief The header of an entry of the database. */
+struct EntryHeader {
+  uint32_t magic;
+  uint32_t workload_key_size;
+  uint32_t target_size;
+  uint32_t record_size;
+  double cost;
+
+  uint64_t size() const {
+    return sizeof(EntryHeader) + workload_key_size + target_size + record_size;
+  }
+};
+
+template <typename T>
+void Put(std::string* buf, const T& value) {
+  buf->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void PutString(std::string* buf, const std::string& value) {
+  Put(buf, static_cast<uint32_t>(value.size()));
+  buf->append(value);
+}
+
+template <typename T>
+bool Get(std::istream* is, T* value) {
+  return static_cast<bool>(is->read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+
+bool GetString(std::istream* is, std::string* value) {
+  uint32_t size;
+  if (!Get(is, &size)) return false;
+  value->resize(size);
+  return static_cast<bool>(is->read(&(*value)[0], size));
+}
+
+uint64_t FileSize(const std::string& path) {
+  std::ifstream is(path, std::ifstream::binary | std::ifstream::ate);
+  return is ? static_cast<uint64_t>(is.tellg()) : 0;
+}
+
+/*!
+ * \brief Append bytes to a file. The file is locked so that the entries appended by
+ *  concurrent processes do not interleave.
+ * \param path The path of the file.
+ * \param bytes The bytes to append.
+ * \param only_if_empty Only write the bytes to an empty file.
+ */
+void AppendLocked(const std::string& path, const std::string& bytes, bool only_if_empty) {
+#ifndef _WIN32
+  int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+  ICHECK_GE(fd, 0) << "Cannot open the record database " << path;
+  ICHECK_EQ(flock(fd, LOCK_EX), 0) << "Cannot lock the record database " << path;
+  if (!only_if_empty || lseek(fd, 0, SEEK_END) == 0) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+      ssize_t n = write(fd, bytes.data() + written, bytes.size() - written);
+      ICHECK_GT(n, 0) << "Cannot write to the record database " << path;
+      written += n;
+    }
+  }
+  flock(fd, LOCK_UN);
+  close(fd);
+#else
+  // There is no advisory lock on windows, the file is not shared by concurrent processes.
+  if (only_if_empty && FileSize(path) > 0) return;
+  std::ofstream ofs(path, std::ofstream::binary | std::ofstream::app);
+  ICHECK(ofs) << "Cannot open the record database " << path;
+  ofs.write(bytes.data(), bytes.size());
+#endif
+}
+
+}  // namespace
+
+RecordDatabase::RecordDatabase(String path, int top_k) {
+  ICHECK_GT(top_k, 0) << "The database must index at least one record per workload";
+  auto node = make_object<RecordDatabaseNode>();
+  node->path = std::move(path);
+  node->top_k = top_k;
+  AppendLocked(node->path, std::string(kDatabaseMagic, sizeof(kDatabaseMagic)), true);
+  {
+    std::ifstream is(node->path, std::ifstream::binary);
+    char magic[sizeof(kDatabaseMagic)];
+    ICHECK(is.read(magic, sizeof(magic)) && std::memcmp(magic, kDatabaseMagic, sizeof(magic)) == 0)
+        << node->path << " is not a record database";
+  }
+  if (!node->LoadIndex()) {
+    node->index_.clear();
+    node->indexed_size_ = sizeof(kDatabaseMagic);
+  }
+  node->Refresh();
+  data_ = std::move(node);
+}
+
+void RecordDatabaseNode::Index(const std::string& workload_key, const std::string& target,
+                               double cost, uint64_t offset) {
+  if (!std::isfinite(cost)) return;
+  IndexEntry& entry = index_[workload_key + "\n" + target];
+  if (entry.best.empty()) {
+    entry.workload_key = workload_key;
+    entry.target = target;
+  }
+  auto item = std::make_pair(cost, offset);
+  auto it = std::upper_bound(entry.best.begin(), entry.best.end(), item);
+  if (it - entry.best.begin() >= top_k) return;
+  entry.best.insert(it, item);
+  if (static_cast<int>(entry.best.size()) > top_k) entry.best.pop_back();
+}
+
+void RecordDatabaseNode::Append(const Array<MeasureInput>& inputs,
+                                const Array<MeasureResult>& results) {
+  ICHECK_EQ(inputs.size(), results.size());
+  std::string bytes;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::ostringstream record;
+    WriteMeasureRecords(&record, {inputs[i]}, {results[i]});
+    std::string workload_key = inputs[i]->task->workload_key;
+    std::string target = inputs[i]->task->target->str();
+    EntryHeader header;
+    header.magic = kEntryMagic;
+    header.workload_key_size = workload_key.size();
+    header.target_size = target.size();
+    header.record_size = record.str().size();
+    header.cost = results[i]->error_no == 0 && !results[i]->costs.empty()
+                      ? FloatArrayMean(results[i]->costs)
+                      : std::numeric_limits<double>::infinity();
+    Put(&bytes, header);
+    bytes += workload_key;
+    bytes += target;
+    bytes += record.str();
+  }
+  AppendLocked(path, bytes, false);
+  // The entries are indexed from the file, with the entries of the other processes.
+  Refresh();
+}
+
+void RecordDatabaseNode::Refresh() {
+  uint64_t size = FileSize(path);
+  if (size <= indexed_size_) return;
+  std::ifstream is(path, std::ifstream::binary);
+  is.seekg(indexed_size_);
+  std::string workload_key, target;
+  while (indexed_size_ + sizeof(EntryHeader) <= size) {
+    EntryHeader header;
+    if (!Get(&is, &header)) break;
+    if (header.magic != kEntryMagic) {
+      LOG(WARNING) << "Corrupted entry at offset " << indexed_size_ << " of the record database "
+                   << path << ", the following entries are ignored";
+      break;
+    }
+    // An entry still being written by another process is indexed by the next refresh.
+    if (indexed_size_ + header.size() > size) break;
+    workload_key.resize(header.workload_key_size);
+    target.resize(header.target_size);
+    is.read(&workload_key[0], header.workload_key_size);
+    is.read(&target[0], header.target_size);
+    is.seekg(header.record_size, std::ios_base::cur);
+    if (!is) break;
+    Index(workload_key, target, header.cost, indexed_size_);
+    indexed_size_ += header.size();
+  }
+}
+
+void RecordDatabaseNode::ReadEntry(std::ifstream* is, uint64_t offset, MeasureInputNode* inp,
+                                   MeasureResultNode* res) const {
+  EntryHeader header;
+  is->seekg(offset);
+  ICHECK(Get(is, &header) && header.magic == kEntryMagic)
+      << "Corrupted entry at offset " << offset << " of the record database " << path;
+  is->seekg(header.workload_key_size + header.target_size, std::ios_base::cur);
+  std::string record(header.record_size, '\0');
+  ICHECK(is->read(&record[0], header.record_size))
+      << "Corrupted entry at offset " << offset << " of the record database " << path;
+  std::string log_version;
+  ReadMeasureRecord(record, inp, res, &log_version);
+}
+
+std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordDatabaseNode::GetTopK(
+    const std::string& workload_key, const std::string& target, int k) {
+  ICHECK_LE(k, top_k) << "The database only indexes the " << top_k << " best records";
+  Refresh();
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  auto it = index_.find(workload_key + "\n" + target);
+  if (it == index_.end()) return std::make_pair(inputs, results);
+  std::ifstream is(path, std::ifstream::binary);
+  const auto& best = it->second.best;
+  for (size_t i = 0; i < best.size() && static_cast<int>(i) < k; ++i) {
+    auto inp = make_object<MeasureInputNode>();
+    auto res = make_object<MeasureResultNode>();
+    ReadEntry(&is, best[i].second, inp.get(), res.get());
+    inputs.push_back(MeasureInput(inp));
+    results.push_back(MeasureResult(res));
+  }
+  return std::make_pair(inputs, results);
+}
+
+std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordDatabaseNode::GetBestRecords() {
+  Refresh();
+  std::vector<uint64_t> offsets;
+  for (const auto& kv : index_) {
+    if (!kv.second.best.empty()) offsets.push_back(kv.second.best[0].second);
+  }
+  // The entries are read in the order of the file.
+  std::sort(offsets.begin(), offsets.end());
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  std::ifstream is(path, std::ifstream::binary);
+  for (uint64_t offset : offsets) {
+    auto inp = make_object<MeasureInputNode>();
+    auto res = make_object<MeasureResultNode>();
+    ReadEntry(&is, offset, inp.get(), res.get());
+    inputs.push_back(MeasureInput(inp));
+    results.push_back(MeasureResult(res));
+  }
+  return std::make_pair(inputs, results);
+}
+
+void RecordDatabaseNode::SaveIndex() {
+  Refresh();
+  std::string bytes(kIndexMagic, sizeof(kIndexMagic));
+  Put(&bytes, indexed_size_);
+  Put(&bytes, static_cast<uint32_t>(top_k));
+  Put(&bytes, static_cast<uint64_t>(index_.size()));
+  for (const auto& kv : index_) {
+    PutString(&bytes, kv.second.workload_key);
+    PutString(&bytes, kv.second.target);
+    Put(&bytes, static_cast<uint32_t>(kv.second.best.size()));
+    for (const auto& item : kv.second.best) {
+      Put(&bytes, item.first);
+      Put(&bytes, item.second);
+    }
+  }
+  // The index is replaced at once, a concurrent reader sees the old or the new one.
+  std::string index_path = std::string(path) + ".index";
+  std::string tmp_path = index_path + ".tmp";
+  {
+    std::ofstream ofs(tmp_path, std::ofstream::binary | std::ofstream::trunc);
+    ICHECK(ofs.write(bytes.data(), bytes.size())) << "Cannot write the index " << tmp_path;
+  }
+  ICHECK_EQ(std::rename(tmp_path.c_str(), index_path.c_str()), 0)
+      << "Cannot write the index " << index_path;
+}
+
+bool RecordDatabaseNode::LoadIndex() {
+  std::ifstream is(std::string(path) + ".index", std::ifstream::binary);
+  char magic[sizeof(kIndexMagic)];
+  if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, kIndexMagic, sizeof(magic)) != 0) {
+    return false;
+  }
+  uint64_t indexed_size, num_entries;
+  uint32_t saved_top_k;
+  if (!Get(&is, &indexed_size) || !Get(&is, &saved_top_k) || !Get(&is, &num_entries)) {
+    return false;
+  }
+  // An index with fewer records per workload, or of a larger file, is built again.
+  if (static_cast<int>(saved_top_k) < top_k || indexed_size > FileSize(path)) return false;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    IndexEntry entry;
+    uint32_t num_best;
+    if (!GetString(&is, &entry.workload_key) || !GetString(&is, &entry.target) ||
+        !Get(&is, &num_best)) {
+      return false;
+    }
+    for (uint32_t j = 0; j < num_best; ++j) {
+      std::pair<double, uint64_t> item;
+      if (!Get(&is, &item.first) || !Get(&is, &item.second)) return false;
+      if (static_cast<int>(j) < top_k) entry.best.push_back(item);
+    }
+    std::string key = entry.workload_key + "\n" + entry.target;
+    index_[key] = std::move(entry);
+  }
+  indexed_size_ = indexed_size;
+  return true;
+}
+
+void RecordDatabaseNode::Compact(const std::string& out_path) {
+  ICHECK_NE(out_path, std::string(path)) << "The database cannot be compacted in place";
+  Refresh();
+  std::vector<uint64_t> offsets;
+  for (const auto& kv : index_) {
+    for (const auto& item : kv.second.best) offsets.push_back(item.second);
+  }
+  std::sort(offsets.begin(), offsets.end());
+  std::string tmp_path = out_path + ".tmp";
+  {
+    std::ifstream is(path, std::ifstream::binary);
+    std::ofstream ofs(tmp_path, std::ofstream::binary | std::ofstream::trunc);
+    ofs.write(kDatabaseMagic, sizeof(kDatabaseMagic));
+    std::string entry;
+    for (uint64_t offset : offsets) {
+      EntryHeader header;
+      is.seekg(offset);
+      ICHECK(Get(&is, &header) && header.magic == kEntryMagic)
+          << "Corrupted entry at offset " << offset << " of the record database " << path;
+      entry.resize(header.size() - sizeof(EntryHeader));
+      ICHECK(is.read(&entry[0], entry.size()))
+          << "Corrupted entry at offset " << offset << " of the record database " << path;
+      ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      ofs.write(entry.data(), entry.size());
+    }
+    ICHECK(ofs) << "Cannot write the record database " << tmp_path;
+  }
+  std::remove((out_path + ".index").c_str());
+  ICHECK_EQ(std::rename(tmp_path.c_str(), out_path.c_str()), 0)
+      << "Cannot write the record database " << out_path;
+  RecordDatabase(out_path, top_k)->SaveIndex();
+}
+
+RecordToDatabase::RecordToDatabase(RecordDatabase database) {
+  auto node = make_object<RecordToDatabaseNode>();
+  node->database = std::move(database);
+  data_ = std::move(node);
+}
+
+void RecordToDatabaseNode::Callback(const SearchPolicy& policy, const Array<MeasureInput>& inputs,
+                                    const Array<MeasureResult>& results) {
+  database->Append(inputs, results);
+}
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabase")
+    .set_body_typed([](String path, int top_k) { return RecordDatabase(path, top_k); });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabaseAppend")
+    .set_body_typed([](RecordDatabase database, Array<MeasureInput> inputs,
+                       Array<MeasureResult> results) { database->Append(inputs, results); });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabaseGetTopK")
+    .set_body_typed([](RecordDatabase database, String workload_key, String target, int k) {
+      const auto& res = database->GetTopK(workload_key, target, k);
+      return Array<ObjectRef>{res.first, res.second};
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabaseGetBestRecords")
+    .set_body_typed([](RecordDatabase database) {
+      const auto& res = database->GetBestRecords();
+      return Array<ObjectRef>{res.first, res.second};
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabaseSaveIndex")
+    .set_body_typed([](RecordDatabase database) { database->SaveIndex(); });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordDatabaseCompact")
+    .set_body_typed([](RecordDatabase database, String out_path) {
+      database->Compact(out_path);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.RecordToDatabase")
+    .set_body_typed([](RecordDatabase database) { return RecordToDatabase(database); });
+
+}  // namespace auto_scheduler
+}  // namespace tvm
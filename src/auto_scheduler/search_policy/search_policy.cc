@@ -26,6 +26,11 @@
 #include <tvm/auto_scheduler/search_policy.h>
 #include <tvm/runtime/registry.h>
 
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "utils.h"
 
 namespace tvm {
@@ -81,6 +86,132 @@ void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
   }
 }
 
+/*! \brief Get the compute function name or the compute DAG hash of a workload key. */
+static std::string GetWorkloadFamily(const std::string& workload_key) {
+  // The workload key is a JSON list "[func_name/hash, args ...]"
+  if (workload_key.size() > 2 && workload_key[0] == '[' && workload_key[1] == '"') {
+    size_t end = workload_key.find('"', 2);
+    if (end != std::string::npos) {
+      return workload_key.substr(2, end - 2);
+    }
+  }
+  return workload_key;
+}
+
+/*!
+ * \brief Adapt a split step recorded for another workload to the extent of the iterator it splits
+ *  in the current state. Every length is reduced to its greatest common divisor with the extent
+ *  left to split, so that the adapted step is still a perfect tiling of the iterator.
+ */
+static Step AdaptSplitStep(const State& state, const SplitStepNode* ps) {
+  if (ps->stage_id >= static_cast<int>(state->stages.size()) ||
+      ps->iter_id >= static_cast<int>(state->stages[ps->stage_id]->iters.size())) {
+    return GetRef<Step>(ps);
+  }
+  const Iterator& it = state->stages[ps->stage_id]->iters[ps->iter_id];
+  const auto* extent = it->range.defined() ? it->range->extent.as<IntImmNode>() : nullptr;
+  if (extent == nullptr) {
+    return GetRef<Step>(ps);
+  }
+
+  int64_t remaining = extent->value;
+  Array<Optional<Integer>> lengths;
+  for (const auto& length : ps->lengths) {
+    if (!length) {
+      lengths.push_back(length);
+      continue;
+    }
+    int64_t a = length.value()->value, b = remaining;
+    while (b != 0) {
+      std::swap(a, b);
+      b %= a;
+    }
+    lengths.push_back(Integer(a));
+    remaining /= a;
+  }
+  return SplitStep(ps->stage_id, ps->iter_id, Integer(extent->value), lengths,
+                   ps->inner_to_outer);
+}
+
+std::pair<Array<MeasureInput>, Array<MeasureResult>> SearchPolicyNode::PreloadSimilarStates(
+    const String& log_file, int max_states) {
+  RecordReader reader = RecordReader(log_file);
+  const auto& res = reader->ReadLines(-1);
+  ICHECK_EQ(res.first.size(), res.second.size());
+  const std::string& workload_key = search_task->workload_key;
+  const std::string family = GetWorkloadFamily(workload_key);
+
+  // Collect the valid records of the other workloads of the same family
+  std::vector<int> candidates;
+  std::unordered_map<std::string, double> best_costs;
+  for (size_t i = 0; i < res.first.size(); ++i) {
+    const auto& task = res.first[i]->task;
+    if (res.second[i]->error_no != 0 || task->workload_key == workload_key ||
+        task->target->kind->name.compare(search_task->target->kind->name) != 0 ||
+        GetWorkloadFamily(task->workload_key) != family) {
+      continue;
+    }
+    double cost = FloatArrayMean(res.second[i]->costs);
+    auto best = best_costs.find(task->workload_key);
+    if (best == best_costs.end()) {
+      best_costs[task->workload_key] = cost;
+    } else {
+      best->second = std::min(best->second, cost);
+    }
+    candidates.push_back(i);
+  }
+
+  // The throughputs are normalized per source workload, the best record of each gets 1
+  std::vector<float> throughputs;
+  throughputs.reserve(candidates.size());
+  for (int i : candidates) {
+    throughputs.push_back(best_costs[res.first[i]->task->workload_key] /
+                          FloatArrayMean(res.second[i]->costs));
+  }
+
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  std::unordered_set<std::string> loaded_states;
+  for (int idx : Argsort(throughputs)) {
+    if (static_cast<int>(inputs.size()) >= max_states) {
+      break;
+    }
+    const auto& inp = res.first[candidates[idx]];
+    State state = search_task->compute_dag->init_state;
+    try {
+      for (const auto& step : inp->state->transform_steps) {
+        Step new_step = step;
+        if (auto ps = step.as<SplitStepNode>()) {
+          new_step = AdaptSplitStep(state, ps);
+        }
+        state.CopyOnWrite()->transform_steps.push_back(new_step);
+        StepApplyToState(new_step, &state, search_task->compute_dag);
+      }
+      state = search_task->compute_dag.InferBound(state);
+    } catch (Error& e) {
+      // The steps do not fit the current compute DAG
+      continue;
+    }
+    std::string state_str = state.ToStr();
+    if (measured_states_set_.count(state_str) || !loaded_states.insert(state_str).second) {
+      continue;
+    }
+
+    measured_states_vector_.push_back(state);
+    measured_states_throughputs_.push_back(throughputs[idx]);
+    SearchTask source_task(search_task->compute_dag, inp->task->workload_key, search_task->target,
+                           search_task->target_host, search_task->hardware_params,
+                           search_task->layout_rewrite_option, search_task->task_input_names);
+    inputs.push_back(MeasureInput(source_task, state));
+    results.push_back(res.second[candidates[idx]]);
+  }
+
+  StdCout(verbose) << "SearchPolicy: Loaded " << inputs.size() << " states of " << best_costs.size()
+                   << " similar workloads from " << log_file << " for " << workload_key
+                   << std::endl;
+  return std::make_pair(std::move(inputs), std::move(results));
+}
+
 void SearchPolicyNode::RunCallbacks(const Array<SearchCallback>& callbacks) {
   for (const auto& callback : callbacks) {
     callback->Callback(this);
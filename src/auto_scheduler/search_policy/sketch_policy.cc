@@ -30,6 +30,8 @@
 #include <tvm/support/parallel_for.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <iomanip>
 #include <limits>
 #include <memory>
@@ -517,16 +519,34 @@ Array<State> SketchPolicyNode::EvolutionarySearch(const Array<State>& init_popul
   heap.reserve(out_size);
 
   // auxiliary global variables
-  std::vector<float> pop_scores;
+  std::vector<float> pop_scores, next_scores;
   std::vector<double> pop_selection_probs;
   float max_score = -1e-10f;
   pop_scores.reserve(population);
+  next_scores.reserve(population);
   pop_selection_probs.reserve(population);
-  std::uniform_real_distribution<> dis(0.0, 1.0);
+
+  // The population is mutated in batches, in parallel with a random generator per
+  // index of the batch. The cost model predicts a batch asynchronously while the
+  // next one is mutated.
+  int predict_batch_size = std::min<int>(
+      population, params.count(SketchParamKey::EvolutionarySearch::predict_batch_size)
+                      ? GetIntParam(params, SketchParamKey::EvolutionarySearch::predict_batch_size)
+                      : population);
+  ICHECK_GT(predict_batch_size, 0) << "The prediction batch size must be positive";
+  std::vector<std::mt19937> rand_gens;
+  rand_gens.reserve(predict_batch_size);
+  for (int i = 0; i < predict_batch_size; i++) {
+    rand_gens.push_back(std::mt19937(rand_gen()));
+  }
+  auto predict = [this](Array<State> states) {
+    std::vector<float> scores;
+    program_cost_model->Predict(search_task, states, &scores);
+    return scores;
+  };
 
   // mutation rules
-  int mutation_success_ct, mutation_fail_ct;
-  mutation_success_ct = mutation_fail_ct = 0;
+  std::atomic<int> mutation_success_ct{0}, mutation_fail_ct{0};
   std::vector<float> rule_weights;
   std::vector<double> rule_selection_probs;
   for (const auto& rule : mutation_rules) {
@@ -534,13 +554,14 @@ Array<State> SketchPolicyNode::EvolutionarySearch(const Array<State>& init_popul
   }
   ComputePrefixSumProb(rule_weights, &rule_selection_probs);
 
+  // The states of the initial population are predicted as a whole.
+  *pnow = search_task->compute_dag.InferBound(*pnow);
+  PruneInvalidState(search_task, pnow);
+  program_cost_model->Predict(search_task, *pnow, &pop_scores);
+
   // Genetic Algorithm
   for (int k = 0; k < num_iters + 1; ++k) {
     // Maintain the heap
-    *pnow = search_task->compute_dag.InferBound(*pnow);
-    PruneInvalidState(search_task, pnow);
-    program_cost_model->Predict(search_task, *pnow, &pop_scores);
-
     for (size_t i = 0; i < pnow->size(); ++i) {
       const State& state = (*pnow)[i];
       std::string state_str = state.ToStr();
@@ -588,24 +609,59 @@ Array<State> SketchPolicyNode::EvolutionarySearch(const Array<State>& init_popul
     // TODO(merrymercy, comaniac): add crossover.
 
     // Do mutation
-    while (pnext->size() < population) {
-      State tmp_s = (*pnow)[RandomChoose(pop_selection_probs, &rand_gen)];
-
-      if (dis(rand_gen) < mutation_prob) {
-        const auto& rule = mutation_rules[RandomChoose(rule_selection_probs, &rand_gen)];
-        if (rule->Apply(this, &tmp_s, &rand_gen) == PopulationGenerationRule::ResultKind::kValid) {
-          pnext->push_back(std::move(tmp_s));
-          mutation_success_ct++;
-        } else {
+    std::future<std::vector<float>> pending;
+    Array<State> pending_states;
+    auto wait_pending = [&]() {
+      if (!pending.valid()) return;
+      std::vector<float> scores = pending.get();
+      pnext->insert(pnext->end(), pending_states.begin(), pending_states.end());
+      next_scores.insert(next_scores.end(), scores.begin(), scores.end());
+    };
+    size_t num_next = 0;
+    while (num_next < population) {
+      int batch_size = std::min<int>(predict_batch_size, population - num_next);
+      std::vector<State> batch(batch_size);
+      support::parallel_for(0, batch_size, [&](int index) {
+        std::mt19937* gen = &rand_gens[index];
+        std::uniform_real_distribution<> dis(0.0, 1.0);
+        State tmp_s = (*pnow)[RandomChoose(pop_selection_probs, gen)];
+        if (dis(*gen) >= mutation_prob) {
+          batch[index] = std::move(tmp_s);
+          return;
+        }
+        const auto& rule = mutation_rules[RandomChoose(rule_selection_probs, gen)];
+        if (rule->Apply(this, &tmp_s, gen) != PopulationGenerationRule::ResultKind::kValid) {
           mutation_fail_ct++;
+          return;
         }
-      } else {
-        pnext->push_back(std::move(tmp_s));
+        mutation_success_ct++;
+        try {
+          tmp_s = search_task->compute_dag.InferBound(tmp_s);
+        } catch (Error&) {
+          // The state is dropped, as by PruneInvalidState.
+          return;
+        }
+        if (IsGPUTask(search_task) || !HasNestedParallel(tmp_s)) {
+          batch[index] = std::move(tmp_s);
+        }
+      });
+      Array<State> valid;
+      for (auto& state : batch) {
+        if (state.defined()) valid.push_back(std::move(state));
       }
+      if (valid.empty()) continue;
+      num_next += valid.size();
+      // Keep a single prediction in flight, the cost model may not be thread safe.
+      wait_pending();
+      pending_states = valid;
+      pending = std::async(std::launch::async, predict, valid);
     }
+    wait_pending();
 
     std::swap(pnext, pnow);
+    std::swap(next_scores, pop_scores);
     pnext->clear();
+    next_scores.clear();
   }
 
   // Copy best states in the heap to out_states
@@ -691,6 +747,27 @@ void PreloadCustomSketchRuleNode::Callback(SearchPolicyNode* policy) {
   StdCout(policy->verbose) << "Custom sketch rule \"" << rule_name << "\" added." << std::endl;
 }
 
+/********** PreloadSimilarStates **********/
+TVM_REGISTER_OBJECT_TYPE(PreloadSimilarStatesNode);
+
+PreloadSimilarStates::PreloadSimilarStates(String filename, int max_states) {
+  auto node = make_object<PreloadSimilarStatesNode>();
+  node->filename = std::move(filename);
+  node->max_states = max_states;
+  data_ = std::move(node);
+}
+
+void PreloadSimilarStatesNode::Callback(SearchPolicyNode* policy) {
+  CHECK(policy->IsInstance<SketchPolicyNode>());
+  auto sketch_policy = dynamic_cast<SketchPolicyNode*>(policy);
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  std::tie(inputs, results) = sketch_policy->PreloadSimilarStates(filename, max_states);
+  if (!inputs.empty()) {
+    sketch_policy->program_cost_model->Update(inputs, results);
+  }
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.SketchPolicy")
     .set_body_typed([](SearchTask task, CostModel program_cost_model, Map<String, ObjectRef> params,
                        int seed, int verbose,
@@ -724,5 +801,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.PreloadCustomSketchRule")
       return PreloadCustomSketchRule(meet_condition_func, apply_func, rule_name);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.PreloadSimilarStates")
+    .set_body_typed([](String filename, int max_states) {
+      return PreloadSimilarStates(filename, max_states);
+    });
+
 }  // namespace auto_scheduler
 }  // namespace tvm
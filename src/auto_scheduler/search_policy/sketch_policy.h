@@ -70,6 +70,8 @@ struct SketchParamKey {
     static constexpr const char* num_iters = "evolutionary_search_num_iters";
     /*! \brief The mutation probability.*/
     static constexpr const char* mutation_prob = "evolutionary_search_mutation_prob";
+    /*! \brief The number of states mutated before being sent to the cost model at once.*/
+    static constexpr const char* predict_batch_size = "evolutionary_search_predict_batch_size";
   };
 
   struct MultiLevelTiling {
@@ -231,6 +233,41 @@ class PreloadCustomSketchRule : public SearchCallback {
                                         PreloadCustomSketchRuleNode);
 };
 
+/*!
+ * \brief Pre-search callback function to warm start the search with the records of similar
+ *  workloads. The adapted states join the initial population of the evolutionary search and
+ *  the cost model is updated with them.
+ */
+class PreloadSimilarStatesNode : public SearchCallbackNode {
+ public:
+  /*! \brief The name of the record log file. */
+  String filename;
+  /*! \brief The maximum number of states to load. */
+  int max_states;
+
+  void Callback(SearchPolicyNode* policy) final;
+
+  static constexpr const char* _type_key = "auto_scheduler.PreloadSimilarStates";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PreloadSimilarStatesNode, SearchCallbackNode);
+};
+
+/*!
+ * \brief Managed reference to PreloadSimilarStatesNode.
+ * \sa PreloadSimilarStatesNode
+ */
+class PreloadSimilarStates : public SearchCallback {
+ public:
+  /*!
+   * \brief The constructor.
+   * \param filename The name of the record log file.
+   * \param max_states The maximum number of states to load.
+   */
+  PreloadSimilarStates(String filename, int max_states);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PreloadSimilarStates, SearchCallback,
+                                        PreloadSimilarStatesNode);
+};
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <condition_variable>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
@@ -663,7 +664,8 @@ inline void PrintTitle(const std::string& title, int verbose) {
 
 /*!
  * \brief Enumerate all possible factorization schemes for splitting an axes.
- * \note This class will memorize the results for reuse.
+ * \note This class will memorize the results for reuse. It can be queried from several threads,
+ *  the returned references stay valid.
  */
 class SplitFactorizationMemo {
  public:
@@ -675,7 +677,9 @@ class SplitFactorizationMemo {
 
  private:
   void DfsEnumerate(int now, int remaining_length, int max_innermost_factor);
+  const std::vector<int>& GetFactorsInternal(int n);
 
+  std::mutex mutex_;
   std::unordered_map<QueryKey, Array<Array<Integer>>> memory_;
 
   int n_lengths_;
@@ -705,6 +709,9 @@ State DoMultiLevelTiling(const State& state, int stage_id, const std::string& fo
 State FollowTiling(const State& state, int stage_id, const std::vector<int>& split_step_ids,
                    int n_split);
 
+// Return whether a state has nested parallel, which is invalid on CPUs
+bool HasNestedParallel(const State& state);
+
 // Prune invalid states and return the results in-place.
 void PruneInvalidState(const SearchTask& task, Array<State>* states);
 
@@ -0,0 +1,412 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_scheduler/task_scheduler.cc
+ * \brief The task scheduler that allocates the measurement trials among tasks.
+ */
+
+#include <tvm/auto_scheduler/measure_record.h>
+#include <tvm/auto_scheduler/task_scheduler.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/te/operation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+namespace tvm {
+namespace auto_scheduler {
+
+TVM_REGISTER_NODE_TYPE(TaskSchedulerNode);
+
+/*! \brief The cost of the tasks without a valid measurement. */
+static constexpr double kInitCost = 1e10;
+
+/*! \brief The key identifying the tasks of the same workload and target. */
+static std::string TaskKey(const SearchTask& task) {
+  return task->workload_key + "|" + task->target->str();
+}
+
+std::string DeriveSimilarityTag(const ComputeDAG& dag, double log_base) {
+  std::string ret;
+  for (const auto& op : dag->ops) {
+    auto it = op->attrs.find("auto_scheduler_task_scheduler_tag");
+    if (it == op->attrs.end()) {
+      continue;
+    }
+    std::string tag = Downcast<String>((*it).second);
+    if (!tag.empty()) {
+      ret += tag + "_";
+    }
+  }
+  if (!ret.empty()) {
+    ret += std::to_string(static_cast<int>(std::log(dag->flop_ct + 1) / std::log(log_base)));
+  }
+  return ret;
+}
+
+TaskScheduler::TaskScheduler(Array<SearchTask> tasks, Array<FloatImm> task_weights,
+                             PackedFunc objective_func, String strategy, double alpha,
+                             double beta, int backward_window_size) {
+  ICHECK(!tasks.empty()) << "No tasks";
+  ICHECK(task_weights.empty() || task_weights.size() == tasks.size())
+      << "Expect one weight per task, got " << task_weights.size() << " for " << tasks.size()
+      << " tasks";
+  ICHECK(strategy == "round-robin" || strategy == "gradient") << "Invalid strategy: " << strategy;
+  auto node = make_object<TaskSchedulerNode>();
+  node->objective_func = objective_func;
+  node->strategy = strategy;
+  node->alpha = alpha;
+  node->beta = beta;
+  node->backward_window_size = backward_window_size;
+
+  // The tasks of the same workload and target, e.g. from different models, are tuned once and
+  // weighted by the number of times they are called in all of them.
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    double weight = task_weights.empty() ? 1.0 : task_weights[i]->value;
+    auto res = node->task_index_.emplace(TaskKey(tasks[i]), node->tasks.size());
+    if (res.second) {
+      node->tasks.push_back(tasks[i]);
+      node->task_weights.push_back(weight);
+    } else {
+      node->task_weights[res.first->second] += weight;
+    }
+  }
+
+  size_t num_tasks = node->tasks.size();
+  node->task_cts.assign(num_tasks, 0);
+  node->task_best_cts.assign(num_tasks, 0);
+  node->task_costs_history.assign(num_tasks, {});
+  node->best_costs.assign(num_tasks, kInitCost);
+
+  // Build the similarity groups
+  for (size_t i = 0; i < num_tasks; ++i) {
+    std::string tag = DeriveSimilarityTag(node->tasks[i]->compute_dag);
+    node->task_tags_.push_back(tag);
+    if (!tag.empty()) {
+      node->group_task_ids_[tag].push_back(i);
+    }
+  }
+
+  node->cur_score = node->ComputeScore(node->best_costs);
+  data_ = std::move(node);
+}
+
+int TaskSchedulerNode::TaskIndex(const SearchTask& task) const {
+  auto it = task_index_.find(TaskKey(task));
+  return it == task_index_.end() ? -1 : it->second;
+}
+
+double TaskSchedulerNode::ComputeScore(const std::vector<double>& costs) const {
+  if (objective_func != nullptr) {
+    Array<FloatImm> args;
+    for (double cost : costs) {
+      args.push_back(FloatImm(DataType::Float(64), cost));
+    }
+    return objective_func(args);
+  }
+  double score = 0;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    score += task_weights[i] * costs[i];
+  }
+  return score;
+}
+
+void TaskSchedulerNode::Prepare(int num_measure_trials, int num_measures_per_round,
+                                int early_stopping_all, int early_stopping_task, int verbose) {
+  ICHECK_GT(num_measures_per_round, 0);
+  this->num_measure_trials = num_measure_trials;
+  this->num_measures_per_round = num_measures_per_round;
+  this->early_stopping_all =
+      early_stopping_all < 0 ? std::numeric_limits<int>::max() : early_stopping_all;
+  this->early_stopping_task =
+      early_stopping_task < 0 ? std::numeric_limits<int>::max() : early_stopping_task;
+  this->verbose = verbose;
+  ct = best_ct = 0;
+  cur_score = best_score = ComputeScore(best_costs);
+  warmed_up_ = stopped_ = false;
+  rr_task_idx_ = -1;
+}
+
+void TaskSchedulerNode::RestoreStatus(const String& log_file) {
+  RecordReader reader = RecordReader(log_file);
+  const auto& res = reader->ReadLines(-1);
+  ICHECK_EQ(res.first.size(), res.second.size());
+  for (size_t i = 0; i < res.first.size(); ++i) {
+    int task_idx = TaskIndex(res.first[i]->task);
+    if (task_idx < 0) {
+      continue;
+    }
+    task_cts[task_idx]++;
+    if (res.second[i]->error_no == 0) {
+      double cost = FloatArrayMean(res.second[i]->costs);
+      if (cost < best_costs[task_idx]) {
+        best_costs[task_idx] = cost;
+        task_best_cts[task_idx] = task_cts[task_idx];
+      }
+    }
+  }
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (task_cts[i] - task_best_cts[i] > early_stopping_task) {
+      dead_tasks.insert(i);
+    }
+    // The records are counted in trials, the rounds are estimated from them. The estimation may
+    // not be accurate if the log file is changed externally or `num_measures_per_round` is
+    // different from the last tuning.
+    task_cts[i] = static_cast<int>(task_cts[i] * 1.0 / num_measures_per_round + 0.5);
+    task_best_cts[i] = static_cast<int>(task_best_cts[i] * 1.0 / num_measures_per_round + 0.5);
+    task_costs_history[i].push_back(best_costs[i]);
+  }
+
+  cur_score = best_score = ComputeScore(best_costs);
+  StdCout(verbose) << "TaskScheduler: Loaded " << res.first.size()
+                   << " measurement records from " << log_file << std::endl;
+}
+
+double TaskSchedulerNode::Gradient(int task_idx) const {
+  // compute gradient from chain rule : (delta f / delta g_i)
+  const double delta = 1e-4;
+  std::vector<double> new_costs = best_costs;
+  new_costs[task_idx] -= delta;
+  double chain_grad = (ComputeScore(best_costs) - ComputeScore(new_costs)) / delta;
+
+  // compute (g_i(t_i) - g(t_i - \Delta t)) / (\Delta t)
+  const std::vector<double>& history = task_costs_history[task_idx];
+  int cur_ct = task_cts[task_idx] - 1;
+  double backward_grad = 0;
+  if (cur_ct < static_cast<int>(history.size()) && cur_ct - backward_window_size >= 0) {
+    backward_grad =
+        (history[cur_ct] - history[cur_ct - backward_window_size]) / backward_window_size;
+  }
+
+  // compute (g_i(t_i + \Delta t) - g(t_i)) / (\Delta t)
+  double g_next_1 = best_costs[task_idx] - best_costs[task_idx] / task_cts[task_idx];
+  double g_next_2 = beta * 1e30;
+  const std::string& tag = task_tags_[task_idx];
+  if (!tag.empty() && group_task_ids_.at(tag).size() > 1) {
+    double best_flops = 0;
+    for (int j : group_task_ids_.at(tag)) {
+      best_flops = std::max(best_flops, tasks[j]->compute_dag->flop_ct / best_costs[j]);
+    }
+    g_next_2 = beta * tasks[task_idx]->compute_dag->flop_ct / best_flops;
+  }
+  double forward_grad = std::min(g_next_1, g_next_2) - best_costs[task_idx];
+
+  // combine all grads
+  return chain_grad * (alpha * backward_grad + (1 - alpha) * forward_grad);
+}
+
+int TaskSchedulerNode::NextTask() {
+  int num_tasks = tasks.size();
+  // do a round robin first to warm up, skipping the tasks restored from a log file
+  if (!warmed_up_) {
+    for (int i = 0; i < num_tasks; ++i) {
+      if (task_cts[i] == 0) {
+        return i;
+      }
+    }
+    warmed_up_ = true;
+    best_ct = ct;
+    best_score = cur_score;
+  }
+
+  if (stopped_ || ct >= num_measure_trials || static_cast<int>(dead_tasks.size()) >= num_tasks) {
+    return -1;
+  }
+
+  if (strategy == "round-robin") {
+    do {
+      rr_task_idx_ = (rr_task_idx_ + 1) % num_tasks;
+    } while (dead_tasks.count(rr_task_idx_));
+    return rr_task_idx_;
+  }
+
+  std::vector<double> gradients(num_tasks, 0);
+  for (int i = 0; i < num_tasks; ++i) {
+    if (!dead_tasks.count(i)) {
+      gradients[i] = Gradient(i);
+    }
+  }
+  auto minmax = std::minmax_element(gradients.begin(), gradients.end());
+  if (*minmax.first == *minmax.second) {
+    std::vector<int> alive;
+    for (int i = 0; i < num_tasks; ++i) {
+      if (!dead_tasks.count(i)) {
+        alive.push_back(i);
+      }
+    }
+    return alive[std::uniform_int_distribution<int>(0, alive.size() - 1)(rand_gen_)];
+  }
+  return minmax.first - gradients.begin();
+}
+
+void TaskSchedulerNode::Update(int task_idx, const Array<MeasureInput>& inputs,
+                               const Array<MeasureResult>& results) {
+  ICHECK(task_idx >= 0 && task_idx < static_cast<int>(tasks.size()));
+  task_cts[task_idx]++;
+  for (const auto& res : results) {
+    double cost = FloatArrayMean(res->costs);
+    if (cost < best_costs[task_idx]) {
+      task_best_cts[task_idx] = task_cts[task_idx];
+      best_costs[task_idx] = cost;
+    }
+  }
+
+  // Stop tuning this task in the rest of the process if its search space has been
+  // fully explored or it has no improvement for a long while.
+  int64_t no_change_trials =
+      static_cast<int64_t>(task_cts[task_idx] - task_best_cts[task_idx]) * num_measures_per_round;
+  if (inputs.empty() || no_change_trials > early_stopping_task) {
+    dead_tasks.insert(task_idx);
+  }
+
+  task_costs_history[task_idx].push_back(best_costs[task_idx]);
+  ct += inputs.size();
+  cur_score = ComputeScore(best_costs);
+
+  if (!warmed_up_) {
+    return;
+  }
+  AdjustSimilarityGroup(task_idx);
+  if (cur_score < best_score) {
+    best_score = cur_score;
+    best_ct = ct;
+  } else if (ct - best_ct >= early_stopping_all &&
+             std::all_of(best_costs.begin(), best_costs.end(),
+                         [](double cost) { return cost < 1e9; })) {
+    StdCout(verbose) << "Stop early since no performance improvement in the last "
+                     << early_stopping_all << " measurement trials." << std::endl;
+    stopped_ = true;
+  }
+}
+
+void TaskSchedulerNode::AdjustSimilarityGroup(int task_idx) {
+  const std::string tag = task_tags_[task_idx];
+  if (tag.empty() || group_task_ids_.at(tag).size() <= 1) {
+    return;
+  }
+  std::vector<int>* group_ids = &group_task_ids_.at(tag);
+  double best_group_flops = 0;
+  int max_other_ct = 0;
+  for (int j : *group_ids) {
+    best_group_flops = std::max(best_group_flops, tasks[j]->compute_dag->flop_ct / best_costs[j]);
+    if (j != task_idx) {
+      max_other_ct = std::max(max_other_ct, task_cts[j]);
+    }
+  }
+  double cur_flops = tasks[task_idx]->compute_dag->flop_ct / best_costs[task_idx];
+
+  // if we tune a task for many times but it still cannot achieve
+  // a similar speed to the fastest one in its group, this means this task
+  // is actually not similar to other tasks in its group.
+  // So we will remove it from its original group.
+  if (cur_flops < best_group_flops / beta && task_cts[task_idx] > 5 + max_other_ct) {
+    task_tags_[task_idx].clear();
+    group_ids->erase(std::find(group_ids->begin(), group_ids->end(), task_idx));
+  }
+}
+
+void TaskSchedulerNode::Tune(const Array<SearchPolicy>& search_policies,
+                             ProgramMeasurer measurer) {
+  ICHECK_EQ(search_policies.size(), tasks.size()) << "Expect one search policy per task";
+  for (int task_idx = NextTask(); task_idx >= 0; task_idx = NextTask()) {
+    Array<MeasureInput> inputs;
+    Array<MeasureResult> results;
+    std::tie(inputs, results) =
+        search_policies[task_idx]->ContinueSearchOneRound(num_measures_per_round, measurer);
+    Update(task_idx, inputs, results);
+  }
+}
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskScheduler")
+    .set_body_typed([](Array<SearchTask> tasks, Array<FloatImm> task_weights,
+                       PackedFunc objective_func, String strategy, double alpha, double beta,
+                       int backward_window_size) {
+      return TaskScheduler(tasks, task_weights, objective_func, strategy, alpha, beta,
+                           backward_window_size);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerPrepare")
+    .set_body_typed([](TaskScheduler scheduler, int num_measure_trials, int num_measures_per_round,
+                       int early_stopping_all, int early_stopping_task, int verbose) {
+      scheduler->Prepare(num_measure_trials, num_measures_per_round, early_stopping_all,
+                         early_stopping_task, verbose);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerRestoreStatus")
+    .set_body_typed([](TaskScheduler scheduler, const String& log_file) {
+      scheduler->RestoreStatus(log_file);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerNextTask")
+    .set_body_typed([](TaskScheduler scheduler) { return scheduler->NextTask(); });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerUpdate")
+    .set_body_typed([](TaskScheduler scheduler, int task_idx, Array<MeasureInput> inputs,
+                       Array<MeasureResult> results) {
+      scheduler->Update(task_idx, inputs, results);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerTune")
+    .set_body_typed([](TaskScheduler scheduler, Array<SearchPolicy> search_policies,
+                       ProgramMeasurer measurer) { scheduler->Tune(search_policies, measurer); });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerTaskIndex")
+    .set_body_typed([](TaskScheduler scheduler, SearchTask task) {
+      return scheduler->TaskIndex(task);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerGetStatus")
+    .set_body_typed([](TaskScheduler scheduler) {
+      Array<FloatImm> weights, best_costs;
+      Array<Integer> task_cts, dead_tasks;
+      for (size_t i = 0; i < scheduler->tasks.size(); ++i) {
+        weights.push_back(FloatImm(DataType::Float(64), scheduler->task_weights[i]));
+        best_costs.push_back(FloatImm(DataType::Float(64), scheduler->best_costs[i]));
+        task_cts.push_back(scheduler->task_cts[i]);
+        if (scheduler->dead_tasks.count(i)) {
+          dead_tasks.push_back(static_cast<int>(i));
+        }
+      }
+      return Array<ObjectRef>{weights, best_costs, task_cts, dead_tasks};
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.TaskSchedulerSetBestCosts")
+    .set_body_typed([](TaskScheduler scheduler, Array<FloatImm> best_costs) {
+      ICHECK_EQ(best_costs.size(), scheduler->tasks.size());
+      for (size_t i = 0; i < best_costs.size(); ++i) {
+        scheduler->best_costs[i] = best_costs[i]->value;
+      }
+      scheduler->cur_score = scheduler->ComputeScore(scheduler->best_costs);
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.DeriveSimilarityTag")
+    .set_body_typed([](ComputeDAG dag, double log_base) {
+      return String(DeriveSimilarityTag(dag, log_base));
+    });
+
+}  // namespace auto_scheduler
+}  // namespace tvm
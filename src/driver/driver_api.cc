@@ -33,6 +33,8 @@
 #include <algorithm>
 #include <mutex>
 #include <stack>
+#include <string>
+#include <unordered_set>
 
 namespace tvm {
 
@@ -42,6 +44,11 @@ TVM_REGISTER_PASS_CONFIG_OPTION("tir.detect_global_barrier", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.instrument_bound_checkers", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_assert", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_vectorize", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_shared_memory_padding", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_software_prefetch", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_auto_tile", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.enable_loop_invariant_code_motion", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.disable_cse", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("tir.add_lower_pass", Array<Array<ObjectRef>>);
 
 using runtime::PackedFunc;
@@ -167,10 +174,18 @@ transform::Pass Filter(FCond fcond) {
   return tir::transform::CreatePrimFuncPass(fpass, 0, "Filter", {});
 }
 
+/*! \brief Whether the target is generated as C-like source, with no CSE run by its compiler */
+bool IsCSourceTarget(const Target& target) {
+  static const std::unordered_set<std::string> kinds = {"c", "cuda", "opencl", "metal"};
+  return kinds.count(target->kind->name);
+}
+
 Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for_te_schedule) {
   transform::PassContext pass_ctx = transform::PassContext::Current();
 
   bool disable_vectorize = pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+  bool disable_shared_memory_padding =
+      pass_ctx->GetConfig<Bool>("tir.disable_shared_memory_padding", Bool(false)).value();
   bool instrument_bound_checkers =
       pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
 
@@ -216,6 +231,9 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for
   // PHASE 1
   if (for_te_schedule) {
     pass_list.push_back(tir::transform::InjectPrefetch());
+    if (!disable_shared_memory_padding) {
+      pass_list.push_back(tir::transform::PadSharedMemory());
+    }
     pass_list.push_back(tir::transform::StorageFlatten(64, instrument_bound_checkers));
   } else {
     pass_list.push_back(tir::transform::LowerInitBlock());
@@ -250,6 +268,9 @@ Array<tvm::transform::Pass> CreatePassList(bool disable_loop_partition, bool for
   pass_list.push_back(tir::transform::RemoveNoOp());
   pass_list.push_back(tir::transform::RewriteUnsafeSelect());
   pass_list.push_back(tir::transform::HoistIfThenElse());
+  if (pass_ctx->GetConfig<Bool>("tir.enable_loop_invariant_code_motion", Bool(false)).value()) {
+    pass_list.push_back(tir::transform::LoopInvariantCodeMotion());
+  }
 
   // Add user-defined phase-3 passes
   pass_list.insert(pass_list.end(), user_lower_phase3.begin(), user_lower_phase3.end());
@@ -374,8 +395,17 @@ std::pair<IRModule, IRModule> SplitDevHostFuncs(IRModule mod_mixed, const Target
                                                 const transform::PassContext& pass_ctx) {
   Target target = target_arg, target_host = target_host_arg;
   CheckAndUpdateHostConsistency(&target, &target_host);
-  Array<tvm::transform::Pass> mixed_pass_list = {BindTarget(target),
-                                                 tir::transform::VerifyMemory()};
+  bool disable_cse = pass_ctx->GetConfig<Bool>("tir.disable_cse", Bool(false)).value();
+  Array<tvm::transform::Pass> mixed_pass_list = {BindTarget(target)};
+  if (pass_ctx->GetConfig<Bool>("tir.enable_auto_tile", Bool(false)).value()) {
+    bool disable_vectorize =
+        pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+    mixed_pass_list.push_back(tir::transform::AutoTile());
+    mixed_pass_list.push_back(tir::transform::VectorizeLoop(!disable_vectorize));
+    mixed_pass_list.push_back(tir::transform::Simplify());
+  }
+  mixed_pass_list.push_back(tir::transform::VerifyMemory());
+  mixed_pass_list.push_back(tir::transform::HorizontalFuseKernels());
 
   if (pass_ctx->GetConfig<Bool>("tir.detect_global_barrier", Bool(false)).value()) {
     mixed_pass_list.push_back(tir::transform::ThreadSync("global"));
@@ -396,24 +426,29 @@ std::pair<IRModule, IRModule> SplitDevHostFuncs(IRModule mod_mixed, const Target
   auto opt_mixed = transform::Sequential(mixed_pass_list);
   mod_mixed = opt_mixed(std::move(mod_mixed));
 
-  auto host_pass_list = {
+  Array<tvm::transform::Pass> host_pass_list = {
       Filter([](const tir::PrimFunc& f) {
         return f->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault)) !=
                CallingConv::kDeviceKernelLaunch;
       }),
-      BindTarget(target_host),
-      tir::transform::LowerTVMBuiltin(),
-      tir::transform::LowerCustomDatatypes(),
-      tir::transform::LowerIntrin(),
-      tir::transform::LowerDeviceStorageAccessInfo(),
-      tir::transform::CombineContextCall(),
-  };
+      BindTarget(target_host)};
+  if (pass_ctx->GetConfig<Bool>("tir.enable_software_prefetch", Bool(false)).value()) {
+    host_pass_list.push_back(tir::transform::InjectSoftwarePrefetch());
+  }
+  host_pass_list.push_back(tir::transform::LowerTVMBuiltin());
+  host_pass_list.push_back(tir::transform::LowerCustomDatatypes());
+  host_pass_list.push_back(tir::transform::LowerIntrin());
+  host_pass_list.push_back(tir::transform::LowerDeviceStorageAccessInfo());
+  host_pass_list.push_back(tir::transform::CombineContextCall());
+  if (!disable_cse && IsCSourceTarget(target_host)) {
+    host_pass_list.push_back(tir::transform::CommonSubexprElim());
+  }
   auto opt_host = transform::Sequential(host_pass_list);
   ICHECK(mod_mixed.defined()) << "This module must be defined";
   auto mhost = opt_host(mod_mixed);
 
   // device pipeline
-  auto device_pass_list = {
+  Array<tvm::transform::Pass> device_pass_list = {
       Filter([](const tir::PrimFunc& f) {
         return f->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault)) ==
                CallingConv::kDeviceKernelLaunch;
@@ -425,6 +460,9 @@ std::pair<IRModule, IRModule> SplitDevHostFuncs(IRModule mod_mixed, const Target
       tir::transform::LowerIntrin(),
       tir::transform::LowerDeviceStorageAccessInfo(),
   };
+  if (!disable_cse && IsCSourceTarget(target)) {
+    device_pass_list.push_back(tir::transform::CommonSubexprElim());
+  }
   auto opt_device = transform::Sequential(device_pass_list);
   auto mdevice = opt_device(mod_mixed);
 
@@ -24,6 +24,7 @@
 #include <tvm/ir/diagnostic.h>
 #include <tvm/parser/source_map.h>
 
+#include <mutex>
 #include <rang.hpp>
 
 namespace tvm {
@@ -88,7 +89,14 @@ TVM_REGISTER_GLOBAL("diagnostics.DiagnosticRenderer")
 /* Diagnostic Context */
 TVM_REGISTER_NODE_TYPE(DiagnosticContextNode);
 
+/*!
+ * \brief Guards the diagnostics of the contexts emitted to by the functions a pass optimizes in
+ * parallel.
+ */
+static std::recursive_mutex diagnostics_mutex;
+
 void DiagnosticContext::Render() {
+  std::lock_guard<std::recursive_mutex> lock(diagnostics_mutex);
   (*this)->renderer.Render(*this);
 
   int errs = 0;
@@ -127,6 +135,7 @@ TVM_REGISTER_GLOBAL("diagnostics.DiagnosticContext")
 
 /*! \brief Emit a diagnostic. */
 void DiagnosticContext::Emit(const Diagnostic& diagnostic) {
+  std::lock_guard<std::recursive_mutex> lock(diagnostics_mutex);
   (*this)->diagnostics.push_back(diagnostic);
 }
 
@@ -25,9 +25,29 @@
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
 #include <stack>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../support/str_escape.h"
 
 namespace tvm {
 namespace instrument {
@@ -337,5 +357,339 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+/*!
+ * \brief Count the distinct IR nodes reachable from an object, following the fields visited by
+ *  the structural hash, and without recursion. The containers and strings are not counted.
+ */
+class IRNodeCounter : public SHashReducer::Handler {
+ public:
+  static int64_t Count(const ObjectRef& root) {
+    IRNodeCounter counter;
+    try {
+      counter.SHashReduce(root, false);
+      while (!counter.stack_.empty()) {
+        ObjectRef object = counter.stack_.back();
+        counter.stack_.pop_back();
+        ReflectionVTable::Global()->SHashReduce(object.get(), SHashReducer(&counter, false));
+      }
+    } catch (const Error& e) {
+      // Some objects, e.g. the runtime modules, are not structurally hashable.
+      return -1;
+    }
+    return counter.count_;
+  }
+
+  void SHashReduceHashedValue(size_t hashed_value) final {}
+
+  void SHashReduce(const ObjectRef& key, bool map_free_vars) final {
+    if (!key.defined() || !visited_.insert(key.get()).second) return;
+    if (!key->IsInstance<runtime::ArrayNode>() && !key->IsInstance<runtime::MapNode>() &&
+        !key->IsInstance<runtime::StringObj>()) {
+      ++count_;
+    }
+    stack_.push_back(key);
+  }
+
+  void SHashReduceFreeVar(const runtime::Object* var, bool map_free_vars) final {
+    if (visited_.insert(var).second) ++count_;
+  }
+
+  bool LookupHashedValue(const ObjectRef& key, size_t* hashed_value) final { return false; }
+
+  void MarkGraphNode() final {}
+
+ private:
+  std::unordered_set<const Object*> visited_;
+  std::vector<ObjectRef> stack_;
+  int64_t count_{0};
+};
+
+/*!
+ * \brief Get the memory usage of the process.
+ * \param current_kb The current resident set size in KB, or -1 if unknown.
+ * \param peak_kb The peak resident set size in KB, or -1 if unknown.
+ */
+void GetResidentSetSize(int64_t* current_kb, int64_t* peak_kb) {
+  *current_kb = -1;
+  *peak_kb = -1;
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    *peak_kb = static_cast<int64_t>(usage.ru_maxrss) / 1024;
+#else
+    *peak_kb = static_cast<int64_t>(usage.ru_maxrss);
+#endif
+  }
+#endif
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  int64_t size_pages, resident_pages;
+  if (statm >> size_pages >> resident_pages) {
+    *current_kb = resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+  }
+#endif
+}
+
+/*!
+ * \brief A pass instrument profiling the wall time, the memory and the IR size of each pass.
+ *
+ *  The passes are recorded with their nesting, per thread, from the outermost pass context the
+ *  profiler is entered in. The records are kept after the context exits, until it is entered
+ *  again.
+ */
+class PassProfilerNode : public PassInstrumentNode {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /*! \brief The profile of one run of a pass */
+  struct Record {
+    /*! \brief The name of the pass */
+    String name;
+    /*! \brief The index of the thread the pass runs on, in the order the threads are seen */
+    int thread;
+    /*! \brief The index of the record of the enclosing pass on the thread, or -1 */
+    int64_t parent;
+    /*! \brief The nesting depth of the pass on the thread */
+    int depth;
+    /*! \brief The time the pass starts, since the profiler is entered, in microseconds */
+    double start_us;
+    /*! \brief The wall time of the pass in microseconds, or -1 if it did not finish */
+    double duration_us{-1};
+    /*! \brief The resident set size before the pass in KB, or -1 if unknown */
+    int64_t rss_before_kb;
+    /*! \brief The resident set size after the pass in KB, or -1 if unknown */
+    int64_t rss_after_kb{-1};
+    /*! \brief The increase of the peak resident set size of the process during the pass in KB */
+    int64_t peak_rss_increase_kb{0};
+    /*! \brief The peak resident set size before the pass in KB, or -1 if unknown */
+    int64_t peak_rss_before_kb;
+    /*! \brief The number of IR nodes of the module before the pass, or -1 if not counted */
+    int64_t nodes_before;
+    /*! \brief The number of IR nodes of the module after the pass, or -1 if not counted */
+    int64_t nodes_after{-1};
+  };
+
+  /*! \brief Whether to count the IR nodes of the module before and after each pass */
+  bool count_nodes{true};
+
+  void VisitAttrs(AttrVisitor* v) {
+    PassInstrumentNode::VisitAttrs(v);
+    v->Visit("count_nodes", &count_nodes);
+  }
+
+  void EnterPassContext() const final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (context_depth_++ == 0) {
+      records_.clear();
+      stacks_.clear();
+      threads_.clear();
+      origin_ = Clock::now();
+    }
+  }
+
+  void ExitPassContext() const final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --context_depth_;
+  }
+
+  bool ShouldRun(const IRModule& mod, const transform::PassInfo& info) const final { return true; }
+
+  void RunBeforePass(const IRModule& mod, const transform::PassInfo& info) const final {
+    Record record;
+    record.name = info->name;
+    record.nodes_before = count_nodes ? IRNodeCounter::Count(mod) : -1;
+    GetResidentSetSize(&record.rss_before_kb, &record.peak_rss_before_kb);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto thread = threads_.emplace(std::this_thread::get_id(), threads_.size()).first;
+    std::vector<int64_t>& stack = stacks_[std::this_thread::get_id()];
+    record.thread = static_cast<int>(thread->second);
+    record.parent = stack.empty() ? -1 : stack.back();
+    record.depth = static_cast<int>(stack.size());
+    record.start_us = std::chrono::duration<double, std::micro>(Clock::now() - origin_).count();
+    stack.push_back(static_cast<int64_t>(records_.size()));
+    records_.push_back(record);
+  }
+
+  void RunAfterPass(const IRModule& mod, const transform::PassInfo& info) const final {
+    auto end = Clock::now();
+    int64_t nodes_after = count_nodes ? IRNodeCounter::Count(mod) : -1;
+    int64_t rss_kb, peak_rss_kb;
+    GetResidentSetSize(&rss_kb, &peak_rss_kb);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int64_t>& stack = stacks_[std::this_thread::get_id()];
+    // A pass that threw left its record open, it is closed by its enclosing pass.
+    while (!stack.empty() && records_[stack.back()].name != info->name) {
+      stack.pop_back();
+    }
+    if (stack.empty()) return;
+    Record& record = records_[stack.back()];
+    stack.pop_back();
+    record.duration_us =
+        std::chrono::duration<double, std::micro>(end - origin_).count() - record.start_us;
+    record.rss_after_kb = rss_kb;
+    if (peak_rss_kb >= 0 && record.peak_rss_before_kb >= 0) {
+      record.peak_rss_increase_kb = peak_rss_kb - record.peak_rss_before_kb;
+    }
+    record.nodes_after = nodes_after;
+  }
+
+  /*! \return The records, in the order the passes are entered */
+  std::vector<Record> GetRecords() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+  }
+
+  /*! \brief Render the profile as a table, the passes nested under their callers */
+  String Render() const;
+
+  /*! \brief Render the profile in the Chrome trace event format */
+  String ChromeTrace() const;
+
+  static constexpr const char* _type_key = "instrument.PassProfiler";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PassProfilerNode, PassInstrumentNode);
+
+ private:
+  mutable std::mutex mutex_;
+  mutable int context_depth_{0};
+  mutable Clock::time_point origin_{Clock::now()};
+  mutable std::vector<Record> records_;
+  mutable std::unordered_map<std::thread::id, std::vector<int64_t>> stacks_;
+  mutable std::unordered_map<std::thread::id, size_t> threads_;
+};
+
+/*!
+ * \brief Managed reference class for PassProfilerNode
+ * \sa PassProfilerNode
+ */
+class PassProfiler : public PassInstrument {
+ public:
+  /*!
+   * \brief Constructor
+   * \param count_nodes Whether to count the IR nodes of the module before and after each pass
+   */
+  explicit PassProfiler(bool count_nodes) {
+    auto n = make_object<PassProfilerNode>();
+    n->name = "PassProfiler";
+    n->count_nodes = count_nodes;
+    data_ = std::move(n);
+  }
+  TVM_DEFINE_OBJECT_REF_METHODS(PassProfiler, PassInstrument, PassProfilerNode);
+};
+
+String PassProfilerNode::Render() const {
+  std::vector<Record> records = GetRecords();
+  // The time spent in each pass itself, excluding the passes it calls.
+  std::vector<double> self_us(records.size());
+  double total_us = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    self_us[i] += std::max(records[i].duration_us, 0.0);
+    if (records[i].parent >= 0) {
+      self_us[records[i].parent] -= std::max(records[i].duration_us, 0.0);
+    } else {
+      total_us += std::max(records[i].duration_us, 0.0);
+    }
+  }
+  auto fmt_kb = [](int64_t kb) -> std::string {
+    if (kb < 0) return "-";
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << kb / 1024.0;
+    return os.str();
+  };
+  auto fmt_nodes = [](int64_t before, int64_t after) -> std::string {
+    if (before < 0 || after < 0) return "-";
+    return std::to_string(before) + " -> " + std::to_string(after);
+  };
+
+  std::ostringstream os;
+  os << std::fixed;
+  os << std::left << std::setw(56) << "Pass" << std::right << std::setw(12) << "Time(ms)"
+     << std::setw(12) << "Self(ms)" << std::setw(9) << "Total%" << std::setw(10) << "RSS(MB)"
+     << std::setw(12) << "PeakRSS+MB" << std::setw(24) << "Nodes" << "\n";
+  int num_threads = 0;
+  for (const Record& record : records) {
+    num_threads = std::max(num_threads, record.thread + 1);
+  }
+  for (int thread = 0; thread < num_threads; ++thread) {
+    if (num_threads > 1) {
+      os << "[thread " << thread << "]\n";
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+      const Record& record = records[i];
+      if (record.thread != thread) continue;
+      std::string name = std::string(record.depth * 2, ' ') + std::string(record.name);
+      double pct = total_us > 0 ? std::max(record.duration_us, 0.0) / total_us * 100.0 : 0.0;
+      os << std::left << std::setw(56) << name << std::right << std::setprecision(3)
+         << std::setw(12) << record.duration_us / 1000.0 << std::setw(12) << self_us[i] / 1000.0
+         << std::setprecision(2) << std::setw(9) << pct << std::setw(10)
+         << fmt_kb(record.rss_after_kb) << std::setw(12) << fmt_kb(record.peak_rss_increase_kb)
+         << std::setw(24) << fmt_nodes(record.nodes_before, record.nodes_after) << "\n";
+    }
+  }
+
+  // The passes by their total self time, to find the ones dominating the build.
+  std::unordered_map<std::string, std::tuple<int64_t, double, double>> totals;
+  for (size_t i = 0; i < records.size(); ++i) {
+    auto& total = totals[records[i].name];
+    ++std::get<0>(total);
+    std::get<1>(total) += std::max(records[i].duration_us, 0.0);
+    std::get<2>(total) += self_us[i];
+  }
+  std::vector<std::pair<std::string, std::tuple<int64_t, double, double>>> sorted(totals.begin(),
+                                                                                  totals.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return std::get<2>(lhs.second) > std::get<2>(rhs.second);
+  });
+  os << "\n"
+     << std::left << std::setw(56) << "Pass (by self time)" << std::right << std::setw(12)
+     << "Calls" << std::setw(12) << "Time(ms)" << std::setw(12) << "Self(ms)" << "\n";
+  for (const auto& kv : sorted) {
+    os << std::left << std::setw(56) << kv.first << std::right << std::setw(12)
+       << std::get<0>(kv.second) << std::setprecision(3) << std::setw(12)
+       << std::get<1>(kv.second) / 1000.0 << std::setw(12) << std::get<2>(kv.second) / 1000.0
+       << "\n";
+  }
+  return os.str();
+}
+
+String PassProfilerNode::ChromeTrace() const {
+  std::vector<Record> records = GetRecords();
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  for (const Record& record : records) {
+    if (record.duration_us < 0) continue;
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "  {\"name\": \"" << support::StrEscape(record.name) << "\", \"cat\": \"pass\""
+       << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << record.thread
+       << ", \"ts\": " << record.start_us << ", \"dur\": " << record.duration_us
+       << ", \"args\": {\"rss_kb\": " << record.rss_after_kb
+       << ", \"rss_delta_kb\": "
+       << (record.rss_after_kb >= 0 && record.rss_before_kb >= 0
+               ? record.rss_after_kb - record.rss_before_kb
+               : 0)
+       << ", \"peak_rss_increase_kb\": " << record.peak_rss_increase_kb
+       << ", \"nodes_before\": " << record.nodes_before
+       << ", \"nodes_after\": " << record.nodes_after << "}}";
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+TVM_REGISTER_NODE_TYPE(PassProfilerNode);
+
+TVM_REGISTER_GLOBAL("instrument.MakePassProfiler").set_body_typed([](bool count_nodes) {
+  return PassProfiler(count_nodes);
+});
+
+TVM_REGISTER_GLOBAL("instrument.PassProfilerRender").set_body_typed([](PassProfiler profiler) {
+  return profiler->Render();
+});
+
+TVM_REGISTER_GLOBAL("instrument.PassProfilerChromeTrace")
+    .set_body_typed([](PassProfiler profiler) { return profiler->ChromeTrace(); });
+
 }  // namespace instrument
 }  // namespace tvm
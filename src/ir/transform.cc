@@ -25,6 +25,7 @@
 #include <tvm/ir/transform.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/runtime/registry.h>
 
 #include <chrono>
@@ -41,6 +42,9 @@ using tvm::ReprPrinter;
 using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("transform.use_object_arena", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("transform.thread_confined_objects", Bool);
+
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
   PassContext default_context;
@@ -54,10 +58,21 @@ struct PassContextThreadLocalEntry {
 /*! \brief Thread local store to hold the pass context. */
 typedef dmlc::ThreadLocalStore<PassContextThreadLocalEntry> RelayPassContextThreadLocalStore;
 
-void PassContext::EnterWithScope() {
-  InstrumentEnterPassContext();
+// Whether a pass context shares the instruments of the enclosing one, e.g. the fresh context
+// the primitive functions are lowered in. Such a context stays in the instrumented scope of the
+// enclosing context: the instruments are not entered and exited again.
+static bool InheritsInstruments(const PassContextThreadLocalEntry* entry,
+                                const PassContext& pass_ctx) {
+  return !entry->context_stack.empty() && pass_ctx->instruments.defined() &&
+         entry->context_stack.top()->instruments.same_as(pass_ctx->instruments);
+}
 
+void PassContext::EnterWithScope() {
   PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
+  if (!InheritsInstruments(entry, *this)) {
+    InstrumentEnterPassContext();
+  }
+
   entry->context_stack.push(*this);
 }
 
@@ -67,7 +82,9 @@ void PassContext::ExitWithScope() {
   ICHECK(entry->context_stack.top().same_as(*this));
   entry->context_stack.pop();
 
-  InstrumentExitPassContext();
+  if (!InheritsInstruments(entry, *this)) {
+    InstrumentExitPassContext();
+  }
 }
 
 PassContext PassContext::Current() {
@@ -264,9 +281,21 @@ IRModule Pass::operator()(IRModule mod, const PassContext& pass_ctx) const {
                << " with opt level: " << pass_info->opt_level;
     return mod;
   }
-  auto ret = node->operator()(std::move(mod), pass_ctx);
+  IRModule ret;
+  bool use_object_arena =
+      pass_ctx->GetConfig<Bool>("transform.use_object_arena", Bool(false)).value();
+  // The objects the pass creates are only referenced from this thread until it returns.
+  bool thread_confined =
+      pass_ctx->GetConfig<Bool>("transform.thread_confined_objects", Bool(false)).value();
+  if (use_object_arena || thread_confined) {
+    // The objects the pass creates are allocated from an arena, including the ones it returns.
+    runtime::ObjectArenaScope arena_scope(thread_confined);
+    ret = node->operator()(std::move(mod), pass_ctx);
+  } else {
+    ret = node->operator()(std::move(mod), pass_ctx);
+  }
   pass_ctx.InstrumentAfterPass(ret, pass_info);
-  return std::move(ret);
+  return ret;
 }
 
 /*!
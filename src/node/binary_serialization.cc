@@ -0,0 +1,784 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file node/binary_serialization.cc
+ * \brief Compact binary serialization of TVM AST/IR objects.
+ *
+ *  The format is a stream of records in host byte order:
+ *
+ *  - The header: kTVMNodeBinaryMagic, kNodeBinaryVersion and the TVM version.
+ *  - The tensors: their count, then the dtype, shape and byte size of each
+ *    tensor followed by its data, aligned to kNodeBinaryAlignment bytes from
+ *    the start of the stream so that a mapped file can be used in place.
+ *  - The nodes: their count, then each node in post order, so that a node only
+ *    refers to the nodes before it. A node starts with the index of its type;
+ *    the first node of a type defines it with its type key, its layout and,
+ *    for reflected objects, the names and kinds of the fields in the order of
+ *    VisitAttrs. The values of the fields follow, without names.
+ *  - The index of the root node.
+ *
+ *  Fields are matched by name when loading, so objects saved by another version
+ *  load as long as the fields they have now were saved.
+ */
+#include <dmlc/io.h>
+#include <dmlc/memory_io.h>
+#include <tvm/node/reflection.h>
+#include <tvm/node/serialization.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/serializer.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../runtime/file_utils.h"
+#include "../runtime/object_internal.h"
+
+namespace tvm {
+
+constexpr uint64_t kTVMNodeBinaryMagic = 0xF7E58D4F05049CB9;
+constexpr uint64_t kNodeBinaryVersion = 1;
+/*! \brief Alignment of the tensor data from the start of the stream. */
+constexpr uint64_t kNodeBinaryAlignment = 64;
+/*! \brief The index of an undefined tensor. */
+constexpr uint64_t kUndefinedTensor = std::numeric_limits<uint64_t>::max();
+
+namespace {
+
+enum class FieldKind : uint8_t {
+  kDouble = 0,
+  kInt64 = 1,
+  kUInt64 = 2,
+  kInt = 3,
+  kBool = 4,
+  kString = 5,
+  kDataType = 6,
+  kNDArray = 7,
+  kObject = 8,
+};
+
+enum class NodeLayout : uint8_t {
+  /*! \brief An object with reflected fields. */
+  kFields = 0,
+  /*! \brief An object saved as its repr bytes. */
+  kRepr = 1,
+  kArray = 2,
+  kMap = 3,
+};
+
+/*! \brief Wrap a stream to count the bytes read or written, which gives the alignment. */
+class CountingStream : public dmlc::Stream {
+ public:
+  explicit CountingStream(dmlc::Stream* base, dmlc::SeekStream* seekable = nullptr)
+      : base_(base), seekable_(seekable) {}
+
+  size_t Read(void* ptr, size_t size) final {
+    size_t n = base_->Read(ptr, size);
+    count_ += n;
+    return n;
+  }
+
+  void Write(const void* ptr, size_t size) final {
+    base_->Write(ptr, size);
+    count_ += size;
+  }
+
+  /*! \brief Read and check a value. */
+  template <typename T>
+  void ReadChecked(T* value) {
+    dmlc::Stream* strm = this;
+    ICHECK(strm->Read(value)) << "LoadBinary: the data is truncated";
+  }
+
+  void Skip(size_t size) {
+    if (seekable_ != nullptr) {
+      seekable_->Seek(seekable_->Tell() + size);
+      count_ += size;
+      return;
+    }
+    char buf[4096];
+    while (size != 0) {
+      size_t n = std::min(size, sizeof(buf));
+      ICHECK_EQ(Read(buf, n), n) << "LoadBinary: the data is truncated";
+      size -= n;
+    }
+  }
+
+  /*! \brief The padding before the next aligned position. */
+  size_t Padding() const {
+    return (kNodeBinaryAlignment - count_ % kNodeBinaryAlignment) % kNodeBinaryAlignment;
+  }
+
+  size_t count() const { return count_; }
+
+ private:
+  dmlc::Stream* base_;
+  dmlc::SeekStream* seekable_;
+  size_t count_{0};
+};
+
+bool IsStrMap(const MapNode* map) {
+  return std::all_of(map->begin(), map->end(),
+                     [](const auto& kv) { return kv.first->template IsInstance<StringObj>(); });
+}
+
+/*!
+ * \brief Index the nodes in post order, so that the children of a node come before it.
+ *
+ *  The graph is walked with an explicit stack since IR graphs can be deeper than
+ *  the native stack allows.
+ */
+class BinaryNodeIndexer : public AttrVisitor {
+ public:
+  std::unordered_map<const Object*, uint64_t> node_index_{{nullptr, 0}};
+  std::vector<const Object*> node_list_{nullptr};
+  std::unordered_map<const DLTensor*, uint64_t> tensor_index_;
+  std::vector<runtime::NDArray> tensor_list_;
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {
+    if (!value->defined()) return;
+    const DLTensor* ptr = value->operator->();
+    if (tensor_index_.count(ptr)) return;
+    tensor_index_[ptr] = tensor_list_.size();
+    tensor_list_.push_back(*value);
+  }
+  void Visit(const char* key, ObjectRef* value) final { children_->push_back(value->get()); }
+
+  void Index(const Object* root) {
+    struct Frame {
+      const Object* node;
+      std::vector<const Object*> children;
+      size_t next{0};
+    };
+    std::unordered_set<const Object*> on_stack;
+    std::vector<Frame> stack;
+    auto push = [&](const Object* node) {
+      if (node_index_.count(node)) return;
+      ICHECK(!on_stack.count(node)) << "SaveBinary: cyclic reference detected";
+      on_stack.insert(node);
+      stack.emplace_back();
+      stack.back().node = node;
+      children_ = &stack.back().children;
+      CollectChildren(node);
+    };
+    push(root);
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      if (frame.next < frame.children.size()) {
+        // Caution: frame becomes invalid when the stack grows.
+        push(frame.children[frame.next++]);
+        continue;
+      }
+      node_index_[frame.node] = node_list_.size();
+      node_list_.push_back(frame.node);
+      on_stack.erase(frame.node);
+      stack.pop_back();
+    }
+  }
+
+ private:
+  void CollectChildren(const Object* node) {
+    if (node->IsInstance<ArrayNode>()) {
+      for (const ObjectRef& elem : *static_cast<const ArrayNode*>(node)) {
+        children_->push_back(elem.get());
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      const auto* map = static_cast<const MapNode*>(node);
+      // Maps with string keys only save the strings, like SaveJSON.
+      bool str_keys = IsStrMap(map);
+      for (const auto& kv : *map) {
+        if (!str_keys) children_->push_back(kv.first.get());
+        children_->push_back(kv.second.get());
+      }
+    } else if (!reflection_->GetReprBytes(node, nullptr)) {
+      reflection_->VisitAttrs(const_cast<Object*>(node), this);
+    }
+  }
+
+  std::vector<const Object*>* children_{nullptr};
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+};
+
+/*! \brief The names and kinds of the reflected fields of an object, in VisitAttrs order. */
+class FieldSchemaVisitor : public AttrVisitor {
+ public:
+  std::vector<std::pair<std::string, FieldKind>> fields;
+
+  void Visit(const char* key, double* value) final { Add(key, FieldKind::kDouble); }
+  void Visit(const char* key, int64_t* value) final { Add(key, FieldKind::kInt64); }
+  void Visit(const char* key, uint64_t* value) final { Add(key, FieldKind::kUInt64); }
+  void Visit(const char* key, int* value) final { Add(key, FieldKind::kInt); }
+  void Visit(const char* key, bool* value) final { Add(key, FieldKind::kBool); }
+  void Visit(const char* key, std::string* value) final { Add(key, FieldKind::kString); }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final { Add(key, FieldKind::kDataType); }
+  void Visit(const char* key, runtime::NDArray* value) final { Add(key, FieldKind::kNDArray); }
+  void Visit(const char* key, ObjectRef* value) final { Add(key, FieldKind::kObject); }
+
+ private:
+  void Add(const char* key, FieldKind kind) { fields.emplace_back(key, kind); }
+};
+
+/*! \brief Write the values of the reflected fields of an object. */
+class FieldValueWriter : public AttrVisitor {
+ public:
+  FieldValueWriter(dmlc::Stream* strm, const BinaryNodeIndexer* indexer)
+      : strm_(strm), indexer_(indexer) {}
+
+  void Write(const Object* node, const std::vector<std::pair<std::string, FieldKind>>* schema) {
+    schema_ = schema;
+    next_ = 0;
+    ReflectionVTable::Global()->VisitAttrs(const_cast<Object*>(node), this);
+    CheckField(nullptr, FieldKind::kObject);
+  }
+
+  void Visit(const char* key, double* value) final {
+    CheckField(key, FieldKind::kDouble);
+    strm_->Write(*value);
+  }
+  void Visit(const char* key, int64_t* value) final {
+    CheckField(key, FieldKind::kInt64);
+    strm_->Write(*value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    CheckField(key, FieldKind::kUInt64);
+    strm_->Write(*value);
+  }
+  void Visit(const char* key, int* value) final {
+    CheckField(key, FieldKind::kInt);
+    strm_->Write(static_cast<int32_t>(*value));
+  }
+  void Visit(const char* key, bool* value) final {
+    CheckField(key, FieldKind::kBool);
+    strm_->Write(static_cast<uint8_t>(*value));
+  }
+  void Visit(const char* key, std::string* value) final {
+    CheckField(key, FieldKind::kString);
+    strm_->Write(*value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    CheckField(key, FieldKind::kDataType);
+    strm_->Write(static_cast<DLDataType>(*value));
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    CheckField(key, FieldKind::kNDArray);
+    uint64_t index =
+        value->defined() ? indexer_->tensor_index_.at(value->operator->()) : kUndefinedTensor;
+    strm_->Write(index);
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    CheckField(key, FieldKind::kObject);
+    strm_->Write(indexer_->node_index_.at(value->get()));
+  }
+
+ private:
+  /*! \brief Check that the object visits the fields of the schema of its type, key is null at the end. */
+  void CheckField(const char* key, FieldKind kind) {
+    if (key == nullptr) {
+      ICHECK_EQ(next_, schema_->size()) << "SaveBinary: the fields of an object depend on its value";
+      return;
+    }
+    ICHECK(next_ < schema_->size() && (*schema_)[next_].first == key &&
+           (*schema_)[next_].second == kind)
+        << "SaveBinary: the fields of an object depend on its value, at field " << key;
+    ++next_;
+  }
+
+  dmlc::Stream* strm_;
+  const BinaryNodeIndexer* indexer_;
+  const std::vector<std::pair<std::string, FieldKind>>* schema_{nullptr};
+  size_t next_{0};
+};
+
+/*! \brief A saved field value. */
+struct FieldValue {
+  FieldKind kind;
+  union {
+    double f64;
+    int64_t i64;
+    uint64_t u64;
+    DLDataType dtype;
+  };
+  std::string str;
+};
+
+/*! \brief A type defined in the stream. */
+struct SavedType {
+  std::string type_key;
+  NodeLayout layout;
+  std::vector<std::pair<std::string, FieldKind>> fields;
+  /*!
+   * \brief The saved position of each field visited by the current VisitAttrs, filled
+   *  when the first object of the type is loaded.
+   */
+  std::vector<size_t> current_to_saved;
+  bool resolved{false};
+};
+
+/*! \brief Set the reflected fields of an object from the saved values. */
+class FieldValueSetter : public AttrVisitor {
+ public:
+  FieldValueSetter(const std::vector<ObjectPtr<Object>>* nodes,
+                   const std::vector<runtime::NDArray>* tensors)
+      : nodes_(nodes), tensors_(tensors) {}
+
+  void Set(Object* node, SavedType* type, const std::vector<FieldValue>* values) {
+    if (!type->resolved) Resolve(node, type);
+    type_ = type;
+    values_ = values;
+    next_ = 0;
+    ReflectionVTable::Global()->VisitAttrs(node, this);
+  }
+
+  void Visit(const char* key, double* value) final { *value = Next(key, FieldKind::kDouble).f64; }
+  void Visit(const char* key, int64_t* value) final { *value = Next(key, FieldKind::kInt64).i64; }
+  void Visit(const char* key, uint64_t* value) final {
+    *value = Next(key, FieldKind::kUInt64).u64;
+  }
+  void Visit(const char* key, int* value) final {
+    *value = static_cast<int>(Next(key, FieldKind::kInt).i64);
+  }
+  void Visit(const char* key, bool* value) final { *value = Next(key, FieldKind::kBool).i64 != 0; }
+  void Visit(const char* key, std::string* value) final {
+    *value = Next(key, FieldKind::kString).str;
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    *value = DataType(Next(key, FieldKind::kDataType).dtype);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    uint64_t index = Next(key, FieldKind::kNDArray).u64;
+    if (index == kUndefinedTensor) {
+      *value = runtime::NDArray();
+      return;
+    }
+    ICHECK_LT(index, tensors_->size()) << "LoadBinary: invalid tensor index";
+    *value = tensors_->at(index);
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    uint64_t index = Next(key, FieldKind::kObject).u64;
+    ICHECK_LT(index, nodes_->size()) << "LoadBinary: invalid node index";
+    *value = ObjectRef(nodes_->at(index));
+  }
+
+ private:
+  /*! \brief Match the fields visited by the current version with the saved ones. */
+  void Resolve(Object* node, SavedType* type) {
+    FieldSchemaVisitor schema;
+    ReflectionVTable::Global()->VisitAttrs(node, &schema);
+    for (const auto& field : schema.fields) {
+      size_t pos = 0;
+      while (pos < type->fields.size() && type->fields[pos].first != field.first) ++pos;
+      if (pos == type->fields.size()) {
+        LOG(FATAL) << "LoadBinary: cannot find field " << field.first << " of "
+                   << type->type_key;
+      }
+      ICHECK(type->fields[pos].second == field.second)
+          << "LoadBinary: field " << field.first << " of " << type->type_key
+          << " was saved with another type";
+      type->current_to_saved.push_back(pos);
+    }
+    type->resolved = true;
+  }
+
+  const FieldValue& Next(const char* key, FieldKind kind) {
+    ICHECK_LT(next_, type_->current_to_saved.size())
+        << "LoadBinary: the fields of " << type_->type_key << " depend on its value";
+    const FieldValue& value = (*values_)[type_->current_to_saved[next_++]];
+    ICHECK(value.kind == kind) << "LoadBinary: unexpected type of field " << key;
+    return value;
+  }
+
+  const std::vector<ObjectPtr<Object>>* nodes_;
+  const std::vector<runtime::NDArray>* tensors_;
+  SavedType* type_{nullptr};
+  const std::vector<FieldValue>* values_{nullptr};
+  size_t next_{0};
+};
+
+void WriteTensors(CountingStream* strm, const std::vector<runtime::NDArray>& tensors) {
+  dmlc::Stream* s = strm;
+  s->Write(static_cast<uint64_t>(tensors.size()));
+  std::vector<char> buf;
+  const char padding[kNodeBinaryAlignment] = {0};
+  for (const runtime::NDArray& array : tensors) {
+    const DLTensor* tensor = array.operator->();
+    std::vector<int64_t> shape(tensor->shape, tensor->shape + tensor->ndim);
+    uint64_t nbytes = runtime::GetDataSize(*tensor);
+    s->Write(tensor->dtype);
+    s->Write(shape);
+    s->Write(nbytes);
+    s->Write(padding, strm->Padding());
+    if (tensor->device.device_type == kDLCPU && runtime::IsContiguous(*tensor)) {
+      s->Write(static_cast<const char*>(tensor->data) + tensor->byte_offset, nbytes);
+    } else {
+      buf.resize(nbytes);
+      array.CopyToBytes(buf.data(), nbytes);
+      s->Write(buf.data(), nbytes);
+    }
+  }
+}
+
+std::vector<runtime::NDArray> ReadTensors(CountingStream* strm,
+                                          const std::shared_ptr<runtime::MappedFile>& file) {
+  uint64_t count;
+  strm->ReadChecked(&count);
+  std::vector<runtime::NDArray> tensors;
+  for (uint64_t i = 0; i < count; ++i) {
+    DLDataType dtype;
+    std::vector<int64_t> shape;
+    uint64_t nbytes;
+    strm->ReadChecked(&dtype);
+    strm->ReadChecked(&shape);
+    strm->ReadChecked(&nbytes);
+    strm->Skip(strm->Padding());
+    runtime::NDArray tensor;
+    if (file != nullptr) {
+      ICHECK_LE(strm->count() + nbytes, file->size()) << "LoadBinary: the data is truncated";
+      tensor = runtime::MappedFile::View(file, strm->count(), shape, dtype);
+      strm->Skip(nbytes);
+    } else {
+      tensor = runtime::NDArray::Empty(shape, dtype, {kDLCPU, 0});
+      ICHECK_EQ(strm->Read(tensor->data, nbytes), nbytes) << "LoadBinary: the data is truncated";
+    }
+    ICHECK_EQ(runtime::GetDataSize(*tensor.operator->()), nbytes)
+        << "LoadBinary: invalid tensor size";
+    tensors.emplace_back(std::move(tensor));
+  }
+  return tensors;
+}
+
+void ReadFieldValues(CountingStream* strm, const SavedType& type, std::vector<FieldValue>* values) {
+  values->resize(type.fields.size());
+  for (size_t i = 0; i < type.fields.size(); ++i) {
+    FieldValue& value = (*values)[i];
+    value.kind = type.fields[i].second;
+    switch (value.kind) {
+      case FieldKind::kDouble:
+        strm->ReadChecked(&value.f64);
+        break;
+      case FieldKind::kInt64:
+        strm->ReadChecked(&value.i64);
+        break;
+      case FieldKind::kUInt64:
+      case FieldKind::kNDArray:
+      case FieldKind::kObject:
+        strm->ReadChecked(&value.u64);
+        break;
+      case FieldKind::kInt: {
+        int32_t v;
+        strm->ReadChecked(&v);
+        value.i64 = v;
+        break;
+      }
+      case FieldKind::kBool: {
+        uint8_t v;
+        strm->ReadChecked(&v);
+        value.i64 = v;
+        break;
+      }
+      case FieldKind::kString:
+        strm->ReadChecked(&value.str);
+        break;
+      case FieldKind::kDataType:
+        strm->ReadChecked(&value.dtype);
+        break;
+      default:
+        LOG(FATAL) << "LoadBinary: invalid field kind";
+    }
+  }
+}
+
+ObjectRef LoadBinary(CountingStream* strm, const std::shared_ptr<runtime::MappedFile>& file) {
+  uint64_t magic, version;
+  std::string tvm_version;
+  strm->ReadChecked(&magic);
+  ICHECK_EQ(magic, kTVMNodeBinaryMagic) << "LoadBinary: invalid magic number";
+  strm->ReadChecked(&version);
+  ICHECK_LE(version, kNodeBinaryVersion) << "LoadBinary: unsupported format version " << version;
+  strm->ReadChecked(&tvm_version);
+
+  std::vector<runtime::NDArray> tensors = ReadTensors(strm, file);
+
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  uint64_t num_nodes;
+  strm->ReadChecked(&num_nodes);
+  std::vector<ObjectPtr<Object>> nodes{nullptr};
+  std::vector<SavedType> types;
+  std::vector<FieldValue> values;
+  FieldValueSetter setter(&nodes, &tensors);
+  auto read_index = [&]() {
+    uint64_t index;
+    strm->ReadChecked(&index);
+    ICHECK_LT(index, nodes.size()) << "LoadBinary: invalid node index";
+    return index;
+  };
+  for (uint64_t i = 0; i < num_nodes; ++i) {
+    uint32_t type_index;
+    strm->ReadChecked(&type_index);
+    ICHECK_LE(type_index, types.size()) << "LoadBinary: invalid type index";
+    if (type_index == types.size()) {
+      SavedType type;
+      uint8_t layout;
+      strm->ReadChecked(&type.type_key);
+      strm->ReadChecked(&layout);
+      ICHECK_LE(layout, static_cast<uint8_t>(NodeLayout::kMap)) << "LoadBinary: invalid layout";
+      type.layout = static_cast<NodeLayout>(layout);
+      if (type.layout == NodeLayout::kFields) {
+        uint64_t num_fields;
+        strm->ReadChecked(&num_fields);
+        for (uint64_t j = 0; j < num_fields; ++j) {
+          std::string name;
+          uint8_t kind;
+          strm->ReadChecked(&name);
+          strm->ReadChecked(&kind);
+          ICHECK_LE(kind, static_cast<uint8_t>(FieldKind::kObject))
+              << "LoadBinary: invalid field kind";
+          type.fields.emplace_back(std::move(name), static_cast<FieldKind>(kind));
+        }
+      }
+      types.emplace_back(std::move(type));
+    }
+    SavedType& type = types[type_index];
+    switch (type.layout) {
+      case NodeLayout::kRepr: {
+        std::string repr_bytes;
+        strm->ReadChecked(&repr_bytes);
+        nodes.push_back(reflection->CreateInitObject(type.type_key, repr_bytes));
+        break;
+      }
+      case NodeLayout::kArray: {
+        uint64_t size;
+        strm->ReadChecked(&size);
+        std::vector<ObjectRef> elems;
+        elems.reserve(size);
+        for (uint64_t j = 0; j < size; ++j) {
+          elems.push_back(ObjectRef(nodes[read_index()]));
+        }
+        Array<ObjectRef> array(elems);
+        nodes.push_back(runtime::ObjectInternal::MoveObjectPtr(&array));
+        break;
+      }
+      case NodeLayout::kMap: {
+        uint8_t str_keys;
+        uint64_t size;
+        strm->ReadChecked(&str_keys);
+        strm->ReadChecked(&size);
+        std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual> container;
+        for (uint64_t j = 0; j < size; ++j) {
+          ObjectRef key;
+          if (str_keys) {
+            std::string str;
+            strm->ReadChecked(&str);
+            key = String(str);
+          } else {
+            key = ObjectRef(nodes[read_index()]);
+          }
+          container[key] = ObjectRef(nodes[read_index()]);
+        }
+        Map<ObjectRef, ObjectRef> map(container);
+        nodes.push_back(runtime::ObjectInternal::MoveObjectPtr(&map));
+        break;
+      }
+      case NodeLayout::kFields: {
+        ReadFieldValues(strm, type, &values);
+        // The references are checked by the setter, all of them point to earlier nodes.
+        ObjectPtr<Object> node = reflection->CreateInitObject(type.type_key);
+        setter.Set(node.get(), &type, &values);
+        nodes.push_back(node);
+        break;
+      }
+    }
+  }
+  return ObjectRef(nodes.at(read_index()));
+}
+
+/*! \brief A dmlc stream writing to a std::ostream. */
+class OStreamWriter : public dmlc::Stream {
+ public:
+  explicit OStreamWriter(std::ostream* os) : os_(os) {}
+  size_t Read(void* ptr, size_t size) final {
+    LOG(FATAL) << "OStreamWriter cannot be read";
+    return 0;
+  }
+  void Write(const void* ptr, size_t size) final {
+    os_->write(static_cast<const char*>(ptr), size);
+  }
+
+ private:
+  std::ostream* os_;
+};
+
+}  // namespace
+
+void SaveBinary(dmlc::Stream* strm, const ObjectRef& node) {
+  BinaryNodeIndexer indexer;
+  indexer.Index(node.get());
+  CountingStream counting(strm);
+  dmlc::Stream* s = &counting;
+  s->Write(kTVMNodeBinaryMagic);
+  s->Write(kNodeBinaryVersion);
+  s->Write(std::string(TVM_VERSION));
+  WriteTensors(&counting, indexer.tensor_list_);
+
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  // The type indices of the stream, by runtime type index.
+  std::unordered_map<uint32_t, uint32_t> type_ids;
+  std::vector<std::vector<std::pair<std::string, FieldKind>>> schemas;
+  FieldValueWriter writer(s, &indexer);
+  std::string repr_bytes;
+  s->Write(static_cast<uint64_t>(indexer.node_list_.size() - 1));
+  for (size_t i = 1; i < indexer.node_list_.size(); ++i) {
+    const Object* node = indexer.node_list_[i];
+    auto it = type_ids.find(node->type_index());
+    bool has_repr = reflection->GetReprBytes(node, &repr_bytes);
+    NodeLayout layout = node->IsInstance<ArrayNode>() ? NodeLayout::kArray
+                        : node->IsInstance<MapNode>() ? NodeLayout::kMap
+                        : has_repr                    ? NodeLayout::kRepr
+                                                      : NodeLayout::kFields;
+    if (it == type_ids.end()) {
+      uint32_t type_id = static_cast<uint32_t>(schemas.size());
+      it = type_ids.emplace(node->type_index(), type_id).first;
+      schemas.emplace_back();
+      s->Write(type_id);
+      s->Write(node->GetTypeKey());
+      s->Write(static_cast<uint8_t>(layout));
+      if (layout == NodeLayout::kFields) {
+        FieldSchemaVisitor schema;
+        reflection->VisitAttrs(const_cast<Object*>(node), &schema);
+        s->Write(static_cast<uint64_t>(schema.fields.size()));
+        for (const auto& field : schema.fields) {
+          s->Write(field.first);
+          s->Write(static_cast<uint8_t>(field.second));
+        }
+        schemas.back() = std::move(schema.fields);
+      }
+    } else {
+      s->Write(it->second);
+    }
+    switch (layout) {
+      case NodeLayout::kRepr:
+        s->Write(repr_bytes);
+        break;
+      case NodeLayout::kArray: {
+        const auto* arr = static_cast<const ArrayNode*>(node);
+        s->Write(static_cast<uint64_t>(arr->size()));
+        for (const ObjectRef& elem : *arr) {
+          s->Write(indexer.node_index_.at(elem.get()));
+        }
+        break;
+      }
+      case NodeLayout::kMap: {
+        const auto* map = static_cast<const MapNode*>(node);
+        bool str_keys = IsStrMap(map);
+        s->Write(static_cast<uint8_t>(str_keys));
+        s->Write(static_cast<uint64_t>(map->size()));
+        for (const auto& kv : *map) {
+          if (str_keys) {
+            s->Write(std::string(Downcast<String>(kv.first)));
+          } else {
+            s->Write(indexer.node_index_.at(kv.first.get()));
+          }
+          s->Write(indexer.node_index_.at(kv.second.get()));
+        }
+        break;
+      }
+      case NodeLayout::kFields:
+        writer.Write(node, &schemas[it->second]);
+        break;
+    }
+  }
+  s->Write(indexer.node_index_.at(node.get()));
+}
+
+std::string SaveBinary(const ObjectRef& node) {
+  std::string blob;
+  dmlc::MemoryStringStream strm(&blob);
+  SaveBinary(&strm, node);
+  return blob;
+}
+
+void SaveBinaryToFile(const std::string& file_name, const ObjectRef& node) {
+  std::ofstream fs(file_name, std::ios::out | std::ios::binary);
+  ICHECK(!fs.fail()) << "Cannot open file " << file_name;
+  OStreamWriter strm(&fs);
+  SaveBinary(&strm, node);
+  ICHECK(!fs.fail()) << "Cannot write file " << file_name;
+}
+
+ObjectRef LoadBinary(dmlc::Stream* strm) {
+  CountingStream counting(strm);
+  return LoadBinary(&counting, nullptr);
+}
+
+ObjectRef LoadBinary(std::string blob) {
+  ICHECK(!blob.empty()) << "LoadBinary: the data is truncated";
+  dmlc::MemoryFixedSizeStream strm(&blob[0], blob.size());
+  CountingStream counting(&strm, &strm);
+  return LoadBinary(&counting, nullptr);
+}
+
+ObjectRef LoadBinaryFromFile(const std::string& file_name, bool use_mmap) {
+  auto file = std::make_shared<runtime::MappedFile>(file_name);
+  dmlc::MemoryFixedSizeStream strm(file->data(), file->size());
+  CountingStream counting(&strm, &strm);
+  // Without mmap, the tensors are copied and the file is released on return.
+  return LoadBinary(&counting, use_mmap ? file : nullptr);
+}
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body_typed([](const ObjectRef& node) {
+  std::string blob = SaveBinary(node);
+  // copy return array so it is owned by the ret value
+  runtime::TVMRetValue rv;
+  rv = TVMByteArray{blob.data(), blob.size()};
+  return rv;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinary").set_body_typed([](std::string blob) {
+  return LoadBinary(std::move(blob));
+});
+
+TVM_REGISTER_GLOBAL("node.SaveBinaryToFile").set_body_typed(SaveBinaryToFile);
+
+TVM_REGISTER_GLOBAL("node.LoadBinaryFromFile").set_body_typed(LoadBinaryFromFile);
+
+}  // namespace tvm
@@ -29,6 +29,8 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "../support/str_escape.h"
 #include "../support/utils.h"
@@ -72,24 +74,34 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    /*!
+     * \brief Whether the hash only depends on the subtree, not on the order of its
+     *  free variables and graph nodes in the whole traversal.
+     */
+    bool context_free{true};
 
     Task() = default;
     explicit Task(ObjectRef object, size_t reduced_hash, bool map_free_vars)
         : object(object), reduced_hash(reduced_hash), map_free_vars(map_free_vars) {}
   };
 
-  VarCountingSHashHandler() {}
+  VarCountingSHashHandler() : cache_(SHashCache::Current()) {}
 
   void MarkGraphNode() final {
     // need to push to pending tasks in this case
     ICHECK(!allow_push_to_stack_ && !task_stack_.empty());
     task_stack_.back().graph_node_hash = true;
+    task_stack_.back().context_free = false;
   }
 
   bool LookupHashedValue(const ObjectRef& key, size_t* hash_value) final {
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
       hash_value[0] = it->second;
+      // The caller reduces the value, the hash of the node being expanded depends on it.
+      if (!allow_push_to_stack_ && !task_stack_.empty() && context_dependent_.count(key.get())) {
+        task_stack_.back().context_free = false;
+      }
       return true;
     }
     return false;
@@ -110,6 +122,7 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
       size_t value = std::hash<const runtime::Object*>()(var);
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
     }
+    pending_tasks_.back().context_free = false;
   }
 
   void SHashReduce(const ObjectRef& object, bool map_free_vars) final {
@@ -121,8 +134,12 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
       return;
     }
     auto it = hash_memo_.find(object);
+    size_t cached_hash;
     if (it != hash_memo_.end()) {
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second, false));
+      pending_tasks_.back().context_free = !context_dependent_.count(object.get());
+    } else if (cache_ != nullptr && cache_->Lookup(object, &cached_hash)) {
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), cached_hash, false));
     } else {
       // Push a pending task with initial value.
       pending_tasks_.emplace_back(Task(object, object->GetTypeKeyHash(), map_free_vars));
@@ -145,6 +162,7 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
     ICHECK_EQ(result_stack_.size(), 1U);
     size_t ret = result_stack_.back();
     result_stack_.pop_back();
+    result_context_free_.clear();
     return ret;
   }
 
@@ -155,22 +173,25 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
   void PopTaskStack() {
     const auto& entry = task_stack_.back();
     result_stack_.push_back(entry.reduced_hash);
+    result_context_free_.push_back(entry.context_free);
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
    */
-  size_t ReduceHash(const Task& task) {
-    size_t stack_begin = task.result_stack_index;
+  size_t ReduceHash(Task* task) {
+    size_t stack_begin = task->result_stack_index;
     ICHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
-    size_t reduced_hash = task.reduced_hash;
+    size_t reduced_hash = task->reduced_hash;
     for (size_t i = result_stack_.size(); i != stack_begin; --i) {
       reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1]);
+      task->context_free = task->context_free && result_context_free_[i - 1];
     }
     result_stack_.resize(stack_begin);
+    result_context_free_.resize(stack_begin);
     return reduced_hash;
   }
   // run the tasks.
@@ -180,13 +201,14 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        entry.reduced_hash = ReduceHash(&entry);
         // When all the children has expanded and visited.
         // entry.reduced_hash contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
           entry.reduced_hash = it->second;
+          entry.context_free = !context_dependent_.count(entry.object.get());
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
@@ -195,6 +217,11 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
                                                       std::hash<size_t>()(graph_node_counter_++));
           }
           hash_memo_[entry.object] = entry.reduced_hash;
+          if (!entry.context_free) {
+            context_dependent_.insert(entry.object.get());
+          } else if (cache_ != nullptr) {
+            cache_->Insert(entry.object, entry.reduced_hash);
+          }
         }
         // send value to parent.
         this->PopTaskStack();
@@ -247,6 +274,12 @@ class VarCountingSHashHandler : public SHashReducer::Handler {
   std::vector<Task> task_stack_;
   // Internal stack to store the result poped from the task stack.
   std::vector<size_t> result_stack_;
+  // Whether each entry of the result stack is context free.
+  std::vector<bool> result_context_free_;
+  // The memoized objects whose hash is not context free.
+  std::unordered_set<const Object*> context_dependent_;
+  // The cross-call cache of context free hashes, may be nullptr.
+  SHashCacheNode* cache_;
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
@@ -263,6 +296,78 @@ size_t StructuralHash::operator()(const ObjectRef& object) const {
   return VarCountingSHashHandler().Hash(object, false);
 }
 
+bool SHashCacheNode::Lookup(const ObjectRef& key, size_t* hashed_value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = table_.find(key);
+  if (it == table_.end()) return false;
+  ++hits;
+  *hashed_value = it->second;
+  return true;
+}
+
+void SHashCacheNode::Insert(const ObjectRef& key, size_t hashed_value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_.emplace(key, hashed_value);
+}
+
+size_t SHashCacheNode::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return table_.size();
+}
+
+void SHashCacheNode::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_.clear();
+  hits = 0;
+}
+
+SHashCache SHashCache::Create() { return SHashCache(make_object<SHashCacheNode>()); }
+
+/*! \brief The stack of entered caches of a thread. */
+static std::vector<SHashCache>* SHashCacheStack() {
+  thread_local std::vector<SHashCache> stack;
+  return &stack;
+}
+
+SHashCacheNode* SHashCache::Current() {
+  std::vector<SHashCache>* stack = SHashCacheStack();
+  return stack->empty() ? nullptr : stack->back().operator->();
+}
+
+void SHashCache::EnterWithScope() { SHashCacheStack()->push_back(*this); }
+
+void SHashCache::ExitWithScope() {
+  std::vector<SHashCache>* stack = SHashCacheStack();
+  ICHECK(!stack->empty() && stack->back().same_as(*this));
+  stack->pop_back();
+}
+
+TVM_REGISTER_OBJECT_TYPE(SHashCacheNode);
+
+class SHashCacheInternal {
+ public:
+  static void EnterScope(SHashCache cache) { cache.EnterWithScope(); }
+  static void ExitScope(SHashCache cache) { cache.ExitWithScope(); }
+};
+
+TVM_REGISTER_GLOBAL("node.SHashCache").set_body_typed(SHashCache::Create);
+
+TVM_REGISTER_GLOBAL("node.SHashCacheEnterScope").set_body_typed(SHashCacheInternal::EnterScope);
+
+TVM_REGISTER_GLOBAL("node.SHashCacheExitScope").set_body_typed(SHashCacheInternal::ExitScope);
+
+TVM_REGISTER_GLOBAL("node.SHashCacheSize").set_body_typed([](SHashCache cache) {
+  return static_cast<int64_t>(cache->size());
+});
+
+TVM_REGISTER_GLOBAL("node.SHashCacheHits").set_body_typed([](SHashCache cache) {
+  return cache->hits;
+});
+
+TVM_REGISTER_GLOBAL("node.SHashCacheClear").set_body_typed([](SHashCache cache) {
+  cache->Clear();
+});
+
 // SEQualReduce traits for runtime containers.
 struct StringObjTrait {
   static constexpr const std::nullptr_t VisitAttrs = nullptr;
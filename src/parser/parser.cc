@@ -1867,7 +1867,7 @@ class Parser {
 };
 
 Parser InitParser(const std::string& file_name, const std::string& file_content,
-                  Optional<IRModule> init_module) {
+                  Optional<IRModule> init_module, Optional<MetaTable> init_meta_table) {
   DLOG(INFO) << "InitParser: file_name: " << file_name
              << "file_content_size: " << file_content.size();
   SourceName src_name = SourceName::Get(file_name);
@@ -1889,13 +1889,17 @@ Parser InitParser(const std::string& file_name, const std::string& file_content,
   auto tokens = tokens_and_table.first;
   auto meta_data_table = tokens_and_table.second;
 
-  return Parser(module, diag_ctx, source, tokens, DefaultOpTable(), meta_data_table.ToMetadata());
+  // The metadata section of the text, if any, takes precedence over the initial table.
+  MetaTable meta_table = meta_data_table->data.defined() || !init_meta_table
+                             ? meta_data_table.ToMetadata()
+                             : init_meta_table.value();
+  return Parser(module, diag_ctx, source, tokens, DefaultOpTable(), meta_table);
 }
 
 IRModule ParseModule(std::string file_name, std::string file_content,
-                     Optional<IRModule> init_module) {
+                     Optional<IRModule> init_module, Optional<MetaTable> init_meta_table) {
   DLOG(INFO) << "ParseModule";
-  auto parser = InitParser(file_name, file_content, init_module);
+  auto parser = InitParser(file_name, file_content, init_module, init_meta_table);
   auto mod = parser.ParseModule();
   ICHECK(mod.defined()) << "The parser must return a non-null module.";
   // NB(@jroesch): it is very important that we render any errors before we procede
@@ -1909,7 +1913,7 @@ IRModule ParseModule(std::string file_name, std::string file_content,
 
 Expr ParseExpr(std::string file_name, std::string file_content) {
   DLOG(INFO) << "ParseExpr";
-  auto parser = InitParser(file_name, file_content, Optional<IRModule>());
+  auto parser = InitParser(file_name, file_content, Optional<IRModule>(), NullOpt);
   parser.ParseSemVer(false);
   parser.PushScope();
   auto expr = parser.ParseExpr();
@@ -1922,8 +1926,9 @@ Expr ParseExpr(std::string file_name, std::string file_content) {
 }
 
 TVM_REGISTER_GLOBAL("parser.ParseModule")
-    .set_body_typed([](tvm::String file_name, tvm::String file_content) {
-      return ParseModule(file_name, file_content);
+    .set_body_typed([](tvm::String file_name, tvm::String file_content,
+                       Optional<IRModule> init_module, Optional<MetaTable> init_meta_table) {
+      return ParseModule(file_name, file_content, init_module, init_meta_table);
     });
 
 TVM_REGISTER_GLOBAL("parser.ParseExpr")
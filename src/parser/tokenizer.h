@@ -27,6 +27,8 @@
 #include <tvm/node/serialization.h>
 #include <tvm/runtime/object.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <string>
@@ -88,7 +90,7 @@ struct Tokenizer {
   std::vector<Token> tokens;
 
   char Next() {
-    char c = this->source.at(this->pos);
+    char c = this->source.data()[this->pos];
     if (c == '\n') {
       this->line += 1;
       this->col = 1;
@@ -103,7 +105,41 @@ struct Tokenizer {
 
   char Peek() {
     ICHECK(pos < this->source.size());
-    return this->source.at(this->pos);
+    return this->source.data()[this->pos];
+  }
+
+  /*! rief Consume the characters while they satisfy the predicate. */
+  template <typename FPredicate>
+  void SkipWhile(FPredicate pred) {
+    while (More() && pred(Peek())) {
+      Next();
+    }
+  }
+
+  /*!
+   * rief Move to the given position in one scan, updating the line and column.
+   *  Used to consume large sections, e.g. the metadata, without a call per character.
+   */
+  void AdvanceTo(size_t end) {
+    const char* data = this->source.data();
+    const char* last_newline = nullptr;
+    const char* p = static_cast<const char*>(memchr(data + pos, '\n', end - pos));
+    while (p != nullptr) {
+      this->line += 1;
+      last_newline = p;
+      p = static_cast<const char*>(memchr(p + 1, '\n', data + end - (p + 1)));
+    }
+    if (last_newline != nullptr) {
+      this->col = static_cast<int>(data + end - last_newline);
+    } else {
+      this->col += static_cast<int>(end - pos);
+    }
+    this->pos = end;
+  }
+
+  /*! rief The text from begin to the current position, copied once. */
+  std::string Substr(size_t begin) const {
+    return std::string(this->source.data() + begin, this->pos - begin);
   }
 
   Token NewToken(TokenType token_type, ObjectRef data = ObjectRef(), int lines = 0, int cols = 1) {
@@ -224,36 +260,27 @@ struct Tokenizer {
   }
 
   Token ParseNumber(bool is_pos) {
-    std::stringstream ss;
-    while (More() && IsNumeric(Peek())) {
-      ss << Next();
-    }
+    size_t begin = this->pos;
+    SkipWhile(IsNumeric);
 
     bool is_float = false;
 
     // Remove trailing floating point prefix.
     if (More() && Peek() == 'f') {
-      ss << Next();
-      while (More() && IsNumeric(Peek())) {
-        ss << Next();
-      }
+      Next();
+      SkipWhile(IsNumeric);
       is_float = true;
     }
-    return ParseNumber(is_pos, is_float, ss.str());
+    return ParseNumber(is_pos, is_float, Substr(begin));
   }
 
-  bool MatchString(const std::string& string) {
-    int start = this->pos;
-
-    for (auto c : string) {
-      if (Peek() != c) {
-        this->pos = start;
-        return false;
-      } else {
-        Next();
-      }
+  bool MatchString(const char* string) {
+    size_t length = strlen(string);
+    if (this->source.size() - this->pos < length ||
+        memcmp(this->source.data() + this->pos, string, length) != 0) {
+      return false;
     }
-
+    AdvanceTo(this->pos + length);
     return true;
   }
 
@@ -261,27 +288,26 @@ struct Tokenizer {
     int line = this->line;
     int column = this->col;
 
+    auto not_closing = [](char c) { return c != ']'; };
     ICHECK_EQ(Peek(), '[');
     Next();
-    std::stringstream type_key;
-    while (More() && Peek() != ']') {
-      type_key << Next();
-    }
+    size_t type_key_begin = this->pos;
+    SkipWhile(not_closing);
+    std::string type_key = Substr(type_key_begin);
     ICHECK_EQ(Peek(), ']');
     Next();
 
     ICHECK_EQ(Peek(), '[');
     Next();
-    std::stringstream str_index;
-    while (More() && Peek() != ']') {
-      str_index << Next();
-    }
+    size_t index_begin = this->pos;
+    SkipWhile(not_closing);
+    std::string str_index = Substr(index_begin);
     ICHECK_EQ(Peek(), ']');
     Next();
     // todo: add error handling around bad indices
-    auto index = ParseNumber(true, false, str_index.str()).ToNumber();
+    auto index = ParseNumber(true, false, str_index).ToNumber();
     auto span = SpanFrom(line, column);
-    return Token(span, TokenType::kMetaReference, MetaRef(type_key.str(), index));
+    return Token(span, TokenType::kMetaReference, MetaRef(type_key, index));
   }
 
   Token TokenizeAttr() {
@@ -290,26 +316,21 @@ struct Tokenizer {
     Next();
     if (Peek() == '[') {
       Next();
-      std::stringstream raw_attribute;
-
-      while (More() && Peek() != ']') {
-        raw_attribute << Next();
-      }
+      size_t begin = this->pos;
+      SkipWhile([](char c) { return c != ']'; });
+      auto attribute = Substr(begin);
 
       ICHECK_EQ(Next(), ']');
 
-      auto attribute = raw_attribute.str();
       // Clean up the white-space on both sides.
       ltrim(attribute);
       rtrim(attribute);
 
       // Metadata can only appear at the bottom of a file and goes to EOF.
       if (attribute == "metadata") {
-        std::stringstream metadata;
-        while (More()) {
-          metadata << Next();
-        }
-        ObjectRef metadata_map = tvm::LoadJSON(metadata.str());
+        size_t metadata_begin = this->pos;
+        AdvanceTo(this->source.size());
+        ObjectRef metadata_map = tvm::LoadJSON(Substr(metadata_begin));
         auto span = SpanFrom(line, column);
         return Token(span, TokenType::kMetadata, metadata_map);
       }
@@ -360,16 +381,16 @@ struct Tokenizer {
       // TODO(@jroesch): Properly tokenize escape sequences in strings.
       // see https://github.com/apache/tvm/issues/6153.
       Next();
-      std::stringstream string_content;
-      while (More() && Peek() != '"') {
-        string_content << Next();
-      }
+      size_t begin = this->pos;
+      SkipWhile([](char c) { return c != '"'; });
+      std::string string_content = Substr(begin);
       Next();
-      return NewToken(TokenType::kStringLiteral, tvm::String(string_content.str()));
+      return NewToken(TokenType::kStringLiteral, tvm::String(string_content));
     } else if (IsWhitespace(next)) {
-      auto token = NewToken(TokenType::kWhitespace);
+      // A run of indentation is a single token.
       Next();
-      return token;
+      SkipWhile([](char c) { return c == ' ' || c == '\t'; });
+      return Token(SpanFrom(line, col), TokenType::kWhitespace, ObjectRef());
     } else if (next == '-') {
       int negs = 0;
       while (More() && Peek() == '-') {
@@ -472,12 +493,9 @@ struct Tokenizer {
       auto token = NewToken(TokenType::kPercent);
       Next();
 
-      std::stringstream number;
-      while (More() && IsDigit(Peek())) {
-        number << Next();
-      }
-
-      auto number_str = number.str();
+      size_t begin = this->pos;
+      SkipWhile(IsDigit);
+      auto number_str = Substr(begin);
       if (number_str.size()) {
         auto num_tok = ParseNumber(true, false, number_str);
         auto span = SpanFrom(token->span->line, token->span->column);
@@ -491,11 +509,9 @@ struct Tokenizer {
         auto token = NewToken(TokenType::kLineComment);
         // Consume the /
         Next();
-        std::stringstream comment;
-        while (More() && Peek() != '\n') {
-          comment << Next();
-        }
-        token->data = tvm::String(comment.str());
+        size_t begin = this->pos;
+        SkipWhile([](char c) { return c != '\n'; });
+        token->data = tvm::String(Substr(begin));
         return token;
       } else if (Peek() == '*') {
         // Eat the first /* pair before entering the state machine.
@@ -508,18 +524,15 @@ struct Tokenizer {
         return NewToken(TokenType::kDivision);
       }
     } else if (IsIdentLetter(next)) {
-      std::stringstream ss;
       // Due the below code we need to patch
       // the line/col info to the start of
       // token.
       int line = this->line;
       int col = this->col;
 
-      while (More() && IsIdent(Peek())) {
-        ss << Next();
-      }
-
-      std::string keyword = ss.str();
+      size_t begin = this->pos;
+      SkipWhile(IsIdent);
+      std::string keyword = Substr(begin);
       auto it = KEYWORD_TABLE.find(keyword);
 
       TokenType token_type;
@@ -537,14 +550,12 @@ struct Tokenizer {
       }
 
       auto span = SpanFrom(line, col);
-      return Token(span, token_type, tvm::String(ss.str()));
+      return Token(span, token_type, tvm::String(keyword));
     } else {
-      std::stringstream ss;
-      while (More() && !IsWhitespace(Peek())) {
-        ss << Next();
-      }
       auto token = NewToken(TokenType::kUnknown);
-      token->data = tvm::String(ss.str());
+      size_t begin = this->pos;
+      SkipWhile([](char c) { return !IsWhitespace(c); });
+      token->data = tvm::String(Substr(begin));
       return token;
     }
   }
@@ -571,6 +582,7 @@ struct Tokenizer {
 
 std::vector<Token> Condense(const std::vector<Token>& tokens, Token* table) {
   std::vector<Token> out;
+  out.reserve(tokens.size());
   bool found_metadata = false;
 
   for (size_t i = 0; i < tokens.size(); i++) {
@@ -653,7 +665,7 @@ std::pair<std::vector<Token>, Token> Tokenize(const DiagnosticContext& ctx, cons
   tokenizer.Tokenize();
   Token meta_table(Span(), TokenType::kUnknown, ObjectRef());
   auto tokens = Condense(tokenizer.tokens, &meta_table);
-  for (auto token : tokens) {
+  for (const auto& token : tokens) {
     ICHECK(token.defined());
   }
   return {tokens, meta_table};
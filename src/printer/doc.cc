@@ -83,6 +83,28 @@ class DocLine : public DocAtom {
   TVM_DEFINE_OBJECT_REF_METHODS(DocLine, DocAtom, DocLineNode);
 };
 
+/*!
+ * \brief Represent a reference to a meta data node, with a deferred index.
+ */
+class DocMetaRefNode : public DocAtomNode {
+ public:
+  /*! \brief The type key of the node. */
+  std::string type_key;
+  /*! \brief The index before the offset. */
+  int64_t index;
+  /*! \brief The offsets, by type key. */
+  std::shared_ptr<const MetaIndexOffsets> offsets;
+
+  DocMetaRefNode(std::string type_key, int64_t index,
+                 std::shared_ptr<const MetaIndexOffsets> offsets)
+      : type_key(type_key), index(index), offsets(offsets) {}
+
+  static constexpr const char* _type_key = "printer.DocMetaRef";
+  TVM_DECLARE_FINAL_OBJECT_INFO(DocMetaRefNode, DocAtomNode);
+};
+
+TVM_REGISTER_OBJECT_TYPE(DocMetaRefNode);
+
 // DSL function implementations
 Doc& Doc::operator<<(const Doc& right) {
   ICHECK(this != &right);
@@ -97,22 +119,38 @@ Doc& Doc::operator<<(const DocAtom& right) {
   return *this;
 }
 
-std::string Doc::str() {
+std::string Doc::str() const {
   std::ostringstream os;
-  for (auto atom : this->stream_) {
+  Print(os);
+  return os.str();
+}
+
+void Doc::Print(std::ostream& os) const {
+  for (const DocAtom& atom : this->stream_) {
     if (auto* text = atom.as<DocTextNode>()) {
       os << text->str;
     } else if (auto* line = atom.as<DocLineNode>()) {
-      os << "\n" << std::string(line->indent, ' ');
+      os << "\n";
+      for (int i = 0; i < line->indent; ++i) {
+        os.put(' ');
+      }
+    } else if (auto* ref = atom.as<DocMetaRefNode>()) {
+      auto it = ref->offsets->find(ref->type_key);
+      int64_t offset = it == ref->offsets->end() ? 0 : it->second;
+      os << "meta[" << ref->type_key << "][" << ref->index + offset << "]";
     } else {
       LOG(FATAL) << "do not expect type " << atom->GetTypeKey();
     }
   }
-  return os.str();
 }
 
 Doc Doc::NewLine(int indent) { return Doc() << DocLine(indent); }
 
+Doc Doc::MetaRef(std::string type_key, int64_t index,
+                 std::shared_ptr<const MetaIndexOffsets> offsets) {
+  return Doc() << DocAtom(runtime::make_object<DocMetaRefNode>(type_key, index, offsets));
+}
+
 Doc Doc::Text(std::string text) { return Doc() << DocText(text); }
 
 Doc Doc::RawText(std::string text) {
@@ -30,8 +30,11 @@
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/object.h>
 
+#include <memory>
+#include <ostream>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace tvm {
@@ -55,6 +58,9 @@ class DocAtom : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(DocAtom, ObjectRef, DocAtomNode);
 };
 
+/*! \brief The offsets added to the meta data indices by type key, set after the doc is built. */
+using MetaIndexOffsets = std::unordered_map<std::string, int64_t>;
+
 /*!
  * \brief Stream-like interface for Doc DSL.
  *
@@ -104,7 +110,12 @@ class Doc {
    * \brief Convert the doc stream into string.
    * \return The string representation.
    */
-  std::string str();
+  std::string str() const;
+  /*!
+   * \brief Write the doc stream, without building the string.
+   * \param os The stream to write to.
+   */
+  void Print(std::ostream& os) const;
   /*!
    * \brief Create a doc that represents text content.
    * \return The created doc.
@@ -120,6 +131,16 @@ class Doc {
    * \return The created doc.
    */
   static Doc NewLine(int indent = 0);
+  /*!
+   * \brief Create a doc that represents a reference to a meta data node, the index of which is
+   *  offset when the doc is printed, e.g. once the meta data of several printers is merged.
+   * \param type_key The type key of the node.
+   * \param index The index of the node among the ones of its printer.
+   * \param offsets The offsets of the indices by type key, shared by the docs of a printer.
+   * \return The created doc.
+   */
+  static Doc MetaRef(std::string type_key, int64_t index,
+                     std::shared_ptr<const MetaIndexOffsets> offsets);
   /*!
    * \brief Create a new doc that adds indentation to everyline of the doc.
    * \param indent The indent to be added.
@@ -26,6 +26,7 @@
 
 #include <tvm/node/serialization.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -103,11 +104,41 @@ class TextMetaDataContext {
     int64_t index = static_cast<int64_t>(mvector.size());
     mvector.push_back(node);
     Doc doc;
-    doc << "meta[" << type_key << "][" << index << "]";
+    if (offsets_ != nullptr) {
+      doc << Doc::MetaRef(type_key, index, offsets_);
+    } else {
+      doc << "meta[" << type_key << "][" << index << "]";
+    }
     meta_repr_[node] = doc;
     return meta_repr_[node];
   }
 
+  /*!
+   * \brief Print the meta nodes with indices offset once the context is appended to another one.
+   * \note To be called before any meta node is printed.
+   * \sa Append
+   */
+  void DeferIndices() {
+    ICHECK(meta_data_.empty());
+    offsets_ = std::make_shared<MetaIndexOffsets>();
+  }
+
+  /*!
+   * \brief Append the meta data of another context after the one here, which sets the offsets of
+   *  the indices printed by the other context. The nodes in both contexts are stored twice.
+   * \param other The other context, the indices of which are deferred.
+   */
+  void Append(const TextMetaDataContext& other) {
+    ICHECK(other.offsets_ != nullptr);
+    for (const auto& kv : other.meta_data_) {
+      Array<ObjectRef>& mvector = meta_data_[kv.first];
+      (*other.offsets_)[kv.first] = static_cast<int64_t>(mvector.size());
+      for (const ObjectRef& node : kv.second) {
+        mvector.push_back(node);
+      }
+    }
+  }
+
   /*!
    * \brief Test whether a node has been put in meta
    * \param node The query node
@@ -131,6 +162,14 @@ class TextMetaDataContext {
     return Doc::RawText(SaveJSON(Map<String, ObjectRef>(meta_data_.begin(), meta_data_.end())));
   }
 
+  /*!
+   * \brief Get the meta data, e.g. to be saved aside instead of printed.
+   * \return The nodes in meta, by type key, in the order of their indices.
+   */
+  Map<String, Array<ObjectRef>> GetMetaTable() const {
+    return Map<String, Array<ObjectRef>>(meta_data_.begin(), meta_data_.end());
+  }
+
   /*! \return whether the meta data context is empty. */
   bool empty() const { return meta_data_.empty(); }
 
@@ -139,6 +178,8 @@ class TextMetaDataContext {
   std::unordered_map<String, Array<ObjectRef> > meta_data_;
   /*! \brief map from meta data into its string representation */
   std::unordered_map<ObjectRef, Doc, ObjectPtrHash, ObjectPtrEqual> meta_repr_;
+  /*! \brief the offsets of the indices when deferred, set when appended to another context */
+  std::shared_ptr<MetaIndexOffsets> offsets_;
 };
 }  // namespace tvm
 #endif  // TVM_PRINTER_META_DATA_H_
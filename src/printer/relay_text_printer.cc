@@ -369,6 +369,11 @@ Doc RelayTextPrinter::VisitExpr_(const ConstantNode* op) {
       return ScalarLiteral(dtype, static_cast<const uint8_t*>(op->data->data)[0]);
     }
   }
+  if (elide_constant_bytes_ > 0 &&
+      static_cast<int64_t>(runtime::GetDataSize(*op->data.operator->())) > elide_constant_bytes_) {
+    // Neither printed nor kept in meta, the type printed after it tells the shape.
+    return Doc::Text("meta[relay.Constant][elided]");
+  }
   // default fall-back, record it as meta node.
   Doc doc;
   // Don't append optional_info. Because the entry function is Print,
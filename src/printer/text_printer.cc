@@ -25,9 +25,13 @@
 
 #include "text_printer.h"
 
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/function.h>
 
+#include <fstream>
 #include <string>
+#include <thread>
+#include <utility>
 
 namespace tvm {
 
@@ -46,25 +50,64 @@ Doc TextPrinter::PrintMod(const IRModule& mod) {
   }
   // functions
   for (const auto& kv : mod->functions) {
-    if (kv.second.as<relay::FunctionNode>()) {
-      relay_text_printer_.dg_ =
-          relay::DependencyGraph::Create(&relay_text_printer_.arena_, kv.second);
-    }
     if (counter++ != 0) {
       doc << Doc::NewLine();
     }
-    if (kv.second.as<relay::FunctionNode>()) {
-      std::ostringstream os;
-      os << "def @" << kv.first->name_hint;
-      doc << relay_text_printer_.PrintFunc(Doc::Text(os.str()), kv.second);
-    } else if (kv.second.as<tir::PrimFuncNode>()) {
-      doc << tir_text_printer_.PrintPrimFunc(Downcast<tir::PrimFunc>(kv.second));
-    }
+    doc << PrintModEntry(kv.first, kv.second);
     doc << Doc::NewLine();
   }
   return doc;
 }
 
+Doc TextPrinter::PrintModEntry(const ObjectRef& name, const ObjectRef& value) {
+  if (value.as<relay::FunctionNode>()) {
+    relay_text_printer_.dg_ = relay::DependencyGraph::Create(&relay_text_printer_.arena_,
+                                                             Downcast<relay::Function>(value));
+    std::ostringstream os;
+    os << "def @" << Downcast<GlobalVar>(name)->name_hint;
+    return relay_text_printer_.PrintFunc(Doc::Text(os.str()), Downcast<BaseFunc>(value));
+  } else if (value.as<tir::PrimFuncNode>()) {
+    return tir_text_printer_.PrintPrimFunc(Downcast<tir::PrimFunc>(value));
+  } else if (value.as<TypeDataNode>()) {
+    return relay_text_printer_.Print(value);
+  }
+  return Doc();
+}
+
+void StreamModEntries(std::ostream& os, int num_entries, int num_threads,
+                      const std::function<Doc(int, TextMetaDataContext*)>& fprint,
+                      TextMetaDataContext* meta) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  // A few entries per thread, for the threads not to wait for the longest entry of each batch.
+  int batch_size = num_threads == 1 ? 1 : num_threads * 4;
+  std::vector<Doc> docs(batch_size);
+  std::vector<TextMetaDataContext> metas(batch_size);
+  for (int begin = 0; begin < num_entries; begin += batch_size) {
+    int end = std::min(num_entries, begin + batch_size);
+    auto fentry = [&](int i) {
+      metas[i - begin] = TextMetaDataContext();
+      metas[i - begin].DeferIndices();
+      docs[i - begin] = fprint(i, &metas[i - begin]);
+    };
+    if (num_threads == 1) {
+      fentry(begin);
+    } else {
+      support::parallel_for(begin, end, fentry, 1,
+                            [num_threads](int begin, int end, int step, int) {
+                              return support::rr_partitioner(begin, end, step, num_threads);
+                            });
+    }
+    for (int i = begin; i < end; ++i) {
+      meta->Append(metas[i - begin]);
+      docs[i - begin].Print(os);
+      docs[i - begin] = Doc();
+      metas[i - begin] = TextMetaDataContext();
+    }
+  }
+}
+
 String PrettyPrint(const ObjectRef& node) {
   Doc doc;
   doc << TextPrinter(false, nullptr, false).PrintFinal(node);
@@ -84,8 +127,85 @@ String AsText(const ObjectRef& node, bool show_meta_data,
   return doc.str();
 }
 
+String AsTextWithMetaTable(const ObjectRef& node, Map<String, Array<ObjectRef>>* meta_table,
+                           runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
+  Doc doc;
+  doc << "#[version = \"" << kSemVer << "\"]" << Doc::NewLine();
+  runtime::TypedPackedFunc<std::string(ObjectRef)> ftyped = nullptr;
+  if (annotate != nullptr) {
+    ftyped = runtime::TypedPackedFunc<std::string(ObjectRef)>(
+        [&annotate](const ObjectRef& expr) -> std::string { return annotate(expr); });
+  }
+  TextPrinter printer(false, ftyped, false);
+  doc << printer.PrintFinal(node);
+  *meta_table = printer.meta_.GetMetaTable();
+  return doc.str();
+}
+
+void PrintText(std::ostream& os, const ObjectRef& node, bool show_meta_data,
+               runtime::TypedPackedFunc<String(ObjectRef)> annotate, int num_threads,
+               int64_t elide_constant_bytes) {
+  os << "#[version = \"" << kSemVer << "\"]\n";
+  runtime::TypedPackedFunc<std::string(ObjectRef)> ftyped = nullptr;
+  if (annotate != nullptr) {
+    ftyped = runtime::TypedPackedFunc<std::string(ObjectRef)>(
+        [&annotate](const ObjectRef& expr) -> std::string { return annotate(expr); });
+    // The callback may not be thread safe, e.g. when it is a Python function.
+    num_threads = 1;
+  }
+  TextPrinter printer(show_meta_data, ftyped);
+  printer.SetElideConstantBytes(elide_constant_bytes);
+  const auto* mod = node.as<IRModuleNode>();
+  if (mod == nullptr) {
+    printer.PrintFinal(node).Print(os);
+    return;
+  }
+  // The entries are laid out as in PrintMod, each followed by a new line.
+  std::vector<std::pair<ObjectRef, ObjectRef>> entries;
+  for (const auto& kv : mod->type_definitions) {
+    entries.emplace_back(kv.first, kv.second);
+  }
+  for (const auto& kv : mod->functions) {
+    entries.emplace_back(kv.first, kv.second);
+  }
+  StreamModEntries(
+      os, static_cast<int>(entries.size()), num_threads,
+      [&](int i, TextMetaDataContext* meta) {
+        TextPrinter entry_printer(show_meta_data, ftyped);
+        entry_printer.SetElideConstantBytes(elide_constant_bytes);
+        entry_printer.meta_ = std::move(*meta);
+        Doc doc;
+        if (i != 0) {
+          doc << Doc::NewLine();
+        }
+        doc << entry_printer.PrintModEntry(entries[i].first, entries[i].second) << Doc::NewLine();
+        *meta = std::move(entry_printer.meta_);
+        return doc;
+      },
+      &printer.meta_);
+  printer.PrintMetaSection().Print(os);
+}
+
+void SaveText(const ObjectRef& node, const std::string& file_name, bool show_meta_data,
+              runtime::TypedPackedFunc<String(ObjectRef)> annotate, int num_threads,
+              int64_t elide_constant_bytes) {
+  std::ofstream os(file_name);
+  ICHECK(os) << "Cannot open " << file_name << " to write";
+  PrintText(os, node, show_meta_data, annotate, num_threads, elide_constant_bytes);
+  ICHECK(os) << "Failed to write " << file_name;
+}
+
 TVM_REGISTER_GLOBAL("ir.PrettyPrint").set_body_typed(PrettyPrint);
 
 TVM_REGISTER_GLOBAL("ir.AsText").set_body_typed(AsText);
 
+TVM_REGISTER_GLOBAL("ir.SaveText").set_body_typed(SaveText);
+
+TVM_REGISTER_GLOBAL("ir.AsTextWithMetaTable")
+    .set_body_typed([](ObjectRef node, runtime::TypedPackedFunc<String(ObjectRef)> annotate) {
+      Map<String, Array<ObjectRef>> meta_table;
+      String text = AsTextWithMetaTable(node, &meta_table, annotate);
+      return Array<ObjectRef>{text, meta_table};
+    });
+
 }  // namespace tvm
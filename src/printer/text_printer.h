@@ -36,6 +36,8 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/var.h>
 
+#include <functional>
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -199,6 +201,8 @@ class RelayTextPrinter : public ExprFunctor<Doc(const Expr&)>,
   support::Arena arena_;
   /*! \brief dependency graph of the expr */
   DependencyGraph dg_;
+  /*! \brief the constants of more bytes are elided, 0 to keep all of them */
+  int64_t elide_constant_bytes_{0};
   class AttrPrinter;
   friend class AttrPrinter;
   friend class tvm::TextPrinter;
@@ -371,6 +375,20 @@ class TIRTextPrinter : public StmtFunctor<Doc(const Stmt&)>,
 
 String AsTVMScript(const ObjectRef& mod, bool show_meta = false);
 
+/*!
+ * \brief Stream a PrimFunc or an IRModule as TVMScript, as AsTVMScript does.
+ *
+ *  The functions of a module are printed by printers of their own in parallel and written in
+ *  order, the text being the one of AsTVMScript but for the indices of the meta nodes shared by
+ *  several functions.
+ *
+ * \param os The stream to write to.
+ * \param mod The PrimFunc or IRModule.
+ * \param show_meta Whether to print the meta data.
+ * \param num_threads The number of functions printed at once, 0 for the number of cores.
+ */
+void AsTVMScript(std::ostream& os, const ObjectRef& mod, bool show_meta, int num_threads);
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -404,6 +422,14 @@ class TextPrinter {
 
   bool GetVarName(::tvm::tir::Var v, std::string* s) { return tir_text_printer_.GetVarName(v, s); }
 
+  /*!
+   * \brief Elide the constants of more than the given bytes, kept out of the meta data.
+   * \param elide_constant_bytes The number of bytes, 0 to keep all the constants.
+   */
+  void SetElideConstantBytes(int64_t elide_constant_bytes) {
+    relay_text_printer_.elide_constant_bytes_ = elide_constant_bytes;
+  }
+
   Doc PrintFinal(const ObjectRef& node) {
     Doc doc;
     if (node->IsInstance<IRModuleNode>()) {
@@ -414,6 +440,13 @@ class TextPrinter {
     } else {
       doc << relay_text_printer_.PrintFinal(node);
     }
+    doc << PrintMetaSection();
+    return doc;
+  }
+
+  /*! \brief Print the metadata section, or the warning that it is omitted, after the text. */
+  Doc PrintMetaSection() {
+    Doc doc;
     if (!meta_.empty()) {
       doc << Doc::NewLine();
       if (show_meta_data_) {
@@ -429,7 +462,28 @@ class TextPrinter {
   }
 
   Doc PrintMod(const IRModule& mod);
+
+  /*!
+   * \brief Print a type definition or a function of a module.
+   * \param name The global type var or the global var.
+   * \param value The type definition or the function.
+   */
+  Doc PrintModEntry(const ObjectRef& name, const ObjectRef& value);
 };
+
+/*!
+ * \brief Print the entries of a module by printers of their own, in parallel, and write them in
+ *  order. The docs of a batch of entries are released once written, so that the text is never
+ *  held at once.
+ * \param os The stream to write to.
+ * \param num_entries The number of entries.
+ * \param num_threads The number of entries printed at once.
+ * \param fprint Print an entry, with an own meta data context the indices of which are deferred.
+ * \param meta The context the meta data of the entries is appended to.
+ */
+void StreamModEntries(std::ostream& os, int num_entries, int num_threads,
+                      const std::function<Doc(int, TextMetaDataContext*)>& fprint,
+                      TextMetaDataContext* meta);
 }  // namespace tvm
 
 #endif  // TVM_PRINTER_TEXT_PRINTER_H_
@@ -34,7 +34,9 @@
 #include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
+#include <fstream>
 #include <utility>
+#include <vector>
 
 #include "doc.h"
 #include "meta_data.h"
@@ -55,6 +57,7 @@ class TVMScriptPrinter : public StmtFunctor<Doc(const Stmt&)>,
   TVM_DLL Doc Print(const ObjectRef& node);
 
  private:
+  friend void AsTVMScript(std::ostream& os, const ObjectRef& mod, bool show_meta, int num_threads);
   /*! \brief whether show meta data */
   bool show_meta_;
   /*! \brief additional comment function */
@@ -1132,7 +1135,57 @@ String AsTVMScript(const ObjectRef& mod, bool show_meta) {
   return "@tvm.script.tir\n" + TVMScriptPrinter(show_meta).Print(mod).str() + "\n";
 }
 
-TVM_REGISTER_GLOBAL("script.AsTVMScript").set_body_typed(AsTVMScript);
+void AsTVMScript(std::ostream& os, const ObjectRef& mod, bool show_meta, int num_threads) {
+  ICHECK(mod->IsInstance<PrimFuncNode>() || mod->IsInstance<IRModuleNode>());
+  os << "@tvm.script.tir\n";
+  TVMScriptPrinter printer(show_meta);
+  const auto* module = mod.as<IRModuleNode>();
+  if (module == nullptr) {
+    printer.Print(mod).Print(os);
+    os << "\n";
+    return;
+  }
+  // Laid out as in PrintIRModule.
+  std::vector<std::pair<GlobalVar, PrimFunc>> funcs;
+  for (const auto& kv : module->functions) {
+    if (const auto* func = kv.second.as<PrimFuncNode>()) {
+      funcs.emplace_back(kv.first, GetRef<PrimFunc>(func));
+    }
+  }
+  os << "class Module:";
+  Doc::Indent(4, Doc::NewLine()).Print(os);
+  StreamModEntries(
+      os, static_cast<int>(funcs.size()), num_threads,
+      [&](int i, TextMetaDataContext* meta) {
+        TVMScriptPrinter func_printer(show_meta);
+        func_printer.meta_ = std::move(*meta);
+        func_printer.func2var_[funcs[i].second.get()] = funcs[i].first;
+        Doc doc;
+        if (i != 0) {
+          doc << Doc::NewLine() << Doc::NewLine();
+        }
+        doc << func_printer.Print(funcs[i].second);
+        *meta = std::move(func_printer.meta_);
+        return Doc::Indent(4, doc);
+      },
+      &printer.meta_);
+  Doc::Indent(4, Doc::NewLine() << printer.DumpMeta()).Print(os);
+  os << "\n";
+}
+
+void SaveTVMScript(const ObjectRef& mod, const std::string& file_name, bool show_meta,
+                   int num_threads) {
+  std::ofstream os(file_name);
+  ICHECK(os) << "Cannot open " << file_name << " to write";
+  AsTVMScript(os, mod, show_meta, num_threads);
+  ICHECK(os) << "Failed to write " << file_name;
+}
+
+TVM_REGISTER_GLOBAL("script.AsTVMScript").set_body_typed([](ObjectRef mod, bool show_meta) {
+  return AsTVMScript(mod, show_meta);
+});
+
+TVM_REGISTER_GLOBAL("script.SaveTVMScript").set_body_typed(SaveTVMScript);
 
 }  // namespace tir
 }  // namespace tvm
@@ -22,20 +22,28 @@
  * \brief Graph runtime codegen
  */
 
+#include <dmlc/json.h>
 #include <tvm/ir/module.h>
+#include <tvm/relay/attrs/memory.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/object.h>
+#include <tvm/target/target_kind.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt.h>
+#include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
 #include <algorithm>
 #include <list>
+#include <map>
+#include <set>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "compile_engine.h"
@@ -50,9 +58,16 @@ using TargetsMap = std::unordered_map<int, Target>;
 using StorageMap =
     std::unordered_map<Expr, StorageInfo, runtime::ObjectPtrHash, runtime::ObjectPtrEqual>;
 
+/*! \brief The PassContext option with the workspace pools of the AOT executor. */
+constexpr const char* kWorkspacePools = "relay.backend.workspace_pools";
+/*! \brief The PassContext option to profile the operator calls of the AOT executor. */
+constexpr const char* kAotProfile = "relay.backend.aot_profile";
+
 /**
  * This is an on demand allocator for AOT. A new temporary
  * (storage allocator identifier) is allocated for each operation.
+ * The temporaries are then placed by PlanBuffers, the temporaries
+ * that are not live at the same time share the same bytes.
  */
 class AOTOnDemandAllocator : public ExprVisitor {
  public:
@@ -65,12 +80,46 @@ class AOTOnDemandAllocator : public ExprVisitor {
     }
 
     GetStorage(func->body);
+    if (backend::IsInplaceEnabled()) {
+      AliasInplaceCalls();
+    }
   }
 
   std::vector<int> GetReturnIds() const { return return_ids_; }
 
   StorageMap GetStorageMap() const { return storage_device_map_; }
 
+  /*!
+   * \brief Get the lifetime of the temporaries of the operator calls.
+   *
+   *  The lifetime of a temporary goes from the call that produces it to the last call
+   *  that reads it, the calls are numbered in the order of their execution.
+   *  The inputs, the constants and the outputs are not temporaries.
+   *
+   * \return The first and the last call of each temporary sid.
+   */
+  std::map<int, std::pair<size_t, size_t>> GetLiveIntervals() const {
+    std::map<int, std::pair<size_t, size_t>> intervals;
+    for (size_t step = 0; step < call_order_.size(); ++step) {
+      const CallNode* call = call_order_[step].as<CallNode>();
+      for (const Expr& arg : call->args) {
+        auto it = storage_device_map_.find(arg);
+        if (it == storage_device_map_.end()) continue;
+        for (auto sid : it->second->storage_ids) {
+          auto iit = intervals.find(sid);
+          if (iit != intervals.end()) iit->second.second = step;
+        }
+      }
+      const StorageInfo& sinfo = storage_device_map_.at(call_order_[step]);
+      for (auto sid : sinfo->storage_ids) {
+        if (std::find(return_ids_.begin(), return_ids_.end(), sid) != return_ids_.end()) continue;
+        // a call computing in place keeps the temporary of its argument alive.
+        intervals.emplace(sid, std::make_pair(step, step));
+      }
+    }
+    return intervals;
+  }
+
   void VisitExpr_(const ConstantNode* op) final {
     CreateStorage(op);
     AssignReturnSid(GetRef<Expr>(op));
@@ -82,6 +131,7 @@ class AOTOnDemandAllocator : public ExprVisitor {
     for (Expr arg : op->args) {
       GetStorage(arg);
     }
+    call_order_.push_back(GetRef<Expr>(op));
     AssignReturnSid(GetRef<Expr>(op));
   }
 
@@ -134,6 +184,51 @@ class AOTOnDemandAllocator : public ExprVisitor {
   void VisitExpr_(const LetNode* op) final { LOG(FATAL) << "let is not supported."; }
 
  private:
+  /*!
+   * \brief Let the calls computing in place write their output over an argument.
+   *
+   *  The argument needs to be a temporary that is not read after the call, the
+   *  output then takes the sid of the argument.
+   */
+  void AliasInplaceCalls() {
+    std::map<int, std::pair<size_t, size_t>> intervals = GetLiveIntervals();
+    std::unordered_map<int64_t, int64_t> alias;
+    auto resolve = [&alias](int64_t sid) {
+      for (auto it = alias.find(sid); it != alias.end(); it = alias.find(sid)) sid = it->second;
+      return sid;
+    };
+    for (size_t step = 0; step < call_order_.size(); ++step) {
+      const auto* call = call_order_[step].as<CallNode>();
+      const StorageInfo& sinfo = storage_device_map_.at(call_order_[step]);
+      if (sinfo->storage_ids.size() != 1) continue;
+      auto out_it = intervals.find(sinfo->storage_ids[0]);
+      if (out_it == intervals.end()) continue;
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        auto it = storage_device_map_.find(call->args[i]);
+        if (it == storage_device_map_.end() || it->second->storage_ids.size() != 1 ||
+            it->second->device_types[0] != sinfo->device_types[0] ||
+            !backend::CanComputeInplace(call, i)) {
+          continue;
+        }
+        auto in_it = intervals.find(resolve(it->second->storage_ids[0]));
+        if (in_it == intervals.end() || in_it->second.second != step) continue;
+        alias[out_it->first] = in_it->first;
+        in_it->second.second = out_it->second.second;
+        intervals.erase(out_it);
+        break;
+      }
+    }
+    if (alias.empty()) return;
+    for (auto& kv : storage_device_map_) {
+      std::vector<int64_t> storage_ids;
+      for (auto sid : kv.second->storage_ids) {
+        storage_ids.push_back(resolve(sid));
+      }
+      kv.second = StorageInfo(storage_ids, kv.second->device_types,
+                              kv.second->storage_sizes_in_bytes);
+    }
+  }
+
   void AssignReturnSid(Expr e) {
     if (storage_device_map_.find(e) != storage_device_map_.end()) {
       StorageInfo& sinfo = storage_device_map_[e];
@@ -216,8 +311,141 @@ class AOTOnDemandAllocator : public ExprVisitor {
   int next_available_sid_{0};
   /*! \brief the set of intermediate tensors that are return variables */
   std::vector<int> return_ids_;
+  /*! \brief the operator calls, in the order of their execution */
+  std::vector<Expr> call_order_;
 };
 
+/*!
+ * \brief Move the workspaces of an operator to its parameters, so that the
+ *  main function gives their memory instead of the runtime allocator.
+ *
+ *  The global allocations of constant size that are not in a parallel loop
+ *  or a thread are moved, they become buffer parameters after the other ones.
+ */
+class WorkspaceExtractor : public tir::StmtExprMutator {
+ public:
+  /*!
+   * \brief Extract the workspaces of the operator.
+   * \param func The operator.
+   * \return The rewritten operator and the size in bytes of each workspace parameter.
+   */
+  std::pair<tir::PrimFunc, std::vector<int64_t>> Extract(tir::PrimFunc func) {
+    auto* n = func.CopyOnWrite();
+    n->body = this->VisitStmt(n->body);
+    for (const auto& buffer : buffers_) {
+      n->params.push_back(buffer->data);
+      n->buffer_map.Set(buffer->data, buffer);
+    }
+    return {func, sizes_};
+  }
+
+ private:
+  tir::Stmt VisitStmt_(const tir::ForNode* op) final {
+    if (op->kind == tir::ForKind::kSerial || op->kind == tir::ForKind::kUnrolled) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    ++num_parallel_scopes_;
+    tir::Stmt ret = StmtExprMutator::VisitStmt_(op);
+    --num_parallel_scopes_;
+    return ret;
+  }
+
+  tir::Stmt VisitStmt_(const tir::AttrStmtNode* op) final {
+    if (op->attr_key == tir::attr::thread_extent || op->attr_key == tir::attr::virtual_thread) {
+      ++num_parallel_scopes_;
+      tir::Stmt ret = StmtExprMutator::VisitStmt_(op);
+      --num_parallel_scopes_;
+      return ret;
+    }
+    const auto* alloc = op->body.as<tir::AllocateNode>();
+    const auto* scope = op->value.as<tir::StringImmNode>();
+    if (op->attr_key == tir::attr::storage_scope && alloc != nullptr &&
+        alloc->buffer_var.same_as(op->node) && scope != nullptr && scope->value == "global" &&
+        num_parallel_scopes_ == 0 && tir::is_one(alloc->condition)) {
+      int32_t num_elements = alloc->constant_allocation_size();
+      if (num_elements > 0) {
+        buffers_.push_back(tir::Buffer(alloc->buffer_var, alloc->dtype, {num_elements}, {},
+                                       PrimExpr(), alloc->buffer_var->name_hint, "global", 0, 0,
+                                       tir::kDefault));
+        sizes_.push_back(static_cast<int64_t>(num_elements) *
+                         ((alloc->dtype.bits() * alloc->dtype.lanes() + 7) / 8));
+        return this->VisitStmt(alloc->body);
+      }
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  /*! \brief the number of enclosing parallel loops and threads */
+  int num_parallel_scopes_{0};
+  /*! \brief the extracted workspaces */
+  std::vector<tir::Buffer> buffers_;
+  std::vector<int64_t> sizes_;
+};
+
+/*! \brief A buffer of the main function, placed in a memory pool at compile time. */
+struct PlannedBuffer {
+  /*! \brief the variable of the buffer in the main function */
+  tir::Var var;
+  /*! \brief the size in bytes, aligned */
+  int64_t size;
+  /*! \brief the first and the last call using the buffer */
+  size_t begin;
+  size_t end;
+  /*! \brief the pool and the byte offset in the pool, set by PlanBuffers */
+  int pool{-1};
+  int64_t offset{0};
+};
+
+/*!
+ * \brief Place the buffers in the memory pools.
+ *
+ *  The buffers are placed by decreasing size. Each one goes in the first pool
+ *  where it fits, at the lowest offset that does not overlap a placed buffer
+ *  of the same pool whose lifetime intersects its own.
+ *
+ * \param buffers The buffers to place.
+ * \param pool_sizes The size of the pools, in the order they are tried, -1 for no limit.
+ * \return The used size of each pool.
+ */
+std::vector<int64_t> PlanBuffers(std::vector<PlannedBuffer>* buffers,
+                                 const std::vector<int64_t>& pool_sizes) {
+  std::vector<PlannedBuffer*> order;
+  for (auto& buffer : *buffers) {
+    order.push_back(&buffer);
+  }
+  std::stable_sort(order.begin(), order.end(), [](const PlannedBuffer* a, const PlannedBuffer* b) {
+    return a->size > b->size;
+  });
+
+  std::vector<int64_t> used(pool_sizes.size(), 0);
+  std::vector<std::vector<const PlannedBuffer*>> placed(pool_sizes.size());
+  for (PlannedBuffer* cur : order) {
+    for (size_t pool = 0; pool < pool_sizes.size() && cur->pool < 0; ++pool) {
+      // the placed buffers live at the same time as cur, by offset.
+      std::vector<std::pair<int64_t, int64_t>> conflicts;
+      for (const PlannedBuffer* other : placed[pool]) {
+        if (other->begin <= cur->end && cur->begin <= other->end) {
+          conflicts.emplace_back(other->offset, other->offset + other->size);
+        }
+      }
+      std::sort(conflicts.begin(), conflicts.end());
+      int64_t offset = 0;
+      for (const auto& range : conflicts) {
+        if (range.first - offset >= cur->size) break;
+        offset = std::max(offset, range.second);
+      }
+      if (pool_sizes[pool] >= 0 && offset + cur->size > pool_sizes[pool]) continue;
+      cur->pool = static_cast<int>(pool);
+      cur->offset = offset;
+      placed[pool].push_back(cur);
+      used[pool] = std::max(used[pool], offset + cur->size);
+    }
+    ICHECK_GE(cur->pool, 0) << "The workspace pools are too small, cannot place a buffer of "
+                            << cur->size << " bytes";
+  }
+  return used;
+}
+
 /*! \brief Code generator for AOT executor */
 class AOTExecutorCodegen : public ExprVisitor {
  protected:
@@ -281,39 +509,112 @@ class AOTExecutorCodegen : public ExprVisitor {
     }
   }
 
+  /*!
+   * \brief The handle of a parameter: its linked symbol with the C runtime, or an
+   *  argument of the main function, given by the executor, with the C++ runtime.
+   */
+  PrimExpr ParamHandle(const std::string& name) {
+    if (!cpp_runtime_) {
+      return tir::Call(DataType::Handle(), tir::builtin::lookup_param(), {tir::StringImm(name)});
+    }
+    auto it = param_vars_.find(name);
+    if (it == param_vars_.end()) {
+      it = param_vars_.emplace(name, tir::Var(MakeString("param_", name), DataType::Handle()))
+               .first;
+      param_names_.push_back(name);
+    }
+    return it->second;
+  }
+
+  /*! \brief Whether a variable is an argument of the main function. */
+  bool IsMainArg(const tir::Var& var) const {
+    for (const auto& arg : main_signature_) {
+      if (arg.same_as(var)) return true;
+    }
+    return false;
+  }
+
+  /*!
+   * \brief The argument of an operator call for a buffer of the main function.
+   *
+   *  With the C++ runtime the operators check their arguments, so the temporaries
+   *  are passed as DLTensors with their shape, type and device, the main function
+   *  arguments already are.
+   */
+  PrimExpr TensorArg(const tir::Var& var, const TensorType& ttype) {
+    if (!cpp_runtime_ || IsMainArg(var)) return var;
+    PrimExpr shape_ptr =
+        tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_shape(), ttype->shape);
+    return tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_array(),
+                     {var, shape_ptr, tir::make_zero(DataType::Handle()),
+                      ConstInt32(ttype->shape.size()), tir::make_zero(ttype->dtype),
+                      ConstInt32(0)});
+  }
+
   /*!
    * brief Call a function with a given name
+   * \param external Whether the function is in an external module, looked up by
+   *  name once instead of called by its symbol.
    */
-  void CreateFuncCall(Call call, std::string func_name) {
+  void CreateFuncCall(Call call, std::string func_name, bool external = false) {
     tvm::Array<PrimExpr> args{tvm::tir::StringImm(func_name)};
     std::vector<tir::Stmt> create_func_call_stmts;
 
     // Pack the inputs
     for (Expr arg : call->args) {
       if (params_by_expr_.find(arg) != params_by_expr_.end()) {
-        auto param_handle = tvm::tir::Call(DataType::Handle(), tvm::tir::builtin::lookup_param(),
-                                           {tir::StringImm(params_by_expr_[arg])});
-        args.push_back(param_handle);
+        args.push_back(ParamHandle(params_by_expr_[arg]));
       } else {
         auto var_arg = FindExpr(arg);
-        args.push_back(var_arg[0]);
+        args.push_back(TensorArg(var_arg[0], FlattenTupleType(arg->checked_type())[0]));
       }
     }
 
     auto ret_expr = Downcast<Expr>(call);
     // Pack the return(s) value. A call node can produce multiple outputs
-    for (const auto& var : PackSid(ret_expr)) {
-      args.push_back(var);
+    std::vector<TensorType> ret_types = FlattenTupleType(call->checked_type());
+    std::vector<tir::Var> ret_vars = PackSid(ret_expr);
+    for (size_t i = 0; i < ret_vars.size(); ++i) {
+      args.push_back(TensorArg(ret_vars[i], ret_types[i]));
+    }
+
+    // Pass the workspaces moved out of the operator, they only live during the call
+    auto ws_iter = operator_workspaces_.find(func_name);
+    if (ws_iter != operator_workspaces_.end()) {
+      for (int64_t size : ws_iter->second.second) {
+        te::Var ws_var(MakeString("workspace_", planned_buffers_.size()),
+                       PointerType(PrimType(DataType::Int(8))));
+        PlannedBuffer buffer;
+        buffer.var = ws_var;
+        buffer.size = AlignSize(size);
+        buffer.begin = buffer.end = num_calls_;
+        planned_buffers_.push_back(buffer);
+        args.push_back(ws_var);
+      }
     }
+    int call_index = static_cast<int>(num_calls_++);
 
     // Use tvm_call_packed to execute the function unless we're calling directly
     auto calling_pattern = tvm::tir::builtin::tvm_call_cpacked();
     if (use_unpacked_api_) {
       calling_pattern = tvm::tir::builtin::call_extern();
+    } else if (cpp_runtime_ && external) {
+      calling_pattern = tvm::tir::builtin::tvm_call_packed();
     }
 
+    // Read the cycle counter around the call when profiling
+    if (profile_) {
+      create_func_call_stmts.push_back(tir::Evaluate(
+          tvm::tir::Call(DataType::Int(32), tvm::tir::builtin::call_extern(),
+                         {tir::StringImm("TVMBackendProfileBegin"), call_index})));
+    }
     create_func_call_stmts.push_back(
         tir::Evaluate(tvm::tir::Call(DataType::Int(32), calling_pattern, args)));
+    if (profile_) {
+      create_func_call_stmts.push_back(tir::Evaluate(tvm::tir::Call(
+          DataType::Int(32), tvm::tir::builtin::call_extern(),
+          {tir::StringImm("TVMBackendProfileEnd"), call_index, tir::StringImm(func_name)})));
+    }
 
     tir::Stmt body = tir::SeqStmt(create_func_call_stmts);
     stmts_.push_back(body);
@@ -326,6 +627,14 @@ class AOTExecutorCodegen : public ExprVisitor {
    * copy-on-write fashion.
    */
   void CopyToOutput(PrimExpr out, PrimExpr in, bool pack_input, size_t size) {
+    // The runtime copies the DLTensors, they may be on a device
+    if (cpp_runtime_) {
+      stmts_.push_back(tir::Evaluate(
+          tir::Call(DataType::Int(32), tir::builtin::call_extern(),
+                    {tir::StringImm("TVMArrayCopyFromTo"), in, out,
+                     tir::make_zero(DataType::Handle())})));
+      return;
+    }
     // Define intermediate DLTensor to load/store the data
     auto tmp0 = te::Var("tmp0", DataType::Handle());
     auto tmp1 = te::Var("tmp1", DataType::Handle());
@@ -365,6 +674,42 @@ class AOTExecutorCodegen : public ExprVisitor {
     return ss.str();
   }
 
+  /*! \brief Round a size up to the workspace alignment. */
+  int64_t AlignSize(int64_t size) {
+    return (size + workspace_byte_alignment_ - 1) / workspace_byte_alignment_ *
+           workspace_byte_alignment_;
+  }
+
+  /*!
+   * \brief Place the planned buffers in the workspace pools, the cheapest pools first,
+   *  or in one arena of the main function when there is no pool.
+   */
+  void PlanMemory() {
+    if (pools_.empty()) {
+      pool_used_sizes_ = PlanBuffers(&planned_buffers_, {-1});
+      return;
+    }
+    std::vector<int> order(pools_.size());
+    for (size_t i = 0; i < pools_.size(); ++i) {
+      order[i] = static_cast<int>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+      return pools_[a]->access_cost->value < pools_[b]->access_cost->value;
+    });
+    std::vector<int64_t> pool_sizes;
+    for (int i : order) {
+      pool_sizes.push_back(pools_[i]->size_bytes->value);
+    }
+    std::vector<int64_t> used = PlanBuffers(&planned_buffers_, pool_sizes);
+    pool_used_sizes_.assign(pools_.size(), 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+      pool_used_sizes_[order[i]] = used[i];
+    }
+    for (auto& buffer : planned_buffers_) {
+      buffer.pool = order[buffer.pool];
+    }
+  }
+
   /*!
    * \brief Update the "main" control function's metadata
    *
@@ -383,6 +728,9 @@ class AOTExecutorCodegen : public ExprVisitor {
     }
     fi_node->workspace_sizes.Set(target_host_, workspace_size);
     fi_node->relay_primfuncs.Set(target_host_, func);
+    for (size_t i = 0; i < pools_.size(); ++i) {
+      fi_node->workspace_pool_sizes.Set(pools_[i]->pool_name, pool_used_sizes_[i]);
+    }
 
     int64_t io_size = 0;
     for (const auto& input : input_vars_) {
@@ -412,6 +760,10 @@ class AOTExecutorCodegen : public ExprVisitor {
     auto fi_node = make_object<FunctionInfoNode>();
     for (const auto& kv : cfunc->funcs->functions) {
       auto primfunc = Downcast<tir::PrimFunc>(kv.second);
+      auto ws_iter = operator_workspaces_.find(kv.first->name_hint);
+      if (ws_iter != operator_workspaces_.end()) {
+        primfunc = ws_iter->second.first;
+      }
       auto workspace_byte_alignment =
           target_host_->GetAttr<Integer>("workspace-byte-alignment").value_or(16);
       Integer workspace_size = CalculateWorkspaceBytes(primfunc, workspace_byte_alignment);
@@ -476,7 +828,7 @@ class AOTExecutorCodegen : public ExprVisitor {
       UpdateConstants(func, &params_);
 
       // Generate the TIR function call
-      CreateFuncCall(GetRef<Call>(op), ext_func->prim_fn_var->name_hint);
+      CreateFuncCall(GetRef<Call>(op), ext_func->prim_fn_var->name_hint, /*external*/ true);
       return;
     }
 
@@ -509,6 +861,19 @@ class AOTExecutorCodegen : public ExprVisitor {
       lowered_funcs_[target->str()] = IRModule(Map<GlobalVar, BaseFunc>({}));
     }
     lowered_funcs_[target->str()]->Update(lowered_func->funcs);
+    // Let the main function give the workspaces of the operator from the pools, with
+    // the C++ runtime the operators allocate them from the workspace pool of the device.
+    if (!pools_.empty() && !cpp_runtime_) {
+      const GlobalVar& prim_fn_var = lowered_func->prim_fn_var;
+      auto ws_iter = operator_workspaces_.find(prim_fn_var->name_hint);
+      if (ws_iter == operator_workspaces_.end()) {
+        auto prim_func = Downcast<tir::PrimFunc>(lowered_func->funcs->Lookup(prim_fn_var));
+        ws_iter = operator_workspaces_
+                      .emplace(prim_fn_var->name_hint, WorkspaceExtractor().Extract(prim_func))
+                      .first;
+      }
+      lowered_funcs_[target->str()]->Update(prim_fn_var, ws_iter->second.first);
+    }
     // Update function metadata via looking at all primfuncs
     UpdateFunctionMetadata(lowered_func, func, target);
 
@@ -526,9 +891,8 @@ class AOTExecutorCodegen : public ExprVisitor {
     if (output_iter != return_sid_.end()) {
       int output_index = std::distance(return_sid_.begin(), output_iter);
       if (params_by_expr_.find(expr) != params_by_expr_.end()) {
-        auto param_handle = tvm::tir::Call(DataType::Handle(), tvm::tir::builtin::lookup_param(),
-                                           {tir::StringImm(params_by_expr_[expr])});
-        CopyToOutput(main_signature_[input_vars_.size() + output_index], param_handle,
+        CopyToOutput(main_signature_[input_vars_.size() + output_index],
+                     ParamHandle(params_by_expr_[expr]),
                      /*pack_input*/ true, sinfo->storage_sizes_in_bytes[0]);
       } else {
         auto var_expr = FindExpr(expr);
@@ -552,9 +916,7 @@ class AOTExecutorCodegen : public ExprVisitor {
     auto output_iter = std::find(return_sid_.begin(), return_sid_.end(), sinfo->storage_ids[0]);
     if (output_iter != return_sid_.end()) {
       int output_index = std::distance(return_sid_.begin(), output_iter);
-      auto param_handle = tvm::tir::Call(DataType::Handle(), tvm::tir::builtin::lookup_param(),
-                                         {tir::StringImm(params_by_expr_[expr])});
-      CopyToOutput(main_signature_[input_vars_.size() + output_index], param_handle, false,
+      CopyToOutput(main_signature_[input_vars_.size() + output_index], ParamHandle(name), false,
                    sinfo->storage_sizes_in_bytes[0]);
     }
   }
@@ -601,6 +963,17 @@ class AOTExecutorCodegen : public ExprVisitor {
   tir::PrimFunc CreateMainFunc(unsigned int relay_params) {
     tir::Stmt body = tir::SeqStmt(stmts_);
 
+    // Point the planned buffers in their pool, or in the arena of the main function
+    Map<tir::Var, PrimExpr> buffer_ptrs;
+    for (const auto& buffer : planned_buffers_) {
+      tir::Var base = pools_.empty() ? arena_ : pool_vars_[buffer.pool];
+      buffer_ptrs.Set(buffer.var, tir::Call(DataType::Handle(), tir::builtin::tvm_access_ptr(),
+                                            {tir::TypeAnnotation(DataType::Int(8)), base,
+                                             ConstInt32(buffer.offset), ConstInt32(buffer.size),
+                                             tir::make_const(DataType::Int(32), 3)}));
+    }
+    body = tir::Substitute(body, buffer_ptrs);
+
     // Allocate the sids
     std::unordered_map<int, bool> allocated;
 
@@ -621,6 +994,11 @@ class AOTExecutorCodegen : public ExprVisitor {
           continue;
         }
 
+        // The planned sids are already placed
+        if (buffer_ptrs.count(sids_table_[sid])) {
+          continue;
+        }
+
         // TODO(giuseros): we should allocate this once outside the PrimFunc
         // so we don't pay the price of allocation for every inference
         if (!allocated[sid]) {
@@ -632,9 +1010,30 @@ class AOTExecutorCodegen : public ExprVisitor {
       }
     }
 
-    // Define the attributes
-    body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_type, 1, body);
-    body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_id, 0, body);
+    // Allocate the arena of the planned buffers when there is no pool, the executor of
+    // the C++ runtime gives it
+    if (pools_.empty() && !planned_buffers_.empty() && !cpp_runtime_) {
+      body = tir::Allocate(arena_, DataType::Int(8), {ConstInt32(pool_used_sizes_[0])},
+                           tir::const_true(), body);
+      body = tir::AttrStmt(arena_, tir::attr::storage_scope, tir::StringImm("global"), body);
+    }
+
+    // Define the attributes. With the C++ runtime the model runs on the device of its
+    // outputs, a CPU or a GPU.
+    if (cpp_runtime_) {
+      const tir::Var& output = main_signature_[input_vars_.size()];
+      body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_type,
+                           tir::Call(DataType::Int(32), tir::builtin::tvm_struct_get(),
+                                     {output, 0, tir::builtin::kArrDeviceType}),
+                           body);
+      body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_id,
+                           tir::Call(DataType::Int(32), tir::builtin::tvm_struct_get(),
+                                     {output, 0, tir::builtin::kArrDeviceId}),
+                           body);
+    } else {
+      body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_type, 1, body);
+      body = tir::AttrStmt(PrimExpr(), tvm::tir::attr::device_id, 0, body);
+    }
 
     // Define the PrimFunc attributes
     Map<String, ObjectRef> dict_attrs;
@@ -685,6 +1084,25 @@ class AOTExecutorCodegen : public ExprVisitor {
   StorageMap storage_device_map_;
   /*! \brief mapping sid -> tir::Var */
   std::unordered_map<int, te::Var> sids_table_;
+  /*! \brief the workspace pools given by the user, passed to the main function */
+  std::vector<PoolInfo> pools_;
+  /*! \brief the parameters of the main function for the workspace pools */
+  std::vector<tir::Var> pool_vars_;
+  /*! \brief the arena of the planned buffers when there is no workspace pool */
+  te::Var arena_{"sid_arena", PointerType(PrimType(DataType::Int(8)))};
+  /*! \brief the buffers placed at compile time, the temporaries and the operator workspaces */
+  std::vector<PlannedBuffer> planned_buffers_;
+  /*! \brief the used size of each pool, or of the arena */
+  std::vector<int64_t> pool_used_sizes_;
+  /*! \brief mapping operator name -> operator taking its workspaces, and their sizes */
+  std::unordered_map<std::string, std::pair<tir::PrimFunc, std::vector<int64_t>>>
+      operator_workspaces_;
+  /*! \brief the number of operator calls generated so far */
+  size_t num_calls_{0};
+  /*! \brief whether to read the cycle counter around the operator calls */
+  bool profile_{false};
+  /*! \brief the byte alignment of the planned buffers */
+  int64_t workspace_byte_alignment_;
   /*! \brief lowered funcs */
   std::unordered_map<std::string, IRModule> lowered_funcs_;
   /*! \brief lowered funcs */
@@ -697,6 +1115,65 @@ class AOTExecutorCodegen : public ExprVisitor {
   std::vector<int> return_sid_;
   /*! \brief the module name we use to mangle the function names */
   String mod_name_;
+  /*!
+   * \brief whether the main function runs with the C++ runtime rather than the C
+   *  runtime. Its parameters and arena are then arguments given by the executor.
+   */
+  bool cpp_runtime_;
+  /*! \brief the arguments of the main function for the parameters, with the C++ runtime */
+  std::unordered_map<std::string, tir::Var> param_vars_;
+  /*! \brief the names of the parameters, in the order of their arguments */
+  std::vector<std::string> param_names_;
+
+  /*!
+   * \brief The configuration of the executor of the C++ runtime: the run function,
+   *  the names, shapes and types of the inputs, the outputs, the parameter
+   *  arguments and the size of the pools and of the arena.
+   */
+  std::string ExecutorConfig(const Function& func, const String& run_func_name) {
+    auto int_shape = [](const TensorType& ttype) {
+      std::vector<int64_t> shape;
+      for (const auto& dim : ttype->shape) {
+        const int64_t* value = tir::as_const_int(dim);
+        ICHECK(value != nullptr) << "The AOT executor needs static shapes, got " << ttype->shape;
+        shape.push_back(*value);
+      }
+      return shape;
+    };
+    std::vector<std::string> input_names, input_dtypes, output_dtypes;
+    std::vector<std::vector<int64_t>> input_shapes, output_shapes;
+    for (const auto& param : func->params) {
+      TensorType ttype = FlattenTupleType(param->checked_type())[0];
+      input_names.push_back(param->name_hint());
+      input_shapes.push_back(int_shape(ttype));
+      input_dtypes.push_back(runtime::DLDataType2String(ttype->dtype));
+    }
+    for (const auto& ttype : FlattenTupleType(func->body->checked_type())) {
+      output_shapes.push_back(int_shape(ttype));
+      output_dtypes.push_back(runtime::DLDataType2String(ttype->dtype));
+    }
+    std::vector<int64_t> pool_sizes;
+    int64_t arena_size = 0;
+    if (pools_.empty()) {
+      arena_size = pool_used_sizes_[0];
+    } else {
+      pool_sizes = pool_used_sizes_;
+    }
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("run_func", std::string(run_func_name));
+    writer.WriteObjectKeyValue("input_names", input_names);
+    writer.WriteObjectKeyValue("input_shapes", input_shapes);
+    writer.WriteObjectKeyValue("input_dtypes", input_dtypes);
+    writer.WriteObjectKeyValue("output_shapes", output_shapes);
+    writer.WriteObjectKeyValue("output_dtypes", output_dtypes);
+    writer.WriteObjectKeyValue("param_names", param_names_);
+    writer.WriteObjectKeyValue("pool_sizes", pool_sizes);
+    writer.WriteObjectKeyValue("arena_size", arena_size);
+    writer.EndObject();
+    return os.str();
+  }
 
  public:
   AOTExecutorCodegen(runtime::Module* mod, const TargetsMap& targets, Target target_host)
@@ -704,7 +1181,8 @@ class AOTExecutorCodegen : public ExprVisitor {
         targets_(targets),
         target_host_(target_host),
         use_unpacked_api_(target_host->GetAttr<Bool>("unpacked-api").value_or(Bool(false))),
-        compile_engine_(CompileEngine::Global()) {}
+        compile_engine_(CompileEngine::Global()),
+        cpp_runtime_(target_host->GetAttr<String>("runtime").value_or("") != kTvmRuntimeCrt) {}
 
   LoweredOutput Codegen(relay::Function func, String mod_name) {
     auto aot_allocator = AOTOnDemandAllocator();
@@ -713,6 +1191,19 @@ class AOTExecutorCodegen : public ExprVisitor {
     // Retrieve the storage map
     storage_device_map_ = aot_allocator.GetStorageMap();
     mod_name_ = mod_name;
+    workspace_byte_alignment_ = target_host_->GetAttr<Integer>("workspace-byte-alignment")
+                                    .value_or(tvm::runtime::kDefaultWorkspaceAlignment)
+                                    ->value;
+    auto pools = transform::PassContext::Current()
+                     ->GetConfig<Array<ObjectRef>>(kWorkspacePools, Array<ObjectRef>())
+                     .value();
+    profile_ = transform::PassContext::Current()->GetConfig<Bool>(kAotProfile, Bool(false)).value();
+    for (const auto& pool : pools) {
+      ICHECK(pool->IsInstance<PoolInfoNode>())
+          << "ValueError: " << kWorkspacePools << " expects PoolInfo, but gets "
+          << pool->GetTypeKey();
+      pools_.push_back(Downcast<PoolInfo>(pool));
+    }
 
     for (auto input : func->params) {
       input_vars_.push_back(input);
@@ -733,8 +1224,51 @@ class AOTExecutorCodegen : public ExprVisitor {
       main_signature_.push_back(tir::Var("output", DataType::Handle()));
     }
 
+    // The workspace pools come after the outputs
+    for (const auto& pool : pools_) {
+      pool_vars_.push_back(tir::Var(MakeString("pool_", pool->pool_name), DataType::Handle()));
+      main_signature_.push_back(pool_vars_.back());
+    }
+
+    // The temporaries are placed with the operator workspaces after the calls
+    std::unordered_map<int, int64_t> sid_sizes;
+    for (const auto& kv : storage_device_map_) {
+      for (size_t i = 0; i < kv.second->storage_ids.size(); ++i) {
+        sid_sizes[kv.second->storage_ids[i]] = kv.second->storage_sizes_in_bytes[i];
+      }
+    }
+    for (const auto& kv : aot_allocator.GetLiveIntervals()) {
+      PlannedBuffer buffer;
+      buffer.var = sids_table_[kv.first];
+      buffer.size = AlignSize(sid_sizes[kv.first]);
+      buffer.begin = kv.second.first;
+      buffer.end = kv.second.second;
+      planned_buffers_.push_back(buffer);
+    }
+
     VisitExpr(func->body);
 
+    PlanMemory();
+
+    // With the C++ runtime the parameters and the arena come after the pools
+    if (cpp_runtime_) {
+      ICHECK(!use_unpacked_api_) << "The AOT executor of the C++ runtime uses the packed API";
+      std::set<int> device_types;
+      for (const auto& kv : storage_device_map_) {
+        for (auto device_type : kv.second->device_types) {
+          if (device_type != 0) device_types.insert(device_type);
+        }
+      }
+      ICHECK_LE(device_types.size(), 1U)
+          << "The AOT executor of the C++ runtime runs a model on a single device";
+      for (const auto& name : param_names_) {
+        main_signature_.push_back(param_vars_.at(name));
+      }
+      if (pools_.empty()) {
+        main_signature_.push_back(arena_);
+      }
+    }
+
     // Create the runner function. Please note that the function is not legal yet
     // because the packed calls arguments are not wrapped in TVMValues. To make this happen we need
     // to run the LegalizePackedCalls pass.
@@ -769,8 +1303,9 @@ class AOTExecutorCodegen : public ExprVisitor {
     mod_run = storage_rewrite(mod_run);
 
     // Legalize AOT if needed. This means that all the packed calls
-    // need to be wrapped in TVMValues (unless use_unpacked_api is set)
-    if (!use_unpacked_api_) {
+    // need to be wrapped in TVMValues (unless use_unpacked_api is set). With the
+    // C++ runtime the arguments already are DLTensors.
+    if (!use_unpacked_api_ && !cpp_runtime_) {
       auto pack_calls = tir::transform::LegalizePackedCalls();
       mod_run = pack_calls(mod_run);
     }
@@ -782,13 +1317,20 @@ class AOTExecutorCodegen : public ExprVisitor {
     } else {
       ret.lowered_funcs.Set(target_host_str, mod_run);
     }
+    if (cpp_runtime_) {
+      ret.graph_json = ExecutorConfig(
+          func, runtime::get_name_mangled(mod_name_, runtime::symbol::tvm_run_func_suffix));
+    }
     ret.function_metadata = std::move(function_metadata_);
     ret.metadata = runtime::Metadata(input_vars_.size(), return_sid_.size(),
-                                     runtime::kTvmExecutorAot, mod_name);
+                                     runtime::kTvmExecutorAot, mod_name, pools_.size());
     return ret;
   }
 };
 
+TVM_REGISTER_PASS_CONFIG_OPTION(kWorkspacePools, Array<PoolInfo>);
+TVM_REGISTER_PASS_CONFIG_OPTION(kAotProfile, Bool);
+
 class AOTExecutorCodegenModule : public runtime::ModuleNode {
  public:
   AOTExecutorCodegenModule() {}
@@ -833,6 +1375,9 @@ class AOTExecutorCodegenModule : public runtime::ModuleNode {
     } else if (name == "get_metadata") {
       return PackedFunc(
           [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = output_.metadata; });
+    } else if (name == "get_executor_config") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = output_.graph_json; });
     } else {
       return PackedFunc([](TVMArgs args, TVMRetValue* rv) {});
     }
@@ -852,6 +1397,16 @@ class AOTExecutorCodegenModule : public runtime::ModuleNode {
       ICHECK(dev_type);
       targets[dev_type->value] = it.second;
     }
+    // The main function of a model on a GPU runs on the host of its target
+    if (!target_host.defined()) {
+      for (const auto& it : tmp) {
+        if (it.second->GetHost().defined()) {
+          target_host = it.second->GetHost().value();
+          break;
+        }
+      }
+    }
+    ICHECK(target_host.defined()) << "The AOT executor needs a CPU or a host target";
     codegen_ = std::make_shared<AOTExecutorCodegen>(reinterpret_cast<runtime::Module*>(mod),
                                                     targets, target_host);
   }
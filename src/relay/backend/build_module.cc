@@ -46,6 +46,24 @@ namespace backend {
 using TargetsMap = Map<tvm::Integer, tvm::Target>;
 using namespace tvm::relay::transform;
 
+/*! \brief The expressions kept by the common subexpression elimination, the casts to int32 */
+static PackedFunc CSESkip() {
+  return PackedFunc([](TVMArgs args, TVMRetValue* rv) {
+    Expr expr = args[0];
+    *rv = false;
+    if (expr.as<CallNode>()) {
+      auto call_node = expr.as<CallNode>();
+      auto op_node = call_node->op.as<OpNode>();
+      if (op_node && op_node->name == "cast") {
+        auto attrs = call_node->attrs.as<CastAttrs>();
+        if (attrs->dtype == DataType::Int(32)) {
+          *rv = true;
+        }
+      }
+    }
+  });
+}
+
 /*!
  * \brief Output of building module
  */
@@ -120,7 +138,10 @@ struct AOTCodegen : ExecutorCodegen {
     mod = (*pf)();
   }
 
-  void UpdateOutput(BuildOutput* ret) override { ret->graph_json = ""; }
+  // The configuration of the executor of the C++ runtime, empty with the C runtime.
+  void UpdateOutput(BuildOutput* ret) override {
+    ret->graph_json = CallFunc<std::string>("get_executor_config", nullptr);
+  }
 
   ~AOTCodegen() {}
 };
@@ -331,21 +352,7 @@ class RelayBuildModule : public runtime::ModuleNode {
     // Convert Dynamic ops to static versions
     pass_seqs.push_back(transform::DynamicToStatic());
 
-    PackedFunc fskip = PackedFunc([](TVMArgs args, TVMRetValue* rv) {
-      Expr expr = args[0];
-      *rv = false;
-      if (expr.as<CallNode>()) {
-        auto call_node = expr.as<CallNode>();
-        auto op_node = call_node->op.as<OpNode>();
-        if (op_node->name == "cast") {
-          auto attrs = call_node->attrs.as<CastAttrs>();
-          if (attrs->dtype == DataType::Int(32)) {
-            *rv = true;
-          }
-        }
-      }
-    });
-    pass_seqs.push_back(transform::EliminateCommonSubexpr(fskip));
+    pass_seqs.push_back(transform::EliminateCommonSubexpr(CSESkip()));
     pass_seqs.push_back(transform::SimplifyExpr());
     pass_seqs.push_back(transform::CombineParallelConv2D(3));
     pass_seqs.push_back(transform::CombineParallelDense(3));
@@ -359,6 +366,7 @@ class RelayBuildModule : public runtime::ModuleNode {
     if (targets.size() == 1) {
       pass_seqs.push_back(transform::InferType());
       pass_seqs.push_back(transform::AlterOpLayout());
+      pass_seqs.push_back(transform::MinimizeLayoutTransform());
     }
 
     // Fast math optimizations.
@@ -410,8 +418,27 @@ class RelayBuildModule : public runtime::ModuleNode {
       }
     }
 
+    // Merge the calls to equal fused functions, and the common subexpressions of their bodies.
+    relay_module = transform::InferType()(relay_module);
+    relay_module = transform::EliminateCommonSubexpr(CSESkip())(relay_module);
+
+    // Pack the independent fused functions together if it is enabled.
+    Pass horizontal_fuse = transform::HorizontalFuseOps();
+    if (pass_ctx.PassEnabled(horizontal_fuse->Info())) {
+      relay_module = transform::InferType()(relay_module);
+      relay_module = horizontal_fuse(relay_module);
+    }
+
     relay_module = transform::InferType()(relay_module);
 
+    // Recompute the intermediates over the memory budget, in the order their memory is planned.
+    Integer remat_budget =
+        pass_ctx->GetConfig<Integer>("relay.backend.remat_memory_budget", Integer(0)).value();
+    if (remat_budget->value > 0) {
+      relay_module = transform::Rematerialize(remat_budget->value)(relay_module);
+      relay_module = transform::InferType()(relay_module);
+    }
+
     // Inline the functions that have been lifted by the module scope.
     //
     // TODO(@zhiics) Note that we need to be careful about the subgraphs with
@@ -71,16 +71,27 @@ class CompileEngineImpl : public CompileEngineNode {
   PackedFunc JIT(const CCacheKey& key) final {
     auto mangle_fn = [](String name) { return name; };
     CCacheValue value = LowerInternal(key, mangle_fn);
-    if (value->packed_func != nullptr) return value->packed_func;
-    auto m = build(value->cached_func->funcs, key->target, Target(nullptr));
-    value->packed_func = m.GetFunction(value->cached_func->prim_fn_var->name_hint);
-    return value->packed_func;
+    return BuildPackedFunc(value, [&]() {
+      return build(value->cached_func->funcs, key->target, Target(nullptr));
+    });
   }
 
   CachedFunc LowerShapeFunc(const CCacheKey& key) final {
     return LowerShapeFuncInternal(key)->cached_func;
   }
 
+  PackedFunc JITShapeFunc(const CCacheKey& key) final {
+    CCacheValue value = LowerShapeFuncInternal(key);
+    return BuildPackedFunc(value, [&]() {
+      const CachedFunc& cfunc = value->cached_func;
+      if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
+        runtime::Module m = (*f)(cfunc->funcs, cfunc->target);
+        return m;
+      }
+      return build(cfunc->funcs, cfunc->target, Target(nullptr));
+    });
+  }
+
   Array<tvm::runtime::Module> LowerExternalFunctions() {
     Array<tvm::runtime::Module> ret;
     std::unordered_map<std::string, std::string> cached_symbol;
@@ -166,6 +177,23 @@ class CompileEngineImpl : public CompileEngineNode {
   CCacheKey GetCurrentCCacheKey() { return cur_ccache_key_; }
 
  private:
+  // Get the packed function of a lowered function, building it on first use.
+  PackedFunc BuildPackedFunc(CCacheValue value, std::function<runtime::Module()> fbuild) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (value->packed_func != nullptr) return value->packed_func;
+    }
+    // Build out of the lock, so that the functions JITed concurrently, e.g. by the interpreters of
+    // a parallel FoldConstant, are built in parallel. A function built twice is built the same.
+    runtime::Module m = fbuild();
+    PackedFunc packed_func = m.GetFunction(value->cached_func->prim_fn_var->name_hint);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (value->packed_func == nullptr) {
+      value->packed_func = packed_func;
+    }
+    return value->packed_func;
+  }
+
   // implement lowered func
   CCacheValue LowerInternal(const CCacheKey& key, std::function<String(String)> mangle_fn) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -225,6 +253,7 @@ class CompileEngineImpl : public CompileEngineNode {
     std::unordered_map<te::Tensor, tir::Buffer> binds;
     auto func_name = cfunc->prim_fn_var->name_hint;
     cfunc->funcs->Update(tvm::LowerSchedule(cfunc->schedule, all_args, func_name, binds));
+    PropagateFunctionAttrs(key->source_func, cfunc->funcs);
     value->cached_func = cfunc;
 
     return value;
@@ -249,7 +278,7 @@ class CompileEngineImpl : public CompileEngineNode {
 
     ICHECK(!value->cached_func.defined());
     using tvm::transform::PassContext;
-    With<PassContext> fresh_pass_ctx_scope(PassContext::Create());
+    With<PassContext> fresh_pass_ctx_scope(CreateLoweringPassContext());
 
     auto cached_func = ShapeFuncFor(key->source_func, key->target, [&](std::string name) {
       return GetUniqueName(name, &name_map_);
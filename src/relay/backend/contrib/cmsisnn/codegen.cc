@@ -0,0 +1,385 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/backend/contrib/cmsisnn/codegen.cc
+ * \brief Generate the C source calling the CMSIS-NN kernels for the partitioned functions.
+ *
+ *  Each partitioned function holds one composite function, lowered to one call of a kernel.
+ *  The weights, the biases and the requantization parameters are placed in static arrays of
+ *  the source, the scratch buffer of the kernel is taken from the workspace of the platform.
+ */
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/function.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../qnn/utils.h"
+#include "../../../transforms/pattern_utils.h"
+#include "../../utils.h"
+
+namespace tvm {
+namespace relay {
+namespace contrib {
+namespace cmsisnn {
+
+/*! \brief Collect the calls of a composite function by operator name, from its body. */
+std::unordered_map<std::string, Call> CollectCalls(const Expr& body) {
+  std::unordered_map<std::string, Call> calls;
+  Expr expr = body;
+  while (const auto* call = expr.as<CallNode>()) {
+    const auto* op = call->op.as<OpNode>();
+    ICHECK(op) << "CMSIS-NN expects the operators of a composite function";
+    calls.emplace(op->name, GetRef<Call>(call));
+    expr = call->args[0];
+  }
+  return calls;
+}
+
+/*! \brief The number of elements of an array. */
+int64_t NumElements(const runtime::NDArray& array) {
+  int64_t size = 1;
+  for (int64_t dim : array.Shape()) {
+    size *= dim;
+  }
+  return size;
+}
+
+class CodegenCMSISNN {
+ public:
+  explicit CodegenCMSISNN(const std::string& symbol) : symbol_(symbol) {}
+
+  std::string Generate(const Function& func) {
+    const auto* call = func->body.as<CallNode>();
+    ICHECK(call) << "CMSIS-NN expects a call of a composite function";
+    const auto* composite = call->op.as<FunctionNode>();
+    ICHECK(composite) << "CMSIS-NN expects a call of a composite function";
+    auto name = composite->GetAttr<String>(attr::kComposite);
+    ICHECK(name.defined()) << "CMSIS-NN expects a call of a composite function";
+    ICHECK_EQ(call->args.size(), 1U) << "CMSIS-NN kernels take one input tensor";
+    ICHECK(call->args[0].same_as(func->params[0])) << "CMSIS-NN expects the input of the function";
+
+    calls_ = CollectCalls(composite->body);
+    output_shape_ = backend::GetShape(composite->body->checked_type());
+    SetActivation(composite->body);
+    if (name.value() == "cmsisnn.qnn_conv2d") {
+      EmitConv2D();
+    } else if (name.value() == "cmsisnn.qnn_fully_connected") {
+      EmitFullyConnected();
+    } else if (name.value() == "cmsisnn.qnn_max_pool2d") {
+      EmitPool2D(calls_.at("nn.max_pool2d"), "arm_max_pool_s8", "");
+    } else if (name.value() == "cmsisnn.qnn_avg_pool2d") {
+      EmitPool2D(calls_.at("nn.avg_pool2d"), "arm_avgpool_s8",
+                 "arm_avgpool_s8_get_buffer_size(output_dims.w, input_dims.c)");
+    } else {
+      LOG(FATAL) << "CMSIS-NN does not support the composite function " << name.value();
+    }
+
+    std::ostringstream os;
+    os << decl_stream_.str() << "\n";
+    os << "#ifdef __cplusplus\n"
+       << "extern \"C\"\n"
+       << "#endif\n"
+       << "TVM_DLL int32_t " << symbol_ << "(TVMValue* args, int* type_code, int num_args, "
+       << "TVMValue* out_value, int* out_type_code, void* resource_handle) {\n";
+    os << "  const int8_t* input = (const int8_t*)(((DLTensor*)args[0].v_handle)->data);\n";
+    os << "  int8_t* output = (int8_t*)(((DLTensor*)args[1].v_handle)->data);\n";
+    os << body_stream_.str();
+    os << "  cmsis_nn_context ctx;\n"
+       << "  ctx.buf = NULL;\n"
+       << "  ctx.size = " << (buffer_size_.empty() ? "0" : buffer_size_) << ";\n"
+       << "  if (ctx.size > 0) {\n"
+       << "    ctx.buf = TVMBackendAllocWorkspace(kDLCPU, 0, ctx.size, kDLInt, 8);\n"
+       << "    if (ctx.buf == NULL) {\n"
+       << "      return -1;\n"
+       << "    }\n"
+       << "  }\n";
+    os << "  arm_status status = " << kernel_call_ << ";\n";
+    os << "  if (ctx.buf != NULL) {\n"
+       << "    TVMBackendFreeWorkspace(kDLCPU, 0, ctx.buf);\n"
+       << "  }\n"
+       << "  return status == ARM_MATH_SUCCESS ? 0 : -1;\n"
+       << "}\n";
+    return os.str();
+  }
+
+ private:
+  /*! \brief Clamp the int8 range by the clip fused after the kernel. */
+  void SetActivation(const Expr& body) {
+    const auto* call = body.as<CallNode>();
+    if (const auto* attrs = call->attrs.as<ClipAttrs>()) {
+      act_min_ = std::max(act_min_, static_cast<int32_t>(attrs->a_min));
+      act_max_ = std::min(act_max_, static_cast<int32_t>(attrs->a_max));
+    }
+  }
+
+  template <typename T>
+  std::string EmitArray(const std::string& suffix, const std::string& ctype,
+                        const std::vector<T>& values) {
+    std::string name = symbol_ + "_" + suffix;
+    decl_stream_ << "static const " << ctype << " " << name << "[" << values.size() << "] = {";
+    for (size_t i = 0; i < values.size(); ++i) {
+      decl_stream_ << (i % 16 == 0 ? "\n    " : " ") << static_cast<int64_t>(values[i])
+                   << (i + 1 == values.size() ? "" : ",");
+    }
+    decl_stream_ << "\n};\n";
+    return name;
+  }
+
+  void EmitDims(const std::string& name, int64_t n, int64_t h, int64_t w, int64_t c) {
+    body_stream_ << "  cmsis_nn_dims " << name << " = {" << n << ", " << h << ", " << w << ", "
+                 << c << "};\n";
+  }
+
+  void EmitActivation(const std::string& params) {
+    body_stream_ << "  " << params << ".activation.min = " << act_min_ << ";\n";
+    body_stream_ << "  " << params << ".activation.max = " << act_max_ << ";\n";
+  }
+
+  void EmitTile(const std::string& field, int64_t h, int64_t w) {
+    body_stream_ << "  " << field << ".h = " << h << ";\n";
+    body_stream_ << "  " << field << ".w = " << w << ";\n";
+  }
+
+  /*!
+   * \brief Emit the bias and the fixed point multipliers and shifts of the output channels.
+   * \param num_channels The number of output channels.
+   * \return The names of the bias, the multipliers and the shifts arrays.
+   */
+  std::vector<std::string> EmitRequantize(size_t num_channels) {
+    const Call& requantize = calls_.at("qnn.requantize");
+    std::vector<int32_t> bias(num_channels, 0);
+    auto it = calls_.find("nn.bias_add");
+    if (it != calls_.end()) {
+      runtime::NDArray data = Downcast<Constant>(it->second->args[1])->data;
+      ICHECK_EQ(data.Shape().back(), static_cast<int64_t>(num_channels));
+      std::copy_n(static_cast<const int32_t*>(data->data), num_channels, bias.begin());
+    }
+    std::vector<float> input_scales = qnn::GetFloatVectorFromConstant(requantize->args[1]);
+    ICHECK(input_scales.size() == 1 || input_scales.size() == num_channels);
+    double output_scale = GetScalarFromConstant<float>(requantize->args[3]);
+    output_offset_ = GetScalarFromConstant<int32_t>(requantize->args[4]);
+    std::vector<int32_t> multipliers, shifts;
+    for (size_t i = 0; i < num_channels; ++i) {
+      double scale = input_scales[input_scales.size() == 1 ? 0 : i];
+      auto multiplier_shift = qnn::GetFixedPointMultiplierShift(scale / output_scale);
+      multipliers.push_back(multiplier_shift.first);
+      shifts.push_back(multiplier_shift.second);
+    }
+    return {EmitArray("bias", "int32_t", bias), EmitArray("multiplier", "int32_t", multipliers),
+            EmitArray("shift", "int32_t", shifts)};
+  }
+
+  void EmitConv2D() {
+    const Call& conv = calls_.at("qnn.conv2d");
+    const auto* attrs = conv->attrs.as<Conv2DAttrs>();
+    std::vector<int> input_shape = backend::GetShape(conv->args[0]->checked_type());
+    int64_t pad_top = attrs->padding[0].as<IntImmNode>()->value;
+    int64_t pad_left = attrs->padding[1].as<IntImmNode>()->value;
+    auto pad = calls_.find("nn.pad");
+    if (pad != calls_.end()) {
+      // The pad with the zero point is the padding of the kernel.
+      const auto* pad_attrs = pad->second->attrs.as<PadAttrs>();
+      input_shape = backend::GetShape(pad->second->args[0]->checked_type());
+      pad_top += pad_attrs->pad_width[1][0]->value;
+      pad_left += pad_attrs->pad_width[2][0]->value;
+    }
+    int32_t input_offset = -GetScalarFromConstant<int32_t>(conv->args[2]);
+    bool depthwise = attrs->groups != 1;
+
+    // Reorder the weights to OHWI, the depthwise weights are already in the 1HWC order.
+    runtime::NDArray weight = Downcast<Constant>(conv->args[1])->data;
+    runtime::ShapeTuple wshape = weight.Shape();
+    const int8_t* wdata = static_cast<const int8_t*>(weight->data);
+    std::vector<int8_t> filter(wdata, wdata + NumElements(weight));
+    int64_t kernel_h, kernel_w, out_channels = output_shape_[3];
+    std::string kernel_layout = attrs->kernel_layout;
+    if (kernel_layout == "HWIO") {
+      kernel_h = wshape[0], kernel_w = wshape[1];
+      int64_t in_channels = wshape[2];
+      for (int64_t h = 0; h < kernel_h; ++h) {
+        for (int64_t w = 0; w < kernel_w; ++w) {
+          for (int64_t i = 0; i < in_channels; ++i) {
+            for (int64_t o = 0; o < out_channels; ++o) {
+              filter[((o * kernel_h + h) * kernel_w + w) * in_channels + i] =
+                  wdata[((h * kernel_w + w) * in_channels + i) * out_channels + o];
+            }
+          }
+        }
+      }
+    } else if (kernel_layout == "OHWI") {
+      kernel_h = wshape[1], kernel_w = wshape[2];
+    } else {
+      ICHECK_EQ(kernel_layout, "HWOI") << "CMSIS-NN does not support the kernel layout";
+      kernel_h = wshape[0], kernel_w = wshape[1];
+    }
+    std::string filter_name = EmitArray("filter", "int8_t", filter);
+    std::vector<std::string> quant = EmitRequantize(out_channels);
+
+    std::string params = depthwise ? "dw_conv_params" : "conv_params";
+    body_stream_ << "  " << (depthwise ? "cmsis_nn_dw_conv_params " : "cmsis_nn_conv_params ")
+                 << params << ";\n";
+    body_stream_ << "  " << params << ".input_offset = " << input_offset << ";\n";
+    body_stream_ << "  " << params << ".output_offset = " << output_offset_ << ";\n";
+    if (depthwise) {
+      body_stream_ << "  " << params << ".ch_mult = " << out_channels / input_shape[3] << ";\n";
+    }
+    EmitTile(params + ".stride", attrs->strides[0].as<IntImmNode>()->value,
+             attrs->strides[1].as<IntImmNode>()->value);
+    EmitTile(params + ".padding", pad_top, pad_left);
+    EmitTile(params + ".dilation", attrs->dilation[0].as<IntImmNode>()->value,
+             attrs->dilation[1].as<IntImmNode>()->value);
+    EmitActivation(params);
+    body_stream_ << "  cmsis_nn_per_channel_quant_params quant_params;\n";
+    body_stream_ << "  quant_params.multiplier = (int32_t*)" << quant[1] << ";\n";
+    body_stream_ << "  quant_params.shift = (int32_t*)" << quant[2] << ";\n";
+    EmitDims("input_dims", input_shape[0], input_shape[1], input_shape[2], input_shape[3]);
+    EmitDims("filter_dims", depthwise ? 1 : out_channels, kernel_h, kernel_w,
+             depthwise ? out_channels : input_shape[3]);
+    EmitDims("bias_dims", 1, 1, 1, out_channels);
+    EmitDims("output_dims", output_shape_[0], output_shape_[1], output_shape_[2], out_channels);
+
+    std::string kernel = depthwise ? "arm_depthwise_conv_wrapper_s8" : "arm_convolve_wrapper_s8";
+    buffer_size_ = kernel + "_get_buffer_size(&" + params + ", &input_dims, &filter_dims, " +
+                   "&output_dims)";
+    kernel_call_ = kernel + "(&ctx, &" + params +
+                   ", &quant_params, &input_dims, input, &filter_dims, " + filter_name +
+                   ", &bias_dims, " + quant[0] + ", &output_dims, output)";
+  }
+
+  void EmitFullyConnected() {
+    const Call& dense = calls_.at("qnn.dense");
+    std::vector<int> input_shape = backend::GetShape(dense->args[0]->checked_type());
+    runtime::NDArray weight = Downcast<Constant>(dense->args[1])->data;
+    int64_t out_channels = weight.Shape()[0], accum_depth = weight.Shape()[1];
+    const int8_t* wdata = static_cast<const int8_t*>(weight->data);
+    std::string filter_name = EmitArray(
+        "filter", "int8_t", std::vector<int8_t>(wdata, wdata + NumElements(weight)));
+    std::vector<std::string> quant = EmitRequantize(out_channels);
+
+    body_stream_ << "  cmsis_nn_fc_params fc_params;\n";
+    body_stream_ << "  fc_params.input_offset = " << -GetScalarFromConstant<int32_t>(dense->args[2])
+                 << ";\n";
+    body_stream_ << "  fc_params.filter_offset = 0;\n";
+    body_stream_ << "  fc_params.output_offset = " << output_offset_ << ";\n";
+    EmitActivation("fc_params");
+    // One scale for all the output channels, see the pattern table.
+    body_stream_ << "  cmsis_nn_per_tensor_quant_params quant_params;\n";
+    body_stream_ << "  quant_params.multiplier = " << quant[1] << "[0];\n";
+    body_stream_ << "  quant_params.shift = " << quant[2] << "[0];\n";
+    EmitDims("input_dims", input_shape[0], 1, 1, accum_depth);
+    EmitDims("filter_dims", accum_depth, 1, 1, out_channels);
+    EmitDims("bias_dims", 1, 1, 1, out_channels);
+    EmitDims("output_dims", input_shape[0], 1, 1, out_channels);
+
+    buffer_size_ = "arm_fully_connected_s8_get_buffer_size(&filter_dims)";
+    kernel_call_ = "arm_fully_connected_s8(&ctx, &fc_params, &quant_params, &input_dims, input, "
+                   "&filter_dims, " +
+                   filter_name + ", &bias_dims, " + quant[0] + ", &output_dims, output)";
+  }
+
+  void EmitPool2D(const Call& pool, const std::string& kernel, const std::string& buffer_size) {
+    Array<IndexExpr> pool_size, strides, padding;
+    if (const auto* attrs = pool->attrs.as<MaxPool2DAttrs>()) {
+      pool_size = attrs->pool_size, strides = attrs->strides, padding = attrs->padding;
+    } else {
+      const auto* avg_attrs = pool->attrs.as<AvgPool2DAttrs>();
+      pool_size = avg_attrs->pool_size, strides = avg_attrs->strides;
+      padding = avg_attrs->padding;
+    }
+    Expr data = pool->args[0];
+    if (const auto* cast = data.as<CallNode>()) {
+      data = cast->args[0];
+    }
+    std::vector<int> input_shape = backend::GetShape(data->checked_type());
+
+    body_stream_ << "  cmsis_nn_pool_params pool_params;\n";
+    EmitTile("pool_params.stride", strides[0].as<IntImmNode>()->value,
+             strides[1].as<IntImmNode>()->value);
+    EmitTile("pool_params.padding", padding[0].as<IntImmNode>()->value,
+             padding[1].as<IntImmNode>()->value);
+    EmitActivation("pool_params");
+    EmitDims("input_dims", input_shape[0], input_shape[1], input_shape[2], input_shape[3]);
+    EmitDims("filter_dims", 1, pool_size[0].as<IntImmNode>()->value,
+             pool_size[1].as<IntImmNode>()->value, 1);
+    EmitDims("output_dims", output_shape_[0], output_shape_[1], output_shape_[2],
+             output_shape_[3]);
+
+    buffer_size_ = buffer_size;
+    kernel_call_ = kernel + "(&ctx, &pool_params, &input_dims, input, &filter_dims, " +
+                   "&output_dims, output)";
+  }
+
+  /*! \brief The symbol of the partitioned function. */
+  std::string symbol_;
+  /*! \brief The calls of the composite function by operator name. */
+  std::unordered_map<std::string, Call> calls_;
+  /*! \brief The shape of the output in NHWC. */
+  std::vector<int> output_shape_;
+  /*! \brief The range of the output after the activation. */
+  int32_t act_min_{-128};
+  int32_t act_max_{127};
+  /*! \brief The zero point of the output. */
+  int32_t output_offset_{0};
+  /*! \brief The declarations of the constant arrays. */
+  std::ostringstream decl_stream_;
+  /*! \brief The statements setting the parameters of the kernel. */
+  std::ostringstream body_stream_;
+  /*! \brief The expression of the size of the scratch buffer, empty when there is none. */
+  std::string buffer_size_;
+  /*! \brief The expression calling the kernel. */
+  std::string kernel_call_;
+};
+
+runtime::Module CompileCMSISNN(const ObjectRef& ref) {
+  ICHECK(ref->IsInstance<FunctionNode>());
+  Function func = Downcast<Function>(ref);
+  std::string symbol = backend::GetExtSymbol(func);
+
+  std::ostringstream code;
+  code << "#include <stdint.h>\n";
+  code << "#include <tvm/runtime/c_runtime_api.h>\n";
+  code << "#include <tvm/runtime/c_backend_api.h>\n";
+  code << "#include <arm_nnfunctions.h>\n\n";
+  code << CodegenCMSISNN(symbol).Generate(func);
+
+  const auto* pf = runtime::Registry::Get("runtime.CSourceModuleCreate");
+  ICHECK(pf != nullptr) << "Cannot find csource module to create the external runtime module";
+  return (*pf)(code.str(), "c", Array<String>{symbol}, Array<String>());
+}
+
+TVM_REGISTER_GLOBAL("relay.ext.cmsisnn").set_body_typed(CompileCMSISNN);
+
+// The constants are placed in the generated source.
+TVM_REGISTER_GLOBAL("relay.ext.cmsisnn.constant_updater")
+    .set_body_typed([](Expr expr, std::string symbol) { return Map<String, runtime::NDArray>(); });
+
+}  // namespace cmsisnn
+}  // namespace contrib
+}  // namespace relay
+}  // namespace tvm
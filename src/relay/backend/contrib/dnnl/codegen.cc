@@ -431,7 +431,16 @@ class DNNLJSONSerializer : public backend::contrib::JSONSerializer {
   using JSONGraphNodeEntry = tvm::runtime::json::JSONGraphNodeEntry;
 
  public:
-  DNNLJSONSerializer(const std::string& symbol, const Expr& expr) : JSONSerializer(symbol, expr) {}
+  DNNLJSONSerializer(const std::string& symbol, const Expr& expr) : JSONSerializer(symbol, expr) {
+    // The inputs and outputs exchanged with other DNNL subgraphs in the layouts DNNL picks.
+    const auto* func = expr.as<FunctionNode>();
+    for (const auto& index : func->GetAttr<Array<Integer>>("dnnl_blocked_inputs").value_or({})) {
+      blocked_inputs_.push_back(std::to_string(index->value));
+    }
+    for (const auto& index : func->GetAttr<Array<Integer>>("dnnl_blocked_outputs").value_or({})) {
+      blocked_outputs_.push_back(std::to_string(index->value));
+    }
+  }
 
   std::vector<JSONGraphNodeEntry> VisitExpr_(const CallNode* cn) override {
     Expr expr = GetRef<Expr>(cn);
@@ -465,8 +474,19 @@ class DNNLJSONSerializer : public backend::contrib::JSONSerializer {
                                                 "kernel", /* op_type_ */
                                                 inputs, 1 /* num_outputs_ */);
     SetCallNodeAttribute(node, call);
+    // These attributes are global to the whole subgraph.
+    std::vector<dmlc::any> blocked_inputs_attr, blocked_outputs_attr;
+    blocked_inputs_attr.emplace_back(blocked_inputs_);
+    blocked_outputs_attr.emplace_back(blocked_outputs_);
+    node->SetAttr("blocked_inputs", blocked_inputs_attr);
+    node->SetAttr("blocked_outputs", blocked_outputs_attr);
     return AddNode(node, GetRef<Expr>(cn));
   }
+
+ private:
+  /*! \brief The indices of the inputs and outputs in blocked layouts. */
+  std::vector<std::string> blocked_inputs_;
+  std::vector<std::string> blocked_outputs_;
 };
 #endif
 
@@ -25,6 +25,8 @@
 #include <tvm/relay/attrs/nn.h>
 #include <tvm/relay/type.h>
 
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +48,9 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
   bool use_implicit_batch;
   size_t max_workspace_size;
   bool remove_no_mac_subgraphs;
+  Map<String, Array<Array<Integer>>> optimization_profiles;
+  bool use_int8;
+  String int8_calibration_dir;
 
   TVM_DECLARE_ATTRS(TensorRTCompilerConfigNode, "ext.attrs.TensorRTCompilerConfigNode") {
     TVM_ATTR_FIELD(tensorrt_version)
@@ -54,6 +59,15 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
     TVM_ATTR_FIELD(use_implicit_batch).set_default(true);
     TVM_ATTR_FIELD(max_workspace_size).set_default(size_t(1) << 30);
     TVM_ATTR_FIELD(remove_no_mac_subgraphs).set_default(false);
+    TVM_ATTR_FIELD(optimization_profiles)
+        .describe("The (min, opt, max) shapes of the inputs of the subgraphs, by input name.")
+        .set_default(Map<String, Array<Array<Integer>>>());
+    TVM_ATTR_FIELD(use_int8).describe("Whether to build INT8 engines.").set_default(false);
+    TVM_ATTR_FIELD(int8_calibration_dir)
+        .describe(
+            "The directory of the calibration tables of an offline calibration, by subgraph. The "
+            "subgraphs without a table calibrate on the inputs of their first runs.")
+        .set_default("");
   }
 };
 
@@ -77,7 +91,9 @@ class TensorRTJSONSerializer : public backend::contrib::JSONSerializer {
 
  public:
   TensorRTJSONSerializer(const std::string& symbol, const Expr& expr)
-      : JSONSerializer(symbol, expr) {}
+      : JSONSerializer(symbol, expr),
+        func_name_(symbol),
+        inputs_(Downcast<Function>(expr)->params) {}
 
   std::vector<JSONGraphNodeEntry> VisitExpr_(const CallNode* cn) {
     std::string name;
@@ -222,7 +238,77 @@ class TensorRTJSONSerializer : public backend::contrib::JSONSerializer {
     node->SetAttr("tensorrt_version", tensorrt_version_attr);
     node->SetAttr("use_implicit_batch", use_implicit_batch_attr);
     node->SetAttr("max_workspace_size", max_workspace_size_attr);
+    SaveOptimizationProfiles(node, cfg.value()->optimization_profiles);
+    if (cfg.value()->use_int8) {
+      SaveInt8Attributes(node, cfg.value()->int8_calibration_dir);
+    }
+  }
+
+  /*!
+   * \brief Save the INT8 flag and the calibration table of this subgraph, the file
+   * "<symbol>_int8.calib" of the calibration directory as written in TVM_TENSORRT_CACHE_DIR by the
+   * runtime.
+   */
+  void SaveInt8Attributes(std::shared_ptr<JSONGraphNode> node, const std::string& calibration_dir) {
+    std::vector<dmlc::any> use_int8_attr;
+    use_int8_attr.emplace_back(std::vector<std::string>{"1"});
+    node->SetAttr("use_int8", use_int8_attr);
+    if (calibration_dir.empty()) return;
+    std::string path = calibration_dir + "/" + func_name_ + "_int8.calib";
+    std::ifstream is(path, std::ios::binary);
+    if (!is.good()) {
+      LOG(WARNING) << "No calibration table " << path << ", TensorRT subgraph " << func_name_
+                   << " will calibrate on the inputs of its first runs";
+      return;
+    }
+    std::string table((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    std::vector<dmlc::any> table_attr;
+    table_attr.emplace_back(std::vector<std::string>{table});
+    node->SetAttr("int8_calibration_table", table_attr);
+  }
+
+  /*!
+   * \brief Save the shape ranges of the inputs of this subgraph which have one, with the shapes
+   * as comma separated dims.
+   */
+  void SaveOptimizationProfiles(std::shared_ptr<JSONGraphNode> node,
+                                const Map<String, Array<Array<Integer>>>& profiles) {
+    std::vector<std::string> names, min_shapes, opt_shapes, max_shapes;
+    for (const auto& param : inputs_) {
+      auto it = profiles.find(param->name_hint());
+      if (it == profiles.end()) continue;
+      const Array<Array<Integer>>& shapes = (*it).second;
+      ICHECK_EQ(shapes.size(), 3) << "The profile of " << param->name_hint()
+                                  << " must be the (min, opt, max) shapes";
+      std::vector<std::string> dims(3);
+      for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < shapes[i].size(); ++j) {
+          dims[i] += (j ? "," : "") + std::to_string(shapes[i][j]->value);
+        }
+      }
+      names.push_back(param->name_hint());
+      min_shapes.push_back(dims[0]);
+      opt_shapes.push_back(dims[1]);
+      max_shapes.push_back(dims[2]);
+    }
+    if (names.empty()) return;
+    std::vector<std::pair<std::string, std::vector<std::string>>> attrs = {
+        {"profile_inputs", names},
+        {"profile_min_shapes", min_shapes},
+        {"profile_opt_shapes", opt_shapes},
+        {"profile_max_shapes", max_shapes}};
+    for (const auto& attr : attrs) {
+      std::vector<dmlc::any> value;
+      value.emplace_back(attr.second);
+      node->SetAttr(attr.first, value);
+    }
   }
+
+ private:
+  /*! \brief The symbol of the subgraph. */
+  std::string func_name_;
+  /*! \brief The inputs of the subgraph. */
+  Array<Var> inputs_;
 };
 
 /*!
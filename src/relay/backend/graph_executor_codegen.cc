@@ -80,6 +80,9 @@ class GraphNodeRef {
 
   inline void Load(dmlc::JSONReader* reader) { LOG(FATAL) << "Not implemented."; }
 
+  int ident() const { return ident_; }
+  int index() const { return index_; }
+
  protected:
   int ident_;
   int index_{0};
@@ -257,6 +260,7 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     }
 
     heads_ = VisitExpr(main_func->body);
+    if (has_branches_) SetBranchGuards();
     std::ostringstream os;
 
     dmlc::JSONWriter writer(&os);
@@ -308,6 +312,15 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       storage_ids.push_back(v);
     }
     node->attrs_["storage_id"] = std::move(storage_ids);
+    // storage scope, only recorded when some tensors are not in flat memory
+    if (std::any_of(storage_info->storage_scopes.begin(), storage_info->storage_scopes.end(),
+                    [](const std::string& scope) { return scope != "global"; })) {
+      node->attrs_["storage_scope"] = storage_info->storage_scopes;
+    }
+    // storage offset, only recorded by the offset memory planners
+    if (!storage_info->storage_offsets.empty()) {
+      node->attrs_["storage_offset"] = storage_info->storage_offsets;
+    }
     // type
     std::vector<int64_t> device_types;
     for (auto v : storage_info->device_types) {
@@ -324,6 +337,7 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     }
     auto node_id = nodes_.size();
     nodes_.push_back(node);
+    node_guards_.push_back(branch_guard_);
     // Tuple return value, flatten as tuple
     if (const auto* tuple_type = checked_type.as<TupleTypeNode>()) {
       std::vector<GraphNodeRef> ret;
@@ -392,7 +406,10 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     StorageInfo rit = GetStorageInfo(rhs);
     int64_t lhs_storage_id = lit->storage_ids[0];
     int64_t rhs_storage_id = rit->storage_ids[0];
-    return lhs_storage_id == rhs_storage_id;
+    // the tensors of an arena share its storage id, at their own offsets
+    int64_t lhs_offset = lit->storage_offsets.empty() ? 0 : lit->storage_offsets[0];
+    int64_t rhs_offset = rit->storage_offsets.empty() ? 0 : rit->storage_offsets[0];
+    return lhs_storage_id == rhs_storage_id && lhs_offset == rhs_offset;
   }
 
   std::vector<GraphNodeRef> GraphAddCallNode(const CallNode* op, const std::string& func_name,
@@ -470,8 +487,81 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     return {};
   }
   std::vector<GraphNodeRef> VisitExpr_(const IfNode* op) override {
-    throw std::invalid_argument("if not supported");
-    return {};
+    const auto* cond_type = op->cond->checked_type().as<TensorTypeNode>();
+    ICHECK(cond_type != nullptr && cond_type->shape.empty())
+        << "the graph executor only supports If on a scalar predicate";
+    auto cond = VisitExpr(op->cond);
+    ICHECK_EQ(cond.size(), 1U);
+    // the nodes first visited in a branch are only run when it is taken
+    branch_guard_.push_back({cond[0], true});
+    auto then_refs = VisitExpr(op->true_branch);
+    branch_guard_.back().value = false;
+    auto else_refs = VisitExpr(op->false_branch);
+    branch_guard_.pop_back();
+    has_branches_ = true;
+
+    // the select copies the outputs of the branch taken
+    std::vector<GraphNodeRef> inputs = cond;
+    inputs.insert(inputs.end(), then_refs.begin(), then_refs.end());
+    inputs.insert(inputs.end(), else_refs.begin(), else_refs.end());
+    auto node = GraphOpNode::make_node_ptr(_GetUniqueName("if"), GraphAttrs(), "__if", inputs,
+                                           GraphAttrs());
+    return AddNode(node, GetRef<Expr>(op));
+  }
+
+  /*! \brief A branch condition, the predicate entry and the branch it selects. */
+  struct BranchCondition {
+    GraphNodeRef pred;
+    bool value;
+    bool operator==(const BranchCondition& other) const {
+      return pred.ident() == other.pred.ident() && pred.index() == other.pred.index() &&
+             value == other.value;
+    }
+  };
+  using BranchGuard = std::vector<BranchCondition>;
+
+  /*!
+   * \brief Record the branches each op node is in as its "branch_guard" attribute, the
+   *  "nid:index:value" conditions from the outermost separated by semicolons.
+   *
+   *  A node first visited in a branch but also used outside of it, since the expressions are
+   *  memoized, only keeps the branches of all its uses.
+   */
+  void SetBranchGuards() {
+    auto restrict_to = [this](int nid, const BranchGuard& guard) {
+      BranchGuard& node_guard = node_guards_[nid];
+      size_t common = 0;
+      while (common < node_guard.size() && common < guard.size() &&
+             node_guard[common] == guard[common]) {
+        ++common;
+      }
+      node_guard.resize(common);
+    };
+    for (const GraphNodeRef& head : heads_) node_guards_[head.ident()].clear();
+    for (size_t nid = nodes_.size(); nid-- > 0;) {
+      if (nodes_[nid]->Type() != kGraphOpNode) continue;
+      auto op_node = std::dynamic_pointer_cast<GraphOpNode>(nodes_[nid]);
+      const BranchGuard& guard = node_guards_[nid];
+      bool is_select = op_node->op_name_ == "__if";
+      for (size_t i = 0; i < op_node->inputs_.size(); ++i) {
+        BranchGuard allowed = guard;
+        // the outputs of the branches are inputs 1 to n and n + 1 to 2n of the select
+        if (is_select && i > 0) {
+          allowed.push_back({op_node->inputs_[0], 2 * i <= op_node->inputs_.size() - 1});
+        }
+        restrict_to(op_node->inputs_[i].ident(), allowed);
+      }
+    }
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      if (nodes_[nid]->Type() != kGraphOpNode || node_guards_[nid].empty()) continue;
+      std::ostringstream os;
+      for (size_t i = 0; i < node_guards_[nid].size(); ++i) {
+        const BranchCondition& cond = node_guards_[nid][i];
+        if (i != 0) os << ";";
+        os << cond.pred.ident() << ":" << cond.pred.index() << ":" << cond.value;
+      }
+      std::dynamic_pointer_cast<GraphOpNode>(nodes_[nid])->op_attrs_["branch_guard"] = os.str();
+    }
   }
   std::vector<GraphNodeRef> VisitExpr_(const FunctionNode* op) override {
     ICHECK(op->GetAttr<String>(attr::kCompiler).defined())
@@ -516,6 +606,10 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     std::vector<size_t> storage_ids;
     std::vector<size_t> device_types;
     std::vector<std::string> dltypes;
+    std::vector<std::string> storage_scopes;
+    bool has_storage_scope = false;
+    std::vector<int64_t> storage_offsets;
+    bool has_storage_offset = false;
     std::vector<size_t> node_row_ptr{0};
     for (auto node : nodes_) {
       const auto& shape_vec = dmlc::get<ShapeVector>(node->attrs_["shape"]);
@@ -532,6 +626,20 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
         device_types.insert(device_types.end(), dev_types.begin(), dev_types.end());
       }
+      if (node->attrs_.count("storage_scope")) {
+        const auto& scopes = dmlc::get<std::vector<std::string>>(node->attrs_["storage_scope"]);
+        storage_scopes.insert(storage_scopes.end(), scopes.begin(), scopes.end());
+        has_storage_scope = true;
+      } else {
+        storage_scopes.insert(storage_scopes.end(), node->num_outputs_, "global");
+      }
+      if (node->attrs_.count("storage_offset")) {
+        const auto& offsets = dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+        storage_offsets.insert(storage_offsets.end(), offsets.begin(), offsets.end());
+        has_storage_offset = true;
+      } else {
+        storage_offsets.insert(storage_offsets.end(), node->num_outputs_, 0);
+      }
       node_row_ptr.push_back(num_entry);
     }
     writer->BeginObject();
@@ -549,6 +657,14 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     }
     attrs["dltype"].emplace_back(std::string("list_str"));
     attrs["dltype"].emplace_back(dltypes);
+    if (has_storage_scope) {
+      attrs["storage_scope"].emplace_back(std::string("list_str"));
+      attrs["storage_scope"].emplace_back(storage_scopes);
+    }
+    if (has_storage_offset) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
     writer->WriteObjectKeyValue("attrs", attrs);
     writer->WriteObjectKeyValue("node_row_ptr", node_row_ptr);
     writer->EndObject();
@@ -575,6 +691,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
   std::vector<GraphObjectPtr> nodes_;
   /*! \brief output of graph */
   std::vector<GraphNodeRef> heads_;
+  /*! \brief The branches the node being visited is in, from the outermost. */
+  BranchGuard branch_guard_;
+  /*! \brief The branches each node was first visited in. */
+  std::vector<BranchGuard> node_guards_;
+  /*! \brief Whether the graph has conditional branches. */
+  bool has_branches_{false};
   /*! \brief mod */
   runtime::Module* mod_;
   /*! \brief variable map */
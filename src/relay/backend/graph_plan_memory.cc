@@ -27,8 +27,15 @@
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+
+#include "../../runtime/texture.h"
 #include "../../support/arena.h"
 #include "./utils.h"
 
@@ -51,6 +58,18 @@ struct StorageToken {
   int device_type{0};
   /*! \brief The storage id */
   int64_t storage_id{-1};
+  /*! \brief The storage scope, "global" for flat memory. */
+  std::string storage_scope{"global"};
+  /*! \brief The 2D image of a texture storage scope, the largest of the tensors it holds. */
+  runtime::Texture2DShape<size_t> texture_shape{0, 0, 0};
+  /*! \brief The byte offset of the token in its storage, set by the offset planners. */
+  int64_t storage_offset{0};
+  /*! \brief The step the token is allocated at. */
+  int first_step{-1};
+  /*! \brief The step the token is released at, -1 if it is never released. */
+  int last_step{-1};
+  /*! \brief Whether the token holds a parameter or a constant, never reused. */
+  bool is_fixed{false};
 };
 
 std::ostream& operator<<(std::ostream& os, StorageToken tok) {
@@ -62,7 +81,29 @@ std::ostream& operator<<(std::ostream& os, StorageToken tok) {
             // ok idk how to print this properly
             << "tttype shape: " << tok.ttype->shape << std::endl
             << "device_type: " << tok.device_type << std::endl
-            << "storage_id: " << tok.storage_id << std::endl;
+            << "storage_id: " << tok.storage_id << std::endl
+            << "storage_scope: " << tok.storage_scope << std::endl;
+}
+
+/*!
+ * \brief The storage scope of the outputs of an expression.
+ * \param expr The expression.
+ * \return The scope set by the kOutputStorageScope attribute of the called primitive function,
+ *  "global" if it is not set.
+ */
+std::string GetOutputStorageScope(const Expr& expr) {
+  if (const auto* call = expr.as<CallNode>()) {
+    if (const auto* fn = call->op.as<FunctionNode>()) {
+      if (Optional<String> scope = fn->GetAttr<String>(attr::kOutputStorageScope)) {
+        return scope.value();
+      }
+    } else if (const auto* tir_call_attrs = call->attrs.as<TIRCallAttrs>()) {
+      if (tir_call_attrs->metadata.count(attr::kOutputStorageScope)) {
+        return Downcast<String>(tir_call_attrs->metadata[attr::kOutputStorageScope]);
+      }
+    }
+  }
+  return "global";
 }
 
 class StorageAllocaBaseVisitor : public ExprVisitor {
@@ -111,8 +152,6 @@ class StorageAllocaBaseVisitor : public ExprVisitor {
     token_map_[op] = {tok[op->index]};
   }
 
-  void VisitExpr_(const IfNode* op) final { LOG(FATAL) << "if is not supported."; }
-
   void VisitExpr_(const LetNode* op) final {
     auto token = GetToken(op->value);
     token_map_[op->var.operator->()] = token;
@@ -163,6 +202,7 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
     std::vector<StorageToken*> tokens;
     int device_type =
         node_device_map_.count(GetRef<Expr>(op)) ? node_device_map_[GetRef<Expr>(op)]->value : 0;
+    std::string storage_scope = GetOutputStorageScope(GetRef<Expr>(op));
     if (const auto* tuple_type = op->checked_type().as<TupleTypeNode>()) {
       for (Type t : tuple_type->fields) {
         const auto* ttype = t.as<TensorTypeNode>();
@@ -170,6 +210,7 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
         StorageToken* token = arena_->make<StorageToken>();
         token->ttype = ttype;
         token->device_type = device_type;
+        token->storage_scope = storage_scope;
         tokens.push_back(token);
       }
     } else {
@@ -178,6 +219,7 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
       StorageToken* token = arena_->make<StorageToken>();
       token->ttype = ttype;
       token->device_type = device_type;
+      token->storage_scope = storage_scope;
       tokens.push_back(token);
     }
     token_map_[op] = tokens;
@@ -195,6 +237,17 @@ class StorageAllocaInit : protected StorageAllocaBaseVisitor {
     }
   }
 
+  void VisitExpr_(const IfNode* op) final {
+    // the outputs of the branch taken are copied to the storage of the if, as by a call
+    // reading the predicate and the outputs of both branches.
+    CreateToken(op, true);
+    for (Expr arg : {op->cond, op->true_branch, op->false_branch}) {
+      for (StorageToken* tok : GetToken(arg)) {
+        tok->ref_counter += 1;
+      }
+    }
+  }
+
  private:
   // allocator
   support::Arena* arena_;
@@ -216,8 +269,19 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
 
   // Run storage allocation for a function.
   StaticMemoryPlan Plan(const Function& func) {
+    enable_inplace_ = backend::IsInplaceEnabled();
+    offset_planner_ = transform::PassContext::Current()
+                          ->GetConfig<String>("relay.backend.graph_memory_planner", String(""))
+                          .value();
+    ICHECK(offset_planner_.empty() || offset_planner_ == "greedy_by_size" ||
+           offset_planner_ == "best_fit")
+        << "relay.backend.graph_memory_planner must be \"greedy_by_size\" or \"best_fit\", not "
+        << offset_planner_;
+    // The offset planners place a token per tensor, the match range would merge them.
+    if (!offset_planner_.empty()) match_range_ = 0;
     prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
     this->Run(func);
+    if (!offset_planner_.empty()) PlanOffsets();
 
     // The value of smap contains two integer arrays where the first array
     // contains the planned storage ids and the second holds the device types.
@@ -229,6 +293,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       std::vector<int64_t> storage_ids;
       std::vector<DLDeviceType> device_types;
       std::vector<int64_t> sid_sizes_byte;
+      std::vector<std::string> storage_scopes;
+      std::vector<int64_t> storage_offsets;
 
       for (StorageToken* tok : kv.second) {
         if (tok->device_type) {
@@ -237,9 +303,13 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         num_nodes++;
         storage_ids.push_back(tok->storage_id);
         device_types.push_back(static_cast<DLDeviceType>(tok->device_type));
-        sid_sizes_byte.push_back(GetMemorySize(tok));
+        sid_sizes_byte.push_back(IsTexture(tok) ? tok->max_bytes : GetMemorySize(tok));
+        storage_scopes.push_back(tok->storage_scope);
+        storage_offsets.push_back(tok->storage_offset);
       }
-      auto storage_info = backend::StorageInfo(storage_ids, device_types, sid_sizes_byte);
+      if (offset_planner_.empty()) storage_offsets.clear();
+      auto storage_info = backend::StorageInfo(storage_ids, device_types, sid_sizes_byte,
+                                               storage_scopes, storage_offsets);
       smap.Set(GetRef<Expr>(kv.first), storage_info);
     }
     // Either all or none of the nodes should be annotated.
@@ -249,6 +319,17 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
                     "or none of the expressions are expected to be annotated.";
     }
 
+    // The rematerialization budget bounds the intermediates, not the params and constants.
+    int64_t remat_budget = transform::PassContext::Current()
+                               ->GetConfig<Integer>("relay.backend.remat_memory_budget", Integer(0))
+                               .value()
+                               ->value;
+    int64_t activation_bytes = static_cast<int64_t>(TotalAllocBytes() - fixed_bytes_);
+    if (remat_budget > 0 && activation_bytes > remat_budget) {
+      LOG(WARNING) << "The intermediates planned take " << activation_bytes
+                   << " bytes, over the rematerialization budget of " << remat_budget << " bytes";
+    }
+
     return backend::StaticMemoryPlan(smap);
   }
 
@@ -267,6 +348,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       } else {
         // Allocate a new token,
         StorageToken* allocated_tok = Alloc(tok, GetMemorySize(tok));
+        fixed_bytes_ += allocated_tok->max_bytes;
+        allocated_tok->is_fixed = true;
         allocated_tok->device_type = tok->device_type;
         // ensure it never get de-allocated.
         allocated_tok->ref_counter += 1;
@@ -308,14 +391,21 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     // only works for flat memory case, we will go with this choice
     //
     // TODO(tvm-team) Update checks of flat memory enablement when we support
-    // opaque-nd memory planning to skip this path.
-    if (IsReshape(op)) {
+    // opaque-nd memory planning to skip this path. The textures are not flat,
+    // their reshapes are not aliased.
+    bool is_texture = std::any_of(args.begin(), args.end(), IsTexture) ||
+                      std::any_of(prototype_.at(op).begin(), prototype_.at(op).end(), IsTexture);
+    ++step_;
+    if (IsReshape(op) && !is_texture) {
       // TODO(@electriclilies, jroesch): This check is failing because the size of args is 3
       // I can't figure out where the extra args are coming from, I assume it must be related
       // to the relay_attrs field we added to the TIRCallArgs, but I don't know where / how
       // that's happening...
       ICHECK_EQ(args.size(), 1U);
       ReuseInputToken(op, args[0]);
+    } else if (StorageToken* input_token = FindInplaceToken(op, args)) {
+      // write the output over an argument which is dead after the call.
+      ReuseInputToken(op, input_token);
     } else {
       // create token for the call node.
       CreateToken(op, true);
@@ -330,6 +420,53 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       CheckForRelease(tok);
     }
   }
+  // The branches are planned as if both ran one after the other, which stays valid when the
+  // executor skips the one not taken.
+  void VisitExpr_(const IfNode* op) final {
+    std::vector<StorageToken*> args;
+    for (Expr arg : {op->cond, op->true_branch, op->false_branch}) {
+      for (StorageToken* tok : GetToken(arg)) {
+        args.push_back(tok);
+      }
+    }
+    ++step_;
+    CreateToken(op, true);
+    for (StorageToken* tok : token_map_.at(op)) {
+      CheckForRelease(tok);
+    }
+    for (StorageToken* tok : args) {
+      tok->ref_counter -= 1;
+      CheckForRelease(tok);
+    }
+  }
+  /*!
+   * \brief Find the token of an argument that the call can overwrite with its output.
+   *
+   *  The call is the last reader of the token. The function parameters, the constants
+   *  and the outputs hold an extra reference, so they are never overwritten.
+   *
+   * \param call The call.
+   * \param args The tokens of the arguments of the call.
+   * \return The token, nullptr if there is none.
+   */
+  StorageToken* FindInplaceToken(const CallNode* call, const std::vector<StorageToken*>& args) {
+    if (!enable_inplace_) return nullptr;
+    const std::vector<StorageToken*>& outputs = prototype_.at(call);
+    if (outputs.size() != 1) return nullptr;
+    for (size_t i = 0; i < call->args.size(); ++i) {
+      if (!backend::CanComputeInplace(call, i)) continue;
+      const std::vector<StorageToken*>& tokens = GetToken(call->args[i]);
+      if (tokens.size() != 1 || tokens[0]->device_type != outputs[0]->device_type ||
+          tokens[0]->storage_scope != outputs[0]->storage_scope) {
+        continue;
+      }
+      StorageToken* tok = tokens[0];
+      if (tok->ref_counter == std::count(args.begin(), args.end(), tok)) {
+        return tok;
+      }
+    }
+    return nullptr;
+  }
   /*!
    * \brief ceil(size/word_size) to get number of words.
    * \param size The original size.
@@ -382,6 +519,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
    * \return The result token.
    */
   StorageToken* Request(StorageToken* prototype) {
+    if (IsTexture(prototype)) {
+      return RequestTexture(prototype);
+    }
     // calculate the size;
     size_t size = GetMemorySize(prototype);
     // search memory block in [size / match_range_, size * match_range_)
@@ -419,6 +559,89 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     // cannot find anything return a new one.
     return this->Alloc(prototype, size);
   }
+  /*!
+   * \brief Whether the token is a 2D image of a texture storage scope.
+   * \param tok The token.
+   */
+  static bool IsTexture(const StorageToken* tok) {
+    return runtime::IsTextureStorage(tok->storage_scope);
+  }
+  /*!
+   * \brief Get the 2D image holding the tensor of a texture token.
+   * \param prototype The prototype token.
+   * \return The width, height and channels of the image.
+   */
+  static runtime::Texture2DShape<size_t> GetTextureShape(const StorageToken* prototype) {
+    const TensorTypeNode* ttype = prototype->ttype;
+    std::vector<size_t> shape;
+    for (IndexExpr dim : ttype->shape) {
+      const int64_t* pval = tir::as_const_int(dim);
+      ICHECK(pval != nullptr) << "Cannot allocate texture for symbolic tensor shape "
+                              << ttype->shape;
+      shape.push_back(static_cast<size_t>(*pval));
+    }
+    ICHECK_GE(shape.size(), 2U) << "A texture holds a tensor of rank 2 or more, not "
+                                << ttype->shape;
+    size_t axis = runtime::DefaultTextureLayoutSeparator(shape.size(), prototype->storage_scope);
+    return runtime::ApplyTexture2DFlattening<size_t>(shape, shape.size(), axis);
+  }
+  /*!
+   * \brief Request a texture token for a given prototype.
+   *
+   *  The free images of the same scope, data type and channels are candidates. The image
+   *  that grows the least to hold the tensor is reused, the one wasting the least space
+   *  among the images that do not grow. A new image is allocated when growing the best
+   *  candidate would add more pixels than the tensor has, as TexturePool does at runtime.
+   *
+   * \param prototype The prototype storage token.
+   * \return The result token.
+   */
+  StorageToken* RequestTexture(StorageToken* prototype) {
+    runtime::Texture2DShape<size_t> shape = GetTextureShape(prototype);
+    size_t requested = shape.width * shape.height;
+    auto best = free_textures_.end();
+    size_t min_added = std::numeric_limits<size_t>::max();
+    size_t min_wasted = std::numeric_limits<size_t>::max();
+    for (auto it = free_textures_.begin(); it != free_textures_.end(); ++it) {
+      StorageToken* tok = *it;
+      if (tok->device_type != prototype->device_type ||
+          tok->storage_scope != prototype->storage_scope ||
+          tok->ttype->dtype != prototype->ttype->dtype ||
+          tok->texture_shape.channel != shape.channel) {
+        continue;
+      }
+      size_t area = std::max(tok->texture_shape.width, shape.width) *
+                    std::max(tok->texture_shape.height, shape.height);
+      size_t added = area - tok->texture_shape.width * tok->texture_shape.height;
+      size_t wasted = area - requested;
+      if (added < min_added || (added == min_added && wasted < min_wasted)) {
+        min_added = added;
+        min_wasted = wasted;
+        best = it;
+      }
+    }
+    if (best != free_textures_.end() && min_added <= requested) {
+      StorageToken* tok = *best;
+      free_textures_.erase(best);
+      ICHECK_EQ(tok->ref_counter, 0);
+      tok->texture_shape.width = std::max(tok->texture_shape.width, shape.width);
+      tok->texture_shape.height = std::max(tok->texture_shape.height, shape.height);
+      tok->max_bytes = TextureBytes(tok);
+      tok->ref_counter = prototype->ref_counter;
+      return tok;
+    }
+    prototype->texture_shape = shape;
+    return this->Alloc(prototype, TextureBytes(prototype));
+  }
+  /*!
+   * \brief The bytes of the image of a texture token.
+   * \param tok The token.
+   */
+  static size_t TextureBytes(const StorageToken* tok) {
+    const DataType& dtype = tok->ttype->dtype;
+    return tok->texture_shape.width * tok->texture_shape.height * tok->texture_shape.channel *
+           DivRoundUp(dtype.bits() * dtype.lanes(), 8);
+  }
   /*!
    * \brief Allocate a storage token by consuming prototype
    * \param prototype The prototype token.
@@ -426,6 +649,7 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
    */
   StorageToken* Alloc(StorageToken* prototype, size_t size) {
     prototype->max_bytes = size;
+    prototype->first_step = step_;
     prototype->storage_id = static_cast<int64_t>(data_.size());
     data_.push_back(prototype);
     return prototype;
@@ -438,25 +662,153 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     ICHECK_GE(tok->storage_id, 0);
     ICHECK_GE(tok->ref_counter, 0);
     if (tok->ref_counter == 0) {
-      free_.insert({tok->max_bytes, tok});
+      tok->last_step = step_;
+      if (IsTexture(tok)) {
+        free_textures_.push_back(tok);
+      } else {
+        free_.insert({tok->max_bytes, tok});
+      }
     }
   }
+  /*!
+   * \brief Place the tokens of the intermediates and the outputs at byte offsets in one storage
+   *  per device, the arena.
+   *
+   *  The params and constants keep their own storage, as do the textures. The tokens live from
+   *  the step they are allocated at to the one they are released at, both included, the
+   *  outputs to the last step. The tokens of overlapping lifetimes do not overlap in the arena.
+   *  The "greedy_by_size" planner places the largest tokens first, each at the lowest offset it
+   *  fits at. The "best_fit" planner places the tokens in execution order, each in the
+   *  smallest gap it fits in.
+   */
+  void PlanOffsets() {
+    std::map<int, std::vector<StorageToken*>> arena_tokens;
+    std::vector<StorageToken*> kept;
+    for (StorageToken* tok : data_) {
+      if (!tok->is_fixed && !IsTexture(tok)) {
+        if (tok->last_step < 0) tok->last_step = step_;
+        arena_tokens[tok->device_type].push_back(tok);
+      } else {
+        kept.push_back(tok);
+      }
+    }
+    data_.clear();
+    for (StorageToken* tok : kept) {
+      tok->storage_id = static_cast<int64_t>(data_.size());
+      data_.push_back(tok);
+    }
+    for (auto& kv : arena_tokens) {
+      std::vector<StorageToken*>& tokens = kv.second;
+      bool best_fit = offset_planner_ == "best_fit";
+      std::sort(tokens.begin(), tokens.end(), [best_fit](StorageToken* a, StorageToken* b) {
+        if (best_fit && a->first_step != b->first_step) return a->first_step < b->first_step;
+        if (a->max_bytes != b->max_bytes) return a->max_bytes > b->max_bytes;
+        return a->first_step < b->first_step;
+      });
+      std::vector<StorageToken*> placed;
+      size_t arena_bytes = 0;
+      int64_t sid = static_cast<int64_t>(data_.size());
+      for (StorageToken* tok : tokens) {
+        size_t offset = FindOffset(tok, placed, best_fit);
+        tok->storage_offset = static_cast<int64_t>(offset);
+        tok->storage_id = sid;
+        arena_bytes = std::max(arena_bytes, offset + tok->max_bytes);
+        placed.push_back(tok);
+      }
+      StorageToken* arena = arena_.make<StorageToken>();
+      arena->max_bytes = arena_bytes;
+      arena->device_type = kv.first;
+      arena->storage_id = sid;
+      data_.push_back(arena);
+      LOG(INFO) << "The " << offset_planner_ << " plan puts " << tokens.size()
+                << " intermediates of device type " << kv.first << " in " << arena_bytes
+                << " bytes, the peak of their live bytes is " << PeakLiveBytes(tokens);
+    }
+  }
+  /*!
+   * \brief Find the offset of a token in the arena.
+   * \param tok The token.
+   * \param placed The tokens placed before.
+   * \param best_fit Whether to take the smallest gap the token fits in, the lowest otherwise.
+   * \return The offset, aligned for the allocations of the runtime.
+   */
+  static size_t FindOffset(const StorageToken* tok, const std::vector<StorageToken*>& placed,
+                           bool best_fit) {
+    auto align = [](size_t offset) {
+      return (offset + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+             runtime::kAllocAlignment;
+    };
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (const StorageToken* other : placed) {
+      if (other->first_step <= tok->last_step && tok->first_step <= other->last_step) {
+        size_t begin = static_cast<size_t>(other->storage_offset);
+        busy.emplace_back(begin, begin + other->max_bytes);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t best = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t end = 0;
+    for (const auto& range : busy) {
+      size_t begin = align(end);
+      if (range.first >= begin + tok->max_bytes) {
+        if (!best_fit) return begin;
+        if (range.first - begin < best_gap) {
+          best_gap = range.first - begin;
+          best = begin;
+        }
+      }
+      end = std::max(end, range.second);
+    }
+    return best != std::numeric_limits<size_t>::max() ? best : align(end);
+  }
+  /*!
+   * \brief The largest sum of the bytes of the tokens live at the same step, the smallest arena
+   *  any placement of the tokens takes, up to the alignment.
+   */
+  static size_t PeakLiveBytes(const std::vector<StorageToken*>& tokens) {
+    std::map<int, int64_t> deltas;
+    for (const StorageToken* tok : tokens) {
+      deltas[tok->first_step] += static_cast<int64_t>(tok->max_bytes);
+      deltas[tok->last_step + 1] -= static_cast<int64_t>(tok->max_bytes);
+    }
+    int64_t live = 0;
+    int64_t peak = 0;
+    for (const auto& kv : deltas) {
+      live += kv.second;
+      peak = std::max(peak, live);
+    }
+    return static_cast<size_t>(peak);
+  }
 
  private:
   // allocator
   support::Arena arena_;
+  // the offset planner, "greedy_by_size" or "best_fit", empty to plan storage ids only
+  std::string offset_planner_;
+  // the step of the call visited last
+  int step_{0};
   // scale used for rough match
   size_t match_range_{16};
+  // whether the elementwise calls can write over a dead argument
+  bool enable_inplace_{false};
   // free list of storage entry
   std::multimap<size_t, StorageToken*> free_;
+  // free list of the 2D images of the texture storage scopes
+  std::vector<StorageToken*> free_textures_;
   // all the storage resources available
   std::vector<StorageToken*> data_;
+  // the bytes of the storages never released, i.e. of the params and constants
+  size_t fixed_bytes_{0};
   /*! \brief internal prototype token map */
   std::unordered_map<const ExprNode*, std::vector<StorageToken*> > prototype_;
 };
 
 StaticMemoryPlan GraphPlanMemory(const Function& func) { return StorageAllocator().Plan(func); }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.enable_inplace", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.graph_memory_planner", String);
+
 TVM_REGISTER_GLOBAL("relay.backend.GraphPlanMemory").set_body_typed(GraphPlanMemory);
 
 }  // namespace relay
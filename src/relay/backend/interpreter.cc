@@ -31,6 +31,11 @@
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/object.h>
+#include <tvm/runtime/vm/memory_manager.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <vector>
 
 #include "../transforms/pass_utils.h"
 #include "compile_engine.h"
@@ -40,6 +45,8 @@ namespace relay {
 
 using namespace runtime;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.Interpreter.parallel", Bool);
+
 InterpreterClosure::InterpreterClosure(tvm::Map<Var, ObjectRef> env, Function func) {
   ObjectPtr<InterpreterClosureObj> n = make_object<InterpreterClosureObj>();
   n->env = std::move(env);
@@ -210,12 +217,23 @@ InterpreterState::InterpreterState(Expr current_expr, InterpreterState::Stack st
 // contains DAG in dataflow-form.
 //
 // Conversion to ANF is recommended before running the interpretation.
+//
+// The primitive functions are compiled once per structurally equal function
+// through the global compile engine, and their outputs are allocated from the
+// pooled allocator of the device, so the buffers of the dead values are reused.
+// With "relay.Interpreter.parallel", the consecutive let bindings of primitive
+// calls not depending on each other are evaluated in parallel.
 class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
                     PatternFunctor<bool(const Pattern& p, const ObjectRef& v)> {
  public:
-  Interpreter(IRModule mod, Device device, Target target)
-      : mod_(mod), device_(device), target_(target), debug_op_(Op::Get("debug")) {
+  Interpreter(IRModule mod, Device device, Target target, bool parallel = false)
+      : mod_(mod),
+        device_(device),
+        target_(target),
+        parallel_(parallel),
+        debug_op_(Op::Get("debug")) {
     engine_ = CompileEngine::Global();
+    allocator_ = vm::MemoryManager::GetOrCreateAllocator(device, vm::kPooled);
   }
 
   template <typename T>
@@ -287,6 +305,7 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
   Array<Shape> ComputeDynamicShape(const Function& func, const Array<ObjectRef>& args) {
     CCacheKey key(func, Target("llvm"));
     auto cfunc = engine_->LowerShapeFunc(key);
+    PackedFunc shape_func = engine_->JITShapeFunc(key);
     size_t arity = cfunc->inputs.size() + cfunc->outputs.size();
 
     std::vector<TVMValue> values(arity);
@@ -374,15 +393,7 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
     }
     ICHECK_EQ(cfunc->outputs.size(), out_cnt) << "Shape function output sizes mismatch";
 
-    PackedFunc shape_func;
-    Module m;
     TVMRetValue rv;
-    if (const auto* f = runtime::Registry::Get("relay.backend.build")) {
-      m = (*f)(cfunc->funcs, cfunc->target);
-    } else {
-      m = build(cfunc->funcs, cfunc->target, Target(nullptr));
-    }
-    shape_func = m.GetFunction(cfunc->prim_fn_var->name_hint);
     shape_func.CallPacked(TVMArgs(values.data(), codes.data(), arity), &rv);
 
     // Get output shapes
@@ -471,7 +482,7 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
         shape.push_back(ivalue[0]);
       }
       DLDataType dtype = rtype->dtype;
-      NDArray nd_array = NDArray::Empty(shape, dtype, device_);
+      NDArray nd_array = allocator_->Empty(shape, dtype, device_);
       setter(num_inputs + i, nd_array);
       return nd_array;
     };
@@ -580,15 +591,26 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
   }
 
   ObjectRef VisitExpr_(const LetNode* let) final {
-    if (auto func = let->value.as<FunctionNode>()) {
-      auto clo = MakeClosure(GetRef<Function>(func), let->var);
-      this->extend(let->var, clo);
-    } else {
-      auto value = Eval(let->value);
-      this->extend(let->var, value);
+    // The let chain is evaluated in a loop rather than by recursing into the bodies, as the
+    // chains of the programs in A-normal form are as long as the programs.
+    Expr expr = GetRef<Let>(let);
+    std::vector<PendingCall> pending;
+    while (const auto* node = expr.as<LetNode>()) {
+      expr = node->body;
+      if (parallel_ && Defer(node, &pending)) {
+        continue;
+      }
+      EvalPending(&pending);
+      if (auto func = node->value.as<FunctionNode>()) {
+        auto clo = MakeClosure(GetRef<Function>(func), node->var);
+        this->extend(node->var, clo);
+      } else {
+        auto value = Eval(node->value);
+        this->extend(node->var, value);
+      }
     }
-
-    return Eval(let->body);
+    EvalPending(&pending);
+    return Eval(expr);
   }
 
   ObjectRef VisitExpr_(const TupleGetItemNode* op) final {
@@ -701,6 +723,63 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
   }
 
  private:
+  /*! \brief A let binding of a primitive call, deferred to be evaluated with its neighbours */
+  struct PendingCall {
+    Var var;
+    Function func;
+    Array<ObjectRef> args;
+  };
+
+  // Defer the binding of a call to a primitive function whose arguments are bound (not pending)
+  // variables or constants, returning whether the binding was deferred.
+  bool Defer(const LetNode* let, std::vector<PendingCall>* pending) {
+    const auto* call = let->value.as<CallNode>();
+    if (call == nullptr || !call->op.as<VarNode>()) return false;
+    auto is_pending = [&](const Expr& expr) {
+      return std::any_of(pending->begin(), pending->end(),
+                         [&](const PendingCall& p) { return p.var.same_as(expr); });
+    };
+    if (is_pending(call->op)) return false;
+    // The functions bound by a let are recursive closures.
+    ObjectRef fn_val = Lookup(Downcast<Var>(call->op));
+    if (const auto* rec_closure = fn_val.as<RecClosureObj>()) {
+      fn_val = rec_closure->clos;
+    }
+    const auto* closure = fn_val.as<InterpreterClosureObj>();
+    if (closure == nullptr || !closure->func->HasNonzeroAttr(attr::kPrimitive)) return false;
+    const auto* body = closure->func->body.as<CallNode>();
+    if (body != nullptr && body->op == debug_op_) return false;
+    for (const Expr& arg : call->args) {
+      if (!arg.as<ConstantNode>() && !(arg.as<VarNode>() && !is_pending(arg))) return false;
+    }
+    Array<ObjectRef> args;
+    for (const Expr& arg : call->args) {
+      args.push_back(Eval(arg));
+    }
+    pending->push_back({let->var, closure->func, args});
+    return true;
+  }
+
+  // Evaluate the deferred bindings, in parallel when there are several, and bind their values.
+  void EvalPending(std::vector<PendingCall>* pending) {
+    if (pending->empty()) return;
+    std::vector<ObjectRef> values(pending->size());
+    if (pending->size() == 1) {
+      values[0] = InvokePrimitiveOp((*pending)[0].func, (*pending)[0].args);
+    } else {
+      // The lowering of the primitives reads the configs of the pass context, local to a thread.
+      transform::PassContext pass_ctx = transform::PassContext::Current();
+      support::parallel_for(0, static_cast<int>(pending->size()), [&](int i) {
+        With<transform::PassContext> ctx_scope(pass_ctx);
+        values[i] = InvokePrimitiveOp((*pending)[i].func, (*pending)[i].args);
+      });
+    }
+    for (size_t i = 0; i < pending->size(); ++i) {
+      this->extend((*pending)[i].var, values[i]);
+    }
+    pending->clear();
+  }
+
   // Module
   IRModule mod_;
   // For simplicity we only run the interpreter on a single context.
@@ -708,6 +787,10 @@ class Interpreter : public ExprFunctor<ObjectRef(const Expr& n)>,
   Device device_;
   // Target parameter being used by the interpreter.
   Target target_;
+  // Whether the independent primitive calls are evaluated in parallel.
+  bool parallel_;
+  // The allocator of the outputs of the primitive calls.
+  vm::Allocator* allocator_;
   // Object stack.
   Stack stack_;
   // Backend compile engine.
@@ -728,7 +811,10 @@ TypedPackedFunc<ObjectRef(Expr)> CreateInterpreter(IRModule mod, Device device,
     mod = seq(mod);
   }
 
-  auto intrp = std::make_shared<Interpreter>(mod, device, target);
+  bool parallel = transform::PassContext::Current()
+                      ->GetConfig<Bool>("relay.Interpreter.parallel", Bool(false))
+                      .value();
+  auto intrp = std::make_shared<Interpreter>(mod, device, target, parallel);
   auto packed = [intrp](Expr expr) {
     auto f = DetectFeature(expr);
     ICHECK(f.is_subset_of(FeatureSet::All() - fGraph));
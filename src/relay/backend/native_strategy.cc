@@ -0,0 +1,256 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/native_strategy.cc
+ * \brief The operator strategies implemented in C++, for lowering without Python.
+ */
+#include "native_strategy.h"
+
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/op.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/target/generic_func.h>
+#include <tvm/topi/nn/batch_matmul.h>
+#include <tvm/topi/nn/layer_norm.h>
+#include <tvm/topi/nn/pooling.h>
+#include <tvm/topi/nn/softmax.h>
+
+#include <string>
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+TVM_REGISTER_PASS_CONFIG_OPTION(kUseNativeStrategy, Bool);
+
+namespace {
+
+/*! \brief The priority of the native implementations */
+constexpr int kNativePriority = 10;
+
+/*!
+ * \brief Make the schedule function dispatching to a TOPI schedule registered as a generic
+ * function, e.g. "schedule_injective"
+ */
+FTVMSchedule TargetSchedule(const std::string& name) {
+  return [name](const Attrs& attrs, const Array<te::Tensor>& outs, const Target& target) {
+    With<Target> target_scope(target);
+    te::Schedule schedule = GenericFunc::Get(name)(outs);
+    return schedule;
+  };
+}
+
+/*! \brief Make a strategy of a single implementation */
+OpStrategy MakeStrategy(FTVMCompute fcompute, FTVMSchedule fschedule, const std::string& name) {
+  OpStrategy strategy(make_object<OpStrategyNode>());
+  strategy.AddImplementation(fcompute, fschedule, name, kNativePriority);
+  return strategy;
+}
+
+/*!
+ * \brief Register the native strategy of an operator, computed by a C++ compute and scheduled by a
+ * TOPI schedule
+ */
+GenericFunc NativeStrategy(const std::string& name, FTVMCompute fcompute,
+                           const std::string& schedule) {
+  return GenericFunc::Get("native." + name + "_strategy")
+      .set_default(runtime::TypedPackedFunc<OpStrategy(Attrs, Array<te::Tensor>, Type, Target)>(
+          [=](Attrs attrs, Array<te::Tensor> inputs, Type out_type, Target target) {
+            return MakeStrategy(fcompute, TargetSchedule(schedule), name + ".native");
+          }));
+}
+
+/*! \brief The type with the static dimensions of the tensors cast to int32, as in the inputs */
+Type ToInt32Shape(const Type& type) {
+  if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+    Array<PrimExpr> shape;
+    for (const PrimExpr& dim : tensor_type->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm && imm->dtype != DataType::Int(32) && imm->value <= INT32_MAX) {
+        shape.push_back(IntImm(DataType::Int(32), imm->value));
+      } else {
+        shape.push_back(dim);
+      }
+    }
+    return TensorType(shape, tensor_type->dtype);
+  }
+  if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+    Array<Type> fields;
+    for (const Type& field : tuple_type->fields) {
+      fields.push_back(ToInt32Shape(field));
+    }
+    return TupleType(fields);
+  }
+  return type;
+}
+
+DataType OutDType(DataType out_dtype, const te::Tensor& input) {
+  return out_dtype.bits() == 0 ? input->dtype : out_dtype;
+}
+
+}  // namespace
+
+OpStrategy GetNativeStrategy(const Op& op, const Attrs& attrs, const Array<te::Tensor>& inputs,
+                             const Type& out_type, const Target& target) {
+  static const auto& fnative = Op::GetAttrMap<FTVMStrategy>("FTVMNativeStrategy");
+  static const auto& fcompute = Op::GetAttrMap<FTVMCompute>("FTVMCompute");
+  static const auto& fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  With<Target> target_scope(target);
+  if (fnative.count(op)) {
+    return fnative[op](attrs, inputs, out_type, target);
+  }
+  if (!fcompute.count(op)) {
+    return OpStrategy();
+  }
+  int pattern = fpattern.get(op, kOpaque);
+  if (pattern <= kInjective) {
+    return MakeStrategy(fcompute[op], TargetSchedule("schedule_injective"), "injective.native");
+  }
+  if (pattern == kCommReduce) {
+    return MakeStrategy(fcompute[op], TargetSchedule("schedule_reduce"), "reduce.native");
+  }
+  return OpStrategy();
+}
+
+Optional<LoweredOutput> NativeLowerCall(const Call& call, const Array<te::Tensor>& inputs,
+                                        const Target& target) {
+  const auto* op = call->op.as<OpNode>();
+  ICHECK(op) << "Primitive function only allows call into primitive ops";
+  Type out_type = ToInt32Shape(call->checked_type());
+  OpStrategy strategy = GetNativeStrategy(GetRef<Op>(op), call->attrs, inputs, out_type, target);
+  if (!strategy.defined()) {
+    return NullOpt;
+  }
+  // The implementation of the highest priority among the unconditional ones.
+  OpImplementation best;
+  for (const OpSpecialization& specialization : strategy->specializations) {
+    if (specialization->condition.defined() && !specialization->condition->clauses.empty()) {
+      continue;
+    }
+    for (const OpImplementation& impl : specialization->implementations) {
+      if (!best.defined() || impl->plevel > best->plevel) {
+        best = impl;
+      }
+    }
+  }
+  if (!best.defined()) {
+    return NullOpt;
+  }
+  With<Target> target_scope(target);
+  Array<te::Tensor> outputs = best.Compute(call->attrs, inputs, out_type);
+  return LoweredOutput(outputs, best);
+}
+
+RELAY_REGISTER_OP("nn.dense")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "dense",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<DenseAttrs>();
+              ICHECK(param);
+              // The dense compute of the target, e.g. the one calling cuBLAS when enabled.
+              te::Tensor out = GenericFunc::Get("dense")(inputs[0], inputs[1], te::Tensor(),
+                                                         OutDType(param->out_dtype, inputs[0]));
+              return Array<te::Tensor>{out};
+            },
+            "schedule_dense"));
+
+RELAY_REGISTER_OP("nn.batch_matmul")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "batch_matmul",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<BatchMatmulAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{topi::nn::batch_matmul(
+                  inputs[0], inputs[1], OutDType(param->out_dtype, inputs[0]))};
+            },
+            "schedule_batch_matmul"));
+
+RELAY_REGISTER_OP("nn.softmax")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "softmax",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<SoftmaxAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{topi::nn::softmax(inputs[0], param->axis)};
+            },
+            "schedule_softmax"));
+
+RELAY_REGISTER_OP("nn.layer_norm")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "layer_norm",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<LayerNormAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{topi::nn::layer_norm(inputs[0], inputs[1], inputs[2],
+                                                            param->axis, param->epsilon,
+                                                            param->center, param->scale)};
+            },
+            "schedule_layer_norm"));
+
+RELAY_REGISTER_OP("nn.rms_norm")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "rms_norm",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<RMSNormAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{topi::nn::rms_norm(inputs[0], inputs[1], param->axis,
+                                                          param->epsilon, param->scale)};
+            },
+            "schedule_layer_norm"));
+
+RELAY_REGISTER_OP("nn.global_avg_pool2d")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "global_avg_pool2d",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<GlobalPool2DAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{
+                  topi::nn::global_pool(inputs[0], topi::nn::kAvgPool, param->layout)};
+            },
+            "schedule_global_pool"));
+
+RELAY_REGISTER_OP("nn.global_max_pool2d")
+    .set_attr<FTVMStrategy>(
+        "FTVMNativeStrategy",
+        NativeStrategy(
+            "global_max_pool2d",
+            [](const Attrs& attrs, const Array<te::Tensor>& inputs, const Type& out_type) {
+              const auto* param = attrs.as<GlobalPool2DAttrs>();
+              ICHECK(param);
+              return Array<te::Tensor>{
+                  topi::nn::global_pool(inputs[0], topi::nn::kMaxPool, param->layout)};
+            },
+            "schedule_global_pool"));
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file relay/backend/native_strategy.h
+ * \brief The operator strategies implemented in C++, for lowering without Python.
+ *
+ * The strategies registered from Python (`FTVMStrategy`) call into Python for every operator
+ * lowered, which needs the interpreter and serializes the lowering on the GIL. The native
+ * strategies build the implementations from the C++ computes and the TOPI schedules registered in
+ * `src/topi/schedule.cc` instead:
+ *
+ *  - the elementwise, broadcast and injective operators use their `FTVMCompute` and the
+ *    `schedule_injective` schedule of the target;
+ *  - the reductions use their `FTVMCompute` and the `schedule_reduce` schedule of the target;
+ *  - the other operators use the `FTVMNativeStrategy` attribute they register, a generic function
+ *    of the same signature as `FTVMStrategy`.
+ *
+ * The native strategies are used when `relay.backend.lower_call` is not registered, i.e. in a
+ * build without Python, or when the `relay.backend.use_native_strategy` pass config is set. They
+ * neither query AutoTVM nor evaluate specialized conditions: the implementation of the highest
+ * priority is picked.
+ */
+#ifndef TVM_RELAY_BACKEND_NATIVE_STRATEGY_H_
+#define TVM_RELAY_BACKEND_NATIVE_STRATEGY_H_
+
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op_strategy.h>
+#include <tvm/target/target.h>
+#include <tvm/te/tensor.h>
+
+#include "te_compiler_cache.h"
+
+namespace tvm {
+namespace relay {
+namespace tec {
+
+/*! \brief The pass config enabling the native strategies even when Python is available. */
+constexpr const char* kUseNativeStrategy = "relay.backend.use_native_strategy";
+
+/*!
+ * \brief Get the native strategy of an operator.
+ * \param op The operator.
+ * \param attrs The attributes of the call.
+ * \param inputs The input tensors.
+ * \param out_type The type of the output.
+ * \param target The target to lower the call for.
+ * \return The strategy, undefined if the operator has no native strategy.
+ */
+OpStrategy GetNativeStrategy(const Op& op, const Attrs& attrs, const Array<te::Tensor>& inputs,
+                             const Type& out_type, const Target& target);
+
+/*!
+ * \brief Lower a call to an operator with its native strategy.
+ * \param call The call.
+ * \param inputs The input tensors.
+ * \param target The target to lower the call for.
+ * \return The outputs and the implementation of the call, undefined if the operator has no native
+ * strategy.
+ */
+Optional<LoweredOutput> NativeLowerCall(const Call& call, const Array<te::Tensor>& inputs,
+                                        const Target& target);
+
+}  // namespace tec
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_BACKEND_NATIVE_STRATEGY_H_
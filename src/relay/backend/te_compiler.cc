@@ -21,6 +21,7 @@
 
 #include <tvm/driver/driver_api.h>
 #include <tvm/ir/type_functor.h>
+#include <tvm/node/serialization.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/device_copy.h>
@@ -30,19 +31,26 @@
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/te/operation.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
 #include <tvm/topi/tags.h>
 
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <iomanip>
 #include <limits>
 #include <mutex>
+#include <random>
+#include <sstream>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "../../support/utils.h"
 #include "../transforms/pass_utils.h"
 #include "te_compiler.h"
 #include "te_compiler_cache.h"
@@ -59,6 +67,9 @@ using namespace tvm::relay::transform;
 
 TVM_REGISTER_OBJECT_TYPE(TECompilerNode);
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.parallel_lowering", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.te_compiler_cache_dir", String);
+
 class TECompilerImpl : public TECompilerNode {
  public:
   // Lower the function.
@@ -88,6 +99,38 @@ class TECompilerImpl : public TECompilerNode {
     return LowerShapeFuncInternal(key)->cached_func;
   }
 
+  void LowerParallel(const Array<CCacheKey>& keys, const String mod_name) final {
+    auto mangle_fn = [mod_name](String name) { return runtime::get_name_mangled(mod_name, name); };
+    std::vector<CCacheKey> pending_keys;
+    std::vector<CCacheValue> pending_values;
+    std::vector<ScheduledFunc> pending;
+    {
+      // The schedules are built in order, they may call Python strategies and they
+      // assign the unique names.
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const CCacheKey& key : keys) {
+        CCacheValue value;
+        ScheduledFunc scheduled = ScheduleInternal(key, mangle_fn, false, &value);
+        if (!scheduled.cfunc.defined()) continue;
+        pending_keys.push_back(key);
+        pending_values.push_back(value);
+        pending.push_back(scheduled);
+      }
+    }
+    // The pass context and target are thread local, the workers enter those of the caller.
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    support::parallel_for(0, static_cast<int>(pending.size()), [&](int i) {
+      With<transform::PassContext> pass_ctx_scope(pass_ctx);
+      With<Target> target_scope(pending_keys[i]->target);
+      LowerSchedule(pending_keys[i], pending[i].cfunc);
+    });
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < pending.size(); ++i) {
+      pending_values[i]->cached_func = pending[i].cfunc;
+      SaveToDiskCache(pending_keys[i], pending[i]);
+    }
+  }
+
   Map<String, IRModule> GetLoweredFunctions() {
     Map<String, IRModule> lowered_functions;
     for (const auto& it : cache_) {
@@ -169,19 +212,48 @@ class TECompilerImpl : public TECompilerNode {
   CCacheKey GetCurrentCCacheKey() { return cur_ccache_key_; }
 
  private:
+  /*! \brief A scheduled function which still needs to be lowered to TIR. */
+  struct ScheduledFunc {
+    CachedFunc cfunc;
+    /*! \brief The name of the function before mangling and uniquifying. */
+    std::string base_name;
+  };
+
   // implement lowered func
   CCacheValue LowerInternal(const CCacheKey& key, std::function<String(String)> mangle_fn) {
     std::lock_guard<std::mutex> lock(mutex_);
     CCacheValue value;
+    ScheduledFunc scheduled = ScheduleInternal(key, mangle_fn, true, &value);
+    if (scheduled.cfunc.defined()) {
+      With<Target> target_scope(key->target);
+      LowerSchedule(key, scheduled.cfunc);
+      value->cached_func = scheduled.cfunc;
+      SaveToDiskCache(key, scheduled);
+    }
+    return value;
+  }
+
+  /*!
+   * \brief Find or create the cache entry of a function, and schedule it if it is not lowered yet.
+   * \param key The key of the function.
+   * \param mangle_fn The function mangling the name of the lowered function.
+   * \param count_use Whether to count this request in the use count of the entry.
+   * \param value The cache entry.
+   * \return The scheduled function to lower with LowerSchedule, undefined if the entry is
+   *  complete.
+   * \note Must be called with mutex_ held.
+   */
+  ScheduledFunc ScheduleInternal(const CCacheKey& key, std::function<String(String)> mangle_fn,
+                                 bool count_use, CCacheValue* value) {
     auto it = cache_.find(key);
     if (it != cache_.end()) {
-      it->second->use_count += 1;
-      if (it->second->cached_func.defined()) return it->second;
-      value = it->second;
+      if (count_use) it->second->use_count += 1;
+      *value = it->second;
+      if (it->second->cached_func.defined()) return ScheduledFunc();
     } else {
-      value = CCacheValue(make_object<CCacheValueNode>());
-      value->use_count = 1;
-      cache_[key] = value;
+      *value = CCacheValue(make_object<CCacheValueNode>());
+      (*value)->use_count = count_use ? 1 : 0;
+      cache_[key] = *value;
     }
     cur_ccache_key_ = key;
 
@@ -195,15 +267,24 @@ class TECompilerImpl : public TECompilerNode {
       auto target = Target("ext_dev");
       auto global_var = GlobalVar(func_name);
       global_var->checked_type_ = key->source_func->checked_type();
-      value->cached_func = CachedFunc(target, global_var, {}, {}, te::Schedule(), {}, ir_module);
-      return value;
+      (*value)->cached_func =
+          CachedFunc(target, global_var, {}, {}, te::Schedule(), {}, ir_module);
+      return ScheduledFunc();
     }
 
     // Enforce use the target.
     With<Target> target_scope(key->target);
 
-    ICHECK(!value->cached_func.defined());
-    auto cfunc = PrimFuncFor(key->source_func, key->target, [&](std::string name) {
+    ICHECK(!(*value)->cached_func.defined());
+    CachedFunc cached = LoadFromDiskCache(key, mangle_fn);
+    if (cached.defined()) {
+      (*value)->cached_func = cached;
+      return ScheduledFunc();
+    }
+
+    ScheduledFunc scheduled;
+    scheduled.cfunc = PrimFuncFor(key->source_func, key->target, [&](std::string name) {
+      scheduled.base_name = name;
       auto mangled = mangle_fn(name);
       return GetUniqueName(mangled, &name_map_);
     });
@@ -212,11 +293,15 @@ class TECompilerImpl : public TECompilerNode {
     const Expr body = (key->source_func)->body;
     if (const CallNode* call_node = body.as<CallNode>()) {
       if (call_node->attrs.as<DeviceCopyAttrs>()) {
-        value->cached_func = cfunc;
-        return value;
+        (*value)->cached_func = scheduled.cfunc;
+        return ScheduledFunc();
       }
     }
+    return scheduled;
+  }
 
+  /*! \brief Lower the schedule of a function to TIR, may run on any thread. */
+  static void LowerSchedule(const CCacheKey& key, const CachedFunc& cfunc) {
     // NOTE: array will copy on write.
     Array<te::Tensor> all_args = Array<te::Tensor>(cfunc->inputs);
     for (te::Tensor arg : cfunc->outputs) {
@@ -226,8 +311,91 @@ class TECompilerImpl : public TECompilerNode {
     std::unordered_map<te::Tensor, tir::Buffer> binds;
     auto func_name = cfunc->prim_fn_var->name_hint;
     cfunc->funcs->Update(tvm::LowerSchedule(cfunc->schedule, all_args, func_name, binds));
-    value->cached_func = cfunc;
-    return value;
+    PropagateFunctionAttrs(key->source_func, cfunc->funcs);
+  }
+
+  /*!
+   * \brief The file of a function in the on-disk cache, empty if the cache is disabled.
+   *
+   *  The auto-scheduler extracts its tasks while scheduling, so the cache is disabled with it.
+   */
+  static std::string DiskCachePath(const CCacheKey& key) {
+    std::string dir = backend::GetTECompilerCacheDir();
+    if (dir.empty() || backend::IsAutoSchedulerEnabled()) return "";
+    uint64_t hash = StructuralHash()(key->source_func);
+    hash = support::HashCombine(hash, StructuralHash()(String(key->target->str())));
+    hash = support::HashCombine(hash, StructuralHash()(String(TVM_VERSION)));
+    std::ostringstream os;
+    os << dir << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return os.str();
+  }
+
+  /*!
+   * \brief Load a lowered function from the on-disk cache, renamed to a unique name.
+   * \return The function, undefined if it is not in the cache.
+   */
+  CachedFunc LoadFromDiskCache(const CCacheKey& key, std::function<String(String)> mangle_fn) {
+    std::string path = DiskCachePath(key);
+    if (path.empty()) return CachedFunc();
+    std::ifstream fs(path, std::ios::in | std::ios::binary);
+    if (fs.fail()) return CachedFunc();
+    std::string blob((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    Map<String, ObjectRef> entry;
+    try {
+      entry = Downcast<Map<String, ObjectRef>>(LoadBinary(blob));
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Ignoring the invalid lowered function cache entry " << path;
+      return CachedFunc();
+    }
+    // Guard against hash collisions.
+    if (Downcast<String>(entry["target"]) != key->target->str() ||
+        !StructuralEqual()(entry["source_func"], key->source_func)) {
+      return CachedFunc();
+    }
+    GlobalVar old_var = Downcast<GlobalVar>(entry["prim_fn_var"]);
+    IRModule old_funcs = Downcast<IRModule>(entry["funcs"]);
+    std::string name = GetUniqueName(mangle_fn(Downcast<String>(entry["name"])), &name_map_);
+    GlobalVar prim_fn_var(name);
+    prim_fn_var->checked_type_ = old_var->checked_type_;
+    auto func = Downcast<tir::PrimFunc>(old_funcs->Lookup(old_var));
+    func = WithAttr(std::move(func), tvm::attr::kGlobalSymbol, String(name));
+    IRModule funcs(Map<GlobalVar, BaseFunc>({{prim_fn_var, func}}));
+    return CachedFunc(key->target, prim_fn_var, Downcast<Array<te::Tensor>>(entry["inputs"]),
+                      Downcast<Array<te::Tensor>>(entry["outputs"]), te::Schedule(), {}, funcs);
+  }
+
+  /*! \brief Save a lowered function to the on-disk cache, if enabled. */
+  void SaveToDiskCache(const CCacheKey& key, const ScheduledFunc& scheduled) {
+    const CachedFunc& cfunc = scheduled.cfunc;
+    if (scheduled.base_name.empty() || cfunc->funcs->functions.size() != 1 ||
+        !cfunc->funcs->ContainGlobalVar(cfunc->prim_fn_var->name_hint)) {
+      return;
+    }
+    std::string path = DiskCachePath(key);
+    if (path.empty()) return;
+    Map<String, ObjectRef> entry;
+    entry.Set("target", String(key->target->str()));
+    entry.Set("source_func", key->source_func);
+    entry.Set("name", String(scheduled.base_name));
+    entry.Set("prim_fn_var", cfunc->prim_fn_var);
+    entry.Set("inputs", cfunc->inputs);
+    entry.Set("outputs", cfunc->outputs);
+    entry.Set("funcs", cfunc->funcs);
+    // Write to a temporary file first, so that concurrent builds never read partial entries.
+    std::ostringstream tmp_path;
+    tmp_path << path << "." << std::hex << std::random_device()() << ".tmp";
+    {
+      std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+      if (fs.fail()) {
+        LOG(WARNING) << "Cannot write the lowered function cache entry " << tmp_path.str();
+        return;
+      }
+      std::string blob = SaveBinary(entry);
+      fs.write(blob.data(), blob.size());
+    }
+    if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+      std::remove(tmp_path.str().c_str());
+    }
   }
 
   // implement lowered shape func
@@ -250,7 +418,7 @@ class TECompilerImpl : public TECompilerNode {
     ICHECK(!value->cached_func.defined());
 
     using tvm::transform::PassContext;
-    With<PassContext> fresh_pass_ctx_scope(PassContext::Create());
+    With<PassContext> fresh_pass_ctx_scope(CreateLoweringPassContext());
     auto cached_func = ShapeFuncFor(key->source_func, key->target, [&](std::string name) {
       return GetUniqueName(name, &name_map_);
     });
@@ -303,6 +471,78 @@ std::tuple<bool, int, int> IsDeviceCopy(const Function& func) {
   return std::tuple<bool, int, int>(false, -1, -1);
 }
 
+/*!
+ * \brief Select the target of a primitive call from the device type it was planned on.
+ * \param targets The targets of the module.
+ * \param call_dev_type The device type of the call, 0 for the fallback device.
+ * \return The only target in the homogeneous case, the target of the device otherwise.
+ */
+Target SelectTarget(const TargetMap& targets, DLDeviceType call_dev_type) {
+  if (targets.size() == 1) {
+    // The homogeneous execution case, we should only have one target
+    // so we just grab it.
+    const auto& it = targets.begin();
+    return (*it).second;
+  }
+  // The heterogeneous execution case we have multiple targets
+  // in this case.
+  //
+  // We need to identify the target and translate.
+  std::string call_dev_name;
+  if (call_dev_type == 0) {
+    call_dev_name = "llvm";
+    call_dev_type = kDLCPU;
+  } else {
+    call_dev_name = ::tvm::runtime::DeviceName(call_dev_type);
+  }
+
+  if (targets.count(call_dev_type) == 0) {
+    std::stringstream msg;
+    msg << "No target is specified for provided device name: `" << call_dev_name << "`\n\n";
+    msg << call_dev_name << " mapped to device type (" << call_dev_type
+        << ") which was not found in the target map.\n";
+    msg << "Availible targets: \n";
+    for (auto target : targets) {
+      msg << "  " << target.first << "-> " << target.second << "\n";
+    }
+    LOG(FATAL) << msg.str();
+  }
+  return targets.at(call_dev_type);
+}
+
+/*!
+ * \brief Collect the cache keys of the primitive calls of a function, in the order in which
+ *  LowerTensorExpr lowers them, so that they can be lowered in parallel beforehand.
+ */
+class PrimitiveCallCollector : public ExprVisitor {
+ public:
+  PrimitiveCallCollector(const TargetMap& targets, const DeviceMap& device_ctx_map)
+      : targets_(targets), device_context_map_(device_ctx_map) {}
+
+  void VisitExpr_(const CallNode* call) final {
+    const auto* func = call->op.as<FunctionNode>();
+    if (func == nullptr || !func->HasNonzeroAttr(attr::kPrimitive)) {
+      ExprVisitor::VisitExpr_(call);
+      return;
+    }
+    for (const Expr& arg : call->args) {
+      VisitExpr(arg);
+    }
+    // External functions are lowered together by their codegen.
+    if (func->GetAttr<String>(attr::kCompiler).defined()) return;
+    auto it = device_context_map_.find(GetRef<Call>(call));
+    DLDeviceType call_dev_type =
+        it == device_context_map_.end() ? static_cast<DLDeviceType>(0) : (*it).second.device_type;
+    keys.push_back(CCacheKey(GetRef<Function>(func), SelectTarget(targets_, call_dev_type)));
+  }
+
+  Array<CCacheKey> keys;
+
+ private:
+  const TargetMap& targets_;
+  const DeviceMap& device_context_map_;
+};
+
 class LowerTensorExpr : public ExprMutator {
  public:
   LowerTensorExpr(const IRModule& module, const TargetMap& targets, const DeviceMap& device_ctx_map,
@@ -375,38 +615,7 @@ class LowerTensorExpr : public ExprMutator {
     auto call_dev_type = device_context.device_type;
 
     // Non-External Relay Function
-    if (targets_.size() == 1) {
-      // The homogeneous execution case, we should only have one target
-      // so we just grab it.
-      const auto& it = targets_.begin();
-      target = (*it).second;
-    } else {
-      // The heterogeneous execution case we have multiple targets
-      // in this case.
-      //
-      // We need to identify the target and translate.
-      std::string call_dev_name;
-      if (call_dev_type == 0) {
-        call_dev_name = "llvm";
-        call_dev_type = kDLCPU;
-      } else {
-        call_dev_name = ::tvm::runtime::DeviceName(call_dev_type);
-      }
-
-      if (targets_.count(call_dev_type) == 0) {
-        std::stringstream msg;
-        msg << "No target is specified for provided device name: `" << call_dev_name << "`\n\n";
-        msg << call_dev_name << " mapped to device type (" << call_dev_type
-            << ") which was not found in the target map.\n";
-        msg << "Availible targets: \n";
-        for (auto target : targets_) {
-          msg << "  " << target.first << "-> " << target.second << "\n";
-        }
-        LOG(FATAL) << msg.str();
-      }
-
-      target = targets_[call_dev_type];
-    }
+    target = SelectTarget(targets_, call_dev_type);
 
     CCacheKey key = CCacheKey(func, target);
     CachedFunc lowered_func = compiler_->Lower(key, module_name_);
@@ -431,6 +640,11 @@ class LowerTensorExpr : public ExprMutator {
     auto tir_call_attrs = make_object<TIRCallAttrs>();
     if (func->HasNonzeroAttr(attr::kReshapeOnly)) {
       tir_call_attrs->metadata.Set(attr::kReshapeOnly, tvm::Integer(1));
+    } else if (backend::IsInplaceFunction(func)) {
+      tir_call_attrs->metadata.Set(attr::kInplace, tvm::Integer(1));
+    }
+    if (Optional<String> scope = func->GetAttr<String>(attr::kOutputStorageScope)) {
+      tir_call_attrs->metadata.Set(attr::kOutputStorageScope, scope.value());
     }
 
     auto device_copy = IsDeviceCopy(func);
@@ -561,8 +775,11 @@ backend::FunctionInfo UpdateMainWorkspaceSize(const IRModule& mod, TargetMap tar
       // Here we record the largest size of the tensor
       // that share the same storage id, because storage_id will
       // be shared between multiple tensors that are not live simultaneously.
-      if (size_bytes > sid_workspace[devices[i]][storage_ids[i]]) {
-        sid_workspace[devices[i]][storage_ids[i]] = size_bytes;
+      // The tensors placed at offsets in the storage extend it to their end.
+      int64_t end = size_bytes;
+      if (!storage_info->storage_offsets.empty()) end += storage_info->storage_offsets[i];
+      if (end > sid_workspace[devices[i]][storage_ids[i]]) {
+        sid_workspace[devices[i]][storage_ids[i]] = end;
       }
     }
   }
@@ -700,6 +917,11 @@ LoweredModule LowerTE(const IRModule& module, TargetMap targets, DeviceMap devic
 
   auto pass = CreateFunctionPass(
       [=](Function func, IRModule module, PassContext ctx) {
+        if (backend::IsParallelLoweringEnabled()) {
+          PrimitiveCallCollector collector(targets, device_context_map);
+          collector.VisitExpr(func);
+          TECompiler(compiler)->LowerParallel(collector.keys, module_name);
+        }
         LowerTensorExpr lower_te(module, targets, device_context_map, process_fn, module_name,
                                  compiler);
         return Downcast<Function>(lower_te.VisitExpr(func));
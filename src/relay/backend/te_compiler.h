@@ -96,6 +96,16 @@ class TECompilerNode : public Object {
    */
   virtual CachedFunc Lower(const CCacheKey& key, const String mod_name) = 0;
 
+  /*!
+   * \brief Lower a batch of functions ahead of the Lower calls for them.
+   *
+   *  The functions are scheduled one after another, which keeps the names they get in
+   *  order, then their schedules are lowered to TIR on a pool of threads.
+   * \param keys The keys of the functions, in the order Lower would be called for them.
+   * \param mod_name The module name to mangle the function names with.
+   */
+  virtual void LowerParallel(const Array<CCacheKey>& keys, const String mod_name) = 0;
+
   /* Return all functions which have been lowered by the compiler, keyed by target. */
   virtual Map<String, IRModule> GetLoweredFunctions() = 0;
 
@@ -42,6 +42,7 @@
 #include <vector>
 
 #include "../transforms/pass_utils.h"
+#include "native_strategy.h"
 #include "utils.h"
 
 namespace tvm {
@@ -113,6 +114,10 @@ class ScheduleBuilder : public backend::MemoizedExprTranslator<Array<te::Tensor>
       : target_(target), device_copy_op_(Op::Get("device_copy")) {
     // Whether to use auto_scheduler schedule.
     use_auto_scheduler_ = backend::IsAutoSchedulerEnabled();
+    // Whether to lower with the native strategies even when Python is available.
+    use_native_strategy_ = transform::PassContext::Current()
+                               ->GetConfig<Bool>(kUseNativeStrategy, Bool(false))
+                               .value();
   }
 
   CachedFunc Create(const Function& prim_func, std::function<std::string(std::string)> renamer) {
@@ -234,7 +239,6 @@ class ScheduleBuilder : public backend::MemoizedExprTranslator<Array<te::Tensor>
   Array<te::Tensor> VisitExpr_(const CallNode* call_node) final {
     static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
     static auto flower_call = tvm::runtime::Registry::Get("relay.backend.lower_call");
-    ICHECK(flower_call) << "relay.backend.lower_call is not registered.";
 
     Array<te::Tensor> inputs;
     int count_tuple = 0;
@@ -263,9 +267,18 @@ class ScheduleBuilder : public backend::MemoizedExprTranslator<Array<te::Tensor>
       const auto* copy_input = inputs[0].operator->();
       outputs.push_back(te::Tensor(copy_input->shape, copy_input->dtype, te::Operation(), 0));
     } else {
-      LoweredOutput lowered_out = (*flower_call)(GetRef<Call>(call_node), inputs, target_);
-      outputs = lowered_out->outputs;
-      impl = lowered_out->implementation;
+      Optional<LoweredOutput> lowered_out;
+      if (use_native_strategy_ || flower_call == nullptr) {
+        lowered_out = NativeLowerCall(GetRef<Call>(call_node), inputs, target_);
+      }
+      if (!lowered_out) {
+        ICHECK(flower_call) << "relay.backend.lower_call is not registered, and " << op->name
+                            << " has no native strategy.";
+        LoweredOutput python_lowered_out = (*flower_call)(GetRef<Call>(call_node), inputs, target_);
+        lowered_out = python_lowered_out;
+      }
+      outputs = lowered_out.value()->outputs;
+      impl = lowered_out.value()->implementation;
     }
 
     int op_pattern = fpattern[op];
@@ -339,6 +352,7 @@ class ScheduleBuilder : public backend::MemoizedExprTranslator<Array<te::Tensor>
   std::ostringstream readable_name_stream_;
   Array<te::Operation> scalars_;
   bool use_auto_scheduler_;
+  bool use_native_strategy_;
   // Cache device copy op for equivalence checking to reduce registry lookup
   // overhead for each invocation of call node when retrieving schedules.
   const Op& device_copy_op_;
@@ -356,6 +370,18 @@ CachedFunc PrimFuncFor(const Function& source_func, const Target& target,
   return ScheduleBuilder(target).Create(source_func, renamer);
 }
 
+void PropagateFunctionAttrs(const Function& source_func, IRModule funcs) {
+  if (!source_func->HasNonzeroAttr(attr::kHorizontalFusion)) return;
+  std::vector<std::pair<GlobalVar, tir::PrimFunc>> updates;
+  for (const auto& kv : funcs->functions) {
+    if (const auto* prim_func = kv.second.as<tir::PrimFuncNode>()) {
+      updates.emplace_back(kv.first, WithAttr(GetRef<tir::PrimFunc>(prim_func),
+                                              tir::attr::kHorizontalFusion, Integer(1)));
+    }
+  }
+  for (const auto& update : updates) funcs->Update(update.first, update.second);
+}
+
 // Creates shape function from functor.
 class MakeShapeFunc : public backend::MemoizedExprTranslator<Array<te::Tensor>> {
  public:
@@ -459,7 +485,7 @@ class MakeShapeFunc : public backend::MemoizedExprTranslator<Array<te::Tensor>>
     }
 
     using tvm::transform::PassContext;
-    With<PassContext> fresh_pass_ctx_scope(PassContext::Create());
+    With<PassContext> fresh_pass_ctx_scope(CreateLoweringPassContext());
 
     std::unordered_map<te::Tensor, tir::Buffer> binds;
     IRModule ir_module = tvm::LowerSchedule(schedule, all_args, func_name, binds);
@@ -665,6 +691,12 @@ CachedFunc ShapeFuncFor(const Function& prim_func, const Target& target,
   return MakeShapeFunc().Create(prim_func, target, renamer);
 }
 
+transform::PassContext CreateLoweringPassContext() {
+  transform::PassContext pass_ctx = transform::PassContext::Create();
+  pass_ctx->instruments = transform::PassContext::Current()->instruments;
+  return pass_ctx;
+}
+
 /*!
  * \brief Get unique name from name.
  * \param name The orginal name.
@@ -213,8 +213,24 @@ CachedFunc PrimFuncFor(const Function& source_func, const Target& target,
 CachedFunc ShapeFuncFor(const Function& prim_func, const Target& target,
                         std::function<std::string(std::string)> renamer);
 
+/*!
+ * \brief Carry the attributes of a primitive function relevant to the lowering of TIR
+ *  to the PrimFuncs lowered from it.
+ * \param source_func The primitive function.
+ * \param funcs The module of the lowered functions, updated in place.
+ */
+void PropagateFunctionAttrs(const Function& source_func, IRModule funcs);
+
 std::string GetUniqueName(std::string name, std::unordered_map<std::string, int>* name_map);
 
+/*!
+ * \brief Create the fresh pass context the primitive functions are lowered in, which keeps the
+ *  instruments of the current pass context, so that the lowering is instrumented, e.g. profiled,
+ *  under the passes of the Relay build.
+ * \return The pass context.
+ */
+transform::PassContext CreateLoweringPassContext();
+
 // implementations
 inline size_t CCacheKeyNode::Hash() const {
   if (hash_ != 0) return hash_;
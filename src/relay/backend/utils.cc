@@ -24,6 +24,9 @@
 
 #include "utils.h"
 
+#include <tvm/relay/attrs/annotation.h>
+#include <tvm/relay/op_attr_types.h>
+
 namespace tvm {
 namespace relay {
 namespace backend {
@@ -31,11 +34,15 @@ namespace backend {
 TVM_REGISTER_NODE_TYPE(StorageInfoNode);
 
 StorageInfo::StorageInfo(std::vector<int64_t> storage_ids, std::vector<DLDeviceType> device_types,
-                         std::vector<int64_t> storage_sizes_in_bytes) {
+                         std::vector<int64_t> storage_sizes_in_bytes,
+                         std::vector<std::string> storage_scopes,
+                         std::vector<int64_t> storage_offsets) {
   auto n = make_object<StorageInfoNode>();
   n->storage_ids = std::move(storage_ids);
   n->device_types = std::move(device_types);
   n->storage_sizes_in_bytes = std::move(storage_sizes_in_bytes);
+  n->storage_scopes = std::move(storage_scopes);
+  n->storage_offsets = std::move(storage_offsets);
   data_ = std::move(n);
 }
 
@@ -63,6 +70,22 @@ TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageSizes").set_body_typed([](Storag
   return storage_sizes_in_bytes;
 });
 
+TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageScopes").set_body_typed([](StorageInfo si) {
+  Array<String> storage_scopes;
+  for (size_t i = 0; i < si->storage_ids.size(); ++i) {
+    storage_scopes.push_back(si->storage_scopes.empty() ? "global" : si->storage_scopes[i]);
+  }
+  return storage_scopes;
+});
+
+TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageOffsets").set_body_typed([](StorageInfo si) {
+  Array<tvm::Integer> storage_offsets;
+  for (size_t i = 0; i < si->storage_ids.size(); ++i) {
+    storage_offsets.push_back(si->storage_offsets.empty() ? 0 : si->storage_offsets[i]);
+  }
+  return storage_offsets;
+});
+
 TVM_REGISTER_NODE_TYPE(StaticMemoryPlanNode);
 
 StaticMemoryPlan::StaticMemoryPlan(Map<Expr, StorageInfo> expr_to_storage_info) {
@@ -95,6 +118,68 @@ int64_t CalculateRelayExprSizeBytes(const Type& expr_type) {
   return element_size * num_of_elements;
 }
 
+bool IsInplaceFunction(const Function& func) {
+  if (!func->HasNonzeroAttr(attr::kPrimitive) || func->GetAttr<String>(attr::kCompiler).defined() ||
+      !func->body->checked_type_.as<TensorTypeNode>()) {
+    return false;
+  }
+  class ElemwiseChecker : public ExprVisitor {
+   public:
+    void VisitExpr_(const CallNode* call) final {
+      static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+      const auto* op = call->op.as<OpNode>();
+      if (op == nullptr || fpattern.get(GetRef<Op>(op), kOpaque) > kBroadcast) {
+        elemwise = false;
+        return;
+      }
+      ExprVisitor::VisitExpr_(call);
+    }
+    void VisitExpr_(const TupleNode* op) final { elemwise = false; }
+    void VisitExpr_(const TupleGetItemNode* op) final { elemwise = false; }
+    void VisitExpr_(const LetNode* op) final { elemwise = false; }
+    void VisitExpr_(const IfNode* op) final { elemwise = false; }
+    void VisitExpr_(const FunctionNode* op) final { elemwise = false; }
+
+    bool elemwise = true;
+  } checker;
+  checker(func->body);
+  return checker.elemwise;
+}
+
+bool CanComputeInplace(const CallNode* call, size_t arg_index) {
+  bool inplace = false;
+  if (const auto* fn = call->op.as<FunctionNode>()) {
+    inplace = IsInplaceFunction(GetRef<Function>(fn));
+  } else if (const auto* tir_call_attrs = call->attrs.as<TIRCallAttrs>()) {
+    inplace = tir_call_attrs->metadata.count(attr::kInplace) != 0;
+  }
+  if (!inplace || arg_index >= call->args.size()) return false;
+  const auto* out_type = call->checked_type_.as<TensorTypeNode>();
+  const auto* arg_type = call->args[arg_index]->checked_type_.as<TensorTypeNode>();
+  if (out_type == nullptr || arg_type == nullptr) return false;
+  // The argument and the output are aliased element by element.
+  if (out_type->dtype.bits() * out_type->dtype.lanes() !=
+      arg_type->dtype.bits() * arg_type->dtype.lanes()) {
+    return false;
+  }
+  return StructuralEqual()(out_type->shape, arg_type->shape);
+}
+
+TVM_REGISTER_NODE_TYPE(PoolInfoNode);
+
+PoolInfo::PoolInfo(String pool_name, Integer size_bytes, Integer access_cost) {
+  auto n = make_object<PoolInfoNode>();
+  n->pool_name = std::move(pool_name);
+  n->size_bytes = std::move(size_bytes);
+  n->access_cost = std::move(access_cost);
+  data_ = std::move(n);
+}
+
+TVM_REGISTER_GLOBAL("relay.backend.PoolInfo")
+    .set_body_typed([](String pool_name, Integer size_bytes, Integer access_cost) {
+      return PoolInfo(pool_name, size_bytes, access_cost);
+    });
+
 TVM_REGISTER_NODE_TYPE(FunctionInfoNode);
 
 FunctionInfo::FunctionInfo(Map<Target, Integer> workspace_sizes, Map<Target, Integer> io_sizes,
@@ -57,6 +57,10 @@ class StorageInfoNode : public Object {
   std::vector<DLDeviceType> device_types;
   /* \brief The sizes of each storage element. */
   std::vector<int64_t> storage_sizes_in_bytes;
+  /* \brief The storage scope of each storage element, empty if all are in global memory. */
+  std::vector<std::string> storage_scopes;
+  /* \brief The byte offset of each element in its storage, empty if all are 0. */
+  std::vector<int64_t> storage_offsets;
 
   // TODO(@jroesch): expose the fields
   void VisitAttrs(AttrVisitor* v) {}
@@ -69,7 +73,9 @@ class StorageInfoNode : public Object {
 class StorageInfo : public ObjectRef {
  public:
   StorageInfo(std::vector<int64_t> storage_ids, std::vector<DLDeviceType> device_types,
-              std::vector<int64_t> storage_sizes_in_bytes);
+              std::vector<int64_t> storage_sizes_in_bytes,
+              std::vector<std::string> storage_scopes = {},
+              std::vector<int64_t> storage_offsets = {});
   TVM_DEFINE_OBJECT_REF_METHODS(StorageInfo, ObjectRef, StorageInfoNode);
 };
 
@@ -93,12 +99,44 @@ class StaticMemoryPlan : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(StaticMemoryPlan, ObjectRef, StaticMemoryPlanNode);
 };
 
+/*!
+ * \brief A memory region of the device, in which the AOT executor places the intermediate
+ *  tensors and the operator workspaces at compile time.
+ */
+class PoolInfoNode : public Object {
+ public:
+  /*! \brief The name of the pool, e.g. "sram". */
+  String pool_name;
+  /*! \brief The size of the pool in bytes. */
+  Integer size_bytes;
+  /*! \brief The relative cost of an access to the pool, the cheapest pools are filled first. */
+  Integer access_cost;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("pool_name", &pool_name);
+    v->Visit("size_bytes", &size_bytes);
+    v->Visit("access_cost", &access_cost);
+  }
+
+  static constexpr const char* _type_key = "relay.backend.PoolInfo";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PoolInfoNode, Object);
+};
+
+/*! \brief A memory pool for the AOT executor. */
+class PoolInfo : public ObjectRef {
+ public:
+  PoolInfo(String pool_name, Integer size_bytes, Integer access_cost);
+  TVM_DEFINE_OBJECT_REF_METHODS(PoolInfo, ObjectRef, PoolInfoNode);
+};
+
 struct FunctionInfoNode : public Object {
   Map<Target, Integer> workspace_sizes;
   Map<Target, Integer> io_sizes;
   Map<Target, Integer> constant_sizes;
   Map<Target, tir::PrimFunc> tir_primfuncs;
   Map<Target, Function> relay_primfuncs;
+  /*! \brief The bytes used in each workspace pool, only set for the main function. */
+  Map<String, Integer> workspace_pool_sizes;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("workspace_sizes", &workspace_sizes);
@@ -106,6 +144,7 @@ struct FunctionInfoNode : public Object {
     v->Visit("constant_sizes", &constant_sizes);
     v->Visit("tir_primfuncs", &tir_primfuncs);
     v->Visit("relay_primfuncs", &relay_primfuncs);
+    v->Visit("workspace_pool_sizes", &workspace_pool_sizes);
   }
 
   static constexpr const char* _type_key = "relay.backend.FunctionInfo";
@@ -128,6 +167,28 @@ class FunctionInfo : public ObjectRef {
  */
 int64_t CalculateRelayExprSizeBytes(const Type& expr_type);
 
+/*!
+ * \brief Check whether a primitive function only has elementwise and broadcast operators.
+ *
+ *  Each element of the output of such a function only reads the elements at the same
+ *  position of the arguments which have the shape of the output.
+ *
+ * \param func The primitive function.
+ */
+bool IsInplaceFunction(const Function& func);
+
+/*!
+ * \brief Check whether a call can write its output over one of its arguments.
+ *
+ *  The call needs to be to an in place function, either a primitive function or a lowered
+ *  one marked by attr::kInplace, and the argument needs the shape and the element size of
+ *  the output. Whether the argument is still read after the call is left to the caller.
+ *
+ * \param call The call.
+ * \param arg_index The index of the argument.
+ */
+bool CanComputeInplace(const CallNode* call, size_t arg_index);
+
 /*!
  *  \brief Executor generator artifacts. Those artifacts  are subsequently
  *  used by the relay build process.
@@ -410,6 +471,33 @@ inline bool IsCompileEngineCacheDisabled() {
       .value();
 }
 
+/*!
+ * \brief Return whether the primitive functions are lowered to TIR in parallel.
+ */
+inline bool IsParallelLoweringEnabled() {
+  return transform::PassContext::Current()
+      ->GetConfig<Bool>("relay.backend.parallel_lowering", Bool(false))
+      .value();
+}
+
+/*!
+ * \brief Return whether the memory planners let the elementwise calls compute in place.
+ */
+inline bool IsInplaceEnabled() {
+  return transform::PassContext::Current()
+      ->GetConfig<Bool>("relay.backend.enable_inplace", Bool(false))
+      .value();
+}
+
+/*!
+ * \brief Return the directory of the on-disk cache of lowered functions, empty if disabled.
+ */
+inline std::string GetTECompilerCacheDir() {
+  return transform::PassContext::Current()
+      ->GetConfig<String>("relay.backend.te_compiler_cache_dir", String(""))
+      .value();
+}
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
@@ -899,6 +899,11 @@ PackedFunc VMCompiler::GetFunction(const std::string& name, const ObjectPtr<Obje
       }
       *rv = ret;
     });
+  } else if (name == "set_shape_buckets") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.num_args, 3);
+      this->SetShapeBuckets(args[0], args[1], args[2]);
+    });
   } else if (name == "optimize") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       ICHECK_EQ(args.num_args, 3);
@@ -914,6 +919,13 @@ void VMCompiler::SetParam(const std::string& name, runtime::NDArray data_in) {
   params_[name] = data_in;
 }
 
+void VMCompiler::SetShapeBuckets(Map<String, Integer> inputs, Array<Integer> buckets,
+                                 double pad_value) {
+  bucket_inputs_ = inputs;
+  buckets_ = buckets;
+  bucket_pad_value_ = pad_value;
+}
+
 void VMCompiler::Lower(IRModule mod, const TargetsMap& targets, const tvm::Target& target_host) {
   exec_ = make_object<Executable>();
   targets_ = targets;
@@ -1020,6 +1032,13 @@ transform::Sequential MemoryOpt(tvm::Target host_target, TargetsMap targets) {
   // Compute away possibly introduced constant computation.
   pass_seqs.push_back(transform::FoldConstant());
 
+  // Pack the static allocations into pre-planned arenas.
+  if (transform::PassContext::Current()
+          ->GetConfig<Bool>("relay.vm.plan_static_memory", Bool(false))
+          .value()) {
+    pass_seqs.push_back(transform::PlanStaticMemory());
+  }
+
   // Lift constants to the top-level of the block to simplify VM code generation.
   // TODO(@icemelon9, @jroesch): Remove this pass for now because some
   //  instructions need to access to constant
@@ -1045,6 +1064,10 @@ IRModule VMCompiler::OptimizeModule(IRModule mod, const TargetsMap& targets_arg,
   Array<Pass> pass_seqs;
   Array<runtime::String> entry_functions{"main"};
   pass_seqs.push_back(transform::RemoveUnusedFunctions(entry_functions));
+  if (!bucket_inputs_.empty() && !buckets_.empty()) {
+    // Specialize main before it's optimized, so that every bucket is optimized for its extent.
+    pass_seqs.push_back(transform::BucketDynamicShape(bucket_inputs_, buckets_, bucket_pad_value_));
+  }
   pass_seqs.push_back(transform::ToBasicBlockNormalForm());
   // Run all dialect legalization passes.
   pass_seqs.push_back(relay::qnn::transform::Legalize());
@@ -1064,7 +1087,7 @@ IRModule VMCompiler::OptimizeModule(IRModule mod, const TargetsMap& targets_arg,
     if (expr.as<CallNode>()) {
       auto call_node = expr.as<CallNode>();
       auto op_node = call_node->op.as<OpNode>();
-      if (op_node->name == "cast") {
+      if (op_node && op_node->name == "cast") {
         auto attrs = call_node->attrs.as<CastAttrs>();
         if (attrs->dtype == DataType::Int(32)) {
           *rv = true;
@@ -1088,6 +1111,7 @@ IRModule VMCompiler::OptimizeModule(IRModule mod, const TargetsMap& targets_arg,
   // Alter layout transformation is only applied to homogeneous execution yet.
   if (targets.size() == 1) {
     pass_seqs.push_back(transform::AlterOpLayout());
+    pass_seqs.push_back(transform::MinimizeLayoutTransform());
   }
 
   // Fast math optimizations.
@@ -1101,6 +1125,9 @@ IRModule VMCompiler::OptimizeModule(IRModule mod, const TargetsMap& targets_arg,
   }
 
   pass_seqs.push_back(transform::FuseOps());
+  // Merge the calls to equal fused functions, and the common subexpressions of their bodies.
+  pass_seqs.push_back(transform::InferType());
+  pass_seqs.push_back(transform::EliminateCommonSubexpr(fskip));
   // Do layout rewrite for auto-scheduler.
   transform::PassContext pass_ctx = PassContext::Current();
   if (backend::IsAutoSchedulerEnabled() && targets.size() == 1) {
@@ -1118,6 +1145,9 @@ IRModule VMCompiler::OptimizeModule(IRModule mod, const TargetsMap& targets_arg,
     }
   }
 
+  // Pack the independent fused functions together, enabled at opt_level 4.
+  pass_seqs.push_back(transform::HorizontalFuseOps());
+
   pass_seqs.push_back(transform::ToANormalForm());
   pass_seqs.push_back(transform::InferType());
   pass_seqs.push_back(transform::LambdaLift());
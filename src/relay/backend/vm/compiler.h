@@ -101,6 +101,16 @@ class VMCompiler : public runtime::ModuleNode {
    */
   void SetParam(const std::string& name, runtime::NDArray data_in);
 
+  /*!
+   * \brief Compile main specialized for buckets of a dynamic input dimension
+   *
+   * \param inputs The names of the inputs to bucket, mapped to their dynamic dimension
+   * \param buckets The upper bounds of the buckets
+   * \param pad_value The value the inputs are padded to the bucket upper bound with
+   * \sa transform::BucketDynamicShape
+   */
+  void SetShapeBuckets(Map<String, Integer> inputs, Array<Integer> buckets, double pad_value);
+
   /*!
    * \brief Lower the functions in a Module
    *
@@ -147,6 +157,12 @@ class VMCompiler : public runtime::ModuleNode {
   ObjectPtr<Executable> exec_;
   /*! \brief parameters */
   std::unordered_map<std::string, runtime::NDArray> params_;
+  /*! \brief The inputs of main to bucket, mapped to their dynamic dimension */
+  Map<String, Integer> bucket_inputs_;
+  /*! \brief The upper bounds of the buckets */
+  Array<Integer> buckets_;
+  /*! \brief The value the bucketed inputs are padded with */
+  double bucket_pad_value_ = 0.0;
 };
 
 }  // namespace vm
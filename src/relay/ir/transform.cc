@@ -25,15 +25,22 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
 
 namespace tvm {
 namespace relay {
 namespace transform {
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.fallback_device_type", IntImm);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FunctionPass.num_threads", Integer);
 
 class FunctionPass;
 
+/*! \brief Whether the current thread optimizes functions for a parallel function pass. */
+static thread_local bool in_function_pass_worker = false;
+
 /*!
  * \brief Function-level passes are used to implement various global
  * optimizations for a given Relay module. It fetches one function at a time
@@ -55,6 +62,13 @@ class FunctionPassNode : public PassNode {
    */
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func;
 
+  /*!
+   * \brief Whether `pass_func` may run concurrently on different functions of a module, i.e. it
+   * only reads the module and keeps no state across the functions. The functions are optimized
+   * in parallel when the `relay.FunctionPass.num_threads` config is greater than 1.
+   */
+  bool thread_safe{true};
+
   FunctionPassNode() = default;
 
   void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("pass_info", &pass_info); }
@@ -86,6 +100,16 @@ class FunctionPassNode : public PassNode {
    * \return Return true if the function will be skipped, otherwise false.
    */
   bool SkipFunction(const Function& func) const;
+
+  /*!
+   * \brief Get the number of threads to optimize the functions of a module with.
+   *
+   * \param pass_ctx The context that the pass executes on.
+   * \param num_funcs The number of functions to optimize.
+   *
+   * \return Return the number of threads, 1 to optimize the functions sequentially.
+   */
+  int NumThreads(const PassContext& pass_ctx, int num_funcs) const;
 };
 
 class FunctionPass : public Pass {
@@ -141,12 +165,41 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   for (const auto& it : updated_mod->functions) {
     // only picks up relay::Function
     if (auto* n = it.second.as<FunctionNode>()) {
-      Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
-      updates.push_back({it.first, updated_func});
+      updates.push_back({it.first, GetRef<Function>(n)});
     }
   }
 
+  std::vector<int> todo;
+  for (size_t i = 0; i < updates.size(); ++i) {
+    if (!SkipFunction(updates[i].second)) {
+      todo.push_back(i);
+    }
+  }
+  int num_threads = NumThreads(pass_ctx, todo.size());
+  if (num_threads <= 1) {
+    for (int i : todo) {
+      updates[i].second = pass_func(updates[i].second, updated_mod, pass_ctx);
+    }
+  } else {
+    // The workers see the same configs and diagnostic context as this thread. The instruments
+    // are left to this thread: they were already entered, and are not thread safe.
+    auto worker_ctx_node = make_object<PassContextNode>(*pass_ctx.operator->());
+    worker_ctx_node->instruments = {};
+    PassContext worker_ctx(worker_ctx_node);
+    support::parallel_for(
+        0, todo.size(),
+        [&](int k) {
+          With<PassContext> scope(worker_ctx);
+          in_function_pass_worker = true;
+          int i = todo[k];
+          updates[i].second = pass_func(updates[i].second, updated_mod, worker_ctx);
+        },
+        1,
+        [num_threads](int begin, int end, int step, int) {
+          return support::rr_partitioner(begin, end, step, num_threads);
+        });
+  }
+
   for (const auto& pair : updates) {
     updated_mod->Add(pair.first, pair.second, true);
   }
@@ -167,6 +220,16 @@ bool FunctionPassNode::SkipFunction(const Function& func) const {
          func->GetAttr<Integer>(attr::kSkipOptimization, 0) != 0;
 }
 
+int FunctionPassNode::NumThreads(const PassContext& pass_ctx, int num_funcs) const {
+  // The nested function passes of a worker run sequentially, parallel_for does not nest.
+  if (!thread_safe || in_function_pass_worker || num_funcs <= 1) {
+    return 1;
+  }
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("relay.FunctionPass.num_threads", Integer(1)).value();
+  return std::min(num_threads, num_funcs);
+}
+
 Pass CreateFunctionPass(
     const runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)>& pass_func,
     int opt_level, String name, tvm::Array<String> required) {
@@ -179,7 +242,14 @@ TVM_REGISTER_NODE_TYPE(FunctionPassNode);
 TVM_REGISTER_GLOBAL("relay._transform.MakeFunctionPass")
     .set_body_typed(
         [](runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func,
-           PassInfo pass_info) { return FunctionPass(pass_func, pass_info); });
+           PassInfo pass_info) {
+          auto n = make_object<FunctionPassNode>();
+          n->pass_func = std::move(pass_func);
+          n->pass_info = std::move(pass_info);
+          // The passes implemented in Python run on the thread holding the interpreter.
+          n->thread_safe = false;
+          return FunctionPass(n);
+        });
 
 TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
     .set_dispatch<FunctionPassNode>([](const ObjectRef& ref, ReprPrinter* p) {
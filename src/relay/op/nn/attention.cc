@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file attention.cc
+ * \brief Fused attention operator
+ */
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/op.h>
+#include <tvm/tir/op.h>
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relay {
+
+// relay.nn.attention
+TVM_REGISTER_NODE_TYPE(AttentionAttrs);
+
+bool AttentionRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                  const TypeReporter& reporter) {
+  ICHECK_EQ(types.size(), 5);
+  const auto* query = types[0].as<TensorTypeNode>();
+  const auto* key = types[1].as<TensorTypeNode>();
+  const auto* value = types[2].as<TensorTypeNode>();
+  const auto* valid_length = types[3].as<TensorTypeNode>();
+  if (query == nullptr || key == nullptr || value == nullptr || valid_length == nullptr) {
+    return false;
+  }
+  ICHECK(query->shape.size() == 3 && key->shape.size() == 3 && value->shape.size() == 3)
+      << "Attention: expect the query, key and value of shape (batch, seq, dim), got "
+      << query->shape << ", " << key->shape << " and " << value->shape;
+  ICHECK(valid_length->dtype.is_int())
+      << "Attention: expect an integer valid_length, got " << valid_length->dtype;
+  ICHECK_LE(valid_length->shape.size(), 1)
+      << "Attention: expect a scalar or (batch,) valid_length, got " << valid_length->shape;
+  ICHECK(reporter->AssertEQ(query->shape[0], key->shape[0]) &&
+         reporter->AssertEQ(key->shape[0], value->shape[0]))
+      << "Attention: batch dimensions don't match, query shape=" << query->shape
+      << ", key shape=" << key->shape << ", value shape=" << value->shape;
+  ICHECK(reporter->AssertEQ(query->shape[2], key->shape[2]))
+      << "Attention: head dimensions of query and key don't match, query shape=" << query->shape
+      << ", key shape=" << key->shape;
+  ICHECK(reporter->AssertEQ(key->shape[1], value->shape[1]))
+      << "Attention: sequence lengths of key and value don't match, key shape=" << key->shape
+      << ", value shape=" << value->shape;
+  if (valid_length->shape.size() == 1) {
+    ICHECK(reporter->AssertEQ(valid_length->shape[0], query->shape[0]))
+        << "Attention: expect a valid length per batch, got " << valid_length->shape;
+  }
+  Array<PrimExpr> oshape{query->shape[0], query->shape[1], value->shape[2]};
+  reporter->Assign(types[4], TensorType(oshape, query->dtype));
+  return true;
+}
+
+// Positional relay function to create attention operator used by frontend FFI.
+Expr MakeAttention(Expr query, Expr key, Expr value, Expr valid_length, double scale,
+                   bool causal) {
+  auto attrs = make_object<AttentionAttrs>();
+  attrs->scale = scale;
+  attrs->causal = causal;
+  static const Op& op = Op::Get("nn.attention");
+  return Call(op, {query, key, value, valid_length}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op.nn._make.attention").set_body_typed(MakeAttention);
+
+RELAY_REGISTER_OP("nn.attention")
+    .describe(R"code(Computes the scaled dot-product attention of the queries over the keys.
+
+.. math::
+
+  attention(q, k, v)[b, :, :] = softmax(scale * q[b, :, :] k[b, :, :]^T + mask[b]) v[b, :, :]
+
+where the mask hides the keys from `valid_length[b]` on and, if causal, the keys past the
+position of the query, the last query being aligned with the last key. The scores are
+computed a tile of keys at a time with an online softmax, so that the (q_seq, kv_seq) score
+matrix is never stored.
+
+- **query**: `(b, q_seq, d)`
+- **key**: `(b, kv_seq, d)`
+- **value**: `(b, kv_seq, d_v)`
+- **valid_length**: `(b,)` or a scalar for all the batches
+- **out**: `(b, q_seq, d_v)`.
+
+)code" TVM_ADD_FILELINE)
+    .set_attrs_type<AttentionAttrs>()
+    .set_num_inputs(4)
+    .add_argument("query", "3D Tensor", "The queries.")
+    .add_argument("key", "3D Tensor", "The keys.")
+    .add_argument("value", "3D Tensor", "The values.")
+    .add_argument("valid_length", "Tensor", "The number of valid keys of each batch.")
+    .set_support_level(10)
+    .add_type_rel("Attention", AttentionRel);
+
+}  // namespace relay
+}  // namespace tvm
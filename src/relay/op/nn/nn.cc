@@ -32,6 +32,7 @@
 #include <tvm/topi/nn.h>
 #include <tvm/topi/nn/bias_add.h>
 #include <tvm/topi/nn/flatten.h>
+#include <tvm/topi/nn/layer_norm.h>
 #include <tvm/topi/nn/softmax.h>
 
 #include <algorithm>
@@ -853,6 +854,16 @@ Expr MakeLayerNorm(Expr data, Expr gamma, Expr beta, int axis, double epsilon, b
 
 TVM_REGISTER_GLOBAL("relay.op.nn._make.layer_norm").set_body_typed(MakeLayerNorm);
 
+Array<te::Tensor> LayerNormCompute(const Attrs& attrs, const Array<te::Tensor>& inputs,
+                                   const Type& out_type) {
+  const auto* param = attrs.as<LayerNormAttrs>();
+  ICHECK(param != nullptr);
+  return {topi::nn::layer_norm(inputs[0], inputs[1], inputs[2], param->axis, param->epsilon,
+                               param->center, param->scale)};
+}
+
+// The kernels compute the mean and the variance in one pass. They are kCommReduce so that
+// FuseOps fuses the producers of the data, e.g. a residual add, into them.
 RELAY_REGISTER_OP("nn.layer_norm")
     .describe(R"code(
 )code" TVM_ADD_FILELINE)
@@ -862,7 +873,61 @@ RELAY_REGISTER_OP("nn.layer_norm")
     .add_argument("gamma", "Tensor", "The gamma scale factor.")
     .add_argument("beta", "Tensor", "The beta offset factor.")
     .set_support_level(1)
-    .add_type_rel("LayerNorm", LayerNormRel);
+    .add_type_rel("LayerNorm", LayerNormRel)
+    .set_attr<FTVMCompute>("FTVMCompute", LayerNormCompute)
+    .set_attr<TOpPattern>("TOpPattern", kCommReduce);
+
+// rms_norm
+TVM_REGISTER_NODE_TYPE(RMSNormAttrs);
+
+bool RMSNormRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                const TypeReporter& reporter) {
+  ICHECK_EQ(types.size(), 3);
+  const auto* data = types[0].as<TensorTypeNode>();
+  if (data == nullptr) return false;
+  const RMSNormAttrs* param = attrs.as<RMSNormAttrs>();
+  int axis = param->axis >= 0 ? param->axis : param->axis + data->shape.size();
+  ICHECK(axis >= 0 && axis < (int)data->shape.size());
+  reporter->Assign(types[1], TensorType({data->shape[axis]}, data->dtype));
+  reporter->Assign(types[2], TensorType(data->shape, data->dtype));
+
+  return true;
+}
+
+Expr MakeRMSNorm(Expr data, Expr gamma, int axis, double epsilon, bool scale) {
+  auto attrs = make_object<RMSNormAttrs>();
+  attrs->axis = axis;
+  attrs->epsilon = epsilon;
+  attrs->scale = scale;
+  static const Op& op = Op::Get("nn.rms_norm");
+  return Call(op, {data, gamma}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op.nn._make.rms_norm").set_body_typed(MakeRMSNorm);
+
+Array<te::Tensor> RMSNormCompute(const Attrs& attrs, const Array<te::Tensor>& inputs,
+                                 const Type& out_type) {
+  const auto* param = attrs.as<RMSNormAttrs>();
+  ICHECK(param != nullptr);
+  return {topi::nn::rms_norm(inputs[0], inputs[1], param->axis, param->epsilon, param->scale)};
+}
+
+RELAY_REGISTER_OP("nn.rms_norm")
+    .describe(R"code(Root mean square normalization.
+
+.. math::
+
+    out = \frac{data}{\sqrt{mean(data^2, axis) + \epsilon}} * gamma
+
+)code" TVM_ADD_FILELINE)
+    .set_attrs_type<RMSNormAttrs>()
+    .set_num_inputs(2)
+    .add_argument("data", "Tensor", "Input to which rms_norm will be applied.")
+    .add_argument("gamma", "Tensor", "The gamma scale factor.")
+    .set_support_level(1)
+    .add_type_rel("RMSNorm", RMSNormRel)
+    .set_attr<FTVMCompute>("FTVMCompute", RMSNormCompute)
+    .set_attr<TOpPattern>("TOpPattern", kCommReduce);
 
 // group_norm
 TVM_REGISTER_NODE_TYPE(GroupNormAttrs);
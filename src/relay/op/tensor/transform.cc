@@ -33,6 +33,7 @@
 #include <tvm/tir/op.h>
 #include <tvm/topi/broadcast.h>
 #include <tvm/topi/detail/constant_utils.h>
+#include <tvm/topi/einsum.h>
 #include <tvm/topi/elemwise.h>
 #include <tvm/topi/nn.h>
 #include <tvm/topi/reduction.h>
@@ -1288,6 +1289,154 @@ Examples::
     .set_attr<FTVMCompute>("FTVMCompute", TakeCompute)
     .set_attr<TOpPattern>("TOpPattern", kInjective);
 
+// embedding_bag
+TVM_REGISTER_NODE_TYPE(EmbeddingBagAttrs);
+
+bool EmbeddingBagRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                     const TypeReporter& reporter) {
+  // `types` contains: [weight, indices, offsets, per_sample_weights, result]
+  ICHECK_EQ(types.size(), 5);
+  const auto* weight = types[0].as<TensorTypeNode>();
+  const auto* indices = types[1].as<TensorTypeNode>();
+  const auto* offsets = types[2].as<TensorTypeNode>();
+  const auto* per_sample_weights = types[3].as<TensorTypeNode>();
+  if (weight == nullptr || indices == nullptr || offsets == nullptr ||
+      per_sample_weights == nullptr) {
+    return false;
+  }
+  const auto* param = attrs.as<EmbeddingBagAttrs>();
+  ICHECK(param != nullptr);
+  ICHECK_EQ(weight->shape.size(), 2) << "weight of embedding_bag must be 2-D";
+  ICHECK(indices->dtype.is_int()) << "indices of embedding_bag must be tensor of integer";
+  ICHECK(offsets->dtype.is_int()) << "offsets of embedding_bag must be tensor of integer";
+  ICHECK_EQ(indices->shape.size(), 1) << "indices of embedding_bag must be 1-D";
+  ICHECK_EQ(offsets->shape.size(), 1) << "offsets of embedding_bag must be 1-D";
+  ICHECK(param->mode == "sum" || param->mode == "mean" || param->mode == "max")
+      << "embedding_bag does not support the mode " << param->mode;
+  // A scalar is the placeholder of the bags without per sample weights.
+  if (per_sample_weights->shape.size() != 0) {
+    ICHECK_EQ(param->mode, "sum") << "per_sample_weights of embedding_bag are only supported for "
+                                     "the sum mode";
+    ICHECK_EQ(per_sample_weights->shape.size(), 1)
+        << "per_sample_weights of embedding_bag must be a scalar or have the shape of indices";
+    ICHECK_EQ(per_sample_weights->dtype, weight->dtype)
+        << "per_sample_weights of embedding_bag must have the data type of the weight";
+    reporter->AssertEQ(per_sample_weights->shape[0], indices->shape[0]);
+  }
+  reporter->Assign(types[4], TensorType({offsets->shape[0], weight->shape[1]}, weight->dtype));
+  return true;
+}
+
+Expr MakeEmbeddingBag(Expr weight, Expr indices, Expr offsets, Expr per_sample_weights,
+                      String mode) {
+  auto attrs = make_object<EmbeddingBagAttrs>();
+  attrs->mode = std::move(mode);
+  static const Op& op = Op::Get("embedding_bag");
+  return Call(op, {weight, indices, offsets, per_sample_weights}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op._make.embedding_bag").set_body_typed(MakeEmbeddingBag);
+
+RELAY_REGISTER_OP("embedding_bag")
+    .describe(R"code(Reduce bags of rows of an embedding table.
+
+The bag b gathers the rows indices[offsets[b]:offsets[b + 1]] of the weight, the last bag the rows
+up to the end of indices, and reduces them without materializing the gathered rows.
+
+Examples::
+
+  weight = [[1., 2.],
+            [3., 4.],
+            [5., 6.]]
+  indices = [0, 2, 1, 1]
+  offsets = [0, 2, 2]
+  embedding_bag(weight, indices, offsets, 1.0) = [[6., 8.],
+                                                  [0., 0.],
+                                                  [6., 8.]]
+
+)code" TVM_ADD_FILELINE)
+    .set_attrs_type<EmbeddingBagAttrs>()
+    .set_num_inputs(4)
+    .add_argument("weight", "Tensor", "The embedding table.")
+    .add_argument("indices", "Tensor", "The rows of the bags, concatenated.")
+    .add_argument("offsets", "Tensor", "The start of each bag in indices.")
+    .add_argument("per_sample_weights", "Tensor",
+                  "The scale of each row of indices, or a scalar scaling all the rows in the sum "
+                  "mode.")
+    .set_support_level(3)
+    .add_type_rel("EmbeddingBag", EmbeddingBagRel)
+    .set_attr<TOpPattern>("TOpPattern", kOpaque);
+
+// einsum
+TVM_REGISTER_NODE_TYPE(EinsumAttrs);
+
+bool EinsumRel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+               const TypeReporter& reporter) {
+  // `types` contains: [data, result]
+  ICHECK_EQ(types.size(), 2);
+  const auto* tensor_tuple = types[0].as<TupleTypeNode>();
+  if (tensor_tuple == nullptr) {
+    ICHECK(types[0].as<IncompleteTypeNode>())
+        << "einsum: expect input type to be TupleType but get " << types[0];
+    return false;
+  }
+  const auto* param = attrs.as<EinsumAttrs>();
+  ICHECK(param != nullptr);
+  ICHECK_GT(tensor_tuple->fields.size(), 0) << "einsum: expect at least one operand";
+
+  std::vector<Array<PrimExpr>> input_shapes;
+  DataType dtype;
+  for (size_t i = 0; i < tensor_tuple->fields.size(); ++i) {
+    const auto* e = tensor_tuple->fields[i].as<TensorTypeNode>();
+    if (e == nullptr) {
+      return false;
+    }
+    if (i == 0) {
+      dtype = e->dtype;
+    }
+    ICHECK_EQ(e->dtype, dtype) << "einsum: expect all the operands to have the same dtype";
+    for (const PrimExpr& dim : e->shape) {
+      ICHECK(dim.as<IntImmNode>()) << "einsum: only supports operands of static shapes";
+    }
+    input_shapes.push_back(e->shape);
+  }
+  Array<PrimExpr> oshape = topi::NumpyEinsumShape(param->equation, input_shapes);
+  reporter->Assign(types[1], TensorType(oshape, dtype));
+  return true;
+}
+
+Array<te::Tensor> EinsumCompute(const Attrs& attrs, const Array<te::Tensor>& inputs,
+                                const Type& out_type) {
+  const auto* param = attrs.as<EinsumAttrs>();
+  ICHECK(param != nullptr);
+  return Array<te::Tensor>{topi::einsum(param->equation, inputs)};
+}
+
+Expr MakeEinsum(Expr data, String equation) {
+  auto attrs = make_object<EinsumAttrs>();
+  attrs->equation = std::move(equation);
+  static const Op& op = Op::Get("einsum");
+  return Call(op, {data}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relay.op._make.einsum").set_body_typed(MakeEinsum);
+
+RELAY_REGISTER_OP("einsum")
+    .describe(R"code(Evaluates the Einstein summation convention on the operands.
+
+The einsum is lowered as a single compute, each element of the output expanding the sum over all
+the reduced labels. An einsum of several operands is legalized into pairwise contractions mapped
+to dense and batch_matmul instead, in the order of least cost.
+
+)code" TVM_ADD_FILELINE)
+    .set_attrs_type<EinsumAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tuple of Tensors", "The input list of tensors.")
+    .set_support_level(11)
+    .add_type_rel("Einsum", EinsumRel)
+    .set_attr<FTVMCompute>("FTVMCompute", EinsumCompute)
+    .set_attr<TOpPattern>("TOpPattern", kInjective);
+
 // Init ops
 TVM_REGISTER_NODE_TYPE(InitOpAttrs);
 
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/qnn/op/dense_int4.cc
+ * \brief Dense with int4 weights packed two per byte, and the packing of the weights.
+ *
+ * The weights are quantized symmetrically: a weight is its int4 value, in [-8, 7], times the
+ * scale of the tensor, of its output channel or of its group of the reduction axis. The dense
+ * unpacks the bytes and scales the weights in its reduction, the unpacked weights are never
+ * stored.
+ */
+
+#include <tvm/relay/base.h>
+#include <tvm/relay/op.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/qnn/attrs.h>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace relay {
+namespace qnn {
+
+TVM_REGISTER_NODE_TYPE(DenseInt4Attrs);
+
+bool PackInt4Rel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                 const TypeReporter& reporter) {
+  // Expected Types: weight, out_type
+  ICHECK_EQ(types.size(), 2);
+  const auto* weight = types[0].as<TensorTypeNode>();
+  if (weight == nullptr) return false;
+  ICHECK(weight->dtype == DataType::Int(8))
+      << "Expected the int4 values in int8 for the weight but was " << weight->dtype;
+  ICHECK_GT(weight->shape.size(), 0U) << "The packed weight must have at least one axis";
+  const auto* last = weight->shape.back().as<IntImmNode>();
+  ICHECK(last && last->value % 2 == 0)
+      << "The last axis of the packed weight must have an even static size";
+  Array<IndexExpr> oshape = weight->shape;
+  oshape.Set(oshape.size() - 1, Integer(last->value / 2));
+  reporter->Assign(types[1], TensorType(oshape, DataType::UInt(8)));
+  return true;
+}
+
+Expr MakePackInt4(Expr weight) {
+  static const Op& op = Op::Get("qnn.pack_int4");
+  return Call(op, {weight}, Attrs(), {});
+}
+
+RELAY_REGISTER_OP("qnn.pack_int4")
+    .describe(R"code(Packs int4 values, held in int8, two per byte along the last axis.
+The even elements go in the low nibbles, the odd ones in the high nibbles.
+- **weight**: (d_1, ..., d_n) int8 in [-8, 7], d_n even.
+- **out**: (d_1, ..., d_n / 2) uint8.
+)code" TVM_ADD_FILELINE)
+    .set_num_inputs(1)
+    .add_argument("weight", "Tensor", "The int4 values.")
+    .set_support_level(11)
+    .add_type_rel("QnnPackInt4", PackInt4Rel);
+
+TVM_REGISTER_GLOBAL("relay.qnn.op._make.pack_int4").set_body_typed(MakePackInt4);
+
+bool DenseInt4Rel(const Array<Type>& types, int num_inputs, const Attrs& attrs,
+                  const TypeReporter& reporter) {
+  // Expected Types: data, packed_weight, weight_scale, out_type
+  ICHECK_EQ(types.size(), 4);
+  const auto* data = types[0].as<TensorTypeNode>();
+  const auto* weight = types[1].as<TensorTypeNode>();
+  if (data == nullptr || weight == nullptr) return false;
+  if (types[2].as<IncompleteTypeNode>()) return false;
+  const auto* param = attrs.as<DenseInt4Attrs>();
+  ICHECK(param != nullptr) << "DenseInt4Attrs cannot be nullptr.";
+  ICHECK(data->dtype.is_float()) << "Expected a float input but was " << data->dtype;
+  ICHECK(weight->dtype == DataType::UInt(8))
+      << "Expected the weight packed by qnn.pack_int4 but was " << weight->dtype;
+  ICHECK_EQ(data->shape.size(), 2U) << "Expected a 2-D input";
+  ICHECK_EQ(weight->shape.size(), 2U) << "Expected a 2-D packed weight";
+
+  IndexExpr units = param->units.defined() ? param->units : weight->shape[0];
+  reporter->AssertEQ(weight->shape[0], units);
+  IndexExpr reduction = data->shape[1];
+  reporter->AssertEQ(weight->shape[1] * 2, reduction);
+  int64_t group_size =
+      AssignGroupedScaleType(types[2], data->dtype, units, reduction, reporter);  // weight_scale
+  ICHECK_EQ(group_size % 2, 0) << "The groups of the scale must cover whole bytes of the weight";
+
+  DataType out_dtype = param->out_dtype.is_void() ? data->dtype : param->out_dtype;
+  reporter->Assign(types[3], TensorType({data->shape[0], units}, out_dtype));
+  return true;
+}
+
+Expr MakeDenseInt4(Expr data, Expr packed_weight, Expr weight_scale, IndexExpr units,
+                   DataType out_dtype) {
+  auto attrs = make_object<DenseInt4Attrs>();
+  attrs->units = std::move(units);
+  attrs->out_dtype = out_dtype;
+  static const Op& op = Op::Get("qnn.dense_int4");
+  return Call(op, {data, packed_weight, weight_scale}, Attrs(attrs), {});
+}
+
+RELAY_REGISTER_OP("qnn.dense_int4")
+    .describe(R"code(Applies a linear transformation with int4 weights: :math:`Y = XW^T`.
+The weights are unpacked and scaled in the reduction.
+- **data**: (batch, in_dim) float.
+- **packed_weight**: (units, in_dim / 2) uint8, packed by qnn.pack_int4.
+- **weight_scale**: (), (units,) or (units, groups) with in_dim / groups even.
+- **out**: (batch, units).
+)code" TVM_ADD_FILELINE)
+    .set_attrs_type<DenseInt4Attrs>()
+    .set_num_inputs(3)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .add_argument("packed_weight", "Tensor", "The int4 weights, packed two per byte.")
+    .add_argument("weight_scale", "Tensor", "The scale of the weights.")
+    .set_support_level(11)
+    .add_type_rel("QnnDenseInt4", DenseInt4Rel);
+
+TVM_REGISTER_GLOBAL("relay.qnn.op._make.dense_int4").set_body_typed(MakeDenseInt4);
+
+}  // namespace qnn
+}  // namespace relay
+}  // namespace tvm
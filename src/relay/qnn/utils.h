@@ -211,6 +211,47 @@ static inline void AssignType(const Type& expr_type, const DataType& dtype, cons
   }
 }
 
+/*
+ * \brief Checks and assigns the type of the scale of a weight quantized per tensor, per output
+ *  channel or per group of consecutive elements of the reduction axis.
+ * \param expr_type The type of the scale, of shape (), (channels,) or (channels, groups).
+ * \param dtype The expected dtype.
+ * \param channels The number of output channels.
+ * \param reduction The size of the reduction axis, split in groups of the same size.
+ * \param reporter The type reported of original InferType call.
+ * \return The number of elements of a group, 0 when the scale is not per group.
+ */
+static inline int64_t AssignGroupedScaleType(const Type& expr_type, const DataType& dtype,
+                                             const IndexExpr& channels, const IndexExpr& reduction,
+                                             const TypeReporter& reporter) {
+  const auto* tensor_type = expr_type.as<TensorTypeNode>();
+  ICHECK(tensor_type) << "Can assign type to Tensor type only. But got "
+                      << AsText(expr_type, false);
+  ICHECK(tensor_type->dtype == dtype)
+      << "Expected type is " << dtype << " but received " << tensor_type->dtype;
+  switch (tensor_type->shape.size()) {
+    case 0:
+      return 0;
+    case 1:
+      reporter->Assign(expr_type, TensorType({channels}, dtype));
+      return 0;
+    case 2: {
+      const auto* groups = tensor_type->shape[1].as<IntImmNode>();
+      const auto* size = reduction.as<IntImmNode>();
+      ICHECK(groups && size) << "The groups of the scale must have static shapes";
+      ICHECK(groups->value > 0 && size->value % groups->value == 0)
+          << "The reduction axis of " << size->value << " elements can't be split in "
+          << groups->value << " groups";
+      reporter->Assign(expr_type, TensorType({channels, tensor_type->shape[1]}, dtype));
+      return size->value / groups->value;
+    }
+    default:
+      LOG(FATAL) << "The scale must be a scalar, per channel or per group, but got "
+                 << AsText(expr_type, false);
+      return 0;
+  }
+}
+
 static inline std::vector<float> GetFloatVectorFromConstant(const Expr& expr) {
   const auto* n = expr.as<ConstantNode>();
   std::vector<float> vals;
@@ -0,0 +1,289 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file src/relay/transforms/auto_device_placement.cc
+ * \brief Place the calls of main on the fallback device or a second device, by cost.
+ *
+ * Each call costs its latency on the device it runs on, and each value produced on one
+ * device and read on the other costs a copy. The graph executor runs the calls one after
+ * the other, so the latency of main is the sum of these costs. With two devices, the
+ * placement minimizing it is a minimum s-t cut:
+ *
+ *   fallback --cost on device--> call --cost on fallback--> device
+ *   call <--copy cost--> consumer
+ *
+ * The calls on the fallback side of the cut stay unannotated, the others are wrapped in
+ * on_device, and RewriteAnnotatedOps then inserts the device copies of the cut edges.
+ * The calls already annotated keep their device.
+ */
+
+#include <tvm/relay/attrs/annotation.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+/*! \brief Maximum flow by shortest augmenting paths, for the small graphs of the calls. */
+class MinCut {
+ public:
+  explicit MinCut(int num_nodes) : adj_(num_nodes) {}
+
+  void AddEdge(int from, int to, double capacity, double reverse_capacity = 0) {
+    adj_[from].push_back(edges_.size());
+    edges_.push_back({to, capacity});
+    adj_[to].push_back(edges_.size());
+    edges_.push_back({from, reverse_capacity});
+  }
+
+  /*! \return Whether each node is on the source side of a minimum cut. */
+  std::vector<bool> Solve(int source, int sink) {
+    while (true) {
+      std::vector<int> parent_edge(adj_.size(), -1);
+      std::vector<bool> seen = Reachable(source, &parent_edge);
+      if (!seen[sink]) return seen;
+      double flow = std::numeric_limits<double>::infinity();
+      for (int v = sink; v != source; v = edges_[parent_edge[v] ^ 1].to) {
+        flow = std::min(flow, edges_[parent_edge[v]].capacity);
+      }
+      for (int v = sink; v != source; v = edges_[parent_edge[v] ^ 1].to) {
+        edges_[parent_edge[v]].capacity -= flow;
+        edges_[parent_edge[v] ^ 1].capacity += flow;
+      }
+    }
+  }
+
+ private:
+  struct Edge {
+    int to;
+    double capacity;
+  };
+
+  std::vector<bool> Reachable(int source, std::vector<int>* parent_edge) {
+    std::vector<bool> seen(adj_.size(), false);
+    std::queue<int> queue;
+    seen[source] = true;
+    queue.push(source);
+    while (!queue.empty()) {
+      int v = queue.front();
+      queue.pop();
+      for (size_t e : adj_[v]) {
+        // Ignore the residual capacities lost in the rounding of the costs.
+        if (edges_[e].capacity <= 1e-9 || seen[edges_[e].to]) continue;
+        seen[edges_[e].to] = true;
+        (*parent_edge)[edges_[e].to] = static_cast<int>(e);
+        queue.push(edges_[e].to);
+      }
+    }
+    return seen;
+  }
+
+  std::vector<std::vector<size_t>> adj_;
+  std::vector<Edge> edges_;
+};
+
+/*! \brief Visit the calls in post order, without entering the functions they call. */
+class CallCollector : public ExprVisitor {
+ public:
+  explicit CallCollector(std::function<void(const CallNode*)> fvisit) : fvisit_(fvisit) {}
+
+  void VisitExpr_(const CallNode* op) final {
+    ExprVisitor::VisitExpr_(op);
+    fvisit_(op);
+  }
+
+  void VisitExpr_(const FunctionNode* op) final {}
+
+ private:
+  std::function<void(const CallNode*)> fvisit_;
+};
+
+class DevicePlacer : public ExprMutator {
+ public:
+  DevicePlacer(int fallback_device, int device, PackedFunc cost_fn, double transfer_gbps,
+               double transfer_latency_us)
+      : fallback_device_(fallback_device),
+        device_(device),
+        cost_fn_(cost_fn),
+        transfer_gbps_(transfer_gbps),
+        transfer_latency_us_(transfer_latency_us) {}
+
+  Expr Place(const Expr& body) {
+    Collect(body);
+    int num_calls = calls_.size();
+    int source = num_calls, sink = num_calls + 1;
+    MinCut cut(num_calls + 2);
+    // A cost large enough to never be cut, without the infinities of the unsupported ops.
+    const double kForbidden = 1e15;
+    for (int i = 0; i < num_calls; ++i) {
+      const CallNode* call = calls_[i];
+      double on_fallback = kForbidden, on_device = kForbidden;
+      auto it = fixed_.find(call);
+      if (it == fixed_.end() || it->second == fallback_device_) {
+        on_fallback = std::min(Cost(call, fallback_device_), kForbidden);
+      }
+      if (it == fixed_.end() || it->second == device_) {
+        on_device = std::min(Cost(call, device_), kForbidden);
+      }
+      cut.AddEdge(source, i, on_device);
+      cut.AddEdge(i, sink, on_fallback);
+      for (const auto& input : inputs_[i]) {
+        double copy = transfer_latency_us_ + input.second / (transfer_gbps_ * 1e3);
+        cut.AddEdge(input.first, i, copy, copy);
+      }
+    }
+    std::vector<bool> on_fallback = cut.Solve(source, sink);
+    for (int i = 0; i < num_calls; ++i) {
+      if (!on_fallback[i] && !fixed_.count(calls_[i])) placed_.insert(calls_[i]);
+    }
+    return VisitExpr(body);
+  }
+
+  Expr VisitExpr_(const CallNode* call_node) final {
+    Expr new_call = ExprMutator::VisitExpr_(call_node);
+    if (!placed_.count(call_node)) return new_call;
+    auto attrs = make_object<OnDeviceAttrs>();
+    attrs->device_type = device_;
+    static const Op& on_device_op = Op::Get("on_device");
+    return Call(on_device_op, {new_call}, Attrs(attrs), {});
+  }
+
+  Expr VisitExpr_(const FunctionNode* op) final {
+    // The calls of the functions called by main, e.g. the composites, are not placed.
+    return GetRef<Function>(op);
+  }
+
+ private:
+  double Cost(const CallNode* call, int device_type) {
+    double cost = cost_fn_(GetRef<Call>(call), device_type);
+    ICHECK_GE(cost, 0) << "The cost of " << call->op << " on the device " << device_type
+                       << " is negative";
+    return cost;
+  }
+
+  static double NumBytes(const Type& type) {
+    const auto* tensor = type.as<TensorTypeNode>();
+    if (tensor == nullptr) return 0;
+    double bytes = tensor->dtype.bytes() * tensor->dtype.lanes();
+    for (const PrimExpr& dim : tensor->shape) {
+      // The dynamic dimensions count as one.
+      if (const auto* imm = dim.as<IntImmNode>()) bytes *= imm->value;
+    }
+    return bytes;
+  }
+
+  // Visit the calls of the dataflow in post order, with the calls they read from.
+  void Collect(const Expr& body) {
+    static const Op& on_device_op = Op::Get("on_device");
+    CallCollector([&](const CallNode* call) {
+      if (call->op == on_device_op) {
+        int device_type = call->attrs.as<OnDeviceAttrs>()->device_type;
+        ICHECK(device_type == fallback_device_ || device_type == device_)
+            << "The call annotated on the device " << device_type
+            << " is neither on the fallback device nor on the placed device";
+        if (const auto* inner = call->args[0].as<CallNode>()) fixed_[inner] = device_type;
+        return;
+      }
+      std::vector<std::pair<int, double>> inputs;
+      for (const Expr& arg : call->args) {
+        Producers(arg, NumBytes(arg->checked_type()), &inputs);
+      }
+      index_[call] = calls_.size();
+      calls_.push_back(call);
+      inputs_.push_back(inputs);
+    }).VisitExpr(body);
+  }
+
+  // The calls computing the value of expr, through the tuples and the annotations.
+  void Producers(const Expr& expr, double bytes, std::vector<std::pair<int, double>>* inputs) {
+    static const Op& on_device_op = Op::Get("on_device");
+    if (const auto* call = expr.as<CallNode>()) {
+      if (call->op == on_device_op) {
+        Producers(call->args[0], bytes, inputs);
+        return;
+      }
+      auto it = index_.find(call);
+      if (it != index_.end()) inputs->emplace_back(it->second, bytes);
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        Producers(field, NumBytes(field->checked_type()), inputs);
+      }
+    } else if (const auto* get = expr.as<TupleGetItemNode>()) {
+      if (const auto* tuple = get->tuple.as<TupleNode>()) {
+        Producers(tuple->fields[get->index], bytes, inputs);
+      } else {
+        Producers(get->tuple, bytes, inputs);
+      }
+    }
+  }
+
+  int fallback_device_;
+  int device_;
+  PackedFunc cost_fn_;
+  double transfer_gbps_;
+  double transfer_latency_us_;
+  /*! \brief The calls of main, in post order. */
+  std::vector<const CallNode*> calls_;
+  std::unordered_map<const CallNode*, int> index_;
+  /*! \brief The producer and the number of bytes of each input of each call. */
+  std::vector<std::vector<std::pair<int, double>>> inputs_;
+  /*! \brief The device of the calls annotated by the user. */
+  std::unordered_map<const CallNode*, int> fixed_;
+  /*! \brief The calls placed on device_. */
+  std::unordered_set<const CallNode*> placed_;
+};
+
+namespace transform {
+
+Pass AutoDevicePlacement(int fallback_device, int device, PackedFunc cost_fn,
+                         double transfer_gbps, double transfer_latency_us) {
+  ICHECK_NE(fallback_device, device) << "The placement needs two different devices";
+  ICHECK(cost_fn != nullptr) << "The placement needs the cost of the calls";
+  ICHECK_GT(transfer_gbps, 0) << "The transfer bandwidth must be positive";
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    GlobalVar main = mod->GetGlobalVar("main");
+    Function func = Downcast<Function>(mod->Lookup(main));
+    Expr body = DevicePlacer(fallback_device, device, cost_fn, transfer_gbps,
+                             transfer_latency_us)
+                    .Place(func->body);
+    mod->Update(main, Function(func->params, body, func->ret_type, func->type_params,
+                               func->attrs, func->span));
+    return mod;
+  };
+  return CreateModulePass(pass_func, 0, "AutoDevicePlacement", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.AutoDevicePlacement").set_body_typed(AutoDevicePlacement);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
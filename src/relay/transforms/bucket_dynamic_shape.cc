@@ -0,0 +1,282 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file bucket_dynamic_shape.cc
+ * \brief Specialize the main function for buckets of a dynamic input dimension.
+ *
+ * The kernels of a function whose inputs have an `Any` dimension are compiled for any extent of
+ * the dimension, so their loops can't be specialized. Given the upper bounds of the buckets the
+ * extent falls in at run time, e.g. the sequence lengths 32, 64, 128 and 256, the main function
+ *
+ *   fn main(%x: Tensor[(1, ?), int64]) { body }
+ *
+ * is rewritten into a dispatch to one copy of the function per bucket, typed with the bucket
+ * upper bound as the extent, and the generic function for the extents beyond the last bucket:
+ *
+ *   fn main(%x: Tensor[(1, ?), int64]) {
+ *     let %n = take(shape_of(%x), 1);
+ *     if (%n <= 32) {
+ *       take(@main_bucket_32(pad_to(%x, 32)), arange(%n), axis=1)
+ *     } else if (%n <= 64) {
+ *       ...
+ *     } else {
+ *       body
+ *     }
+ *   }
+ *
+ * The inputs are padded to the bucket upper bound and the output dimensions of the bucket extent
+ * are sliced back to the actual extent. This is only valid for the models whose outputs at the
+ * valid positions do not depend on the padding, e.g. the ones taking an attention mask that is
+ * padded along with the tokens.
+ */
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../op/make_op.h"
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+
+namespace {
+
+/*! \brief An input whose dimension is bucketed */
+struct BucketedInput {
+  /*! \brief The index of the input in the parameters of main */
+  size_t index;
+  /*! \brief The bucketed dimension */
+  int axis;
+};
+
+/*!
+ * \brief Pad the bucketed dimension of a tensor to a bucket upper bound, no smaller than the
+ * extent of the dimension, and give the result the static extent of the bucket
+ */
+Expr PadToBucket(const Expr& data, const TensorTypeNode* type, int axis, int64_t bucket,
+                 double pad_value) {
+  int ndim = static_cast<int>(type->shape.size());
+  Array<Array<Integer>> pad_width;
+  Array<Integer> newshape;
+  for (int i = 0; i < ndim; ++i) {
+    pad_width.push_back({Integer(0), Integer(i == axis ? bucket : 0)});
+    newshape.push_back(Integer(i == axis ? bucket : 0));
+  }
+  Expr padded = MakePad(data, pad_width, MakeConstantScalar(type->dtype, pad_value), "constant");
+  Expr sliced = MakeStridedSlice(padded, {Integer(0)}, {Integer(bucket)}, {Integer(1)}, "end",
+                                 Array<Integer>{Integer(axis)});
+  // The strided slice of a dynamic dimension is dynamic, the reshape makes the extent static.
+  return MakeReshape(sliced, newshape);
+}
+
+/*!
+ * \brief Slice the dimensions of the output of a bucket function that take the bucket extent
+ * back to the actual extent
+ * \param out The output of the bucket function
+ * \param generic_type The type of the output of the generic function
+ * \param bucket_type The type of the output of the bucket function
+ * \param extent The actual extent, a scalar of int64
+ * \param bucket The bucket upper bound
+ * \param sliced Set to false if the output has a dimension the bucket turned static with an
+ * extent other than the bucket extent, which can't be sliced back
+ */
+Expr SliceFromBucket(const Expr& out, const Type& generic_type, const Type& bucket_type,
+                     const Expr& extent, int64_t bucket, bool* sliced) {
+  if (const auto* tuple_type = generic_type.as<TupleTypeNode>()) {
+    const auto* bucket_tuple_type = bucket_type.as<TupleTypeNode>();
+    ICHECK(bucket_tuple_type && bucket_tuple_type->fields.size() == tuple_type->fields.size());
+    Array<Expr> fields;
+    for (size_t i = 0; i < tuple_type->fields.size(); ++i) {
+      fields.push_back(SliceFromBucket(TupleGetItem(out, i), tuple_type->fields[i],
+                                       bucket_tuple_type->fields[i], extent, bucket, sliced));
+    }
+    return Tuple(fields);
+  }
+  const auto* tensor_type = generic_type.as<TensorTypeNode>();
+  const auto* bucket_tensor_type = bucket_type.as<TensorTypeNode>();
+  if (tensor_type == nullptr || bucket_tensor_type == nullptr) {
+    *sliced = false;
+    return out;
+  }
+  ICHECK_EQ(tensor_type->shape.size(), bucket_tensor_type->shape.size());
+  Expr result = out;
+  for (size_t i = 0; i < tensor_type->shape.size(); ++i) {
+    if (!tensor_type->shape[i]->IsInstance<AnyNode>()) {
+      continue;
+    }
+    const auto* dim = bucket_tensor_type->shape[i].as<IntImmNode>();
+    if (dim == nullptr) {
+      // Still dynamic, the bucket function computes the extent itself.
+      continue;
+    }
+    if (dim->value != bucket) {
+      *sliced = false;
+      return out;
+    }
+    Expr indices = MakeArange(MakeConstantScalar(DataType::Int(64), 0), extent,
+                              MakeConstantScalar(DataType::Int(64), 1), DataType::Int(64));
+    result = MakeTake(result, indices, Integer(0), Integer(static_cast<int>(i)), "clip");
+  }
+  return result;
+}
+
+}  // namespace
+
+IRModule BucketDynamicShape(IRModule mod, const Map<String, Integer>& inputs,
+                            const Array<Integer>& buckets, double pad_value) {
+  const auto* main_gv = mod->ContainGlobalVar("main") ? mod->GetGlobalVar("main").get() : nullptr;
+  if (main_gv == nullptr || inputs.empty() || buckets.empty()) {
+    return mod;
+  }
+  GlobalVar main_var = GetRef<GlobalVar>(main_gv);
+  mod = transform::InferType()(mod);
+  const auto* main_func = mod->Lookup(main_var).as<FunctionNode>();
+  if (main_func == nullptr) {
+    return mod;
+  }
+  Function func = GetRef<Function>(main_func);
+  Type generic_ret_type = Downcast<FuncType>(func->checked_type())->ret_type;
+
+  std::vector<BucketedInput> bucketed;
+  for (const auto& kv : inputs) {
+    auto it = std::find_if(func->params.begin(), func->params.end(),
+                           [&](const Var& param) { return param->name_hint() == kv.first; });
+    ICHECK(it != func->params.end()) << "BucketDynamicShape: main has no input " << kv.first;
+    const auto* type = (*it)->checked_type().as<TensorTypeNode>();
+    ICHECK(type) << "BucketDynamicShape: the input " << kv.first << " is not a tensor";
+    int ndim = static_cast<int>(type->shape.size());
+    int axis = kv.second->value < 0 ? kv.second->value + ndim : kv.second->value;
+    ICHECK(axis >= 0 && axis < ndim)
+        << "BucketDynamicShape: axis " << kv.second->value << " is out of range for the input "
+        << kv.first << " of rank " << ndim;
+    if (!type->shape[axis]->IsInstance<AnyNode>()) {
+      LOG(WARNING) << "BucketDynamicShape: dimension " << axis << " of the input " << kv.first
+                   << " is static, skip bucketing it";
+      continue;
+    }
+    bucketed.push_back({static_cast<size_t>(it - func->params.begin()), axis});
+  }
+  if (bucketed.empty()) {
+    return mod;
+  }
+  std::vector<int64_t> bounds;
+  for (const Integer& bucket : buckets) {
+    ICHECK_GT(bucket->value, 0) << "BucketDynamicShape: the buckets must be positive";
+    bounds.push_back(bucket->value);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  // Add one copy of main per bucket, with the bucketed dimensions of the inputs typed as the
+  // bucket upper bound. Type inference then specializes every operator of the copy.
+  IRModule bucketed_mod = mod;
+  bucketed_mod.CopyOnWrite();
+  std::vector<GlobalVar> bucket_vars;
+  for (int64_t bound : bounds) {
+    Array<Var> params;
+    Map<Var, Expr> binds;
+    for (const Var& param : func->params) {
+      params.push_back(Var(param->name_hint(), param->checked_type()));
+    }
+    for (const BucketedInput& input : bucketed) {
+      const auto* type = func->params[input.index]->checked_type().as<TensorTypeNode>();
+      Array<PrimExpr> shape = type->shape;
+      shape.Set(input.axis, Integer(bound));
+      params.Set(input.index,
+                 Var(func->params[input.index]->name_hint(), TensorType(shape, type->dtype)));
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+      binds.Set(func->params[i], params[i]);
+    }
+    Function bucket_func =
+        Downcast<Function>(DeDup(Function(params, Bind(func->body, binds), Type(), {})));
+    std::string name = "main_bucket_" + std::to_string(bound);
+    for (int i = 0; bucketed_mod->ContainGlobalVar(name); ++i) {
+      name = "main_bucket_" + std::to_string(bound) + "_" + std::to_string(i);
+    }
+    GlobalVar bucket_var(name);
+    bucketed_mod->Add(bucket_var, bucket_func);
+    bucket_vars.push_back(bucket_var);
+  }
+  bucketed_mod = transform::InferType()(bucketed_mod);
+
+  // The extent to dispatch on, the largest of the extents of the bucketed dimensions.
+  Expr extent;
+  for (const BucketedInput& input : bucketed) {
+    Expr dim = MakeTake(MakeShapeOf(func->params[input.index], DataType::Int(64)),
+                        MakeConstantScalar(DataType::Int(32), input.axis), Integer(0), Integer(0),
+                        "clip");
+    extent = extent.defined() ? Maximum(extent, dim) : dim;
+  }
+  Var extent_var("bucket_extent", TensorType({}, DataType::Int(64)));
+
+  static const Op& less_equal = Op::Get("less_equal");
+  Expr body = func->body;
+  for (size_t b = bounds.size(); b-- > 0;) {
+    Array<Expr> args;
+    for (const Var& param : func->params) {
+      args.push_back(param);
+    }
+    for (const BucketedInput& input : bucketed) {
+      const Var& param = func->params[input.index];
+      args.Set(input.index, PadToBucket(param, param->checked_type().as<TensorTypeNode>(),
+                                        input.axis, bounds[b], pad_value));
+    }
+    Type bucket_ret_type =
+        Downcast<FuncType>(bucketed_mod->Lookup(bucket_vars[b])->checked_type())->ret_type;
+    bool sliced = true;
+    Expr out = SliceFromBucket(Call(bucket_vars[b], args), generic_ret_type, bucket_ret_type,
+                               extent_var, bounds[b], &sliced);
+    if (!sliced) {
+      LOG(WARNING) << "BucketDynamicShape: the output " << bucket_ret_type << " of bucket "
+                   << bounds[b] << " can't be sliced back to the type " << generic_ret_type
+                   << " of main, skip bucketing";
+      return mod;
+    }
+    Expr cond = Call(less_equal, {extent_var, MakeConstantScalar(DataType::Int(64), bounds[b])});
+    body = If(cond, out, body);
+  }
+  body = Let(extent_var, extent, body);
+  bucketed_mod->Add(main_var,
+                    Function(func->params, body, func->ret_type, func->type_params, func->attrs),
+                    true);
+  return bucketed_mod;
+}
+
+namespace transform {
+
+Pass BucketDynamicShape(Map<String, Integer> inputs, Array<Integer> buckets, double pad_value) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule m,
+                                                                            PassContext pc) {
+    return relay::BucketDynamicShape(m, inputs, buckets, pad_value);
+  };
+  return CreateModulePass(pass_func, 0, "BucketDynamicShape", {});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.BucketDynamicShape").set_body_typed(BucketDynamicShape);
+
+}  // namespace transform
+}  // namespace relay
+}  // namespace tvm
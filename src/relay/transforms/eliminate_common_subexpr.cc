@@ -25,13 +25,32 @@
  * This is an optimization pass that eliminates common subexpressions. During the pass, it tries
  * to replace an expression with a previously appeared expression with the same input and
  * attributes. The fskip callback argument allows us to skip specific expressions.
+ *
+ * The calls are numbered by a hash of their operator, attributes and arguments, so that an
+ * expression is only compared with the ones of the same hash. Beyond the syntactically identical
+ * calls, the following are equivalent:
+ *
+ *  - the calls to a commutative operator with the arguments swapped, e.g. add(%x, %y) and
+ *    add(%y, %x);
+ *  - the reshapes, squeezes and expand_dims of the same input to the same result type, whatever
+ *    the form of their attributes, e.g. reshape(%x, newshape=[-1, 4]) and
+ *    reshape(%x, newshape=[2, 4]);
+ *  - the transposes of the same input by the same permutation, e.g. transpose(%x) and
+ *    transpose(%x, axes=[-1, -2]) of a 2-d %x;
+ *  - the calls to structurally equal primitive functions, e.g. after FuseOps.
+ *
+ * The bodies of the primitive functions are visited as well, so the pass can run after FuseOps.
  */
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/transform.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 
 #include <unordered_map>
+#include <vector>
 
+#include "../../support/utils.h"
 #include "pattern_utils.h"
 
 namespace tvm {
@@ -47,36 +66,29 @@ class CommonSubexprEliminator : public MixedModeMutator {
     const CallNode* new_call = new_expr.as<CallNode>();
     ICHECK(new_call);
     const OpNode* op = new_call->op.as<OpNode>();
-    StructuralEqual attrs_equal;
+    const FunctionNode* func = new_call->op.as<FunctionNode>();
 
-    if (new_call->args.size() == 0 || op == nullptr || op_stateful.get(GetRef<Op>(op), false)) {
+    if (new_call->args.size() == 0 || (op != nullptr && op_stateful.get(GetRef<Op>(op), false))) {
+      return new_expr;
+    }
+    // The calls to the other functions, e.g. to global functions or closures, are kept
+    if (op == nullptr &&
+        (func == nullptr || !func->HasNonzeroAttr(attr::kPrimitive) || HasStatefulOp(func))) {
       return new_expr;
     }
     if (fskip_ != nullptr && fskip_(new_expr)) {
       return new_expr;
     }
 
-    auto it = expr_map_.find(new_call->op);
-    if (it != expr_map_.end()) {
-      for (const Expr& candidate_expr : it->second) {
-        if (const CallNode* candidate = candidate_expr.as<CallNode>()) {
-          bool is_equivalent = true;
-          if (!attrs_equal(new_call->attrs, candidate->attrs)) {
-            continue;
-          }
-          for (size_t i = 0; i < new_call->args.size(); i++) {
-            if (!new_call->args[i].same_as(candidate->args[i]) &&
-                !IsEqualScalar(new_call->args[i], candidate->args[i])) {
-              is_equivalent = false;
-              break;
-            }
-          }
-          if (!is_equivalent) continue;
-          return GetRef<Call>(candidate);
-        }
+    Candidate current{new_expr, call->checked_type_};
+    size_t hash = HashCall(current);
+    auto range = call_map_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (IsEquivalent(current, it->second)) {
+        return it->second.expr;
       }
     }
-    expr_map_[new_call->op].push_back(new_expr);
+    call_map_.emplace(hash, current);
     return new_expr;
   }
 
@@ -103,7 +115,205 @@ class CommonSubexprEliminator : public MixedModeMutator {
     return new_expr;
   }
 
+ private:
+  /*! \brief A call and the type of its result, undefined if the call was not typed */
+  struct Candidate {
+    Expr expr;
+    Type type;
+  };
+
+  /*! \brief The equivalence class of an operator */
+  enum class OpKind { kDefault, kCommutative, kReshape, kTranspose };
+
+  static OpKind GetOpKind(const Expr& op) {
+    static const std::unordered_map<Op, OpKind, ObjectPtrHash, ObjectPtrEqual> kinds = {
+        {Op::Get("add"), OpKind::kCommutative},
+        {Op::Get("multiply"), OpKind::kCommutative},
+        {Op::Get("maximum"), OpKind::kCommutative},
+        {Op::Get("minimum"), OpKind::kCommutative},
+        {Op::Get("equal"), OpKind::kCommutative},
+        {Op::Get("not_equal"), OpKind::kCommutative},
+        {Op::Get("logical_and"), OpKind::kCommutative},
+        {Op::Get("logical_or"), OpKind::kCommutative},
+        {Op::Get("bitwise_and"), OpKind::kCommutative},
+        {Op::Get("bitwise_or"), OpKind::kCommutative},
+        {Op::Get("bitwise_xor"), OpKind::kCommutative},
+        {Op::Get("reshape"), OpKind::kReshape},
+        {Op::Get("squeeze"), OpKind::kReshape},
+        {Op::Get("expand_dims"), OpKind::kReshape},
+        {Op::Get("contrib_reverse_reshape"), OpKind::kReshape},
+        {Op::Get("transpose"), OpKind::kTranspose},
+    };
+    if (const auto* op_node = op.as<OpNode>()) {
+      auto it = kinds.find(GetRef<Op>(op_node));
+      if (it != kinds.end()) {
+        return it->second;
+      }
+    }
+    return OpKind::kDefault;
+  }
+
+  /*!
+   * \brief The kind of a call, kDefault when the types its equivalence relies on are unknown
+   * or not static
+   */
+  static OpKind GetCallKind(const Candidate& candidate) {
+    const auto* call = candidate.expr.as<CallNode>();
+    OpKind kind = GetOpKind(call->op);
+    if (kind == OpKind::kCommutative && call->args.size() != 2) {
+      return OpKind::kDefault;
+    }
+    if (kind == OpKind::kReshape || kind == OpKind::kTranspose) {
+      const auto* tensor_type = candidate.type.as<TensorTypeNode>();
+      if (tensor_type == nullptr || !IsStaticShape(tensor_type)) {
+        return OpKind::kDefault;
+      }
+    }
+    return kind;
+  }
+
+  static bool IsStaticShape(const TensorTypeNode* type) {
+    for (const PrimExpr& dim : type->shape) {
+      if (!dim.as<IntImmNode>()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The permutation of a transpose, with the default and negative axes resolved */
+  static std::vector<int64_t> TransposeAxes(const Candidate& candidate) {
+    const auto* call = candidate.expr.as<CallNode>();
+    const auto* attrs = call->attrs.as<TransposeAttrs>();
+    int64_t ndim = candidate.type.as<TensorTypeNode>()->shape.size();
+    std::vector<int64_t> axes;
+    if (!attrs->axes.defined() || attrs->axes.empty()) {
+      for (int64_t i = ndim - 1; i >= 0; --i) {
+        axes.push_back(i);
+      }
+      return axes;
+    }
+    for (const Integer& axis : attrs->axes) {
+      axes.push_back(axis->value < 0 ? axis->value + ndim : axis->value);
+    }
+    return axes;
+  }
+
+  /*! \brief Hash an argument, by value for the scalar constants compared by value */
+  static size_t HashArg(const Expr& arg) {
+    const auto* constant = arg.as<ConstantNode>();
+    if (constant && constant->is_scalar()) {
+      return StructuralHash()(arg);
+    }
+    return ObjectPtrHash()(arg);
+  }
+
+  static bool IsSameArg(const Expr& a, const Expr& b) {
+    return a.same_as(b) || IsEqualScalar(a, b);
+  }
+
+  size_t HashCall(const Candidate& candidate) {
+    const auto* call = candidate.expr.as<CallNode>();
+    size_t hash = HashCallee(call->op);
+    switch (GetCallKind(candidate)) {
+      case OpKind::kCommutative:
+        // the hash of the arguments does not depend on their order
+        return support::HashCombine(hash, HashArg(call->args[0]) + HashArg(call->args[1]));
+      case OpKind::kReshape:
+        // all the reshapes of an input to a shape are the same
+        hash = support::HashCombine(static_cast<uint64_t>(OpKind::kReshape),
+                                    HashArg(call->args[0]));
+        return support::HashCombine(hash, StructuralHash()(candidate.type));
+      case OpKind::kTranspose:
+        hash = support::HashCombine(hash, HashArg(call->args[0]));
+        for (int64_t axis : TransposeAxes(candidate)) {
+          hash = support::HashCombine(hash, axis);
+        }
+        return hash;
+      default:
+        hash = support::HashCombine(hash, StructuralHash()(call->attrs));
+        for (const Expr& arg : call->args) {
+          hash = support::HashCombine(hash, HashArg(arg));
+        }
+        return hash;
+    }
+  }
+
+  bool IsEquivalent(const Candidate& a, const Candidate& b) {
+    const auto* call_a = a.expr.as<CallNode>();
+    const auto* call_b = b.expr.as<CallNode>();
+    OpKind kind = GetCallKind(a);
+    if (kind != GetCallKind(b)) {
+      return false;
+    }
+    if (kind == OpKind::kReshape) {
+      return IsSameArg(call_a->args[0], call_b->args[0]) && StructuralEqual()(a.type, b.type);
+    }
+    if (!IsSameCallee(call_a->op, call_b->op) || call_a->args.size() != call_b->args.size()) {
+      return false;
+    }
+    if (kind == OpKind::kTranspose) {
+      return IsSameArg(call_a->args[0], call_b->args[0]) && TransposeAxes(a) == TransposeAxes(b);
+    }
+    if (!StructuralEqual()(call_a->attrs, call_b->attrs)) {
+      return false;
+    }
+    if (kind == OpKind::kCommutative && IsSameArg(call_a->args[0], call_b->args[1]) &&
+        IsSameArg(call_a->args[1], call_b->args[0])) {
+      return true;
+    }
+    for (size_t i = 0; i < call_a->args.size(); i++) {
+      if (!IsSameArg(call_a->args[i], call_b->args[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief Hash a callee, by structure for the primitive functions */
+  size_t HashCallee(const Expr& callee) {
+    if (!callee.as<FunctionNode>()) {
+      return ObjectPtrHash()(callee);
+    }
+    auto it = func_hash_.find(callee);
+    if (it == func_hash_.end()) {
+      it = func_hash_.emplace(callee, StructuralHash()(callee)).first;
+    }
+    return it->second;
+  }
+
+  static bool IsSameCallee(const Expr& a, const Expr& b) {
+    return a.same_as(b) || (a.as<FunctionNode>() && b.as<FunctionNode>() &&
+                            StructuralEqual()(a, b));
+  }
+
+  /*! \brief Whether a primitive function calls a stateful operator */
+  bool HasStatefulOp(const FunctionNode* func) {
+    static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+    auto it = func_stateful_.find(GetRef<Function>(func));
+    if (it != func_stateful_.end()) {
+      return it->second;
+    }
+    bool stateful = false;
+    PostOrderVisit(func->body, [&](const Expr& expr) {
+      if (const auto* call = expr.as<CallNode>()) {
+        if (const auto* op = call->op.as<OpNode>()) {
+          stateful = stateful || op_stateful.get(GetRef<Op>(op), false);
+        }
+      }
+    });
+    func_stateful_.emplace(GetRef<Function>(func), stateful);
+    return stateful;
+  }
+
+  /*! \brief The calls seen, by hash */
+  std::unordered_multimap<size_t, Candidate> call_map_;
+  /*! \brief The tuple items seen, by tuple */
   std::unordered_map<Expr, std::vector<Expr>, ObjectPtrHash, ObjectPtrEqual> expr_map_;
+  /*! \brief The structural hash of the primitive functions called */
+  std::unordered_map<Expr, size_t, ObjectPtrHash, ObjectPtrEqual> func_hash_;
+  /*! \brief Whether the primitive functions called have a stateful operator */
+  std::unordered_map<Expr, bool, ObjectPtrHash, ObjectPtrEqual> func_stateful_;
   runtime::TypedPackedFunc<bool(Expr)> fskip_;
 };
 
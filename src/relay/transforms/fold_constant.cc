@@ -29,6 +29,13 @@
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "pattern_utils.h"
 
@@ -37,6 +44,8 @@ namespace relay {
 
 using FInterpreter = runtime::TypedPackedFunc<ObjectRef(Expr)>;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant.parallel", Bool);
+
 class ConstantChecker : private ExprVisitor {
  public:
   // Check whether an expression is constant. The results are memoized.
@@ -72,8 +81,71 @@ bool ConstantCheck(const Expr& e) { return ConstantChecker().Check(e); }
 
 TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(ConstantCheck);
 
+using ExprSet = std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual>;
+using ExprMap = std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual>;
+
+/*!
+ * \brief Collect the outermost deferred expressions, the ones which are used by
+ *  an expression that is not itself deferred.
+ */
+class DeferredRootCollector : private ExprVisitor {
+ public:
+  DeferredRootCollector(const ExprSet& deferred, const ExprMap& folded)
+      : deferred_(deferred), folded_(folded) {}
+
+  std::vector<Expr> Collect(const Expr& expr) {
+    VisitExpr(expr);
+    return std::move(roots_);
+  }
+
+ private:
+  void VisitExpr(const Expr& expr) final {
+    if (deferred_.count(expr)) {
+      if (!folded_.count(expr) && seen_.insert(expr).second) roots_.push_back(expr);
+      return;
+    }
+    ExprVisitor::VisitExpr(expr);
+  }
+
+  const ExprSet& deferred_;
+  const ExprMap& folded_;
+  ExprSet seen_;
+  std::vector<Expr> roots_;
+};
+
+/*! \brief Replace the deferred expressions by their folded values. */
+class FoldedValueSubstituter : private ExprMutator {
+ public:
+  explicit FoldedValueSubstituter(const ExprMap& folded) : folded_(folded) {}
+
+  Expr Substitute(const Expr& expr) { return VisitExpr(expr); }
+
+ private:
+  Expr VisitExpr(const Expr& expr) final {
+    auto it = folded_.find(expr);
+    if (it != folded_.end()) return it->second;
+    return ExprMutator::VisitExpr(expr);
+  }
+
+  const ExprMap& folded_;
+};
+
 // TODO(tvm-team) consider combine dead-code with constant folder.
 // or make a more powerful partial evaluator.
+/*!
+ * \brief Fold the expressions whose inputs are all constant.
+ *
+ *  Creating an interpreter and running the lowering pipeline for each foldable
+ *  call dominates the time of folding constant heavy models, so the calls are
+ *  not evaluated when they are visited. They are marked as deferred and their
+ *  users treat them as constants. Once the whole expression is visited, the
+ *  outermost deferred expressions are evaluated in a few batches, each batch
+ *  being a single tuple for the interpreter. With "relay.FoldConstant.parallel"
+ *  the batches are evaluated in parallel, or the independent primitive calls
+ *  of a single batch are by the interpreter. The lowered primitives are shared
+ *  through the global compile engine cache, so structurally identical ops are
+ *  only compiled once.
+ */
 class ConstantFolder : public MixedModeMutator {
  public:
   explicit ConstantFolder(IRModule module)
@@ -82,7 +154,22 @@ class ConstantFolder : public MixedModeMutator {
         shape_of_op_(Op::Get("shape_of")),
         vm_shape_of_op_(Op::Get("vm.shape_of")),
         cast_op_(Op::Get("cast")),
-        ndarray_size_op_(Op::Get("ndarray_size")) {}
+        ndarray_size_op_(Op::Get("ndarray_size")) {
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    Integer num_threads =
+        pass_ctx->GetConfig<Integer>("relay.FunctionPass.num_threads", Integer(1)).value();
+    // The functions folded concurrently already use the threads, and parallel_for does not nest.
+    parallel_ = pass_ctx->GetConfig<Bool>("relay.FoldConstant.parallel", Bool(false)).value() &&
+                num_threads->value <= 1;
+  }
+
+  /*! \brief Fold the constants of expr, evaluating the deferred expressions. */
+  Expr Fold(const Expr& expr) {
+    Expr ret = Mutate(expr);
+    if (deferred_.empty()) return ret;
+    EvaluateDeferred(DeferredRootCollector(deferred_, folded_).Collect(ret));
+    return FoldedValueSubstituter(folded_).Substitute(ret);
+  }
 
   using MixedModeMutator::VisitExpr_;
 
@@ -90,7 +177,7 @@ class ConstantFolder : public MixedModeMutator {
     auto pre_visit = [this](const LetNode* op) {
       // Rely on the Memoizer to cache pre-visit values
       Expr value = this->Mutate(op->value);
-      if (value.as<ConstantNode>()) {
+      if (IsConstant(value)) {
         this->memo_[op->var] = value;
       } else {
         this->Mutate(op->var);
@@ -100,7 +187,7 @@ class ConstantFolder : public MixedModeMutator {
       Expr expr = GetRef<Expr>(op);
       // Rely on the Memoizer to cache pre-visit values
       Expr value = this->Mutate(op->value);
-      if (value.as<ConstantNode>()) {
+      if (IsConstant(value)) {
         this->memo_[expr] = this->Mutate(op->body);
       } else {
         Var var = Downcast<Var>(this->Mutate(op->var));
@@ -130,7 +217,7 @@ class ConstantFolder : public MixedModeMutator {
   }
 
   Expr VisitExpr_(const IfNode* op) final {
-    auto new_cond = ExprMutator::VisitExpr(op->cond);
+    auto new_cond = Materialize(ExprMutator::VisitExpr(op->cond));
     if (auto const_cond = new_cond.as<ConstantNode>()) {
       if (reinterpret_cast<uint8_t*>(const_cond->data->data)[0]) {
         return ExprMutator::VisitExpr(op->true_branch);
@@ -177,15 +264,30 @@ class ConstantFolder : public MixedModeMutator {
 
     bool all_const_args = true;
     for (Expr arg : call->args) {
-      if (!checker_.Check(arg)) {
+      if (!IsConstant(arg)) {
         all_const_args = false;
       }
     }
     if (all_const_args) {
-      return ConstEvaluate(post);
-    } else {
-      return post;
+      deferred_.insert(post);
+    }
+    return post;
+  }
+
+  Expr Rewrite_(const TupleNode* op, const Expr& post) final {
+    op = post.as<TupleNode>();
+    // Tuples of constants are already constants, only tuples using deferred
+    // expressions need to be deferred themselves.
+    bool any_deferred = false;
+    for (const Expr& field : op->fields) {
+      if (deferred_.count(field)) {
+        any_deferred = true;
+      } else if (!checker_.Check(field)) {
+        return post;
+      }
     }
+    if (any_deferred) deferred_.insert(post);
+    return post;
   }
 
   Expr Rewrite_(const TupleGetItemNode* op, const Expr& post) final {
@@ -193,6 +295,7 @@ class ConstantFolder : public MixedModeMutator {
     if (const auto* tuple = op->tuple.as<TupleNode>()) {
       return tuple->fields[op->index];
     } else {
+      if (deferred_.count(op->tuple)) deferred_.insert(post);
       return post;
     }
   }
@@ -202,6 +305,12 @@ class ConstantFolder : public MixedModeMutator {
   ConstantChecker checker_;
   // Module
   IRModule module_;
+  // Whether the deferred expressions are evaluated in parallel.
+  bool parallel_{false};
+  // The expressions with constant inputs whose evaluation is deferred.
+  ExprSet deferred_;
+  // The values of the deferred expressions which were evaluated.
+  ExprMap folded_;
 
   // Cache the following ops for equivalence checking in this pass.
   const Op& device_copy_op_;
@@ -227,8 +336,60 @@ class ConstantFolder : public MixedModeMutator {
       return Expr();
     }
   }
-  // Constant evaluate an expression.
-  Expr ConstEvaluate(Expr expr) {
+  // Whether expr is a constant or will be folded into one.
+  bool IsConstant(const Expr& expr) { return deferred_.count(expr) || checker_.Check(expr); }
+
+  // Evaluate a deferred expression now, for the users which need its value.
+  Expr Materialize(const Expr& expr) {
+    if (!deferred_.count(expr)) return expr;
+    auto it = folded_.find(expr);
+    if (it != folded_.end()) return it->second;
+    return folded_[expr] = ConstEvaluate(expr, parallel_);
+  }
+
+  // Evaluate the deferred roots, as one tuple per batch.
+  void EvaluateDeferred(const std::vector<Expr>& roots) {
+    if (roots.empty()) return;
+    size_t num_batches = 1;
+    if (parallel_) {
+      size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+      num_batches = std::min(roots.size(), num_threads);
+    }
+    std::vector<Array<Expr>> batches(num_batches);
+    for (size_t i = 0; i < roots.size(); ++i) {
+      batches[i * num_batches / roots.size()].push_back(roots[i]);
+    }
+    std::vector<Expr> values(num_batches);
+    // A single batch evaluates its independent primitives in parallel instead.
+    bool parallel_primitives = parallel_ && num_batches == 1;
+    auto evaluate = [&](int i) {
+      const Array<Expr>& batch = batches[i];
+      Expr expr = batch.size() == 1 ? batch[0] : Tuple(batch);
+      values[i] = ConstEvaluate(expr, parallel_primitives);
+    };
+    if (num_batches == 1) {
+      evaluate(0);
+    } else {
+      support::parallel_for(0, static_cast<int>(num_batches), evaluate);
+    }
+    for (size_t i = 0; i < num_batches; ++i) {
+      if (batches[i].size() == 1) {
+        folded_[batches[i][0]] = values[i];
+        continue;
+      }
+      const auto* tuple = values[i].as<TupleNode>();
+      ICHECK(tuple != nullptr && tuple->fields.size() == batches[i].size());
+      for (size_t j = 0; j < batches[i].size(); ++j) {
+        folded_[batches[i][j]] = tuple->fields[j];
+      }
+    }
+  }
+
+  // Constant evaluate an expression, with the interpreter evaluating the
+  // independent primitive calls in parallel if `parallel`.
+  // This is called from several threads by EvaluateDeferred, so it must not
+  // touch the state of the folder.
+  Expr ConstEvaluate(Expr expr, bool parallel = false) {
     std::vector<transform::Pass> passes = {transform::FuseOps(0), transform::ToANormalForm(),
                                            transform::InferType()};
     Function func;
@@ -254,7 +415,11 @@ class ConstantFolder : public MixedModeMutator {
     // use a fresh build context
     // in case we are already in a build context.
     // needed for both execution and creation(due to JIT)
-    With<PassContext> fresh_build_ctx(PassContext::Create());
+    PassContext fresh_ctx = PassContext::Create();
+    if (parallel) {
+      fresh_ctx->config.Set("relay.Interpreter.parallel", Bool(true));
+    }
+    With<PassContext> fresh_build_ctx(fresh_ctx);
 
     FInterpreter executor = CreateInterpreter(mod, dev, target);
     return ObjectToExpr(executor(expr));
@@ -370,7 +535,7 @@ class ConstantFolder : public MixedModeMutator {
 };
 
 Expr FoldConstant(const Expr& expr, const IRModule& mod) {
-  return ConstantFolder(mod).Mutate(expr);
+  return ConstantFolder(mod).Fold(expr);
 }
 
 TVM_REGISTER_GLOBAL("relay._transform.FoldConstantExpr").set_body_typed(FoldConstant);
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/fuse_attention.cc
+ * \brief Rewrite the attention composed of batch_matmul, softmax and batch_matmul into the
+ *  fused nn.attention operator.
+ */
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/dataflow_matcher.h>
+#include <tvm/relay/transform.h>
+
+#include <limits>
+
+#include "../op/make_op.h"
+#include "pattern_utils.h"
+#include "simplify_expr.h"
+
+namespace tvm {
+namespace relay {
+
+/*!
+ * \brief Matches batch_matmul(softmax(scale * batch_matmul(q, k)), transpose(v)), where the
+ *  scale is an optional multiplication or division of the scores by a scalar constant, and
+ *  rewrites it into nn.attention(q, k, v).
+ */
+class AttentionRewrite : public DFPatternRewrite {
+ public:
+  AttentionRewrite() {
+    query_ = IsWildcard();
+    key_ = IsWildcard();
+    value_t_ = IsWildcard();
+    scale_ = IsConstant();
+    auto scores = IsOp("nn.batch_matmul")({query_, key_});
+    auto scaled = IsOp("multiply")({scores, scale_}) || IsOp("multiply")({scale_, scores}) ||
+                  IsOp("divide")({scores, scale_}) || scores;
+    auto probs = IsOp("nn.softmax")({scaled});
+    pattern_ = IsOp("nn.batch_matmul")({probs, value_t_});
+  }
+
+  Expr Callback(const Expr& pre, const Expr& post,
+                const Map<DFPattern, Array<Expr>>& node_map) const override {
+    Expr query = node_map[query_][0];
+    Expr key = node_map[key_][0];
+    Expr value_t = node_map[value_t_][0];
+
+    const auto* out_type = pre->checked_type().as<TensorTypeNode>();
+    const auto* query_type = query->checked_type().as<TensorTypeNode>();
+    if (out_type == nullptr || query_type == nullptr || out_type->dtype != query_type->dtype) {
+      return post;
+    }
+    // The softmax is over the keys
+    const auto* probs = Downcast<Call>(post)->args[0].as<CallNode>();
+    const auto* softmax_attrs = probs->attrs.as<SoftmaxAttrs>();
+    if (softmax_attrs->axis != -1 && softmax_attrs->axis != 2) {
+      return post;
+    }
+    double scale = 1.0;
+    if (node_map.count(scale_)) {
+      Expr scale_expr = node_map[scale_][0];
+      if (!IsConstScalar(scale_expr) && !IsAllOnesShape(scale_expr)) {
+        return post;
+      }
+      double value = static_cast<double>(ToScalar(Downcast<Constant>(scale_expr)->data));
+      static const Op& divide = Op::Get("divide");
+      scale = probs->args[0].as<CallNode>()->op == divide ? 1.0 / value : value;
+    }
+    // batch_matmul(probs, value_t) multiplies probs by the transpose of value_t
+    Expr value;
+    const auto* value_t_call = value_t.as<CallNode>();
+    static const Op& transpose = Op::Get("transpose");
+    if (value_t_call && value_t_call->op == transpose && IsBatchTranspose(value_t_call)) {
+      value = value_t_call->args[0];
+    } else {
+      value = MakeTranspose(value_t, {0, 2, 1});
+    }
+
+    auto attrs = make_object<AttentionAttrs>();
+    attrs->scale = scale;
+    attrs->causal = false;
+    static const Op& attention = Op::Get("nn.attention");
+    Expr valid_length = MakeConstantScalar(DataType::Int(32), std::numeric_limits<int32_t>::max());
+    return Call(attention, {query, key, value, valid_length}, Attrs(attrs), {});
+  }
+
+ private:
+  /*! \brief Whether the constant has a single element */
+  static bool IsAllOnesShape(const Expr& expr) {
+    const auto* constant = expr.as<ConstantNode>();
+    if (constant == nullptr) return false;
+    for (int64_t i = 0; i < constant->data->ndim; ++i) {
+      if (constant->data->shape[i] != 1) return false;
+    }
+    return true;
+  }
+
+  /*! \brief Whether the transpose swaps the last two axes of a 3-D tensor */
+  static bool IsBatchTranspose(const CallNode* call) {
+    const auto* attrs = call->attrs.as<TransposeAttrs>();
+    if (!attrs->axes.defined() || attrs->axes.size() != 3) return false;
+    return attrs->axes[0]->value == 0 && attrs->axes[1]->value == 2 && attrs->axes[2]->value == 1;
+  }
+
+  DFPattern query_;
+  DFPattern key_;
+  DFPattern value_t_;
+  DFPattern scale_;
+};
+
+Expr FuseAttention(const Expr& expr, const IRModule& mod) {
+  DFPatternRewriteComposer composer;
+  composer.AddRewrite<AttentionRewrite>();
+  return RewritePatterns(composer.MakeCallbacks(), expr, mod);
+}
+
+namespace transform {
+
+Pass FuseAttention() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(FuseAttention(f, m));
+      };
+  return CreateFunctionPass(pass_func, 0, "FuseAttention", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.FuseAttention").set_body_typed(FuseAttention);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
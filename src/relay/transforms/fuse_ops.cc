@@ -75,6 +75,12 @@ namespace relay {
       will still run correctly.
   - CommitFuse: mark all the nodes between source and post-dominator as the same group.
   - We use an Union-Find data structure to manage the groups.
+
+  When "relay.FuseOps.cost_model" names a cost function, each fusion allowed by the
+  rules above is only committed if the estimated cost of the merged group does not
+  exceed the sum of the estimated costs of the groups it merges. The cost function
+  takes the nodes of a candidate group in topological order and returns a float,
+  "relay.FuseOps.AnalyticalCost" is a simple model of memory traffic and kernel time.
 */
 using support::LinkedList;
 using support::LinkNode;
@@ -84,6 +90,7 @@ constexpr uint32_t kMaxFusedOps = 256;
 static const Op& stop_fusion_op = Op::Get("annotation.stop_fusion");
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FuseOps.cost_model", String);
 
 /*!
  * \brief Indexed data flow graph in forward direction.
@@ -507,8 +514,9 @@ DominatorTree DominatorTree::PostDom(support::Arena* arena, const IndexedForward
  */
 class GraphPartitioner {
  public:
-  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth)
-      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth) {}
+  explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
+                            PackedFunc fcost = nullptr)
+      : arena_(arena), opt_level_(opt_level), max_fuse_depth_(max_fuse_depth), fcost_(fcost) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -562,6 +570,10 @@ class GraphPartitioner {
   int opt_level_;
   /*! \brief The maximum number of operations in one fused function */
   size_t max_fuse_depth_;
+  /*! \brief The cost function of a group, fusions are not checked against a cost if null. */
+  PackedFunc fcost_;
+  /*! \brief The graph being partitioned. */
+  const IndexedForwardGraph* graph_{nullptr};
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -682,6 +694,63 @@ class GraphPartitioner {
     return target->FindRoot()->num_nodes + CountNodesUptoSink_(child, dom_parent);
   }
 
+  // Collect the nodes between src and sink, excluding sink.
+  void CollectPath_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink,
+                    std::vector<IndexedForwardGraph::Node*>* nodes) {
+    if (src == sink || visited_.count(src)) return;
+    visited_.insert(src);
+    nodes->push_back(src);
+    for (auto link = src->outputs.head; link != nullptr; link = link->next) {
+      CollectPath_(link->value.node, sink, nodes);
+    }
+  }
+
+  // The estimated cost of a group made of the nodes with the given indices.
+  double GroupCost(std::vector<size_t> nids) {
+    std::sort(nids.begin(), nids.end());
+    Array<Expr> nodes;
+    for (size_t nid : nids) {
+      nodes.push_back(GetRef<Expr>(static_cast<const ExprNode*>(graph_->post_dfs_order[nid]->ref)));
+    }
+    return fcost_(nodes);
+  }
+
+  /*!
+   * \brief Check that fusing src into sink does not increase the estimated cost.
+   * \param src The source node.
+   * \param sink The termination node.
+   * \note sink must be a post-dominator of src.
+   */
+  bool CheckCost(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+    if (fcost_ == nullptr) return true;
+    std::vector<IndexedForwardGraph::Node*> path;
+    visited_.clear();
+    CollectPath_(src, sink, &path);
+    std::unordered_set<Group*> merged{groups_[sink->index]->FindRoot()};
+    for (auto* node : path) merged.insert(groups_[node->index]->FindRoot());
+    if (merged.size() == 1) return true;
+    std::unordered_map<Group*, std::vector<size_t>> members;
+    std::vector<size_t> all_members;
+    for (size_t nid = 0; nid < groups_.size(); ++nid) {
+      Group* root = groups_[nid]->FindRoot();
+      if (merged.count(root)) {
+        members[root].push_back(nid);
+        all_members.push_back(nid);
+      }
+    }
+    double separate = 0;
+    for (const auto& kv : members) separate += GroupCost(kv.second);
+    return GroupCost(all_members) <= separate;
+  }
+
+  // Check the path and the cost, then fuse src into sink.
+  template <typename F>
+  void TryFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink, F fcond) {
+    if (CheckPath(src, sink, fcond) && CheckCost(src, sink)) {
+      CommitFuse(src, sink);
+    }
+  }
+
   // Initialize the groups.
   void InitGroups(const IndexedForwardGraph& graph) {
     groups_.resize(graph.post_dfs_order.size());
@@ -729,9 +798,7 @@ class GraphPartitioner {
           auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
           // dom_root_group can also be tuple, as in inception layers
           // CheckPath is needed to avoid fusing two intermediate tuples
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph_node, dom_node->parent->gnode, fcond);
         }
         continue;
       }
@@ -752,9 +819,7 @@ class GraphPartitioner {
           ICHECK(dom_node->parent->gnode != nullptr);
           // The fuse can be executed if all the intermediate ops are still broadcast.
           auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kBroadcast; };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph_node, dom_node->parent->gnode, fcond);
         }
       } else if (group_node->pattern <= kBroadcast) {
         // Pre-condition: can only be fused to parent which is injective or reduction.
@@ -772,9 +837,7 @@ class GraphPartitioner {
                       kind == kOutEWiseFusable);
             }
           };
-          if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-            CommitFuse(graph_node, dom_node->parent->gnode);
-          }
+          TryFuse(graph_node, dom_node->parent->gnode, fcond);
         }
       } else if (group_node->pattern == kInjective || group_node->pattern == kTuple) {
         // defer injective fusion to second phase.
@@ -782,9 +845,7 @@ class GraphPartitioner {
         if (phase != 1) continue;
         // Check if all path are injective.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
-          CommitFuse(graph_node, dom_node->parent->gnode);
-        }
+        TryFuse(graph_node, dom_node->parent->gnode, fcond);
       } else {
         // do nothing.
         ICHECK(group_node->pattern == kCommReduce);
@@ -797,6 +858,7 @@ std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
     const IndexedForwardGraph& graph) {
   this->InitGroups(graph);
   if (opt_level_ == 0) return std::move(groups_);
+  graph_ = &graph;
   // get post dominator tree
   auto post_dom_tree = DominatorTree::PostDom(arena_, graph);
   // run fusion algorithm.
@@ -809,10 +871,12 @@ std::vector<GraphPartitioner::Group*> GraphPartitioner::Partition(
 class FuseMutator : private MixedModeMutator {
  public:
   // Run the transform
-  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth) {
+  Expr Transform(const Expr& body, int fuse_opt_level, size_t max_fuse_depth,
+                 PackedFunc fcost = nullptr) {
     // setup the group map.
     auto graph = IndexedForwardGraph::Create(&arena_, body);
-    auto groups = GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth).Partition(graph);
+    auto groups =
+        GraphPartitioner(&arena_, fuse_opt_level, max_fuse_depth, fcost).Partition(graph);
     for (size_t nid = 0; nid < graph.post_dfs_order.size(); ++nid) {
       ICHECK(graph.post_dfs_order[nid]->ref != nullptr);
       gmap_[graph.post_dfs_order[nid]->ref] = groups[nid];
@@ -1015,10 +1079,75 @@ class FuseMutator : private MixedModeMutator {
   }
 };
 
-Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, const IRModule& module) {
-  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth);
+Expr FuseOps(const Expr& expr, int fuse_opt_level, size_t max_fuse_depth, const IRModule& module,
+             PackedFunc fcost = nullptr) {
+  return FuseMutator().Transform(expr, fuse_opt_level, max_fuse_depth, fcost);
 }
 
+// The number of bytes of the tensors of a type, dynamic dimensions count as one.
+static int64_t TypeBytes(const Type& type) {
+  if (const auto* tensor = type.as<TensorTypeNode>()) {
+    int64_t bytes = (tensor->dtype.bits() * tensor->dtype.lanes() + 7) / 8;
+    for (const PrimExpr& dim : tensor->shape) {
+      if (const auto* imm = dim.as<IntImmNode>()) bytes *= imm->value;
+    }
+    return bytes;
+  } else if (const auto* tuple = type.as<TupleTypeNode>()) {
+    int64_t bytes = 0;
+    for (const Type& field : tuple->fields) bytes += TypeBytes(field);
+    return bytes;
+  }
+  return 0;
+}
+
+/*!
+ * \brief An analytical cost of a fused group, in bytes of memory traffic.
+ *
+ *  The traffic is the size of the inputs produced outside of the group and the size
+ *  of the nodes not used inside the group. The time to launch a kernel is counted as
+ *  kLaunchBytes. A group reading more than kMaxInputs tensors, or mixing more than
+ *  kMaxReductions reductions, is assumed to spill registers or lose vectorization and
+ *  its traffic is doubled.
+ */
+double AnalyticalFusionCost(const Array<Expr>& nodes) {
+  constexpr double kLaunchBytes = 64 << 10;
+  constexpr size_t kMaxInputs = 16;
+  constexpr int kMaxReductions = 1;
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  std::unordered_set<const Object*> members, used, inputs;
+  for (const Expr& node : nodes) members.insert(node.get());
+  double traffic = 0;
+  int num_reductions = 0;
+  auto read = [&](const Expr& arg) {
+    if (members.count(arg.get())) {
+      used.insert(arg.get());
+    } else if (inputs.insert(arg.get()).second && arg->checked_type_.defined()) {
+      traffic += TypeBytes(arg->checked_type());
+    }
+  };
+  for (const Expr& node : nodes) {
+    if (const auto* call = node.as<CallNode>()) {
+      for (const Expr& arg : call->args) read(arg);
+      if (const auto* op = call->op.as<OpNode>()) {
+        if (fpattern.get(GetRef<Op>(op), kOpaque) == kCommReduce) ++num_reductions;
+      }
+    } else if (const auto* tuple = node.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) read(field);
+    } else if (const auto* get = node.as<TupleGetItemNode>()) {
+      read(get->tuple);
+    }
+  }
+  for (const Expr& node : nodes) {
+    if (!used.count(node.get()) && node->checked_type_.defined()) {
+      traffic += TypeBytes(node->checked_type());
+    }
+  }
+  if (inputs.size() > kMaxInputs || num_reductions > kMaxReductions) traffic *= 2;
+  return traffic + kLaunchBytes;
+}
+
+TVM_REGISTER_GLOBAL("relay.FuseOps.AnalyticalCost").set_body_typed(AnalyticalFusionCost);
+
 namespace transform {
 
 Pass FuseOps(int fuse_opt_level) {
@@ -1026,7 +1155,13 @@ Pass FuseOps(int fuse_opt_level) {
       [=](Function f, IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relay.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), m));
+        PackedFunc fcost = nullptr;
+        if (auto cost_model = pc->GetConfig<String>("relay.FuseOps.cost_model")) {
+          const PackedFunc* pf = runtime::Registry::Get(cost_model.value());
+          ICHECK(pf != nullptr) << "Cannot find the fusion cost model " << cost_model.value();
+          fcost = *pf;
+        }
+        return Downcast<Function>(FuseOps(f, opt_level, max_fuse_depth.value(), m, fcost));
       };
   return CreateFunctionPass(pass_func, 1, "FuseOps", {"InferType"});
 }
@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file src/relay/transforms/horizontal_fuse_ops.cc
+ * \brief Pack independent fused functions into a single fused function.
+ *
+ * FuseOps fuses the ops along the dataflow, leaving many small independent
+ * kernels in models made of many towers. The calls to injective fused functions
+ * which are at the same depth of the dataflow graph do not depend on each other,
+ * so they are merged into one primitive function returning a tuple:
+ *
+ *   %0 = fn0(%x);             %0 = fn(%x, %y);  // fn returns (fn0(p0), fn1(p1))
+ *   %1 = fn1(%y);      ==>    %1 = %0.0;
+ *                             %2 = %0.1;
+ *
+ * The merged function is marked with attr::kHorizontalFusion, whose lowered
+ * PrimFuncs have their kernels packed into one launch by
+ * tir::transform::HorizontalFuseKernels.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/device_copy.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/feature.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief Find the groups of independent calls to injective fused functions. */
+class HorizontalGroupFinder : private MixedModeVisitor {
+ public:
+  explicit HorizontalGroupFinder(size_t max_group_size) : max_group_size_(max_group_size) {}
+
+  std::vector<std::vector<const CallNode*>> Find(const Expr& body) {
+    VisitExpr(body);
+    std::unordered_map<int, std::vector<const CallNode*>> levels;
+    std::vector<int> level_order;
+    for (const CallNode* call : candidates_) {
+      int level = depth_[call];
+      if (!levels.count(level)) level_order.push_back(level);
+      levels[level].push_back(call);
+    }
+    std::vector<std::vector<const CallNode*>> groups;
+    for (int level : level_order) {
+      const auto& calls = levels[level];
+      for (size_t begin = 0; begin + 1 < calls.size(); begin += max_group_size_) {
+        size_t end = std::min(calls.size(), begin + max_group_size_);
+        if (end - begin < 2) break;
+        groups.emplace_back(calls.begin() + begin, calls.begin() + end);
+      }
+    }
+    return groups;
+  }
+
+ private:
+  using MixedModeVisitor::VisitExpr_;
+
+  int Depth(const Expr& expr) {
+    auto it = depth_.find(expr.get());
+    return it == depth_.end() ? 0 : it->second;
+  }
+
+  void VisitExpr_(const TupleNode* op) final {
+    int depth = 0;
+    for (const Expr& field : op->fields) depth = std::max(depth, Depth(field));
+    depth_[op] = depth;
+  }
+
+  void VisitExpr_(const TupleGetItemNode* op) final { depth_[op] = Depth(op->tuple); }
+
+  void VisitExpr_(const CallNode* op) final {
+    int depth = 0;
+    for (const Expr& arg : op->args) depth = std::max(depth, Depth(arg));
+    depth_[op] = depth + 1;
+    if (IsCandidate(op)) candidates_.push_back(op);
+  }
+
+  // Only the calls in the scope of the visited function are grouped, the fused
+  // functions and the closures are not looked into.
+  void VisitExpr_(const FunctionNode* op) final {}
+
+  static bool IsCandidate(const CallNode* call) {
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* func = call->op.as<FunctionNode>();
+    if (func == nullptr || !func->HasNonzeroAttr(attr::kPrimitive) ||
+        func->GetAttr<String>(attr::kCompiler).defined()) {
+      return false;
+    }
+    if (!call->checked_type_.defined() || !call->checked_type().as<TensorTypeNode>()) {
+      return false;
+    }
+    bool injective = true;
+    PostOrderVisit(func->body, [&](const Expr& expr) {
+      if (const auto* inner = expr.as<CallNode>()) {
+        const auto* op = inner->op.as<OpNode>();
+        if (op == nullptr || inner->attrs.as<DeviceCopyAttrs>() ||
+            fpattern.get(GetRef<Op>(op), kOpaque) > kInjective) {
+          injective = false;
+        }
+      }
+    });
+    return injective;
+  }
+
+  size_t max_group_size_;
+  std::unordered_map<const Object*, int> depth_;
+  std::vector<const CallNode*> candidates_;
+};
+
+class HorizontalFuseMutator : private MixedModeMutator {
+ public:
+  Expr Transform(const Expr& body, size_t max_group_size) {
+    auto groups = HorizontalGroupFinder(max_group_size).Find(body);
+    if (groups.empty()) return body;
+    for (size_t i = 0; i < groups.size(); ++i) {
+      for (size_t j = 0; j < groups[i].size(); ++j) {
+        members_[groups[i][j]] = {i, j};
+      }
+    }
+    groups_ = std::move(groups);
+    merged_.resize(groups_.size());
+    return this->Mutate(body);
+  }
+
+ private:
+  using MixedModeMutator::VisitExpr_;
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) final {
+    auto it = members_.find(pre);
+    if (it == members_.end()) return post;
+    size_t group = it->second.first;
+    if (!merged_[group].defined()) merged_[group] = MergeGroup(groups_[group]);
+    return TupleGetItem(merged_[group], it->second.second);
+  }
+
+  // The calls of a group are independent, so their arguments can be rewritten before
+  // any of them is visited.
+  Expr MergeGroup(const std::vector<const CallNode*>& calls) {
+    Array<Var> params;
+    Array<Expr> bodies, args;
+    for (const CallNode* call : calls) {
+      Function func = Downcast<Function>(call->op);
+      Map<Var, Expr> binds;
+      for (const Var& param : func->params) {
+        Var fresh(param->name_hint(), param->type_annotation);
+        params.push_back(fresh);
+        binds.Set(param, fresh);
+      }
+      bodies.push_back(Bind(func->body, binds));
+      for (const Expr& arg : call->args) args.push_back(this->Mutate(arg));
+    }
+    Function func(params, Tuple(bodies), Type(), {});
+    func = WithAttr(std::move(func), attr::kPrimitive, tvm::Integer(1));
+    func = WithAttr(std::move(func), attr::kHorizontalFusion, tvm::Integer(1));
+    return Call(func, args);
+  }
+
+  std::vector<std::vector<const CallNode*>> groups_;
+  /*! \brief The group of each grouped call and its index in the group. */
+  std::unordered_map<const CallNode*, std::pair<size_t, size_t>> members_;
+  /*! \brief The call to the merged function of each group. */
+  std::vector<Expr> merged_;
+};
+
+Function HorizontalFuseOps(const Function& func, size_t max_group_size) {
+  if (func->HasNonzeroAttr(attr::kPrimitive)) return func;
+  // Only the dataflow fragment is handled, devices copies and control flow are left alone.
+  FeatureSet control_flow =
+      FeatureSet(fLet) + fIf + fRefCreate + fRefRead + fRefWrite + fConstructor + fMatch + fLetRec;
+  if (!DetectFeature(func).is_subset_of(FeatureSet::All() - control_flow)) return func;
+  static const Op& device_copy_op = Op::Get("device_copy");
+  bool has_device_copy = false;
+  PostOrderVisit(func, [&](const Expr& e) {
+    if (const auto* call = e.as<CallNode>()) {
+      if (call->op == device_copy_op || call->attrs.as<DeviceCopyAttrs>()) has_device_copy = true;
+    }
+  });
+  if (has_device_copy) return func;
+  Expr body = HorizontalFuseMutator().Transform(func->body, max_group_size);
+  if (body.same_as(func->body)) return func;
+  return Function(func->params, body, func->ret_type, func->type_params, func->attrs, func->span);
+}
+
+namespace transform {
+
+Pass HorizontalFuseOps(int max_group_size) {
+  ICHECK_GE(max_group_size, 2) << "A group must have at least two functions";
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return HorizontalFuseOps(f, max_group_size);
+      };
+  return CreateFunctionPass(pass_func, 4, "HorizontalFuseOps", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.HorizontalFuseOps").set_body_typed(HorizontalFuseOps);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
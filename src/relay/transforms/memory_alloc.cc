@@ -31,13 +31,16 @@
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/target/target.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -83,6 +86,173 @@ bool IsReshapeOnly(const Expr& expr) {
   return false;
 }
 
+/*!
+ * \brief Infer the output shapes of a primitive function symbolically, in terms of the shapes of
+ * its parameters.
+ *
+ * Every dynamic dimension of a parameter is given a symbol, which is propagated through the
+ * elementwise and broadcast operators. An output whose symbolic shape is exactly the one of a
+ * parameter has the shape of the corresponding argument at run time, without evaluating the shape
+ * function of the primitive function.
+ */
+class SymbolicShapeInferer {
+ public:
+  explicit SymbolicShapeInferer(const Function& func) : func_(func) {
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      const auto* type = func->params[i]->checked_type().as<TensorTypeNode>();
+      if (type == nullptr) {
+        param_shapes_.push_back(NullOpt);
+        continue;
+      }
+      Array<PrimExpr> shape;
+      for (size_t j = 0; j < type->shape.size(); ++j) {
+        if (type->shape[j]->IsInstance<AnyNode>()) {
+          shape.push_back(
+              tir::SizeVar("p" + std::to_string(i) + "_d" + std::to_string(j), DataType::Int(32)));
+        } else {
+          shape.push_back(type->shape[j]);
+        }
+      }
+      param_shapes_.push_back(shape);
+      memo_[func->params[i]] = shape;
+    }
+  }
+
+  /*!
+   * \brief For each output of the function, the index of the parameter of the same shape
+   * \return The indices, -1 for the outputs whose shape is not the shape of a parameter
+   */
+  std::vector<int> OutputSources() {
+    std::vector<Expr> outputs;
+    if (const auto* tuple = func_->body.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        outputs.push_back(field);
+      }
+    } else {
+      outputs.push_back(func_->body);
+    }
+    std::vector<int> sources;
+    for (const Expr& output : outputs) {
+      Optional<Array<PrimExpr>> shape = Infer(output);
+      int source = -1;
+      for (size_t i = 0; shape && i < param_shapes_.size() && source < 0; ++i) {
+        if (param_shapes_[i] && ShapeEqual(param_shapes_[i].value(), shape.value())) {
+          source = static_cast<int>(i);
+        }
+      }
+      sources.push_back(source);
+    }
+    return sources;
+  }
+
+ private:
+  static bool DimEqual(const PrimExpr& lhs, const PrimExpr& rhs) {
+    if (lhs.same_as(rhs)) return true;
+    const auto* lhs_imm = lhs.as<IntImmNode>();
+    const auto* rhs_imm = rhs.as<IntImmNode>();
+    return lhs_imm && rhs_imm && lhs_imm->value == rhs_imm->value;
+  }
+
+  static bool ShapeEqual(const Array<PrimExpr>& lhs, const Array<PrimExpr>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      if (!DimEqual(lhs[i], rhs[i])) return false;
+    }
+    return true;
+  }
+
+  // The numpy style broadcast of two symbolic shapes, undefined if the result depends on the
+  // values of the symbols.
+  static Optional<Array<PrimExpr>> Broadcast(const Array<PrimExpr>& lhs,
+                                             const Array<PrimExpr>& rhs) {
+    size_t ndim = std::max(lhs.size(), rhs.size());
+    std::vector<PrimExpr> shape(ndim);
+    for (size_t i = 1; i <= ndim; ++i) {
+      if (i > lhs.size()) {
+        shape[ndim - i] = rhs[rhs.size() - i];
+        continue;
+      }
+      if (i > rhs.size()) {
+        shape[ndim - i] = lhs[lhs.size() - i];
+        continue;
+      }
+      PrimExpr l = lhs[lhs.size() - i];
+      PrimExpr r = rhs[rhs.size() - i];
+      if (DimEqual(l, r) || tir::is_const_int(r, 1)) {
+        shape[ndim - i] = l;
+      } else if (tir::is_const_int(l, 1)) {
+        shape[ndim - i] = r;
+      } else if (l->IsInstance<IntImmNode>() && r->IsInstance<IntImmNode>()) {
+        return NullOpt;
+      } else {
+        // A symbol is broadcast with a constant other than 1 only if it's 1 or equal to the
+        // constant, the result is the constant.
+        shape[ndim - i] = l->IsInstance<IntImmNode>() ? l : r;
+        if (!shape[ndim - i]->IsInstance<IntImmNode>()) return NullOpt;
+      }
+    }
+    return Array<PrimExpr>(shape);
+  }
+
+  Optional<Array<PrimExpr>> Infer(const Expr& expr) {
+    auto it = memo_.find(expr);
+    if (it != memo_.end()) {
+      return it->second;
+    }
+    static const auto& fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* type = expr->checked_type().as<TensorTypeNode>();
+    Optional<Array<PrimExpr>> shape;
+    const auto* call = expr.as<CallNode>();
+    const auto* op = call ? call->op.as<OpNode>() : nullptr;
+    if (type != nullptr && op != nullptr &&
+        fpattern.get(GetRef<Op>(op), kOpaque) <= kBroadcast) {
+      for (const Expr& arg : call->args) {
+        if (!arg->checked_type().as<TensorTypeNode>()) continue;
+        Optional<Array<PrimExpr>> arg_shape = Infer(arg);
+        if (!arg_shape) {
+          shape = NullOpt;
+          break;
+        }
+        shape = shape ? Broadcast(shape.value(), arg_shape.value()) : arg_shape;
+        if (!shape) break;
+      }
+      // The operators deriving the shape from their attributes, e.g. broadcast_to, are only
+      // trusted where the inferred shape agrees with the type.
+      if (shape && !Consistent(shape.value(), type)) {
+        shape = NullOpt;
+      }
+    }
+    if (!shape && type != nullptr && IsStatic(type)) {
+      shape = type->shape;
+    }
+    memo_[expr] = shape;
+    return shape;
+  }
+
+  static bool IsStatic(const TensorTypeNode* type) {
+    for (const PrimExpr& dim : type->shape) {
+      if (!dim->IsInstance<IntImmNode>()) return false;
+    }
+    return true;
+  }
+
+  static bool Consistent(const Array<PrimExpr>& shape, const TensorTypeNode* type) {
+    if (shape.size() != type->shape.size()) return false;
+    for (size_t i = 0; i < shape.size(); ++i) {
+      bool dynamic = type->shape[i]->IsInstance<AnyNode>();
+      bool symbolic = !shape[i]->IsInstance<IntImmNode>();
+      if (dynamic != symbolic || (!dynamic && !DimEqual(shape[i], type->shape[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Function func_;
+  std::vector<Optional<Array<PrimExpr>>> param_shapes_;
+  std::unordered_map<Expr, Optional<Array<PrimExpr>>, ObjectPtrHash, ObjectPtrEqual> memo_;
+};
+
 class DialectRewriter : public ExprMutator {
  public:
   DialectRewriter(const Target& target_host, const AnalysisResultMap& context_analysis_map)
@@ -117,12 +287,16 @@ class DialectRewriter : public ExprMutator {
 
   Expr VisitExpr_(const LetNode* ln) final {
     scopes_.emplace_back();
+    shape_scopes_.emplace_back();
 
     const LetNode* let = ln;
     Expr body;
     while (let) {
       auto new_value = ExprMutator::Mutate(let->value);
       scopes_.back().Push(let->var, new_value);
+      if (Optional<Expr> shape = LookupShape(new_value)) {
+        shape_scopes_.back().shapes[let->var] = shape.value();
+      }
       body = let->body;
       let = body.as<LetNode>();
     }
@@ -130,6 +304,7 @@ class DialectRewriter : public ExprMutator {
     CHECK(body.defined());
     auto new_body = ExprMutator::Mutate(body);
     auto ret = scopes_.back().Get(new_body);
+    shape_scopes_.pop_back();
     scopes_.pop_back();
     return ret;
   }
@@ -332,18 +507,67 @@ class DialectRewriter : public ExprMutator {
     return out_shapes;
   }
 
+  // Look up the variable holding the shape of a tensor in the enclosing scopes.
+  Optional<Expr> LookupShape(const Expr& tensor) const {
+    for (auto it = shape_scopes_.rbegin(); it != shape_scopes_.rend(); ++it) {
+      auto shape_it = it->shapes.find(tensor);
+      if (shape_it != it->shapes.end()) {
+        return shape_it->second;
+      }
+    }
+    return NullOpt;
+  }
+
+  // Get the variable holding the shape of a tensor, emitting a shape_of on its first use.
+  Expr GetShapeOf(LetList* scope, const Expr& tensor) {
+    if (Optional<Expr> shape = LookupShape(tensor)) {
+      return shape.value();
+    }
+    Var shape_var("in_shape", Type(nullptr));
+    Expr shape = scope->Push(shape_var, ExprMutator::Mutate(ShapeOf(tensor)));
+    shape_scopes_.back().shapes[tensor] = shape;
+    return shape;
+  }
+
+  // Get the variable holding the storage size of a tensor of a dynamic shape, computing it once
+  // per shape and element size.
+  Expr GetStorageSize(LetList* scope, const Expr& shape, const TensorType& type) {
+    int64_t elem_bytes = (type->dtype.bits() * type->dtype.lanes() + 7) / 8;
+    for (auto it = shape_scopes_.rbegin(); it != shape_scopes_.rend(); ++it) {
+      auto shape_it = it->sizes.find(shape);
+      if (shape_it != it->sizes.end() && shape_it->second.count(elem_bytes)) {
+        return shape_it->second.at(elem_bytes);
+      }
+    }
+    Var size_var("storage_size", Type(nullptr));
+    Expr size = scope->Push(size_var, ComputeStorageInRelay(shape, type));
+    shape_scopes_.back().sizes[shape][elem_bytes] = size;
+    return size;
+  }
+
   // Generate the code for invoking a TVM op with a dynamic shape.
   Expr DynamicInvoke(LetList* scope, const Function& func, const Tuple& ins,
                      const std::vector<Expr>& new_args, const std::vector<TensorType>& out_types,
                      const Type& ret_type) {
-    auto out_shapes = EmitShapeFunc(scope, func, new_args);
+    // The outputs of the shape of an input, e.g. of the elementwise ops, reuse the shape of the
+    // input instead of evaluating the shape function. A chain of such ops shares a single shape
+    // and storage size computation.
+    std::vector<int> sources = SymbolicShapeInferer(func).OutputSources();
+    Array<Expr> out_shapes;
+    if (std::all_of(sources.begin(), sources.end(), [](int source) { return source >= 0; })) {
+      for (int source : sources) {
+        out_shapes.push_back(GetShapeOf(scope, new_args[source]));
+      }
+    } else {
+      out_shapes = EmitShapeFunc(scope, func, new_args);
+    }
     std::vector<Var> storages;
     auto func_dev = GetDevice(func);
     CHECK_EQ(out_shapes.size(), out_types.size());
     for (size_t i = 0; i < out_shapes.size(); ++i) {
       auto out_shape = out_shapes[i];
       auto out_type = out_types[i];
-      auto size = ComputeStorageInRelay(out_shape, out_type);
+      auto size = GetStorageSize(scope, out_shape, out_type);
       auto alignment = ComputeAlignment(out_type->dtype);
       Var sto_var("storage_" + std::to_string(i), Type(nullptr));
       auto val = AllocStorage(size, alignment, func_dev, out_type->dtype);
@@ -358,6 +582,7 @@ class DialectRewriter : public ExprMutator {
       auto alloc = AllocTensor(storage, out_shape, out_type->dtype, out_type->shape);
       Var out_var("out_" + std::to_string(i), Type(nullptr));
       outs.push_back(scope->Push(out_var, alloc));
+      shape_scopes_.back().shapes[outs.back()] = out_shape;
     }
 
     Tuple tuple_outs(outs);
@@ -390,6 +615,13 @@ class DialectRewriter : public ExprMutator {
   Target target_host_;
   AnalysisResultMap context_analysis_map_;
   std::vector<LetList> scopes_;
+  /*! \brief The known shapes of the tensors and storage sizes of the shapes, per scope */
+  struct ShapeScope {
+    std::unordered_map<Expr, Expr, ObjectPtrHash, ObjectPtrEqual> shapes;
+    std::unordered_map<Expr, std::unordered_map<int64_t, Expr>, ObjectPtrHash, ObjectPtrEqual>
+        sizes;
+  };
+  std::vector<ShapeScope> shape_scopes_;
 
   runtime::DataType compute_dtype_ = runtime::DataType::Int(64);
   Device default_device_{kDLCPU, 0};
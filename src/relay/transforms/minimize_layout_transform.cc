@@ -0,0 +1,386 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file minimize_layout_transform.cc
+ * \brief Move the layout-agnostic regions of a dataflow graph to the layout that needs the fewest
+ *        layout_transforms.
+ *
+ * AlterOpLayout and ConvertLayout decide the layout of each operator greedily, and realize the
+ * original layout whenever an operator cannot be rewritten. The elementwise operators between
+ * two convolutions in a blocked layout then often run in the original layout, between a
+ * NCHWc -> NCHW and a NCHW -> NCHWc transform.
+ *
+ * This pass groups the elementwise and broadcast operators whose tensor operands all have the
+ * shape of their output into connected regions. Such a region computes the same values in any
+ * layout of its tensors, so the pass counts, for every layout the region is transformed from,
+ * the layout_transforms the region needs at its boundary in that layout, and moves the region to
+ * the layout of the fewest transforms.
+ */
+#include <tvm/relay/attrs/transform.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+#include <tvm/tir/data_layout.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+namespace minimize_layout_transform {
+
+/*! \brief A connected region of layout-agnostic calls. */
+struct Region {
+  /*! \brief The calls of the region. */
+  std::unordered_set<const CallNode*> calls;
+  /*! \brief The layout the region computes in. */
+  std::string layout;
+  /*! \brief The layout the region is moved to, empty to keep it in its layout. */
+  std::string new_layout;
+};
+
+class LayoutRegionFinder : private ExprVisitor {
+ public:
+  /*!
+   * \brief Find the regions of the layout-agnostic calls of an expression, and the layout each
+   * region is moved to.
+   * \param expr The expression.
+   * \return The regions, keyed by their calls.
+   */
+  std::unordered_map<const CallNode*, std::shared_ptr<Region>> Find(const Expr& expr) {
+    VisitExpr(expr);
+    users_[expr.get()].push_back(nullptr);
+    // The regions, as the union of the agnostic calls and their agnostic arguments.
+    for (const CallNode* call : agnostic_) {
+      for (const Expr& arg : call->args) {
+        const auto* arg_call = arg.as<CallNode>();
+        if (arg_call && agnostic_.count(arg_call)) {
+          Union(call, arg_call);
+        }
+      }
+    }
+    std::unordered_map<const CallNode*, std::shared_ptr<Region>> roots;
+    std::unordered_map<const CallNode*, std::shared_ptr<Region>> regions;
+    for (const CallNode* call : agnostic_) {
+      std::shared_ptr<Region>& region = roots[Find(call)];
+      if (!region) {
+        region = std::make_shared<Region>();
+      }
+      region->calls.insert(call);
+      regions[call] = region;
+    }
+    for (const auto& it : roots) {
+      ChooseLayout(it.second.get());
+    }
+    return regions;
+  }
+
+ private:
+  void VisitExpr_(const CallNode* call) final {
+    ExprVisitor::VisitExpr_(call);
+    for (const Expr& arg : call->args) {
+      users_[arg.get()].push_back(call);
+    }
+    if (IsAgnostic(call)) {
+      agnostic_.insert(call);
+    }
+  }
+
+  void VisitExpr_(const TupleNode* tuple) final {
+    ExprVisitor::VisitExpr_(tuple);
+    for (const Expr& field : tuple->fields) {
+      users_[field.get()].push_back(nullptr);
+    }
+  }
+
+  void VisitExpr_(const TupleGetItemNode* get_item) final {
+    ExprVisitor::VisitExpr_(get_item);
+    users_[get_item->tuple.get()].push_back(nullptr);
+  }
+
+  void VisitExpr_(const LetNode* let) final {
+    ExprVisitor::VisitExpr_(let);
+    users_[let->value.get()].push_back(nullptr);
+    users_[let->body.get()].push_back(nullptr);
+  }
+
+  void VisitExpr_(const IfNode* if_node) final {
+    ExprVisitor::VisitExpr_(if_node);
+    for (const Expr& expr : {if_node->cond, if_node->true_branch, if_node->false_branch}) {
+      users_[expr.get()].push_back(nullptr);
+    }
+  }
+
+  void VisitExpr_(const FunctionNode* func) final {
+    ExprVisitor::VisitExpr_(func);
+    users_[func->body.get()].push_back(nullptr);
+  }
+
+  /*! \brief Whether the call computes the same values in any layout of its tensors. */
+  static bool IsAgnostic(const CallNode* call) {
+    static const auto& fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+    const auto* op = call->op.as<OpNode>();
+    if (!op || fpattern.get(GetRef<Op>(op), kOpaque) > kBroadcast) {
+      return false;
+    }
+    const auto* out_type = call->checked_type_.as<TensorTypeNode>();
+    if (!out_type || out_type->shape.empty()) {
+      return false;
+    }
+    for (const Expr& arg : call->args) {
+      const auto* arg_type = arg->checked_type_.as<TensorTypeNode>();
+      if (!arg_type) {
+        return false;
+      }
+      if (!arg_type->shape.empty() && !StructuralEqual()(arg_type->shape, out_type->shape)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The attributes of a layout_transform, nullptr if the node is not a layout_transform. */
+  static const LayoutTransformAttrs* AsLayoutTransform(const Object* node) {
+    static const Op& layout_transform = Op::Get("layout_transform");
+    if (!node || !node->IsInstance<CallNode>()) {
+      return nullptr;
+    }
+    const auto* call = static_cast<const CallNode*>(node);
+    if ( !call->op.same_as(layout_transform)) {
+      return nullptr;
+    }
+    return call->attrs.as<LayoutTransformAttrs>();
+  }
+
+  static bool IsScalar(const Expr& expr) {
+    const auto* type = expr->checked_type_.as<TensorTypeNode>();
+    return type && type->shape.empty();
+  }
+
+  /*!
+   * \brief Choose the layout of the region with the fewest layout_transforms at its boundary.
+   *
+   * Moving the region from its layout L to a layout S:
+   *  - removes the layout_transforms S -> L of its inputs, unless they have other users;
+   *  - adds a layout_transform L -> S to its other tensor inputs;
+   *  - removes the layout_transforms L -> S of its outputs;
+   *  - changes the layout_transforms L -> D of its outputs to S -> D;
+   *  - adds a layout_transform S -> L to the outputs with other users.
+   */
+  void ChooseLayout(Region* region) {
+    // The inputs of the region, and its layout.
+    std::vector<const Object*> inputs;
+    std::unordered_set<const Object*> visited;
+    for (const CallNode* call : region->calls) {
+      for (const Expr& arg : call->args) {
+        const auto* arg_call = arg.as<CallNode>();
+        if ((arg_call && region->calls.count(arg_call)) || IsScalar(arg) ||
+            !visited.insert(arg.get()).second) {
+          continue;
+        }
+        inputs.push_back(arg.get());
+        if (const auto* attrs = AsLayoutTransform(arg.get())) {
+          if (!region->layout.empty() && region->layout != attrs->dst_layout) {
+            return;
+          }
+          region->layout = attrs->dst_layout;
+        }
+      }
+    }
+    if (region->layout.empty()) {
+      return;
+    }
+    Layout layout(region->layout);
+    // The layouts the region is transformed from are the candidates.
+    std::vector<std::string> candidates;
+    for (const Object* input : inputs) {
+      const auto* attrs = AsLayoutTransform(input);
+      if (attrs && std::find(candidates.begin(), candidates.end(), attrs->src_layout) ==
+                       candidates.end()) {
+        candidates.push_back(attrs->src_layout);
+      }
+    }
+    int best_cost = 0;
+    for (const std::string& candidate : candidates) {
+      Layout new_layout(candidate);
+      if (!tir::BijectiveLayout(layout, new_layout).defined()) {
+        continue;
+      }
+      int cost = 0;
+      for (const Object* input : inputs) {
+        const auto* attrs = AsLayoutTransform(input);
+        if (!attrs || attrs->src_layout != candidate) {
+          cost += 1;
+        } else if (OnlyUsedBy(input, region)) {
+          cost -= 1;
+        }
+      }
+      for (const CallNode* call : region->calls) {
+        bool realized = false;
+        for (const CallNode* user : users_[call]) {
+          if (user && region->calls.count(user)) {
+            continue;
+          }
+          const auto* attrs = AsLayoutTransform(user);
+          if (attrs && attrs->dst_layout == candidate) {
+            cost -= 1;
+          } else if (!attrs ||
+                     !tir::BijectiveLayout(new_layout, Layout(attrs->dst_layout)).defined()) {
+            realized = true;
+          }
+        }
+        cost += realized;
+      }
+      if (cost < best_cost) {
+        best_cost = cost;
+        region->new_layout = candidate;
+      }
+    }
+  }
+
+  /*! \brief Whether the expression is only used by the calls of the region. */
+  bool OnlyUsedBy(const Object* expr, const Region* region) {
+    for (const CallNode* user : users_[expr]) {
+      if (!user || !region->calls.count(user)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const CallNode* Find(const CallNode* call) {
+    auto it = parent_.find(call);
+    if (it == parent_.end() || it->second == call) {
+      return call;
+    }
+    return it->second = Find(it->second);
+  }
+
+  void Union(const CallNode* a, const CallNode* b) { parent_[Find(a)] = Find(b); }
+
+  /*! \brief The users of each expression, nullptr for a user other than a call. */
+  std::unordered_map<const Object*, std::vector<const CallNode*>> users_;
+  /*! \brief The layout-agnostic calls. */
+  std::unordered_set<const CallNode*> agnostic_;
+  /*! \brief The union-find forest of the regions. */
+  std::unordered_map<const CallNode*, const CallNode*> parent_;
+};
+
+class LayoutTransformMinimizer : public ExprMutator {
+ public:
+  explicit LayoutTransformMinimizer(
+      std::unordered_map<const CallNode*, std::shared_ptr<Region>> regions)
+      : regions_(std::move(regions)) {}
+
+  Expr VisitExpr_(const CallNode* call) final {
+    static const Op& layout_transform = Op::Get("layout_transform");
+    if (const Region* region = MovedRegion(call)) {
+      // The users outside of the region still see the region in its layout.
+      return MakeLayoutTransform(Moved(call), region->new_layout, region->layout);
+    }
+    if (call->op.same_as(layout_transform)) {
+      const auto* attrs = call->attrs.as<LayoutTransformAttrs>();
+      const auto* arg = call->args[0].as<CallNode>();
+      if (const Region* region = arg ? MovedRegion(arg) : nullptr) {
+        if (attrs->dst_layout == region->new_layout) {
+          return Moved(arg);
+        }
+        if (tir::BijectiveLayout(Layout(region->new_layout), Layout(attrs->dst_layout))
+                .defined()) {
+          return MakeLayoutTransform(Moved(arg), region->new_layout, attrs->dst_layout);
+        }
+      }
+    }
+    return ExprMutator::VisitExpr_(call);
+  }
+
+ private:
+  const Region* MovedRegion(const CallNode* call) const {
+    auto it = regions_.find(call);
+    if (it == regions_.end() || it->second->new_layout.empty()) {
+      return nullptr;
+    }
+    return it->second.get();
+  }
+
+  /*! \brief The call of a moved region, computing in the new layout of the region. */
+  Expr Moved(const CallNode* call) {
+    auto it = moved_.find(call);
+    if (it != moved_.end()) {
+      return it->second;
+    }
+    static const Op& layout_transform = Op::Get("layout_transform");
+    const Region* region = MovedRegion(call);
+    Array<Expr> args;
+    for (const Expr& arg : call->args) {
+      const auto* arg_call = arg.as<CallNode>();
+      const auto* arg_type = arg->checked_type_.as<TensorTypeNode>();
+      if (arg_call && region->calls.count(arg_call)) {
+        args.push_back(Moved(arg_call));
+      } else if (arg_type->shape.empty()) {
+        args.push_back(VisitExpr(arg));
+      } else if (arg_call && arg_call->op.same_as(layout_transform) &&
+                 arg_call->attrs.as<LayoutTransformAttrs>()->src_layout == region->new_layout) {
+        args.push_back(VisitExpr(arg_call->args[0]));
+      } else {
+        args.push_back(MakeLayoutTransform(VisitExpr(arg), region->layout, region->new_layout));
+      }
+    }
+    Expr moved = Call(call->op, args, call->attrs, call->type_args, call->span);
+    return moved_[call] = moved;
+  }
+
+  /*! \brief The regions of the layout-agnostic calls. */
+  std::unordered_map<const CallNode*, std::shared_ptr<Region>> regions_;
+  /*! \brief The calls of the moved regions, in the new layout. */
+  std::unordered_map<const CallNode*, Expr> moved_;
+};
+
+Expr MinimizeLayoutTransform(const Expr& expr) {
+  auto regions = LayoutRegionFinder().Find(expr);
+  return LayoutTransformMinimizer(std::move(regions)).Mutate(expr);
+}
+
+}  // namespace minimize_layout_transform
+
+namespace transform {
+
+Pass MinimizeLayoutTransform() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(relay::minimize_layout_transform::MinimizeLayoutTransform(f));
+      };
+  return CreateFunctionPass(pass_func, 3, "MinimizeLayoutTransform", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.MinimizeLayoutTransform")
+    .set_body_typed(MinimizeLayoutTransform);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
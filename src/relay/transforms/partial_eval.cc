@@ -88,8 +88,17 @@
  * We can do a binding time analysis to cache the result and avoid re-partial evaluation.
  *
  * These assumptions do not affect the correctness of the algorithm, however.
+ *
+ * The "relay.PartialEval" pass config bounds the expansion: at most max_inlines function bodies
+ * are expanded and the functions of more than max_inline_size nodes are not, the calls being left
+ * to the runtime. With memoize, the calls of the pure functions on static arguments are evaluated
+ * once per structurally equal arguments. With record_specializations, the
+ * "relay.partial_eval_specializations" attribute of every global function lists the calls
+ * expanded, memoized and left while evaluating it.
  */
 #include <tvm/ir/type_functor.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/feature.h>
@@ -97,6 +106,11 @@
 #include <tvm/relay/pattern_functor.h>
 #include <tvm/relay/transform.h>
 
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "../../support/utils.h"
 #include "let_list.h"
 #include "pass_utils.h"
 
@@ -559,6 +573,36 @@ struct WithFuncIdAttrs : public tvm::AttrsNode<WithFuncIdAttrs> {
 
 TVM_REGISTER_NODE_TYPE(WithFuncIdAttrs);
 
+struct PartialEvalConfigNode : public tvm::AttrsNode<PartialEvalConfigNode> {
+  int max_inlines;
+  int max_inline_size;
+  bool memoize;
+  bool record_specializations;
+
+  TVM_DECLARE_ATTRS(PartialEvalConfigNode, "relay.transform.PartialEvalConfig") {
+    TVM_ATTR_FIELD(max_inlines)
+        .describe("The number of function bodies expanded in a module, negative for no limit")
+        .set_default(-1);
+    TVM_ATTR_FIELD(max_inline_size)
+        .describe("The number of nodes of the largest function body expanded, 0 for no limit")
+        .set_default(0);
+    TVM_ATTR_FIELD(memoize)
+        .describe("Evaluate the pure calls on static arguments once per arguments")
+        .set_default(false);
+    TVM_ATTR_FIELD(record_specializations)
+        .describe("Record the calls in the relay.partial_eval_specializations function attribute")
+        .set_default(false);
+  }
+};
+
+class PartialEvalConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(PartialEvalConfig, Attrs, PartialEvalConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(PartialEvalConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.PartialEval", PartialEvalConfig);
+
 RELAY_REGISTER_OP("annotation.with_funcid")
     .describe(R"code(Annotate a function with a funcid.)code" TVM_ADD_FILELINE)
     .set_num_inputs(1)
@@ -591,7 +635,7 @@ Function AsFunc(const Expr& e) {
 class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>,
                          public PatternFunctor<MatchStatus(const Pattern&, const PStatic&)> {
  public:
-  PartialEvaluator(const IRModule& mod) : mod_(mod) {}
+  PartialEvaluator(const IRModule& mod, const PartialEvalConfig& cfg) : mod_(mod), cfg_(cfg) {}
 
   PStatic VisitExpr(const Expr& e, LetList* ll) final {
     PStatic ret = ExprFunctor<PStatic(const Expr&, LetList*)>::VisitExpr(e, ll);
@@ -645,9 +689,17 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
       if (auto* n = base_func.as<FunctionNode>()) {
         Function func = GetRef<Function>(n);
         InitializeFuncId(func);
+        func_names_[func_map_.at(func)] = gv->name_hint;
         Func f = VisitFuncStatic(func, gv);
         gv_map_.insert({gv, HasStatic(MkSFunc(f), gv)});
+        std::map<std::string, CallStats> outer_stats;
+        std::swap(outer_stats, call_stats_);
         func = AsFunc(PostProcess(VisitFuncDynamic(func, f, gv)));
+        std::swap(outer_stats, call_stats_);
+        if (cfg_->record_specializations) {
+          func = WithAttr(std::move(func), "relay.partial_eval_specializations",
+                          ReportCallStats(outer_stats));
+        }
         mod_->Update(gv, func);
         return gv_map_.at(gv);
       } else {
@@ -774,6 +826,107 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
     return MkFSeq(fuels);
   }
 
+  /*! \brief The calls of a function evaluated while evaluating a global function. */
+  struct CallStats {
+    /*! \brief The number of calls expanded. */
+    int inlined{0};
+    /*! \brief The number of calls the value of which was memoized. */
+    int memoized{0};
+    /*! \brief The number of calls left to the runtime by the budget. */
+    int over_budget{0};
+  };
+
+  /*! \brief A call of a pure function on static arguments, evaluated to a static value. */
+  struct Specialization {
+    FuncId fid;
+    Expr args;
+    tvm::Array<Type> type_args;
+    /*! \brief The static value of the call. */
+    Static value;
+    /*! \brief The value reflected, to be bound at the call sites. */
+    Expr reflected;
+  };
+
+  std::string FuncName(FuncId fid) const {
+    auto it = func_names_.find(fid);
+    return it != func_names_.end() ? it->second : "fn#" + std::to_string(fid);
+  }
+
+  static tvm::Array<String> ReportCallStats(const std::map<std::string, CallStats>& stats) {
+    tvm::Array<String> lines;
+    for (const auto& kv : stats) {
+      std::ostringstream os;
+      os << kv.first << ": " << kv.second.inlined << " inlined, " << kv.second.memoized
+         << " memoized, " << kv.second.over_budget << " over budget";
+      lines.push_back(os.str());
+    }
+    return lines;
+  }
+
+  /*! \brief The number of nodes of the body of a function, the size of its expansions. */
+  int64_t BodySize(FuncId fid, const Function& func) {
+    auto it = body_size_.find(fid);
+    if (it != body_size_.end()) {
+      return it->second;
+    }
+    struct SizeVisitor : ExprVisitor {
+      int64_t size{0};
+      void VisitExpr(const Expr& e) final {
+        ++size;
+        ExprVisitor::VisitExpr(e);
+      }
+    } visitor;
+    visitor.VisitExpr(func->body);
+    return body_size_[fid] = visitor.size;
+  }
+
+  /*!
+   * \brief Whether a function only computes its value, without references, global functions nor
+   *  stateful operators, so that a call on static arguments can be replaced by its value.
+   */
+  bool IsPure(FuncId fid, const Function& func) {
+    auto it = is_pure_.find(fid);
+    if (it != is_pure_.end()) {
+      return it->second;
+    }
+    struct PureVisitor : ExprVisitor {
+      bool pure{true};
+      void VisitExpr_(const RefCreateNode* op) final { pure = false; }
+      void VisitExpr_(const RefReadNode* op) final { pure = false; }
+      void VisitExpr_(const RefWriteNode* op) final { pure = false; }
+      void VisitExpr_(const GlobalVarNode* op) final { pure = false; }
+      void VisitExpr_(const OpNode* op) final { pure = pure && !StatefulOp(GetRef<Op>(op)); }
+    } visitor;
+    visitor.VisitExpr(func->body);
+    return is_pure_[fid] = visitor.pure;
+  }
+
+  /*! \brief Whether the budget of the expansions allows to expand a function. */
+  bool WithinBudget(FuncId fid, const Function& func) {
+    if (cfg_->max_inlines >= 0 && num_inlines_ >= cfg_->max_inlines) {
+      return false;
+    }
+    return cfg_->max_inline_size <= 0 || BodySize(fid, func) <= cfg_->max_inline_size;
+  }
+
+  /*!
+   * \brief Find the memoized value of a call.
+   * \param key The hash of the call.
+   * \return The specialization, nullptr if the call was not evaluated.
+   */
+  const Specialization* FindSpecialization(uint64_t key, FuncId fid, const Expr& args,
+                                           const tvm::Array<Type>& type_args) const {
+    auto range = specializations_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Specialization& spec = it->second;
+      if (spec.fid == fid && StructuralEqual()(spec.args, args) &&
+          StructuralEqual()(spec.type_args, type_args)) {
+        return &spec;
+      }
+    }
+    return nullptr;
+  }
+
   Func VisitFuncStatic(const Function& func, const Expr& var) {
     ICHECK(IsAtomic(var));
     if (func->HasNonzeroAttr(attr::kPrimitive)) {
@@ -798,8 +951,47 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
         for (const auto& v : pv) {
           args_fuel.push_back(GetFuel(v));
         }
+        // The body of a dynamic function is always expanded, the calls in it are to the budget.
+        bool force_inline = force_inline_;
+        force_inline_ = false;
+        CallStats& stats = call_stats_[FuncName(fid)];
+        if (!force_inline && !WithinBudget(fid, func)) {
+          ++stats.over_budget;
+          std::vector<Expr> dyn;
+          for (const auto& v : pv) {
+            dyn.push_back(v->dynamic);
+          }
+          store_.Invalidate();
+          return NoStatic(ll->Push(Call(self->dynamic, dyn, attrs, type_args)));
+        }
+        // The static arguments of a memoizable call, and its hash.
+        Optional<Expr> static_args;
+        uint64_t key = 0;
+        // The value of a call only depends on its arguments when the function captures nothing.
+        if (cfg_->memoize && !force_inline && free_vars.empty() && IsPure(fid, func) &&
+            std::all_of(pv.begin(), pv.end(), [this](const PStatic& ps) { return IsStatic(ps); })) {
+          tvm::Array<Expr> args;
+          for (const PStatic& ps : pv) {
+            args.push_back(Reflect(ps));
+          }
+          static_args = Tuple(args);
+          key = support::HashCombine(StructuralHash()(static_args.value()),
+                                     StructuralHash()(type_args));
+          key = support::HashCombine(key, std::hash<FuncId>()(fid));
+        }
+        if (static_args.defined()) {
+          if (const Specialization* spec =
+                  FindSpecialization(key, fid, static_args.value(), type_args)) {
+            ++stats.memoized;
+            return HasStatic(spec->value, ll->Push(spec->reflected));
+          }
+        }
         auto meet_res = fuel_map_[fid]->Meet(MkFSeq(args_fuel));
         if (std::get<1>(meet_res)) {
+          ++stats.inlined;
+          if (!force_inline) {
+            ++num_inlines_;
+          }
           FuelFrame tf(this, fid, std::get<0>(meet_res));
           Expr dedup_func = RegisterFuncId(DeDup(AnnotateFuncId(func)));
           Function func = AsFunc(dedup_func);
@@ -819,7 +1011,13 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
           for (size_t i = type_args.size(); i < func->type_params.size(); ++i) {
             subst.Set(func->type_params[i], IncompleteType(kType));
           }
-          return VisitExpr(RegisterFuncId(TypeSubst(AnnotateFuncId(func->body), subst)), ll);
+          PStatic ret =
+              VisitExpr(RegisterFuncId(TypeSubst(AnnotateFuncId(func->body), subst)), ll);
+          if (static_args.defined() && IsStatic(ret)) {
+            specializations_.emplace(
+                key, Specialization{fid, static_args.value(), type_args, ret->pstatic, Reflect(ret)});
+          }
+          return ret;
         } else {
           std::vector<Expr> dyn;
           for (const auto& v : pv) {
@@ -843,6 +1041,7 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
                         for (const auto& tp : func->type_params) {
                           type_args.push_back(tp);
                         }
+                        force_inline_ = !func->HasNonzeroAttr(attr::kPrimitive);
                         return f(HasStatic(MkSFunc(f), self), pv, Attrs(), type_args, ll)->dynamic;
                       }),
                       func->ret_type, func->type_params, func->attrs);
@@ -861,6 +1060,17 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
     return VisitFunc(GetRef<Function>(op), ll);
   }
 
+  /*! \brief Whether a value is fully static, made of tensors and tuples Reflect handles. */
+  bool IsStatic(const PStatic& ps) const {
+    if (ps->pstatic.as<STensorNode>()) {
+      return true;
+    } else if (const STupleNode* op = ps->pstatic.as<STupleNode>()) {
+      return std::all_of(op->fields.begin(), op->fields.end(),
+                         [this](const PStatic& field) { return IsStatic(field); });
+    }
+    return false;
+  }
+
   struct ReflectError : Error {
     ReflectError() : Error("static value not found") {}
   };
@@ -1135,6 +1345,20 @@ class PartialEvaluator : public ExprFunctor<PStatic(const Expr& e, LetList* ll)>
    */
   std::unordered_map<Function, FuncId, ObjectPtrHash, ObjectPtrEqual> func_map_;
   std::unordered_map<FuncId, Fuel> fuel_map_;
+  /*! \brief The budget and the memoization of the calls. */
+  PartialEvalConfig cfg_;
+  /*! \brief The number of function bodies expanded, to the budget. */
+  int num_inlines_{0};
+  /*! \brief Whether the next call evaluated makes the body of a dynamic function. */
+  bool force_inline_{false};
+  /*! \brief The names of the global functions, for the report. */
+  std::unordered_map<FuncId, std::string> func_names_;
+  /*! \brief The calls evaluated for the global function being evaluated, by callee. */
+  std::map<std::string, CallStats> call_stats_;
+  std::unordered_map<FuncId, int64_t> body_size_;
+  std::unordered_map<FuncId, bool> is_pure_;
+  /*! \brief The memoized calls, by the hash of their arguments. */
+  std::unordered_multimap<uint64_t, Specialization> specializations_;
   Store store_;
   Device device_ = CPUDevice();
   FInterpreter executor_ = CPUInterpreter();
@@ -1183,7 +1407,12 @@ Expr PostProcess(const Expr& e) { return StripWithFuncId(DeDup(Remap(e))); }
 
 IRModule PartialEval(const IRModule& m) {
   CheckFeature(m, FeatureSet::All() - fGraph);
-  relay::partial_eval::PartialEvaluator pe(m);
+  auto cfg = transform::PassContext::Current()->GetConfig<partial_eval::PartialEvalConfig>(
+      "relay.PartialEval");
+  if (!cfg.defined()) {
+    cfg = AttrsWithDefaultValues<partial_eval::PartialEvalConfig>();
+  }
+  relay::partial_eval::PartialEvaluator pe(m, cfg.value());
   std::vector<GlobalVar> gvs;
   for (const auto& p : m->functions) {
     gvs.push_back(p.first);
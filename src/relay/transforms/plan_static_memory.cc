@@ -0,0 +1,374 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/plan_static_memory.cc
+ * \brief Pack the static allocations of the VM dialect into pre-planned arenas.
+ *
+ *  After ManifestAlloc, every intermediate owns a `memory.alloc_storage`. For
+ *  each let chain, this pass computes the live range of the storages with a
+ *  constant size, from their definition to the last use of any value that may
+ *  alias them, and assigns them to slots the way graph_plan_memory assigns
+ *  tokens: a slot is reused once its previous owner is dead. The slots of a
+ *  device are laid out in a single arena allocated once per chain, and the
+ *  tensors are allocated at their slot offset inside it.
+ *
+ *  Storages reachable from the result of the chain, captured by a closure or
+ *  stored in a reference are left untouched.
+ */
+#include <tvm/relay/attrs/memory.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+#include <tvm/runtime/logging.h>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../op/memory/memory.h"
+#include "pattern_utils.h"
+
+namespace tvm {
+namespace relay {
+
+namespace {
+
+/*! \brief Read a constant int64 scalar, returns false if expr is not one. */
+bool GetConstInt64(const Expr& expr, int64_t* value) {
+  const auto* constant = expr.as<ConstantNode>();
+  if (constant == nullptr || !constant->is_scalar()) return false;
+  const DLTensor* data = constant->data.operator->();
+  if (data->dtype.code != kDLInt || data->dtype.bits != 64 || data->device.device_type != kDLCPU) {
+    return false;
+  }
+  *value = static_cast<const int64_t*>(data->data)[0];
+  return true;
+}
+
+/*! \brief Collect the variables an expression refers to. */
+class VarUseCollector : public ExprVisitor {
+ public:
+  void VisitExpr_(const VarNode* var) final {
+    // Uses under a closure or a reference outlive the binding that creates them.
+    if (captured_ > 0) {
+      captured.insert(var);
+    } else {
+      used.insert(var);
+    }
+  }
+
+  void VisitExpr_(const FunctionNode* func) final {
+    ++captured_;
+    ExprVisitor::VisitExpr_(func);
+    --captured_;
+  }
+
+  void VisitExpr_(const RefCreateNode* ref) final {
+    ++captured_;
+    ExprVisitor::VisitExpr_(ref);
+    --captured_;
+  }
+
+  void VisitExpr_(const RefWriteNode* ref) final {
+    ++captured_;
+    ExprVisitor::VisitExpr_(ref);
+    --captured_;
+  }
+
+  std::unordered_set<const VarNode*> used;
+  std::unordered_set<const VarNode*> captured;
+
+ private:
+  int captured_{0};
+};
+
+/*! \brief Whether the value bound by a call never aliases its arguments. */
+bool IsFreshValue(const Expr& value) {
+  static const Op& invoke_tvm_op = Op::Get("vm.invoke_tvm_op");
+  static const Op& shape_func = Op::Get("vm.shape_func");
+  static const Op& shape_of = Op::Get("vm.shape_of");
+  static const Op& device_copy = Op::Get("device_copy");
+  static const Op& alloc_storage = Op::Get("memory.alloc_storage");
+  static const Op& kill = Op::Get("memory.kill");
+  const auto* call = value.as<CallNode>();
+  if (call == nullptr) return false;
+  return call->op == invoke_tvm_op || call->op == shape_func || call->op == shape_of ||
+         call->op == device_copy || call->op == alloc_storage || call->op == kill;
+}
+
+/*! \brief A static storage of a let chain and its live range. */
+struct StorageInfo {
+  size_t def{0};
+  size_t last_use{0};
+  int64_t size{0};
+  int64_t alignment{0};
+  Device device;
+  DataType dtype_hint;
+  bool plannable{true};
+  /*! \brief The slot of the arena of the device. */
+  size_t slot{0};
+};
+
+class StaticMemoryPlanner : public ExprMutator {
+ public:
+  Expr VisitExpr_(const LetNode* ln) final {
+    std::vector<std::pair<Var, Expr>> bindings;
+    Expr body = GetRef<Let>(ln);
+    while (const auto* let = body.as<LetNode>()) {
+      bindings.emplace_back(let->var, Mutate(let->value));
+      body = let->body;
+    }
+    return PlanChain(bindings, Mutate(body));
+  }
+
+ private:
+  Expr PlanChain(const std::vector<std::pair<Var, Expr>>& bindings, const Expr& body) {
+    static const Op& alloc_storage = Op::Get("memory.alloc_storage");
+    static const Op& alloc_tensor = Op::Get("memory.alloc_tensor");
+
+    // Collect the storages of constant size.
+    std::unordered_map<const VarNode*, StorageInfo> storages;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      const auto* call = bindings[i].second.as<CallNode>();
+      if (call == nullptr || call->op != alloc_storage) continue;
+      const auto* attrs = call->attrs.as<AllocStorageAttrs>();
+      StorageInfo info;
+      if (attrs == nullptr || !GetConstInt64(call->args[0], &info.size) ||
+          !GetConstInt64(call->args[1], &info.alignment)) {
+        continue;
+      }
+      info.def = i;
+      info.last_use = i;
+      info.device.device_type = static_cast<DLDeviceType>(attrs->device_type);
+      info.device.device_id = attrs->device_id;
+      info.dtype_hint = attrs->dtype;
+      storages.emplace(bindings[i].first.get(), info);
+    }
+    if (storages.size() < 2) return Rebuild(bindings, body);
+
+    // Compute the live ranges, following the values that may alias a storage.
+    std::unordered_map<const VarNode*, std::unordered_set<const VarNode*>> owners;
+    for (const auto& kv : storages) owners[kv.first].insert(kv.first);
+
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      const Expr& value = bindings[i].second;
+      VarUseCollector uses;
+      uses(value);
+      const auto* call = value.as<CallNode>();
+      bool is_alloc_tensor = call != nullptr && call->op == alloc_tensor;
+      std::unordered_set<const VarNode*> touched;
+      for (const VarNode* var : uses.used) {
+        auto it = owners.find(var);
+        if (it != owners.end()) touched.insert(it->second.begin(), it->second.end());
+      }
+      for (const VarNode* var : uses.captured) {
+        auto it = owners.find(var);
+        if (it == owners.end()) continue;
+        for (const VarNode* sto : it->second) storages[sto].plannable = false;
+      }
+      for (const VarNode* sto : touched) {
+        StorageInfo& info = storages[sto];
+        info.last_use = i;
+        if (uses.used.count(sto)) {
+          // The storage itself may only back tensors allocated at a constant offset.
+          int64_t offset;
+          if (!is_alloc_tensor || !call->args[0].same_as(GetRef<Var>(sto)) ||
+              !GetConstInt64(call->args[1], &offset)) {
+            info.plannable = false;
+          }
+        }
+        if (!IsFreshValue(value)) {
+          owners[bindings[i].first.get()].insert(sto);
+        }
+      }
+    }
+    {
+      VarUseCollector uses;
+      uses(body);
+      for (const VarNode* var : uses.used) {
+        auto it = owners.find(var);
+        if (it == owners.end()) continue;
+        for (const VarNode* sto : it->second) storages[sto].plannable = false;
+      }
+      for (const VarNode* var : uses.captured) {
+        auto it = owners.find(var);
+        if (it == owners.end()) continue;
+        for (const VarNode* sto : it->second) storages[sto].plannable = false;
+      }
+    }
+
+    // Assign the plannable storages of each device to slots in definition order.
+    std::map<std::pair<int, int>, std::vector<const VarNode*>> by_device;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      auto it = storages.find(bindings[i].first.get());
+      if (it == storages.end() || !it->second.plannable) continue;
+      const Device& dev = it->second.device;
+      by_device[{dev.device_type, dev.device_id}].push_back(it->first);
+    }
+    std::unordered_map<const VarNode*, Arena> arenas;
+    // The planned storages, mapped to the first storage of their group.
+    std::unordered_map<const VarNode*, const VarNode*> arena_of;
+    std::unordered_map<const VarNode*, int64_t> offsets;
+    for (auto& kv : by_device) {
+      const std::vector<const VarNode*>& group = kv.second;
+      if (group.size() < 2) continue;
+      Arena arena = AssignSlots(group, &storages);
+      for (const VarNode* sto : group) {
+        offsets[sto] = arena.slot_offsets[storages[sto].slot];
+      }
+      arenas.emplace(group.front(), arena);
+      for (const VarNode* sto : group) arena_of[sto] = group.front();
+    }
+    if (arenas.empty()) return Rebuild(bindings, body);
+
+    std::vector<std::pair<Var, Expr>> planned;
+    std::unordered_map<const VarNode*, Var> arena_vars;
+    for (const auto& binding : bindings) {
+      const VarNode* var = binding.first.get();
+      auto arena_it = arena_of.find(var);
+      if (arena_it != arena_of.end()) {
+        // The first storage of a group is replaced by the arena, the others are dropped.
+        if (arena_it->second == var) {
+          const Arena& arena = arenas.at(var);
+          const StorageInfo& info = storages.at(var);
+          Var arena_var("arena", Type(nullptr));
+          arena_vars[var] = arena_var;
+          planned.emplace_back(
+              arena_var, AllocStorage(MakeConstantScalar(DataType::Int(64), arena.size),
+                                      MakeConstantScalar(DataType::Int(64), arena.alignment),
+                                      info.device, arena.dtype_hint));
+        }
+        continue;
+      }
+      const auto* call = binding.second.as<CallNode>();
+      if (call != nullptr && call->op == alloc_tensor) {
+        const auto* sto = call->args[0].as<VarNode>();
+        if (sto != nullptr && arena_of.count(sto)) {
+          int64_t offset = 0;
+          GetConstInt64(call->args[1], &offset);
+          Var arena_var = arena_vars.at(arena_of.at(sto));
+          Expr new_offset = MakeConstantScalar(DataType::Int(64), offsets.at(sto) + offset);
+          planned.emplace_back(binding.first,
+                               Call(call->op, {arena_var, new_offset, call->args[2]}, call->attrs,
+                                    call->type_args, call->span));
+          continue;
+        }
+      }
+      planned.push_back(binding);
+    }
+    return Rebuild(planned, body);
+  }
+
+  /*! \brief The layout of the arena of one device. */
+  struct Arena {
+    int64_t size{0};
+    int64_t alignment{0};
+    DataType dtype_hint;
+    std::vector<int64_t> slot_offsets;
+  };
+
+  static int64_t AlignUp(int64_t value, int64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  /*!
+   * \brief Give each storage a slot, reusing the slots of dead storages. Like
+   *  graph_plan_memory, pick the smallest free slot that fits, otherwise grow the
+   *  largest free slot, otherwise open a new one.
+   */
+  static Arena AssignSlots(const std::vector<const VarNode*>& group,
+                           std::unordered_map<const VarNode*, StorageInfo>* storages) {
+    Arena arena;
+    arena.dtype_hint = storages->at(group.front()).dtype_hint;
+    std::vector<int64_t> slot_sizes;
+    // Slots in use, with the last use of their current owner.
+    std::vector<std::pair<size_t, size_t>> active;
+    std::vector<size_t> free_slots;
+    for (const VarNode* sto : group) {
+      StorageInfo& info = storages->at(sto);
+      arena.alignment = std::max(arena.alignment, info.alignment);
+      if (info.dtype_hint != arena.dtype_hint) arena.dtype_hint = DataType::UInt(8);
+      for (auto it = active.begin(); it != active.end();) {
+        if (it->first < info.def) {
+          free_slots.push_back(it->second);
+          it = active.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      auto best = free_slots.end();
+      auto largest = free_slots.end();
+      for (auto it = free_slots.begin(); it != free_slots.end(); ++it) {
+        int64_t slot_size = slot_sizes[*it];
+        if (slot_size >= info.size && (best == free_slots.end() || slot_size < slot_sizes[*best])) {
+          best = it;
+        }
+        if (largest == free_slots.end() || slot_size > slot_sizes[*largest]) largest = it;
+      }
+      auto chosen = best != free_slots.end() ? best : largest;
+      if (chosen != free_slots.end()) {
+        info.slot = *chosen;
+        free_slots.erase(chosen);
+        slot_sizes[info.slot] = std::max(slot_sizes[info.slot], info.size);
+      } else {
+        info.slot = slot_sizes.size();
+        slot_sizes.push_back(info.size);
+      }
+      active.emplace_back(info.last_use, info.slot);
+    }
+    for (int64_t slot_size : slot_sizes) {
+      arena.slot_offsets.push_back(arena.size);
+      arena.size += AlignUp(slot_size, arena.alignment);
+    }
+    return arena;
+  }
+
+  static Expr Rebuild(const std::vector<std::pair<Var, Expr>>& bindings, const Expr& body) {
+    Expr ret = body;
+    for (auto it = bindings.rbegin(); it != bindings.rend(); ++it) {
+      ret = Let(it->first, it->second, ret);
+    }
+    return ret;
+  }
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass PlanStaticMemory() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(StaticMemoryPlanner().Mutate(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "PlanStaticMemory", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.PlanStaticMemory").set_body_typed(PlanStaticMemory);
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.vm.plan_static_memory", Bool);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -0,0 +1,444 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/transforms/rematerialize.cc
+ * \brief Recompute the intermediates kept alive across a dataflow graph, e.g. the forward
+ *  activations read by a backward pass, to bound the memory live at once.
+ *
+ *  The graph is walked in the post-DFS order graph_plan_memory allocates in, an intermediate
+ *  being live from its call to its last use. While the bytes live at the peak exceed the budget,
+ *  the intermediate live across the peak but not read there which frees the most bytes per unit of
+ *  recomputation is picked: its uses after the peak read a copy of its call instead, made from the
+ *  tensors live at that point, or from copies of their own calls when they are dead. The others
+ *  stay checkpointed. The cost of a call is its multiply-accumulates, from the FMacCount of
+ *  mac_count.cc, plus its output elements.
+ *
+ *  The bytes come from the checked types, an intermediate of dynamic shape is never recomputed.
+ *  The functions with bindings, conditions or closures are left untouched.
+ */
+#include <tvm/relay/attrs/annotation.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relay {
+
+namespace {
+
+/*! \brief The bytes of a tensor or tuple type, -1 if a shape is not constant. */
+int64_t TypeBytes(const Type& type) {
+  if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+    int64_t bytes = (tensor_type->dtype.bits() * tensor_type->dtype.lanes() + 7) / 8;
+    for (const PrimExpr& dim : tensor_type->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return -1;
+      bytes *= imm->value;
+    }
+    return bytes;
+  } else if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+    int64_t bytes = 0;
+    for (const Type& field : tuple_type->fields) {
+      int64_t field_bytes = TypeBytes(field);
+      if (field_bytes < 0) return -1;
+      bytes += field_bytes;
+    }
+    return bytes;
+  }
+  return -1;
+}
+
+/*! \brief The number of elements of a tensor or tuple type, 0 if a shape is not constant. */
+int64_t TypeElements(const Type& type) {
+  int64_t elements = 0;
+  if (const auto* tensor_type = type.as<TensorTypeNode>()) {
+    elements = 1;
+    for (const PrimExpr& dim : tensor_type->shape) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return 0;
+      elements *= imm->value;
+    }
+  } else if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+    for (const Type& field : tuple_type->fields) {
+      elements += TypeElements(field);
+    }
+  }
+  return elements;
+}
+
+/*! \brief The multiply-accumulates of the calls of an expression, not looking into the args. */
+class CallCost : public ExprVisitor {
+ public:
+  static int64_t Get(const Call& call) {
+    CallCost visitor;
+    if (call->op.as<FunctionNode>()) {
+      visitor.VisitExpr(call->op);
+    } else {
+      visitor.Count(call);
+    }
+    return visitor.macs_ + TypeElements(call->checked_type());
+  }
+
+ private:
+  void VisitExpr_(const CallNode* op) final {
+    Count(GetRef<Call>(op));
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void Count(const Call& call) {
+    static const auto& fmac = Op::GetAttrMap<runtime::TypedPackedFunc<int64_t(const Call&)>>(
+        "FMacCount");
+    if (const auto* op = call->op.as<OpNode>()) {
+      auto f = fmac.get(GetRef<Op>(op), nullptr);
+      if (f != nullptr) macs_ += f(call);
+    }
+  }
+
+  int64_t macs_{0};
+};
+
+/*! \brief The calls of a dataflow graph in post-DFS order, with their uses. */
+class CallGraph : public ExprVisitor {
+ public:
+  struct Node {
+    const CallNode* call;
+    /*! \brief The bytes of the output, -1 when not constant. */
+    int64_t bytes;
+    /*! \brief The indices of the calls producing the args. */
+    std::vector<int> inputs;
+    /*! \brief The indices of the calls reading the output. */
+    std::vector<int> uses;
+    /*! \brief Whether the output is one of the function. */
+    bool is_output{false};
+    /*! \brief The index of the last call reading the output, the end for an output. */
+    int last_use;
+  };
+
+  /*! \brief Build the graph of a function, false if the function is not a dataflow graph. */
+  bool Build(const Function& func) {
+    VisitExpr(func->body);
+    if (!supported_) return false;
+    std::vector<int> outputs;
+    Producers(func->body, &outputs);
+    for (int index : outputs) {
+      nodes[index].is_output = true;
+    }
+    for (Node& node : nodes) {
+      node.last_use = node.is_output ? static_cast<int>(nodes.size()) : IndexOf(node.call);
+      for (int use : node.uses) {
+        node.last_use = std::max(node.last_use, use);
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The index of a call in the graph. */
+  int IndexOf(const CallNode* call) const { return index_.at(call); }
+
+  /*! \brief Collect the calls a value is the output of, through tuples. */
+  void Producers(const Expr& expr, std::vector<int>* out) const {
+    if (const auto* call = expr.as<CallNode>()) {
+      out->push_back(IndexOf(call));
+    } else if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        Producers(field, out);
+      }
+    } else if (const auto* get_item = expr.as<TupleGetItemNode>()) {
+      Producers(get_item->tuple, out);
+    }
+  }
+
+  std::vector<Node> nodes;
+
+ private:
+  void VisitExpr_(const CallNode* op) final {
+    for (const Expr& arg : op->args) {
+      VisitExpr(arg);
+    }
+    Node node;
+    node.call = op;
+    node.bytes = TypeBytes(op->checked_type());
+    for (const Expr& arg : op->args) {
+      Producers(arg, &node.inputs);
+    }
+    int index = static_cast<int>(nodes.size());
+    for (int input : node.inputs) {
+      nodes[input].uses.push_back(index);
+    }
+    index_[op] = index;
+    nodes.push_back(node);
+  }
+
+  void VisitExpr_(const FunctionNode* op) final {
+    // The primitive functions called are not part of the graph.
+  }
+
+  void VisitExpr_(const LetNode* op) final { supported_ = false; }
+  void VisitExpr_(const IfNode* op) final { supported_ = false; }
+  void VisitExpr_(const MatchNode* op) final { supported_ = false; }
+  void VisitExpr_(const RefCreateNode* op) final { supported_ = false; }
+
+  std::unordered_map<const CallNode*, int> index_;
+  bool supported_{true};
+};
+
+/*! \brief Make the uses of a call after the peak read a recomputation of it. */
+class Redirector : public ExprMutator {
+ public:
+  Redirector(const CallGraph& graph, int target, const std::unordered_set<int>& recomputed,
+             int peak)
+      : graph_(graph), target_(target), recomputed_(recomputed), peak_(peak) {}
+
+  Expr VisitExpr(const Expr& expr) final {
+    Expr ret = ExprMutator::VisitExpr(expr);
+    // Keep the types for the next round of analysis.
+    if (!ret->checked_type_.defined()) {
+      ret->checked_type_ = expr->checked_type_;
+    }
+    return ret;
+  }
+
+  Expr VisitExpr_(const CallNode* op) final {
+    if (graph_.IndexOf(op) <= peak_) {
+      return ExprMutator::VisitExpr_(op);
+    }
+    const auto& inputs = graph_.nodes[graph_.IndexOf(op)].inputs;
+    if (std::find(inputs.begin(), inputs.end(), target_) == inputs.end()) {
+      return ExprMutator::VisitExpr_(op);
+    }
+    Array<Expr> args;
+    for (const Expr& arg : op->args) {
+      args.push_back(Redirect(arg));
+    }
+    Call call(VisitExpr(op->op), args, op->attrs, op->type_args, op->span);
+    call->checked_type_ = op->checked_type_;
+    return std::move(call);
+  }
+
+  Expr VisitExpr_(const FunctionNode* op) final {
+    // The primitive functions called are left as they are.
+    return GetRef<Function>(op);
+  }
+
+ private:
+  /*! \brief Mutate an arg of a call after the peak, reading the copies. */
+  Expr Redirect(const Expr& arg) {
+    if (const auto* call = arg.as<CallNode>()) {
+      int index = graph_.IndexOf(call);
+      return index == target_ ? Recompute(index) : VisitExpr(arg);
+    } else if (const auto* tuple = arg.as<TupleNode>()) {
+      Array<Expr> fields;
+      for (const Expr& field : tuple->fields) {
+        fields.push_back(Redirect(field));
+      }
+      Tuple ret(fields, tuple->span);
+      ret->checked_type_ = tuple->checked_type_;
+      return std::move(ret);
+    } else if (const auto* get_item = arg.as<TupleGetItemNode>()) {
+      TupleGetItem ret(Redirect(get_item->tuple), get_item->index, get_item->span);
+      ret->checked_type_ = get_item->checked_type_;
+      return std::move(ret);
+    }
+    return VisitExpr(arg);
+  }
+
+  /*! \brief The copy of a call, reading the copies of the dead inputs. */
+  Expr Recompute(int index) {
+    auto it = copies_.find(index);
+    if (it != copies_.end()) return it->second;
+    const CallNode* op = graph_.nodes[index].call;
+    Array<Expr> args;
+    for (const Expr& arg : op->args) {
+      args.push_back(CopyArg(arg));
+    }
+    Call call(VisitExpr(op->op), args, op->attrs, op->type_args, op->span);
+    call->checked_type_ = op->checked_type_;
+    copies_[index] = call;
+    return std::move(call);
+  }
+
+  Expr CopyArg(const Expr& arg) {
+    if (const auto* call = arg.as<CallNode>()) {
+      int index = graph_.IndexOf(call);
+      return recomputed_.count(index) ? Recompute(index) : VisitExpr(arg);
+    } else if (const auto* tuple = arg.as<TupleNode>()) {
+      Array<Expr> fields;
+      for (const Expr& field : tuple->fields) {
+        fields.push_back(CopyArg(field));
+      }
+      Tuple ret(fields, tuple->span);
+      ret->checked_type_ = tuple->checked_type_;
+      return std::move(ret);
+    } else if (const auto* get_item = arg.as<TupleGetItemNode>()) {
+      TupleGetItem ret(CopyArg(get_item->tuple), get_item->index, get_item->span);
+      ret->checked_type_ = get_item->checked_type_;
+      return std::move(ret);
+    }
+    return VisitExpr(arg);
+  }
+
+  const CallGraph& graph_;
+  int target_;
+  const std::unordered_set<int>& recomputed_;
+  int peak_;
+  std::unordered_map<int, Expr> copies_;
+};
+
+class Rematerializer {
+ public:
+  explicit Rematerializer(int64_t memory_budget) : memory_budget_(memory_budget) {}
+
+  Function Run(Function func) {
+    CallGraph graph;
+    if (!graph.Build(func)) return func;
+    int peak;
+    int64_t peak_bytes = PeakBytes(graph, &peak);
+    // Every round recomputes an intermediate live at the peak, as long as the peak goes down.
+    while (peak_bytes > memory_budget_) {
+      std::unordered_set<int> recomputed;
+      int target = PickTarget(graph, peak, &recomputed);
+      if (target < 0) break;
+      Redirector redirector(graph, target, recomputed, peak);
+      Function updated = Function(func->params, redirector.Mutate(func->body), func->ret_type,
+                                  func->type_params, func->attrs, func->span);
+      CallGraph updated_graph;
+      ICHECK(updated_graph.Build(updated));
+      int updated_peak;
+      int64_t updated_peak_bytes = PeakBytes(updated_graph, &updated_peak);
+      if (updated_peak_bytes >= peak_bytes) break;
+      func = updated;
+      graph = std::move(updated_graph);
+      peak = updated_peak;
+      peak_bytes = updated_peak_bytes;
+    }
+    return func;
+  }
+
+ private:
+  /*!
+   * \brief The bytes of the intermediates live at the peak, each from its call to its last use.
+   * \param peak The index of the call at the peak.
+   */
+  static int64_t PeakBytes(const CallGraph& graph, int* peak) {
+    int num_nodes = static_cast<int>(graph.nodes.size());
+    std::vector<int64_t> delta(num_nodes + 2, 0);
+    for (int i = 0; i < num_nodes; ++i) {
+      const auto& node = graph.nodes[i];
+      int64_t bytes = std::max<int64_t>(node.bytes, 0);
+      delta[i] += bytes;
+      delta[node.last_use + 1] -= bytes;
+    }
+    int64_t live = 0;
+    int64_t peak_bytes = 0;
+    *peak = 0;
+    for (int i = 0; i < num_nodes; ++i) {
+      live += delta[i];
+      if (live > peak_bytes) {
+        peak_bytes = live;
+        *peak = i;
+      }
+    }
+    return peak_bytes;
+  }
+
+  /*!
+   * \brief Collect the calls to recompute for a call read at a given index: the call, and the
+   *  calls of its inputs not live there, recursively.
+   * \return Whether the copies are few enough.
+   */
+  bool CollectRecompute(const CallGraph& graph, int index, int read_at,
+                        std::unordered_set<int>* recomputed, int64_t* cost) {
+    if (recomputed->count(index)) return true;
+    if (recomputed->size() >= kMaxRecomputedCalls) return false;
+    const auto& node = graph.nodes[index];
+    if (node.bytes < 0) return false;
+    recomputed->insert(index);
+    *cost += CallCost::Get(GetRef<Call>(node.call));
+    for (int input : node.inputs) {
+      if (graph.nodes[input].last_use < read_at &&
+          !CollectRecompute(graph, input, read_at, recomputed, cost)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Pick the intermediate to recompute after the peak.
+   * \param recomputed The calls to recompute for it.
+   * \return The index of its call, -1 if there is none.
+   */
+  int PickTarget(const CallGraph& graph, int peak, std::unordered_set<int>* recomputed) {
+    int target = -1;
+    double best_score = 0;
+    for (int i = 0; i < peak; ++i) {
+      const auto& node = graph.nodes[i];
+      if (node.is_output || node.bytes <= 0 || node.last_use <= peak) continue;
+      int first_late_use = node.last_use;
+      bool read_at_peak = false;
+      for (int use : node.uses) {
+        if (use == peak) read_at_peak = true;
+        if (use > peak) first_late_use = std::min(first_late_use, use);
+      }
+      if (read_at_peak) continue;
+      std::unordered_set<int> calls;
+      int64_t cost = 0;
+      if (!CollectRecompute(graph, i, first_late_use, &calls, &cost)) continue;
+      double score = static_cast<double>(node.bytes) / static_cast<double>(cost + 1);
+      if (score > best_score) {
+        best_score = score;
+        target = i;
+        *recomputed = std::move(calls);
+      }
+    }
+    return target;
+  }
+
+  /*! \brief The most calls recomputed for an intermediate. */
+  static constexpr size_t kMaxRecomputedCalls = 16;
+
+  int64_t memory_budget_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass Rematerialize(int64_t memory_budget) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        if (f->HasNonzeroAttr(attr::kPrimitive)) return f;
+        return Rematerializer(memory_budget).Run(f);
+      };
+  return CreateFunctionPass(pass_func, 0, "Rematerialize", {"InferType"});
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.Rematerialize").set_body_typed(Rematerialize);
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.remat_memory_budget", Integer);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
@@ -138,6 +138,24 @@ Expr LayerNormToInferUnpack(const Attrs attrs, Expr data, Expr gamma, Expr beta,
   return out;
 }
 
+Expr RMSNormToInferUnpack(const Attrs attrs, Expr data, Expr gamma, Type tdata) {
+  auto ttype = tdata.as<TensorTypeNode>();
+  ICHECK(ttype);
+  const auto param = attrs.as<RMSNormAttrs>();
+  ICHECK(param);
+
+  Expr epsilon = MakeConstantScalar(ttype->dtype, static_cast<float>(param->epsilon));
+  Expr mean_square = Mean(Multiply(data, data), {param->axis}, true, false);
+  Expr out = Divide(data, Sqrt(Add(mean_square, epsilon)));
+
+  size_t ndim = ttype->shape.size();
+  int axis = (param->axis < 0) ? param->axis + ndim : param->axis;
+  if (param->scale) {
+    out = Multiply(out, ExpandBiasToMatchAxis(gamma, ndim, {axis}));
+  }
+  return out;
+}
+
 Expr InstanceNormToInferUnpack(const Attrs attrs, Expr data, Expr gamma, Expr beta, Type tdata) {
   auto ttype = tdata.as<TensorTypeNode>();
   ICHECK(ttype);
@@ -180,13 +198,15 @@ Expr L2NormToInferUnpack(const Attrs attrs, Expr data) {
 
 class InferenceSimplifier : public MixedModeMutator {
  public:
-  InferenceSimplifier()
+  explicit InferenceSimplifier(bool keep_norm)
       : batch_norm_op_(Op::Get("nn.batch_norm")),
         dropout_op_(Op::Get("nn.dropout")),
         instance_norm_op_(Op::Get("nn.instance_norm")),
         layer_norm_op_(Op::Get("nn.layer_norm")),
+        rms_norm_op_(Op::Get("nn.rms_norm")),
         group_norm_op_(Op::Get("nn.group_norm")),
-        l2_norm_op_(Op::Get("nn.l2_normalize")) {}
+        l2_norm_op_(Op::Get("nn.l2_normalize")),
+        keep_norm_(keep_norm) {}
 
   Expr Rewrite_(const TupleGetItemNode* n, const Expr& new_e) final {
     const auto* new_n = new_e.as<TupleGetItemNode>();
@@ -207,10 +227,14 @@ class InferenceSimplifier : public MixedModeMutator {
   Expr Rewrite_(const CallNode* n, const Expr& new_n) {
     if (n->op == batch_norm_op_) {
       ty_map_[new_n.as<CallNode>()->args[0]] = n->args[0]->checked_type();
-    } else if (n->op == layer_norm_op_) {
+    } else if (n->op == layer_norm_op_ && !keep_norm_) {
       const auto* call = new_n.as<CallNode>();
       return LayerNormToInferUnpack(call->attrs, call->args[0], call->args[1], call->args[2],
                                     n->args[0]->checked_type());
+    } else if (n->op == rms_norm_op_ && !keep_norm_) {
+      const auto* call = new_n.as<CallNode>();
+      return RMSNormToInferUnpack(call->attrs, call->args[0], call->args[1],
+                                  n->args[0]->checked_type());
     } else if (n->op == group_norm_op_) {
       const auto* call = new_n.as<CallNode>();
       return GroupNormToInferUnpack(call->attrs, call->args[0], call->args[1], call->args[2],
@@ -234,19 +258,27 @@ class InferenceSimplifier : public MixedModeMutator {
   const Op& dropout_op_;
   const Op& instance_norm_op_;
   const Op& layer_norm_op_;
+  const Op& rms_norm_op_;
   const Op& group_norm_op_;
   const Op& l2_norm_op_;
+  // Whether layer_norm and rms_norm are kept for their fused kernels.
+  bool keep_norm_;
   std::unordered_map<Expr, Type, ObjectPtrHash, ObjectPtrEqual> ty_map_;
 };
 
-Expr SimplifyInference(const Expr& e) { return InferenceSimplifier().Mutate(e); }
+Expr SimplifyInference(const Expr& e, bool keep_norm) {
+  return InferenceSimplifier(keep_norm).Mutate(e);
+}
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.SimplifyInference.keep_norm", Bool);
+
 Pass SimplifyInference() {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(SimplifyInference(f));
+        bool keep_norm = pc->GetConfig("relay.SimplifyInference.keep_norm", Bool(false)).value();
+        return Downcast<Function>(SimplifyInference(f, keep_norm));
       };
   return CreateFunctionPass(pass_func, 0, "SimplifyInference", {"InferType"});
 }
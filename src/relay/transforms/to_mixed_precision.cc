@@ -92,6 +92,8 @@ using FTVMMixedPrecisionConversionType = runtime::TypedPackedFunc<Array<ObjectRe
  *         describe whether a larger dtype is used to accumulate the results
  *         of the operation. The output_dtype meanwhile describes the dtype
  *         most Ops should use from this accumulator.
+ *      4) The category of a call can be overridden, e.g. by the automatic
+ *         search keeping the calls hurting the accuracy in FP32.
  */
 class MixedPrecisionPass : public MixedModeMutator {
  private:
@@ -106,6 +108,9 @@ class MixedPrecisionPass : public MixedModeMutator {
    */
   std::unordered_map<std::string, int> missing_ops_;
 
+  /*! \brief The calls converted with another category than the one of their op. */
+  Map<Expr, Integer> call_categories_;
+
   Attrs GetNewAttrs(const CallNode* call, const DataType& accumulation_dtype) const {
     /* If the accumulation dtype is in the attributes make a copy and mutate the field. */
     Attrs cur_attrs = call->attrs;
@@ -272,8 +277,11 @@ class MixedPrecisionPass : public MixedModeMutator {
  public:
   using MixedModeMutator::VisitExpr_;
 
-  explicit MixedPrecisionPass(DataType mixed_precision_type = DataType::Float(16))
-      : MixedModeMutator(), mixed_precision_type_(mixed_precision_type) {
+  explicit MixedPrecisionPass(DataType mixed_precision_type = DataType::Float(16),
+                              Map<Expr, Integer> call_categories = {})
+      : MixedModeMutator(),
+        mixed_precision_type_(mixed_precision_type),
+        call_categories_(call_categories) {
     if (!mixed_precision_type_.is_float() && !mixed_precision_type_.is_bfloat16()) {
       LOG(FATAL) << "Only support IEEE floating point mixed precision types and bfloat16, but got "
                  << mixed_precision_type_;
@@ -330,6 +338,13 @@ class MixedPrecisionPass : public MixedModeMutator {
     } else {
       LOG(FATAL) << "Unsupported op type in CallNode: " << pre_call_node->op;
     }
+    auto it = call_categories_.find(GetRef<Call>(pre_call_node));
+    if (it != call_categories_.end() && cur_op.as<OpNode>()) {
+      ICHECK((*it).second->value >= MIXED_PRECISION_ALWAYS &&
+             (*it).second->value <= MIXED_PRECISION_NEVER)
+          << "Unknown conversion category " << (*it).second << " of " << (*it).first;
+      initial_category = static_cast<MixedTypeConversionCategory>((*it).second->value);
+    }
 
     // First check if all the new mutated args are in lower precision form
     Array<Type> cur_arg_types;
@@ -404,10 +419,11 @@ class MixedPrecisionPass : public MixedModeMutator {
 
   // To access map of ops not registered for error reporting
   friend Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type,
-                               int missing_op_mode);
+                               int missing_op_mode, const Map<Expr, Integer>& call_categories);
 };
 
-Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode) {
+Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, int missing_op_mode,
+                      const Map<Expr, Integer>& call_categories) {
   /*
   missing_op_mode:
 
@@ -418,7 +434,7 @@ Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, in
   ICHECK(missing_op_mode >= 0 && missing_op_mode <= 2)
       << " missing_op_mode must be either 0, 1, or 2 got " << missing_op_mode;
 
-  MixedPrecisionPass converter = MixedPrecisionPass(mixed_precision_type);
+  MixedPrecisionPass converter = MixedPrecisionPass(mixed_precision_type, call_categories);
   auto result = converter.Mutate(expr);
 
   for (auto it = converter.missing_ops_.begin();
@@ -439,10 +455,12 @@ Expr ToMixedPrecision(const Expr& expr, const DataType& mixed_precision_type, in
 
 namespace transform {
 
-Pass ToMixedPrecision(DataType mixed_precision_type, int missing_op_mode) {
+Pass ToMixedPrecision(DataType mixed_precision_type, int missing_op_mode,
+                      Map<Expr, Integer> call_categories) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, mixed_precision_type, missing_op_mode));
+        return Downcast<Function>(
+            ToMixedPrecision(f, mixed_precision_type, missing_op_mode, call_categories));
       };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
@@ -0,0 +1,305 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ *
+ * \file src/relay/transforms/to_streaming.cc
+ * \brief Rewrite a model over a time axis into one computing only the new frames of a stream.
+ *
+ * The first input of main becomes a chunk of `hop` new frames. The ops with a receptive
+ * field along the time axis (conv1d, max_pool1d, avg_pool1d) keep the last frames they read
+ * in a state: each of them reads its state concatenated with the new frames, without padding,
+ * and returns the tail of what it read as the next state.
+ *
+ *   %1 = nn.conv1d(%x, %w, padding=[2, 0]);  ==>  %0 = concatenate((%stream_state_0, %x), axis=2);
+ *                                                %1 = nn.conv1d(%0, %w, padding=[0, 0]);
+ *                                                (%1, strided_slice(%0, begin=[hop], axes=[2]))
+ *
+ * The states are extra inputs of main, named stream_state_<i>, and the new states are
+ * returned after the original result. The states start as zeros, which matches the left
+ * padding of the convolutions of a causal model. The graph executor carries them from
+ * one run to the next with GraphModule.link_output.
+ */
+
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr_functor.h>
+#include <tvm/relay/op_attr_types.h>
+#include <tvm/relay/transform.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../op/make_op.h"
+
+namespace tvm {
+namespace relay {
+
+/*! \brief The number of frames of the stream a call reads to compute its new frames. */
+struct TemporalWindow {
+  /*! \brief The extent of the receptive field, dilation included. */
+  int64_t extent;
+  /*! \brief The stride along the time axis. */
+  int64_t stride;
+  /*! \brief The left padding of the offline op. */
+  int64_t pad_left;
+  /*! \brief The right padding of the offline op. */
+  int64_t pad_right;
+};
+
+class StreamingRewriter : public ExprMutator {
+ public:
+  StreamingRewriter(int64_t hop, int time_axis) : hop_(hop), time_axis_(time_axis) {}
+
+  Function Rewrite(const Function& func) {
+    ICHECK(!func->params.empty()) << "ToStreaming needs the stream as the first input of main";
+    const Var& input = func->params[0];
+    const auto* input_type = input->checked_type().as<TensorTypeNode>();
+    ICHECK(input_type) << "The stream input of main must be a tensor";
+    rank_ = input_type->shape.size();
+    ICHECK(time_axis_ >= 0 && time_axis_ < rank_)
+        << "The time axis " << time_axis_ << " is out of the rank of the stream input";
+    Var chunk(input->name_hint(), WithTimeExtent(input_type, hop_));
+    memo_[input] = chunk;
+    hops_[chunk] = hop_;
+
+    Expr body = VisitExpr(func->body);
+    Array<Expr> fields;
+    if (const auto* tuple = body.as<TupleNode>()) {
+      fields = tuple->fields;
+    } else {
+      fields.push_back(body);
+    }
+    for (const Expr& field : fields) {
+      ICHECK(hops_.count(field)) << "The outputs of main must be computed from the stream";
+    }
+    for (const Expr& state : new_states_) {
+      fields.push_back(state);
+    }
+
+    Array<Var> params{chunk};
+    for (size_t i = 1; i < func->params.size(); ++i) {
+      params.push_back(func->params[i]);
+    }
+    for (const Var& state : states_) {
+      params.push_back(state);
+    }
+    return Function(params, Tuple(fields), Type(), func->type_params, func->attrs, func->span);
+  }
+
+  Expr VisitExpr_(const CallNode* call_node) final {
+    Expr new_expr = ExprMutator::VisitExpr_(call_node);
+    const auto* call = new_expr.as<CallNode>();
+    int64_t hop = -1;
+    for (const Expr& arg : call->args) {
+      ICHECK(!stream_tuples_.count(arg))
+          << "ToStreaming does not support tuples of streams as operands of " << call->op;
+      auto it = hops_.find(arg);
+      if (it == hops_.end()) continue;
+      ICHECK(hop == -1 || hop == it->second)
+          << "ToStreaming cannot combine streams of different rates in " << call->op;
+      hop = it->second;
+    }
+    if (hop == -1) return new_expr;
+
+    const auto* op = call->op.as<OpNode>();
+    ICHECK(op) << "ToStreaming only supports calls to operators on the stream, got "
+               << call->op;
+    static const Op& conv1d_op = Op::Get("nn.conv1d");
+    static const Op& max_pool1d_op = Op::Get("nn.max_pool1d");
+    static const Op& avg_pool1d_op = Op::Get("nn.avg_pool1d");
+    static const Op& bias_add_op = Op::Get("nn.bias_add");
+    static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+
+    if (call->op == conv1d_op || call->op == max_pool1d_op || call->op == avg_pool1d_op) {
+      ICHECK(hops_.count(call->args[0]) && (call->args.size() == 1 || !hops_.count(call->args[1])))
+          << "Only the data of " << call->op << " can be streamed";
+      return RewriteTemporal(GetRef<Call>(call_node), call, hop);
+    }
+    ICHECK(fpattern.get(call->op, kOpaque) <= kBroadcast)
+        << "ToStreaming does not know how " << call->op << " depends on the time axis";
+    const auto* out_type = call_node->checked_type().as<TensorTypeNode>();
+    ICHECK(out_type && static_cast<int>(out_type->shape.size()) == rank_)
+        << call->op << " on the stream must keep the rank of the stream";
+    if (call->op == bias_add_op) {
+      const auto* attrs = call->attrs.as<BiasAddAttrs>();
+      int axis = attrs->axis < 0 ? attrs->axis + rank_ : attrs->axis;
+      ICHECK_NE(axis, time_axis_) << "nn.bias_add on the stream cannot add along the time axis";
+    } else {
+      // The other operands are broadcast along the time axis.
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        if (hops_.count(call->args[i])) continue;
+        const auto* arg_type = call_node->args[i]->checked_type().as<TensorTypeNode>();
+        ICHECK(arg_type) << "The operands of " << call->op << " must be tensors";
+        int axis = time_axis_ - (rank_ - static_cast<int>(arg_type->shape.size()));
+        if (axis < 0) continue;
+        const auto* extent = arg_type->shape[axis].as<IntImmNode>();
+        ICHECK(extent && extent->value == 1)
+            << "The operands of " << call->op
+            << " which are not streamed must be broadcast along the time axis";
+      }
+    }
+    hops_[new_expr] = hop;
+    return new_expr;
+  }
+
+  Expr VisitExpr_(const TupleNode* op) final {
+    Expr new_expr = ExprMutator::VisitExpr_(op);
+    for (const Expr& field : new_expr.as<TupleNode>()->fields) {
+      if (hops_.count(field)) stream_tuples_.insert(new_expr);
+    }
+    return new_expr;
+  }
+
+  Expr VisitExpr_(const TupleGetItemNode* op) final {
+    Expr new_expr = ExprMutator::VisitExpr_(op);
+    ICHECK(!stream_tuples_.count(new_expr.as<TupleGetItemNode>()->tuple))
+        << "ToStreaming does not support tuples of streams";
+    return new_expr;
+  }
+
+ private:
+  Type WithTimeExtent(const TensorTypeNode* type, int64_t extent) {
+    Array<PrimExpr> shape = type->shape;
+    shape.Set(time_axis_, Integer(extent));
+    return TensorType(shape, type->dtype);
+  }
+
+  template <typename T>
+  TemporalWindow PoolWindow(const T* attrs) {
+    ICHECK(!attrs->ceil_mode) << "ToStreaming does not support pools in ceil mode";
+    ICHECK_EQ(attrs->layout.find('W'), static_cast<size_t>(time_axis_))
+        << "The layout " << attrs->layout << " of the pool does not pool along the time axis";
+    TemporalWindow window;
+    window.extent = (GetInt(attrs->pool_size[0]) - 1) * GetInt(attrs->dilation[0]) + 1;
+    window.stride = GetInt(attrs->strides[0]);
+    window.pad_left = GetInt(attrs->padding[0]);
+    window.pad_right = GetInt(attrs->padding[attrs->padding.size() > 1 ? 1 : 0]);
+    return window;
+  }
+
+  static int64_t GetInt(const PrimExpr& expr) {
+    const auto* imm = expr.as<IntImmNode>();
+    ICHECK(imm) << "ToStreaming needs static attributes, got " << expr;
+    return imm->value;
+  }
+
+  Expr RewriteTemporal(const Call& orig, const CallNode* call, int64_t hop) {
+    TemporalWindow window;
+    Attrs attrs;
+    if (const auto* conv = call->attrs.as<Conv1DAttrs>()) {
+      ICHECK_EQ(conv->data_layout.find('W'), static_cast<size_t>(time_axis_))
+          << "The layout " << conv->data_layout
+          << " of the convolution does not convolve along the time axis";
+      const auto* weight_type = orig->args[1]->checked_type().as<TensorTypeNode>();
+      std::string kernel_layout = conv->kernel_layout;
+      window.extent = (GetInt(weight_type->shape[kernel_layout.find('W')]) - 1) *
+                          GetInt(conv->dilation[0]) +
+                      1;
+      window.stride = GetInt(conv->strides[0]);
+      window.pad_left = GetInt(conv->padding[0]);
+      window.pad_right = GetInt(conv->padding[conv->padding.size() > 1 ? 1 : 0]);
+      auto new_attrs = make_object<Conv1DAttrs>(*conv);
+      new_attrs->padding = {Integer(0), Integer(0)};
+      attrs = Attrs(new_attrs);
+    } else if (const auto* pool = call->attrs.as<MaxPool1DAttrs>()) {
+      window = PoolWindow(pool);
+      // The padding of max pools is not zero, the states only match it without history.
+      ICHECK_EQ(window.extent, window.stride)
+          << "ToStreaming only supports max pools whose windows do not overlap";
+      auto new_attrs = make_object<MaxPool1DAttrs>(*pool);
+      new_attrs->padding = {Integer(0), Integer(0)};
+      attrs = Attrs(new_attrs);
+    } else {
+      const auto* avg = call->attrs.as<AvgPool1DAttrs>();
+      ICHECK(avg);
+      window = PoolWindow(avg);
+      ICHECK(window.extent == window.stride || avg->count_include_pad)
+          << "ToStreaming only supports overlapping average pools which count the padding";
+      auto new_attrs = make_object<AvgPool1DAttrs>(*avg);
+      new_attrs->padding = {Integer(0), Integer(0)};
+      attrs = Attrs(new_attrs);
+    }
+
+    int64_t history = window.extent - window.stride;
+    ICHECK_GE(history, 0) << call->op << " skips frames of the stream, its stride "
+                          << window.stride << " is larger than its window " << window.extent;
+    ICHECK_EQ(hop % window.stride, 0)
+        << "The " << hop << " new frames of " << call->op << " are not a multiple of its stride "
+        << window.stride;
+    ICHECK(window.pad_right == 0 && window.pad_left == history)
+        << call->op << " must be causal to be streamed: its padding must be [" << history
+        << ", 0], got [" << window.pad_left << ", " << window.pad_right << "]";
+
+    Expr data = call->args[0];
+    if (history > 0) {
+      const auto* data_type = orig->args[0]->checked_type().as<TensorTypeNode>();
+      Var state("stream_state_" + std::to_string(states_.size()),
+                WithTimeExtent(data_type, history));
+      states_.push_back(state);
+      data = MakeConcatenate(Tuple({state, data}), time_axis_);
+      new_states_.push_back(MakeStridedSlice(data, {Integer(hop)}, {Integer(hop + history)},
+                                             {Integer(1)}, "end", Array<Integer>{time_axis_}));
+    }
+    Array<Expr> args = call->args;
+    args.Set(0, data);
+    Expr new_call = Call(call->op, args, attrs, call->type_args, call->span);
+    hops_[new_call] = hop / window.stride;
+    return new_call;
+  }
+
+  /*! \brief The number of new frames per call at the input. */
+  int64_t hop_;
+  /*! \brief The time axis of the stream. */
+  int time_axis_;
+  /*! \brief The rank of the stream. */
+  int rank_;
+  /*! \brief The number of new frames of each expression computed from the stream. */
+  std::unordered_map<Expr, int64_t, ObjectPtrHash, ObjectPtrEqual> hops_;
+  /*! \brief The tuples holding streams. */
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> stream_tuples_;
+  /*! \brief The state inputs. */
+  std::vector<Var> states_;
+  /*! \brief The next value of each state. */
+  std::vector<Expr> new_states_;
+};
+
+namespace transform {
+
+Pass ToStreaming(int hop, int time_axis) {
+  ICHECK_GT(hop, 0) << "The stream needs at least one new frame per call";
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    GlobalVar main = mod->GetGlobalVar("main");
+    Function func = Downcast<Function>(mod->Lookup(main));
+    mod->Update(main, StreamingRewriter(hop, time_axis).Rewrite(func));
+    return mod;
+  };
+  return tvm::transform::Sequential(
+      {CreateModulePass(pass_func, 0, "ToStreaming", {"InferType"}), InferType()}, "ToStreaming");
+}
+
+TVM_REGISTER_GLOBAL("relay._transform.ToStreaming").set_body_typed(ToStreaming);
+
+}  // namespace transform
+
+}  // namespace relay
+}  // namespace tvm
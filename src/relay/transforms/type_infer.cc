@@ -76,6 +76,24 @@ bool TupleGetItemRel(const Array<Type>& types, int num_inputs, const Attrs& attr
 TVM_REGISTER_NODE_TYPE(TupleGetItemAttrs);
 TVM_REGISTER_GLOBAL("tvm.relay.type_relation.TupleGetItem").set_body_typed(TupleGetItemRel);
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.InferType.incremental", Bool);
+
+/*! \brief Whether a type is fully inferred, i.e. it has no incomplete types and type vars */
+class ConcreteTypeChecker : public TypeVisitor {
+ public:
+  static bool Check(const Type& type) {
+    ConcreteTypeChecker checker;
+    checker.VisitType(type);
+    return checker.concrete_;
+  }
+
+ private:
+  void VisitType_(const IncompleteTypeNode* op) final { concrete_ = false; }
+  void VisitType_(const TypeVarNode* op) final { concrete_ = false; }
+
+  bool concrete_{true};
+};
+
 struct ResolvedTypeInfo {
   explicit ResolvedTypeInfo(Type checked_type, Array<Type> type_args)
       : checked_type(checked_type), type_args(type_args) {}
@@ -99,8 +117,15 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
  public:
   // constructors
 
-  explicit TypeInferencer(IRModule mod, DiagnosticContext diag_ctx)
-      : mod_(mod), diag_ctx(diag_ctx), solver_(GlobalVar(), diag_ctx) {
+  /*!
+   * \brief Constructor
+   * \param mod The module
+   * \param diag_ctx The diagnostic context
+   * \param incremental Whether to reuse the types of the dataflow subexpressions typed before,
+   *  so that only the regions rewritten since the last inference are solved.
+   */
+  explicit TypeInferencer(IRModule mod, DiagnosticContext diag_ctx, bool incremental = false)
+      : mod_(mod), diag_ctx(diag_ctx), solver_(GlobalVar(), diag_ctx), incremental_(incremental) {
     ICHECK(mod.defined()) << "Module must not be null in the type inferencer.";
   }
 
@@ -132,6 +157,13 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
   /*! \brief Internal map used for memoization. */
   std::unordered_map<Expr, Type, ObjectPtrHash, ObjectPtrEqual> memo_;
 
+  /*! \brief Whether to reuse the types of the subexpressions typed before */
+  bool incremental_;
+  /*! \brief Whether the types of the visited dataflow subexpressions can be reused */
+  std::unordered_map<const Object*, bool> typed_;
+  /*! \brief The outermost subexpressions whose types are reused, left as is by the Resolver */
+  std::vector<Expr> reused_;
+
   void VisitLeaf(const Expr& expr) {
     if (!memo_.count(expr)) {
       Type ret = this->DispatchVisitExpr(expr);
@@ -142,17 +174,79 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
   bool CheckVisited(const Expr& expr) {
     if (memo_.count(expr)) {
       return true;
+    } else if (IsTyped(expr)) {
+      memo_[expr] = expr->checked_type_;
+      reused_.push_back(expr);
+      return true;
     } else {
       return false;
     }
   }
 
+  /*!
+   * \brief Check whether the types of a subexpression, inferred by an earlier inference, can be
+   *  reused as they are.
+   *
+   *  This is the case of a dataflow subexpression, i.e. made of calls of operators, tuples, tuple
+   *  projections, constants and variables, whose nodes all have a concrete checked type, and whose
+   *  variables are annotated with their checked type. As the expressions are immutable, the types
+   *  of such a subexpression do not depend on the rest of the function; only the regions rewritten
+   *  since the last inference have to be solved again.
+   */
+  bool IsTyped(const Expr& expr) {
+    if (!incremental_) return false;
+    auto it = typed_.find(expr.get());
+    if (it != typed_.end()) return it->second;
+    // Check the unchecked subexpressions in post order, without recursion.
+    std::vector<std::pair<Expr, bool>> stack{{expr, false}};
+    std::vector<Expr> children;
+    while (!stack.empty()) {
+      Expr e = stack.back().first;
+      if (typed_.count(e.get())) {
+        stack.pop_back();
+        continue;
+      }
+      children.clear();
+      bool typed = e->checked_type_.defined() && ConcreteTypeChecker::Check(e->checked_type_);
+      if (typed) {
+        if (const auto* call = e.as<CallNode>()) {
+          typed = call->op.as<OpNode>() != nullptr;
+          for (const Expr& arg : call->args) children.push_back(arg);
+        } else if (const auto* tuple = e.as<TupleNode>()) {
+          for (const Expr& field : tuple->fields) children.push_back(field);
+        } else if (const auto* get = e.as<TupleGetItemNode>()) {
+          children.push_back(get->tuple);
+        } else if (const auto* var = e.as<VarNode>()) {
+          typed = var->type_annotation.defined() &&
+                  StructuralEqual()(var->type_annotation, var->checked_type_);
+        } else {
+          typed = e.as<ConstantNode>() != nullptr;
+        }
+      }
+      if (!typed || stack.back().second) {
+        for (const Expr& child : children) {
+          typed = typed && typed_.at(child.get());
+        }
+        typed_[e.get()] = typed;
+        stack.pop_back();
+        continue;
+      }
+      stack.back().second = true;
+      for (const Expr& child : children) {
+        if (!typed_.count(child.get())) {
+          stack.emplace_back(child, false);
+        }
+      }
+    }
+    return typed_.at(expr.get());
+  }
+
   Type DispatchVisitExpr(const Expr& expr) { return ExprFunctor::VisitExpr(expr); }
 
   Type VisitExpr(const Expr& expr) final {
     auto fcheck_visited = [this](const Expr& expr) { return this->CheckVisited(expr); };
     auto fvisit_leaf = [this](const Expr& expr) { return this->VisitLeaf(expr); };
-    if (memo_.count(expr)) {
+    if (CheckVisited(expr)) {
       return memo_[expr];
     } else {
       ExpandDataflow(expr, fcheck_visited, fvisit_leaf);
@@ -593,8 +687,13 @@ class TypeInferencer : private ExprFunctor<Type(const Expr&)>,
 class TypeInferencer::Resolver : public MixedModeMutator, PatternMutator {
  public:
   Resolver(const std::unordered_map<Expr, ResolvedTypeInfo, ObjectPtrHash, ObjectPtrEqual>& tmap,
-           TypeSolver* solver)
-      : tmap_(tmap), solver_(solver) {}
+           TypeSolver* solver, const std::vector<Expr>& reused = {})
+      : tmap_(tmap), solver_(solver) {
+    // The subexpressions whose types are reused keep their nodes.
+    for (const Expr& expr : reused) {
+      memo_[expr] = expr;
+    }
+  }
 
   using MixedModeMutator::VisitExpr_;
 
@@ -684,6 +783,12 @@ class TypeInferencer::Resolver : public MixedModeMutator, PatternMutator {
 
     // check if we need update the new_e
     bool need_update_type = !checked_type.same_as(new_e->checked_type_);
+    if (std::is_base_of<VarNode, T>::value && need_update_type &&
+        new_e->checked_type_.defined()) {
+      // Keep a variable typed before, which may still be referred to by the reused
+      // subexpressions.
+      need_update_type = !StructuralEqual()(checked_type, new_e->checked_type_);
+    }
     bool need_update_call =
         (std::is_base_of<CallNode, T>::value && it->second.type_args.defined() &&
          !it->second.type_args.same_as(new_call->type_args));
@@ -754,7 +859,7 @@ Expr TypeInferencer::Infer(GlobalVar var, Function function) {
   Solve();
 
   // Step 3: Attach resolved types to checked_type field.
-  auto resolved_expr = Resolver(type_map_, &solver_).VisitExpr(function);
+  auto resolved_expr = Resolver(type_map_, &solver_, reused_).VisitExpr(function);
 
   if (!WellFormed(resolved_expr, this->diag_ctx)) {
     this->diag_ctx.Emit(Diagnostic::Bug(function->span)
@@ -829,6 +934,8 @@ Pass InferType() {
 
         // Add all the type annotations to the functions in the model.
         AddGlobalTypes(mod);
+        bool incremental =
+            pass_ctx->GetConfig<Bool>("relay.InferType.incremental", Bool(true)).value();
 
         std::vector<std::pair<GlobalVar, Function> > updates;
         for (const auto& it : updated_mod->functions) {
@@ -848,7 +955,7 @@ Pass InferType() {
 
             // TODO(@jroesch): we should be able to move the type inferencer outside
             // of this function but it seems to be more stateful then I expect.
-            auto inferencer = TypeInferencer(mod, pass_ctx->diag_ctx.value());
+            auto inferencer = TypeInferencer(mod, pass_ctx->diag_ctx.value(), incremental);
             auto updated_func = inferencer.Infer(it.first, func);
 
             pass_ctx->diag_ctx.value().Render();
@@ -0,0 +1,210 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor.cc
+ */
+#include "aot_executor.h"
+
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "../file_utils.h"
+
+namespace tvm {
+namespace runtime {
+
+AotExecutor::AotExecutor(const std::string& config_json, Module module,
+                         const std::vector<Device>& devs)
+    : module_(module) {
+  ICHECK(!devs.empty()) << "The AOT executor needs a device";
+  device_ = devs[0];
+  std::istringstream is(config_json);
+  dmlc::JSONReader reader(&is);
+  config_.Load(&reader);
+  run_func_ = module_.GetFunction(config_.run_func, true);
+  ICHECK(run_func_ != nullptr) << "Cannot find the run function " << config_.run_func
+                               << " of the AOT executor in the library";
+
+  for (size_t i = 0; i < config_.input_names.size(); ++i) {
+    inputs_.push_back(NDArray::Empty(config_.input_shapes[i],
+                                     String2DLDataType(config_.input_dtypes[i]), device_));
+  }
+  for (size_t i = 0; i < config_.output_shapes.size(); ++i) {
+    outputs_.push_back(NDArray::Empty(config_.output_shapes[i],
+                                      String2DLDataType(config_.output_dtypes[i]), device_));
+  }
+  for (int64_t size : config_.pool_sizes) {
+    pools_.push_back(
+        NDArray::Empty({std::max<int64_t>(size, 1)}, DLDataType{kDLInt, 8, 1}, device_));
+  }
+  if (config_.pool_sizes.empty() && config_.arena_size > 0) {
+    pools_.push_back(NDArray::Empty({config_.arena_size}, DLDataType{kDLInt, 8, 1}, device_));
+  }
+
+  // The arguments are the inputs, the outputs, the pools, the parameters and the arena.
+  size_t num_args = inputs_.size() + outputs_.size() + config_.pool_sizes.size() +
+                    config_.param_names.size() + (config_.pool_sizes.empty() ? 1 : 0);
+  arg_values_.resize(num_args);
+  arg_type_codes_.assign(num_args, kTVMNullptr);
+  size_t arg = 0;
+  for (const NDArray& input : inputs_) SetArg(arg++, input);
+  for (const NDArray& output : outputs_) SetArg(arg++, output);
+  for (size_t i = 0; i < config_.pool_sizes.size(); ++i, ++arg) {
+    // The pools are plain memory.
+    arg_values_[arg].v_handle = pools_[i]->data;
+    arg_type_codes_[arg] = kTVMOpaqueHandle;
+  }
+  params_.resize(config_.param_names.size());
+  param_arg_begin_ = arg;
+  for (size_t i = 0; i < config_.param_names.size(); ++i, ++arg) {
+    param_index_[config_.param_names[i]] = i;
+  }
+  if (config_.pool_sizes.empty() && !pools_.empty()) {
+    arg_values_[arg].v_handle = pools_.back()->data;
+    arg_type_codes_[arg] = kTVMOpaqueHandle;
+  }
+}
+
+void AotExecutor::SetArg(size_t index, const NDArray& arr) {
+  arg_values_[index].v_handle = const_cast<DLTensor*>(arr.operator->());
+  arg_type_codes_[index] = kTVMDLTensorHandle;
+}
+
+void AotExecutor::Run() {
+  for (size_t i = 0; i < params_.size(); ++i) {
+    ICHECK(params_[i].defined()) << "The parameter " << config_.param_names[i]
+                                 << " of the AOT executor is not set";
+  }
+  TVMRetValue rv;
+  run_func_.CallPacked(
+      TVMArgs(arg_values_.data(), arg_type_codes_.data(), static_cast<int>(arg_values_.size())),
+      &rv);
+}
+
+int AotExecutor::GetInputIndex(const std::string& name) const {
+  for (size_t i = 0; i < config_.input_names.size(); ++i) {
+    if (config_.input_names[i] == name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void AotExecutor::SetInput(int index, DLTensor* data_in) {
+  ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+  inputs_[index].CopyFrom(data_in);
+}
+
+void AotExecutor::SetParam(const std::string& name, DLTensor* data_in) {
+  auto it = param_index_.find(name);
+  if (it == param_index_.end()) return;
+  std::vector<int64_t> shape(data_in->shape, data_in->shape + data_in->ndim);
+  NDArray& param = params_[it->second];
+  // The parameter is allocated once, the later calls copy into it.
+  if (!param.defined() || param.DataType() != DataType(data_in->dtype) ||
+      !std::equal(shape.begin(), shape.end(), param.Shape().begin(), param.Shape().end())) {
+    param = NDArray::Empty(shape, data_in->dtype, device_);
+    SetArg(param_arg_begin_ + it->second, param);
+  }
+  param.CopyFrom(data_in);
+}
+
+void AotExecutor::LoadParams(const std::string& param_blob) {
+  for (const auto& kv : ::tvm::runtime::LoadParams(param_blob)) {
+    SetParam(kv.first, const_cast<DLTensor*>(kv.second.operator->()));
+  }
+}
+
+NDArray AotExecutor::GetInput(int index) const {
+  ICHECK_LT(static_cast<size_t>(index), inputs_.size());
+  return inputs_[index];
+}
+
+NDArray AotExecutor::GetOutput(int index) const {
+  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  return outputs_[index];
+}
+
+PackedFunc AotExecutor::GetFunction(const std::string& name,
+                                    const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "set_input") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      if (String::CanConvertFrom(args[0])) {
+        int in_idx = this->GetInputIndex(args[0].operator String());
+        if (in_idx >= 0) this->SetInput(in_idx, args[1]);
+      } else {
+        this->SetInput(args[0], args[1]);
+      }
+    });
+  } else if (name == "get_input") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int in_idx = 0;
+      if (String::CanConvertFrom(args[0])) {
+        in_idx = this->GetInputIndex(args[0].operator String());
+      } else {
+        in_idx = args[0];
+      }
+      if (in_idx >= 0) *rv = this->GetInput(in_idx);
+    });
+  } else if (name == "get_input_index") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetInputIndex(args[0].operator String());
+    });
+  } else if (name == "get_output") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      if (args.num_args == 2) {
+        this->GetOutput(args[0]).CopyTo(args[1].operator DLTensor*());
+      } else {
+        *rv = this->GetOutput(args[0]);
+      }
+    });
+  } else if (name == "get_num_inputs") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
+  } else if (name == "get_num_outputs") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumOutputs(); });
+  } else if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "set_param") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetParam(args[0].operator String(), args[1]);
+    });
+  } else if (name == "load_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->LoadParams(args[0].operator std::string());
+    });
+  }
+  return PackedFunc();
+}
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.num_args, 3) << "The arguments of tvm.aot_executor.create are the config, "
+                              << "the library and the devices";
+  std::vector<Device> devices;
+  for (int i = 2; i < args.num_args; ++i) {
+    devices.push_back(args[i].operator Device());
+  }
+  *rv = Module(make_object<AotExecutor>(args[0].operator std::string(), args[1], devices));
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor.h
+ * \brief Executor of the models compiled ahead of time, with the C++ runtime.
+ *
+ *  The model is one run function of the library, calling the operators by
+ *  their symbol with the temporaries at static offsets in an arena. The
+ *  executor owns the inputs, the outputs, the parameters and the arena, and
+ *  packs their DLTensors once, so a run is a single call of the run function.
+ */
+#ifndef TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
+#define TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
+
+#include <dmlc/json.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The configuration of an AOT executor, given by the AOT codegen. */
+struct AotExecutorConfig {
+  /*! \brief The symbol of the run function. */
+  std::string run_func;
+  std::vector<std::string> input_names;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::vector<std::string> input_dtypes;
+  std::vector<std::vector<int64_t>> output_shapes;
+  std::vector<std::string> output_dtypes;
+  /*! \brief The parameters passed to the run function, after the workspace pools. */
+  std::vector<std::string> param_names;
+  /*! \brief The size in bytes of the workspace pools. */
+  std::vector<int64_t> pool_sizes;
+  /*! \brief The size in bytes of the arena, passed last, when there is no pool. */
+  int64_t arena_size{0};
+
+  void Load(dmlc::JSONReader* reader) {
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareField("run_func", &run_func);
+    helper.DeclareField("input_names", &input_names);
+    helper.DeclareField("input_shapes", &input_shapes);
+    helper.DeclareField("input_dtypes", &input_dtypes);
+    helper.DeclareField("output_shapes", &output_shapes);
+    helper.DeclareField("output_dtypes", &output_dtypes);
+    helper.DeclareField("param_names", &param_names);
+    helper.DeclareField("pool_sizes", &pool_sizes);
+    helper.DeclareField("arena_size", &arena_size);
+    helper.ReadAllFields(reader);
+  }
+};
+
+/*! \brief Executor of a model compiled ahead of time. */
+class TVM_DLL AotExecutor : public ModuleNode {
+ public:
+  /*!
+   * \brief Allocate the tensors of the model and pack the arguments of the run function.
+   * \param config_json The configuration given by the AOT codegen.
+   * \param module The library with the run function.
+   * \param devs The devices, the model runs on the first one.
+   */
+  AotExecutor(const std::string& config_json, Module module, const std::vector<Device>& devs);
+
+  const char* type_key() const final { return "AotExecutor"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  /*! \brief Run the model, the parameters need to be set. */
+  void Run();
+  /*! \return The index of an input, -1 if there is no such input. */
+  int GetInputIndex(const std::string& name) const;
+  /*!
+   * \brief Copy an input.
+   * \param index The index of the input.
+   * \param data_in The data, on any device.
+   */
+  void SetInput(int index, DLTensor* data_in);
+  /*!
+   * \brief Set a parameter, copied to the device.
+   * \param name The name of the parameter, the parameters the model does not use are skipped.
+   * \param data_in The data.
+   */
+  void SetParam(const std::string& name, DLTensor* data_in);
+  /*! \brief Load the parameters from a blob saved by tvm.runtime.save_param_dict. */
+  void LoadParams(const std::string& param_blob);
+  NDArray GetInput(int index) const;
+  NDArray GetOutput(int index) const;
+  int NumInputs() const { return static_cast<int>(inputs_.size()); }
+  int NumOutputs() const { return static_cast<int>(outputs_.size()); }
+
+ private:
+  /*! \brief Point an argument of the run function at a tensor. */
+  void SetArg(size_t index, const NDArray& arr);
+
+  AotExecutorConfig config_;
+  /*! \brief The library, kept alive while the run function is used. */
+  Module module_;
+  PackedFunc run_func_;
+  Device device_;
+  std::vector<NDArray> inputs_;
+  std::vector<NDArray> outputs_;
+  /*! \brief The parameters given to the run function, undefined until they are set. */
+  std::vector<NDArray> params_;
+  /*! \brief The index of the parameters in params_, by name. */
+  std::unordered_map<std::string, size_t> param_index_;
+  /*! \brief The index of the argument of the first parameter. */
+  size_t param_arg_begin_{0};
+  /*! \brief The workspace pools, then the arena. */
+  std::vector<NDArray> pools_;
+  /*! \brief The arguments of the run function, in the order of its parameters. */
+  std::vector<TVMValue> arg_values_;
+  std::vector<int> arg_type_codes_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_AOT_EXECUTOR_AOT_EXECUTOR_H_
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/aot_executor/aot_executor_factory.cc
+ */
+#include "./aot_executor_factory.h"
+
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/registry.h>
+
+namespace tvm {
+namespace runtime {
+
+AotExecutorFactory::AotExecutorFactory(const std::string& config_json,
+                                       const std::unordered_map<std::string, NDArray>& params,
+                                       const std::string& module_name)
+    : config_json_(config_json), params_(params), module_name_(module_name) {}
+
+PackedFunc AotExecutorFactory::GetFunction(const std::string& name,
+                                           const ObjectPtr<Object>& sptr_to_self) {
+  if (name == module_name_) {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<Device> devices;
+      for (int i = 0; i < args.num_args; ++i) {
+        devices.emplace_back(args[i].operator Device());
+      }
+      *rv = this->ExecutorCreate(devices);
+    });
+  } else if (name == "remove_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      auto exec = make_object<AotExecutorFactory>(this->config_json_,
+                                                  std::unordered_map<std::string, NDArray>(),
+                                                  this->module_name_);
+      exec->Import(this->imports_[0]);
+      *rv = Module(exec);
+    });
+  }
+  return PackedFunc();
+}
+
+void AotExecutorFactory::SaveToBinary(dmlc::Stream* stream) {
+  stream->Write(config_json_);
+  std::vector<std::string> names;
+  std::vector<DLTensor*> arrays;
+  for (const auto& v : params_) {
+    names.emplace_back(v.first);
+    arrays.emplace_back(const_cast<DLTensor*>(v.second.operator->()));
+  }
+  uint64_t sz = arrays.size();
+  stream->Write(sz);
+  stream->Write(names);
+  for (size_t i = 0; i < sz; ++i) {
+    SaveDLTensor(stream, arrays[i]);
+  }
+  stream->Write(module_name_);
+}
+
+Module AotExecutorFactory::ExecutorCreate(const std::vector<Device>& devs) {
+  auto exec = make_object<AotExecutor>(config_json_, imports_[0], devs);
+  for (const auto& p : params_) {
+    exec->SetParam(p.first, const_cast<DLTensor*>(p.second.operator->()));
+  }
+  return Module(exec);
+}
+
+Module AotExecutorFactoryModuleLoadBinary(void* strm) {
+  dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+  std::string config_json;
+  std::unordered_map<std::string, NDArray> params;
+  std::string module_name;
+  ICHECK(stream->Read(&config_json));
+  uint64_t sz;
+  ICHECK(stream->Read(&sz));
+  std::vector<std::string> names;
+  ICHECK(stream->Read(&names));
+  ICHECK(sz == names.size());
+  for (size_t i = 0; i < sz; ++i) {
+    NDArray temp;
+    temp.Load(stream);
+    params[names[i]] = temp;
+  }
+  ICHECK(stream->Read(&module_name));
+  return Module(make_object<AotExecutorFactory>(config_json, params, module_name));
+}
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor_factory.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // The arguments are the config, the library, the module name, then the names and the
+  // tensors of the params.
+  ICHECK_GE(args.num_args, 3) << "tvm.aot_executor_factory.create needs at least 3 arguments";
+  ICHECK_EQ((args.size() - 3) % 2, 0);
+  std::unordered_map<std::string, NDArray> params;
+  for (int i = 3; i < args.num_args; i += 2) {
+    params[args[i].operator String()] = args[i + 1].operator NDArray();
+  }
+  auto exec = make_object<AotExecutorFactory>(args[0].operator std::string(), params,
+                                              args[2].operator std::string());
+  exec->Import(args[1]);
+  *rv = Module(exec);
+});
+
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_AotExecutorFactory")
+    .set_body_typed(AotExecutorFactoryModuleLoadBinary);
+
+}  // namespace runtime
+}  // namespace tvm
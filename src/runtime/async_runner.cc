@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/async_runner.cc
+ */
+#include "async_runner.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <exception>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+AsyncRunner::AsyncRunner(PackedFunc run, int max_in_flight)
+    : run_(std::move(run)), max_in_flight_(max_in_flight) {
+  ICHECK(run_ != nullptr) << "The run function of the async runner is null";
+  ICHECK_GT(max_in_flight, 0) << "The async runner needs room for a request in flight";
+  worker_ = std::thread([this]() { this->RunLoop(); });
+  completer_ = std::thread([this]() { this->CompleteLoop(); });
+}
+
+AsyncRunner::~AsyncRunner() {
+  // The submitted requests still run and complete.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  pending_cv_.notify_all();
+  done_cv_.notify_all();
+  worker_.join();
+  completer_.join();
+}
+
+bool AsyncRunner::Submit(std::unique_ptr<AsyncRequest> request, bool block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!block && in_flight_ >= max_in_flight_) return false;
+  completed_cv_.wait(lock, [this]() { return in_flight_ < max_in_flight_; });
+  ++in_flight_;
+  pending_.push_back(std::move(request));
+  pending_cv_.notify_one();
+  return true;
+}
+
+void AsyncRunner::WaitAll() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  completed_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+}
+
+int AsyncRunner::NumInFlight() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(in_flight_);
+}
+
+void AsyncRunner::RunLoop() {
+  while (true) {
+    std::unique_ptr<AsyncRequest> request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      pending_cv_.wait(lock, [this]() { return closed_ || !pending_.empty(); });
+      if (pending_.empty()) break;
+      request = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    std::vector<TVMValue> values(request->args.size());
+    std::vector<int> type_codes(request->args.size());
+    TVMArgsSetter setter(values.data(), type_codes.data());
+    for (size_t i = 0; i < request->args.size(); ++i) {
+      setter(i, request->args[i]);
+    }
+    try {
+      run_.CallPacked(TVMArgs(values.data(), type_codes.data(), static_cast<int>(values.size())),
+                      &request->result);
+    } catch (const std::exception& e) {
+      request->result = TVMRetValue();
+      request->error = e.what();
+    }
+    // The arguments are not needed by the callback, release them now.
+    request->args.clear();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_.push_back(std::move(request));
+    }
+    done_cv_.notify_one();
+  }
+  // Let the completion thread finish once the last request is done.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    worker_done_ = true;
+  }
+  done_cv_.notify_one();
+}
+
+void AsyncRunner::CompleteLoop() {
+  while (true) {
+    std::unique_ptr<AsyncRequest> request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_cv_.wait(lock, [this]() { return worker_done_ || !done_.empty(); });
+      if (done_.empty()) break;
+      request = std::move(done_.front());
+      done_.pop_front();
+    }
+    if (request->callback != nullptr) {
+      try {
+        request->callback(request->result, request->error);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "The callback of an async request failed: " << e.what();
+      }
+    }
+    request.reset();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --in_flight_;
+    }
+    completed_cv_.notify_all();
+  }
+}
+
+PackedFunc AsyncRunner::GetFunction(const std::string& name,
+                                    const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "submit" || name == "try_submit") {
+    // The args are the callback, then the arguments of the run function.
+    bool block = name == "submit";
+    return PackedFunc([sptr_to_self, block, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.num_args, 1) << "The first argument of " << (block ? "submit" : "try_submit")
+                                  << " is the callback";
+      std::unique_ptr<AsyncRequest> request(new AsyncRequest());
+      if (args[0].type_code() != kTVMNullptr) request->callback = args[0];
+      request->args.resize(args.num_args - 1);
+      for (int i = 1; i < args.num_args; ++i) {
+        request->args[i - 1] = args[i];
+      }
+      *rv = this->Submit(std::move(request), block);
+    });
+  } else if (name == "wait_all") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->WaitAll(); });
+  } else if (name == "num_in_flight") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInFlight(); });
+  }
+  return PackedFunc();
+}
+
+TVM_REGISTER_GLOBAL("runtime.AsyncRunner").set_body_typed([](PackedFunc run, int max_in_flight) {
+  return Module(make_object<AsyncRunner>(run, max_in_flight));
+});
+
+}  // namespace runtime
+}  // namespace tvm
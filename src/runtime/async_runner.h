@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/async_runner.h
+ * \brief Runner of the requests of an executor off the threads submitting them.
+ *
+ *  A request is run on the worker thread of the runner, then its callback is
+ *  called on the completion thread, so that the submitting thread prepares the
+ *  next request while the worker runs the current one and the callbacks
+ *  process the previous ones.
+ */
+#ifndef TVM_RUNTIME_ASYNC_RUNNER_H_
+#define TVM_RUNTIME_ASYNC_RUNNER_H_
+
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A request of an AsyncRunner, from its submission to its callback. */
+struct AsyncRequest {
+  /*! \brief The arguments of the run function. */
+  std::vector<TVMRetValue> args;
+  /*! \brief Called with the result and the error message, empty on success. */
+  PackedFunc callback;
+  TVMRetValue result;
+  std::string error;
+};
+
+/*!
+ * \brief Runner of the requests of an executor.
+ *
+ *  The requests are run in their submission order by a single worker thread,
+ *  the executors not running concurrent requests. At most max_in_flight
+ *  requests are submitted and not completed, Submit waiting or failing while
+ *  there are as many.
+ */
+class AsyncRunner : public ModuleNode {
+ public:
+  /*!
+   * \brief Start the worker and completion threads.
+   * \param run The function running a request, e.g. the run_request function
+   *  of a graph executor, whose result is given to the callback.
+   * \param max_in_flight The maximum number of requests not completed.
+   */
+  AsyncRunner(PackedFunc run, int max_in_flight);
+  ~AsyncRunner();
+
+  const char* type_key() const final { return "AsyncRunner"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  /*!
+   * \brief Submit a request.
+   * \param request The request.
+   * \param block Whether to wait while max_in_flight requests are not completed.
+   * \return Whether the request was submitted, false when not blocking and full.
+   */
+  bool Submit(std::unique_ptr<AsyncRequest> request, bool block);
+  /*! \brief Wait for the completion of the submitted requests. */
+  void WaitAll();
+  /*! \brief The number of requests submitted and not completed. */
+  int NumInFlight();
+
+ private:
+  // The loop of the worker thread, running the requests.
+  void RunLoop();
+  // The loop of the completion thread, calling the callbacks.
+  void CompleteLoop();
+
+  PackedFunc run_;
+  size_t max_in_flight_;
+  /*! \brief The requests waiting to run. */
+  std::deque<std::unique_ptr<AsyncRequest>> pending_;
+  /*! \brief The requests run, waiting for their callback. */
+  std::deque<std::unique_ptr<AsyncRequest>> done_;
+  /*! \brief The number of requests submitted and not completed. */
+  size_t in_flight_{0};
+  bool closed_{false};
+  /*! \brief Whether the worker thread has run its last request. */
+  bool worker_done_{false};
+  std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::condition_variable done_cv_;
+  /*! \brief Notified when a request completes. */
+  std::condition_variable completed_cv_;
+  std::thread worker_;
+  std::thread completer_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_ASYNC_RUNNER_H_
@@ -35,6 +35,7 @@
 #include <cstdlib>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "object_internal.h"
 #include "runtime_base.h"
@@ -43,19 +44,23 @@ namespace tvm {
 namespace runtime {
 
 std::string GetCustomTypeName(uint8_t type_code) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_name");
+  static const Registry::Handle handle = Registry::GetHandle("runtime._datatype_get_type_name");
+  const PackedFunc* f = handle.Get();
   ICHECK(f) << "Function runtime._datatype_get_type_name not found";
   return (*f)(type_code).operator std::string();
 }
 
 uint8_t GetCustomTypeCode(const std::string& type_name) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_code");
+  static const Registry::Handle handle = Registry::GetHandle("runtime._datatype_get_type_code");
+  const PackedFunc* f = handle.Get();
   ICHECK(f) << "Function runtime._datatype_get_type_code not found";
   return (*f)(type_name).operator int();
 }
 
 bool GetCustomTypeRegistered(uint8_t type_code) {
-  auto f = tvm::runtime::Registry::Get("runtime._datatype_get_type_registered");
+  static const Registry::Handle handle =
+      Registry::GetHandle("runtime._datatype_get_type_registered");
+  const PackedFunc* f = handle.Get();
   ICHECK(f) << "Function runtime._datatype_get_type_registered not found";
   return (*f)(type_code).operator bool();
 }
@@ -176,10 +181,74 @@ void DeviceAPI::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHandle str
   size_t nbytes = GetDataSize(*from);
   ICHECK_EQ(nbytes, GetDataSize(*to));
 
-  ICHECK(IsContiguous(*from) && IsContiguous(*to))
-      << "CopyDataFromTo only support contiguous array for now";
-  CopyDataFromTo(from->data, from->byte_offset, to->data, to->byte_offset, nbytes, from->device,
-                 to->device, from->dtype, stream);
+  if (IsContiguous(*from) && IsContiguous(*to)) {
+    CopyDataFromTo(from->data, from->byte_offset, to->data, to->byte_offset, nbytes, from->device,
+                   to->device, from->dtype, stream);
+    return;
+  }
+  ICHECK_EQ(from->ndim, to->ndim) << "CopyDataFromTo: strided arrays must have the same shape";
+  ICHECK(std::equal(from->shape, from->shape + from->ndim, to->shape))
+      << "CopyDataFromTo: strided arrays must have the same shape";
+  ICHECK(from->dtype.code == to->dtype.code && from->dtype.bits == to->dtype.bits &&
+         from->dtype.lanes == to->dtype.lanes)
+      << "CopyDataFromTo: strided arrays must have the same dtype";
+  if (nbytes == 0) return;
+  // The dimensions of the copy, outermost first, with their strides in bytes. The dimensions
+  // whose elements are adjacent in both arrays are merged.
+  struct Dim {
+    int64_t extent, from_stride, to_stride;
+  };
+  const int64_t elem_bytes = (from->dtype.bits * from->dtype.lanes + 7) / 8;
+  std::vector<Dim> dims;
+  int64_t from_stride = elem_bytes, to_stride = elem_bytes;
+  for (int i = from->ndim - 1; i >= 0; --i) {
+    Dim dim{from->shape[i], from->strides ? from->strides[i] * elem_bytes : from_stride,
+            to->strides ? to->strides[i] * elem_bytes : to_stride};
+    from_stride *= from->shape[i];
+    to_stride *= to->shape[i];
+    if (dim.extent == 1) continue;
+    ICHECK(dim.from_stride >= 0 && dim.to_stride > 0)
+        << "CopyDataFromTo: negative strides, or zero strides of the target, are not supported";
+    if (!dims.empty() && dims.back().from_stride * dims.back().extent == dim.from_stride &&
+        dims.back().to_stride * dims.back().extent == dim.to_stride) {
+      dims.back().extent *= dim.extent;
+    } else {
+      dims.push_back(dim);
+    }
+  }
+  // dims is innermost first here: the rows are the innermost dimension when it is contiguous in
+  // both arrays, single elements otherwise.
+  size_t width = elem_bytes;
+  size_t begin = 0;
+  if (!dims.empty() && dims[0].from_stride == elem_bytes && dims[0].to_stride == elem_bytes) {
+    width = dims[0].extent * elem_bytes;
+    begin = 1;
+  }
+  size_t height = 1, from_pitch = width, to_pitch = width;
+  if (begin < dims.size() && dims[begin].from_stride >= static_cast<int64_t>(width) &&
+      dims[begin].to_stride >= static_cast<int64_t>(width)) {
+    height = dims[begin].extent;
+    from_pitch = dims[begin].from_stride;
+    to_pitch = dims[begin].to_stride;
+    ++begin;
+  }
+  // One 2D copy per index of the remaining outer dimensions.
+  std::vector<Dim> outer(dims.begin() + begin, dims.end());
+  std::vector<int64_t> index(outer.size(), 0);
+  while (true) {
+    size_t from_offset = from->byte_offset, to_offset = to->byte_offset;
+    for (size_t i = 0; i < outer.size(); ++i) {
+      from_offset += index[i] * outer[i].from_stride;
+      to_offset += index[i] * outer[i].to_stride;
+    }
+    CopyDataFromTo2D(from->data, from_offset, from_pitch, to->data, to_offset, to_pitch, width,
+                     height, from->device, to->device, from->dtype, stream);
+    size_t i = 0;
+    for (; i < outer.size() && ++index[i] == outer[i].extent; ++i) {
+      index[i] = 0;
+    }
+    if (i == outer.size()) break;
+  }
 }
 
 void DeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset,
@@ -188,6 +257,37 @@ void DeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to, s
   LOG(FATAL) << "Device does not support CopyDataFromTo.";
 }
 
+void DeviceAPI::CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch,
+                                 void* to, size_t to_offset, size_t to_pitch, size_t width,
+                                 size_t height, Device dev_from, Device dev_to,
+                                 DLDataType type_hint, TVMStreamHandle stream) {
+  for (size_t i = 0; i < height; ++i) {
+    CopyDataFromTo(from, from_offset + i * from_pitch, to, to_offset + i * to_pitch, width,
+                   dev_from, dev_to, type_hint, stream);
+  }
+}
+
+namespace {
+/*! \brief The default event: the stream it is recorded on, waited for as a whole. */
+struct StreamEvent {
+  TVMStreamHandle stream{nullptr};
+};
+}  // namespace
+
+TVMEventHandle DeviceAPI::CreateEvent(Device dev) { return new StreamEvent(); }
+
+void DeviceAPI::FreeEvent(Device dev, TVMEventHandle event) {
+  delete static_cast<StreamEvent*>(event);
+}
+
+void DeviceAPI::RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) {
+  static_cast<StreamEvent*>(event)->stream = stream;
+}
+
+void DeviceAPI::EventSync(Device dev, TVMEventHandle event) {
+  StreamSync(dev, static_cast<StreamEvent*>(event)->stream);
+}
+
 void DeviceAPI::FreeWorkspace(Device dev, void* ptr) { FreeDataSpace(dev, ptr); }
 
 TVMStreamHandle DeviceAPI::CreateStream(Device dev) { return nullptr; }
@@ -575,6 +675,42 @@ int TVMStreamStreamSynchronize(int device_type, int device_id, TVMStreamHandle s
   API_END();
 }
 
+int TVMEventCreate(int device_type, int device_id, TVMEventHandle* out) {
+  API_BEGIN();
+  DLDevice dev;
+  dev.device_type = static_cast<DLDeviceType>(device_type);
+  dev.device_id = device_id;
+  *out = DeviceAPIManager::Get(dev)->CreateEvent(dev);
+  API_END();
+}
+
+int TVMEventFree(int device_type, int device_id, TVMEventHandle event) {
+  API_BEGIN();
+  DLDevice dev;
+  dev.device_type = static_cast<DLDeviceType>(device_type);
+  dev.device_id = device_id;
+  DeviceAPIManager::Get(dev)->FreeEvent(dev, event);
+  API_END();
+}
+
+int TVMEventRecord(int device_type, int device_id, TVMEventHandle event, TVMStreamHandle stream) {
+  API_BEGIN();
+  DLDevice dev;
+  dev.device_type = static_cast<DLDeviceType>(device_type);
+  dev.device_id = device_id;
+  DeviceAPIManager::Get(dev)->RecordEvent(dev, event, stream);
+  API_END();
+}
+
+int TVMEventSynchronize(int device_type, int device_id, TVMEventHandle event) {
+  API_BEGIN();
+  DLDevice dev;
+  dev.device_type = static_cast<DLDeviceType>(device_type);
+  dev.device_id = device_id;
+  DeviceAPIManager::Get(dev)->EventSync(dev, event);
+  API_END();
+}
+
 int TVMCbArgToReturn(TVMValue* value, int* code) {
   API_BEGIN();
   tvm::runtime::TVMRetValue rv;
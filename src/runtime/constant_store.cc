@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file constant_store.cc
+ * \brief A process-wide store of the constants loaded by the executors, deduplicated by content.
+ */
+#include "constant_store.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace tvm {
+namespace runtime {
+
+ConstantStore* ConstantStore::Global() {
+  static ConstantStore* store = new ConstantStore();
+  return store;
+}
+
+uint64_t ConstantStore::Hash(const DLTensor& array) {
+  // A multiplicative hash of the words of the data, cheap next to loading the data.
+  constexpr uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+  uint64_t hash = (static_cast<uint64_t>(array.dtype.code) << 16) ^
+                  (static_cast<uint64_t>(array.dtype.bits) << 8) ^ array.dtype.lanes;
+  auto mix = [&hash](uint64_t word) {
+    hash ^= word;
+    hash *= kMul;
+    hash ^= hash >> 32;
+  };
+  for (int i = 0; i < array.ndim; ++i) {
+    mix(static_cast<uint64_t>(array.shape[i]));
+  }
+  const char* data = static_cast<const char*>(array.data) + array.byte_offset;
+  size_t size = GetDataSize(array);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    mix(word);
+  }
+  for (; i < size; ++i) {
+    mix(static_cast<unsigned char>(data[i]));
+  }
+  return hash;
+}
+
+bool ConstantStore::Equal(const DLTensor& lhs, const DLTensor& rhs) {
+  if (lhs.dtype.code != rhs.dtype.code || lhs.dtype.bits != rhs.dtype.bits ||
+      lhs.dtype.lanes != rhs.dtype.lanes || lhs.ndim != rhs.ndim ||
+      !std::equal(lhs.shape, lhs.shape + lhs.ndim, rhs.shape)) {
+    return false;
+  }
+  return std::memcmp(static_cast<const char*>(lhs.data) + lhs.byte_offset,
+                     static_cast<const char*>(rhs.data) + rhs.byte_offset, GetDataSize(lhs)) == 0;
+}
+
+NDArray ConstantStore::Intern(const NDArray& array, Device device) {
+  ICHECK(array.defined());
+  ICHECK_EQ(array->device.device_type, kDLCPU) << "Only CPU arrays can be interned";
+  ICHECK(array.IsContiguous()) << "Only contiguous arrays can be interned";
+  // Hash and compare the data outside of the lock: Equal only reads arrays that are never
+  // written to.
+  uint64_t hash = Hash(*array.operator->());
+  std::vector<NDArray> candidates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      candidates.push_back(it->second.host);
+    }
+  }
+  NDArray host;
+  // The reference held to the host array keeps its entry from being pruned.
+  for (const NDArray& candidate : candidates) {
+    if (Equal(*candidate.operator->(), *array.operator->())) {
+      host = candidate;
+      break;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry* entry = nullptr;
+  if (host.defined()) {
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.host.same_as(host)) {
+        entry = &it->second;
+        break;
+      }
+    }
+  }
+  if (entry == nullptr) {
+    // Another thread may have interned the same content in the meantime.
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second && entry == nullptr; ++it) {
+      if (Equal(*it->second.host.operator->(), *array.operator->())) {
+        entry = &it->second;
+      }
+    }
+  }
+  if (entry == nullptr) {
+    entry = &entries_.emplace(hash, Entry{array, {}})->second;
+  }
+  if (device.device_type == kDLCPU) {
+    return entry->host;
+  }
+  for (const NDArray& copy : entry->device_copies) {
+    const Device& copy_device = copy->device;
+    if (copy_device.device_type == device.device_type &&
+        copy_device.device_id == device.device_id) {
+      return copy;
+    }
+  }
+  NDArray copy = entry->host.CopyTo(device);
+  entry->device_copies.push_back(copy);
+  return copy;
+}
+
+size_t ConstantStore::Prune() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t released = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    std::vector<NDArray>& copies = it->second.device_copies;
+    auto unused = std::remove_if(copies.begin(), copies.end(),
+                                 [](const NDArray& copy) { return copy.use_count() == 1; });
+    for (auto copy = unused; copy != copies.end(); ++copy) {
+      released += GetDataSize(*copy->operator->());
+    }
+    copies.erase(unused, copies.end());
+    if (copies.empty() && it->second.host.use_count() == 1) {
+      released += GetDataSize(*it->second.host.operator->());
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return released;
+}
+
+size_t ConstantStore::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t ConstantStore::NumBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (const auto& it : entries_) {
+    size += GetDataSize(*it.second.host.operator->());
+    for (const NDArray& copy : it.second.device_copies) {
+      size += GetDataSize(*copy.operator->());
+    }
+  }
+  return size;
+}
+
+TVM_REGISTER_GLOBAL("runtime.ConstantStoreSize").set_body_typed([]() {
+  return static_cast<int64_t>(ConstantStore::Global()->Size());
+});
+
+TVM_REGISTER_GLOBAL("runtime.ConstantStoreNumBytes").set_body_typed([]() {
+  return static_cast<int64_t>(ConstantStore::Global()->NumBytes());
+});
+
+TVM_REGISTER_GLOBAL("runtime.ConstantStorePrune").set_body_typed([]() {
+  return static_cast<int64_t>(ConstantStore::Global()->Prune());
+});
+
+}  // namespace runtime
+}  // namespace tvm
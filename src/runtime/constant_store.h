@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file constant_store.h
+ * \brief A process-wide store of the constants loaded by the executors, deduplicated by content.
+ *
+ * Variants of a model served by one process, e.g. fine-tuned from the same base, have most of
+ * their weights in common. The executors intern the weights they load in the store so that the
+ * identical ones are kept once, and each further variant only costs its differing weights.
+ */
+#ifndef TVM_RUNTIME_CONSTANT_STORE_H_
+#define TVM_RUNTIME_CONSTANT_STORE_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief A store of constant arrays keyed by their dtype, shape and data.
+ *
+ * The arrays returned by the store are shared: they must not be written to. The store holds a
+ * reference to each of its arrays; the ones nobody else refers to are released by Prune.
+ */
+class ConstantStore {
+ public:
+  /*! \return The store of the process. */
+  static ConstantStore* Global();
+
+  /*!
+   * \brief Get the array of the store equal to an array, on a device.
+   * \param array The contiguous CPU array to intern. It is kept by the store when the store has
+   *  no array equal to it, so it must not be written to afterwards.
+   * \param device The device of the returned array. The copy of the array on the device is made
+   *  the first time it is requested.
+   * \return The array of the store.
+   */
+  NDArray Intern(const NDArray& array, Device device);
+
+  /*!
+   * \brief Release the arrays nobody but the store refers to.
+   * \return The number of bytes released.
+   */
+  size_t Prune();
+
+  /*! \return The number of distinct arrays in the store. */
+  size_t Size();
+
+  /*! \return The number of bytes of the arrays in the store, on all devices. */
+  size_t NumBytes();
+
+ private:
+  /*! \brief The arrays of a content. */
+  struct Entry {
+    /*! \brief The CPU array, compared with the arrays interned. */
+    NDArray host;
+    /*! \brief The copies of the array on the other devices. */
+    std::vector<NDArray> device_copies;
+  };
+
+  /*! \brief The hash of the dtype, shape and data of an array. */
+  static uint64_t Hash(const DLTensor& array);
+  /*! \brief Whether two arrays have the same dtype, shape and data. */
+  static bool Equal(const DLTensor& lhs, const DLTensor& rhs);
+
+  std::mutex mutex_;
+  /*! \brief The entries, keyed by the hash of their array. */
+  std::unordered_multimap<uint64_t, Entry> entries_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONSTANT_STORE_H_
@@ -0,0 +1,257 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cupti_collector.cc
+ * \brief Metric collector reading CUDA hardware events with CUPTI.
+ */
+#include <cuda.h>
+#include <cupti.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                           \
+  {                                                                \
+    CUptiResult e = (func);                                        \
+    if (e != CUPTI_SUCCESS) {                                      \
+      const char* msg;                                             \
+      cuptiGetResultString(e, &msg);                               \
+      LOG(FATAL) << "CUPTI: " #func " failed with error: " << msg; \
+    }                                                              \
+  }
+
+/*! \brief Bytes of a DRAM sector counted by the fb_subp* events. */
+constexpr int64_t kDRAMSectorBytes = 32;
+
+/*! \brief Event values of a device at the start of a region. */
+class CuptiStartNode : public Object {
+ public:
+  int device_id;
+  std::vector<uint64_t> values;
+
+  static constexpr const char* _type_key = "runtime.profiling.CuptiStart";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CuptiStartNode, Object);
+};
+
+/*!
+ * \brief Collect hardware events of CUDA devices with the CUPTI event API.
+ *
+ *  The events are collected continuously on the context of each device and
+ *  read before and after each region, after synchronizing the device. Only the
+ *  events which can be collected in a single pass are read, the others are
+ *  dropped with a warning. Values are summed over all domain instances, e.g.
+ *  all SMs.
+ *
+ *  The DRAM sectors counted by the "fb_subp*_read_sectors" and
+ *  "fb_subp*_write_sectors" events are also reported as "DRAM Read (B)" and
+ *  "DRAM Write (B)".
+ */
+class CuptiCollectorNode : public MetricCollectorNode {
+ public:
+  explicit CuptiCollectorNode(std::vector<std::string> events) : events_(std::move(events)) {}
+
+  ~CuptiCollectorNode() {
+    for (auto& p : devices_) {
+      for (auto& group : p.second.groups) {
+        cuptiEventGroupDisable(group.group);
+      }
+      if (p.second.sets != nullptr) {
+        cuptiEventGroupSetsDestroy(p.second.sets);
+      }
+    }
+  }
+
+  void Init(const std::vector<Device>& devs) final {
+    for (const Device& dev : devs) {
+      if (dev.device_type != kDLCUDA || devices_.count(dev.device_id)) continue;
+      DeviceEvents state;
+      if (InitDevice(dev.device_id, &state)) {
+        devices_[dev.device_id] = std::move(state);
+      }
+    }
+  }
+
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCUDA) return ObjectRef();
+    auto it = devices_.find(dev.device_id);
+    if (it == devices_.end()) return ObjectRef();
+    auto node = make_object<CuptiStartNode>();
+    node->device_id = dev.device_id;
+    node->values = Read(dev.device_id, it->second);
+    return ObjectRef(node);
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const auto* start = obj.as<CuptiStartNode>();
+    ICHECK(start) << "CuptiCollector cannot stop a region it did not start";
+    const DeviceEvents& state = devices_.at(start->device_id);
+    std::vector<uint64_t> values = Read(start->device_id, state);
+    Map<String, ObjectRef> metrics;
+    int64_t dram_read = 0, dram_write = 0;
+    bool has_read = false, has_write = false;
+    for (size_t i = 0; i < values.size(); ++i) {
+      int64_t value = static_cast<int64_t>(values[i] - start->values[i]);
+      const std::string& name = state.names[i];
+      metrics.Set(name, ObjectRef(make_object<CountNode>(value)));
+      if (name.rfind("fb_subp", 0) == 0) {
+        if (name.find("read_sectors") != std::string::npos) {
+          dram_read += value * kDRAMSectorBytes;
+          has_read = true;
+        } else if (name.find("write_sectors") != std::string::npos) {
+          dram_write += value * kDRAMSectorBytes;
+          has_write = true;
+        }
+      }
+    }
+    if (has_read) metrics.Set("DRAM Read (B)", ObjectRef(make_object<CountNode>(dram_read)));
+    if (has_write) metrics.Set("DRAM Write (B)", ObjectRef(make_object<CountNode>(dram_write)));
+    return metrics;
+  }
+
+  static constexpr const char* _type_key = "runtime.profiling.CuptiCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CuptiCollectorNode, MetricCollectorNode);
+
+ private:
+  struct EventGroup {
+    CUpti_EventGroup group;
+    std::vector<CUpti_EventID> ids;
+    uint32_t num_instances;
+  };
+
+  /*! \brief The enabled events of a device, in the order of names. */
+  struct DeviceEvents {
+    CUpti_EventGroupSets* sets{nullptr};
+    std::vector<EventGroup> groups;
+    std::vector<std::string> names;
+  };
+
+  bool InitDevice(int device_id, DeviceEvents* state) {
+    CUDA_CALL(cudaSetDevice(device_id));
+    // Make sure the runtime created the primary context.
+    CUDA_CALL(cudaFree(nullptr));
+    CUcontext ctx;
+    CUdevice cu_device;
+    CUDA_DRIVER_CALL(cuCtxGetCurrent(&ctx));
+    CUDA_DRIVER_CALL(cuDeviceGet(&cu_device, device_id));
+
+    std::vector<CUpti_EventID> ids;
+    std::map<CUpti_EventID, std::string> names;
+    for (const std::string& name : events_) {
+      CUpti_EventID id;
+      if (cuptiEventGetIdFromName(cu_device, name.c_str(), &id) != CUPTI_SUCCESS) {
+        LOG(WARNING) << "CUPTI event " << name << " is not available on cuda" << device_id;
+        continue;
+      }
+      ids.push_back(id);
+      names[id] = name;
+    }
+    if (ids.empty()) return false;
+
+    CUPTI_CALL(cuptiSetEventCollectionMode(ctx, CUPTI_EVENT_COLLECTION_MODE_CONTINUOUS));
+    CUPTI_CALL(cuptiEventGroupSetsCreate(ctx, ids.size() * sizeof(CUpti_EventID), ids.data(),
+                                         &state->sets));
+    if (state->sets->numSets == 0) {
+      cuptiEventGroupSetsDestroy(state->sets);
+      return false;
+    }
+    if (state->sets->numSets > 1) {
+      LOG(WARNING) << "The CUPTI events need " << state->sets->numSets
+                   << " passes, only the events of the first pass are collected";
+    }
+    const CUpti_EventGroupSet& set = state->sets->sets[0];
+    for (uint32_t i = 0; i < set.numEventGroups; ++i) {
+      EventGroup group;
+      group.group = set.eventGroups[i];
+      uint32_t all = 1;
+      CUPTI_CALL(cuptiEventGroupSetAttribute(group.group,
+                                             CUPTI_EVENT_GROUP_ATTR_PROFILE_ALL_DOMAIN_INSTANCES,
+                                             sizeof(all), &all));
+      uint32_t num_events;
+      size_t size = sizeof(num_events);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group.group, CUPTI_EVENT_GROUP_ATTR_NUM_EVENTS, &size,
+                                             &num_events));
+      group.ids.resize(num_events);
+      size = num_events * sizeof(CUpti_EventID);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group.group, CUPTI_EVENT_GROUP_ATTR_EVENTS, &size,
+                                             group.ids.data()));
+      size = sizeof(group.num_instances);
+      CUPTI_CALL(cuptiEventGroupGetAttribute(group.group, CUPTI_EVENT_GROUP_ATTR_INSTANCE_COUNT,
+                                             &size, &group.num_instances));
+      CUPTI_CALL(cuptiEventGroupEnable(group.group));
+      for (CUpti_EventID id : group.ids) {
+        state->names.push_back(names[id]);
+      }
+      state->groups.push_back(std::move(group));
+    }
+    return true;
+  }
+
+  /*! \brief Read the events of a device, summed over the domain instances. */
+  std::vector<uint64_t> Read(int device_id, const DeviceEvents& state) {
+    CUDA_CALL(cudaSetDevice(device_id));
+    CUDA_CALL(cudaDeviceSynchronize());
+    std::vector<uint64_t> values;
+    std::vector<uint64_t> buf;
+    for (const EventGroup& group : state.groups) {
+      buf.resize(group.num_instances);
+      for (CUpti_EventID id : group.ids) {
+        size_t size = buf.size() * sizeof(uint64_t);
+        CUPTI_CALL(cuptiEventGroupReadEvent(group.group, CUPTI_EVENT_READ_FLAG_NONE, id, &size,
+                                            buf.data()));
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size / sizeof(uint64_t); ++i) sum += buf[i];
+        values.push_back(sum);
+      }
+    }
+    return values;
+  }
+
+  std::vector<std::string> events_;
+  std::map<int, DeviceEvents> devices_;
+};
+
+TVM_REGISTER_OBJECT_TYPE(CuptiStartNode);
+TVM_REGISTER_OBJECT_TYPE(CuptiCollectorNode);
+
+MetricCollector CuptiCollector(Array<String> events) {
+  std::vector<std::string> names(events.begin(), events.end());
+  if (names.empty()) {
+    names = {"inst_executed", "branch", "divergent_branch", "l2_subp0_read_sector_misses",
+             "fb_subp0_read_sectors", "fb_subp1_read_sectors", "fb_subp0_write_sectors",
+             "fb_subp1_write_sectors"};
+  }
+  return MetricCollector(make_object<CuptiCollectorNode>(names));
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.CuptiCollector").set_body_typed(CuptiCollector);
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
@@ -22,11 +22,19 @@
  * \brief A simple JSON runtime for DNNL.
  */
 
+#include <dmlc/parameter.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
 #include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../json/json_node.h"
@@ -40,10 +48,60 @@ namespace contrib {
 using namespace tvm::runtime;
 using namespace tvm::runtime::json;
 
+/*!
+ * \brief The layouts of the tensors written by DNNL subgraphs in the layout DNNL picked, by data
+ * pointer. The DNNL subgraph reading such a tensor takes it as is instead of reordering it to the
+ * plain layout and back. Only the boundaries between DNNL subgraphs marked at compile time, whose
+ * tensors no other op reads, are exchanged this way.
+ */
+class DNNLLayoutRegistry {
+ public:
+  static DNNLLayoutRegistry* Global() {
+    static DNNLLayoutRegistry* inst = new DNNLLayoutRegistry();
+    return inst;
+  }
+
+  void Set(const void* data, const dnnl::memory::desc& desc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    layouts_[data] = desc;
+  }
+
+  void Erase(const void* data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    layouts_.erase(data);
+  }
+
+  bool Get(const void* data, dnnl::memory::desc* desc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = layouts_.find(data);
+    if (it == layouts_.end()) return false;
+    *desc = it->second;
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<const void*, dnnl::memory::desc> layouts_;
+};
+
 class DNNLJSONRuntime : public JSONRuntimeBase {
   using tag = dnnl::memory::format_tag;
   using dt = dnnl::memory::data_type;
 
+  /*! \brief The primitives and memories of the subgraph built for the shapes of its inputs. */
+  struct Network {
+    /* The network layers that are represented in dnnl primitives. */
+    std::vector<dnnl::primitive> net;
+    /* The memory that is consumed by arguments. */
+    std::vector<std::unordered_map<int, dnnl::memory>> net_args;
+    /* The entry ID to its corresponding output memory. */
+    std::unordered_map<uint32_t, std::pair<dnnl::memory, size_t>> entry_out_mem;
+    /* The entry ID to its memory reordered to the layouts of its consumers. */
+    std::unordered_map<uint32_t, std::vector<dnnl::memory>> entry_reordered_mem;
+    /* The entry ID of each output to the memory it is read from. */
+    std::unordered_map<uint32_t, dnnl::memory> output_mem;
+  };
+
  public:
   DNNLJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
                   const Array<String> const_names)
@@ -52,48 +110,132 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   const char* type_key() const { return "dnnl_json"; }
 
   void Init(const Array<NDArray>& consts) override {
-    BuildEngine();
-
     ICHECK_EQ(consts.size(), const_idx_.size())
         << "The number of input constants must match the number of required.";
 
     // Setup constants entries for weights.
     SetupConstants(consts);
+    for (auto nid : const_idx_) const_eids_.insert(EntryID(nid, 0));
+    LoadGlobalAttributes();
+    cache_capacity_ = dmlc::GetEnv("TVM_DNNL_PRIMITIVE_CACHE_CAPACITY", 16);
+    ICHECK_GT(cache_capacity_, 0);
+
+    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+    stream_ = dnnl::stream(engine_);
+    // Build the network of the static input shapes ahead of the first run.
+    std::vector<int64_t> key;
+    bool is_static = true;
+    for (auto nid : input_nodes_) {
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (const auto& shape : nodes_[nid].GetOpShape()) {
+        for (auto dim : shape) is_static &= dim >= 0;
+        key.insert(key.end(), shape.begin(), shape.end());
+        key.push_back(-1);
+      }
+    }
+    if (is_static) GetOrBuildNetwork(key, {});
   }
 
   void Run() override {
+    // Look up the network of the input shapes, and of the layouts of the inputs written by other
+    // DNNL subgraphs.
+    std::vector<int64_t> key;
+    std::unordered_map<uint32_t, dnnl::memory::desc> input_descs;
+    for (size_t i = 0; i < input_var_eid_.size(); ++i) {
+      auto eid = input_var_eid_[i];
+      const DLTensor* data = data_entry_[eid];
+      key.insert(key.end(), data->shape, data->shape + data->ndim);
+      dnnl::memory::desc desc;
+      if (blocked_inputs_.count(i) && DNNLLayoutRegistry::Global()->Get(DataPtr(data), &desc)) {
+        input_descs[eid] = desc;
+        key.push_back(-2);
+      } else {
+        key.push_back(-1);
+      }
+    }
+    Network* network = GetOrBuildNetwork(key, input_descs);
+
     // Fill in the input buffers.
-    for (size_t i = 0; i < input_nodes_.size(); ++i) {
-      auto eid = EntryID(input_nodes_[i], 0);
+    for (auto eid : input_var_eid_) {
+      auto it = network->entry_out_mem.find(eid);
+      if (it == network->entry_out_mem.end()) continue;
       // TODO(@comaniac): Support other data lengths.
-      size_t offset_in_bytes = entry_out_mem_[eid].second * 4;
-      size_t buffer_size = GetDataSize(*data_entry_[eid]);
-      write_to_dnnl_memory(data_entry_[eid]->data, entry_out_mem_[eid].first, buffer_size,
+      size_t offset_in_bytes = it->second.second * 4;
+      size_t buffer_size = input_descs.count(eid) ? input_descs[eid].get_size()
+                                                  : GetDataSize(*data_entry_[eid]);
+      write_to_dnnl_memory(DataPtr(data_entry_[eid]), it->second.first, buffer_size,
                            offset_in_bytes);
     }
 
     // Invoke the engine through intepreting the stream.
-    for (size_t i = 0; i < net_.size(); ++i) {
-      net_.at(i).execute(stream_, net_args_.at(i));
+    for (size_t i = 0; i < network->net.size(); ++i) {
+      network->net.at(i).execute(stream_, network->net_args.at(i));
     }
     stream_.wait();
 
     // Read output buffers.
     for (size_t i = 0; i < outputs_.size(); ++i) {
       auto eid = EntryID(outputs_[i]);
-      size_t offset_in_bytes = entry_out_mem_[eid].second * 4;
+      const dnnl::memory& mem = network->output_mem.at(eid);
+      auto plain_desc = GenDNNLMemDescByShape(EntryShape(outputs_[i]), dt::f32);
+      void* data = DataPtr(data_entry_[eid]);
       size_t buffer_size = GetDataSize(*data_entry_[eid]);
-      read_from_dnnl_memory(data_entry_[eid]->data, entry_out_mem_[eid].first, buffer_size,
-                            offset_in_bytes);
+      if (mem.get_desc() != plain_desc) {
+        buffer_size = mem.get_desc().get_size();
+        DNNLLayoutRegistry::Global()->Set(data, mem.get_desc());
+      } else if (blocked_outputs_.count(i)) {
+        DNNLLayoutRegistry::Global()->Erase(data);
+      }
+      read_from_dnnl_memory(data, mem, buffer_size);
     }
   }
 
  private:
+  void LoadGlobalAttributes() {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      if (!nodes_[i].HasAttr("blocked_inputs")) continue;
+      for (const auto& index : nodes_[i].GetAttr<std::vector<std::string>>("blocked_inputs")) {
+        blocked_inputs_.insert(std::stoul(index));
+      }
+      for (const auto& index : nodes_[i].GetAttr<std::vector<std::string>>("blocked_outputs")) {
+        blocked_outputs_.insert(std::stoul(index));
+      }
+      return;
+    }
+  }
+
+  static void* DataPtr(const DLTensor* data) {
+    return static_cast<char*>(data->data) + data->byte_offset;
+  }
+
+  /*!
+   * \brief Get the network of the input shapes from the cache, or build it. The least recently
+   * used network is evicted when the cache is full, e.g. with many batch sizes.
+   */
+  Network* GetOrBuildNetwork(const std::vector<int64_t>& key,
+                             const std::unordered_map<uint32_t, dnnl::memory::desc>& input_descs) {
+    auto it = network_index_.find(key);
+    if (it != network_index_.end()) {
+      networks_.splice(networks_.begin(), networks_, it->second);
+      return it->second->second.get();
+    }
+    if (networks_.size() >= static_cast<size_t>(cache_capacity_)) {
+      network_index_.erase(networks_.back().first);
+      networks_.pop_back();
+    }
+    DLOG(INFO) << "Building the DNNL primitives of subgraph " << symbol_name_;
+    networks_.emplace_front(key, std::unique_ptr<Network>(new Network()));
+    network_index_[key] = networks_.begin();
+    network_ = networks_.front().second.get();
+    input_descs_ = input_descs;
+    batch_size_ = -1;
+    if (!input_var_eid_.empty() && key[0] >= 0) batch_size_ = key[0];
+    BuildEngine();
+    return network_;
+  }
+
   // Build up the engine based on the input graph.
   void BuildEngine() {
-    engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
-    stream_ = dnnl::stream(engine_);
-
     // Build subgraph engine.
     for (size_t nid = 0; nid < nodes_.size(); ++nid) {
       const auto& node = nodes_[nid];
@@ -119,16 +261,70 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         }
       }
     }
+
+    // Read the outputs in the plain layout, but for the outputs read by other DNNL subgraphs
+    // which fit in their buffer in the layout they were computed in.
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+      auto eid = EntryID(outputs_[i]);
+      auto plain_desc = GenDNNLMemDescByShape(EntryShape(outputs_[i]), dt::f32);
+      dnnl::memory mem = BindDNNLMemory(outputs_[i], plain_desc);
+      if (!blocked_outputs_.count(i) || mem.get_desc().get_size() > plain_desc.get_size()) {
+        mem = GetMemory(outputs_[i], plain_desc);
+      }
+      network_->output_mem[eid] = mem;
+    }
+  }
+
+  // The shape of an entry, with the dynamic batch of the JSON shapes set to the batch size of
+  // the network built.
+  dnnl::memory::dims EntryShape(const JSONGraphNodeEntry& entry) {
+    dnnl::memory::dims shape = nodes_[entry.id_].GetOpShape()[entry.index_];
+    for (size_t i = 0; i < shape.size(); ++i) {
+      if (shape[i] >= 0) continue;
+      ICHECK(i == 0 && batch_size_ >= 0) << "DNNL only supports a dynamic batch dimension.";
+      shape[i] = batch_size_;
+    }
+    return shape;
+  }
+
+  // The layout of an entry, of its producer or of the input.
+  dnnl::memory::desc EntryDesc(const JSONGraphNodeEntry& entry) {
+    auto eid = EntryID(entry);
+    if (network_->entry_out_mem.count(eid)) return network_->entry_out_mem[eid].first.get_desc();
+    if (input_descs_.count(eid)) return input_descs_[eid];
+    return GenDNNLMemDescByShape(EntryShape(entry), dt::f32);
+  }
+
+  // The memory of an entry in the given layout. The entry is reordered when its producer or the
+  // input has another layout, once when building for the constants.
+  dnnl::memory GetMemory(const JSONGraphNodeEntry& entry, const dnnl::memory::desc& desc) {
+    auto eid = EntryID(entry);
+    dnnl::memory mem = BindDNNLMemory(entry, EntryDesc(entry));
+    if (mem.get_desc() == desc) return mem;
+    for (const auto& reordered : network_->entry_reordered_mem[eid]) {
+      if (reordered.get_desc() == desc) return reordered;
+    }
+    dnnl::memory reordered(desc, engine_);
+    auto reorder = dnnl::reorder(mem, reordered);
+    if (const_eids_.count(eid)) {
+      reorder.execute(stream_, mem, reordered);
+      stream_.wait();
+    } else {
+      network_->net.push_back(reorder);
+      network_->net_args.push_back({{DNNL_ARG_FROM, mem}, {DNNL_ARG_TO, reordered}});
+    }
+    network_->entry_reordered_mem[eid].push_back(reordered);
+    return reordered;
   }
 
   // Bind a JSON graph node entry to a DNNL memory.
   dnnl::memory BindDNNLMemory(const JSONGraphNodeEntry& entry, dnnl::memory::desc mem_desc,
                               size_t offset = 0) {
     auto eid = EntryID(entry);
-    if (entry_out_mem_.count(eid) == 0) {
+    if (network_->entry_out_mem.count(eid) == 0) {
       return BindDNNLMemory(entry, dnnl::memory(mem_desc, engine_), offset);
     }
-    return entry_out_mem_[eid].first;
+    return network_->entry_out_mem[eid].first;
   }
 
   // Bind a JSON graph node entry to a given DNNL memory.
@@ -137,15 +333,20 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto eid = EntryID(entry);
     // Since the DNNL memory has been created before calling this function, we assume the entry
     // has not yet been bound to the other DNNL memory; otherwise it may have memory leak.
-    ICHECK_EQ(entry_out_mem_.count(eid), 0);
+    ICHECK_EQ(network_->entry_out_mem.count(eid), 0);
 
     // TODO(@comanic): Support other data types (i.e., int8).
     auto data_node = nodes_[entry.id_];
     auto dltype = data_node.GetOpDataType()[entry.index_];
     ICHECK_EQ(dltype.bits, 32);
 
-    entry_out_mem_[eid] = {mem, offset};
-    return entry_out_mem_[eid].first;
+    network_->entry_out_mem[eid] = {mem, offset};
+    // The constants do not change between runs, write them once.
+    if (const_eids_.count(eid)) {
+      write_to_dnnl_memory(data_entry_[eid]->data, mem, GetDataSize(*data_entry_[eid]),
+                           offset * 4);
+    }
+    return network_->entry_out_mem[eid].first;
   }
 
   void Conv2d(const size_t& nid, const bool has_relu = false, const bool has_bias = false) {
@@ -154,8 +355,8 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     // Setup attributes.
     auto data_entry = node.GetInputs()[0];
     auto weight_entry = node.GetInputs()[1];
-    dnnl::memory::dims input_shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
-    dnnl::memory::dims weight_shape = nodes_[weight_entry.id_].GetOpShape()[weight_entry.index_];
+    dnnl::memory::dims input_shape = EntryShape(data_entry);
+    dnnl::memory::dims weight_shape = EntryShape(weight_entry);
     std::vector<std::string> str_strides = node.GetAttr<std::vector<std::string>>("strides");
     std::vector<std::string> str_padding = node.GetAttr<std::vector<std::string>>("padding");
     dnnl::memory::dim groups = std::stoi(node.GetAttr<std::vector<std::string>>("groups")[0]);
@@ -163,7 +364,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     dnnl::memory::dim N = input_shape[0],       // batch size
         IC = input_shape[1],                    // input channels
         IH = input_shape[2],                    // input height
-        IW = input_shape[2],                    // input width
+        IW = input_shape[3],                    // input width
         OC = weight_shape[0],                   // output channels
         KH = weight_shape[2],                   // weight height
         KW = weight_shape[3],                   // weight width
@@ -172,7 +373,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         PW_L = std::stoi(str_padding[0]),       // width padding: left
         PW_R = std::stoi(str_padding[2]),       // width padding: right
         SH = std::stoi(str_strides[0]),         // height-wise stride
-        SW = std::stoi(str_strides[0]),         // weight-wise stride
+        SW = std::stoi(str_strides[1]),         // weight-wise stride
         OH = (IH - KH + PH_L + PH_R) / SH + 1,  // output height
         OW = (IW - KW + PW_L + PW_R) / SW + 1;  // output width
 
@@ -180,7 +381,7 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     dnnl::memory::dims src_dims = {N, IC, IH, IW};
     dnnl::memory::dims weights_dims = {OC, IC, KH, KW};
     if (groups > 1) {
-      weights_dims = {groups, 1, IC / groups, KH, KW};
+      weights_dims = {groups, OC / groups, IC / groups, KH, KW};
     }
     dnnl::memory::dims bias_dims = {OC};
     dnnl::memory::dims dst_dims = {N, OC, OH, OW};
@@ -188,11 +389,11 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     dnnl::memory::dims padding_dims_l = {PH_L, PW_L};
     dnnl::memory::dims padding_dims_r = {PH_R, PW_R};
 
-    // Memory descriptions.
+    // Memory descriptions. DNNL picks the layouts, blocked ones are propagated to the consumers.
     auto conv_src_md = dnnl::memory::desc(src_dims, dt::f32, tag::any);
     auto conv_weights_md = dnnl::memory::desc(weights_dims, dt::f32, tag::any);
     auto conv_bias_md = dnnl::memory::desc(bias_dims, dt::f32, tag::any);
-    auto conv_dst_md = dnnl::memory::desc(dst_dims, dt::f32, tag::nchw);
+    auto conv_dst_md = dnnl::memory::desc(dst_dims, dt::f32, tag::any);
 
     // Covn2d description.
     auto conv_desc = dnnl::convolution_forward::desc(
@@ -209,38 +410,38 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     auto conv2d_prim_desc = dnnl::convolution_forward::primitive_desc(conv_desc, attr, engine_);
 
-    // Push to the network.
-    auto conv = dnnl::convolution_forward(conv2d_prim_desc);
-    net_.push_back(conv);
-
     // Data memory.
     ICHECK_EQ(node.GetAttr<std::vector<std::string>>("data_layout")[0], "NCHW");
-    auto conv2d_src_memory = BindDNNLMemory(data_entry, {src_dims, dt::f32, tag::nchw});
+    auto conv2d_src_memory = GetMemory(data_entry, conv2d_prim_desc.src_desc());
 
     // Weight memory.
     ICHECK_EQ(node.GetAttr<std::vector<std::string>>("kernel_layout")[0], "OIHW");
-    auto conv2d_weights_memory = BindDNNLMemory(
-        weight_entry, {weights_dims, dt::f32, (groups > 1) ? tag::goihw : tag::oihw});
+    BindDNNLMemory(weight_entry, {weights_dims, dt::f32, (groups > 1) ? tag::goihw : tag::oihw});
+    auto conv2d_weights_memory = GetMemory(weight_entry, conv2d_prim_desc.weights_desc());
 
     // Bias memory.
     auto conv2d_bias_memory = dnnl::memory({bias_dims, dt::f32, tag::x}, engine_);
     if (has_bias) {
       auto bias_entry = node.GetInputs()[2];
-      BindDNNLMemory(bias_entry, conv2d_bias_memory);
+      conv2d_bias_memory = BindDNNLMemory(bias_entry, conv2d_bias_memory);
     } else {
-      float bias[OC] = {0};
-      write_to_dnnl_memory(bias, conv2d_bias_memory, OC * sizeof(float));
+      std::vector<float> bias(OC, 0);
+      write_to_dnnl_memory(bias.data(), conv2d_bias_memory, OC * sizeof(float));
     }
 
+    // Push to the network, after the reorders of its inputs.
+    auto conv = dnnl::convolution_forward(conv2d_prim_desc);
+    network_->net.push_back(conv);
+
     // Output memory.
     JSONGraphNodeEntry out_entry(nid, 0);
     auto conv2d_dst_memory = BindDNNLMemory(out_entry, conv2d_prim_desc.dst_desc());
 
     // Bind memory buffers.
-    net_args_.push_back({{DNNL_ARG_SRC, conv2d_src_memory},
-                         {DNNL_ARG_WEIGHTS, conv2d_weights_memory},
-                         {DNNL_ARG_BIAS, conv2d_bias_memory},
-                         {DNNL_ARG_DST, conv2d_dst_memory}});
+    network_->net_args.push_back({{DNNL_ARG_SRC, conv2d_src_memory},
+                                  {DNNL_ARG_WEIGHTS, conv2d_weights_memory},
+                                  {DNNL_ARG_BIAS, conv2d_bias_memory},
+                                  {DNNL_ARG_DST, conv2d_dst_memory}});
   }
 
   void Dense(const size_t& nid) {
@@ -249,8 +450,8 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     // Setup attributes.
     auto data_entry = node.GetInputs()[0];
     auto weight_entry = node.GetInputs()[1];
-    dnnl::memory::dims input_shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
-    dnnl::memory::dims weight_shape = nodes_[weight_entry.id_].GetOpShape()[weight_entry.index_];
+    dnnl::memory::dims input_shape = EntryShape(data_entry);
+    dnnl::memory::dims weight_shape = EntryShape(weight_entry);
 
     dnnl::memory::dim B = input_shape[0],  // batch size
         IC = input_shape[1],               // input channels
@@ -263,32 +464,33 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     dnnl::memory::dims out_dims = {B, OC};
 
     // Memory descriptions.
-    auto data_md = dnnl::memory::desc({data_dims, dt::f32, tag::nc});
-    auto weight_md = dnnl::memory::desc({weight_dims, dt::f32, tag::nc});
+    auto data_md = dnnl::memory::desc({data_dims, dt::f32, tag::any});
+    auto weight_md = dnnl::memory::desc({weight_dims, dt::f32, tag::any});
     auto bias_md = dnnl::memory::desc({bias_dims, dt::f32, tag::x});
-    auto dst_md = dnnl::memory::desc({out_dims, dt::f32, tag::nc});
+    auto dst_md = dnnl::memory::desc({out_dims, dt::f32, tag::any});
 
     // Dense description.
     auto dense_desc = dnnl::inner_product_forward::desc(dnnl::prop_kind::forward_inference, data_md,
                                                         weight_md, bias_md, dst_md);
     auto dense_prim_desc = dnnl::inner_product_forward::primitive_desc(dense_desc, engine_);
 
-    auto dense = dnnl::inner_product_forward(dense_prim_desc);
-    net_.push_back(dense);
-
     // Memories.
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
-    auto weight_memory = BindDNNLMemory(weight_entry, weight_md);
+    auto data_memory = GetMemory(data_entry, dense_prim_desc.src_desc());
+    auto weight_memory = GetMemory(weight_entry, dense_prim_desc.weights_desc());
     auto bias_memory = dnnl::memory(bias_md, engine_);
-    float bias[OC] = {0};
-    write_to_dnnl_memory(bias, bias_memory, OC * sizeof(float));
+    std::vector<float> bias(OC, 0);
+    write_to_dnnl_memory(bias.data(), bias_memory, OC * sizeof(float));
+
+    auto dense = dnnl::inner_product_forward(dense_prim_desc);
+    network_->net.push_back(dense);
+
     JSONGraphNodeEntry out_entry(nid, 0);
     auto dst_memory = BindDNNLMemory(out_entry, dense_prim_desc.dst_desc());
 
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory},
-                         {DNNL_ARG_WEIGHTS, weight_memory},
-                         {DNNL_ARG_BIAS, bias_memory},
-                         {DNNL_ARG_DST, dst_memory}});
+    network_->net_args.push_back({{DNNL_ARG_SRC, data_memory},
+                                  {DNNL_ARG_WEIGHTS, weight_memory},
+                                  {DNNL_ARG_BIAS, bias_memory},
+                                  {DNNL_ARG_DST, dst_memory}});
   }
 
   void BatchNorm(const size_t& nid) {
@@ -299,25 +501,21 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto beta_entry = node.GetInputs()[2];
     auto mean_entry = node.GetInputs()[3];
     auto variance_entry = node.GetInputs()[4];
-    dnnl::memory::dims data_shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
+    dnnl::memory::dims data_shape = EntryShape(data_entry);
     dnnl::memory::dim IC = data_shape[1];
     float epsilon = std::stof(node.GetAttr<std::vector<std::string>>("epsilon")[0]);
 
-    // Memory description.
-    dnnl::memory::desc data_md = GenDNNLMemDescByShape(data_shape, dt::f32);
+    // Memory description, in the layout of the producer.
+    dnnl::memory::desc data_md = EntryDesc(data_entry);
 
     // BN description.
     auto bn_desc = dnnl::batch_normalization_forward::desc(
         dnnl::prop_kind::forward_inference, data_md, epsilon,
         dnnl::normalization_flags::use_global_stats | dnnl::normalization_flags::use_scale_shift);
     auto bn_prim_desc = dnnl::batch_normalization_forward::primitive_desc(bn_desc, engine_);
-    auto bn = dnnl::batch_normalization_forward(bn_prim_desc);
-    net_.push_back(bn);
 
     // Memories.
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
-    JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, data_md);
+    auto data_memory = GetMemory(data_entry, data_md);
     auto mean_memory = BindDNNLMemory(mean_entry, bn_prim_desc.mean_desc());
     auto variance_memory = BindDNNLMemory(variance_entry, bn_prim_desc.variance_desc());
 
@@ -326,34 +524,39 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
     auto weight_memory = BindDNNLMemory(gamma_entry, bn_prim_desc.weights_desc(), 0);
     BindDNNLMemory(beta_entry, weight_memory, IC);
 
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory},
-                         {DNNL_ARG_DST, out_memory},
-                         {DNNL_ARG_SCALE_SHIFT, weight_memory},
-                         {DNNL_ARG_MEAN, mean_memory},
-                         {DNNL_ARG_VARIANCE, variance_memory}});
+    auto bn = dnnl::batch_normalization_forward(bn_prim_desc);
+    network_->net.push_back(bn);
+
+    JSONGraphNodeEntry out_entry(nid, 0);
+    auto out_memory = BindDNNLMemory(out_entry, bn_prim_desc.dst_desc());
+
+    network_->net_args.push_back({{DNNL_ARG_SRC, data_memory},
+                                  {DNNL_ARG_DST, out_memory},
+                                  {DNNL_ARG_SCALE_SHIFT, weight_memory},
+                                  {DNNL_ARG_MEAN, mean_memory},
+                                  {DNNL_ARG_VARIANCE, variance_memory}});
   }
 
   void Relu(const size_t& nid) {
     auto node = nodes_[nid];
 
     auto data_entry = node.GetInputs()[0];
-    dnnl::memory::dims shape = nodes_[data_entry.id_].GetOpShape()[data_entry.index_];
-    auto data_md = dnnl::memory::desc{{shape}, dt::f32, tag::abcd};
+    auto data_md = EntryDesc(data_entry);
 
     auto relu_desc = dnnl::eltwise_forward::desc(dnnl::prop_kind::forward_inference,
                                                  dnnl::algorithm::eltwise_relu, data_md, 0);
     auto relu_prim_desc = dnnl::eltwise_forward::primitive_desc(relu_desc, engine_);
     ICHECK(data_md == relu_prim_desc.dst_desc());
 
+    auto data_memory = GetMemory(data_entry, data_md);
+
     auto relu = dnnl::eltwise_forward(relu_prim_desc);
-    net_.push_back(relu);
+    network_->net.push_back(relu);
 
-    auto data_memory = BindDNNLMemory(data_entry, data_md);
-    auto out_md = dnnl::memory::desc(shape, dt::f32, tag::abcd);
     JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, out_md);
+    auto out_memory = BindDNNLMemory(out_entry, relu_prim_desc.dst_desc());
 
-    net_args_.push_back({{DNNL_ARG_SRC, data_memory}, {DNNL_ARG_DST, out_memory}});
+    network_->net_args.push_back({{DNNL_ARG_SRC, data_memory}, {DNNL_ARG_DST, out_memory}});
   }
 
   void Add(const size_t& nid) {
@@ -361,32 +564,29 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
     // Memory and compute description.
     std::vector<dnnl::memory::dims> data_dims;
-    std::vector<dnnl::memory::desc> data_mds;
     std::vector<dnnl::memory> data_memories;
 
     ICHECK_EQ(node.GetInputs().size(), 2U);
+    // Both inputs in the layout of the first one.
+    dnnl::memory::desc data_md = EntryDesc(node.GetInputs()[0]);
     for (auto entry : node.GetInputs()) {
-      auto data_shape = nodes_[entry.id_].GetOpShape()[entry.index_];
-      dnnl::memory::desc data_md = GenDNNLMemDescByShape(data_shape, dt::f32);
-
-      data_dims.push_back(data_shape);
-      data_mds.push_back(data_md);
-      data_memories.push_back(BindDNNLMemory(entry, data_md));
+      data_dims.push_back(EntryShape(entry));
+      data_memories.push_back(GetMemory(entry, data_md));
     }
     ICHECK(data_dims[0] == data_dims[1]);
-    auto out_md = data_mds[0];
-    JSONGraphNodeEntry out_entry(nid, 0);
-    auto out_memory = BindDNNLMemory(out_entry, out_md);
+    auto out_md = data_md;
 
-    auto add_desc =
-        dnnl::binary::desc(dnnl::algorithm::binary_add, data_mds[0], data_mds[1], out_md);
+    auto add_desc = dnnl::binary::desc(dnnl::algorithm::binary_add, data_md, data_md, out_md);
     auto add_prim_desc = dnnl::binary::primitive_desc(add_desc, engine_);
     auto add = dnnl::binary(add_prim_desc);
-    net_.push_back(add);
+    network_->net.push_back(add);
+
+    JSONGraphNodeEntry out_entry(nid, 0);
+    auto out_memory = BindDNNLMemory(out_entry, out_md);
 
-    net_args_.push_back({{DNNL_ARG_SRC_0, data_memories[0]},
-                         {DNNL_ARG_SRC_1, data_memories[1]},
-                         {DNNL_ARG_DST, out_memory}});
+    network_->net_args.push_back({{DNNL_ARG_SRC_0, data_memories[0]},
+                                  {DNNL_ARG_SRC_1, data_memories[1]},
+                                  {DNNL_ARG_DST, out_memory}});
   }
 
   // Read from DNNL memory (+offset) and write to the handle.
@@ -431,12 +631,21 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   dnnl::engine engine_;
   /* The dnnl stream. */
   dnnl::stream stream_;
-  /* The network layers that are represented in dnnl primitives. */
-  std::vector<dnnl::primitive> net_;
-  /* The memory that is consumed by arguments. */
-  std::vector<std::unordered_map<int, dnnl::memory>> net_args_;
-  /* The entry ID to its corresponding output memory. */
-  std::unordered_map<uint32_t, std::pair<dnnl::memory, size_t>> entry_out_mem_;
+  /* The networks built for the input shapes, the most recently used first. */
+  std::list<std::pair<std::vector<int64_t>, std::unique_ptr<Network>>> networks_;
+  /* The input shapes to the networks. */
+  std::map<std::vector<int64_t>, decltype(networks_)::iterator> network_index_;
+  /* The maximum number of networks kept. */
+  int cache_capacity_;
+  /* The network being built, its batch size and the layouts of its blocked inputs. */
+  Network* network_{nullptr};
+  int64_t batch_size_{-1};
+  std::unordered_map<uint32_t, dnnl::memory::desc> input_descs_;
+  /* The entry IDs of the constants. */
+  std::unordered_set<uint32_t> const_eids_;
+  /* The indices of the inputs and outputs exchanged with other DNNL subgraphs as blocked. */
+  std::unordered_set<size_t> blocked_inputs_;
+  std::unordered_set<size_t> blocked_outputs_;
 };
 
 runtime::Module DNNLJSONRuntimeCreate(String symbol_name, String graph_json,
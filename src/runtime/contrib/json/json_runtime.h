@@ -27,8 +27,10 @@
 
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
 
 #include <cstddef>
+#include <map>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -92,6 +94,13 @@ class JSONRuntimeBase : public ModuleNode {
         this->initialized_ = true;
         *rv = 0;
       });
+    } else if ("__const_loader_" + this->symbol_name_ == name) {
+      // The function copying the constants to the devices, shared by the submodules of the
+      // metadata module.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        PackedFunc loader = args[0];
+        this->const_loader_ = loader;
+      });
     } else {
       return PackedFunc(nullptr);
     }
@@ -144,7 +153,16 @@ class JSONRuntimeBase : public ModuleNode {
    *
    * \param args The packed args.
    */
-  void SetInputOutputBuffers(const TVMArgs& args) {
+  void SetInputOutputBuffers(const TVMArgs& args) { SetInputOutputBuffers(args, &data_entry_); }
+
+  /*!
+   * \brief Set up the input and output buffers in a copy of the data entries, e.g. local to a
+   * call running concurrently with others.
+   *
+   * \param args The packed args.
+   * \param data_entry The data entries to bind the buffers to.
+   */
+  void SetInputOutputBuffers(const TVMArgs& args, std::vector<const DLTensor*>* data_entry) {
     ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
         << "Found mismatch in the number of provided data entryies and required.";
 
@@ -164,7 +182,7 @@ class JSONRuntimeBase : public ModuleNode {
 
       // Assign input/output the NDArray pointers to data entry so that we can directly
       // read/write host buffers.
-      data_entry_[eid] = arg;
+      (*data_entry)[eid] = arg;
     }
   }
 
@@ -213,11 +231,31 @@ class JSONRuntimeBase : public ModuleNode {
    * \param consts A list of constant NDArray to be used.
    */
   void SetupConstants(const Array<NDArray>& consts) {
+    consts_ = consts;
     for (size_t i = 0; i < consts.size(); ++i) {
       data_entry_[EntryID(const_idx_[i], 0)] = consts[i].operator->();
     }
   }
 
+  /*!
+   * \brief Get a constant on a device, copied on the first request. The copies are shared with
+   * the other JSON runtimes of the metadata module using the same constant.
+   *
+   * \param i The index of the constant.
+   * \param dev The device.
+   * \return The constant on the device.
+   */
+  NDArray GetConstantOnDevice(size_t i, Device dev) {
+    ICHECK_LT(i, consts_.size()) << "The constants have not been set up";
+    if (const_loader_ != nullptr) return const_loader_(consts_[i], dev);
+    auto key = std::make_tuple(i, static_cast<int>(dev.device_type), dev.device_id);
+    auto it = device_consts_.find(key);
+    if (it != device_consts_.end()) return it->second;
+    NDArray copy = consts_[i].CopyTo(dev);
+    device_consts_[key] = copy;
+    return copy;
+  }
+
   // Load the graph.
   void Load(dmlc::JSONReader* reader) {
     reader->BeginObject();
@@ -267,6 +305,12 @@ class JSONRuntimeBase : public ModuleNode {
   std::vector<uint32_t> input_var_eid_;
   /*! \brief input const node index. */
   std::vector<uint32_t> const_idx_;
+  /*! \brief The constants, shared with the other submodules of the metadata module. */
+  Array<NDArray> consts_;
+  /*! \brief The function copying the constants to the devices, given by the metadata module. */
+  TypedPackedFunc<NDArray(NDArray, Device)> const_loader_;
+  /*! \brief The copies of the constants, without a metadata module. */
+  std::map<std::tuple<size_t, int, int>, NDArray> device_consts_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
 };
@@ -22,9 +22,14 @@
  */
 
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <tuple>
 #include <vector>
 
 namespace tvm {
@@ -124,14 +129,314 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   }
 });
 
-template <typename DataType, typename OutType>
-void sort_impl(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend, bool is_argsort) {
-  auto data_ptr = static_cast<DataType*>(input->data);
-  auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
+namespace {
+
+/*! \brief The minimum number of elements sorted by a call before it is split across threads */
+constexpr int64_t kMinParallelWork = 1 << 15;
+/*! \brief The minimum length of a row before it is split across threads on its own */
+constexpr int64_t kMinParallelRowLength = 1 << 16;
+/*! \brief The minimum length of a row before the radix sort is used on its keys */
+constexpr int64_t kMinRadixLength = 256;
+
+/*!
+ * \brief Run `ftask(begin, end)` over the disjoint ranges of [0, n) on the thread pool
+ * \param n The number of items
+ * \param parallel Whether to split the items across threads, otherwise they are run inline
+ * \param ftask The task, which must not throw
+ */
+template <typename FTask>
+void ParallelFor(int64_t n, bool parallel, const FTask& ftask) {
+  if (!parallel || n <= 1 || threading::MaxConcurrency() <= 1) {
+    ftask(0, n);
+    return;
+  }
+  struct Closure {
+    const FTask* ftask;
+    int64_t n;
+  } closure{&ftask, n};
+  auto fworker = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) -> int {
+    const Closure* closure = static_cast<const Closure*>(cdata);
+    int64_t chunk = (closure->n + penv->num_task - 1) / penv->num_task;
+    int64_t begin = std::min(closure->n, task_id * chunk);
+    int64_t end = std::min(closure->n, begin + chunk);
+    if (begin < end) {
+      (*closure->ftask)(begin, end);
+    }
+    return 0;
+  };
+  int res = TVMBackendParallelLaunch(fworker, &closure, 0);
+  ICHECK_EQ(res, 0) << "Parallel sort failed";
+}
+
+/*!
+ * \brief The order preserving unsigned encoding of the keys sorted by the radix sort, where the
+ * equal keys are encoded the same, e.g. -0.0 and 0.0
+ */
+template <typename DataType>
+struct RadixKey {
+  static constexpr bool kEnabled = false;
+  using UType = uint8_t;
+  static UType Encode(DataType value) { return 0; }
+};
+
+template <>
+struct RadixKey<float> {
+  static constexpr bool kEnabled = true;
+  using UType = uint32_t;
+  static UType Encode(float value) {
+    UType bits;
+    value = value == 0.0f ? 0.0f : value;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 31) ? ~bits : (bits | 0x80000000u);
+  }
+};
+
+template <>
+struct RadixKey<double> {
+  static constexpr bool kEnabled = true;
+  using UType = uint64_t;
+  static UType Encode(double value) {
+    UType bits;
+    value = value == 0.0 ? 0.0 : value;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : (bits | 0x8000000000000000ull);
+  }
+};
+
+template <>
+struct RadixKey<int32_t> {
+  static constexpr bool kEnabled = true;
+  using UType = uint32_t;
+  static UType Encode(int32_t value) { return static_cast<UType>(value) ^ 0x80000000u; }
+};
+
+template <>
+struct RadixKey<int64_t> {
+  static constexpr bool kEnabled = true;
+  using UType = uint64_t;
+  static UType Encode(int64_t value) { return static_cast<UType>(value) ^ 0x8000000000000000ull; }
+};
+
+/*!
+ * \brief The order of the indices of the keys, where the equal keys are ordered by their indices,
+ * so that any sort under it gives the result of a stable sort
+ */
+template <typename DataType, bool kAscend>
+struct KeyIndexLess {
+  const DataType* keys;
+  bool operator()(int64_t lhs, int64_t rhs) const {
+    const DataType& a = keys[lhs];
+    const DataType& b = keys[rhs];
+    if (kAscend ? a < b : b < a) return true;
+    if (kAscend ? b < a : a < b) return false;
+    return lhs < rhs;
+  }
+};
+
+/*!
+ * \brief Sort the rows of a tensor, one at a time, keeping its scratch buffers across the rows
+ *
+ * The rows are sorted into the order of their indices, with the LSD radix sort on the encoded
+ * keys for the long rows of 32-bit and 64-bit keys, and with std::sort otherwise. The top k
+ * elements of a row are selected with std::nth_element when k is small. Both are stable, i.e.
+ * the equal keys keep the order of their indices.
+ */
+template <typename DataType>
+class RowSorter {
+ public:
+  explicit RowSorter(bool is_ascend) : is_ascend_(is_ascend) {}
+
+  /*!
+   * \brief Get the keys of a row as a contiguous array
+   * \param data The data of the tensor
+   * \param base The offset of the first element of the row
+   * \param n The length of the row
+   * \param stride The stride of the row
+   */
+  const DataType* Gather(const DataType* data, int64_t base, int64_t n, int64_t stride) {
+    if (stride == 1) {
+      return data + base;
+    }
+    keys_.resize(n);
+    for (int64_t i = 0; i < n; ++i) {
+      keys_[i] = data[base + i * stride];
+    }
+    return keys_.data();
+  }
+
+  /*!
+   * \brief Get the order of the first k indices of the sorted keys
+   * \param keys The keys of the row
+   * \param n The length of the row
+   * \param k The number of indices, at most n
+   * \param parallel Whether the row is split across threads
+   */
+  const int64_t* Sort(const DataType* keys, int64_t n, int64_t k, bool parallel) {
+    return is_ascend_ ? SortImpl<true>(keys, n, k, parallel)
+                      : SortImpl<false>(keys, n, k, parallel);
+  }
+
+ private:
+  template <bool kAscend>
+  const int64_t* SortImpl(const DataType* keys, int64_t n, int64_t k, bool parallel) {
+    KeyIndexLess<DataType, kAscend> less{keys};
+    order_.resize(n);
+    std::iota(order_.begin(), order_.end(), 0);
+    if (k * 4 <= n) {
+      return parallel ? SelectParallel(n, k, less) : Select(order_.data(), n, k, less);
+    }
+    if (parallel) {
+      return SortParallel(n, less);
+    }
+    if (RadixKey<DataType>::kEnabled && n >= kMinRadixLength) {
+      RadixSort<kAscend>(keys, n);
+    } else {
+      std::sort(order_.begin(), order_.end(), less);
+    }
+    return order_.data();
+  }
+
+  template <typename FLess>
+  static const int64_t* Select(int64_t* order, int64_t n, int64_t k, const FLess& less) {
+    if (k < n) {
+      std::nth_element(order, order + k, order + n, less);
+    }
+    std::sort(order, order + k, less);
+    return order;
+  }
+
+  /*! \brief Select the top k of each chunk of the row in parallel, then the top k of them */
+  template <typename FLess>
+  const int64_t* SelectParallel(int64_t n, int64_t k, const FLess& less) {
+    int64_t num_chunks = threading::MaxConcurrency();
+    int64_t chunk = (n + num_chunks - 1) / num_chunks;
+    int64_t* order = order_.data();
+    ParallelFor(num_chunks, true, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t lo = std::min(n, c * chunk), hi = std::min(n, lo + chunk);
+        if (hi - lo > k) {
+          std::nth_element(order + lo, order + lo + k, order + hi, less);
+        }
+      }
+    });
+    order_tmp_.clear();
+    for (int64_t lo = 0; lo < n; lo += chunk) {
+      int64_t hi = std::min(n, lo + std::min(k, chunk));
+      order_tmp_.insert(order_tmp_.end(), order + lo, order + hi);
+    }
+    return Select(order_tmp_.data(), static_cast<int64_t>(order_tmp_.size()), k, less);
+  }
+
+  /*! \brief Sort the chunks of the row in parallel, then merge them pairwise in parallel */
+  template <typename FLess>
+  const int64_t* SortParallel(int64_t n, const FLess& less) {
+    int64_t num_chunks = 1;
+    while (num_chunks * 2 <= threading::MaxConcurrency()) {
+      num_chunks *= 2;
+    }
+    int64_t chunk = (n + num_chunks - 1) / num_chunks;
+    order_tmp_.resize(n);
+    int64_t* src = order_.data();
+    int64_t* dst = order_tmp_.data();
+    ParallelFor(num_chunks, true, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; ++c) {
+        int64_t lo = std::min(n, c * chunk), hi = std::min(n, lo + chunk);
+        std::sort(src + lo, src + hi, less);
+      }
+    });
+    for (int64_t width = chunk; width < n; width *= 2) {
+      int64_t num_merges = (n + 2 * width - 1) / (2 * width);
+      ParallelFor(num_merges, true, [&](int64_t begin, int64_t end) {
+        for (int64_t m = begin; m < end; ++m) {
+          int64_t lo = m * 2 * width;
+          int64_t mid = std::min(n, lo + width), hi = std::min(n, lo + 2 * width);
+          std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+        }
+      });
+      std::swap(src, dst);
+    }
+    return src;
+  }
+
+  /*!
+   * \brief Sort the indices by the LSD radix sort on 8-bit digits of the encoded keys, skipping
+   * the digits all the keys share. The keys are complemented for a descending sort, which keeps
+   * the equal keys in the order of their indices.
+   */
+  template <bool kAscend>
+  void RadixSort(const DataType* keys, int64_t n) {
+    using UType = typename RadixKey<DataType>::UType;
+    constexpr int kNumDigits = sizeof(UType);
+    std::vector<UType>& ukeys = std::get<std::vector<UType>>(ukeys_);
+    std::vector<UType>& ukeys_tmp = std::get<std::vector<UType>>(ukeys_tmp_);
+    ukeys.resize(n);
+    ukeys_tmp.resize(n);
+    order_tmp_.resize(n);
+    int64_t hist[kNumDigits][256] = {};
+    for (int64_t i = 0; i < n; ++i) {
+      UType key = RadixKey<DataType>::Encode(keys[i]);
+      key = kAscend ? key : static_cast<UType>(~key);
+      ukeys[i] = key;
+      for (int d = 0; d < kNumDigits; ++d) {
+        ++hist[d][(key >> (d * 8)) & 0xFF];
+      }
+    }
+    UType* src_keys = ukeys.data();
+    UType* dst_keys = ukeys_tmp.data();
+    int64_t* src = order_.data();
+    int64_t* dst = order_tmp_.data();
+    for (int d = 0; d < kNumDigits; ++d) {
+      int shift = d * 8;
+      if (hist[d][(src_keys[0] >> shift) & 0xFF] == n) {
+        continue;
+      }
+      int64_t offset[256];
+      int64_t sum = 0;
+      for (int b = 0; b < 256; ++b) {
+        offset[b] = sum;
+        sum += hist[d][b];
+      }
+      for (int64_t i = 0; i < n; ++i) {
+        int64_t pos = offset[(src_keys[i] >> shift) & 0xFF]++;
+        dst_keys[pos] = src_keys[i];
+        dst[pos] = src[i];
+      }
+      std::swap(src_keys, dst_keys);
+      std::swap(src, dst);
+    }
+    if (src != order_.data()) {
+      std::copy(src, src + n, order_.data());
+    }
+  }
+
+  bool is_ascend_;
+  std::vector<DataType> keys_;
+  std::vector<int64_t> order_;
+  std::vector<int64_t> order_tmp_;
+  std::tuple<std::vector<uint8_t>, std::vector<uint32_t>, std::vector<uint64_t>> ukeys_;
+  std::tuple<std::vector<uint8_t>, std::vector<uint32_t>, std::vector<uint64_t>> ukeys_tmp_;
+};
+
+/*!
+ * \brief Sort the rows of a tensor along an axis
+ * \param input The tensor
+ * \param out_values The sorted values, or nullptr
+ * \param out_indices The indices of the sorted values, or nullptr
+ * \param axis The axis
+ * \param k The number of the sorted elements written to the outputs along the axis
+ * \param is_ascend Whether to sort in ascending order
+ */
+template <typename DataType, typename IndicesType>
+void SortAlongAxis(const DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int axis,
+                   int64_t k, bool is_ascend) {
+  const DataType* data_ptr = static_cast<const DataType*>(input->data);
+  DataType* values_ptr =
+      (out_values == nullptr) ? nullptr : static_cast<DataType*>(out_values->data);
+  IndicesType* indices_ptr =
+      (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
 
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
+  int64_t axis_mul_before = 1;
+  int64_t axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
     if (i < axis) {
       axis_mul_before *= input->shape[i];
@@ -139,41 +444,56 @@ void sort_impl(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend,
       axis_mul_after *= input->shape[i];
     }
   }
+  int64_t n = input->shape[axis];
+  int64_t num_rows = axis_mul_before * axis_mul_after;
+  int64_t cnt = std::min(k, n);
+  if (n == 0 || num_rows == 0) {
+    return;
+  }
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
+  auto sort_row = [&](RowSorter<DataType>* sorter, int64_t row, bool parallel) {
+    int64_t i = row / axis_mul_after, j = row % axis_mul_after;
+    int64_t src_base_idx = i * n * axis_mul_after + j;
+    int64_t dst_base_idx = i * k * axis_mul_after + j;
+    const DataType* keys = sorter->Gather(data_ptr, src_base_idx, n, axis_mul_after);
+    const int64_t* order = sorter->Sort(keys, n, cnt, parallel);
+    for (int64_t kk = 0; kk < cnt; ++kk) {
+      int64_t dst_idx = dst_base_idx + kk * axis_mul_after;
+      if (indices_ptr != nullptr) {
+        indices_ptr[dst_idx] = static_cast<IndicesType>(order[kk]);
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      if (is_argsort) {
-        for (int64_t k = 0; k < input->shape[axis]; ++k) {
-          out_ptr[base_idx + k * axis_mul_after] = static_cast<OutType>(sorter[k].first);
-        }
-      } else {
-        for (int64_t k = 0; k < input->shape[axis]; ++k) {
-          out_ptr[base_idx + k * axis_mul_after] = static_cast<OutType>(sorter[k].second);
-        }
+      if (values_ptr != nullptr) {
+        values_ptr[dst_idx] = keys[order[kk]];
       }
     }
+  };
+
+  if (num_rows < threading::MaxConcurrency() && n >= kMinParallelRowLength) {
+    // Few long rows, e.g. a topk over all the candidates, are each split across the threads.
+    RowSorter<DataType> sorter(is_ascend);
+    for (int64_t row = 0; row < num_rows; ++row) {
+      sort_row(&sorter, row, true);
+    }
+  } else {
+    ParallelFor(num_rows, num_rows * n >= kMinParallelWork, [&](int64_t begin, int64_t end) {
+      RowSorter<DataType> sorter(is_ascend);
+      for (int64_t row = begin; row < end; ++row) {
+        sort_row(&sorter, row, false);
+      }
+    });
   }
 }
 
+}  // namespace
+
 template <typename DataType, typename OutType>
 void argsort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  return sort_impl<DataType, OutType>(input, output, axis, is_ascend, true);
+  SortAlongAxis<DataType, OutType>(input, nullptr, output, axis, input->shape[axis], is_ascend);
 }
 
 template <typename DataType>
 void sort(DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend) {
-  return sort_impl<DataType, DataType>(input, output, axis, is_ascend, false);
+  SortAlongAxis<DataType, int64_t>(input, output, nullptr, axis, input->shape[axis], is_ascend);
 }
 
 // Argsort implemented C library sort.
@@ -303,52 +623,10 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.sort").set_body([](TVMArgs args, TVMRetVal
 template <typename DataType, typename IndicesType>
 void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, int axis,
           bool is_ascend) {
-  DataType* data_ptr = static_cast<DataType*>(input->data);
-  DataType* values_ptr =
-      (out_values == nullptr) ? nullptr : static_cast<DataType*>(out_values->data);
-  IndicesType* indices_ptr =
-      (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
   if (k < 1) {
     k = input->shape[axis];
   }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      sorter.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-      for (int64_t kk = 0; kk < input->shape[axis]; ++kk) {
-        int64_t full_idx = src_base_idx + kk * axis_mul_after;
-        sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
-      }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
-      }
-      int64_t cnt = k > 0 ? k : input->shape[axis];
-      for (int64_t kk = 0; kk < cnt; ++kk) {
-        if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<IndicesType>(sorter[kk].first);
-        }
-        if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] = static_cast<DataType>(sorter[kk].second);
-        }
-      }
-    }
-  }
+  SortAlongAxis<DataType, IndicesType>(input, out_values, out_indices, axis, k, is_ascend);
 }
 
 // Argsort implemented C library sort.
@@ -79,6 +79,29 @@ void TensorRTBuilder::AddInput(int nid, uint32_t entry_id, const JSONGraphNode&
     if (use_implicit_batch_ && shape.size() > 1) {
       shape.erase(shape.begin());
     }
+    auto it = profiles_.find(node_name);
+    if (it != profiles_.end()) {
+      ICHECK_EQ(shapes.size(), 1) << "The profile of " << node_name << " must be of a tensor.";
+      const auto& range = it->second;
+      std::vector<nvinfer1::Dims> profile_dims;
+      for (const auto& profile_shape : range) {
+        ICHECK_EQ(profile_shape.size(), shape.size())
+            << "The profile of " << node_name << " does not match the rank of the input.";
+        profile_dims.push_back(VectorToTrtDims(profile_shape));
+      }
+      for (size_t j = 0; j < shape.size(); ++j) {
+        ICHECK(range[0][j] <= range[1][j] && range[1][j] <= range[2][j])
+            << "The profile of " << node_name << " must have min <= opt <= max.";
+        if (range[0][j] != range[2][j]) {
+          shape[j] = -1;
+        } else {
+          ICHECK(shape[j] == -1 || shape[j] == range[0][j])
+              << "The profile of " << node_name << " does not match the static dim " << j;
+          shape[j] = range[0][j];
+        }
+      }
+      profile_dims_[name] = profile_dims;
+    }
     nvinfer1::Dims dims = VectorToTrtDims(shape);
     ICHECK(TypeMatch(dtypes[i], kDLFloat, 32)) << "Only FP32 inputs are supported.";
     auto input_tensor = network_->addInput(name.c_str(), nvinfer1::DataType::kFLOAT, dims);
@@ -88,6 +111,14 @@ void TensorRTBuilder::AddInput(int nid, uint32_t entry_id, const JSONGraphNode&
   }
 }
 
+void TensorRTBuilder::SetOptimizationProfiles(
+    const std::unordered_map<std::string, std::vector<std::vector<int64_t>>>& profiles) {
+  ICHECK(profiles.empty() || !use_implicit_batch_)
+      << "The optimization profiles need the explicit batch mode.";
+  ICHECK(network_input_names_.empty()) << "The profiles must be set before adding the inputs.";
+  profiles_ = profiles;
+}
+
 void TensorRTBuilder::AddConstant(int nid, const DLTensor* data) {
   nvinfer1::Weights weight = GetDLTensorAsWeights(data, kDLCPU);
   std::vector<int> shape(data->shape, data->shape + data->ndim);
@@ -149,6 +180,13 @@ void TensorRTBuilder::AddLayer(int nid, const JSONGraphNode& node) {
   }
 }
 
+void TensorRTBuilder::SetInt8Calibrator(nvinfer1::IInt8Calibrator* calibrator) {
+  if (calibrator != nullptr && !builder_->platformHasFastInt8()) {
+    LOG(WARNING) << "The GPU has no fast INT8 support, the INT8 TensorRT engine may be slow.";
+  }
+  int8_calibrator_ = calibrator;
+}
+
 TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
   // Process graph to create INetworkDefinition.
 // Build engine.
@@ -158,20 +196,32 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
   if (use_fp16_) {
     config_->setFlag(nvinfer1::BuilderFlag::kFP16);
   }
+  if (int8_calibrator_ != nullptr) {
+    config_->setFlag(nvinfer1::BuilderFlag::kINT8);
+    config_->setInt8Calibrator(int8_calibrator_);
+  }
   // Add profiles.
   if (!use_implicit_batch_) {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
       auto dims = network_->getInput(i)->getDimensions();
-      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN, dims);
-      profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, dims);
-      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, dims);
+      // The inputs without a range are static.
+      std::vector<nvinfer1::Dims> range = {dims, dims, dims};
+      auto it = profile_dims_.find(name);
+      if (it != profile_dims_.end()) range = it->second;
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN, range[0]);
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT, range[1]);
+      profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX, range[2]);
     }
     config_->addOptimizationProfile(profile);
   }
   nvinfer1::ICudaEngine* engine = builder_->buildEngineWithConfig(*network_, *config_);
 #else
+  if (int8_calibrator_ != nullptr) {
+    builder_->setInt8Mode(true);
+    builder_->setInt8Calibrator(int8_calibrator_);
+  }
   nvinfer1::ICudaEngine* engine = builder_->buildCudaEngine(*network_);
 #endif
   ICHECK_EQ(engine->getNbBindings(), network_input_names_.size() + network_output_names_.size());
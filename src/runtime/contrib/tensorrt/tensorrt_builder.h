@@ -83,6 +83,22 @@ class TensorRTBuilder {
    */
   void AddInput(int nid, uint32_t entry_id, const JSONGraphNode& node);
 
+  /*!
+   * \brief Build the engine for ranges of input shapes instead of the static shapes, in explicit
+   * batch mode. Must be called before the inputs are added.
+   * \param profiles The (min, opt, max) shapes of the inputs, by input node name. The dims which
+   * differ between min and max are dynamic in the engine.
+   */
+  void SetOptimizationProfiles(
+      const std::unordered_map<std::string, std::vector<std::vector<int64_t>>>& profiles);
+
+  /*!
+   * \brief Build an INT8 engine, calibrated by the calibrator. Without a calibrator the engine is
+   * in the precision of use_fp16.
+   * \param calibrator The calibrator, owned by the caller and alive until BuildEngine returns.
+   */
+  void SetInt8Calibrator(nvinfer1::IInt8Calibrator* calibrator);
+
   /*!
    * \brief Add TensorRT weight for input constant in network definition.
    * \param nid The input node id.
@@ -156,6 +172,15 @@ class TensorRTBuilder {
   /*! \brief Batch size to optimize for. */
   int batch_size_;
 
+  /*! \brief The calibrator of an INT8 engine, nullptr if not INT8. */
+  nvinfer1::IInt8Calibrator* int8_calibrator_{nullptr};
+
+  /*! \brief The (min, opt, max) shapes of the inputs, by input node name. */
+  std::unordered_map<std::string, std::vector<std::vector<int64_t>>> profiles_;
+
+  /*! \brief The (min, opt, max) TRT dims of the inputs with a profile, by binding name. */
+  std::unordered_map<std::string, std::vector<nvinfer1::Dims>> profile_dims_;
+
   /*! \brief Input names. */
   std::vector<std::string> network_input_names_;
 
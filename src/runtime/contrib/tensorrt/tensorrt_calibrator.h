@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/contrib/tensorrt/tensorrt_calibrator.h
+ * \brief Contains the TensorRTCalibrator class which feeds the inputs of the first runs of a
+ * subgraph to TensorRT to calibrate its INT8 engines, and keeps the calibration table so that the
+ * engines built for the other batch sizes are not calibrated again.
+ */
+
+#ifndef TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_CALIBRATOR_H_
+#define TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_CALIBRATOR_H_
+
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "NvInfer.h"
+
+namespace tvm {
+namespace runtime {
+namespace contrib {
+
+/*! \brief INT8 calibrator of the engines of a subgraph. */
+class TensorRTCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  /*!
+   * \brief Create a calibrator.
+   * \param use_implicit_batch Whether the engines are in implicit batch mode, where the batches
+   * are given with their batch size.
+   * \param table The calibration table of an earlier calibration, empty to calibrate from the
+   * batches added.
+   */
+  TensorRTCalibrator(bool use_implicit_batch, std::string table)
+      : use_implicit_batch_(use_implicit_batch), table_(std::move(table)) {}
+
+  /*!
+   * \brief Add the inputs of a run as a calibration batch, copied to the host. The batches of
+   * other shapes than the first are skipped, TensorRT calibrating on batches of the same size.
+   * \param inputs The input tensors, by binding name.
+   * \return The number of batches added.
+   */
+  size_t AddBatch(const std::unordered_map<std::string, const DLTensor*>& inputs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!table_.empty()) return batches_.size();
+    std::unordered_map<std::string, NDArray> batch;
+    for (const auto& it : inputs) {
+      std::vector<int64_t> shape(it.second->shape, it.second->shape + it.second->ndim);
+      if (!batches_.empty()) {
+        ShapeTuple first = batches_[0].at(it.first).Shape();
+        if (!std::equal(shape.begin(), shape.end(), first.begin(), first.end())) {
+          return batches_.size();
+        }
+      }
+      NDArray arr = NDArray::Empty(shape, it.second->dtype, {kDLCPU, 0});
+      arr.CopyFrom(it.second);
+      batch.emplace(it.first, arr);
+    }
+    batches_.push_back(std::move(batch));
+    return batches_.size();
+  }
+
+  /*! \brief Whether the calibration table is known. */
+  bool HasTable() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !table_.empty();
+  }
+
+  /*! \brief The calibration table, empty until the first INT8 engine is built. */
+  std::string GetTable() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table_;
+  }
+
+  int getBatchSize() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!use_implicit_batch_ || batches_.empty()) return 1;
+    const NDArray& arr = batches_[0].begin()->second;
+    return arr->ndim == 0 ? 1 : static_cast<int>(arr->shape[0]);
+  }
+
+  bool getBatch(void* bindings[], const char* names[], int nbBindings) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (next_batch_ >= batches_.size()) return false;
+    const auto& batch = batches_[next_batch_++];
+    for (int i = 0; i < nbBindings; ++i) {
+      auto it = batch.find(names[i]);
+      ICHECK(it != batch.end()) << "No calibration data for the TensorRT input " << names[i];
+      NDArray& device_buffer = device_buffers_[names[i]];
+      if (!device_buffer.defined()) {
+        device_buffer = NDArray::Empty(it->second.Shape(), it->second.DataType(), {kDLCUDA, 0});
+      }
+      device_buffer.CopyFrom(it->second);
+      bindings[i] = device_buffer->data;
+    }
+    return true;
+  }
+
+  const void* readCalibrationCache(size_t& length) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A calibration starts again from the first batch.
+    next_batch_ = 0;
+    length = table_.size();
+    return table_.empty() ? nullptr : table_.data();
+  }
+
+  void writeCalibrationCache(const void* cache, size_t length) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.assign(static_cast<const char*>(cache), length);
+    // The batches are not needed anymore.
+    batches_.clear();
+    device_buffers_.clear();
+  }
+
+ private:
+  /*! \brief Whether the engines are in implicit batch mode. */
+  bool use_implicit_batch_;
+  /*! \brief The calibration table. */
+  std::string table_;
+  /*! \brief The calibration batches, each the input tensors by binding name. */
+  std::vector<std::unordered_map<std::string, NDArray>> batches_;
+  /*! \brief The next batch to give to TensorRT. */
+  size_t next_batch_{0};
+  /*! \brief The GPU buffers of the inputs given to TensorRT, by binding name. */
+  std::unordered_map<std::string, NDArray> device_buffers_;
+  /*! \brief Guards the members, the runs adding batches while an engine is calibrated. */
+  mutable std::mutex mutex_;
+};
+
+}  // namespace contrib
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_CALIBRATOR_H_
@@ -26,15 +26,25 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
 
 #include "../../file_utils.h"
 #include "../json/json_node.h"
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include <cuda_runtime_api.h>
+
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
+#include "tensorrt_calibrator.h"
 #endif
 
 namespace tvm {
@@ -50,6 +60,21 @@ struct PairHash {
 
 using namespace tvm::runtime::json;
 
+#ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+/*!
+ * \brief An execution context of an engine, with the CUDA stream it runs on and the GPU buffers
+ * of its bindings. Each concurrent call of a subgraph runs on its own context.
+ */
+struct TensorRTContext {
+  nvinfer1::IExecutionContext* context;
+  cudaStream_t stream;
+  /*! \brief Map of binding index to GPU buffers for inputs and outputs. Only used when target
+   * device is not "cuda". Since TensorRT execution can only read data from GPU, we need to copy
+   * data from the runtime device to these buffers first. */
+  std::unordered_map<int, NDArray> device_buffers;
+};
+#endif
+
 class TensorRTRuntime : public JSONRuntimeBase {
  public:
   /*!
@@ -85,9 +110,12 @@ class TensorRTRuntime : public JSONRuntimeBase {
     ICHECK_EQ(consts.size(), const_idx_.size())
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
+    SetupInt8Calibration();
     if (GetCachedEnginesFromDisk()) return;
     SetupConstants(consts);
     multi_engine_mode_ = dmlc::GetEnv("TVM_TENSORRT_MULTI_ENGINE", false);
+    // The engine of the profiles does not depend on the inputs, start building it now.
+    StartProfileEngineBuild();
   }
 
   void LoadGlobalAttributes() {
@@ -106,30 +134,116 @@ class TensorRTRuntime : public JSONRuntimeBase {
           max_workspace_size_ =
               std::stoul(nodes_[i].GetAttr<std::vector<std::string>>("max_workspace_size")[0]);
         }
-        return;
+        if (nodes_[i].HasAttr("use_int8")) {
+          use_int8_ = std::stoi(nodes_[i].GetAttr<std::vector<std::string>>("use_int8")[0]);
+        }
+        if (nodes_[i].HasAttr("int8_calibration_table")) {
+          calibration_table_ =
+              nodes_[i].GetAttr<std::vector<std::string>>("int8_calibration_table")[0];
+        }
+        break;
       }
     }
+    use_int8_ = use_int8_ || dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      if (!nodes_[i].HasAttr("profile_inputs")) continue;
+      auto names = nodes_[i].GetAttr<std::vector<std::string>>("profile_inputs");
+      auto min_shapes = nodes_[i].GetAttr<std::vector<std::string>>("profile_min_shapes");
+      auto opt_shapes = nodes_[i].GetAttr<std::vector<std::string>>("profile_opt_shapes");
+      auto max_shapes = nodes_[i].GetAttr<std::vector<std::string>>("profile_max_shapes");
+      for (size_t j = 0; j < names.size(); ++j) {
+        profiles_[names[j]] = {ParseShape(min_shapes[j]), ParseShape(opt_shapes[j]),
+                               ParseShape(max_shapes[j])};
+      }
+      ICHECK(!use_implicit_batch_) << "The optimization profiles need the explicit batch mode.";
+      return;
+    }
+  }
+
+  /*! \brief Parse the comma separated dims of a shape. */
+  static std::vector<int64_t> ParseShape(const std::string& dims) {
+    std::vector<int64_t> shape;
+    std::istringstream is(dims);
+    std::string dim;
+    while (std::getline(is, dim, ',')) shape.push_back(std::stoll(dim));
+    return shape;
   }
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+  /*!
+   * \brief Get a packed function. The calls of the subgraph bind their arguments to their own
+   * data entries, so that the calls of several threads run concurrently.
+   */
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) override {
+    if (name != symbol_name_) return JSONRuntimeBase::GetFunction(name, sptr_to_self);
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(this->initialized_) << "The module has not been initialized";
+      std::vector<const DLTensor*> data_entry = this->data_entry_;
+      this->SetInputOutputBuffers(args, &data_entry);
+      this->Run(data_entry);
+    });
+  }
+
+  /*! \brief Destroy an engine and its execution contexts. */
+  void DestroyEngine(const TensorRTEngineAndContext& engine_and_context) {
+    for (const auto& context : free_contexts_[engine_and_context.engine]) {
+      context->context->destroy();
+      cudaStreamDestroy(context->stream);
+    }
+    free_contexts_.erase(engine_and_context.engine);
+    if (engine_and_context.context != nullptr) engine_and_context.context->destroy();
+    engine_and_context.engine->destroy();
+  }
+
   /*! \brief Destroy engines and contexts. */
   void DestroyEngines() {
     for (auto& it : trt_engine_cache_) {
-      it.second.context->destroy();
-      it.second.engine->destroy();
+      DestroyEngine(it.second);
     }
     trt_engine_cache_.clear();
   }
 
-  ~TensorRTRuntime() { DestroyEngines(); }
+  /*! \brief Destroy the engines built for a batch size, keeping the engine of the profiles. */
+  void DestroyBatchEngines() {
+    for (auto it = trt_engine_cache_.begin(); it != trt_engine_cache_.end();) {
+      if (it->first.second == kProfileEngine) {
+        ++it;
+        continue;
+      }
+      DestroyEngine(it->second);
+      it = trt_engine_cache_.erase(it);
+    }
+  }
+
+  ~TensorRTRuntime() {
+    // Wait for the engine built in the background, to destroy it too.
+    TakeProfileEngine();
+    DestroyEngines();
+  }
 
   /*! \brief Run inference using built engine. */
-  void Run() override {
-    auto& engine_and_context = GetOrBuildEngine();
-    int batch_size = GetBatchSize();
+  void Run() override { Run(data_entry_); }
+
+  /*!
+   * \brief Run inference on the given data entries, using a free execution context of the engine
+   * serving their shapes. The engines are only built or replaced while no call runs.
+   */
+  void Run(const std::vector<const DLTensor*>& data_entry) {
+    int batch_size = GetBatchSize(data_entry);
     if (batch_size == 0) return;
-    auto engine = engine_and_context.engine;
-    auto context = engine_and_context.context;
+    std::shared_lock<std::shared_timed_mutex> lock(engines_mutex_);
+    TensorRTEngineAndContext* engine_and_context;
+    while ((engine_and_context = FindEngine(data_entry)) == nullptr) {
+      lock.unlock();
+      {
+        std::unique_lock<std::shared_timed_mutex> build_lock(engines_mutex_);
+        BuildEngineFor(data_entry);
+      }
+      lock.lock();
+    }
+    auto engine = engine_and_context->engine;
+    std::unique_ptr<TensorRTContext> trt_context = AcquireContext(engine_and_context);
+    auto context = trt_context->context;
     std::vector<void*> bindings(engine->getNbBindings(), nullptr);
     // Setup input bindings.
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
@@ -140,11 +254,15 @@ class TensorRTRuntime : public JSONRuntimeBase {
           const std::string name = nodes_[nid].GetOpName() + "_" + std::to_string(j);
           int binding_index = engine->getBindingIndex(name.c_str());
           ICHECK_NE(binding_index, -1);
-          if (data_entry_[eid]->device.device_type == kDLCUDA) {
-            bindings[binding_index] = data_entry_[eid]->data;
+#if TRT_VERSION_GE(6, 0, 1)
+          if (!use_implicit_batch_) SetBindingDimensions(context, binding_index, data_entry[eid]);
+#endif
+          if (data_entry[eid]->device.device_type == kDLCUDA) {
+            bindings[binding_index] = data_entry[eid]->data;
           } else {
-            auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
-            device_buffer.CopyFrom(data_entry_[eid]);
+            auto device_buffer =
+                GetOrAllocateDeviceBuffer(trt_context.get(), data_entry[eid], binding_index);
+            device_buffer.CopyFrom(data_entry[eid]);
             bindings[binding_index] = device_buffer->data;
           }
         }
@@ -153,44 +271,209 @@ class TensorRTRuntime : public JSONRuntimeBase {
     // Setup output bindings.
     for (size_t i = 0; i < outputs_.size(); ++i) {
       uint32_t eid = EntryID(outputs_[i]);
-      const std::string& name = engine_and_context.outputs[i];
+      const std::string& name = engine_and_context->outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
-      if (data_entry_[eid]->device.device_type == kDLCUDA) {
-        bindings[binding_index] = data_entry_[eid]->data;
+      if (data_entry[eid]->device.device_type == kDLCUDA) {
+        bindings[binding_index] = data_entry[eid]->data;
       } else {
-        auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
+        auto device_buffer =
+            GetOrAllocateDeviceBuffer(trt_context.get(), data_entry[eid], binding_index);
         bindings[binding_index] = device_buffer->data;
       }
     }
 
+    cudaStream_t stream = trt_context->stream;
 #if TRT_VERSION_GE(6, 0, 1)
     if (use_implicit_batch_) {
-      ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+          << "Running TensorRT failed.";
     } else {
-      ICHECK(context->executeV2(bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueueV2(bindings.data(), stream, nullptr)) << "Running TensorRT failed.";
     }
 #else
-    ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+    ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+        << "Running TensorRT failed.";
 #endif
+    ICHECK_EQ(cudaStreamSynchronize(stream), cudaSuccess) << "Running TensorRT failed.";
 
     // Copy outputs from GPU buffers if needed.
     for (size_t i = 0; i < outputs_.size(); ++i) {
       uint32_t eid = EntryID(outputs_[i]);
-      const std::string& name = engine_and_context.outputs[i];
+      const std::string& name = engine_and_context->outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
-      if (data_entry_[eid]->device.device_type != kDLCUDA) {
-        auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
-        device_buffer.CopyTo(const_cast<DLTensor*>(data_entry_[eid]));
+      if (data_entry[eid]->device.device_type != kDLCUDA) {
+        auto device_buffer =
+            GetOrAllocateDeviceBuffer(trt_context.get(), data_entry[eid], binding_index);
+        device_buffer.CopyTo(const_cast<DLTensor*>(data_entry[eid]));
       }
     }
+    ReleaseContext(engine, std::move(trt_context));
+    lock.unlock();
+    RecordCalibrationBatch(data_entry);
   }
 
  private:
+#if TRT_VERSION_GE(6, 0, 1)
+  /*! \brief Set the shape of an input binding with dynamic dims to the shape of the input. */
+  void SetBindingDimensions(nvinfer1::IExecutionContext* context, int binding_index,
+                            const DLTensor* data) {
+    nvinfer1::Dims engine_dims = context->getEngine().getBindingDimensions(binding_index);
+    if (std::find(engine_dims.d, engine_dims.d + engine_dims.nbDims, -1) ==
+        engine_dims.d + engine_dims.nbDims) {
+      return;
+    }
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+    ICHECK(context->setBindingDimensions(binding_index, VectorToTrtDims(shape)))
+        << "The input shape is outside of the optimization profile.";
+  }
+#endif
+
+  /*! \brief The path of the calibration table in TVM_TENSORRT_CACHE_DIR, empty if not set. */
+  std::string CalibrationTablePath() {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return "";
+    return cache_dir + "/" + symbol_name_ + "_int8.calib";
+  }
+
+  /*!
+   * \brief Create the INT8 calibrator, with the calibration table given at build time or cached
+   * in TVM_TENSORRT_CACHE_DIR if any. The table is shared by the engines of all the batch sizes.
+   * Without a table, the inputs of the first TVM_TENSORRT_CALIBRATION_BATCHES runs calibrate the
+   * engines, which run in the precision of TVM_TENSORRT_USE_FP16 until then.
+   */
+  void SetupInt8Calibration() {
+    if (!use_int8_) return;
+    std::string table = calibration_table_;
+    std::string path = CalibrationTablePath();
+    if (table.empty() && !path.empty()) {
+      std::ifstream infile(path, std::ios::binary);
+      if (infile.good()) {
+        DLOG(INFO) << "Loading cached TensorRT calibration table from " << path;
+        infile.close();
+        LoadBinaryFromFile(path, &table);
+        calibration_table_saved_ = true;
+      }
+    }
+    num_calibration_batches_ = dmlc::GetEnv("TVM_TENSORRT_CALIBRATION_BATCHES", 1);
+    ICHECK_GT(num_calibration_batches_, 0) << "TVM_TENSORRT_CALIBRATION_BATCHES must be positive";
+    calibrator_.reset(new TensorRTCalibrator(use_implicit_batch_, table));
+    calibration_done_ = !table.empty();
+  }
+
+  /*!
+   * \brief Add the inputs of a run to the calibration batches. Once there are enough, the engines
+   * built meanwhile are replaced by INT8 engines, the first of which calibrates on the batches.
+   */
+  void RecordCalibrationBatch(const std::vector<const DLTensor*>& data_entry) {
+    if (!calibrator_ || calibration_done_) return;
+    std::unordered_map<std::string, const DLTensor*> inputs;
+    for (size_t i = 0; i < input_nodes_.size(); ++i) {
+      auto nid = input_nodes_[i];
+      if (nodes_[nid].GetOpType() != "input") continue;
+      for (size_t j = 0; j < nodes_[nid].GetOpShape().size(); ++j) {
+        inputs[nodes_[nid].GetOpName() + "_" + std::to_string(j)] = data_entry[EntryID(nid, j)];
+      }
+    }
+    if (calibrator_->AddBatch(inputs) < static_cast<size_t>(num_calibration_batches_)) return;
+    std::unique_lock<std::shared_timed_mutex> lock(engines_mutex_);
+    if (calibration_done_) return;
+    calibration_done_ = true;
+    DLOG(INFO) << "Collected the calibration batches of TensorRT subgraph " << symbol_name_
+               << ", replacing its engines with INT8 engines";
+    TakeProfileEngine();
+    DestroyEngines();
+    max_batch_size_ = -1;
+    StartProfileEngineBuild();
+  }
+
+  /*! \brief Save the calibration table to TVM_TENSORRT_CACHE_DIR once calibrated. */
+  void SaveCalibrationTable() {
+    std::string path = CalibrationTablePath();
+    if (calibration_table_saved_ || path.empty() || !calibrator_->HasTable()) return;
+    DLOG(INFO) << "Caching TensorRT calibration table to " << path;
+    SaveBinaryToFile(path, calibrator_->GetTable());
+    calibration_table_saved_ = true;
+  }
+
+  /*!
+   * \brief Take a free execution context of the engine, or create one when all are in use. The
+   * first context is the one created with the engine.
+   */
+  std::unique_ptr<TensorRTContext> AcquireContext(TensorRTEngineAndContext* engine_and_context) {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    auto& free_contexts = free_contexts_[engine_and_context->engine];
+    if (!free_contexts.empty()) {
+      std::unique_ptr<TensorRTContext> context = std::move(free_contexts.back());
+      free_contexts.pop_back();
+      return context;
+    }
+    std::unique_ptr<TensorRTContext> context(new TensorRTContext());
+    if (engine_and_context->context != nullptr) {
+      context->context = engine_and_context->context;
+      engine_and_context->context = nullptr;
+    } else {
+      DLOG(INFO) << "Creating a new TensorRT execution context for subgraph " << symbol_name_;
+      context->context = engine_and_context->engine->createExecutionContext();
+    }
+    ICHECK_EQ(cudaStreamCreate(&context->stream), cudaSuccess);
+    return context;
+  }
+
+  /*! \brief Return an execution context to the free contexts of its engine. */
+  void ReleaseContext(const nvinfer1::ICudaEngine* engine,
+                      std::unique_ptr<TensorRTContext> context) {
+    std::lock_guard<std::mutex> lock(contexts_mutex_);
+    free_contexts_[engine].push_back(std::move(context));
+  }
+
+  /*! \brief Whether the shapes of the inputs are within the ranges of the profiles. */
+  bool InputsWithinProfiles(const std::vector<const DLTensor*>& data_entry) {
+    if (profiles_.empty()) return false;
+    for (size_t i = 0; i < input_nodes_.size(); ++i) {
+      auto nid = input_nodes_[i];
+      if (nodes_[nid].GetOpType() != "input") continue;
+      auto it = profiles_.find(nodes_[nid].GetOpName());
+      if (it == profiles_.end()) continue;
+      const DLTensor* data = data_entry[EntryID(nid, 0)];
+      const auto& range = it->second;
+      if (static_cast<size_t>(data->ndim) != range[0].size()) return false;
+      for (int j = 0; j < data->ndim; ++j) {
+        if (data->shape[j] < range[0][j] || data->shape[j] > range[2][j]) return false;
+      }
+    }
+    return true;
+  }
+
+  /*!
+   * \brief Build the engine serving the ranges of the profiles in a background thread, so that the
+   * requests do not wait for the build unless they arrive before it is done.
+   */
+  void StartProfileEngineBuild() {
+    if (profiles_.empty()) return;
+    DLOG(INFO) << "Building TensorRT engine for the optimization profiles of subgraph "
+               << symbol_name_ << " in the background";
+    const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false);
+    profile_engine_ = std::async(std::launch::async, [this, use_fp16]() {
+      TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
+                              use_fp16, 1);
+      builder.SetOptimizationProfiles(profiles_);
+      return BuildEngine(&builder);
+    });
+  }
+
+  /*! \brief Wait for the engine built in the background, if any, and move it to the cache. */
+  void TakeProfileEngine() {
+    if (!profile_engine_.valid()) return;
+    trt_engine_cache_[std::make_pair(symbol_name_, kProfileEngine)] = profile_engine_.get();
+    DLOG(INFO) << "Finished building TensorRT engine for the optimization profiles of subgraph "
+               << symbol_name_;
+  }
+
   /*! \brief Get batch size for engine from the runtime input shapes. */
-  int GetBatchSize() {
-    return data_entry_[input_var_eid_[0]]->ndim == 0 ? 1 : data_entry_[input_var_eid_[0]]->shape[0];
+  int GetBatchSize(const std::vector<const DLTensor*>& data_entry) {
+    return data_entry[input_var_eid_[0]]->ndim == 0 ? 1 : data_entry[input_var_eid_[0]]->shape[0];
   }
 
   /*! \brief Find an engine in the cache which we can reuse depending on the mode. If no compatible
@@ -212,39 +495,73 @@ class TensorRTRuntime : public JSONRuntimeBase {
     return false;
   }
 
+  /*! \brief Find the engine serving the shapes of the inputs in the cache, nullptr if none. */
+  TensorRTEngineAndContext* FindEngine(const std::vector<const DLTensor*>& data_entry) {
+    if (InputsWithinProfiles(data_entry)) {
+      auto it = trt_engine_cache_.find(std::make_pair(symbol_name_, kProfileEngine));
+      if (it != trt_engine_cache_.end()) return &it->second;
+      // Wait for the engine built in the background instead of building another.
+      if (profile_engine_.valid()) return nullptr;
+    }
+    int compatible_engine_batch_size = -1;
+    if (FindCompatibleEngine(GetBatchSize(data_entry), &compatible_engine_batch_size)) {
+      auto it = trt_engine_cache_.find(std::make_pair(symbol_name_, compatible_engine_batch_size));
+      if (it != trt_engine_cache_.end()) return &it->second;
+    }
+    return nullptr;
+  }
+
   /*!
    * \brief Build TensorRT engine from JSON representation and cache it. If compatible engine is
-   * already built, do nothing.
+   * already built, do nothing. Must hold engines_mutex_ exclusively.
    */
-  TensorRTEngineAndContext& GetOrBuildEngine() {
-    int batch_size = GetBatchSize();
-    int compatible_engine_batch_size = -1;
-    if (FindCompatibleEngine(batch_size, &compatible_engine_batch_size)) {
-      // A compatible engine already exists.
-      return trt_engine_cache_.at(std::make_pair(symbol_name_, compatible_engine_batch_size));
+  void BuildEngineFor(const std::vector<const DLTensor*>& data_entry) {
+    // Another call may have built it while waiting for the lock.
+    if (FindEngine(data_entry) != nullptr) return;
+    if (InputsWithinProfiles(data_entry) && profile_engine_.valid()) {
+      TakeProfileEngine();
+      CacheEngineToDisk(kProfileEngine);
+      return;
+    }
+    if (!profiles_.empty()) {
+      LOG(WARNING) << "The input shapes of TensorRT subgraph " << symbol_name_
+                   << " are outside of the optimization profiles, building an engine for them.";
+    }
+    int batch_size = GetBatchSize(data_entry);
+    // The engine calibrating on the batches serves their batch size.
+    int engine_batch_size = batch_size;
+    if (use_implicit_batch_ && calibration_done_ && !calibrator_->HasTable()) {
+      engine_batch_size = std::max(batch_size, calibrator_->getBatchSize());
     }
     // For single engine mode, remove previous engine and update max_batch_size.
     if (!multi_engine_mode_) {
-      DestroyEngines();
-      max_batch_size_ = batch_size;
+      DestroyBatchEngines();
+      max_batch_size_ = engine_batch_size;
     }
     DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
-               << " with batch size " << batch_size;
+               << " with batch size " << engine_batch_size;
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false);
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
-                            use_fp16, batch_size);
+                            use_fp16, engine_batch_size);
+    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = BuildEngine(&builder);
+    DLOG(INFO) << "Finished building TensorRT engine for subgraph " << symbol_name_
+               << " with batch size " << engine_batch_size;
+    CacheEngineToDisk(batch_size);
+  }
 
+  /*! \brief Add the inputs, constants, layers and outputs of the subgraph and build the engine. */
+  TensorRTEngineAndContext BuildEngine(TensorRTBuilder* builder) {
     // Add inputs and constants.
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
       auto nid = input_nodes_[i];
       const auto& node = nodes_[nid];
       std::string name = node.GetOpName();
       if (node.GetOpType() == "input") {
-        builder.AddInput(nid, EntryID(nid, 0), node);
+        builder->AddInput(nid, EntryID(nid, 0), node);
       } else {
         ICHECK_EQ(node.GetOpType(), "const");
         uint32_t eid = EntryID(nid, 0);
-        builder.AddConstant(nid, data_entry_[eid]);
+        builder->AddConstant(nid, data_entry_[eid]);
       }
     }
 
@@ -252,20 +569,21 @@ class TensorRTRuntime : public JSONRuntimeBase {
     for (size_t nid = 0; nid < nodes_.size(); ++nid) {
       const auto& node = nodes_[nid];
       if (node.GetOpType() != "kernel") continue;
-      builder.AddLayer(nid, node);
+      builder->AddLayer(nid, node);
     }
 
     // Add outputs.
     for (size_t i = 0; i < outputs_.size(); ++i) {
-      builder.AddOutput(outputs_[i], EntryID(outputs_[i]));
+      builder->AddOutput(outputs_[i], EntryID(outputs_[i]));
     }
 
-    // Build engine.
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = builder.BuildEngine();
-    DLOG(INFO) << "Finished building TensorRT engine for subgraph " << symbol_name_
-               << " with batch size " << batch_size;
-    CacheEngineToDisk();
-    return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    // Build engine. The INT8 builds are serialized, the first one calibrating.
+    if (!calibrator_ || !calibration_done_) return builder->BuildEngine();
+    std::lock_guard<std::mutex> lock(int8_build_mutex_);
+    builder->SetInt8Calibrator(calibrator_.get());
+    TensorRTEngineAndContext engine_and_context = builder->BuildEngine();
+    SaveCalibrationTable();
+    return engine_and_context;
   }
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
@@ -300,7 +618,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
     helper.DeclareField("inputs", &engine_and_context.inputs);
     helper.DeclareField("outputs", &engine_and_context.outputs);
     helper.ReadAllFields(&reader);
-    const int batch_size = 1;
+    const int batch_size = profiles_.empty() ? 1 : kProfileEngine;
     trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
     return true;
   }
@@ -308,10 +626,11 @@ class TensorRTRuntime : public JSONRuntimeBase {
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
    * directory so it can be loaded later.
    */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
+  void CacheEngineToDisk(int batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return;
+    // The engines built while collecting the calibration batches are not INT8.
+    if (use_int8_ && !calibration_done_) return;
     std::string key = GetSubgraphKey();
     std::string path = cache_dir + "/" + key + ".plan";
     DLOG(INFO) << "Caching TensorRT engine to " << path;
@@ -338,40 +657,66 @@ class TensorRTRuntime : public JSONRuntimeBase {
     // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
     // instead use a hash of graph_json and all weights to allow many models in the same directory,
     // but the cost of computing the hash is high.
+    if (use_int8_) return symbol_name_ + "_int8";
     return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
   }
 
-  /*! \brief Retreive a GPU buffer for input or output or allocate if needed. */
-  NDArray GetOrAllocateDeviceBuffer(int entry_id, int binding_index) {
-    std::vector<int64_t> shape(data_entry_[entry_id]->shape,
-                               data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
-    if (device_buffers_.count(binding_index)) {
+  /*! \brief Retreive a GPU buffer of a context for input or output or allocate if needed. */
+  NDArray GetOrAllocateDeviceBuffer(TensorRTContext* context, const DLTensor* data,
+                                    int binding_index) {
+    auto& device_buffers = context->device_buffers;
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+    if (device_buffers.count(binding_index)) {
       // Buffer is already initialized.
-      if (shape[0] > device_buffers_[binding_index]->shape[0]) {
+      if (shape[0] > device_buffers[binding_index]->shape[0]) {
         // Buffer is too small. Need to allocate bigger buffer.
-        device_buffers_[binding_index] =
-            runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
-      } else if (shape[0] < device_buffers_[binding_index]->shape[0]) {
+        device_buffers[binding_index] = runtime::NDArray::Empty(shape, data->dtype, {kDLCUDA, 0});
+      } else if (shape[0] < device_buffers[binding_index]->shape[0]) {
         // Buffer is too large. Create view.
-        return device_buffers_[binding_index].CreateView(shape, data_entry_[entry_id]->dtype);
+        return device_buffers[binding_index].CreateView(shape, data->dtype);
       }
     } else {
       // Buffer not initialized yet.
-      device_buffers_[binding_index] =
-          runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
+      device_buffers[binding_index] = runtime::NDArray::Empty(shape, data->dtype, {kDLCUDA, 0});
     }
-    return device_buffers_.at(binding_index);
+    return device_buffers.at(binding_index);
   }
 
+  /*! \brief The key of the engine of the optimization profiles in trt_engine_cache_. */
+  static constexpr int kProfileEngine = -1;
+
+  /*! \brief The engine of the optimization profiles, while it is built in the background. */
+  std::future<TensorRTEngineAndContext> profile_engine_;
+
   /*! \brief Map of function name and max batch size to TRT engine if built already. */
   std::unordered_map<std::pair<std::string, int>, TensorRTEngineAndContext, PairHash>
       trt_engine_cache_;
 
-  /*! \brief Map of inding index to GPU buffers for inputs and outputs. Only used when target device
-   * is not "cuda". Since TensorRT execution can only read data from GPU, we need to copy data from
-   * the runtime device to these buffers first. These will be allocated for the highest batch size
-   * used by all engines. */
-  std::unordered_map<int, NDArray> device_buffers_;
+  /*! \brief Guards trt_engine_cache_, shared by the running calls and exclusive to build or
+   * replace an engine. */
+  std::shared_timed_mutex engines_mutex_;
+
+  /*! \brief The execution contexts of each engine which no call is running on. */
+  std::unordered_map<const nvinfer1::ICudaEngine*, std::vector<std::unique_ptr<TensorRTContext>>>
+      free_contexts_;
+
+  /*! \brief Guards free_contexts_. */
+  std::mutex contexts_mutex_;
+
+  /*! \brief The INT8 calibrator, null if not INT8. */
+  std::unique_ptr<TensorRTCalibrator> calibrator_;
+
+  /*! \brief The number of runs whose inputs calibrate the INT8 engines. */
+  int num_calibration_batches_{1};
+
+  /*! \brief Whether the engines are INT8, either calibrated or calibrating on the batches. */
+  std::atomic<bool> calibration_done_{false};
+
+  /*! \brief Whether the calibration table is in TVM_TENSORRT_CACHE_DIR. */
+  bool calibration_table_saved_{false};
+
+  /*! \brief Serializes the INT8 engine builds, which share the calibrator. */
+  std::mutex int8_build_mutex_;
 
   /*! \brief TensorRT logger. */
   TensorRTLogger logger_;
@@ -389,13 +734,27 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   bool GetCachedEnginesFromDisk() { return false; }
 
-  void CacheEngineToDisk() {}
+  void CacheEngineToDisk(int batch_size) {}
+
+  void StartProfileEngineBuild() {}
+
+  void SetupInt8Calibration() {}
 #endif
 
   bool use_implicit_batch_;
 
   size_t max_workspace_size_;
 
+  /*! \brief Whether to build INT8 engines. */
+  bool use_int8_{false};
+
+  /*! \brief The calibration table given at build time, empty if none. */
+  std::string calibration_table_;
+
+  /*! \brief The (min, opt, max) shapes of the inputs, by input node name, declared at partition
+   * time. A single engine built for these ranges serves all the input shapes within them. */
+  std::unordered_map<std::string, std::vector<std::vector<int64_t>>> profiles_;
+
   /*! \brief Highest batch size that an engine has been built for, used in single-engine mode only
    * (multi_engine_mode=false). */
   int max_batch_size_;
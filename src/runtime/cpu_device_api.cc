@@ -22,22 +22,63 @@
  */
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
 
 #include "workspace_pool.h"
 
 #ifdef __ANDROID__
 #include <android/api-level.h>
 #endif
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#define TVM_CPU_PAGE_PLACEMENT 1
+#else
+#define TVM_CPU_PAGE_PLACEMENT 0
+#endif
 
 namespace tvm {
 namespace runtime {
 class CPUDeviceAPI final : public DeviceAPI {
  public:
+  /*! \brief How the large allocations are backed with huge pages. */
+  enum HugePageMode {
+    /*! \brief The pages of the system default. */
+    kHugePagesOff = 0,
+    /*! \brief Transparent huge pages requested with madvise(MADV_HUGEPAGE). */
+    kHugePagesMadvise = 1,
+    /*! \brief Pages of the hugetlbfs pool, 1GB then 2MB, falling back to madvise. */
+    kHugePagesHugeTLB = 2,
+  };
+
+  CPUDeviceAPI() {
+    const char* mode = getenv("TVM_CPU_HUGE_PAGES");
+    if (mode != nullptr) {
+      huge_page_mode_ = ParseHugePageMode(mode);
+    }
+    const char* threshold = getenv("TVM_CPU_HUGE_PAGE_THRESHOLD");
+    if (threshold != nullptr) {
+      huge_page_threshold_ = std::stoull(threshold);
+    }
+  }
+
   void SetDevice(Device dev) final {}
   void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final {
     if (kind == kExist) {
@@ -46,6 +87,10 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+#if TVM_CPU_PAGE_PLACEMENT
+    ptr = AllocPages(nbytes, alignment);
+    if (ptr != nullptr) return ptr;
+#endif
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -61,6 +106,18 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
 
   void FreeDataSpace(Device dev, void* ptr) final {
+#if TVM_CPU_PAGE_PLACEMENT
+    if (num_mappings_.load(std::memory_order_relaxed) != 0) {
+      std::lock_guard<std::mutex> lock(mappings_mutex_);
+      auto it = mappings_.find(ptr);
+      if (it != mappings_.end()) {
+        munmap(ptr, it->second);
+        mappings_.erase(it);
+        num_mappings_.fetch_sub(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+#endif
 #if _MSC_VER
     _aligned_free(ptr);
 #else
@@ -73,6 +130,161 @@ class CPUDeviceAPI final : public DeviceAPI {
   void* AllocWorkspace(Device dev, size_t size, DLDataType type_hint) final;
   void FreeWorkspace(Device dev, void* data) final;
 
+  /*!
+   * \brief Configure the huge pages of the large allocations.
+   * \param mode The mode, "off", "madvise" or "hugetlb".
+   * \param threshold The size from which the allocations are backed with huge pages, at least
+   *  2MB.
+   * \note It applies to the allocations made after the call.
+   */
+  void ConfigureHugePages(const std::string& mode, size_t threshold) {
+    huge_page_mode_ = ParseHugePageMode(mode);
+    huge_page_threshold_ = threshold;
+  }
+
+  /*!
+   * \brief Get the counters of the huge page allocations.
+   *
+   *  The bytes allocated from hugetlbfs, advised as transparent huge pages and not given huge
+   *  pages since the start of the process, and the bytes of the process which are currently
+   *  backed by transparent and hugetlbfs huge pages according to the kernel.
+   */
+  Map<String, ObjectRef> HugePageStats() const {
+    auto count = [](int64_t v) { return ObjectRef(make_object<profiling::CountNode>(v)); };
+    Map<String, ObjectRef> stats;
+    stats.Set("hugetlb_bytes", count(hugetlb_bytes_.load(std::memory_order_relaxed)));
+    stats.Set("madvise_bytes", count(madvise_bytes_.load(std::memory_order_relaxed)));
+    stats.Set("fallback_bytes", count(fallback_bytes_.load(std::memory_order_relaxed)));
+    int64_t thp_resident = 0, hugetlb_resident = 0;
+#if TVM_CPU_PAGE_PLACEMENT
+    // The sizes are given in kB, e.g. "AnonHugePages:    4096 kB".
+    std::ifstream ifs("/proc/self/smaps_rollup");
+    std::string key;
+    int64_t kb;
+    while (ifs >> key >> kb) {
+      if (key == "AnonHugePages:") thp_resident = kb * 1024;
+      if (key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") hugetlb_resident += kb * 1024;
+      ifs.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#endif
+    stats.Set("thp_resident_bytes", count(thp_resident));
+    stats.Set("hugetlb_resident_bytes", count(hugetlb_resident));
+    return stats;
+  }
+
+ private:
+  static HugePageMode ParseHugePageMode(const std::string& mode) {
+    if (mode == "madvise") return kHugePagesMadvise;
+    if (mode == "hugetlb") return kHugePagesHugeTLB;
+    ICHECK(mode == "off" || mode.empty()) << "Unknown huge page mode " << mode;
+    return kHugePagesOff;
+  }
+
+#if TVM_CPU_PAGE_PLACEMENT
+  static size_t RoundUp(size_t size, size_t unit) { return (size + unit - 1) / unit * unit; }
+
+  /*!
+   * \brief Allocate whole pages, huge pages for the large allocations when enabled, placed on
+   *  the NUMA node of the calling thread if any.
+   * \param nbytes The size of the allocation.
+   * \param alignment The alignment of the allocation.
+   * \return The allocation, nullptr if it is allocated the default way.
+   */
+  void* AllocPages(size_t nbytes, size_t alignment) {
+    constexpr size_t kHugePage = 2UL << 20;
+    constexpr size_t kGiantPage = 1UL << 30;
+    int numa_node = threading::GetAllocNUMANode();
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    HugePageMode mode = huge_page_mode_;
+    bool huge =
+        mode != kHugePagesOff && nbytes >= std::max(huge_page_threshold_.load(), kHugePage);
+    if (!huge && (numa_node < 0 || nbytes < page_size)) return nullptr;
+
+    void* ptr = nullptr;
+    size_t size = 0;
+    if (huge && mode == kHugePagesHugeTLB) {
+      // The hugetlbfs pool may be empty or not reserved, so each size is tried in turn.
+      std::vector<std::pair<size_t, int>> page_sizes;
+#ifdef MAP_HUGE_1GB
+      if (nbytes >= kGiantPage) page_sizes.emplace_back(kGiantPage, MAP_HUGE_1GB);
+#endif
+#ifdef MAP_HUGE_2MB
+      page_sizes.emplace_back(kHugePage, MAP_HUGE_2MB);
+#else
+      page_sizes.emplace_back(kHugePage, 0);
+#endif
+      for (const auto& page : page_sizes) {
+        size = RoundUp(nbytes, page.first);
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | page.second, -1, 0);
+        if (mapped == MAP_FAILED) continue;
+        ptr = mapped;
+        std::lock_guard<std::mutex> lock(mappings_mutex_);
+        mappings_[ptr] = size;
+        num_mappings_.fetch_add(1, std::memory_order_relaxed);
+        hugetlb_bytes_.fetch_add(size, std::memory_order_relaxed);
+        break;
+      }
+    }
+    if (ptr == nullptr) {
+      // Transparent huge pages back the 2MB aligned ranges, the tail needs no rounding.
+      size_t page_alignment = std::max(alignment, huge ? kHugePage : page_size);
+      size = RoundUp(nbytes, page_size);
+      if (posix_memalign(&ptr, page_alignment, size) != 0) throw std::bad_alloc();
+      if (huge) {
+        if (madvise(ptr, size, MADV_HUGEPAGE) == 0) {
+          madvise_bytes_.fetch_add(size, std::memory_order_relaxed);
+        } else {
+          fallback_bytes_.fetch_add(size, std::memory_order_relaxed);
+        }
+      }
+    }
+    if (numa_node >= 0) BindToNUMANode(ptr, size, numa_node);
+    return ptr;
+  }
+
+  /*!
+   * \brief Bind whole pages to a NUMA node, before they are touched.
+   * \param ptr The start of the pages.
+   * \param size The size of the pages.
+   * \param node The NUMA node.
+   */
+  static void BindToNUMANode(void* ptr, size_t size, int node) {
+#ifdef SYS_mbind
+    // The values of MPOL_PREFERRED and MPOL_MF_MOVE in <linux/mempolicy.h>.
+    constexpr int kPreferred = 1;
+    constexpr unsigned kMove = 1 << 1;
+    constexpr size_t kBits = 8 * sizeof(unsigned long);  // NOLINT(*)
+    std::vector<unsigned long> mask(node / kBits + 1, 0);  // NOLINT(*)
+    mask[node / kBits] |= 1UL << (node % kBits);
+    // The pages reused from earlier allocations are moved, the new ones are placed on the node
+    // when first touched. The policy is a preference, failing to apply it is not an error.
+    if (syscall(SYS_mbind, ptr, size, kPreferred, mask.data(), mask.size() * kBits + 1, kMove) !=
+        0) {
+      DLOG(WARNING) << "Cannot place " << size << " bytes on NUMA node " << node;
+    }
+#endif
+  }
+
+  /*! \brief The sizes of the allocations mapped from hugetlbfs, freed with munmap. */
+  std::unordered_map<void*, size_t> mappings_;
+  /*! \brief The number of entries of mappings_, checked without the lock on free. */
+  std::atomic<size_t> num_mappings_{0};
+  /*! \brief Protects mappings_. */
+  std::mutex mappings_mutex_;
+#endif
+  /*! \brief How the large allocations are backed with huge pages. */
+  std::atomic<HugePageMode> huge_page_mode_{kHugePagesOff};
+  /*! \brief The size from which the allocations are backed with huge pages. */
+  std::atomic<size_t> huge_page_threshold_{2UL << 20};
+  /*! \brief The bytes allocated from hugetlbfs. */
+  std::atomic<size_t> hugetlb_bytes_{0};
+  /*! \brief The bytes advised as transparent huge pages. */
+  std::atomic<size_t> madvise_bytes_{0};
+  /*! \brief The bytes of the large allocations the kernel refused huge pages for. */
+  std::atomic<size_t> fallback_bytes_{0};
+
+ public:
   static CPUDeviceAPI* Global() {
     // NOTE: explicitly use new to avoid exit-time destruction of global state
     // Global state will be recycled by OS as the process exits.
@@ -86,6 +298,17 @@ class CPUDeviceAPI final : public DeviceAPI {
                       TVMStreamHandle stream) final {
     memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
   }
+
+  void CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch, void* to,
+                        size_t to_offset, size_t to_pitch, size_t width, size_t height,
+                        Device dev_from, Device dev_to, DLDataType type_hint,
+                        TVMStreamHandle stream) final {
+    const char* src = static_cast<const char*>(from) + from_offset;
+    char* dst = static_cast<char*>(to) + to_offset;
+    for (size_t i = 0; i < height; ++i) {
+      memcpy(dst + i * to_pitch, src + i * from_pitch, width);
+    }
+  }
 };
 
 struct CPUWorkspacePool : public WorkspacePool {
@@ -104,5 +327,14 @@ TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv)
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
 });
+
+TVM_REGISTER_GLOBAL("runtime.cpu_configure_huge_pages")
+    .set_body_typed([](String mode, int64_t threshold) {
+      CPUDeviceAPI::Global()->ConfigureHugePages(mode, threshold);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.cpu_huge_page_stats").set_body_typed([]() {
+  return CPUDeviceAPI::Global()->HugePageStats();
+});
 }  // namespace runtime
 }  // namespace tvm
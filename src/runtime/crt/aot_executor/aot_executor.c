@@ -29,13 +29,22 @@
 #include <tvm/runtime/crt/internal/aot_executor/aot_executor.h>
 
 tvm_crt_error_t tvm_runtime_run(const tvm_model_t* model, void** inputs, void** outputs) {
+  if (model->num_workspace_pools != 0) {
+    return kTvmErrorFunctionCallNumArguments;
+  }
+  return tvm_runtime_run_with_pools(model, inputs, outputs, NULL);
+}
+
+tvm_crt_error_t tvm_runtime_run_with_pools(const tvm_model_t* model, void** inputs, void** outputs,
+                                           void** pools) {
   static DLDevice fake_device = {kDLCPU, 0};
   static int64_t fake_dims = 0;
   static int64_t fake_shape = {0};
 
-  DLTensor tensors[model->num_input_tensors + model->num_output_tensors];     // NOLINT
-  TVMValue tvm_values[model->num_input_tensors + model->num_output_tensors];  // NOLINT
-  int32_t tvm_typeids[model->num_input_tensors + model->num_output_tensors];  // NOLINT
+  size_t num_tensors = model->num_input_tensors + model->num_output_tensors;
+  DLTensor tensors[num_tensors];                                  // NOLINT
+  TVMValue tvm_values[num_tensors + model->num_workspace_pools];  // NOLINT
+  int32_t tvm_typeids[num_tensors + model->num_workspace_pools];  // NOLINT
 
   for (size_t i = 0; i < model->num_input_tensors; i++) {
     tensors[i].device = fake_device;
@@ -58,5 +67,12 @@ tvm_crt_error_t tvm_runtime_run(const tvm_model_t* model, void** inputs, void**
     tvm_values[j].v_handle = &tensors[j];
   }
 
+  // The workspace pools are plain memory, passed as is.
+  for (size_t i = 0; i < model->num_workspace_pools; i++) {
+    size_t j = num_tensors + i;
+    tvm_values[j].v_handle = pools[i];
+    tvm_typeids[j] = kTVMOpaqueHandle;
+  }
+
   return (tvm_crt_error_t)model->run_func(tvm_values, tvm_typeids, 0, NULL, 0, NULL);
 }
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file aot_profiler.c
+ * \brief Record the cycles of the operator calls of an AOT run.
+ */
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/aot_profiler.h>
+#include <tvm/runtime/crt/platform.h>
+
+#include "crt_config.h"
+
+#ifndef TVM_CRT_AOT_PROFILE_MAX_CALLS
+#define TVM_CRT_AOT_PROFILE_MAX_CALLS 64
+#endif
+
+typedef struct {
+  const char* name;
+  uint64_t cycles;
+} TVMAotProfileCall;
+
+static TVMAotProfileCall profile_calls[TVM_CRT_AOT_PROFILE_MAX_CALLS];
+static uint32_t num_profile_calls;
+static uint64_t call_begin_cycles;
+
+int TVMBackendProfileBegin(int32_t call_index) {
+  if (call_index < 0 || call_index >= TVM_CRT_AOT_PROFILE_MAX_CALLS) {
+    return -1;
+  }
+  // A new run starts with the first call.
+  if (call_index == 0) {
+    num_profile_calls = 0;
+  }
+  return TVMPlatformReadCycleCounter(&call_begin_cycles) == kTvmErrorNoError ? 0 : -1;
+}
+
+int TVMBackendProfileEnd(int32_t call_index, const char* name) {
+  uint64_t cycles;
+  if (TVMPlatformReadCycleCounter(&cycles) != kTvmErrorNoError) {
+    return -1;
+  }
+  if (call_index < 0 || call_index >= TVM_CRT_AOT_PROFILE_MAX_CALLS) {
+    return -1;
+  }
+  profile_calls[call_index].name = name;
+  profile_calls[call_index].cycles = cycles - call_begin_cycles;
+  if ((uint32_t)call_index >= num_profile_calls) {
+    num_profile_calls = (uint32_t)call_index + 1;
+  }
+  return 0;
+}
+
+uint32_t TVMAotProfiler_GetNumCalls() { return num_profile_calls; }
+
+tvm_crt_error_t TVMAotProfiler_GetCall(uint32_t call_index, const char** name, uint64_t* cycles) {
+  if (call_index >= num_profile_calls) {
+    return kTvmErrorFunctionIndexInvalid;
+  }
+  *name = profile_calls[call_index].name;
+  *cycles = profile_calls[call_index].cycles;
+  return kTvmErrorNoError;
+}
+
+static int32_t TVMAotProfiler_NumCallsFunc(TVMValue* args, int* tcodes, int nargs,
+                                           TVMValue* ret_values, int* ret_tcodes,
+                                           void* resource_handle) {
+  if (nargs != 0) {
+    return kTvmErrorFunctionCallNumArguments;
+  }
+  ret_values[0].v_int64 = TVMAotProfiler_GetNumCalls();
+  ret_tcodes[0] = kTVMArgInt;
+  return kTvmErrorNoError;
+}
+
+static int32_t TVMAotProfiler_GetCallFunc(TVMValue* args, int* tcodes, int nargs,
+                                          const char** name, uint64_t* cycles) {
+  if (nargs != 1) {
+    return kTvmErrorFunctionCallNumArguments;
+  }
+  if (tcodes[0] != kTVMArgInt || args[0].v_int64 < 0) {
+    return kTvmErrorFunctionCallWrongArgType;
+  }
+  return TVMAotProfiler_GetCall((uint32_t)args[0].v_int64, name, cycles);
+}
+
+static int32_t TVMAotProfiler_CallNameFunc(TVMValue* args, int* tcodes, int nargs,
+                                           TVMValue* ret_values, int* ret_tcodes,
+                                           void* resource_handle) {
+  const char* name;
+  uint64_t cycles;
+  int32_t err = TVMAotProfiler_GetCallFunc(args, tcodes, nargs, &name, &cycles);
+  if (err != kTvmErrorNoError) {
+    return err;
+  }
+  ret_values[0].v_str = name;
+  ret_tcodes[0] = kTVMStr;
+  return kTvmErrorNoError;
+}
+
+static int32_t TVMAotProfiler_CallCyclesFunc(TVMValue* args, int* tcodes, int nargs,
+                                             TVMValue* ret_values, int* ret_tcodes,
+                                             void* resource_handle) {
+  const char* name;
+  uint64_t cycles;
+  int32_t err = TVMAotProfiler_GetCallFunc(args, tcodes, nargs, &name, &cycles);
+  if (err != kTvmErrorNoError) {
+    return err;
+  }
+  ret_values[0].v_int64 = (int64_t)cycles;
+  ret_tcodes[0] = kTVMArgInt;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TVMAotProfiler_Register() {
+  tvm_crt_error_t err = TVMFuncRegisterGlobal(
+      "tvm.aot_profiler.num_calls", (TVMFunctionHandle)&TVMAotProfiler_NumCallsFunc, 0);
+  if (err != kTvmErrorNoError) {
+    return err;
+  }
+  err = TVMFuncRegisterGlobal("tvm.aot_profiler.call_name",
+                              (TVMFunctionHandle)&TVMAotProfiler_CallNameFunc, 0);
+  if (err != kTvmErrorNoError) {
+    return err;
+  }
+  return TVMFuncRegisterGlobal("tvm.aot_profiler.call_cycles",
+                               (TVMFunctionHandle)&TVMAotProfiler_CallCyclesFunc, 0);
+}
@@ -65,7 +65,15 @@ int TVMNDArray_Empty(int32_t ndim, const tvm_index_t* shape, DLDataType dtype, D
   return 0;
 }
 
-int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
+/*!
+ * \brief Read the header of a serialized NDArray, up to its data size.
+ * \param strm The stream, moved after the header.
+ * \param ndim The number of dimensions read.
+ * \param shape The shape read, of TVM_CRT_MAX_NDIM elements.
+ * \param dtype The data type read.
+ * \return 0 on success.
+ */
+static int TVMNDArray_LoadHeader(const char** strm, int* ndim, int64_t* shape, DLDataType* dtype) {
   int32_t status = 0;
   uint64_t header, reserved;
   memcpy(&header, *strm, sizeof(header));
@@ -77,29 +85,37 @@ int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
   memcpy(&reserved, *strm, sizeof(reserved));
   *strm += sizeof(reserved);
   DLDevice dev;
-  int ndim;  // sizeof ndim should match dlpack
-  DLDataType dtype;
   memcpy(&dev, *strm, sizeof(dev));
   *strm += sizeof(dev);
-  memcpy(&ndim, *strm, sizeof(ndim));
-  *strm += sizeof(ndim);
-  memcpy(&dtype, *strm, sizeof(dtype));
-  *strm += sizeof(dtype);
-  if ((ndim < 0) || (ndim > TVM_CRT_MAX_NDIM)) {
-    fprintf(stderr, "Invalid ndim=%d: expected to be 0 ~ %d.\n", ndim, TVM_CRT_MAX_NDIM);
-    status = -1;
+  memcpy(ndim, *strm, sizeof(*ndim));
+  *strm += sizeof(*ndim);
+  memcpy(dtype, *strm, sizeof(*dtype));
+  *strm += sizeof(*dtype);
+  if ((*ndim < 0) || (*ndim > TVM_CRT_MAX_NDIM)) {
+    fprintf(stderr, "Invalid ndim=%d: expected to be 0 ~ %d.\n", *ndim, TVM_CRT_MAX_NDIM);
+    return -1;
   }
   if (dev.device_type != kDLCPU) {
     fprintf(stderr, "Invalid DLTensor device: can only save as CPU tensor\n");
     status = -1;
   }
+  int32_t idx;
+  for (idx = 0; idx < *ndim; idx++) {
+    memcpy(&shape[idx], *strm, sizeof(int64_t));
+    *strm += sizeof(shape[idx]);
+  }
+  return status;
+}
+
+int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
+  int ndim;  // sizeof ndim should match dlpack
+  DLDataType dtype;
+  DLDevice dev = {kDLCPU, 0};
   int64_t shape[TVM_CRT_MAX_NDIM] = {0};
   int32_t idx;
-  if (ndim != 0) {
-    for (idx = 0; idx < ndim; idx++) {
-      memcpy(&shape[idx], *strm, sizeof(int64_t));
-      *strm += sizeof(shape[idx]);
-    }
+  int32_t status = TVMNDArray_LoadHeader(strm, &ndim, shape, &dtype);
+  if (status != 0) {
+    return status;
   }
   status = TVMNDArray_Empty(ndim, shape, dtype, dev, ret);
   if (status != 0) {
@@ -126,6 +142,30 @@ int TVMNDArray_Load(TVMNDArray* ret, const char** strm) {
   return status;
 }
 
+int TVMNDArray_Skip(const char** strm) {
+  int ndim;
+  DLDataType dtype;
+  int64_t shape[TVM_CRT_MAX_NDIM] = {0};
+  int32_t status = TVMNDArray_LoadHeader(strm, &ndim, shape, &dtype);
+  if (status != 0) {
+    return status;
+  }
+  int64_t num_elems = 1;
+  int32_t idx;
+  for (idx = 0; idx < ndim; ++idx) {
+    num_elems *= shape[idx];
+  }
+  int64_t data_byte_size;
+  memcpy(&data_byte_size, *strm, sizeof(data_byte_size));
+  *strm += sizeof(data_byte_size);
+  if (data_byte_size != num_elems * ((dtype.bits + 7) / 8)) {
+    fprintf(stderr, "invalid DLTensor file format: data_byte_size=%d\n", (int)data_byte_size);
+    return -1;
+  }
+  *strm += data_byte_size;
+  return 0;
+}
+
 int TVMNDArray_CreateView(TVMNDArray* arr, const tvm_index_t* shape, int32_t ndim, DLDataType dtype,
                           TVMNDArray* array_view) {
   int status = TVMNDArray_Create(ndim, shape, dtype, arr->dl_tensor.device, array_view);
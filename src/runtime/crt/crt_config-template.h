@@ -39,6 +39,9 @@
 /*! Maximum packet size, in bytes, including the length header. */
 #define TVM_CRT_MAX_PACKET_SIZE_BYTES 2048
 
+/*! Size of the ring buffer receiving the RPC traffic, in bytes. Must be a power of 2. */
+#define TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES 256
+
 /*! Maximum supported string length in dltype, e.g. "int8", "int16", "float32" */
 #define TVM_CRT_MAX_STRLEN_DLTYPE 10
 
@@ -54,4 +57,11 @@
 /*! \brief Enable checks to enforce the stack allocator with a FIFO ordering. Off by default */
 // #define TVM_CRT_STACK_ALLOCATOR_ENABLE_FIFO_CHECK
 
+/*! \brief Compile out the graph JSON loader, the graph executor is then only created from a
+ *  graph descriptor. Off by default */
+// #define TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+
+/*! \brief Maximum number of operator calls profiled in an AOT run */
+#define TVM_CRT_AOT_PROFILE_MAX_CALLS 64
+
 #endif  // TVM_RUNTIME_CRT_CRT_CONFIG_TEMPLATE_H_
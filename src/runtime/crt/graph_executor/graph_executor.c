@@ -49,6 +49,7 @@ uint32_t Shape_Accumulate(int64_t* shape, uint32_t ndim) {
   return accum;
 }
 
+#ifndef TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
 int NodeEntry_Load(TVMGraphExecutorNodeEntry* entry, JSONReader* reader) {
   int status = 0;
   reader->BeginArray(reader);
@@ -209,6 +210,8 @@ TVMGraphExecutorNode TVMGraphExecutorNodeCreate() {
   return node;
 }
 
+#endif  // TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+
 int TVMGraphExecutorNodeRelease(TVMGraphExecutorNode* node) {
   if (!node) {
     return 0;
@@ -225,6 +228,7 @@ int TVMGraphExecutorNodeRelease(TVMGraphExecutorNode* node) {
   return 0;
 }
 
+#ifndef TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
 int TVMGraphExecutorGraphAttr_Load(TVMGraphExecutorGraphAttr* attr, JSONReader* reader) {
   int status = 0;
   int bitmask = 0;
@@ -520,6 +524,8 @@ int TVMGraphExecutorGraphAttr_Load(TVMGraphExecutorGraphAttr* attr, JSONReader*
   return status;
 }
 
+#endif  // TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+
 int TVMGraphExecutorGraphAttr_Release(TVMGraphExecutorGraphAttr* attr) {
   if (!attr) {
     return 0;
@@ -568,6 +574,7 @@ int TVMGraphExecutorGraphAttr_Release(TVMGraphExecutorGraphAttr* attr) {
   return 0;
 }
 
+#ifndef TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
 int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader) {
   int status = 0;
   reader->BeginObject(reader);
@@ -720,6 +727,130 @@ int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader) {
   return status;
 }
 
+#endif  // TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+
+/*!
+ * \brief Load the graph from a graph descriptor, the fields are copied without parsing.
+ * \param executor The graph executor.
+ * \param graph The graph descriptor.
+ * \return 0 on success.
+ */
+int TVMGraphExecutor_LoadDescriptor(TVMGraphExecutor* executor,
+                                    const TVMGraphExecutorGraphDescriptor* graph) {
+  DLDevice dev = {kDLCPU, 0};
+  uint32_t idx, i;
+  tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutorNode) * graph->nodes_count,
+                                                  dev, (void**)&executor->nodes);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memset(executor->nodes, 0, sizeof(TVMGraphExecutorNode) * graph->nodes_count);
+  for (idx = 0; idx < graph->nodes_count; ++idx) {
+    const TVMGraphExecutorNodeDescriptor* desc = graph->nodes + idx;
+    TVMGraphExecutorNode* node = executor->nodes + idx;
+    executor->nodes_count++;
+    snprintf(node->op_type, sizeof(node->op_type), "%s", desc->op_type);
+    snprintf(node->name, sizeof(node->name), "%s", desc->name);
+    if (desc->func_name != NULL) {
+      snprintf(node->param.func_name, sizeof(node->param.func_name), "%s", desc->func_name);
+    }
+    node->param.num_inputs = desc->num_inputs;
+    node->param.num_outputs = desc->num_outputs;
+    node->param.flatten_data = desc->flatten_data;
+    if (desc->inputs_count == 0) {
+      continue;
+    }
+    err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutorNodeEntry) * desc->inputs_count, dev,
+                                    (void**)&node->inputs);
+    if (err != kTvmErrorNoError) {
+      fprintf(stderr, "memory allocate error: %08x", err);
+      return -1;
+    }
+    memset(node->inputs, 0, sizeof(TVMGraphExecutorNodeEntry) * desc->inputs_count);
+    for (i = 0; i < desc->inputs_count; ++i) {
+      node->inputs[i].node_id = desc->inputs[i].node_id;
+      node->inputs[i].index = desc->inputs[i].index;
+    }
+    node->inputs_count = desc->inputs_count;
+  }
+
+  err = TVMPlatformMemoryAllocate(sizeof(uint32_t) * graph->arg_nodes_count, dev,
+                                  (void**)&executor->input_nodes);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memcpy(executor->input_nodes, graph->arg_nodes, sizeof(uint32_t) * graph->arg_nodes_count);
+  executor->input_nodes_count = graph->arg_nodes_count;
+
+  err = TVMPlatformMemoryAllocate(sizeof(uint32_t) * graph->node_row_ptr_count, dev,
+                                  (void**)&executor->node_row_ptr);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memcpy(executor->node_row_ptr, graph->node_row_ptr, sizeof(uint32_t) * graph->node_row_ptr_count);
+  executor->node_row_ptr_count = graph->node_row_ptr_count;
+
+  err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutorNodeEntry) * graph->heads_count, dev,
+                                  (void**)&executor->outputs);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memset(executor->outputs, 0, sizeof(TVMGraphExecutorNodeEntry) * graph->heads_count);
+  for (idx = 0; idx < graph->heads_count; ++idx) {
+    executor->outputs[idx].node_id = graph->heads[idx].node_id;
+    executor->outputs[idx].index = graph->heads[idx].index;
+  }
+  executor->outputs_count = graph->heads_count;
+
+  TVMGraphExecutorGraphAttr* attr = &(executor->attrs);
+  uint32_t count = graph->entries_count;
+  err = TVMPlatformMemoryAllocate(sizeof(uint32_t) * count, dev, (void**)&attr->storage_id);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memcpy(attr->storage_id, graph->storage_id, sizeof(uint32_t) * count);
+  err = TVMPlatformMemoryAllocate(TVM_CRT_STRLEN_DLTYPE * count, dev, (void**)&attr->dltype);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  for (idx = 0; idx < count; ++idx) {
+    snprintf(attr->dltype + idx * TVM_CRT_STRLEN_DLTYPE, TVM_CRT_STRLEN_DLTYPE, "%s",
+             graph->dltype[idx]);
+  }
+  attr->dltype_count = count;
+  err = TVMPlatformMemoryAllocate(sizeof(uint32_t) * count, dev, (void**)&attr->ndim);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memcpy(attr->ndim, graph->ndim, sizeof(uint32_t) * count);
+  err = TVMPlatformMemoryAllocate(sizeof(int64_t) * TVM_CRT_MAX_NDIM * count, dev,
+                                  (void**)&attr->shape);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  memset(attr->shape, 0, sizeof(int64_t) * TVM_CRT_MAX_NDIM * count);
+  const int64_t* shape = graph->shape;
+  for (idx = 0; idx < count; ++idx) {
+    if (graph->ndim[idx] > TVM_CRT_MAX_NDIM) {
+      fprintf(stderr, "Invalid ndim=%u: expected to be 0 ~ %d.\n", graph->ndim[idx],
+              TVM_CRT_MAX_NDIM);
+      return -1;
+    }
+    memcpy(attr->shape + idx * TVM_CRT_MAX_NDIM, shape, sizeof(int64_t) * graph->ndim[idx]);
+    shape += graph->ndim[idx];
+  }
+  attr->shape_count = count;
+  return 0;
+}
+
 uint32_t TVMGraphExecutor_GetEntryId(TVMGraphExecutor* executor, uint32_t nid, uint32_t index) {
   return executor->node_row_ptr[nid] + index;
 }
@@ -837,6 +968,12 @@ int TVMGraphExecutor_LoadParams(TVMGraphExecutor* executor, const char* param_bl
       status = -1;
     }
 
+    // The linked params stay in the read-only section of the module, no copy is made.
+    if (executor->storage_pool[executor->attrs.storage_id[eid]].is_linked_param) {
+      status |= TVMNDArray_Skip(&bptr);
+      continue;
+    }
+
     if (executor->data_entry[eid].dl_tensor.shape) {
       err = TVMPlatformMemoryFree(executor->data_entry[eid].dl_tensor.shape, dev);
       if (err != kTvmErrorNoError) {
@@ -991,13 +1128,15 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
         tensor->data = linked_param_data;
         tensor->device = dev;
         tensor->ndim = attrs->ndim[pit.entry_id];
-        tensor->shape = attrs->shape + idx * TVM_CRT_MAX_NDIM;
+        tensor->dtype = vtype[pit.entry_id];
+        tensor->shape = attrs->shape + pit.entry_id * TVM_CRT_MAX_NDIM;
         tensor->strides = NULL;
         tensor->byte_offset = 0;
         did_find_linked_param = 1;
       }
     }
     if (did_find_linked_param == 0) {
+      executor->storage_pool[executor->storage_pool_count].is_linked_param = 0;
       DLDataType dtype = {kDLFloat, 32, 1};
       int64_t shape[TVM_CRT_MAX_NDIM] = {
           0,
@@ -1145,6 +1284,29 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
   return status;
 }
 
+/*!
+ * \brief Set up the storage and the operators of the loaded graph.
+ * \param executor The graph executor.
+ * \param module_handle The module containing the compiled functions for the host
+ * processor.
+ * \param devs The device of the host and devices where graph nodes will be
+ * executed on.
+ * \return 0 on success.
+ */
+static int TVMGraphExecutor_Setup(TVMGraphExecutor* executor, TVMModuleHandle module_handle,
+                                  const DLDevice* devs) {
+  executor->module_handle = module_handle;
+  executor->devices[0] = devs[0];
+
+  int status;
+  status = TVMGraphExecutor_SetupStorage(executor);
+  if (status != 0) {
+    return status;
+  }
+  return TVMGraphExecutor_SetupOpExecs(executor);
+}
+
+#ifndef TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -1167,28 +1329,30 @@ int TVMGraphExecutor_Init(TVMGraphExecutor* executor, const char* graph_json,
   if (err != kTvmErrorNoError) {
     return -1;
   }
-  executor->module_handle = module_handle;
-  executor->devices[0] = devs[0];
+  return TVMGraphExecutor_Setup(executor, module_handle, devs);
+}
+#endif  // TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
 
-  int status;
-  status = TVMGraphExecutor_SetupStorage(executor);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMGraphExecutor_SetupOpExecs(executor);
+/*!
+ * \brief Initialize the graph executor with a graph descriptor and device.
+ * \param graph The graph descriptor.
+ * \param module_handle The module containing the compiled functions for the host
+ * processor.
+ * \param devs The device of the host and devices where graph nodes will be
+ * executed on.
+ * \return 0 on success.
+ */
+int TVMGraphExecutor_InitFromDescriptor(TVMGraphExecutor* executor,
+                                        const TVMGraphExecutorGraphDescriptor* graph,
+                                        TVMModuleHandle module_handle, const DLDevice* devs) {
+  int status = TVMGraphExecutor_LoadDescriptor(executor, graph);
   if (status != 0) {
-    if (status != 0) {
-      return status;
-    }
-
     return status;
   }
-
-  return status;
+  return TVMGraphExecutor_Setup(executor, module_handle, devs);
 }
 
-int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
-                            const DLDevice* devs, TVMGraphExecutor** executor) {
+static int TVMGraphExecutor_Allocate(TVMGraphExecutor** executor) {
   DLDevice dev = {kDLCPU, 0};
   tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(TVMGraphExecutor), dev, (void**)executor);
   if (err != kTvmErrorNoError) {
@@ -1197,8 +1361,32 @@ int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
   }
 
   memset(*executor, 0, sizeof(TVMGraphExecutor));
+  return 0;
+}
+
+int TVMGraphExecutor_Create(const char* sym_json, TVMModuleHandle module_handle,
+                            const DLDevice* devs, TVMGraphExecutor** executor) {
+#ifdef TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+  fprintf(stderr, "graph JSON loader is disabled, create the executor from a graph descriptor\n");
+  return -1;
+#else
+  int status = TVMGraphExecutor_Allocate(executor);
+  if (status != 0) {
+    return status;
+  }
   // init
   return TVMGraphExecutor_Init(*executor, sym_json, module_handle, devs);
+#endif  // TVM_CRT_GRAPH_EXECUTOR_DISABLE_JSON
+}
+
+int TVMGraphExecutor_CreateFromDescriptor(const TVMGraphExecutorGraphDescriptor* graph,
+                                          TVMModuleHandle module_handle, const DLDevice* devs,
+                                          TVMGraphExecutor** executor) {
+  int status = TVMGraphExecutor_Allocate(executor);
+  if (status != 0) {
+    return status;
+  }
+  return TVMGraphExecutor_InitFromDescriptor(*executor, graph, module_handle, devs);
 }
 
 int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
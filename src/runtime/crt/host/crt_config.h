@@ -48,9 +48,15 @@
 /*! Maximum packet size, in bytes, including the length header. */
 #define TVM_CRT_MAX_PACKET_SIZE_BYTES 8 * 1024
 
+/*! Size of the ring buffer receiving the RPC traffic, in bytes. Must be a power of 2. */
+#define TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES 256
+
 /*! \brief Maximum length of a PackedFunc function name. */
 #define TVM_CRT_MAX_FUNCTION_NAME_LENGTH_BYTES 30
 
+/*! \brief Maximum number of operator calls profiled in an AOT run. */
+#define TVM_CRT_AOT_PROFILE_MAX_CALLS 64
+
 // #define TVM_CRT_FRAMER_ENABLE_LOGS
 
 #endif  // TVM_RUNTIME_CRT_HOST_CRT_CONFIG_H_
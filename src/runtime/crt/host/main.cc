@@ -38,6 +38,10 @@
 #include <tvm/runtime/crt/graph_executor_module.h>
 #endif
 
+#ifdef TVM_HOST_USE_AOT_PROFILER
+#include <tvm/runtime/crt/aot_profiler.h>
+#endif
+
 using namespace std::chrono;
 
 extern "C" {
@@ -95,6 +99,13 @@ tvm_crt_error_t TVMPlatformTimerStop(double* elapsed_time_seconds) {
   return kTvmErrorNoError;
 }
 
+// The host counts nanoseconds.
+tvm_crt_error_t TVMPlatformReadCycleCounter(uint64_t* cycles) {
+  *cycles = static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+  return kTvmErrorNoError;
+}
+
 static_assert(RAND_MAX >= (1 << 8), "RAND_MAX is smaller than acceptable");
 unsigned int random_seed = 0;
 tvm_crt_error_t TVMPlatformGenerateRandom(uint8_t* buffer, size_t num_bytes) {
@@ -137,6 +148,10 @@ int main(int argc, char** argv) {
            "failed to register GraphExecutor TVMModule");
 #endif
 
+#ifdef TVM_HOST_USE_AOT_PROFILER
+  CHECK_EQ(TVMAotProfiler_Register(), kTvmErrorNoError, "failed to register the AOT profiler");
+#endif
+
   int error = TVMFuncRegisterGlobal("tvm.testing.reset_server",
                                     (TVMFunctionHandle)&testonly_reset_server, 0);
   if (error) {
@@ -64,6 +64,7 @@ extern "C" {
 typedef struct {
   size_t num_input_tensors;       /** Number of expected input tensors */
   size_t num_output_tensors;      /** Number of expected output tensors */
+  size_t num_workspace_pools;     /** Number of expected workspace pools */
   TVMBackendPackedCFunc run_func; /** Generated model function, called through tvm_runtime_run */
 } tvm_model_t;
 
@@ -76,6 +77,17 @@ typedef struct {
  */
 tvm_crt_error_t tvm_runtime_run(const tvm_model_t* model, void** inputs, void** outputs);
 
+/*!
+ * \brief Execute the AOT runner function of a model compiled with workspace pools
+ * \param model Model descriptor structure to reference for runtime information
+ * \param inputs Pointer to input pointer(s)
+ * \param outputs Pointer to output pointer(s)
+ * \param pools Pointer to the memory of the workspace pool(s), in the order of their declaration
+ * \return tvm_status_t containing success or errors from the model run
+ */
+tvm_crt_error_t tvm_runtime_run_with_pools(const tvm_model_t* model, void** inputs, void** outputs,
+                                           void** pools);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -49,6 +49,8 @@ int TVMNDArray_Empty(int32_t ndim, const tvm_index_t* shape, DLDataType dtype, D
 
 int TVMNDArray_Load(TVMNDArray* ret, const char** strm);
 
+int TVMNDArray_Skip(const char** strm);
+
 int TVMNDArray_CreateView(TVMNDArray* arr, const tvm_index_t* shape, int32_t ndim, DLDataType dtype,
                           TVMNDArray* array_view);
 
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file ring_buffer.cc
+ * \brief Defines a ring buffer receiving the RPC traffic on the device.
+ */
+
+#include <string.h>
+#include <tvm/runtime/crt/rpc_common/ring_buffer.h>
+
+namespace tvm {
+namespace runtime {
+namespace micro_rpc {
+
+size_t RingBuffer::WriteRegion(uint8_t** region) const {
+  size_t offset = write_cursor_ & (capacity_ - 1);
+  size_t num_bytes_free = WriteAvailable();
+  if (num_bytes_free > capacity_ - offset) {
+    num_bytes_free = capacity_ - offset;
+  }
+
+  *region = &data_[offset];
+  return num_bytes_free;
+}
+
+void RingBuffer::CommitWrite(size_t data_size_bytes) { write_cursor_ += data_size_bytes; }
+
+size_t RingBuffer::Write(const uint8_t* data, size_t data_size_bytes) {
+  size_t num_bytes_copied = 0;
+  while (num_bytes_copied < data_size_bytes) {
+    uint8_t* region;
+    size_t region_size_bytes = WriteRegion(&region);
+    if (region_size_bytes == 0) {
+      break;
+    }
+
+    size_t num_bytes_to_copy = data_size_bytes - num_bytes_copied;
+    if (region_size_bytes < num_bytes_to_copy) {
+      num_bytes_to_copy = region_size_bytes;
+    }
+    memcpy(region, &data[num_bytes_copied], num_bytes_to_copy);
+    CommitWrite(num_bytes_to_copy);
+    num_bytes_copied += num_bytes_to_copy;
+  }
+  return num_bytes_copied;
+}
+
+size_t RingBuffer::ReadRegion(const uint8_t** region) const {
+  size_t offset = read_cursor_ & (capacity_ - 1);
+  size_t num_bytes_available = ReadAvailable();
+  if (num_bytes_available > capacity_ - offset) {
+    num_bytes_available = capacity_ - offset;
+  }
+
+  *region = &data_[offset];
+  return num_bytes_available;
+}
+
+void RingBuffer::CommitRead(size_t data_size_bytes) { read_cursor_ += data_size_bytes; }
+
+}  // namespace micro_rpc
+}  // namespace runtime
+}  // namespace tvm
@@ -41,11 +41,20 @@
 #include <tvm/runtime/crt/platform.h>
 #include <tvm/runtime/crt/rpc_common/frame_buffer.h>
 #include <tvm/runtime/crt/rpc_common/framing.h>
+#include <tvm/runtime/crt/rpc_common/ring_buffer.h>
 #include <tvm/runtime/crt/rpc_common/session.h>
 
 #include "../../minrpc/minrpc_server.h"
 #include "crt_config.h"
 
+#ifndef TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES
+#define TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES 256
+#endif
+
+static_assert((TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES &
+               (TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES - 1)) == 0,
+              "TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES must be a power of 2");
+
 namespace tvm {
 namespace runtime {
 namespace micro_rpc {
@@ -109,8 +118,10 @@ class SerialWriteStream : public WriteStream {
 class MicroRPCServer {
  public:
   MicroRPCServer(uint8_t* receive_storage, size_t receive_storage_size_bytes,
+                 uint8_t* ring_storage, size_t ring_storage_size_bytes,
                  microtvm_rpc_channel_write_t write_func, void* write_func_ctx)
       : receive_buffer_{receive_storage, receive_storage_size_bytes},
+        receive_ring_{ring_storage, ring_storage_size_bytes},
         framer_{&send_stream_},
         session_{&framer_, &receive_buffer_, &HandleCompleteMessageCb, this},
         io_{&session_, &receive_buffer_},
@@ -128,7 +139,7 @@ class MicroRPCServer {
     CHECK_EQ(kTvmErrorNoError, session_.Initialize(initial_session_nonce), "rpc server init");
   }
 
-  /*! \brief Process one message from the receive buffer, if possible.
+  /*! \brief Process the data received in the ring buffer, then the new data, if possible.
    *
    * \param new_data If not nullptr, a pointer to a buffer pointer, which should point at new input
    *     data to process. On return, updated to point past data that has been consumed.
@@ -142,7 +153,17 @@ class MicroRPCServer {
     }
 
     tvm_crt_error_t err = kTvmErrorNoError;
-    if (new_data != nullptr && new_data_size_bytes != nullptr && *new_data_size_bytes > 0) {
+    const uint8_t* region;
+    size_t region_size_bytes;
+    while (err == kTvmErrorNoError && is_running_ &&
+           (region_size_bytes = receive_ring_.ReadRegion(&region)) > 0) {
+      size_t bytes_consumed;
+      err = unframer_.Write(region, region_size_bytes, &bytes_consumed);
+      receive_ring_.CommitRead(bytes_consumed);
+    }
+
+    if (err == kTvmErrorNoError && is_running_ && new_data != nullptr &&
+        new_data_size_bytes != nullptr && *new_data_size_bytes > 0) {
       size_t bytes_consumed;
       err = unframer_.Write(*new_data, *new_data_size_bytes, &bytes_consumed);
       *new_data += bytes_consumed;
@@ -156,6 +177,9 @@ class MicroRPCServer {
     return err;
   }
 
+  /*! \brief The ring buffer the received data can be written to, and processed by Loop. */
+  RingBuffer* ReceiveRing() { return &receive_ring_; }
+
   void Log(const uint8_t* message, size_t message_size_bytes) {
     tvm_crt_error_t to_return =
         session_.SendMessage(MessageType::kLog, message, message_size_bytes);
@@ -166,6 +190,7 @@ class MicroRPCServer {
 
  private:
   FrameBuffer receive_buffer_;
+  RingBuffer receive_ring_;
   SerialWriteStream send_stream_;
   Framer framer_;
   Session session_;
@@ -180,7 +205,10 @@ class MicroRPCServer {
       return;
     }
 
-    is_running_ = rpc_server_.ProcessOnePacket();
+    // A message can batch several RPC packets, processed in order.
+    do {
+      is_running_ = rpc_server_.ProcessOnePacket();
+    } while (is_running_ && buf->ReadAvailable() > 0);
     session_.ClearReceiveBuffer();
   }
 
@@ -216,6 +244,14 @@ microtvm_rpc_server_t MicroTVMRpcServerInit(microtvm_rpc_channel_write_t write_f
     TVMPlatformAbort(err);
   }
   auto receive_buffer = new (receive_buffer_memory) uint8_t[TVM_CRT_MAX_PACKET_SIZE_BYTES];
+  void* receive_ring_memory;
+  err = TVMPlatformMemoryAllocate(TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES, dev,
+                                  &receive_ring_memory);
+  if (err != kTvmErrorNoError) {
+    TVMPlatformAbort(err);
+  }
+  auto receive_ring =
+      new (receive_ring_memory) uint8_t[TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES];
   void* rpc_server_memory;
   err = TVMPlatformMemoryAllocate(sizeof(tvm::runtime::micro_rpc::MicroRPCServer), dev,
                                   &rpc_server_memory);
@@ -223,7 +259,8 @@ microtvm_rpc_server_t MicroTVMRpcServerInit(microtvm_rpc_channel_write_t write_f
     TVMPlatformAbort(err);
   }
   auto rpc_server = new (rpc_server_memory) tvm::runtime::micro_rpc::MicroRPCServer(
-      receive_buffer, TVM_CRT_MAX_PACKET_SIZE_BYTES, write_func, write_func_ctx);
+      receive_buffer, TVM_CRT_MAX_PACKET_SIZE_BYTES, receive_ring,
+      TVM_CRT_RPC_RECEIVE_RING_BUFFER_SIZE_BYTES, write_func, write_func_ctx);
   g_rpc_server = static_cast<microtvm_rpc_server_t>(rpc_server);
   rpc_server->Initialize();
   return g_rpc_server;
@@ -266,4 +303,16 @@ tvm_crt_error_t MicroTVMRpcServerLoop(microtvm_rpc_server_t server_ptr, uint8_t*
   return server->Loop(new_data, new_data_size_bytes);
 }
 
+size_t MicroTVMRpcServerReceiveRegion(microtvm_rpc_server_t server_ptr, uint8_t** region) {
+  tvm::runtime::micro_rpc::MicroRPCServer* server =
+      static_cast<tvm::runtime::micro_rpc::MicroRPCServer*>(server_ptr);
+  return server->ReceiveRing()->WriteRegion(region);
+}
+
+void MicroTVMRpcServerReceiveCommit(microtvm_rpc_server_t server_ptr, size_t num_bytes) {
+  tvm::runtime::micro_rpc::MicroRPCServer* server =
+      static_cast<tvm::runtime::micro_rpc::MicroRPCServer*>(server_ptr);
+  server->ReceiveRing()->CommitWrite(num_bytes);
+}
+
 }  // extern "C"
@@ -28,13 +28,92 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
+#include <vector>
 
 #include "cuda_common.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief Page-locked host buffers staging the asynchronous copies from pageable memory.
+ *
+ *  cudaMemcpyAsync from pageable memory waits for the work already queued on
+ *  the stream before copying. Copying the data into a pinned buffer first lets
+ *  the transfer be queued behind that work instead. A buffer is reused once the
+ *  event recorded after its transfer has completed.
+ */
+class CUDAStagingPool {
+ public:
+  /*! \brief The number of buffers kept per device. */
+  static constexpr size_t kMaxBuffers = 16;
+  /*! \brief Copies larger than this are not staged. */
+  static constexpr size_t kMaxStagedSize = 64 << 20;
+
+  /*!
+   * \brief Queue the copy of pageable host memory to the current device on stream.
+   * \return false if the copy cannot be staged.
+   */
+  bool CopyToDevice(const void* from, void* to, size_t size, int device_id,
+                    cudaStream_t stream) {
+    if (size > kMaxStagedSize) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Buffer* buf = Acquire(size, device_id);
+    if (buf == nullptr) return false;
+    memcpy(buf->data, from, size);
+    CUDA_CALL(cudaMemcpyAsync(to, buf->data, size, cudaMemcpyHostToDevice, stream));
+    CUDA_CALL(cudaEventRecord(buf->event, stream));
+    return true;
+  }
+
+ private:
+  struct Buffer {
+    void* data;
+    size_t size;
+    int device_id;
+    cudaEvent_t event;
+  };
+
+  // Requires mutex_, and device_id to be the current device.
+  Buffer* Acquire(size_t size, int device_id) {
+    Buffer* best = nullptr;
+    size_t num_buffers = 0;
+    for (Buffer& buf : buffers_) {
+      if (buf.device_id != device_id) continue;
+      ++num_buffers;
+      if (buf.size >= size && (best == nullptr || buf.size < best->size) &&
+          cudaEventQuery(buf.event) == cudaSuccess) {
+        best = &buf;
+      }
+    }
+    if (best != nullptr) return best;
+    if (num_buffers < kMaxBuffers) {
+      Buffer buf;
+      buf.size = std::max<size_t>(size, 4096);
+      buf.device_id = device_id;
+      CUDA_CALL(cudaMallocHost(&buf.data, buf.size));
+      CUDA_CALL(cudaEventCreateWithFlags(&buf.event, cudaEventDisableTiming));
+      buffers_.push_back(buf);
+      return &buffers_.back();
+    }
+    // All the buffers are in flight, wait for the smallest one large enough.
+    for (Buffer& buf : buffers_) {
+      if (buf.device_id == device_id && buf.size >= size &&
+          (best == nullptr || buf.size < best->size)) {
+        best = &buf;
+      }
+    }
+    if (best != nullptr) CUDA_CALL(cudaEventSynchronize(best->event));
+    return best;
+  }
+
+  std::mutex mutex_;
+  std::vector<Buffer> buffers_;
+};
+
 class CUDADeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final { CUDA_CALL(cudaSetDevice(dev.device_id)); }
@@ -136,6 +215,8 @@ class CUDADeviceAPI final : public DeviceAPI {
     cudaStream_t cu_stream = static_cast<cudaStream_t>(stream);
     from = static_cast<const char*>(from) + from_offset;
     to = static_cast<char*>(to) + to_offset;
+    // Page-locked sources are copied asynchronously by the driver already.
+    bool pageable_from = dev_from.device_type == kDLCPU;
 
     if (dev_from.device_type == kDLCUDAHost) {
       dev_from.device_type = kDLCPU;
@@ -163,12 +244,53 @@ class CUDADeviceAPI final : public DeviceAPI {
       GPUCopy(from, to, size, cudaMemcpyDeviceToHost, cu_stream);
     } else if (dev_from.device_type == kDLCPU && dev_to.device_type == kDLCUDA) {
       CUDA_CALL(cudaSetDevice(dev_to.device_id));
+      if (cu_stream != nullptr && pageable_from &&
+          staging_pool_.CopyToDevice(from, to, size, dev_to.device_id, cu_stream)) {
+        return;
+      }
       GPUCopy(from, to, size, cudaMemcpyHostToDevice, cu_stream);
     } else {
       LOG(FATAL) << "expect copy from/to GPU or between GPU";
     }
   }
 
+  void CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch, void* to,
+                        size_t to_offset, size_t to_pitch, size_t width, size_t height,
+                        Device dev_from, Device dev_to, DLDataType type_hint,
+                        TVMStreamHandle stream) final {
+    if (dev_from.device_type == kDLCUDAHost) {
+      dev_from.device_type = kDLCPU;
+    }
+    if (dev_to.device_type == kDLCUDAHost) {
+      dev_to.device_type = kDLCPU;
+    }
+    cudaMemcpyKind kind;
+    if (dev_from.device_type == kDLCUDA && dev_to.device_type == kDLCUDA &&
+        dev_from.device_id == dev_to.device_id) {
+      kind = cudaMemcpyDeviceToDevice;
+    } else if (dev_from.device_type == kDLCUDA && dev_to.device_type == kDLCPU) {
+      kind = cudaMemcpyDeviceToHost;
+    } else if (dev_from.device_type == kDLCPU && dev_to.device_type == kDLCUDA) {
+      kind = cudaMemcpyHostToDevice;
+    } else {
+      // The host to host and peer copies are made row by row.
+      DeviceAPI::CopyDataFromTo2D(from, from_offset, from_pitch, to, to_offset, to_pitch, width,
+                                  height, dev_from, dev_to, type_hint, stream);
+      return;
+    }
+    CUDA_CALL(cudaSetDevice(dev_from.device_type == kDLCUDA ? dev_from.device_id
+                                                            : dev_to.device_id));
+    const char* src = static_cast<const char*>(from) + from_offset;
+    char* dst = static_cast<char*>(to) + to_offset;
+    cudaStream_t cu_stream = static_cast<cudaStream_t>(stream);
+    if (cu_stream != nullptr) {
+      CUDA_CALL(
+          cudaMemcpy2DAsync(dst, to_pitch, src, from_pitch, width, height, kind, cu_stream));
+    } else {
+      CUDA_CALL(cudaMemcpy2D(dst, to_pitch, src, from_pitch, width, height, kind));
+    }
+  }
+
  public:
   TVMStreamHandle CreateStream(Device dev) {
     CUDA_CALL(cudaSetDevice(dev.device_id));
@@ -199,6 +321,28 @@ class CUDADeviceAPI final : public DeviceAPI {
     CUDA_CALL(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)));
   }
 
+  TVMEventHandle CreateEvent(Device dev) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    cudaEvent_t event;
+    CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    return event;
+  }
+
+  void FreeEvent(Device dev, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventDestroy(static_cast<cudaEvent_t>(event)));
+  }
+
+  void RecordEvent(Device dev, TVMEventHandle event, TVMStreamHandle stream) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventRecord(static_cast<cudaEvent_t>(event), static_cast<cudaStream_t>(stream)));
+  }
+
+  void EventSync(Device dev, TVMEventHandle event) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    CUDA_CALL(cudaEventSynchronize(static_cast<cudaEvent_t>(event)));
+  }
+
   void SetStream(Device dev, TVMStreamHandle stream) final {
     CUDAThreadEntry::ThreadLocal()->stream = static_cast<cudaStream_t>(stream);
   }
@@ -219,6 +363,9 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
  private:
+  /*! \brief The pinned buffers staging asynchronous uploads from pageable memory. */
+  CUDAStagingPool staging_pool_;
+
   static void GPUCopy(const void* from, void* to, size_t size, cudaMemcpyKind kind,
                       cudaStream_t stream) {
     if (stream != nullptr) {
@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cuda_graph_cache.h
+ * \brief Stream capture of CUDA graphs and an LRU cache of the instantiated graphs.
+ */
+#ifndef TVM_RUNTIME_CUDA_CUDA_GRAPH_CACHE_H_
+#define TVM_RUNTIME_CUDA_CUDA_GRAPH_CACHE_H_
+
+#include <cuda_runtime.h>
+#include <tvm/runtime/logging.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Put a stream in capture mode.
+ * \param stream The stream to capture.
+ * \param mode The capture mode, which decides what other threads may do meanwhile.
+ */
+inline void CudaGraphBeginCapture(cudaStream_t stream,
+                                  cudaStreamCaptureMode mode = cudaStreamCaptureModeGlobal) {
+  CUDA_CALL(cudaStreamBeginCapture(stream, mode));
+}
+
+/*!
+ * \brief End the capture of a stream and instantiate the captured graph.
+ * \param stream The stream in capture mode.
+ * \param num_nodes If not nullptr, set to the number of nodes of the graph.
+ * \return The executable graph, to be destroyed with cudaGraphExecDestroy.
+ */
+inline cudaGraphExec_t CudaGraphEndCapture(cudaStream_t stream, size_t* num_nodes = nullptr) {
+  cudaGraph_t graph;
+  CUDA_CALL(cudaStreamEndCapture(stream, &graph));
+  if (num_nodes != nullptr) {
+    CUDA_CALL(cudaGraphGetNodes(graph, nullptr, num_nodes));
+  }
+  cudaGraphExec_t exec;
+  CUDA_CALL(cudaGraphInstantiate(&exec, graph, nullptr, nullptr, 0));
+  CUDA_CALL(cudaGraphDestroy(graph));
+  return exec;
+}
+
+/*!
+ * \brief Leave capture mode after a failure, dropping what has been captured.
+ * \param stream The stream which may still be in capture mode.
+ */
+inline void CudaGraphAbortCapture(cudaStream_t stream) {
+  cudaStreamCaptureStatus status;
+  if (cudaStreamIsCapturing(stream, &status) == cudaSuccess &&
+      status != cudaStreamCaptureStatusNone) {
+    cudaGraph_t graph = nullptr;
+    if (cudaStreamEndCapture(stream, &graph) == cudaSuccess && graph != nullptr) {
+      cudaGraphDestroy(graph);
+    }
+  }
+  // Clear the sticky error left by the failed capture.
+  cudaGetLastError();
+}
+
+/*!
+ * \brief Least recently used cache of executable CUDA graphs.
+ *
+ *  An entry may hold a null graph, recording that its key cannot be captured.
+ * \tparam State The data kept alive along with each graph, e.g. the buffers baked into it.
+ */
+template <typename State>
+class CudaGraphCache {
+ public:
+  struct Entry {
+    /*! \brief The executable graph, nullptr if the key cannot be captured. */
+    cudaGraphExec_t exec{nullptr};
+    State state;
+  };
+
+  explicit CudaGraphCache(size_t capacity) : capacity_(capacity) {
+    ICHECK_GE(capacity_, 1) << "CUDA graph cache needs room for at least one graph";
+  }
+
+  ~CudaGraphCache() { Clear(); }
+
+  /*! \brief Find the entry of key and mark it as the most recently used, nullptr if absent. */
+  Entry* Find(const std::string& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return &it->second->second;
+  }
+
+  /*! \brief Insert an entry for key, evicting the least recently used ones beyond capacity. */
+  Entry* Insert(const std::string& key, cudaGraphExec_t exec, State state) {
+    ICHECK(index_.find(key) == index_.end()) << "CUDA graph of " << key << " already exists";
+    lru_.emplace_front(key, Entry{exec, std::move(state)});
+    index_[key] = lru_.begin();
+    Shrink();
+    return &lru_.front().second;
+  }
+
+  /*! \brief Change the number of graphs kept. */
+  void SetCapacity(size_t capacity) {
+    ICHECK_GE(capacity, 1) << "CUDA graph cache needs room for at least one graph";
+    capacity_ = capacity;
+    Shrink();
+  }
+
+  void Clear() {
+    while (!lru_.empty()) Evict();
+  }
+
+  size_t size() const { return lru_.size(); }
+  size_t capacity() const { return capacity_; }
+  /*! \brief Number of entries evicted so far. */
+  size_t evictions() const { return evictions_; }
+
+ private:
+  void Shrink() {
+    while (lru_.size() > capacity_) {
+      Evict();
+      ++evictions_;
+    }
+  }
+
+  void Evict() {
+    auto& back = lru_.back();
+    if (back.second.exec != nullptr) {
+      CUDA_CALL(cudaGraphExecDestroy(back.second.exec));
+    }
+    index_.erase(back.first);
+    lru_.pop_back();
+  }
+
+  size_t capacity_;
+  size_t evictions_{0};
+  std::list<std::pair<std::string, Entry>> lru_;
+  std::unordered_map<std::string, typename std::list<std::pair<std::string, Entry>>::iterator>
+      index_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_CUDA_CUDA_GRAPH_CACHE_H_
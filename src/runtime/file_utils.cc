@@ -28,7 +28,17 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -214,6 +224,185 @@ std::string SaveParams(const Map<String, NDArray>& params) {
   return bytes;
 }
 
+namespace {
+/*! \brief The table entry of a tensor in a mapped parameter file. */
+struct MappedParamEntry {
+  DLDataType dtype;
+  std::vector<int64_t> shape;
+  uint64_t offset;
+  uint64_t nbytes;
+};
+
+void WriteMappedParamsTable(dmlc::Stream* strm, const std::vector<std::string>& names,
+                            const std::vector<MappedParamEntry>& entries) {
+  uint64_t header = kTVMMappedParamsMagic, alignment = kMappedParamsAlignment;
+  strm->Write(header);
+  strm->Write(alignment);
+  strm->Write(names);
+  uint64_t sz = static_cast<uint64_t>(entries.size());
+  strm->Write(sz);
+  for (const MappedParamEntry& entry : entries) {
+    strm->Write(entry.dtype);
+    strm->Write(entry.shape);
+    strm->Write(entry.offset);
+    strm->Write(entry.nbytes);
+  }
+}
+
+void ReadMappedParamsTable(const char* data, size_t size, std::vector<std::string>* names,
+                           std::vector<MappedParamEntry>* entries) {
+  dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data), size);
+  dmlc::Stream* strm = &fs;
+  uint64_t header, alignment, sz;
+  ICHECK(strm->Read(&header)) << "Invalid mapped parameters file format";
+  ICHECK(header == kTVMMappedParamsMagic) << "Invalid mapped parameters file format";
+  ICHECK(strm->Read(&alignment)) << "Invalid mapped parameters file format";
+  ICHECK(strm->Read(names)) << "Invalid mapped parameters file format";
+  ICHECK(strm->Read(&sz)) << "Invalid mapped parameters file format";
+  ICHECK(sz == names->size()) << "Invalid mapped parameters file format";
+  entries->resize(sz);
+  for (MappedParamEntry& entry : *entries) {
+    ICHECK(strm->Read(&entry.dtype)) << "Invalid mapped parameters file format";
+    ICHECK(strm->Read(&entry.shape)) << "Invalid mapped parameters file format";
+    ICHECK(strm->Read(&entry.offset)) << "Invalid mapped parameters file format";
+    ICHECK(strm->Read(&entry.nbytes)) << "Invalid mapped parameters file format";
+    DLTensor tensor;
+    tensor.ndim = static_cast<int>(entry.shape.size());
+    tensor.shape = entry.shape.data();
+    tensor.dtype = entry.dtype;
+    ICHECK_EQ(GetDataSize(tensor), entry.nbytes) << "Invalid mapped parameters file format";
+    ICHECK_EQ(entry.offset % alignment, 0) << "Invalid mapped parameters file format";
+    ICHECK_LE(entry.offset + entry.nbytes, size) << "Mapped parameters file is truncated";
+  }
+}
+
+/*! \brief Keeps the mapping alive while a tensor points into it. */
+struct MappedTensorContext {
+  std::shared_ptr<MappedFile> file;
+  DLManagedTensor tensor;
+
+  static void Deleter(DLManagedTensor* tensor) {
+    delete static_cast<MappedTensorContext*>(tensor->manager_ctx);
+  }
+};
+}  // namespace
+
+MappedFile::MappedFile(const std::string& file_name) {
+#ifdef _WIN32
+  LoadBinaryFromFile(file_name, &buffer_);
+  data_ = &buffer_[0];
+  size_ = buffer_.size();
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  ICHECK_GE(fd, 0) << "Cannot open file " << file_name << ": " << strerror(errno);
+  struct stat st;
+  ICHECK_EQ(fstat(fd, &st), 0) << "Cannot stat file " << file_name << ": " << strerror(errno);
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ != 0) {
+    void* addr = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ICHECK(addr != MAP_FAILED) << "Cannot map file " << file_name << ": " << strerror(errno);
+    data_ = static_cast<char*>(addr);
+  }
+  close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (data_ != nullptr) munmap(data_, size_);
+#endif
+}
+
+NDArray MappedFile::View(const std::shared_ptr<MappedFile>& file, size_t offset,
+                         std::vector<int64_t> shape, DLDataType dtype) {
+  char* data = file->data() + offset;
+  if (!file->zero_copy()) {
+    NDArray array = NDArray::Empty(shape, dtype, Device{kDLCPU, 0});
+    array.CopyFromBytes(data, GetDataSize(*array.operator->()));
+    return array;
+  }
+  auto* ctx = new MappedTensorContext();
+  ctx->file = file;
+  DLTensor& tensor = ctx->tensor.dl_tensor;
+  tensor.data = data;
+  tensor.device = Device{kDLCPU, 0};
+  tensor.ndim = static_cast<int>(shape.size());
+  tensor.dtype = dtype;
+  // FromDLPack copies the shape.
+  tensor.shape = shape.data();
+  tensor.strides = nullptr;
+  tensor.byte_offset = 0;
+  ctx->tensor.manager_ctx = ctx;
+  ctx->tensor.deleter = MappedTensorContext::Deleter;
+  return NDArray::FromDLPack(&ctx->tensor);
+}
+
+void SaveMappedParams(const std::string& file_name, const Map<String, NDArray>& params) {
+  std::vector<std::string> names;
+  std::vector<NDArray> arrays;
+  std::vector<MappedParamEntry> entries;
+  for (auto& p : params) {
+    const DLTensor* tensor = p.second.operator->();
+    names.push_back(p.first);
+    arrays.push_back(p.second);
+    std::vector<int64_t> shape(tensor->shape, tensor->shape + tensor->ndim);
+    entries.push_back({tensor->dtype, shape, 0, GetDataSize(*tensor)});
+  }
+  // The offsets have a fixed size, the size of the table does not depend on them.
+  std::string table;
+  {
+    dmlc::MemoryStringStream strm(&table);
+    WriteMappedParamsTable(&strm, names, entries);
+  }
+  uint64_t offset = table.size();
+  for (MappedParamEntry& entry : entries) {
+    offset = (offset + kMappedParamsAlignment - 1) / kMappedParamsAlignment;
+    offset *= kMappedParamsAlignment;
+    entry.offset = offset;
+    offset += entry.nbytes;
+  }
+  table.clear();
+  {
+    dmlc::MemoryStringStream strm(&table);
+    WriteMappedParamsTable(&strm, names, entries);
+  }
+
+  std::ofstream fs(file_name, std::ios::out | std::ios::binary);
+  ICHECK(!fs.fail()) << "Cannot open file " << file_name;
+  fs.write(table.data(), table.size());
+  uint64_t pos = table.size();
+  std::vector<char> buf;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    std::string padding(entries[i].offset - pos, '\0');
+    fs.write(padding.data(), padding.size());
+    const DLTensor* tensor = arrays[i].operator->();
+    size_t nbytes = static_cast<size_t>(entries[i].nbytes);
+    if (tensor->device.device_type == kDLCPU && IsContiguous(*tensor)) {
+      fs.write(static_cast<const char*>(tensor->data) + tensor->byte_offset, nbytes);
+    } else {
+      buf.resize(nbytes);
+      arrays[i].CopyToBytes(buf.data(), nbytes);
+      fs.write(buf.data(), nbytes);
+    }
+    pos = entries[i].offset + entries[i].nbytes;
+  }
+  ICHECK(!fs.fail()) << "Cannot write file " << file_name;
+}
+
+Map<String, NDArray> LoadMappedParams(const std::string& file_name) {
+  auto file = std::make_shared<MappedFile>(file_name);
+  std::vector<std::string> names;
+  std::vector<MappedParamEntry> entries;
+  ReadMappedParamsTable(file->data(), file->size(), &names, &entries);
+
+  Map<String, NDArray> params;
+  for (size_t i = 0; i < names.size(); ++i) {
+    MappedParamEntry& entry = entries[i];
+    params.Set(names[i], MappedFile::View(file, entry.offset, entry.shape, entry.dtype));
+  }
+  return params;
+}
+
 TVM_REGISTER_GLOBAL("runtime.SaveParams").set_body_typed([](const Map<String, NDArray>& params) {
   std::string s = ::tvm::runtime::SaveParams(params);
   // copy return array so it is owned by the ret value
@@ -224,6 +413,8 @@ TVM_REGISTER_GLOBAL("runtime.SaveParams").set_body_typed([](const Map<String, ND
 TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
   return ::tvm::runtime::LoadParams(s);
 });
+TVM_REGISTER_GLOBAL("runtime.SaveMappedParams").set_body_typed(SaveMappedParams);
+TVM_REGISTER_GLOBAL("runtime.LoadMappedParams").set_body_typed(LoadMappedParams);
 
 }  // namespace runtime
 }  // namespace tvm
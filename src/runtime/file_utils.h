@@ -26,9 +26,12 @@
 
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
+#include <tvm/runtime/ndarray.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "meta_data.h"
 
@@ -121,6 +124,69 @@ std::string SaveParams(const Map<String, NDArray>& params);
  * \param params Parameters to save.
  */
 void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+
+constexpr uint64_t kTVMMappedParamsMagic = 0xF7E58D4F05049CB8;
+/*! \brief Alignment of the tensor data in a mapped parameter file. */
+constexpr uint64_t kMappedParamsAlignment = 64;
+/*!
+ * \brief Save parameters to a file which can be memory mapped.
+ *
+ *  The file starts with a table of the names, types, shapes and offsets of the
+ *  tensors, followed by their data, each aligned to kMappedParamsAlignment bytes
+ *  from the start of the file. The data is stored in host byte order.
+ * \param file_name The name of the file.
+ * \param params Parameters to save.
+ */
+void SaveMappedParams(const std::string& file_name, const Map<String, NDArray>& params);
+/*!
+ * \brief Load parameters saved by SaveMappedParams without copying them.
+ *
+ *  The file is mapped copy-on-write and the returned CPU arrays point into the
+ *  mapping, which is unmapped once all of them are freed. Processes loading the
+ *  same file share its pages through the page cache until they write to them.
+ * \param file_name The name of the file.
+ * \return Map of parameter name to parameter value.
+ */
+Map<String, NDArray> LoadMappedParams(const std::string& file_name);
+
+/*!
+ * \brief A view of a file, mapped copy-on-write where supported and read in memory otherwise.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_name);
+  ~MappedFile();
+
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /*! \brief Whether the tensors can point into the file, which needs their alignment. */
+  bool zero_copy() const {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+  }
+
+  /*!
+   * \brief Create a CPU array from the data of a file.
+   * \param file The file, kept alive by the array when it points into the mapping.
+   * \param offset The offset of the data, aligned to kAllocAlignment for zero copy.
+   * \param shape The shape of the array.
+   * \param dtype The type of the array.
+   * \return The array, which points into the mapping when zero_copy() is true.
+   */
+  static NDArray View(const std::shared_ptr<MappedFile>& file, size_t offset,
+                      std::vector<int64_t> shape, DLDataType dtype);
+
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+#ifdef _WIN32
+  std::string buffer_;
+#endif
+};
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_FILE_UTILS_H_
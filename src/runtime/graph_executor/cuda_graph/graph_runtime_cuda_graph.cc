@@ -24,6 +24,7 @@
 #include <tvm/runtime/registry.h>
 
 #include "../../cuda/cuda_common.h"
+#include "../../cuda/cuda_graph_cache.h"
 #include "../graph_executor.h"
 
 namespace tvm {
@@ -41,6 +42,12 @@ namespace runtime {
  */
 class GraphExecutorCudaGraph : public GraphExecutor {
  public:
+  ~GraphExecutorCudaGraph() {
+    if (cuda_graph_exec_ != nullptr) {
+      CUDA_CALL(cudaGraphExecDestroy(cuda_graph_exec_));
+    }
+  }
+
   /*!
    * \brief Begin CUDA graph capture on stream, the stream enters capture mode.
    */
@@ -50,8 +57,7 @@ class GraphExecutorCudaGraph : public GraphExecutor {
     TVMStreamCreate(dev.device_type, dev.device_id, &capture_stream_);
     TVMSetStream(dev.device_type, dev.device_id, capture_stream_);
 
-    CUDA_CALL(cudaStreamBeginCapture(static_cast<cudaStream_t>(capture_stream_),
-                                     cudaStreamCaptureModeGlobal));
+    CudaGraphBeginCapture(static_cast<cudaStream_t>(capture_stream_));
   }
 
   /*!
@@ -68,15 +74,12 @@ class GraphExecutorCudaGraph : public GraphExecutor {
    * instantiated.
    */
   void EndCapture() {
-    cudaGraph_t graph;
-    CUDA_CALL(cudaStreamEndCapture(static_cast<cudaStream_t>(capture_stream_), &graph));
-
-    cudaGraphNode_t* nodes = NULL;
+    if (cuda_graph_exec_ != nullptr) {
+      CUDA_CALL(cudaGraphExecDestroy(cuda_graph_exec_));
+    }
     size_t numNodes = 0;
-    CUDA_CALL(cudaGraphGetNodes(graph, nodes, &numNodes));
+    cuda_graph_exec_ = CudaGraphEndCapture(static_cast<cudaStream_t>(capture_stream_), &numNodes);
     LOG(INFO) << "Num of nodes in the cuda graph created using stream capture API = " << numNodes;
-
-    CUDA_CALL(cudaGraphInstantiate(&cuda_graph_exec_, graph, NULL, NULL, 0));
   }
 
   /*!
@@ -90,7 +93,7 @@ class GraphExecutorCudaGraph : public GraphExecutor {
   /*! \brief The Cuda stream on which to capture a CUDA graph. */
   TVMStreamHandle capture_stream_;
   /*! \brief The captured CUDA graph will be instantiated to this. */
-  cudaGraphExec_t cuda_graph_exec_;
+  cudaGraphExec_t cuda_graph_exec_{nullptr};
 };
 
 PackedFunc GraphExecutorCudaGraph::GetFunction(const std::string& name,
@@ -59,6 +59,7 @@ class GraphExecutorDebug : public GraphExecutor {
   std::string RunIndividual(int number, int repeat, int min_repeat_ms) {
     // warmup run
     GraphExecutor::Run();
+    auto arena_lock = LockActivationArena();
     std::string tkey = module_->type_key();
     std::vector<double> time_sec_per_op(op_execs_.size(), 0);
     if (tkey == "rpc") {
@@ -210,6 +211,7 @@ class GraphExecutorDebug : public GraphExecutor {
    */
   void ExecuteNode(int node) {
     ICHECK_LT(static_cast<size_t>(node), op_execs_.size());
+    auto arena_lock = LockActivationArena();
 
     int start_ind;
     int end_ind;
@@ -258,6 +260,7 @@ class GraphExecutorDebug : public GraphExecutor {
   void DebugGetNodeOutput(int index, DLTensor* data_out) {
     ICHECK_LT(static_cast<size_t>(index), op_execs_.size());
     uint32_t eid = index;
+    auto arena_lock = LockActivationArena();
 
     for (size_t i = 0; i < op_execs_.size(); ++i) {
       if (op_execs_[i]) op_execs_[i]();
@@ -276,15 +279,19 @@ class GraphExecutorDebug : public GraphExecutor {
    * the module compared to GraphRuntimeDebug::RunIndividual as it runs the
    * entire graph in order.
    *
+   * \param collectors Additional metrics to collect for every op and over the run.
+   * \param timeline Whether to record the timeline of the ops and parallel tasks.
    * \returns A table of per-op runtimes and total times.
    */
-  profiling::Report Profile() {
+  profiling::Report Profile(Array<profiling::MetricCollector> collectors, bool timeline) {
     // warm up. 1 iteration does not seem enough.
     for (int i = 0; i < 3; i++) {
       GraphExecutor::Run();
     }
+    auto arena_lock = LockActivationArena();
 
-    profiling::Profiler prof;
+    std::vector<profiling::MetricCollector> cs(collectors.begin(), collectors.end());
+    profiling::Profiler prof(cs, timeline);
     prof.Start(devices_);
     for (size_t i = 0; i < op_execs_.size(); ++i) {
       if (op_execs_[i]) {
@@ -359,7 +366,10 @@ PackedFunc GraphExecutorDebug::GetFunction(const std::string& name,
       *rv = this->RunIndividual(number, repeat, min_repeat_ms);
     });
   } else if (name == "profile") {
-    return TypedPackedFunc<profiling::Report()>([sptr_to_self, this]() { return this->Profile(); });
+    return TypedPackedFunc<profiling::Report(Array<profiling::MetricCollector>, bool)>(
+        [sptr_to_self, this](Array<profiling::MetricCollector> collectors, bool timeline) {
+          return this->Profile(collectors, timeline);
+        });
   } else {
     return GraphExecutor::GetFunction(name, sptr_to_self);
   }
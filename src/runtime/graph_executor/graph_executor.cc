@@ -22,7 +22,9 @@
  */
 #include "graph_executor.h"
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
@@ -30,17 +32,25 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "../constant_store.h"
 #include "../file_utils.h"
+#include "../library_module.h"
+#include "../memory_accounting.h"
 
 namespace tvm {
 namespace runtime {
@@ -50,15 +60,496 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   if (align < kAllocAlignment) return kAllocAlignment;
   return align;
 }
+inline bool SameDevice(const Device& a, const Device& b) {
+  return a.device_type == b.device_type && a.device_id == b.device_id;
+}
 }  // namespace details
 
+void ActivationArenaObj::Reserve(Device dev, size_t size) {
+  for (Slot& slot : slots_) {
+    if (details::SameDevice(slot.device, dev)) {
+      slot.reserved = std::max(slot.reserved, size);
+      return;
+    }
+  }
+  slots_.push_back({dev, size, NDArray()});
+}
+
+NDArray ActivationArenaObj::GetBuffer(Device dev) {
+  for (Slot& slot : slots_) {
+    if (!details::SameDevice(slot.device, dev)) continue;
+    if (!slot.buffer.defined() || GetDataSize(*slot.buffer.operator->()) < slot.reserved) {
+      // The executors bound to the previous buffer keep it alive until they bind again.
+      std::vector<int64_t> shape{static_cast<int64_t>(slot.reserved + 3) / 4};
+      slot.buffer = NDArray::Empty(shape, DLDataType{kDLFloat, 32, 1}, dev);
+      ++generation;
+    }
+    return slot.buffer;
+  }
+  LOG(FATAL) << "No activation storage is reserved on " << dev;
+  return NDArray();
+}
+
+size_t ActivationArenaObj::ReservedBytes() const {
+  size_t total = 0;
+  for (const Slot& slot : slots_) {
+    total += slot.reserved;
+  }
+  return total;
+}
+
+TVM_REGISTER_OBJECT_TYPE(ActivationArenaObj);
+
 /*!
  * \brief Run all the operations one by one.
  */
+GraphExecutor::~GraphExecutor() {
+  if (arena_.defined()) {
+    std::lock_guard<std::mutex> lock(arena_->mutex);
+    if (arena_->owner == this) arena_->owner = nullptr;
+  }
+  FreeStreams();
+  if (has_upload_stream_) {
+    DeviceAPI::Get(upload_device_)->FreeStream(upload_device_, upload_stream_);
+  }
+}
+
 void GraphExecutor::Run() {
-  // setup the array and requirements.
+  auto arena_lock = LockActivationArena();
+  threading::ThreadPoolScope pool_scope(thread_pool_);
+  if (double_buffered_inputs_) SwapInputBuffers();
+  if (sampler_.BeginInvocation()) {
+    RunSampled();
+  } else if (result_cache_.enabled() && !cached_subgraphs_.empty()) {
+    RunCached();
+  } else if (num_streams_ > 1) {
+    RunMultiStream();
+  } else if (inter_op_parallelism_ > 1) {
+    RunDataflow();
+  } else if (has_branches_) {
+    RunBranches();
+  } else {
+    // setup the array and requirements.
+    for (size_t i = 0; i < op_execs_.size(); ++i) {
+      if (op_execs_[i]) op_execs_[i]();
+    }
+  }
+  for (const auto& link : output_links_) {
+    data_entry_[link.first].CopyTo(data_entry_[link.second]);
+  }
+}
+
+void GraphExecutor::RunSampled() {
   for (size_t i = 0; i < op_execs_.size(); ++i) {
-    if (op_execs_[i]) op_execs_[i]();
+    if (!op_execs_[i]) continue;
+    const Device& dev = data_entry_[entry_id(i, 0)]->device;
+    sampler_.StartOp(i, dev);
+    op_execs_[i]();
+    sampler_.StopOp();
+  }
+  sampler_.EndInvocation();
+}
+
+void GraphExecutor::SetSamplingInterval(int64_t interval) {
+  std::vector<std::string> names;
+  for (const Node& node : nodes_) {
+    names.push_back(node.op_type == "tvm_op" ? node.param.func_name : node.name);
+  }
+  sampler_.Configure(interval, names);
+}
+
+void GraphExecutor::RunCached() {
+  std::vector<uint64_t> keys(cached_subgraphs_.size());
+  std::vector<ObjectRef> hits(cached_subgraphs_.size());
+  std::vector<std::vector<NDArray>> key_inputs(cached_subgraphs_.size());
+  std::vector<int> slots(op_execs_.size(), -1);
+  std::vector<bool> skip(op_execs_.size(), false);
+  std::unordered_map<uint32_t, bool> predicates;
+  for (size_t i = 0; i < cached_subgraphs_.size(); ++i) {
+    const CachedSubgraph& subgraph = cached_subgraphs_[i];
+    slots[subgraph.nid] = static_cast<int>(i);
+    for (uint32_t eid : subgraph.key_eids) key_inputs[i].push_back(data_entry_[eid]);
+    if (result_cache_.Lookup(i, key_inputs[i], &keys[i], &hits[i])) {
+      for (uint32_t nid : subgraph.skipped) skip[nid] = true;
+    }
+  }
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    int slot = slots[nid];
+    if (slot >= 0 && hits[slot].defined()) {
+      Array<NDArray> outputs = Downcast<Array<NDArray>>(hits[slot]);
+      for (uint32_t i = 0; i < outputs.size(); ++i) {
+        EntryArray(entry_id(nid, i)).CopyFrom(outputs[i]);
+      }
+      continue;
+    }
+    if (skip[nid] || !op_execs_[nid]) continue;
+    if (has_branches_ && !InTakenBranches(nid, &predicates)) continue;
+    op_execs_[nid]();
+    if (slot >= 0) {
+      Array<NDArray> outputs;
+      for (uint32_t i = 0; i < nodes_[nid].param.num_outputs; ++i) {
+        NDArray entry = EntryArray(entry_id(nid, i));
+        outputs.push_back(entry.CopyTo(entry->device));
+      }
+      result_cache_.Insert(slot, keys[slot], key_inputs[slot], outputs);
+    }
+  }
+}
+
+namespace {
+/*! \brief Read a scalar predicate, on any device. */
+bool ReadPredicate(const DLTensor* pred) {
+  size_t nbytes = GetDataSize(*pred);
+  ICHECK_LE(nbytes, sizeof(int64_t)) << "the predicate of a branch must be a scalar";
+  int64_t value = 0;
+  TVM_CCALL(TVMArrayCopyToBytes(const_cast<DLTensor*>(pred), &value, nbytes));
+  return value != 0;
+}
+}  // namespace
+
+void GraphExecutor::RunBranches() {
+  std::unordered_map<uint32_t, bool> predicates;
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (op_execs_[nid] && InTakenBranches(nid, &predicates)) op_execs_[nid]();
+  }
+}
+
+bool GraphExecutor::InTakenBranches(uint32_t nid,
+                                    std::unordered_map<uint32_t, bool>* predicates) const {
+  for (const auto& cond : branch_guards_[nid]) {
+    auto it = predicates->find(cond.first);
+    if (it == predicates->end()) {
+      it = predicates->emplace(cond.first, ReadPredicate(data_entry_[cond.first].operator->()))
+               .first;
+    }
+    if (it->second != cond.second) return false;
+  }
+  return true;
+}
+
+void GraphExecutor::SetupBranchGuards() {
+  branch_guards_.assign(nodes_.size(), {});
+  has_branches_ = false;
+  for (uint32_t nid = 0; nid < nodes_.size(); ++nid) {
+    auto it = nodes_[nid].param.attrs.find("branch_guard");
+    if (it == nodes_[nid].param.attrs.end()) continue;
+    std::istringstream is(std::string(Downcast<String>(it->second)));
+    std::string cond;
+    while (std::getline(is, cond, ';')) {
+      uint32_t pred_nid, index;
+      int value;
+      char sep0, sep1;
+      std::istringstream cs(cond);
+      cs >> pred_nid >> sep0 >> index >> sep1 >> value;
+      ICHECK(cs && sep0 == ':' && sep1 == ':' && pred_nid < nid)
+          << "invalid branch guard " << cond << " of node " << nodes_[nid].name;
+      branch_guards_[nid].emplace_back(entry_id(pred_nid, index), value != 0);
+    }
+    has_branches_ = has_branches_ || !branch_guards_[nid].empty();
+  }
+}
+
+NDArray GraphExecutor::EntryArray(uint32_t eid) const {
+  auto it = bound_output_entries_.find(eid);
+  return it == bound_output_entries_.end() ? data_entry_[eid] : bound_outputs_[it->second];
+}
+
+void GraphExecutor::SetResultCache(int64_t max_bytes, const std::vector<std::string>& outputs,
+                                   const std::vector<std::string>& inputs) {
+  std::unordered_set<uint32_t> key_nids;
+  for (const std::string& name : inputs) {
+    int index = GetInputIndex(name);
+    ICHECK_GE(index, 0) << "cannot find the input " << name << " of the result cache";
+    key_nids.insert(input_nodes_[index]);
+  }
+  std::vector<bool> is_output(nodes_.size(), false);
+  for (const NodeEntry& e : outputs_) is_output[e.node_id] = true;
+  std::vector<std::vector<uint32_t>> consumers(nodes_.size());
+  for (uint32_t nid = 0; nid < nodes_.size(); ++nid) {
+    for (const NodeEntry& e : nodes_[nid].inputs) consumers[e.node_id].push_back(nid);
+  }
+
+  cached_subgraphs_.clear();
+  for (const std::string& name : outputs) {
+    uint32_t root = 0;
+    while (root < nodes_.size() && nodes_[root].name != name) ++root;
+    ICHECK(root < nodes_.size() && nodes_[root].op_type == "tvm_op")
+        << "cannot find the operator " << name << " of the result cache";
+    CachedSubgraph subgraph;
+    subgraph.nid = root;
+    // the nodes the root depends on, the inputs of a node come before it
+    std::vector<bool> upstream(nodes_.size(), false);
+    upstream[root] = true;
+    for (uint32_t nid = root + 1; nid-- > 0;) {
+      if (!upstream[nid]) continue;
+      for (const NodeEntry& e : nodes_[nid].inputs) upstream[e.node_id] = true;
+      if (key_nids.count(nid)) subgraph.key_eids.push_back(entry_id(nid, 0));
+    }
+    ICHECK(!subgraph.key_eids.empty()) << "the output " << name
+                                       << " of the result cache depends on no key input";
+    // the operators only feeding the subgraph, from the root up
+    std::vector<bool> skipped(nodes_.size(), false);
+    for (uint32_t nid = root + 1; nid-- > 0;) {
+      if (!upstream[nid] || nodes_[nid].op_type == "null") continue;
+      bool internal = nid == root;
+      if (!internal && !is_output[nid]) {
+        internal = std::all_of(consumers[nid].begin(), consumers[nid].end(),
+                               [&skipped](uint32_t consumer) { return skipped[consumer]; });
+      }
+      if (internal) {
+        skipped[nid] = true;
+        subgraph.skipped.push_back(nid);
+      }
+    }
+    cached_subgraphs_.push_back(std::move(subgraph));
+  }
+  result_cache_.Configure(max_bytes);
+}
+
+void GraphExecutor::SetInterOpParallelism(int level) {
+  ICHECK_GE(level, 1) << "inter-op parallelism level must be at least 1";
+  inter_op_parallelism_ = level;
+}
+
+namespace {
+/*! \brief Shared state of the tasks executing one dataflow run. */
+struct DataflowRun {
+  const std::vector<std::function<void()>>* op_execs;
+  const std::vector<std::vector<uint32_t>>* successors;
+  std::unique_ptr<std::atomic<int>[]> pending;
+  std::mutex mutex;
+  std::deque<uint32_t> ready;
+  uint32_t num_ops{0};
+  std::atomic<uint32_t> num_done{0};
+  std::atomic<bool> failed{false};
+  std::string error;
+  int max_tasks{1};
+};
+
+int DataflowTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  DataflowRun* run = static_cast<DataflowRun*>(cdata);
+  if (task_id >= run->max_tasks) return 0;
+  while (run->num_done.load(std::memory_order_acquire) < run->num_ops &&
+         !run->failed.load(std::memory_order_relaxed)) {
+    uint32_t nid = 0;
+    bool found = false;
+    {
+      std::lock_guard<std::mutex> lock(run->mutex);
+      if (!run->ready.empty()) {
+        nid = run->ready.front();
+        run->ready.pop_front();
+        found = true;
+      }
+    }
+    if (!found) {
+      threading::Yield();
+      continue;
+    }
+    try {
+      (*run->op_execs)[nid]();
+    } catch (const std::exception& e) {
+      std::lock_guard<std::mutex> lock(run->mutex);
+      run->error = e.what();
+      run->failed.store(true);
+      break;
+    }
+    for (uint32_t succ : (*run->successors)[nid]) {
+      if (run->pending[succ].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        run->ready.push_back(succ);
+      }
+    }
+    // Successors are queued before the op counts as done so no task exits early.
+    run->num_done.fetch_add(1, std::memory_order_release);
+  }
+  if (run->failed.load()) {
+    std::lock_guard<std::mutex> lock(run->mutex);
+    TVMAPISetLastError(run->error.c_str());
+    return -1;
+  }
+  return 0;
+}
+}  // namespace
+
+void GraphExecutor::BuildOpDependencies() {
+  size_t num_nodes = op_execs_.size();
+  size_t num_storage = storage_pool_.size();
+  std::vector<std::vector<uint32_t>> deps(num_nodes);
+  std::vector<int> last_writer(num_storage, -1);
+  std::vector<std::vector<uint32_t>> readers(num_storage);
+  auto add_dep = [&deps](uint32_t nid, int dep) {
+    if (dep >= 0 && static_cast<uint32_t>(dep) != nid) deps[nid].push_back(dep);
+  };
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (!op_execs_[nid]) continue;
+    const auto& inode = nodes_[nid];
+    for (const auto& e : inode.inputs) {
+      uint32_t sid = attrs_.storage_id[entry_id(e)];
+      // Producers without an executor (inputs and params) are ready before the run.
+      if (op_execs_[e.node_id]) add_dep(nid, e.node_id);
+      add_dep(nid, last_writer[sid]);
+      readers[sid].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      uint32_t sid = attrs_.storage_id[entry_id(nid, index)];
+      // Storage shared with earlier entries: wait until they are consumed.
+      add_dep(nid, last_writer[sid]);
+      for (uint32_t reader : readers[sid]) add_dep(nid, reader);
+      readers[sid].clear();
+      last_writer[sid] = nid;
+    }
+  }
+  op_successors_.assign(num_nodes, {});
+  op_num_deps_.assign(num_nodes, 0);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    std::sort(deps[nid].begin(), deps[nid].end());
+    deps[nid].erase(std::unique(deps[nid].begin(), deps[nid].end()), deps[nid].end());
+    op_num_deps_[nid] = static_cast<int>(deps[nid].size());
+    for (uint32_t dep : deps[nid]) op_successors_[dep].push_back(nid);
+  }
+}
+
+void GraphExecutor::RunDataflow() {
+  if (op_num_deps_.size() != op_execs_.size()) BuildOpDependencies();
+  DataflowRun run;
+  run.op_execs = &op_execs_;
+  run.successors = &op_successors_;
+  run.pending.reset(new std::atomic<int>[op_execs_.size()]);
+  run.max_tasks = inter_op_parallelism_;
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    run.pending[nid].store(op_num_deps_[nid], std::memory_order_relaxed);
+    if (op_num_deps_[nid] == 0) run.ready.push_back(nid);
+    ++run.num_ops;
+  }
+  if (run.num_ops == 0) return;
+  // Launch on every worker and let the tasks beyond the parallelism level return at once,
+  // the pool rejects explicit task counts above its worker count.
+  int ret = TVMBackendParallelLaunch(DataflowTask, &run, 0);
+  ICHECK_EQ(ret, 0) << TVMGetLastError();
+}
+
+void GraphExecutor::SetNumStreams(int num_streams) {
+  ICHECK_GE(num_streams, 1) << "the number of streams must be at least 1";
+  if (num_streams == num_streams_) return;
+  FreeStreams();
+  num_streams_ = num_streams;
+}
+
+void GraphExecutor::FreeStreams() {
+  for (TVMStreamHandle stream : streams_) {
+    DeviceAPI::Get(stream_device_)->FreeStream(stream_device_, stream);
+  }
+  streams_.clear();
+  op_streams_.clear();
+  op_stream_waits_.clear();
+}
+
+std::vector<int64_t> GraphExecutor::GetStreamAssignment() {
+  if (op_streams_.size() != op_execs_.size()) PlanStreams();
+  return std::vector<int64_t>(op_streams_.begin(), op_streams_.end());
+}
+
+void GraphExecutor::PlanStreams() {
+  if (op_num_deps_.size() != op_execs_.size()) BuildOpDependencies();
+  size_t num_nodes = op_execs_.size();
+  auto op_device = [this](uint32_t nid, Device* dev) {
+    if (!op_execs_[nid] || nodes_[nid].param.num_outputs == 0 ||
+        nodes_[nid].param.func_name == "__copy") {
+      return false;
+    }
+    *dev = data_entry_[entry_id(nid, 0)]->device;
+    return true;
+  };
+  // The streams belong to the first accelerator an operator runs on, the
+  // operators of the host and of other devices stay on the default stream.
+  FreeStreams();
+  stream_device_ = Device{kDLCPU, 0};
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    Device dev;
+    if (op_device(nid, &dev) && dev.device_type != kDLCPU) {
+      stream_device_ = dev;
+      break;
+    }
+  }
+
+  std::vector<std::vector<uint32_t>> deps(num_nodes);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    for (uint32_t succ : op_successors_[nid]) deps[succ].push_back(nid);
+  }
+  op_streams_.assign(num_nodes, -1);
+  op_stream_waits_.assign(num_nodes, {});
+  // Slot s + 1 describes stream s, slot 0 the default stream.
+  size_t num_slots = num_streams_ + 1;
+  std::vector<int> tail(num_slots, -1);
+  std::vector<size_t> load(num_streams_, 0);
+  // synced[a][b]: the last node of slot b known to be complete for the work of slot a.
+  std::vector<std::vector<int>> synced(num_slots, std::vector<int>(num_slots, -1));
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (!op_execs_[nid]) continue;
+    Device dev;
+    int stream = -1;
+    if (op_device(nid, &dev) && dev.device_type == stream_device_.device_type &&
+        dev.device_id == stream_device_.device_id) {
+      for (uint32_t dep : deps[nid]) {
+        int s = op_streams_[dep];
+        if (s >= 0 && tail[s + 1] == static_cast<int>(dep)) {
+          stream = s;
+          break;
+        }
+      }
+      if (stream < 0) {
+        stream = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+      }
+      load[stream] += 1;
+    }
+    op_streams_[nid] = stream;
+    for (uint32_t dep : deps[nid]) {
+      int s = op_streams_[dep];
+      if (s == stream) continue;
+      int& last = synced[stream + 1][s + 1];
+      if (last >= static_cast<int>(dep)) continue;
+      // The event covers everything launched on s so far.
+      last = tail[s + 1];
+      op_stream_waits_[nid].push_back(s);
+    }
+    tail[stream + 1] = nid;
+  }
+}
+
+void GraphExecutor::RunMultiStream() {
+  if (op_streams_.size() != op_execs_.size()) PlanStreams();
+  DeviceAPI* api = DeviceAPI::Get(stream_device_);
+  while (streams_.size() < static_cast<size_t>(num_streams_)) {
+    streams_.push_back(api->CreateStream(stream_device_));
+  }
+  auto handle = [this](int s) { return s < 0 ? nullptr : streams_[s]; };
+  // The work queued before the run, e.g. copying the inputs, comes first.
+  for (TVMStreamHandle stream : streams_) {
+    api->SyncStreamFromTo(stream_device_, nullptr, stream);
+  }
+  int current = -1;
+  try {
+    for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+      if (!op_execs_[nid]) continue;
+      int stream = op_streams_[nid];
+      for (int wait : op_stream_waits_[nid]) {
+        api->SyncStreamFromTo(stream_device_, handle(wait), handle(stream));
+      }
+      if (stream != current) {
+        api->SetStream(stream_device_, handle(stream));
+        current = stream;
+      }
+      op_execs_[nid]();
+    }
+  } catch (...) {
+    api->SetStream(stream_device_, nullptr);
+    throw;
+  }
+  api->SetStream(stream_device_, nullptr);
+  // Reading the outputs from the default stream sees the results of all streams.
+  for (TVMStreamHandle stream : streams_) {
+    api->SyncStreamFromTo(stream_device_, stream, nullptr);
   }
 }
 
@@ -110,10 +601,107 @@ int GraphExecutor::GetInputIndex(const std::string& name) {
  * \param data_in The input data.
  */
 void GraphExecutor::SetInput(int index, DLTensor* data_in) {
+  if (double_buffered_inputs_) {
+    SetInputAsync(index, data_in, nullptr);
+    return;
+  }
   ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
   uint32_t eid = this->entry_id(input_nodes_[index], 0);
   data_entry_[eid].CopyFrom(data_in);
 }
+
+void GraphExecutor::SetInputAsync(int index, DLTensor* data_in, TVMStreamHandle stream) {
+  ICHECK_LT(static_cast<size_t>(index), input_nodes_.size());
+  uint32_t eid = this->entry_id(input_nodes_[index], 0);
+  NDArray target = data_entry_[eid];
+  if (double_buffered_inputs_) {
+    ICHECK(stream == nullptr) << "double-buffered inputs are uploaded on their own stream";
+    if (!back_inputs_[index].defined()) {
+      back_inputs_[index] = NDArray::Empty(target.Shape(), target->dtype, target->device);
+    }
+    if (!has_upload_stream_) {
+      upload_device_ = target->device;
+      upload_stream_ = DeviceAPI::Get(upload_device_)->CreateStream(upload_device_);
+      has_upload_stream_ = true;
+    }
+    ICHECK(upload_device_.device_type == target->device.device_type &&
+           upload_device_.device_id == target->device.device_id)
+        << "double-buffered inputs must all be on the same device";
+    target = back_inputs_[index];
+    stream = upload_stream_;
+    back_input_pending_[index] = true;
+  }
+  NDArray::CopyFromTo(data_in, const_cast<DLTensor*>(target.operator->()), stream);
+}
+
+void GraphExecutor::SetDoubleBufferedInputs(bool enable) {
+  if (!enable && has_upload_stream_) {
+    // Keep the inputs uploaded since the last run.
+    SwapInputBuffers();
+    DeviceAPI* api = DeviceAPI::Get(upload_device_);
+    api->StreamSync(upload_device_, upload_stream_);
+    api->FreeStream(upload_device_, upload_stream_);
+    upload_stream_ = nullptr;
+    has_upload_stream_ = false;
+  }
+  double_buffered_inputs_ = enable;
+  back_inputs_.assign(enable ? input_nodes_.size() : 0, NDArray());
+  back_input_pending_.assign(enable ? input_nodes_.size() : 0, false);
+}
+
+void GraphExecutor::SwapInputBuffers() {
+  if (!has_upload_stream_) return;
+  DeviceAPI* api = DeviceAPI::Get(upload_device_);
+  // The run waits for the uploads, and the later uploads wait for the earlier runs,
+  // which read the buffers they overwrite once swapped out.
+  api->SyncStreamFromTo(upload_device_, upload_stream_, nullptr);
+  api->SyncStreamFromTo(upload_device_, nullptr, upload_stream_);
+  for (size_t index = 0; index < back_inputs_.size(); ++index) {
+    if (!back_input_pending_[index]) continue;
+    uint32_t eid = this->entry_id(input_nodes_[index], 0);
+    std::swap(data_entry_[eid], back_inputs_[index]);
+    for (DLTensor* t : input_dltensors_[eid]) {
+      t->data = data_entry_[eid]->data;
+    }
+    back_input_pending_[index] = false;
+  }
+}
+void GraphExecutor::LinkOutputToInput(int output_index, int input_index) {
+  ICHECK_LT(static_cast<size_t>(output_index), outputs_.size());
+  uint32_t out_eid = this->entry_id(outputs_[output_index]);
+  output_links_.erase(std::remove_if(output_links_.begin(), output_links_.end(),
+                                     [&](const std::pair<uint32_t, uint32_t>& link) {
+                                       return link.first == out_eid;
+                                     }),
+                      output_links_.end());
+  if (input_index < 0) return;
+  ICHECK_LT(static_cast<size_t>(input_index), input_nodes_.size());
+  ICHECK(static_cast<size_t>(output_index) >= bound_outputs_.size() ||
+         !bound_outputs_[output_index].defined())
+      << "The output " << output_index << " is bound to an external array, it cannot be linked";
+  uint32_t in_eid = this->entry_id(input_nodes_[input_index], 0);
+  const DLTensor* out = data_entry_[out_eid].operator->();
+  const DLTensor* in = data_entry_[in_eid].operator->();
+  ICHECK(DataType(out->dtype) == DataType(in->dtype) && out->ndim == in->ndim &&
+         std::equal(out->shape, out->shape + out->ndim, in->shape))
+      << "The output " << output_index << " cannot be copied into the input " << input_index
+      << ", they differ in type or shape";
+  output_links_.emplace_back(out_eid, in_eid);
+}
+namespace {
+// Check that a tensor can stand in for the entry of the graph, as a zero-copy input or output.
+void CheckZeroCopyConsistency(const DLTensor* old_t, const DLTensor* data_ref, size_t alignment) {
+  ICHECK_EQ(alignment, details::GetDataAlignment(*data_ref));
+  ICHECK_EQ(reinterpret_cast<size_t>(data_ref->data) % kAllocAlignment, 0);
+  ICHECK_EQ(old_t->ndim, static_cast<size_t>(data_ref->ndim));
+  ICHECK_EQ(old_t->device.device_type, data_ref->device.device_type);
+  ICHECK_EQ(old_t->device.device_id, data_ref->device.device_id);
+  for (auto i = 0; i < data_ref->ndim; ++i) {
+    ICHECK_EQ(old_t->shape[i], data_ref->shape[i]);
+  }
+}
+}  // namespace
+
 /*!
  * \brief set index-th input to the graph without copying the data.
  * \param index The input index.
@@ -125,20 +713,99 @@ void GraphExecutor::SetInputZeroCopy(int index, DLTensor* data_ref) {
   const DLTensor* old_t = data_entry_[eid].operator->();
 
   // check the consistency of input
-  ICHECK_EQ(data_alignment_[eid], details::GetDataAlignment(*data_ref));
-  ICHECK_EQ(reinterpret_cast<size_t>(data_ref->data) % kAllocAlignment, 0);
-  ICHECK_EQ(old_t->ndim, static_cast<size_t>(data_ref->ndim));
-  ICHECK_EQ(old_t->device.device_type, data_ref->device.device_type);
-  ICHECK_EQ(old_t->device.device_id, data_ref->device.device_id);
-  for (auto i = 0; i < data_ref->ndim; ++i) {
-    ICHECK_EQ(old_t->shape[i], data_ref->shape[i]);
-  }
+  CheckZeroCopyConsistency(old_t, data_ref, data_alignment_[eid]);
 
   // Update the data pointer for each argument of each op
   for (DLTensor* t : input_dltensors_[eid]) {
     t->data = data_ref->data;
   }
 }
+std::vector<int64_t> GraphExecutor::ResolveInputs(const std::vector<std::string>& names) {
+  std::vector<int64_t> indices;
+  indices.reserve(names.size());
+  for (const std::string& name : names) {
+    int index = GetInputIndex(name);
+    ICHECK_GE(index, 0) << "Cannot find the input " << name;
+    indices.push_back(index);
+  }
+  return indices;
+}
+
+void GraphExecutor::BindInputs(const std::vector<int64_t>& indices,
+                               const std::vector<DLTensor*>& data, bool zero_copy) {
+  ICHECK_EQ(indices.size(), data.size()) << "Expect one tensor per input";
+  for (size_t i = 0; i < indices.size(); ++i) {
+    if (zero_copy) {
+      SetInputZeroCopy(indices[i], data[i]);
+    } else {
+      SetInput(indices[i], data[i]);
+    }
+  }
+}
+
+std::vector<uint32_t> GraphExecutor::OutputAliasEntries(const NodeEntry& e) const {
+  std::vector<uint32_t> eids{entry_id(e)};
+  uint32_t nid = e.node_id;
+  while (nodes_[nid].op_type != "null" && nodes_[nid].param.func_name == "__nop") {
+    const NodeEntry& input = nodes_[nid].inputs[0];
+    eids.push_back(entry_id(input));
+    nid = input.node_id;
+  }
+  if (nodes_[nid].op_type == "null") return {};
+  return eids;
+}
+
+void GraphExecutor::SetOutputZeroCopy(int index, NDArray data) {
+  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  std::vector<uint32_t> eids = OutputAliasEntries(outputs_[index]);
+  ICHECK(!eids.empty()) << "The output " << index
+                        << " is an input or a parameter of the graph, it cannot be bound";
+  bound_outputs_.resize(outputs_.size());
+  // Give the entries back to the graph storage first.
+  for (uint32_t eid : eids) {
+    auto it = bound_output_entries_.find(eid);
+    if (it == bound_output_entries_.end() || it->second != index) continue;
+    bound_output_entries_.erase(it);
+    for (DLTensor* t : output_dltensors_[eid]) {
+      t->data = data_entry_[eid]->data;
+    }
+  }
+  bound_outputs_[index] = NDArray();
+  if (!data.defined()) return;
+
+  for (uint32_t eid : eids) {
+    ICHECK(std::none_of(output_links_.begin(), output_links_.end(),
+                        [&](const std::pair<uint32_t, uint32_t>& link) {
+                          return link.first == eid;
+                        }))
+        << "The output " << index << " is linked to an input, it cannot be bound";
+    auto it = bound_output_entries_.find(eid);
+    ICHECK(it == bound_output_entries_.end())
+        << "The output " << index << " shares its storage with the bound output " << it->second;
+  }
+  uint32_t out_eid = eids[0];
+  CheckZeroCopyConsistency(data_entry_[out_eid].operator->(), data.operator->(),
+                           data_alignment_[out_eid]);
+  ICHECK(DataType(data->dtype) == DataType(data_entry_[out_eid]->dtype))
+      << "The output " << index << " is of type " << DataType(data_entry_[out_eid]->dtype)
+      << ", not " << DataType(data->dtype);
+  for (uint32_t eid : eids) {
+    bound_output_entries_[eid] = index;
+    for (DLTensor* t : output_dltensors_[eid]) {
+      t->data = data->data;
+    }
+  }
+  bound_outputs_[index] = data;
+}
+
+void GraphExecutor::BindOutputsZeroCopy(const std::vector<int64_t>& indices,
+                                        const std::vector<NDArray>& data) {
+  ICHECK_EQ(indices.size(), data.size()) << "Expect one array per output";
+  for (size_t i = 0; i < indices.size(); ++i) {
+    SetOutputZeroCopy(indices[i], data[i]);
+  }
+}
+
 /*!
  * \brief Get the number of outputs
  *
@@ -170,6 +837,9 @@ NDArray GraphExecutor::GetInput(int index) const {
  */
 NDArray GraphExecutor::GetOutput(int index) const {
   ICHECK_LT(static_cast<size_t>(index), outputs_.size());
+  if (static_cast<size_t>(index) < bound_outputs_.size() && bound_outputs_[index].defined()) {
+    return bound_outputs_[index];
+  }
   uint32_t eid = this->entry_id(outputs_[index]);
   return data_entry_[eid];
 }
@@ -179,17 +849,23 @@ NDArray GraphExecutor::GetOutput(int index) const {
  * \param data_out the output data.
  */
 void GraphExecutor::CopyOutputTo(int index, DLTensor* data_out) {
-  ICHECK_LT(static_cast<size_t>(index), outputs_.size());
-  uint32_t eid = this->entry_id(outputs_[index]);
-
   // Check the shapes to avoid receiving in different dimension but same size.
-  const NDArray& data = data_entry_[eid];
+  NDArray data = GetOutput(index);
   ICHECK_EQ(data->ndim, data_out->ndim);
   for (int32_t j = 0; j < data->ndim; ++j) {
     ICHECK_EQ(data->shape[j], data_out->shape[j]);
   }
 
-  data_entry_[eid].CopyTo(data_out);
+  data.CopyTo(data_out);
+}
+
+void GraphExecutor::CopyOutputToAsync(int index, DLTensor* data_out, TVMStreamHandle stream) {
+  NDArray data = GetOutput(index);
+  ICHECK_EQ(data->ndim, data_out->ndim);
+  for (int32_t j = 0; j < data->ndim; ++j) {
+    ICHECK_EQ(data->shape[j], data_out->shape[j]);
+  }
+  NDArray::CopyFromTo(data.operator->(), data_out, stream);
 }
 
 /*!
@@ -211,6 +887,42 @@ void GraphExecutor::LoadParams(dmlc::Stream* strm) {
   }
 }
 
+void GraphExecutor::LoadMappedParams(const std::string& file_name, bool share) {
+  this->BindParams(::tvm::runtime::LoadMappedParams(file_name), share);
+}
+
+void GraphExecutor::LoadSharedParams(const std::string& param_blob) {
+  dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
+  this->BindParams(::tvm::runtime::LoadParams(&strm), true);
+}
+
+void GraphExecutor::BindParams(const Map<String, NDArray>& params, bool share) {
+  ConstantStore* store = ConstantStore::Global();
+  if (share) {
+    // Release the parameters of the executors destroyed since the last load.
+    store->Prune();
+  }
+  for (auto& p : params) {
+    int in_idx = GetInputIndex(p.first);
+    if (in_idx < 0) continue;
+    uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
+    const DLTensor* old_t = data_entry_[eid].operator->();
+    const DLTensor* new_t = p.second.operator->();
+    bool same_layout = old_t->ndim == new_t->ndim && TypeEqual(old_t->dtype, new_t->dtype) &&
+                       std::equal(old_t->shape, old_t->shape + old_t->ndim, new_t->shape);
+    if (same_layout && share) {
+      data_entry_[eid] = store->Intern(p.second, old_t->device);
+      data_alignment_[eid] = details::GetDataAlignment(*data_entry_[eid].operator->());
+    } else if (same_layout && old_t->device.device_type == kDLCPU) {
+      data_entry_[eid] = p.second;
+      data_alignment_[eid] = details::GetDataAlignment(*new_t);
+    } else {
+      data_entry_[eid].CopyFrom(p.second);
+    }
+  }
+  this->SetupOpExecs();
+}
+
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
@@ -236,6 +948,122 @@ void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm)
   this->SetupOpExecs();
 }
 
+void GraphExecutor::SetSharedParamsSource(const GraphExecutor* other,
+                                          const std::unordered_set<std::string>& param_names) {
+  ICHECK(nodes_.empty()) << "SetSharedParamsSource must be called before Init";
+  shared_params_source_ = other;
+  shared_param_names_ = param_names;
+}
+
+void GraphExecutor::SetActivationArena(ActivationArena arena) {
+  ICHECK(arena.defined());
+  ICHECK(!nodes_.empty()) << "SetActivationArena must be called after Init";
+  ICHECK(!arena_.defined()) << "The executor already draws its activations from an arena";
+  // The storage outliving a run stays planned: inputs and parameters, outputs and their aliases.
+  std::vector<bool> persistent(storage_pool_.size(), false);
+  for (uint32_t nid : input_nodes_) {
+    persistent[attrs_.storage_id[entry_id(nid, 0)]] = true;
+  }
+  for (const NodeEntry& e : outputs_) {
+    for (uint32_t eid : OutputAliasEntries(e)) {
+      persistent[attrs_.storage_id[eid]] = true;
+    }
+  }
+  for (size_t eid = 0; eid < attrs_.storage_scope.size(); ++eid) {
+    if (IsTextureStorage(attrs_.storage_scope[eid])) persistent[attrs_.storage_id[eid]] = true;
+  }
+
+  // Lay the other storage entries out in the buffer of their device.
+  std::vector<std::pair<Device, size_t>> sizes;
+  std::vector<size_t> offsets(storage_pool_.size(), 0);
+  for (uint32_t sid = 0; sid < storage_pool_.size(); ++sid) {
+    if (persistent[sid]) continue;
+    const DLTensor* storage = storage_pool_[sid].operator->();
+    auto it = std::find_if(sizes.begin(), sizes.end(), [storage](const auto& size) {
+      return details::SameDevice(size.first, storage->device);
+    });
+    if (it == sizes.end()) it = sizes.insert(sizes.end(), {storage->device, 0});
+    offsets[sid] = (it->second + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+    it->second = offsets[sid] + GetDataSize(*storage);
+    arena_sids_.push_back(sid);
+  }
+  {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    for (const auto& size : sizes) {
+      arena->Reserve(size.first, size.second);
+    }
+  }
+
+  std::unordered_map<uint32_t, size_t> entry_index;
+  for (uint32_t eid = 0; eid < num_node_entries(); ++eid) {
+    uint32_t sid = attrs_.storage_id[eid];
+    if (persistent[sid]) continue;
+    entry_index[eid] = arena_entries_.size();
+    size_t offset = offsets[sid] + (attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[eid]);
+    arena_entries_.push_back({eid, data_entry_[eid]->device, offset, {}});
+  }
+  for (uint32_t nid = 0; nid < op_args_.size(); ++nid) {
+    if (!op_args_[nid]) continue;
+    const auto& inode = nodes_[nid];
+    std::vector<uint32_t> eids;
+    for (const auto& e : inode.inputs) {
+      eids.push_back(entry_id(e));
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      eids.push_back(entry_id(nid, index));
+    }
+    for (size_t i = 0; i < eids.size(); ++i) {
+      auto it = entry_index.find(eids[i]);
+      if (it == entry_index.end()) continue;
+      arena_entries_[it->second].args.push_back(
+          static_cast<DLTensor*>(op_args_[nid]->arg_values[i].v_handle));
+    }
+  }
+  arena_ = arena;
+}
+
+void GraphExecutor::AcquireActivationArena() { LockActivationArena(); }
+
+std::unique_lock<std::mutex> GraphExecutor::LockActivationArena() {
+  if (!arena_.defined()) return std::unique_lock<std::mutex>();
+  std::unique_lock<std::mutex> lock(arena_->mutex);
+  BindActivationArena();
+  return lock;
+}
+
+void GraphExecutor::BindActivationArena() {
+  // Get all the buffers first, growing one for this executor reallocates it.
+  std::vector<std::pair<Device, NDArray>> buffers;
+  auto find_buffer = [&buffers](const Device& dev) {
+    return std::find_if(buffers.begin(), buffers.end(), [&dev](const auto& buffer) {
+      return details::SameDevice(buffer.first, dev);
+    });
+  };
+  for (const ArenaEntry& entry : arena_entries_) {
+    if (find_buffer(entry.device) == buffers.end()) {
+      buffers.emplace_back(entry.device, arena_->GetBuffer(entry.device));
+    }
+  }
+  arena_->owner = this;
+  if (arena_generation_ == arena_->generation) return;
+  for (const ArenaEntry& entry : arena_entries_) {
+    NDArray buffer = find_buffer(entry.device)->second;
+    void* data = static_cast<char*>(buffer->data) + entry.offset;
+    NDArray view = buffer.CreateView(attrs_.shape[entry.eid], data_entry_[entry.eid]->dtype);
+    const_cast<DLTensor*>(view.operator->())->data = data;
+    data_entry_[entry.eid] = view;
+    for (DLTensor* arg : entry.args) {
+      arg->data = data;
+    }
+  }
+  arena_generation_ = arena_->generation;
+  // The planned storage is no longer referenced by the entries.
+  for (uint32_t sid : arena_sids_) {
+    storage_pool_[sid] = NDArray();
+  }
+  arena_sids_.clear();
+}
+
 void GraphExecutor::LinkedNDArrayDeleter(Object* container) {
   // container is the NDArray::Container which needs to get deleted.
   // The data member points to global const memory, so it does not need deleting.
@@ -299,6 +1127,8 @@ void GraphExecutor::SetupStorage() {
     size_t bits = t.bits * t.lanes;
     ICHECK(bits % 8U == 0U || bits == 1U || bits == 4U);
     size_t bytes = ((bits + 7U) / 8U) * size;
+    // The entries of an arena are at offsets in its storage.
+    size_t offset = attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[i];
 
     uint32_t sid = static_cast<uint32_t>(storage_id);
     if (sid >= pool_entry.size()) {
@@ -319,12 +1149,61 @@ void GraphExecutor::SetupStorage() {
       pool_entry[sid].linked_param = lookup_rv;
     }
     pool_entry[sid].param_data_entry = i;
-    pool_entry[sid].size = std::max(pool_entry[sid].size, bytes);
+    pool_entry[sid].size = std::max(pool_entry[sid].size, offset + bytes);
     pool_entry[sid].device_type = device_type;
+    if (!attrs_.storage_scope.empty() && IsTextureStorage(attrs_.storage_scope[i])) {
+      // The image holds the tensors of the entry in their 2D layouts.
+      const std::string& scope = attrs_.storage_scope[i];
+      ICHECK_EQ(offset, 0U) << "A texture cannot be placed at an offset";
+      const std::vector<int64_t>& shape = attrs_.shape[i];
+      size_t axis = DefaultTextureLayoutSeparator(shape.size(), scope);
+      auto texture = ApplyTexture2DFlattening<int64_t>(shape, shape.size(), axis);
+      PoolEntry& entry = pool_entry[sid];
+      ICHECK(entry.scope.empty() || entry.scope == scope)
+          << "The same pool entry cannot be assigned to multiple storage scopes";
+      entry.scope = scope;
+      entry.dtype = t;
+      entry.texture_shape.width = std::max(entry.texture_shape.width, texture.width);
+      entry.texture_shape.height = std::max(entry.texture_shape.height, texture.height);
+      entry.texture_shape.channel = texture.channel;
+    }
+  }
+
+  // A storage entry holding nothing but shared parameters is taken from the source executor.
+  std::vector<bool> shared_storage(pool_entry.size(), false);
+  if (shared_params_source_ != nullptr) {
+    std::unordered_set<uint32_t> shared_eids;
+    for (uint32_t nid : input_nodes_) {
+      if (shared_param_names_.count(nodes_[nid].name)) {
+        shared_eids.insert(entry_id(nid, 0));
+      }
+    }
+    for (uint32_t eid : shared_eids) {
+      shared_storage[attrs_.storage_id[eid]] = true;
+    }
+    for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+      if (!shared_eids.count(i)) shared_storage[attrs_.storage_id[i]] = false;
+    }
+    ICHECK_EQ(shared_params_source_->storage_pool_.size(), pool_entry.size())
+        << "Can only share params between executors of the same graph";
+  }
+
+  // The entries holding nothing but inputs are accounted as parameters, the others as activations.
+  std::vector<bool> input_storage(pool_entry.size(), true);
+  {
+    std::unordered_set<uint32_t> input_eids;
+    for (uint32_t nid : input_nodes_) input_eids.insert(entry_id(nid, 0));
+    for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+      if (!input_eids.count(i)) input_storage[attrs_.storage_id[i]] = false;
+    }
   }
 
   // Allocate the space.
-  for (const auto& pit : pool_entry) {
+  for (size_t sid = 0; sid < pool_entry.size(); ++sid) {
+    const PoolEntry& pit = pool_entry[sid];
+    MemoryAccountingScope accounting(
+        input_storage[sid] ? MemoryCategory::kParams : MemoryCategory::kActivations,
+        "graph_executor");
     // This for loop is very fast since there are usually only a couple of
     // devices available on the same hardware.
     const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&pit](const Device& d) {
@@ -333,6 +1212,12 @@ void GraphExecutor::SetupStorage() {
     Device dev = cit == devices_.end() ? devices_[0] : *cit;
     if (pit.linked_param.defined()) {
       storage_pool_.push_back(pit.linked_param);
+    } else if (shared_storage[sid]) {
+      storage_pool_.push_back(shared_params_source_->storage_pool_[sid]);
+    } else if (!pit.scope.empty()) {
+      std::vector<int64_t> shape{pit.texture_shape.height, pit.texture_shape.width,
+                                 pit.texture_shape.channel};
+      storage_pool_.push_back(NDArray::Empty(shape, pit.dtype, dev, String(pit.scope)));
     } else {
       std::vector<int64_t> shape;
       shape.push_back(static_cast<int64_t>(pit.size + 3) / 4);
@@ -349,6 +1234,11 @@ void GraphExecutor::SetupStorage() {
     int storage_id = attrs_.storage_id[i];
     ICHECK_LT(static_cast<size_t>(storage_id), storage_pool_.size());
     data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    if (!attrs_.storage_offset.empty() && attrs_.storage_offset[i] != 0) {
+      // The kernels expect no byte offset, the view points to the entry instead.
+      DLTensor* view = const_cast<DLTensor*>(data_entry_[i].operator->());
+      view->data = static_cast<char*>(view->data) + attrs_.storage_offset[i];
+    }
 
     const DLTensor* tmp = data_entry_[i].operator->();
     data_alignment_[i] = details::GetDataAlignment(*tmp);
@@ -356,13 +1246,24 @@ void GraphExecutor::SetupStorage() {
 }
 
 void GraphExecutor::SetupOpExecs() {
+  SetupBranchGuards();
   op_execs_.resize(this->GetNumOfNodes());
+  op_args_.assign(this->GetNumOfNodes(), nullptr);
+  op_num_deps_.clear();
+  op_streams_.clear();
   input_dltensors_.resize(num_node_entries());
+  output_dltensors_.assign(num_node_entries(), {});
   std::unordered_set<uint32_t> input_node_eids;
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     uint32_t nid = input_nodes_[i];
     input_node_eids.insert(entry_id(nid, 0));
   }
+  std::unordered_set<uint32_t> output_node_eids;
+  for (const NodeEntry& e : outputs_) {
+    for (uint32_t eid : OutputAliasEntries(e)) {
+      output_node_eids.insert(eid);
+    }
+  }
 
   // setup the array and requirements.
   for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
@@ -381,6 +1282,7 @@ void GraphExecutor::SetupOpExecs() {
 
     std::shared_ptr<OpArgs> op_args = nullptr;
     std::tie(op_execs_[nid], op_args) = CreateTVMOp(inode.param, args, inode.inputs.size());
+    op_args_[nid] = op_args;
 
     for (size_t i = 0; i < inode.inputs.size(); i++) {
       uint32_t eid = this->entry_id(inode.inputs[i]);
@@ -388,6 +1290,16 @@ void GraphExecutor::SetupOpExecs() {
       if (input_node_eids.count(eid) > 0) {
         input_dltensors_[eid].push_back(static_cast<DLTensor*>(op_args->arg_values[i].v_handle));
       }
+      if (output_node_eids.count(eid) > 0) {
+        output_dltensors_[eid].push_back(static_cast<DLTensor*>(op_args->arg_values[i].v_handle));
+      }
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      uint32_t eid = this->entry_id(nid, index);
+      if (output_node_eids.count(eid) > 0) {
+        size_t i = inode.inputs.size() + index;
+        output_dltensors_[eid].push_back(static_cast<DLTensor*>(op_args->arg_values[i].v_handle));
+      }
     }
   }
 }
@@ -426,6 +1338,21 @@ GraphExecutor::CreateTVMOp(const TVMOpParam& param, const std::vector<DLTensor>&
       TVM_CCALL(TVMArrayCopyFromTo(from, to, nullptr));
     };
     return {fexec, arg_ptr};
+  } else if (param.func_name == "__if") {
+    // Copy the outputs of the branch selected by the predicate, the first input.
+    size_t num_outputs = args.size() - num_inputs;
+    ICHECK_EQ(num_inputs, 1 + 2 * num_outputs) << "invalid number of inputs of __if";
+    auto fexec = [arg_ptr, num_outputs]() {
+      const DLTensor* pred = static_cast<DLTensor*>(arg_ptr->arg_values[0].v_handle);
+      size_t branch = ReadPredicate(pred) ? 1 : 1 + num_outputs;
+      for (size_t i = 0; i < num_outputs; ++i) {
+        size_t out = 1 + 2 * num_outputs + i;
+        DLTensor* from = static_cast<DLTensor*>(arg_ptr->arg_values[branch + i].v_handle);
+        DLTensor* to = static_cast<DLTensor*>(arg_ptr->arg_values[out].v_handle);
+        TVM_CCALL(TVMArrayCopyFromTo(from, to, nullptr));
+      }
+    };
+    return {fexec, arg_ptr};
   }
 
   // Get compiled function from the module that contains both host and device
@@ -433,12 +1360,10 @@ GraphExecutor::CreateTVMOp(const TVMOpParam& param, const std::vector<DLTensor>&
   tvm::runtime::PackedFunc pf = module_.GetFunction(param.func_name, true);
   ICHECK(pf != nullptr) << "no such function in module: " << param.func_name;
 
-  auto fexec = [arg_ptr, pf]() {
-    TVMRetValue rv;
-    TVMArgs targs(arg_ptr->arg_values.data(), arg_ptr->arg_tcodes.data(),
-                  static_cast<int>(arg_ptr->arg_values.size()));
-    pf.CallPacked(targs, &rv);
-  };
+  // The arguments are packed once here, the operator calls the compiled function on them.
+  BoundPackedCall call(pf, arg_ptr->arg_values.data(), arg_ptr->arg_tcodes.data(),
+                       static_cast<int>(arg_ptr->arg_values.size()));
+  auto fexec = [arg_ptr, call]() { call(); };
   return {fexec, arg_ptr};
 }
 
@@ -463,6 +1388,90 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
         this->SetInputZeroCopy(args[0], args[1]);
       }
     });
+  } else if (name == "resolve_inputs") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<std::string> names;
+      for (int i = 0; i < args.num_args; ++i) {
+        names.push_back(args[i].operator String());
+      }
+      *rv = ShapeTuple(this->ResolveInputs(names));
+    });
+  } else if (name == "bind_inputs" || name == "bind_inputs_zero_copy") {
+    // The indices, then one tensor per index.
+    bool zero_copy = name == "bind_inputs_zero_copy";
+    return PackedFunc([sptr_to_self, zero_copy, this](TVMArgs args, TVMRetValue* rv) {
+      ShapeTuple indices = args[0];
+      ICHECK_EQ(indices.size() + 1, static_cast<size_t>(args.num_args))
+          << "Expect one tensor per index";
+      std::vector<DLTensor*> data;
+      for (int i = 1; i < args.num_args; ++i) {
+        data.push_back(args[i]);
+      }
+      this->BindInputs(std::vector<int64_t>(indices.begin(), indices.end()), data, zero_copy);
+    });
+  } else if (name == "bind_outputs_zero_copy") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ShapeTuple indices = args[0];
+      ICHECK_EQ(indices.size() + 1, static_cast<size_t>(args.num_args))
+          << "Expect one array per index";
+      std::vector<NDArray> data;
+      for (int i = 1; i < args.num_args; ++i) {
+        data.push_back(args[i]);
+      }
+      this->BindOutputsZeroCopy(std::vector<int64_t>(indices.begin(), indices.end()), data);
+    });
+  } else if (name == "set_output_zero_copy") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetOutputZeroCopy(args[0], args.num_args > 1 ? args[1].operator NDArray() : NDArray());
+    });
+  } else if (name == "set_input_async") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      TVMStreamHandle stream = args.num_args > 2 ? args[2].operator void*() : nullptr;
+      if (String::CanConvertFrom(args[0])) {
+        int in_idx = this->GetInputIndex(args[0].operator String());
+        if (in_idx >= 0) this->SetInputAsync(in_idx, args[1], stream);
+      } else {
+        this->SetInputAsync(args[0], args[1], stream);
+      }
+    });
+  } else if (name == "set_double_buffered_inputs") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetDoubleBufferedInputs(args[0]);
+    });
+  } else if (name == "link_output") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int in_idx = -1;
+      if (String::CanConvertFrom(args[1])) {
+        in_idx = this->GetInputIndex(args[1].operator String());
+        ICHECK_GE(in_idx, 0) << "Cannot find the input " << args[1].operator String();
+      } else {
+        in_idx = args[1];
+      }
+      this->LinkOutputToInput(args[0], in_idx);
+    });
+  } else if (name == "run_request") {
+    // Set the inputs, run and copy the outputs in one call, the request of an
+    // async runner. The outputs are copied since the next run overwrites them.
+    return TypedPackedFunc<Array<NDArray>(Map<String, NDArray>)>(
+        [sptr_to_self, this](Map<String, NDArray> inputs) {
+          for (const auto& it : inputs) {
+            int in_idx = this->GetInputIndex(it.first);
+            ICHECK_GE(in_idx, 0) << "Cannot find the input " << it.first;
+            this->SetInput(in_idx, const_cast<DLTensor*>(it.second.operator->()));
+          }
+          this->Run();
+          Array<NDArray> outputs;
+          for (int i = 0; i < this->NumOutputs(); ++i) {
+            NDArray output = this->GetOutput(i);
+            outputs.push_back(output.CopyTo(output->device));
+          }
+          return outputs;
+        });
+  } else if (name == "get_output_async") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      TVMStreamHandle stream = args.num_args > 2 ? args[2].operator void*() : nullptr;
+      this->CopyOutputToAsync(args[0], args[1], stream);
+    });
   } else if (name == "get_output") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       if (args.num_args == 2) {
@@ -495,6 +1504,66 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       this->LoadParams(args[0].operator std::string());
     });
+  } else if (name == "load_mapped_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      bool share = args.num_args > 1 ? args[1].operator bool() : false;
+      this->LoadMappedParams(args[0].operator std::string(), share);
+    });
+  } else if (name == "load_shared_params") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->LoadSharedParams(args[0].operator std::string());
+    });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->thread_pool_ = args[0].operator std::string();
+    });
+  } else if (name == "set_inter_op_parallelism") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetInterOpParallelism(args[0]);
+    });
+  } else if (name == "set_num_streams") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetNumStreams(args[0]);
+    });
+  } else if (name == "get_stream_assignment") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = ShapeTuple(this->GetStreamAssignment());
+    });
+  } else if (name == "set_sampling_interval") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetSamplingInterval(args[0]);
+    });
+  } else if (name == "set_result_cache") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<std::string> outputs, inputs;
+      for (const String& name : args[1].AsObjectRef<Array<String>>()) outputs.push_back(name);
+      for (const String& name : args[2].AsObjectRef<Array<String>>()) inputs.push_back(name);
+      this->SetResultCache(args[0], outputs, inputs);
+    });
+  } else if (name == "get_result_cache_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetResultCacheStats();
+    });
+  } else if (name == "get_sampling_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->GetSamplingStats();
+    });
+  } else if (name == "set_activation_arena") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetActivationArena(args[0]);
+    });
+  } else if (name == "acquire_activation_arena") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->AcquireActivationArena(); });
+  } else if (name == "owns_activation_arena") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      if (!arena_.defined()) {
+        *rv = false;
+        return;
+      }
+      std::lock_guard<std::mutex> lock(arena_->mutex);
+      *rv = arena_->owner == this;
+    });
   } else if (name == "share_params") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       const auto& module = args[0].operator Module();
@@ -516,6 +1585,16 @@ Module GraphExecutorCreate(const std::string& sym_json, const tvm::runtime::Modu
   return Module(exec);
 }
 
+TVM_REGISTER_GLOBAL("runtime.ActivationArena").set_body_typed([]() {
+  return ActivationArena(make_object<ActivationArenaObj>());
+});
+
+TVM_REGISTER_GLOBAL("runtime.ActivationArenaReservedBytes")
+    .set_body_typed([](ActivationArena arena) {
+      std::lock_guard<std::mutex> lock(arena->mutex);
+      return static_cast<int64_t>(arena->ReservedBytes());
+    });
+
 // Get all devices for the host and other runtime devices.
 std::vector<Device> GetAllDevice(const TVMArgs& args, int dev_start_arg) {
   // Reserve the first item as the fallback device.
@@ -32,11 +32,17 @@
 #include <tvm/runtime/packed_func.h>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "../op_latency_sampler.h"
+#include "../result_cache.h"
+#include "../texture.h"
+
 namespace tvm {
 namespace runtime {
 
@@ -56,6 +62,62 @@ struct TVMOpParam {
   uint32_t flatten_data;
 };
 
+class GraphExecutor;
+
+/*!
+ * \brief The activation storage shared by graph executors run one at a time.
+ *
+ *  The arena holds one buffer per device, sized to the largest activation plan of the executors
+ *  joined to it. The executor running acquires the arena and overwrites the activations of the
+ *  previous owner, so only the inputs, outputs and parameters of an executor, which are never
+ *  placed in the arena, outlive the run of another executor.
+ */
+class ActivationArenaObj : public Object {
+ public:
+  /*!
+   * \brief Grow the reserved size of a device.
+   * \param dev The device.
+   * \param size The number of bytes an executor needs on the device.
+   */
+  void Reserve(Device dev, size_t size);
+  /*!
+   * \brief Get the buffer of a device, reallocated when smaller than the reserved size.
+   * \param dev The device.
+   * \return The buffer.
+   */
+  NDArray GetBuffer(Device dev);
+  /*! \return The total number of bytes reserved over the devices. */
+  size_t ReservedBytes() const;
+
+  /*! \brief The executor whose activations the buffers hold, nullptr if none. */
+  const GraphExecutor* owner{nullptr};
+  /*! \brief Incremented each time a buffer is reallocated. */
+  uint64_t generation{0};
+  /*! \brief Held while a joined executor runs, so that the executors run one at a time. */
+  std::mutex mutex;
+
+  static constexpr const char* _type_key = "runtime.ActivationArena";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ActivationArenaObj, Object);
+
+ private:
+  /*! \brief The buffer of a device. */
+  struct Slot {
+    Device device;
+    size_t reserved;
+    NDArray buffer;
+  };
+  std::vector<Slot> slots_;
+};
+
+/*!
+ * \brief Managed reference to ActivationArenaObj.
+ * \sa ActivationArenaObj
+ */
+class ActivationArena : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(ActivationArena, ObjectRef, ActivationArenaObj);
+};
+
 /*!
  * \brief Tiny graph executor.
  *
@@ -83,8 +145,76 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \return The type key of the executor.
    */
   const char* type_key() const final { return "GraphExecutor"; }
+  ~GraphExecutor();
   void Run();
 
+  /*!
+   * \brief Set the number of operators that may run concurrently.
+   *
+   *  With a level greater than one, Run() dispatches operators in dataflow
+   *  order on the thread pool instead of one by one.
+   * \param level The inter-op parallelism level, 1 keeps sequential execution.
+   */
+  void SetInterOpParallelism(int level);
+
+  /*!
+   * \brief Set the number of device streams the operators are launched on.
+   *
+   *  With more than one stream, independent branches of the graph are mapped
+   *  to different streams of the accelerator, synchronized with events where
+   *  they join. This takes precedence over the inter-op parallelism level.
+   * \param num_streams The number of streams, 1 launches everything on the
+   *  current stream of the thread.
+   */
+  void SetNumStreams(int num_streams);
+
+  /*!
+   * \brief Get the stream each node is launched on in multi-stream mode.
+   * \return The stream index of each node, -1 for the nodes running on the
+   *  default stream: inputs, parameters, cross device copies and the operators
+   *  of other devices.
+   */
+  std::vector<int64_t> GetStreamAssignment();
+
+  /*!
+   * \brief Time the operators of one run out of interval.
+   *
+   *  The operators of a sampled run are launched in order on the current
+   *  stream, each with a device timer which is only synchronized at the end
+   *  of the run. Other runs are not affected. The latencies are accumulated
+   *  in per-operator histograms, see GetSamplingStats.
+   * \param interval The sampling interval, 0 disables sampling. Clears the histograms.
+   */
+  void SetSamplingInterval(int64_t interval);
+
+  /*!
+   * \brief Get the latency statistics of the sampled runs.
+   * \return A JSON object with the p50, p99 and mean latency of the runs and of each operator.
+   */
+  std::string GetSamplingStats() const { return sampler_.StatsJSON(); }
+
+  /*!
+   * \brief Memoize the outputs of subgraphs, keyed by the content of their inputs.
+   *
+   *  The subgraph of an output node is made of the operators it depends on
+   *  which only feed the subgraph. When the key inputs the node depends on
+   *  were seen before, the subgraph is skipped and the outputs of the node
+   *  are copied from the cache. The other inputs it depends on, e.g. the
+   *  parameters, are assumed not to change. Runs with the cache are launched
+   *  in order on the current stream, the sampled runs bypass it.
+   * \param max_bytes The byte budget of the cache, inputs included, 0 disables it.
+   * \param outputs The names of the nodes whose outputs are cached.
+   * \param inputs The names of the key inputs.
+   */
+  void SetResultCache(int64_t max_bytes, const std::vector<std::string>& outputs,
+                      const std::vector<std::string>& inputs);
+
+  /*!
+   * \brief Get the statistics of the result cache.
+   * \return A JSON object with the hits, misses, evictions and size of the cache.
+   */
+  std::string GetResultCacheStats() const { return result_cache_.StatsJSON(); }
+
   /*!
    * \brief Initialize the graph executor with graph and device.
    * \param graph_json The execution graph.
@@ -119,6 +249,72 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param data_ref The input data that is referred.
    */
   void SetInputZeroCopy(int index, DLTensor* data_ref);
+  /*!
+   * \brief Resolve the names of inputs to their indices, the handles of the binding calls.
+   *
+   *  The names are looked up once, so that the inputs of every request are bound by index.
+   * \param names The names of the inputs.
+   * \return The indices of the inputs.
+   */
+  std::vector<int64_t> ResolveInputs(const std::vector<std::string>& names);
+  /*!
+   * \brief Bind a batch of inputs, by the indices given by ResolveInputs.
+   * \param indices The input indices.
+   * \param data The input data, one per index.
+   * \param zero_copy Whether to refer to the data instead of copying it, as SetInputZeroCopy.
+   */
+  void BindInputs(const std::vector<int64_t>& indices, const std::vector<DLTensor*>& data,
+                  bool zero_copy);
+  /*!
+   * \brief Have the graph write the index-th output into the given array instead of its own
+   *  storage, saving the copy of CopyOutputTo.
+   *
+   *  The array is written by every later run and returned by GetOutput. The entries a reshape
+   *  output aliases are redirected too. The outputs that are graph inputs or parameters, or that
+   *  are linked to inputs, cannot be bound.
+   * \param index The output index.
+   * \param data The array, of the shape, device and alignment of the output. An undefined array
+   *  restores the storage of the graph.
+   */
+  void SetOutputZeroCopy(int index, NDArray data);
+  /*!
+   * \brief Bind a batch of outputs with SetOutputZeroCopy.
+   * \param indices The output indices.
+   * \param data The arrays to write the outputs to, one per index.
+   */
+  void BindOutputsZeroCopy(const std::vector<int64_t>& indices, const std::vector<NDArray>& data);
+  /*!
+   * \brief Queue the copy of the index-th input on a stream, without waiting for it.
+   *
+   *  The caller orders the work that reads the input after the copy, e.g. by
+   *  running the graph on the same stream.
+   * \param index The input index.
+   * \param data_in The input data.
+   * \param stream The stream to copy on, nullptr for the default stream. Must be
+   *  nullptr with double-buffered inputs, which use the upload stream.
+   */
+  void SetInputAsync(int index, DLTensor* data_in, TVMStreamHandle stream);
+  /*!
+   * \brief Upload the inputs into a second set of buffers while the graph runs.
+   *
+   *  Once enabled, SetInput and SetInputAsync copy to spare input buffers on a
+   *  dedicated upload stream without waiting, and Run swaps the buffers in after
+   *  ordering the run after the uploads. The upload for the next run thus
+   *  overlaps the current one. GetInput returns the inputs of the last run until
+   *  the next Run.
+   * \param enable Whether to double-buffer the inputs.
+   */
+  void SetDoubleBufferedInputs(bool enable);
+  /*!
+   * \brief Copy an output into an input at the end of each run.
+   *
+   *  This carries the state of a stateful model, e.g. a model rewritten by
+   *  relay.transform.ToStreaming, from one run to the next. The input must be
+   *  set with SetInput, not SetInputZeroCopy.
+   * \param output_index The output index.
+   * \param input_index The input index, -1 to remove the link of the output.
+   */
+  void LinkOutputToInput(int output_index, int input_index);
   /*!
    * \brief Get the number of outputs
    *
@@ -151,6 +347,15 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param data_out the output data.
    */
   void CopyOutputTo(int index, DLTensor* data_out);
+  /*!
+   * \brief Queue the copy of the index-th output on a stream, without waiting for it.
+   *
+   *  The copy only overlaps other work when data_out is page-locked host memory.
+   * \param index The output index.
+   * \param data_out the output data.
+   * \param stream The stream to copy on, nullptr for the default stream.
+   */
+  void CopyOutputToAsync(int index, DLTensor* data_out, TVMStreamHandle stream);
   /*!
    * \brief Load parameters from binary stream
    * \param strm The input stream.
@@ -161,6 +366,24 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param param_blob A binary blob of parameter.
    */
   void LoadParams(const std::string& param_blob);
+  /*!
+   * \brief Load parameters from a file written by SaveMappedParams.
+   *
+   *  The parameters which live on the CPU point into the mapped file instead of
+   *  being copied, the others are copied to their device.
+   * \param file_name The name of the file.
+   * \param share Whether to intern the parameters in the process-wide ConstantStore, see
+   *  LoadSharedParams.
+   */
+  void LoadMappedParams(const std::string& file_name, bool share = false);
+  /*!
+   * \brief Load parameters from parameter blob, interned in the process-wide ConstantStore.
+   *
+   *  The parameters identical to the ones already loaded by another executor of the process,
+   *  on the same device, share their memory instead of being copied.
+   * \param param_blob A binary blob of parameter.
+   */
+  void LoadSharedParams(const std::string& param_blob);
 
   /*!
    * \brief Share parameters from pre-existing GraphExecutor instance.
@@ -170,6 +393,33 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   void ShareParams(const GraphExecutor& other, dmlc::Stream* strm);
 
+  /*!
+   * \brief Let the next Init reuse the parameter storage of another executor instead of
+   *  allocating its own, so that only the activations are owned by this instance.
+   * \param other An initialized executor of the same graph.
+   * \param param_names The names of the parameters to share, usually the loaded params of other.
+   * \note Must be called before Init.
+   */
+  void SetSharedParamsSource(const GraphExecutor* other,
+                             const std::unordered_set<std::string>& param_names);
+  /*!
+   * \brief Draw the activations from an arena shared with other executors instead of the
+   *  storage planned for this instance.
+   *
+   *  The storage holding neither an input, an output nor a parameter is placed in the arena, and
+   *  released after the first run. The intermediate results of a run, e.g. the node outputs of
+   *  the debug executor, are only valid until another executor of the arena runs.
+   * \param arena The arena.
+   * \note Must be called after Init, at most once. Join all the executors before running any
+   *  of them, so that the arena is allocated once at its largest size.
+   */
+  void SetActivationArena(ActivationArena arena);
+  /*!
+   * \brief Become the owner of the activation arena, pointing the activations into its buffers.
+   *  Run does it implicitly.
+   */
+  void AcquireActivationArena();
+
   /*!
    * \brief Get total number of nodes.
    * \return Total number of nodes.
@@ -185,6 +435,12 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     int device_type;
     int param_data_entry;
     NDArray linked_param;
+    /*! \brief The storage scope of the entry, empty for flat memory. */
+    std::string scope;
+    /*! \brief The 2D image of a texture scope, the largest of its tensors. */
+    Texture2DShape<int64_t> texture_shape{0, 0, 0};
+    /*! \brief The data type of the image of a texture scope. */
+    DLDataType dtype{kDLFloat, 32, 1};
     //    PoolEntry(int s, int dev_type, void* pre_linked_param) :
     //        size(s), device_type(dev_type), pre_linked_param(std::move(pre_linked_param)) {}
   };
@@ -277,6 +533,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     std::vector<int> storage_id;
     std::vector<int> device_index;
     std::vector<std::string> dltype;
+    std::vector<std::string> storage_scope;
+    std::vector<int64_t> storage_offset;
     std::vector<std::vector<int64_t>> shape;
     // The graph attribute fields.
     void Load(dmlc::JSONReader* reader) {
@@ -319,6 +577,22 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           ICHECK(reader->NextArrayItem());
           reader->Read(&device_index);
           ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_scope") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_str");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_scope);
+          ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
         } else {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -375,8 +649,56 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   static void LinkedNDArrayDeleter(Object* container);
   /*! \brief Setup the temporal storage */
   void SetupStorage();
+  /*!
+   * \brief Make the input entries of the parameters refer to the given arrays where they can.
+   * \param params The parameters.
+   * \param share Whether to use the arrays of the ConstantStore equal to the parameters.
+   *  Otherwise only the CPU parameters are referred to, the others are copied.
+   */
+  void BindParams(const Map<String, NDArray>& params, bool share);
   /*! \brief Setup the executors. */
   void SetupOpExecs();
+  /*!
+   * \brief Build the operator dependency DAG used by the dataflow mode.
+   *
+   *  Besides the data edges, a writer of a storage id waits for the earlier
+   *  readers and writers of that storage id, so that the buffer reuse decided
+   *  by the memory planner stays safe when operators run out of order.
+   */
+  void BuildOpDependencies();
+  /*! \brief Run all the operations in dataflow order on the thread pool. */
+  void RunDataflow();
+  /*!
+   * \brief Map the operators to streams and record the events they wait for.
+   *
+   *  Operators are visited in topological order. An operator continues the
+   *  stream of a producer it alone follows up, otherwise it starts on the least
+   *  loaded stream. It waits for the streams of its dependencies, except those
+   *  an earlier operator of its stream already waited for past that point.
+   */
+  void PlanStreams();
+  /*! \brief Run all the operations on the planned streams. */
+  void RunMultiStream();
+  /*! \brief Run all the operations in order, timing each of them. */
+  void RunSampled();
+  /*! \brief Run all the operations in order, skipping the subgraphs of the cache hits. */
+  void RunCached();
+  /*! \brief Run all the operations in order, skipping the branches not taken. */
+  void RunBranches();
+  /*! \brief Parse the "branch_guard" attributes of the nodes. */
+  void SetupBranchGuards();
+  /*!
+   * \brief Check whether a node is in the branches taken by the current run.
+   * \param nid The node.
+   * \param predicates The predicates read in the current run, by entry.
+   */
+  bool InTakenBranches(uint32_t nid, std::unordered_map<uint32_t, bool>* predicates) const;
+  /*! \brief The array the outputs of an entry are written to, bound outputs included. */
+  NDArray EntryArray(uint32_t eid) const;
+  /*! \brief Release the streams created for multi-stream mode. */
+  void FreeStreams();
+  /*! \brief Order the run after the pending uploads and swap their buffers in. */
+  void SwapInputBuffers();
   /*!
    * \brief Create an execution function given input.
    * \param attrs The node attributes.
@@ -390,6 +712,19 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   uint32_t entry_id(uint32_t nid, uint32_t index) const { return node_row_ptr_[nid] + index; }
   // Get node entry index.
   uint32_t entry_id(const NodeEntry& e) const { return entry_id(e.node_id, e.index); }
+  /*!
+   * \brief Get the entries an output is written to, the output entry first, followed by the
+   *  entries the reshapes run as "__nop" alias.
+   * \param e The output entry.
+   */
+  std::vector<uint32_t> OutputAliasEntries(const NodeEntry& e) const;
+  /*!
+   * \brief Lock the activation arena and acquire it, for the operators run outside of Run.
+   * \return The lock, not owning a mutex without arena.
+   */
+  std::unique_lock<std::mutex> LockActivationArena();
+  /*! \brief Point the activations into the arena, assuming its mutex is held. */
+  void BindActivationArena();
   // Number of node entries.
   uint32_t num_node_entries() const { return node_row_ptr_.back(); }
   /*! \brief The graph nodes. */
@@ -400,6 +735,15 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::unordered_map<std::string, uint32_t> input_map_;
   /*! \brief Used for quick node input DLTensor* lookup given an input eid. */
   std::vector<std::vector<DLTensor*>> input_dltensors_;
+  /*!
+   * \brief The node arguments DLTensor* of the entries the outputs are written to, given an eid,
+   *  i.e. of the output entries and of the entries their reshapes alias.
+   */
+  std::vector<std::vector<DLTensor*>> output_dltensors_;
+  /*! \brief The array each output is bound to by SetOutputZeroCopy, undefined when unbound. */
+  std::vector<NDArray> bound_outputs_;
+  /*! \brief The output each entry redirected by SetOutputZeroCopy is bound for. */
+  std::unordered_map<uint32_t, int> bound_output_entries_;
   /*! \brief Used for quick entry indexing. */
   std::vector<uint32_t> node_row_ptr_;
   /*! \brief Output entries. */
@@ -427,6 +771,83 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * When the module does not include linked parmeters, module_lookup_linked_param_ will be nullptr.
    */
   bool module_lookup_linked_param_valid_;
+  /*! \brief Maximum number of operators running concurrently, 1 for sequential execution. */
+  int inter_op_parallelism_{1};
+  /*! \brief Operators that depend on each node, built on the first dataflow run. */
+  std::vector<std::vector<uint32_t>> op_successors_;
+  /*! \brief Number of operators each node waits for. */
+  std::vector<int> op_num_deps_;
+  /*! \brief Number of streams the operators are launched on, 1 for the current stream. */
+  int num_streams_{1};
+  /*! \brief The stream of each node, -1 for the default stream, built on the first run. */
+  std::vector<int> op_streams_;
+  /*! \brief The streams each node waits for before launching, -1 for the default stream. */
+  std::vector<std::vector<int>> op_stream_waits_;
+  /*! \brief The device the streams are created on. */
+  Device stream_device_{kDLCPU, 0};
+  /*! \brief The streams of multi-stream mode. */
+  std::vector<TVMStreamHandle> streams_;
+  /*! \brief The (output entry, input entry) pairs copied at the end of each run. */
+  std::vector<std::pair<uint32_t, uint32_t>> output_links_;
+  /*! \brief Whether SetInput writes to spare buffers swapped in by Run. */
+  bool double_buffered_inputs_{false};
+  /*! \brief The spare buffer of each input in double-buffered mode. */
+  std::vector<NDArray> back_inputs_;
+  /*! \brief Whether the spare buffer of each input holds data for the next run. */
+  std::vector<bool> back_input_pending_;
+  /*! \brief The device of the upload stream. */
+  Device upload_device_{kDLCPU, 0};
+  /*! \brief The stream uploading the inputs in double-buffered mode. */
+  TVMStreamHandle upload_stream_{nullptr};
+  /*! \brief Whether upload_stream_ has been created, it is nullptr on some devices. */
+  bool has_upload_stream_{false};
+  /*! \brief The named thread pool the operators run on, empty for the default pool. */
+  std::string thread_pool_;
+  /*! \brief Latency histograms of the sampled runs. */
+  OpLatencySampler sampler_;
+  /*! \brief A subgraph whose outputs are memoized. */
+  struct CachedSubgraph {
+    /*! \brief The node computing the outputs. */
+    uint32_t nid;
+    /*! \brief The entries of the key inputs the node depends on. */
+    std::vector<uint32_t> key_eids;
+    /*! \brief The operators skipped on a hit, the node included. */
+    std::vector<uint32_t> skipped;
+  };
+  /*! \brief The memoized subgraphs, by their slot in result_cache_. */
+  std::vector<CachedSubgraph> cached_subgraphs_;
+  /*! \brief The memoized outputs of the subgraphs. */
+  ResultCache result_cache_;
+  /*!
+   * \brief The branches each node is in, outermost first, as the entry of the predicate and
+   *  the value selecting the branch. Empty for the unconditional nodes.
+   */
+  std::vector<std::vector<std::pair<uint32_t, bool>>> branch_guards_;
+  /*! \brief Whether some nodes are in conditional branches. */
+  bool has_branches_{false};
+  /*! \brief The executor whose parameter storage is reused by SetupStorage, if any. */
+  const GraphExecutor* shared_params_source_{nullptr};
+  /*! \brief The names of the parameters taken from shared_params_source_. */
+  std::unordered_set<std::string> shared_param_names_;
+  /*! \brief The arguments of the operator of each node, nullptr for the null nodes. */
+  std::vector<std::shared_ptr<OpArgs>> op_args_;
+  /*! \brief An entry placed in the activation arena. */
+  struct ArenaEntry {
+    uint32_t eid;
+    Device device;
+    /*! \brief The offset of the entry in the buffer of its device. */
+    size_t offset;
+    /*! \brief The operator arguments reading or writing the entry. */
+    std::vector<DLTensor*> args;
+  };
+  /*! \brief The activation arena, undefined when the planned storage is used. */
+  ActivationArena arena_;
+  /*! \brief The entries placed in arena_. */
+  std::vector<ArenaEntry> arena_entries_;
+  /*! \brief The storage entries placed in arena_, released on the first bind. */
+  std::vector<uint32_t> arena_sids_;
+  /*! \brief The arena generation the entries point into, 0 before the first bind. */
+  uint64_t arena_generation_{0};
 };
 
 std::vector<Device> GetAllDevice(const TVMArgs& args, int dev_start_arg);
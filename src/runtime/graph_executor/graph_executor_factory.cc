@@ -24,6 +24,7 @@
 
 #include "./graph_executor_factory.h"
 
+#include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
@@ -53,6 +54,16 @@ PackedFunc GraphExecutorFactory::GetFunction(
       }
       *rv = this->ExecutorCreate(devices);
     });
+  } else if (name == "create_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_GE(args.size(), 2);
+      int num_executors = args[0];
+      std::vector<Device> devices;
+      for (int i = 1; i < args.num_args; ++i) {
+        devices.emplace_back(args[i].operator Device());
+      }
+      *rv = this->ExecutorPoolCreate(num_executors, devices);
+    });
   } else if (name == "debug_create") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       ICHECK_GE(args.size(), 2);
@@ -111,6 +122,26 @@ Module GraphExecutorFactory::ExecutorCreate(const std::vector<Device>& devs) {
   return Module(exec);
 }
 
+Array<Module> GraphExecutorFactory::ExecutorPoolCreate(int num_executors,
+                                                      const std::vector<Device>& devs) {
+  ICHECK_GT(num_executors, 0) << "An executor pool needs at least one executor";
+  Array<Module> executors;
+  Module first = ExecutorCreate(devs);
+  const GraphExecutor* source = first.as<GraphExecutor>();
+  executors.push_back(first);
+  std::unordered_set<std::string> param_names;
+  for (const auto& p : this->params_) {
+    param_names.insert(p.first);
+  }
+  for (int i = 1; i < num_executors; ++i) {
+    auto exec = make_object<GraphExecutor>();
+    exec->SetSharedParamsSource(source, param_names);
+    exec->Init(this->graph_json_, this->imports_[0], devs, PackedFunc());
+    executors.push_back(Module(exec));
+  }
+  return executors;
+}
+
 Module GraphExecutorFactory::DebugExecutorCreate(const std::vector<Device>& devs) {
   const PackedFunc* pf = tvm::runtime::Registry::Get("tvm.graph_executor_debug.create");
   ICHECK(pf != nullptr) << "Cannot find function tvm.graph_executor_debug.create in registry. "
@@ -81,6 +81,16 @@ class TVM_DLL GraphExecutorFactory : public runtime::ModuleNode {
    */
   Module ExecutorCreate(const std::vector<Device>& devs);
 
+  /*!
+   * \brief Create executors that can run concurrently from different threads.
+   *  The executors share the params and the code, only their activations are separate.
+   * \param num_executors The number of executors.
+   * \param devs The device of the host and devices where graph nodes will be
+   *  executed on.
+   * \return The created executor modules.
+   */
+  Array<Module> ExecutorPoolCreate(int num_executors, const std::vector<Device>& devs);
+
   /*!
    * \brief Create a specific debug executor module
    * \param devs The device of the host and devices where graph nodes will be
@@ -19,21 +19,131 @@
 
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "hexagon_module.h"
 
 namespace tvm {
 namespace runtime {
+namespace hexagon {
+
+/*!
+ * \brief A pool of VTCM, planned in a block reserved once.
+ *
+ *  Each VTCM allocation of the device is a remote call, made at every invocation of a kernel
+ *  with a VTCM buffer. The pool reserves a block of VTCM at the first allocation, of
+ *  TVM_HEXAGON_VTCM_POOL_BYTES bytes (256KB by default), and places the later allocations in it
+ *  at the first free range that fits, coalescing the ranges when they are freed. The allocations
+ *  that do not fit in the block are passed to the device.
+ */
+class VtcmPool {
+ public:
+  static VtcmPool* Global() {
+    static VtcmPool* inst = new VtcmPool();
+    return inst;
+  }
+
+  void* Alloc(size_t nbytes, size_t align) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!reserved_) Reserve();
+    nbytes = std::max<size_t>(nbytes, 1);
+    uintptr_t base = reinterpret_cast<uintptr_t>(base_);
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      size_t begin = it->first;
+      size_t end = begin + it->second;
+      size_t offset = (base + begin + align - 1) / align * align - base;
+      if (offset + nbytes > end) continue;
+      free_.erase(it);
+      if (offset > begin) free_[begin] = offset - begin;
+      if (offset + nbytes < end) free_[offset + nbytes] = end - offset - nbytes;
+      used_[base_ + offset] = nbytes;
+      return base_ + offset;
+    }
+    void* ptr = Device::Global()->AllocVtcm(nbytes, align);
+    if (ptr != nullptr) direct_.insert(ptr);
+    return ptr;
+  }
+
+  /*! \return Whether the pointer was allocated in VTCM, and is freed. */
+  bool Free(void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = used_.find(static_cast<char*>(ptr));
+    if (it != used_.end()) {
+      size_t begin = it->first - base_;
+      size_t size = it->second;
+      used_.erase(it);
+      auto next = free_.lower_bound(begin);
+      if (next != free_.end() && begin + size == next->first) {
+        size += next->second;
+        next = free_.erase(next);
+      }
+      if (next != free_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == begin) {
+          prev->second += size;
+          return true;
+        }
+      }
+      free_[begin] = size;
+      return true;
+    }
+    if (direct_.erase(ptr)) {
+      Device::Global()->FreeVtcm(ptr);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  void Reserve() {
+    reserved_ = true;
+    size_t size = kDefaultPoolBytes;
+    if (const char* val = getenv("TVM_HEXAGON_VTCM_POOL_BYTES")) {
+      size = strtoull(val, nullptr, 10);
+    }
+    if (size == 0) return;
+    base_ = static_cast<char*>(Device::Global()->AllocVtcm(size, kPoolAlignment));
+    if (base_ == nullptr) {
+      LOG(WARNING) << "Cannot reserve " << size << " bytes of VTCM, allocating it on demand";
+      return;
+    }
+    free_[0] = size;
+  }
+
+  static constexpr size_t kDefaultPoolBytes = 256 * 1024;
+  static constexpr size_t kPoolAlignment = 2048;
+  std::mutex mutex_;
+  // Whether the block was reserved, or failed to be
+  bool reserved_{false};
+  // The reserved block
+  char* base_{nullptr};
+  // The free ranges of the block, offset to size
+  std::map<size_t, size_t> free_;
+  // The allocations in the block, pointer to size
+  std::unordered_map<char*, size_t> used_;
+  // The allocations passed to the device
+  std::unordered_set<void*> direct_;
+};
+
+}  // namespace hexagon
 
 class HexagonDeviceAPI : public DeviceAPI {
  public:
   void SetDevice(Device dev) final;
   void GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) final;
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final;
+  void* AllocDataSpace(Device dev, int ndim, const int64_t* shape, DLDataType dtype,
+                       Optional<String> mem_scope) final;
   void FreeDataSpace(Device dev, void* ptr) final;
   void StreamSync(Device dev, TVMStreamHandle stream) final;
   void* AllocWorkspace(Device dev, size_t nbytes, DLDataType type_hint = {}) final;
@@ -66,9 +176,28 @@ inline void* HexagonDeviceAPI::AllocDataSpace(Device dev, size_t nbytes, size_t
   return hexagon::Device::Global()->Alloc(nbytes, alignment);
 }
 
+inline void* HexagonDeviceAPI::AllocDataSpace(Device dev, int ndim, const int64_t* shape,
+                                              DLDataType dtype, Optional<String> mem_scope) {
+  if (mem_scope.defined() &&
+      (mem_scope.value() == "local.vtcm" || mem_scope.value() == "global.vtcm")) {
+    ICHECK(hexagon::Device::ValidateDeviceId(dev.device_id));
+    DLTensor temp;
+    temp.ndim = ndim;
+    temp.dtype = dtype;
+    temp.shape = const_cast<int64_t*>(shape);
+    size_t nbytes = GetDataSize(temp);
+    void* ptr = hexagon::VtcmPool::Global()->Alloc(nbytes, 2048);
+    ICHECK(ptr != nullptr) << "Cannot allocate " << nbytes << " bytes of VTCM";
+    return ptr;
+  }
+  return DeviceAPI::AllocDataSpace(dev, ndim, shape, dtype, mem_scope);
+}
+
 inline void HexagonDeviceAPI::FreeDataSpace(Device dev, void* ptr) {
   ICHECK(hexagon::Device::ValidateDeviceId(dev.device_id));
-  hexagon::Device::Global()->Free(ptr);
+  if (!hexagon::VtcmPool::Global()->Free(ptr)) {
+    hexagon::Device::Global()->Free(ptr);
+  }
 }
 
 inline void HexagonDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to,
@@ -114,14 +243,17 @@ inline void* HexagonDeviceAPI::AllocWorkspace(Device dev, size_t nbytes, DLDataT
   ICHECK(hexagon::Device::ValidateDeviceId(dev.device_id));
   if (type_hint.code == 100) {
     size_t align = std::min(nbytes, 2048lu);
-    return hexagon::Device::Global()->AllocVtcm(nbytes, align);
+    return hexagon::VtcmPool::Global()->Alloc(nbytes, align);
   }
   return DeviceAPI::AllocWorkspace(dev, nbytes, type_hint);
 }
 
 inline void HexagonDeviceAPI::FreeWorkspace(Device dev, void* ptr) {
   ICHECK(hexagon::Device::ValidateDeviceId(dev.device_id));
-  DeviceAPI::FreeWorkspace(dev, ptr);
+  // The VTCM workspaces are freed back to the pool.
+  if (!hexagon::VtcmPool::Global()->Free(ptr)) {
+    DeviceAPI::FreeWorkspace(dev, ptr);
+  }
 }
 
 TVM_REGISTER_GLOBAL("device_api.hexagon").set_body([](TVMArgs args, TVMRetValue* rv) {
@@ -136,9 +268,10 @@ TVM_REGISTER_GLOBAL("device_api.hexagon").set_body([](TVMArgs args, TVMRetValue*
 extern "C" {
 void* HexagonBackendAllocateVTCM(uint32_t nbytes, uint32_t align) {
   align = std::max(align, 2048u);
-  return tvm::runtime::hexagon::Device::Global()->AllocVtcm(nbytes, align);
+  return tvm::runtime::hexagon::VtcmPool::Global()->Alloc(nbytes, align);
 }
 void HexagonBackendFreeVTCM(void* ptr) {
-  return tvm::runtime::hexagon::Device::Global()->FreeVtcm(ptr);
+  bool freed = tvm::runtime::hexagon::VtcmPool::Global()->Free(ptr);
+  ICHECK(freed) << "Free a buffer not allocated in VTCM";
 }
 }
@@ -27,10 +27,19 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#if TVM_USE_ZSTD
+#include <zstd.h>
+#endif
+
 namespace tvm {
 namespace runtime {
 
@@ -69,8 +78,12 @@ class ModuleInternal {
   static std::vector<Module>* GetImportsAddr(ModuleNode* node) { return &(node->imports_); }
 };
 
-PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
-  return PackedFunc([faddr, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+/*! \brief The body of a packed function wrapping a backend function */
+struct PackedCFuncWrapper {
+  TVMBackendPackedCFunc faddr;
+  ObjectPtr<Object> sptr_to_self;
+
+  void operator()(TVMArgs args, TVMRetValue* rv) const {
     TVMValue ret_value;
     int ret_type_code = kTVMNullptr;
     int ret = (*faddr)(const_cast<TVMValue*>(args.values), const_cast<int*>(args.type_codes),
@@ -79,7 +92,17 @@ PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>&
     if (ret_type_code != kTVMNullptr) {
       *rv = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
     }
-  });
+  }
+};
+
+PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
+  return PackedFunc(PackedCFuncWrapper{faddr, sptr_to_self});
+}
+
+TVMBackendPackedCFunc GetWrappedPackedCFunc(const PackedFunc& pf) {
+  PackedFunc::FType body = pf.body();
+  const PackedCFuncWrapper* wrapper = body.target<PackedCFuncWrapper>();
+  return wrapper == nullptr ? nullptr : wrapper->faddr;
 }
 
 void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
@@ -121,6 +144,194 @@ Module LoadModuleFromBinary(const std::string& type_key, dmlc::Stream* stream) {
   return (*f)(static_cast<void*>(stream));
 }
 
+#if TVM_USE_ZSTD
+/*!
+ * \brief A stream decompressing a zstd frame held in memory, as the frame is read. The binary
+ *  of a compressed module is never decompressed as a whole.
+ */
+class ZstdReadStream : public dmlc::Stream {
+ public:
+  ZstdReadStream(const char* data, size_t size) : dstream_(ZSTD_createDStream()) {
+    ICHECK(dstream_ != nullptr);
+    ZSTD_initDStream(dstream_);
+    input_.src = data;
+    input_.size = size;
+    input_.pos = 0;
+  }
+
+  ~ZstdReadStream() { ZSTD_freeDStream(dstream_); }
+
+  using dmlc::Stream::Read;
+  using dmlc::Stream::Write;
+
+  size_t Read(void* ptr, size_t size) final {
+    ZSTD_outBuffer output = {ptr, size, 0};
+    while (output.pos < output.size && !finished_) {
+      size_t in_pos = input_.pos, out_pos = output.pos;
+      size_t ret = ZSTD_decompressStream(dstream_, &output, &input_);
+      ICHECK(!ZSTD_isError(ret)) << "Failed to decompress the module binary: "
+                                 << ZSTD_getErrorName(ret);
+      // The frame is decoded and flushed, or the frame is truncated.
+      finished_ = ret == 0 || (input_.pos == in_pos && output.pos == out_pos);
+    }
+    return output.pos;
+  }
+
+  void Write(const void* ptr, size_t size) final {
+    LOG(FATAL) << "ZstdReadStream is read only";
+  }
+
+ private:
+  ZSTD_DStream* dstream_;
+  ZSTD_inBuffer input_;
+  bool finished_{false};
+};
+#endif
+
+std::string CompressModuleBinary(const std::string& data, int level) {
+#if TVM_USE_ZSTD
+  ICHECK(level >= 1 && level <= ZSTD_maxCLevel())
+      << "The zstd compression level must be between 1 and " << ZSTD_maxCLevel();
+  std::string compressed(ZSTD_compressBound(data.size()), '\0');
+  size_t size = ZSTD_compress(&compressed[0], compressed.size(), data.data(), data.size(), level);
+  ICHECK(!ZSTD_isError(size)) << "Failed to compress the module binary: "
+                              << ZSTD_getErrorName(size);
+  compressed.resize(size);
+  return compressed;
+#else
+  LOG(FATAL) << "Compressing the module binaries requires zstd, please build with USE_ZSTD=ON";
+  return std::string();
+#endif
+}
+
+/*!
+ * \brief Load the module of an entry of a module blob.
+ * \param tkey The key of the entry, already read from the stream.
+ * \param data The data the stream reads from.
+ * \param stream The stream, after the key.
+ * \return The module.
+ */
+Module LoadModuleEntry(const std::string& tkey, const char* data,
+                       dmlc::MemoryFixedSizeStream* stream) {
+  if (tkey != kZstdModuleKey) {
+    return LoadModuleFromBinary(tkey, stream);
+  }
+  dmlc::Stream* strm = stream;
+  std::string type_key;
+  uint64_t size = 0;
+  ICHECK(strm->Read(&type_key));
+  ICHECK(strm->Read(&size));
+#if TVM_USE_ZSTD
+  size_t offset = stream->Tell();
+  ZstdReadStream zstd_stream(data + offset, static_cast<size_t>(size));
+  Module module = LoadModuleFromBinary(type_key, &zstd_stream);
+  stream->Seek(offset + size);
+  return module;
+#else
+  LOG(FATAL) << "The binary of the " << type_key << " module is compressed with zstd, "
+             << "please rebuild the runtime with USE_ZSTD=ON";
+  return Module();
+#endif
+}
+
+/*!
+ * \brief Read the offsets of the entries of a module blob, when the blob carries them.
+ * \param data The data of the blob, after its size.
+ * \param nbytes The size of the data.
+ * \param num_entries The number of entries of the blob.
+ * \return The offset of each entry from the start of the data, empty for an older blob.
+ */
+std::vector<uint64_t> ReadModuleBlobIndex(const char* data, uint64_t nbytes,
+                                          uint64_t num_entries) {
+  std::vector<uint64_t> entry_offsets;
+  // The trailer is the offset of the index and the magic number.
+  const uint64_t trailer_size = 2 * sizeof(uint64_t);
+  if (nbytes < trailer_size) {
+    return entry_offsets;
+  }
+  dmlc::MemoryFixedSizeStream trailer_fs(const_cast<char*>(data + nbytes - trailer_size),
+                                         static_cast<size_t>(trailer_size));
+  dmlc::Stream* trailer = &trailer_fs;
+  uint64_t index_offset = 0, magic = 0;
+  ICHECK(trailer->Read(&index_offset) && trailer->Read(&magic));
+  if (magic != kModuleBlobIndexMagic || index_offset > nbytes - trailer_size) {
+    return entry_offsets;
+  }
+  dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data + index_offset),
+                                 static_cast<size_t>(nbytes - trailer_size - index_offset));
+  dmlc::Stream* stream = &fs;
+  if (!stream->Read(&entry_offsets) || entry_offsets.size() != num_entries) {
+    return std::vector<uint64_t>();
+  }
+  for (uint64_t offset : entry_offsets) {
+    if (offset >= index_offset) {
+      return std::vector<uint64_t>();
+    }
+  }
+  return entry_offsets;
+}
+
+/*!
+ * \brief Load the modules of the entries of a module blob with several threads.
+ * \param data The data of the blob, after its size.
+ * \param nbytes The size of the data.
+ * \param entry_offsets The offsets of the entries.
+ * \param tkeys The type key of each entry.
+ * \param modules The loaded modules, set for the entries of the modules.
+ */
+void LoadModulesInParallel(const char* data, uint64_t nbytes,
+                           const std::vector<uint64_t>& entry_offsets,
+                           const std::vector<std::string>& tkeys, std::vector<Module>* modules) {
+  std::vector<size_t> module_entries;
+  for (size_t i = 0; i < tkeys.size(); ++i) {
+    if (tkeys[i] != "_lib" && tkeys[i] != "_import_tree") {
+      module_entries.push_back(i);
+    }
+  }
+  auto load = [&](size_t i) {
+    dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data + entry_offsets[i]),
+                                   static_cast<size_t>(nbytes - entry_offsets[i]));
+    dmlc::Stream* stream = &fs;
+    std::string tkey;
+    ICHECK(stream->Read(&tkey));
+    (*modules)[i] = LoadModuleEntry(tkey, data + entry_offsets[i], &fs);
+  };
+  // TVM_NUM_MODULE_LOAD_THREADS=1 loads the modules one after another.
+  size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+  if (const char* env = std::getenv("TVM_NUM_MODULE_LOAD_THREADS")) {
+    num_threads = std::max(1, atoi(env));
+  }
+  num_threads = std::min(num_threads, module_entries.size());
+  if (num_threads <= 1) {
+    for (size_t i : module_entries) {
+      load(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next{0};
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      try {
+        for (size_t k = next++; k < module_entries.size(); k = next++) {
+          load(module_entries[k]);
+        }
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 /*!
  * \brief Load and append module blob to module list
  * \param mblob The module blob.
@@ -136,8 +347,8 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib, runtime::Modul
     uint64_t c = mblob[i];
     nbytes |= (c & 0xffUL) << (i * 8);
   }
-  dmlc::MemoryFixedSizeStream fs(const_cast<char*>(mblob + sizeof(nbytes)),
-                                 static_cast<size_t>(nbytes));
+  const char* data = mblob + sizeof(nbytes);
+  dmlc::MemoryFixedSizeStream fs(const_cast<char*>(data), static_cast<size_t>(nbytes));
   dmlc::Stream* stream = &fs;
   uint64_t size;
   ICHECK(stream->Read(&size));
@@ -146,24 +357,52 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib, runtime::Modul
   std::vector<uint64_t> import_tree_child_indices;
   int num_dso_module = 0;
 
-  for (uint64_t i = 0; i < size; ++i) {
-    std::string tkey;
-    ICHECK(stream->Read(&tkey));
-    // "_lib" serves as a placeholder in the module import tree to indicate where
-    // to place the DSOModule
-    if (tkey == "_lib") {
-      auto dso_module = Module(make_object<LibraryModuleNode>(lib));
-      *dso_ctx_addr = dso_module.operator->();
-      ++num_dso_module;
-      modules.emplace_back(dso_module);
-      ICHECK_EQ(num_dso_module, 1U) << "Multiple dso module detected, please upgrade tvm "
-                                    << " to the latest before exporting the module";
-    } else if (tkey == "_import_tree") {
-      ICHECK(stream->Read(&import_tree_row_ptr));
-      ICHECK(stream->Read(&import_tree_child_indices));
-    } else {
-      auto m = LoadModuleFromBinary(tkey, stream);
-      modules.emplace_back(m);
+  auto load_lib = [&]() {
+    auto dso_module = Module(make_object<LibraryModuleNode>(lib));
+    *dso_ctx_addr = dso_module.operator->();
+    ++num_dso_module;
+    ICHECK_EQ(num_dso_module, 1U) << "Multiple dso module detected, please upgrade tvm "
+                                  << " to the latest before exporting the module";
+    return dso_module;
+  };
+
+  std::vector<uint64_t> entry_offsets = ReadModuleBlobIndex(data, nbytes, size);
+  if (!entry_offsets.empty()) {
+    // The modules of the entries are independent: deserialize them in parallel.
+    std::vector<std::string> tkeys(size);
+    modules.resize(size);
+    for (uint64_t i = 0; i < size; ++i) {
+      dmlc::MemoryFixedSizeStream entry_fs(const_cast<char*>(data + entry_offsets[i]),
+                                           static_cast<size_t>(nbytes - entry_offsets[i]));
+      dmlc::Stream* entry = &entry_fs;
+      ICHECK(entry->Read(&tkeys[i]));
+      if (tkeys[i] == "_lib") {
+        modules[i] = load_lib();
+      } else if (tkeys[i] == "_import_tree") {
+        ICHECK_EQ(i + 1, size) << "The import tree must be the last entry";
+        ICHECK(entry->Read(&import_tree_row_ptr));
+        ICHECK(entry->Read(&import_tree_child_indices));
+      }
+    }
+    ICHECK_EQ(tkeys.back(), "_import_tree") << "The import tree must be the last entry";
+    LoadModulesInParallel(data, nbytes, entry_offsets, tkeys, &modules);
+    // The import tree is not a module.
+    modules.pop_back();
+  } else {
+    for (uint64_t i = 0; i < size; ++i) {
+      std::string tkey;
+      ICHECK(stream->Read(&tkey));
+      // "_lib" serves as a placeholder in the module import tree to indicate where
+      // to place the DSOModule
+      if (tkey == "_lib") {
+        modules.emplace_back(load_lib());
+      } else if (tkey == "_import_tree") {
+        ICHECK(stream->Read(&import_tree_row_ptr));
+        ICHECK(stream->Read(&import_tree_child_indices));
+      } else {
+        auto m = LoadModuleEntry(tkey, data, &fs);
+        modules.emplace_back(m);
+      }
     }
   }
 
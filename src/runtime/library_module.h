@@ -26,14 +26,38 @@
 
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/logging.h>
 #include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
 
 #include <functional>
 #include <string>
+#include <utility>
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The magic number ending a device module blob that carries the offset of each of its
+ *  entries, followed in the blob by the offsets and the offset of the offsets.
+ */
+constexpr uint64_t kModuleBlobIndexMagic = 0x54564d424c4f4249;
+
+/*!
+ * \brief The key of a compressed entry of a device module blob. The key is followed by the type
+ *  key of the module, the size of the compressed binary and the zstd frame of the binary.
+ */
+constexpr const char* kZstdModuleKey = "_zstd";
+
+/*!
+ * \brief Compress the binary of a module into a zstd frame.
+ * \param data The binary of the module.
+ * \param level The zstd compression level, between 1 and the maximum level of zstd.
+ * \return The compressed binary.
+ * \note Aborts when the runtime is built without USE_ZSTD.
+ */
+std::string CompressModuleBinary(const std::string& data, int level);
+
 /*! \brief Load a module with the given type key directly from the stream.
  *  This function wraps the registry mechanism used to store type based deserializers
  *  for each runtime::Module sub-class.
@@ -72,6 +96,67 @@ class Library : public Object {
  */
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& mptr);
 
+/*!
+ * \brief Get the backend function wrapped by a packed function.
+ * \param pf The packed function.
+ * \return The function address if pf is created by WrapPackedFunc, otherwise nullptr.
+ */
+TVMBackendPackedCFunc GetWrappedPackedCFunc(const PackedFunc& pf);
+
+/*!
+ * \brief A call of a packed function with arguments packed ahead of time and the return
+ *  value discarded, e.g. an operator of an executor invoked on the same tensors on each run.
+ *
+ *  When the function wraps a backend function, the call invokes the function address directly
+ *  on the packed arguments, skipping the TVMArgs and TVMRetValue marshaling and the indirection
+ *  of the PackedFunc body.
+ */
+class BoundPackedCall {
+ public:
+  /*!
+   * \brief Constructor
+   * \param pf The packed function, kept alive by the call.
+   * \param values The packed argument values, which must outlive the call.
+   * \param type_codes The type codes of the arguments, which must outlive the call.
+   * \param num_args The number of arguments.
+   */
+  BoundPackedCall(PackedFunc pf, TVMValue* values, int* type_codes, int num_args)
+      : pf_(std::move(pf)),
+        faddr_(GetWrappedPackedCFunc(pf_)),
+        values_(values),
+        type_codes_(type_codes),
+        num_args_(num_args) {}
+
+  /*! \brief Invoke the function on the packed arguments. */
+  void operator()() const {
+    if (faddr_ != nullptr) {
+      TVMValue ret_value;
+      int ret_type_code = kTVMNullptr;
+      int ret = (*faddr_)(values_, type_codes_, num_args_, &ret_value, &ret_type_code, nullptr);
+      ICHECK_EQ(ret, 0) << TVMGetLastError();
+      if (ret_type_code != kTVMNullptr) {
+        // Release the returned object, if any.
+        TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
+      }
+    } else {
+      TVMRetValue rv;
+      pf_.CallPacked(TVMArgs(values_, type_codes_, num_args_), &rv);
+    }
+  }
+
+ private:
+  /*! \brief The packed function */
+  PackedFunc pf_;
+  /*! \brief The backend function wrapped by pf_, or nullptr */
+  TVMBackendPackedCFunc faddr_;
+  /*! \brief The packed argument values */
+  TVMValue* values_;
+  /*! \brief The type codes of the arguments */
+  int* type_codes_;
+  /*! \brief The number of arguments */
+  int num_args_;
+};
+
 /*!
  * \brief Utility to initialize conext function symbols during startup
  * \param fgetsymbol A symbol lookup function.
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_accounting.cc
+ * \brief Accounting of the device memory allocated by the runtime, by category and executor.
+ */
+#include "memory_accounting.h"
+
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+thread_local MemoryCategory current_category = MemoryCategory::kNDArray;
+thread_local const char* current_executor = nullptr;
+
+const char* kCategoryNames[] = {"ndarray",   "params",  "activations",
+                                "workspace", "vm_pool", "texture"};
+
+struct Counter {
+  size_t live_bytes{0};
+  size_t peak_bytes{0};
+  size_t num_allocs{0};
+
+  void Add(size_t nbytes) {
+    live_bytes += nbytes;
+    peak_bytes = std::max(peak_bytes, live_bytes);
+    ++num_allocs;
+  }
+  void Sub(size_t nbytes) { live_bytes -= std::min(live_bytes, nbytes); }
+  void ResetPeak() { peak_bytes = live_bytes; }
+};
+
+struct DeviceAccount {
+  Counter total;
+  Counter categories[static_cast<int>(MemoryCategory::kNumCategories)];
+  std::map<std::string, Counter> executors;
+};
+
+/*! \brief A live allocation, to be subtracted from its counters when freed. */
+struct Record {
+  std::pair<int, int> device;
+  MemoryCategory category;
+  std::string executor;
+  size_t nbytes;
+};
+
+class MemoryAccounting {
+ public:
+  static MemoryAccounting* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction, pools may outlive statics.
+    static auto* inst = new MemoryAccounting();
+    return inst;
+  }
+
+  void Alloc(Device dev, const void* ptr, size_t nbytes, MemoryCategory category) {
+    Record record{{static_cast<int>(dev.device_type), dev.device_id},
+                  category,
+                  current_executor == nullptr ? "none" : current_executor,
+                  nbytes};
+    std::lock_guard<std::mutex> lock(mutex_);
+    DeviceAccount& account = devices_[record.device];
+    account.total.Add(nbytes);
+    account.categories[static_cast<int>(category)].Add(nbytes);
+    account.executors[record.executor].Add(nbytes);
+    records_[ptr] = std::move(record);
+  }
+
+  void Free(const void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = records_.find(ptr);
+    if (it == records_.end()) return;
+    const Record& record = it->second;
+    DeviceAccount& account = devices_[record.device];
+    account.total.Sub(record.nbytes);
+    account.categories[static_cast<int>(record.category)].Sub(record.nbytes);
+    account.executors[record.executor].Sub(record.nbytes);
+    records_.erase(it);
+  }
+
+  MemoryUsage Usage(Device dev) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryUsage usage;
+    auto it = devices_.find({static_cast<int>(dev.device_type), dev.device_id});
+    if (it != devices_.end()) usage = ToUsage(it->second.total);
+    return usage;
+  }
+
+  std::string JSON() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream os;
+    os << "{";
+    bool first_device = true;
+    for (const auto& kv : devices_) {
+      Device dev{static_cast<DLDeviceType>(kv.first.first), kv.first.second};
+      const DeviceAccount& account = kv.second;
+      os << (first_device ? "" : ", ") << "\"" << dev << "\": {\"total\": ";
+      first_device = false;
+      WriteCounter(account.total, os);
+      os << ", \"by_category\": {";
+      bool first = true;
+      for (int i = 0; i < static_cast<int>(MemoryCategory::kNumCategories); ++i) {
+        if (account.categories[i].num_allocs == 0) continue;
+        os << (first ? "" : ", ") << "\"" << kCategoryNames[i] << "\": ";
+        WriteCounter(account.categories[i], os);
+        first = false;
+      }
+      os << "}, \"by_executor\": {";
+      first = true;
+      for (const auto& executor : account.executors) {
+        os << (first ? "" : ", ") << "\"" << executor.first << "\": ";
+        WriteCounter(executor.second, os);
+        first = false;
+      }
+      os << "}}";
+    }
+    os << "}";
+    return os.str();
+  }
+
+  void ResetPeak() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& kv : devices_) {
+      kv.second.total.ResetPeak();
+      for (Counter& counter : kv.second.categories) counter.ResetPeak();
+      for (auto& executor : kv.second.executors) executor.second.ResetPeak();
+    }
+  }
+
+ private:
+  static MemoryUsage ToUsage(const Counter& counter) {
+    MemoryUsage usage;
+    usage.live_bytes = counter.live_bytes;
+    usage.peak_bytes = counter.peak_bytes;
+    usage.num_allocs = counter.num_allocs;
+    return usage;
+  }
+
+  static void WriteCounter(const Counter& counter, std::ostream& os) {
+    os << "{\"live_bytes\": " << counter.live_bytes << ", \"peak_bytes\": " << counter.peak_bytes
+       << ", \"num_allocs\": " << counter.num_allocs << "}";
+  }
+
+  std::mutex mutex_;
+  std::map<std::pair<int, int>, DeviceAccount> devices_;
+  std::unordered_map<const void*, Record> records_;
+};
+}  // namespace
+
+MemoryAccountingScope::MemoryAccountingScope(MemoryCategory category, const char* executor)
+    : prev_category_(current_category), prev_executor_(current_executor) {
+  current_category = category;
+  if (executor != nullptr) current_executor = executor;
+}
+
+MemoryAccountingScope::~MemoryAccountingScope() {
+  current_category = prev_category_;
+  current_executor = prev_executor_;
+}
+
+MemoryCategory MemoryAccountingScope::CurrentCategory() { return current_category; }
+
+void RecordDeviceAlloc(Device dev, const void* ptr, size_t nbytes, MemoryCategory category) {
+  if (ptr == nullptr || nbytes == 0) return;
+  MemoryAccounting::Global()->Alloc(dev, ptr, nbytes, category);
+}
+
+void RecordDeviceFree(const void* ptr) {
+  if (ptr == nullptr) return;
+  MemoryAccounting::Global()->Free(ptr);
+}
+
+MemoryUsage GetDeviceMemoryUsage(Device dev) { return MemoryAccounting::Global()->Usage(dev); }
+
+std::string DeviceMemoryUsageJSON() { return MemoryAccounting::Global()->JSON(); }
+
+void ResetMemoryPeak() { MemoryAccounting::Global()->ResetPeak(); }
+
+TVM_REGISTER_GLOBAL("runtime.profiling.DeviceMemoryUsage").set_body_typed(DeviceMemoryUsageJSON);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.ResetDeviceMemoryPeak").set_body_typed(ResetMemoryPeak);
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file memory_accounting.h
+ * \brief Accounting of the device memory allocated by the runtime, by category and executor.
+ */
+#ifndef TVM_RUNTIME_MEMORY_ACCOUNTING_H_
+#define TVM_RUNTIME_MEMORY_ACCOUNTING_H_
+
+#include <tvm/runtime/device_api.h>
+
+#include <cstddef>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief What a device allocation holds. */
+enum class MemoryCategory : int {
+  /*! \brief The tensors allocated outside of the scopes below. */
+  kNDArray = 0,
+  /*! \brief The parameters and constants of the executors, and the graph executor inputs. */
+  kParams = 1,
+  /*! \brief The intermediate tensors of the executors. */
+  kActivations = 2,
+  /*! \brief The blocks of the workspace pools, handed out or cached. */
+  kWorkspace = 3,
+  /*! \brief The buffers of the VM allocators, handed out or cached. */
+  kVMPool = 4,
+  /*! \brief The images of the texture pools. */
+  kTexture = 5,
+  kNumCategories = 6,
+};
+
+/*! \brief The live and peak bytes of a device, a category or an executor. */
+struct MemoryUsage {
+  size_t live_bytes{0};
+  /*! \brief Peak of live_bytes since the last ResetMemoryPeak. */
+  size_t peak_bytes{0};
+  /*! \brief Number of allocations recorded. */
+  size_t num_allocs{0};
+};
+
+/*!
+ * \brief Attribute the device allocations of the current thread to a category and an executor.
+ *
+ *  The scopes nest, the innermost one applies. An allocation recorded with an explicit category,
+ *  e.g. by a pool, keeps it and is only attributed to the executor of the scope.
+ */
+class MemoryAccountingScope {
+ public:
+  /*!
+   * \param category The category of the allocations of NDArray::Empty.
+   * \param executor The executor, e.g. "vm", nullptr to keep the one of the enclosing scope.
+   */
+  explicit MemoryAccountingScope(MemoryCategory category, const char* executor = nullptr);
+  ~MemoryAccountingScope();
+
+  /*! \brief The category of the current scope, kNDArray outside of any. */
+  static MemoryCategory CurrentCategory();
+
+ private:
+  MemoryCategory prev_category_;
+  const char* prev_executor_;
+};
+
+/*!
+ * \brief Record a device allocation.
+ * \param dev The device.
+ * \param ptr The allocated pointer, the key of RecordDeviceFree.
+ * \param nbytes The size of the allocation.
+ * \param category The category, attributed to the executor of the current scope.
+ */
+TVM_DLL void RecordDeviceAlloc(Device dev, const void* ptr, size_t nbytes,
+                               MemoryCategory category);
+
+/*!
+ * \brief Record the release of a device allocation. Pointers not recorded are ignored.
+ * \param ptr The pointer given to RecordDeviceAlloc.
+ */
+TVM_DLL void RecordDeviceFree(const void* ptr);
+
+/*! \brief Get the usage of a device, summed over the categories. */
+TVM_DLL MemoryUsage GetDeviceMemoryUsage(Device dev);
+
+/*!
+ * \brief Get the usage of every device as a JSON object, keyed by the device, with the
+ *  "total" usage of the device, its usage "by_category" and "by_executor".
+ */
+TVM_DLL std::string DeviceMemoryUsageJSON();
+
+/*! \brief Restart tracking the peaks from the current live bytes. */
+TVM_DLL void ResetMemoryPeak();
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_MEMORY_ACCOUNTING_H_
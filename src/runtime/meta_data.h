@@ -62,6 +62,8 @@ class MetadataNode : public Object {
   String executor = kTvmExecutorGraph;
 
   String mod_name = "";
+  /*! \brief number of workspace pools given to the main function after the outputs */
+  int num_workspace_pools = 0;
 
   static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
   static constexpr const char* _type_key = "MetadataObj";
@@ -73,12 +75,14 @@ class MetadataNode : public Object {
  */
 class Metadata : public ObjectRef {
  public:
-  TVM_DLL Metadata(int num_inputs, int num_outputs, String executor, String mod_name) {
+  TVM_DLL Metadata(int num_inputs, int num_outputs, String executor, String mod_name,
+                   int num_workspace_pools = 0) {
     auto n = make_object<MetadataNode>();
     n->num_inputs = num_inputs;
     n->num_outputs = num_outputs;
     n->executor = executor;
     n->mod_name = mod_name;
+    n->num_workspace_pools = num_workspace_pools;
     data_ = std::move(n);
   }
 
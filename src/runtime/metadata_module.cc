@@ -33,14 +33,99 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <tuple>
 
 #include "meta_data.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The constants of a metadata module, shared by all of its submodules.
+ *
+ * The constants with the same dtype, shape and content, e.g. the weights duplicated in several
+ * partitions of a model, are stored once. The copies on the devices are made on the first
+ * request of a submodule and shared with the later requests.
+ */
+class ConstantPool {
+ public:
+  /*!
+   * \brief Get the pooled array with the content of an array.
+   * \param arr The array, on the CPU.
+   * \return The array itself the first time its content is interned, the first array with the
+   * same content after.
+   */
+  NDArray Intern(const NDArray& arr) {
+    if (arr->device.device_type != kDLCPU || !arr.IsContiguous()) return arr;
+    std::vector<NDArray>& bucket = arrays_[Hash(arr)];
+    for (const NDArray& pooled : bucket) {
+      if (Equal(pooled, arr)) return pooled;
+    }
+    bucket.push_back(arr);
+    return arr;
+  }
+
+  /*!
+   * \brief Get the copy of a pooled array on a device, copied on the first request.
+   * \param arr The pooled array.
+   * \param dev The device.
+   * \return The copy on the device.
+   */
+  NDArray OnDevice(const NDArray& arr, Device dev) {
+    if (arr->device.device_type == dev.device_type && arr->device.device_id == dev.device_id) {
+      return arr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto key = std::make_tuple(arr.get(), static_cast<int>(dev.device_type), dev.device_id);
+    auto it = device_arrays_.find(key);
+    if (it != device_arrays_.end()) return it->second.second;
+    NDArray copy = arr.CopyTo(dev);
+    device_arrays_[key] = {arr, copy};
+    return copy;
+  }
+
+ private:
+  static size_t Hash(const NDArray& arr) {
+    // FNV-1a over the dtype, the shape and the content.
+    size_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+      }
+    };
+    mix(&arr->dtype, sizeof(arr->dtype));
+    mix(arr->shape, arr->ndim * sizeof(int64_t));
+    mix(static_cast<const char*>(arr->data) + arr->byte_offset, GetDataSize(*arr.operator->()));
+    return hash;
+  }
+
+  static bool Equal(const NDArray& a, const NDArray& b) {
+    if (a->ndim != b->ndim || a->dtype.code != b->dtype.code || a->dtype.bits != b->dtype.bits ||
+        a->dtype.lanes != b->dtype.lanes) {
+      return false;
+    }
+    if (!std::equal(a->shape, a->shape + a->ndim, b->shape)) return false;
+    return std::memcmp(static_cast<const char*>(a->data) + a->byte_offset,
+                       static_cast<const char*>(b->data) + b->byte_offset,
+                       GetDataSize(*a.operator->())) == 0;
+  }
+
+  /*! \brief The pooled arrays, by the hash of their content. */
+  std::unordered_map<size_t, std::vector<NDArray>> arrays_;
+  /*! \brief The array and its copy, by array and device. */
+  std::map<std::tuple<const Object*, int, int>, std::pair<NDArray, NDArray>> device_arrays_;
+  /*! \brief Guard the copies, requested from the threads running the submodules. */
+  std::mutex mutex_;
+};
+
 /*!
  * \brief The metadata module is designed to manage initialization of the
  * imported submodules.
@@ -50,6 +135,10 @@ class MetadataModuleNode : public ModuleNode {
   MetadataModuleNode(const std::unordered_map<std::string, NDArray>& metadata,
                      const std::unordered_map<std::string, std::vector<std::string>>& sym_vars)
       : metadata_(metadata), sym_vars_(sym_vars) {
+    // The submodules are given the same array for the constants with the same content.
+    for (auto& it : metadata_) {
+      it.second = pool_->Intern(it.second);
+    }
     // Only the related submodules are cached to reduce the number of runtime
     // symbol lookup for initialization. Otherwise, symbols/primitives in the
     // DSO module will also be cached but they never need to be initialized.
@@ -101,6 +190,9 @@ class MetadataModuleNode : public ModuleNode {
    * \param symobl The symbol used for initializing a module. It is also used
    * for runtime lookup.
    *
+   * A module also providing __const_loader_<symbol> is first given a function
+   * copying its constants to a device, shared by all the submodules.
+   *
    * \note  A module could be like the following:
    *  MetadataModuleNode (contains all the metadata)
    *    - CSourceModule
@@ -116,6 +208,12 @@ class MetadataModuleNode : public ModuleNode {
       std::string init_name = "__init_" + symbol;
       init = it.GetFunction(init_name, false);
       if (init != nullptr) {
+        PackedFunc set_loader = it.GetFunction("__const_loader_" + symbol, false);
+        if (set_loader != nullptr) {
+          std::shared_ptr<ConstantPool> pool = pool_;
+          set_loader(TypedPackedFunc<NDArray(NDArray, Device)>(
+              [pool](NDArray arr, Device dev) { return pool->OnDevice(arr, dev); }));
+        }
         auto md = GetRequiredMetadata(symbol);
         // Initialize the module with metadata.
         int ret = init(md);
@@ -215,6 +313,8 @@ class MetadataModuleNode : public ModuleNode {
   std::unordered_map<std::string, NDArray> metadata_;
   /*! \brief Symbol name to required constant variables mapping. */
   std::unordered_map<std::string, std::vector<std::string>> sym_vars_;
+  /*! \brief The pool of the constants, kept alive by the loaders given to the submodules. */
+  std::shared_ptr<ConstantPool> pool_ = std::make_shared<ConstantPool>();
 };
 
 Module MetadataModuleCreate(
@@ -28,6 +28,7 @@
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLCommandBuffer.h>
 #import <Metal/MTLCommandQueue.h>
+#import <Metal/MTLComputeCommandEncoder.h>
 #import <Metal/MTLDevice.h>
 #import <Metal/MTLLibrary.h>
 #include <tvm/runtime/c_runtime_api.h>
@@ -35,6 +36,8 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -103,13 +106,25 @@ class AutoReleasePoolWrapper {
 
 /*!
  * \brief Structure for error handling in queues
+ *
+ * The kernel launches are encoded in one pending compute encoder of one pending command
+ * buffer, which are committed once they hold max_dispatches_ launches, or when a copy or a
+ * synchronization needs the results. The encoder dispatches serially, a launch sees the writes
+ * of the previous ones. TVM_METAL_MAX_BATCHED_DISPATCHES sets the number of launches of a
+ * command buffer, 1 committing each launch on its own.
  */
 class Stream {
  public:
   explicit Stream(id<MTLDevice> device) : error_happened_(false) {
     queue_ = [device newCommandQueue];
+    if (const char* val = getenv("TVM_METAL_MAX_BATCHED_DISPATCHES")) {
+      max_dispatches_ = std::max(atoi(val), 1);
+    }
+  }
+  ~Stream() {
+    Flush();
+    [queue_ release];
   }
-  ~Stream() { [queue_ release]; }
   id<MTLCommandBuffer> GetCommandBuffer() {
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
@@ -117,12 +132,56 @@ class Stream {
     }];
     return cb;
   }
+  /*!
+   * \brief Get the pending compute encoder, creating it with its command buffer when there is
+   *  none. Call EndDispatch after the dispatch.
+   */
+  id<MTLComputeCommandEncoder> GetComputeEncoder() {
+    if (pending_encoder_ == nil) {
+      pending_cb_ = [GetCommandBuffer() retain];
+      pending_encoder_ = [[pending_cb_ computeCommandEncoder] retain];
+      pending_state_ = nil;
+    }
+    return pending_encoder_;
+  }
+  /*!
+   * \brief Set the pipeline state of the pending encoder, unless it is already set.
+   */
+  void SetPipelineState(id<MTLComputePipelineState> state) {
+    if (state == pending_state_) return;
+    [pending_encoder_ setComputePipelineState:state];
+    pending_state_ = state;
+  }
+  /*! \brief Count a dispatch of the pending encoder, committing it when it is full. */
+  void EndDispatch() {
+    if (++num_dispatches_ >= max_dispatches_) Flush();
+  }
+  /*! \brief Commit the pending command buffer, if any. */
+  void Flush() {
+    if (pending_encoder_ == nil) return;
+    [pending_encoder_ endEncoding];
+    [pending_cb_ commit];
+    [pending_encoder_ release];
+    [pending_cb_ release];
+    pending_encoder_ = nil;
+    pending_cb_ = nil;
+    pending_state_ = nil;
+    num_dispatches_ = 0;
+  }
   bool HasErrorHappened() { return error_happened_; }
 
  private:
   void SetErrorStatus() { error_happened_ = true; }
   // Queue
   id<MTLCommandQueue> queue_;
+  // The command buffer and the encoder of the pending launches.
+  id<MTLCommandBuffer> pending_cb_{nil};
+  id<MTLComputeCommandEncoder> pending_encoder_{nil};
+  // The pipeline state last set on the pending encoder.
+  id<MTLComputePipelineState> pending_state_{nil};
+  // The number of launches in the pending encoder, and the most it takes.
+  int num_dispatches_{0};
+  int max_dispatches_{64};
   // Check if error happened in one previous run
   bool error_happened_;
 };
@@ -27,6 +27,7 @@
 #include <array>
 #include <mutex>
 #include <string>
+#include <vector>
 #include "../file_utils.h"
 #include "../meta_data.h"
 #include "../pack_args.h"
@@ -205,12 +206,19 @@ class MetalWrappedFunc {
       int blockSize = wl.block_dim(0) * wl.block_dim(1) * wl.block_dim(2);
       auto maxTotalThreadsPerThreadgroup = scache_[device_id].maxTotalThreadsPerThreadgroup;
       CHECK_LE(blockSize, maxTotalThreadsPerThreadgroup);
-      id<MTLCommandBuffer> cb = stream->GetCommandBuffer();
-      id<MTLComputeCommandEncoder> encoder = [cb computeCommandEncoder];
-      [encoder setComputePipelineState:scache_[device_id]];
-      for (size_t i = 0; i < num_buffer_args_; ++i) {
-        void* buf = args[static_cast<int>(i)];
-        [encoder setBuffer:(id<MTLBuffer>)(buf) offset:0 atIndex:i];
+      // the launch goes in the pending encoder of the stream, see metal::Stream.
+      id<MTLComputeCommandEncoder> encoder = stream->GetComputeEncoder();
+      stream->SetPipelineState(scache_[device_id]);
+      if (num_buffer_args_ != 0) {
+        std::vector<id<MTLBuffer>> buffers(num_buffer_args_);
+        std::vector<NSUInteger> offsets(num_buffer_args_, 0);
+        for (size_t i = 0; i < num_buffer_args_; ++i) {
+          void* buf = args[static_cast<int>(i)];
+          buffers[i] = (id<MTLBuffer>)(buf);
+        }
+        [encoder setBuffers:buffers.data()
+                    offsets:offsets.data()
+                  withRange:NSMakeRange(0, num_buffer_args_)];
       }
       if (num_pack_args_ != 0) {
         [encoder setBytes:pack_args
@@ -221,8 +229,7 @@ class MetalWrappedFunc {
       MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
       MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
       [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
-      [encoder endEncoding];
-      [cb commit];
+      stream->EndDispatch();
     };
   }
 
@@ -26,11 +26,13 @@
 #include <tvm/runtime/crt/rpc_common/framing.h>
 #include <tvm/runtime/crt/rpc_common/session.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
 #include <chrono>
 #include <cstdarg>
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -93,11 +95,16 @@ class MicroTransportChannel : public RPCChannel {
    *  times out.
    * \param session_established_timeout Timeout used for the Recv() function. This is used for
    *  messages sent after a session is already established. If 0, Recv() never times out.
+   * \param max_batch_size_bytes When not 0, the RPC packets sent before a Recv() are batched in
+   *  messages of at most this many bytes, so that the device processes them without waiting for
+   *  the host in between. A single larger packet is sent in its own message. When 0, every Send()
+   *  is a message.
    */
   MicroTransportChannel(PackedFunc fsend, PackedFunc frecv,
                         ::std::chrono::microseconds session_start_retry_timeout,
                         ::std::chrono::microseconds session_start_timeout,
-                        ::std::chrono::microseconds session_established_timeout)
+                        ::std::chrono::microseconds session_established_timeout,
+                        size_t max_batch_size_bytes = 0)
       : state_{State::kReset},
         session_start_retry_timeout_{session_start_retry_timeout},
         session_start_timeout_{session_start_timeout},
@@ -109,7 +116,18 @@ class MicroTransportChannel : public RPCChannel {
         unframer_{session_.Receiver()},
         did_receive_message_{false},
         frecv_{frecv},
-        message_buffer_{nullptr} {}
+        message_buffer_{nullptr},
+        max_batch_size_bytes_{max_batch_size_bytes} {}
+
+  ~MicroTransportChannel() {
+    if (state_ == State::kSessionEstablished && !pending_send_.empty()) {
+      // e.g. the shutdown packet, sent right before the channel is closed.
+      tvm_crt_error_t err = FlushBatch(pending_send_.size());
+      if (err != kTvmErrorNoError) {
+        LOG(WARNING) << "SendMessage returned " << err << " when closing the channel";
+      }
+    }
+  }
 
  private:
   static constexpr const size_t kReceiveBufferSizeBytes = 128;
@@ -242,13 +260,39 @@ class MicroTransportChannel : public RPCChannel {
 
   size_t Send(const void* data, size_t size) override {
     const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
-    tvm_crt_error_t err = session_.SendMessage(MessageType::kNormal, data_bytes, size);
-    ICHECK(err == kTvmErrorNoError) << "SendMessage returned " << err;
+    if (max_batch_size_bytes_ == 0) {
+      tvm_crt_error_t err = session_.SendMessage(MessageType::kNormal, data_bytes, size);
+      ICHECK(err == kTvmErrorNoError) << "SendMessage returned " << err;
+      return size;
+    }
 
+    pending_send_.append(reinterpret_cast<const char*>(data_bytes), size);
+    // Find the ends of the packets, each its uint64 length followed by its body.
+    while (pending_send_.size() >= batch_end_ + sizeof(uint64_t)) {
+      uint64_t packet_nbytes;
+      memcpy(&packet_nbytes, &pending_send_[batch_end_], sizeof(packet_nbytes));
+      size_t packet_end = batch_end_ + sizeof(packet_nbytes) + packet_nbytes;
+      if (packet_end > pending_send_.size()) {
+        break;
+      }
+      if (batch_end_ > 0 && packet_end > max_batch_size_bytes_) {
+        // The batch is full, send it ahead of this packet.
+        packet_end -= batch_end_;
+        tvm_crt_error_t err = FlushBatch(batch_end_);
+        ICHECK(err == kTvmErrorNoError) << "SendMessage returned " << err;
+      }
+      batch_end_ = packet_end;
+    }
     return size;
   }
 
   size_t Recv(void* data, size_t size) override {
+    if (!pending_send_.empty()) {
+      // The reply waits for the batched requests, send them along with any partial packet.
+      tvm_crt_error_t err = FlushBatch(pending_send_.size());
+      ICHECK(err == kTvmErrorNoError) << "SendMessage returned " << err;
+    }
+
     size_t num_bytes_recv = 0;
     while (num_bytes_recv < size) {
       if (message_buffer_ != nullptr) {
@@ -323,6 +367,19 @@ class MicroTransportChannel : public RPCChannel {
     return false;
   }
 
+  /*!
+   * \brief Send the first bytes of the batched packets as one message.
+   * \param num_bytes The number of bytes to send, from the start of the batch.
+   * \return kTvmErrorNoError on success, or an error code otherwise.
+   */
+  tvm_crt_error_t FlushBatch(size_t num_bytes) {
+    tvm_crt_error_t err = session_.SendMessage(
+        MessageType::kNormal, reinterpret_cast<const uint8_t*>(pending_send_.data()), num_bytes);
+    pending_send_.erase(0, num_bytes);
+    batch_end_ = batch_end_ > num_bytes ? batch_end_ - num_bytes : 0;
+    return err;
+  }
+
   static void HandleMessageReceivedCb(void* context, MessageType message_type, FrameBuffer* buf) {
     static_cast<MicroTransportChannel*>(context)->HandleMessageReceived(message_type, buf);
   }
@@ -385,6 +442,11 @@ class MicroTransportChannel : public RPCChannel {
   PackedFunc frecv_;
   FrameBuffer* message_buffer_;
   std::string pending_chunk_;
+  size_t max_batch_size_bytes_;
+  /*! \brief The bytes sent but not yet framed, when batching. */
+  std::string pending_send_;
+  /*! \brief The end of the last complete packet in pending_send_. */
+  size_t batch_end_{0};
 };
 
 std::atomic<unsigned int> MicroTransportChannel::random_seed{0};
@@ -393,7 +455,8 @@ TVM_REGISTER_GLOBAL("micro._rpc_connect").set_body([](TVMArgs args, TVMRetValue*
   MicroTransportChannel* micro_channel =
       new MicroTransportChannel(args[1], args[2], ::std::chrono::microseconds(uint64_t(args[3])),
                                 ::std::chrono::microseconds(uint64_t(args[4])),
-                                ::std::chrono::microseconds(uint64_t(args[5])));
+                                ::std::chrono::microseconds(uint64_t(args[5])),
+                                args.size() > 6 ? size_t(uint64_t(args[6])) : 0);
   if (!micro_channel->StartSession()) {
     std::stringstream ss;
     ss << "MicroSessionTimeoutError: session start handshake failed after " << double(args[4]) / 1e6
@@ -406,6 +469,55 @@ TVM_REGISTER_GLOBAL("micro._rpc_connect").set_body([](TVMArgs args, TVMRetValue*
   *rv = CreateRPCSessionModule(sess);
 });
 
+/*!
+ * \brief Read the cycle counts of the operator calls of the last AOT run on the device.
+ * \param session The RPC session with the device.
+ * \param cycles_per_second The frequency of the cycle counter of the device.
+ * \return The report of the operator calls.
+ */
+profiling::Report GetAotProfile(Module session, double cycles_per_second) {
+  ICHECK_GT(cycles_per_second, 0) << "ValueError: cycles_per_second must be positive";
+  PackedFunc num_calls = session->GetFunction("tvm.aot_profiler.num_calls", false);
+  ICHECK(num_calls != nullptr) << "The AOT profiler is not registered on the device";
+  PackedFunc call_name = session->GetFunction("tvm.aot_profiler.call_name", false);
+  PackedFunc call_cycles = session->GetFunction("tvm.aot_profiler.call_cycles", false);
+
+  int64_t count = num_calls();
+  std::vector<std::string> names;
+  std::vector<int64_t> cycles;
+  int64_t total_cycles = 0;
+  for (int64_t i = 0; i < count; ++i) {
+    names.push_back(call_name(i));
+    cycles.push_back(call_cycles(i));
+    total_cycles += cycles.back();
+  }
+
+  const String device("micro");
+  Array<Map<String, ObjectRef>> calls;
+  for (size_t i = 0; i < names.size(); ++i) {
+    Map<String, ObjectRef> row;
+    row.Set("Name", String(names[i]));
+    row.Set("Duration (us)", ObjectRef(make_object<profiling::DurationNode>(
+                                 cycles[i] / cycles_per_second * 1e6)));
+    row.Set("Percent", ObjectRef(make_object<profiling::PercentNode>(
+                           total_cycles == 0 ? 0.0 : cycles[i] * 100.0 / total_cycles)));
+    row.Set("Cycles", ObjectRef(make_object<profiling::CountNode>(cycles[i])));
+    row.Set("Count", ObjectRef(make_object<profiling::CountNode>(1)));
+    row.Set("Device", device);
+    calls.push_back(row);
+  }
+  Map<String, ObjectRef> total;
+  total.Set("Name", String("Total"));
+  total.Set("Duration (us)", ObjectRef(make_object<profiling::DurationNode>(
+                                 total_cycles / cycles_per_second * 1e6)));
+  total.Set("Percent", ObjectRef(make_object<profiling::PercentNode>(100.0)));
+  total.Set("Cycles", ObjectRef(make_object<profiling::CountNode>(total_cycles)));
+  total.Set("Device", device);
+  return profiling::Report(calls, {{device, total}});
+}
+
+TVM_REGISTER_GLOBAL("micro.GetAotProfile").set_body_typed(GetAotProfile);
+
 }  // namespace micro_rpc
 }  // namespace runtime
 }  // namespace tvm
@@ -57,6 +57,10 @@ namespace runtime {
  *
  *  All the dependencies are provided by the io arguments.
  *
+ *  The requests are processed one at a time, in the order they are read.
+ *  Clients can send several requests without waiting, the returns are written
+ *  in the order of the requests.
+ *
  * \tparam TIOHandler IO provider to provide io handling.
  *         An IOHandler needs to provide the following functions:
  *         - PosixWrite, PosixRead, Close: posix style, read, write, close API.
@@ -27,6 +27,7 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include "memory_accounting.h"
 #include "runtime_base.h"
 
 extern "C" {
@@ -103,6 +104,7 @@ struct NDArray::Internal {
     if (ptr->manager_ctx != nullptr) {
       static_cast<NDArray::Container*>(ptr->manager_ctx)->DecRef();
     } else if (ptr->dl_tensor.data != nullptr) {
+      RecordDeviceFree(ptr->dl_tensor.data);
       tvm::runtime::DeviceAPI::Get(ptr->dl_tensor.device)
           ->FreeDataSpace(ptr->dl_tensor.device, ptr->dl_tensor.data);
     }
@@ -195,6 +197,8 @@ NDArray NDArray::Empty(ShapeTuple shape, DLDataType dtype, Device dev, Optional<
   ret.get_mutable()->dl_tensor.data =
       DeviceAPI::Get(ret->device)
           ->AllocDataSpace(ret->device, shape.size(), shape.data(), ret->dtype, mem_scope);
+  RecordDeviceAlloc(ret->device, ret->data, GetDataSize(*ret.operator->()),
+                    MemoryAccountingScope::CurrentCategory());
   return ret;
 }
 
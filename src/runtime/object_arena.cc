@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/object_arena.cc
+ * \brief The thread-local arenas make_object allocates from in an ObjectArenaScope.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#if defined(__ANDROID__) && __ANDROID_API__ < 17
+#include <malloc.h>
+#endif
+
+#include "object_internal.h"
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+
+/*! \brief The size and alignment of a chunk, so that the chunk of an object is found from it. */
+constexpr size_t kChunkSize = 64 << 10;
+/*! \brief The size of the largest object allocated from the arena. */
+constexpr size_t kMaxObjectSize = 1 << 10;
+
+/*! \brief The header of a chunk, followed by the objects. */
+struct alignas(64) ArenaChunk {
+  /*! \brief One reference for each live object, and one while the arena allocates from it. */
+  std::atomic<int64_t> ref_count{1};
+};
+
+/*! \brief The arena of a thread. */
+struct ObjectArena {
+  /*! \brief The number of the active scopes of the thread. */
+  int depth{0};
+  /*! \brief The chunk allocated from. */
+  ArenaChunk* chunk{nullptr};
+  /*! \brief The offset of the free memory in the chunk. */
+  size_t offset{0};
+  /*! \brief The number of the active thread-confined scopes of the thread. */
+  int confined_depth{0};
+  /*! \brief The objects confined to the thread. */
+  std::vector<Object*> confined;
+  /*!
+   * \brief The chunks of the confined objects, kept until the thread-confined scopes exit so that
+   * the counters of the freed objects can still be read.
+   */
+  std::vector<ArenaChunk*> held_chunks;
+};
+
+thread_local ObjectArena arena;
+
+ArenaChunk* NewChunk() {
+  void* ptr = nullptr;
+#if _MSC_VER
+  ptr = _aligned_malloc(kChunkSize, kChunkSize);
+  if (ptr == nullptr) throw std::bad_alloc();
+#elif defined(__ANDROID__) && __ANDROID_API__ < 17
+  ptr = memalign(kChunkSize, kChunkSize);
+  if (ptr == nullptr) throw std::bad_alloc();
+#else
+  int ret = posix_memalign(&ptr, kChunkSize, kChunkSize);
+  if (ret != 0) throw std::bad_alloc();
+#endif
+  return new (ptr) ArenaChunk();
+}
+
+void ReleaseChunk(ArenaChunk* chunk) {
+  if (chunk->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  chunk->~ArenaChunk();
+#if _MSC_VER
+  _aligned_free(chunk);
+#else
+  free(chunk);
+#endif
+}
+
+void HoldChunk(ArenaChunk* chunk) {
+  chunk->ref_count.fetch_add(1, std::memory_order_relaxed);
+  arena.held_chunks.push_back(chunk);
+}
+
+}  // namespace
+
+ObjectArenaScope::ObjectArenaScope(bool thread_confined) : thread_confined_(thread_confined) {
+  ++arena.depth;
+#if TVM_OBJECT_ATOMIC_REF_COUNTER
+  if (thread_confined_ && arena.confined_depth++ == 0 && arena.chunk != nullptr) {
+    HoldChunk(arena.chunk);
+  }
+#endif  // TVM_OBJECT_ATOMIC_REF_COUNTER
+}
+
+ObjectArenaScope::~ObjectArenaScope() {
+  ICHECK_GT(arena.depth, 0);
+#if TVM_OBJECT_ATOMIC_REF_COUNTER
+  if (thread_confined_ && --arena.confined_depth == 0) {
+    // The objects outliving the scope are shared from now on.
+    for (Object* obj : arena.confined) {
+      if (ObjectInternal::IsReferenced(obj)) {
+        ObjectInternal::SetThreadConfined(obj, false);
+      }
+    }
+    arena.confined.clear();
+    for (ArenaChunk* chunk : arena.held_chunks) {
+      ReleaseChunk(chunk);
+    }
+    arena.held_chunks.clear();
+  }
+#endif  // TVM_OBJECT_ATOMIC_REF_COUNTER
+  if (--arena.depth == 0 && arena.chunk != nullptr) {
+    // The chunk is freed with its last object.
+    ReleaseChunk(arena.chunk);
+    arena.chunk = nullptr;
+  }
+}
+
+void* ObjectArenaAlloc(size_t size, size_t alignment) {
+  if (arena.depth == 0 || size > kMaxObjectSize || alignment > alignof(ArenaChunk)) {
+    return nullptr;
+  }
+  size_t offset = (arena.offset + alignment - 1) / alignment * alignment;
+  if (arena.chunk == nullptr || offset + size > kChunkSize) {
+    if (arena.chunk != nullptr) {
+      ReleaseChunk(arena.chunk);
+    }
+    arena.chunk = NewChunk();
+    offset = sizeof(ArenaChunk);
+    if (arena.confined_depth != 0) {
+      HoldChunk(arena.chunk);
+    }
+  }
+  arena.chunk->ref_count.fetch_add(1, std::memory_order_relaxed);
+  arena.offset = offset + size;
+  return reinterpret_cast<char*>(arena.chunk) + offset;
+}
+
+void ObjectArenaFree(void* data) {
+  uintptr_t chunk = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(kChunkSize - 1);
+  ReleaseChunk(reinterpret_cast<ArenaChunk*>(chunk));
+}
+
+void ObjectArenaTrack(Object* obj) {
+#if TVM_OBJECT_ATOMIC_REF_COUNTER
+  if (arena.confined_depth != 0) {
+    ObjectInternal::SetThreadConfined(obj, true);
+    arena.confined.push_back(obj);
+  }
+#endif  // TVM_OBJECT_ATOMIC_REF_COUNTER
+}
+
+bool ObjectArenaIsThreadConfined() { return arena.confined_depth != 0; }
+
+}  // namespace runtime
+}  // namespace tvm
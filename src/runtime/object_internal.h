@@ -56,6 +56,23 @@ class ObjectInternal {
       static_cast<Object*>(obj)->DecRef();
     }
   }
+#if TVM_OBJECT_ATOMIC_REF_COUNTER
+  /*!
+   * \brief Mark an object as referenced only from the current thread, or clear the mark.
+   * \param obj The object.
+   * \param confined Whether the object is referenced only from the current thread.
+   */
+  static void SetThreadConfined(Object* obj, bool confined) {
+    int32_t count = obj->ref_counter_.load(std::memory_order_relaxed);
+    count = confined ? count | Object::kThreadConfinedBit : count & ~Object::kThreadConfinedBit;
+    obj->ref_counter_.store(count, std::memory_order_relaxed);
+  }
+#endif  // TVM_OBJECT_ATOMIC_REF_COUNTER
+  /*!
+   * \brief Whether an object is still referenced.
+   * \param obj The object, whose memory is not freed yet.
+   */
+  static bool IsReferenced(const Object* obj) { return obj->use_count() != 0; }
   /*!
    * \brief Check of obj derives from the type indicated by type index.
    * \param obj The original object.
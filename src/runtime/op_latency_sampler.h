@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file op_latency_sampler.h
+ * \brief Low overhead per-op latency histograms of sampled executor invocations.
+ */
+#ifndef TVM_RUNTIME_OP_LATENCY_SAMPLER_H_
+#define TVM_RUNTIME_OP_LATENCY_SAMPLER_H_
+
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/profiling.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Histogram of latencies with buckets of about 12% relative width.
+ *
+ *  Recording is a few relaxed atomic increments, so it can be done from any
+ *  thread while the histogram is read by another.
+ */
+class LatencyHistogram {
+ public:
+  /*! \brief Latencies below this many nanoseconds have their own bucket. */
+  static constexpr int kLinearBuckets = 16;
+  /*! \brief Buckets per power of two above them. */
+  static constexpr int kSubBuckets = 8;
+  /*! \brief Latencies are clamped to 2^kMaxLog2 nanoseconds, about 18 minutes. */
+  static constexpr int kMaxLog2 = 40;
+  static constexpr int kNumBuckets = kLinearBuckets + (kMaxLog2 - 4) * kSubBuckets;
+
+  LatencyHistogram() {
+    for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+  }
+
+  void Record(int64_t ns) {
+    buckets_[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(ns > 0 ? ns : 0, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  double MeanNanos() const {
+    uint64_t n = count();
+    return n == 0 ? 0 : static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / n;
+  }
+
+  /*! \brief The latency below which a fraction q of the samples lie, using bucket midpoints. */
+  double QuantileNanos(double q) const {
+    uint64_t counts[kNumBuckets];
+    uint64_t total = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      counts[i] = buckets_[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * (total - 1));
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+      seen += counts[i];
+      if (seen > rank) return (BucketBegin(i) + BucketBegin(i + 1)) / 2.0;
+    }
+    return BucketBegin(kNumBuckets);
+  }
+
+ private:
+  static int Bucket(int64_t ns) {
+    if (ns < kLinearBuckets) return ns < 0 ? 0 : static_cast<int>(ns);
+    if (ns >= (int64_t(1) << kMaxLog2)) return kNumBuckets - 1;
+    int log2 = 4;
+    while ((ns >> (log2 + 1)) != 0) ++log2;
+    int sub = static_cast<int>((ns >> (log2 - 3)) & (kSubBuckets - 1));
+    return kLinearBuckets + (log2 - 4) * kSubBuckets + sub;
+  }
+
+  static double BucketBegin(int bucket) {
+    if (bucket < kLinearBuckets) return bucket;
+    int log2 = (bucket - kLinearBuckets) / kSubBuckets + 4;
+    int sub = (bucket - kLinearBuckets) % kSubBuckets;
+    double base = static_cast<double>(int64_t(1) << log2);
+    return base * (1.0 + sub / static_cast<double>(kSubBuckets));
+  }
+
+  std::atomic<uint64_t> buckets_[kNumBuckets];
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_ns_{0};
+};
+
+/*!
+ * \brief Always-on sampling of the per-op latencies of an executor.
+ *
+ *  Every Nth invocation of the executor is sampled: each op is timed with a
+ *  device `Timer` and the timers are only synchronized once the invocation is
+ *  done, so ops are not serialized with the host. Other invocations only pay
+ *  for one atomic increment. Latencies go to per-op histograms which can be
+ *  scraped at any time.
+ *
+ * \note Configure must not be called while the executor runs.
+ */
+class OpLatencySampler {
+ public:
+  /*!
+   * \brief Set the sampling interval and the ops, clearing the histograms.
+   * \param interval Sample one invocation every interval, 0 disables sampling.
+   * \param op_names The name of each op, ops are referred to by their index.
+   */
+  void Configure(int64_t interval, std::vector<std::string> op_names) {
+    ICHECK_GE(interval, 0) << "sampling interval must not be negative";
+    interval_ = interval;
+    invocations_.store(0, std::memory_order_relaxed);
+    op_names_ = std::move(op_names);
+    ops_.clear();
+    if (interval_ > 0) {
+      for (size_t i = 0; i < op_names_.size(); ++i) {
+        ops_.emplace_back(new LatencyHistogram());
+      }
+    }
+    total_.reset(new LatencyHistogram());
+  }
+
+  bool enabled() const { return interval_ > 0; }
+
+  /*! \brief Count an invocation, returns whether it is sampled. */
+  bool BeginInvocation() {
+    if (interval_ == 0) return false;
+    uint64_t n = invocations_.fetch_add(1, std::memory_order_relaxed);
+    if (n % interval_ != 0) return false;
+    pending_.clear();
+    begin_ns_ = profiling::TimelineNanos();
+    return true;
+  }
+
+  /*! \brief Start timing op of a sampled invocation on dev. */
+  void StartOp(size_t op, Device dev) { pending_.emplace_back(op, Timer::Start(dev)); }
+
+  /*! \brief Stop timing the last started op. */
+  void StopOp() { pending_.back().second->Stop(); }
+
+  /*! \brief Synchronize the timers of a sampled invocation and record them. */
+  void EndInvocation() {
+    for (auto& p : pending_) {
+      if (p.first < ops_.size()) ops_[p.first]->Record(p.second->SyncAndGetElapsedNanos());
+    }
+    pending_.clear();
+    total_->Record(profiling::TimelineNanos() - begin_ns_);
+  }
+
+  /*! \brief The statistics as a JSON object, latencies in microseconds. */
+  std::string StatsJSON() const {
+    std::ostringstream os;
+    os << "{\"interval\": " << interval_
+       << ", \"invocations\": " << invocations_.load(std::memory_order_relaxed)
+       << ", \"total\": ";
+    WriteHistogram(total_.get(), &os);
+    os << ", \"ops\": [";
+    bool first = true;
+    for (size_t i = 0; i < ops_.size(); ++i) {
+      // Skip the ops which were never timed, e.g. the inputs of a graph.
+      if (ops_[i]->count() == 0) continue;
+      if (!first) os << ", ";
+      first = false;
+      os << "{\"name\": \"" << op_names_[i] << "\", \"latency\": ";
+      WriteHistogram(ops_[i].get(), &os);
+      os << "}";
+    }
+    os << "]}";
+    return os.str();
+  }
+
+ private:
+  static void WriteHistogram(const LatencyHistogram* hist, std::ostringstream* os) {
+    if (hist == nullptr) {
+      *os << "{\"count\": 0}";
+      return;
+    }
+    *os << "{\"count\": " << hist->count() << ", \"mean_us\": " << hist->MeanNanos() / 1e3
+        << ", \"p50_us\": " << hist->QuantileNanos(0.5) / 1e3
+        << ", \"p99_us\": " << hist->QuantileNanos(0.99) / 1e3 << "}";
+  }
+
+  int64_t interval_{0};
+  std::atomic<uint64_t> invocations_{0};
+  std::vector<std::string> op_names_;
+  std::vector<std::unique_ptr<LatencyHistogram>> ops_;
+  std::unique_ptr<LatencyHistogram> total_;
+  /*! \brief The timers of the ops of the sampled invocation in flight. */
+  std::vector<std::pair<size_t, Timer>> pending_;
+  int64_t begin_ns_{0};
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_OP_LATENCY_SAMPLER_H_
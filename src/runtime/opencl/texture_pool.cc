@@ -24,6 +24,7 @@
 #include <limits>
 #include <memory>
 
+#include "../memory_accounting.h"
 #include "../texture.h"
 
 namespace tvm {
@@ -67,12 +68,15 @@ class TexturePool::Pool {
       } else if (min_added_size <= req_size) {
         // if added size is less or equal to
         // what is needed by alloc, then grow entry
+        RecordDeviceFree(best_mem->data);
         device->FreeDataSpace(dev, best_mem->data);
         free_list_.erase(best_mem);
         new_mem.type = type_hint;
         std::vector<int64_t> shape{int64_t(new_mem.y), int64_t(new_mem.x), 4};
         new_mem.data = device->AllocDataSpace(dev, shape.size(), shape.data(), new_mem.type,
                                               Optional<String>("global.texture"));
+        RecordDeviceAlloc(dev, new_mem.data, TextureBytes(new_mem.x, new_mem.y, new_mem.type),
+                          MemoryCategory::kTexture);
         e = new_mem;
       }
     }
@@ -82,6 +86,8 @@ class TexturePool::Pool {
       std::vector<int64_t> shape{int64_t(height), int64_t(width), 4};
       e.data = device->AllocDataSpace(dev, shape.size(), shape.data(), type_hint,
                                       Optional<String>("global.texture"));
+      RecordDeviceAlloc(dev, e.data, TextureBytes(width, height, type_hint),
+                        MemoryCategory::kTexture);
       e.x = width;
       e.y = height;
       e.type = type_hint;
@@ -111,9 +117,11 @@ class TexturePool::Pool {
   // Release all resources immediately
   void Release(Device dev, DeviceAPI* device) {
     for (auto& e : allocated_) {
+      RecordDeviceFree(e.data);
       device->FreeDataSpace(dev, e.data);
     }
     for (auto& e : free_list_) {
+      RecordDeviceFree(e.data);
       device->FreeDataSpace(dev, e.data);
     }
     allocated_.clear();
@@ -121,6 +129,11 @@ class TexturePool::Pool {
   }
 
  private:
+  /*! \brief The size of an image of 4 channels. */
+  static size_t TextureBytes(size_t width, size_t height, DLDataType type) {
+    return width * height * 4 * ((type.bits * type.lanes + 7) / 8);
+  }
+
   struct Entry {
     void* data;
     size_t x;
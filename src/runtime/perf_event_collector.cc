@@ -0,0 +1,265 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file perf_event_collector.cc
+ * \brief Metric collector reading CPU hardware counters with Linux perf_event_open.
+ */
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#ifdef __linux__
+
+namespace {
+struct PerfEventKind {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t HWCache(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+/*! \brief Events supported by the collector, named after the `perf list` names. */
+const PerfEventKind kPerfEventKinds[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch-instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"L1-dcache-load-misses", PERF_TYPE_HW_CACHE,
+     HWCache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"LLC-loads", PERF_TYPE_HW_CACHE,
+     HWCache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+             PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+    {"LLC-load-misses", PERF_TYPE_HW_CACHE,
+     HWCache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+const char* kLLCLoadMisses = "LLC-load-misses";
+}  // namespace
+
+/*! \brief Counter values of every thread at the start of a region. */
+class PerfEventStartNode : public Object {
+ public:
+  std::vector<std::vector<double>> values;
+
+  static constexpr const char* _type_key = "runtime.profiling.PerfEventStart";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventStartNode, Object);
+};
+
+/*!
+ * \brief Collect hardware counters of the CPU with perf_event_open.
+ *
+ *  The counters of a region are the sum over all threads of the process, so
+ *  that the work of the thread pool is included. Threads are looked up in
+ *  /proc/self/task at the start of each region, a region does not count the
+ *  threads created after its start. The counters are multiplexed by the kernel
+ *  when there are more events than hardware registers, the values are then scaled
+ *  by the fraction of time each event was measured.
+ *
+ *  When "LLC-load-misses" is collected, "LLC Miss Bytes" estimates the memory
+ *  traffic of the region as the number of misses times the cache line size.
+ */
+class PerfEventCollectorNode : public MetricCollectorNode {
+ public:
+  explicit PerfEventCollectorNode(std::vector<std::string> events) : events_(std::move(events)) {
+    for (const std::string& name : events_) {
+      const PerfEventKind* kind = nullptr;
+      for (const PerfEventKind& k : kPerfEventKinds) {
+        if (name == k.name) kind = &k;
+      }
+      if (kind == nullptr) {
+        std::string supported;
+        for (const PerfEventKind& k : kPerfEventKinds) {
+          supported += std::string(supported.empty() ? "" : ", ") + k.name;
+        }
+        LOG(FATAL) << "Unknown perf event " << name << ", supported events are " << supported;
+      }
+      kinds_.push_back(kind);
+    }
+    long line_size = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);  // NOLINT(runtime/int)
+    cache_line_size_ = line_size > 0 ? line_size : 64;
+  }
+
+  ~PerfEventCollectorNode() {
+    for (auto& thread : threads_) {
+      for (int fd : thread.fds) close(fd);
+    }
+  }
+
+  void Init(const std::vector<Device>& devs) final { UpdateThreads(); }
+
+  ObjectRef Start(Device dev) final {
+    if (dev.device_type != kDLCPU || disabled_) return ObjectRef();
+    UpdateThreads();
+    if (threads_.empty()) return ObjectRef();
+    auto node = make_object<PerfEventStartNode>();
+    for (auto& thread : threads_) {
+      node->values.push_back(Read(thread));
+    }
+    return ObjectRef(node);
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const auto* start = obj.as<PerfEventStartNode>();
+    ICHECK(start) << "PerfEventCollector cannot stop a region it did not start";
+    std::vector<double> totals(events_.size(), 0);
+    for (size_t i = 0; i < start->values.size(); ++i) {
+      std::vector<double> now = Read(threads_[i]);
+      for (size_t j = 0; j < totals.size(); ++j) {
+        totals[j] += now[j] - start->values[i][j];
+      }
+    }
+    Map<String, ObjectRef> metrics;
+    for (size_t j = 0; j < totals.size(); ++j) {
+      int64_t value = static_cast<int64_t>(totals[j] + 0.5);
+      metrics.Set(events_[j], ObjectRef(make_object<CountNode>(value)));
+      if (events_[j] == kLLCLoadMisses) {
+        metrics.Set("LLC Miss Bytes", ObjectRef(make_object<CountNode>(value * cache_line_size_)));
+      }
+    }
+    return metrics;
+  }
+
+  static constexpr const char* _type_key = "runtime.profiling.PerfEventCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PerfEventCollectorNode, MetricCollectorNode);
+
+ private:
+  /*! \brief The counters of one thread, the first fd is the group leader. */
+  struct ThreadCounters {
+    pid_t tid;
+    std::vector<int> fds;
+  };
+
+  /*! \brief Open the counters of the threads which are not counted yet. */
+  void UpdateThreads() {
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) return;
+    while (dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] == '.') continue;
+      pid_t tid = static_cast<pid_t>(std::stol(entry->d_name));
+      if (counted_.count(tid)) continue;
+      counted_.insert(tid);
+      ThreadCounters thread{tid, {}};
+      if (Open(&thread)) {
+        threads_.push_back(std::move(thread));
+      }
+    }
+    closedir(dir);
+  }
+
+  bool Open(ThreadCounters* thread) {
+    for (const PerfEventKind* kind : kinds_) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = kind->type;
+      attr.config = kind->config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      int group = thread->fds.empty() ? -1 : thread->fds[0];
+      int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, thread->tid, -1, group, 0));
+      if (fd < 0) {
+        int err = errno;
+        for (int opened : thread->fds) close(opened);
+        thread->fds.clear();
+        if (threads_.empty() && err != ESRCH) {
+          // Only warn once, the other threads would fail the same way.
+          LOG(WARNING) << "Cannot open perf event " << kind->name << ": " << strerror(err)
+                       << (err == EACCES || err == EPERM
+                               ? ", check /proc/sys/kernel/perf_event_paranoid"
+                               : "")
+                       << ". Hardware counters will not be collected.";
+          disabled_ = true;
+        }
+        return false;
+      }
+      thread->fds.push_back(fd);
+    }
+    return true;
+  }
+
+  /*! \brief Read the scaled counters of a thread. */
+  std::vector<double> Read(const ThreadCounters& thread) {
+    // nr, time_enabled, time_running, then one value per event.
+    std::vector<uint64_t> buf(3 + kinds_.size(), 0);
+    std::vector<double> values(kinds_.size(), 0);
+    ssize_t size = read(thread.fds[0], buf.data(), buf.size() * sizeof(uint64_t));
+    if (size < static_cast<ssize_t>(buf.size() * sizeof(uint64_t)) || buf[2] == 0) {
+      return values;
+    }
+    double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<double>(buf[3 + i]) * scale;
+    }
+    return values;
+  }
+
+  std::vector<std::string> events_;
+  std::vector<const PerfEventKind*> kinds_;
+  std::vector<ThreadCounters> threads_;
+  std::unordered_set<pid_t> counted_;
+  int64_t cache_line_size_;
+  bool disabled_{false};
+};
+
+TVM_REGISTER_OBJECT_TYPE(PerfEventStartNode);
+TVM_REGISTER_OBJECT_TYPE(PerfEventCollectorNode);
+
+MetricCollector PerfEventCollector(Array<String> events) {
+  std::vector<std::string> names(events.begin(), events.end());
+  if (names.empty()) {
+    names = {"cycles", "instructions", "cache-misses", "branch-misses", kLLCLoadMisses};
+  }
+  return MetricCollector(make_object<PerfEventCollectorNode>(names));
+}
+
+TVM_REGISTER_GLOBAL("runtime.profiling.PerfEventCollector").set_body_typed(PerfEventCollector);
+
+#endif  // __linux__
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
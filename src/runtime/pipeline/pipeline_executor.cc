@@ -0,0 +1,290 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/pipeline/pipeline_executor.cc
+ */
+#include "pipeline_executor.h"
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+
+bool PipelineQueue::Push(std::shared_ptr<PipelineRequest> request) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock, [this]() { return closed_ || requests_.size() < capacity_; });
+  if (closed_) return false;
+  requests_.push_back(std::move(request));
+  not_empty_.notify_one();
+  return true;
+}
+
+std::shared_ptr<PipelineRequest> PipelineQueue::Pop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this]() { return closed_ || !requests_.empty(); });
+  if (requests_.empty()) return nullptr;
+  std::shared_ptr<PipelineRequest> request = std::move(requests_.front());
+  requests_.pop_front();
+  not_full_.notify_one();
+  return request;
+}
+
+void PipelineQueue::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = true;
+  not_empty_.notify_all();
+  not_full_.notify_all();
+}
+
+void PipelineStageConfig::Load(dmlc::JSONReader* reader) {
+  dmlc::JSONObjectReadHelper helper;
+  helper.DeclareField("input_names", &input_names);
+  helper.DeclareField("input_values", &input_values);
+  helper.DeclareField("output_values", &output_values);
+  helper.ReadAllFields(reader);
+  ICHECK_EQ(input_names.size(), input_values.size()) << "invalid pipeline stage";
+}
+
+void PipelineConfig::Load(dmlc::JSONReader* reader) {
+  dmlc::JSONObjectReadHelper helper;
+  helper.DeclareField("input_names", &input_names);
+  helper.DeclareField("input_values", &input_values);
+  helper.DeclareField("output_values", &output_values);
+  helper.DeclareField("num_values", &num_values);
+  helper.DeclareField("stages", &stages);
+  helper.ReadAllFields(reader);
+  ICHECK_EQ(input_names.size(), input_values.size()) << "invalid pipeline config";
+}
+
+void PipelineStageStats::Save(dmlc::JSONWriter* writer) const {
+  writer->BeginObject();
+  writer->WriteObjectKeyValue("runs", runs);
+  writer->WriteObjectKeyValue("mean_us", runs == 0 ? 0.0 : busy_us / runs);
+  writer->WriteObjectKeyValue("busy_us", busy_us);
+  writer->WriteObjectKeyValue("idle_us", idle_us);
+  writer->WriteObjectKeyValue("blocked_us", blocked_us);
+  writer->EndObject();
+}
+
+PipelineExecutor::PipelineExecutor(const std::string& config_json,
+                                   const std::vector<Module>& stages, int queue_capacity)
+    : stages_(stages) {
+  std::istringstream is(config_json);
+  dmlc::JSONReader reader(&is);
+  config_.Load(&reader);
+  ICHECK_EQ(config_.stages.size(), stages_.size())
+      << "The pipeline config has " << config_.stages.size() << " stages, got "
+      << stages_.size() << " executors";
+  ICHECK_GT(queue_capacity, 0) << "The queues must hold at least one request";
+  for (size_t i = 0; i <= stages_.size(); ++i) {
+    queues_.emplace_back(new PipelineQueue(queue_capacity));
+  }
+  stats_.resize(stages_.size());
+  next_request_ = std::make_shared<PipelineRequest>();
+  next_request_->values.resize(config_.num_values);
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    threads_.emplace_back([this, i]() { this->StageLoop(i); });
+  }
+}
+
+PipelineExecutor::~PipelineExecutor() {
+  for (auto& queue : queues_) {
+    queue->Close();
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void PipelineExecutor::StageLoop(size_t index) {
+  using Clock = std::chrono::high_resolution_clock;
+  auto to_us = [](Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(d).count();
+  };
+  const PipelineStageConfig& stage = config_.stages[index];
+  PackedFunc set_input = stages_[index].GetFunction("set_input");
+  PackedFunc run = stages_[index].GetFunction("run");
+  PackedFunc get_output = stages_[index].GetFunction("get_output");
+  PipelineQueue* in = queues_[index].get();
+  PipelineQueue* out = queues_[index + 1].get();
+  while (true) {
+    Clock::time_point wait_begin = Clock::now();
+    std::shared_ptr<PipelineRequest> request = in->Pop();
+    if (request == nullptr) return;
+    Clock::time_point run_begin = Clock::now();
+    try {
+      for (size_t i = 0; i < stage.input_names.size(); ++i) {
+        set_input(stage.input_names[i], request->values[stage.input_values[i]]);
+      }
+      run();
+      // The executor overwrites its outputs on the next run, the later stages read copies.
+      for (size_t i = 0; i < stage.output_values.size(); ++i) {
+        NDArray output = get_output(static_cast<int>(i));
+        request->values[stage.output_values[i]] = output.CopyTo(output->device);
+      }
+      for (size_t i = 0; i < stage.output_values.size(); ++i) {
+        Device dev = request->values[stage.output_values[i]]->device;
+        DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+      }
+    } catch (const std::exception& e) {
+      Abort("stage " + std::to_string(index) + ": " + e.what());
+      return;
+    }
+    Clock::time_point run_end = Clock::now();
+    bool pushed = out->Push(std::move(request));
+    Clock::time_point push_end = Clock::now();
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      PipelineStageStats& stats = stats_[index];
+      stats.runs += 1;
+      stats.idle_us += to_us(run_begin - wait_begin);
+      stats.busy_us += to_us(run_end - run_begin);
+      stats.blocked_us += to_us(push_end - run_end);
+    }
+    if (!pushed) return;
+  }
+}
+
+void PipelineExecutor::Abort(const std::string& error) {
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (error_.empty()) error_ = error;
+  }
+  for (auto& queue : queues_) {
+    queue->Close();
+  }
+}
+
+void PipelineExecutor::SetInput(const std::string& name, DLTensor* data) {
+  auto it = std::find(config_.input_names.begin(), config_.input_names.end(), name);
+  ICHECK(it != config_.input_names.end()) << "The pipeline has no input " << name;
+  int value = config_.input_values[it - config_.input_names.begin()];
+  std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+  NDArray input = NDArray::Empty(shape, data->dtype, data->device);
+  input.CopyFrom(data);
+  next_request_->values[value] = input;
+}
+
+void PipelineExecutor::Run() {
+  for (size_t i = 0; i < config_.input_names.size(); ++i) {
+    ICHECK(next_request_->values[config_.input_values[i]].defined())
+        << "The input " << config_.input_names[i] << " of the pipeline is not set";
+  }
+  std::shared_ptr<PipelineRequest> request = next_request_;
+  // The inputs are kept for the next requests, like the inputs of the graph executor.
+  next_request_ = std::make_shared<PipelineRequest>();
+  next_request_->values.resize(config_.num_values);
+  for (int value : config_.input_values) {
+    next_request_->values[value] = request->values[value];
+  }
+  if (!queues_.front()->Push(std::move(request))) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    LOG(FATAL) << "The pipeline stopped, " << error_;
+  }
+  ++num_pending_;
+}
+
+Array<NDArray> PipelineExecutor::GetOutput() {
+  ICHECK_GT(num_pending_, 0) << "No request is running in the pipeline";
+  std::shared_ptr<PipelineRequest> request = queues_.back()->Pop();
+  if (request == nullptr) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    LOG(FATAL) << "The pipeline stopped, " << error_;
+  }
+  --num_pending_;
+  Array<NDArray> outputs;
+  for (int value : config_.output_values) {
+    outputs.push_back(request->values[value]);
+  }
+  return outputs;
+}
+
+std::string PipelineExecutor::GetStats() {
+  std::vector<PipelineStageStats> stats;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats = stats_;
+  }
+  int bottleneck = 0;
+  double total = 0, slowest = 0;
+  for (size_t i = 0; i < stats.size(); ++i) {
+    double mean = stats[i].runs == 0 ? 0.0 : stats[i].busy_us / stats[i].runs;
+    total += mean;
+    if (mean > slowest) {
+      slowest = mean;
+      bottleneck = static_cast<int>(i);
+    }
+  }
+  // 1 when the stages are balanced, the number of stages when a single stage does all the work.
+  double balance = total == 0 ? 1.0 : slowest * stats.size() / total;
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.BeginObject();
+  writer.WriteObjectKeyValue("stages", stats);
+  writer.WriteObjectKeyValue("bottleneck", bottleneck);
+  writer.WriteObjectKeyValue("balance", balance);
+  writer.EndObject();
+  return os.str();
+}
+
+PackedFunc PipelineExecutor::GetFunction(const std::string& name,
+                                         const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "set_input") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetInput(args[0], args[1]);
+    });
+  } else if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "get_output") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetOutput(); });
+  } else if (name == "get_stats") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetStats(); });
+  } else if (name == "get_num_stages") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<int>(this->stages_.size());
+    });
+  } else if (name == "get_num_outputs") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<int>(this->config_.output_values.size());
+    });
+  }
+  return PackedFunc();
+}
+
+TVM_REGISTER_GLOBAL("tvm.pipeline_executor.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.num_args, 3) << "The args are the config, the queue capacity and the stages";
+  std::vector<Module> stages;
+  for (int i = 2; i < args.num_args; ++i) {
+    stages.push_back(args[i]);
+  }
+  auto exec = make_object<PipelineExecutor>(args[0], stages, args[1]);
+  *rv = Module(exec);
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/pipeline/pipeline_executor.h
+ * \brief Executor running the stages of a split model as a pipeline.
+ *
+ *  Each stage is a graph executor built for its own device, run by its own
+ *  thread. The stages are connected by bounded queues of requests, so that a
+ *  stage works on a request while the next stage works on the previous one.
+ */
+#ifndef TVM_RUNTIME_PIPELINE_PIPELINE_EXECUTOR_H_
+#define TVM_RUNTIME_PIPELINE_PIPELINE_EXECUTOR_H_
+
+#include <dmlc/json.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The values of one request flowing through the pipeline, indexed by value id.
+ *
+ *  The inputs of the model and the values passed from a stage to the later ones
+ *  each have an id in the pipeline configuration.
+ */
+struct PipelineRequest {
+  std::vector<NDArray> values;
+};
+
+/*! \brief A bounded blocking queue of requests between two stages. */
+class PipelineQueue {
+ public:
+  explicit PipelineQueue(size_t capacity) : capacity_(capacity) {}
+  /*!
+   * \brief Push a request, wait while the queue is full.
+   * \return false if the queue is closed.
+   */
+  bool Push(std::shared_ptr<PipelineRequest> request);
+  /*!
+   * \brief Pop the oldest request, wait while the queue is empty.
+   * \return nullptr if the queue is closed and empty.
+   */
+  std::shared_ptr<PipelineRequest> Pop();
+  /*! \brief Wake up the waiting threads, the later pushes fail. */
+  void Close();
+
+ private:
+  size_t capacity_;
+  bool closed_{false};
+  std::deque<std::shared_ptr<PipelineRequest>> requests_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+/*! \brief Where a stage reads its inputs and writes its outputs. */
+struct PipelineStageConfig {
+  /*! \brief The names of the inputs of the stage executor. */
+  std::vector<std::string> input_names;
+  /*! \brief The value id read by each input. */
+  std::vector<int> input_values;
+  /*! \brief The value id written by each output of the stage executor. */
+  std::vector<int> output_values;
+
+  void Load(dmlc::JSONReader* reader);
+};
+
+/*! \brief The connections of the stages. */
+struct PipelineConfig {
+  /*! \brief The names of the inputs of the model. */
+  std::vector<std::string> input_names;
+  /*! \brief The value id of each input of the model. */
+  std::vector<int> input_values;
+  /*! \brief The value ids of the outputs of the model. */
+  std::vector<int> output_values;
+  /*! \brief The number of values of a request. */
+  int num_values;
+  /*! \brief The stages, in the order of the pipeline. */
+  std::vector<PipelineStageConfig> stages;
+
+  void Load(dmlc::JSONReader* reader);
+};
+
+/*! \brief The time a stage spent on the requests, in microseconds. */
+struct PipelineStageStats {
+  /*! \brief The number of requests run. */
+  int64_t runs{0};
+  /*! \brief The time spent copying the inputs, running and copying the outputs. */
+  double busy_us{0};
+  /*! \brief The time spent waiting for a request from the previous stage. */
+  double idle_us{0};
+  /*! \brief The time spent waiting for space in the queue of the next stage. */
+  double blocked_us{0};
+
+  void Save(dmlc::JSONWriter* writer) const;
+};
+
+/*!
+ * \brief Pipeline executor.
+ *
+ *  SetInput fills the inputs of the next request and Run queues it without
+ *  waiting for its outputs, blocking only while the first queue is full.
+ *  GetOutput waits for the outputs of the oldest request not yet returned.
+ */
+class PipelineExecutor : public ModuleNode {
+ public:
+  /*!
+   * \brief Start the stage threads.
+   * \param config_json The connections of the stages, see PipelineConfig.
+   * \param stages The graph executor of each stage.
+   * \param queue_capacity The number of requests each queue holds.
+   */
+  PipelineExecutor(const std::string& config_json, const std::vector<Module>& stages,
+                   int queue_capacity);
+  ~PipelineExecutor();
+
+  const char* type_key() const final { return "PipelineExecutor"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+  /*!
+   * \brief Set an input of the next request.
+   * \param name The name of the input of the model.
+   * \param data The input data, copied.
+   */
+  void SetInput(const std::string& name, DLTensor* data);
+  /*! \brief Queue the next request. */
+  void Run();
+  /*! \brief Wait for the outputs of the oldest request not returned yet. */
+  Array<NDArray> GetOutput();
+  /*!
+   * \brief Get the time spent by the stages, to balance them.
+   * \return A JSON object with the stats of each stage, the slowest stage,
+   *  and the ratio of its mean latency to the mean latency of the stages.
+   */
+  std::string GetStats();
+
+ private:
+  // The loop of the thread of a stage.
+  void StageLoop(size_t index);
+  // Stop the pipeline after an error of a stage.
+  void Abort(const std::string& error);
+
+  PipelineConfig config_;
+  std::vector<Module> stages_;
+  /*! \brief The input queue of each stage, and the queue of the finished requests. */
+  std::vector<std::unique_ptr<PipelineQueue>> queues_;
+  std::vector<std::thread> threads_;
+  /*! \brief The request being filled by SetInput. */
+  std::shared_ptr<PipelineRequest> next_request_;
+  /*! \brief The number of requests queued and not returned by GetOutput. */
+  int64_t num_pending_{0};
+  std::mutex stats_mutex_;
+  std::vector<PipelineStageStats> stats_;
+  /*! \brief The first error of a stage. */
+  std::string error_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_PIPELINE_PIPELINE_EXECUTOR_H_
@@ -26,12 +26,18 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
 
+#include "memory_accounting.h"
+#include "workspace_pool.h"
+
 namespace tvm {
 namespace runtime {
 
@@ -100,21 +106,130 @@ TVM_REGISTER_GLOBAL("profiling.start_timer").set_body_typed(Timer::Start);
 
 namespace profiling {
 
+namespace {
+/*! \brief The timeline events recorded by one thread. */
+struct TimelineBuffer {
+  int thread_id;
+  std::mutex mutex;
+  std::vector<TimelineEvent> events;
+};
+
+/*! \brief The buffers of all threads which recorded events, kept after the threads exit. */
+struct TimelineRegistry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<TimelineBuffer>> buffers;
+  /*! \brief The number of profilers recording a timeline. */
+  std::atomic<int> recording{0};
+
+  static TimelineRegistry* Global() {
+    static auto* inst = new TimelineRegistry();
+    return inst;
+  }
+
+  /*! \brief Take the events of all threads recorded between begin_ns and end_ns. */
+  std::vector<TimelineEvent> Take(int64_t begin_ns, int64_t end_ns) {
+    std::vector<TimelineEvent> taken;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& buffer : buffers) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      std::vector<TimelineEvent> kept;
+      for (auto& event : buffer->events) {
+        if (event.begin_ns >= begin_ns && event.end_ns <= end_ns) {
+          taken.push_back(std::move(event));
+        } else if (event.end_ns > end_ns) {
+          // Recorded for another profiler which is still running.
+          kept.push_back(std::move(event));
+        }
+      }
+      buffer->events = std::move(kept);
+    }
+    return taken;
+  }
+};
+
+TimelineBuffer* ThreadTimelineBuffer() {
+  thread_local std::shared_ptr<TimelineBuffer> buffer;
+  if (buffer == nullptr) {
+    TimelineRegistry* registry = TimelineRegistry::Global();
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    buffer = std::make_shared<TimelineBuffer>();
+    buffer->thread_id = static_cast<int>(registry->buffers.size());
+    registry->buffers.push_back(buffer);
+  }
+  return buffer.get();
+}
+}  // namespace
+
+int64_t TimelineNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool IsTimelineRecording() {
+  return TimelineRegistry::Global()->recording.load(std::memory_order_relaxed) > 0;
+}
+
+void RecordTimelineEvent(std::string name, int64_t begin_ns, int64_t end_ns) {
+  TimelineBuffer* buffer = ThreadTimelineBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->events.push_back(TimelineEvent{std::move(name), buffer->thread_id, begin_ns, end_ns});
+}
+
+int TimelineThreadId() { return ThreadTimelineBuffer()->thread_id; }
+
 void Profiler::Start(const std::vector<Device>& devs) {
   CHECK(global_timers_.empty()) << "You can only call Start once per Profiler.";
+  if (record_timeline_) {
+    TimelineRegistry::Global()->recording.fetch_add(1);
+    timeline_start_ns_ = TimelineNanos();
+  }
+  for (auto& collector : collectors_) {
+    collector->Init(devs);
+  }
   for (auto dev : devs) {
+    ResetWorkspacePoolPeak(dev);
+    global_collectors_.push_back(StartCollectors(dev));
     global_timers_.emplace_back(dev, Timer::Start(dev));
   }
 }
 
+std::vector<std::pair<MetricCollector, ObjectRef>> Profiler::StartCollectors(Device dev) {
+  std::vector<std::pair<MetricCollector, ObjectRef>> started;
+  for (auto& collector : collectors_) {
+    ObjectRef obj = collector->Start(dev);
+    if (obj.defined()) {
+      started.emplace_back(collector, obj);
+    }
+  }
+  return started;
+}
+
+void Profiler::StopCollectors(const std::vector<std::pair<MetricCollector, ObjectRef>>& started,
+                              std::unordered_map<std::string, ObjectRef>* metrics) {
+  // Stop in the reverse order of Start so that the collectors nest.
+  for (auto it = started.rbegin(); it != started.rend(); ++it) {
+    for (auto p : it->first->Stop(it->second)) {
+      (*metrics)[p.first] = p.second;
+    }
+  }
+}
+
 void Profiler::StartCall(String name, Device dev,
                          std::unordered_map<std::string, ObjectRef> extra_metrics) {
-  in_flight_.push(CallFrame{dev, name, Timer::Start(dev), extra_metrics});
+  // Collectors are started before the timer so that their overhead is not timed.
+  auto started = StartCollectors(dev);
+  int64_t start_ns = record_timeline_ ? TimelineNanos() : 0;
+  int thread_id = record_timeline_ ? TimelineThreadId() : 0;
+  in_flight_.push(
+      CallFrame{dev, name, Timer::Start(dev), extra_metrics, started, start_ns, thread_id});
 }
 
 void Profiler::StopCall(std::unordered_map<std::string, ObjectRef> extra_metrics) {
   CallFrame cf = in_flight_.top();
   cf.timer->Stop();
+  StopCollectors(cf.extra_collectors, &cf.extra_metrics);
+  cf.extra_collectors.clear();
   for (auto& p : extra_metrics) {
     cf.extra_metrics[p.first] = p.second;
   }
@@ -127,6 +242,16 @@ void Profiler::Stop() {
   for (auto p : global_timers_) {
     p.second->Stop();
   }
+  for (auto& started : global_collectors_) {
+    global_metrics_.emplace_back();
+    StopCollectors(started, &global_metrics_.back());
+  }
+  global_collectors_.clear();
+  if (record_timeline_) {
+    timeline_stop_ns_ = TimelineNanos();
+    TimelineRegistry::Global()->recording.fetch_sub(1);
+    thread_events_ = TimelineRegistry::Global()->Take(timeline_start_ns_, timeline_stop_ns_);
+  }
 }
 
 String ShapeString(const std::vector<NDArray>& shapes) {
@@ -407,12 +532,26 @@ Report Profiler::Report(bool aggregate, bool sort) {
   }
 
   std::unordered_map<String, Map<String, ObjectRef>> device_metrics;
-  for (auto p : global_times) {
+  for (size_t i = 0; i < global_times.size(); ++i) {
+    const auto& p = global_times[i];
     std::unordered_map<String, ObjectRef> row;
+    if (i < global_metrics_.size()) {
+      for (auto& metric : global_metrics_[i]) {
+        row[metric.first] = metric.second;
+      }
+    }
     row["Name"] = String("Total");
     row["Duration (us)"] = ObjectRef(make_object<DurationNode>(p.second));
     row["Percent"] = ObjectRef(make_object<PercentNode>(p.second / overall_time * 100));
     row["Device"] = String(DeviceString(p.first));
+    WorkspacePoolStats workspace = GetWorkspacePoolStats(p.first);
+    row["Workspace Peak (B)"] = ObjectRef(make_object<CountNode>(workspace.peak_live_bytes));
+    row["Workspace Cached (B)"] = ObjectRef(make_object<CountNode>(workspace.cached_bytes));
+    row["Workspace Device Allocs"] = ObjectRef(make_object<CountNode>(workspace.device_allocs));
+    row["Workspace Remote Frees"] = ObjectRef(make_object<CountNode>(workspace.remote_frees));
+    MemoryUsage memory = GetDeviceMemoryUsage(p.first);
+    row["Memory Live (B)"] = ObjectRef(make_object<CountNode>(memory.live_bytes));
+    row["Memory Peak (B)"] = ObjectRef(make_object<CountNode>(memory.peak_bytes));
     device_metrics[DeviceString(p.first)] = row;
   }
 
@@ -431,14 +570,250 @@ Report Profiler::Report(bool aggregate, bool sort) {
     rows.push_back(row);
   }
 
-  return profiling::Report(rows, device_metrics);
+  std::vector<Map<String, ObjectRef>> timeline;
+  if (record_timeline_) {
+    std::vector<std::pair<int64_t, Map<String, ObjectRef>>> events;
+    // The end of the last call on the stream of each device.
+    std::map<std::pair<int, int>, int64_t> stream_ends;
+    for (size_t i = 0; i < calls_.size(); ++i) {
+      const CallFrame& cf = calls_[i];
+      int64_t start_ns = cf.start_ns;
+      double duration_us = rows[i]["Duration (us)"].as<DurationNode>()->microseconds;
+      int64_t duration_ns = static_cast<int64_t>(duration_us * 1e3);
+      if (cf.dev.device_type != kDLCPU) {
+        // Calls are launched asynchronously, a call starts on the device once the
+        // previous one on the stream is done.
+        int64_t& stream_end = stream_ends[{static_cast<int>(cf.dev.device_type), cf.dev.device_id}];
+        start_ns = std::max(start_ns, stream_end);
+        stream_end = start_ns + duration_ns;
+      }
+      Map<String, ObjectRef> event;
+      event.Set("Name", cf.name);
+      event.Set("Process", String(DeviceString(cf.dev)));
+      // Calls on the CPU run on the calling thread, the others on the stream of their device.
+      event.Set("Thread", String(cf.dev.device_type == kDLCPU
+                                     ? "thread " + std::to_string(cf.thread_id)
+                                     : std::string("stream")));
+      event.Set("Category", String("call"));
+      event.Set("Start (us)",
+                ObjectRef(make_object<DurationNode>((start_ns - timeline_start_ns_) / 1e3)));
+      event.Set("Duration (us)", rows[i]["Duration (us)"]);
+      auto it = cf.extra_metrics.find("Argument Shapes");
+      if (it != cf.extra_metrics.end()) {
+        event.Set("Argument Shapes", it->second);
+      }
+      events.emplace_back(start_ns, event);
+    }
+    for (const TimelineEvent& te : thread_events_) {
+      Map<String, ObjectRef> event;
+      event.Set("Name", String(te.name));
+      event.Set("Process", String(DeviceString(Device{kDLCPU, 0})));
+      event.Set("Thread", String("thread " + std::to_string(te.thread_id)));
+      event.Set("Category", String("thread"));
+      event.Set("Start (us)",
+                ObjectRef(make_object<DurationNode>((te.begin_ns - timeline_start_ns_) / 1e3)));
+      event.Set("Duration (us)",
+                ObjectRef(make_object<DurationNode>((te.end_ns - te.begin_ns) / 1e3)));
+      events.emplace_back(te.begin_ns, event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& p : events) {
+      timeline.push_back(p.second);
+    }
+  }
+
+  return profiling::Report(rows, device_metrics, timeline);
+}
+
+namespace {
+std::string JSONEscape(const std::string& str) {
+  std::ostringstream os;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+         << std::dec;
+    } else {
+      os << c;
+    }
+  }
+  return os.str();
+}
+
+/*! \brief The numeric ids of the processes and threads of a timeline, in order of appearance. */
+struct TimelineTracks {
+  std::map<std::string, int> processes;
+  std::map<std::pair<int, std::string>, int> threads;
+
+  explicit TimelineTracks(const Array<Map<String, ObjectRef>>& timeline) {
+    for (const auto& event : timeline) {
+      std::string process = Downcast<String>(event["Process"]);
+      int pid = processes.emplace(process, static_cast<int>(processes.size())).first->second;
+      std::string thread = Downcast<String>(event["Thread"]);
+      threads.emplace(std::make_pair(pid, thread), static_cast<int>(threads.size()));
+    }
+  }
+
+  int Process(const Map<String, ObjectRef>& event) const {
+    return processes.at(Downcast<String>(event["Process"]));
+  }
+  int Thread(const Map<String, ObjectRef>& event) const {
+    std::string thread = Downcast<String>(event["Thread"]);
+    return threads.at(std::make_pair(Process(event), thread));
+  }
+};
+
+/*! \brief Minimal protobuf writer for the Perfetto trace. */
+class ProtoWriter {
+ public:
+  void Varint(uint32_t field, uint64_t value) {
+    Key(field, 0);
+    Raw(value);
+  }
+  void Bytes(uint32_t field, const std::string& value) {
+    Key(field, 2);
+    Raw(value.size());
+    out_ += value;
+  }
+  const std::string& str() const { return out_; }
+
+ private:
+  void Key(uint32_t field, uint32_t wire_type) {
+    Raw((static_cast<uint64_t>(field) << 3) | wire_type);
+  }
+  void Raw(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  std::string out_;
+};
+
+// Field numbers of perfetto/protos/perfetto/trace.
+constexpr uint32_t kTracePacket = 1;
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketSequenceId = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+constexpr uint32_t kTrackUuid = 1;
+constexpr uint32_t kTrackName = 2;
+constexpr uint32_t kTrackParentUuid = 5;
+constexpr uint32_t kEventType = 9;
+constexpr uint32_t kEventTrackUuid = 11;
+constexpr uint32_t kEventName = 23;
+constexpr uint64_t kSliceBegin = 1;
+constexpr uint64_t kSliceEnd = 2;
+}  // namespace
+
+String ReportNode::AsChromeTrace() const {
+  TimelineTracks tracks(timeline);
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  bool first = true;
+  auto sep = [&]() -> std::ostream& {
+    os << (first ? "\n  " : ",\n  ");
+    first = false;
+    return os;
+  };
+  for (const auto& p : tracks.processes) {
+    sep() << "{\"ph\": \"M\", \"name\": \"process_name\", \"pid\": " << p.second
+          << ", \"args\": {\"name\": \"" << JSONEscape(p.first) << "\"}}";
+  }
+  for (const auto& p : tracks.threads) {
+    sep() << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": " << p.first.first
+          << ", \"tid\": " << p.second << ", \"args\": {\"name\": \""
+          << JSONEscape(p.first.second) << "\"}}";
+  }
+  for (const auto& event : timeline) {
+    sep() << "{\"ph\": \"X\", \"name\": \""
+          << JSONEscape(Downcast<String>(event["Name"])) << "\", \"cat\": \""
+          << JSONEscape(Downcast<String>(event["Category"])) << "\", \"pid\": "
+          << tracks.Process(event) << ", \"tid\": " << tracks.Thread(event)
+          << ", \"ts\": " << event["Start (us)"].as<DurationNode>()->microseconds
+          << ", \"dur\": " << event["Duration (us)"].as<DurationNode>()->microseconds;
+    auto it = event.find("Argument Shapes");
+    if (it != event.end()) {
+      os << ", \"args\": {\"Argument Shapes\": \"" << JSONEscape(Downcast<String>((*it).second))
+         << "\"}";
+    }
+    os << "}";
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+std::string ReportNode::AsPerfetto() const {
+  TimelineTracks tracks(timeline);
+  // Process tracks use uuids 1..P, thread tracks follow.
+  auto process_uuid = [](int pid) { return static_cast<uint64_t>(pid) + 1; };
+  uint64_t num_processes = tracks.processes.size();
+  auto thread_uuid = [&](int tid) { return num_processes + static_cast<uint64_t>(tid) + 1; };
+
+  ProtoWriter trace;
+  auto packet = [&](uint64_t timestamp, uint32_t field, const ProtoWriter& body) {
+    ProtoWriter p;
+    p.Varint(kPacketTimestamp, timestamp);
+    p.Varint(kPacketSequenceId, 1);
+    p.Bytes(field, body.str());
+    trace.Bytes(kTracePacket, p.str());
+  };
+  for (const auto& p : tracks.processes) {
+    ProtoWriter desc;
+    desc.Varint(kTrackUuid, process_uuid(p.second));
+    desc.Bytes(kTrackName, p.first);
+    packet(0, kPacketTrackDescriptor, desc);
+  }
+  for (const auto& p : tracks.threads) {
+    ProtoWriter desc;
+    desc.Varint(kTrackUuid, thread_uuid(p.second));
+    desc.Bytes(kTrackName, p.first.second);
+    desc.Varint(kTrackParentUuid, process_uuid(p.first.first));
+    packet(0, kPacketTrackDescriptor, desc);
+  }
+  // Slices are written as begin and end packets, sorted by time.
+  struct Mark {
+    uint64_t time;
+    bool begin;
+    uint64_t track;
+    std::string name;
+  };
+  std::vector<Mark> marks;
+  for (const auto& event : timeline) {
+    double start_us = event["Start (us)"].as<DurationNode>()->microseconds;
+    double duration_us = event["Duration (us)"].as<DurationNode>()->microseconds;
+    uint64_t begin = static_cast<uint64_t>(start_us * 1e3);
+    uint64_t end = begin + static_cast<uint64_t>(duration_us * 1e3);
+    uint64_t track = thread_uuid(tracks.Thread(event));
+    marks.push_back(Mark{begin, true, track, Downcast<String>(event["Name"])});
+    marks.push_back(Mark{end, false, track, std::string()});
+  }
+  // Ends sort before begins at the same time so that adjacent slices do not nest.
+  std::stable_sort(marks.begin(), marks.end(), [](const Mark& a, const Mark& b) {
+    return a.time != b.time ? a.time < b.time : (!a.begin && b.begin);
+  });
+  for (const Mark& mark : marks) {
+    ProtoWriter event;
+    event.Varint(kEventType, mark.begin ? kSliceBegin : kSliceEnd);
+    event.Varint(kEventTrackUuid, mark.track);
+    if (mark.begin) event.Bytes(kEventName, mark.name);
+    packet(mark.time, kPacketTrackEvent, event);
+  }
+  return trace.str();
 }
 
 Report::Report(Array<Map<String, ObjectRef>> calls,
-               Map<String, Map<String, ObjectRef>> device_metrics) {
+               Map<String, Map<String, ObjectRef>> device_metrics,
+               Array<Map<String, ObjectRef>> timeline) {
   auto node = make_object<ReportNode>();
   node->calls = std::move(calls);
   node->device_metrics = std::move(device_metrics);
+  node->timeline = std::move(timeline);
   data_ = std::move(node);
 }
 
@@ -446,8 +821,20 @@ TVM_REGISTER_OBJECT_TYPE(DurationNode);
 TVM_REGISTER_OBJECT_TYPE(PercentNode);
 TVM_REGISTER_OBJECT_TYPE(CountNode);
 TVM_REGISTER_OBJECT_TYPE(ReportNode);
+TVM_REGISTER_OBJECT_TYPE(MetricCollectorNode);
 
 TVM_REGISTER_GLOBAL("runtime.profiling.AsCSV").set_body_typed([](Report n) { return n->AsCSV(); });
+TVM_REGISTER_GLOBAL("runtime.profiling.AsChromeTrace").set_body_typed([](Report n) {
+  return n->AsChromeTrace();
+});
+TVM_REGISTER_GLOBAL("runtime.profiling.AsPerfetto").set_body([](TVMArgs args, TVMRetValue* rv) {
+  Report report = args[0];
+  std::string trace = report->AsPerfetto();
+  TVMByteArray arr;
+  arr.data = trace.data();
+  arr.size = trace.size();
+  *rv = arr;
+});
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
@@ -27,30 +27,101 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
+#include <string>
+#include <vector>
 
 #include "runtime_base.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The entry of a name in the registry.
+ *
+ *  The entries are never removed, a removed function only clears its registry, so the entries
+ *  can be read by Get and the handles without a lock.
+ */
+struct Registry::Entry {
+  /*! \brief The name, immutable once the entry is published */
+  std::string name;
+  /*! \brief The registry of the function, nullptr if the function is not registered */
+  std::atomic<Registry*> registry{nullptr};
+};
+
 struct Registry::Manager {
-  // map storing the functions.
-  // We deliberately used raw pointer.
+  /*!
+   * \brief An open addressing table of the entries, with a power of two capacity.
+   *
+   *  A published table is only written to by inserting entries into its empty slots. The table
+   *  is replaced by a larger copy when it is half full, and the old table is never freed since
+   *  it may still be probed by a concurrent lookup.
+   */
+  struct Table {
+    explicit Table(size_t capacity) : capacity(capacity), slots(new std::atomic<Entry*>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    size_t capacity;
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+  };
+
+  // The entries and the tables are deliberately leaked, like the registries.
   // This is because PackedFunc can contain callbacks into the host language (Python) and the
   // resource can become invalid because of indeterministic order of destruction and forking.
   // The resources will only be recycled during program exit.
-  std::unordered_map<std::string, Registry*> fmap;
-  // mutex
+  std::atomic<Table*> table{new Table(1024)};
+  // the entries in the order they are created, guarded by the mutex
+  std::vector<Entry*> entries;
+  // mutex serializing the writes
   std::mutex mutex;
 
   Manager() {}
 
+  // Find the entry of a name, without a lock.
+  Entry* Find(const std::string& name) const {
+    const Table* t = table.load(std::memory_order_acquire);
+    size_t mask = t->capacity - 1;
+    for (size_t i = std::hash<std::string>()(name) & mask;; i = (i + 1) & mask) {
+      Entry* entry = t->slots[i].load(std::memory_order_acquire);
+      if (entry == nullptr || entry->name == name) return entry;
+    }
+  }
+
+  // Find the entry of a name, or create it. The caller must hold the mutex.
+  Entry* FindOrCreate(const std::string& name) {
+    if (Entry* entry = Find(name)) return entry;
+    Table* t = table.load(std::memory_order_relaxed);
+    if ((entries.size() + 1) * 2 > t->capacity) {
+      Table* grown = new Table(t->capacity * 2);
+      for (Entry* entry : entries) {
+        Insert(grown, entry);
+      }
+      table.store(grown, std::memory_order_release);
+      t = grown;
+    }
+    Entry* entry = new Entry();
+    entry->name = name;
+    entries.push_back(entry);
+    Insert(t, entry);
+    return entry;
+  }
+
+  static void Insert(Table* t, Entry* entry) {
+    size_t mask = t->capacity - 1;
+    size_t i = std::hash<std::string>()(entry->name) & mask;
+    while (t->slots[i].load(std::memory_order_relaxed) != nullptr) {
+      i = (i + 1) & mask;
+    }
+    t->slots[i].store(entry, std::memory_order_release);
+  }
+
   static Manager* Global() {
     // We deliberately leak the Manager instance, to avoid leak sanitizers
-    // complaining about the entries in Manager::fmap being leaked at program
+    // complaining about the entries in Manager::entries being leaked at program
     // exit.
     static Manager* inst = new Manager();
     return inst;
@@ -65,40 +136,55 @@ Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
 Registry& Registry::Register(const std::string& name, bool can_override) {  // NOLINT(*)
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  if (m->fmap.count(name)) {
+  Entry* entry = m->FindOrCreate(name);
+  if (entry->registry.load(std::memory_order_relaxed) != nullptr) {
     ICHECK(can_override) << "Global PackedFunc " << name << " is already registered";
   }
 
   Registry* r = new Registry();
   r->name_ = name;
-  m->fmap[name] = r;
+  entry->registry.store(r, std::memory_order_release);
   return *r;
 }
 
 bool Registry::Remove(const std::string& name) {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return false;
-  m->fmap.erase(it);
+  Entry* entry = m->Find(name);
+  if (entry == nullptr || entry->registry.load(std::memory_order_relaxed) == nullptr) return false;
+  entry->registry.store(nullptr, std::memory_order_release);
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
+  const Entry* entry = Manager::Global()->Find(name);
+  if (entry == nullptr) return nullptr;
+  return Handle(entry).Get();
+}
+
+Registry::Handle Registry::GetHandle(const std::string& name) {
   Manager* m = Manager::Global();
+  if (const Entry* entry = m->Find(name)) return Handle(entry);
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
-  return &(it->second->func_);
+  return Handle(m->FindOrCreate(name));
+}
+
+const PackedFunc* Registry::Handle::Get() const {
+  Registry* r = entry_->registry.load(std::memory_order_acquire);
+  return r == nullptr ? nullptr : &(r->func_);
 }
 
+const std::string& Registry::Handle::name() const { return entry_->name; }
+
 std::vector<std::string> Registry::ListNames() {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
   std::vector<std::string> keys;
-  keys.reserve(m->fmap.size());
-  for (const auto& kv : m->fmap) {
-    keys.push_back(kv.first);
+  keys.reserve(m->entries.size());
+  for (const Entry* entry : m->entries) {
+    if (entry->registry.load(std::memory_order_relaxed) != nullptr) {
+      keys.push_back(entry->name);
+    }
   }
   return keys;
 }
@@ -0,0 +1,253 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file result_cache.h
+ * \brief Byte bounded LRU cache of the outputs of subgraphs, keyed by their input tensors.
+ */
+#ifndef TVM_RUNTIME_RESULT_CACHE_H_
+#define TVM_RUNTIME_RESULT_CACHE_H_
+
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief Memoization of the outputs of the subgraphs of an executor.
+ *
+ *  An entry is keyed by the subgraph, a slot chosen by the executor, and by a
+ *  64 bit hash of the shape, type and content of the input tensors of the
+ *  subgraph. The inputs are kept in the entry and compared on a hit, so hash
+ *  collisions are misses. The entries are evicted in LRU order once their
+ *  tensors, inputs included, exceed the byte budget.
+ *
+ * \note The cached outputs are shared with the executor, they must not be
+ *  written to.
+ */
+class ResultCache {
+ public:
+  /*!
+   * \brief Set the byte budget, clearing the cache and the statistics.
+   * \param max_bytes The budget, 0 disables the cache.
+   */
+  void Configure(int64_t max_bytes) {
+    ICHECK_GE(max_bytes, 0) << "result cache size must not be negative";
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+    hits_ = misses_ = evictions_ = 0;
+  }
+
+  bool enabled() const { return max_bytes_ > 0; }
+
+  /*!
+   * \brief Collect the tensors of a value, tensors and tuples of them.
+   * \return Whether the value only holds tensors.
+   */
+  static bool CollectTensors(const ObjectRef& value, std::vector<NDArray>* tensors) {
+    if (const auto* arr = value.as<NDArray::ContainerType>()) {
+      tensors->push_back(GetRef<NDArray>(arr));
+      return true;
+    }
+    if (const auto* adt = value.as<ADTObj>()) {
+      for (size_t i = 0; i < adt->size; ++i) {
+        if (!CollectTensors((*adt)[i], tensors)) return false;
+      }
+      return true;
+    }
+    if (const auto* arr = value.as<ArrayNode>()) {
+      for (const ObjectRef& elem : *arr) {
+        if (!CollectTensors(elem, tensors)) return false;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Look the outputs of a subgraph up.
+   * \param slot The subgraph.
+   * \param inputs The input tensors of the subgraph, on any device.
+   * \param key The hash of the inputs, to insert the outputs with on a miss.
+   * \param value The cached outputs on a hit.
+   * \return Whether the outputs were cached.
+   */
+  bool Lookup(int64_t slot, const std::vector<NDArray>& inputs, uint64_t* key, ObjectRef* value) {
+    std::vector<NDArray> host = ToHost(inputs);
+    *key = Hash(slot, host);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(*key);
+    if (it != index_.end() && it->second->slot == slot && Equal(it->second->inputs, host)) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      *value = it->second->value;
+      ++hits_;
+      return true;
+    }
+    ++misses_;
+    return false;
+  }
+
+  /*!
+   * \brief Insert the outputs of a subgraph after a miss.
+   * \param slot The subgraph.
+   * \param key The hash given by Lookup.
+   * \param inputs The input tensors of the subgraph, copied in the entry.
+   * \param value The outputs, kept as is.
+   */
+  void Insert(int64_t slot, uint64_t key, const std::vector<NDArray>& inputs,
+              const ObjectRef& value) {
+    Entry entry;
+    entry.slot = slot;
+    entry.key = key;
+    entry.value = value;
+    std::vector<NDArray> outputs;
+    if (!CollectTensors(value, &outputs)) return;
+    for (const NDArray& input : inputs) {
+      entry.inputs.push_back(input.CopyTo(Device{kDLCPU, 0}));
+      entry.bytes += GetDataSize(*input.operator->());
+    }
+    for (const NDArray& output : outputs) entry.bytes += GetDataSize(*output.operator->());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entry.bytes > static_cast<size_t>(max_bytes_)) return;
+    auto it = index_.find(key);
+    if (it != index_.end()) Erase(it->second);
+    while (!lru_.empty() && bytes_ + entry.bytes > static_cast<size_t>(max_bytes_)) {
+      Erase(std::prev(lru_.end()));
+      ++evictions_;
+    }
+    bytes_ += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_[key] = lru_.begin();
+  }
+
+  /*! \brief The statistics as a JSON object. */
+  std::string StatsJSON() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t lookups = hits_ + misses_;
+    std::ostringstream os;
+    os << "{\"max_bytes\": " << max_bytes_ << ", \"bytes\": " << bytes_
+       << ", \"entries\": " << lru_.size() << ", \"hits\": " << hits_
+       << ", \"misses\": " << misses_ << ", \"evictions\": " << evictions_
+       << ", \"hit_rate\": " << (lookups == 0 ? 0.0 : static_cast<double>(hits_) / lookups)
+       << "}";
+    return os.str();
+  }
+
+ private:
+  struct Entry {
+    int64_t slot;
+    uint64_t key;
+    /*! \brief The inputs, on the host. */
+    std::vector<NDArray> inputs;
+    ObjectRef value;
+    size_t bytes{0};
+  };
+
+  static std::vector<NDArray> ToHost(const std::vector<NDArray>& inputs) {
+    std::vector<NDArray> host;
+    for (const NDArray& input : inputs) {
+      ICHECK(input.IsContiguous()) << "the inputs of a cached subgraph must be contiguous";
+      host.push_back(input->device.device_type == kDLCPU ? input
+                                                         : input.CopyTo(Device{kDLCPU, 0}));
+    }
+    return host;
+  }
+
+  /*! \brief Hash the tensors 8 bytes at a time, the hash does not need to be strong. */
+  static uint64_t Hash(int64_t slot, const std::vector<NDArray>& host) {
+    constexpr uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+    uint64_t h = static_cast<uint64_t>(slot) * kMul;
+    auto mix = [&h](uint64_t word) {
+      h ^= word * kMul;
+      h = ((h << 31) | (h >> 33)) * 0xC2B2AE3D27D4EB4FULL;
+    };
+    for (const NDArray& arr : host) {
+      const DLTensor* t = arr.operator->();
+      mix((static_cast<uint64_t>(t->dtype.code) << 24) | (t->dtype.bits << 16) | t->dtype.lanes);
+      for (int i = 0; i < t->ndim; ++i) mix(static_cast<uint64_t>(t->shape[i]));
+      size_t size = GetDataSize(*t);
+      const char* data = static_cast<const char*>(t->data) + t->byte_offset;
+      size_t i = 0;
+      for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        mix(word);
+      }
+      uint64_t tail = 0;
+      std::memcpy(&tail, data + i, size - i);
+      mix(tail ^ size);
+    }
+    return h;
+  }
+
+  static bool Equal(const std::vector<NDArray>& a, const std::vector<NDArray>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+      const DLTensor* x = a[i].operator->();
+      const DLTensor* y = b[i].operator->();
+      if (x->ndim != y->ndim || x->dtype.code != y->dtype.code || x->dtype.bits != y->dtype.bits ||
+          x->dtype.lanes != y->dtype.lanes ||
+          !std::equal(x->shape, x->shape + x->ndim, y->shape)) {
+        return false;
+      }
+      if (std::memcmp(static_cast<const char*>(x->data) + x->byte_offset,
+                      static_cast<const char*>(y->data) + y->byte_offset, GetDataSize(*x)) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void Erase(std::list<Entry>::iterator it) {
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    lru_.erase(it);
+  }
+
+  int64_t max_bytes_{0};
+  /*! \brief The entries, most recently used first. */
+  std::list<Entry> lru_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+  size_t bytes_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t evictions_{0};
+  mutable std::mutex mutex_;
+};
+
+}  // namespace runtime
+}  // namespace tvm
+#endif  // TVM_RUNTIME_RESULT_CACHE_H_
@@ -27,6 +27,18 @@
 namespace tvm {
 namespace runtime {
 
+void RPCChannel::SendAll(const std::vector<std::pair<const void*, size_t>>& bufs) {
+  for (const auto& buf : bufs) {
+    const char* data = static_cast<const char*>(buf.first);
+    size_t ndone = 0;
+    while (ndone < buf.second) {
+      size_t n = this->Send(data + ndone, buf.second - ndone);
+      ICHECK_NE(n, 0U) << "RPCChannel::SendAll: channel closed";
+      ndone += n;
+    }
+  }
+}
+
 size_t CallbackChannel::Send(const void* data, size_t size) {
   TVMByteArray bytes;
   bytes.data = static_cast<const char*>(data);
@@ -27,6 +27,7 @@
 #include <tvm/runtime/packed_func.h>
 
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace runtime {
@@ -53,6 +54,15 @@ class RPCChannel {
    * \return The actual bytes received.
    */
   virtual size_t Recv(void* data, size_t size) = 0;
+  /*!
+   * \brief Send all the bytes of several buffers, in order.
+   *
+   *  Used to send large payloads from their memory, the default implementation
+   *  sends the buffers one after another. Channels can override it with a gather write.
+   *
+   * \param bufs The data pointer and size of each buffer.
+   */
+  virtual void SendAll(const std::vector<std::pair<const void*, size_t>>& bufs);
 };
 
 /*!
@@ -57,12 +57,14 @@ namespace runtime {
 class RPCEndpoint::EventHandler : public dmlc::Stream {
  public:
   EventHandler(support::RingBuffer* reader, support::RingBuffer* writer, std::string name,
-               std::string* remote_key, std::function<void()> flush_writer)
+               std::string* remote_key, std::function<void()> flush_writer,
+               std::function<void(const void*, size_t)> send_with_data)
       : reader_(reader),
         writer_(writer),
         name_(name),
         remote_key_(remote_key),
-        flush_writer_(flush_writer) {
+        flush_writer_(flush_writer),
+        send_with_data_(send_with_data) {
     this->Clear();
 
     if (*remote_key == "%toinit") {
@@ -390,14 +392,20 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     this->Read(&data_bytes);
     size_t elem_bytes = (arr->dtype.bits * arr->dtype.lanes + 7) / 8;
     auto* sess = GetServingSession();
+    // The event driven server never writes to the channel by itself.
+    bool send_with_data = !async_server_mode_;
     // Return Copy Ack with the given data
-    auto fcopyack = [this](char* dptr, size_t num_bytes) {
+    auto fcopyack = [this, send_with_data](char* dptr, size_t num_bytes) {
       RPCCode code = RPCCode::kCopyAck;
       uint64_t packet_nbytes = sizeof(code) + num_bytes;
 
       this->Write(packet_nbytes);
       this->Write(code);
-      this->WriteArray(dptr, num_bytes);
+      if (send_with_data) {
+        send_with_data_(dptr, num_bytes);
+      } else {
+        this->WriteArray(dptr, num_bytes);
+      }
       this->SwitchToState(kRecvPacketNumBytes);
     };
 
@@ -619,8 +627,13 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   std::string* remote_key_;
   // function to flush the writer.
   std::function<void()> flush_writer_;
+  // function to flush the writer followed by a payload sent from its memory.
+  std::function<void(const void*, size_t)> send_with_data_;
 };
 
+// The number of calls sent without waiting before the client receives the oldest return.
+const int kRPCMaxInFlightCalls = 64;
+
 RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn) {
   RPCCode code = RPCCode::kCallFunc;
   while (code != RPCCode::kReturn && code != RPCCode::kShutdown && code != RPCCode::kCopyAck) {
@@ -657,12 +670,16 @@ void RPCEndpoint::Init() {
     }
   };
 
+  auto send_with_data = [this](const void* data, size_t size) { SendWithData(data, size); };
+
   // Event handler
-  handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
+  handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer,
+                                            send_with_data);
 
   // Quick function to for syscall remote.
   syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
     std::lock_guard<std::mutex> lock(mutex_);
+    ReceivePendingCalls(next_call_id_);
     RPCCode code = static_cast<RPCCode>(all_args[0].operator int());
     TVMArgs args(all_args.values + 1, all_args.type_codes + 1, all_args.num_args - 1);
 
@@ -724,6 +741,21 @@ void RPCEndpoint::Shutdown() {
   }
 }
 
+void RPCEndpoint::SendWithData(const void* data, size_t size) {
+  std::vector<std::pair<const void*, size_t>> bufs;
+  // The buffered bytes stay valid until the next write to the writer.
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback(
+        [&bufs](const void* ptr, size_t n) {
+          bufs.emplace_back(ptr, n);
+          return n;
+        },
+        writer_.bytes_available());
+  }
+  bufs.emplace_back(data, size);
+  channel_->SendAll(bufs);
+}
+
 void RPCEndpoint::ServerLoop() {
   if (const auto* f = Registry::Get("tvm.rpc.server.start")) {
     (*f)();
@@ -755,6 +787,7 @@ int RPCEndpoint::ServerAsyncIOEventHandler(const std::string& in_bytes, int even
 
 void RPCEndpoint::InitRemoteSession(TVMArgs args) {
   std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCalls(next_call_id_);
   RPCCode code = RPCCode::kInitServer;
   std::string protocol_ver = kRPCProtocolVer;
   uint64_t length = protocol_ver.length();
@@ -774,12 +807,8 @@ void RPCEndpoint::InitRemoteSession(TVMArgs args) {
   ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
 }
 
-// Get remote function with name
-void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
-                           const int* arg_type_codes, int num_args,
-                           RPCSession::FEncodeReturn encode_return) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
+void RPCEndpoint::WriteCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                const int* arg_type_codes, int num_args) {
   handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
   RPCCode code = RPCCode::kCallFunc;
   uint64_t handle = reinterpret_cast<uint64_t>(h);
@@ -792,51 +821,150 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   handler_->Write(code);
   handler_->Write(handle);
   handler_->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
+}
+
+// Get remote function with name
+void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                           const int* arg_type_codes, int num_args,
+                           RPCSession::FEncodeReturn encode_return) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCalls(next_call_id_);
 
-  code = HandleUntilReturnEvent(true, encode_return);
+  WriteCallFunc(h, arg_values, arg_type_codes, num_args);
+  RPCCode code = HandleUntilReturnEvent(true, encode_return);
   ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+uint64_t RPCEndpoint::SendCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                   const int* arg_type_codes, int num_args,
+                                   RPCSession::FAsyncCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Bound the returns the server may have to buffer before the client reads them.
+  if (pending_calls_.size() >= static_cast<size_t>(kRPCMaxInFlightCalls)) {
+    ReceivePendingCalls(pending_calls_.front().first + 1);
+  }
+
+  WriteCallFunc(h, arg_values, arg_type_codes, num_args);
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+  }
+  uint64_t call_id = next_call_id_++;
+  pending_calls_.emplace_back(call_id, std::move(callback));
+  return call_id;
+}
+
+void RPCEndpoint::WaitCallFunc(uint64_t call_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCalls(call_id + 1);
+}
+
+void RPCEndpoint::ReceivePendingCalls(uint64_t end) {
+  while (!pending_calls_.empty() && pending_calls_.front().first < end) {
+    RPCSession::FAsyncCallback callback = std::move(pending_calls_.front().second);
+    pending_calls_.pop_front();
+    bool returned = false;
+    std::string error;
+    try {
+      RPCCode code = HandleUntilReturnEvent(true, [&](TVMArgs args) {
+        returned = true;
+        callback(RPCCode::kReturn, args);
+      });
+      ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+    } catch (const std::exception& e) {
+      // Errors of the callback itself are not the result of the call.
+      if (returned) throw;
+      error = e.what();
+    }
+    if (!returned) {
+      TVMValue value;
+      value.v_str = error.c_str();
+      int32_t tcode = kTVMStr;
+      callback(RPCCode::kException, TVMArgs(&value, &tcode, 1));
+    }
+  }
+}
+
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                               uint64_t block_size, int max_in_flight) {
   std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCalls(next_call_id_);
   RPCCode code = RPCCode::kCopyToRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
   ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GT(block_size, 0U);
+  ICHECK_GT(max_in_flight, 0);
+
+  DLTensor block = *to;
+  uint64_t num_blocks = (nbytes + block_size - 1) / block_size;
+  uint64_t num_acked = 0;
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    if (i - num_acked == static_cast<uint64_t>(max_in_flight)) {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+      ++num_acked;
+    }
+    uint64_t offset = i * block_size;
+    uint64_t size = std::min(block_size, nbytes - offset);
+    block.byte_offset = to->byte_offset + offset;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(&block, code, size);
+    uint64_t packet_nbytes = overhead + size;
 
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
-  uint64_t packet_nbytes = overhead + nbytes;
-
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, to);
-  handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+    handler_->Write(packet_nbytes);
+    handler_->Write(code);
+    RPCReference::SendDLTensor(handler_, &block);
+    handler_->Write(size);
+    SendWithData(static_cast<char*>(from_bytes) + offset, size);
+  }
+  for (; num_acked < num_blocks; ++num_acked) {
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  }
 }
 
-void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
+void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                 uint64_t block_size, int max_in_flight) {
   std::lock_guard<std::mutex> lock(mutex_);
+  ReceivePendingCalls(next_call_id_);
   RPCCode code = RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
   ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
       << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
       << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GT(block_size, 0U);
+  ICHECK_GT(max_in_flight, 0);
+
+  auto frecv_block = [&](uint64_t i) {
+    uint64_t offset = i * block_size;
+    uint64_t size = std::min(block_size, nbytes - offset);
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+    handler_->ReadArray(static_cast<char*>(to_bytes) + offset, size);
+    handler_->FinishCopyAck();
+  };
 
-  uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
-  uint64_t packet_nbytes = overhead;
-
-  handler_->Write(packet_nbytes);
-  handler_->Write(code);
-  RPCReference::SendDLTensor(handler_, from);
-  handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+  DLTensor block = *from;
+  uint64_t num_blocks = (nbytes + block_size - 1) / block_size;
+  uint64_t num_received = 0;
+  for (uint64_t i = 0; i < num_blocks; ++i) {
+    if (i - num_received == static_cast<uint64_t>(max_in_flight)) {
+      frecv_block(num_received++);
+    }
+    uint64_t size = std::min(block_size, nbytes - i * block_size);
+    block.byte_offset = from->byte_offset + i * block_size;
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(&block, code, size);
+    uint64_t packet_nbytes = overhead;
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
+    handler_->Write(packet_nbytes);
+    handler_->Write(code);
+    RPCReference::SendDLTensor(handler_, &block);
+    handler_->Write(size);
+  }
+  for (; num_received < num_blocks; ++num_received) {
+    frecv_block(num_received);
+  }
 }
 
 // SysCallEventHandler functions
@@ -985,6 +1113,11 @@ void RPCEndpoint::EventHandler::HandleSyscall(RPCCode code) {
   }
 }
 
+// The number of copy packets sent to a server before waiting for the first one.
+const int kRPCMaxInFlightCopies = 4;
+// The payload of a copy packet, the server copies a block while it receives the next ones.
+const uint64_t kRPCCopyBlockBytes = 4 << 20;
+
 /*!
  * \brief RPC client session that proxies all calls to an endpoint.
  */
@@ -1005,30 +1138,21 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     endpoint_->CallFunc(func, arg_values, arg_type_codes, num_args, fencode_return);
   }
 
+  uint64_t SendCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                        const int* arg_type_codes, int num_args, FAsyncCallback callback) final {
+    return endpoint_->SendCallFunc(func, arg_values, arg_type_codes, num_args, callback);
+  }
+
+  void WaitCallFunc(uint64_t call_id) final { endpoint_->WaitCallFunc(call_id); }
+
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
     RPCCode code = RPCCode::kCopyToRemote;
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
-    }
+    uint64_t block_size = std::min(rpc_max_size - overhead, kRPCCopyBlockBytes);
+    endpoint_->CopyToRemote(local_from_bytes, remote_to, nbytes, block_size,
+                            GetRPCMaxInFlightCopies());
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
@@ -1036,25 +1160,9 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
     uint64_t rpc_max_size = GetRPCMaxTransferSize();
     ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
-    }
+    uint64_t block_size = std::min(rpc_max_size - overhead, kRPCCopyBlockBytes);
+    endpoint_->CopyFromRemote(remote_from, local_to_bytes, nbytes, block_size,
+                              GetRPCMaxInFlightCopies());
   }
 
   void FreeHandle(void* handle, int type_code) final {
@@ -1125,27 +1233,36 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
  private:
   uint64_t GetRPCMaxTransferSize() {
     if (rpc_chunk_max_size_bytes_ > 0) {
-      return (uint64_t)rpc_chunk_max_size_bytes_;
+      return rpc_chunk_max_size_bytes_;
     }
 
     PackedFuncHandle rpc_func = GetFunction("tvm.rpc.server.GetCRTMaxPacketSize");
     if (rpc_func == nullptr) {
-      rpc_chunk_max_size_bytes_ = (int64_t)kRPCMaxTransferSizeBytesDefault;
+      rpc_chunk_max_size_bytes_ = kRPCMaxTransferSizeBytesDefault;
     } else {
       CallFunc(rpc_func, nullptr, nullptr, 0, [this](TVMArgs args) {
         // Use args[1] as return value, args[0] is tcode
         // Look at RPCWrappedFunc in src/runtime/rpc/rpc_module.cc
-        rpc_chunk_max_size_bytes_ = (int64_t)args[1];
-        ICHECK_GT(rpc_chunk_max_size_bytes_, 0)
-            << "RPC max transfer size is <= 0! (remote value = " << rpc_chunk_max_size_bytes_
-            << ")";
+        int64_t max_size = args[1];
+        ICHECK_GT(max_size, 0) << "RPC max transfer size is <= 0! (remote value = " << max_size
+                               << ")";
+        rpc_chunk_max_size_bytes_ = static_cast<uint64_t>(max_size);
       });
     }
-    return (uint64_t)rpc_chunk_max_size_bytes_;
+    return rpc_chunk_max_size_bytes_;
+  }
+
+  int GetRPCMaxInFlightCopies() {
+    // The CRT server handles one packet at a time in a fixed size buffer.
+    if (GetRPCMaxTransferSize() != kRPCMaxTransferSizeBytesDefault) {
+      return 1;
+    }
+    return kRPCMaxInFlightCopies;
   }
 
   std::shared_ptr<RPCEndpoint> endpoint_;
-  int64_t rpc_chunk_max_size_bytes_ = -1;
+  // The maximum packet size, 0 until it is queried from the server.
+  uint64_t rpc_chunk_max_size_bytes_ = 0;
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -125,28 +126,55 @@ class RPCEndpoint {
    */
   void CallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
                 const int* arg_type_codes, int num_args, RPCSession::FEncodeReturn encode_return);
+  /*!
+   * \brief Send a call into remote function without waiting for its return.
+   *
+   *  The server handles the requests in order, the returns of the calls in flight are
+   *  received by WaitCallFunc, or before any other request is sent.
+   *
+   * \param handle The function handle
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param callback The callback to pass the return value or exception.
+   * \return The id of the call.
+   */
+  uint64_t SendCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                        const int* arg_type_codes, int num_args,
+                        RPCSession::FAsyncCallback callback);
+  /*!
+   * \brief Receive the returns of the calls in flight, up to the given call.
+   * \param call_id The id returned by SendCallFunc.
+   */
+  void WaitCallFunc(uint64_t call_id);
   /*!
    * \brief Copy bytes into remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   *
+   *  The bytes are sent in packets of at most block_size bytes, straight from the source
+   *  memory. Up to max_in_flight packets are sent before waiting for their acknowledgement.
+   *
+   * \param from_bytes The source host data.
+   * \param to The target array, from its byte offset.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_to The target device.
-   * \param type_hint Hint of content data type.
+   * \param block_size The maximum number of bytes per packet.
+   * \param max_in_flight The maximum number of packets waiting for an acknowledgement.
    */
-  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes, uint64_t block_size,
+                    int max_in_flight);
   /*!
    * \brief Copy bytes from remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   *
+   *  The bytes are requested in packets of at most block_size bytes, up to max_in_flight
+   *  requests are sent before receiving their data.
+   *
+   * \param from The source array, from its byte offset.
+   * \param to_bytes The target host data.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_from The source device.
-   * \param type_hint Hint of content data type.
+   * \param block_size The maximum number of bytes per packet.
+   * \param max_in_flight The maximum number of requests waiting for their data.
    */
-  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes, uint64_t block_size,
+                      int max_in_flight);
 
   /*!
    * \brief Call a remote defined system function with arguments.
@@ -176,6 +204,13 @@ class RPCEndpoint {
   void Init();
   // Shutdown
   void Shutdown();
+  // Send the buffered writes followed by the data, without copying the data to the writer.
+  void SendWithData(const void* data, size_t size);
+  // Write the request of a call into the writer.
+  void WriteCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                     const int* arg_type_codes, int num_args);
+  // Receive the returns of the calls in flight whose id is less than end.
+  void ReceivePendingCalls(uint64_t end);
   // Internal channel.
   std::unique_ptr<RPCChannel> channel_;
   // Internal mutex
@@ -186,6 +221,10 @@ class RPCEndpoint {
   std::shared_ptr<EventHandler> handler_;
   // syscall remote with specified function code.
   PackedFunc syscall_remote_;
+  // The callbacks of the calls in flight, in the order of the calls.
+  std::deque<std::pair<uint64_t, RPCSession::FAsyncCallback>> pending_calls_;
+  // The id of the next call.
+  uint64_t next_call_id_{0};
   // The name of the session.
   std::string name_;
   // The remote key
@@ -26,8 +26,13 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -76,6 +81,14 @@ NDArray NDArrayFromRemoteOpaqueHandle(std::shared_ptr<RPCSession> sess, void* ha
   return NDArray(GetObjectPtr<Object>(data));
 }
 
+class RPCWrappedFunc;
+
+/*! \brief The body of the PackedFunc of a remote function. */
+struct RPCWrappedFuncBody {
+  std::shared_ptr<RPCWrappedFunc> wf;
+  void operator()(TVMArgs args, TVMRetValue* rv) const;
+};
+
 /*!
  * \brief A wrapped remote function as a PackedFunc.
  */
@@ -87,7 +100,80 @@ class RPCWrappedFunc : public Object {
     std::vector<TVMValue> values(args.values, args.values + args.size());
     std::vector<int> type_codes(args.type_codes, args.type_codes + args.size());
     std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
+    RewriteArgsToRemote(args, &values, &type_codes, &temp_dltensors);
+    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
+    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
+  }
+
+  /*!
+   * \brief Send a call of the function without waiting for its return.
+   * \param self The wrapped function.
+   * \param args The arguments.
+   * \return A function that waits for the return of the call and returns its value,
+   *  or raises its error.
+   */
+  static PackedFunc SendCall(std::shared_ptr<RPCWrappedFunc> self, TVMArgs args) {
+    struct CallState {
+      bool done{false};
+      TVMRetValue value;
+      std::string error;
+    };
+    std::vector<TVMValue> values(args.values, args.values + args.size());
+    std::vector<int> type_codes(args.type_codes, args.type_codes + args.size());
+    std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
+    self->RewriteArgsToRemote(args, &values, &type_codes, &temp_dltensors);
+
+    auto state = std::make_shared<CallState>();
+    // The session keeps the callback until the return is received. It only holds a weak
+    // reference to the state, the return of a dropped call is discarded without keeping
+    // the session alive or freeing remote handles from within the session.
+    std::weak_ptr<CallState> weak_state = state;
+    RPCWrappedFunc* wf = self.get();
+    auto callback = [weak_state, wf](RPCCode status, TVMArgs ret) {
+      auto state = weak_state.lock();
+      if (state == nullptr) return;
+      // the waiting function holds both the state and the wrapped function.
+      state->done = true;
+      if (status == RPCCode::kException) {
+        state->error = ret[0].operator std::string();
+      } else {
+        wf->WrapRemoteReturnToValue(ret, &state->value);
+      }
+    };
+    uint64_t call_id = self->sess_->SendCallFunc(self->handle_, values.data(), type_codes.data(),
+                                                 args.size(), callback);
+    return PackedFunc([self, state, call_id](TVMArgs args, TVMRetValue* rv) {
+      if (!state->done) {
+        self->sess_->WaitCallFunc(call_id);
+      }
+      ICHECK(state->done) << "The return of the RPC call is not received";
+      if (!state->error.empty()) {
+        throw Error(state->error);
+      }
+      *rv = state->value;
+    });
+  }
+
+  ~RPCWrappedFunc() {
+    try {
+      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
+    } catch (const Error& e) {
+      // fault tolerance to remote close
+    }
+  }
+
+ private:
+  // remote function handle
+  void* handle_{nullptr};
+  // pointer to the session.
+  std::shared_ptr<RPCSession> sess_;
 
+  // rewrite the arguments to their remote variant, the DLTensors are kept in temp_dltensors.
+  void RewriteArgsToRemote(TVMArgs args, std::vector<TVMValue>* values_ptr,
+                           std::vector<int>* type_codes_ptr,
+                           std::vector<std::unique_ptr<DLTensor>>* temp_dltensors) const {
+    std::vector<TVMValue>& values = *values_ptr;
+    std::vector<int>& type_codes = *type_codes_ptr;
     // scan and check whether we need rewrite these arguments
     // to their remote variant.
     for (int i = 0; i < args.size(); ++i) {
@@ -109,7 +195,7 @@ class RPCWrappedFunc : public Object {
           dptr->device = RemoveSessMask(dptr->device);
           dptr->data = static_cast<RemoteSpace*>(dptr->data)->data;
           values[i].v_handle = dptr.get();
-          temp_dltensors.emplace_back(std::move(dptr));
+          temp_dltensors->emplace_back(std::move(dptr));
           break;
         }
         case kDLDevice: {
@@ -123,24 +209,7 @@ class RPCWrappedFunc : public Object {
         }
       }
     }
-    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
-    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
   }
-
-  ~RPCWrappedFunc() {
-    try {
-      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
-    } catch (const Error& e) {
-      // fault tolerance to remote close
-    }
-  }
-
- private:
-  // remote function handle
-  void* handle_{nullptr};
-  // pointer to the session.
-  std::shared_ptr<RPCSession> sess_;
-
   // unwrap a remote value to the underlying handle.
   void* UnwrapRemoteValueToHandle(const TVMArgValue& arg) const;
   // wrap a remote return via Set
@@ -189,13 +258,27 @@ class RPCModuleNode final : public ModuleNode {
   }
 
   PackedFunc GetTimeEvaluator(const std::string& name, Device dev, int number, int repeat,
-                              int min_repeat_ms, const std::string& f_preproc_name) {
-    InitRemoteFunc(&remote_get_time_evaluator_, "runtime.RPCTimeEvaluator");
+                              int min_repeat_ms, const std::string& f_preproc_name,
+                              int max_repeat = 0, double max_rel_ci = 0, int warmup = 1,
+                              double cutoff = 0) {
     // Remove session mask because we pass dev by parts.
     ICHECK_EQ(GetRPCSessionIndex(dev), sess_->table_index())
         << "ValueError: Need to pass the matched remote device to RPCModule.GetTimeEvaluator";
     dev = RemoveRPCSessionMask(dev);
 
+    Optional<Module> mod;
+    if (module_handle_ != nullptr) {
+      mod = GetRef<Module>(this);
+    }
+    if (max_repeat > 0 || warmup != 1 || cutoff > 0) {
+      // The servers without the adaptive evaluator still support the fixed one.
+      InitRemoteFunc(&remote_get_robust_time_evaluator_, "runtime.RPCRobustTimeEvaluator");
+      return remote_get_robust_time_evaluator_(mod, name, static_cast<int>(dev.device_type),
+                                               dev.device_id, number, repeat, min_repeat_ms,
+                                               f_preproc_name, max_repeat, max_rel_ci, warmup,
+                                               cutoff);
+    }
+    InitRemoteFunc(&remote_get_time_evaluator_, "runtime.RPCTimeEvaluator");
     if (module_handle_ != nullptr) {
       return remote_get_time_evaluator_(GetRef<Module>(this), name,
                                         static_cast<int>(dev.device_type), dev.device_id, number,
@@ -233,7 +316,7 @@ class RPCModuleNode final : public ModuleNode {
   PackedFunc WrapRemoteFunc(RPCSession::PackedFuncHandle handle) {
     if (handle == nullptr) return PackedFunc();
     auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    return PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    return PackedFunc(RPCWrappedFuncBody{wf});
   }
 
   // The module handle
@@ -243,6 +326,10 @@ class RPCModuleNode final : public ModuleNode {
   // remote function to get time evaluator
   TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, std::string)>
       remote_get_time_evaluator_;
+  // remote function to get the adaptive time evaluator
+  TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, std::string,
+                             int, double, int, double)>
+      remote_get_robust_time_evaluator_;
   // remote function getter for modules.
   TypedPackedFunc<PackedFunc(Module, std::string, bool)> remote_mod_get_function_;
   // remote function getter for load module
@@ -251,6 +338,10 @@ class RPCModuleNode final : public ModuleNode {
   TypedPackedFunc<void(Module, Module)> remote_import_module_;
 };
 
+void RPCWrappedFuncBody::operator()(TVMArgs args, TVMRetValue* rv) const {
+  wf->operator()(args, rv);
+}
+
 void* RPCWrappedFunc::UnwrapRemoteValueToHandle(const TVMArgValue& arg) const {
   if (arg.type_code() == kTVMModuleHandle) {
     Module mod = arg;
@@ -275,7 +366,7 @@ void RPCWrappedFunc::WrapRemoteReturnToValue(TVMArgs args, TVMRetValue* rv) cons
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
     auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    *rv = PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    *rv = PackedFunc(RPCWrappedFuncBody{wf});
   } else if (tcode == kTVMModuleHandle) {
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
@@ -335,15 +426,88 @@ inline void CPUCacheFlushImpl(const char* addr, unsigned int len) {
 #endif
 }
 
+/*!
+ * \brief Evict the CPU caches by writing over a buffer larger than the last level cache.
+ *
+ * Unlike the flush of the arguments, this also evicts the data the function reads besides its
+ * arguments, and works on the CPUs without an instruction to flush a cache line.
+ */
+inline void CPUCacheFlushBuffer() {
+  // Larger than the last level cache of the server CPUs.
+  constexpr size_t kFlushBufferBytes = 64 << 20;
+  constexpr size_t kCacheLine = 64;
+  static thread_local std::vector<char> buffer(kFlushBufferBytes);
+  volatile char* data = buffer.data();
+  for (size_t i = 0; i < kFlushBufferBytes; i += kCacheLine) {
+    data[i] = data[i] + 1;
+  }
+}
+
 inline void CPUCacheFlush(int begin_index, const TVMArgs& args) {
+#if (defined(_M_X64) || defined(__x86_64__))
   for (int i = begin_index; i < args.size(); i++) {
     CPUCacheFlushImpl(static_cast<char*>((args[i].operator DLTensor*()->data)),
                       GetDataSize(*(args[i].operator DLTensor*())));
   }
+#else
+  CPUCacheFlushBuffer();
+#endif
+}
+
+/*!
+ * \brief The relative half width of the 95% confidence interval of the mean of the costs.
+ *
+ * The outliers, outside of the Tukey fences 1.5 interquartile ranges away from the quartiles, are
+ * rejected first, as tvm.runtime.module.RobustProfileResult does.
+ */
+double RelativeConfidenceInterval(std::vector<double> costs) {
+  if (costs.size() < 2) {
+    return std::numeric_limits<double>::infinity();
+  }
+  std::sort(costs.begin(), costs.end());
+  auto quantile = [&costs](double q) {
+    double pos = q * (costs.size() - 1);
+    size_t lower = static_cast<size_t>(pos);
+    size_t upper = std::min(lower + 1, costs.size() - 1);
+    return costs[lower] + (pos - lower) * (costs[upper] - costs[lower]);
+  };
+  double q1 = quantile(0.25);
+  double q3 = quantile(0.75);
+  double low = q1 - 1.5 * (q3 - q1);
+  double high = q3 + 1.5 * (q3 - q1);
+  std::vector<double> kept;
+  for (double cost : costs) {
+    if (cost >= low && cost <= high) kept.push_back(cost);
+  }
+  if (kept.size() < 2) {
+    return std::numeric_limits<double>::infinity();
+  }
+  double mean = 0;
+  for (double cost : kept) mean += cost;
+  mean /= kept.size();
+  double var = 0;
+  for (double cost : kept) var += (cost - mean) * (cost - mean);
+  var /= kept.size() - 1;
+  // The normal quantile, the t one being close enough past a few repeats.
+  return 1.96 * std::sqrt(var / kept.size()) / mean;
+}
+
+/*! \brief Warn once when the frequency of the CPUs can change while measuring. */
+void WarnCPUFrequencyScaling() {
+  static bool warned = false;
+  if (warned) return;
+  warned = true;
+  std::ifstream governor("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+  std::string name;
+  if (governor >> name && name != "performance") {
+    LOG(WARNING) << "The CPU frequency governor is \"" << name << "\" instead of \"performance\", "
+                 << "the frequency changes during the measurement make the costs noisy";
+  }
 }
 
 PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat, int min_repeat_ms,
-                             PackedFunc f_preproc) {
+                             PackedFunc f_preproc, int max_repeat, double max_rel_ci, int warmup,
+                             double cutoff) {
   ICHECK(pf != nullptr);
 
   if (static_cast<int>(dev.device_type) == static_cast<int>(kDLMicroDev)) {
@@ -352,16 +516,32 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
     return (*get_micro_time_evaluator)(pf, dev, number, repeat);
   }
 
-  auto ftimer = [pf, dev, number, repeat, min_repeat_ms, f_preproc](TVMArgs args,
-                                                                    TVMRetValue* rv) mutable {
+  if (max_repeat > 0 && dev.device_type == kDLCPU) {
+    WarnCPUFrequencyScaling();
+  }
+
+  auto ftimer = [pf, dev, number, repeat, min_repeat_ms, f_preproc, max_repeat, max_rel_ci, warmup,
+                 cutoff](TVMArgs args, TVMRetValue* rv) mutable {
     TVMRetValue temp;
     std::ostringstream os;
-    // skip first time call, to activate lazy compilation components.
-    pf.CallPacked(args, &temp);
+    // skip the first calls, to activate lazy compilation components and warm up the device.
+    for (int i = 0; i < warmup; ++i) {
+      pf.CallPacked(args, &temp);
+    }
 
     DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
 
-    for (int i = 0; i < repeat; ++i) {
+    // Past the `repeat` measurements, repeat until the confidence interval is narrow enough.
+    std::vector<double> costs;
+    // A function slower than the cutoff is not measured further, the cost reported is enough to
+    // tell it loses against the one the cutoff is derived from.
+    auto over_cutoff = [cutoff](double duration_ms, int number) {
+      return cutoff > 0 && duration_ms / 1e3 / number > cutoff;
+    };
+    auto keep_repeating = [&](int i) {
+      return i < repeat || (i < max_repeat && RelativeConfidenceInterval(costs) > max_rel_ci);
+    };
+    for (int i = 0; keep_repeating(i); ++i) {
       if (f_preproc != nullptr) {
         f_preproc.CallPacked(args, &temp);
       }
@@ -381,10 +561,12 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
         t->Stop();
         int64_t t_nanos = t->SyncAndGetElapsedNanos();
         duration_ms = t_nanos / 1e6;
-      } while (duration_ms < min_repeat_ms);
+      } while (duration_ms < min_repeat_ms && !over_cutoff(duration_ms, number));
 
       double speed = duration_ms / 1e3 / number;
       os.write(reinterpret_cast<char*>(&speed), sizeof(speed));
+      costs.push_back(speed);
+      if (over_cutoff(duration_ms, number)) break;
     }
 
     std::string blob = os.str();
@@ -397,47 +579,53 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
   return PackedFunc(ftimer);
 }
 
+/*! \brief Get the time evaluator of a function of a module, or of a global function. */
+PackedFunc GetTimeEvaluator(Optional<Module> opt_mod, std::string name, int device_type,
+                            int device_id, int number, int repeat, int min_repeat_ms,
+                            std::string f_preproc_name, int max_repeat, double max_rel_ci,
+                            int warmup, double cutoff) {
+  Device dev;
+  dev.device_type = static_cast<DLDeviceType>(device_type);
+  dev.device_id = device_id;
+  if (opt_mod.defined() && opt_mod.value()->type_key() == std::string("rpc")) {
+    Module m = opt_mod.value();
+    return static_cast<RPCModuleNode*>(m.operator->())
+        ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms, f_preproc_name, max_repeat,
+                           max_rel_ci, warmup, cutoff);
+  }
+  PackedFunc f_preproc;
+  if (!f_preproc_name.empty()) {
+    auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
+    ICHECK(pf_preproc != nullptr) << "Cannot find " << f_preproc_name << " in the global function";
+    f_preproc = *pf_preproc;
+  }
+  if (opt_mod.defined()) {
+    return WrapTimeEvaluator(opt_mod.value().GetFunction(name, false), dev, number, repeat,
+                             min_repeat_ms, f_preproc, max_repeat, max_rel_ci, warmup, cutoff);
+  }
+  auto* pf = runtime::Registry::Get(name);
+  ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
+  return WrapTimeEvaluator(*pf, dev, number, repeat, min_repeat_ms, f_preproc, max_repeat,
+                           max_rel_ci, warmup, cutoff);
+}
+
 TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
     .set_body_typed([](Optional<Module> opt_mod, std::string name, int device_type, int device_id,
                        int number, int repeat, int min_repeat_ms, std::string f_preproc_name) {
-      Device dev;
-      dev.device_type = static_cast<DLDeviceType>(device_type);
-      dev.device_id = device_id;
-      if (opt_mod.defined()) {
-        Module m = opt_mod.value();
-        std::string tkey = m->type_key();
-        if (tkey == "rpc") {
-          return static_cast<RPCModuleNode*>(m.operator->())
-              ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms, f_preproc_name);
-        } else {
-          PackedFunc f_preproc;
-          if (!f_preproc_name.empty()) {
-            auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-            ICHECK(pf_preproc != nullptr)
-                << "Cannot find " << f_preproc_name << " in the global function";
-            f_preproc = *pf_preproc;
-          }
-          return WrapTimeEvaluator(m.GetFunction(name, false), dev, number, repeat, min_repeat_ms,
-                                   f_preproc);
-        }
-      } else {
-        auto* pf = runtime::Registry::Get(name);
-        ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
-        PackedFunc f_preproc;
-        if (!f_preproc_name.empty()) {
-          auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-          ICHECK(pf_preproc != nullptr)
-              << "Cannot find " << f_preproc_name << " in the global function";
-          f_preproc = *pf_preproc;
-        }
-        return WrapTimeEvaluator(*pf, dev, number, repeat, min_repeat_ms, f_preproc);
-      }
+      return GetTimeEvaluator(opt_mod, name, device_type, device_id, number, repeat,
+                              min_repeat_ms, f_preproc_name, 0, 0, 1, 0);
     });
 
+TVM_REGISTER_GLOBAL("runtime.RPCRobustTimeEvaluator").set_body_typed(GetTimeEvaluator);
+
 TVM_REGISTER_GLOBAL("cache_flush_cpu_non_first_arg").set_body([](TVMArgs args, TVMRetValue* rv) {
   CPUCacheFlush(1, args);
 });
 
+TVM_REGISTER_GLOBAL("cache_flush_cpu_buffer").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CPUCacheFlushBuffer();
+});
+
 // server function registration.
 TVM_REGISTER_GLOBAL("tvm.rpc.server.ImportModule").set_body_typed([](Module parent, Module child) {
   parent->Import(child);
@@ -449,6 +637,15 @@ TVM_REGISTER_GLOBAL("tvm.rpc.server.ModuleGetFunction")
     });
 
 // functions to access an RPC module.
+TVM_REGISTER_GLOBAL("rpc.SendCall").set_body([](TVMArgs args, TVMRetValue* rv) {
+  PackedFunc func = args[0];
+  PackedFunc::FType body = func.body();
+  const auto* remote = body.target<RPCWrappedFuncBody>();
+  ICHECK(remote != nullptr) << "ValueError: Can only send calls to a remote function";
+  *rv = RPCWrappedFunc::SendCall(remote->wf,
+                                 TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1));
+});
+
 TVM_REGISTER_GLOBAL("rpc.LoadRemoteModule").set_body_typed([](Module sess, std::string name) {
   std::string tkey = sess->type_key();
   ICHECK_EQ(tkey, "rpc");
@@ -93,6 +93,15 @@ void RPCSession::AsyncStreamWait(Device dev, TVMStreamHandle stream,
   }
 }
 
+uint64_t RPCSession::SendCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                  const int* arg_type_codes, int num_args,
+                                  FAsyncCallback callback) {
+  this->AsyncCallFunc(func, arg_values, arg_type_codes, num_args, callback);
+  return 0;
+}
+
+void RPCSession::WaitCallFunc(uint64_t call_id) {}
+
 class RPCSessTable {
  public:
   static constexpr int kMaxRPCSession = 32;
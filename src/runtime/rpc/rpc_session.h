@@ -241,6 +241,38 @@ class RPCSession {
    */
   virtual void AsyncStreamWait(Device dev, TVMStreamHandle stream, FAsyncCallback on_compelte);
 
+  // Pipelined calls
+  // These APIs are used by the client to keep several calls in flight.
+  // The remote handles the requests in the order they are sent, so the
+  // returns arrive in the same order and are matched to the calls by it.
+
+  /*!
+   * \brief Send a call to func without waiting for its return.
+   *
+   *  The callback receives the return value or the exception of the call.
+   *  It is invoked from WaitCallFunc, or from any later synchronous request
+   *  of the session, which first receives the returns of the calls in flight.
+   *
+   * \param func The function handle.
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param callback The callback to pass the return value or exception.
+   * \return The id of the call, used to wait for it.
+   *
+   * \note The callback must not call into the session.
+   *   The default implementation calls AsyncCallFunc, so the callback
+   *   is invoked before the function returns.
+   */
+  virtual uint64_t SendCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                const int* arg_type_codes, int num_args, FAsyncCallback callback);
+
+  /*!
+   * \brief Wait until the callback of a call sent by SendCallFunc is invoked.
+   * \param call_id The id returned by SendCallFunc.
+   */
+  virtual void WaitCallFunc(uint64_t call_id);
+
   /*!
    * \return The session table index of the session.
    */
@@ -300,10 +332,20 @@ struct RemoteSpace {
  *        i.e., When the run time of one `repeat` falls below this time,
  *        the `number` parameter will be automatically increased.
  * \param f_preproc The function to be executed before we excetute time evaluator.
+ * \param max_repeat The maximum number of times to repeat the measurement. When it is larger
+ *        than `repeat`, the measurement is repeated past `repeat` until the 95% confidence
+ *        interval of the mean cost, outliers rejected, is within `max_rel_ci` of the mean.
+ *        The result then contains between `repeat` and `max_repeat` costs.
+ * \param max_rel_ci The target half width of the confidence interval, relative to the mean.
+ * \param warmup The number of calls before the measurement, discarded.
+ * \param cutoff The cost in seconds past which the measurement stops, e.g. a multiple of the
+ *        best cost known for the task while tuning. The result then ends with the first cost
+ *        over the cutoff. 0 never stops early.
  * \return f_timer A timer function.
  */
 PackedFunc WrapTimeEvaluator(PackedFunc f, Device dev, int number, int repeat, int min_repeat_ms,
-                             PackedFunc f_preproc = nullptr);
+                             PackedFunc f_preproc = nullptr, int max_repeat = 0,
+                             double max_rel_ci = 0, int warmup = 1, double cutoff = 0);
 
 /*!
  * \brief Create a Global RPC module that refers to the session.
@@ -0,0 +1,285 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_shm_impl.cc
+ * \brief Shared memory RPC channel between the processes of the same host.
+ *
+ *  The client creates a shared memory file holding one ring of bytes per direction,
+ *  and passes it to a server process it starts, like the pipe channel. The bytes are
+ *  copied in and out of the shared pages, a side only sleeps on a futex when it
+ *  waits for the other one.
+ */
+// Linux only, the notification relies on futex.
+#if defined(__linux__)
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rpc_endpoint.h"
+#include "rpc_local_session.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A single producer, single consumer ring of bytes in shared memory. */
+struct ShmRing {
+  /*! \brief The number of bytes written since the creation. */
+  std::atomic<uint64_t> head;
+  /*! \brief The number of bytes read since the creation. */
+  std::atomic<uint64_t> tail;
+  /*! \brief Futex word, changed by every update of head and tail. */
+  std::atomic<uint32_t> seq;
+  /*! \brief The number of sides sleeping on seq. */
+  std::atomic<uint32_t> num_waiters;
+};
+
+/*! \brief The header of the shared memory, followed by the data of the two rings. */
+struct ShmHeader {
+  /*! \brief The capacity in bytes of each ring. */
+  uint64_t capacity;
+  /*! \brief Set when a side closes the channel. */
+  std::atomic<uint32_t> closed;
+  /*! \brief The ring from the client to the server and the one from the server to the client. */
+  ShmRing rings[2];
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "The futex words need to be plain 32 bit integers");
+
+// The offset of the ring data from the start of the shared memory.
+const size_t kShmDataOffset = 4096;
+// The number of polls of a ring before sleeping on its futex.
+const int kShmSpinCount = 4096;
+// The sleep between two checks that the server process is alive, in milliseconds.
+const int kShmWaitTimeoutMs = 100;
+
+class ShmChannel final : public RPCChannel {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param fd The shared memory file.
+   * \param is_server Whether this side is the server.
+   * \param child_pid The server process on the client side, 0 on the server side.
+   */
+  ShmChannel(int fd, bool is_server, pid_t child_pid) : fd_(fd), child_pid_(child_pid) {
+    ICHECK_EQ(pread(fd, &capacity_, sizeof(capacity_), offsetof(ShmHeader, capacity)),
+              static_cast<ssize_t>(sizeof(capacity_)))
+        << "Cannot read the RPC shared memory";
+    ICHECK(capacity_ != 0 && (capacity_ & (capacity_ - 1)) == 0)
+        << "The capacity of the RPC shared memory is not a power of two";
+    size_ = kShmDataOffset + 2 * capacity_;
+    void* base = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ICHECK(base != MAP_FAILED) << "Cannot map the RPC shared memory: " << strerror(errno);
+    header_ = static_cast<ShmHeader*>(base);
+    char* data = static_cast<char*>(base) + kShmDataOffset;
+    send_ring_ = &header_->rings[is_server ? 1 : 0];
+    recv_ring_ = &header_->rings[is_server ? 0 : 1];
+    send_data_ = data + (is_server ? capacity_ : 0);
+    recv_data_ = data + (is_server ? 0 : capacity_);
+  }
+
+  ~ShmChannel() { Close(); }
+
+  size_t Send(const void* data, size_t size) final {
+    uint64_t head = send_ring_->head.load(std::memory_order_relaxed);
+    uint64_t space = 0;
+    if (!Wait(send_ring_, [&]() {
+          space = capacity_ - (head - send_ring_->tail.load(std::memory_order_acquire));
+          return space != 0;
+        })) {
+      LOG(FATAL) << "Shared memory channel closed while sending";
+    }
+    size_t n = static_cast<size_t>(std::min<uint64_t>(size, space));
+    size_t offset = static_cast<size_t>(head & (capacity_ - 1));
+    size_t first = std::min(n, static_cast<size_t>(capacity_) - offset);
+    memcpy(send_data_ + offset, data, first);
+    memcpy(send_data_, static_cast<const char*>(data) + first, n - first);
+    send_ring_->head.store(head + n, std::memory_order_release);
+    Notify(send_ring_);
+    return n;
+  }
+
+  size_t Recv(void* data, size_t size) final {
+    uint64_t tail = recv_ring_->tail.load(std::memory_order_relaxed);
+    uint64_t avail = 0;
+    if (!Wait(recv_ring_, [&]() {
+          avail = recv_ring_->head.load(std::memory_order_acquire) - tail;
+          return avail != 0;
+        })) {
+      // closed, as a stream that reaches its end.
+      return 0;
+    }
+    size_t n = static_cast<size_t>(std::min<uint64_t>(size, avail));
+    size_t offset = static_cast<size_t>(tail & (capacity_ - 1));
+    size_t first = std::min(n, static_cast<size_t>(capacity_) - offset);
+    memcpy(data, recv_data_ + offset, first);
+    memcpy(static_cast<char*>(data) + first, recv_data_, n - first);
+    recv_ring_->tail.store(tail + n, std::memory_order_release);
+    Notify(recv_ring_);
+    return n;
+  }
+
+  void Close() {
+    if (header_ == nullptr) return;
+    header_->closed.store(1);
+    for (ShmRing& ring : header_->rings) {
+      ring.seq.fetch_add(1);
+      Futex(&ring.seq, FUTEX_WAKE, INT32_MAX, nullptr);
+    }
+    munmap(header_, size_);
+    close(fd_);
+    header_ = nullptr;
+    if (child_pid_ != 0) {
+      kill(child_pid_, SIGKILL);
+      waitpid(child_pid_, nullptr, 0);
+    }
+  }
+
+ private:
+  static long Futex(std::atomic<uint32_t>* addr, int op, uint32_t val,  // NOLINT(*)
+                    const struct timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, timeout, nullptr, 0);
+  }
+
+  /*!
+   * \brief Wait until the ring is ready.
+   * \param ring The ring.
+   * \param fready Check whether the ring is ready.
+   * \return false when the channel is closed before the ring is ready.
+   */
+  template <typename FReady>
+  bool Wait(ShmRing* ring, FReady fready) {
+    for (int i = 0; i < kShmSpinCount; ++i) {
+      if (fready()) return true;
+    }
+    while (true) {
+      uint32_t seq = ring->seq.load();
+      ring->num_waiters.fetch_add(1);
+      bool ready = fready();
+      if (!ready && !IsClosed()) {
+        struct timespec timeout = {0, kShmWaitTimeoutMs * 1000000L};
+        Futex(&ring->seq, FUTEX_WAIT, seq, &timeout);
+      }
+      ring->num_waiters.fetch_sub(1);
+      if (ready || fready()) return true;
+      if (IsClosed()) return false;
+    }
+  }
+
+  // Wake the other side if it sleeps on the ring.
+  void Notify(ShmRing* ring) {
+    ring->seq.fetch_add(1);
+    if (ring->num_waiters.load() != 0) {
+      Futex(&ring->seq, FUTEX_WAKE, INT32_MAX, nullptr);
+    }
+  }
+
+  // Whether the other side closed the channel, or the server process exited.
+  bool IsClosed() {
+    if (header_->closed.load() != 0) return true;
+    if (child_pid_ != 0 && waitpid(child_pid_, nullptr, WNOHANG) == child_pid_) {
+      child_pid_ = 0;
+      header_->closed.store(1);
+      return true;
+    }
+    return false;
+  }
+
+  int fd_;
+  pid_t child_pid_;
+  uint64_t capacity_;
+  size_t size_;
+  ShmHeader* header_{nullptr};
+  ShmRing* send_ring_;
+  ShmRing* recv_ring_;
+  char* send_data_;
+  char* recv_data_;
+};
+
+Module CreateShmClient(uint64_t capacity, std::vector<std::string> cmd) {
+  ICHECK(capacity != 0 && (capacity & (capacity - 1)) == 0)
+      << "ValueError: The capacity of the RPC shared memory must be a power of two";
+  int fd = static_cast<int>(syscall(SYS_memfd_create, "tvm_rpc_shm", 0));
+  ICHECK_GE(fd, 0) << "Cannot create the RPC shared memory: " << strerror(errno);
+  ICHECK_EQ(ftruncate(fd, kShmDataOffset + 2 * capacity), 0)
+      << "Cannot allocate the RPC shared memory: " << strerror(errno);
+  ICHECK_EQ(pwrite(fd, &capacity, sizeof(capacity), 0), static_cast<ssize_t>(sizeof(capacity)));
+
+  pid_t parent_pid = getpid();
+  pid_t pid = fork();
+  if (pid == 0) {
+    // child process, exits with the client.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent_pid) _exit(1);
+    std::string sfd = std::to_string(fd);
+    std::vector<char*> argv;
+    for (auto& str : cmd) {
+      argv.push_back(dmlc::BeginPtr(str));
+    }
+    argv.push_back(dmlc::BeginPtr(sfd));
+    argv.push_back(nullptr);
+    execvp(argv[0], &argv[0]);
+    _exit(1);
+  }
+  ICHECK_GT(pid, 0) << "Cannot start the RPC server process";
+
+  auto endpt = RPCEndpoint::Create(std::unique_ptr<ShmChannel>(new ShmChannel(fd, false, pid)),
+                                   "shm", "shm");
+  endpt->InitRemoteSession(TVMArgs(nullptr, nullptr, 0));
+  return CreateRPCSessionModule(CreateClientSession(endpt));
+}
+
+void ShmServerLoop(int fd) {
+  RPCEndpoint::Create(std::unique_ptr<ShmChannel>(new ShmChannel(fd, true, 0)),
+                      "ShmServerLoop", "")
+      ->ServerLoop();
+}
+
+TVM_REGISTER_GLOBAL("rpc.CreateShmClient").set_body([](TVMArgs args, TVMRetValue* rv) {
+  uint64_t capacity = args[0].operator int64_t();
+  std::vector<std::string> cmd;
+  for (int i = 1; i < args.size(); ++i) {
+    cmd.push_back(args[i].operator std::string());
+  }
+  *rv = CreateShmClient(capacity, cmd);
+});
+
+TVM_REGISTER_GLOBAL("rpc.ShmServerLoop").set_body_typed(ShmServerLoop);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif
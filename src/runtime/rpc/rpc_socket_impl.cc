@@ -24,6 +24,8 @@
 #include <tvm/runtime/registry.h>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "../../support/socket.h"
 #include "rpc_endpoint.h"
@@ -59,6 +61,13 @@ class SockChannel final : public RPCChannel {
     }
     return static_cast<size_t>(n);
   }
+  void SendAll(const std::vector<std::pair<const void*, size_t>>& bufs) final {
+    size_t nbytes = 0;
+    for (const auto& buf : bufs) {
+      nbytes += buf.second;
+    }
+    ICHECK_EQ(sock_.SendAllV(bufs), nbytes) << "SockChannel::SendAll";
+  }
 
  private:
   support::TCPSocket sock_;
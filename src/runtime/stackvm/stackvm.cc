@@ -27,6 +27,7 @@
 #include <tvm/runtime/c_backend_api.h>
 
 #include <algorithm>
+#include <atomic>
 
 namespace tvm {
 namespace runtime {
@@ -35,6 +36,42 @@ typedef dmlc::ThreadLocalStore<StackVM::State> StackVMStateStore;
 
 StackVM::State* StackVM::ThreadLocalState() { return StackVMStateStore::Get(); }
 
+#if defined(__GNUC__)
+#define STACK_VM_COMPUTED_GOTO 1
+#else
+#define STACK_VM_COMPUTED_GOTO 0
+#endif
+
+namespace {
+std::atomic<bool> threaded_dispatch{STACK_VM_COMPUTED_GOTO != 0};
+}  // namespace
+
+void StackVM::SetThreadedDispatch(bool threaded) {
+#if !STACK_VM_COMPUTED_GOTO
+  if (threaded) {
+    LOG(WARNING) << "Threaded dispatch needs computed gotos, falling back to the switch loop";
+  }
+#endif
+  threaded_dispatch = threaded;
+}
+
+#if STACK_VM_COMPUTED_GOTO
+#define STACK_VM_HANDLER(CODE) handler_##CODE:
+// In threaded mode every handler checks the stack and jumps straight to the
+// next one, so that each jump site gets its own branch prediction history.
+#define STACK_VM_DISPATCH()                              \
+  if (threaded) {                                        \
+    ICHECK_GE(sp, alloca_sp) << "touch allocated space"; \
+    ICHECK_LT(sp, stack_cap) << "Stack overflow";        \
+    if (pc >= code_size) return;                         \
+    goto* kHandlers[code[pc].op_code];                   \
+  }                                                      \
+  break
+#else
+#define STACK_VM_HANDLER(CODE)
+#define STACK_VM_DISPATCH() break
+#endif
+
 #define STACK_VM_BINOP(OP, FIELD)                                 \
   {                                                               \
     stack[sp - 1].FIELD = stack[sp - 1].FIELD OP stack[sp].FIELD; \
@@ -87,6 +124,16 @@ StackVM::State* StackVM::ThreadLocalState() { return StackVMStateStore::Get(); }
     return pc + 3;                                                                              \
   }
 
+#define STACK_VM_PRINT_CODE3(CODE)                                                              \
+  case CODE: {                                                                                  \
+    os << "[" << pc << "]\t" << #CODE << " " << code[pc + 1].v_int << " " << code[pc + 2].v_int \
+       << " " << code[pc + 3].v_int << "\n"                                                     \
+       << "[" << pc + 1 << "]" << std::endl                                                     \
+       << "[" << pc + 2 << "]" << std::endl                                                     \
+       << "[" << pc + 3 << "]" << std::endl;                                                    \
+    return pc + 4;                                                                              \
+  }
+
 #define STACK_VM_PRINT_HEAP_ACCESS(CODE)                                  \
   case CODE: {                                                            \
     os << "[" << pc << "]\t" << #CODE << " " << code[pc + 1].v_int << " " \
@@ -103,6 +150,120 @@ StackVM::State* StackVM::ThreadLocalState() { return StackVMStateStore::Get(); }
     return pc + 2;                                                               \
   }
 
+namespace {
+
+// Read a field of a structure, shared by TVM_STRUCT_GET and HEAP_STRUCT_GET.
+inline void StructGet(void* ptr, int index, int kind, TVMValue* dst) {
+  DLTensor* arr = static_cast<DLTensor*>(ptr);
+  switch (kind) {
+    case StackVM::kArrData: {
+      dst->v_handle = arr[index].data;
+      break;
+    }
+    case StackVM::kArrShape: {
+      dst->v_handle = arr[index].shape;
+      break;
+    }
+    case StackVM::kArrStrides: {
+      dst->v_handle = arr[index].strides;
+      break;
+    }
+    case StackVM::kArrNDim: {
+      dst->v_int64 = arr[index].ndim;
+      break;
+    }
+    case StackVM::kArrTypeCode: {
+      dst->v_int64 = static_cast<int64_t>(arr[index].dtype.code);
+      break;
+    }
+    case StackVM::kArrTypeBits: {
+      dst->v_int64 = static_cast<int64_t>(arr[index].dtype.bits);
+      break;
+    }
+    case StackVM::kArrTypeLanes: {
+      dst->v_int64 = static_cast<int64_t>(arr[index].dtype.lanes);
+      break;
+    }
+    case StackVM::kArrByteOffset: {
+      dst->v_int64 = static_cast<int64_t>(arr[index].byte_offset);
+      break;
+    }
+    case StackVM::kArrDeviceId: {
+      dst->v_int64 = arr[index].device.device_id;
+      break;
+    }
+    case StackVM::kArrDeviceType: {
+      dst->v_int64 = static_cast<int64_t>(arr[index].device.device_type);
+      break;
+    }
+    case StackVM::kArrAddr: {
+      dst->v_handle = arr + index;
+      break;
+    }
+    case StackVM::kTVMValueContent: {
+      *dst = static_cast<TVMValue*>(ptr)[index];
+      break;
+    }
+    default:
+      LOG(FATAL) << "unhandled get " << kind;
+  }
+}
+
+// Write a field of a structure, shared by TVM_STRUCT_SET and HEAP_STRUCT_SET.
+inline void StructSet(void* ptr, int index, int kind, const TVMValue& value) {
+  DLTensor* arr = static_cast<DLTensor*>(ptr);
+  switch (kind) {
+    case StackVM::kArrData: {
+      arr[index].data = value.v_handle;
+      break;
+    }
+    case StackVM::kArrShape: {
+      arr[index].shape = static_cast<int64_t*>(value.v_handle);
+      break;
+    }
+    case StackVM::kArrStrides: {
+      arr[index].strides = static_cast<int64_t*>(value.v_handle);
+      break;
+    }
+    case StackVM::kArrNDim: {
+      arr[index].ndim = static_cast<int>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrTypeCode: {
+      arr[index].dtype.code = static_cast<uint8_t>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrTypeBits: {
+      arr[index].dtype.bits = static_cast<uint8_t>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrTypeLanes: {
+      arr[index].dtype.lanes = static_cast<uint16_t>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrByteOffset: {
+      arr[index].byte_offset = static_cast<uint64_t>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrDeviceId: {
+      arr[index].device.device_id = static_cast<int>(value.v_int64);
+      break;
+    }
+    case StackVM::kArrDeviceType: {
+      arr[index].device.device_type = static_cast<DLDeviceType>(value.v_int64);
+      break;
+    }
+    case StackVM::kTVMValueContent: {
+      static_cast<TVMValue*>(ptr)[index] = value;
+      break;
+    }
+    default:
+      LOG(FATAL) << "unhandled tvm_struct_set " << kind;
+  }
+}
+
+}  // namespace
+
 int64_t StackVM::PrintCode(std::ostream& os, int64_t pc) const {
   switch (code[pc].op_code) {
     // int
@@ -159,6 +320,10 @@ int64_t StackVM::PrintCode(std::ostream& os, int64_t pc) const {
     STACK_VM_PRINT_CODE0(TVM_DEVICE_ALLOCA);
     STACK_VM_PRINT_CODE0(TVM_DEVICE_FREE);
     STACK_VM_PRINT_CODE0(TVM_THROW_LAST_ERROR);
+    // superinstructions
+    STACK_VM_PRINT_CODE3(HEAP_STRUCT_GET);
+    STACK_VM_PRINT_CODE3(HEAP_STRUCT_SET);
+    STACK_VM_PRINT_CODE3(HEAP_ARRAY_STORE_IMM_INT32);
     // packed function.
     case CALL_PACKED_LOWERED: {
       int call_fid = code[pc + 1].v_int;
@@ -172,6 +337,16 @@ int64_t StackVM::PrintCode(std::ostream& os, int64_t pc) const {
       }
       return pc + 4;
     }
+    case HEAP_CALL_PACKED_LOWERED: {
+      os << "[" << pc << "]\tHEAP_CALL_PACKED_FUNC "
+         << " fid=" << code[pc + 1].v_int << " begin=" << code[pc + 2].v_int
+         << " end=" << code[pc + 3].v_int << " value=" << code[pc + 4].v_int
+         << " tcode=" << code[pc + 5].v_int << '\n';
+      for (int i = 0; i < 5; ++i) {
+        os << "[" << pc + 1 + i << "]" << std::endl;
+      }
+      return pc + 6;
+    }
   }
   LOG(FATAL) << "unknown op code " << code[pc].op_code;
   return 0;
@@ -252,177 +427,278 @@ void StackVM::Run(State* s) const {
     heap.resize(heap_size);
   }
   const int64_t code_size = static_cast<int64_t>(code.size());
+#if STACK_VM_COMPUTED_GOTO
+  // Indexed by OpCode.
+  static void* const kHandlers[] = {
+      &&handler_ADD_I64,
+      &&handler_SUB_I64,
+      &&handler_MUL_I64,
+      &&handler_DIV_I64,
+      &&handler_MOD_I64,
+      &&handler_EQ_I64,
+      &&handler_LT_I64,
+      &&handler_LE_I64,
+      &&handler_ADD_F64,
+      &&handler_SUB_F64,
+      &&handler_MUL_F64,
+      &&handler_DIV_F64,
+      &&handler_EQ_F64,
+      &&handler_LT_F64,
+      &&handler_LE_F64,
+      &&handler_EQ_HANDLE,
+      &&handler_ARRAY_LOAD_UINT32,
+      &&handler_ARRAY_LOAD_INT32,
+      &&handler_ARRAY_LOAD_INT64,
+      &&handler_ARRAY_LOAD_FP64,
+      &&handler_ARRAY_LOAD_HANDLE,
+      &&handler_ARRAY_LOAD_TVMVALUE,
+      &&handler_ARRAY_STORE_UINT32,
+      &&handler_ARRAY_STORE_INT32,
+      &&handler_ARRAY_STORE_INT64,
+      &&handler_ARRAY_STORE_FP64,
+      &&handler_ARRAY_STORE_HANDLE,
+      &&handler_ARRAY_STORE_TVMVALUE,
+      &&handler_NOT,
+      &&handler_ADDR_ADD,
+      &&handler_PUSH_I64,
+      &&handler_PUSH_VALUE,
+      &&handler_LOAD_HEAP,
+      &&handler_STORE_HEAP,
+      &&handler_POP,
+      &&handler_SELECT,
+      &&handler_ASSERT,
+      &&handler_RJUMP_IF_TRUE,
+      &&handler_RJUMP_IF_FALSE,
+      &&handler_RJUMP,
+      &&handler_ASSERT_SP,
+      &&handler_CALL_PACKED_LOWERED,
+      &&handler_TVM_STACK_ALLOCA_BY_8BYTE,
+      &&handler_TVM_DEVICE_ALLOCA,
+      &&handler_TVM_DEVICE_FREE,
+      &&handler_TVM_THROW_LAST_ERROR,
+      &&handler_TVM_STRUCT_GET,
+      &&handler_TVM_STRUCT_SET,
+      &&handler_HEAP_STRUCT_GET,
+      &&handler_HEAP_STRUCT_SET,
+      &&handler_HEAP_ARRAY_STORE_IMM_INT32,
+      &&handler_HEAP_CALL_PACKED_LOWERED};
+  static_assert(sizeof(kHandlers) / sizeof(kHandlers[0]) == HEAP_CALL_PACKED_LOWERED + 1,
+                "a handler is missing");
+  const bool threaded = threaded_dispatch;
+#endif
   while (pc < code_size) {
     switch (code[pc].op_code) {
       case ADD_I64:
+      STACK_VM_HANDLER(ADD_I64)
         STACK_VM_BINOP(+, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case SUB_I64:
+      STACK_VM_HANDLER(SUB_I64)
         STACK_VM_BINOP(-, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case MUL_I64:
+      STACK_VM_HANDLER(MUL_I64)
         STACK_VM_BINOP(*, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case DIV_I64:
+      STACK_VM_HANDLER(DIV_I64)
         STACK_VM_BINOP(/, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case MOD_I64:
+      STACK_VM_HANDLER(MOD_I64)
         STACK_VM_BINOP(%, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case EQ_I64:
+      STACK_VM_HANDLER(EQ_I64)
         STACK_VM_CMPOP(==, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case LT_I64:
+      STACK_VM_HANDLER(LT_I64)
         STACK_VM_CMPOP(<, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case LE_I64:
+      STACK_VM_HANDLER(LE_I64)
         STACK_VM_CMPOP(<=, v_int64);
-        break;
+        STACK_VM_DISPATCH();
       case ADD_F64:
+      STACK_VM_HANDLER(ADD_F64)
         STACK_VM_BINOP(+, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case SUB_F64:
+      STACK_VM_HANDLER(SUB_F64)
         STACK_VM_BINOP(-, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case MUL_F64:
+      STACK_VM_HANDLER(MUL_F64)
         STACK_VM_BINOP(*, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case DIV_F64:
+      STACK_VM_HANDLER(DIV_F64)
         STACK_VM_BINOP(/, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case EQ_F64:
+      STACK_VM_HANDLER(EQ_F64)
         STACK_VM_CMPOP(==, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case LT_F64:
+      STACK_VM_HANDLER(LT_F64)
         STACK_VM_CMPOP(<, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case LE_F64:
+      STACK_VM_HANDLER(LE_F64)
         STACK_VM_CMPOP(<=, v_float64);
-        break;
+        STACK_VM_DISPATCH();
       case EQ_HANDLE:
+      STACK_VM_HANDLER(EQ_HANDLE)
         STACK_VM_CMPOP(==, v_handle);
-        break;
+        STACK_VM_DISPATCH();
       // addressing
       case ARRAY_LOAD_UINT32:
+      STACK_VM_HANDLER(ARRAY_LOAD_UINT32)
         STACK_VM_LOAD(.v_int64, int64_t, uint32_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_LOAD_INT32:
+      STACK_VM_HANDLER(ARRAY_LOAD_INT32)
         STACK_VM_LOAD(.v_int64, int64_t, int32_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_LOAD_INT64:
+      STACK_VM_HANDLER(ARRAY_LOAD_INT64)
         STACK_VM_LOAD(.v_int64, int64_t, int64_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_LOAD_FP64:
+      STACK_VM_HANDLER(ARRAY_LOAD_FP64)
         STACK_VM_LOAD(.v_float64, double, double);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_LOAD_HANDLE:
+      STACK_VM_HANDLER(ARRAY_LOAD_HANDLE)
         STACK_VM_LOAD(.v_handle, void*, void*);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_LOAD_TVMVALUE:
+      STACK_VM_HANDLER(ARRAY_LOAD_TVMVALUE)
         STACK_VM_LOAD(, TVMValue, TVMValue);
-        break;
+        STACK_VM_DISPATCH();
       // store
       case ARRAY_STORE_UINT32:
+      STACK_VM_HANDLER(ARRAY_STORE_UINT32)
         STACK_VM_STORE(.v_int64, uint32_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_STORE_INT32:
+      STACK_VM_HANDLER(ARRAY_STORE_INT32)
         STACK_VM_STORE(.v_int64, int32_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_STORE_INT64:
+      STACK_VM_HANDLER(ARRAY_STORE_INT64)
         STACK_VM_STORE(.v_int64, int64_t);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_STORE_FP64:
+      STACK_VM_HANDLER(ARRAY_STORE_FP64)
         STACK_VM_STORE(.v_float64, double);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_STORE_HANDLE:
+      STACK_VM_HANDLER(ARRAY_STORE_HANDLE)
         STACK_VM_STORE(.v_handle, void*);
-        break;
+        STACK_VM_DISPATCH();
       case ARRAY_STORE_TVMVALUE:
+      STACK_VM_HANDLER(ARRAY_STORE_TVMVALUE)
         STACK_VM_STORE(, TVMValue);
-        break;
+        STACK_VM_DISPATCH();
       // add
-      case ADDR_ADD: {
+      case ADDR_ADD:
+      STACK_VM_HANDLER(ADDR_ADD) {
         stack[sp - 1].v_handle = (char*)(stack[sp - 1].v_handle) + stack[sp].v_int64;  // NOLINT(*)
         sp = sp - 1;
         pc = pc + 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case NOT: {
+      case NOT:
+      STACK_VM_HANDLER(NOT) {
         stack[sp].v_int64 = !stack[sp].v_int64;
         pc += 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case PUSH_I64: {
+      case PUSH_I64:
+      STACK_VM_HANDLER(PUSH_I64) {
         stack[sp + 1].v_int64 = code[pc + 1].v_int;
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case PUSH_VALUE: {
+      case PUSH_VALUE:
+      STACK_VM_HANDLER(PUSH_VALUE) {
         int relpos = code[pc + 1].v_int;
         ICHECK_LE(relpos, 0);
         stack[sp + 1] = stack[sp + relpos];
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case POP: {
+      case POP:
+      STACK_VM_HANDLER(POP) {
         sp -= 1;
         pc += 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case SELECT: {
+      case SELECT:
+      STACK_VM_HANDLER(SELECT) {
         stack[sp - 2] = (stack[sp].v_int64 ? stack[sp - 2] : stack[sp - 1]);
         sp -= 2;
         pc += 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case LOAD_HEAP: {
+      case LOAD_HEAP:
+      STACK_VM_HANDLER(LOAD_HEAP) {
         stack[sp + 1] = heap[code[pc + 1].v_int];
         sp += 1;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case STORE_HEAP: {
+      case STORE_HEAP:
+      STACK_VM_HANDLER(STORE_HEAP) {
         heap[code[pc + 1].v_int] = stack[sp];
         sp -= 1;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case ASSERT: {
+      case ASSERT:
+      STACK_VM_HANDLER(ASSERT) {
         ICHECK(stack[sp].v_int64) << str_data[code[pc + 1].v_int];
         sp -= 1;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case RJUMP_IF_TRUE: {
+      case RJUMP_IF_TRUE:
+      STACK_VM_HANDLER(RJUMP_IF_TRUE) {
         if (stack[sp].v_int64) {
           pc += code[pc + 1].v_int;
         } else {
           pc += 2;
         }
-        break;
+        STACK_VM_DISPATCH();
       }
-      case RJUMP_IF_FALSE: {
+      case RJUMP_IF_FALSE:
+      STACK_VM_HANDLER(RJUMP_IF_FALSE) {
         if (!stack[sp].v_int64) {
           pc += code[pc + 1].v_int;
         } else {
           pc += 2;
         }
-        break;
+        STACK_VM_DISPATCH();
       }
-      case RJUMP: {
+      case RJUMP:
+      STACK_VM_HANDLER(RJUMP) {
         pc += code[pc + 1].v_int;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case ASSERT_SP: {
+      case ASSERT_SP:
+      STACK_VM_HANDLER(ASSERT_SP) {
         int64_t expected = code[pc + 1].v_int;
         ICHECK_EQ(sp, expected) << "sp assertion failed, expected=" << expected << " now=" << sp
                                 << ", pc=" << pc;
         pc += 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case CALL_PACKED_LOWERED: {
+      case CALL_PACKED_LOWERED:
+      STACK_VM_HANDLER(CALL_PACKED_LOWERED) {
         // call packed function.
         TVMValue* value_stack = static_cast<TVMValue*>(stack[sp - 1].v_handle);
         int* type_stack = static_cast<int*>(stack[sp].v_handle);
@@ -437,126 +713,64 @@ void StackVM::Run(State* s) const {
         sp = sp - 1;
         stack[sp] = rv.value();
         pc += 4;
-        break;
+        STACK_VM_DISPATCH();
+      }
+      case HEAP_CALL_PACKED_LOWERED:
+      STACK_VM_HANDLER(HEAP_CALL_PACKED_LOWERED) {
+        TVMValue* value_stack = static_cast<TVMValue*>(heap[code[pc + 4].v_int].v_handle);
+        int* type_stack = static_cast<int*>(heap[code[pc + 5].v_int].v_handle);
+        int call_fid = code[pc + 1].v_int;
+        int begin = code[pc + 2].v_int;
+        int end = code[pc + 3].v_int;
+        runtime::TVMRetValue rv;
+        GetExtern(s, call_fid)
+            .CallPacked(runtime::TVMArgs(value_stack + begin, type_stack + begin, end - begin),
+                        &rv);
+        sp = sp + 1;
+        stack[sp] = rv.value();
+        pc += 6;
+        STACK_VM_DISPATCH();
       }
       // intrinsics
-      case TVM_STRUCT_GET: {
-        int index = code[pc + 1].v_int;
-        int kind = code[pc + 2].v_int;
-        DLTensor* arr = static_cast<DLTensor*>(stack[sp].v_handle);
-        switch (kind) {
-          case StackVM::kArrData: {
-            stack[sp].v_handle = arr[index].data;
-            break;
-          }
-          case StackVM::kArrShape: {
-            stack[sp].v_handle = arr[index].shape;
-            break;
-          }
-          case StackVM::kArrStrides: {
-            stack[sp].v_handle = arr[index].strides;
-            break;
-          }
-          case StackVM::kArrNDim: {
-            stack[sp].v_int64 = arr[index].ndim;
-            break;
-          }
-          case StackVM::kArrTypeCode: {
-            stack[sp].v_int64 = static_cast<int64_t>(arr[index].dtype.code);
-            break;
-          }
-          case StackVM::kArrTypeBits: {
-            stack[sp].v_int64 = static_cast<int64_t>(arr[index].dtype.bits);
-            break;
-          }
-          case StackVM::kArrTypeLanes: {
-            stack[sp].v_int64 = static_cast<int64_t>(arr[index].dtype.lanes);
-            break;
-          }
-          case StackVM::kArrByteOffset: {
-            stack[sp].v_int64 = static_cast<int64_t>(arr[index].byte_offset);
-            break;
-          }
-          case StackVM::kArrDeviceId: {
-            stack[sp].v_int64 = arr[index].device.device_id;
-            break;
-          }
-          case StackVM::kArrDeviceType: {
-            stack[sp].v_int64 = static_cast<int64_t>(arr[index].device.device_type);
-            break;
-          }
-          case StackVM::kArrAddr: {
-            stack[sp].v_handle = arr + index;
-            break;
-          }
-          case StackVM::kTVMValueContent: {
-            stack[sp] = static_cast<TVMValue*>(stack[sp].v_handle)[index];
-            break;
-          }
-          default:
-            LOG(FATAL) << "unhandled get " << kind;
-        }
+      case TVM_STRUCT_GET:
+      STACK_VM_HANDLER(TVM_STRUCT_GET) {
+        StructGet(stack[sp].v_handle, code[pc + 1].v_int, code[pc + 2].v_int, &stack[sp]);
         pc = pc + 3;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case TVM_STRUCT_SET: {
-        int index = code[pc + 1].v_int;
-        int kind = code[pc + 2].v_int;
-        DLTensor* arr = static_cast<DLTensor*>(stack[sp - 1].v_handle);
-        switch (kind) {
-          case StackVM::kArrData: {
-            arr[index].data = stack[sp].v_handle;
-            break;
-          }
-          case StackVM::kArrShape: {
-            arr[index].shape = static_cast<int64_t*>(stack[sp].v_handle);
-            break;
-          }
-          case StackVM::kArrStrides: {
-            arr[index].strides = static_cast<int64_t*>(stack[sp].v_handle);
-            break;
-          }
-          case StackVM::kArrNDim: {
-            arr[index].ndim = static_cast<int>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrTypeCode: {
-            arr[index].dtype.code = static_cast<uint8_t>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrTypeBits: {
-            arr[index].dtype.bits = static_cast<uint8_t>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrTypeLanes: {
-            arr[index].dtype.lanes = static_cast<uint16_t>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrByteOffset: {
-            arr[index].byte_offset = static_cast<uint64_t>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrDeviceId: {
-            arr[index].device.device_id = static_cast<int>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kArrDeviceType: {
-            arr[index].device.device_type = static_cast<DLDeviceType>(stack[sp].v_int64);
-            break;
-          }
-          case StackVM::kTVMValueContent: {
-            static_cast<TVMValue*>(stack[sp - 1].v_handle)[index] = stack[sp];
-            break;
-          }
-          default:
-            LOG(FATAL) << "unhandled tvm_struct_set " << kind;
-        }
+      case TVM_STRUCT_SET:
+      STACK_VM_HANDLER(TVM_STRUCT_SET) {
+        StructSet(stack[sp - 1].v_handle, code[pc + 1].v_int, code[pc + 2].v_int, stack[sp]);
         sp -= 2;
         pc += 3;
-        break;
+        STACK_VM_DISPATCH();
+      }
+      case HEAP_STRUCT_GET:
+      STACK_VM_HANDLER(HEAP_STRUCT_GET) {
+        StructGet(heap[code[pc + 1].v_int].v_handle, code[pc + 2].v_int, code[pc + 3].v_int,
+                  &stack[sp + 1]);
+        sp += 1;
+        pc += 4;
+        STACK_VM_DISPATCH();
+      }
+      case HEAP_STRUCT_SET:
+      STACK_VM_HANDLER(HEAP_STRUCT_SET) {
+        StructSet(heap[code[pc + 1].v_int].v_handle, code[pc + 2].v_int, code[pc + 3].v_int,
+                  stack[sp]);
+        sp -= 1;
+        pc += 4;
+        STACK_VM_DISPATCH();
+      }
+      case HEAP_ARRAY_STORE_IMM_INT32:
+      STACK_VM_HANDLER(HEAP_ARRAY_STORE_IMM_INT32) {
+        static_cast<int32_t*>(heap[code[pc + 1].v_int].v_handle)[code[pc + 2].v_int] =
+            code[pc + 3].v_int;
+        pc += 4;
+        STACK_VM_DISPATCH();
       }
       // alloca
-      case TVM_STACK_ALLOCA_BY_8BYTE: {
+      case TVM_STACK_ALLOCA_BY_8BYTE:
+      STACK_VM_HANDLER(TVM_STACK_ALLOCA_BY_8BYTE) {
         static_assert(sizeof(TVMValue) == 8, "invariance");
         int num = code[pc + 1].v_int;
         void* addr = &stack[sp] + 1;
@@ -564,9 +778,10 @@ void StackVM::Run(State* s) const {
         alloca_sp = sp - 1;
         stack[sp].v_handle = addr;
         pc = pc + 2;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case TVM_DEVICE_ALLOCA: {
+      case TVM_DEVICE_ALLOCA:
+      STACK_VM_HANDLER(TVM_DEVICE_ALLOCA) {
         int device_type = static_cast<int>(stack[sp - 4].v_int64);
         int device_id = static_cast<int>(stack[sp - 3].v_int64);
         size_t nbytes = static_cast<size_t>(stack[sp - 2].v_int64);
@@ -577,9 +792,10 @@ void StackVM::Run(State* s) const {
         stack[sp - 4].v_handle = ptr;
         sp = sp - 4;
         pc = pc + 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case TVM_DEVICE_FREE: {
+      case TVM_DEVICE_FREE:
+      STACK_VM_HANDLER(TVM_DEVICE_FREE) {
         int device_type = static_cast<int>(stack[sp - 2].v_int64);
         int device_id = static_cast<int>(stack[sp - 1].v_int64);
         void* ptr = stack[sp].v_handle;
@@ -587,11 +803,12 @@ void StackVM::Run(State* s) const {
         stack[sp - 2].v_int64 = ret;
         sp = sp - 2;
         pc = pc + 1;
-        break;
+        STACK_VM_DISPATCH();
       }
-      case TVM_THROW_LAST_ERROR: {
+      case TVM_THROW_LAST_ERROR:
+      STACK_VM_HANDLER(TVM_THROW_LAST_ERROR) {
         LOG(FATAL) << TVMGetLastError();
-        break;
+        STACK_VM_DISPATCH();
       }
     }
     ICHECK_GE(sp, alloca_sp) << "touch allocated space";
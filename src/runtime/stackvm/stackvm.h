@@ -283,7 +283,52 @@ class StackVM {
      *  sp = sp - 1
      * \endcode
      */
-    TVM_STRUCT_SET
+    TVM_STRUCT_SET,
+    // Superinstructions, reading their handle from a heap slot instead of the stack.
+    // They are appended so that the code of the older compilers keeps loading.
+    /*!
+     * \brief get data from the structure of a heap slot, i.e. LOAD_HEAP then TVM_STRUCT_GET.
+     * \code
+     *  index = code[pc + 2].v_int;
+     *  field = code[pc + 3].v_int;
+     *  stack[sp + 1] = ((StructType*)heap[code[pc + 1].v_int].v_handle)[index]->field;
+     *  sp = sp + 1;
+     *  pc = pc + 4;
+     * \endcode
+     */
+    HEAP_STRUCT_GET,
+    /*!
+     * \brief set data into the structure of a heap slot, i.e. TVM_STRUCT_SET with the handle
+     *  loaded from the heap.
+     * \code
+     *  index = code[pc + 2].v_int;
+     *  field = code[pc + 3].v_int;
+     *  ((StructType*)heap[code[pc + 1].v_int].v_handle)[index]->field = stack[sp];
+     *  sp = sp - 1;
+     *  pc = pc + 4;
+     * \endcode
+     */
+    HEAP_STRUCT_SET,
+    /*!
+     * \brief store a constant into the int32 array of a heap slot, e.g. a type code of a packed
+     *  call.
+     * \code
+     *  ((int32_t*)heap[code[pc + 1].v_int].v_handle)[code[pc + 2].v_int] = code[pc + 3].v_int;
+     *  pc = pc + 4;
+     * \endcode
+     */
+    HEAP_ARRAY_STORE_IMM_INT32,
+    /*!
+     * \brief call an extern packed function on the value and type code stacks of heap slots.
+     * \code
+     *  value_stack = heap[code[pc + 4].v_int].v_handle;
+     *  type_stack = heap[code[pc + 5].v_int].v_handle;
+     *  stack[sp + 1] = f(&value_stack[begin:end], type_stack[begin:end], end - begin);
+     *  sp = sp + 1;
+     *  pc = pc + 6;
+     * \endcode
+     */
+    HEAP_CALL_PACKED_LOWERED
   };
   /*! \brief The kind of structure field info */
   enum StructFieldKind : int {
@@ -343,6 +388,13 @@ class StackVM {
   int64_t PrintCode(std::ostream& os, int64_t pc) const;  // NOLINT(*)
   /*! \brief Get thread local state of the stack VM */
   static State* ThreadLocalState();
+  /*!
+   * \brief Set whether the handlers jump straight to the next handler, through a computed goto
+   *  table, instead of going back to the central switch. On by default when the compiler
+   *  supports computed gotos.
+   * \param threaded Whether to use the threaded dispatch.
+   */
+  static void SetThreadedDispatch(bool threaded);
   // The code below are programs
   /*! \brief The instructions */
   std::vector<Code> code;
@@ -144,5 +144,8 @@ Module StackVMModuleCreate(std::unordered_map<std::string, StackVM> fmap, std::s
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_stackvm")
     .set_body_typed(StackVMModuleNode::LoadFromFile);
 
+TVM_REGISTER_GLOBAL("runtime.StackVMSetThreadedDispatch")
+    .set_body_typed(StackVM::SetThreadedDispatch);
+
 }  // namespace runtime
 }  // namespace tvm
@@ -24,8 +24,10 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
 #if TVM_THREADPOOL_USE_OPENMP
@@ -33,6 +35,7 @@
 #endif
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstring>
 #include <memory>
@@ -40,6 +43,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 const constexpr int kL1CacheBytes = 64;
@@ -58,11 +62,148 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+// The longest an idle worker spins in adaptive mode before it parks.
+constexpr int64_t kDefaultMaxSpinNs = 200000;
+// Idle gaps shorter than this are bridged by busy spinning instead of yielding.
+constexpr int64_t kBusySpinNs = 10000;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Run a task of a parallel request, adding it to the timeline of the profiler
+// when one is recorded.
+int RunParallelTask(FTVMParallelLambda flambda, int task_id, TVMParallelGroupEnv* penv,
+                    void* cdata) {
+  if (!profiling::IsTimelineRecording()) {
+    return (*flambda)(task_id, penv, cdata);
+  }
+  int64_t begin = profiling::TimelineNanos();
+  int ret = (*flambda)(task_id, penv, cdata);
+  profiling::RecordTimelineEvent(
+      "task " + std::to_string(task_id) + "/" + std::to_string(penv->num_task), begin,
+      profiling::TimelineNanos());
+  return ret;
+}
+
+// Hint the cpu that we are in a spin loop.
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 }  // namespace
 
+/*!
+ * \brief Decides how long the idle workers of a pool wait before they park,
+ *  and records what waiting costs.
+ *
+ *  In fixed mode the workers yield TVM_THREAD_POOL_SPIN_COUNT times before parking.
+ *  In adaptive mode the pool keeps a moving average of the idle gap between two requests:
+ *  short gaps are bridged by busy spinning, medium ones by yielding, and when the gap
+ *  is expected to be longer than the spin limit the workers park on the condition
+ *  variable (a futex on linux) right away.
+ */
+class IdlePolicy {
+ public:
+  IdlePolicy() : fixed_spin_count(GetSpinCount()) {
+    const char* val = getenv("TVM_THREAD_POOL_SPIN_POLICY");
+    adaptive = val != nullptr && std::string(val) == "adaptive";
+  }
+  // Record the start of a top level request.
+  void RecordLaunch(int64_t now_ns) {
+    int64_t last_finish = last_finish_ns_.load(std::memory_order_relaxed);
+    if (last_finish != 0) {
+      int64_t gap = now_ns - last_finish;
+      int64_t avg = avg_gap_ns_.load(std::memory_order_relaxed);
+      // exponential moving average with weight 1/8
+      avg_gap_ns_.store(avg == 0 ? gap : avg + (gap - avg) / 8, std::memory_order_relaxed);
+    }
+  }
+  // Record the end of a top level request.
+  void RecordFinish(int64_t now_ns) { last_finish_ns_.store(now_ns, std::memory_order_relaxed); }
+  // The time an idle worker should spin before it parks.
+  int64_t SpinBudgetNs() const {
+    int64_t avg = avg_gap_ns_.load(std::memory_order_relaxed);
+    int64_t max_spin_ns = this->max_spin_ns.load(std::memory_order_relaxed);
+    // no history yet, spin up to the limit to learn the gap.
+    if (avg == 0) return max_spin_ns;
+    if (avg > max_spin_ns) return 0;
+    return std::min(2 * avg, max_spin_ns);
+  }
+  // Record the time from pushing a task until a worker picked it up.
+  void RecordWakeup(int64_t latency_ns) {
+    num_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    wakeup_latency_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+    int64_t prev = max_wakeup_latency_ns_.load(std::memory_order_relaxed);
+    while (prev < latency_ns &&
+           !max_wakeup_latency_ns_.compare_exchange_weak(prev, latency_ns,
+                                                         std::memory_order_relaxed)) {
+    }
+  }
+  // Record a worker that spun for spin_ns without getting a task and parks now.
+  void RecordPark(int64_t spin_ns) {
+    num_parks_.fetch_add(1, std::memory_order_relaxed);
+    wasted_spin_ns_.fetch_add(spin_ns, std::memory_order_relaxed);
+  }
+  // Add the counters to the stats of the pool.
+  void GetStats(Map<String, ObjectRef>* stats) const {
+    auto count = [](const std::atomic<int64_t>& v) {
+      return ObjectRef(make_object<profiling::CountNode>(v.load(std::memory_order_relaxed)));
+    };
+    stats->Set("wakeups", count(num_wakeups_));
+    stats->Set("wakeup_latency_ns", count(wakeup_latency_ns_));
+    stats->Set("max_wakeup_latency_ns", count(max_wakeup_latency_ns_));
+    stats->Set("parks", count(num_parks_));
+    stats->Set("wasted_spin_ns", count(wasted_spin_ns_));
+    stats->Set("idle_gap_ns", count(avg_gap_ns_));
+  }
+
+  // Whether to use the adaptive policy, can be changed while the workers wait.
+  std::atomic<bool> adaptive{false};
+  // The number of yields before parking in fixed mode.
+  uint32_t fixed_spin_count;
+  // The spin limit in adaptive mode.
+  std::atomic<int64_t> max_spin_ns{kDefaultMaxSpinNs};
+
+ private:
+  std::atomic<int64_t> last_finish_ns_{0};
+  std::atomic<int64_t> avg_gap_ns_{0};
+  std::atomic<int64_t> num_wakeups_{0};
+  std::atomic<int64_t> wakeup_latency_ns_{0};
+  std::atomic<int64_t> max_wakeup_latency_ns_{0};
+  std::atomic<int64_t> num_parks_{0};
+  std::atomic<int64_t> wasted_spin_ns_{0};
+};
+
 // stride in the page, fit to cache line.
 constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
 
+/*!
+ * \brief Range of task ids [begin, end) owned by one worker in work-stealing mode.
+ *
+ *  The range is packed into a single 64 bit word so that the owner (popping from
+ *  the front) and the thieves (popping from the back) can update it with one CAS.
+ */
+struct TaskRange {
+  static uint64_t Pack(uint32_t begin, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | begin;
+  }
+  static uint32_t Begin(uint64_t bounds) { return static_cast<uint32_t>(bounds); }
+  static uint32_t End(uint64_t bounds) { return static_cast<uint32_t>(bounds >> 32); }
+
+  std::atomic<uint64_t> bounds{0};
+  // pad to a cache line to avoid false sharing between neighbouring ranges
+  char pad[kL1CacheBytes - sizeof(std::atomic<uint64_t>)];
+};
+
+class ThreadPool;
+
 /*!
  * \brief Thread local main environment.
  */
@@ -75,13 +216,15 @@ class ParallelLauncher {
     this->flambda = flambda;
     this->env.num_task = num_task;
     has_error_.store(false);
+    work_stealing = false;
     // reshape
     if (static_cast<size_t>(num_task) > par_errors_.size()) {
       par_errors_.resize(num_task + 1);
-      if (need_sync) {
-        delete[] sync_counter_;
-        sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
-      }
+    }
+    if (need_sync && num_task > sync_capacity_) {
+      delete[] sync_counter_;
+      sync_counter_ = new std::atomic<int>[num_task * kSyncStride];
+      sync_capacity_ = num_task;
     }
     if (need_sync) {
       for (int i = 0; i < num_task; ++i) {
@@ -92,6 +235,66 @@ class ParallelLauncher {
       this->env.sync_handle = nullptr;
     }
   }
+  /*!
+   * \brief Switch the current request to work-stealing mode.
+   *  The num_task tasks are split into num_ranges contiguous ranges, one per participating
+   *  worker. Each participant signals finish once after all ranges have been drained.
+   * \param num_ranges The number of participating workers.
+   */
+  void InitWorkStealing(int num_ranges) {
+    if (static_cast<size_t>(num_ranges) > ranges_.size()) {
+      ranges_ = std::vector<TaskRange>(num_ranges);
+    }
+    num_ranges_ = num_ranges;
+    int num_task = this->env.num_task;
+    for (int i = 0; i < num_ranges; ++i) {
+      uint32_t begin = static_cast<uint32_t>(static_cast<int64_t>(num_task) * i / num_ranges);
+      uint32_t end = static_cast<uint32_t>(static_cast<int64_t>(num_task) * (i + 1) / num_ranges);
+      ranges_[i].bounds.store(TaskRange::Pack(begin, end), std::memory_order_relaxed);
+    }
+    num_pending_.store(num_ranges);
+    work_stealing = true;
+  }
+  /*!
+   * \brief Claim the next task of a range.
+   * \param range_id The range to claim from.
+   * \param from_back Whether to take the task from the back (stealing) or the front (owner).
+   * \param task_id The claimed task id.
+   * \return Whether a task was claimed.
+   */
+  bool ClaimTask(int range_id, bool from_back, int* task_id) {
+    std::atomic<uint64_t>& bounds = ranges_[range_id].bounds;
+    uint64_t cur = bounds.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t begin = TaskRange::Begin(cur);
+      uint32_t end = TaskRange::End(cur);
+      if (begin >= end) return false;
+      uint64_t next = from_back ? TaskRange::Pack(begin, end - 1) : TaskRange::Pack(begin + 1, end);
+      if (bounds.compare_exchange_weak(cur, next, std::memory_order_acq_rel)) {
+        *task_id = static_cast<int>(from_back ? end - 1 : begin);
+        return true;
+      }
+    }
+  }
+  /*!
+   * \brief Run tasks of the own range, then steal from the other ranges until all are drained.
+   *  The caller signals finish afterwards.
+   * \param range_id The range owned by the calling worker.
+   */
+  void RunWorkStealing(int range_id) {
+    int task_id;
+    while (ClaimTask(range_id, false, &task_id)) {
+      RunStolenTask(task_id);
+    }
+    // round robin over the victims, restart whenever something was stolen
+    // as the remaining work can only shrink.
+    for (int k = 1; k < num_ranges_; ++k) {
+      int victim = (range_id + k) % num_ranges_;
+      while (ClaimTask(victim, true, &task_id)) {
+        RunStolenTask(task_id);
+      }
+    }
+  }
   ~ParallelLauncher() { delete[] sync_counter_; }
   // Wait n jobs to finish
   int WaitForJobs() {
@@ -119,6 +322,8 @@ class ParallelLauncher {
   void SignalJobFinish() { num_pending_.fetch_sub(1); }
   // Get thread local version of the store.
   static ParallelLauncher* ThreadLocal() { return dmlc::ThreadLocalStore<ParallelLauncher>::Get(); }
+  // Get the thread local store used by a nested request while ThreadLocal() is in use.
+  static ParallelLauncher* NestedThreadLocal();
   // The parallel lambda
   FTVMParallelLambda flambda;
   // The closure data
@@ -126,20 +331,54 @@ class ParallelLauncher {
   // Local env
   TVMParallelGroupEnv env;
   // Whether this thread is worker of the pool.
-  // used to prevent recursive launch.
+  // used to route nested launches to the owning pool.
   bool is_worker{false};
+  // The pool this thread is a worker of, only valid if is_worker.
+  ThreadPool* pool{nullptr};
+  // The named pool the requests of this thread are routed to, see ThreadPoolScope.
+  ThreadPool* bound_pool{nullptr};
+  // Whether this launcher is currently used by a request of this thread.
+  // used to prevent recursive launch.
+  bool launching{false};
+  // The workers reserved by the last nested request of this thread.
+  std::vector<int> pool_helpers;
+  // Whether the current request is scheduled with work stealing.
+  bool work_stealing{false};
+  // The time the current request was pushed to the workers.
+  int64_t launch_time_ns{0};
 
  private:
+  // Run a single task claimed in work-stealing mode, errors are recorded
+  // but the pending counter is only decremented per participant.
+  void RunStolenTask(int task_id) {
+    if (RunParallelTask(flambda, task_id, &env, cdata) != 0) {
+      par_errors_[task_id] = TVMGetLastError();
+      has_error_.store(true);
+    }
+  }
   // The pending jobs.
   std::atomic<int32_t> num_pending_;
   // Whether error has been countered.
   std::atomic<bool> has_error_;
   // The counter page.
   std::atomic<int32_t>* sync_counter_{nullptr};
+  // The number of tasks the counter page can host.
+  int sync_capacity_{0};
   // The error message
   std::vector<std::string> par_errors_;
+  // The task ranges of each participant in work-stealing mode.
+  std::vector<TaskRange> ranges_;
+  // The number of participants in work-stealing mode.
+  int num_ranges_{0};
 };
 
+/*! \brief Launcher used by nested requests of a thread whose main launcher is in use. */
+class NestedParallelLauncher : public ParallelLauncher {};
+
+ParallelLauncher* ParallelLauncher::NestedThreadLocal() {
+  return dmlc::ThreadLocalStore<NestedParallelLauncher>::Get();
+}
+
 /*! \brief Lock-free single-producer-single-consumer queue for each thread */
 class SpscTaskQueue {
  public:
@@ -170,15 +409,32 @@ class SpscTaskQueue {
   /*!
    * \brief Pop a task out of the queue and condition wait if no tasks.
    * \param output The pointer to the task to be dequeued.
-   * \param spin_count The number of iterations to spin before sleep.
+   * \param policy The policy deciding how long to spin before sleep.
    * \return Whether pop is successful (true) or we need to exit now (false).
    */
-  bool Pop(Task* output, uint32_t spin_count) {
+  bool Pop(Task* output, IdlePolicy* policy) {
     // Busy wait a bit when the queue is empty.
     // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
-    // The default spin count is set by following the typical omp convention
-    for (uint32_t i = 0; i < spin_count && pending_.load() == 0; ++i) {
-      tvm::runtime::threading::Yield();
+    if (!policy->adaptive) {
+      // The default spin count is set by following the typical omp convention
+      for (uint32_t i = 0; i < policy->fixed_spin_count && pending_.load() == 0; ++i) {
+        tvm::runtime::threading::Yield();
+      }
+    } else if (pending_.load() == 0) {
+      int64_t budget = policy->SpinBudgetNs();
+      int64_t start = NowNs();
+      int64_t elapsed = 0;
+      while (elapsed < budget && pending_.load() == 0) {
+        if (elapsed < kBusySpinNs) {
+          CpuRelax();
+        } else {
+          tvm::runtime::threading::Yield();
+        }
+        elapsed = NowNs() - start;
+      }
+      if (pending_.load() == 0) {
+        policy->RecordPark(elapsed);
+      }
     }
     if (pending_.fetch_sub(1) == 0) {
       std::unique_lock<std::mutex> lock(mutex_);
@@ -257,21 +513,49 @@ class SpscTaskQueue {
 // The thread pool
 class ThreadPool {
  public:
-  ThreadPool() : num_workers_(tvm::runtime::threading::MaxConcurrency()) {
+  /*! \brief How the tasks of a parallel request are distributed over the workers. */
+  enum SchedulePolicy : int {
+    /*! \brief Each worker runs exactly the task pushed into its queue. */
+    kStatic = 0,
+    /*!
+     * \brief Tasks are split into per-worker ranges, idle workers steal from the others.
+     *  Tasks can outnumber the workers, in which case TVMBackendParallelBarrier is not supported.
+     */
+    kWorkStealing = 1,
+  };
+
+  ThreadPool() : ThreadPool(tvm::runtime::threading::MaxConcurrency(), {}) {}
+  /*!
+   * \brief Create a pool.
+   * \param num_workers The number of workers.
+   * \param cpus If not empty, the pool is a named pool that can be shared among threads,
+   *  with all its workers running in their own thread bound to these cpus.
+   * \param numa_node The NUMA node the allocations of the workers are placed on, or -1.
+   */
+  ThreadPool(int num_workers, const std::vector<unsigned int>& cpus, int numa_node = -1)
+      : num_workers_(num_workers),
+        shared_(!cpus.empty()),
+        numa_node_(numa_node),
+        worker_states_(num_workers_) {
     for (int i = 0; i < num_workers_; ++i) {
       // The SpscTaskQueue only hosts ONE item at a time
       queues_.emplace_back(std::unique_ptr<SpscTaskQueue>(new SpscTaskQueue()));
     }
     const char* exclude_worker0 = getenv("TVM_EXCLUDE_WORKER0");
-    if (exclude_worker0 && atoi(exclude_worker0) == 0) {
+    if (shared_ || (exclude_worker0 && atoi(exclude_worker0) == 0)) {
+      // the calling thread of a shared pool is not bound to its cpus.
       exclude_worker0_ = false;
     }
     threads_ = std::unique_ptr<tvm::runtime::threading::ThreadGroup>(
         new tvm::runtime::threading::ThreadGroup(
             num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
             exclude_worker0_ /* include_main_thread */));
-    num_workers_used_ = threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_);
+    num_workers_used_ =
+        threads_->Configure(threading::ThreadGroup::kBig, 0, exclude_worker0_, cpus);
   }
+  /*! \brief The NUMA node the allocations of the pool are placed on, -1 for the default. */
+  int numa_node() const { return numa_node_; }
+
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
@@ -282,6 +566,27 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    if (launcher->is_worker || launcher->launching) {
+      return LaunchNested(launcher, flambda, cdata, num_task, need_sync);
+    }
+    LaunchScope scope(launcher);
+    // a shared pool serves one top level request at a time.
+    std::unique_lock<std::mutex> lock(launch_mutex_, std::defer_lock);
+    if (shared_) lock.lock();
+    launcher->launch_time_ns = NowNs();
+    idle_policy_.RecordLaunch(launcher->launch_time_ns);
+    int res;
+    if (policy_ == kWorkStealing) {
+      res = LaunchWorkStealing(launcher, flambda, cdata, num_task, need_sync);
+    } else {
+      res = LaunchStatic(launcher, flambda, cdata, num_task, need_sync);
+    }
+    idle_policy_.RecordFinish(NowNs());
+    return res;
+  }
+
+  int LaunchStatic(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                   int num_task, int need_sync) {
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -293,6 +598,7 @@ class ThreadPool {
     launcher->Init(flambda, cdata, num_task, need_sync != 0);
     SpscTaskQueue::Task tsk;
     tsk.launcher = launcher;
+    MarkBusy(num_task);
     // if worker0 is taken by the main, queues_[0] is abandoned
     for (int i = exclude_worker0_; i < num_task; ++i) {
       tsk.task_id = i;
@@ -301,7 +607,7 @@ class ThreadPool {
     // use the main thread to run task 0
     if (exclude_worker0_) {
       TVMParallelGroupEnv* penv = &(tsk.launcher->env);
-      if ((*tsk.launcher->flambda)(0, penv, cdata) == 0) {
+      if (RunParallelTask(tsk.launcher->flambda, 0, penv, cdata) == 0) {
         tsk.launcher->SignalJobFinish();
       } else {
         tsk.launcher->SignalJobError(tsk.task_id);
@@ -313,6 +619,16 @@ class ThreadPool {
 
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
+  /*!
+   * \return The pool a parallel request of the calling thread goes to,
+   *  the owning pool for a worker and the thread local pool otherwise.
+   */
+  static ThreadPool* Current() {
+    ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
+    if (launcher->is_worker) return launcher->pool;
+    return launcher->bound_pool != nullptr ? launcher->bound_pool : ThreadLocal();
+  }
+
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads) {
     // this will also reset the affinity of the ThreadGroup
     // may use less than the MaxConcurrency number of workers
@@ -322,41 +638,302 @@ class ThreadPool {
     num_workers_used_ = std::min(num_workers_, num_workers_used_);
   }
 
+  void UpdateSchedulePolicy(SchedulePolicy policy, int chunks_per_worker) {
+    ICHECK_GE(chunks_per_worker, 1) << "chunks_per_worker must be positive";
+    policy_ = policy;
+    chunks_per_worker_ = chunks_per_worker;
+  }
+
+  void UpdateIdlePolicy(bool adaptive, int64_t max_spin_ns) {
+    ICHECK_GE(max_spin_ns, 0) << "max_spin_ns must not be negative";
+    idle_policy_.adaptive = adaptive;
+    idle_policy_.max_spin_ns = max_spin_ns;
+  }
+
+  void UpdateNestedParallel(bool enable) { nested_parallel_ = enable; }
+
+  Map<String, ObjectRef> GetStats() const {
+    Map<String, ObjectRef> stats;
+    stats.Set("nested_launches", ObjectRef(make_object<profiling::CountNode>(
+                                     num_nested_launches_.load(std::memory_order_relaxed))));
+    stats.Set("serialized_launches", ObjectRef(make_object<profiling::CountNode>(
+                                         num_serialized_launches_.load(std::memory_order_relaxed))));
+    idle_policy_.GetStats(&stats);
+    return stats;
+  }
+
  private:
+  /*! \brief Marks the launcher of the calling thread as in use for the duration of a request. */
+  struct LaunchScope {
+    explicit LaunchScope(ParallelLauncher* launcher) : launcher(launcher) {
+      launcher->launching = true;
+    }
+    ~LaunchScope() { launcher->launching = false; }
+    ParallelLauncher* launcher;
+  };
+
+  /*! \brief Busy flag of a worker, padded to a cache line. */
+  struct WorkerState {
+    std::atomic<bool> busy{false};
+    char pad[kL1CacheBytes - sizeof(std::atomic<bool>)];
+  };
+
+  // Mark the workers taking part in a top level request as busy,
+  // so that nested requests do not push into their queues.
+  void MarkBusy(int num_workers) {
+    for (int i = exclude_worker0_; i < num_workers; ++i) {
+      worker_states_[i].busy.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Run the request on the calling thread only.
+  int LaunchSerial(FTVMParallelLambda flambda, void* cdata) {
+    num_serialized_launches_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<int32_t> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    return RunParallelTask(flambda, 0, &env, cdata) == 0 ? 0 : -1;
+  }
+
+  // Launch a request issued from inside a running task, using only idle workers.
+  int LaunchNested(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                   int num_task, int need_sync) {
+    // the main launcher of this thread may still be in use by the enclosing request,
+    // e.g. when task 0 runs on the thread that owns the pool.
+    if (launcher->launching) {
+      launcher = ParallelLauncher::NestedThreadLocal();
+    }
+    if (!nested_parallel_ || launcher->launching) {
+      return LaunchSerial(flambda, cdata);
+    }
+    int num_helpers = (num_task == 0 ? num_workers_used_ : num_task) - 1;
+    std::vector<int>& helpers = launcher->pool_helpers;
+    helpers.clear();
+    for (int i = exclude_worker0_;
+         i < num_workers_used_ && static_cast<int>(helpers.size()) < num_helpers; ++i) {
+      bool expected = false;
+      if (worker_states_[i].busy.compare_exchange_strong(expected, true,
+                                                         std::memory_order_acq_rel)) {
+        helpers.push_back(i);
+      }
+    }
+    // An explicit task count has to be honored as a whole, so we cannot run partially.
+    if (helpers.empty() || (num_task != 0 && static_cast<int>(helpers.size()) < num_helpers)) {
+      for (int i : helpers) {
+        worker_states_[i].busy.store(false, std::memory_order_release);
+      }
+      return LaunchSerial(flambda, cdata);
+    }
+    num_nested_launches_.fetch_add(1, std::memory_order_relaxed);
+    LaunchScope scope(launcher);
+    launcher->launch_time_ns = NowNs();
+    num_task = static_cast<int>(helpers.size()) + 1;
+    launcher->Init(flambda, cdata, num_task, need_sync != 0);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    for (int i = 1; i < num_task; ++i) {
+      tsk.task_id = i;
+      queues_[helpers[i - 1]]->Push(tsk);
+    }
+    // the calling worker runs task 0
+    if (RunParallelTask(flambda, 0, &(launcher->env), cdata) == 0) {
+      launcher->SignalJobFinish();
+    } else {
+      launcher->SignalJobError(0);
+    }
+    return launcher->WaitForJobs();
+  }
+
+  int LaunchWorkStealing(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                         int num_task, int need_sync) {
+    if (num_task == 0) {
+      num_task = num_workers_used_ * chunks_per_worker_;
+    }
+    int num_ranges = std::min(num_task, num_workers_used_);
+    // The barrier needs all tasks in flight at the same time, which only holds
+    // when each participant runs at most one task concurrently with the others.
+    launcher->Init(flambda, cdata, num_task, need_sync != 0 && num_task <= num_workers_used_);
+    launcher->InitWorkStealing(num_ranges);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    MarkBusy(num_ranges);
+    for (int i = exclude_worker0_; i < num_ranges; ++i) {
+      tsk.task_id = i;
+      queues_[i]->Push(tsk);
+    }
+    if (exclude_worker0_) {
+      launcher->RunWorkStealing(0);
+      launcher->SignalJobFinish();
+    }
+    return launcher->WaitForJobs();
+  }
+
   // Internal worker function.
   void RunWorker(int worker_id) {
+    if (numa_node_ >= 0) threading::SetAllocNUMANode(numa_node_);
     SpscTaskQueue* queue = queues_[worker_id].get();
     SpscTaskQueue::Task task;
     ParallelLauncher::ThreadLocal()->is_worker = true;
-    // Initialize the spin count (from envvar TVM_THREAD_POOL_SPIN_COUNT) on
-    // the global first use of the ThreadPool.
-    // TODO(tulloch): should we make this configurable via standard APIs?
-    static size_t spin_count = GetSpinCount();
-    while (queue->Pop(&task, spin_count)) {
+    ParallelLauncher::ThreadLocal()->pool = this;
+    std::atomic<bool>& busy = worker_states_[worker_id].busy;
+    while (queue->Pop(&task, &idle_policy_)) {
       ICHECK(task.launcher != nullptr);
+      idle_policy_.RecordWakeup(NowNs() - task.launcher->launch_time_ns);
+      // The busy flag is released before signaling, so the worker is idle
+      // again by the time the request it took part in completes.
+      if (task.launcher->work_stealing) {
+        task.launcher->RunWorkStealing(task.task_id);
+        busy.store(false, std::memory_order_release);
+        task.launcher->SignalJobFinish();
+        continue;
+      }
       TVMParallelGroupEnv* penv = &(task.launcher->env);
       void* cdata = task.launcher->cdata;
-      if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
+      if (RunParallelTask(task.launcher->flambda, task.task_id, penv, cdata) == 0) {
+        busy.store(false, std::memory_order_release);
         task.launcher->SignalJobFinish();
       } else {
+        busy.store(false, std::memory_order_release);
         task.launcher->SignalJobError(task.task_id);
       }
     }
   }
   int num_workers_;
+  // whether this is a named pool that can be used by several threads
+  bool shared_{false};
+  // serializes the top level requests of a shared pool
+  std::mutex launch_mutex_;
   // number of workers used (can be restricted with affinity pref)
   int num_workers_used_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // the NUMA node of the cpus of a named pool, -1 if not bound to a node
+  int numa_node_{-1};
+  // the policy used to distribute tasks over the workers
+  SchedulePolicy policy_{kStatic};
+  // number of tasks per worker used by work stealing when num_task is not given
+  int chunks_per_worker_{1};
+  // whether requests issued from inside a task may use idle workers
+  bool nested_parallel_{false};
+  // number of nested requests that ran on more than one worker
+  std::atomic<int64_t> num_nested_launches_{0};
+  // number of nested requests that ran on the calling thread only
+  std::atomic<int64_t> num_serialized_launches_{0};
+  // how idle workers wait for the next request
+  IdlePolicy idle_policy_;
+  std::vector<WorkerState> worker_states_;
   std::vector<std::unique_ptr<SpscTaskQueue> > queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
 
+/*! \brief The named thread pools of the process. */
+class NamedThreadPoolRegistry {
+ public:
+  void Create(const std::string& name, const std::vector<unsigned int>& cpus, int numa_node) {
+    ICHECK(!cpus.empty()) << "Thread pool " << name << " needs at least one cpu";
+    std::lock_guard<std::mutex> lock(mutex_);
+    ICHECK(!pools_.count(name)) << "Thread pool " << name << " already exists";
+    pools_[name].reset(new ThreadPool(static_cast<int>(cpus.size()), cpus, numa_node));
+  }
+
+  ThreadPool* Get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pools_.find(name);
+    ICHECK(it != pools_.end()) << "Thread pool " << name << " has not been created";
+    return it->second.get();
+  }
+
+  static NamedThreadPoolRegistry* Global() {
+    // intentionally leaked, so that the workers outlive any executor using them
+    static NamedThreadPoolRegistry* inst = new NamedThreadPoolRegistry();
+    return inst;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<ThreadPool>> pools_;
+};
+
+namespace threading {
+
+void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus,
+                      int numa_node) {
+  NamedThreadPoolRegistry::Global()->Create(name, cpus, numa_node);
+}
+
+ThreadPoolScope::ThreadPoolScope(const std::string& name) {
+  if (name.empty()) return;
+  ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
+  prev_pool_ = launcher->bound_pool;
+  launcher->bound_pool = NamedThreadPoolRegistry::Global()->Get(name);
+  // The buffers allocated while running on the pool are local to its cpus.
+  prev_numa_node_ = GetAllocNUMANode();
+  if (launcher->bound_pool->numa_node() >= 0) {
+    SetAllocNUMANode(launcher->bound_pool->numa_node());
+  }
+  active_ = true;
+}
+
+ThreadPoolScope::~ThreadPoolScope() {
+  if (active_) {
+    ParallelLauncher::ThreadLocal()->bound_pool = static_cast<ThreadPool*>(prev_pool_);
+    SetAllocNUMANode(prev_numa_node_);
+  }
+}
+
+}  // namespace threading
+
 TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRetValue* rv) {
   threading::ThreadGroup::AffinityMode mode =
       static_cast<threading::ThreadGroup::AffinityMode>(static_cast<int>(args[0]));
   int nthreads = args[1];
   ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(mode, nthreads);
+  if (args.size() >= 3) {
+    std::string policy = args[2];
+    int chunks_per_worker = args.size() >= 4 ? args[3].operator int() : 1;
+    ThreadPool::SchedulePolicy p = ThreadPool::kStatic;
+    if (policy == "work_stealing") {
+      p = ThreadPool::kWorkStealing;
+    } else {
+      ICHECK_EQ(policy, "static") << "Unknown thread pool schedule policy " << policy;
+    }
+    ThreadPool::ThreadLocal()->UpdateSchedulePolicy(p, chunks_per_worker);
+  }
+});
+
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_nested").set_body_typed([](bool enable) {
+  ThreadPool::ThreadLocal()->UpdateNestedParallel(enable);
+});
+
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_idle")
+    .set_body_typed([](std::string policy, int64_t max_spin_ns) {
+      ICHECK(policy == "fixed" || policy == "adaptive")
+          << "Unknown thread pool idle policy " << policy;
+      ThreadPool::ThreadLocal()->UpdateIdlePolicy(policy == "adaptive", max_spin_ns);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.threadpool_stats").set_body_typed([]() {
+  return ThreadPool::ThreadLocal()->GetStats();
+});
+
+TVM_REGISTER_GLOBAL("runtime.threadpool_create")
+    .set_body_typed([](String name, ShapeTuple cpus, int numa_node) {
+      std::vector<unsigned int> cpu_ids(cpus.begin(), cpus.end());
+      if (numa_node >= 0) {
+        cpu_ids = threading::NUMANodeCPUs(numa_node);
+        ICHECK(!cpu_ids.empty()) << "Cannot find the cpus of NUMA node " << numa_node;
+      }
+      threading::CreateThreadPool(name, cpu_ids, numa_node);
+    });
+
+TVM_REGISTER_GLOBAL("runtime.numa_node_count").set_body_typed([]() {
+  return threading::NUMANodeCount();
+});
+
+TVM_REGISTER_GLOBAL("runtime.numa_set_alloc_node").set_body_typed([](int node) {
+  ICHECK_LT(node, threading::NUMANodeCount()) << "The system has no NUMA node " << node;
+  return threading::SetAllocNUMANode(node);
 });
 
 }  // namespace runtime
@@ -369,11 +946,11 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     TVMParallelGroupEnv env;
     env.num_task = 1;
     env.sync_handle = &sync_counter;
-    (*flambda)(0, &env, cdata);
+    tvm::runtime::RunParallelTask(flambda, 0, &env, cdata);
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
-    int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
+    int res = tvm::runtime::ThreadPool::Current()->Launch(flambda, cdata, num_task, 1);
     return res;
 #else
     if (num_task == 0) num_task = num_workers;
@@ -382,7 +959,7 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     {
       TVMParallelGroupEnv env;
       env.num_task = num_task;
-      (*flambda)(omp_get_thread_num(), &env, cdata);
+      tvm::runtime::RunParallelTask(flambda, omp_get_thread_num(), &env, cdata);
     }
     return 0;
 #endif
@@ -396,6 +973,12 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
   using tvm::runtime::kSyncStride;
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
+  if (sync_counter == nullptr) {
+    TVMAPISetLastError(
+        "TVMBackendParallelBarrier is not supported when the parallel tasks outnumber the "
+        "workers, e.g. in work_stealing mode with chunks_per_worker > 1");
+    return -1;
+  }
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
   for (int i = 0; i < num_task; ++i) {
     if (i != task_id) {
@@ -25,7 +25,9 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <string>
 #include <thread>
+#include <vector>
 #if defined(__linux__) || defined(__ANDROID__)
 #include <fstream>
 #include <sstream>
@@ -60,7 +62,13 @@ class ThreadGroup::Impl {
     }
   }
 
-  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0) {
+  int Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
+                const std::vector<unsigned int>& cpus) {
+    if (!cpus.empty()) {
+      int num_workers_used = std::min(num_workers_, nthreads ? nthreads : num_workers_);
+      SetAffinity(exclude_worker0, cpus);
+      return num_workers_used;
+    }
     int num_workers_used = 0;
     if (mode == kLittle) {
       num_workers_used = little_count_;
@@ -140,6 +148,29 @@ class ThreadGroup::Impl {
 #endif
   }
 
+  // bind worker threads to the given cpus, in the order of the worker ids.
+  // the main thread, if it runs task 0, may migrate over all given cpus.
+  void SetAffinity(bool exclude_worker0, const std::vector<unsigned int>& cpus) {
+#if defined(__linux__)
+    for (unsigned i = 0; i < threads_.size(); ++i) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpus[(i + exclude_worker0) % cpus.size()], &cpuset);
+      pthread_setaffinity_np(threads_[i].native_handle(), sizeof(cpu_set_t), &cpuset);
+    }
+    if (exclude_worker0) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      for (unsigned int cpu : cpus) {
+        CPU_SET(cpu, &cpuset);
+      }
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    }
+#else
+    LOG(WARNING) << "Binding thread pool workers to given cpus is not supported on this platform";
+#endif
+  }
+
   void SetMasterThreadFullCpuAffinity(bool reverse) {
 #if defined(__linux__) || defined(__ANDROID__)
     cpu_set_t cpuset;
@@ -231,8 +262,9 @@ ThreadGroup::ThreadGroup(int num_workers, std::function<void(int)> worker_callba
 ThreadGroup::~ThreadGroup() { delete impl_; }
 void ThreadGroup::Join() { impl_->Join(); }
 
-int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0) {
-  return impl_->Configure(mode, nthreads, exclude_worker0);
+int ThreadGroup::Configure(AffinityMode mode, int nthreads, bool exclude_worker0,
+                           const std::vector<unsigned int>& cpus) {
+  return impl_->Configure(mode, nthreads, exclude_worker0, cpus);
 }
 
 void Yield() { std::this_thread::yield(); }
@@ -265,6 +297,47 @@ int MaxConcurrency() {
   return std::max(max_concurrency, 1);
 }
 
+namespace {
+// Read a sysfs id list of the form "0-3,8-11".
+std::vector<unsigned int> ReadIdList(const std::string& path) {
+  std::vector<unsigned int> ids;
+#if defined(__linux__)
+  std::ifstream ifs(path);
+  std::string range;
+  while (!ifs.fail() && std::getline(ifs, range, ',')) {
+    if (range.find_first_of("0123456789") == std::string::npos) continue;
+    size_t dash = range.find('-');
+    unsigned int begin = std::stoul(range.substr(0, dash));
+    unsigned int end = dash == std::string::npos ? begin : std::stoul(range.substr(dash + 1));
+    for (unsigned int id = begin; id <= end; ++id) {
+      ids.push_back(id);
+    }
+  }
+#endif
+  return ids;
+}
+
+// The NUMA node the CPU allocations of this thread are placed on.
+thread_local int alloc_numa_node = -1;
+}  // namespace
+
+std::vector<unsigned int> NUMANodeCPUs(int node) {
+  return ReadIdList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+}
+
+int NUMANodeCount() {
+  std::vector<unsigned int> nodes = ReadIdList("/sys/devices/system/node/online");
+  return nodes.empty() ? 1 : static_cast<int>(nodes.back()) + 1;
+}
+
+int SetAllocNUMANode(int node) {
+  int prev = alloc_numa_node;
+  alloc_numa_node = node;
+  return prev;
+}
+
+int GetAllocNUMANode() { return alloc_numa_node; }
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
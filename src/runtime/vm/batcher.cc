@@ -0,0 +1,305 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/batcher.cc
+ * \brief Coalesce concurrent requests into batched invocations of a VM function.
+ *
+ *  The requests submitted by concurrent callers are queued. The oldest queued
+ *  request acts as the leader: it waits until the batch is full or its latency
+ *  budget has expired, concatenates the inputs of the compatible requests along
+ *  the leading axis, invokes the VM once and splits the outputs back.
+ */
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/vm/vm.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*! \brief Batching frontend of a VirtualMachine module. */
+class VirtualMachineBatcher : public ModuleNode {
+ public:
+  /*!
+   * \brief Create a batcher.
+   * \param vm The VirtualMachine module, initialized with its devices.
+   * \param func_name The function to invoke. Its inputs and outputs must have a
+   *  dynamic leading batch dimension.
+   * \param max_batch_size The maximum number of rows of a batched invocation.
+   * \param timeout_us How long the oldest request waits for others to join.
+   */
+  VirtualMachineBatcher(Module vm, std::string func_name, int64_t max_batch_size,
+                        int64_t timeout_us)
+      : vm_(vm),
+        func_name_(func_name),
+        max_batch_size_(max_batch_size),
+        timeout_(timeout_us) {
+    ICHECK_GE(max_batch_size_, 1) << "max_batch_size must be positive";
+    ICHECK_GE(timeout_us, 0) << "timeout must not be negative";
+    set_input_ = vm_.GetFunction("set_input");
+    invoke_ = vm_.GetFunction("invoke");
+    ICHECK(set_input_ != nullptr && invoke_ != nullptr)
+        << "VirtualMachineBatcher expects a VirtualMachine module";
+  }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "submit") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        std::vector<NDArray> inputs;
+        for (int i = 0; i < args.size(); ++i) {
+          inputs.push_back(args[i].operator NDArray());
+        }
+        *rv = this->Submit(std::move(inputs));
+      });
+    } else if (name == "get_stats") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetStats(); });
+    }
+    return PackedFunc();
+  }
+
+  const char* type_key() const final { return "VirtualMachineBatcher"; }
+
+  /*!
+   * \brief Run one request, possibly batched with concurrent ones.
+   * \param inputs The inputs of the request, each with a leading batch dimension.
+   * \return The outputs of the request.
+   */
+  ObjectRef Submit(std::vector<NDArray> inputs) {
+    ICHECK(!inputs.empty()) << "a batched request needs at least one input";
+    for (const NDArray& input : inputs) {
+      ICHECK_GE(input->ndim, 1) << "batched inputs need a leading batch dimension";
+      ICHECK_EQ(input->shape[0], inputs[0]->shape[0])
+          << "the inputs of a request must have the same batch size";
+    }
+    Request req;
+    req.inputs = std::move(inputs);
+    req.arrival = Clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.push_back(&req);
+    cv_.notify_all();
+    while (!req.done) {
+      if (!leader_active_ && queue_.front() == &req) {
+        leader_active_ = true;
+        Clock::time_point deadline = req.arrival + timeout_;
+        cv_.wait_until(lock, deadline, [this] { return QueuedRows() >= max_batch_size_; });
+        std::vector<Request*> batch = TakeBatch();
+        lock.unlock();
+        RunBatch(batch);
+        lock.lock();
+        for (Request* r : batch) r->done = true;
+        leader_active_ = false;
+        cv_.notify_all();
+      } else {
+        cv_.wait(lock);
+      }
+    }
+    lock.unlock();
+    if (!req.error.empty()) {
+      LOG(FATAL) << req.error;
+    }
+    return req.result;
+  }
+
+  /*! \brief Number of batched invocations and requests served so far. */
+  Map<String, ObjectRef> GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Map<String, ObjectRef> stats;
+    stats.Set("batches", ObjectRef(make_object<profiling::CountNode>(num_batches_)));
+    stats.Set("requests", ObjectRef(make_object<profiling::CountNode>(num_requests_)));
+    return stats;
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    std::vector<NDArray> inputs;
+    Clock::time_point arrival;
+    ObjectRef result;
+    std::string error;
+    bool done{false};
+  };
+
+  static int64_t Rows(const Request* req) { return req->inputs[0]->shape[0]; }
+
+  /*! \brief Whether two requests can share an invocation: same dtypes and trailing dims. */
+  static bool Compatible(const Request* a, const Request* b) {
+    if (a->inputs.size() != b->inputs.size()) return false;
+    for (size_t i = 0; i < a->inputs.size(); ++i) {
+      const DLTensor* x = a->inputs[i].operator->();
+      const DLTensor* y = b->inputs[i].operator->();
+      if (x->ndim != y->ndim || x->dtype.code != y->dtype.code ||
+          x->dtype.bits != y->dtype.bits || x->dtype.lanes != y->dtype.lanes ||
+          x->device.device_type != y->device.device_type ||
+          x->device.device_id != y->device.device_id) {
+        return false;
+      }
+      for (int d = 1; d < x->ndim; ++d) {
+        if (x->shape[d] != y->shape[d]) return false;
+      }
+    }
+    return true;
+  }
+
+  // Requires mutex_.
+  int64_t QueuedRows() const {
+    int64_t rows = 0;
+    for (const Request* r : queue_) rows += Rows(r);
+    return rows;
+  }
+
+  // Requires mutex_. The front request is always taken, even when it exceeds the batch size.
+  std::vector<Request*> TakeBatch() {
+    std::vector<Request*> batch{queue_.front()};
+    queue_.pop_front();
+    int64_t rows = Rows(batch[0]);
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (rows + Rows(*it) <= max_batch_size_ && Compatible(batch[0], *it)) {
+        rows += Rows(*it);
+        batch.push_back(*it);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return batch;
+  }
+
+  /*! \brief A view of rows [begin, begin + rows) of a contiguous array. */
+  static DLTensor RowView(const NDArray& array, int64_t begin, int64_t rows,
+                          std::vector<int64_t>* shape) {
+    DLTensor view = *array.operator->();
+    shape->assign(view.shape, view.shape + view.ndim);
+    int64_t total = (*shape)[0];
+    (*shape)[0] = rows;
+    view.shape = shape->data();
+    view.strides = nullptr;
+    view.byte_offset += total == 0 ? 0 : GetDataSize(*array.operator->()) / total * begin;
+    return view;
+  }
+
+  static NDArray Concat(const std::vector<Request*>& batch, size_t index, int64_t rows) {
+    const NDArray& first = batch[0]->inputs[index];
+    std::vector<int64_t> shape(first->shape, first->shape + first->ndim);
+    shape[0] = rows;
+    NDArray out = NDArray::Empty(shape, first->dtype, first->device);
+    int64_t begin = 0;
+    std::vector<int64_t> view_shape;
+    for (Request* r : batch) {
+      const NDArray& input = r->inputs[index];
+      DLTensor dst = RowView(out, begin, input->shape[0], &view_shape);
+      NDArray::CopyFromTo(input.operator->(), &dst);
+      begin += input->shape[0];
+    }
+    return out;
+  }
+
+  static NDArray Slice(const NDArray& array, int64_t begin, int64_t rows) {
+    std::vector<int64_t> view_shape;
+    DLTensor src = RowView(array, begin, rows, &view_shape);
+    NDArray out = NDArray::Empty(view_shape, array->dtype, array->device);
+    out.CopyFrom(&src);
+    return out;
+  }
+
+  ObjectRef Split(const ObjectRef& output, int64_t begin, int64_t rows, int64_t total) {
+    if (const auto* adt = output.as<ADTObj>()) {
+      std::vector<ObjectRef> fields;
+      for (size_t i = 0; i < adt->size; ++i) {
+        fields.push_back(Split((*adt)[i], begin, rows, total));
+      }
+      return ADT(adt->tag, fields);
+    }
+    NDArray array = Downcast<NDArray>(output);
+    ICHECK(array->ndim >= 1 && array->shape[0] == total)
+        << "output of " << func_name_ << " does not have a leading batch dimension of " << total;
+    return Slice(array, begin, rows);
+  }
+
+  void RunBatch(const std::vector<Request*>& batch) {
+    try {
+      int64_t total = 0;
+      for (Request* r : batch) total += Rows(r);
+      size_t num_inputs = batch[0]->inputs.size();
+      std::vector<NDArray> batched(num_inputs);
+      for (size_t i = 0; i < num_inputs; ++i) {
+        batched[i] = batch.size() == 1 ? batch[0]->inputs[i] : Concat(batch, i, total);
+      }
+      std::vector<TVMValue> values(num_inputs + 1);
+      std::vector<int> codes(num_inputs + 1);
+      TVMArgsSetter setter(values.data(), codes.data());
+      setter(0, func_name_);
+      for (size_t i = 0; i < num_inputs; ++i) setter(i + 1, batched[i]);
+      TVMRetValue rv;
+      set_input_.CallPacked(TVMArgs(values.data(), codes.data(), num_inputs + 1), &rv);
+      ObjectRef output = invoke_(func_name_);
+      int64_t begin = 0;
+      for (Request* r : batch) {
+        r->result = batch.size() == 1 ? output : Split(output, begin, Rows(r), total);
+        begin += Rows(r);
+      }
+    } catch (const std::exception& e) {
+      for (Request* r : batch) r->error = e.what();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_batches_ += 1;
+    num_requests_ += batch.size();
+  }
+
+  /*! \brief The VirtualMachine module, only used by the current leader. */
+  Module vm_;
+  std::string func_name_;
+  int64_t max_batch_size_;
+  std::chrono::microseconds timeout_;
+  PackedFunc set_input_;
+  PackedFunc invoke_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /*! \brief The requests waiting to be batched, in arrival order. */
+  std::deque<Request*> queue_;
+  /*! \brief Whether a request is currently collecting or running a batch. */
+  bool leader_active_{false};
+  int64_t num_batches_{0};
+  int64_t num_requests_{0};
+};
+
+TVM_REGISTER_GLOBAL("runtime._VirtualMachineBatcher")
+    .set_body_typed([](Module vm, String func_name, int64_t max_batch_size, int64_t timeout_us) {
+      return Module(
+          make_object<VirtualMachineBatcher>(vm, func_name, max_batch_size, timeout_us));
+    });
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,302 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/cuda_graph/vm_cuda_graph.cc
+ * \brief Virtual machine replaying CUDA graphs captured per input shape signature.
+ */
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/vm/vm.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+#include "../../cuda/cuda_graph_cache.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief Virtual machine launching its functions as CUDA graphs.
+ *
+ *  The first time a function is invoked with a given signature of input shapes,
+ *  it is run normally and then captured from the CUDA stream of the VM into a
+ *  graph. The graph owns copies of the inputs and keeps the memory of every
+ *  storage allocated during the capture, so later invocations with the same
+ *  signature only copy the inputs in and relaunch it. The captured graphs are
+ *  kept in an LRU cache.
+ *
+ *  A function is run with kernel launches instead when it cannot be captured,
+ *  e.g. when it synchronizes with the host to copy a tensor back for shape
+ *  computation, or when some of its inputs are not on the GPU.
+ *
+ * \note The outputs of a replayed graph are the same arrays for every launch
+ *  of that graph and are overwritten by the next invocation with that signature.
+ */
+class VirtualMachineCudaGraph : public VirtualMachine {
+ public:
+  /*! \brief The number of graphs kept by default. */
+  static constexpr size_t kDefaultCacheSize = 8;
+
+  VirtualMachineCudaGraph() : graphs_(kDefaultCacheSize) {}
+
+  ~VirtualMachineCudaGraph() {
+    graphs_.Clear();
+    if (stream_ != nullptr) {
+      TVMStreamFree(kDLCUDA, stream_device_id_, stream_);
+    }
+  }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
+
+ private:
+  /*! \brief The state baked into a captured graph. */
+  struct CapturedState {
+    /*! \brief The arguments the graph was captured with. */
+    std::vector<ObjectRef> args;
+    /*! \brief The tensors of args, in the order of FlattenTensors. */
+    std::vector<NDArray> inputs;
+    /*! \brief The memory written by the graph. */
+    std::vector<ObjectRef> retained;
+    /*! \brief The result of the captured invocation, updated by every launch. */
+    ObjectRef result;
+  };
+
+  /*!
+   * \brief Append the tensors of an argument to tensors.
+   * \return false if the argument holds something else than tensors on the GPU.
+   */
+  static bool FlattenTensors(const ObjectRef& arg, std::vector<NDArray>* tensors) {
+    if (const auto* adt = arg.as<ADTObj>()) {
+      for (size_t i = 0; i < adt->size; ++i) {
+        if (!FlattenTensors((*adt)[i], tensors)) return false;
+      }
+      return true;
+    }
+    if (const auto* array = arg.as<NDArray::Container>()) {
+      if (array->dl_tensor.device.device_type != kDLCUDA) return false;
+      tensors->push_back(GetRef<NDArray>(array));
+      return true;
+    }
+    return false;
+  }
+
+  /*! \brief The shape signature of the arguments of a function. */
+  static std::string Signature(const std::string& func_name, const std::vector<ObjectRef>& args) {
+    std::ostringstream os;
+    os << func_name;
+    for (const ObjectRef& arg : args) {
+      os << ';';
+      AppendSignature(arg, &os);
+    }
+    return os.str();
+  }
+
+  static void AppendSignature(const ObjectRef& arg, std::ostringstream* os) {
+    if (const auto* adt = arg.as<ADTObj>()) {
+      *os << '(';
+      for (size_t i = 0; i < adt->size; ++i) {
+        if (i != 0) *os << ',';
+        AppendSignature((*adt)[i], os);
+      }
+      *os << ')';
+      return;
+    }
+    NDArray array = Downcast<NDArray>(arg);
+    *os << DLDataType2String(array->dtype) << '@' << array->device.device_id << '[';
+    for (int i = 0; i < array->ndim; ++i) {
+      if (i != 0) *os << ',';
+      *os << array->shape[i];
+    }
+    *os << ']';
+  }
+
+  /*! \brief Make an argument of the same structure backed by fresh tensors. */
+  static ObjectRef CloneArg(const ObjectRef& arg, std::vector<NDArray>* inputs) {
+    if (const auto* adt = arg.as<ADTObj>()) {
+      std::vector<ObjectRef> fields;
+      for (size_t i = 0; i < adt->size; ++i) {
+        fields.push_back(CloneArg((*adt)[i], inputs));
+      }
+      return ADT(adt->tag, fields);
+    }
+    NDArray array = Downcast<NDArray>(arg);
+    NDArray copy = NDArray::Empty(array.Shape(), array->dtype, array->device);
+    inputs->push_back(copy);
+    return copy;
+  }
+
+  /*! \brief Copy the tensors of the arguments into the inputs of a graph on the VM stream. */
+  void CopyInputs(const std::vector<NDArray>& tensors, const std::vector<NDArray>& inputs) {
+    ICHECK_EQ(tensors.size(), inputs.size());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      NDArray::CopyFromTo(tensors[i].operator->(), const_cast<DLTensor*>(inputs[i].operator->()),
+                          stream_);
+    }
+  }
+
+  /*! \brief Get the stream graphs are captured and launched on. */
+  cudaStream_t Stream(int device_id) {
+    if (stream_ == nullptr) {
+      stream_device_id_ = device_id;
+      TVMStreamCreate(kDLCUDA, device_id, &stream_);
+    }
+    ICHECK_EQ(stream_device_id_, device_id) << "CUDA graphs are only supported on a single GPU";
+    return static_cast<cudaStream_t>(stream_);
+  }
+
+  /*!
+   * \brief Run a function, capturing it as a graph for a new signature and
+   *  replaying the graph otherwise.
+   */
+  ObjectRef InvokeCudaGraph(const std::string& func_name);
+
+  /*! \brief Capture func with the tensors of args and insert the graph under key. */
+  void Capture(const std::string& key, const VMFunction& func, const std::vector<ObjectRef>& args,
+               const std::vector<NDArray>& tensors);
+
+  /*! \brief The captured graphs keyed by their signature. */
+  CudaGraphCache<CapturedState> graphs_;
+  TVMStreamHandle stream_{nullptr};
+  int stream_device_id_{0};
+  int64_t hits_{0};
+  int64_t captures_{0};
+  int64_t fallbacks_{0};
+};
+
+ObjectRef VirtualMachineCudaGraph::InvokeCudaGraph(const std::string& func_name) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  auto git = exec_->global_map.find(func_name);
+  ICHECK(git != exec_->global_map.end())
+      << "Cannot find function " << func_name << " in the executable";
+  const VMFunction& func = exec_->GetVMFunction(git->second);
+  std::vector<ObjectRef> args;
+  if (!func.params.empty()) {
+    auto it = inputs_.find(func_name);
+    ICHECK(it != inputs_.end()) << "Input has not been set for function " << func_name;
+    args = it->second;
+  }
+
+  std::vector<NDArray> tensors;
+  bool capturable = true;
+  for (const ObjectRef& arg : args) {
+    capturable = capturable && FlattenTensors(arg, &tensors);
+  }
+  if (!capturable || tensors.empty()) {
+    // The device the graph would run on is only known from the inputs.
+    fallbacks_ += 1;
+    return Invoke(func, args);
+  }
+
+  std::string key = Signature(func_name, args);
+  auto* entry = graphs_.Find(key);
+  if (entry == nullptr) {
+    // Run once without capture so the kernels are loaded and the constants are
+    // on the device, both of which are not allowed while capturing.
+    ObjectRef result = Invoke(func, args);
+    Capture(key, func, args, tensors);
+    return result;
+  }
+  if (entry->exec == nullptr) {
+    fallbacks_ += 1;
+    return Invoke(func, args);
+  }
+  cudaStream_t stream = Stream(tensors[0]->device.device_id);
+  CopyInputs(tensors, entry->state.inputs);
+  CUDA_CALL(cudaGraphLaunch(entry->exec, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  hits_ += 1;
+  return entry->state.result;
+}
+
+void VirtualMachineCudaGraph::Capture(const std::string& key, const VMFunction& func,
+                                      const std::vector<ObjectRef>& args,
+                                      const std::vector<NDArray>& tensors) {
+  int device_id = tensors[0]->device.device_id;
+  cudaStream_t stream = Stream(device_id);
+  CapturedState state;
+  for (const ObjectRef& arg : args) {
+    state.args.push_back(CloneArg(arg, &state.inputs));
+  }
+  CopyInputs(tensors, state.inputs);
+  CUDA_CALL(cudaStreamSynchronize(stream));
+
+  cudaGraphExec_t exec = nullptr;
+  TVMSetStream(kDLCUDA, device_id, stream_);
+  retained_objects_ = &state.retained;
+  try {
+    // Relaxed mode lets the allocators grow their pools while capturing.
+    CudaGraphBeginCapture(stream, cudaStreamCaptureModeRelaxed);
+    state.result = Invoke(func, state.args);
+    exec = CudaGraphEndCapture(stream);
+    captures_ += 1;
+  } catch (const std::exception& e) {
+    CudaGraphAbortCapture(stream);
+    frames_.clear();
+    state = CapturedState();
+    fallbacks_ += 1;
+    LOG(WARNING) << "Cannot capture " << key << " as a CUDA graph, using kernel launches instead: "
+                 << e.what();
+  }
+  retained_objects_ = nullptr;
+  TVMSetStream(kDLCUDA, device_id, nullptr);
+  graphs_.Insert(key, exec, std::move(state));
+}
+
+PackedFunc VirtualMachineCudaGraph::GetFunction(const std::string& name,
+                                                const ObjectPtr<Object>& sptr_to_self) {
+  if (name == "invoke_cuda_graph") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->InvokeCudaGraph(args[0]);
+    });
+  } else if (name == "set_cuda_graph_cache_size") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int64_t size = args[0];
+      ICHECK_GE(size, 1) << "CUDA graph cache size must be positive";
+      graphs_.SetCapacity(static_cast<size_t>(size));
+    });
+  } else if (name == "get_cuda_graph_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::ostringstream os;
+      os << "{\"hits\": " << hits_ << ", \"captures\": " << captures_
+         << ", \"fallbacks\": " << fallbacks_ << ", \"evictions\": " << graphs_.evictions()
+         << ", \"size\": " << graphs_.size() << ", \"capacity\": " << graphs_.capacity() << "}";
+      *rv = os.str();
+    });
+  }
+  return VirtualMachine::GetFunction(name, sptr_to_self);
+}
+
+TVM_REGISTER_GLOBAL("runtime._VirtualMachineCudaGraph")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      runtime::Module mod = args[0];
+      const auto* exec = dynamic_cast<Executable*>(mod.operator->());
+      ICHECK(exec) << "The virtual machine executable has not been defined yet.";
+      auto vm = make_object<VirtualMachineCudaGraph>();
+      vm->LoadExecutable(exec);
+      *rv = runtime::Module(vm);
+    });
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
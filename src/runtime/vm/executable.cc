@@ -24,6 +24,7 @@
 
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/vm/executable.h>
 #include <tvm/runtime/vm/vm.h>
@@ -39,6 +40,7 @@
 
 #include "../file_utils.h"
 #include "../library_module.h"
+#include "../memory_accounting.h"
 #include "serialize_utils.h"
 
 namespace tvm {
@@ -76,6 +78,11 @@ PackedFunc Executable::GetFunction(const std::string& name, const ObjectPtr<Obje
       int index = args[1];
       *rv = this->GetFunctionParameterName(func_name, index);
     });
+  } else if (name == "get_num_loaded_sections") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      auto loaded = this->NumLoadedSections();
+      *rv = ShapeTuple({static_cast<int64_t>(loaded.first), static_cast<int64_t>(loaded.second)});
+    });
   } else if (name == "vm_load_executable") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       auto vm = make_object<VirtualMachine>();
@@ -112,7 +119,119 @@ std::string Executable::GetFunctionParameterName(std::string func_name, uint32_t
   return func.params[index];
 }
 
+const VMFunction& Executable::GetVMFunction(Index index) const {
+  ICHECK_LT(static_cast<size_t>(index), functions.size()) << "Invalid function index " << index;
+  if (lazy_functions_ && !lazy_functions_[index].loaded.load(std::memory_order_acquire)) {
+    LoadFunction(index);
+  }
+  return functions[index];
+}
+
+const ObjectRef& Executable::GetConstant(Index index) const {
+  ICHECK_LT(static_cast<size_t>(index), constants.size()) << "Invalid constant index " << index;
+  if (lazy_constants_ && !lazy_constants_[index].loaded.load(std::memory_order_acquire)) {
+    LoadConstant(index);
+  }
+  return constants[index];
+}
+
+ObjectRef Executable::GetDeviceConstant(Index index, Device dev) const {
+  std::pair<int, int> key(dev.device_type, dev.device_id);
+  {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    auto it = device_constants_.find(key);
+    if (it != device_constants_.end() && static_cast<size_t>(index) < it->second.size() &&
+        it->second[index].defined()) {
+      return it->second[index];
+    }
+  }
+  // Copy outside of the lock, the VMs racing on the same constant keep the first copy.
+  ObjectRef constant = GetConstant(index);
+  if (const auto* arr = constant.as<NDArray::Container>()) {
+    const DLDevice& src = arr->dl_tensor.device;
+    if (src.device_type != dev.device_type || src.device_id != dev.device_id) {
+      MemoryAccountingScope accounting(MemoryCategory::kParams);
+      constant = GetRef<NDArray>(arr).CopyTo(dev);
+    }
+  }
+  std::lock_guard<std::mutex> lock(shared_mutex_);
+  std::vector<ObjectRef>& pool = device_constants_[key];
+  if (pool.size() < constants.size()) pool.resize(constants.size());
+  if (!pool[index].defined()) pool[index] = constant;
+  return pool[index];
+}
+
+const std::vector<PackedFunc>& Executable::GetPackedFuncs() const {
+  std::lock_guard<std::mutex> lock(shared_mutex_);
+  if (!packed_funcs_.empty() || primitive_map.empty()) return packed_funcs_;
+  runtime::Module lib = GetLib();
+  ICHECK(lib.operator->()) << "If the executable has declared primitive functions, the"
+                           << "generated kernel library must non-be null.";
+  std::vector<PackedFunc> funcs;
+  for (const auto& it : primitive_map) {
+    const auto& packed_name = it.first;
+    auto packed_index = static_cast<size_t>(it.second);
+    if (funcs.size() <= packed_index) {
+      funcs.resize(packed_index + 1);
+    }
+    tvm::runtime::PackedFunc pf = lib.GetFunction(packed_name, true);
+    ICHECK(pf != nullptr) << "Cannot find function in module: " << packed_name;
+    funcs[packed_index] = pf;
+  }
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    ICHECK(funcs[i] != nullptr) << "Packed function " << i << " is not initialized";
+  }
+  packed_funcs_ = std::move(funcs);
+  return packed_funcs_;
+}
+
+void Executable::LoadAllSections() const {
+  for (size_t i = 0; i < constants.size(); ++i) GetConstant(i);
+  for (size_t i = 0; i < functions.size(); ++i) GetVMFunction(i);
+}
+
+std::pair<size_t, size_t> Executable::NumLoadedSections() const {
+  auto count = [](const std::unique_ptr<LazyEntry[]>& entries, size_t size) {
+    if (!entries) return size;
+    size_t n = 0;
+    for (size_t i = 0; i < size; ++i) n += entries[i].loaded.load(std::memory_order_acquire);
+    return n;
+  };
+  return {count(lazy_constants_, constants.size()), count(lazy_functions_, functions.size())};
+}
+
+void Executable::LoadConstant(Index index) const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  LazyEntry& entry = lazy_constants_[index];
+  if (entry.loaded.load(std::memory_order_relaxed)) return;
+  dmlc::MemoryFixedSizeStream reader(const_cast<char*>(code_.data()) + entry.begin,
+                                     entry.end - entry.begin);
+  runtime::NDArray constant;
+  STREAM_CHECK(constant.Load(&reader), "constant");
+  constants[index] = constant;
+  entry.loaded.store(true, std::memory_order_release);
+}
+
+void Executable::LoadFunction(Index index) const {
+  std::lock_guard<std::mutex> lock(lazy_mutex_);
+  LazyEntry& entry = lazy_functions_[index];
+  if (entry.loaded.load(std::memory_order_relaxed)) return;
+  dmlc::MemoryFixedSizeStream reader(const_cast<char*>(code_.data()) + entry.begin,
+                                     entry.end - entry.begin);
+  dmlc::Stream* strm = &reader;
+  std::vector<Instruction> instructions;
+  instructions.reserve(entry.num_instructions);
+  for (size_t j = 0; j < entry.num_instructions; j++) {
+    VMInstructionSerializer instr;
+    STREAM_CHECK(instr.Load(strm), "code/instruction");
+    instructions.push_back(DeserializeInstruction(instr));
+  }
+  functions[index].instructions = std::move(instructions);
+  entry.loaded.store(true, std::memory_order_release);
+}
+
 std::string Executable::GetBytecode() const {
+  LoadAllSections();
   std::ostringstream oss;
 
   for (size_t i = 0; i < functions.size(); ++i) {
@@ -147,6 +266,7 @@ std::string Executable::GetBytecode() const {
 }
 
 std::string Executable::Stats() const {
+  LoadAllSections();
   std::ostringstream oss;
   oss << "Relay VM executable statistics:" << std::endl;
 
@@ -208,6 +328,11 @@ void SaveHeader(dmlc::Stream* strm) {
 }
 
 TVMByteArray Executable::Save() {
+  // The lazy entries point into the code which is about to be overwritten.
+  LoadAllSections();
+  lazy_constants_.reset();
+  lazy_functions_.reset();
+
   // Initialize the stream object.
   code_.clear();
   dmlc::MemoryStringStream strm(&code_);
@@ -249,18 +374,23 @@ void Executable::SaveGlobalSection(dmlc::Stream* strm) {
 }
 
 void Executable::SaveConstantSection(dmlc::Stream* strm) {
-  std::vector<DLTensor*> arrays;
-  for (const auto& obj : this->constants) {
-    const auto cell = Downcast<runtime::NDArray>(obj);
-    arrays.push_back(const_cast<DLTensor*>(cell.operator->()));
-  }
   strm->Write(static_cast<uint64_t>(this->constants.size()));
-  for (const auto& it : arrays) {
-    runtime::SaveDLTensor(strm, it);
-  }
-
   // Save the const to device mapping.
   strm->Write(this->const_device_type);
+
+  // Save the constants after a table of their offsets, so that they can be loaded on demand.
+  std::string data;
+  dmlc::MemoryStringStream data_strm(&data);
+  std::vector<uint64_t> offsets;
+  for (const auto& obj : this->constants) {
+    offsets.push_back(data.size());
+    const auto cell = Downcast<runtime::NDArray>(obj);
+    runtime::SaveDLTensor(&data_strm, cell.operator->());
+  }
+  offsets.push_back(data.size());
+  strm->Write(offsets);
+  strm->Write(static_cast<uint64_t>(data.size()));
+  strm->Write(data.data(), data.size());
 }
 
 void Executable::SavePrimitiveOpNames(dmlc::Stream* strm) {
@@ -457,6 +587,11 @@ VMInstructionSerializer SerializeInstruction(const Instruction& instr) {
 void Executable::SaveCodeSection(dmlc::Stream* strm) {
   // Save the number of functions.
   strm->Write(static_cast<uint64_t>(this->functions.size()));
+  // Save the function infos, followed by the instructions of each function after a table of
+  // their offsets, so that the instructions can be decoded on demand.
+  std::string data;
+  dmlc::MemoryStringStream data_strm(&data);
+  std::vector<uint64_t> offsets;
   for (const auto& func : this->functions) {
     // Save the function info.
     VMFunctionSerializer func_format(func.name, func.register_file_size, func.instructions.size(),
@@ -464,11 +599,16 @@ void Executable::SaveCodeSection(dmlc::Stream* strm) {
     func_format.Save(strm);
 
     // Serialize each instruction.
+    offsets.push_back(data.size());
     for (const auto& instr : func.instructions) {
       const auto& serialized_instr = SerializeInstruction(instr);
-      serialized_instr.Save(strm);
+      serialized_instr.Save(&data_strm);
     }
   }
+  offsets.push_back(data.size());
+  strm->Write(offsets);
+  strm->Write(static_cast<uint64_t>(data.size()));
+  strm->Write(data.data(), data.size());
 }
 
 void LoadHeader(dmlc::Stream* strm) {
@@ -543,24 +683,46 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+/*!
+ * \brief Read the offset table and the size of a section, and skip its data.
+ * \return The offset of the data in the stream.
+ */
+static size_t SkipSectionData(dmlc::SeekStream* strm, size_t num_entries, size_t stream_size,
+                              std::vector<uint64_t>* offsets, const char* section) {
+  uint64_t data_size;
+  STREAM_CHECK(strm->Read(offsets), section);
+  STREAM_CHECK(offsets->size() == num_entries + 1, section);
+  STREAM_CHECK(strm->Read(&data_size), section);
+  size_t begin = strm->Tell();
+  STREAM_CHECK(begin + data_size <= stream_size && offsets->back() == data_size, section);
+  for (size_t i = 0; i < num_entries; ++i) {
+    STREAM_CHECK((*offsets)[i] <= (*offsets)[i + 1], section);
+  }
+  strm->Seek(begin + data_size);
+  return begin;
+}
+
+void Executable::LoadConstantSection(dmlc::SeekStream* strm) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
-
   size_t size = static_cast<size_t>(sz);
-  // Load each of the constants.
-  for (size_t i = 0; i < size; i++) {
-    runtime::NDArray constant;
-    STREAM_CHECK(constant.Load(strm), "constant");
-    this->constants.push_back(constant);
-  }
 
   // Load the const to device mapping.
   std::vector<Index> const_device_type;
   STREAM_CHECK(strm->Read(&const_device_type), "constant");
   ICHECK_EQ(size, const_device_type.size());
   this->const_device_type = const_device_type;
+
+  // The constants are deserialized on first use.
+  std::vector<uint64_t> offsets;
+  size_t begin = SkipSectionData(strm, size, code_.size(), &offsets, "constant");
+  this->constants.resize(size);
+  lazy_constants_.reset(new LazyEntry[size]);
+  for (size_t i = 0; i < size; i++) {
+    lazy_constants_[i].begin = begin + offsets[i];
+    lazy_constants_[i].end = begin + offsets[i + 1];
+  }
 }
 
 void Executable::LoadPrimitiveOpNames(dmlc::Stream* strm) {
@@ -770,34 +932,39 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
   }
 }
 
-void Executable::LoadCodeSection(dmlc::Stream* strm) {
+void Executable::LoadCodeSection(dmlc::SeekStream* strm) {
   // Load the number of functions.
   uint64_t sz;
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "code");
 
   size_t num_funcs = static_cast<size_t>(sz);
   this->functions.resize(num_funcs);
+  std::vector<Index> func_indices;
+  std::vector<size_t> num_instructions;
   for (size_t i = 0; i < num_funcs; i++) {
     // Load the function info.
     VMFunctionSerializer loaded_func;
     STREAM_CHECK(loaded_func.Load(strm), "code/function");
 
-    // Load the instructions.
-    std::vector<Instruction> instructions;
-    for (size_t j = 0; j < loaded_func.num_instructions; j++) {
-      VMInstructionSerializer instr;
-      std::vector<Index> instr_fields;
-      STREAM_CHECK(instr.Load(strm), "code/instruction");
-      instructions.push_back(DeserializeInstruction(instr));
-    }
-
-    // Create the VM function.
-    VMFunction vm_func = VMFunction(loaded_func.name, loaded_func.params, instructions,
+    // Create the VM function, its instructions are decoded on first use.
+    VMFunction vm_func = VMFunction(loaded_func.name, loaded_func.params, {},
                                     loaded_func.register_file_size, loaded_func.params_device_type);
     auto it = this->global_map.find(loaded_func.name);
     ICHECK(it != this->global_map.end());
-    ICHECK_LE(it->second, this->global_map.size());
+    ICHECK_LT(it->second, num_funcs);
     this->functions[it->second] = vm_func;
+    func_indices.push_back(it->second);
+    num_instructions.push_back(loaded_func.num_instructions);
+  }
+
+  std::vector<uint64_t> offsets;
+  size_t begin = SkipSectionData(strm, num_funcs, code_.size(), &offsets, "code");
+  lazy_functions_.reset(new LazyEntry[num_funcs]);
+  for (size_t i = 0; i < num_funcs; i++) {
+    LazyEntry& entry = lazy_functions_[func_indices[i]];
+    entry.begin = begin + offsets[i];
+    entry.end = begin + offsets[i + 1];
+    entry.num_instructions = num_instructions[i];
   }
 }
 
@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/kv_cache.cc
+ * \brief Preallocated key/value caches of autoregressive decoding, and their VM builtins.
+ */
+#include "kv_cache.h"
+
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+TVM_REGISTER_OBJECT_TYPE(KVCacheObj);
+
+/*! \brief The rows [begin, begin + num_rows) of a buffer, pointing into its data. */
+static DLTensor RowsOf(const NDArray& data, int64_t begin, int64_t num_rows,
+                       std::vector<int64_t>* shape) {
+  const DLTensor* t = data.operator->();
+  shape->assign(t->shape, t->shape + t->ndim);
+  (*shape)[0] = num_rows;
+  DLTensor rows = *t;
+  rows.shape = shape->data();
+  rows.strides = nullptr;
+  int64_t row_bytes = t->ndim == 0 ? 0 : GetDataSize(*t) / std::max<int64_t>(t->shape[0], 1);
+  rows.byte_offset = t->byte_offset + begin * row_bytes;
+  return rows;
+}
+
+NDArray KVCacheObj::View() const {
+  std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+  shape[0] = fill_count;
+  NDArray buffer = data;
+  return buffer.CreateView(ShapeTuple(shape), data->dtype);
+}
+
+void KVCacheObj::Reserve(int64_t num_rows) {
+  if (num_rows <= capacity()) return;
+  std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+  shape[0] = std::max(num_rows, capacity() * 2);
+  NDArray grown = NDArray::Empty(ShapeTuple(shape), data->dtype, data->device);
+  if (fill_count > 0) {
+    std::vector<int64_t> src_shape, dst_shape;
+    DLTensor src = RowsOf(data, 0, fill_count, &src_shape);
+    DLTensor dst = RowsOf(grown, 0, fill_count, &dst_shape);
+    NDArray::CopyFromTo(&src, &dst);
+  }
+  data = grown;
+}
+
+void KVCacheObj::Append(const NDArray& value) {
+  ICHECK(value.IsContiguous()) << "the rows appended to a KV cache must be contiguous";
+  ICHECK_EQ(value->ndim, data->ndim) << "the rows appended to a KV cache must be of rank "
+                                     << data->ndim << ", but got " << value->ndim;
+  ICHECK(value.DataType() == DataType(data->dtype))
+      << "the rows appended to a KV cache must be of type " << DataType(data->dtype)
+      << ", but got " << value.DataType();
+  for (int i = 1; i < data->ndim; ++i) {
+    ICHECK_EQ(value->shape[i], data->shape[i])
+        << "the rows appended to a KV cache must match its shape on axis " << i;
+  }
+  int64_t num_rows = value->shape[0];
+  if (num_rows == 0) return;
+  Reserve(fill_count + num_rows);
+  std::vector<int64_t> shape;
+  DLTensor dst = RowsOf(data, fill_count, num_rows, &shape);
+  NDArray::CopyFromTo(value.operator->(), &dst);
+  fill_count += num_rows;
+}
+
+KVCache KVCache::Create(NDArray init_data, int64_t capacity) {
+  ICHECK_GE(init_data->ndim, 1) << "a KV cache must have a leading axis to grow along";
+  int64_t num_rows = init_data->shape[0];
+  std::vector<int64_t> shape(init_data->shape, init_data->shape + init_data->ndim);
+  shape[0] = std::max<int64_t>({capacity, num_rows, 1});
+  auto n = make_object<KVCacheObj>();
+  n->data = NDArray::Empty(ShapeTuple(shape), init_data->dtype, init_data->device);
+  n->Append(init_data);
+  return KVCache(n);
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_create").set_body_typed(KVCache::Create);
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_append").set_body_typed([](KVCache cache, NDArray value) {
+  cache->Append(value);
+  return cache;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_view").set_body_typed([](KVCache cache) {
+  return cache->View();
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_reset").set_body_typed([](KVCache cache) {
+  cache->fill_count = 0;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_fill_count").set_body_typed([](KVCache cache) {
+  return cache->fill_count;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.kv_cache_capacity").set_body_typed([](KVCache cache) {
+  return cache->capacity();
+});
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/vm/kv_cache.h
+ * \brief Preallocated key/value caches of autoregressive decoding.
+ */
+#ifndef TVM_RUNTIME_VM_KV_CACHE_H_
+#define TVM_RUNTIME_VM_KV_CACHE_H_
+
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief A tensor growing along its leading axis, e.g. the keys or values of the past tokens.
+ *
+ *  The rows are stored in a buffer reserved for a capacity of rows, so appending the rows of a
+ *  decoding step copies only them, and the buffer is only reallocated, doubling its capacity,
+ *  once it is full. The filled rows are read as a view of the buffer. A cache passed to the VM
+ *  is given to the function as this view, without a copy.
+ *
+ * \note The views share the buffer: the rows appended later are written after the rows of the
+ *  views, and a reset cache overwrites them.
+ */
+class KVCacheObj : public Object {
+ public:
+  /*! \brief The buffer, of the capacity of the cache along the leading axis. */
+  NDArray data;
+  /*! \brief The number of filled rows. */
+  int64_t fill_count{0};
+
+  /*! \brief The number of rows the buffer holds. */
+  int64_t capacity() const { return data->shape[0]; }
+
+  /*! \brief View the filled rows, sharing the buffer. */
+  NDArray View() const;
+
+  /*!
+   * \brief Append rows, growing the buffer when it is full.
+   * \param value The rows, of the shape of the buffer except for the leading axis.
+   */
+  void Append(const NDArray& value);
+
+  static constexpr const char* _type_key = "vm.KVCache";
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  TVM_DECLARE_FINAL_OBJECT_INFO(KVCacheObj, Object);
+
+ private:
+  /*! \brief Reallocate the buffer for at least the given number of rows. */
+  void Reserve(int64_t num_rows);
+};
+
+/*! \brief Reference to a KVCacheObj. */
+class KVCache : public ObjectRef {
+ public:
+  /*!
+   * \brief Create a cache.
+   * \param init_data The rows the cache starts with, on the device of the cache.
+   * \param capacity The number of rows reserved, at least those of init_data.
+   */
+  static KVCache Create(NDArray init_data, int64_t capacity);
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(KVCache, ObjectRef, KVCacheObj);
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_KV_CACHE_H_
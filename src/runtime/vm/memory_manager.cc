@@ -21,13 +21,16 @@
  * \file tvm/runtime/vm/memory_manager.cc
  * \brief Allocate and manage memory for the runtime.
  */
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/vm/memory_manager.h>
 
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
+#include "size_class_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -130,6 +133,12 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator(dev));
         break;
       }
+      case kSizeClass: {
+        DLOG(INFO) << "New size class allocator for " << DeviceName(dev.device_type) << "("
+                   << dev.device_id << ")";
+        alloc.reset(new SizeClassAllocator(dev));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
@@ -170,6 +179,25 @@ NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype, DLDevice
   return NDArray(GetObjectPtr<Object>(container));
 }
 
+TVM_REGISTER_GLOBAL("runtime.SizeClassAllocatorStats")
+    .set_body_typed([](int device_type, int device_id) {
+      Device dev{static_cast<DLDeviceType>(device_type), device_id};
+      Allocator* alloc = MemoryManager::GetAllocator(dev);
+      ICHECK_EQ(alloc->type(), kSizeClass)
+          << "The allocator for " << DeviceName(dev.device_type) << "(" << dev.device_id
+          << ") is not a size class allocator";
+      SizeClassAllocatorStats stats = static_cast<SizeClassAllocator*>(alloc)->Stats();
+      std::ostringstream os;
+      os << "{\"used_bytes\": " << stats.used_bytes << ", \"live_bytes\": " << stats.live_bytes
+         << ", \"pooled_bytes\": " << stats.pooled_bytes
+         << ", \"requested_bytes\": " << stats.requested_bytes
+         << ", \"rounded_bytes\": " << stats.rounded_bytes
+         << ", \"trimmed_blocks\": " << stats.trimmed_blocks
+         << ", \"internal_fragmentation\": " << stats.InternalFragmentation()
+         << ", \"external_fragmentation\": " << stats.ExternalFragmentation() << "}";
+      return os.str();
+    });
+
 }  // namespace vm
 }  // namespace runtime
 }  // namespace tvm
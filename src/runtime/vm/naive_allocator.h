@@ -28,6 +28,8 @@
 
 #include <atomic>
 
+#include "../memory_accounting.h"
+
 namespace tvm {
 namespace runtime {
 namespace vm {
@@ -41,12 +43,14 @@ class NaiveAllocator final : public Allocator {
     buf.device = device_;
     buf.size = nbytes;
     buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, nbytes, alignment, type_hint);
+    RecordDeviceAlloc(device_, buf.data, nbytes, MemoryCategory::kVMPool);
     used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     return buf;
   }
 
   void Free(const Buffer& buffer) override {
+    RecordDeviceFree(buffer.data);
     DeviceAPI::Get(device_)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
@@ -31,6 +31,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "../memory_accounting.h"
+
 namespace tvm {
 namespace runtime {
 namespace vm {
@@ -66,6 +68,7 @@ class PooledAllocator final : public Allocator {
       buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
     }
 
+    RecordDeviceAlloc(device_, buf.data, size, MemoryCategory::kVMPool);
     used_memory_.fetch_add(size, std::memory_order_relaxed);
     DLOG(INFO) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
@@ -88,6 +91,7 @@ class PooledAllocator final : public Allocator {
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
+        RecordDeviceFree(buf.data);
         DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
       }
     }
@@ -43,26 +43,31 @@ namespace vm {
 PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
                                             const ObjectPtr<Object>& sptr_to_self) {
   if (name == "profile") {
-    return TypedPackedFunc<profiling::Report(String)>([sptr_to_self, this](String arg_name) {
-      std::vector<Device> devices;
-      for (auto dev : devices_) {
-        if (dev.device_type > 0) {
-          devices.push_back(dev);
-        }
-      }
-
-      auto invoke = VirtualMachine::GetFunction("invoke", sptr_to_self);
-      // warmup
-      for (int i = 0; i < 3; i++) {
-        invoke(arg_name);
-      }
-
-      prof_ = profiling::Profiler();  // reset profiler
-      prof_.Start(devices);
-      invoke(arg_name);
-      prof_.Stop();
-      return prof_.Report();
-    });
+    return TypedPackedFunc<profiling::Report(String, Array<profiling::MetricCollector>, bool)>(
+        [sptr_to_self, this](String arg_name, Array<profiling::MetricCollector> collectors,
+                             bool timeline) {
+          std::vector<Device> devices;
+          for (auto dev : devices_) {
+            if (dev.device_type > 0) {
+              devices.push_back(dev);
+            }
+          }
+
+          auto invoke = VirtualMachine::GetFunction("invoke", sptr_to_self);
+          // warmup
+          for (int i = 0; i < 3; i++) {
+            invoke(arg_name);
+          }
+
+          // reset profiler
+          prof_ = profiling::Profiler(
+              std::vector<profiling::MetricCollector>(collectors.begin(), collectors.end()),
+              timeline);
+          prof_.Start(devices);
+          invoke(arg_name);
+          prof_.Stop();
+          return prof_.Report();
+        });
   } else {
     return VirtualMachine::GetFunction(name, sptr_to_self);
   }
@@ -0,0 +1,295 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/size_class_allocator.h
+ * \brief Pooled allocator with segregated size classes and per-thread caches.
+ *
+ *  Requests are rounded up to jemalloc-style size classes: every power of two
+ *  interval is split into four classes, bounding the rounding waste to 25%.
+ *  Freed blocks go to a small cache of the freeing thread first and to a
+ *  central pool per size class otherwise. When the free memory held by the
+ *  pools exceeds the high-water mark, the central pool is trimmed back to half
+ *  of it.
+ */
+#ifndef TVM_RUNTIME_VM_SIZE_CLASS_ALLOCATOR_H_
+#define TVM_RUNTIME_VM_SIZE_CLASS_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/vm/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../memory_accounting.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*! \brief Snapshot of the memory held by a SizeClassAllocator. */
+struct SizeClassAllocatorStats {
+  /*! \brief Bytes obtained from the device, live or pooled. */
+  size_t used_bytes{0};
+  /*! \brief Bytes of the blocks currently handed out, in size-class units. */
+  size_t live_bytes{0};
+  /*! \brief Bytes of free blocks kept in the thread caches and the central pool. */
+  size_t pooled_bytes{0};
+  /*! \brief Total bytes requested by Alloc since creation. */
+  size_t requested_bytes{0};
+  /*! \brief Total bytes handed out by Alloc since creation, after rounding. */
+  size_t rounded_bytes{0};
+  /*! \brief Number of blocks returned to the device by trimming. */
+  size_t trimmed_blocks{0};
+  /*! \brief Fraction of the handed out bytes lost to size-class rounding. */
+  double InternalFragmentation() const {
+    return rounded_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(requested_bytes) / rounded_bytes;
+  }
+  /*! \brief Fraction of the device memory held as free blocks. */
+  double ExternalFragmentation() const {
+    return used_bytes == 0 ? 0.0 : static_cast<double>(pooled_bytes) / used_bytes;
+  }
+};
+
+class SizeClassAllocator final : public Allocator {
+ public:
+  /*! \brief The smallest size class. */
+  static constexpr size_t kMinClassSize = 256;
+  /*! \brief Blocks larger than this bypass the thread caches. */
+  static constexpr size_t kMaxCachedSize = 1 << 20;
+  /*! \brief Blocks of one size class kept by a thread cache. */
+  static constexpr size_t kMaxCachedPerClass = 4;
+  static constexpr size_t kDefaultHighWater = static_cast<size_t>(1) << 30;
+
+  /*!
+   * \param dev The device to allocate on.
+   * \param high_water Free bytes held by the pools beyond which they are trimmed,
+   *  0 disables trimming.
+   */
+  explicit SizeClassAllocator(Device dev, size_t high_water = kDefaultHighWater)
+      : Allocator(kSizeClass), id_(NextId()), high_water_(high_water), device_(dev) {}
+
+  ~SizeClassAllocator() { ReleaseAll(); }
+
+  /*! \brief The size class a request of nbytes is rounded up to. */
+  static size_t ClassSize(size_t nbytes) {
+    if (nbytes <= kMinClassSize) return kMinClassSize;
+    size_t pow2 = kMinClassSize;
+    while (pow2 * 2 < nbytes) pow2 <<= 1;
+    // nbytes lies in (pow2, 2 * pow2], split into four classes of pow2 / 4.
+    size_t step = pow2 / 4;
+    return (nbytes + step - 1) / step * step;
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    size_t size = ClassSize(nbytes);
+    requested_bytes_.fetch_add(nbytes, std::memory_order_relaxed);
+    rounded_bytes_.fetch_add(size, std::memory_order_relaxed);
+    Buffer buf;
+    if (TakeCached(size, &buf) || TakeCentral(size, &buf)) {
+      pooled_bytes_.fetch_sub(size, std::memory_order_relaxed);
+      live_bytes_.fetch_add(size, std::memory_order_relaxed);
+      return buf;
+    }
+    buf.device = device_;
+    buf.size = size;
+    try {
+      buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "SizeClassAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      ReleaseAll();
+      buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    }
+    RecordDeviceAlloc(device_, buf.data, size, MemoryCategory::kVMPool);
+    used_memory_.fetch_add(size, std::memory_order_relaxed);
+    live_bytes_.fetch_add(size, std::memory_order_relaxed);
+    DLOG(INFO) << "allocate " << size << " B, used memory " << used_memory_ << " B";
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    live_bytes_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    pooled_bytes_.fetch_add(buffer.size, std::memory_order_relaxed);
+    if (!PutCached(buffer)) {
+      std::lock_guard<std::mutex> lock(mu_);
+      central_[buffer.size].push_back(buffer);
+    }
+    if (high_water_ != 0 && pooled_bytes_.load(std::memory_order_relaxed) > high_water_) {
+      Trim(high_water_ / 2);
+    }
+  }
+
+  size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
+
+  /*!
+   * \brief Return free blocks to the device, largest first, until the pools hold
+   *  at most target bytes. The central pool is drained before the thread caches.
+   * \param target The number of free bytes to keep.
+   */
+  void Trim(size_t target) {
+    std::lock_guard<std::mutex> lock(mu_);
+    TrimPools(&central_, target);
+    for (auto& cache : caches_) {
+      if (pooled_bytes_.load(std::memory_order_relaxed) <= target) break;
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      TrimPools(&cache->blocks, target);
+    }
+  }
+
+  /*! \brief Report the memory held by the allocator and its fragmentation. */
+  SizeClassAllocatorStats Stats() const {
+    SizeClassAllocatorStats stats;
+    stats.used_bytes = used_memory_.load(std::memory_order_relaxed);
+    stats.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+    stats.pooled_bytes = pooled_bytes_.load(std::memory_order_relaxed);
+    stats.requested_bytes = requested_bytes_.load(std::memory_order_relaxed);
+    stats.rounded_bytes = rounded_bytes_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mu_);
+    stats.trimmed_blocks = trimmed_blocks_;
+    return stats;
+  }
+
+ private:
+  /*! \brief The free blocks cached by one thread, owned by the allocator. */
+  struct ThreadCache {
+    std::mutex mu;
+    std::unordered_map<size_t, std::vector<Buffer>> blocks;
+  };
+
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next_id{0};
+    return next_id.fetch_add(1);
+  }
+
+  /*!
+   * \brief The cache of the calling thread. Caches are keyed by the id of the
+   *  allocator, which is never reused, so entries of destroyed allocators go stale.
+   */
+  ThreadCache* LocalCache() {
+    thread_local std::unordered_map<uint64_t, ThreadCache*> caches;
+    auto it = caches.find(id_);
+    if (it != caches.end()) return it->second;
+    ThreadCache* cache = new ThreadCache();
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      caches_.emplace_back(cache);
+    }
+    caches.emplace(id_, cache);
+    return cache;
+  }
+
+  bool TakeCached(size_t size, Buffer* buf) {
+    if (size > kMaxCachedSize) return false;
+    ThreadCache* cache = LocalCache();
+    std::lock_guard<std::mutex> lock(cache->mu);
+    auto it = cache->blocks.find(size);
+    if (it == cache->blocks.end() || it->second.empty()) return false;
+    *buf = it->second.back();
+    it->second.pop_back();
+    return true;
+  }
+
+  bool PutCached(const Buffer& buffer) {
+    if (buffer.size > kMaxCachedSize) return false;
+    ThreadCache* cache = LocalCache();
+    std::lock_guard<std::mutex> lock(cache->mu);
+    auto& blocks = cache->blocks[buffer.size];
+    if (blocks.size() >= kMaxCachedPerClass) return false;
+    blocks.push_back(buffer);
+    return true;
+  }
+
+  bool TakeCentral(size_t size, Buffer* buf) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = central_.find(size);
+    if (it == central_.end() || it->second.empty()) return false;
+    *buf = it->second.back();
+    it->second.pop_back();
+    return true;
+  }
+
+  // Requires mu_.
+  void TrimPools(std::unordered_map<size_t, std::vector<Buffer>>* pools, size_t target) {
+    std::vector<size_t> sizes;
+    for (const auto& it : *pools) {
+      if (!it.second.empty()) sizes.push_back(it.first);
+    }
+    std::sort(sizes.rbegin(), sizes.rend());
+    for (size_t size : sizes) {
+      auto& pool = (*pools)[size];
+      while (!pool.empty() && pooled_bytes_.load(std::memory_order_relaxed) > target) {
+        const Buffer& buf = pool.back();
+        RecordDeviceFree(buf.data);
+        DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+        pooled_bytes_.fetch_sub(size, std::memory_order_relaxed);
+        used_memory_.fetch_sub(size, std::memory_order_relaxed);
+        trimmed_blocks_ += 1;
+        pool.pop_back();
+      }
+    }
+  }
+
+  void ReleaseAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto release = [this](std::unordered_map<size_t, std::vector<Buffer>>* pools) {
+      for (auto& it : *pools) {
+        for (const Buffer& buf : it.second) {
+          RecordDeviceFree(buf.data);
+          DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+          pooled_bytes_.fetch_sub(buf.size, std::memory_order_relaxed);
+          used_memory_.fetch_sub(buf.size, std::memory_order_relaxed);
+        }
+      }
+      pools->clear();
+    };
+    for (auto& cache : caches_) {
+      std::lock_guard<std::mutex> cache_lock(cache->mu);
+      release(&cache->blocks);
+    }
+    release(&central_);
+    DLOG(INFO) << "release all buffers";
+  }
+
+  /*! \brief Unique id of the allocator, keys the thread caches. */
+  uint64_t id_;
+  size_t high_water_;
+  std::atomic<size_t> used_memory_{0};
+  std::atomic<size_t> live_bytes_{0};
+  std::atomic<size_t> pooled_bytes_{0};
+  std::atomic<size_t> requested_bytes_{0};
+  std::atomic<size_t> rounded_bytes_{0};
+  size_t trimmed_blocks_{0};
+  /*! \brief Central pool of free blocks per size class. */
+  std::unordered_map<size_t, std::vector<Buffer>> central_;
+  /*! \brief The thread caches created for this allocator. */
+  std::vector<std::unique_ptr<ThreadCache>> caches_;
+  mutable std::mutex mu_;
+  Device device_;
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_SIZE_CLASS_ALLOCATOR_H_
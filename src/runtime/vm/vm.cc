@@ -27,6 +27,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
+#include <tvm/runtime/threading_backend.h>
 #include <tvm/runtime/vm/vm.h>
 
 #include <algorithm>
@@ -35,7 +36,12 @@
 #include <stdexcept>
 #include <vector>
 
+#include "../constant_store.h"
 #include "../file_utils.h"
+#include "../memory_accounting.h"
+#include "../op_latency_sampler.h"
+#include "../result_cache.h"
+#include "kv_cache.h"
 
 using namespace tvm::runtime;
 
@@ -65,6 +71,10 @@ std::ostream& operator<<(std::ostream& os, const VMFunction& vm_func) {
 }
 
 inline ObjectRef CopyTo(ObjectRef src, const DLDevice& dev) {
+  if (auto* cache = src.as<KVCacheObj>()) {
+    // A KV cache is passed as the view of its filled rows, without a copy.
+    return CopyTo(cache->View(), dev);
+  }
   if (src->IsInstance<NDArray::ContainerType>()) {
     auto nd_array = Downcast<NDArray>(src);
     if (nd_array->device.device_type != dev.device_type) {
@@ -122,7 +132,7 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       auto git = exec_->global_map.find(func_name);
       ICHECK(git != exec_->global_map.end())
           << "Cannot find function " << func_name << " in the executable";
-      auto func = exec_->functions[git->second];
+      const auto& func = exec_->GetVMFunction(git->second);
       if (func.params.empty()) {
         *rv = Invoke(func, {});
       } else {
@@ -140,6 +150,12 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       TVMRetValue rv_;
       invoke.CallPacked(args, &rv_);
     });
+  } else if (name == "invoke_with_args") {
+    // Set the inputs and invoke in one call, the request of an async runner.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      GetFunction("set_input", sptr_to_self).CallPacked(args, rv);
+      GetFunction("invoke", sptr_to_self).CallPacked(TVMArgs(args.values, args.type_codes, 1), rv);
+    });
   } else if (name == "get_output") {
     return TypedPackedFunc<NDArray(int64_t)>([this](int64_t index) {
       if (this->return_register_.as<ADTObj>()) {
@@ -211,6 +227,62 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       inputs_.erase(func_name);
       inputs_.emplace(func_name, func_args);
     });
+  } else if (name == "set_outputs") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<NDArray> outputs;
+      for (int i = 1; i < args.size(); ++i) {
+        outputs.push_back(args[i]);
+      }
+      this->SetOutputs(args[0], outputs);
+    });
+  } else if (name == "configure_dispatch") {
+    return TypedPackedFunc<void(bool, bool)>(
+        [sptr_to_self, this](bool superinstructions, bool threaded) {
+          this->ConfigureDispatch(superinstructions, threaded);
+        });
+  } else if (name == "share_constants") {
+    return TypedPackedFunc<void(bool)>([sptr_to_self, this](bool share) {
+      ICHECK(const_pool_.empty()) << "share_constants must be set before the first invocation";
+      this->share_constants_ = share;
+      if (share) ConstantStore::Global()->Prune();
+    });
+  } else if (name == "clone") {
+    return TypedPackedFunc<Module()>([sptr_to_self, this]() { return Module(this->Clone()); });
+  } else if (name == "set_thread_pool") {
+    return TypedPackedFunc<void(std::string)>(
+        [sptr_to_self, this](std::string pool) { this->thread_pool_ = pool; });
+  } else if (name == "set_sampling_interval") {
+    return TypedPackedFunc<void(int64_t)>([sptr_to_self, this](int64_t interval) {
+      ICHECK(exec_) << "The executable has not been created yet.";
+      std::vector<std::string> names(exec_->primitive_map.size());
+      for (const auto& it : exec_->primitive_map) {
+        if (static_cast<size_t>(it.second) < names.size()) names[it.second] = it.first;
+      }
+      if (!sampler_) sampler_ = std::make_shared<OpLatencySampler>();
+      sampler_->Configure(interval, names);
+    });
+  } else if (name == "set_result_cache") {
+    return TypedPackedFunc<void(int64_t, Array<String>)>(
+        [sptr_to_self, this](int64_t max_bytes, Array<String> func_names) {
+          ICHECK(exec_) << "The executable has not been created yet.";
+          cached_functions_.clear();
+          for (const String& func_name : func_names) {
+            auto it = exec_->global_map.find(func_name);
+            ICHECK(it != exec_->global_map.end())
+                << "Cannot find function " << func_name << " in the executable";
+            cached_functions_.emplace(it->second, cached_functions_.size());
+          }
+          if (!result_cache_) result_cache_ = std::make_shared<ResultCache>();
+          result_cache_->Configure(max_bytes);
+        });
+  } else if (name == "get_result_cache_stats") {
+    return TypedPackedFunc<std::string()>([sptr_to_self, this]() {
+      return result_cache_ ? result_cache_->StatsJSON() : ResultCache().StatsJSON();
+    });
+  } else if (name == "get_sampling_stats") {
+    return TypedPackedFunc<std::string()>([sptr_to_self, this]() {
+      return sampler_ ? sampler_->StatsJSON() : OpLatencySampler().StatsJSON();
+    });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc([sptr_to_self, name](TVMArgs args, TVMRetValue* rv) {});
@@ -235,7 +307,7 @@ Index VirtualMachine::PopFrame() {
   ICHECK_GT(frames_.size(), 0);
   const VMFrame& fr = frames_.back();
   func_index_ = fr.func_index;
-  code_ = fr.code;
+  SetCode(fr.code);
   pc_ = fr.pc;
   auto call_stack_size = frames_.size();
   frames_.pop_back();
@@ -251,15 +323,51 @@ void VirtualMachine::InvokeGlobal(const VMFunction& func, const std::vector<Obje
   }
   DLOG(INFO) << "func.params= " << func.params.size();
 
-  code_ = func.instructions.data();
+  if (superinstructions_ && !super_instructions_.count(func.instructions.data())) {
+    super_instructions_.emplace(func.instructions.data(), BuildSuperInstructions(func));
+  }
+  SetCode(func.instructions.data());
   pc_ = 0;
 }
 
+bool VirtualMachine::InvokeGlobalCached(Index func_index, const std::vector<ObjectRef>& args,
+                                        ObjectRef* result) {
+  const VMFunction& func = exec_->GetVMFunction(func_index);
+  auto it = cached_functions_.find(func_index);
+  std::vector<NDArray> inputs;
+  if (it == cached_functions_.end() || !result_cache_->enabled() ||
+      !ResultCache::CollectTensors(Array<ObjectRef>(args.begin(), args.end()), &inputs)) {
+    InvokeGlobal(func, args);
+    return false;
+  }
+  uint64_t key;
+  if (result_cache_->Lookup(it->second, inputs, &key, result)) return true;
+  InvokeGlobal(func, args);
+  VMFrame& frame = frames_.back();
+  frame.cache_slot = it->second;
+  frame.cache_key = key;
+  frame.cache_inputs = std::move(inputs);
+  return false;
+}
+
 ObjectRef VirtualMachine::Invoke(const VMFunction& func, const std::vector<ObjectRef>& args) {
   DLOG(INFO) << "Executing Function: " << std::endl << func;
+  threading::ThreadPoolScope pool_scope(thread_pool_);
+  MemoryAccountingScope accounting(MemoryCategory::kActivations, "vm");
 
-  InvokeGlobal(func, args);
-  RunLoop();
+  sampling_ = sampler_ && sampler_->BeginInvocation();
+  auto it = exec_->global_map.find(func.name);
+  // the outputs bound by set_outputs are written by each invocation
+  if (!bound_outputs_.empty() || it == exec_->global_map.end()) {
+    InvokeGlobal(func, args);
+    RunLoop();
+  } else if (!InvokeGlobalCached(it->second, args, &return_register_)) {
+    RunLoop();
+  }
+  if (sampling_) {
+    sampling_ = false;
+    sampler_->EndInvocation();
+  }
   return return_register_;
 }
 
@@ -269,7 +377,7 @@ ObjectRef VirtualMachine::Invoke(const std::string& name, const std::vector<Obje
   ICHECK(it != exec_->global_map.end()) << "Cannot find function " << name << " in the executable";
   auto func_index_ = it->second;
   DLOG(INFO) << "Invoke Global " << name << " at index " << func_index_;
-  return Invoke(exec_->functions[func_index_], args);
+  return Invoke(exec_->GetVMFunction(func_index_), args);
 }
 
 void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, Index arg_count,
@@ -288,11 +396,13 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
   runtime::TVMArgsSetter setter(values.data(), codes.data());
   int idx = 0;
   bool is_empty_output = false;
+  Device dev{kDLCPU, 0};
   for (Index i = 0; i < arg_count; i++) {
     if (const auto* dt_cell = args[i].as<ADTObj>()) {
       for (size_t fi = 0; fi < dt_cell->size; ++fi) {
         auto obj = (*dt_cell)[fi];
         auto nd_array = Downcast<NDArray>(obj);
+        if (idx == 0) dev = nd_array->device;
         setter(idx++, nd_array);
       }
     } else {
@@ -307,39 +417,40 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
           }
         }
       }
+      if (idx == 0) dev = nd_array->device;
       setter(idx++, nd_array);
     }
   }
 
   if (!is_empty_output) {
     TVMRetValue rv;
+    if (sampling_) sampler_->StartOp(packed_index, dev);
     func.CallPacked(TVMArgs(values.data(), codes.data(), arity), &rv);
+    if (sampling_) sampler_->StopOp();
   }
 }
 
 void VirtualMachine::LoadExecutable(const Executable* exec) {
   ICHECK(exec) << "The executable is not created yet.";
   exec_ = exec;
+  // The kernels are looked up once per executable, the VMs only copy the handles.
+  packed_funcs_ = exec_->GetPackedFuncs();
+}
 
-  runtime::Module lib = exec_->GetLib();
-
-  ICHECK(exec->primitive_map.empty() || lib.operator->())
-      << "If the executable has declared primitive functions, the"
-      << "generated kernel library must non-be null.";
-
-  for (const auto& it : exec_->primitive_map) {
-    const auto& packed_name = it.first;
-    auto packed_index = static_cast<size_t>(it.second);
-    if (packed_funcs_.size() <= packed_index) {
-      packed_funcs_.resize(packed_index + 1);
-    }
-    tvm::runtime::PackedFunc pf = lib.GetFunction(packed_name, true);
-    ICHECK(pf != nullptr) << "Cannot find function in module: " << packed_name;
-    packed_funcs_[packed_index] = pf;
-  }
-  for (size_t i = 0; i < packed_funcs_.size(); ++i) {
-    ICHECK(packed_funcs_[i] != nullptr) << "Packed function " << i << " is not initialized";
-  }
+ObjectPtr<VirtualMachine> VirtualMachine::Clone() const {
+  ICHECK(exec_) << "The executable is not created yet.";
+  auto vm = make_object<VirtualMachine>();
+  vm->exec_ = exec_;
+  vm->packed_funcs_ = packed_funcs_;
+  vm->devices_ = devices_;
+  vm->allocators_ = allocators_;
+  vm->share_constants_ = share_constants_;
+  vm->thread_pool_ = thread_pool_;
+  vm->superinstructions_ = superinstructions_;
+  vm->threaded_dispatch_ = threaded_dispatch_;
+  vm->result_cache_ = result_cache_;
+  vm->cached_functions_ = cached_functions_;
+  return vm;
 }
 
 void VirtualMachine::Init(const std::vector<Device>& devs,
@@ -398,29 +509,383 @@ inline int64_t VirtualMachine::LoadScalarInt(Index r) const {
   return result;
 }
 
+Storage VirtualMachine::ExecAllocStorage(const Instruction& instr) {
+  auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
+  auto alignment = instr.alloc_storage.alignment;
+
+  DLOG(INFO) << "AllocStorage: allocation_size=" << size << ", alignment=" << alignment
+             << ", dtype_hint=" << DLDataType2String(instr.alloc_storage.dtype_hint)
+             << ", device_type=" << instr.alloc_storage.device_type;
+
+  auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
+  auto dev_type = instr.alloc_storage.device_type;
+  ICHECK_LT(static_cast<size_t>(dev_type), allocators_.size())
+      << "Memory allocator for device " << dev_type << " has not been initialized";
+  auto* alloc = allocators_[dev_type];
+  ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
+  storage_obj->buffer = alloc->Alloc(size, alignment, instr.alloc_storage.dtype_hint);
+  Storage storage(storage_obj);
+  if (retained_objects_ != nullptr) retained_objects_->push_back(storage);
+  return storage;
+}
+
+NDArray VirtualMachine::ExecAllocTensor(const Instruction& instr, const Storage& storage) {
+  std::vector<int64_t> shape;
+  DLDataType dtype;
+  if (instr.op == Opcode::AllocTensor) {
+    shape.assign(instr.alloc_tensor.shape, instr.alloc_tensor.shape + instr.alloc_tensor.ndim);
+    dtype = instr.alloc_tensor.dtype;
+  } else {
+    ICHECK(instr.op == Opcode::AllocTensorReg);
+    Device cpu_dev = GetDevice(static_cast<Index>(kDLCPU));
+    auto shape_obj = ReadRegister(instr.alloc_tensor_reg.shape_register);
+    NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
+    shape = ToShape(shape_tensor);
+    dtype = instr.alloc_tensor_reg.dtype;
+  }
+  if (!bound_outputs_.empty()) {
+    auto it = bound_outputs_.find(&instr);
+    if (it != bound_outputs_.end()) {
+      const NDArray& out = it->second;
+      ICHECK(std::equal(shape.begin(), shape.end(), out->shape, out->shape + out->ndim) &&
+             DataType(out->dtype) == DataType(dtype))
+          << "The array set by set_outputs does not match the shape or the type of the output";
+      ICHECK(out->device.device_type == storage->buffer.device.device_type &&
+             out->device.device_id == storage->buffer.device.device_id)
+          << "The array set by set_outputs is not on the device of the output";
+      return out;
+    }
+  }
+  auto offset = LoadScalarInt(instr.alloc_tensor.offset);
+  return storage->AllocNDArray(offset, shape, dtype);
+}
+
+namespace {
+/*! \brief Whether an instruction writes its dst register. */
+bool WritesDst(Opcode op) {
+  return op != Opcode::Ret && op != Opcode::If && op != Opcode::Goto && op != Opcode::Fatal &&
+         op != Opcode::InvokePacked;
+}
+}  // namespace
+
+void VirtualMachine::SetOutputs(const std::string& func_name, const std::vector<NDArray>& outputs) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  auto git = exec_->global_map.find(func_name);
+  ICHECK(git != exec_->global_map.end()) << "Cannot find function " << func_name;
+  const std::vector<Instruction>& code = exec_->GetVMFunction(git->second).instructions;
+  for (const Instruction& instr : code) {
+    bound_outputs_.erase(&instr);
+  }
+  if (outputs.empty()) return;
+
+  for (const Instruction& instr : code) {
+    ICHECK(instr.op != Opcode::If && instr.op != Opcode::Goto)
+        << "The outputs of " << func_name << " cannot be bound, it has control flow";
+  }
+  ICHECK(!code.empty() && code.back().op == Opcode::Ret);
+  // The pc of the instruction computing a register before a pc, through the moves.
+  auto find_writer = [&code](RegName reg, Index before) {
+    for (Index pc = before - 1; pc >= 0; --pc) {
+      if (!WritesDst(code[pc].op) || code[pc].dst != reg) continue;
+      if (code[pc].op != Opcode::Move) return pc;
+      reg = code[pc].from;
+    }
+    return Index(-1);
+  };
+  Index ret_pc = static_cast<Index>(code.size()) - 1;
+  Index root = find_writer(code[ret_pc].result, ret_pc);
+  std::vector<Index> allocs;
+  if (root >= 0 && code[root].op == Opcode::AllocADT) {
+    for (Index i = 0; i < code[root].num_fields; ++i) {
+      allocs.push_back(find_writer(code[root].datatype_fields[i], root));
+    }
+  } else {
+    allocs.push_back(root);
+  }
+  ICHECK_EQ(allocs.size(), outputs.size())
+      << func_name << " has " << allocs.size() << " outputs, " << outputs.size() << " are set";
+  for (size_t i = 0; i < allocs.size(); ++i) {
+    ICHECK(allocs[i] >= 0 && (code[allocs[i]].op == Opcode::AllocTensor ||
+                              code[allocs[i]].op == Opcode::AllocTensorReg))
+        << "The output " << i << " of " << func_name
+        << " is not allocated by the function, e.g. it is a parameter, a constant or a reshape, "
+        << "it cannot be bound";
+    ICHECK(std::count(allocs.begin(), allocs.end(), allocs[i]) == 1)
+        << "The output " << i << " of " << func_name << " is returned more than once";
+    ICHECK_EQ(reinterpret_cast<size_t>(outputs[i]->data) % kAllocAlignment, 0)
+        << "The array of the output " << i << " is not aligned";
+  }
+  for (size_t i = 0; i < allocs.size(); ++i) {
+    bound_outputs_[&code[allocs[i]]] = outputs[i];
+  }
+}
+
+void VirtualMachine::ExecInvokePacked(const Instruction& instr) {
+  DLOG(INFO) << "InvokedPacked " << instr.packed_index << " arity=" << instr.arity;
+  ICHECK_LE(instr.packed_index, packed_funcs_.size());
+  const auto& func = packed_funcs_[instr.packed_index];
+  const auto& arity = instr.arity;
+  std::vector<ObjectRef> args;
+  for (Index i = 0; i < arity; ++i) {
+    DLOG(INFO) << "arg" << i << " $" << instr.packed_args[i];
+    auto arg = ReadRegister(instr.packed_args[i]);
+    args.push_back(arg);
+  }
+
+  // We no longer need to write the registers back, we write directly
+  // through the registers mutably.
+  InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+}
+
+namespace {
+/*! \brief Call f on every register an instruction reads. */
+template <typename F>
+void ForEachReadRegister(const Instruction& instr, F f) {
+  switch (instr.op) {
+    case Opcode::Move:
+      f(instr.from);
+      break;
+    case Opcode::Ret:
+      f(instr.result);
+      break;
+    case Opcode::Invoke:
+      for (Index i = 0; i < instr.num_args; ++i) f(instr.invoke_args_registers[i]);
+      break;
+    case Opcode::InvokeClosure:
+      f(instr.closure);
+      for (Index i = 0; i < instr.num_closure_args; ++i) f(instr.closure_args[i]);
+      break;
+    case Opcode::InvokePacked:
+      for (Index i = 0; i < instr.arity; ++i) f(instr.packed_args[i]);
+      break;
+    case Opcode::AllocTensor:
+      f(instr.alloc_tensor.storage);
+      f(instr.alloc_tensor.offset);
+      break;
+    case Opcode::AllocTensorReg:
+      f(instr.alloc_tensor_reg.storage);
+      f(instr.alloc_tensor_reg.offset);
+      f(instr.alloc_tensor_reg.shape_register);
+      break;
+    case Opcode::AllocADT:
+      for (Index i = 0; i < instr.num_fields; ++i) f(instr.datatype_fields[i]);
+      break;
+    case Opcode::AllocClosure:
+      for (Index i = 0; i < instr.num_freevar; ++i) f(instr.free_vars[i]);
+      break;
+    case Opcode::GetField:
+      f(instr.object);
+      break;
+    case Opcode::GetTag:
+      f(instr.get_tag.object);
+      break;
+    case Opcode::If:
+      f(instr.if_op.test);
+      f(instr.if_op.target);
+      break;
+    case Opcode::AllocStorage:
+      f(instr.alloc_storage.allocation_size);
+      break;
+    case Opcode::ShapeOf:
+      f(instr.shape_of.tensor);
+      break;
+    case Opcode::ReshapeTensor:
+      f(instr.reshape_tensor.tensor);
+      f(instr.reshape_tensor.newshape);
+      break;
+    case Opcode::DeviceCopy:
+      f(instr.src);
+      break;
+    default:
+      break;
+  }
+}
+
+bool IsAllocation(Opcode op) {
+  return op == Opcode::AllocStorage || op == Opcode::AllocTensor || op == Opcode::AllocTensorReg;
+}
+}  // namespace
+
+std::vector<SuperInstruction> VirtualMachine::BuildSuperInstructions(const VMFunction& func) {
+  const std::vector<Instruction>& code = func.instructions;
+  size_t size = code.size();
+  std::vector<SuperInstruction> supers(size);
+  // A run must not be entered from the middle.
+  std::vector<bool> jump_target(size + 1, false);
+  std::unordered_map<RegName, size_t> num_reads;
+  for (size_t pc = 0; pc < size; ++pc) {
+    const Instruction& instr = code[pc];
+    if (instr.op == Opcode::Goto) {
+      jump_target[pc + instr.pc_offset] = true;
+    } else if (instr.op == Opcode::If) {
+      jump_target[pc + instr.if_op.true_offset] = true;
+      jump_target[pc + instr.if_op.false_offset] = true;
+    }
+    ForEachReadRegister(instr, [&num_reads](RegName reg) { num_reads[reg] += 1; });
+  }
+  size_t pc = 0;
+  while (pc < size) {
+    size_t end = pc;
+    while (end < size && IsAllocation(code[end].op) && (end == pc || !jump_target[end])) ++end;
+    if (end < size && end > pc && code[end].op == Opcode::InvokePacked && !jump_target[end]) ++end;
+    if (end - pc < 2) {
+      pc = end > pc ? end : pc + 1;
+      continue;
+    }
+    SuperInstruction& super = supers[pc];
+    super.length = static_cast<Index>(end - pc);
+    // Storages consumed by the tensors of the run only need not go through the register file.
+    std::unordered_map<RegName, size_t> run_reads;
+    for (size_t i = pc; i < end; ++i) {
+      const Instruction& instr = code[i];
+      if (instr.op == Opcode::AllocTensor) run_reads[instr.alloc_tensor.storage] += 1;
+      if (instr.op == Opcode::AllocTensorReg) run_reads[instr.alloc_tensor_reg.storage] += 1;
+    }
+    for (size_t i = pc; i < end; ++i) {
+      const Instruction& instr = code[i];
+      if (instr.op != Opcode::AllocStorage) continue;
+      auto it = run_reads.find(instr.dst);
+      if (it != run_reads.end() && it->second == num_reads[instr.dst]) {
+        super.local_storages.push_back(instr.dst);
+      }
+    }
+    pc = end;
+  }
+  return supers;
+}
+
+void VirtualMachine::RunSuperInstruction(const SuperInstruction& super) {
+  std::vector<std::pair<RegName, Storage>> locals;
+  auto is_local = [&super](RegName reg) {
+    return std::find(super.local_storages.begin(), super.local_storages.end(), reg) !=
+           super.local_storages.end();
+  };
+  auto read_storage = [this, &locals](RegName reg) {
+    for (const auto& local : locals) {
+      if (local.first == reg) return local.second;
+    }
+    return Downcast<Storage>(ReadRegister(reg));
+  };
+  for (Index i = 0; i < super.length; ++i) {
+    const Instruction& instr = code_[pc_ + i];
+    switch (instr.op) {
+      case Opcode::AllocStorage: {
+        Storage storage = ExecAllocStorage(instr);
+        if (is_local(instr.dst)) {
+          locals.emplace_back(instr.dst, storage);
+        } else {
+          WriteRegister(instr.dst, storage);
+        }
+        break;
+      }
+      case Opcode::AllocTensor:
+        WriteRegister(instr.dst, ExecAllocTensor(instr, read_storage(instr.alloc_tensor.storage)));
+        break;
+      case Opcode::AllocTensorReg:
+        WriteRegister(instr.dst,
+                      ExecAllocTensor(instr, read_storage(instr.alloc_tensor_reg.storage)));
+        break;
+      case Opcode::InvokePacked:
+        ExecInvokePacked(instr);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected opcode in a superinstruction: " << int(instr.op);
+    }
+  }
+  pc_ += super.length;
+}
+
+void VirtualMachine::ConfigureDispatch(bool superinstructions, bool threaded) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  // The superinstructions of a function are built when it is first invoked, since its
+  // bytecode may not be loaded yet.
+  super_instructions_.clear();
+  superinstructions_ = superinstructions;
+#if !defined(__GNUC__)
+  if (threaded) {
+    LOG(WARNING) << "Threaded dispatch needs computed gotos, falling back to the switch loop";
+  }
+#endif
+  threaded_dispatch_ = threaded;
+  SetCode(code_);
+}
+
+void VirtualMachine::SetCode(const Instruction* code) {
+  code_ = code;
+  supers_ = nullptr;
+  if (!super_instructions_.empty()) {
+    auto it = super_instructions_.find(code);
+    if (it != super_instructions_.end()) supers_ = it->second.data();
+  }
+}
+
+#if defined(__GNUC__)
+#define TVM_VM_COMPUTED_GOTO 1
+#else
+#define TVM_VM_COMPUTED_GOTO 0
+#endif
+
+#if TVM_VM_COMPUTED_GOTO
+#define TVM_VM_HANDLER(op) handler_##op:
+// In threaded mode every handler jumps straight to the next one, so that each
+// jump site gets its own branch prediction history.
+#define TVM_VM_DISPATCH()                                        \
+  do {                                                           \
+    if (threaded && (supers_ == nullptr || !supers_[pc_].length)) { \
+      ip = &code_[pc_];                                          \
+      goto* kHandlers[static_cast<int>(ip->op)];                 \
+    }                                                            \
+    goto main_loop;                                              \
+  } while (0)
+#else
+#define TVM_VM_HANDLER(op)
+#define TVM_VM_DISPATCH() goto main_loop
+#endif
+
 void VirtualMachine::RunLoop() {
   ICHECK(this->exec_);
   ICHECK(this->code_);
   pc_ = 0;
   Index frame_start = frames_.size();
+  const Instruction* ip = nullptr;
+#if TVM_VM_COMPUTED_GOTO
+  // Indexed by Opcode.
+  static void* const kHandlers[] = {
+      &&handler_Move,          &&handler_Ret,           &&handler_Invoke,    &&handler_InvokeClosure,
+      &&handler_InvokePacked,  &&handler_AllocTensor,   &&handler_AllocTensorReg,
+      &&handler_AllocADT,      &&handler_AllocClosure,  &&handler_GetField,  &&handler_If,
+      &&handler_LoadConst,     &&handler_Goto,          &&handler_GetTag,    &&handler_LoadConsti,
+      &&handler_Fatal,         &&handler_AllocStorage,  &&handler_ShapeOf,   &&handler_ReshapeTensor,
+      &&handler_DeviceCopy};
+  const bool threaded = threaded_dispatch_;
+#endif
   while (true) {
   main_loop:
-    auto const& instr = code_[this->pc_];
-    DLOG(INFO) << "Executing(" << pc_ << "): " << instr;
+    if (supers_ != nullptr && supers_[pc_].length != 0) {
+      RunSuperInstruction(supers_[pc_]);
+      goto main_loop;
+    }
+    ip = &code_[pc_];
+    DLOG(INFO) << "Executing(" << pc_ << "): " << *ip;
 
-    switch (instr.op) {
-      case Opcode::Move: {
+    switch (ip->op) {
+      case Opcode::Move:
+      TVM_VM_HANDLER(Move) {
+        const Instruction& instr = *ip;
         ObjectRef from_obj;
         from_obj = ReadRegister(instr.from);
         WriteRegister(instr.dst, from_obj);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Fatal: {
+      case Opcode::Fatal:
+      TVM_VM_HANDLER(Fatal) {
+        const Instruction& instr = *ip;
         throw std::runtime_error("VM encountered fatal error");
       }
-      case Opcode::LoadConst: {
-        auto constant_obj = exec_->constants[instr.const_index];
+      case Opcode::LoadConst:
+      TVM_VM_HANDLER(LoadConst) {
+        const Instruction& instr = *ip;
         // We cache the allocated object in the constant pool. To measure, the
         // first iteration will set the pool up. The other iterations will
         // directly reuse the allocated objects.
@@ -429,48 +894,57 @@ void VirtualMachine::RunLoop() {
         }
 
         if (!const_pool_[instr.const_index].defined()) {
+          const auto& constant_obj = exec_->GetConstant(instr.const_index);
           Device dev = GetDevice(exec_->const_device_type[instr.const_index]);
-          const_pool_[instr.const_index] = CopyTo(constant_obj, dev);
+          const auto* tensor = constant_obj.as<NDArray::Container>();
+          if (share_constants_ && tensor && tensor->dl_tensor.device.device_type == kDLCPU &&
+              IsContiguous(tensor->dl_tensor)) {
+            const_pool_[instr.const_index] =
+                ConstantStore::Global()->Intern(Downcast<NDArray>(constant_obj), dev);
+          } else {
+            // The device copy is shared by the VMs of the executable.
+            const_pool_[instr.const_index] = exec_->GetDeviceConstant(instr.const_index, dev);
+          }
         }
         WriteRegister(instr.dst, const_pool_[instr.const_index]);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::LoadConsti: {
+      case Opcode::LoadConsti:
+      TVM_VM_HANDLER(LoadConsti) {
+        const Instruction& instr = *ip;
         auto tensor = NDArray::Empty({1}, {kDLInt, 64, 1}, {kDLCPU, 0});
         reinterpret_cast<int64_t*>(tensor->data)[0] = instr.load_consti.val;
         WriteRegister(instr.dst, tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Invoke: {
+      case Opcode::Invoke:
+      TVM_VM_HANDLER(Invoke) {
+        const Instruction& instr = *ip;
         std::vector<ObjectRef> args;
         for (Index i = 0; i < instr.num_args; ++i) {
           args.push_back(ReadRegister(instr.invoke_args_registers[i]));
         }
-        InvokeGlobal(exec_->functions[instr.func_index], args);
-        frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
-      }
-      case Opcode::InvokePacked: {
-        DLOG(INFO) << "InvokedPacked " << instr.packed_index << " arity=" << instr.arity;
-        ICHECK_LE(instr.packed_index, packed_funcs_.size());
-        const auto& func = packed_funcs_[instr.packed_index];
-        const auto& arity = instr.arity;
-        std::vector<ObjectRef> args;
-        for (Index i = 0; i < arity; ++i) {
-          DLOG(INFO) << "arg" << i << " $" << instr.packed_args[i];
-          auto arg = ReadRegister(instr.packed_args[i]);
-          args.push_back(arg);
+        ObjectRef result;
+        if (InvokeGlobalCached(instr.func_index, args, &result)) {
+          WriteRegister(instr.dst, result);
+          pc_++;
+        } else {
+          frames_.back().caller_return_register = instr.dst;
         }
-
-        // We no longer need to write the registers back, we write directly
-        // through the registers mutably.
-        InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+        TVM_VM_DISPATCH();
+      }
+      case Opcode::InvokePacked:
+      TVM_VM_HANDLER(InvokePacked) {
+        const Instruction& instr = *ip;
+        ExecInvokePacked(instr);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::InvokeClosure: {
+      case Opcode::InvokeClosure:
+      TVM_VM_HANDLER(InvokeClosure) {
+        const Instruction& instr = *ip;
         auto object = ReadRegister(instr.closure);
         const auto* closure = object.as<VMClosureObj>();
         ICHECK(closure);
@@ -481,19 +955,28 @@ void VirtualMachine::RunLoop() {
         for (Index i = 0; i < instr.num_closure_args; ++i) {
           args.push_back(ReadRegister(instr.closure_args[i]));
         }
-        InvokeGlobal(exec_->functions[closure->func_index], args);
-        frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        ObjectRef result;
+        if (InvokeGlobalCached(closure->func_index, args, &result)) {
+          WriteRegister(instr.dst, result);
+          pc_++;
+        } else {
+          frames_.back().caller_return_register = instr.dst;
+        }
+        TVM_VM_DISPATCH();
       }
-      case Opcode::GetField: {
+      case Opcode::GetField:
+      TVM_VM_HANDLER(GetField) {
+        const Instruction& instr = *ip;
         auto object = ReadRegister(instr.object);
         const auto& tuple = Downcast<ADT>(object);
         auto field = tuple[instr.field_index];
         WriteRegister(instr.dst, field);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::GetTag: {
+      case Opcode::GetTag:
+      TVM_VM_HANDLER(GetTag) {
+        const Instruction& instr = *ip;
         auto object = ReadRegister(instr.get_tag.object);
         const auto& adt = Downcast<ADT>(object);
         auto tag = adt.tag();
@@ -501,13 +984,17 @@ void VirtualMachine::RunLoop() {
         reinterpret_cast<int32_t*>(tag_tensor->data)[0] = tag;
         WriteRegister(instr.dst, tag_tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Goto: {
+      case Opcode::Goto:
+      TVM_VM_HANDLER(Goto) {
+        const Instruction& instr = *ip;
         pc_ += instr.pc_offset;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::If: {
+      case Opcode::If:
+      TVM_VM_HANDLER(If) {
+        const Instruction& instr = *ip;
         int32_t test_val = LoadScalarInt(instr.if_op.test);
         int32_t target_val = LoadScalarInt(instr.if_op.target);
 
@@ -519,39 +1006,27 @@ void VirtualMachine::RunLoop() {
           pc_ += instr.if_op.false_offset;
         }
 
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocTensor: {
-        auto shape = std::vector<int64_t>(instr.alloc_tensor.ndim);
-
-        for (uint32_t i = 0; i < instr.alloc_tensor.ndim; ++i) {
-          shape[i] = instr.alloc_tensor.shape[i];
-        }
-
-        auto storage_obj = ReadRegister(instr.alloc_tensor.storage);
-        auto offset = LoadScalarInt(instr.alloc_tensor.offset);
-        auto storage = Downcast<Storage>(storage_obj);
-        auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor.dtype);
-
-        WriteRegister(instr.dst, obj);
+      case Opcode::AllocTensor:
+      TVM_VM_HANDLER(AllocTensor) {
+        const Instruction& instr = *ip;
+        auto storage = Downcast<Storage>(ReadRegister(instr.alloc_tensor.storage));
+        WriteRegister(instr.dst, ExecAllocTensor(instr, storage));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocTensorReg: {
-        Device cpu_dev = GetDevice(static_cast<Index>(kDLCPU));
-        auto shape_obj = ReadRegister(instr.alloc_tensor_reg.shape_register);
-        NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
-        auto shape = ToShape(shape_tensor);
-        auto storage_obj = ReadRegister(instr.alloc_tensor_reg.storage);
-        auto storage = Downcast<Storage>(storage_obj);
-        auto offset = LoadScalarInt(instr.alloc_tensor.offset);
-        auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor_reg.dtype);
-
-        WriteRegister(instr.dst, obj);
+      case Opcode::AllocTensorReg:
+      TVM_VM_HANDLER(AllocTensorReg) {
+        const Instruction& instr = *ip;
+        auto storage = Downcast<Storage>(ReadRegister(instr.alloc_tensor_reg.storage));
+        WriteRegister(instr.dst, ExecAllocTensor(instr, storage));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocADT: {
+      case Opcode::AllocADT:
+      TVM_VM_HANDLER(AllocADT) {
+        const Instruction& instr = *ip;
         std::vector<ObjectRef> fields;
         for (Index i = 0; i < instr.num_fields; ++i) {
           fields.push_back(ReadRegister(instr.datatype_fields[i]));
@@ -559,38 +1034,29 @@ void VirtualMachine::RunLoop() {
         ObjectRef obj = ADT(instr.constructor_tag, fields);
         WriteRegister(instr.dst, obj);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocClosure: {
+      case Opcode::AllocClosure:
+      TVM_VM_HANDLER(AllocClosure) {
+        const Instruction& instr = *ip;
         std::vector<ObjectRef> free_vars;
         for (Index i = 0; i < instr.num_freevar; i++) {
           free_vars.push_back(ReadRegister(instr.free_vars[i]));
         }
         WriteRegister(instr.dst, VMClosure(instr.func_index, free_vars));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocStorage: {
-        auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
-        auto alignment = instr.alloc_storage.alignment;
-
-        DLOG(INFO) << "AllocStorage: allocation_size=" << size << ", alignment=" << alignment
-                   << ", dtype_hint=" << DLDataType2String(instr.alloc_storage.dtype_hint)
-                   << ", device_type=" << instr.alloc_storage.device_type;
-
-        auto storage_obj = SimpleObjAllocator().make_object<StorageObj>();
-        auto dev_type = instr.alloc_storage.device_type;
-        ICHECK_LT(static_cast<size_t>(dev_type), allocators_.size())
-            << "Memory allocator for device " << dev_type << " has not been initialized";
-        auto* alloc = allocators_[dev_type];
-        ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
-        storage_obj->buffer = alloc->Alloc(size, alignment, instr.alloc_storage.dtype_hint);
-        Storage storage(storage_obj);
-        WriteRegister(instr.dst, storage);
+      case Opcode::AllocStorage:
+      TVM_VM_HANDLER(AllocStorage) {
+        const Instruction& instr = *ip;
+        WriteRegister(instr.dst, ExecAllocStorage(instr));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::ShapeOf: {
+      case Opcode::ShapeOf:
+      TVM_VM_HANDLER(ShapeOf) {
+        const Instruction& instr = *ip;
         auto input = ReadRegister(instr.shape_of.tensor);
         NDArray input_array = Downcast<NDArray>(input);
         int ndim = input_array->ndim;
@@ -600,24 +1066,33 @@ void VirtualMachine::RunLoop() {
         }
         WriteRegister(instr.dst, out_tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Ret: {
+      case Opcode::Ret:
+      TVM_VM_HANDLER(Ret) {
+        const Instruction& instr = *ip;
         // If we have hit the point from which we started
         // running, we should return to the caller breaking
         // the dispatch loop.
         return_register_ = ReadRegister(instr.result);
         auto caller_return_register = frames_.back().caller_return_register;
+        if (frames_.back().cache_slot >= 0) {
+          const VMFrame& frame = frames_.back();
+          result_cache_->Insert(frame.cache_slot, frame.cache_key, frame.cache_inputs,
+                                return_register_);
+        }
 
         if (PopFrame() == frame_start) {
           return;
           // Otherwise we are just returning from a local call.
         } else {
           WriteRegister(caller_return_register, return_register_);
-          goto main_loop;
+          TVM_VM_DISPATCH();
         }
       }
-      case Opcode::ReshapeTensor: {
+      case Opcode::ReshapeTensor:
+      TVM_VM_HANDLER(ReshapeTensor) {
+        const Instruction& instr = *ip;
         Device cpu_dev = GetDevice(static_cast<Index>(kDLCPU));
         auto tensor_obj = ReadRegister(instr.reshape_tensor.tensor);
         NDArray tensor_arr = Downcast<NDArray>(tensor_obj);
@@ -634,9 +1109,11 @@ void VirtualMachine::RunLoop() {
         auto out_tensor = tensor_arr.CreateView(shape, tensor_arr->dtype);
         WriteRegister(instr.dst, out_tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::DeviceCopy: {
+      case Opcode::DeviceCopy:
+      TVM_VM_HANDLER(DeviceCopy) {
+        const Instruction& instr = *ip;
         auto tensor_src = ReadRegister(instr.src);
         NDArray src_data = Downcast<NDArray>(tensor_src);
         Device src_dev = src_data->device;
@@ -647,16 +1124,20 @@ void VirtualMachine::RunLoop() {
         dst_dev.device_id = 0;
 
         NDArray dst_data = src_data.CopyTo(dst_dev);
+        if (retained_objects_ != nullptr) retained_objects_->push_back(dst_data);
         WriteRegister(instr.dst, dst_data);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
       default:
-        LOG(FATAL) << "Unknown instruction opcode: " << int(instr.op);
+        LOG(FATAL) << "Unknown instruction opcode: " << int(ip->op);
     }
   }
 }
 
+#undef TVM_VM_DISPATCH
+#undef TVM_VM_HANDLER
+
 runtime::Module CreateVirtualMachine(const Executable* exec) {
   auto vm = make_object<VirtualMachine>();
   vm->LoadExecutable(exec);
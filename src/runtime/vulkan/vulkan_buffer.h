@@ -25,6 +25,8 @@
 #include <memory>
 #include <unordered_map>
 
+#include "vulkan_memory_allocator.h"
+
 namespace tvm {
 namespace runtime {
 namespace vulkan {
@@ -46,9 +48,13 @@ class VulkanBuffer {
    * \param mem_type_index The memory type to index.  This should be
    * an index to a compatible memory located in
    * VkPhysicalDeviceMemoryProperties.
+   *
+   * \param allocator If not null, the memory is sub-allocated from
+   * the allocator, unless the buffer requires or prefers a dedicated
+   * allocation.  The allocator should outlive the VulkanBuffer.
    */
   VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUsageFlags usage,
-               uint32_t mem_type_index);
+               uint32_t mem_type_index, VulkanMemoryAllocator* allocator = nullptr);
 
   //! \brief Destructor, deallocates the memory and buffer.
   ~VulkanBuffer();
@@ -103,6 +109,18 @@ class VulkanBuffer {
   //! \brief Handle to the physical device memory
   VkDeviceMemory memory{VK_NULL_HANDLE};
 
+  //! \brief The offset in bytes of the buffer in the device memory
+  VkDeviceSize offset{0};
+
+  /*! \brief The allocator the memory is sub-allocated from
+   *
+   * Null if the buffer owns its memory.
+   */
+  VulkanMemoryAllocator* allocator_{nullptr};
+
+  //! \brief The memory range given by allocator_
+  VulkanMemoryAllocation allocation_;
+
   friend class VulkanHostVisibleBuffer;
 };
 
@@ -20,7 +20,14 @@
 #include "vulkan_device.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <mutex>
+#include <random>
+#include <sstream>
 #include <unordered_map>
 #include <utility>
 
@@ -220,6 +227,7 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
   // holds the ancillary handles that TVM needs.
 
   vkGetDeviceQueue(device_, queue_family_index, 0, &queue);
+  CreatePipelineCache();
 
   // Find suitable memory type for staging and compute
   // Find suitable compute index.
@@ -298,6 +306,10 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
     get_buffer_memory_requirements_2_functions =
         std::make_unique<VulkanGetBufferMemoryRequirements2Functions>(device_);
   }
+
+  if (!support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_SUBALLOCATION")) {
+    memory_allocator = std::make_unique<VulkanMemoryAllocator>(physical_device_, device_);
+  }
 }
 
 VulkanDevice::~VulkanDevice() {
@@ -308,7 +320,12 @@ VulkanDevice::~VulkanDevice() {
   stream_per_thread.Clear();
   staging_buffer_per_thread.Clear();
   uniform_buffer_per_thread.Clear();
+  memory_allocator.reset();
 
+  if (pipeline_cache != VK_NULL_HANDLE) {
+    SavePipelineCache();
+    vkDestroyPipelineCache(device_, pipeline_cache, nullptr);
+  }
   if (device_) {
     vkDestroyDevice(device_, nullptr);
   }
@@ -337,15 +354,95 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
   std::swap(get_buffer_memory_requirements_2_functions,
             other.get_buffer_memory_requirements_2_functions);
   std::swap(compute_mtype_index, other.compute_mtype_index);
+  std::swap(memory_allocator, other.memory_allocator);
   std::swap(queue, other.queue);
   std::swap(queue_family_index, other.queue_family_index);
   std::swap(physical_device_, other.physical_device_);
   std::swap(enabled_extensions, other.enabled_extensions);
   std::swap(device_, other.device_);
+  std::swap(pipeline_cache, other.pipeline_cache);
 }
 
 bool VulkanDevice::SupportsCompute() const { return queue_family_index != uint32_t(-1); }
 
+std::string VulkanDevice::PipelineCachePath() const {
+  const char* dir = std::getenv("TVM_VULKAN_PIPELINE_CACHE_DIR");
+  if (dir == nullptr || *dir == '\0') {
+    return "";
+  }
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physical_device_, &props);
+  std::ostringstream path;
+  path << dir << "/vulkan_pipeline_" << std::hex << props.vendorID << "_" << props.deviceID << "_"
+       << props.driverVersion << ".cache";
+  return path.str();
+}
+
+void VulkanDevice::CreatePipelineCache() {
+  std::vector<char> data;
+  std::string path = PipelineCachePath();
+  if (!path.empty()) {
+    std::ifstream fs(path, std::ios::in | std::ios::binary);
+    if (fs) {
+      data.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+    }
+  }
+  // The drivers should reject a foreign cache, but check the header
+  // ourselves as some do not.
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physical_device_, &props);
+  VkPipelineCacheHeaderVersionOne header;
+  if (data.size() < sizeof(header)) {
+    data.clear();
+  } else {
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        header.vendorID != props.vendorID || header.deviceID != props.deviceID ||
+        memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+      LOG(INFO) << "Ignoring the Vulkan pipeline cache " << path
+                << ", it was made by another device or driver";
+      data.clear();
+    }
+  }
+
+  VkPipelineCacheCreateInfo cache_cinfo;
+  cache_cinfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  cache_cinfo.pNext = nullptr;
+  cache_cinfo.flags = 0;
+  cache_cinfo.initialDataSize = data.size();
+  cache_cinfo.pInitialData = data.empty() ? nullptr : data.data();
+  VULKAN_CALL(vkCreatePipelineCache(device_, &cache_cinfo, nullptr, &pipeline_cache));
+}
+
+void VulkanDevice::SavePipelineCache() const {
+  std::string path = PipelineCachePath();
+  if (path.empty() || pipeline_cache == VK_NULL_HANDLE) {
+    return;
+  }
+  size_t size = 0;
+  VULKAN_CALL(vkGetPipelineCacheData(device_, pipeline_cache, &size, nullptr));
+  std::vector<char> data(size);
+  VULKAN_CALL(vkGetPipelineCacheData(device_, pipeline_cache, &size, data.data()));
+
+  static std::mutex save_mutex;
+  std::lock_guard<std::mutex> lock(save_mutex);
+  std::ostringstream tmp_path;
+  // A unique name, the processes sharing the directory must not write the same file.
+  tmp_path << path << ".tmp" << std::random_device()();
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (!fs) {
+      LOG(WARNING) << "Cannot write the Vulkan pipeline cache " << tmp_path.str();
+      return;
+    }
+    fs.write(data.data(), size);
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the Vulkan pipeline cache " << path;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
 void VulkanDevice::QueueSubmit(VkSubmitInfo submit_info, VkFence fence) const {
   // Multiple streams (on different threads) use the same VulkanDevice
   // instance, so we need to externally synchronize accesses.
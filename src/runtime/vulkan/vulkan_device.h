@@ -33,6 +33,7 @@
 #include "../thread_map.h"
 #include "vulkan/vulkan_core.h"
 #include "vulkan_buffer.h"
+#include "vulkan_memory_allocator.h"
 #include "vulkan_stream.h"
 
 namespace tvm {
@@ -212,11 +213,35 @@ class VulkanDevice {
   // Memory type index for compute
   uint32_t compute_mtype_index{0};
 
+  /*! \brief The sub-allocator of the memory of the data buffers
+   *
+   * Null if disabled by TVM_VULKAN_DISABLE_SUBALLOCATION, in which
+   * case each buffer has its own VkDeviceMemory.
+   */
+  std::unique_ptr<VulkanMemoryAllocator> memory_allocator{nullptr};
+
   // queue family_index;
   uint32_t queue_family_index{uint32_t(-1)};
 
   bool UseImmediate() const { return descriptor_template_khr_functions != nullptr; }
 
+  /*! \brief Write the pipeline cache to disk
+   *
+   * Does nothing unless TVM_VULKAN_PIPELINE_CACHE_DIR is set.  The
+   * file is keyed by the vendor, the device and the driver version,
+   * and replaced atomically so that processes sharing the directory
+   * never read a partial cache.
+   */
+  void SavePipelineCache() const;
+
+  /*! \brief The pipeline cache used by the pipelines of all modules
+   *
+   * Loaded at device creation from TVM_VULKAN_PIPELINE_CACHE_DIR, if
+   * set, so that the driver skips the shader compilation of
+   * pipelines created by previous runs.
+   */
+  VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
+
  private:
   /*! \brief Helper function for move assignment/construction
    *
@@ -245,6 +270,16 @@ class VulkanDevice {
    */
   void CreateVkDevice(const VulkanInstance& instance);
 
+  /*! \brief Create the pipeline cache, from the cache on disk when valid
+   *
+   * Called during VulkanDevice construction, after the VkDevice is
+   * created.
+   */
+  void CreatePipelineCache();
+
+  /*! \brief The path of the pipeline cache on disk, empty if not persisted */
+  std::string PipelineCachePath() const;
+
   //! \brief Handle to the Vulkan API physical device
   VkPhysicalDevice physical_device_{nullptr};
 
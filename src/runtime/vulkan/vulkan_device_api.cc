@@ -19,11 +19,14 @@
 
 #include "vulkan_device_api.h"
 
+#include <tvm/runtime/profiling.h>
+
 #include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "vulkan_common.h"
 
@@ -237,7 +240,8 @@ void* VulkanDeviceAPI::AllocDataSpace(Device dev, size_t nbytes, size_t alignmen
   const auto& device = this->device(dev.device_id);
   auto usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-  return new VulkanBuffer(device, nbytes, usage, device.compute_mtype_index);
+  return new VulkanBuffer(device, nbytes, usage, device.compute_mtype_index,
+                          device.memory_allocator.get());
 }
 
 void VulkanDeviceAPI::FreeDataSpace(Device dev, void* ptr) {
@@ -286,11 +290,28 @@ void VulkanDeviceAPI::SetStream(Device dev, TVMStreamHandle stream) {
 void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void* to,
                                      size_t to_offset, size_t size, Device dev_from, Device dev_to,
                                      DLDataType type_hint, TVMStreamHandle stream) {
+  CopyDataFromTo2D(from, from_offset, size, to, to_offset, size, size, 1, dev_from, dev_to,
+                   type_hint, stream);
+}
+
+void VulkanDeviceAPI::CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch,
+                                       void* to, size_t to_offset, size_t to_pitch, size_t width,
+                                       size_t height, Device dev_from, Device dev_to,
+                                       DLDataType type_hint, TVMStreamHandle stream) {
   ICHECK(stream == nullptr);
-  Device dev = dev_from;
-  if (dev_from.device_type == kDLCPU) {
-    dev = dev_to;
-  }
+  // The rows are copied by the regions of a single vkCmdCopyBuffer, through a staging buffer
+  // where they are packed for the host copies.
+  size_t size = width * height;
+  auto make_regions = [&](size_t src_offset, size_t src_pitch, size_t dst_offset,
+                          size_t dst_pitch) {
+    std::vector<VkBufferCopy> regions(height);
+    for (size_t i = 0; i < height; ++i) {
+      regions[i].srcOffset = src_offset + i * src_pitch;
+      regions[i].dstOffset = dst_offset + i * dst_pitch;
+      regions[i].size = width;
+    }
+    return regions;
+  };
 
   int from_dev_type = static_cast<int>(dev_from.device_type);
   int to_dev_type = static_cast<int>(dev_to.device_type);
@@ -299,25 +320,16 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
         << "The Vulkan runtime does not support deviceA to deviceB copies. "
         << "This should be changed to a deviceA to CPU copy, followed by a CPU to deviceB copy";
 
+    std::vector<VkBufferCopy> regions = make_regions(from_offset, from_pitch, to_offset, to_pitch);
     device(dev_from.device_id).ThreadLocalStream().Launch([=](VulkanStreamState* state) {
       // 1: copy
       const auto* from_buf = static_cast<const VulkanBuffer*>(from);
       auto* to_buf = static_cast<VulkanBuffer*>(to);
-      VkBufferCopy copy_info;
-      copy_info.srcOffset = from_offset;
-      copy_info.dstOffset = to_offset;
-      copy_info.size = size;
-      vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, to_buf->buffer, 1, &copy_info);
-      // 2: barrier(transfer-> compute|transfer)
-      VkMemoryBarrier barrier_info;
-      barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-      barrier_info.pNext = nullptr;
-      barrier_info.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
-                                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-      vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
-                           1, &barrier_info, 0, nullptr, 0, nullptr);
+      // 0: barrier(previous accesses -> transfer), 1: copy
+      state->BarrierBeforeAccess({from_buf->buffer, to_buf->buffer},
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
+      vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, to_buf->buffer,
+                      static_cast<uint32_t>(regions.size()), regions.data());
     });
 
   } else if (from_dev_type == kDLVulkan && to_dev_type == kDLCPU) {
@@ -325,13 +337,12 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
     auto& device = this->device(dev_from.device_id);
     auto& stream = device.ThreadLocalStream();
     auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
+    std::vector<VkBufferCopy> regions = make_regions(from_offset, from_pitch, 0, width);
     stream.Launch([&](VulkanStreamState* state) {
-      VkBufferCopy copy_info;
-      copy_info.srcOffset = from_offset;
-      copy_info.dstOffset = 0;
-      copy_info.size = size;
-      vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, staging_buffer.vk_buf.buffer, 1,
-                      &copy_info);
+      state->BarrierBeforeAccess({from_buf->buffer, staging_buffer.vk_buf.buffer},
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
+      vkCmdCopyBuffer(state->cmd_buffer_, from_buf->buffer, staging_buffer.vk_buf.buffer,
+                      static_cast<uint32_t>(regions.size()), regions.data());
     });
     stream.Synchronize();
     if (!device.coherent_staging) {
@@ -343,13 +354,19 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
       mrange.size = VK_WHOLE_SIZE;  // size;
       VULKAN_CALL(vkInvalidateMappedMemoryRanges(device, 1, &mrange));
     }
-    memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>(staging_buffer.host_addr), size);
+    for (size_t i = 0; i < height; ++i) {
+      memcpy(static_cast<char*>(to) + to_offset + i * to_pitch,
+             static_cast<char*>(staging_buffer.host_addr) + i * width, width);
+    }
   } else if (from_dev_type == kDLCPU && to_dev_type == kDLVulkan) {
     auto& device = this->device(dev_to.device_id);
     auto& stream = device.ThreadLocalStream();
     const auto* to_buf = static_cast<const VulkanBuffer*>(to);
     auto& staging_buffer = device.ThreadLocalStagingBuffer(size);
-    memcpy(staging_buffer.host_addr, static_cast<const char*>(from) + from_offset, size);
+    for (size_t i = 0; i < height; ++i) {
+      memcpy(static_cast<char*>(staging_buffer.host_addr) + i * width,
+             static_cast<const char*>(from) + from_offset + i * from_pitch, width);
+    }
     // host side flush if access is not coherent.
     // so writes from CPU is visible to GPU
     if (!device.coherent_staging) {
@@ -362,6 +379,7 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
       VULKAN_CALL(vkFlushMappedMemoryRanges(device, 1, &mrange));
     }
 
+    std::vector<VkBufferCopy> regions = make_regions(0, width, to_offset, to_pitch);
     stream.Launch([&](VulkanStreamState* state) {
       // 0: barrier(host->transfer)
       VkMemoryBarrier barrier_info;
@@ -372,13 +390,12 @@ void VulkanDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void*
       vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_HOST_BIT,
                            VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier_info, 0, nullptr, 0,
                            nullptr);
-      // 1: copy
-      VkBufferCopy copy_info;
-      copy_info.srcOffset = 0;
-      copy_info.dstOffset = to_offset;
-      copy_info.size = size;
-      vkCmdCopyBuffer(state->cmd_buffer_, staging_buffer.vk_buf.buffer, to_buf->buffer, 1,
-                      &copy_info);
+      // 1: barrier(previous accesses -> transfer)
+      state->BarrierBeforeAccess({staging_buffer.vk_buf.buffer, to_buf->buffer},
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT);
+      // 2: copy
+      vkCmdCopyBuffer(state->cmd_buffer_, staging_buffer.vk_buf.buffer, to_buf->buffer,
+                      static_cast<uint32_t>(regions.size()), regions.data());
     });
     // TODO(tulloch): should we instead make the staging buffer a property of the
     // Stream? This would allow us to elide synchronizations here.
@@ -404,6 +421,41 @@ TVM_REGISTER_GLOBAL("device_api.vulkan").set_body([](TVMArgs args, TVMRetValue*
   *rv = static_cast<void*>(ptr);
 });
 
+TVM_REGISTER_GLOBAL("device_api.vulkan.stream_profile").set_body_typed([](Device dev) {
+  using profiling::CountNode;
+  using profiling::DurationNode;
+  VulkanStreamProfile profile =
+      VulkanDeviceAPI::Global()->device(dev.device_id).ThreadLocalStream().Profile();
+  Map<String, ObjectRef> metrics;
+  metrics.Set("num_submits", ObjectRef(make_object<CountNode>(profile.num_submits)));
+  metrics.Set("num_barriers", ObjectRef(make_object<CountNode>(profile.num_barriers)));
+  metrics.Set("num_elided_barriers",
+              ObjectRef(make_object<CountNode>(profile.num_elided_barriers)));
+  metrics.Set("submit_duration", ObjectRef(make_object<DurationNode>(profile.submit_us)));
+  metrics.Set("wait_duration", ObjectRef(make_object<DurationNode>(profile.wait_us)));
+  return metrics;
+});
+
+TVM_REGISTER_GLOBAL("device_api.vulkan.memory_stats")
+    .set_body_typed([](Device dev, const std::string& name) -> int64_t {
+      const auto& allocator = VulkanDeviceAPI::Global()->device(dev.device_id).memory_allocator;
+      VulkanMemoryStats stats = allocator ? allocator->Stats() : VulkanMemoryStats();
+      if (name == "num_blocks") {
+        return stats.num_blocks;
+      } else if (name == "reserved_bytes") {
+        return stats.reserved_bytes;
+      } else if (name == "used_bytes") {
+        return stats.used_bytes;
+      }
+      LOG(FATAL) << "Unknown Vulkan memory statistic " << name;
+      return 0;
+    });
+
+TVM_REGISTER_GLOBAL("device_api.vulkan.release_unused_memory").set_body_typed([](Device dev) {
+  const auto& allocator = VulkanDeviceAPI::Global()->device(dev.device_id).memory_allocator;
+  return allocator ? static_cast<int64_t>(allocator->ReleaseUnusedBlocks()) : int64_t(0);
+});
+
 TVM_REGISTER_GLOBAL("device_api.vulkan.get_target_property")
     .set_body_typed([](Device dev, const std::string& property) {
       TVMRetValue rv;
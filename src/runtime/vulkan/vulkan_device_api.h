@@ -67,6 +67,10 @@ class VulkanDeviceAPI final : public DeviceAPI {
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
                       TVMStreamHandle stream) final;
+  void CopyDataFromTo2D(const void* from, size_t from_offset, size_t from_pitch, void* to,
+                        size_t to_offset, size_t to_pitch, size_t width, size_t height,
+                        Device dev_from, Device dev_to, DLDataType type_hint,
+                        TVMStreamHandle stream) final;
 
   // End of required methods for the DeviceAPI interface
 
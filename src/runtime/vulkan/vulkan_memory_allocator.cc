@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "vulkan_memory_allocator.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "vulkan_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace vulkan {
+
+namespace {
+
+// The size of the blocks, capped to an eighth of the heap of the
+// memory type so that small heaps are not exhausted by one block.
+constexpr VkDeviceSize kDefaultBlockSize = VkDeviceSize(64) << 20;
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(VkPhysicalDevice physical_device, VkDevice device)
+    : device_(device) {
+  VkPhysicalDeviceMemoryProperties prop;
+  vkGetPhysicalDeviceMemoryProperties(physical_device, &prop);
+  block_sizes_.resize(prop.memoryTypeCount);
+  for (uint32_t k = 0; k < prop.memoryTypeCount; ++k) {
+    VkDeviceSize heap_size = prop.memoryHeaps[prop.memoryTypes[k].heapIndex].size;
+    block_sizes_[k] = std::max<VkDeviceSize>(std::min(kDefaultBlockSize, heap_size / 8), 1);
+  }
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+  for (const auto& kv : blocks_) {
+    vkFreeMemory(device_, kv.first, nullptr);
+  }
+}
+
+VulkanMemoryAllocation VulkanMemoryAllocator::Allocate(const VkMemoryRequirements& requirements,
+                                                       uint32_t mem_type_index) {
+  ICHECK_LT(mem_type_index, block_sizes_.size());
+  ICHECK(requirements.memoryTypeBits & (1U << mem_type_index))
+      << "Memory type " << mem_type_index << " cannot hold the buffer";
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  VulkanMemoryAllocation allocation;
+  allocation.size = requirements.size;
+  VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+  VkDeviceSize block_size = block_sizes_[mem_type_index];
+  if (requirements.size > block_size / 2) {
+    Block* block = AllocateBlock(requirements.size, mem_type_index, true);
+    block->used = requirements.size;
+    allocation.memory = block->memory;
+    return allocation;
+  }
+
+  for (Block* block : blocks_per_type_[mem_type_index]) {
+    if (!block->dedicated &&
+        AllocateFromBlock(block, requirements.size, alignment, &allocation.offset)) {
+      allocation.memory = block->memory;
+      return allocation;
+    }
+  }
+  Block* block = AllocateBlock(block_size, mem_type_index, false);
+  ICHECK(AllocateFromBlock(block, requirements.size, alignment, &allocation.offset));
+  allocation.memory = block->memory;
+  return allocation;
+}
+
+void VulkanMemoryAllocator::Free(const VulkanMemoryAllocation& allocation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = blocks_.find(allocation.memory);
+  ICHECK(it != blocks_.end()) << "Freed memory not allocated by this allocator";
+  Block* block = it->second.get();
+  block->used -= allocation.size;
+  if (block->dedicated) {
+    FreeBlock(block->memory);
+    return;
+  }
+
+  // Insert the range, merged with the free ranges around it.
+  VkDeviceSize offset = allocation.offset;
+  VkDeviceSize size = allocation.size;
+  auto next = block->free_ranges.lower_bound(offset);
+  if (next != block->free_ranges.end() && offset + size == next->first) {
+    size += next->second;
+    next = block->free_ranges.erase(next);
+  }
+  if (next != block->free_ranges.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      block->free_ranges.erase(prev);
+    }
+  }
+  block->free_ranges[offset] = size;
+
+  if (block->used == 0) {
+    const auto& blocks = blocks_per_type_[block->mem_type_index];
+    bool has_other_empty = std::any_of(blocks.begin(), blocks.end(), [&](const Block* other) {
+      return other != block && !other->dedicated && other->used == 0;
+    });
+    if (has_other_empty) {
+      FreeBlock(block->memory);
+    }
+  }
+}
+
+VkDeviceSize VulkanMemoryAllocator::ReleaseUnusedBlocks() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<VkDeviceMemory> unused;
+  VkDeviceSize released = 0;
+  for (const auto& kv : blocks_) {
+    if (kv.second->used == 0) {
+      unused.push_back(kv.first);
+      released += kv.second->size;
+    }
+  }
+  for (VkDeviceMemory memory : unused) {
+    FreeBlock(memory);
+  }
+  return released;
+}
+
+VulkanMemoryStats VulkanMemoryAllocator::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  VulkanMemoryStats stats;
+  stats.num_blocks = blocks_.size();
+  for (const auto& kv : blocks_) {
+    stats.reserved_bytes += kv.second->size;
+    stats.used_bytes += kv.second->used;
+  }
+  return stats;
+}
+
+VulkanMemoryAllocator::Block* VulkanMemoryAllocator::AllocateBlock(VkDeviceSize size,
+                                                                   uint32_t mem_type_index,
+                                                                   bool dedicated) {
+  VkMemoryAllocateInfo mem_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  mem_info.allocationSize = size;
+  mem_info.memoryTypeIndex = mem_type_index;
+  VkDeviceMemory memory;
+  VkResult res = vkAllocateMemory(device_, &mem_info, nullptr, &memory);
+  if (res == VK_ERROR_OUT_OF_DEVICE_MEMORY || res == VK_ERROR_OUT_OF_HOST_MEMORY) {
+    // The empty blocks of the other memory types may be on the same heap.
+    for (auto it = blocks_.begin(); it != blocks_.end();) {
+      auto current = it++;
+      if (current->second->used == 0) {
+        FreeBlock(current->first);
+      }
+    }
+    res = vkAllocateMemory(device_, &mem_info, nullptr, &memory);
+  }
+  VULKAN_CHECK_ERROR(res);
+
+  auto block = std::make_unique<Block>();
+  block->memory = memory;
+  block->mem_type_index = mem_type_index;
+  block->size = size;
+  block->dedicated = dedicated;
+  if (!dedicated) {
+    block->free_ranges[0] = size;
+  }
+  Block* ptr = block.get();
+  blocks_[memory] = std::move(block);
+  blocks_per_type_[mem_type_index].push_back(ptr);
+  return ptr;
+}
+
+bool VulkanMemoryAllocator::AllocateFromBlock(Block* block, VkDeviceSize size,
+                                              VkDeviceSize alignment, VkDeviceSize* offset) {
+  for (auto it = block->free_ranges.begin(); it != block->free_ranges.end(); ++it) {
+    VkDeviceSize range_begin = it->first;
+    VkDeviceSize range_end = it->first + it->second;
+    VkDeviceSize begin = AlignUp(range_begin, alignment);
+    if (begin + size > range_end) continue;
+
+    block->free_ranges.erase(it);
+    if (begin > range_begin) {
+      block->free_ranges[range_begin] = begin - range_begin;
+    }
+    if (begin + size < range_end) {
+      block->free_ranges[begin + size] = range_end - (begin + size);
+    }
+    block->used += size;
+    *offset = begin;
+    return true;
+  }
+  return false;
+}
+
+void VulkanMemoryAllocator::FreeBlock(VkDeviceMemory memory) {
+  auto it = blocks_.find(memory);
+  ICHECK(it != blocks_.end());
+  auto& blocks = blocks_per_type_[it->second->mem_type_index];
+  blocks.erase(std::find(blocks.begin(), blocks.end(), it->second.get()));
+  vkFreeMemory(device_, memory, nullptr);
+  blocks_.erase(it);
+}
+
+}  // namespace vulkan
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TVM_RUNTIME_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
+#define TVM_RUNTIME_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
+
+#include <vulkan/vulkan_core.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vulkan {
+
+/*! \brief A range of device memory, sub-allocated by a VulkanMemoryAllocator */
+struct VulkanMemoryAllocation {
+  //! \brief The device memory the range belongs to
+  VkDeviceMemory memory{VK_NULL_HANDLE};
+  //! \brief The offset in bytes of the range in the device memory
+  VkDeviceSize offset{0};
+  //! \brief The size in bytes of the range
+  VkDeviceSize size{0};
+};
+
+/*! \brief The memory held by a VulkanMemoryAllocator */
+struct VulkanMemoryStats {
+  //! \brief The number of VkDeviceMemory allocations
+  size_t num_blocks{0};
+  //! \brief The bytes allocated from the device
+  VkDeviceSize reserved_bytes{0};
+  //! \brief The bytes sub-allocated to buffers
+  VkDeviceSize used_bytes{0};
+};
+
+/*! \brief Sub-allocates buffer memory from large device memory blocks
+ *
+ * Drivers limit the number of VkDeviceMemory allocations (often to
+ * 4096), and each allocation is expensive.  The allocator instead
+ * allocates blocks of memory, one list per memory type, and places
+ * the buffers in the free ranges of the blocks, first fit.  Freed
+ * ranges are merged with their free neighbours.  Requests larger
+ * than half a block get a block of their own, freed with the buffer.
+ *
+ * At most one empty block is kept per memory type, for the next
+ * allocations, the others are returned to the device as soon as they
+ * are empty.  The bound buffers cannot be moved, so the allocator
+ * does not compact the blocks; ReleaseUnusedBlocks is the hook to
+ * return all the empty blocks, e.g. after a pooled allocator released
+ * its buffers.
+ *
+ * Safe to call from multiple CPU threads.
+ */
+class VulkanMemoryAllocator {
+ public:
+  /*! \brief Create the allocator of a device
+   *
+   * \param physical_device The physical device, queried for the size
+   * of the memory heaps.
+   *
+   * \param device The logical device allocating the memory.  Should
+   * outlive the allocator.
+   */
+  VulkanMemoryAllocator(VkPhysicalDevice physical_device, VkDevice device);
+
+  //! \brief Destructor, frees all the blocks
+  ~VulkanMemoryAllocator();
+
+  // Forbid copy and move, the buffers hold pointers to the allocator.
+  VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+  VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+  /*! \brief Sub-allocate memory for a buffer
+   *
+   * \param requirements The memory requirements of the buffer.
+   *
+   * \param mem_type_index The memory type of the memory.  Must be
+   * allowed by requirements.memoryTypeBits.
+   */
+  VulkanMemoryAllocation Allocate(const VkMemoryRequirements& requirements,
+                                  uint32_t mem_type_index);
+
+  //! \brief Return a range given by Allocate
+  void Free(const VulkanMemoryAllocation& allocation);
+
+  /*! \brief Free the blocks holding no buffer
+   *
+   * \returns The number of bytes returned to the device.
+   */
+  VkDeviceSize ReleaseUnusedBlocks();
+
+  //! \brief The memory held by the allocator
+  VulkanMemoryStats Stats() const;
+
+ private:
+  struct Block {
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    uint32_t mem_type_index{0};
+    VkDeviceSize size{0};
+    VkDeviceSize used{0};
+    // Whether the block holds a single allocation.
+    bool dedicated{false};
+    // The free ranges of the block, offset to size.
+    std::map<VkDeviceSize, VkDeviceSize> free_ranges;
+  };
+
+  // Allocate a new block from the device, releasing the empty blocks
+  // and retrying if the device is out of memory.
+  Block* AllocateBlock(VkDeviceSize size, uint32_t mem_type_index, bool dedicated);
+
+  // Carve a range out of the free ranges of the block, returns
+  // whether it had a large enough range.
+  static bool AllocateFromBlock(Block* block, VkDeviceSize size, VkDeviceSize alignment,
+                                VkDeviceSize* offset);
+
+  void FreeBlock(VkDeviceMemory memory);
+
+  VkDevice device_{VK_NULL_HANDLE};
+  // The size of the blocks of each memory type.
+  std::vector<VkDeviceSize> block_sizes_;
+  // The blocks by memory handle, and in allocation order by memory type.
+  std::unordered_map<VkDeviceMemory, std::unique_ptr<Block>> blocks_;
+  std::unordered_map<uint32_t, std::vector<Block*>> blocks_per_type_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace vulkan
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VULKAN_VULKAN_MEMORY_ALLOCATOR_H_
@@ -19,12 +19,48 @@
 
 #include "vulkan_stream.h"
 
+#include <chrono>
+
 #include "vulkan_device.h"
 
 namespace tvm {
 namespace runtime {
 namespace vulkan {
 
+void VulkanStreamState::BarrierBeforeAccess(const std::vector<VkBuffer>& buffers,
+                                            VkPipelineStageFlags stage) {
+  std::vector<VkBufferMemoryBarrier> barriers;
+  VkPipelineStageFlags src_stage = 0;
+  for (VkBuffer buffer : buffers) {
+    auto it = pending_accesses_.find(buffer);
+    if (it == pending_accesses_.end()) continue;
+    VkBufferMemoryBarrier barrier_info;
+    barrier_info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier_info.pNext = nullptr;
+    barrier_info.srcAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    barrier_info.dstAccessMask = barrier_info.srcAccessMask;
+    barrier_info.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier_info.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier_info.buffer = buffer;
+    barrier_info.offset = 0;
+    barrier_info.size = VK_WHOLE_SIZE;
+    barriers.push_back(barrier_info);
+    src_stage |= it->second;
+    pending_accesses_.erase(it);
+  }
+  if (barriers.empty()) {
+    ++num_elided_barriers_;
+  } else {
+    vkCmdPipelineBarrier(cmd_buffer_, src_stage, stage, 0, 0, nullptr, barriers.size(),
+                         barriers.data(), 0, nullptr);
+    ++num_barriers_;
+  }
+  for (VkBuffer buffer : buffers) {
+    pending_accesses_[buffer] |= stage;
+  }
+}
+
 VulkanStream::VulkanStream(const VulkanDevice* device)
     : device_(device), state_(new VulkanStreamState()) {
   // create command pool
@@ -132,7 +168,9 @@ void VulkanStream::Synchronize() {
   cb_submit.signalSemaphoreCount = 0;
   cb_submit.pSignalSemaphores = nullptr;
 
+  auto submit_begin = std::chrono::high_resolution_clock::now();
   device_->QueueSubmit(cb_submit, state_->fence_);
+  auto wait_begin = std::chrono::high_resolution_clock::now();
 
   uint64_t timeout = 1UL << 30UL;
   VkResult res;
@@ -140,6 +178,12 @@ void VulkanStream::Synchronize() {
     res = vkWaitForFences(*device_, 1, &(state_->fence_), 0, timeout);
   } while (res == VK_TIMEOUT);
   VULKAN_CHECK_ERROR(res);
+  auto wait_end = std::chrono::high_resolution_clock::now();
+  profile_.num_submits += 1;
+  profile_.submit_us +=
+      std::chrono::duration<double, std::micro>(wait_begin - submit_begin).count();
+  profile_.wait_us += std::chrono::duration<double, std::micro>(wait_end - wait_begin).count();
+  state_->pending_accesses_.clear();
   VULKAN_CALL(vkResetCommandBuffer(state_->cmd_buffer_, 0));
   VULKAN_CALL(vkResetFences(*device_, 1, &(state_->fence_)));
 
@@ -152,6 +196,13 @@ void VulkanStream::Synchronize() {
   VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
 }
 
+VulkanStreamProfile VulkanStream::Profile() const {
+  VulkanStreamProfile profile = profile_;
+  profile.num_barriers = state_->num_barriers_;
+  profile.num_elided_barriers = state_->num_elided_barriers_;
+  return profile;
+}
+
 }  // namespace vulkan
 }  // namespace runtime
 }  // namespace tvm
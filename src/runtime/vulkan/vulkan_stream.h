@@ -20,6 +20,7 @@
 #ifndef TVM_RUNTIME_VULKAN_VULKAN_STREAM_H_
 #define TVM_RUNTIME_VULKAN_VULKAN_STREAM_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -35,8 +36,42 @@ class VulkanDevice;
 
 class VulkanStreamState {
  public:
+  /*! \brief Record the barrier needed before a command accessing the buffers.
+   *
+   * Every access is assumed to both read and write the buffer.  A
+   * buffer memory barrier is recorded for each of the buffers
+   * accessed by a command recorded since the buffer's last barrier,
+   * the commands on other buffers are neither waited on nor flushed,
+   * so that independent kernels can overlap on the device.
+   *
+   * \param buffers The buffers accessed by the command.
+   * \param stage The pipeline stage of the command, compute or transfer.
+   */
+  void BarrierBeforeAccess(const std::vector<VkBuffer>& buffers, VkPipelineStageFlags stage);
+
   VkCommandBuffer cmd_buffer_;
   VkFence fence_;
+  // The pipeline stages of the commands recorded since the last
+  // barrier of each buffer.  Cleared at each submission, the fence
+  // wait orders the following commands.
+  std::unordered_map<VkBuffer, VkPipelineStageFlags> pending_accesses_;
+  // The number of barriers recorded, and of commands that needed none.
+  uint64_t num_barriers_{0};
+  uint64_t num_elided_barriers_{0};
+};
+
+/*! \brief The submission overhead of a stream, since its creation. */
+struct VulkanStreamProfile {
+  /*! \brief The number of command buffers submitted. */
+  uint64_t num_submits{0};
+  /*! \brief The number of pipeline barriers recorded. */
+  uint64_t num_barriers{0};
+  /*! \brief The number of commands recorded without a barrier. */
+  uint64_t num_elided_barriers{0};
+  /*! \brief The time spent in vkQueueSubmit, in microseconds. */
+  double submit_us{0};
+  /*! \brief The time spent waiting for the submissions to finish, in microseconds. */
+  double wait_us{0};
 };
 
 // Used to identify state that should only be used once-per-stream.
@@ -102,6 +137,9 @@ class VulkanStream {
   // Synchronize the current stream `state_` with respect to the host.
   void Synchronize();
 
+  /*! \brief The submission overhead of the stream. */
+  VulkanStreamProfile Profile() const;
+
  private:
   const VulkanDevice* device_;
   std::unique_ptr<VulkanStreamState> state_;
@@ -110,6 +148,7 @@ class VulkanStream {
   std::unordered_map<VkDescriptorSet, std::vector<VulkanStreamToken>> deferred_tokens_;
   std::vector<std::function<void(VulkanStreamState*)>> deferred_kernels_;
   VkCommandPool cmd_pool_;
+  VulkanStreamProfile profile_;
 };
 
 }  // namespace vulkan
@@ -21,8 +21,11 @@
 
 #include <dmlc/memory_io.h>
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
+#include "../../support/utils.h"
 #include "../file_utils.h"
 #include "vulkan_device_api.h"
 
@@ -46,8 +49,13 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
                                    const ArgUnion64* pack_args) const {
   int device_id = VulkanDeviceAPI::Global()->GetActiveDeviceID();
   auto& device = VulkanDeviceAPI::Global()->device(device_id);
+  const size_t nbytes_scalars = num_pack_args_ * sizeof(ArgUnion64);
   if (!scache_[device_id]) {
     scache_[device_id] = m_->GetPipeline(device_id, func_name_, num_pack_args_);
+    // The pipeline may have been created by another thread.
+    if (scache_[device_id]->use_ubo) {
+      device.AllocateThreadLocalUniformBuffer(nbytes_scalars);
+    }
   }
   const auto& pipeline = scache_[device_id];
   ThreadWorkLoad wl = thread_axis_cfg_.Extract(args);
@@ -61,7 +69,6 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     binfo.range = VK_WHOLE_SIZE;
     descriptor_buffers[i] = binfo;
   }
-  const size_t nbytes_scalars = num_pack_args_ * sizeof(ArgUnion64);
   if (pipeline->use_ubo) {
     auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
     VkDescriptorBufferInfo binfo;
@@ -70,6 +77,11 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     binfo.range = VK_WHOLE_SIZE;
     descriptor_buffers.push_back(binfo);
   }
+  // The storage buffers, the accesses of which are ordered by barriers.
+  std::vector<VkBuffer> buffers;
+  for (size_t i = 0; i < num_buffer_args_; ++i) {
+    buffers.push_back(descriptor_buffers[i].buffer);
+  }
   if (device.UseImmediate()) {
     // Can safely capture by reference as this lambda is immediately executed on the calling thread.
     device.ThreadLocalStream().Launch([&](VulkanStreamState* state) {
@@ -88,16 +100,8 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
                            pack_args);
       }
 
+      state->BarrierBeforeAccess(buffers, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
       vkCmdDispatch(state->cmd_buffer_, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-      VkMemoryBarrier barrier_info;
-      barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-      barrier_info.pNext = nullptr;
-      barrier_info.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-      barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
-                                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-      vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
-                           1, &barrier_info, 0, nullptr, 0, nullptr);
     });
     return;
   }
@@ -128,8 +132,8 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
                            0);
   };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
+  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars, device_id,
+                                 buffers](VulkanStreamState* state) {
     auto& device = VulkanDeviceAPI::Global()->device(device_id);
 
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
@@ -146,16 +150,8 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
                          pack_args_storage.data());
     }
 
+    state->BarrierBeforeAccess(buffers, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
     vkCmdDispatch(state->cmd_buffer_, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-    VkMemoryBarrier barrier_info;
-    barrier_info.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    barrier_info.pNext = nullptr;
-    barrier_info.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT;
-    barrier_info.dstAccessMask = (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
-                                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-    vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
-                         1, &barrier_info, 0, nullptr, 0, nullptr);
   };
   VulkanStreamToken deferred_token;
   deferred_token.descriptor_set_ = pipeline->descriptor_set;
@@ -166,24 +162,67 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
   device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
 }
 
+VulkanModuleNode::VulkanModuleNode(std::unordered_map<std::string, VulkanShader> smap,
+                                   std::unordered_map<std::string, FunctionInfo> fmap,
+                                   std::string source)
+    : smap_(smap), fmap_(fmap), source_(source) {
+  if (support::BoolEnvironmentVar("TVM_VULKAN_PRECOMPILE_PIPELINES") && !fmap_.empty()) {
+    StartPrecompile(VulkanDeviceAPI::Global()->GetActiveDeviceID());
+  }
+}
+
 VulkanModuleNode::~VulkanModuleNode() {
+  for (auto& thread : precompile_threads_) {
+    thread.join();
+  }
   // cleanup vulkan related caches.
   for (size_t device_id = 0; device_id < ecache_.size(); ++device_id) {
     for (auto& kv : ecache_[device_id]) {
       auto& pe = kv.second;
       ICHECK(pe);
-      const auto& device = VulkanDeviceAPI::Global()->device(device_id);
+      DestroyPipeline(device_id, *pe);
+    }
+  }
+}
+
+void VulkanModuleNode::DestroyPipeline(size_t device_id, const VulkanPipeline& pe) {
+  const auto& device = VulkanDeviceAPI::Global()->device(device_id);
+  if (pe.descriptor_update_template != VK_NULL_HANDLE) {
+    device.descriptor_template_khr_functions->vkDestroyDescriptorUpdateTemplateKHR(
+        device, pe.descriptor_update_template, nullptr);
+  }
+  vkDestroyPipeline(device, pe.pipeline, nullptr);
+  vkDestroyPipelineLayout(device, pe.pipeline_layout, nullptr);
+  vkDestroyDescriptorPool(device, pe.descriptor_pool, nullptr);
+  vkDestroyDescriptorSetLayout(device, pe.descriptor_set_layout, nullptr);
+  vkDestroyShaderModule(device, pe.shader, nullptr);
+}
 
-      if (pe->descriptor_update_template != VK_NULL_HANDLE) {
-        device.descriptor_template_khr_functions->vkDestroyDescriptorUpdateTemplateKHR(
-            device, pe->descriptor_update_template, nullptr);
+void VulkanModuleNode::StartPrecompile(size_t device_id) {
+  auto funcs = std::make_shared<std::vector<std::pair<std::string, size_t>>>();
+  for (const auto& kv : fmap_) {
+    size_t num_buffer_args = NumBufferArgs(kv.second.arg_types);
+    funcs->emplace_back(kv.first, kv.second.arg_types.size() - num_buffer_args);
+  }
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  auto remaining = std::make_shared<std::atomic<size_t>>(funcs->size());
+  size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+  num_threads = std::min(num_threads, funcs->size());
+  for (size_t i = 0; i < num_threads; ++i) {
+    precompile_threads_.emplace_back([this, device_id, funcs, next, remaining]() {
+      for (size_t k = (*next)++; k < funcs->size(); k = (*next)++) {
+        try {
+          GetPipeline(device_id, (*funcs)[k].first, (*funcs)[k].second);
+        } catch (const std::exception& e) {
+          // The error is raised again by the first call of the function.
+          LOG(WARNING) << "Cannot precompile the Vulkan pipeline of " << (*funcs)[k].first << ": "
+                       << e.what();
+        }
+        if (--(*remaining) == 0) {
+          VulkanDeviceAPI::Global()->device(device_id).SavePipelineCache();
+        }
       }
-      vkDestroyPipeline(device, pe->pipeline, nullptr);
-      vkDestroyPipelineLayout(device, pe->pipeline_layout, nullptr);
-      vkDestroyDescriptorPool(device, pe->descriptor_pool, nullptr);
-      vkDestroyDescriptorSetLayout(device, pe->descriptor_set_layout, nullptr);
-      vkDestroyShaderModule(device, pe->shader, nullptr);
-    }
+    });
   }
 }
 
@@ -204,13 +243,31 @@ PackedFunc VulkanModuleNode::GetFunction(const std::string& name,
 std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
                                                               const std::string& func_name,
                                                               size_t num_pack_args) {
-  auto& device = VulkanDeviceAPI::Global()->device(device_id);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto& cp = ecache_[device_id][func_name];
+    if (cp) {
+      return cp;
+    }
+  }
+  // The pipelines are created without the lock, so that the precompile
+  // threads compile in parallel.  A pipeline created twice by a race is
+  // dropped.
+  auto pe = CreatePipeline(device_id, func_name, num_pack_args);
   std::lock_guard<std::mutex> lock(mutex_);
-  const auto& cp = ecache_[device_id][func_name];
+  auto& cp = ecache_[device_id][func_name];
   if (cp) {
+    DestroyPipeline(device_id, *pe);
     return cp;
   }
-  // Create new pipeline
+  cp = pe;
+  return pe;
+}
+
+std::shared_ptr<VulkanPipeline> VulkanModuleNode::CreatePipeline(size_t device_id,
+                                                                 const std::string& func_name,
+                                                                 size_t num_pack_args) {
+  auto& device = VulkanDeviceAPI::Global()->device(device_id);
   auto pe = std::make_shared<VulkanPipeline>();
   {
     // create shader
@@ -282,9 +339,9 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
 
   size_t nbytes_scalars = num_pod * sizeof(ArgUnion64);
   if (pe->use_ubo) {
-    // Use UBO instead of push constants
+    // Use UBO instead of push constants, the uniform buffer of the
+    // calling thread is allocated by VulkanWrappedFunc.
     push_arg_info(num_buffer, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-    device.AllocateThreadLocalUniformBuffer(nbytes_scalars);
   }
 
   {
@@ -364,7 +421,7 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   pipeline_cinfo.layout = pe->pipeline_layout;
   pipeline_cinfo.basePipelineHandle = VK_NULL_HANDLE;
   pipeline_cinfo.basePipelineIndex = 0;
-  VULKAN_CALL(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipeline_cinfo, nullptr,
+  VULKAN_CALL(vkCreateComputePipelines(device, device.pipeline_cache, 1, &pipeline_cinfo, nullptr,
                                        &(pe->pipeline)));
 
   if (device.UseImmediate()) {
@@ -382,7 +439,6 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
     VULKAN_CALL(device.descriptor_template_khr_functions->vkCreateDescriptorUpdateTemplateKHR(
         device, &descrip_template_cinfo, 0, &(pe->descriptor_update_template)));
   }
-  ecache_[device_id][func_name] = pe;
   return pe;
 }
 
@@ -24,6 +24,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -83,9 +84,15 @@ class VulkanWrappedFunc {
 
 class VulkanModuleNode final : public runtime::ModuleNode {
  public:
+  /*!
+   * \brief Create the module.
+   *
+   * When TVM_VULKAN_PRECOMPILE_PIPELINES is set, the pipelines of all
+   * the functions are created in background threads for the active
+   * device, and the pipeline cache is saved once they are all made.
+   */
   explicit VulkanModuleNode(std::unordered_map<std::string, VulkanShader> smap,
-                            std::unordered_map<std::string, FunctionInfo> fmap, std::string source)
-      : smap_(smap), fmap_(fmap), source_(source) {}
+                            std::unordered_map<std::string, FunctionInfo> fmap, std::string source);
   ~VulkanModuleNode();
 
   const char* type_key() const final { return "vulkan"; }
@@ -101,6 +108,14 @@ class VulkanModuleNode final : public runtime::ModuleNode {
   std::string GetSource(const std::string& format) final;
 
  private:
+  // Create the pipeline of a function, without caching it.
+  std::shared_ptr<VulkanPipeline> CreatePipeline(size_t device_id, const std::string& func_name,
+                                                 size_t num_pack_args);
+  // Destroy the handles of a pipeline.
+  static void DestroyPipeline(size_t device_id, const VulkanPipeline& pe);
+  // Create the pipelines of all the functions in background threads.
+  void StartPrecompile(size_t device_id);
+
   // function information table.
   std::unordered_map<std::string, VulkanShader> smap_;
   // function information table.
@@ -114,6 +129,8 @@ class VulkanModuleNode final : public runtime::ModuleNode {
   std::mutex mutex_;
   std::array<std::unordered_map<std::string, std::shared_ptr<VulkanPipeline>>, kVulkanMaxNumDevice>
       ecache_;
+  // The threads precompiling the pipelines, joined before the pipelines are destroyed.
+  std::vector<std::thread> precompile_threads_;
 };
 
 }  // namespace vulkan
@@ -23,114 +23,187 @@
  */
 #include "workspace_pool.h"
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "memory_accounting.h"
 
 namespace tvm {
 namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// Number of size classes holding exact multiples of the page size.
+constexpr size_t kNumPageClasses = 16;
+// Number of size classes per power of two above them.
+constexpr size_t kClassesPerPow2 = 4;
+
+namespace {
+/*! \brief The counters of a device, shared by the pools of all threads. */
+struct DeviceCounters {
+  std::atomic<size_t> live_bytes{0};
+  std::atomic<size_t> cached_bytes{0};
+  std::atomic<size_t> peak_live_bytes{0};
+  std::atomic<size_t> device_allocs{0};
+  std::atomic<size_t> remote_frees{0};
+
+  void AddLive(size_t nbytes) {
+    size_t live = live_bytes.fetch_add(nbytes, std::memory_order_relaxed) + nbytes;
+    size_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+  }
+};
+
+DeviceCounters* GetDeviceCounters(Device dev) {
+  static std::mutex mutex;
+  // NOTE: explicitly use new to avoid exit-time destruction, pools may outlive statics.
+  static auto* counters = new std::map<std::pair<int, int>, std::unique_ptr<DeviceCounters>>();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& entry = (*counters)[{static_cast<int>(dev.device_type), dev.device_id}];
+  if (entry == nullptr) entry.reset(new DeviceCounters());
+  return entry.get();
+}
+
+/*! \brief Workspaces freed by another thread than the pool which allocated them. */
+struct RemoteFrees {
+  std::mutex mutex;
+  std::vector<std::pair<Device, void*>> ptrs;
+  /*! \brief Incremented on every push, so that pools only look at new entries. */
+  std::atomic<uint64_t> version{0};
+
+  static RemoteFrees* Global() {
+    static auto* inst = new RemoteFrees();
+    return inst;
+  }
+};
+
+/*! \brief The size class of a request, and its rounded size. */
+size_t SizeClass(size_t nbytes, size_t* rounded) {
+  size_t pages = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize;
+  if (pages == 0) pages = 1;
+  if (pages <= kNumPageClasses) {
+    *rounded = pages * kWorkspacePageSize;
+    return pages - 1;
+  }
+  // pages lies in (2^k, 2^(k+1)], split into kClassesPerPow2 classes.
+  size_t k = 0;
+  while ((static_cast<size_t>(2) << k) < pages) ++k;
+  size_t step = (static_cast<size_t>(1) << k) / kClassesPerPow2;
+  size_t sub = (pages - (static_cast<size_t>(1) << k) + step - 1) / step - 1;
+  *rounded = ((static_cast<size_t>(1) << k) + (sub + 1) * step) * kWorkspacePageSize;
+  // 2^k > kNumPageClasses = 2^4 here.
+  return kNumPageClasses + (k - 4) * kClassesPerPow2 + sub;
+}
+}  // namespace
 
 class WorkspacePool::Pool {
  public:
-  // constructor
-  Pool() {
-    // safe guard header on each list.
-    Entry e;
-    e.data = nullptr;
-    e.size = 0;
-    free_list_.push_back(e);
-    allocated_.push_back(e);
-  }
+  explicit Pool(Device dev) : dev_(dev), counters_(GetDeviceCounters(dev)) {}
   // allocate from pool
-  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
-    // Allocate align to page.
-    nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
-    if (nbytes == 0) nbytes = kWorkspacePageSize;
-    Entry e;
-    DLDataType type;
-    type.code = kDLUInt;
-    type.bits = 8;
-    type.lanes = 1;
-    if (free_list_.size() == 2) {
-      e = free_list_.back();
-      free_list_.pop_back();
-      if (e.size < nbytes) {
-        // resize the page
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
-    } else if (free_list_.size() == 1) {
-      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-      e.size = nbytes;
+  void* Alloc(DeviceAPI* device, size_t nbytes) {
+    ClaimRemoteFrees();
+    size_t size;
+    size_t cls = SizeClass(nbytes, &size);
+    if (cls >= free_lists_.size()) free_lists_.resize(cls + 1);
+    void* data;
+    if (!free_lists_[cls].empty()) {
+      data = free_lists_[cls].back();
+      free_lists_[cls].pop_back();
+      counters_->cached_bytes.fetch_sub(size, std::memory_order_relaxed);
     } else {
-      if (free_list_.back().size >= nbytes) {
-        // find smallest fit
-        auto it = free_list_.end() - 2;
-        for (; it->size >= nbytes; --it) {
-        }
-        e = *(it + 1);
-        free_list_.erase(it + 1);
-      } else {
-        // resize the page
-        e = free_list_.back();
-        free_list_.pop_back();
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
-      }
+      DLDataType type;
+      type.code = kDLUInt;
+      type.bits = 8;
+      type.lanes = 1;
+      data = device->AllocDataSpace(dev_, size, kTempAllocaAlignment, type);
+      RecordDeviceAlloc(dev_, data, size, MemoryCategory::kWorkspace);
+      counters_->device_allocs.fetch_add(1, std::memory_order_relaxed);
     }
-    allocated_.push_back(e);
-    return e.data;
+    allocated_[data] = cls;
+    counters_->AddLive(size);
+    return data;
   }
   // free resource back to pool
   void Free(void* data) {
-    Entry e;
-    if (allocated_.back().data == data) {
-      // quick path, last allocated.
-      e = allocated_.back();
-      allocated_.pop_back();
-    } else {
-      int index = static_cast<int>(allocated_.size()) - 2;
-      for (; index > 0 && allocated_[index].data != data; --index) {
-      }
-      ICHECK_GT(index, 0) << "trying to free things that has not been allocated";
-      e = allocated_[index];
-      allocated_.erase(allocated_.begin() + index);
-    }
-    if (free_list_.back().size < e.size) {
-      free_list_.push_back(e);
-    } else if (free_list_.size() == 2) {
-      free_list_.push_back(free_list_.back());
-      free_list_[1] = e;
-    } else {
-      size_t i = free_list_.size() - 1;
-      free_list_.resize(free_list_.size() + 1);
-      for (; e.size < free_list_[i].size; --i) {
-        free_list_[i + 1] = free_list_[i];
-      }
-      free_list_[i + 1] = e;
+    if (!FreeLocal(data)) {
+      // Not allocated by this pool: hand it back to the owner.
+      RemoteFrees* remote = RemoteFrees::Global();
+      std::lock_guard<std::mutex> lock(remote->mutex);
+      remote->ptrs.emplace_back(dev_, data);
+      remote->version.fetch_add(1, std::memory_order_release);
+      counters_->remote_frees.fetch_add(1, std::memory_order_relaxed);
+      return;
     }
+    ClaimRemoteFrees();
   }
   // Release all resources
-  void Release(Device dev, DeviceAPI* device) {
-    for (size_t i = 1; i < free_list_.size(); ++i) {
-      device->FreeDataSpace(dev, free_list_[i].data);
+  void Release(DeviceAPI* device) {
+    ClaimRemoteFrees();
+    for (size_t cls = 0; cls < free_lists_.size(); ++cls) {
+      size_t size = ClassSize(cls);
+      for (void* data : free_lists_[cls]) {
+        RecordDeviceFree(data);
+        device->FreeDataSpace(dev_, data);
+        counters_->cached_bytes.fetch_sub(size, std::memory_order_relaxed);
+      }
     }
-    free_list_.clear();
+    free_lists_.clear();
   }
 
  private:
-  /*! \brief a single entry in the pool */
-  struct Entry {
-    void* data;
-    size_t size;
-  };
-  /*! \brief List of free items, sorted from small to big size */
-  std::vector<Entry> free_list_;
-  /*! \brief List of allocated items */
-  std::vector<Entry> allocated_;
+  static size_t ClassSize(size_t cls) {
+    if (cls < kNumPageClasses) return (cls + 1) * kWorkspacePageSize;
+    size_t k = (cls - kNumPageClasses) / kClassesPerPow2 + 4;
+    size_t sub = (cls - kNumPageClasses) % kClassesPerPow2;
+    size_t step = (static_cast<size_t>(1) << k) / kClassesPerPow2;
+    return ((static_cast<size_t>(1) << k) + (sub + 1) * step) * kWorkspacePageSize;
+  }
+
+  bool FreeLocal(void* data) {
+    auto it = allocated_.find(data);
+    if (it == allocated_.end()) return false;
+    size_t cls = it->second;
+    allocated_.erase(it);
+    free_lists_[cls].push_back(data);
+    size_t size = ClassSize(cls);
+    counters_->live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    counters_->cached_bytes.fetch_add(size, std::memory_order_relaxed);
+    return true;
+  }
+
+  /*! \brief Take back the workspaces of this pool freed by other threads. */
+  void ClaimRemoteFrees() {
+    RemoteFrees* remote = RemoteFrees::Global();
+    uint64_t version = remote->version.load(std::memory_order_acquire);
+    if (version == seen_version_) return;
+    std::lock_guard<std::mutex> lock(remote->mutex);
+    auto& ptrs = remote->ptrs;
+    for (size_t i = 0; i < ptrs.size();) {
+      if (ptrs[i].first.device_type == dev_.device_type &&
+          ptrs[i].first.device_id == dev_.device_id && FreeLocal(ptrs[i].second)) {
+        ptrs[i] = ptrs.back();
+        ptrs.pop_back();
+      } else {
+        ++i;
+      }
+    }
+    seen_version_ = remote->version.load(std::memory_order_relaxed);
+  }
+
+  Device dev_;
+  DeviceCounters* counters_;
+  /*! \brief The free blocks of each size class. */
+  std::vector<std::vector<void*>> free_lists_;
+  /*! \brief The size class of each allocated block. */
+  std::unordered_map<void*, size_t> allocated_;
+  /*! \brief The version of the remote frees last looked at. */
+  uint64_t seen_version_{0};
 };
 
 WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
@@ -139,10 +212,7 @@ WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
 WorkspacePool::~WorkspacePool() {
   for (size_t i = 0; i < array_.size(); ++i) {
     if (array_[i] != nullptr) {
-      Device dev;
-      dev.device_type = device_type_;
-      dev.device_id = static_cast<int>(i);
-      array_[i]->Release(dev, device_);
+      array_[i]->Release(device_);
       delete array_[i];
     }
   }
@@ -153,15 +223,37 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
     array_.resize(dev.device_id + 1, nullptr);
   }
   if (array_[dev.device_id] == nullptr) {
-    array_[dev.device_id] = new Pool();
+    array_[dev.device_id] = new Pool(dev);
   }
-  return array_[dev.device_id]->Alloc(dev, device_, size);
+  return array_[dev.device_id]->Alloc(device_, size);
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
-  ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
+  if (static_cast<size_t>(dev.device_id) >= array_.size()) {
+    array_.resize(dev.device_id + 1, nullptr);
+  }
+  if (array_[dev.device_id] == nullptr) {
+    array_[dev.device_id] = new Pool(dev);
+  }
   array_[dev.device_id]->Free(ptr);
 }
 
+WorkspacePoolStats GetWorkspacePoolStats(Device dev) {
+  DeviceCounters* counters = GetDeviceCounters(dev);
+  WorkspacePoolStats stats;
+  stats.live_bytes = counters->live_bytes.load(std::memory_order_relaxed);
+  stats.cached_bytes = counters->cached_bytes.load(std::memory_order_relaxed);
+  stats.peak_live_bytes = counters->peak_live_bytes.load(std::memory_order_relaxed);
+  stats.device_allocs = counters->device_allocs.load(std::memory_order_relaxed);
+  stats.remote_frees = counters->remote_frees.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void ResetWorkspacePoolPeak(Device dev) {
+  DeviceCounters* counters = GetDeviceCounters(dev);
+  counters->peak_live_bytes.store(counters->live_bytes.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
+}
+
 }  // namespace runtime
 }  // namespace tvm
@@ -31,6 +31,33 @@
 
 namespace tvm {
 namespace runtime {
+
+/*! \brief Byte counters of the workspace pools of one device, summed over the threads. */
+struct WorkspacePoolStats {
+  /*! \brief Bytes of the workspaces currently handed out. */
+  size_t live_bytes{0};
+  /*! \brief Bytes of the free blocks cached by the pools. */
+  size_t cached_bytes{0};
+  /*! \brief Peak of live_bytes since the last ResetWorkspacePoolPeak. */
+  size_t peak_live_bytes{0};
+  /*! \brief Number of blocks requested from the device. */
+  size_t device_allocs{0};
+  /*! \brief Number of workspaces freed by another thread than the allocating one. */
+  size_t remote_frees{0};
+};
+
+/*!
+ * \brief Get the counters of the workspace pools of a device.
+ * \param dev The device.
+ */
+TVM_DLL WorkspacePoolStats GetWorkspacePoolStats(Device dev);
+
+/*!
+ * \brief Restart tracking the peak of the live workspace bytes of a device from its current value.
+ * \param dev The device.
+ */
+TVM_DLL void ResetWorkspacePoolPeak(Device dev);
+
 /*!
  * \brief A workspace pool to manage
  *
@@ -41,6 +68,11 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  A pool is meant to be used by a single thread. Requests are rounded up to
+ *  size classes and free blocks are kept in one list per class, so that
+ *  allocating and freeing take constant time. Freeing a workspace from another
+ *  pool hands it back to its owner, which takes it at its next call.
  */
 class TVM_DLL WorkspacePool {
  public:
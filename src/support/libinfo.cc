@@ -155,6 +155,10 @@
 #define TVM_INFO_USE_CUBLAS "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_CUPTI
+#define TVM_INFO_USE_CUPTI "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_THRUST
 #define TVM_INFO_USE_THRUST "NOT-FOUND"
 #endif
@@ -179,6 +183,10 @@
 #define TVM_INFO_USE_RANDOM "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_ZSTD
+#define TVM_INFO_USE_ZSTD "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_MICRO_STANDALONE_RUNTIME
 #define TVM_INFO_USE_MICRO_STANDALONE_RUNTIME "NOT-FOUND"
 #endif
@@ -261,12 +269,14 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_DNNL_CODEGEN", TVM_INFO_USE_DNNL_CODEGEN},
       {"USE_CUDNN", TVM_INFO_USE_CUDNN},
       {"USE_CUBLAS", TVM_INFO_USE_CUBLAS},
+      {"USE_CUPTI", TVM_INFO_USE_CUPTI},
       {"USE_THRUST", TVM_INFO_USE_THRUST},
       {"USE_MIOPEN", TVM_INFO_USE_MIOPEN},
       {"USE_ROCBLAS", TVM_INFO_USE_ROCBLAS},
       {"USE_SORT", TVM_INFO_USE_SORT},
       {"USE_NNPACK", TVM_INFO_USE_NNPACK},
       {"USE_RANDOM", TVM_INFO_USE_RANDOM},
+      {"USE_ZSTD", TVM_INFO_USE_ZSTD},
       {"USE_MICRO_STANDALONE_RUNTIME", TVM_INFO_USE_MICRO_STANDALONE_RUNTIME},
       {"USE_CPP_RPC", TVM_INFO_USE_CPP_RPC},
       {"USE_TFLITE", TVM_INFO_USE_TFLITE},
@@ -22,6 +22,7 @@
  * \brief An implementation to run loop in parallel.
  */
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
 #include <tvm/support/parallel_for.h>
 
 #include <future>
@@ -47,16 +48,26 @@ std::vector<std::vector<int>> rr_partitioner(int begin, int end, int step, int n
   return ret;
 }
 
+/*!
+ * \brief Whether the current thread runs a parallel_for or one of its tasks. Independent
+ *  threads may run parallel_for loops concurrently, only the nested loops are rejected.
+ */
+static thread_local bool in_parallel_for = false;
+
 void parallel_for(int begin, int end, const std::function<void(int)>& f, int step,
                   const PartitionerFuncType partitioner) {
-  static bool GLOBAL_PARALLEL_FOR_FLAG{false};
-  static std::mutex M_GLOBAL_PARALLEL_FOR_FLAG;
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(!GLOBAL_PARALLEL_FOR_FLAG) << "There's another parallel_for running. Maybe you're "
-                                      << "currently inside another parallel_for loop.";
-    GLOBAL_PARALLEL_FOR_FLAG = true;
+  ICHECK(!in_parallel_for) << "There's another parallel_for running. Maybe you're "
+                           << "currently inside another parallel_for loop.";
+  if (runtime::ObjectArenaIsThreadConfined()) {
+    // The objects of the thread-confined scope must not be referenced from the other threads.
+    for (const auto& run_partition : partitioner(begin, end, step, 1)) {
+      for (int i : run_partition) {
+        f(i);
+      }
+    }
+    return;
   }
+  in_parallel_for = true;
 
   int default_num_threads = std::thread::hardware_concurrency();
   const auto& run_partitions = partitioner(begin, end, step, default_num_threads);
@@ -68,6 +79,7 @@ void parallel_for(int begin, int end, const std::function<void(int)>& f, int ste
   for (const auto& run_partition : run_partitions) {
     std::packaged_task<void(const std::vector<int>&, const std::function<void(int)>&)> task(
         [](const std::vector<int>& run_pattition, const std::function<void(int)>& f) {
+          in_parallel_for = true;
           for (const auto& i : run_pattition) {
             f(i);
           }
@@ -79,11 +91,7 @@ void parallel_for(int begin, int end, const std::function<void(int)>& f, int ste
   for (auto&& thread : threads) {
     thread.join();
   }
-  {
-    std::unique_lock<std::mutex> l(M_GLOBAL_PARALLEL_FOR_FLAG);
-    ICHECK(GLOBAL_PARALLEL_FOR_FLAG);
-    GLOBAL_PARALLEL_FOR_FLAG = false;
-  }
+  in_parallel_for = false;
   try {
     for (auto&& i : res_vec) {
       i.get();
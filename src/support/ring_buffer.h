@@ -121,6 +121,7 @@ class RingBuffer {
       bytes_available_ -= nsend2;
       nsend += nsend2;
     }
+    head_ptr_ = (head_ptr_ + nsend) % ring_.size();
     return nsend;
   }
   /*!
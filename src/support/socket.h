@@ -47,14 +47,17 @@ using ssize_t = int;
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <climits>
 #include <cstring>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../support/utils.h"
@@ -537,6 +540,54 @@ class TCPSocket : public Socket {
     }
     return ndone;
   }
+  /*!
+   * \brief peform a block gather write that will attempt to send all the buffers out
+   *    can still return smaller than request when error occurs
+   * \param bufs the pointer and size of the buffers
+   * \return size of data actually sent
+   */
+  size_t SendAllV(const std::vector<std::pair<const void*, size_t>>& bufs) {
+#if defined(_WIN32)
+    size_t ndone = 0;
+    for (const auto& buf : bufs) {
+      size_t n = SendAll(buf.first, buf.second);
+      ndone += n;
+      if (n != buf.second) break;
+    }
+    return ndone;
+#else
+    std::vector<iovec> iov;
+    for (const auto& buf : bufs) {
+      if (buf.second == 0) continue;
+      iovec v;
+      v.iov_base = const_cast<void*>(buf.first);
+      v.iov_len = buf.second;
+      iov.push_back(v);
+    }
+    size_t ndone = 0;
+    size_t next = 0;
+    while (next < iov.size()) {
+      int count = static_cast<int>(std::min(iov.size() - next, static_cast<size_t>(IOV_MAX)));
+      ssize_t ret = RetryCallOnEINTR([&]() { return writev(sockfd, &iov[next], count); });
+      if (ret == -1) {
+        if (LastErrorWouldBlock()) return ndone;
+        Socket::Error("SendAllV");
+      }
+      ndone += ret;
+      // skip the buffers that are completely sent, and advance in the partial one.
+      size_t nsent = static_cast<size_t>(ret);
+      while (next < iov.size() && nsent >= iov[next].iov_len) {
+        nsent -= iov[next].iov_len;
+        ++next;
+      }
+      if (next < iov.size()) {
+        iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + nsent;
+        iov[next].iov_len -= nsent;
+      }
+    }
+    return ndone;
+#endif
+  }
   /*!
    * \brief peform block read that will attempt to read all data
    *    can still return smaller than request when error occurs
@@ -37,6 +37,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include "../runtime/library_module.h"
+
 namespace tvm {
 namespace codegen {
 
@@ -57,7 +59,15 @@ runtime::Module Build(IRModule mod, Target target) {
 /*! \brief Helper class to serialize module */
 class ModuleSerializer {
  public:
-  explicit ModuleSerializer(runtime::Module mod) : mod_(mod) { Init(); }
+  /*!
+   * \brief Constructor
+   * \param mod The module to serialize with its imports.
+   * \param compression_level The zstd compression level of the binaries, 0 not to compress them.
+   */
+  explicit ModuleSerializer(runtime::Module mod, int compression_level = 0)
+      : mod_(mod), compression_level_(compression_level) {
+    Init();
+  }
 
   void SerializeModule(dmlc::Stream* stream) {
     // Only have one DSO module and it is in the root, then
@@ -76,29 +86,55 @@ class ModuleSerializer {
       sz = mod_->imports().size();
     }
     stream->Write(sz);
+    // The offset of each entry from the start of the stream, written after the entries so that
+    // the loader can deserialize the modules in parallel.
+    uint64_t offset = sizeof(sz);
+    std::vector<uint64_t> entry_offsets;
+    auto write_key = [&](const std::string& key) {
+      entry_offsets.push_back(offset);
+      stream->Write(key);
+      offset += sizeof(uint64_t) + key.size();
+    };
 
     for (const auto& group : mod_group_vec_) {
       ICHECK_NE(group.size(), 0) << "Every allocated group must have at least one module";
       if (!DSOExportable(group[0])) {
         ICHECK_EQ(group.size(), 1U) << "Non DSO module is never merged";
-        std::string mod_type_key = group[0]->type_key();
-        stream->Write(mod_type_key);
-        group[0]->SaveToBinary(stream);
+        std::string blob;
+        dmlc::MemoryStringStream blob_stream(&blob);
+        group[0]->SaveToBinary(&blob_stream);
+        if (compression_level_ > 0) {
+          // The compressed entries are decompressed as they are read by the loader.
+          write_key(runtime::kZstdModuleKey);
+          std::string mod_type_key = group[0]->type_key();
+          stream->Write(mod_type_key);
+          blob = runtime::CompressModuleBinary(blob, compression_level_);
+          stream->Write(static_cast<uint64_t>(blob.size()));
+          offset += sizeof(uint64_t) * 2 + mod_type_key.size();
+        } else {
+          write_key(group[0]->type_key());
+        }
+        stream->Write(blob.data(), blob.size());
+        offset += blob.size();
       } else {
         // DSOExportable: do not need binary
         if (has_import_tree) {
-          std::string mod_type_key = "_lib";
-          stream->Write(mod_type_key);
+          write_key("_lib");
         }
       }
     }
 
     // Write _import_tree key if we have
     if (has_import_tree) {
-      std::string import_key = "_import_tree";
-      stream->Write(import_key);
+      write_key("_import_tree");
       stream->Write(import_tree_row_ptr_);
       stream->Write(import_tree_child_indices_);
+      offset += sizeof(uint64_t) * (2 + import_tree_row_ptr_.size() +
+                                    import_tree_child_indices_.size());
+      // The index is ignored by the loaders reading the entries one after another.
+      stream->Write(entry_offsets);
+      stream->Write(offset);
+      stream->Write(runtime::kModuleBlobIndexMagic);
     }
   }
 
@@ -219,6 +255,8 @@ class ModuleSerializer {
   }
 
   runtime::Module mod_;
+  // the zstd compression level of the binaries, 0 not to compress them
+  int compression_level_;
   // construct module to index
   std::unordered_map<runtime::ModuleNode*, size_t> mod2index_;
   // index -> module group
@@ -228,20 +266,20 @@ class ModuleSerializer {
 };
 
 namespace {
-std::string SerializeModule(const runtime::Module& mod) {
+std::string SerializeModule(const runtime::Module& mod, int compression_level) {
   std::string bin;
   dmlc::MemoryStringStream ms(&bin);
   dmlc::Stream* stream = &ms;
 
-  ModuleSerializer module_serializer(mod);
+  ModuleSerializer module_serializer(mod, compression_level);
   module_serializer.SerializeModule(stream);
 
   return bin;
 }
 }  // namespace
 
-std::string PackImportsToC(const runtime::Module& mod, bool system_lib) {
-  std::string bin = SerializeModule(mod);
+std::string PackImportsToC(const runtime::Module& mod, bool system_lib, int compression_level) {
+  std::string bin = SerializeModule(mod, compression_level);
 
   // translate to C program
   std::ostringstream os;
@@ -290,8 +328,8 @@ std::string PackImportsToC(const runtime::Module& mod, bool system_lib) {
 }
 
 runtime::Module PackImportsToLLVM(const runtime::Module& mod, bool system_lib,
-                                  const std::string& target_triple) {
-  std::string bin = SerializeModule(mod);
+                                  const std::string& target_triple, int compression_level) {
+  std::string bin = SerializeModule(mod, compression_level);
 
   uint64_t nbytes = bin.length();
   std::string header;
@@ -24,18 +24,24 @@
 
 #include "codegen_cpu.h"
 
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/tir/analysis.h>
 
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "../func_registry_generator.h"
 
 namespace tvm {
 namespace codegen {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm_pgo_instrument", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm_pgo_profile", String);
+
 void CodeGenCPU::Init(const std::string& module_name, llvm::TargetMachine* tm,
                       llvm::LLVMContext* ctx, bool system_lib, bool dynamic_lookup,
                       bool target_c_runtime) {
@@ -246,6 +252,83 @@ std::unique_ptr<llvm::Module> CodeGenCPU::Finish() {
   }
   return CodeGenLLVM::Finish();
 }
+
+void CodeGenCPU::Optimize() {
+  tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+  bool pgo_instrument = pass_ctx->GetConfig<Bool>("tir.llvm_pgo_instrument", Bool(false)).value();
+  String pgo_profile = pass_ctx->GetConfig<String>("tir.llvm_pgo_profile", String("")).value();
+  if (pgo_instrument || !pgo_profile.empty()) {
+#if TVM_LLVM_VERSION >= 90
+    ICHECK(!(pgo_instrument && !pgo_profile.empty()))
+        << "tir.llvm_pgo_instrument and tir.llvm_pgo_profile cannot be used together";
+    // The instrumentation and the profile use run on the same unoptimized module, so that
+    // the CFG hashes of the functions match between the two builds.
+    llvm::legacy::PassManager pgo_pass;
+    if (pgo_instrument) {
+      pgo_pass.add(llvm::createPGOInstrumentationGenLegacyPass());
+    } else {
+      pgo_pass.add(llvm::createPGOInstrumentationUseLegacyPass(pgo_profile));
+    }
+    pgo_pass.run(*module_);
+    if (pgo_instrument) {
+      this->LowerPGOCounters();
+    }
+#else
+    LOG(FATAL) << "Profile guided optimization requires LLVM 9 or later";
+#endif
+  }
+  CodeGenLLVM::Optimize();
+}
+
+void CodeGenCPU::LowerPGOCounters() {
+#if TVM_LLVM_VERSION >= 90
+  llvm::NamedMDNode* md = module_->getOrInsertNamedMetadata("tvm.pgo.counters");
+  std::unordered_map<llvm::GlobalVariable*, llvm::GlobalVariable*> counters;
+  std::vector<llvm::Instruction*> intrinsics;
+  for (llvm::Function& f : *module_) {
+    for (llvm::BasicBlock& bb : f) {
+      for (llvm::Instruction& inst : bb) {
+        if (llvm::isa<llvm::InstrProfValueProfileInst>(&inst)) {
+          // Value profiles (e.g. of memcpy sizes) are not collected.
+          intrinsics.push_back(&inst);
+          continue;
+        }
+        auto* inc = llvm::dyn_cast<llvm::InstrProfIncrementInst>(&inst);
+        if (inc == nullptr) continue;
+        intrinsics.push_back(inc);
+
+        llvm::GlobalVariable*& array = counters[inc->getName()];
+        llvm::ArrayType* array_type =
+            llvm::ArrayType::get(t_int64_, inc->getNumCounters()->getZExtValue());
+        if (array == nullptr) {
+          std::string array_name = "__tvm_pgo_counters_" + std::to_string(md->getNumOperands());
+          array = new llvm::GlobalVariable(*module_, array_type, false,
+                                           llvm::GlobalValue::ExternalLinkage,
+                                           llvm::ConstantAggregateZero::get(array_type),
+                                           array_name);
+          llvm::StringRef func_name = llvm::getPGOFuncNameVarInitializer(inc->getName());
+          md->addOperand(llvm::MDNode::get(*ctx_, {llvm::MDString::get(*ctx_, func_name),
+                                                   llvm::ConstantAsMetadata::get(inc->getHash()),
+                                                   llvm::MDString::get(*ctx_, array_name)}));
+        }
+        llvm::Constant* indices[] = {llvm::ConstantInt::get(t_int32_, 0), inc->getIndex()};
+        llvm::Constant* addr =
+            llvm::ConstantExpr::getInBoundsGetElementPtr(array_type, array, indices);
+        llvm::Value* step = llvm::ConstantInt::get(t_int64_, 1);
+        if (auto* inc_step = llvm::dyn_cast<llvm::InstrProfIncrementInstStep>(inc)) {
+          step = inc_step->getStep();
+        }
+        // Like the default lowering of LLVM, the counters are not updated atomically.
+        llvm::IRBuilder<> builder(inc);
+        builder.CreateStore(builder.CreateAdd(builder.CreateLoad(t_int64_, addr), step), addr);
+      }
+    }
+  }
+  for (llvm::Instruction* inst : intrinsics) {
+    inst->eraseFromParent();
+  }
+#endif
+}
 llvm::Value* CodeGenCPU::CreateStructRefPtr(DataType t, llvm::Value* buf, llvm::Value* index,
                                             int kind) {
   if (kind < builtin::kArrKindBound_) {
@@ -731,6 +814,45 @@ llvm::Value* CodeGenCPU::CreateCallPacked(const CallNode* op) {
   return rvalue;
 }
 
+llvm::Value* CodeGenCPU::CreateCallCPacked(const CallNode* op) {
+  // The callee is linked with the caller, e.g. an operator called by the AOT
+  // executor, so there is no handle to look up.
+  ICHECK_EQ(op->args.size(), 5U);
+  std::string func_name = op->args[0].as<StringImmNode>()->value;
+  int64_t begin = op->args[3].as<IntImmNode>()->value;
+  int64_t end = op->args[4].as<IntImmNode>()->value;
+  llvm::Function* callee = module_->getFunction(func_name);
+  if (callee == nullptr) {
+    llvm::Type* t_int_p = t_int_->getPointerTo(GetGlobalAddressSpace());
+    llvm::FunctionType* ftype = llvm::FunctionType::get(
+        t_int_, {t_void_p_, t_int_p, t_int_, t_void_p_, t_int_p, t_void_p_}, false);
+    callee = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage, func_name,
+                                    module_.get());
+  }
+  llvm::Value* stack_value = MakeValue(op->args[1]);
+  llvm::Value* stack_tcode = MakeValue(op->args[2]);
+  llvm::Value* arg_value = builder_->CreateInBoundsGEP(
+      builder_->CreatePointerCast(stack_value, t_tvm_value_->getPointerTo()), ConstInt32(begin));
+  llvm::Value* arg_tcode = CreateBufferPtr(DataType::Int(32), stack_tcode, ConstInt32(begin));
+  llvm::Value* ret_value = builder_->CreateInBoundsGEP(
+      builder_->CreatePointerCast(stack_value, t_tvm_value_->getPointerTo()), ConstInt32(end));
+  llvm::Value* ret_tcode = CreateBufferPtr(DataType::Int(32), stack_tcode, ConstInt32(end));
+  std::vector<llvm::Value*> call_args = {arg_value, arg_tcode, ConstInt32(end - begin),
+                                         ret_value, ret_tcode,
+                                         llvm::ConstantPointerNull::get(t_void_p_)};
+  llvm::FunctionType* ftype = callee->getFunctionType();
+  ICHECK_EQ(ftype->getNumParams(), call_args.size())
+      << func_name << " does not have the signature of a packed function";
+  for (size_t i = 0; i < call_args.size(); ++i) {
+    if (call_args[i]->getType() != ftype->getParamType(i)) {
+      call_args[i] = builder_->CreatePointerCast(call_args[i], ftype->getParamType(i));
+    }
+  }
+  llvm::Value* retcode = builder_->CreateCall(callee, call_args);
+  CheckCallSuccess(retcode);
+  return retcode;
+}
+
 llvm::Value* CodeGenCPU::CreateCallTracePacked(const CallNode* op) {
   using llvm::BasicBlock;
   ICHECK_EQ(op->args.size(), 6U);
@@ -855,6 +977,8 @@ void CodeGenCPU::AddStartupFunction() {
 llvm::Value* CodeGenCPU::CreateIntrinsic(const CallNode* op) {
   if (op->op.same_as(builtin::tvm_call_packed_lowered())) {
     return CreateCallPacked(op);
+  } else if (op->op.same_as(builtin::tvm_call_cpacked_lowered())) {
+    return CreateCallCPacked(op);
   } else if (op->op.same_as(builtin::tvm_call_trace_packed_lowered())) {
     return CreateCallTracePacked(op);
   } else if (op->op.same_as(builtin::tvm_static_handle())) {
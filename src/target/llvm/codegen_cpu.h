@@ -43,6 +43,12 @@ class CodeGenCPU : public CodeGenLLVM {
   void AddFunction(const PrimFunc& f) override;
   void AddMainFunction(const std::string& entry_func_name) override;
   std::unique_ptr<llvm::Module> Finish() override;
+  /*!
+   * \brief Run the optimization pipeline, instrumenting the module for profile collection or
+   *  attaching a collected profile when profile guided optimization is enabled in the
+   *  PassContext ("tir.llvm_pgo_instrument" and "tir.llvm_pgo_profile").
+   */
+  void Optimize() override;
   void VisitStmt_(const AssertStmtNode* op) override;
   void VisitStmt_(const AttrStmtNode* op) override;
   void VisitStmt_(const ForNode* op) override;
@@ -58,6 +64,13 @@ class CodeGenCPU : public CodeGenLLVM {
 
  protected:
   void AddStartupFunction() final;
+  /*!
+   * \brief Replace the profile counter increments inserted by the PGO instrumentation with
+   *  updates of one external counter array per function, which are read back from the JIT
+   *  module by LLVMModuleNode without the compiler-rt profile runtime. The function name, CFG
+   *  hash and counter array of each function are recorded in the "tvm.pgo.counters" metadata.
+   */
+  void LowerPGOCounters();
   // meta data
   llvm::MDNode* md_tbaa_ctx_ptr_{nullptr};
   // TVM related data types
@@ -115,6 +128,8 @@ class CodeGenCPU : public CodeGenLLVM {
                                    const int64_t begin, const int64_t end);
   // create call into tvm packed function.
   llvm::Value* CreateCallPacked(const CallNode* op);
+  // create direct call to a packed function of the module, by its symbol.
+  llvm::Value* CreateCallCPacked(const CallNode* op);
   // Create trace call into tvm packed function.
   llvm::Value* CreateCallTracePacked(const CallNode* op);
   // Create static initialization
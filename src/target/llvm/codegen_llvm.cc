@@ -91,6 +91,9 @@ void CodeGenLLVM::InitTarget(llvm::TargetMachine* tm) {
       native_vector_bits_ = 256;
     } else if (arch == llvm::Triple::arm || arch == llvm::Triple::aarch64) {
       native_vector_bits_ = 128;
+    } else if (arch == llvm::Triple::wasm32 || arch == llvm::Triple::wasm64) {
+      // for simd128
+      native_vector_bits_ = 128;
     } else {
       native_vector_bits_ = 128;
       std::string arch_name = std::string(tm->getTargetTriple().getArchName());
@@ -132,11 +135,20 @@ void CodeGenLLVM::AddFunctionInternal(const PrimFunc& f, bool ret_void) {
   auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
   ICHECK(global_symbol.defined())
       << "CodeGenLLVM: Expect PrimFunc to have the global_symbol attribute";
-  ICHECK(module_->getFunction(static_cast<std::string>(global_symbol.value())) == nullptr)
+  // A function called by its symbol before its definition is only declared, e.g. an
+  // operator of the AOT executor.
+  llvm::Function* declared = module_->getFunction(static_cast<std::string>(global_symbol.value()));
+  ICHECK(declared == nullptr || declared->isDeclaration())
       << "Function " << global_symbol << " already exist in module";
 
-  function_ = llvm::Function::Create(ftype, llvm::Function::ExternalLinkage,
-                                     global_symbol.value().operator std::string(), module_.get());
+  function_ = llvm::Function::Create(
+      ftype, llvm::Function::ExternalLinkage,
+      declared == nullptr ? global_symbol.value().operator std::string() : "", module_.get());
+  if (declared != nullptr) {
+    function_->takeName(declared);
+    declared->replaceAllUsesWith(llvm::ConstantExpr::getBitCast(function_, declared->getType()));
+    declared->eraseFromParent();
+  }
   function_->setCallingConv(llvm::CallingConv::C);
   function_->setDLLStorageClass(llvm::GlobalValue::DLLStorageClassTypes::DLLExportStorageClass);
 
@@ -317,6 +329,112 @@ llvm::Value* CodeGenLLVM::CreateStorageSync(const CallNode* op) {
   return nullptr;
 }
 
+void CodeGenLLVM::InitPassManagerBuilder(llvm::PassManagerBuilder* builder) {}
+
+#if TVM_LLVM_VERSION >= 130
+#if TVM_LLVM_VERSION >= 140
+using llvm::OptimizationLevel;
+#else
+using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
+/*!
+ * \brief Attach the vectorization, interleave and unroll hints of the pipeline options to the
+ *  innermost loops, as llvm.loop metadata that the loop passes honor.
+ */
+class LoopHintPass : public llvm::PassInfoMixin<LoopHintPass> {
+ public:
+  explicit LoopHintPass(const LLVMPipelineOptions& options) : options_(options) {}
+
+  llvm::PreservedAnalyses run(llvm::Function& f, llvm::FunctionAnalysisManager& fam) {
+    llvm::LLVMContext& ctx = f.getContext();
+    auto hint = [&ctx](const char* name, int value) -> llvm::Metadata* {
+      return llvm::MDNode::get(
+          ctx, {llvm::MDString::get(ctx, name),
+                llvm::ConstantAsMetadata::get(
+                    llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), value))});
+    };
+    llvm::LoopInfo& loop_info = fam.getResult<llvm::LoopAnalysis>(f);
+    for (llvm::Loop* loop : loop_info.getLoopsInPreorder()) {
+      if (!loop->getSubLoops().empty()) continue;
+      // The first operand of a loop id refers to itself.
+      llvm::SmallVector<llvm::Metadata*, 4> operands{nullptr};
+      if (llvm::MDNode* loop_id = loop->getLoopID()) {
+        for (unsigned i = 1; i < loop_id->getNumOperands(); ++i) {
+          operands.push_back(loop_id->getOperand(i));
+        }
+      }
+      if (options_.vectorize_width > 0) {
+        operands.push_back(hint("llvm.loop.vectorize.enable", 1));
+        operands.push_back(hint("llvm.loop.vectorize.width", options_.vectorize_width));
+      }
+      if (options_.interleave_count > 0) {
+        operands.push_back(hint("llvm.loop.interleave.count", options_.interleave_count));
+      }
+      if (options_.unroll_count > 0) {
+        operands.push_back(hint("llvm.loop.unroll.count", options_.unroll_count));
+      }
+      llvm::MDNode* loop_id = llvm::MDNode::getDistinct(ctx, operands);
+      loop_id->replaceOperandWith(0, loop_id);
+      loop->setLoopID(loop_id);
+    }
+    return llvm::PreservedAnalyses::all();
+  }
+
+ private:
+  LLVMPipelineOptions options_;
+};
+
+void CodeGenLLVM::Optimize() {
+  const LLVMPipelineOptions& options = pipeline_options_;
+  llvm::PipelineTuningOptions tuning_options;
+  tuning_options.LoopVectorization = options.loop_vectorize;
+  tuning_options.SLPVectorization = options.slp_vectorize;
+  tuning_options.LoopUnrolling = options.loop_unroll;
+  tuning_options.LoopInterleaving = options.loop_interleave;
+
+  llvm::PassBuilder builder(target_machine_, tuning_options);
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+  builder.registerModuleAnalyses(mam);
+  builder.registerCGSCCAnalyses(cgam);
+  builder.registerFunctionAnalyses(fam);
+  builder.registerLoopAnalyses(lam);
+  builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+  if (options.vectorize_width > 0 || options.interleave_count > 0 || options.unroll_count > 0) {
+    builder.registerPipelineStartEPCallback(
+        [&options](llvm::ModulePassManager& mpm, OptimizationLevel level) {
+          mpm.addPass(llvm::createModuleToFunctionPassAdaptor(LoopHintPass(options)));
+        });
+  }
+  if (options.loop_interchange) {
+    builder.registerLoopOptimizerEndEPCallback(
+        [](llvm::LoopPassManager& lpm, OptimizationLevel level) {
+          lpm.addPass(llvm::LoopInterchangePass());
+        });
+  }
+
+  llvm::ModulePassManager mpm;
+  switch (options.opt_level) {
+    case 0:
+      mpm = builder.buildO0DefaultPipeline(OptimizationLevel::O0);
+      break;
+    case 1:
+      mpm = builder.buildPerModuleDefaultPipeline(OptimizationLevel::O1);
+      break;
+    case 2:
+      mpm = builder.buildPerModuleDefaultPipeline(OptimizationLevel::O2);
+      break;
+    default:
+      mpm = builder.buildPerModuleDefaultPipeline(OptimizationLevel::O3);
+      break;
+  }
+  mpm.run(*module_, mam);
+}
+#else
 class FPassManager : public llvm::legacy::FunctionPassManager {
  public:
   explicit FPassManager(llvm::Module* m) : llvm::legacy::FunctionPassManager(m) {}
@@ -330,9 +448,12 @@ class MPassManager : public llvm::legacy::PassManager {
   void add(llvm::Pass* p) final { llvm::legacy::PassManager::add(p); }
 };
 
-void CodeGenLLVM::InitPassManagerBuilder(llvm::PassManagerBuilder* builder) {}
-
 void CodeGenLLVM::Optimize() {
+  const LLVMPipelineOptions& options = pipeline_options_;
+  if (options.loop_interchange || options.vectorize_width > 0 || options.interleave_count > 0 ||
+      options.unroll_count > 0) {
+    LOG(WARNING) << "The loop-interchange and loop hint target options require LLVM 13 or later";
+  }
   // pass manager
   FPassManager fpass(module_.get());
   MPassManager mpass;
@@ -343,15 +464,16 @@ void CodeGenLLVM::Optimize() {
 
   // place optimization pass
   llvm::PassManagerBuilder builder;
-  builder.OptLevel = 3;
+  builder.OptLevel = options.opt_level;
 
 #if TVM_LLVM_VERSION >= 50
   builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, 0, false);
 #else
   builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, 0);
 #endif
-  builder.LoopVectorize = true;
-  builder.SLPVectorize = true;
+  builder.LoopVectorize = options.loop_vectorize;
+  builder.SLPVectorize = options.slp_vectorize;
+  builder.DisableUnrollLoops = !options.loop_unroll;
   this->InitPassManagerBuilder(&builder);
 
 #if TVM_LLVM_VERSION >= 50
@@ -368,6 +490,7 @@ void CodeGenLLVM::Optimize() {
   fpass.doFinalization();
   mpass.run(*module_);
 }
+#endif
 
 int CodeGenLLVM::NativeVectorBits(const runtime::StorageScope& storage_scope) const {
   return native_vector_bits_;
@@ -643,7 +766,7 @@ llvm::Value* CodeGenLLVM::CreateVecConcat(std::vector<llvm::Value*> vecs) {
 }
 
 void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
-                                  const Var& loop_var, const Stmt& body) {
+                                  const Var& loop_var, const Stmt& body, llvm::MDNode* loop_md) {
   using llvm::BasicBlock;
   BasicBlock* pre_block = builder_->GetInsertBlock();
   BasicBlock* for_begin = BasicBlock::Create(*ctx_, "for_begin", function_);
@@ -662,10 +785,29 @@ void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Va
   var_map_.erase(loop_var.get());
   llvm::Value* loop_next = CreateAdd(loop_var.dtype(), loop_value, stride);
   loop_value->addIncoming(loop_next, builder_->GetInsertBlock());
-  builder_->CreateBr(for_begin);
+  llvm::BranchInst* latch = builder_->CreateBr(for_begin);
+  if (loop_md != nullptr) {
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loop_md);
+  }
   builder_->SetInsertPoint(for_end);
 }
 
+llvm::MDNode* CodeGenLLVM::CreateScalableVectorizeLoopMD() {
+  auto hint = [this](const char* name) -> llvm::Metadata* {
+    return llvm::MDNode::get(*ctx_, {llvm::MDString::get(*ctx_, name),
+                                     llvm::ConstantAsMetadata::get(builder_->getTrue())});
+  };
+  // The vectorizer of LLVM picks vscale based vectors on targets with scalable vectors (SVE,
+  // RVV) when the width is scalable, and folds the tail into the vector body with predication
+  // instead of emitting a scalar epilogue.
+  llvm::MDNode* loop_md = llvm::MDNode::getDistinct(
+      *ctx_, {nullptr, hint("llvm.loop.vectorize.enable"),
+              hint("llvm.loop.vectorize.scalable.enable"),
+              hint("llvm.loop.vectorize.predicate.enable")});
+  loop_md->replaceOperandWith(0, loop_md);
+  return loop_md;
+}
+
 // cast operatpr
 llvm::Value* CodeGenLLVM::CreateCast(DataType from, DataType to, llvm::Value* value) {
   llvm::Type* target = DTypeToLLVMType(to);
@@ -1125,6 +1267,9 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LetNode* op) {
 }
 
 llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
+  if (!is_one(op->predicate)) {
+    return CreatePredicatedLoad(op);
+  }
   DataType t = op->dtype;
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -1179,6 +1324,123 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const LoadNode* op) {
   return ret;
 }
 
+llvm::Value* CodeGenLLVM::CreatePredicatedLoad(const LoadNode* op) {
+  DataType t = op->dtype;
+  ICHECK_EQ(op->predicate.dtype().lanes(), t.lanes()) << op->predicate;
+  bool is_volatile = volatile_buf_.count(op->buffer_var.get());
+  llvm::Value* buffer = MakeValue(op->buffer_var);
+  llvm::Value* mask = MakeValue(op->predicate);
+  llvm::Value* zero = llvm::Constant::getNullValue(DTypeToLLVMType(t));
+
+  const RampNode* ramp = op->index.as<RampNode>();
+  if (t.lanes() > 1 && ramp && is_one(ramp->stride) && !is_volatile) {
+    // A contiguous masked load, e.g. vmaskmov on AVX2 or a mask register load on AVX-512.
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
+    int alignment, native_bits;
+    GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+    ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+#if TVM_LLVM_VERSION >= 130
+    llvm::CallInst* load = builder_->CreateMaskedLoad(DTypeToLLVMType(t), ptr,
+                                                      llvm::Align(alignment), mask, zero);
+#elif TVM_LLVM_VERSION >= 110
+    llvm::CallInst* load = builder_->CreateMaskedLoad(ptr, llvm::Align(alignment), mask, zero);
+#else
+    llvm::CallInst* load = builder_->CreateMaskedLoad(ptr, alignment, mask, zero);
+#endif
+    AddAliasInfo(load, op->buffer_var.get(), op->index);
+    return load;
+  }
+
+  // Load the active lanes one by one, behind a branch on their predicate.
+  llvm::Value* index = MakeValue(op->index);
+  int basic_align = t.bits() / 8;
+  llvm::Value* ret = zero;
+  auto f = [&](int i, llvm::Value* lane_index) {
+    llvm::Value* lane_mask = t.lanes() > 1 ? builder_->CreateExtractElement(mask, i) : mask;
+    llvm::BasicBlock* pre_block = builder_->GetInsertBlock();
+    llvm::BasicBlock* load_block = llvm::BasicBlock::Create(*ctx_, "pred_load", function_);
+    llvm::BasicBlock* end_block = llvm::BasicBlock::Create(*ctx_, "pred_load_end", function_);
+    builder_->CreateCondBr(lane_mask, load_block, end_block);
+    builder_->SetInsertPoint(load_block);
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, lane_index);
+#if TVM_LLVM_VERSION >= 110
+    llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, llvm::Align(basic_align), is_volatile);
+#else
+    llvm::LoadInst* load = builder_->CreateAlignedLoad(ptr, basic_align, is_volatile);
+#endif
+    AddAliasInfo(load, op->buffer_var.get(), PrimExpr());
+    llvm::Value* loaded = t.lanes() > 1 ? builder_->CreateInsertElement(ret, load, ConstInt32(i))
+                                        : static_cast<llvm::Value*>(load);
+    builder_->CreateBr(end_block);
+    builder_->SetInsertPoint(end_block);
+    llvm::PHINode* phi = builder_->CreatePHI(ret->getType(), 2);
+    phi->addIncoming(ret, pre_block);
+    phi->addIncoming(loaded, load_block);
+    ret = phi;
+  };
+  if (t.lanes() > 1) {
+    this->Scalarize(op->index, f);
+  } else {
+    f(0, index);
+  }
+  return ret;
+}
+
+void CodeGenLLVM::CreatePredicatedStore(const StoreNode* op) {
+  DataType t = op->value.dtype();
+  ICHECK_EQ(op->predicate.dtype().lanes(), t.lanes()) << op->predicate;
+  bool is_volatile = volatile_buf_.count(op->buffer_var.get());
+  llvm::Value* buffer = MakeValue(op->buffer_var);
+  llvm::Value* value = MakeValue(op->value);
+  llvm::Value* mask = MakeValue(op->predicate);
+
+  const RampNode* ramp = op->index.as<RampNode>();
+  if (t.lanes() > 1 && ramp && is_one(ramp->stride) && !is_volatile) {
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
+    int alignment, native_bits;
+    GetAlignment(t, op->buffer_var.get(), ramp->base, &alignment, &native_bits);
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(ramp->base));
+    ptr = builder_->CreatePointerCast(ptr, DTypeToLLVMType(t)->getPointerTo(addrspace));
+#if TVM_LLVM_VERSION >= 110
+    llvm::CallInst* store =
+        builder_->CreateMaskedStore(value, ptr, llvm::Align(alignment), mask);
+#else
+    llvm::CallInst* store = builder_->CreateMaskedStore(value, ptr, alignment, mask);
+#endif
+    AddAliasInfo(store, op->buffer_var.get(), op->index);
+    return;
+  }
+
+  // Store the active lanes one by one, behind a branch on their predicate.
+  ICHECK_GE(t.bits(), 8);
+  llvm::Value* index = MakeValue(op->index);
+  int basic_align = t.bits() / 8;
+  auto f = [&](int i, llvm::Value* lane_index) {
+    llvm::Value* lane_mask = t.lanes() > 1 ? builder_->CreateExtractElement(mask, i) : mask;
+    llvm::BasicBlock* store_block = llvm::BasicBlock::Create(*ctx_, "pred_store", function_);
+    llvm::BasicBlock* end_block = llvm::BasicBlock::Create(*ctx_, "pred_store_end", function_);
+    builder_->CreateCondBr(lane_mask, store_block, end_block);
+    builder_->SetInsertPoint(store_block);
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, lane_index);
+    llvm::Value* lane_value = t.lanes() > 1 ? builder_->CreateExtractElement(value, i) : value;
+#if TVM_LLVM_VERSION >= 110
+    llvm::StoreInst* store =
+        builder_->CreateAlignedStore(lane_value, ptr, llvm::Align(basic_align), is_volatile);
+#else
+    llvm::StoreInst* store = builder_->CreateAlignedStore(lane_value, ptr, basic_align, is_volatile);
+#endif
+    AddAliasInfo(store, op->buffer_var.get(), PrimExpr());
+    builder_->CreateBr(end_block);
+    builder_->SetInsertPoint(end_block);
+  };
+  if (t.lanes() > 1) {
+    this->Scalarize(op->index, f);
+  } else {
+    f(0, index);
+  }
+}
+
 llvm::Value* CodeGenLLVM::VisitExpr_(const CallNode* op) {
   if (auto* ptr_op = op->op.as<OpNode>()) {
     auto call_op = GetRef<Op>(ptr_op);
@@ -1240,7 +1502,10 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const BroadcastNode* op) {
 }
 
 void CodeGenLLVM::VisitStmt_(const StoreNode* op) {
-  ICHECK(is_one(op->predicate)) << op->predicate;
+  if (!is_one(op->predicate)) {
+    CreatePredicatedStore(op);
+    return;
+  }
   DataType t = op->value.dtype();
   bool is_volatile = volatile_buf_.count(op->buffer_var.get());
   llvm::Value* buffer = MakeValue(op->buffer_var);
@@ -1306,8 +1571,13 @@ void CodeGenLLVM::VisitStmt_(const ForNode* op) {
   } else {
     ICHECK(op->kind == ForKind::kSerial);
   }
+  llvm::MDNode* loop_md = nullptr;
+  if (op->annotations.count(tir::attr::scalable_vectorize)) {
+    loop_md = CreateScalableVectorizeLoopMD();
+  }
   CreateSerialFor(MakeValue(op->min), MakeValue(op->extent),
-                  llvm::ConstantInt::getSigned(GetLLVMType(op->extent), 1), op->loop_var, op->body);
+                  llvm::ConstantInt::getSigned(GetLLVMType(op->extent), 1), op->loop_var, op->body,
+                  loop_md);
 }
 
 void CodeGenLLVM::VisitStmt_(const WhileNode* op) {
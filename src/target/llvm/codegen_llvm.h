@@ -97,6 +97,11 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    * \param mod The module to be linked.
    */
   void AddLinkModule(std::unique_ptr<llvm::Module>&& mod);
+  /*!
+   * \brief Set the options of the optimization pipeline run by Finish.
+   * \param options The pipeline options.
+   */
+  void SetPipelineOptions(const LLVMPipelineOptions& options) { pipeline_options_ = options; }
   /*!
    * \brief Link parameters into the module so they don't need to be supplied at runtime.
    * Parameters can be linked into the module so that the generated code is easier to use, or so
@@ -289,9 +294,14 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   llvm::Value* CreateVecFlip(llvm::Value* vec);
   llvm::Value* CreateVecConcat(std::vector<llvm::Value*> vecs);
   llvm::Value* CreateVecPad(llvm::Value* vec, int target_lanes);
-  // Create serial for
+  // Create a load or store masked by its vector predicate.
+  llvm::Value* CreatePredicatedLoad(const LoadNode* op);
+  void CreatePredicatedStore(const StoreNode* op);
+  // Create serial for, with the optional llvm.loop metadata of its latch.
   void CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
-                       const Var& loop_var, const Stmt& body);
+                       const Var& loop_var, const Stmt& body, llvm::MDNode* loop_md = nullptr);
+  // Create the llvm.loop metadata asking for a scalable, tail predicated vectorization.
+  llvm::MDNode* CreateScalableVectorizeLoopMD();
   // add alias information.
   void AddAliasInfo(llvm::Instruction* load, const VarNode* buffer, PrimExpr index);
   // The IRBuilder.
@@ -307,6 +317,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unique_ptr<llvm::MDBuilder> md_builder_;
   // llvm target machine
   llvm::TargetMachine* target_machine_{nullptr};
+  // The options of the optimization pipeline
+  LLVMPipelineOptions pipeline_options_;
   // llvm context
   llvm::LLVMContext* ctx_{nullptr};
   // helpful data types
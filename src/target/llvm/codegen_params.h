@@ -34,13 +34,14 @@ namespace codegen {
 /*!
  * \brief Convert an NDArray to an LLVM array of constants.
  *
- * The supplied NDArray is flattened, and each element is converted to the appropriate LLVM type.
+ * The supplied NDArray is flattened and its data is copied at once into a constant data array of
+ * the appropriate LLVM element type, emitted as raw bytes in the object file.
  *
  * \param ctx LLVM context used to create the various primitive datatypes.
  * \param arr NDArray to convert.
- * \return LLVM array containing the array data.
+ * \return LLVM constant containing the array data, a ConstantAggregateZero if it is all zeros.
  */
-llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::NDArray arr);
+llvm::Constant* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::NDArray arr);
 
 }  // namespace codegen
 }  // namespace tvm
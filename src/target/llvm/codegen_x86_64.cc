@@ -25,6 +25,9 @@
 
 #include <tvm/runtime/registry.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "codegen_cpu.h"
 #include "llvm/MC/MCSubtargetInfo.h"
 
@@ -66,10 +69,15 @@ bool TargetHasFeature(const llvm::TargetMachine& tm, const std::string& feature)
 class CodeGenX86_64 final : public CodeGenCPU {
  public:
   llvm::Value* VisitExpr_(const CastNode* op) override;
+  llvm::Value* CreateIntrinsic(const CallNode* op) override;
 
  private:
   llvm::Value* CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes, llvm::Type* result_ty,
                                 const std::vector<llvm::Value*>& args);
+  // Load the AMX tile configuration at the entry of the current function.
+  llvm::Value* CreateAMXTileConfig(const CallNode* op);
+  // The AMX tile configuration loaded by each function.
+  std::unordered_map<llvm::Function*, std::vector<int64_t>> amx_tile_config_;
 };
 
 llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
@@ -113,6 +121,68 @@ llvm::Value* CodeGenX86_64::VisitExpr_(const CastNode* op) {
   return CodeGenCPU::VisitExpr_(op);
 }
 
+llvm::Value* CodeGenX86_64::CreateIntrinsic(const CallNode* op) {
+  if (op->op.same_as(builtin::amx_tile_config())) {
+    return CreateAMXTileConfig(op);
+  }
+  return CodeGenCPU::CreateIntrinsic(op);
+}
+
+llvm::Value* CodeGenX86_64::CreateAMXTileConfig(const CallNode* op) {
+#if TVM_LLVM_VERSION >= 120
+  // The 64 bytes configuration: the palette, then the bytes per row of the 16 tiles as 16 bit
+  // integers from byte 16, then their number of rows from byte 48.
+  const int kMaxTiles = 8;
+  ICHECK_EQ(op->args.size() % 2, 0U) << "amx_tile_config expects pairs of rows and bytes per row";
+  ICHECK_LE(op->args.size() / 2, kMaxTiles) << "AMX has " << kMaxTiles << " tile registers";
+  std::vector<int64_t> config;
+  for (const PrimExpr& arg : op->args) {
+    const int64_t* value = as_const_int(arg);
+    ICHECK(value) << "amx_tile_config expects constant arguments, but got " << arg;
+    config.push_back(*value);
+  }
+  auto it = amx_tile_config_.find(function_);
+  if (it != amx_tile_config_.end()) {
+    ICHECK(it->second == config) << "All the AMX tile configurations of a function must match";
+    return llvm::UndefValue::get(t_int32_);
+  }
+  amx_tile_config_[function_] = config;
+
+  std::vector<uint8_t> bytes(64, 0);
+  bytes[0] = 1;
+  for (size_t i = 0; i < config.size() / 2; ++i) {
+    int64_t rows = config[2 * i], colsb = config[2 * i + 1];
+    ICHECK(rows > 0 && rows <= 16) << "An AMX tile has at most 16 rows, but got " << rows;
+    ICHECK(colsb > 0 && colsb <= 64) << "An AMX tile has at most 64 bytes per row, but got "
+                                     << colsb;
+    bytes[16 + 2 * i] = static_cast<uint8_t>(colsb);
+    bytes[48 + i] = static_cast<uint8_t>(rows);
+  }
+  llvm::Constant* init = llvm::ConstantDataArray::get(*ctx_, bytes);
+  llvm::GlobalVariable* global =
+      new llvm::GlobalVariable(*module_, init->getType(), true, llvm::GlobalValue::PrivateLinkage,
+                               init, "__tvm_amx_tile_config");
+#if TVM_LLVM_VERSION >= 100
+  global->setAlignment(llvm::Align(64));
+#else
+  global->setAlignment(64);
+#endif
+
+  // Tile configurations are per thread, the entry of a parallel lambda runs in its worker.
+  llvm::BasicBlock* current = builder_->GetInsertBlock();
+  llvm::BasicBlock* entry = &(function_->getEntryBlock());
+  builder_->SetInsertPoint(entry, entry->getFirstInsertionPt());
+  llvm::Function* f =
+      llvm::Intrinsic::getDeclaration(module_.get(), llvm::Intrinsic::x86_ldtilecfg);
+  builder_->CreateCall(f, {builder_->CreatePointerCast(global, t_void_p_)});
+  builder_->SetInsertPoint(current);
+  return llvm::UndefValue::get(t_int32_);
+#else
+  LOG(FATAL) << "AMX tile configuration requires LLVM 12 or later";
+  return nullptr;
+#endif
+}
+
 llvm::Value* CodeGenX86_64::CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes,
                                              llvm::Type* result_ty,
                                              const std::vector<llvm::Value*>& args) {
@@ -141,6 +141,28 @@ std::unique_ptr<llvm::TargetMachine> GetLLVMTargetMachine(const Target& target,
   return std::unique_ptr<llvm::TargetMachine>(tm);
 }
 
+LLVMPipelineOptions ParseLLVMPipelineOptions(const Target& target) {
+  LLVMPipelineOptions options;
+  auto get_int = [&target](const char* key, int default_value) {
+    return static_cast<int>(target->GetAttr<Integer>(key).value_or(Integer(default_value))->value);
+  };
+  auto get_bool = [&target](const char* key, bool default_value) {
+    return static_cast<bool>(target->GetAttr<Bool>(key).value_or(Bool(default_value)));
+  };
+  options.opt_level = get_int("opt-level", options.opt_level);
+  ICHECK(options.opt_level >= 0 && options.opt_level <= 3)
+      << "opt-level must be in [0, 3], but got " << options.opt_level;
+  options.loop_vectorize = get_bool("loop-vectorize", options.loop_vectorize);
+  options.slp_vectorize = get_bool("slp-vectorize", options.slp_vectorize);
+  options.loop_unroll = get_bool("loop-unroll", options.loop_unroll);
+  options.loop_interleave = get_bool("loop-interleave", options.loop_interleave);
+  options.loop_interchange = get_bool("loop-interchange", options.loop_interchange);
+  options.vectorize_width = get_int("vectorize-width", options.vectorize_width);
+  options.interleave_count = get_int("interleave-count", options.interleave_count);
+  options.unroll_count = get_int("unroll-count", options.unroll_count);
+  return options;
+}
+
 std::string LLVMTargetToString(const Target& target) {
   std::ostringstream os;
   os << "llvm";
@@ -51,14 +51,23 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
+#if TVM_LLVM_VERSION >= 130
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Transforms/Scalar/LoopInterchange.h>
+#endif
+#include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/InstrProfWriter.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Instrumentation.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
 
@@ -116,6 +125,35 @@ void ParseLLVMTargetOptions(const Target& target, std::string* triple, std::stri
 std::unique_ptr<llvm::TargetMachine> GetLLVMTargetMachine(const Target& target,
                                                           bool allow_null = false);
 
+/*! \brief The options of the LLVM optimization pipeline, set by attributes of the target. */
+struct LLVMPipelineOptions {
+  /*! \brief The optimization level, from 0 to 3 ("opt-level"). */
+  int opt_level = 3;
+  /*! \brief Whether to run the loop vectorizer ("loop-vectorize"). */
+  bool loop_vectorize = true;
+  /*! \brief Whether to run the SLP vectorizer ("slp-vectorize"). */
+  bool slp_vectorize = true;
+  /*! \brief Whether to unroll loops ("loop-unroll"). */
+  bool loop_unroll = true;
+  /*! \brief Whether the loop vectorizer interleaves loops ("loop-interleave"). */
+  bool loop_interleave = true;
+  /*! \brief Whether to run the loop interchange pass ("loop-interchange"). */
+  bool loop_interchange = false;
+  /*! \brief The vectorization width hinted on innermost loops, 0 if unset ("vectorize-width"). */
+  int vectorize_width = 0;
+  /*! \brief The interleave count hinted on innermost loops, 0 if unset ("interleave-count"). */
+  int interleave_count = 0;
+  /*! \brief The unroll count hinted on innermost loops, 0 if unset ("unroll-count"). */
+  int unroll_count = 0;
+};
+
+/*!
+ * \brief Parse the options of the optimization pipeline from the target attributes.
+ * \param target The TVM target
+ * \return The pipeline options
+ */
+LLVMPipelineOptions ParseLLVMPipelineOptions(const Target& target);
+
 /*!
  * \brief Convert the TVM's LLVM target to string by extracting only relevant fields
  * \param target The TVM target to be extracted
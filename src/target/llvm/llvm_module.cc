@@ -24,11 +24,29 @@
 #ifdef TVM_LLVM_VERSION
 
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+#include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <functional>
 #include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#if TVM_LLVM_VERSION >= 130
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#endif
 
 #include "../../runtime/file_utils.h"
 #include "../../runtime/library_module.h"
@@ -45,9 +63,257 @@ using runtime::PackedFunc;
 using runtime::TVMArgs;
 using runtime::TVMRetValue;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm_num_compile_units", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.llvm_min_compile_unit_size", Integer);
+
+/*!
+ * \brief Emit the object code of a module.
+ * \param tm The target machine.
+ * \param module The module, the passes of the code generation run on it.
+ * \param dest The stream of the object code.
+ */
+static void EmitObjectFile(llvm::TargetMachine* tm, llvm::Module* module,
+                           llvm::raw_pwrite_stream* dest) {
+  llvm::legacy::PassManager pass;
+  ICHECK(tm);
+#if TVM_LLVM_VERSION <= 60
+  ICHECK(tm->addPassesToEmitFile(pass, *dest, llvm::TargetMachine::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#elif TVM_LLVM_VERSION <= 90
+  ICHECK(tm->addPassesToEmitFile(pass, *dest, nullptr, llvm::TargetMachine::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#else
+  ICHECK(tm->addPassesToEmitFile(pass, *dest, nullptr, llvm::CGFT_ObjectFile) == 0)
+      << "Cannot emit target CGFT_ObjectFile";
+#endif
+  pass.run(*module);
+}
+
+/*!
+ * \brief Partition the functions of a module into compilation units of balanced sizes.
+ *
+ *  The size of a function is the number of nodes of its body. The functions smaller than
+ *  min_size are kept in the unit of the functions calling them, or else together with the other
+ *  small functions, so that they can still be inlined. The entry function is in the first unit.
+ *
+ * \param funcs The functions.
+ * \param num_units The number of units, at most.
+ * \param min_size The size of the functions kept together, 0 to only balance the sizes.
+ * \param entry_func The name of the entry function, empty if there is none.
+ * \return The indices of the functions of each unit, in their order in funcs.
+ */
+static std::vector<std::vector<int>> PartitionCompileUnits(const std::vector<tir::PrimFunc>& funcs,
+                                                           int num_units, int64_t min_size,
+                                                           const std::string& entry_func) {
+  int num_funcs = static_cast<int>(funcs.size());
+  std::unordered_map<std::string, int> func_index;
+  for (int i = 0; i < num_funcs; ++i) {
+    func_index[funcs[i]->GetAttr<String>(tvm::attr::kGlobalSymbol).value()] = i;
+  }
+  std::vector<int64_t> sizes(num_funcs, 0);
+  std::vector<std::vector<int>> callees(num_funcs);
+  for (int i = 0; i < num_funcs; ++i) {
+    tir::PostOrderVisit(funcs[i]->body, [&](const ObjectRef& node) {
+      ++sizes[i];
+      const auto* call = node.as<tir::CallNode>();
+      if (call == nullptr) return;
+      std::string callee;
+      if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+        callee = gvar->name_hint;
+      } else if ((call->op.same_as(tir::builtin::call_extern()) ||
+                  call->op.same_as(tir::builtin::call_pure_extern())) &&
+                 !call->args.empty() && call->args[0].as<tir::StringImmNode>()) {
+        callee = call->args[0].as<tir::StringImmNode>()->value;
+      }
+      auto it = func_index.find(callee);
+      if (it != func_index.end()) callees[i].push_back(it->second);
+    });
+  }
+
+  // Group the functions kept together.
+  std::vector<int> group(num_funcs);
+  std::iota(group.begin(), group.end(), 0);
+  std::function<int(int)> find = [&](int i) {
+    return group[i] == i ? i : group[i] = find(group[i]);
+  };
+  auto unite = [&](int a, int b) { group[find(a)] = find(b); };
+  std::vector<bool> called(num_funcs, false);
+  for (int i = 0; i < num_funcs; ++i) {
+    for (int callee : callees[i]) {
+      if (sizes[callee] < min_size) {
+        unite(i, callee);
+        called[callee] = true;
+      }
+    }
+  }
+  int small_group = -1;
+  for (int i = 0; i < num_funcs; ++i) {
+    if (sizes[i] >= min_size || called[i] || find(i) != i) continue;
+    if (small_group < 0) {
+      small_group = i;
+    } else {
+      unite(i, small_group);
+    }
+  }
+  std::unordered_map<int, int64_t> group_sizes;
+  for (int i = 0; i < num_funcs; ++i) group_sizes[find(i)] += sizes[i];
+
+  // Assign the largest groups first, each to the smallest unit.
+  std::vector<std::pair<int64_t, int>> groups;
+  for (const auto& kv : group_sizes) groups.emplace_back(kv.second, kv.first);
+  std::sort(groups.begin(), groups.end(), std::greater<std::pair<int64_t, int>>());
+  num_units = std::max(1, std::min(num_units, static_cast<int>(groups.size())));
+  std::vector<int64_t> unit_sizes(num_units, 0);
+  std::unordered_map<int, int> group_unit;
+  for (const auto& g : groups) {
+    int unit = static_cast<int>(std::min_element(unit_sizes.begin(), unit_sizes.end()) -
+                                unit_sizes.begin());
+    unit_sizes[unit] += g.first;
+    group_unit[g.second] = unit;
+  }
+  std::vector<std::vector<int>> units(num_units);
+  for (int i = 0; i < num_funcs; ++i) units[group_unit.at(find(i))].push_back(i);
+  auto entry = func_index.find(entry_func);
+  if (entry != func_index.end()) std::swap(units[0], units[group_unit.at(find(entry->second))]);
+  return units;
+}
+
+#if TVM_LLVM_VERSION >= 130
+/*!
+ * \brief An ORC JIT session, shared by the modules JITed for the same target so that the target
+ *  machine and the compile threads are only set up once.
+ *
+ * Each module is added to a JITDylib of its own, as the modules define the same symbols, and its
+ * functions are only compiled on their first call, by the compile threads of the session.
+ */
+class ORCJITSession {
+ public:
+  /*! \brief Get the session of a target, creating it on first use. */
+  static ORCJITSession* Get(const std::string& triple, const std::string& mcpu,
+                            const std::string& mattr, const llvm::TargetOptions& opt) {
+    static std::mutex mutex;
+    // The sessions live as long as the process, as the addresses they return may be kept.
+    static auto* sessions = new std::unordered_map<std::string, ORCJITSession*>();
+    std::string key = triple + "|" + mcpu + "|" + mattr + "|" +
+                      std::to_string(static_cast<int>(opt.FloatABIType));
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sessions->find(key);
+    if (it == sessions->end()) {
+      it = sessions->emplace(key, new ORCJITSession(triple, mcpu, mattr, opt)).first;
+    }
+    return it->second;
+  }
+
+  /*! \brief The data layout of the modules the session JITs. */
+  const llvm::DataLayout& GetDataLayout() const { return jit_->getDataLayout(); }
+
+  /*!
+   * \brief Add a module to a new JITDylib, compiling its functions lazily.
+   * \param module The module, in a context of its own.
+   * \param ctx The context of the module.
+   * \return The JITDylib.
+   */
+  llvm::orc::JITDylib* Add(std::unique_ptr<llvm::Module> module,
+                           std::unique_ptr<llvm::LLVMContext> ctx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto created = jit_->createJITDylib("tvm_module_" + std::to_string(num_dylibs_++));
+    ICHECK(created) << "ORC JIT error: " << llvm::toString(created.takeError());
+    llvm::orc::JITDylib& dylib = *created;
+    // The TVM runtime API the module calls is resolved in the process.
+    dylib.addGenerator(
+        CheckError(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            jit_->getDataLayout().getGlobalPrefix())));
+    CheckError(jit_->addLazyIRModule(
+        dylib, llvm::orc::ThreadSafeModule(std::move(module), std::move(ctx))));
+    CheckError(jit_->initialize(dylib));
+    return &dylib;
+  }
+
+  /*!
+   * \brief Release the code of a JITDylib, running the static destructors of its module.
+   *
+   * The JITDylib itself is kept, so that the address of a removed JITDylib is never reused for a
+   * new one: the lazy compile layer keeps the resources of the JITDylibs by address.
+   */
+  void Remove(llvm::orc::JITDylib* dylib) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (llvm::Error err = jit_->deinitialize(*dylib)) {
+      LOG(WARNING) << "Failed to deinitialize " << dylib->getName() << ": "
+                   << llvm::toString(std::move(err));
+    }
+    // The compiled functions live in the implementation JITDylib of the lazy compile layer.
+    std::string impl_name = dylib->getName() + ".impl";
+    for (llvm::orc::JITDylib* d :
+         {dylib, jit_->getExecutionSession().getJITDylibByName(impl_name)}) {
+      if (d == nullptr) continue;
+      if (llvm::Error err = d->clear()) {
+        LOG(WARNING) << "Failed to release " << d->getName() << ": "
+                     << llvm::toString(std::move(err));
+      }
+    }
+  }
+
+  /*!
+   * \brief Look up a symbol of a JITDylib, materializing the lazy stub of a function.
+   * \return The address of the symbol, 0 if it is not found.
+   */
+  uint64_t Lookup(llvm::orc::JITDylib* dylib, const std::string& name) {
+    auto sym = jit_->lookup(*dylib, name);
+    if (!sym) {
+      LOG(WARNING) << "Cannot find " << name << ": " << llvm::toString(sym.takeError());
+      return 0;
+    }
+#if TVM_LLVM_VERSION >= 150
+    return sym->getValue();
+#else
+    return sym->getAddress();
+#endif
+  }
+
+ private:
+  ORCJITSession(const std::string& triple, const std::string& mcpu, const std::string& mattr,
+                const llvm::TargetOptions& opt) {
+    llvm::orc::JITTargetMachineBuilder tm_builder{llvm::Triple(triple)};
+    tm_builder.setCPU(mcpu);
+    if (mattr.length() != 0) {
+      tm_builder.addFeatures(std::vector<std::string>{mattr});
+    }
+    tm_builder.setOptions(opt);
+    tm_builder.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+    unsigned num_threads = std::max(1U, std::thread::hardware_concurrency());
+    jit_ = CheckError(llvm::orc::LLLazyJITBuilder()
+                          .setJITTargetMachineBuilder(std::move(tm_builder))
+                          .setNumCompileThreads(num_threads)
+                          .create());
+  }
+
+  template <typename T>
+  static T CheckError(llvm::Expected<T> value) {
+    ICHECK(value) << "ORC JIT error: " << llvm::toString(value.takeError());
+    return std::move(*value);
+  }
+
+  static void CheckError(llvm::Error err) {
+    ICHECK(!err) << "ORC JIT error: " << llvm::toString(std::move(err));
+  }
+
+  // The lazy JIT.
+  std::unique_ptr<llvm::orc::LLLazyJIT> jit_;
+  // The lock of the JITDylibs added and removed.
+  std::mutex mutex_;
+  // The number of JITDylibs created, to name the next one.
+  int64_t num_dylibs_{0};
+};
+#endif
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode() {
+#if TVM_LLVM_VERSION >= 130
+    if (orc_dylib_ != nullptr) {
+      orc_session_->Remove(orc_dylib_);
+    }
+#endif
     module_.reset();
     if (ee_ != nullptr) {
       ee_->runStaticConstructorsDestructors(true);
@@ -76,8 +342,16 @@ class LLVMModuleNode final : public runtime::ModuleNode {
         target_triple += " -mfloat-abi=soft";
       }
       return PackedFunc([target_triple](TVMArgs args, TVMRetValue* rv) { *rv = target_triple; });
+    } else if (name == "write_pgo_profile") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->WritePGOProfile(args[0]);
+      });
+    } else if (name == "save_compile_units") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->SaveCompileUnits(args[0]);
+      });
     }
-    if (ee_ == nullptr) LazyInitJIT();
+    if (!JITInitialized()) LazyInitJIT();
 
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -106,20 +380,7 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 #else
       std::unique_ptr<llvm::Module> m = llvm::CloneModule(*mptr_);
 #endif
-      llvm::legacy::PassManager pass;
-      ICHECK(tm_);
-#if TVM_LLVM_VERSION <= 60
-      ICHECK(tm_->addPassesToEmitFile(pass, dest, llvm::TargetMachine::CGFT_ObjectFile) == 0)
-          << "Cannot emit target CGFT_ObjectFile";
-#elif TVM_LLVM_VERSION <= 90
-      ICHECK(tm_->addPassesToEmitFile(pass, dest, nullptr, llvm::TargetMachine::CGFT_ObjectFile) ==
-             0)
-          << "Cannot emit target CGFT_ObjectFile";
-#else
-      ICHECK(tm_->addPassesToEmitFile(pass, dest, nullptr, llvm::CGFT_ObjectFile) == 0)
-          << "Cannot emit target CGFT_ObjectFile";
-#endif
-      pass.run(*m);
+      EmitObjectFile(tm_.get(), m.get(), &dest);
     } else if (fmt == "s" || fmt == "asm") {
 #if TVM_LLVM_VERSION <= 60
       std::unique_ptr<llvm::Module> m = llvm::CloneModule(mptr_);
@@ -201,10 +462,7 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   void Init(const IRModule& mod, const Target& target) {
     InitializeLLVM();
     tm_ = GetLLVMTargetMachine(target);
-    bool system_lib = target->GetAttr<Bool>("system-lib").value_or(Bool(false));
-    bool target_c_runtime = (target->GetAttr<String>("runtime").value_or("") == kTvmRuntimeCrt);
     ctx_ = std::make_shared<llvm::LLVMContext>();
-    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm_.get());
 
     std::vector<PrimFunc> funcs;
     std::string entry_func;
@@ -240,9 +498,54 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     }
     // TODO(@jroesch): follow up on this condition.
     // ICHECK(funcs.size() > 0 || (could_have_linked_params && found_linked_params));
+    const Map<String, LinkedParam>* params = found_linked_params ? &linked_params : nullptr;
+    tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+    int num_units = static_cast<int>(
+        pass_ctx->GetConfig<Integer>("tir.llvm_num_compile_units", Integer(1)).value()->value);
+    int64_t min_size =
+        pass_ctx->GetConfig<Integer>("tir.llvm_min_compile_unit_size", Integer(0)).value()->value;
+    // The counters of the instrumented units would be named alike.
+    if (pass_ctx->GetConfig<Bool>("tir.llvm_pgo_instrument", Bool(false)).value()) num_units = 1;
+    std::vector<std::vector<int>> units;
+    if (num_units > 1 && funcs.size() > 1) {
+      units = PartitionCompileUnits(funcs, num_units, min_size, entry_func);
+    }
+    if (units.size() > 1) {
+      module_ = BuildCompileUnits(funcs, units, entry_func, params, target);
+    } else {
+      module_ = BuildCompileUnit(funcs, entry_func, params, target, tm_.get(), ctx_.get());
+    }
+
+    std::string verify_errors_storage;
+    llvm::raw_string_ostream verify_errors(verify_errors_storage);
+    LOG_IF(FATAL, llvm::verifyModule(*module_, &verify_errors))
+        << "LLVM module verification failed with the following errors: \n"
+        << verify_errors.str();
+    target_ = target;
+    mptr_ = module_.get();
+  }
+
+  /*!
+   * \brief Generate the LLVM module of functions, optimized.
+   * \param funcs The functions.
+   * \param entry_func The name of the entry function, empty if there is none.
+   * \param linked_params The linked parameters, nullptr if there are none.
+   * \param target The target.
+   * \param tm The target machine.
+   * \param ctx The context of the module.
+   * \return The module.
+   */
+  static std::unique_ptr<llvm::Module> BuildCompileUnit(
+      const std::vector<PrimFunc>& funcs, const std::string& entry_func,
+      const Map<String, LinkedParam>* linked_params, const Target& target, llvm::TargetMachine* tm,
+      llvm::LLVMContext* ctx) {
+    bool system_lib = target->GetAttr<Bool>("system-lib").value_or(Bool(false));
+    bool target_c_runtime = (target->GetAttr<String>("runtime").value_or("") == kTvmRuntimeCrt);
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(tm);
     // TODO(tqchen): remove the entry function behavior as it does not
     // makes sense when we start to use multiple modules.
-    cg->Init("TVMMod", tm_.get(), ctx_.get(), system_lib, system_lib, target_c_runtime);
+    cg->Init("TVMMod", tm, ctx, system_lib, system_lib, target_c_runtime);
+    cg->SetPipelineOptions(ParseLLVMPipelineOptions(target));
 
     for (const auto& f : funcs) {
       cg->AddFunction(f);
@@ -252,26 +555,105 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       cg->AddMainFunction(entry_func);
     }
 
-    if (found_linked_params) {
-      cg->LinkParameters(linked_params);
+    if (linked_params != nullptr) {
+      cg->LinkParameters(*linked_params);
+    }
+    std::unique_ptr<llvm::Module> module = cg->Finish();
+    module->addModuleFlag(llvm::Module::Warning, "tvm_target",
+                          llvm::MDString::get(*ctx, LLVMTargetToString(target)));
+    module->addModuleFlag(llvm::Module::Override, "Debug Info Version",
+                          llvm::DEBUG_METADATA_VERSION);
+
+    if (tm->getTargetTriple().isOSDarwin()) {
+      module->addModuleFlag(llvm::Module::Override, "Dwarf Version", 2);
     }
-    module_ = cg->Finish();
-    module_->addModuleFlag(llvm::Module::Warning, "tvm_target",
-                           llvm::MDString::get(*ctx_, LLVMTargetToString(target)));
-    module_->addModuleFlag(llvm::Module::Override, "Debug Info Version",
-                           llvm::DEBUG_METADATA_VERSION);
+    return module;
+  }
+
+  /*!
+   * \brief Generate and optimize the compilation units of the functions in parallel, then link
+   *  them in one module of ctx_. The optimized units are kept for SaveCompileUnits.
+   * \param funcs The functions.
+   * \param units The indices of the functions of each unit, the entry function in the first.
+   * \param entry_func The name of the entry function, empty if there is none.
+   * \param linked_params The linked parameters, nullptr if there are none.
+   * \param target The target.
+   * \return The linked module.
+   */
+  std::unique_ptr<llvm::Module> BuildCompileUnits(const std::vector<PrimFunc>& funcs,
+                                                  const std::vector<std::vector<int>>& units,
+                                                  const std::string& entry_func,
+                                                  const Map<String, LinkedParam>* linked_params,
+                                                  const Target& target) {
+    // The contexts and the target machines are not thread safe, each unit has its own.
+    std::vector<std::unique_ptr<llvm::TargetMachine>> tms;
+    for (size_t i = 0; i < units.size(); ++i) tms.push_back(GetLLVMTargetMachine(target));
+    unit_bitcode_.assign(units.size(), std::string());
+    // The pass context is thread local, the workers enter the one of the caller.
+    tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+    support::parallel_for(0, static_cast<int>(units.size()), [&](int i) {
+      With<tvm::transform::PassContext> pass_ctx_scope(pass_ctx);
+      std::vector<PrimFunc> unit_funcs;
+      for (int index : units[i]) unit_funcs.push_back(funcs[index]);
+      llvm::LLVMContext ctx;
+      std::unique_ptr<llvm::Module> module =
+          BuildCompileUnit(unit_funcs, i == 0 ? entry_func : "", i == 0 ? linked_params : nullptr,
+                           target, tms[i].get(), &ctx);
+      llvm::raw_string_ostream os(unit_bitcode_[i]);
+#if TVM_LLVM_VERSION <= 60
+      llvm::WriteBitcodeToFile(module.get(), os);
+#else
+      llvm::WriteBitcodeToFile(*module, os);
+#endif
+      os.flush();
+    });
 
-    if (tm_->getTargetTriple().isOSDarwin()) {
-      module_->addModuleFlag(llvm::Module::Override, "Dwarf Version", 2);
+    std::unique_ptr<llvm::Module> linked;
+    for (const std::string& bitcode : unit_bitcode_) {
+      llvm::SMDiagnostic err;
+      std::unique_ptr<llvm::Module> module =
+          llvm::parseIR(llvm::MemoryBufferRef(bitcode, "TVMMod"), err, *ctx_);
+      ICHECK(module != nullptr) << "Fail to load a compilation unit: "
+                                << std::string(err.getMessage());
+      if (linked == nullptr) {
+        linked = std::move(module);
+      } else {
+        ICHECK(!llvm::Linker::linkModules(*linked, std::move(module)))
+            << "Failed to link the compilation units";
+      }
     }
+    return linked;
+  }
 
-    std::string verify_errors_storage;
-    llvm::raw_string_ostream verify_errors(verify_errors_storage);
-    LOG_IF(FATAL, llvm::verifyModule(*module_, &verify_errors))
-        << "LLVM module verification failed with the following errors: \n"
-        << verify_errors.str();
-    target_ = target;
-    mptr_ = module_.get();
+  /*!
+   * \brief Save the object code of each compilation unit, in parallel.
+   * \param file_name The name of the object file of the module, the units are saved next to it.
+   * \return The names of the object files, empty if the module was built as one unit.
+   */
+  Array<String> SaveCompileUnits(const std::string& file_name) {
+    Array<String> file_names;
+    if (unit_bitcode_.size() <= 1) return file_names;
+    std::string stem = file_name.substr(0, file_name.rfind('.'));
+    std::vector<std::unique_ptr<llvm::TargetMachine>> tms;
+    for (size_t i = 0; i < unit_bitcode_.size(); ++i) {
+      file_names.push_back(stem + "_unit" + std::to_string(i) + ".o");
+      tms.push_back(GetLLVMTargetMachine(target_));
+    }
+    support::parallel_for(0, static_cast<int>(unit_bitcode_.size()), [&](int i) {
+      llvm::LLVMContext ctx;
+      llvm::SMDiagnostic err;
+      std::unique_ptr<llvm::Module> module =
+          llvm::parseIR(llvm::MemoryBufferRef(unit_bitcode_[i], "TVMMod"), err, ctx);
+      ICHECK(module != nullptr) << "Fail to load a compilation unit: "
+                                << std::string(err.getMessage());
+      std::string unit_file = file_names[i];
+      std::error_code ecode;
+      llvm::raw_fd_ostream dest(unit_file, ecode, llvm::sys::fs::F_None);
+      ICHECK_EQ(ecode.value(), 0) << "Cannot open file: " << unit_file << " " << ecode.message();
+      EmitObjectFile(tms[i].get(), module.get(), &dest);
+      dest.close();
+    });
+    return file_names;
   }
 
   void Init(std::unique_ptr<llvm::Module> module, std::shared_ptr<llvm::LLVMContext> ctx) {
@@ -283,6 +665,44 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       std::string msg = std::string(err.getMessage());
       LOG(FATAL) << "Fail to load module: " << msg;
     }
+    mptr_ = module_.get();
+    tm_ = GetLLVMTargetMachine(Target(GetTargetMetadata()));
+  }
+
+  void LoadIR(const std::string& file_name) {
+    auto ctx = std::make_shared<llvm::LLVMContext>();
+    llvm::SMDiagnostic err;
+    auto module = llvm::parseIRFile(file_name, err, *ctx);
+    if (module == nullptr) {
+      std::string msg = std::string(err.getMessage());
+      LOG(FATAL) << "Fail to load ir file " << file_name << "\n"
+                 << "line " << err.getLineNo() << ":" << msg;
+    }
+    Init(std::move(module), ctx);
+  }
+
+  /*!
+   * \brief Load the module from its LLVM IR in memory, e.g. as given by GetSource("ll").
+   * \param ir The LLVM IR, in text or bitcode.
+   * \param jit The JIT of the module, "mcjit" or "orc".
+   */
+  void LoadIRString(const std::string& ir, const std::string& jit) {
+    auto ctx = std::make_shared<llvm::LLVMContext>();
+    llvm::SMDiagnostic err;
+    auto module = llvm::parseIR(llvm::MemoryBufferRef(ir, "TVMMod"), err, *ctx);
+    if (module == nullptr) {
+      std::string msg = std::string(err.getMessage());
+      LOG(FATAL) << "Fail to load ir\n"
+                 << "line " << err.getLineNo() << ":" << msg;
+    }
+    Init(std::move(module), ctx);
+    // Unlike the modules loaded from files, JIT for the target the module was built for.
+    target_ = Target(GetTargetMetadata() + " -jit=" + jit);
+  }
+
+ private:
+  // The target the module was built for, as recorded in its "tvm_target" flag.
+  std::string GetTargetMetadata() const {
     std::string target_metadata;
     llvm::Metadata* tvm_target = module_->getModuleFlag("tvm_target");
     if (tvm_target != nullptr) {
@@ -297,35 +717,38 @@ class LLVMModuleNode final : public runtime::ModuleNode {
       os << "llvm -mtriple " << module_->getTargetTriple();
       target_metadata = os.str();
     }
-    mptr_ = module_.get();
-    tm_ = GetLLVMTargetMachine(Target(target_metadata));
+    return target_metadata;
   }
 
-  void LoadIR(const std::string& file_name) {
-    auto ctx = std::make_shared<llvm::LLVMContext>();
-    llvm::SMDiagnostic err;
-    auto module = llvm::parseIRFile(file_name, err, *ctx);
-    if (module == nullptr) {
-      std::string msg = std::string(err.getMessage());
-      LOG(FATAL) << "Fail to load ir file " << file_name << "\n"
-                 << "line " << err.getLineNo() << ":" << msg;
-    }
-    Init(std::move(module), ctx);
+  bool JITInitialized() const {
+#if TVM_LLVM_VERSION >= 130
+    if (orc_dylib_ != nullptr) return true;
+#endif
+    return ee_ != nullptr;
   }
 
- private:
   void LazyInitJIT() {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (ee_) {
+    if (JITInitialized()) {
       return;
     }
     if (!target_.defined()) {
       target_ = Target("llvm");
     }
-    llvm::EngineBuilder builder(std::move(module_));
     std::string triple, mcpu, mattr;
     llvm::TargetOptions opt;
     ParseLLVMTargetOptions(target_, &triple, &mcpu, &mattr, &opt);
+    std::string jit = target_->GetAttr<String>("jit").value_or("mcjit");
+    if (jit == "orc") {
+#if TVM_LLVM_VERSION >= 130
+      InitORCJIT(triple, mcpu, mattr, opt);
+      return;
+#else
+      LOG(FATAL) << "The ORC JIT requires LLVM 13 or later";
+#endif
+    }
+    ICHECK_EQ(jit, "mcjit") << "Unknown LLVM JIT " << jit << ", expected mcjit or orc";
+    llvm::EngineBuilder builder(std::move(module_));
     builder.setEngineKind(llvm::EngineKind::JIT);
     builder.setOptLevel(llvm::CodeGenOpt::Aggressive);
     if (mcpu.length() != 0) {
@@ -351,7 +774,11 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     ee_ = builder.create(tm.release());
     ICHECK(ee_ != nullptr) << "Failed to initialize jit engine for " << mptr_->getTargetTriple();
     ee_->runStaticConstructorsDestructors(false);
+    InitContext();
+  }
 
+  // Set the module context and the TVM runtime API function pointers of the JITed module.
+  void InitContext() {
     if (void** ctx_addr =
             reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx))) {
       *ctx_addr = this;
@@ -359,10 +786,90 @@ class LLVMModuleNode final : public runtime::ModuleNode {
     runtime::InitContextFunctions(
         [this](const char* name) { return reinterpret_cast<void*>(GetGlobalAddr(name)); });
   }
+
+#if TVM_LLVM_VERSION >= 130
+  // JIT the module with the ORC JIT session of the target, compiling each function on its first
+  // call instead of the whole module up front. The session gets a copy of the module in a context
+  // of its own, as it splits the module and compiles the parts in its own threads, while mptr_
+  // stays valid for the source and the symbol queries.
+  void InitORCJIT(const std::string& triple, const std::string& mcpu, const std::string& mattr,
+                  const llvm::TargetOptions& opt) {
+    std::unique_ptr<llvm::TargetMachine> tm_sys = GetLLVMTargetMachine(Target("llvm"));
+    if (tm_sys->getTargetTriple().getArch() != llvm::Triple(triple).getArch()) {
+      LOG(FATAL) << "Cannot run module, architecture mismatch "
+                 << " module=" << triple << " system=" << tm_sys->getTargetTriple().str();
+    }
+    orc_session_ = ORCJITSession::Get(triple, mcpu, mattr, opt);
+    const llvm::DataLayout& layout = orc_session_->GetDataLayout();
+    ICHECK(layout == mptr_->getDataLayout())
+        << "Data layout mismatch between module("
+        << mptr_->getDataLayout().getStringRepresentation() << ")"
+        << " and ORC JIT (" << layout.getStringRepresentation() << ")";
+
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(*mptr_, os);
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto module = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), "TVMMod"), *ctx);
+    ICHECK(module) << "Failed to copy the module for the ORC JIT: "
+                   << llvm::toString(module.takeError());
+    orc_dylib_ = orc_session_->Add(std::move(*module), std::move(ctx));
+    InitContext();
+  }
+#endif
+  // Write the counters collected by a module built with "tir.llvm_pgo_instrument" to an
+  // indexed profile, which is attached to the rebuild with "tir.llvm_pgo_profile".
+  void WritePGOProfile(const std::string& file_name) {
+#if TVM_LLVM_VERSION >= 90
+    llvm::NamedMDNode* md = mptr_->getNamedMetadata("tvm.pgo.counters");
+    ICHECK(md != nullptr) << "The module is not instrumented, build it with the "
+                          << "\"tir.llvm_pgo_instrument\" PassContext option";
+    if (!JITInitialized()) LazyInitJIT();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    llvm::InstrProfWriter writer;
+    for (const llvm::MDNode* node : md->operands()) {
+      llvm::StringRef func_name = llvm::cast<llvm::MDString>(node->getOperand(0))->getString();
+      uint64_t hash =
+          llvm::mdconst::extract<llvm::ConstantInt>(node->getOperand(1))->getZExtValue();
+      std::string array_name = llvm::cast<llvm::MDString>(node->getOperand(2))->getString().str();
+      const llvm::GlobalVariable* array = mptr_->getGlobalVariable(array_name);
+      ICHECK(array != nullptr) << "Cannot find the profile counters " << array_name;
+      uint64_t num_counters = llvm::cast<llvm::ArrayType>(array->getValueType())->getNumElements();
+      const uint64_t* counts = reinterpret_cast<const uint64_t*>(GetGlobalAddr(array_name));
+      ICHECK(counts != nullptr) << "Cannot find the address of the profile counters " << array_name;
+      writer.addRecord(llvm::NamedInstrProfRecord(
+                           func_name, hash, std::vector<uint64_t>(counts, counts + num_counters)),
+                       [](llvm::Error err) { LOG(WARNING) << llvm::toString(std::move(err)); });
+    }
+#if TVM_LLVM_VERSION >= 140
+    llvm::Error err = writer.mergeProfileKind(llvm::InstrProfKind::IR);
+#else
+    llvm::Error err = writer.setIsIRLevelProfile(true, false);
+#endif
+    ICHECK(!err) << llvm::toString(std::move(err));
+
+    std::error_code ecode;
+    llvm::raw_fd_ostream dest(file_name, ecode, llvm::sys::fs::F_None);
+    ICHECK_EQ(ecode.value(), 0) << "Cannot open file: " << file_name << " " << ecode.message();
+#if TVM_LLVM_VERSION >= 100
+    err = writer.write(dest);
+    ICHECK(!err) << llvm::toString(std::move(err));
+#else
+    writer.write(dest);
+#endif
+#else
+    LOG(FATAL) << "Profile guided optimization requires LLVM 9 or later";
+#endif
+  }
   // Get global address from execution engine.
   uint64_t GetGlobalAddr(const std::string& name) const {
     // first verifies if GV exists.
     if (mptr_->getGlobalVariable(name) != nullptr) {
+#if TVM_LLVM_VERSION >= 130
+      if (orc_dylib_ != nullptr) return orc_session_->Lookup(orc_dylib_, name);
+#endif
       return ee_->getGlobalValueAddress(name);
     } else {
       return 0;
@@ -371,6 +878,9 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   uint64_t GetFunctionAddr(const std::string& name) const {
     // first verifies if GV exists.
     if (mptr_->getFunction(name) != nullptr) {
+#if TVM_LLVM_VERSION >= 130
+      if (orc_dylib_ != nullptr) return orc_session_->Lookup(orc_dylib_, name);
+#endif
       return ee_->getFunctionAddress(name);
     } else {
       return 0;
@@ -383,6 +893,11 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::mutex mutex_;
   // execution engine
   llvm::ExecutionEngine* ee_{nullptr};
+#if TVM_LLVM_VERSION >= 130
+  // The ORC JIT session and the JITDylib of the module, when JITed with "-jit=orc".
+  ORCJITSession* orc_session_{nullptr};
+  llvm::orc::JITDylib* orc_dylib_{nullptr};
+#endif
   // The raw pointer to the module.
   llvm::Module* mptr_{nullptr};
   // The target machine
@@ -393,6 +908,8 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::shared_ptr<llvm::LLVMContext> ctx_;
   /* \brief names of the functions declared in this module */
   Array<String> function_names_;
+  // The optimized bitcode of the compilation units, empty if the module was built as one unit.
+  std::vector<std::string> unit_bitcode_;
 };
 
 TVM_REGISTER_GLOBAL("target.build.llvm")
@@ -435,6 +952,13 @@ TVM_REGISTER_GLOBAL("runtime.module.loadfile_ll")
       return runtime::Module(n);
     });
 
+TVM_REGISTER_GLOBAL("target.llvm_load_ir")
+    .set_body_typed([](std::string ir, std::string jit) -> runtime::Module {
+      auto n = make_object<LLVMModuleNode>();
+      n->LoadIRString(ir, jit);
+      return runtime::Module(n);
+    });
+
 TVM_REGISTER_GLOBAL("codegen.llvm_target_enabled")
     .set_body_typed([](std::string target_str) -> bool {
       InitializeLLVM();
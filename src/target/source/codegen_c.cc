@@ -80,7 +80,7 @@ void CodeGenC::AddFunction(const PrimFunc& f) {
   auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
   ICHECK(global_symbol.defined())
       << "CodeGenC: Expect PrimFunc to have the global_symbol attribute";
-  bool no_alias = f->HasNonzeroAttr(tir::attr::kNoAlias);
+  func_no_alias_ = f->HasNonzeroAttr(tir::attr::kNoAlias);
 
   this->PrintFuncPrefix();
   this->stream << " " << static_cast<std::string>(global_symbol.value()) << "(";
@@ -105,7 +105,7 @@ void CodeGenC::AddFunction(const PrimFunc& f) {
         }
       }
 
-      if (no_alias && restrict_keyword_.length() != 0) {
+      if (func_no_alias_ && restrict_keyword_.length() != 0) {
         stream << ' ' << restrict_keyword_;
       }
     } else {
@@ -843,7 +843,15 @@ void CodeGenC::VisitStmt_(const LetStmtNode* op) {
     PrintIndent();
     if (op->var.dtype() == DataType::Handle() && handle_data_type_.count(op->var.get())) {
       PrintType(handle_data_type_.at(op->var.get()), stream);
-      stream << "* " << AllocVarID(op->var.get()) << " = (";
+      stream << "* ";
+      // the data of the DLTensor arguments of a noalias function do not alias either
+      const CallNode* call = op->value.as<CallNode>();
+      if (func_no_alias_ && restrict_keyword_.length() != 0 && call != nullptr &&
+          call->op.same_as(builtin::tvm_struct_get()) &&
+          call->args[2].as<IntImmNode>()->value == builtin::kArrData) {
+        stream << restrict_keyword_ << ' ';
+      }
+      stream << AllocVarID(op->var.get()) << " = (";
       PrintType(handle_data_type_.at(op->var.get()), stream);
       stream << "*)" << value << ";\n";
     } else {
@@ -894,6 +902,18 @@ void CodeGenC::VisitStmt_(const AttrStmtNode* op) {
     const StringImmNode* value = op->value.as<StringImmNode>();
     ICHECK(value != nullptr);
     decl_stream << value->value;
+  } else if (op->attr_key == tir::attr::storage_alignment) {
+    const VarNode* v = op->node.as<VarNode>();
+    ICHECK(v);
+    int64_t align = Downcast<IntImm>(op->value)->value;
+    if (assume_aligned_func_.length() != 0 && !print_ssa_form_ && align > 1 &&
+        var_idmap_.count(v) && handle_data_type_.count(v)) {
+      std::string vid = GetVarID(v);
+      PrintIndent();
+      stream << vid << " = (";
+      PrintType(handle_data_type_.at(v), stream);
+      stream << "*)" << assume_aligned_func_ << "(" << vid << ", " << align << ");\n";
+    }
   }
   this->PrintStmt(op->body);
 }
@@ -255,6 +255,13 @@ class CodeGenC : public ExprFunctor<void(const PrimExpr&, std::ostream&)>,
 
   /*! \brief restrict keyword */
   std::string restrict_keyword_{""};
+  /*!
+   * \brief The function asserting the alignment of a pointer, taking the pointer and the
+   *  alignment in bytes. The storage_alignment attributes are not printed if empty.
+   */
+  std::string assume_aligned_func_{""};
+  /*! \brief whether the buffers of the current function do not alias */
+  bool func_no_alias_{false};
   /*! \brief the storage scope of allocation */
   std::unordered_map<const VarNode*, std::string> alloc_storage_scope_;
   /*! \brief the data type of allocated buffers */
@@ -22,10 +22,13 @@
  */
 #include "codegen_c_host.h"
 
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/module.h>
 #include <tvm/target/codegen.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -37,16 +40,54 @@
 namespace tvm {
 namespace codegen {
 
-CodeGenCHost::CodeGenCHost() { module_name_ = GetUniqueName("__tvm_module_ctx"); }
+/*!
+ * \brief The size in bytes from which a linked parameter is emitted as a string literal of its raw
+ *  bytes rather than as a list of its elements, negative for never.
+ */
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.c_link_params_blob_min_bytes", Integer);
 
-void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, std::string target_str) {
+CodeGenCHost::CodeGenCHost() {
+  module_name_ = GetUniqueName("__tvm_module_ctx");
+  restrict_keyword_ = "TVM_RESTRICT";
+  assume_aligned_func_ = "TVM_ASSUME_ALIGNED";
+}
+
+void CodeGenCHost::Init(bool output_ssa, bool emit_asserts, std::string target_str,
+                        const Array<String>& includes) {
   emit_asserts_ = emit_asserts;
   declared_globals_.clear();
+  declared_vector_types_.clear();
   decl_stream << "// tvm target: " << target_str << "\n";
   decl_stream << "#define TVM_EXPORTS\n";
   decl_stream << "#include \"tvm/runtime/c_runtime_api.h\"\n";
   decl_stream << "#include \"tvm/runtime/c_backend_api.h\"\n";
   decl_stream << "#include <math.h>\n";
+  for (const String& include : includes) {
+    std::string header = include;
+    ICHECK(!header.empty()) << "empty header name in the includes of the C target";
+    if (header[0] == '<' || header[0] == '"') {
+      decl_stream << "#include " << header << "\n";
+    } else {
+      decl_stream << "#include <" << header << ">\n";
+    }
+  }
+  // the noalias buffers and the alignment of the DLTensor data, for the C compiler to vectorize
+  decl_stream << "#ifndef TVM_RESTRICT\n"
+              << "#if defined(__GNUC__) || defined(__clang__)\n"
+              << "#define TVM_RESTRICT __restrict__\n"
+              << "#elif defined(__cplusplus)\n"
+              << "#define TVM_RESTRICT\n"
+              << "#else\n"
+              << "#define TVM_RESTRICT restrict\n"
+              << "#endif\n"
+              << "#endif\n"
+              << "#ifndef TVM_ASSUME_ALIGNED\n"
+              << "#if defined(__GNUC__) || defined(__clang__)\n"
+              << "#define TVM_ASSUME_ALIGNED(ptr, align) __builtin_assume_aligned(ptr, align)\n"
+              << "#else\n"
+              << "#define TVM_ASSUME_ALIGNED(ptr, align) (ptr)\n"
+              << "#endif\n"
+              << "#endif\n";
   CodeGenC::Init(output_ssa);
 }
 
@@ -62,22 +103,49 @@ void CodeGenCHost::AddFunction(const PrimFunc& f) {
 }
 
 void CodeGenCHost::DeclareParameters(Map<String, LinkedParam> params) {
+  tvm::transform::PassContext pass_ctx = tvm::transform::PassContext::Current();
+  int64_t blob_min_bytes =
+      pass_ctx->GetConfig<Integer>("tir.c_link_params_blob_min_bytes", Integer(4096)).value();
+  bool declared_aligned = false;
   for (auto kv : params) {
     decl_stream << "\n"
                 << "#ifdef __cplusplus\n"
                 << "extern \"C\" {\n"
-                << "#endif\n"
-                << "static const ";
-    int64_t num_elements = 1;
-    for (int64_t dim : kv.second->param.Shape()) {
-      num_elements *= dim;
+                << "#endif\n";
+    const runtime::NDArray& param = kv.second->param;
+    int64_t num_bytes = static_cast<int64_t>(runtime::GetDataSize(*param.operator->()));
+    if (blob_min_bytes >= 0 && num_bytes >= blob_min_bytes) {
+      // The large parameters are written as their raw bytes, aligned as in the LLVM backend. The
+      // extra byte holds the terminating NUL of the literal.
+      if (!declared_aligned) {
+        decl_stream << "#ifndef TVM_PARAM_ALIGNED\n"
+                    << "#if defined(__GNUC__) || defined(__clang__)\n"
+                    << "#define TVM_PARAM_ALIGNED(align) __attribute__((aligned(align)))\n"
+                    << "#else\n"
+                    << "#define TVM_PARAM_ALIGNED(align)\n"
+                    << "#endif\n"
+                    << "#endif\n";
+        declared_aligned = true;
+      }
+      size_t align = std::max(runtime::GetVectorBytes(param.DataType()), runtime::kAllocAlignment);
+      decl_stream << "static const uint8_t " << ::tvm::runtime::symbol::tvm_param_prefix
+                  << kv.first << "[" << num_bytes + 1 << "] TVM_PARAM_ALIGNED(" << align
+                  << ") =\n";
+      NDArrayDataToCBytes(param, 4, decl_stream);
+      decl_stream << ";\n";
+    } else {
+      decl_stream << "static const ";
+      int64_t num_elements = 1;
+      for (int64_t dim : param.Shape()) {
+        num_elements *= dim;
+      }
+      PrintType(param.DataType(), decl_stream);
+      decl_stream << " " << ::tvm::runtime::symbol::tvm_param_prefix << kv.first << "["
+                  << num_elements << "] = {\n";
+      NDArrayDataToC(param, 4, decl_stream);
+      decl_stream << "};\n";
     }
-    PrintType(kv.second->param.DataType(), decl_stream);
-    decl_stream << " " << ::tvm::runtime::symbol::tvm_param_prefix << kv.first << "["
-                << num_elements << "] = {\n";
-    NDArrayDataToC(kv.second->param, 4, decl_stream);
-    decl_stream << "};\n"
-                << "#ifdef __cplusplus\n"
+    decl_stream << "#ifdef __cplusplus\n"
                 << "}  // extern \"C\"\n"
                 << "#endif\n";
   }
@@ -150,6 +218,11 @@ void CodeGenCHost::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
     if (!fail && lanes == 1) return;
     if (!fail && (lanes >= 2 && lanes <= 16)) {
       os << lanes;
+      if (t.bits() != 16) {
+        std::ostringstream name;
+        name << (t.bits() == 32 ? "float" : "double") << lanes;
+        DeclareVectorType(t, name.str());
+      }
       return;
     }
   } else if (t.is_uint() || t.is_int()) {
@@ -179,22 +252,88 @@ void CodeGenCHost::PrintType(DataType t, std::ostream& os) {  // NOLINT(*)
     if (!fail && lanes == 1) return;
     if (!fail && (lanes >= 2 && lanes <= 16)) {
       os << lanes;
+      std::ostringstream name;
+      int elem_bits = t.bits() == 1 ? 32 : t.bits();
+      name << (t.is_uint() ? "u" : "") << "int" << elem_bits << "_t" << lanes;
+      DeclareVectorType(t.with_bits(elem_bits), name.str());
       return;
     }
   }
   LOG(FATAL) << "Cannot convert type " << t << " to C type";
 }
 
+void CodeGenCHost::DeclareVectorType(DataType t, const std::string& name) {
+  if (!declared_vector_types_.insert(name).second) return;
+  int elem_bytes = t.bits() / 8;
+  decl_stream << "typedef ";
+  PrintType(t.element_of(), decl_stream);
+  decl_stream << " " << name << " __attribute__((vector_size(" << elem_bytes * t.lanes()
+              << "), aligned(" << elem_bytes << ")));\n";
+}
+
+void CodeGenCHost::PrintVecElemLoad(const std::string& vec, DataType t, int i,
+                                    std::ostream& os) {  // NOLINT(*)
+  os << vec << "[" << i << "]";
+}
+
+void CodeGenCHost::PrintVecElemStore(const std::string& vec, DataType t, int i,
+                                     const std::string& value) {
+  this->PrintIndent();
+  stream << vec << "[" << i << "] = " << value << ";\n";
+}
+
+void CodeGenCHost::PrintVecElemLoadExpr(DataType t, int i, const std::string& value,
+                                        std::ostream& os) {  // NOLINT(*)
+  ICHECK_GT(t.lanes(), 1);
+  if (i == 0) {
+    os << "((";
+    PrintType(t, os);
+    os << "){";
+  }
+  os << value;
+  if (i != t.lanes() - 1) {
+    os << ", ";
+  } else {
+    os << "})";
+  }
+}
+
 void CodeGenCHost::VisitExpr_(const BroadcastNode* op, std::ostream& os) {  // NOLINT(*)
   std::string v = PrintExpr(op->value);
   os << "((";
   PrintType(op->dtype, os);
-  os << ")(";
+  os << "){";
   for (int i = 0; i < op->lanes; ++i) {
     if (i != 0) os << ", ";
     os << v;
   }
-  os << "))";
+  os << "})";
+}
+
+void CodeGenCHost::VisitExpr_(const RampNode* op, std::ostream& os) {  // NOLINT(*)
+  std::string base = PrintExpr(op->base);
+  std::string stride = PrintExpr(op->stride);
+  os << "((";
+  PrintType(op->dtype, os);
+  os << "){";
+  for (int i = 0; i < op->lanes; ++i) {
+    if (i != 0) os << ", ";
+    os << "(" << base << ")+(" << stride << "*" << i << ")";
+  }
+  os << "})";
+}
+
+void CodeGenCHost::VisitStmt_(const LetStmtNode* op) {  // NOLINT(*)
+  // type the pointers to the buffer data, e.g. of the DLTensor arguments, after their buffers
+  if (op->var.dtype().is_handle() && !handle_data_type_.count(op->var.get())) {
+    if (auto* ptr = op->var->type_annotation.as<PointerTypeNode>()) {
+      auto* prim = ptr->element_type.as<PrimTypeNode>();
+      if (prim != nullptr && !prim->dtype.is_handle() && prim->dtype.lanes() == 1) {
+        RegisterHandleType(op->var.get(), prim->dtype);
+      }
+    }
+  }
+  CodeGenC::VisitStmt_(op);
 }
 
 void CodeGenCHost::PrintGetFuncFromBackend(const std::string& func_name,
@@ -369,7 +508,8 @@ runtime::Module BuildCHost(IRModule mod, Target target) {
   bool output_ssa = false;
   bool emit_asserts = false;
   CodeGenCHost cg;
-  cg.Init(output_ssa, emit_asserts, target->str());
+  cg.Init(output_ssa, emit_asserts, target->str(),
+          target->GetAttr<Array<String>>("includes").value_or(Array<String>()));
 
   Map<String, LinkedParam> linked_params;
   bool found_linked_params = false;
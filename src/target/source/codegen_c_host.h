@@ -28,6 +28,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include <unordered_set>
+
 #include "codegen_c.h"
 #include "tvm/target/codegen.h"
 #include "tvm/tir/expr.h"
@@ -38,7 +40,16 @@ namespace codegen {
 class CodeGenCHost final : public CodeGenC {
  public:
   CodeGenCHost();
-  void Init(bool output_ssa, bool emit_asserts, std::string target_str);
+  /*!
+   * \brief Initialize the code generator.
+   * \param output_ssa Whether to output SSA.
+   * \param emit_asserts Whether to emit the asserts in the resulting C code.
+   * \param target_str The target of the module, printed in the header comment.
+   * \param includes The headers included in the module, e.g. of SIMD intrinsics, "<header>",
+   *  "\"header\"" or a bare name included with angle brackets.
+   */
+  void Init(bool output_ssa, bool emit_asserts, std::string target_str,
+            const Array<String>& includes = {});
 
   void AddFunction(const PrimFunc& f);
 
@@ -51,9 +62,17 @@ class CodeGenCHost final : public CodeGenC {
   void PrintType(DataType t, std::ostream& os) final;  // NOLINT(*)
   void PrintFuncPrefix() final;                        // NOLINT(*)
   void PrintFinalReturn() final;                       // NOLINT(*)
+  // print the vector types as GNU vector extensions, with element access by subscript
+  void PrintVecElemLoad(const std::string& vec, DataType t, int i,
+                        std::ostream& os) final;  // NOLINT(*)
+  void PrintVecElemStore(const std::string& vec, DataType t, int i,
+                         const std::string& value) final;
+  void PrintVecElemLoadExpr(DataType t, int i, const std::string& value,
+                            std::ostream& os) final;  // NOLINT(*)
 
   // overload visitor functions
   void VisitExpr_(const BroadcastNode* op, std::ostream& os) final;  // NOLINT(*)
+  void VisitExpr_(const RampNode* op, std::ostream& os) final;       // NOLINT(*)
   void VisitExpr_(const CallNode* op, std::ostream& os) final;       // NOLINT(*)
   // overload min and max to use the ternary operator, so we don't rely on the
   // standard library implementations
@@ -61,6 +80,7 @@ class CodeGenCHost final : public CodeGenC {
   void VisitExpr_(const MaxNode* op, std::ostream& os) final;  // NOLINT(*)
 
   void VisitStmt_(const AssertStmtNode* op) final;  // NOLINT(*)
+  void VisitStmt_(const LetStmtNode* op) final;     // NOLINT(*)
 
   Array<String> GetFunctionNames() { return function_names_; }
 
@@ -81,6 +101,16 @@ class CodeGenCHost final : public CodeGenC {
   Array<String> function_names_;
   /*! \brief whether to emit asserts in the resulting C code */
   bool emit_asserts_;
+  /*! \brief the vector types declared in the module */
+  std::unordered_set<std::string> declared_vector_types_;
+
+  /*!
+   * \brief Declare a vector type as a GNU vector extension, aligned as its elements so that the
+   *  vectors can be loaded from and stored to any element of a buffer.
+   * \param t The vector type.
+   * \param name The name of the type.
+   */
+  void DeclareVectorType(DataType t, const std::string& name);
 
   FunctionInfo GetFunctionInfo(const CallNode* op);
   void PrintGetFuncFromBackend(const std::string& func_name, const std::string& packed_func_name);
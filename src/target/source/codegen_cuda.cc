@@ -611,6 +611,36 @@ void CodeGenCUDA::PrintCallExtern(Type ret_type, String global_symbol, const Arr
   }
 }
 
+/*!
+ * \brief The PTX type of the dtype of an operand of ptx_mma or ptx_mma_sp.
+ */
+static std::string PTXMMAType(const PrimExpr& dtype) {
+  const auto* str = dtype.as<StringImmNode>();
+  ICHECK(str) << "The mma intrinsics expect the dtypes as strings";
+  if (str->value == "fp16") return "f16";
+  if (str->value == "bf16") return "bf16";
+  if (str->value == "fp32") return "f32";
+  if (str->value == "tf32") return "tf32";
+  if (str->value == "int8") return "s8";
+  if (str->value == "uint8") return "u8";
+  if (str->value == "int32") return "s32";
+  LOG(FATAL) << "The mma intrinsics do not support the dtype " << str->value;
+  return "";
+}
+
+/*!
+ * \brief The list of the inline asm operands begin, ..., begin + count - 1.
+ */
+static std::string PTXOperandList(int begin, int count) {
+  std::ostringstream list;
+  list << "{";
+  for (int i = 0; i < count; ++i) {
+    list << (i ? ", " : "") << "%" << begin + i;
+  }
+  list << "}";
+  return list.str();
+}
+
 void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
   if (auto* ptr_op = op->op.as<OpNode>()) {
     Op call_op = GetRef<Op>(ptr_op);
@@ -670,6 +700,171 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
       this->PrintExpr(op->args[i * 2 + 1], os);
       os << "]" << ((i < 3) ? ", " : ")");
     }
+  } else if (op->op.same_as(builtin::ptx_mma_sp())) {
+    ICHECK_EQ(op->args.size(), 15U);
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    ICHECK(Downcast<StringImm>(op->args[1])->value == "row" &&
+           Downcast<StringImm>(op->args[2])->value == "col")
+        << "ptx_mma_sp only supports a row major A and a column major B";
+    std::string a_type = PTXMMAType(op->args[3]);
+    std::string b_type = PTXMMAType(op->args[4]);
+    std::string c_type = PTXMMAType(op->args[5]);
+    ICHECK(a_type == b_type && (a_type == "f16" || a_type == "bf16"))
+        << "ptx_mma_sp expects A and B in fp16 or bf16";
+    ICHECK(c_type == "f32" || (c_type == "f16" && a_type == "f16"))
+        << "ptx_mma_sp expects the accumulator in fp32, or in fp16 for fp16 inputs";
+    // The 32-bit registers of the fragments of a thread, A holding half of its columns.
+    int ab_regs = 0;
+    if (shape == "m16n8k16") {
+      ab_regs = 2;
+    } else if (shape == "m16n8k32") {
+      ab_regs = 4;
+    } else {
+      LOG(FATAL) << "ptx_mma_sp does not support the shape " << shape;
+    }
+    int c_regs = c_type == "f32" ? 4 : 2;
+    const auto* selector = op->args[14].as<IntImmNode>();
+    ICHECK(selector) << "The sparse selector of ptx_mma_sp must be a constant";
+    if (shape == "m16n8k32") {
+      ICHECK_EQ(selector->value, 0) << "The sparse selector of m16n8k32 must be 0";
+    } else {
+      ICHECK(selector->value == 0 || selector->value == 1)
+          << "The sparse selector of m16n8k16 must be 0 or 1";
+    }
+
+    auto print_reg = [&](const char* constraint, const char* ctype, int arg, int i) {
+      os << "\"" << constraint << "\"(((" << ctype << " *)(";
+      this->PrintExpr(op->args[arg], os);
+      os << " + ";
+      this->PrintExpr(op->args[arg + 1], os);
+      os << "))[" << i << "])";
+    };
+    std::string c_list = PTXOperandList(0, c_regs);
+    os << "asm volatile(\"mma.sp.sync.aligned." << shape << ".row.col." << c_type << "."
+       << a_type << "." << b_type << "." << c_type << " " << c_list << ", "
+       << PTXOperandList(c_regs, ab_regs) << ", " << PTXOperandList(c_regs + ab_regs, ab_regs)
+       << ", " << c_list << ", %" << c_regs + 2 * ab_regs << ", " << selector->value << ";\\n\"\n";
+    os << "    : ";
+    for (int i = 0; i < c_regs; ++i) {
+      if (i) os << ", ";
+      if (c_type == "f32") {
+        print_reg("+f", "float", 10, i);
+      } else {
+        print_reg("+r", "unsigned", 10, i);
+      }
+    }
+    os << "\n    : ";
+    for (int i = 0; i < ab_regs; ++i) {
+      print_reg("r", "unsigned", 6, i);
+      os << ", ";
+    }
+    for (int i = 0; i < ab_regs; ++i) {
+      print_reg("r", "unsigned", 8, i);
+      os << ", ";
+    }
+    print_reg("r", "unsigned", 12, 0);
+    os << ")";
+  } else if (op->op.same_as(builtin::ptx_mma())) {
+    ICHECK_EQ(op->args.size(), 12U);
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    ICHECK(Downcast<StringImm>(op->args[1])->value == "row" &&
+           Downcast<StringImm>(op->args[2])->value == "col")
+        << "ptx_mma only supports a row major A and a column major B";
+    std::string a_type = PTXMMAType(op->args[3]);
+    std::string b_type = PTXMMAType(op->args[4]);
+    std::string c_type = PTXMMAType(op->args[5]);
+    ICHECK(a_type == b_type && a_type != "f32" && a_type != "s32")
+        << "ptx_mma expects A and B in the same fp16, bf16, tf32, int8 or uint8 dtype";
+    bool is_int = a_type == "s8" || a_type == "u8";
+    // The two k of each input type, of 128 and 256 bits of A per thread.
+    int k = std::stoi(shape.substr(shape.find('k') + 1));
+    int small_k = a_type == "tf32" ? 4 : (is_int ? 16 : 8);
+    ICHECK(shape.rfind("m16n8k", 0) == 0 && (k == small_k || k == 2 * small_k))
+        << "ptx_mma does not support the shape " << shape << " for " << a_type;
+    ICHECK(is_int ? c_type == "s32" : (c_type == "f32" || (c_type == "f16" && a_type == "f16")))
+        << "ptx_mma expects the accumulator in int32 for int8, in fp32 otherwise, or in fp16 "
+        << "for fp16 inputs";
+    // The 32-bit registers of the fragments of a thread.
+    int a_regs = k == small_k ? 2 : 4;
+    int b_regs = a_regs / 2;
+    int c_regs = c_type == "f16" ? 2 : 4;
+
+    auto print_reg = [&](const char* constraint, const char* ctype, int arg, int i) {
+      os << "\"" << constraint << "\"(((" << ctype << " *)(";
+      this->PrintExpr(op->args[arg], os);
+      os << " + ";
+      this->PrintExpr(op->args[arg + 1], os);
+      os << "))[" << i << "])";
+    };
+    std::string c_list = PTXOperandList(0, c_regs);
+    os << "asm volatile(\"mma.sync.aligned." << shape << ".row.col." << c_type << "." << a_type
+       << "." << b_type << "." << c_type << " " << c_list << ", "
+       << PTXOperandList(c_regs, a_regs) << ", " << PTXOperandList(c_regs + a_regs, b_regs) << ", "
+       << c_list << ";\\n\"\n";
+    os << "    : ";
+    for (int i = 0; i < c_regs; ++i) {
+      if (i) os << ", ";
+      if (c_type == "f32") {
+        print_reg("+f", "float", 10, i);
+      } else if (c_type == "s32") {
+        print_reg("+r", "int", 10, i);
+      } else {
+        print_reg("+r", "unsigned", 10, i);
+      }
+    }
+    os << "\n    : ";
+    for (int i = 0; i < a_regs; ++i) {
+      print_reg("r", "unsigned", 6, i);
+      os << ", ";
+    }
+    for (int i = 0; i < b_regs; ++i) {
+      if (i) os << ", ";
+      print_reg("r", "unsigned", 8, i);
+    }
+    os << ")";
+  } else if (op->op.same_as(builtin::ptx_ldmatrix())) {
+    ICHECK_EQ(op->args.size(), 6U);
+    const auto* trans_imm = op->args[0].as<IntImmNode>();
+    ICHECK(trans_imm) << "The transpose flag of ptx_ldmatrix must be a constant";
+    bool trans = trans_imm->value != 0;
+    const auto* num = op->args[1].as<IntImmNode>();
+    ICHECK(num && (num->value == 1 || num->value == 2 || num->value == 4))
+        << "ptx_ldmatrix loads 1, 2 or 4 matrices";
+    os << "asm volatile(\"ldmatrix.sync.aligned.m8n8.x" << num->value << (trans ? ".trans" : "")
+       << ".shared.b16 " << PTXOperandList(0, num->value) << ", [%" << num->value << "];\\n\"\n";
+    os << "    : ";
+    for (int i = 0; i < num->value; ++i) {
+      if (i) os << ", ";
+      os << "\"=r\"(((unsigned *)(";
+      this->PrintExpr(op->args[2], os);
+      os << " + ";
+      this->PrintExpr(op->args[3], os);
+      os << "))[" << i << "])";
+    }
+    os << "\n    : \"r\"((unsigned)__cvta_generic_to_shared(";
+    this->PrintExpr(op->args[4], os);
+    os << " + ";
+    this->PrintExpr(op->args[5], os);
+    os << ")))";
+  } else if (op->op.same_as(builtin::ptx_cp_async())) {
+    ICHECK_EQ(op->args.size(), 3U);
+    const auto* bytes = op->args[2].as<IntImmNode>();
+    ICHECK(bytes && (bytes->value == 4 || bytes->value == 8 || bytes->value == 16))
+        << "ptx_cp_async copies 4, 8 or 16 bytes";
+    // The copies of 16 bytes bypass L1.
+    os << "asm volatile(\"cp.async." << (bytes->value == 16 ? "cg" : "ca")
+       << ".shared.global [%0], [%1], " << bytes->value << ";\\n\"\n";
+    os << "    :: \"r\"((unsigned)__cvta_generic_to_shared(";
+    this->PrintExpr(op->args[0], os);
+    os << ")), \"l\"(";
+    this->PrintExpr(op->args[1], os);
+    os << "))";
+  } else if (op->op.same_as(builtin::ptx_commit_group())) {
+    os << "asm volatile(\"cp.async.commit_group;\\n\" ::)";
+  } else if (op->op.same_as(builtin::ptx_wait_group())) {
+    const auto* n = op->args[0].as<IntImmNode>();
+    ICHECK(n) << "The number of pending groups of ptx_wait_group must be a constant";
+    os << "asm volatile(\"cp.async.wait_group " << n->value << ";\\n\" ::)";
   } else if (op->op.same_as(builtin::tvm_bmma_sync())) {
     need_mma_h_ = true;
     ICHECK_EQ(op->args.size(), 8U);
@@ -25,6 +25,7 @@
 
 #include <dlpack/dlpack.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <memory>
@@ -244,5 +245,30 @@ void NDArrayDataToC(::tvm::runtime::NDArray arr, int indent_chars, std::ostream&
   os.flags(old_fmtflags);
 }
 
+void NDArrayDataToCBytes(::tvm::runtime::NDArray arr, int indent_chars, std::ostream& os) {
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  constexpr const size_t kBytesPerRow = 32;
+  static const char* kHexDigits = "0123456789abcdef";
+  const uint8_t* data = static_cast<const uint8_t*>(arr->data) + arr->byte_offset;
+  size_t num_bytes = runtime::GetDataSize(*arr.operator->());
+
+  std::string row;
+  row.reserve(indent_chars + 2 + kBytesPerRow * 4 + 1);
+  for (size_t i = 0; i < num_bytes; i += kBytesPerRow) {
+    row.assign(indent_chars, ' ');
+    row += '"';
+    for (size_t j = i; j < std::min(num_bytes, i + kBytesPerRow); ++j) {
+      row += "\\x";
+      row += kHexDigits[data[j] >> 4];
+      row += kHexDigits[data[j] & 0xf];
+    }
+    row += "\"\n";
+    os.write(row.data(), row.size());
+  }
+  if (num_bytes == 0) {
+    os << std::string(indent_chars, ' ') << "\"\"\n";
+  }
+}
+
 }  // namespace codegen
 }  // namespace tvm
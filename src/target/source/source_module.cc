@@ -194,7 +194,8 @@ class CSourceCrtMetadataModuleNode : public runtime::ModuleNode {
 
   void GenerateEntrypointForUnpackedAPI(const std::string& run_func) {
     code_ << "TVM_DLL int32_t " << run_func << "(";
-    int total_args = (metadata_->num_inputs + metadata_->num_outputs);
+    int total_args =
+        (metadata_->num_inputs + metadata_->num_outputs + metadata_->num_workspace_pools);
     for (int i = 0; i < total_args; ++i) {
       code_ << "arg" << i;
       if (i + 1 != total_args) {
@@ -216,6 +217,11 @@ class CSourceCrtMetadataModuleNode : public runtime::ModuleNode {
         code_ << ",";
       }
     }
+    // The workspace pools are passed as plain pointers
+    for (int i = 0; i < metadata_->num_workspace_pools; ++i) {
+      int j = metadata_->num_inputs + metadata_->num_outputs + i;
+      code_ << ",((TVMValue*)args)[" << j << "].v_handle";
+    }
     code_ << ");\n";
     code_ << "}\n";
   }
@@ -250,6 +256,7 @@ class CSourceCrtMetadataModuleNode : public runtime::ModuleNode {
           << "    .run_func = &" << ::tvm::runtime::symbol::tvm_module_main << ",\n"
           << "    .num_input_tensors = " << metadata_->num_inputs << ",\n"
           << "    .num_output_tensors = " << metadata_->num_outputs << ", \n"
+          << "    .num_workspace_pools = " << metadata_->num_workspace_pools << ",\n"
           << "};\n";
   }
 
@@ -286,6 +286,39 @@ spirv::Value CodeGenSPIRV::VisitExpr_(const LetNode* op) {
   return MakeValue(op->body);
 }
 
+spirv::Value CodeGenSPIRV::CreateSubgroupShuffle(const CallNode* op) {
+  // The arguments are the mask, the value, the lane or the delta, the
+  // width of the segments shuffled within and the warp size. The mask
+  // is ignored, the inactive invocations not taking part in the group
+  // operations.
+  ICHECK_EQ(op->args.size(), 5U);
+  spirv::SType t_uint = builder_->GetSType(DataType::UInt(32));
+  spirv::Value value = MakeValue(op->args[1]);
+  spirv::Value lane_or_delta = builder_->Cast(t_uint, MakeValue(op->args[2]));
+  spirv::Value width = builder_->Cast(t_uint, MakeValue(op->args[3]));
+  spirv::Value lane = builder_->GetSubgroupLocalID();
+  spirv::Value segment_mask = builder_->Sub(width, builder_->UIntImm(t_uint, 1));
+  spirv::Value lane_in_segment = builder_->MakeValue(spv::OpBitwiseAnd, t_uint, lane, segment_mask);
+
+  if (op->op.same_as(builtin::tvm_warp_shuffle())) {
+    spirv::Value segment_base = builder_->Sub(lane, lane_in_segment);
+    return builder_->SubgroupShuffle(spv::OpGroupNonUniformShuffle, value,
+                                     builder_->Add(segment_base, lane_or_delta));
+  }
+  // Like the CUDA shuffles, the invocations reading past their segment
+  // keep their value.
+  spirv::Value in_segment;
+  spirv::Value shuffled;
+  if (op->op.same_as(builtin::tvm_warp_shuffle_down())) {
+    in_segment = builder_->LT(builder_->Add(lane_in_segment, lane_or_delta), width);
+    shuffled = builder_->SubgroupShuffle(spv::OpGroupNonUniformShuffleDown, value, lane_or_delta);
+  } else {
+    in_segment = builder_->GE(lane_in_segment, lane_or_delta);
+    shuffled = builder_->SubgroupShuffle(spv::OpGroupNonUniformShuffleUp, value, lane_or_delta);
+  }
+  return builder_->Select(in_segment, shuffled, value);
+}
+
 spirv::Value CodeGenSPIRV::VisitExpr_(const CallNode* op) {
   if (op->op.same_as(builtin::call_spirv_pure_glsl450())) {
     ICHECK_GE(op->args.size(), 2U);
@@ -339,6 +372,15 @@ spirv::Value CodeGenSPIRV::VisitExpr_(const CallNode* op) {
     return builder_->UIntImm(builder_->GetSType(op->dtype), val);
   } else if (op->op.same_as(builtin::tvm_storage_sync())) {
     return this->CreateStorageSync(op);
+  } else if (op->op.same_as(builtin::tvm_warp_activemask())) {
+    spirv::SType t_bool = builder_->GetSType(DataType::UInt(1));
+    spirv::Value ballot = builder_->SubgroupBallot(builder_->UIntImm(t_bool, 1));
+    // The subgroups of the reductions have at most 32 invocations.
+    return builder_->MakeValue(spv::OpCompositeExtract, builder_->GetSType(op->dtype), ballot, 0);
+  } else if (op->op.same_as(builtin::tvm_warp_shuffle()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_down()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_up())) {
+    return this->CreateSubgroupShuffle(op);
   } else if (op->op.same_as(builtin::if_then_else())) {
     ICHECK_EQ(op->args.size(), 3U);
     spirv::Value cond = MakeValue(op->args[0]);
@@ -140,6 +140,8 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
   // Get the thread index
   spirv::Value GetThreadIndex(const IterVar& iv, const PrimExpr& extent);
   spirv::Value CreateStorageSync(const CallNode* op);
+  // Lower the tvm_warp_shuffle builtins to subgroup shuffles.
+  spirv::Value CreateSubgroupShuffle(const CallNode* op);
   void Scalarize(const PrimExpr& e, std::function<void(int i, spirv::Value v)> f);
   // SPIRV-related capabilities of the target
   SPIRVSupport spirv_support_;
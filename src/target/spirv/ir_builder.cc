@@ -37,9 +37,10 @@ void IRBuilder::InitHeader() {
   ICHECK_EQ(header_.size(), 0U);
   header_.push_back(spv::MagicNumber);
 
-  // Target SPIR-V version 1.0.  Additional functionality will be
-  // enabled through extensions.
-  header_.push_back(0x10000);
+  // Target SPIR-V version 1.0 unless subgroup operations are used,
+  // see Finalize.  Additional functionality will be enabled through
+  // extensions.
+  header_.push_back(spirv_version_);
 
   // generator: set to 0, unknown
   header_.push_back(0U);
@@ -78,6 +79,8 @@ std::vector<uint32_t> IRBuilder::Finalize() {
   // Index for upper bound of id numbers.
   const int kBoundLoc = 3;
   header_[kBoundLoc] = id_counter_;
+  const int kVersionLoc = 1;
+  header_[kVersionLoc] = spirv_version_;
   data.insert(data.end(), header_.begin(), header_.end());
   for (const auto& capability : capabilities_used_) {
     ib_.Begin(spv::OpCapability).Add(capability).Commit(&data);
@@ -357,6 +360,29 @@ Value IRBuilder::GetLocalID(uint32_t dim_index) {
   return GetBuiltInValue(spv::BuiltInLocalInvocationId, dim_index, name);
 }
 
+Value IRBuilder::GetSubgroupLocalID() {
+  return GetBuiltInValue(spv::BuiltInSubgroupLocalInvocationId, 0, "subgroup_lane");
+}
+
+Value IRBuilder::SubgroupShuffle(spv::Op op, Value value, Value lane_or_delta) {
+  if (op == spv::OpGroupNonUniformShuffle) {
+    AddSubgroupCapability(spv::CapabilityGroupNonUniformShuffle);
+  } else {
+    ICHECK(op == spv::OpGroupNonUniformShuffleDown || op == spv::OpGroupNonUniformShuffleUp)
+        << "Unsupported subgroup shuffle " << op;
+    AddSubgroupCapability(spv::CapabilityGroupNonUniformShuffleRelative);
+  }
+  AddCapabilityFor(value.stype.type);
+  return MakeValue(op, value.stype, IntImm(t_int32_, spv::ScopeSubgroup), value, lane_or_delta);
+}
+
+Value IRBuilder::SubgroupBallot(Value pred) {
+  ICHECK(pred.stype.type == DataType::UInt(1)) << "A ballot takes a boolean predicate";
+  AddSubgroupCapability(spv::CapabilityGroupNonUniformBallot);
+  return MakeValue(spv::OpGroupNonUniformBallot, GetSType(DataType::UInt(32, 4)),
+                   IntImm(t_int32_, spv::ScopeSubgroup), pred);
+}
+
 Value IRBuilder::GetBuiltInValue(spv::BuiltIn built_in, uint32_t index, const std::string& name) {
   // Returned cached value if it exists
   {
@@ -375,6 +401,12 @@ Value IRBuilder::GetBuiltInValue(spv::BuiltIn built_in, uint32_t index, const st
       global_arr_type = data_type.with_lanes(3);
       break;
 
+    case spv::BuiltInSubgroupLocalInvocationId:
+      AddSubgroupCapability(spv::CapabilityGroupNonUniform);
+      data_type = DataType::UInt(32);
+      global_arr_type = data_type;
+      break;
+
     default:
       LOG(FATAL) << "No data type defined for SPIR-V Built-In " << built_in;
   }
@@ -402,6 +434,9 @@ Value IRBuilder::GetBuiltInValue(spv::BuiltIn built_in, uint32_t index, const st
         case spv::BuiltInWorkgroupId:
           SetName(global_array, "BuiltInWorkgroupId");
           break;
+        case spv::BuiltInSubgroupLocalInvocationId:
+          SetName(global_array, "BuiltInSubgroupLocalInvocationId");
+          break;
 
         default:
           break;
@@ -413,13 +448,16 @@ Value IRBuilder::GetBuiltInValue(spv::BuiltIn built_in, uint32_t index, const st
 
   // Declare the dereferenced value
   SType data_stype = GetSType(data_type);
-  SType ptr_type = this->GetPointerType(data_stype, spv::StorageClassInput);
-  Value global_const_index = UIntImm(t_int32_, static_cast<int64_t>(index));
+  Value ptr = global_array;
+  if (global_arr_type.is_vector()) {
+    SType ptr_type = this->GetPointerType(data_stype, spv::StorageClassInput);
+    Value global_const_index = UIntImm(t_int32_, static_cast<int64_t>(index));
 
-  Value ptr = NewValue(ptr_type, kNormal);
-  ib_.Begin(spv::OpAccessChain)
-      .AddSeq(ptr_type, ptr, global_array, global_const_index)
-      .Commit(&function_scope_vars_);
+    ptr = NewValue(ptr_type, kNormal);
+    ib_.Begin(spv::OpAccessChain)
+        .AddSeq(ptr_type, ptr, global_array, global_const_index)
+        .Commit(&function_scope_vars_);
+  }
 
   Value output = NewValue(data_stype, kNormal);
   ib_.Begin(spv::OpLoad).AddSeq(data_stype, output, ptr).Commit(&function_scope_vars_);
@@ -497,6 +535,15 @@ SType IRBuilder::DeclareType(const DataType& dtype) {
   }
 }
 
+void IRBuilder::AddSubgroupCapability(spv::Capability capability) {
+  ICHECK_GE(spirv_support_.vulkan_api_version, VK_API_VERSION_1_1)
+      << "Vulkan target does not support subgroup operations, "
+      << "which require Vulkan 1.1 or higher";
+  capabilities_used_.insert(spv::CapabilityGroupNonUniform);
+  capabilities_used_.insert(capability);
+  spirv_version_ = std::max(spirv_version_, 0x10300U);
+}
+
 void IRBuilder::AddCapabilityFor(const DataType& dtype) {
   // Declare appropriate capabilities for int/float types
   if (dtype.is_int() || dtype.is_uint()) {
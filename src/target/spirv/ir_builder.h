@@ -568,6 +568,29 @@ class IRBuilder {
    * \return The value representing the local id.
    */
   Value GetLocalID(uint32_t dim_index);
+  /*
+   * \brief Get the index of the invocation in its subgroup.
+   * \return The value representing the subgroup lane, a uint32.
+   */
+  Value GetSubgroupLocalID();
+  /*!
+   * \brief Shuffle a value between the invocations of a subgroup.
+   *
+   *  Requires Vulkan 1.1, the module being then emitted as SPIR-V 1.3.
+   *
+   * \param op The shuffle, one of spv::OpGroupNonUniformShuffle,
+   *  spv::OpGroupNonUniformShuffleDown and spv::OpGroupNonUniformShuffleUp.
+   * \param value The value to shuffle.
+   * \param lane_or_delta The invocation to read from, or the distance to it, a uint32.
+   * \return The value of the other invocation.
+   */
+  Value SubgroupShuffle(spv::Op op, Value value, Value lane_or_delta);
+  /*!
+   * \brief Ballot a predicate over the active invocations of a subgroup.
+   * \param pred The boolean predicate.
+   * \return A uint32 vector of 4 lanes, one bit per invocation whose predicate is true.
+   */
+  Value SubgroupBallot(Value pred);
   // Expressions
   Value Add(Value a, Value b);
   Value Sub(Value a, Value b);
@@ -636,6 +659,10 @@ class IRBuilder {
   // this data type.
   void AddCapabilityFor(const DataType& dtype);
 
+  // Declare a group non-uniform capability, the subgroup operations
+  // requiring SPIR-V 1.3.
+  void AddSubgroupCapability(spv::Capability capability);
+
   /*! \brief SPIRV-related capabilities of the target
    *
    * This SPIRVSupport object is owned by the same CodeGenSPIRV
@@ -705,6 +732,8 @@ class IRBuilder {
   std::set<spv::Capability> capabilities_used_;
   /*! \brief SPIR-V extensions used by this module. */
   std::set<std::string> extensions_used_;
+  /*! \brief The SPIR-V version of the module, raised by the features used. */
+  uint32_t spirv_version_{0x10000};
   /*! \brief entry point segment */
   std::vector<uint32_t> extended_instruction_section_;
   /*! \brief entry point segment */
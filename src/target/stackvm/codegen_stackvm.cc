@@ -23,6 +23,7 @@
 #include "codegen_stackvm.h"
 
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/function.h>
@@ -38,6 +39,8 @@ namespace codegen {
 
 using namespace tir;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.stackvm_superinstructions", Bool);
+
 // map struct field kind to runtime variants
 // We keep two separate enums to ensure runtime/compiler isolation.
 StackVM::StructFieldKind MapFieldKind(int64_t kind) {
@@ -81,6 +84,9 @@ StackVM CodeGenStackVM::Compile(const PrimFunc& f) {
     int vid = AllocVarID(v.get());
     ICHECK_EQ(static_cast<size_t>(vid), i);
   }
+  superinstructions_ = transform::PassContext::Current()
+                           ->GetConfig<Bool>("tir.stackvm_superinstructions", Bool(true))
+                           .value();
   this->Push(f->body);
   vm_.InitCache();
   return std::move(vm_);
@@ -114,6 +120,16 @@ int64_t CodeGenStackVM::PushOp(StackVM::OpCode opcode, int operand) {
   return pc + 1;
 }
 
+void CodeGenStackVM::PushOp(StackVM::OpCode opcode, std::initializer_list<int> operands) {
+  StackVM::Code code;
+  code.op_code = opcode;
+  vm_.code.push_back(code);
+  for (int operand : operands) {
+    code.v_int = operand;
+    vm_.code.push_back(code);
+  }
+}
+
 int CodeGenStackVM::GetStrID(const std::string& key) {
   auto it = str_idmap_.find(key);
   if (it != str_idmap_.end()) return it->second;
@@ -154,8 +170,17 @@ void CodeGenStackVM::VisitExpr_(const LoadNode* op) {
 }
 
 void CodeGenStackVM::VisitStmt_(const StoreNode* op) {
-  this->Push(op->buffer_var);
   StackVM::OpCode code = StackVM::GetStore(op->value.dtype());
+  const IntImmNode* const_index = op->index.as<IntImmNode>();
+  const IntImmNode* const_value = op->value.as<IntImmNode>();
+  if (superinstructions_ && code == StackVM::ARRAY_STORE_INT32 && const_index && const_value) {
+    // e.g. the type codes of a packed call.
+    this->PushOp(StackVM::HEAP_ARRAY_STORE_IMM_INT32,
+                 {GetVarID(op->buffer_var.get()), static_cast<int>(const_index->value),
+                  static_cast<int>(const_value->value)});
+    return;
+  }
+  this->Push(op->buffer_var);
   if (const IntImmNode* index = op->index.as<IntImmNode>()) {
     this->Push(op->value);
     this->PushOp(code, index->value);
@@ -187,9 +212,16 @@ void CodeGenStackVM::VisitExpr_(const CallNode* op) {
   } else if (op->op.same_as(builtin::tvm_struct_get())) {
     ICHECK_EQ(op->args.size(), 3U);
     int kind = op->args[2].as<IntImmNode>()->value;
-    this->Push(op->args[0]);
     const IntImmNode* index = op->args[1].as<IntImmNode>();
     ICHECK(index != nullptr);
+    if (const VarNode* handle = op->args[0].as<VarNode>()) {
+      if (superinstructions_) {
+        this->PushOp(StackVM::HEAP_STRUCT_GET,
+                     {GetVarID(handle), static_cast<int>(index->value), MapFieldKind(kind)});
+        return;
+      }
+    }
+    this->Push(op->args[0]);
     StackVM::Code code;
     code.op_code = StackVM::TVM_STRUCT_GET;
     vm_.code.push_back(code);
@@ -201,8 +233,13 @@ void CodeGenStackVM::VisitExpr_(const CallNode* op) {
     ICHECK_GE(op->args.size(), 5U);
     const StringImmNode* s = op->args[0].as<StringImmNode>();
     ICHECK(s != nullptr) << "tvm_call_global expect first argument as function name";
-    this->Push(op->args[1]);
-    this->Push(op->args[2]);
+    const VarNode* value_stack = op->args[1].as<VarNode>();
+    const VarNode* tcode_stack = op->args[2].as<VarNode>();
+    bool from_heap = superinstructions_ && value_stack && tcode_stack;
+    if (!from_heap) {
+      this->Push(op->args[1]);
+      this->Push(op->args[2]);
+    }
     int begin = op->args[3].as<IntImmNode>()->value;
     int end = op->args[4].as<IntImmNode>()->value;
     // find the fuction id.
@@ -216,6 +253,11 @@ void CodeGenStackVM::VisitExpr_(const CallNode* op) {
       vm_.extern_func_name.push_back(func_name);
       extern_fun_idmap_[func_name] = fid;
     }
+    if (from_heap) {
+      this->PushOp(StackVM::HEAP_CALL_PACKED_LOWERED,
+                   {fid, begin, end, GetVarID(value_stack), GetVarID(tcode_stack)});
+      return;
+    }
     // CALL_PACKED_FUNC
     StackVM::Code code;
     code.op_code = StackVM::CALL_PACKED_LOWERED;
@@ -432,10 +474,19 @@ void CodeGenStackVM::VisitStmt_(const EvaluateNode* ev) {
   const CallNode* op = ev->value.as<CallNode>();
   if (op && op->op.same_as(builtin::tvm_struct_set())) {
     ICHECK_EQ(op->args.size(), 4U);
-    this->Push(op->args[0]);
-    this->Push(op->args[3]);
     const IntImmNode* index = op->args[1].as<IntImmNode>();
     ICHECK(index != nullptr);
+    const VarNode* handle = op->args[0].as<VarNode>();
+    if (superinstructions_ && handle) {
+      // The handle is read from the heap after the value is computed.
+      this->Push(op->args[3]);
+      this->PushOp(StackVM::HEAP_STRUCT_SET,
+                   {GetVarID(handle), static_cast<int>(index->value),
+                    MapFieldKind(op->args[2].as<IntImmNode>()->value)});
+      return;
+    }
+    this->Push(op->args[0]);
+    this->Push(op->args[3]);
     StackVM::Code code;
     code.op_code = StackVM::TVM_STRUCT_SET;
     vm_.code.push_back(code);
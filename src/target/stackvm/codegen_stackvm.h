@@ -30,6 +30,7 @@
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <initializer_list>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -74,6 +75,12 @@ class CodeGenStackVM : public ExprFunctor<void(const PrimExpr&)>,
    * \return operand_index, indicating location of operand
    */
   int64_t PushOp(StackVM::OpCode opcode, int operand);
+  /*!
+   * \brief Push the opcode and several operands to the code.
+   * \param opcode The opcode.
+   * \param operands The operands to be pushed.
+   */
+  void PushOp(StackVM::OpCode opcode, std::initializer_list<int> operands);
   /*!
    * \brief Set the relative jump offset to be offset.
    * \param operand_index The indexed returned by PushOp.
@@ -146,6 +153,8 @@ class CodeGenStackVM : public ExprFunctor<void(const PrimExpr&)>,
 
  private:
   bool debug_{false};
+  /*! \brief Whether to emit the superinstructions reading their handles from the heap. */
+  bool superinstructions_{true};
   /*! \brief The vm to be generated */
   StackVM vm_;
   /*! \brief id of each variable */
@@ -325,4 +325,17 @@ TVM_REGISTER_CUDA_TAG("nvidia/jetson-tx1", "sm_53", 49152, 32768);
 TVM_REGISTER_CUDA_TAG("nvidia/tegra-x1", "sm_53", 49152, 32768);
 
 #undef TVM_REGISTER_CUDA_TAG
+
+#define TVM_REGISTER_WASM_TAG(Name, ...)                  \
+  TVM_REGISTER_TARGET_TAG(Name).set_config({              \
+      {"kind", String("llvm")},                           \
+      {"mtriple", String("wasm32-unknown-unknown-wasm")}, \
+      {"mattr", Array<String>{__VA_ARGS__}},              \
+  });
+
+TVM_REGISTER_WASM_TAG("webassembly/simd128", "+simd128");
+// The objects linked into a multi-threaded wasm runtime need the atomics and bulk memory
+TVM_REGISTER_WASM_TAG("webassembly/simd128-threads", "+simd128", "+atomics", "+bulk-memory");
+
+#undef TVM_REGISTER_WASM_TAG
 }  // namespace tvm
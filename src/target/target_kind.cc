@@ -299,6 +299,20 @@ TVM_REGISTER_TARGET_KIND("llvm", kDLCPU)
     .add_attr_option<String>("runtime")
     .add_attr_option<Bool>("link-params", Bool(false))
     .add_attr_option<Bool>("unpacked-api")
+    .add_attr_option<String>("executor")
+    .add_attr_option<Integer>("workspace-byte-alignment")
+    .add_attr_option<Integer>("opt-level")
+    .add_attr_option<Bool>("loop-vectorize")
+    .add_attr_option<Bool>("slp-vectorize")
+    .add_attr_option<Bool>("loop-unroll")
+    .add_attr_option<Bool>("loop-interleave")
+    .add_attr_option<Bool>("loop-interchange")
+    .add_attr_option<Integer>("vectorize-width")
+    .add_attr_option<Integer>("interleave-count")
+    .add_attr_option<Integer>("unroll-count")
+    .add_attr_option<Integer>("l1-cache-size")
+    .add_attr_option<Integer>("l2-cache-size")
+    .add_attr_option<String>("jit")
     .set_default_keys({"cpu"});
 
 TVM_REGISTER_TARGET_KIND("c", kDLCPU)
@@ -310,6 +324,7 @@ TVM_REGISTER_TARGET_KIND("c", kDLCPU)
     .add_attr_option<String>("executor")
     .add_attr_option<Integer>("workspace-byte-alignment")
     .add_attr_option<Bool>("unpacked-api")
+    .add_attr_option<Array<String>>("includes")
     .set_default_keys({"cpu"});
 
 TVM_REGISTER_TARGET_KIND("cuda", kDLCUDA)
@@ -52,9 +52,13 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "ad_utils.h"
 
@@ -841,6 +845,96 @@ std::pair<PrimExpr, PrimExpr> ImplicationNotContainingVars(
   }
 }
 
+// The systems of inequalities solved, with their variables renamed to canonical ones so that the
+// systems of the different tensors of the same shape share their solutions. The system of every
+// (in)equality between the indices of a conv, dense or pooling is solved again for each adjoint
+// otherwise, and Fourier-Motzkin elimination is the most expensive step of the simplification.
+class InequalitiesSolutionCache {
+ public:
+  arith::PartialSolvedInequalities Solve(const arith::IntConstraints& system) {
+    // Rename the variables in the order they appear in, the ranges only bound the variables.
+    Map<Var, PrimExpr> to_canonical;
+    Map<Var, PrimExpr> from_canonical;
+    std::unordered_map<DataType, int> num_vars;
+    auto rename = [&](const Var& var) {
+      if (to_canonical.count(var)) return;
+      Var canonical = CanonicalVar(var->dtype, num_vars[var->dtype]++);
+      to_canonical.Set(var, canonical);
+      from_canonical.Set(canonical, var);
+    };
+    for (const Var& var : system->variables) {
+      rename(var);
+    }
+    for (const PrimExpr& relation : system->relations) {
+      PostOrderVisit(relation, [&](const ObjectRef& node) {
+        if (const VarNode* var = node.as<VarNode>()) rename(GetRef<Var>(var));
+      });
+    }
+    Array<Var> variables;
+    for (const Var& var : system->variables) {
+      variables.push_back(Downcast<Var>(to_canonical[var]));
+    }
+    Map<Var, Range> ranges;
+    for (const auto& kv : system->ranges) {
+      if (!to_canonical.count(kv.first)) continue;
+      ranges.Set(Downcast<Var>(to_canonical[kv.first]),
+                 Range::FromMinExtent(Substitute(kv.second->min, to_canonical),
+                                      Substitute(kv.second->extent, to_canonical)));
+    }
+    Array<PrimExpr> relations;
+    for (const PrimExpr& relation : system->relations) {
+      relations.push_back(Substitute(relation, to_canonical));
+    }
+    arith::IntConstraints canonical_system(variables, ranges, relations);
+
+    auto it = solutions_.find(canonical_system);
+    if (it == solutions_.end()) {
+      if (solutions_.size() >= kMaxSolutions) {
+        solutions_.clear();
+      }
+      it = solutions_.emplace(canonical_system, arith::SolveLinearInequalities(canonical_system))
+               .first;
+    }
+
+    Map<Var, arith::IntGroupBounds> bounds;
+    for (const auto& kv : it->second.first) {
+      bounds.Set(Downcast<Var>(from_canonical[kv.first]), kv.second.Substitute(from_canonical));
+    }
+    Array<PrimExpr> other_conditions;
+    for (const PrimExpr& cond : it->second.second) {
+      other_conditions.push_back(Substitute(cond, from_canonical));
+    }
+    return {bounds, other_conditions};
+  }
+
+  static InequalitiesSolutionCache* ThreadLocal() {
+    static thread_local InequalitiesSolutionCache inst;
+    return &inst;
+  }
+
+ private:
+  /*! \brief The canonical variable of the given index and dtype, shared by all the systems. */
+  Var CanonicalVar(DataType dtype, int index) {
+    std::vector<Var>& vars = canonical_vars_[dtype];
+    while (static_cast<int>(vars.size()) <= index) {
+      vars.push_back(Var("v" + std::to_string(vars.size()), dtype));
+    }
+    return vars[index];
+  }
+
+  /*! \brief The most solutions kept, the cache is reset past it. */
+  static constexpr size_t kMaxSolutions = 4096;
+
+  std::unordered_map<DataType, std::vector<Var>> canonical_vars_;
+  std::unordered_map<arith::IntConstraints, arith::PartialSolvedInequalities, StructuralHash,
+                     StructuralEqual>
+      solutions_;
+};
+
+// The most atomic formulas Fourier-Motzkin elimination is applied to, the number of inequalities
+// it generates being quadratic in them for every variable eliminated.
+constexpr size_t kMaxAtomicsToEliminate = 64;
+
 // Factor conditions out of a reduction by applying Fourier-Motzkin elimination and moving out
 // (in)equalities which do not depend on the reduction variables.
 std::pair<PrimExpr, PrimExpr> LiftConditionsThroughReduction(const PrimExpr& cond,
@@ -859,19 +953,27 @@ std::pair<PrimExpr, PrimExpr> LiftConditionsThroughReduction(const PrimExpr& con
     allvars.push_back(v->var);
   }
 
-  auto vranges = Merge(IterVarsToMap(red_axis), IterVarsToMap(outer_axis));
-  // start from reduction vars, so that input vars don't depend on them
-  arith::IntConstraints ineq_to_solve(allvars, vranges, atomics);
-  auto res_ineq = arith::SolveLinearInequalities(ineq_to_solve);
-  atomics = arith::AsConditions(allvars, res_ineq.first, res_ineq.second);
-
-  // Append the rest part
-  PrimExpr rewritten_cond = All(atomics) && rest;
-
   std::unordered_set<const VarNode*> vset;
   for (const IterVar& v : red_axis) {
     vset.insert(v->var.get());
   }
+  auto use_red_var = [&vset](const PrimExpr& atomic) {
+    return tir::ExprUseVar(atomic, [&vset](const VarNode* var) { return vset.count(var); });
+  };
+
+  // Bail out when no atomic formula constrains the reduction vars, there is nothing to eliminate,
+  // or when there are too many of them for the elimination to finish in a reasonable time.
+  if (std::any_of(atomics.begin(), atomics.end(), use_red_var) &&
+      atomics.size() <= kMaxAtomicsToEliminate) {
+    auto vranges = Merge(IterVarsToMap(red_axis), IterVarsToMap(outer_axis));
+    // start from reduction vars, so that input vars don't depend on them
+    arith::IntConstraints ineq_to_solve(allvars, vranges, atomics);
+    auto res_ineq = InequalitiesSolutionCache::ThreadLocal()->Solve(ineq_to_solve);
+    atomics = arith::AsConditions(allvars, res_ineq.first, res_ineq.second);
+  }
+
+  // Append the rest part
+  PrimExpr rewritten_cond = All(atomics) && rest;
 
   // The outer (first) condition does not contain reduction vars,
   // the inner (second) condition is everything else
@@ -998,6 +1100,10 @@ inline PrimExpr RemoveRedundantInequalities(const PrimExpr& expr, const Array<Pr
 // extracted tensor will be less than the volume of the outer_axis
 PrimExpr TrySimplifyCompute(const PrimExpr& expr, const PrimExpr& cond,
                             const Array<Var>& outer_axis, const Map<Var, Range>& vranges) {
+  // Without a condition the domain stays the same, and the expression is kept.
+  if (is_one(cond)) {
+    return expr;
+  }
   // solve cond, e.g., (jac_i0 == i) && (jac_i1 == j)
   arith::IntConstraints domain_to_solve(outer_axis, vranges,
                                         FactorOutAtomicFormulas(cond).to_array());
@@ -118,6 +118,24 @@ TVM_DLL Tensor InlineTailTensorAccess(const Tensor& tensor);
 TVM_DLL arith::IntConstraintsTransform SimplifyDomain(const arith::IntConstraints& iter_domains,
                                                       bool eliminate_div_mod = true);
 
+/*!
+ * \brief Differentiate an expression with respect to an element of a tensor.
+ * \param expr The expression to differentiate.
+ * \param input The tensor.
+ * \param indices The indices of the element.
+ * \return The derivative.
+ */
+TVM_DLL PrimExpr Jacobian(const PrimExpr& expr, const Tensor& input,
+                          const Array<PrimExpr>& indices);
+
+/*!
+ * \brief Check whether a combiner is a sum, i.e. adds its operands and starts from zero.
+ * \param combiner The combiner.
+ * \param vranges Map from the free variables to their value ranges.
+ * \return Whether the combiner is a sum.
+ */
+TVM_DLL bool IsSumCombiner(const CommReducer& combiner, const Map<Var, Range>& vranges);
+
 /*!
  * \brief Perform lifting of conditions of being possible to be non-zero together with
  *  applying some transformations like simplifying the reduction domain. Works only with
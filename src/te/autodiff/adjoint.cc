@@ -30,13 +30,17 @@
  *        (3) and sum them together to get the adjoint of the input itself.
  *        The three steps are computed recursively.
  */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/te/autodiff.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/topi/elemwise.h>
 #include <tvm/topi/transform.h>
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 #include "ad_utils.h"
@@ -61,6 +65,132 @@ Tensor Identity(const Tensor& output) {
   return te::compute(shape, func, "identity");
 }
 
+/*!
+ * \brief Compute the vector-Jacobian product without the Jacobian tensor, by transposing the
+ *  accesses to the input: the gradient of the elementwise, broadcast, dense, conv or pooling
+ *  compute is then the transposed compute reading the head, e.g. a transposed conv.
+ *
+ *  It applies to the computes which are either a sum or have no reduction, and read the input at
+ *  the same indices everywhere. Each of these indices has to be `w + base`, where `w` is an axis
+ *  of the compute, output or reduction, only read there; the adjoint at `p` sums the head over the
+ *  other axes, with `w = p - base` in the range of `w`.
+ *
+ * \return The product, undefined if the compute does not match.
+ */
+Tensor DirectVectorJacobianProduct(const Tensor& output, const Tensor& input, const Tensor& head) {
+  const ComputeOpNode* op = output->op.as<ComputeOpNode>();
+  if (op == nullptr || op->body.size() != 1) return Tensor();
+
+  PrimExpr source = op->body[0];
+  PrimExpr condition = const_true();
+  Array<IterVar> all_axis = op->axis;
+  if (const ReduceNode* red = source.as<ReduceNode>()) {
+    if (!red->init.empty() || red->source.size() != 1 || !IsSumCombiner(red->combiner, {})) {
+      return Tensor();
+    }
+    source = red->source[0];
+    condition = red->condition;
+    for (const IterVar& iv : red->axis) {
+      all_axis.push_back(iv);
+    }
+  }
+
+  // The indices the input is read at, the same at every read.
+  Optional<Array<PrimExpr>> indices;
+  bool matched = true;
+  PostOrderVisit(source, [&](const ObjectRef& node) {
+    if (node->IsInstance<ReduceNode>()) {
+      matched = false;
+    } else if (const ProducerLoadNode* load = node.as<ProducerLoadNode>()) {
+      if (!load->producer.same_as(input)) return;
+      if (!indices) {
+        indices = load->indices;
+      } else if (!StructuralEqual()(indices.value(), load->indices)) {
+        matched = false;
+      }
+    }
+  });
+  PostOrderVisit(condition, [&](const ObjectRef& node) {
+    if (const ProducerLoadNode* load = node.as<ProducerLoadNode>()) {
+      if (load->producer.same_as(input)) matched = false;
+    }
+  });
+  if (!matched || !indices) return Tensor();
+
+  // Solve each index for an axis only read there, the one of the largest extent so that the
+  // remaining sum is the shortest, e.g. for the output rows rather than the kernel rows of a conv.
+  std::vector<int> solved_axis;
+  std::vector<PrimExpr> bases;
+  std::unordered_set<int> solved_set;
+  for (size_t j = 0; j < indices.value().size(); ++j) {
+    int best = -1;
+    int64_t best_extent = -1;
+    PrimExpr best_base;
+    for (size_t i = 0; i < all_axis.size(); ++i) {
+      const Var& var = all_axis[i]->var;
+      if (solved_set.count(i) || !tir::ExprUseVar(indices.value()[j], var)) continue;
+      bool read_elsewhere = false;
+      for (size_t k = 0; k < indices.value().size(); ++k) {
+        if (k != j && tir::ExprUseVar(indices.value()[k], var)) read_elsewhere = true;
+      }
+      if (read_elsewhere) continue;
+      Array<PrimExpr> coeffs = arith::DetectLinearEquation(indices.value()[j], {var});
+      if (coeffs.size() != 2 || !is_one(coeffs[0])) continue;
+      const int64_t* extent = tir::as_const_int(all_axis[i]->dom->extent);
+      int64_t extent_value = extent ? *extent : 0;
+      if (extent_value > best_extent) {
+        best = static_cast<int>(i);
+        best_extent = extent_value;
+        best_base = coeffs[1];
+      }
+    }
+    if (best < 0) return Tensor();
+    solved_axis.push_back(best);
+    bases.push_back(best_base);
+    solved_set.insert(best);
+  }
+
+  arith::Analyzer analyzer;
+  PrimExpr derivative = analyzer.Simplify(Jacobian(source, input, indices.value()));
+
+  size_t num_head_dims = head->shape.size() - output->shape.size();
+  Array<PrimExpr> shape(head->shape.begin(), head->shape.begin() + num_head_dims);
+  for (const PrimExpr& e : input->shape) {
+    shape.push_back(e);
+  }
+  auto func = [&](const Array<Var>& vars) -> PrimExpr {
+    // The axes not solved for are summed over.
+    Map<Var, PrimExpr> vmap;
+    Array<IterVar> sum_axis;
+    for (size_t i = 0; i < all_axis.size(); ++i) {
+      if (solved_set.count(i)) continue;
+      IterVar iv = reduce_axis(all_axis[i]->dom, all_axis[i]->var->name_hint);
+      vmap.Set(all_axis[i]->var, iv->var);
+      sum_axis.push_back(iv);
+    }
+    PrimExpr cond = const_true();
+    for (size_t j = 0; j < solved_axis.size(); ++j) {
+      const IterVar& iv = all_axis[solved_axis[j]];
+      PrimExpr value = vars[num_head_dims + j] - Substitute(bases[j], vmap);
+      cond = cond && value >= iv->dom->min && value < iv->dom->min + iv->dom->extent;
+      vmap.Set(iv->var, value);
+    }
+    cond = analyzer.Simplify(cond && Substitute(condition, vmap));
+
+    Array<PrimExpr> head_indices(vars.begin(), vars.begin() + num_head_dims);
+    for (const IterVar& iv : op->axis) {
+      head_indices.push_back(vmap[iv->var]);
+    }
+    PrimExpr value = head(head_indices) * Substitute(derivative, vmap);
+    if (sum_axis.empty()) {
+      return Select(cond, value, make_zero(value.dtype()));
+    }
+    const ReduceNode* sum_red = sum(value, sum_axis).as<ReduceNode>();
+    return Reduce(sum_red->combiner, sum_red->source, sum_red->axis, cond, 0, {});
+  };
+  return te::compute(shape, func, output->op->name + "." + input->op->name + ".grad");
+}
+
 Tensor VectorJacobianProduct(const Tensor& output, const Tensor& input, const Tensor& head) {
   Tensor jac = Jacobian(output, input);
   Tensor result = topi::tensordot(head, jac, /*axes=*/output->shape.size(),
@@ -100,8 +230,10 @@ Array<Tensor> Gradient(const Tensor& output, const Array<Tensor>& inputs,
   // This is a recursive function that does all the work. It computes the adjoint for a given
   // tensor, adds it to the map, and returns it
   std::function<Tensor(const Tensor&)> compute_adjoint;
-  compute_adjoint = [&compute_adjoint, &adjoints, &reverse_dependencies, &head,
-                     &output](const Tensor& tensor) {
+  // With the identity head the adjoints are Jacobians, simplified better by the generic products.
+  bool direct = head_or_null.get() != nullptr;
+  compute_adjoint = [&compute_adjoint, &adjoints, &reverse_dependencies, &head, &output,
+                     direct](const Tensor& tensor) {
     if (!adjoints.count(tensor)) {
       // Here the adjoint hasn't been computed yet
       Tensor res_adjoint;
@@ -121,8 +253,14 @@ Array<Tensor> Gradient(const Tensor& output, const Array<Tensor>& inputs,
         // and the multiplication is done in the function VectorJacobianProduct
         for (const Tensor& direct_consumer : direct_consumers) {
           // part = (adjoint of direct_consumer) * Jacobian(direct_consumer, tensor)
-          Tensor part =
-              VectorJacobianProduct(direct_consumer, tensor, compute_adjoint(direct_consumer));
+          Tensor consumer_adjoint = compute_adjoint(direct_consumer);
+          Tensor part;
+          if (direct) {
+            part = DirectVectorJacobianProduct(direct_consumer, tensor, consumer_adjoint);
+          }
+          if (!part.get()) {
+            part = VectorJacobianProduct(direct_consumer, tensor, consumer_adjoint);
+          }
           res_adjoint = res_adjoint.get() ? topi::add(res_adjoint, part) : part;
         }
       }
@@ -118,6 +118,24 @@ Map<Var, Range> LoopDomainOfSRefTreePath(const StmtSRef& low_inclusive,
  * \return The block var binding
  */
 Map<Var, PrimExpr> GetBindings(const BlockRealize& realize);
+/*!
+ * \brief Returns the BlockRealize of a block
+ * \param block_sref The block to be looked up
+ * \return The BlockRealize whose block is the given block
+ */
+BlockRealize GetBlockRealize(const StmtSRef& block_sref);
+
+/******** Region ********/
+/*!
+ * \brief Relaxes a buffer region accessed by a block over the loops between the block and an
+ * ancestor, and clamps the result to the shape of the buffer
+ * \param block_sref The block that accesses the region
+ * \param high_exclusive The ancestor where the relaxation stops, whose loop is not relaxed
+ * \param region The buffer region, in the block vars of the block
+ * \return The relaxed region, one integer set per dimension of the buffer
+ */
+Array<arith::IntSet> RelaxBufferRegion(const StmtSRef& block_sref, const StmtSRef& high_exclusive,
+                                       const BufferRegion& region);
 
 /******** Block-loop relation ********/
 /*!
@@ -142,6 +160,15 @@ Array<StmtSRef> GetLoops(const StmtSRef& block_sref);
  * \return A list of leaf blocks
  */
 Array<StmtSRef> GetChildBlocks(const ScheduleState& self, const StmtSRef& parent_sref);
+/*!
+ * \brief Gets the position of the statement that contains a block/loop in the body of its scope
+ * root
+ * \param sref The block/loop to be looked up
+ * \param scope_root_sref The scope root of the block/loop
+ * \return The index of the statement in the SeqStmt body of the scope root, or 0 if the body is
+ * not a SeqStmt
+ */
+int GetTopLevelPosition(const StmtSRef& sref, const StmtSRef& scope_root_sref);
 
 }  // namespace tir
 }  // namespace tvm
@@ -229,6 +229,54 @@ Map<Var, PrimExpr> GetBindings(const BlockRealize& realize) {
   return result;
 }
 
+BlockRealize GetBlockRealize(const StmtSRef& block_sref) {
+  const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+  const BlockRealizeNode* result = nullptr;
+  // The BlockRealize is a child of the parent stmt, possibly under a SeqStmt
+  PreOrderVisit(GetRef<Stmt>(block_sref->parent->stmt), [&](const ObjectRef& node) {
+    if (result != nullptr) {
+      return false;
+    }
+    if (const auto* realize = node.as<BlockRealizeNode>()) {
+      if (realize->block.get() == block) {
+        result = realize;
+      }
+      return false;
+    }
+    return true;
+  });
+  ICHECK(result != nullptr) << "InternalError: Cannot find the BlockRealize of the block:\n"
+                            << GetRef<Block>(block);
+  return GetRef<BlockRealize>(result);
+}
+
+/******** Region ********/
+
+Array<arith::IntSet> RelaxBufferRegion(const StmtSRef& block_sref, const StmtSRef& high_exclusive,
+                                       const BufferRegion& region) {
+  Map<Var, PrimExpr> binding = GetBindings(GetBlockRealize(block_sref));
+  Map<Var, arith::IntSet> dom;
+  if (block_sref->parent != high_exclusive.get()) {
+    dom = AsIntSet(LoopDomainOfSRefTreePath(GetRef<StmtSRef>(block_sref->parent), high_exclusive));
+  }
+  Array<Range> bound_region;
+  bound_region.reserve(region->region.size());
+  for (const Range& range : region->region) {
+    bound_region.push_back(
+        Range::FromMinExtent(Substitute(range->min, binding), Substitute(range->extent, binding)));
+  }
+  Array<arith::IntSet> relaxed = arith::EvalSet(bound_region, dom);
+  const Array<PrimExpr>& shape = region->buffer->shape;
+  Array<arith::IntSet> result;
+  result.reserve(relaxed.size());
+  for (size_t i = 0; i < relaxed.size(); ++i) {
+    arith::IntSet full =
+        arith::IntSet::FromRange(Range::FromMinExtent(make_zero(shape[i].dtype()), shape[i]));
+    result.push_back(arith::Intersect({relaxed[i], full}));
+  }
+  return result;
+}
+
 /******** Block-loop relation ********/
 
 Array<StmtSRef> GetBlocks(const ScheduleState& self, const String& name, const String& func_name) {
@@ -298,5 +346,13 @@ Array<StmtSRef> GetChildBlocks(const ScheduleState& self, const StmtSRef& parent
   throw;
 }
 
+int GetTopLevelPosition(const StmtSRef& sref, const StmtSRef& scope_root_sref) {
+  const StmtSRefNode* p = sref.get();
+  for (; p->parent != scope_root_sref.get(); p = p->parent) {
+    ICHECK(p->parent != nullptr) << "InternalError: The sref is not under the scope root";
+  }
+  return std::max<int64_t>(p->seq_index, 0);
+}
+
 }  // namespace tir
 }  // namespace tvm
@@ -59,6 +59,7 @@ class ConcreteScheduleNode : public ScheduleNode {
 
  public:
   ScheduleState state() const final { return state_; }
+  Optional<Trace> trace() const override { return NullOpt; }
   Schedule Copy() const override;
 
  public:
@@ -78,11 +79,24 @@ class ConcreteScheduleNode : public ScheduleNode {
   BlockRV GetBlock(const String& name, const String& func_name = "main") override;
   Array<LoopRV> GetLoops(const BlockRV& block_rv) override;
   /******** Schedule: loops manipulation ********/
+  Array<LoopRV> Split(const LoopRV& loop_rv, const Array<Optional<ExprRV>>& factors) override;
+  LoopRV Fuse(const Array<LoopRV>& loop_rvs) override;
+  void Reorder(const Array<LoopRV>& ordered_loop_rvs) override;
   /******** Schedule: compute location ********/
+  void ComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) override;
+  void ReverseComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) override;
   void ComputeInline(const BlockRV& block) override;
   void ReverseComputeInline(const BlockRV& block) override;
   /******** Schedule: loop binding/annotation ********/
+  void Parallel(const LoopRV& loop_rv) override;
+  void Vectorize(const LoopRV& loop_rv) override;
+  void Bind(const LoopRV& loop_rv, const String& thread_axis) override;
+  void Unroll(const LoopRV& loop_rv) override;
   /******** Schedule: cache read/write ********/
+  BlockRV CacheRead(const BlockRV& block_rv, int read_buffer_index,
+                    const String& storage_scope) override;
+  BlockRV CacheWrite(const BlockRV& block_rv, int write_buffer_index,
+                     const String& storage_scope) override;
   /******** Schedule: reduction ********/
   /******** Schedule: blockize & tensorize ********/
 
@@ -94,6 +108,12 @@ class ConcreteScheduleNode : public ScheduleNode {
    * \param new_symbol_table The symbol table copied
    */
   void Copy(ScheduleState* new_state, TSymbolTable* new_symbol_table) const;
+  /*!
+   * \brief Get the srefs corresponding to a list of LoopRVs
+   * \param loop_rvs The LoopRVs to be looked up
+   * \return The corresponding loop srefs
+   */
+  inline Array<StmtSRef> GetSRefs(const Array<LoopRV>& loop_rvs) const;
   /*!
    * \brief Add srefs as random variables into the symbol table
    * \tparam T The type of the random variables
@@ -143,17 +163,22 @@ inline For ConcreteScheduleNode::Get(const LoopRV& loop_rv) const {
 }
 
 inline PrimExpr ConcreteScheduleNode::Get(const ExprRV& expr_rv) const {
-  auto it = this->symbol_table_.find(expr_rv);
-  if (it == this->symbol_table_.end()) {
-    LOG(FATAL) << "IndexError: Cannot find corresponding ExprRV: " << expr_rv;
-  }
-  const ObjectRef& obj = (*it).second;
-  const auto* expr_node = obj.as<PrimExprNode>();
-  if (expr_node == nullptr) {
-    LOG(FATAL) << "ValueError: ExprRV's corresponding type is invalid: "
-               << (obj.defined() ? obj->GetTypeKey() : "None");
-  }
-  return GetRef<PrimExpr>(expr_node);
+  // An ExprRV is an expression of the Vars in the symbol table, e.g. a constant split factor, or
+  // a factor computed from the random variables
+  PrimExpr transformed = Substitute(expr_rv, [this](const Var& var) -> Optional<PrimExpr> {
+    auto it = this->symbol_table_.find(var);
+    if (it == this->symbol_table_.end()) {
+      LOG(FATAL) << "IndexError: Cannot find corresponding ExprRV: " << var;
+    }
+    const ObjectRef& obj = (*it).second;
+    const auto* expr_node = obj.as<PrimExprNode>();
+    if (expr_node == nullptr) {
+      LOG(FATAL) << "ValueError: ExprRV's corresponding type is invalid: "
+                 << (obj.defined() ? obj->GetTypeKey() : "None");
+    }
+    return GetRef<PrimExpr>(expr_node);
+  });
+  return this->analyzer_->Simplify(transformed);
 }
 
 inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
@@ -198,6 +223,15 @@ inline StmtSRef ConcreteScheduleNode::GetSRef(const LoopRV& loop_rv) const {
   return GetRef<StmtSRef>(sref);
 }
 
+inline Array<StmtSRef> ConcreteScheduleNode::GetSRefs(const Array<LoopRV>& loop_rvs) const {
+  Array<StmtSRef> result;
+  result.reserve(loop_rvs.size());
+  for (const LoopRV& loop_rv : loop_rvs) {
+    result.push_back(this->GetSRef(loop_rv));
+  }
+  return result;
+}
+
 /******** Adding/Removing elements in the symbol table ********/
 
 template <class T>
@@ -220,7 +254,7 @@ inline T ConcreteScheduleNode::CreateRV(const StmtSRef& sref) {
 }
 
 inline ExprRV ConcreteScheduleNode::CreateRV(const PrimExpr& expr) {
-  ExprRV rv;
+  Var rv("v", expr.dtype());
   this->symbol_table_.Set(rv, expr);
   return std::move(rv);
 }
@@ -229,9 +263,7 @@ inline Array<ExprRV> ConcreteScheduleNode::CreateRV(const Array<PrimExpr>& exprs
   Array<ExprRV> result;
   result.reserve(exprs.size());
   for (const PrimExpr& expr : exprs) {
-    ExprRV rv;
-    this->symbol_table_.Set(rv, expr);
-    result.push_back(rv);
+    result.push_back(CreateRV(expr));
   }
   return result;
 }
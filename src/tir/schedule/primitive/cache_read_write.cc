@@ -0,0 +1,560 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace tir {
+
+/******** Error Classes ********/
+
+class NotSingleWriteBlock : public ScheduleError {
+ public:
+  explicit NotSingleWriteBlock(IRModule mod, Buffer buffer, Array<StmtSRef> write_blocks)
+      : mod_(std::move(mod)), buffer_(std::move(buffer)) {
+    ICHECK_GT(write_blocks.size(), 1);
+    write_blocks_.reserve(write_blocks.size());
+    for (const StmtSRef& block_sref : write_blocks) {
+      const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+      write_blocks_.push_back(GetRef<Block>(block));
+    }
+  }
+
+  String FastErrorString() const final {
+    return "ScheduleError: The buffer is allowed to be written by single block.";
+  }
+
+  String DetailRenderTemplate() const final {
+    size_t k = write_blocks_.size();
+    return "The buffer " + buffer_->name + " is expected to be written by single block, but got " +
+           std::to_string(k) + " blocks who write it.";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final {
+    return {write_blocks_.begin(), write_blocks_.end()};
+  }
+
+ private:
+  IRModule mod_;
+  Buffer buffer_;
+  Array<Block> write_blocks_;
+};
+
+class BufferIndexOutOfRangeError : public ScheduleError {
+ public:
+  explicit BufferIndexOutOfRangeError(IRModule mod, Block block, int buffer_index, bool is_write)
+      : mod_(std::move(mod)), block_(std::move(block)), buffer_index_(buffer_index) {
+    num_buffers_ = is_write ? block_->writes.size() : block_->reads.size();
+    kind_ = is_write ? "write" : "read";
+  }
+
+  String FastErrorString() const final {
+    return "ScheduleError: The input buffer index is out of range of the block's buffers";
+  }
+
+  String DetailRenderTemplate() const final {
+    std::ostringstream os;
+    os << "The block {0} has " << num_buffers_ << " " << kind_
+       << " regions, so `buffer_index` is required to be in [0, " << num_buffers_
+       << "). However, the input `buffer_index` is " << buffer_index_
+       << ", which is out of the expected range";
+    return os.str();
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  int buffer_index_;
+  size_t num_buffers_;
+  std::string kind_;
+};
+
+class CacheStagePlacementError : public ScheduleError {
+ public:
+  explicit CacheStagePlacementError(IRModule mod, Buffer buffer, Block scope_root)
+      : mod_(std::move(mod)), buffer_(std::move(buffer)), scope_root_(std::move(scope_root)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: The cache stage cannot be placed between the producer and the "
+           "consumers at the scope root";
+  }
+
+  String DetailRenderTemplate() const final {
+    return "The cache stage of the buffer " + buffer_->name +
+           " is placed in the body of the scope root {0}, between the statement that writes " +
+           buffer_->name +
+           " and the statements that read it, but the writer and a reader are under the same "
+           "statement";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {scope_root_}; }
+
+ private:
+  IRModule mod_;
+  Buffer buffer_;
+  Block scope_root_;
+};
+
+/******** Helper Functions/Classes ********/
+
+/*! \brief The auxiliary info used for the insertion point and content of the cache stage. */
+struct CacheStageInfo {
+  /*! \brief The buffer to be read. */
+  Buffer read_buffer;
+  /*! \brief The buffer to be written. */
+  Buffer write_buffer;
+  /*! \brief The buffer allocation to be inserted into the block signature. */
+  Buffer alloc;
+  /*! \brief The position in the body of the scope root to insert the cache stage. */
+  int loc_pos;
+  /*! \brief The cache_read/cache_write stage to be inserted. */
+  Stmt cache_stage;
+  /*! \brief The map used for ScheduleStateNode::Replace. */
+  Map<Block, Block> block_reuse;
+};
+
+/*!
+ * \brief Create a new buffer with the same shape and dtype in another storage scope
+ * \param buffer The buffer to be copied
+ * \param storage_scope The storage scope of the new buffer
+ * \return The new buffer, named after its scope
+ */
+Buffer WithScope(const Buffer& buffer, const String& storage_scope) {
+  ObjectPtr<BufferNode> new_buffer = make_object<BufferNode>(*buffer.get());
+  String name = buffer->name + "_" + storage_scope;
+  // The storage scope is carried by the buffer, which FlattenBuffer annotates the allocation with
+  new_buffer->data = Var(name, buffer->data->type_annotation);
+  new_buffer->name = name;
+  new_buffer->scope = storage_scope;
+  return Buffer(new_buffer);
+}
+
+/*!
+ * \brief Replace the buffer of the regions whose buffer is `source` with `target`
+ * \param regions The buffer regions
+ * \param source The buffer to be replaced
+ * \param target The buffer to replace with
+ * \return The regions after replacement
+ */
+Array<BufferRegion> ReplaceBuffer(const Array<BufferRegion>& regions, const Buffer& source,
+                                  const Buffer& target) {
+  Array<BufferRegion> result = regions;
+  result.MutateByApply([&source, &target](const BufferRegion& region) -> BufferRegion {
+    if (region->buffer.same_as(source)) {
+      return BufferRegion(target, region->region);
+    }
+    return region;
+  });
+  return result;
+}
+
+/*!
+ * \brief Create a loop nest that represents cache copy (cache_read / cache_write) from read buffer
+ *        to write buffer.
+ * \note This function will store the stmt with loop nesting to the CacheStageInfo, but only return
+ *        the inside block.
+ * \param cache_region The cached copy region.
+ * \param info The cache stage information, which will be updated in the function.
+ * \param storage_scope The storage scope of the cached buffer (only used in naming here)
+ * \returns A block indicating the body of the loop nesting.
+ */
+Block MakeCacheStage(const Array<Range>& cache_region, CacheStageInfo* info,
+                     const String& storage_scope) {
+  // loop variables
+  std::vector<Var> loop_vars;
+  // bindings in block realize
+  std::vector<PrimExpr> iter_values;
+  // Create loop vars and block vars' binding_value
+  for (const Range& axis : cache_region) {
+    Var loop_var("ax" + std::to_string(loop_vars.size()));
+    loop_vars.push_back(loop_var);
+    iter_values.push_back(axis->min + loop_var);
+  }
+  // block variables
+  Array<IterVar> block_vars;
+  // block access region for read/write buffers
+  Region access_region;
+  // indices used in block body
+  Array<PrimExpr> access_indices;
+  // Create block vars, block's accessed region and accessing indices
+  for (const Range& axis : cache_region) {
+    Var var("v" + std::to_string(access_indices.size()));
+    block_vars.push_back(IterVar(/*dom=*/axis,
+                                 /*var=*/var,
+                                 /*IterVarType=*/kDataPar));
+    access_indices.push_back(var);
+    access_region.push_back(Range::FromMinExtent(var, 1));
+  }
+  // Create the body block:
+  //   reads = [read_buffer[access_region]]
+  //   writes = [write_buffer[access_region]]
+  //     write_buffer[access_indices] = read_buffer[access_indices]
+  Block block(
+      /*iter_vars=*/std::move(block_vars),
+      /*reads=*/{BufferRegion(info->read_buffer, access_region)},
+      /*writes=*/{BufferRegion(info->write_buffer, access_region)},
+      /*name_hint=*/info->alloc->name,
+      /*body=*/
+      BufferStore(info->write_buffer, BufferLoad(info->read_buffer, access_indices),
+                  access_indices),
+      /*init=*/NullOpt,
+      /*alloc_buffers=*/{},
+      /*match_buffers=*/{},
+      /*annotations=*/{});
+  // Create the block realize node
+  Stmt body = BlockRealize(/*values=*/iter_values,
+                           /*predicate=*/const_true(),
+                           /*block=*/block);
+  // Create surrounding loops
+  for (size_t i = loop_vars.size(); i >= 1; --i) {
+    body = For(/*loop_var=*/loop_vars[i - 1],
+               /*min=*/0,
+               /*extent=*/cache_region[i - 1]->extent,
+               /*kind=*/ForKind::kSerial,
+               /*body=*/body);
+  }
+  info->cache_stage = std::move(body);
+  return block;
+}
+
+/*!
+ * \brief Insert the cache_read/cache_write stage into the body of the scope root
+ * \param stmt The body of the scope root
+ * \param pos The position where the cache stage is inserted
+ * \param stage The stage to be inserted
+ * \return A SeqStmt, the result after insertion
+ */
+SeqStmt InsertCacheStage(const Stmt& stmt, int pos, const Stmt& stage) {
+  if (const auto* seq_stmt = stmt.as<SeqStmtNode>()) {
+    ObjectPtr<SeqStmtNode> result = make_object<SeqStmtNode>(*seq_stmt);
+    result->seq.insert(result->seq.begin() + pos, stage);
+    return SeqStmt(result);
+  }
+  if (pos == 0) {
+    return SeqStmt({stage, stmt});
+  }
+  ICHECK_EQ(pos, 1);
+  return SeqStmt({stmt, stage});
+}
+
+/*! \brief Mutator for CacheRead. */
+class CacheReadRewriter : public StmtExprMutator {
+ public:
+  /*!
+   * \brief Rewrite the AST and add a cache_read stage with the information provided
+   * \param scope_sref The parent scope of this mutation
+   * \param info The cache stage information
+   * \return The new AST rooting at the original parent scope
+   */
+  static Stmt Rewrite(const StmtSRef& scope_sref, CacheStageInfo* info) {
+    CacheReadRewriter rewriter(scope_sref, info);
+    return rewriter(GetRef<Stmt>(scope_sref->stmt));
+  }
+
+ private:
+  explicit CacheReadRewriter(const StmtSRef& scope_sref, CacheStageInfo* info)
+      : scope_sref_(scope_sref), info_(info) {}
+
+  Stmt VisitStmt_(const BlockNode* block) final {
+    Block old_stmt = GetRef<Block>(block);
+    Block stmt = Downcast<Block>(StmtMutator::VisitStmt_(block));
+    ObjectPtr<BlockNode> n = make_object<BlockNode>(*stmt.as<BlockNode>());
+    if (block == scope_sref_->stmt) {
+      // Insert the cache stage and its allocation into the scope root
+      n->body = InsertCacheStage(n->body, info_->loc_pos, info_->cache_stage);
+      n->alloc_buffers.push_back(info_->alloc);
+    } else {
+      // Otherwise, update read regions and match_buffers
+      n->reads = ReplaceBuffer(n->reads, info_->read_buffer, info_->write_buffer);
+      n->match_buffers.MutateByApply([this](const MatchBufferRegion& match) -> MatchBufferRegion {
+            const BufferRegion& source = match->source;
+            if (source->buffer.same_as(info_->read_buffer)) {
+              return MatchBufferRegion(match->buffer,
+                                       BufferRegion(info_->write_buffer, source->region));
+            }
+            return match;
+          });
+    }
+    Block new_block(n);
+    info_->block_reuse.Set(old_stmt, new_block);
+    return std::move(new_block);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* load) final {
+    if (load->buffer.same_as(info_->read_buffer)) {
+      ObjectPtr<BufferLoadNode> n = make_object<BufferLoadNode>(*load);
+      n->buffer = info_->write_buffer;
+      n->indices.MutateByApply([this](const PrimExpr& e) { return this->VisitExpr(e); });
+      return PrimExpr(n);
+    }
+    return ExprMutator::VisitExpr_(load);
+  }
+
+  /*! \brief The parent scope of the insertion */
+  const StmtSRef& scope_sref_;
+  /*! \brief The info for inserting cache stage */
+  CacheStageInfo* info_;
+};
+
+/*! \brief Mutator for CacheWrite */
+class CacheWriteRewriter : public StmtExprMutator {
+ public:
+  /*!
+   * \brief Rewrite the AST and add a cache_write stage with the information provided.
+   * \param scope_sref The parent scope of this mutation.
+   * \param writer_block_sref The only writer block in the scope.
+   * \param info The cache stage information.
+   * \return The new AST rooting at the original parent scope.
+   */
+  static Stmt Rewrite(const StmtSRef& scope_sref, const StmtSRef& writer_block_sref,
+                      CacheStageInfo* info) {
+    CacheWriteRewriter rewriter(scope_sref, writer_block_sref, info);
+    return rewriter(GetRef<Stmt>(scope_sref->stmt));
+  }
+
+ private:
+  explicit CacheWriteRewriter(const StmtSRef& scope_sref, const StmtSRef& writer_block_sref,
+                              CacheStageInfo* info)
+      : scope_sref_(scope_sref), writer_block_sref_(writer_block_sref), info_(info) {}
+
+  Stmt VisitStmt_(const BlockNode* block) final {
+    Block old_stmt = GetRef<Block>(block);
+    bool is_writer = block == writer_block_sref_->stmt;
+    bool under_writer = under_writer_;
+    under_writer_ = under_writer_ || is_writer;
+    Block stmt = Downcast<Block>(StmtMutator::VisitStmt_(block));
+    under_writer_ = under_writer;
+    ObjectPtr<BlockNode> n = make_object<BlockNode>(*stmt.as<BlockNode>());
+    if (block == scope_sref_->stmt) {
+      // Insert the cache stage and its allocation into the scope root
+      n->body = InsertCacheStage(n->body, info_->loc_pos, info_->cache_stage);
+      n->alloc_buffers.push_back(info_->alloc);
+    } else if (under_writer_ || is_writer) {
+      // The writer and the blocks under it access the cache instead
+      n->reads = ReplaceBuffer(n->reads, info_->write_buffer, info_->read_buffer);
+      n->writes = ReplaceBuffer(n->writes, info_->write_buffer, info_->read_buffer);
+    } else {
+      return std::move(stmt);
+    }
+    Block new_block(n);
+    info_->block_reuse.Set(old_stmt, new_block);
+    return std::move(new_block);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* store) final {
+    BufferStore stmt = Downcast<BufferStore>(StmtExprMutator::VisitStmt_(store));
+    if (under_writer_ && stmt->buffer.same_as(info_->write_buffer)) {
+      ObjectPtr<BufferStoreNode> n = make_object<BufferStoreNode>(*stmt.get());
+      n->buffer = info_->read_buffer;
+      return Stmt(n);
+    }
+    return std::move(stmt);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* load) final {
+    PrimExpr expr = ExprMutator::VisitExpr_(load);
+    const auto* new_load = expr.as<BufferLoadNode>();
+    if (under_writer_ && new_load->buffer.same_as(info_->write_buffer)) {
+      ObjectPtr<BufferLoadNode> n = make_object<BufferLoadNode>(*new_load);
+      n->buffer = info_->read_buffer;
+      return PrimExpr(n);
+    }
+    return expr;
+  }
+
+  /*! \brief The parent scope of the insertion. */
+  const StmtSRef& scope_sref_;
+  /*! \brief The only writer block in the scope. */
+  const StmtSRef& writer_block_sref_;
+  /*! \brief The info for inserting cache stage. */
+  CacheStageInfo* info_;
+  /*! \brief Whether the mutator is under the writer block. */
+  bool under_writer_{false};
+};
+
+/*!
+ * \brief Set the flags of the new cache stage, which copies a region of its buffer with an
+ * affine binding.
+ */
+void UpdateCacheStageInfo(ScheduleState self, const Block& cache_stage,
+                          const StmtSRef& scope_sref) {
+  StmtSRef result_block_sref = self->stmt2ref.at(cache_stage.get());
+  BlockInfo& block_info = self->block_info[result_block_sref];
+  block_info.affine_binding = true;
+  block_info.region_cover = true;
+  block_info.scope->stage_pipeline = true;
+  self->block_info[scope_sref].scope->stage_pipeline = true;
+}
+
+/******** Implementation ********/
+
+StmtSRef CacheRead(ScheduleState self, const StmtSRef& block_sref, int read_buffer_index,
+                   const String& storage_scope) {
+  /*!
+   * Check:
+   *   - The index is in the array of block reading region
+   *   - There is at most one block who writes the buffer in the scope
+   *
+   * Mutate:
+   *   - Allocate new cache buffer under the current scope.
+   *   - Find the lowest ancestor of the block and ANY ONE of the consumers blocks.
+   *   - Copy the buffer with the consumed region.
+   */
+
+  // Step 1. Check index, getting the target buffer and the parent scope
+  const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+  if (read_buffer_index < 0 || read_buffer_index >= static_cast<int>(block->reads.size())) {
+    throw BufferIndexOutOfRangeError(self->mod, GetRef<Block>(block), read_buffer_index, false);
+  }
+  Buffer read_buffer = block->reads[read_buffer_index]->buffer;
+  StmtSRef scope_sref = GetScopeRootAndCheckStagePipeline(self, block_sref);
+  const BlockNode* scope_block = TVM_SREF_TO_BLOCK(scope_block, scope_sref);
+
+  // Step 2. Creat CacheStageInfo
+  CacheStageInfo info;
+  info.read_buffer = read_buffer;
+  // Create the corresponding buffer to be written, i.e. result of cache_read
+  info.write_buffer = WithScope(read_buffer, storage_scope);
+  // Create the corresponding buffer allocation
+  info.alloc = info.write_buffer;
+
+  // Step 3. The cache stage goes after the statement of the writer, if any, and before the
+  // statements of all the readers, caching the union of their read regions.
+  int writer_pos = -1;
+  BlockScope scope = self->GetBlockScope(scope_sref);
+  auto it = scope->buffer_writers.find(read_buffer);
+  if (it != scope->buffer_writers.end()) {
+    const Array<StmtSRef>& writers = it->second;
+    if (writers.size() > 1) {
+      throw NotSingleWriteBlock(self->mod, read_buffer, writers);
+    }
+    writer_pos = GetTopLevelPosition(writers[0], scope_sref);
+  }
+  int reader_pos = std::numeric_limits<int>::max();
+  std::vector<Array<arith::IntSet>> read_regions;
+  for (const StmtSRef& child_sref : GetChildBlocks(self, scope_sref)) {
+    const BlockNode* child = TVM_SREF_TO_BLOCK(child, child_sref);
+    for (const BufferRegion& region : child->reads) {
+      if (region->buffer.same_as(read_buffer)) {
+        reader_pos = std::min(reader_pos, GetTopLevelPosition(child_sref, scope_sref));
+        read_regions.push_back(RelaxBufferRegion(child_sref, scope_sref, region));
+      }
+    }
+  }
+  if (writer_pos >= reader_pos) {
+    throw CacheStagePlacementError(self->mod, read_buffer, GetRef<Block>(scope_block));
+  }
+  info.loc_pos = writer_pos + 1;
+  Array<Range> cache_region;
+  for (size_t i = 0; i < read_buffer->shape.size(); ++i) {
+    Array<arith::IntSet> sets;
+    for (const Array<arith::IntSet>& region : read_regions) {
+      sets.push_back(region[i]);
+    }
+    Range full = Range::FromMinExtent(0, read_buffer->shape[i]);
+    cache_region.push_back(arith::Union(sets).CoverRange(full));
+  }
+
+  // Step 4. Making new cache stage block and rewrite readers.
+  Block cache_read_stage = MakeCacheStage(/*cache_region=*/cache_region, /*info=*/&info,
+                                          /*storage_scope=*/storage_scope);
+  Stmt new_scope = CacheReadRewriter::Rewrite(/*scope_sref=*/scope_sref, /*info=*/&info);
+
+  // Step 5. Replacing and updating flags.
+  self->Replace(scope_sref, new_scope, info.block_reuse);
+  UpdateCacheStageInfo(self, cache_read_stage, scope_sref);
+  return self->stmt2ref.at(cache_read_stage.get());
+}
+
+StmtSRef CacheWrite(ScheduleState self, const StmtSRef& block_sref, int write_buffer_index,
+                    const String& storage_scope) {
+  /*!
+   * Check:
+   *   - The index is in the array of block reading region
+   *   - There is only one block who writes the buffer in the scope
+   *
+   * Mutate:
+   *   - Allocate new cache buffer under the current scope.
+   *   - Find the lowest ancestor of the block and ANY ONE of the producer blocks.
+   *   - Copy the buffer with the consumed region.
+   */
+
+  // Step 1. Checking index, getting the target buffer and the parent scope
+  const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+  if (write_buffer_index < 0 || write_buffer_index >= static_cast<int>(block->writes.size())) {
+    throw BufferIndexOutOfRangeError(self->mod, GetRef<Block>(block), write_buffer_index, true);
+  }
+  Buffer write_buffer = block->writes[write_buffer_index]->buffer;
+  StmtSRef scope_sref = GetScopeRootAndCheckStagePipeline(self, block_sref);
+  const BlockNode* scope_block = TVM_SREF_TO_BLOCK(scope_block, scope_sref);
+
+  // Step 2. Checking there is only one writer block
+  const Array<StmtSRef>& writers = self->GetBlockScope(scope_sref)->buffer_writers.at(write_buffer);
+  if (writers.size() > 1) {
+    throw NotSingleWriteBlock(self->mod, write_buffer, writers);
+  }
+
+  // Step 3. Creating CacheStageInfo
+  CacheStageInfo info;
+  info.read_buffer = WithScope(write_buffer, storage_scope);
+  // Create the corresponding buffer to be written, i.e. result of cache_write
+  info.write_buffer = write_buffer;
+  // Create the corresponding buffer allocation
+  info.alloc = info.read_buffer;
+
+  // Step 4. The write back goes after the statement of the writer, and before the statements of
+  // the other readers, covering the region the writer writes.
+  int writer_pos = GetTopLevelPosition(block_sref, scope_sref);
+  for (const StmtSRef& child_sref : GetChildBlocks(self, scope_sref)) {
+    if (child_sref.same_as(block_sref)) continue;
+    const BlockNode* child = TVM_SREF_TO_BLOCK(child, child_sref);
+    for (const BufferRegion& region : child->reads) {
+      if (region->buffer.same_as(write_buffer) &&
+          GetTopLevelPosition(child_sref, scope_sref) <= writer_pos) {
+        throw CacheStagePlacementError(self->mod, write_buffer, GetRef<Block>(scope_block));
+      }
+    }
+  }
+  info.loc_pos = writer_pos + 1;
+  Array<arith::IntSet> write_region =
+      RelaxBufferRegion(block_sref, scope_sref, block->writes[write_buffer_index]);
+  Array<Range> cache_region;
+  for (size_t i = 0; i < write_buffer->shape.size(); ++i) {
+    cache_region.push_back(
+        write_region[i].CoverRange(Range::FromMinExtent(0, write_buffer->shape[i])));
+  }
+
+  // Step 5. Making new cache stage block and rewrite the writer.
+  Block cache_write_stage = MakeCacheStage(/*cache_region=*/cache_region, /*info=*/&info,
+                                           /*storage_scope=*/storage_scope);
+  Stmt new_scope = CacheWriteRewriter::Rewrite(/*scope_sref=*/scope_sref,
+                                               /*writer_block_sref=*/block_sref, /*info=*/&info);
+
+  // Step 6. Replacing and updating flags.
+  self->Replace(scope_sref, new_scope, info.block_reuse);
+  UpdateCacheStageInfo(self, cache_write_stage, scope_sref);
+  return self->stmt2ref.at(cache_write_stage.get());
+}
+
+}  // namespace tir
+}  // namespace tvm
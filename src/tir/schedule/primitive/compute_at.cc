@@ -0,0 +1,383 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace tir {
+
+/******** Error Classes ********/
+
+class NotInSameScopeError : public ScheduleError {
+ public:
+  explicit NotInSameScopeError(IRModule mod, Block block, For loop)
+      : mod_(std::move(mod)), block_(std::move(block)), loop_(std::move(loop)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: Expected the block and the loop to be under the same block scope, and "
+           "the loop not to be an ancestor of the block";
+  }
+
+  String DetailRenderTemplate() const final {
+    return "Expected the block {0} and the loop {1} to be under the same block "
+           "scope, and the loop not to be an ancestor of the block";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_, loop_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  For loop_;
+};
+
+class NotAllRequiredBlocksUnderLoopError : public ScheduleError {
+ public:
+  explicit NotAllRequiredBlocksUnderLoopError(IRModule mod, Block block, For loop,
+                                              bool is_compute_at)
+      : mod_(std::move(mod)),
+        block_(std::move(block)),
+        loop_(std::move(loop)),
+        is_compute_at_(is_compute_at) {}
+
+  String FastErrorString() const final {
+    return is_compute_at_ ? "ScheduleError: Not all the consumers of the block are under the loop"
+                          : "ScheduleError: Not all the producers of the block are under the loop";
+  }
+
+  String DetailRenderTemplate() const final {
+    std::string kind = is_compute_at_ ? "consumers" : "producers";
+    return "The block {0} has no " + kind + " under the loop {1}, or some of its " + kind +
+           " are not under the loop";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_, loop_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  For loop_;
+  bool is_compute_at_;
+};
+
+class DependencyOrderError : public ScheduleError {
+ public:
+  explicit DependencyOrderError(IRModule mod, Block block, Block other, For loop,
+                                bool is_compute_at)
+      : mod_(std::move(mod)),
+        block_(std::move(block)),
+        other_(std::move(other)),
+        loop_(std::move(loop)),
+        is_compute_at_(is_compute_at) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: Moving the block under the loop breaks a dependency of the block";
+  }
+
+  String DetailRenderTemplate() const final {
+    if (is_compute_at_) {
+      return "The block {1} produces an input of the block {0}, but it does not run before the "
+             "loop {2}";
+    }
+    return "The block {1} consumes an output of the block {0}, but it does not run after the "
+           "loop {2}";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_, other_, loop_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  Block other_;
+  For loop_;
+  bool is_compute_at_;
+};
+
+class NotPureIndexError : public ScheduleError {
+ public:
+  explicit NotPureIndexError(IRModule mod, Block block, Buffer buffer)
+      : mod_(std::move(mod)), block_(std::move(block)), buffer_(std::move(buffer)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: The block reads its producers' buffer with indices that are not its "
+           "data parallel block vars";
+  }
+
+  String DetailRenderTemplate() const final {
+    return "The block {0} is expected to read the buffer " + buffer_->name +
+           " with its data parallel block vars as the indices, so the region it consumes is "
+           "known from the region its producers write";
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {block_}; }
+
+ private:
+  IRModule mod_;
+  Block block_;
+  Buffer buffer_;
+};
+
+/******** Helper Functions/Classes ********/
+
+/*! \brief Whether `ancestor` is an ancestor of `sref` in the sref tree, or `sref` itself */
+bool IsAncestorOrSelf(const StmtSRefNode* ancestor, const StmtSRefNode* sref) {
+  for (; sref != nullptr; sref = sref->parent) {
+    if (sref == ancestor) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief The highest statement that contains only the given block, i.e. the BlockRealize of the
+ * block or the outermost loop of a loop nest whose only leaf is the block
+ */
+const StmtNode* GetRemovableStmt(const StmtSRef& block_sref, const StmtSRef& scope_root_sref) {
+  const StmtNode* result = GetBlockRealize(block_sref).get();
+  for (const StmtSRefNode* p = block_sref->parent; p != scope_root_sref.get(); p = p->parent) {
+    const auto* loop = p->StmtAs<ForNode>();
+    if (loop == nullptr || loop->body.get() != result) {
+      break;
+    }
+    result = loop;
+  }
+  return result;
+}
+
+/*!
+ * \brief Removes a statement from the scope root, and inserts another into the body of a loop
+ * under it
+ */
+class BlockMover : public StmtMutator {
+ public:
+  static Block Move(const Block& scope_root, const StmtNode* rm_stmt, const ForNode* loop,
+                    int insert_pos, const Stmt& new_stmt) {
+    BlockMover mover(rm_stmt, loop, insert_pos, new_stmt);
+    ObjectPtr<BlockNode> n = make_object<BlockNode>(*scope_root.get());
+    n->body = mover(scope_root->body);
+    return Block(n);
+  }
+
+ private:
+  explicit BlockMover(const StmtNode* rm_stmt, const ForNode* loop, int insert_pos,
+                      const Stmt& new_stmt)
+      : rm_stmt_(rm_stmt), loop_(loop), insert_pos_(insert_pos), new_stmt_(new_stmt) {}
+
+  Stmt VisitStmt_(const SeqStmtNode* op) final {
+    Array<Stmt> seq;
+    seq.reserve(op->seq.size());
+    for (const Stmt& stmt : op->seq) {
+      if (stmt.get() != rm_stmt_) {
+        seq.push_back(VisitStmt(stmt));
+      }
+    }
+    return seq.size() == 1 ? seq[0] : SeqStmt(seq);
+  }
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtMutator::VisitStmt_(op));
+    if (op != loop_) {
+      return std::move(loop);
+    }
+    Array<Stmt> seq;
+    if (const auto* seq_stmt = loop->body.as<SeqStmtNode>()) {
+      seq = seq_stmt->seq;
+    } else {
+      seq.push_back(loop->body);
+    }
+    seq.insert(seq.begin() + insert_pos_, new_stmt_);
+    ObjectPtr<ForNode> n = make_object<ForNode>(*loop.get());
+    n->body = SeqStmt(seq);
+    return For(n);
+  }
+
+  const StmtNode* rm_stmt_;
+  const ForNode* loop_;
+  int insert_pos_;
+  const Stmt& new_stmt_;
+};
+
+/*!
+ * \brief The implementation of compute-at and reverse-compute-at
+ * \tparam is_compute_at Whether the block is moved under the loop of its consumers (compute-at), or
+ * under the loop of its producers (reverse-compute-at)
+ * \param self The schedule state
+ * \param block_sref The block to be moved
+ * \param loop_sref The loop where the block is moved under
+ */
+template <bool is_compute_at>
+void ComputeAtOrReverseComputeAtImpl(ScheduleState self, const StmtSRef& block_sref,
+                                     const StmtSRef& loop_sref) {
+  const BlockNode* block = TVM_SREF_TO_BLOCK(block, block_sref);
+  const ForNode* loop = TVM_SREF_TO_FOR(loop, loop_sref);
+  // Step 1. Check the block and the loop are in the same scope, and the loop is not an ancestor of
+  // the block
+  StmtSRef scope_root_sref = GetScopeRootAndCheckStagePipeline(self, block_sref);
+  if (!GetScopeRoot(loop_sref).same_as(scope_root_sref) ||
+      IsAncestorOrSelf(loop_sref.get(), block_sref.get())) {
+    throw NotInSameScopeError(self->mod, GetRef<Block>(block), GetRef<For>(loop));
+  }
+  const BlockNode* scope_root = TVM_SREF_TO_BLOCK(scope_root, scope_root_sref);
+  int loop_pos = GetTopLevelPosition(loop_sref, scope_root_sref);
+  // Step 2. Find the blocks the region is derived from: the consumers of the block for
+  // compute-at, and the producers of the block for reverse-compute-at. They must all be under the
+  // loop. The blocks on the other side of the block must run before (compute-at) or after
+  // (reverse-compute-at) the loop.
+  const Array<BufferRegion>& related_regions = is_compute_at ? block->writes : block->reads;
+  const Array<BufferRegion>& other_regions = is_compute_at ? block->reads : block->writes;
+  auto f_accesses = [](const Array<BufferRegion>& regions, const Buffer& buffer) {
+    for (const BufferRegion& region : regions) {
+      if (region->buffer.same_as(buffer)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  // The accessed region of the related blocks, per buffer and per dimension
+  std::unordered_map<const BufferNode*, std::vector<Array<arith::IntSet>>> related_access;
+  int min_pos = std::numeric_limits<int>::max();
+  int max_pos = -1;
+  for (const StmtSRef& child_sref : GetChildBlocks(self, scope_root_sref)) {
+    if (child_sref.same_as(block_sref)) {
+      continue;
+    }
+    const BlockNode* child = TVM_SREF_TO_BLOCK(child, child_sref);
+    const Array<BufferRegion>& child_related = is_compute_at ? child->reads : child->writes;
+    const Array<BufferRegion>& child_other = is_compute_at ? child->writes : child->reads;
+    bool under_loop = IsAncestorOrSelf(loop_sref.get(), child_sref.get());
+    for (const BufferRegion& region : child_related) {
+      if (!f_accesses(related_regions, region->buffer)) {
+        continue;
+      }
+      if (!under_loop) {
+        throw NotAllRequiredBlocksUnderLoopError(self->mod, GetRef<Block>(block),
+                                                 GetRef<For>(loop), is_compute_at);
+      }
+      related_access[region->buffer.get()].push_back(
+          RelaxBufferRegion(child_sref, loop_sref, region));
+      // The position of the child in the loop body
+      const StmtSRefNode* p = child_sref.get();
+      for (; p->parent != loop_sref.get(); p = p->parent) {
+      }
+      int pos = std::max<int64_t>(p->seq_index, 0);
+      min_pos = std::min(min_pos, pos);
+      max_pos = std::max(max_pos, pos);
+    }
+    for (const BufferRegion& region : child_other) {
+      if (!f_accesses(other_regions, region->buffer)) {
+        continue;
+      }
+      int child_pos = GetTopLevelPosition(child_sref, scope_root_sref);
+      if (under_loop || (is_compute_at ? child_pos >= loop_pos : child_pos <= loop_pos)) {
+        throw DependencyOrderError(self->mod, GetRef<Block>(block), GetRef<Block>(child),
+                                   GetRef<For>(loop), is_compute_at);
+      }
+    }
+  }
+  if (related_access.empty()) {
+    throw NotAllRequiredBlocksUnderLoopError(self->mod, GetRef<Block>(block), GetRef<For>(loop),
+                                             is_compute_at);
+  }
+  // Step 3. Derive the domain of the block vars. A data parallel block var that indexes a
+  // dimension of a related buffer iterates the region the related blocks access in the
+  // dimension; the others keep their domain.
+  arith::Analyzer analyzer;
+  std::unordered_map<const VarNode*, std::vector<arith::IntSet>> var_sets;
+  for (const BufferRegion& region : related_regions) {
+    auto it = related_access.find(region->buffer.get());
+    if (it == related_access.end()) {
+      continue;
+    }
+    for (size_t i = 0; i < region->region.size(); ++i) {
+      const Range& range = region->region[i];
+      const auto* var = range->min.as<VarNode>();
+      bool is_data_par_var = var != nullptr && is_one(range->extent);
+      if (is_data_par_var) {
+        is_data_par_var = false;
+        for (const IterVar& iter_var : block->iter_vars) {
+          if (iter_var->var.get() == var && iter_var->iter_type == IterVarType::kDataPar) {
+            is_data_par_var = true;
+          }
+        }
+      }
+      if (!is_data_par_var) {
+        // Leaving the dimension unnarrowed is conservative for compute-at, which recomputes more
+        // than the consumers read. A consumer could read what is not produced yet otherwise.
+        if (!is_compute_at) {
+          throw NotPureIndexError(self->mod, GetRef<Block>(block), region->buffer);
+        }
+        continue;
+      }
+      for (const Array<arith::IntSet>& access : it->second) {
+        var_sets[var].push_back(access[i]);
+      }
+    }
+  }
+  Array<PrimExpr> bindings;
+  std::vector<std::pair<Var, PrimExpr>> new_loops;
+  for (const IterVar& iter_var : block->iter_vars) {
+    Range dom = iter_var->dom;
+    auto it = var_sets.find(iter_var->var.get());
+    if (it != var_sets.end()) {
+      arith::IntSet set =
+          arith::Intersect({arith::Union(it->second), arith::IntSet::FromRange(iter_var->dom)});
+      dom = set.CoverRange(iter_var->dom);
+    }
+    PrimExpr min = analyzer.Simplify(dom->min);
+    PrimExpr extent = analyzer.Simplify(dom->extent);
+    if (is_one(extent)) {
+      bindings.push_back(min);
+    } else {
+      Var loop_var("ax" + std::to_string(new_loops.size()), iter_var->var.dtype());
+      new_loops.emplace_back(loop_var, extent);
+      bindings.push_back(analyzer.Simplify(min + loop_var));
+    }
+  }
+  Stmt new_stmt = BlockRealize(bindings, const_true(), GetRef<Block>(block));
+  for (auto it = new_loops.rbegin(); it != new_loops.rend(); ++it) {
+    new_stmt = For(it->first, 0, it->second, ForKind::kSerial, new_stmt);
+  }
+  // Step 4. Move the block under the loop, before the first consumer or after the last producer
+  int insert_pos = is_compute_at ? min_pos : max_pos + 1;
+  const StmtNode* rm_stmt = GetRemovableStmt(block_sref, scope_root_sref);
+  Block new_scope_root =
+      BlockMover::Move(GetRef<Block>(scope_root), rm_stmt, loop, insert_pos, new_stmt);
+  self->Replace(scope_root_sref, new_scope_root, {{GetRef<Block>(scope_root), new_scope_root}});
+  // Step 5. Update the cached flags. The block is reused intact, so only its binding changes.
+  BlockInfo& block_info = self->block_info[block_sref];
+  block_info.affine_binding = IsAffineBinding(
+      /*realize=*/GetBlockRealize(block_sref),
+      /*loop_var_ranges=*/LoopDomainOfSRefTreePath(GetRef<StmtSRef>(block_sref->parent)),
+      /*analyzer=*/&analyzer);
+}
+
+void ComputeAt(ScheduleState self, const StmtSRef& block_sref, const StmtSRef& loop_sref) {
+  ComputeAtOrReverseComputeAtImpl<true>(self, block_sref, loop_sref);
+}
+
+void ReverseComputeAt(ScheduleState self, const StmtSRef& block_sref, const StmtSRef& loop_sref) {
+  ComputeAtOrReverseComputeAtImpl<false>(self, block_sref, loop_sref);
+}
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,374 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <tvm/tir/schedule/trace.h>
+
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+
+#include "./utils.h"
+
+namespace tvm {
+namespace tir {
+
+/**************** Constructor ****************/
+
+Instruction::Instruction(String kind, Array<ObjectRef> inputs, Array<ObjectRef> attrs,
+                         Array<ObjectRef> outputs) {
+  ObjectPtr<InstructionNode> n = make_object<InstructionNode>();
+  n->kind = std::move(kind);
+  n->inputs = std::move(inputs);
+  n->attrs = std::move(attrs);
+  n->outputs = std::move(outputs);
+  this->data_ = std::move(n);
+}
+
+Trace::Trace() { this->data_ = make_object<TraceNode>(); }
+
+Trace::Trace(Array<Instruction> insts) {
+  ObjectPtr<TraceNode> n = make_object<TraceNode>();
+  n->insts = std::move(insts);
+  this->data_ = std::move(n);
+}
+
+/**************** Instruction kinds ****************/
+
+/*!
+ * \brief The schedule primitive an instruction kind invokes
+ * \param sch The schedule the instruction is applied to
+ * \param inputs The random variables, already translated to the ones of `sch`
+ * \param attrs The attributes of the instruction
+ * \return The random variables the primitive returns
+ */
+using FInstApply = std::function<Array<ObjectRef>(const Schedule& sch,
+                                                  const Array<ObjectRef>& inputs,
+                                                  const Array<ObjectRef>& attrs)>;
+
+/*! \brief An instruction kind: how it is replayed, and its python method */
+struct InstKind {
+  /*! \brief Replays the instruction */
+  FInstApply f_apply;
+  /*! \brief The name of the python method of the schedule */
+  const char* py_method;
+  /*! \brief The keyword of each input in python, or nullptr for a variadic positional input */
+  std::vector<const char*> py_inputs;
+  /*! \brief The keyword of each attribute in python */
+  std::vector<const char*> py_attrs;
+  /*! \brief Whether the primitive returns an array of random variables */
+  bool returns_array;
+};
+
+template <class T>
+Array<T> DowncastInputs(const Array<ObjectRef>& inputs, size_t begin = 0) {
+  Array<T> result;
+  result.reserve(inputs.size() - begin);
+  for (size_t i = begin; i < inputs.size(); ++i) {
+    result.push_back(Downcast<T>(inputs[i]));
+  }
+  return result;
+}
+
+const InstKind& GetInstKind(const String& kind) {
+  static const std::unordered_map<std::string, InstKind> kinds = {
+      {"GetBlock",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          return Array<ObjectRef>{
+              sch->GetBlock(Downcast<String>(attrs[0]), Downcast<String>(attrs[1]))};
+        },
+        "get_block",
+        {},
+        {"name", "func_name"},
+        false}},
+      {"GetLoops",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          Array<LoopRV> loops = sch->GetLoops(Downcast<BlockRV>(inputs[0]));
+          return Array<ObjectRef>{loops.begin(), loops.end()};
+        },
+        "get_loops",
+        {"block"},
+        {},
+        true}},
+      {"Split",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          Array<LoopRV> loops = sch->Split(Downcast<LoopRV>(inputs[0]),
+                                           DowncastInputs<Optional<ExprRV>>(inputs, 1));
+          return Array<ObjectRef>{loops.begin(), loops.end()};
+        },
+        "split",
+        {"loop", nullptr},
+        {},
+        true}},
+      {"Fuse",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          return Array<ObjectRef>{sch->Fuse(DowncastInputs<LoopRV>(inputs))};
+        },
+        "fuse",
+        {nullptr},
+        {},
+        false}},
+      {"Reorder",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->Reorder(DowncastInputs<LoopRV>(inputs));
+          return Array<ObjectRef>{};
+        },
+        "reorder",
+        {nullptr},
+        {},
+        false}},
+      {"ComputeAt",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->ComputeAt(Downcast<BlockRV>(inputs[0]), Downcast<LoopRV>(inputs[1]));
+          return Array<ObjectRef>{};
+        },
+        "compute_at",
+        {"block", "loop"},
+        {},
+        false}},
+      {"ReverseComputeAt",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->ReverseComputeAt(Downcast<BlockRV>(inputs[0]), Downcast<LoopRV>(inputs[1]));
+          return Array<ObjectRef>{};
+        },
+        "reverse_compute_at",
+        {"block", "loop"},
+        {},
+        false}},
+      {"ComputeInline",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->ComputeInline(Downcast<BlockRV>(inputs[0]));
+          return Array<ObjectRef>{};
+        },
+        "compute_inline",
+        {"block"},
+        {},
+        false}},
+      {"ReverseComputeInline",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->ReverseComputeInline(Downcast<BlockRV>(inputs[0]));
+          return Array<ObjectRef>{};
+        },
+        "reverse_compute_inline",
+        {"block"},
+        {},
+        false}},
+      {"Parallel",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->Parallel(Downcast<LoopRV>(inputs[0]));
+          return Array<ObjectRef>{};
+        },
+        "parallel",
+        {"loop"},
+        {},
+        false}},
+      {"Vectorize",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->Vectorize(Downcast<LoopRV>(inputs[0]));
+          return Array<ObjectRef>{};
+        },
+        "vectorize",
+        {"loop"},
+        {},
+        false}},
+      {"Bind",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->Bind(Downcast<LoopRV>(inputs[0]), Downcast<String>(attrs[0]));
+          return Array<ObjectRef>{};
+        },
+        "bind",
+        {"loop"},
+        {"thread_axis"},
+        false}},
+      {"Unroll",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          sch->Unroll(Downcast<LoopRV>(inputs[0]));
+          return Array<ObjectRef>{};
+        },
+        "unroll",
+        {"loop"},
+        {},
+        false}},
+      {"CacheRead",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          return Array<ObjectRef>{sch->CacheRead(Downcast<BlockRV>(inputs[0]),
+                                                 Downcast<Integer>(attrs[0]),
+                                                 Downcast<String>(attrs[1]))};
+        },
+        "cache_read",
+        {"block"},
+        {"read_buffer_index", "storage_scope"},
+        false}},
+      {"CacheWrite",
+       {[](const Schedule& sch, const Array<ObjectRef>& inputs, const Array<ObjectRef>& attrs) {
+          return Array<ObjectRef>{sch->CacheWrite(Downcast<BlockRV>(inputs[0]),
+                                                  Downcast<Integer>(attrs[0]),
+                                                  Downcast<String>(attrs[1]))};
+        },
+        "cache_write",
+        {"block"},
+        {"write_buffer_index", "storage_scope"},
+        false}},
+  };
+  auto it = kinds.find(kind);
+  CHECK(it != kinds.end()) << "ValueError: Unknown instruction kind: " << kind;
+  return it->second;
+}
+
+/**************** Trace ****************/
+
+void TraceNode::Append(Instruction inst) { insts.push_back(std::move(inst)); }
+
+void TraceNode::ApplyToSchedule(Schedule sch) const {
+  // Maps the random variables of the trace to the ones of `sch`
+  std::unordered_map<ObjectRef, ObjectRef, ObjectPtrHash, ObjectPtrEqual> rv_map;
+  auto f_translate = [&rv_map](const ObjectRef& input) -> ObjectRef {
+    if (!input.defined()) {
+      return input;
+    }
+    if (input->IsInstance<BlockRVNode>() || input->IsInstance<LoopRVNode>()) {
+      auto it = rv_map.find(input);
+      CHECK(it != rv_map.end()) << "ValueError: The random variable is not defined in the trace: "
+                                << input;
+      return it->second;
+    }
+    if (const auto* expr = input.as<PrimExprNode>()) {
+      return Substitute(GetRef<PrimExpr>(expr), [&rv_map](const Var& var) -> Optional<PrimExpr> {
+        auto it = rv_map.find(var);
+        if (it == rv_map.end()) {
+          return NullOpt;
+        }
+        return Downcast<PrimExpr>(it->second);
+      });
+    }
+    return input;
+  };
+  for (const Instruction& inst : insts) {
+    Array<ObjectRef> inputs;
+    inputs.reserve(inst->inputs.size());
+    for (const ObjectRef& input : inst->inputs) {
+      inputs.push_back(f_translate(input));
+    }
+    Array<ObjectRef> outputs = GetInstKind(inst->kind).f_apply(sch, inputs, inst->attrs);
+    CHECK_EQ(outputs.size(), inst->outputs.size())
+        << "ValueError: The instruction " << inst->kind << " returns " << outputs.size()
+        << " random variable(s) on replay, but " << inst->outputs.size() << " when it is traced";
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      rv_map[inst->outputs[i]] = outputs[i];
+    }
+  }
+}
+
+Array<String> TraceNode::AsPython() const {
+  std::unordered_map<ObjectRef, std::string, ObjectPtrHash, ObjectPtrEqual> rv_names;
+  auto f_name = [&rv_names](const ObjectRef& rv) -> std::string {
+    if (!rv.defined()) {
+      return "None";
+    }
+    auto it = rv_names.find(rv);
+    if (it != rv_names.end()) {
+      return it->second;
+    }
+    if (const auto* expr = rv.as<PrimExprNode>()) {
+      std::ostringstream os;
+      os << GetRef<PrimExpr>(expr);
+      return os.str();
+    }
+    LOG(FATAL) << "ValueError: The random variable is not defined in the trace: " << rv;
+    throw;
+  };
+  auto f_attr = [](const ObjectRef& attr) -> std::string {
+    std::ostringstream os;
+    if (const auto* str = attr.as<StringObj>()) {
+      os << '"' << str->data << '"';
+    } else {
+      os << attr;
+    }
+    return os.str();
+  };
+  Array<String> result;
+  result.reserve(insts.size());
+  for (const Instruction& inst : insts) {
+    const InstKind& kind = GetInstKind(inst->kind);
+    // The arguments
+    std::vector<std::string> args;
+    for (size_t i = 0; i < inst->inputs.size(); ++i) {
+      const char* keyword = kind.py_inputs[std::min(i, kind.py_inputs.size() - 1)];
+      if (keyword == nullptr) {
+        // The trailing variadic inputs are passed as a list, except for the loops of fuse and
+        // reorder, which are passed positionally
+        if (kind.py_inputs.size() == 1) {
+          args.push_back(f_name(inst->inputs[i]));
+        } else {
+          std::string list = "factors=[";
+          for (size_t j = i; j < inst->inputs.size(); ++j) {
+            list += (j == i ? "" : ", ") + f_name(inst->inputs[j]);
+          }
+          args.push_back(list + "]");
+          break;
+        }
+      } else {
+        args.push_back(std::string(keyword) + "=" + f_name(inst->inputs[i]));
+      }
+    }
+    for (size_t i = 0; i < inst->attrs.size(); ++i) {
+      args.push_back(std::string(kind.py_attrs[i]) + "=" + f_attr(inst->attrs[i]));
+    }
+    // The outputs
+    std::ostringstream os;
+    for (size_t i = 0; i < inst->outputs.size(); ++i) {
+      const ObjectRef& output = inst->outputs[i];
+      std::string prefix = output->IsInstance<BlockRVNode>() ? "b"
+                           : output->IsInstance<LoopRVNode>() ? "l"
+                                                              : "v";
+      std::string name = prefix + std::to_string(rv_names.size());
+      rv_names[output] = name;
+      os << (i == 0 ? "" : ", ") << name;
+    }
+    if (!inst->outputs.empty()) {
+      os << (kind.returns_array && inst->outputs.size() == 1 ? ", = " : " = ");
+    }
+    os << "sch." << kind.py_method << "(";
+    for (size_t i = 0; i < args.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << args[i];
+    }
+    os << ")";
+    result.push_back(os.str());
+  }
+  return result;
+}
+
+/**************** FFI ****************/
+
+TVM_REGISTER_NODE_TYPE(InstructionNode);
+TVM_REGISTER_NODE_TYPE(TraceNode);
+
+TVM_REGISTER_GLOBAL("tir.schedule.Instruction")
+    .set_body_typed([](String kind, Array<ObjectRef> inputs, Array<ObjectRef> attrs,
+                       Array<ObjectRef> outputs) -> Instruction {
+      return Instruction(kind, inputs, attrs, outputs);
+    });
+TVM_REGISTER_GLOBAL("tir.schedule.Trace").set_body_typed([](Optional<Array<Instruction>> insts) {
+  return Trace(insts.value_or({}));
+});
+TVM_REGISTER_GLOBAL("tir.schedule.TraceAppend").set_body_method<Trace>(&TraceNode::Append);
+TVM_REGISTER_GLOBAL("tir.schedule.TraceApplyToSchedule")
+    .set_body_method<Trace>(&TraceNode::ApplyToSchedule);
+TVM_REGISTER_GLOBAL("tir.schedule.TraceAsPython").set_body_method<Trace>(&TraceNode::AsPython);
+
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,194 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "./traced_schedule.h"
+
+namespace tvm {
+namespace tir {
+
+Schedule Schedule::Traced(IRModule mod, int debug_mode,
+                          ScheduleErrorRenderLevel error_render_level) {
+  ObjectPtr<TracedScheduleNode> n = make_object<TracedScheduleNode>();
+  n->state_ = ScheduleState(mod, debug_mode);
+  n->error_render_level_ = error_render_level;
+  n->symbol_table_ = {};
+  n->analyzer_ = std::make_unique<arith::Analyzer>();
+  n->trace_ = Trace();
+  return Schedule(std::move(n));
+}
+
+Schedule TracedScheduleNode::Copy() const {
+  ObjectPtr<TracedScheduleNode> n = make_object<TracedScheduleNode>();
+  n->error_render_level_ = this->error_render_level_;
+  ConcreteScheduleNode::Copy(&n->state_, &n->symbol_table_);
+  n->analyzer_ = std::make_unique<arith::Analyzer>();
+  // The random variables are shared with the copy, so is the trace recorded so far
+  n->trace_ = Trace(this->trace_->insts);
+  return Schedule(std::move(n));
+}
+
+/******** Block/Loop relation ********/
+
+BlockRV TracedScheduleNode::GetBlock(const String& name, const String& func_name) {
+  BlockRV result = ConcreteScheduleNode::GetBlock(name, func_name);
+  trace_->Append(Instruction(/*kind=*/"GetBlock",
+                             /*inputs=*/{},
+                             /*attrs=*/{name, func_name},
+                             /*outputs=*/{result}));
+  return result;
+}
+
+Array<LoopRV> TracedScheduleNode::GetLoops(const BlockRV& block_rv) {
+  Array<LoopRV> results = ConcreteScheduleNode::GetLoops(block_rv);
+  trace_->Append(Instruction(/*kind=*/"GetLoops",
+                             /*inputs=*/{block_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{results.begin(), results.end()}));
+  return results;
+}
+
+/******** Schedule: loops manipulation ********/
+
+Array<LoopRV> TracedScheduleNode::Split(const LoopRV& loop_rv,
+                                        const Array<Optional<ExprRV>>& factor_rvs) {
+  Array<LoopRV> results = ConcreteScheduleNode::Split(loop_rv, factor_rvs);
+  Array<ObjectRef> inputs{loop_rv};
+  inputs.reserve(factor_rvs.size() + 1);
+  for (const Optional<ExprRV>& factor_rv : factor_rvs) {
+    inputs.push_back(factor_rv);
+  }
+  trace_->Append(Instruction(/*kind=*/"Split",
+                             /*inputs=*/inputs,
+                             /*attrs=*/{},
+                             /*outputs=*/{results.begin(), results.end()}));
+  return results;
+}
+
+LoopRV TracedScheduleNode::Fuse(const Array<LoopRV>& loop_rvs) {
+  LoopRV result = ConcreteScheduleNode::Fuse(loop_rvs);
+  trace_->Append(Instruction(/*kind=*/"Fuse",
+                             /*inputs=*/{loop_rvs.begin(), loop_rvs.end()},
+                             /*attrs=*/{},
+                             /*outputs=*/{result}));
+  return result;
+}
+
+void TracedScheduleNode::Reorder(const Array<LoopRV>& ordered_loop_rvs) {
+  ConcreteScheduleNode::Reorder(ordered_loop_rvs);
+  trace_->Append(Instruction(/*kind=*/"Reorder",
+                             /*inputs=*/{ordered_loop_rvs.begin(), ordered_loop_rvs.end()},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+/******** Schedule: compute location ********/
+
+void TracedScheduleNode::ComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) {
+  ConcreteScheduleNode::ComputeAt(block_rv, loop_rv);
+  trace_->Append(Instruction(/*kind=*/"ComputeAt",
+                             /*inputs=*/{block_rv, loop_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::ReverseComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) {
+  ConcreteScheduleNode::ReverseComputeAt(block_rv, loop_rv);
+  trace_->Append(Instruction(/*kind=*/"ReverseComputeAt",
+                             /*inputs=*/{block_rv, loop_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::ComputeInline(const BlockRV& block_rv) {
+  ConcreteScheduleNode::ComputeInline(block_rv);
+  trace_->Append(Instruction(/*kind=*/"ComputeInline",
+                             /*inputs=*/{block_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::ReverseComputeInline(const BlockRV& block_rv) {
+  ConcreteScheduleNode::ReverseComputeInline(block_rv);
+  trace_->Append(Instruction(/*kind=*/"ReverseComputeInline",
+                             /*inputs=*/{block_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+/******** Schedule: loop binding/annotation ********/
+
+void TracedScheduleNode::Parallel(const LoopRV& loop_rv) {
+  ConcreteScheduleNode::Parallel(loop_rv);
+  trace_->Append(Instruction(/*kind=*/"Parallel",
+                             /*inputs=*/{loop_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::Vectorize(const LoopRV& loop_rv) {
+  ConcreteScheduleNode::Vectorize(loop_rv);
+  trace_->Append(Instruction(/*kind=*/"Vectorize",
+                             /*inputs=*/{loop_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::Bind(const LoopRV& loop_rv, const String& thread_axis) {
+  ConcreteScheduleNode::Bind(loop_rv, thread_axis);
+  trace_->Append(Instruction(/*kind=*/"Bind",
+                             /*inputs=*/{loop_rv},
+                             /*attrs=*/{thread_axis},
+                             /*outputs=*/{}));
+}
+
+void TracedScheduleNode::Unroll(const LoopRV& loop_rv) {
+  ConcreteScheduleNode::Unroll(loop_rv);
+  trace_->Append(Instruction(/*kind=*/"Unroll",
+                             /*inputs=*/{loop_rv},
+                             /*attrs=*/{},
+                             /*outputs=*/{}));
+}
+
+/******** Schedule: cache read/write ********/
+
+BlockRV TracedScheduleNode::CacheRead(const BlockRV& block_rv, int read_buffer_index,
+                                      const String& storage_scope) {
+  BlockRV result = ConcreteScheduleNode::CacheRead(block_rv, read_buffer_index, storage_scope);
+  trace_->Append(Instruction(/*kind=*/"CacheRead",
+                             /*inputs=*/{block_rv},
+                             /*attrs=*/{Integer(read_buffer_index), storage_scope},
+                             /*outputs=*/{result}));
+  return result;
+}
+
+BlockRV TracedScheduleNode::CacheWrite(const BlockRV& block_rv, int write_buffer_index,
+                                       const String& storage_scope) {
+  BlockRV result = ConcreteScheduleNode::CacheWrite(block_rv, write_buffer_index, storage_scope);
+  trace_->Append(Instruction(/*kind=*/"CacheWrite",
+                             /*inputs=*/{block_rv},
+                             /*attrs=*/{Integer(write_buffer_index), storage_scope},
+                             /*outputs=*/{result}));
+  return result;
+}
+
+/******** FFI ********/
+
+TVM_REGISTER_NODE_TYPE(TracedScheduleNode);
+
+}  // namespace tir
+}  // namespace tvm
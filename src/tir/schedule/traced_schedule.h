@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef TVM_TIR_SCHEDULE_TRACED_SCHEDULE_H_
+#define TVM_TIR_SCHEDULE_TRACED_SCHEDULE_H_
+
+#include "./concrete_schedule.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief A concrete schedule that records each primitive applied into its trace */
+class TracedScheduleNode : public ConcreteScheduleNode {
+  friend class Schedule;
+
+ protected:
+  /*! \brief The trace of the schedule */
+  Trace trace_;
+
+ public:
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    // `trace_` is not visited
+  }
+
+  ~TracedScheduleNode() = default;
+
+  static constexpr const char* _type_key = "tir.TracedSchedule";
+  TVM_DECLARE_FINAL_OBJECT_INFO(TracedScheduleNode, ConcreteScheduleNode);
+
+ public:
+  Optional<Trace> trace() const final { return trace_; }
+  Schedule Copy() const final;
+
+ public:
+  /******** Block/Loop relation ********/
+  BlockRV GetBlock(const String& name, const String& func_name = "main") final;
+  Array<LoopRV> GetLoops(const BlockRV& block_rv) final;
+  /******** Schedule: loops manipulation ********/
+  Array<LoopRV> Split(const LoopRV& loop_rv, const Array<Optional<ExprRV>>& factor_rvs) final;
+  LoopRV Fuse(const Array<LoopRV>& loop_rvs) final;
+  void Reorder(const Array<LoopRV>& ordered_loop_rvs) final;
+  /******** Schedule: compute location ********/
+  void ComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) final;
+  void ReverseComputeAt(const BlockRV& block_rv, const LoopRV& loop_rv) final;
+  void ComputeInline(const BlockRV& block_rv) final;
+  void ReverseComputeInline(const BlockRV& block_rv) final;
+  /******** Schedule: loop binding/annotation ********/
+  void Parallel(const LoopRV& loop_rv) final;
+  void Vectorize(const LoopRV& loop_rv) final;
+  void Bind(const LoopRV& loop_rv, const String& thread_axis) final;
+  void Unroll(const LoopRV& loop_rv) final;
+  /******** Schedule: cache read/write ********/
+  BlockRV CacheRead(const BlockRV& block_rv, int read_buffer_index,
+                    const String& storage_scope) final;
+  BlockRV CacheWrite(const BlockRV& block_rv, int write_buffer_index,
+                     const String& storage_scope) final;
+};
+
+}  // namespace tir
+}  // namespace tvm
+
+#endif  // TVM_TIR_SCHEDULE_TRACED_SCHEDULE_H_
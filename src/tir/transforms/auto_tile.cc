@@ -0,0 +1,382 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file auto_tile.cc
+ * \brief Tile the unscheduled reduction loop nests of the CPU functions for the caches.
+ *
+ *  The pass matches the loop nests that TE lowers from a reduction without schedule:
+ *
+ *    for (s_0 ...) ... for (s_m ...) {
+ *      C[f(s)] = init                                  // optional
+ *      for (r_0 ...) ... for (r_n ...) C[f(s)] = g(C[f(s)], ...)
+ *    }
+ *
+ *  where the loops are serial, f is an injective affine index of the spatial vars s, and
+ *  C is not otherwise accessed. The nest becomes
+ *
+ *    for (s_0.l2 ...) ... for (s_m.l1 ...) {
+ *      for (s_0.i ...) ... for (s_m.i ...) C[f(s)] = init
+ *      for (r_0 ...) ... for (r_n.o ...) for (r_n.i ...)
+ *        for (s_0.i ...) ... vectorized for (s_m.i ...) C[f(s)] = g(...)
+ *    }
+ *
+ *  The L1 tile, the spatial and the last reduction loops, holds its data in half the L1
+ *  cache, and the L2 tile of the spatial loops in half the L2 cache. The iterations that
+ *  update an element of C run in their original order, the result is unchanged.
+ */
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief A reduction loop nest of the form matched by the pass. */
+struct ReductionNest {
+  std::vector<const ForNode*> spatial;
+  std::vector<const ForNode*> reduction;
+  // The initialization of C, may be null.
+  const StoreNode* init{nullptr};
+  const StoreNode* update{nullptr};
+  // The coefficient of each spatial var in the index of C.
+  std::vector<int64_t> coeffs;
+};
+
+class AutoTiler : public StmtMutator {
+ public:
+  AutoTiler(int64_t l1_bytes, int64_t l2_bytes) : l1_bytes_(l1_bytes), l2_bytes_(l2_bytes) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    // the nests under a scheduled loop are left as the schedule made them.
+    if (!IsPlainLoop(op)) return GetRef<Stmt>(op);
+    ReductionNest nest;
+    if (Match(op, &nest)) return Tile(nest);
+    return StmtMutator::VisitStmt_(op);
+  }
+
+ private:
+  static constexpr int64_t kMinIterations = 4096;
+
+  static bool IsPlainLoop(const ForNode* op) {
+    return op->kind == ForKind::kSerial && !op->thread_binding.defined() &&
+           op->annotations.empty() && is_const_int(op->min, 0) && op->extent.as<IntImmNode>();
+  }
+
+  // Collect the chain of plain loops starting at stmt, return the body.
+  static Stmt LoopChain(Stmt stmt, std::vector<const ForNode*>* loops) {
+    while (const auto* loop = stmt.as<ForNode>()) {
+      if (!IsPlainLoop(loop)) break;
+      loops->push_back(loop);
+      stmt = loop->body;
+    }
+    return stmt;
+  }
+
+  static bool UsesAnyVar(const PrimExpr& e, const std::vector<const ForNode*>& loops) {
+    return ExprUseVar(e, [&loops](const VarNode* v) {
+      for (const ForNode* loop : loops) {
+        if (loop->loop_var.get() == v) return true;
+      }
+      return false;
+    });
+  }
+
+  static bool UsesLoopVar(const PrimExpr& e, const ForNode* loop) {
+    return ExprUseVar(e, loop->loop_var);
+  }
+
+  // Whether value only reads C at index.
+  static bool ReadsOnlyAt(const PrimExpr& value, const Var& buffer, const PrimExpr& index,
+                          int* num_reads) {
+    bool ok = true;
+    PostOrderVisit(value, [&](const ObjectRef& n) {
+      if (const auto* load = n.as<LoadNode>()) {
+        if (load->buffer_var.same_as(buffer)) {
+          ++*num_reads;
+          ok = ok && StructuralEqual()(load->index, index);
+        }
+      } else if (n->IsInstance<RampNode>() || n->IsInstance<BroadcastNode>()) {
+        ok = false;
+      }
+    });
+    return ok && SideEffect(value) <= CallEffectKind::kReadState;
+  }
+
+  bool Match(const ForNode* op, ReductionNest* nest) {
+    std::vector<const ForNode*> loops;
+    Stmt body = LoopChain(GetRef<Stmt>(op), &loops);
+    if (loops.empty()) return false;
+    if (const auto* seq = body.as<SeqStmtNode>()) {
+      // the init store, then the reduction loops.
+      if (seq->size() != 2) return false;
+      nest->init = seq->seq[0].as<StoreNode>();
+      if (nest->init == nullptr) return false;
+      nest->spatial = loops;
+      body = LoopChain(seq->seq[1], &nest->reduction);
+    } else {
+      // the spatial loops are the ones in the index of C.
+      const auto* store = body.as<StoreNode>();
+      if (store == nullptr) return false;
+      size_t num_spatial = 0;
+      while (num_spatial < loops.size() && UsesLoopVar(store->index, loops[num_spatial])) {
+        ++num_spatial;
+      }
+      nest->spatial.assign(loops.begin(), loops.begin() + num_spatial);
+      nest->reduction.assign(loops.begin() + num_spatial, loops.end());
+    }
+    nest->update = body.as<StoreNode>();
+    if (nest->update == nullptr || nest->spatial.empty() || nest->reduction.empty()) {
+      return false;
+    }
+    const StoreNode* update = nest->update;
+    if (!is_one(update->predicate) || update->value.dtype().lanes() != 1) return false;
+    // the index of C is of the spatial vars only.
+    if (UsesAnyVar(update->index, nest->reduction)) return false;
+    for (const ForNode* loop : nest->spatial) {
+      if (!UsesLoopVar(update->index, loop)) return false;
+    }
+    int num_reads = 0;
+    if (!ReadsOnlyAt(update->value, update->buffer_var, update->index, &num_reads)) return false;
+    if (num_reads == 0) return false;
+    if (nest->init != nullptr) {
+      const StoreNode* init = nest->init;
+      int init_reads = 0;
+      if (!init->buffer_var.same_as(update->buffer_var) ||
+          !StructuralEqual()(init->index, update->index) || !is_one(init->predicate) ||
+          !ReadsOnlyAt(init->value, init->buffer_var, init->index, &init_reads) ||
+          init_reads != 0) {
+        return false;
+      }
+    }
+    // the index is injective: each spatial coefficient covers the range of the smaller ones.
+    Array<Var> vars;
+    for (const ForNode* loop : nest->spatial) vars.push_back(loop->loop_var);
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(update->index, vars);
+    if (coeffs.size() != vars.size() + 1) return false;
+    std::vector<std::pair<int64_t, int64_t>> radix;
+    for (size_t i = 0; i < vars.size(); ++i) {
+      const auto* c = coeffs[i].as<IntImmNode>();
+      if (c == nullptr || c->value <= 0) return false;
+      nest->coeffs.push_back(c->value);
+      radix.emplace_back(c->value, Downcast<IntImm>(nest->spatial[i]->extent)->value);
+    }
+    std::sort(radix.begin(), radix.end());
+    for (size_t i = 1; i < radix.size(); ++i) {
+      if (radix[i].first < radix[i - 1].first * radix[i - 1].second) return false;
+    }
+    int64_t iterations = 1;
+    for (const ForNode* loop : nest->spatial) iterations *= Downcast<IntImm>(loop->extent)->value;
+    for (const ForNode* loop : nest->reduction) {
+      iterations *= Downcast<IntImm>(loop->extent)->value;
+    }
+    return iterations >= kMinIterations;
+  }
+
+  // The largest power of two tile of at most max_tile dividing extent, the extent if smaller.
+  static int64_t TileSize(int64_t extent, int64_t max_tile) {
+    if (extent <= max_tile) return extent;
+    int64_t tile = 1;
+    while (tile * 2 <= max_tile && extent % (tile * 2) == 0) tile *= 2;
+    return tile;
+  }
+
+  // The bytes touched by the update for the given extents of the loop vars.
+  int64_t Footprint(const ReductionNest& nest,
+                    const std::unordered_map<const VarNode*, int64_t>& extents) {
+    Array<Var> vars;
+    std::vector<int64_t> var_extents;
+    for (const ForNode* loop : nest.spatial) vars.push_back(loop->loop_var);
+    for (const ForNode* loop : nest.reduction) vars.push_back(loop->loop_var);
+    for (const Var& var : vars) var_extents.push_back(extents.at(var.get()));
+    int64_t bytes = 0;
+    auto add = [&](const PrimExpr& index, DataType dtype) {
+      // the rows of the vars of non unit stride, of the span of the unit stride vars.
+      Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, vars);
+      if (coeffs.size() != vars.size() + 1) {
+        // an unknown footprint does not fit.
+        bytes += std::numeric_limits<int32_t>::max();
+        return;
+      }
+      int64_t rows = 1, row = 1;
+      for (size_t i = 0; i < vars.size(); ++i) {
+        const auto* c = coeffs[i].as<IntImmNode>();
+        if (c != nullptr && c->value == 0) continue;
+        if (c != nullptr && std::abs(c->value) == 1) {
+          row += var_extents[i] - 1;
+        } else {
+          rows *= var_extents[i];
+        }
+      }
+      bytes += rows * row * dtype.bytes();
+    };
+    add(nest.update->index, nest.update->value.dtype());
+    PostOrderVisit(nest.update->value, [&](const ObjectRef& n) {
+      if (const auto* load = n.as<LoadNode>()) {
+        if (!load->buffer_var.same_as(nest.update->buffer_var)) add(load->index, load->dtype);
+      }
+    });
+    return bytes;
+  }
+
+  // The tile of each spatial loop and of the last reduction loop.
+  std::vector<int64_t> ChooseTiles(const ReductionNest& nest, int64_t cache_bytes,
+                                   bool tile_reduction, int64_t min_tile, int64_t max_tile) {
+    std::vector<int64_t> tiles;
+    for (int64_t tile = max_tile;; tile /= 2) {
+      tiles.clear();
+      std::unordered_map<const VarNode*, int64_t> extents;
+      for (const ForNode* loop : nest.spatial) {
+        tiles.push_back(TileSize(Downcast<IntImm>(loop->extent)->value, tile));
+        extents[loop->loop_var.get()] = tiles.back();
+      }
+      for (const ForNode* loop : nest.reduction) {
+        extents[loop->loop_var.get()] = Downcast<IntImm>(loop->extent)->value;
+      }
+      const ForNode* last = nest.reduction.back();
+      int64_t last_extent = Downcast<IntImm>(last->extent)->value;
+      tiles.push_back(tile_reduction ? TileSize(last_extent, tile) : last_extent);
+      extents[last->loop_var.get()] = tiles.back();
+      if (tile <= min_tile || Footprint(nest, extents) * 2 <= cache_bytes) return tiles;
+    }
+  }
+
+  Stmt Tile(const ReductionNest& nest) {
+    size_t num_spatial = nest.spatial.size();
+    std::vector<int64_t> l1 = ChooseTiles(nest, l1_bytes_, true, 4, 64);
+    std::vector<int64_t> l2 = ChooseTiles(nest, l2_bytes_, false, 4, 512);
+    // the innermost point loop is the one of unit stride, vectorized.
+    size_t inner = num_spatial - 1;
+    for (size_t i = 0; i < num_spatial; ++i) {
+      if (nest.coeffs[i] == 1) inner = i;
+    }
+    std::vector<size_t> point_order;
+    for (size_t i = 0; i < num_spatial; ++i) {
+      if (i != inner) point_order.push_back(i);
+    }
+    point_order.push_back(inner);
+
+    Map<Var, PrimExpr> vmap;
+    std::vector<For> l2_loops, l1_loops;
+    auto make_loop = [](const Var& var, int64_t extent, std::vector<For>* loops) {
+      if (extent > 1) {
+        loops->push_back(For(var, 0, IntImm(var.dtype(), extent), ForKind::kSerial, Evaluate(0)));
+      }
+    };
+    std::vector<Var> point_vars(num_spatial);
+    for (size_t i = 0; i < num_spatial; ++i) {
+      const ForNode* loop = nest.spatial[i];
+      const Var& var = loop->loop_var;
+      int64_t extent = Downcast<IntImm>(loop->extent)->value;
+      int64_t t1 = l1[i];
+      // the L2 tile is a multiple of the L1 tile.
+      int64_t t2 = std::max(l2[i], t1);
+      if (t2 % t1 != 0 || extent % t2 != 0) t2 = t1;
+      Var o2(var->name_hint + ".l2", var.dtype());
+      Var o1(var->name_hint + ".l1", var.dtype());
+      point_vars[i] = Var(var->name_hint + ".i", var.dtype());
+      make_loop(o2, extent / t2, &l2_loops);
+      make_loop(o1, t2 / t1, &l1_loops);
+      PrimExpr value = t1 > 1 ? point_vars[i] : make_zero(var.dtype());
+      if (t2 / t1 > 1) value = o1 * IntImm(var.dtype(), t1) + value;
+      if (extent / t2 > 1) value = o2 * IntImm(var.dtype(), t2) + value;
+      vmap.Set(var, value);
+    }
+    // the last reduction loop, split for the L1 tile.
+    const ForNode* last = nest.reduction.back();
+    int64_t last_extent = Downcast<IntImm>(last->extent)->value;
+    int64_t tk = l1[num_spatial];
+    Var ko(last->loop_var->name_hint + ".o", last->loop_var.dtype());
+    Var ki(last->loop_var->name_hint + ".i", last->loop_var.dtype());
+    PrimExpr k = tk > 1 ? ki : make_zero(ki.dtype());
+    if (last_extent / tk > 1) k = ko * IntImm(ki.dtype(), tk) + k;
+    vmap.Set(last->loop_var, k);
+
+    auto wrap_point_loops = [&](Stmt body) {
+      for (auto it = point_order.rbegin(); it != point_order.rend(); ++it) {
+        size_t i = *it;
+        int64_t t1 = l1[i];
+        if (t1 <= 1) continue;
+        ForKind kind = (i == inner && nest.coeffs[i] == 1) ? ForKind::kVectorized
+                                                           : ForKind::kSerial;
+        body = For(point_vars[i], 0, IntImm(point_vars[i].dtype(), t1), kind, body);
+      }
+      return body;
+    };
+    auto wrap = [](const std::vector<For>& loops, Stmt body) {
+      for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+        auto n = make_object<ForNode>(*it->get());
+        n->body = body;
+        body = For(n);
+      }
+      return body;
+    };
+
+    Stmt update = wrap_point_loops(Substitute(GetRef<Stmt>(nest.update), vmap));
+    if (tk > 1) update = For(ki, 0, IntImm(ki.dtype(), tk), ForKind::kSerial, update);
+    if (last_extent / tk > 1) {
+      update = For(ko, 0, IntImm(ko.dtype(), last_extent / tk), ForKind::kSerial, update);
+    }
+    for (size_t i = nest.reduction.size() - 1; i != 0; --i) {
+      const ForNode* loop = nest.reduction[i - 1];
+      update = For(loop->loop_var, loop->min, loop->extent, ForKind::kSerial, update);
+    }
+    Stmt body = update;
+    if (nest.init != nullptr) {
+      Stmt init = wrap_point_loops(Substitute(GetRef<Stmt>(nest.init), vmap));
+      body = SeqStmt({init, update});
+    }
+    return wrap(l2_loops, wrap(l1_loops, body));
+  }
+
+  int64_t l1_bytes_;
+  int64_t l2_bytes_;
+};
+
+namespace transform {
+
+Pass AutoTile() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->kind->name != "llvm") return f;
+    int64_t l1 = target.value()->GetAttr<Integer>("l1-cache-size", Integer(32 * 1024)).value();
+    int64_t l2 = target.value()->GetAttr<Integer>("l2-cache-size", Integer(1024 * 1024)).value();
+    auto* n = f.CopyOnWrite();
+    n->body = AutoTiler(l1, l2)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.AutoTile", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.AutoTile").set_body_typed(AutoTile);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
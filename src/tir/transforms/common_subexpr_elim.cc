@@ -0,0 +1,426 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file common_subexpr_elim.cc
+ * \brief Bind the repeated pure expressions of the statements to LetStmts.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/op_attr_types.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct CommonSubexprElimConfigNode : public tvm::AttrsNode<CommonSubexprElimConfigNode> {
+  int min_ops;
+  bool cross_statement;
+  bool record_stats;
+
+  TVM_DECLARE_ATTRS(CommonSubexprElimConfigNode, "tir.transform.CommonSubexprElimConfig") {
+    TVM_ATTR_FIELD(min_ops)
+        .describe("The minimum number of operations of an expression to be eliminated")
+        .set_default(2);
+    TVM_ATTR_FIELD(cross_statement)
+        .describe(
+            "Eliminate the expressions repeated across the statements of a scope, rather than "
+            "within each statement")
+        .set_default(true);
+    TVM_ATTR_FIELD(record_stats)
+        .describe("Record the number of operations eliminated in the function attrs")
+        .set_default(false);
+  }
+};
+
+class CommonSubexprElimConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(CommonSubexprElimConfig, Attrs,
+                                            CommonSubexprElimConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(CommonSubexprElimConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.CommonSubexprElim", CommonSubexprElimConfig);
+
+/*!
+ * \brief Whether the call updates a state. The arguments of these calls are kept as they are.
+ */
+bool IsStateUpdatingCall(const CallNode* op) {
+  static auto op_call_effect = Op::GetAttrMap<TCallEffectKind>("TCallEffectKind");
+  const auto* ptr_op = op->op.as<OpNode>();
+  return ptr_op == nullptr ||
+         static_cast<CallEffectKind>(op_call_effect[GetRef<Op>(ptr_op)]->value) >=
+             CallEffectKind::kUpdateState;
+}
+
+/*!
+ * \brief Count the occurrences of the subexpressions that can be eliminated, i.e. the scalar
+ * subexpressions that are pure, that cannot trap, and that have at least min_ops operations.
+ */
+class CandidateCounter : public ExprVisitor {
+ public:
+  struct Candidate {
+    /*! \brief The number of occurrences */
+    int count{0};
+    /*! \brief The number of operations of the expression */
+    int num_ops{0};
+    /*! \brief The order of the first occurrence, to break the ties deterministically */
+    int order{0};
+  };
+
+  explicit CandidateCounter(int min_ops) : min_ops_(min_ops) {}
+
+  std::unordered_map<PrimExpr, Candidate, StructuralHash, StructuralEqual> candidates;
+
+  void VisitExpr(const PrimExpr& expr) final {
+    int outer_ops = num_ops_;
+    bool outer_eligible = eligible_;
+    num_ops_ = 0;
+    eligible_ = true;
+    ExprVisitor::VisitExpr(expr);
+    bool is_leaf = expr->IsInstance<VarNode>() || expr->IsInstance<IntImmNode>() ||
+                   expr->IsInstance<FloatImmNode>() || expr->IsInstance<StringImmNode>();
+    if (!is_leaf) {
+      ++num_ops_;
+    }
+    if (eligible_ && !is_leaf && !IsAnnotation(expr) && expr.dtype().lanes() == 1 &&
+        !expr.dtype().is_handle() && num_ops_ >= std::max(min_ops_, 1)) {
+      Candidate& candidate = candidates[expr];
+      if (candidate.count++ == 0) {
+        candidate.num_ops = num_ops_;
+        candidate.order = static_cast<int>(candidates.size());
+      }
+    }
+    num_ops_ += outer_ops;
+    eligible_ = eligible_ && outer_eligible;
+  }
+
+ private:
+  static bool IsAnnotation(const PrimExpr& expr) {
+    const auto* call = expr.as<CallNode>();
+    return call != nullptr && call->op.same_as(builtin::likely());
+  }
+
+  template <typename T>
+  void VisitDivision(const T* op) {
+    const auto* divisor = op->b.template as<IntImmNode>();
+    if ((op->dtype.is_int() || op->dtype.is_uint()) &&
+        (divisor == nullptr || divisor->value == 0)) {
+      eligible_ = false;
+    }
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const DivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const ModNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorDivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorModNode* op) final { VisitDivision(op); }
+
+  void VisitExpr_(const LoadNode* op) final {
+    eligible_ = false;
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    eligible_ = false;
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    static auto op_call_effect = Op::GetAttrMap<TCallEffectKind>("TCallEffectKind");
+    if (IsStateUpdatingCall(op)) {
+      eligible_ = false;
+      return;
+    }
+    if (static_cast<CallEffectKind>(op_call_effect[Downcast<Op>(op->op)]->value) >
+        CallEffectKind::kPure) {
+      eligible_ = false;
+    }
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  // The subexpressions using the var of a Let cannot be moved out of it
+  void VisitExpr_(const LetNode* op) final { eligible_ = false; }
+  void VisitExpr_(const ReduceNode* op) final { eligible_ = false; }
+
+  int min_ops_;
+  int num_ops_{0};
+  bool eligible_{true};
+};
+
+/*! \brief Replace the occurrences of an expression with a var */
+class ExprReplacer : public ExprMutator {
+ public:
+  ExprReplacer(PrimExpr target, Var var) : target_(std::move(target)), var_(std::move(var)) {}
+
+  /*! \brief Replace the occurrences in the strict subexpressions of the expression */
+  PrimExpr ReplaceInChildren(const PrimExpr& expr) { return ExprMutator::VisitExpr(expr); }
+
+  PrimExpr VisitExpr(const PrimExpr& expr) final {
+    if (StructuralEqual()(expr, target_)) {
+      return var_;
+    }
+    const auto* call = expr.as<CallNode>();
+    if (call != nullptr && IsStateUpdatingCall(call)) {
+      return expr;
+    }
+    return ExprMutator::VisitExpr(expr);
+  }
+
+ private:
+  PrimExpr target_;
+  Var var_;
+};
+
+/*! \brief Collect the expressions of the leaf statements, and put back their replacements */
+class LeafExprs {
+ public:
+  /*! \brief Collect the leaf statements sequenced under stmt, not crossing the nested scopes */
+  void Collect(const Stmt& stmt) {
+    if (const auto* seq = stmt.as<SeqStmtNode>()) {
+      for (const Stmt& s : seq->seq) {
+        Collect(s);
+      }
+    } else if (const auto* store = stmt.as<StoreNode>()) {
+      Add(stmt, {store->value, store->index, store->predicate});
+    } else if (const auto* store = stmt.as<BufferStoreNode>()) {
+      Array<PrimExpr> exprs = store->indices;
+      exprs.insert(exprs.begin(), store->value);
+      Add(stmt, exprs);
+    } else if (const auto* eval = stmt.as<EvaluateNode>()) {
+      Add(stmt, {eval->value});
+    }
+  }
+
+  /*! \brief Rebuild the statement, with the leaf statements updated with exprs */
+  Stmt Rebuild(const Stmt& stmt) const {
+    if (const auto* seq = stmt.as<SeqStmtNode>()) {
+      Array<Stmt> seq_stmts;
+      for (const Stmt& s : seq->seq) {
+        seq_stmts.push_back(Rebuild(s));
+      }
+      return SeqStmt(seq_stmts);
+    }
+    auto it = leaf2index_.find(stmt.get());
+    if (it == leaf2index_.end()) {
+      return stmt;
+    }
+    const PrimExpr* e = &exprs[begin_[it->second]];
+    if (const auto* store = stmt.as<StoreNode>()) {
+      return Store(store->buffer_var, e[0], e[1], e[2]);
+    } else if (const auto* store = stmt.as<BufferStoreNode>()) {
+      return BufferStore(store->buffer, e[0],
+                         Array<PrimExpr>(e + 1, e + 1 + store->indices.size()), store->span);
+    } else {
+      return Evaluate(e[0]);
+    }
+  }
+
+  /*! \brief The expressions of the leaf statements, undefined for an absent predicate */
+  std::vector<PrimExpr> exprs;
+
+ private:
+  void Add(const Stmt& stmt, const Array<PrimExpr>& leaf_exprs) {
+    leaf2index_[stmt.get()] = begin_.size();
+    begin_.push_back(exprs.size());
+    for (const PrimExpr& e : leaf_exprs) {
+      exprs.push_back(e);
+    }
+  }
+
+  std::unordered_map<const StmtNode*, size_t> leaf2index_;
+  std::vector<size_t> begin_;
+};
+
+/*!
+ * \brief Bind the repeated pure expressions to new vars.
+ *
+ * The expressions of the leaf statements of a scope, i.e. the stores and evaluations sequenced
+ * right under a function body, a loop body, a branch, or the body of an allocation, a let or
+ * an attribute, are eliminated together, or those of each leaf statement separately without
+ * cross_statement. The repeated expressions are greedily replaced from the largest one, and
+ * bound by LetStmts at the top of the scope, or right before the leaf statement.
+ */
+class CommonSubexprEliminator : public StmtExprMutator {
+ public:
+  explicit CommonSubexprEliminator(const CommonSubexprElimConfig& config) : config_(config) {}
+
+  /*! \brief Eliminate in a scope, after the nested scopes */
+  Stmt EliminateInScope(const Stmt& stmt) {
+    Stmt body = VisitStmt(stmt);
+    if (config_->cross_statement) {
+      return Eliminate(body);
+    }
+    return EliminatePerStatement(body);
+  }
+
+  /*! \brief The number of operations eliminated */
+  int64_t num_removed_ops{0};
+
+ private:
+  Stmt VisitStmt_(const ForNode* op) final {
+    ObjectPtr<ForNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return For(n);
+  }
+
+  Stmt VisitStmt_(const WhileNode* op) final {
+    ObjectPtr<WhileNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return While(n);
+  }
+
+  Stmt VisitStmt_(const IfThenElseNode* op) final {
+    ObjectPtr<IfThenElseNode> n = CopyOnWrite(op);
+    n->then_case = EliminateInScope(op->then_case);
+    if (op->else_case.defined()) {
+      n->else_case = EliminateInScope(op->else_case);
+    }
+    return IfThenElse(n);
+  }
+
+  Stmt VisitStmt_(const LetStmtNode* op) final {
+    ObjectPtr<LetStmtNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return LetStmt(n);
+  }
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    ObjectPtr<AttrStmtNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return AttrStmt(n);
+  }
+
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    ObjectPtr<AllocateNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return Allocate(n);
+  }
+
+  Stmt VisitStmt_(const AssertStmtNode* op) final {
+    ObjectPtr<AssertStmtNode> n = CopyOnWrite(op);
+    n->body = EliminateInScope(op->body);
+    return AssertStmt(n);
+  }
+
+  // The expressions of the blocks are left to the lowering of the blocks
+  Stmt VisitStmt_(const BlockRealizeNode* op) final { return GetRef<Stmt>(op); }
+
+  Stmt EliminatePerStatement(const Stmt& stmt) {
+    if (const auto* seq = stmt.as<SeqStmtNode>()) {
+      Array<Stmt> seq_stmts;
+      for (const Stmt& s : seq->seq) {
+        seq_stmts.push_back(EliminatePerStatement(s));
+      }
+      return SeqStmt(seq_stmts);
+    }
+    return Eliminate(stmt);
+  }
+
+  Stmt Eliminate(const Stmt& stmt) {
+    LeafExprs leaves;
+    leaves.Collect(stmt);
+    std::vector<std::pair<Var, PrimExpr>> bindings;
+    while (true) {
+      CandidateCounter counter(config_->min_ops);
+      for (const PrimExpr& e : leaves.exprs) {
+        if (e.defined()) {
+          counter(e);
+        }
+      }
+      for (const auto& binding : bindings) {
+        counter(binding.second);
+      }
+      const PrimExpr* best = nullptr;
+      const CandidateCounter::Candidate* best_candidate = nullptr;
+      for (const auto& kv : counter.candidates) {
+        const CandidateCounter::Candidate& candidate = kv.second;
+        if (candidate.count < 2) {
+          continue;
+        }
+        if (best == nullptr || candidate.num_ops > best_candidate->num_ops ||
+            (candidate.num_ops == best_candidate->num_ops &&
+             candidate.order < best_candidate->order)) {
+          best = &kv.first;
+          best_candidate = &candidate;
+        }
+      }
+      if (best == nullptr) {
+        break;
+      }
+      num_removed_ops += static_cast<int64_t>(best_candidate->count - 1) * best_candidate->num_ops;
+      Var var("cse", best->dtype());
+      ExprReplacer replacer(*best, var);
+      for (PrimExpr& e : leaves.exprs) {
+        if (e.defined()) {
+          e = replacer(e);
+        }
+      }
+      for (auto& binding : bindings) {
+        binding.second = replacer.ReplaceInChildren(binding.second);
+      }
+      bindings.emplace_back(var, *best);
+    }
+    if (bindings.empty()) {
+      return stmt;
+    }
+    // A binding is a subexpression of the ones created before it, as the larger expressions are
+    // eliminated first, so the later bindings are emitted outside
+    Stmt result = leaves.Rebuild(stmt);
+    for (const auto& binding : bindings) {
+      result = LetStmt(binding.first, binding.second, result);
+    }
+    return result;
+  }
+
+  CommonSubexprElimConfig config_;
+};
+
+namespace transform {
+
+Pass CommonSubexprElim() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<CommonSubexprElimConfig>("tir.CommonSubexprElim");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<CommonSubexprElimConfig>();
+    }
+    CommonSubexprEliminator eliminator(cfg.value());
+    auto* n = f.CopyOnWrite();
+    n->body = eliminator.EliminateInScope(std::move(n->body));
+    if (cfg.value()->record_stats) {
+      f = WithAttr(std::move(f), "tir.cse_removed_ops", Integer(eliminator.num_removed_ops));
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.CommonSubexprElim", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.CommonSubexprElim").set_body_typed(CommonSubexprElim);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
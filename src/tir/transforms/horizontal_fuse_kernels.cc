@@ -0,0 +1,217 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file horizontal_fuse_kernels.cc
+ * \brief Pack consecutive independent kernels into a single kernel.
+ *
+ *  Each kernel of the sequence is a thread block grid over blockIdx.x and
+ *  threadIdx.x. The packed kernel launches the sum of their blocks and the
+ *  maximum of their threads, each block running the body of the kernel its
+ *  index falls in:
+ *
+ *    // attr [blockIdx.x] thread_extent = n0 + n1
+ *    // attr [threadIdx.x] thread_extent = max(t0, t1)
+ *    if (blockIdx.x < n0) {
+ *      if (threadIdx.x < t0) body0(blockIdx.x, threadIdx.x)
+ *    } else {
+ *      if (threadIdx.x < t1) body1(blockIdx.x - n0, threadIdx.x)
+ *    }
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief A kernel which can be packed with others. */
+struct PackableKernel {
+  Stmt stmt;
+  IterVar block;
+  IterVar thread;
+  int64_t num_blocks;
+  int64_t num_threads;
+  Stmt body;
+  std::unordered_set<const VarNode*> reads;
+  std::unordered_set<const VarNode*> writes;
+
+  /*!
+   * \brief Match a one dimensional grid, whose body has no synchronization.
+   *  The guard on the thread index of a packed kernel would make it divergent.
+   */
+  static bool Match(const Stmt& stmt, PackableKernel* kernel) {
+    auto as_thread_extent = [](const Stmt& s, const char* tag, IterVar* iv, int64_t* extent) {
+      const auto* attr = s.as<AttrStmtNode>();
+      if (attr == nullptr || attr->attr_key != attr::thread_extent) return false;
+      const auto* imm = attr->value.as<IntImmNode>();
+      const auto* var = attr->node.as<IterVarNode>();
+      if (imm == nullptr || var == nullptr || var->thread_tag != tag) return false;
+      *iv = GetRef<IterVar>(var);
+      *extent = imm->value;
+      return true;
+    };
+    const auto* outer = stmt.as<AttrStmtNode>();
+    if (outer == nullptr ||
+        !as_thread_extent(stmt, "blockIdx.x", &kernel->block, &kernel->num_blocks) ||
+        !as_thread_extent(outer->body, "threadIdx.x", &kernel->thread, &kernel->num_threads)) {
+      return false;
+    }
+    kernel->stmt = stmt;
+    kernel->body = outer->body.as<AttrStmtNode>()->body;
+    bool packable = true;
+    PostOrderVisit(kernel->body, [&](const ObjectRef& node) {
+      if (const auto* attr = node.as<AttrStmtNode>()) {
+        if (attr->attr_key == attr::thread_extent || attr->attr_key == attr::virtual_thread) {
+          packable = false;
+        }
+      } else if (node->IsInstance<AllocateNode>()) {
+        packable = false;
+      } else if (const auto* call = node.as<CallNode>()) {
+        if (call->op.same_as(builtin::tvm_storage_sync())) packable = false;
+      } else if (const auto* load = node.as<LoadNode>()) {
+        kernel->reads.insert(load->buffer_var.get());
+      } else if (const auto* store = node.as<StoreNode>()) {
+        kernel->writes.insert(store->buffer_var.get());
+      } else if (const auto* load = node.as<BufferLoadNode>()) {
+        kernel->reads.insert(load->buffer->data.get());
+      } else if (const auto* store = node.as<BufferStoreNode>()) {
+        kernel->writes.insert(store->buffer->data.get());
+      }
+    });
+    return packable;
+  }
+};
+
+class KernelPacker : public StmtMutator {
+ public:
+  Stmt VisitStmt_(const SeqStmtNode* op) final {
+    Stmt ret = StmtMutator::VisitStmt_(op);
+    op = ret.as<SeqStmtNode>();
+    if (op == nullptr) return ret;
+    std::vector<Stmt> seq;
+    std::vector<PackableKernel> run;
+    for (const Stmt& stmt : op->seq) {
+      PackableKernel kernel;
+      if (PackableKernel::Match(stmt, &kernel)) {
+        if (!CanJoin(run, kernel)) Flush(&run, &seq);
+        run.push_back(std::move(kernel));
+      } else {
+        Flush(&run, &seq);
+        seq.push_back(stmt);
+      }
+    }
+    Flush(&run, &seq);
+    return SeqStmt::Flatten(seq);
+  }
+
+ private:
+  // A kernel joins the run if it does not depend on the kernels of the run, and they do
+  // not depend on it, as the blocks of a packed kernel run in any order.
+  static bool CanJoin(const std::vector<PackableKernel>& run, const PackableKernel& kernel) {
+    if (run.empty()) return true;
+    if (run[0].block->var.dtype() != kernel.block->var.dtype() ||
+        run[0].thread->var.dtype() != kernel.thread->var.dtype()) {
+      return false;
+    }
+    int64_t num_blocks = kernel.num_blocks;
+    for (const PackableKernel& other : run) {
+      for (const VarNode* buffer : kernel.writes) {
+        if (other.reads.count(buffer) || other.writes.count(buffer)) return false;
+      }
+      for (const VarNode* buffer : kernel.reads) {
+        if (other.writes.count(buffer)) return false;
+      }
+      num_blocks += other.num_blocks;
+    }
+    return num_blocks <= std::numeric_limits<int32_t>::max();
+  }
+
+  static void Flush(std::vector<PackableKernel>* run, std::vector<Stmt>* seq) {
+    if (run->empty()) return;
+    if (run->size() == 1) {
+      seq->push_back(run->at(0).stmt);
+      run->clear();
+      return;
+    }
+    DataType block_dtype = run->at(0).block->var.dtype();
+    DataType thread_dtype = run->at(0).thread->var.dtype();
+    int64_t num_blocks = 0, num_threads = 0;
+    std::vector<int64_t> offsets;
+    for (const PackableKernel& kernel : *run) {
+      offsets.push_back(num_blocks);
+      num_blocks += kernel.num_blocks;
+      num_threads = std::max(num_threads, kernel.num_threads);
+    }
+    IterVar block(Range::FromMinExtent(make_zero(block_dtype), make_const(block_dtype, num_blocks)),
+                  Var("blockIdx.x", block_dtype), kThreadIndex, "blockIdx.x");
+    IterVar thread(
+        Range::FromMinExtent(make_zero(thread_dtype), make_const(thread_dtype, num_threads)),
+        Var("threadIdx.x", thread_dtype), kThreadIndex, "threadIdx.x");
+    Stmt body;
+    for (size_t i = run->size(); i-- > 0;) {
+      const PackableKernel& kernel = run->at(i);
+      Map<Var, PrimExpr> vmap;
+      vmap.Set(kernel.block->var, block->var - make_const(block_dtype, offsets[i]));
+      vmap.Set(kernel.thread->var, thread->var);
+      Stmt kernel_body = Substitute(kernel.body, vmap);
+      if (kernel.num_threads < num_threads) {
+        kernel_body =
+            IfThenElse(thread->var < make_const(thread_dtype, kernel.num_threads), kernel_body);
+      }
+      if (!body.defined()) {
+        body = kernel_body;
+      } else {
+        PrimExpr cond = block->var < make_const(block_dtype, offsets[i + 1]);
+        body = IfThenElse(cond, kernel_body, body);
+      }
+    }
+    body = AttrStmt(thread, attr::thread_extent, make_const(thread_dtype, num_threads), body);
+    body = AttrStmt(block, attr::thread_extent, make_const(block_dtype, num_blocks), body);
+    seq->push_back(body);
+    run->clear();
+  }
+};
+
+namespace transform {
+
+Pass HorizontalFuseKernels() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    if (!f->HasNonzeroAttr(attr::kHorizontalFusion)) return f;
+    auto* n = f.CopyOnWrite();
+    n->body = KernelPacker()(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.HorizontalFuseKernels", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.HorizontalFuseKernels").set_body_typed(HorizontalFuseKernels);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -19,6 +19,12 @@
 
 /*!
  * \brief Inject double buffering optimization for data fetch.
+ *
+ *  The value of the double_buffer_scope attribute is the number of buffers of the ring, the
+ *  fetches run that many iterations minus one ahead of their use. A value of 1 is double
+ *  buffering, as with a value of 2. With use_async_copy, the copies of a global buffer into
+ *  shared memory are issued with cp.async, one commit group per iteration, and each iteration
+ *  waits for the group of the buffer it reads.
  * \file inject_double_buffer.cc
  */
 #include <tvm/runtime/registry.h>
@@ -26,6 +32,10 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
 #include "ir_utils.h"
 
 namespace tvm {
@@ -33,9 +43,13 @@ namespace tir {
 
 struct InjectDoubleBufferConfigNode : public tvm::AttrsNode<InjectDoubleBufferConfigNode> {
   int split_loop;
+  bool use_async_copy;
 
   TVM_DECLARE_ATTRS(InjectDoubleBufferConfigNode, "tir.transform.InjectDoubleBufferConfig") {
     TVM_ATTR_FIELD(split_loop).describe("Split loop factors").set_default(1);
+    TVM_ATTR_FIELD(use_async_copy)
+        .describe("Fetch global memory into shared memory with the async copies of CUDA sm_80")
+        .set_default(false);
   }
 };
 
@@ -80,9 +94,61 @@ class StripDoubleBufferWrite : public StmtMutator {
   }
 };
 
+/*!
+ * \brief Rewrite the copies of global memory into a shared buffer as async copies.
+ *
+ *  A store of a load, of 4, 8 or 16 contiguous bytes, becomes a ptx_cp_async. The other stores,
+ *  e.g. of computed values or of padding, stay synchronous.
+ */
+class AsyncCopyRewriter : public StmtMutator {
+ public:
+  AsyncCopyRewriter(const VarNode* buffer,
+                    const std::unordered_map<const VarNode*, std::string>& scopes)
+      : buffer_(buffer), scopes_(scopes) {}
+
+  Stmt VisitStmt_(const StoreNode* op) final {
+    const auto* load = op->value.as<LoadNode>();
+    if (op->buffer_var.get() != buffer_ || load == nullptr || !is_one(op->predicate) ||
+        !is_one(load->predicate)) {
+      return GetRef<Stmt>(op);
+    }
+    auto it = scopes_.find(load->buffer_var.get());
+    if (it != scopes_.end() && it->second != "global") {
+      return GetRef<Stmt>(op);
+    }
+    int bytes = op->value.dtype().bytes() * op->value.dtype().lanes();
+    PrimExpr dst_offset = ContiguousBase(op->index);
+    PrimExpr src_offset = ContiguousBase(load->index);
+    if ((bytes != 4 && bytes != 8 && bytes != 16) || !dst_offset.defined() ||
+        !src_offset.defined()) {
+      return GetRef<Stmt>(op);
+    }
+    DataType elem = op->value.dtype().element_of();
+    int lanes = op->value.dtype().lanes();
+    PrimExpr dst = Call(DataType::Handle(), builtin::tvm_access_ptr(),
+                        {TypeAnnotation(elem), op->buffer_var, dst_offset, lanes, 2});
+    PrimExpr src = Call(DataType::Handle(), builtin::tvm_access_ptr(),
+                        {TypeAnnotation(elem), load->buffer_var, src_offset, lanes, 1});
+    return Evaluate(Call(DataType::Void(), builtin::ptx_cp_async(), {dst, src, bytes}));
+  }
+
+ private:
+  // The first element of a contiguous index, undefined if it is not contiguous.
+  static PrimExpr ContiguousBase(const PrimExpr& index) {
+    if (const auto* ramp = index.as<RampNode>()) {
+      return is_one(ramp->stride) ? ramp->base : PrimExpr();
+    }
+    return index.dtype().lanes() == 1 ? index : PrimExpr();
+  }
+
+  const VarNode* buffer_;
+  const std::unordered_map<const VarNode*, std::string>& scopes_;
+};
+
 class DoubleBufferInjector : public StmtExprMutator {
  public:
-  explicit DoubleBufferInjector(int split_loop) : split_loop_(split_loop) {}
+  DoubleBufferInjector(int split_loop, bool use_async_copy)
+      : split_loop_(split_loop), use_async_copy_(use_async_copy) {}
 
   Stmt Inject(Stmt stmt) {
     DoubleBufferDetector detector;
@@ -97,6 +163,7 @@ class DoubleBufferInjector : public StmtExprMutator {
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::storage_scope) {
       const VarNode* buf = op->node.as<VarNode>();
+      storage_scopes_[buf] = op->value.as<StringImmNode>()->value;
       auto it = dbuffer_info_.find(buf);
       if (it != dbuffer_info_.end()) {
         it->second.scope = op->value.as<StringImmNode>()->value;
@@ -119,11 +186,11 @@ class DoubleBufferInjector : public StmtExprMutator {
                           op->dtype.lanes();
       Stmt stmt = StmtExprMutator::VisitStmt_(op);
       op = stmt.as<AllocateNode>();
-      Array<PrimExpr> new_extents{make_const(op->extents[0].dtype(), 2)};
+      ICHECK(it->second.loop != nullptr);
+      Array<PrimExpr> new_extents{make_const(op->extents[0].dtype(), it->second.num_stages)};
       for (PrimExpr e : op->extents) {
         new_extents.push_back(e);
       }
-      ICHECK(it->second.loop != nullptr);
       auto& alloc_nest = loop_allocs_[it->second.loop];
       alloc_nest.emplace_back(
           AttrStmt(op->buffer_var, attr::storage_scope, StringImm(it->second.scope), Evaluate(0)));
@@ -225,24 +292,49 @@ class DoubleBufferInjector : public StmtExprMutator {
     }
     StorageEntry& e = it->second;
     e.loop = loop_nest_.back();
-    PrimExpr zero = make_const(e.loop->loop_var.dtype(), 0);
-    PrimExpr one = make_const(e.loop->loop_var.dtype(), 1);
-    PrimExpr two = make_const(e.loop->loop_var.dtype(), 2);
-    PrimExpr loop_shift = e.loop->loop_var + one;
-    e.switch_write_var = Var(e.loop->loop_var->name_hint + ".db", e.loop->loop_var.dtype());
-    e.switch_read_var = indexmod(e.loop->loop_var, two);
+    const auto* stages = op->value.as<IntImmNode>();
+    e.num_stages = stages ? std::max<int>(stages->value, 2) : 2;
+    DataType dtype = e.loop->loop_var.dtype();
+    PrimExpr num_stages = make_const(dtype, e.num_stages);
+    PrimExpr loop_shift = e.loop->loop_var + make_const(dtype, e.num_stages - 1);
+    e.switch_write_var = Var(e.loop->loop_var->name_hint + ".db", dtype);
+    e.switch_read_var = indexmod(e.loop->loop_var, num_stages);
     in_double_buffer_scope_ = true;
     Stmt body = this->VisitStmt(op->body);
     in_double_buffer_scope_ = false;
+    bool async_copy = use_async_copy_ && e.scope == "shared";
+    if (async_copy) {
+      body = AsyncCopyRewriter(buffer.get(), storage_scopes_)(body);
+    }
+    Stmt commit = Evaluate(Call(DataType::Void(), builtin::ptx_commit_group(), {}));
+    // The fetches of the first iterations, before the loop.
     std::unordered_map<const VarNode*, PrimExpr> vmap;
-    vmap[e.switch_write_var.get()] = zero;
-    vmap[e.loop->loop_var.get()] = zero;
-    loop_pre_[e.loop].emplace_back(Substitute(body, vmap));
+    for (int i = 0; i < e.num_stages - 1; ++i) {
+      PrimExpr stage = make_const(dtype, i);
+      vmap[e.switch_write_var.get()] = stage;
+      vmap[e.loop->loop_var.get()] = stage;
+      Stmt prologue = Substitute(body, vmap);
+      if (i != 0) {
+        prologue = IfThenElse(stage < e.loop->extent, prologue);
+      }
+      loop_pre_[e.loop].emplace_back(prologue);
+      if (async_copy) {
+        loop_pre_[e.loop].emplace_back(commit);
+      }
+    }
     vmap[e.loop->loop_var.get()] = loop_shift;
-    vmap[e.switch_write_var.get()] = indexmod(loop_shift, two);
+    vmap[e.switch_write_var.get()] = indexmod(loop_shift, num_stages);
     body = Substitute(body, vmap);
     body = AttrStmt(buffer, attr::double_buffer_write, 1, body);
     body = IfThenElse(loop_shift < e.loop->extent, body);
+    if (async_copy) {
+      // The group of each iteration is committed, empty past the end of the loop, so that
+      // waiting for all but the last num_stages - 1 groups completes the group of the buffer
+      // read by the iteration.
+      Stmt wait = Evaluate(
+          Call(DataType::Void(), builtin::ptx_wait_group(), {Integer(e.num_stages - 1)}));
+      body = SeqStmt({body, commit, wait});
+    }
     return body;
   }
   // Storage entry for those who need double buffering.
@@ -255,11 +347,17 @@ class DoubleBufferInjector : public StmtExprMutator {
     Var switch_write_var;
     // The switch variable for reading.
     PrimExpr switch_read_var;
+    // The number of buffers of the ring.
+    int num_stages{2};
     // The storage scope.
     std::string scope;
   };
   // Whether split loop
   int32_t split_loop_;
+  // Whether the fetches into shared memory are async copies.
+  bool use_async_copy_;
+  // The storage scope of the allocated buffers.
+  std::unordered_map<const VarNode*, std::string> storage_scopes_;
   // Whether we are inside double buffer scope.
   bool in_double_buffer_scope_{false};
   // The current loop next
@@ -281,7 +379,8 @@ Pass InjectDoubleBuffer() {
     if (!cfg.defined()) {
       cfg = AttrsWithDefaultValues<InjectDoubleBufferConfig>();
     }
-    n->body = DoubleBufferInjector(cfg.value()->split_loop).Inject(std::move(n->body));
+    n->body = DoubleBufferInjector(cfg.value()->split_loop, cfg.value()->use_async_copy)
+                  .Inject(std::move(n->body));
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.InjectDoubleBuffer", {});
@@ -0,0 +1,210 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Prefetch the strided loads of the innermost loops of the CPU kernels.
+ *
+ *  The hardware prefetchers follow the contiguous streams; a load whose address advances by
+ *  a cache line or more per iteration misses each time. Such a load is prefetched d
+ *  iterations ahead, d covering the memory latency with the estimated cost of an iteration.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct InjectSoftwarePrefetchConfigNode
+    : public tvm::AttrsNode<InjectSoftwarePrefetchConfigNode> {
+  int distance;
+  int cache_line_bytes;
+  int memory_latency;
+  int max_streams;
+
+  TVM_DECLARE_ATTRS(InjectSoftwarePrefetchConfigNode,
+                    "tir.transform.InjectSoftwarePrefetchConfig") {
+    TVM_ATTR_FIELD(distance)
+        .describe("The prefetch distance in iterations, 0 to derive it from the latency")
+        .set_default(0);
+    TVM_ATTR_FIELD(cache_line_bytes)
+        .describe("The size of a cache line, the loads of smaller strides are not prefetched")
+        .set_default(64);
+    TVM_ATTR_FIELD(memory_latency)
+        .describe("The latency of a load from memory, in the cost units of an expression node")
+        .set_default(200);
+    TVM_ATTR_FIELD(max_streams)
+        .describe("The maximum number of loads prefetched in a loop")
+        .set_default(8);
+  }
+};
+
+class InjectSoftwarePrefetchConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(InjectSoftwarePrefetchConfig, Attrs,
+                                            InjectSoftwarePrefetchConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(InjectSoftwarePrefetchConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.InjectSoftwarePrefetch", InjectSoftwarePrefetchConfig);
+
+/*! \brief The strided loads of a loop body, and the number of its expression nodes. */
+class StridedLoadCollector : public StmtExprVisitor {
+ public:
+  struct Stream {
+    const LoadNode* load;
+    // The index of the first lane.
+    PrimExpr index;
+    // The stride in bytes.
+    int64_t stride_bytes;
+  };
+
+  StridedLoadCollector(Var loop_var, int64_t min_stride_bytes)
+      : loop_var_(loop_var), min_stride_bytes_(min_stride_bytes) {}
+
+  void VisitExpr(const PrimExpr& e) final {
+    ++num_nodes;
+    StmtExprVisitor::VisitExpr(e);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    has_inner_loop = true;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const WhileNode* op) final {
+    has_inner_loop = true;
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LoadNode* op) final {
+    StmtExprVisitor::VisitExpr_(op);
+    PrimExpr index = op->index;
+    if (const auto* ramp = index.as<RampNode>()) index = ramp->base;
+    if (!IsAffineAddress(index)) return;
+    Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {loop_var_});
+    if (coeffs.size() != 2) return;
+    const auto* stride = coeffs[0].as<IntImmNode>();
+    if (stride == nullptr) return;
+    int64_t stride_bytes = stride->value * op->dtype.bytes();
+    if (std::abs(stride_bytes) < min_stride_bytes_) return;
+    for (const Stream& s : streams) {
+      if (s.load->buffer_var.same_as(op->buffer_var) && StructuralEqual()(s.index, index)) return;
+    }
+    streams.push_back({op, index, stride_bytes});
+  }
+
+  bool has_inner_loop{false};
+  int64_t num_nodes{0};
+  std::vector<Stream> streams;
+
+ private:
+  // The address must not depend on another load, the prefetch would load it ahead.
+  static bool IsAffineAddress(const PrimExpr& index) {
+    bool has_load = false;
+    PostOrderVisit(index, [&has_load](const ObjectRef& n) {
+      if (n->IsInstance<LoadNode>()) has_load = true;
+    });
+    return !has_load;
+  }
+
+  Var loop_var_;
+  int64_t min_stride_bytes_;
+};
+
+class SoftwarePrefetchInjector : public StmtMutator {
+ public:
+  explicit SoftwarePrefetchInjector(const InjectSoftwarePrefetchConfig& config)
+      : config_(config) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    op = stmt.as<ForNode>();
+    if (op->kind != ForKind::kSerial && op->kind != ForKind::kUnrolled) return stmt;
+    if (is_const_int(op->extent, 1)) return stmt;
+    StridedLoadCollector collector(op->loop_var, config_->cache_line_bytes);
+    collector(op->body);
+    if (collector.has_inner_loop || collector.streams.empty()) return stmt;
+
+    int64_t distance = config_->distance;
+    if (distance <= 0) {
+      int64_t cost = std::max<int64_t>(collector.num_nodes, 1);
+      distance = std::max<int64_t>((config_->memory_latency + cost - 1) / cost, 1);
+    }
+    if (const auto* extent = op->extent.as<IntImmNode>()) {
+      // nothing to overlap when the whole loop is shorter than the latency.
+      if (extent->value <= distance) return stmt;
+    }
+    size_t num_streams = std::min<size_t>(collector.streams.size(), config_->max_streams);
+    Map<Var, PrimExpr> ahead;
+    ahead.Set(op->loop_var, op->loop_var + make_const(op->loop_var.dtype(), distance));
+    Array<Stmt> seq;
+    for (size_t i = 0; i < num_streams; ++i) {
+      const auto& s = collector.streams[i];
+      PrimExpr index = analyzer_.Simplify(Substitute(s.index, ahead));
+      DataType dtype = s.load->dtype.element_of();
+      PrimExpr load = Load(dtype, s.load->buffer_var, index, const_true());
+      PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+      // a read, kept in all the cache levels.
+      seq.push_back(Evaluate(Call(DataType::Int(32), builtin::prefetch(), {address, 0, 3, 1})));
+    }
+    seq.push_back(op->body);
+    auto n = CopyOnWrite(op);
+    n->body = SeqStmt(seq);
+    return For(n);
+  }
+
+ private:
+  InjectSoftwarePrefetchConfig config_;
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->kind->name != "llvm") return f;
+    auto cfg = ctx->GetConfig<InjectSoftwarePrefetchConfig>("tir.InjectSoftwarePrefetch");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<InjectSoftwarePrefetchConfig>();
+    }
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(cfg.value())(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
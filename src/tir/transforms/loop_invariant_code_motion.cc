@@ -0,0 +1,352 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file loop_invariant_code_motion.cc
+ * \brief Hoist the loop invariant expressions out of the loops into LetStmts.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/op_attr_types.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+struct LoopInvariantCodeMotionConfigNode
+    : public tvm::AttrsNode<LoopInvariantCodeMotionConfigNode> {
+  int min_ops;
+  bool record_stats;
+
+  TVM_DECLARE_ATTRS(LoopInvariantCodeMotionConfigNode,
+                    "tir.transform.LoopInvariantCodeMotionConfig") {
+    TVM_ATTR_FIELD(min_ops)
+        .describe("The minimum number of operations of an expression to be hoisted")
+        .set_default(1);
+    TVM_ATTR_FIELD(record_stats)
+        .describe("Record the number of operations removed from the loops in the function attrs")
+        .set_default(false);
+  }
+};
+
+class LoopInvariantCodeMotionConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(LoopInvariantCodeMotionConfig, Attrs,
+                                            LoopInvariantCodeMotionConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(LoopInvariantCodeMotionConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.LoopInvariantCodeMotion", LoopInvariantCodeMotionConfig);
+
+/*!
+ * \brief Count the operations of an expression, i.e. the nodes other than the vars and the
+ * constants, and check if evaluating it may trap, i.e. if it has an integer division by a value
+ * that is not a non-zero constant.
+ */
+class OpCounter : public ExprVisitor {
+ public:
+  static std::pair<int, bool> Count(const PrimExpr& expr) {
+    OpCounter counter;
+    counter(expr);
+    return {counter.num_ops_, counter.may_trap_};
+  }
+
+ private:
+  void VisitExpr(const PrimExpr& expr) final {
+    if (!expr->IsInstance<VarNode>() && !expr->IsInstance<IntImmNode>() &&
+        !expr->IsInstance<FloatImmNode>() && !expr->IsInstance<StringImmNode>()) {
+      ++num_ops_;
+    }
+    ExprVisitor::VisitExpr(expr);
+  }
+
+  template <typename T>
+  void VisitDivision(const T* op) {
+    const auto* divisor = op->b.template as<IntImmNode>();
+    if (op->dtype.is_int() || op->dtype.is_uint()) {
+      may_trap_ |= divisor == nullptr || divisor->value == 0;
+    }
+    ExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const DivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const ModNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorDivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorModNode* op) final { VisitDivision(op); }
+
+  int num_ops_{0};
+  bool may_trap_{false};
+};
+
+/*! \brief Collect the vars defined in a statement. */
+class DefinedVarCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_set<const VarNode*> Collect(const Stmt& stmt) {
+    DefinedVarCollector collector;
+    collector(stmt);
+    return std::move(collector.defined_);
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    defined_.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const LetStmtNode* op) final {
+    defined_.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const AllocateNode* op) final {
+    defined_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (const auto* iv = op->node.as<IterVarNode>()) {
+      defined_.insert(iv->var.get());
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+  void VisitExpr_(const LetNode* op) final {
+    defined_.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  std::unordered_set<const VarNode*> defined_;
+};
+
+/*! \brief Whether the invariant expressions can be hoisted out of a loop of the kind. */
+bool IsHoistableLoop(const ForNode* loop) {
+  return loop->kind == ForKind::kSerial || loop->kind == ForKind::kParallel ||
+         loop->kind == ForKind::kUnrolled || loop->kind == ForKind::kVectorized;
+}
+
+/*!
+ * \brief Hoist the loop invariant expressions out of the loops.
+ *
+ * The loops are visited from the innermost one. The maximal subexpressions of a loop body that
+ * are invariant in the loop, i.e. that use no var defined in the loop, and that are pure and
+ * cannot trap, are bound to a new var by a LetStmt right outside the loop. When the enclosing
+ * loop is visited, these LetStmts are moved out of it too if their values are invariant in it,
+ * so each expression ends up bound outside the outermost loop it is invariant in.
+ *
+ * The pass does not move the expressions across the thread bindings, the blocks, and the loops
+ * of other kinds, nor out of the calls that update a state.
+ */
+class LoopInvariantCodeMotion : public StmtExprMutator {
+ public:
+  explicit LoopInvariantCodeMotion(int min_ops) : min_ops_(min_ops) {}
+
+  /*! \brief The number of operations removed from the loops */
+  int64_t num_removed_ops{0};
+
+ private:
+  /*! \brief The state of the loop the invariant expressions are hoisted out of */
+  struct Frame {
+    /*! \brief The vars defined in the loop, including its loop var */
+    std::unordered_set<const VarNode*> defined;
+    /*! \brief The bindings hoisted out of the loop, in the order they are emitted */
+    std::vector<std::pair<Var, PrimExpr>> bindings;
+    /*! \brief The var bound to each hoisted expression */
+    std::unordered_map<PrimExpr, Var, StructuralHash, StructuralEqual> expr2var;
+  };
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    if (hoisting_) {
+      return StmtExprMutator::VisitStmt_(op);
+    }
+    // Hoist the invariant expressions out of the inner loops first
+    For loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    if (!IsHoistableLoop(loop.get())) {
+      return std::move(loop);
+    }
+    Frame frame;
+    frame.defined = DefinedVarCollector::Collect(loop->body);
+    frame.defined.insert(loop->loop_var.get());
+    std::swap(frame_, frame);
+    Stmt body = Hoist(loop->body);
+    std::swap(frame_, frame);
+    if (frame.bindings.empty()) {
+      return std::move(loop);
+    }
+    ObjectPtr<ForNode> n = CopyOnWrite(loop.get());
+    n->body = std::move(body);
+    Stmt result = For(n);
+    for (auto it = frame.bindings.rbegin(); it != frame.bindings.rend(); ++it) {
+      hoisted_vars_.insert(it->first.get());
+      result = LetStmt(it->first, it->second, result);
+    }
+    return result;
+  }
+
+  /*! \brief Hoist the invariant expressions of the statement out of the loop of frame_ */
+  Stmt Hoist(const Stmt& stmt) {
+    hoisting_ = true;
+    Stmt result = VisitStmt(stmt);
+    hoisting_ = false;
+    return result;
+  }
+
+  Stmt VisitStmt(const Stmt& stmt) final {
+    if (!hoisting_) {
+      return StmtExprMutator::VisitStmt(stmt);
+    }
+    // The expressions are not hoisted across these statements
+    if (const auto* loop = stmt.as<ForNode>()) {
+      if (!IsHoistableLoop(loop)) {
+        return stmt;
+      }
+    } else if (const auto* attr = stmt.as<AttrStmtNode>()) {
+      if (attr->attr_key == attr::thread_extent || attr->attr_key == attr::virtual_thread) {
+        return stmt;
+      }
+    } else if (stmt->IsInstance<BlockRealizeNode>() || stmt->IsInstance<BlockNode>()) {
+      return stmt;
+    }
+    return HoistingVisitStmt(stmt);
+  }
+
+  Stmt HoistingVisitStmt(const Stmt& stmt) {
+    if (const auto* let = stmt.as<LetStmtNode>()) {
+      // A LetStmt emitted by this pass for an inner loop is moved out of the loop too
+      if (hoisted_vars_.count(let->var.get()) && IsInvariant(let->value)) {
+        PrimExpr value = Remap(let->value);
+        auto it = frame_.expr2var.find(value);
+        if (it != frame_.expr2var.end()) {
+          var_remap_[let->var.get()] = it->second;
+          num_removed_ops += OpCounter::Count(value).first;
+        } else {
+          frame_.expr2var[value] = let->var;
+          frame_.bindings.emplace_back(let->var, value);
+        }
+        frame_.defined.erase(let->var.get());
+        return VisitStmt(let->body);
+      }
+    }
+    return StmtExprMutator::VisitStmt(stmt);
+  }
+
+  PrimExpr VisitExpr(const PrimExpr& expr) final {
+    if (!hoisting_) {
+      return StmtExprMutator::VisitExpr(expr);
+    }
+    bool hoist_self = true;
+    if (const auto* call = expr.as<CallNode>()) {
+      if (SideEffect(expr) >= CallEffectKind::kUpdateState) {
+        return expr;
+      }
+      // Keep the annotation on the condition, the invariant parts of which are still hoisted
+      hoist_self = !call->op.same_as(builtin::likely());
+    }
+    if (hoist_self && expr.dtype().lanes() == 1 && !expr.dtype().is_handle() && IsInvariant(expr) &&
+        SideEffect(expr) <= CallEffectKind::kPure) {
+      PrimExpr value = Remap(expr);
+      int num_ops;
+      bool may_trap;
+      std::tie(num_ops, may_trap) = OpCounter::Count(value);
+      if (!may_trap && num_ops >= std::max(min_ops_, 1)) {
+        num_removed_ops += num_ops;
+        auto it = frame_.expr2var.find(value);
+        if (it != frame_.expr2var.end()) {
+          return it->second;
+        }
+        Var var("inv", value.dtype());
+        frame_.expr2var[value] = var;
+        frame_.bindings.emplace_back(var, value);
+        return std::move(var);
+      }
+    }
+    return StmtExprMutator::VisitExpr(expr);
+  }
+
+  PrimExpr VisitExpr_(const VarNode* op) final {
+    auto it = var_remap_.find(op);
+    if (it != var_remap_.end()) {
+      return it->second;
+    }
+    return GetRef<PrimExpr>(op);
+  }
+
+  /*! \brief Replace the vars of the duplicated bindings in an expression hoisted as a whole */
+  PrimExpr Remap(const PrimExpr& expr) const {
+    if (var_remap_.empty()) {
+      return expr;
+    }
+    return Substitute(expr, [this](const Var& var) -> Optional<PrimExpr> {
+      auto it = var_remap_.find(var.get());
+      if (it != var_remap_.end()) {
+        return it->second;
+      }
+      return NullOpt;
+    });
+  }
+
+  bool IsInvariant(const PrimExpr& expr) const {
+    return !ExprUseVar(expr, [this](const VarNode* var) {
+      return frame_.defined.count(var) && !var_remap_.count(var);
+    });
+  }
+
+  /*! \brief The minimum number of operations of an expression to be hoisted */
+  int min_ops_;
+  /*! \brief Whether the invariant expressions of a loop body are being hoisted */
+  bool hoisting_{false};
+  /*! \brief The loop the invariant expressions are hoisted out of */
+  Frame frame_;
+  /*! \brief The vars bound by the LetStmts emitted by this pass */
+  std::unordered_set<const VarNode*> hoisted_vars_;
+  /*! \brief The vars of the duplicated bindings, to the equivalent var kept */
+  std::unordered_map<const VarNode*, Var> var_remap_;
+};
+
+namespace transform {
+
+Pass LoopInvariantCodeMotion() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto cfg = ctx->GetConfig<LoopInvariantCodeMotionConfig>("tir.LoopInvariantCodeMotion");
+    if (!cfg.defined()) {
+      cfg = AttrsWithDefaultValues<LoopInvariantCodeMotionConfig>();
+    }
+    tir::LoopInvariantCodeMotion mutator(cfg.value()->min_ops);
+    auto* n = f.CopyOnWrite();
+    n->body = mutator(std::move(n->body));
+    if (cfg.value()->record_stats) {
+      f = WithAttr(std::move(f), "tir.licm_removed_ops", Integer(mutator.num_removed_ops));
+    }
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.LoopInvariantCodeMotion", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.LoopInvariantCodeMotion")
+    .set_body_typed(LoopInvariantCodeMotion);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -19,6 +19,13 @@
 
 /*!
  * \file loop_partition.cc
+ * \brief Partition the loops into the ranges in which their conditions are constant.
+ *
+ *  By default only the likely conditions are partitioned. With partition_if_then_else, the
+ *  conditions of the if_then_else and of the if statements are too, each conjunct of a
+ *  condition on its own, so that the boundary checks of a padded nest split every loop of
+ *  the nest into its interior and its boundaries. max_code_growth bounds the duplication of
+ *  the bodies, the outer loops being partitioned first.
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/arith/bound.h>
@@ -28,6 +35,8 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -41,12 +50,24 @@ namespace tir {
 struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode> {
   bool partition_const_loop;
   bool no_unroll_loop_with_extent_one;
+  bool partition_if_then_else;
+  double max_code_growth;
+  bool record_decisions;
 
   TVM_DECLARE_ATTRS(LoopPartitionConfigNode, "tir.transform.LoopPartitionConfig") {
     TVM_ATTR_FIELD(partition_const_loop).describe("Split constant loop").set_default(false);
     TVM_ATTR_FIELD(no_unroll_loop_with_extent_one)
         .describe("Don't unroll loops with extent 1")
         .set_default(false);
+    TVM_ATTR_FIELD(partition_if_then_else)
+        .describe("Also split on the conjuncts of the if_then_else and if conditions")
+        .set_default(false);
+    TVM_ATTR_FIELD(max_code_growth)
+        .describe("The factor the number of IR nodes of a function may grow by, 0 for no limit")
+        .set_default(0.0);
+    TVM_ATTR_FIELD(record_decisions)
+        .describe("Record the partitions in the tir.loop_partition_decisions function attribute")
+        .set_default(false);
   }
 };
 
@@ -104,8 +125,9 @@ bool ExprUseVars(PrimExpr expr, const std::unordered_set<const VarNode*>& vars)
 class CandidateSelector final : public StmtExprVisitor {
  public:
   using VarIsUsed = bool;
-  explicit CandidateSelector(bool partition_const_loop)
-      : partition_const_loop_(partition_const_loop) {}
+  explicit CandidateSelector(bool partition_const_loop, bool partition_if_then_else)
+      : partition_const_loop_(partition_const_loop),
+        partition_if_then_else_(partition_if_then_else) {}
 
   void VisitStmt_(const ForNode* op) final {
     // partition const loop when sets partition_const_loop_
@@ -153,11 +175,23 @@ class CandidateSelector final : public StmtExprVisitor {
     }
   }
 
+  void VisitStmt_(const IfThenElseNode* op) final {
+    if (partition_if_then_else_) {
+      VisitCondition(op->condition);
+      this->VisitStmt(op->then_case);
+      if (op->else_case.defined()) this->VisitStmt(op->else_case);
+    } else {
+      StmtExprVisitor::VisitStmt_(op);
+    }
+  }
+
   void VisitExpr_(const CallNode* op) final {
     if (op->op.same_as(builtin::likely())) {
-      in_likely_ = true;
-      StmtExprVisitor::VisitExpr_(op);
-      in_likely_ = false;
+      VisitCondition(op->args[0]);
+    } else if (partition_if_then_else_ && op->op.same_as(builtin::if_then_else())) {
+      VisitCondition(op->args[0]);
+      this->VisitExpr(op->args[1]);
+      this->VisitExpr(op->args[2]);
     } else if (op->op.same_as(builtin::tvm_thread_allreduce())) {
       // no split if the body contains allreduce.
       no_split_ = true;
@@ -176,9 +210,17 @@ class CandidateSelector final : public StmtExprVisitor {
   std::unordered_set<Stmt, ObjectPtrHash, ObjectPtrEqual> candidates;
 
  private:
+  void VisitCondition(const PrimExpr& cond) {
+    bool in_likely = in_likely_;
+    in_likely_ = true;
+    this->VisitExpr(cond);
+    in_likely_ = in_likely;
+  }
+
   bool in_likely_{false};
   bool no_split_{false};
   bool partition_const_loop_{false};
+  bool partition_if_then_else_{false};
   std::unordered_map<const VarNode*, VarIsUsed> record_;
 };
 
@@ -189,8 +231,12 @@ class PartitionFinder : public StmtExprVisitor {
  public:
   explicit PartitionFinder(Var current_var,
                            const std::unordered_map<const VarNode*, IntSet>& hint_map,
-                           const std::unordered_map<const VarNode*, IntSet>& relax_map)
-      : current_var_(current_var), hint_map_(hint_map), relax_map_(relax_map) {
+                           const std::unordered_map<const VarNode*, IntSet>& relax_map,
+                           bool partition_if_then_else)
+      : current_var_(current_var),
+        hint_map_(hint_map),
+        relax_map_(relax_map),
+        partition_if_then_else_(partition_if_then_else) {
     for (const auto& kv : hint_map) {
       out_vars_.insert(kv.first);
     }
@@ -227,27 +273,17 @@ class PartitionFinder : public StmtExprVisitor {
     }
   }
 
+  void VisitStmt_(const IfThenElseNode* op) final {
+    if (partition_if_then_else_) FindPartitions(op->condition);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
   void VisitExpr_(const CallNode* op) final {
     if (op->op.same_as(builtin::likely())) {
-      PrimExpr cond = op->args[0];
-      if (ExprUseVars(cond, std::unordered_set<const VarNode*>({current_var_.get()}))) {
-        // For cond, find out the interval, if exists, in which we can prove that cond is
-        // true. Also find the interval, if exists, in which we can prove that cond is
-        // false.
-        IntSet interval = DeduceBound(current_var_, cond, hint_map_, relax_map_);
-        if (!interval.IsNothing()) {
-          // cond is true within interval
-          partitions[{cond, true}] = interval;
-        }
-        PrimExpr inverse_cond = InverseCond(cond);
-        if (inverse_cond.defined()) {
-          IntSet interval = DeduceBound(current_var_, inverse_cond, hint_map_, relax_map_);
-          if (!interval.IsNothing()) {
-            // cond is false within interval
-            partitions[{cond, false}] = interval;
-          }
-        }
-      }
+      FindPartitions(op->args[0]);
+    } else if (partition_if_then_else_ && op->op.same_as(builtin::if_then_else())) {
+      FindPartitions(op->args[0]);
+      StmtExprVisitor::VisitExpr_(op);
     } else {
       StmtExprVisitor::VisitExpr_(op);
     }
@@ -256,6 +292,35 @@ class PartitionFinder : public StmtExprVisitor {
   Partition partitions;
 
  private:
+  void FindPartitions(const PrimExpr& cond) {
+    if (partition_if_then_else_) {
+      // the conjuncts are eliminated one by one, a && b being false where a is
+      if (const AndNode* op = cond.as<AndNode>()) {
+        FindPartitions(op->a);
+        FindPartitions(op->b);
+        return;
+      }
+    }
+    if (ExprUseVars(cond, std::unordered_set<const VarNode*>({current_var_.get()}))) {
+      // For cond, find out the interval, if exists, in which we can prove that cond is
+      // true. Also find the interval, if exists, in which we can prove that cond is
+      // false.
+      IntSet interval = DeduceBound(current_var_, cond, hint_map_, relax_map_);
+      if (!interval.IsNothing()) {
+        // cond is true within interval
+        partitions[{cond, true}] = interval;
+      }
+      PrimExpr inverse_cond = InverseCond(cond);
+      if (inverse_cond.defined()) {
+        IntSet interval = DeduceBound(current_var_, inverse_cond, hint_map_, relax_map_);
+        if (!interval.IsNothing()) {
+          // cond is false within interval
+          partitions[{cond, false}] = interval;
+        }
+      }
+    }
+  }
+
   PrimExpr InverseCond(const PrimExpr& cond) {
     PrimExpr inverse_cond;
     if (const LTNode* op = cond.as<LTNode>()) {
@@ -284,6 +349,31 @@ class PartitionFinder : public StmtExprVisitor {
   std::unordered_set<const VarNode*> out_vars_;
   std::unordered_map<const VarNode*, IntSet> hint_map_;
   std::unordered_map<const VarNode*, IntSet> relax_map_;
+  bool partition_if_then_else_;
+};
+
+// Count the IR nodes of a statement, as a measure of its code size
+class NodeCounter : public StmtExprVisitor {
+ public:
+  static int64_t Count(const Stmt& stmt) {
+    if (!stmt.defined()) return 0;
+    NodeCounter counter;
+    counter(stmt);
+    return counter.count_;
+  }
+
+  void VisitStmt(const Stmt& stmt) final {
+    ++count_;
+    StmtExprVisitor::VisitStmt(stmt);
+  }
+
+  void VisitExpr(const PrimExpr& expr) final {
+    ++count_;
+    StmtExprVisitor::VisitExpr(expr);
+  }
+
+ private:
+  int64_t count_{0};
 };
 
 // Replace the set of conditions given by ps with cond_value (true or false)
@@ -338,9 +428,17 @@ class ThreadPartitionInserter : public StmtMutator {
 // likely conditions
 class LoopPartitioner : public StmtMutator {
  public:
-  explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one)
-      : selector(CandidateSelector(partition_const_loop)),
-        no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one) {}
+  /*!
+   * \param budget The number of IR nodes the partitioning may add, negative for no limit.
+   */
+  LoopPartitioner(const LoopPartitionConfig& cfg, int64_t budget)
+      : selector(CandidateSelector(cfg->partition_const_loop, cfg->partition_if_then_else)),
+        no_unroll_loop_with_extent_one_(cfg->no_unroll_loop_with_extent_one),
+        partition_if_then_else_(cfg->partition_if_then_else),
+        budget_(budget) {}
+
+  /*! \brief The partitions made or given up, in the order of the decisions. */
+  Array<String> decisions;
 
   Stmt VisitAndMutate(Stmt stmt) {
     selector(stmt);
@@ -402,14 +500,30 @@ class LoopPartitioner : public StmtMutator {
 
   inline Stmt MakeFor(const Object* op, PrimExpr extent, Stmt body);
 
+  // Charge the growth of a partition to the budget, false if it does not fit.
+  bool Charge(const Var& var, int64_t growth);
+
   /* Candidate IRs that may be partitioned potentially */
   std::unordered_map<const VarNode*, IntSet> hint_map_;
   std::unordered_map<const VarNode*, IntSet> relax_map_;
   arith::Analyzer analyzer_;
   CandidateSelector selector;
   bool no_unroll_loop_with_extent_one_;
+  bool partition_if_then_else_;
+  int64_t budget_;
 };
 
+bool LoopPartitioner::Charge(const Var& var, int64_t growth) {
+  if (budget_ >= 0 && growth > budget_) {
+    std::ostringstream os;
+    os << var << ": kept, " << growth << " nodes over the budget of " << budget_;
+    decisions.push_back(os.str());
+    return false;
+  }
+  if (budget_ >= 0) budget_ -= std::max<int64_t>(growth, 0);
+  return true;
+}
+
 // Returns an interval (in the first component) in which all the conditions
 // given in the second component provably have value given by cond_value
 std::pair<IntSet, ExpressionSet> LoopPartitioner::GetIntervalAndCondset(
@@ -483,7 +597,7 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
   // include hint of var.
   hint_map_.insert({var.get(), IntSet::Interval(min, max)});
 
-  PartitionFinder finder(var, hint_map_, relax_map_);
+  PartitionFinder finder(var, hint_map_, relax_map_, partition_if_then_else_);
   finder(body);
 
   hint_map_.erase(var.get());
@@ -579,6 +693,14 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
       // Recurse for each non-empty subrange only if there are at least
       // two non-empty subranges
       if (pre_stmt.defined() || post_stmt.defined()) {
+        int64_t growth = NodeCounter::Count(pre_stmt) + NodeCounter::Count(mid_stmt) +
+                         NodeCounter::Count(post_stmt) - NodeCounter::Count(stmt);
+        if (!Charge(var, growth)) return Stmt();
+        std::ostringstream os;
+        os << var << ": split at";
+        if (pre_stmt.defined()) os << " " << body_begin;
+        if (post_stmt.defined()) os << " " << post_doubt_begin;
+        decisions.push_back(os.str());
         mid_stmt = VisitAndMutate(mid_stmt);
         if (pre_stmt.defined() && pre_stmt_recurse) {
           pre_stmt = VisitAndMutate(pre_stmt);
@@ -593,6 +715,11 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
     PrimExpr cond = const_true();
     if (!analyzer_.CanProve(body_begin == min)) cond = cond && (var >= body_begin);
     if (!analyzer_.CanProve(post_doubt_begin == (max + 1))) cond = cond && (var < post_doubt_begin);
+    // the body is duplicated into the two branches
+    if (!Charge(var, NodeCounter::Count(body))) return Stmt();
+    std::ostringstream os;
+    os << var << ": branched on " << cond;
+    decisions.push_back(os.str());
     s = ThreadPartitionInserter(cond_set, cond)(stmt);
   }
   s = ConvertSSA(s);
@@ -624,13 +751,6 @@ class RemoveLikelyTags : public StmtExprMutator {
   }
 };
 
-Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one) {
-  stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one)
-             .VisitAndMutate(std::move(stmt));
-  stmt = RemoveLikelyTags()(std::move(stmt));
-  return stmt;
-}
-
 namespace transform {
 
 Pass LoopPartition() {
@@ -640,8 +760,17 @@ Pass LoopPartition() {
     if (!cfg.defined()) {
       cfg = AttrsWithDefaultValues<LoopPartitionConfig>();
     }
-    n->body = LoopPartition(std::move(n->body), cfg.value()->partition_const_loop,
-                            cfg.value()->no_unroll_loop_with_extent_one);
+    int64_t budget = -1;
+    if (cfg.value()->max_code_growth > 0) {
+      double size = static_cast<double>(NodeCounter::Count(n->body));
+      budget = static_cast<int64_t>(size * std::max(cfg.value()->max_code_growth - 1.0, 0.0));
+    }
+    LoopPartitioner partitioner(cfg.value(), budget);
+    n->body = partitioner.VisitAndMutate(std::move(n->body));
+    n->body = RemoveLikelyTags()(std::move(n->body));
+    if (cfg.value()->record_decisions) {
+      f = WithAttr(std::move(f), "tir.loop_partition_decisions", partitioner.decisions);
+    }
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
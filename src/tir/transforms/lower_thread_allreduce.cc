@@ -197,6 +197,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     std::vector<Stmt> seq;
     std::vector<Var> shared_bufs(size);
     std::vector<Stmt> local_vars;
+    std::vector<Stmt> shared_vars;
     //
     // This is an optimization. For small reduction sizes, it may be beneficial
     // for a single warp to performance the entire reduction. No trips to shared
@@ -214,9 +215,13 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     // broadcast results from lane 0 to all other lanes and store
     // the final reduction result to the proper location.
     //
-    if (is_warp_reduction(types)) {
-      // TODO(tvm-team) sub-warp reduction support.
-      ICHECK_EQ(reduce_extent, warp_size_) << "not a warp reduction";
+    // A reduction over a power of two of threads less than a warp shuffles
+    // within segments of that width. A reduction over several warps is done
+    // by each warp, then by the first lanes of each warp, over the partial
+    // results of the warps staged in shared memory.
+    //
+    int warp_width = WarpReductionWidth(types, vred, reduce_extent);
+    if (warp_width != 0) {
       //
       // This is the index to the reduction variable, one reduction
       // variable per warp. Local scope seems easier to reason without
@@ -253,48 +258,36 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
       }
 
       // Emit reductions within a warp.
-      for (int offset = warp_size_ / 2; offset > 0; offset /= 2) {
-        // Load reduction values, no synchronization needed.
-        Array<PrimExpr> a, b;
+      EmitWarpReduce(combiner, types, shared_bufs, local_vars, mask_var,
+                     std::min(reduce_extent, warp_width), warp_width, &seq);
+
+      int num_warps = reduce_extent / warp_width;
+      if (num_warps > 1) {
+        // Stage the results of the warps, one per warp of each group.
+        PrimExpr lane = indexmod(reduce_index, warp_width);
+        PrimExpr warp = indexdiv(reduce_index, warp_width);
+        PrimExpr group_base = analyzer_.Simplify(group_index * num_warps);
+        std::vector<Stmt> stage_stores, stage_inits, stage_loads;
         for (size_t i = 0; i < size; ++i) {
-          Var var = shared_bufs[i];
           PrimExpr pred = const_true(types[i].lanes());
-          PrimExpr val = Load(types[i], var, index, pred);
-          a.push_back(val);
-
-          // __shfl_*sync calls shall not appear in if_then_else expressions
-          // as this is causing extra divergency. E.g.
-          //
-          // v1 = (v2 < v3) ? v3 : __shfl_sync(mask, v1, 0);
-          //
-          // behaves differently from
-          //
-          // int t = __shfl_sync(mask, v1, 0);
-          // v1 = (v2 < v3) ? v3 : t;
-          //
-          // The former may cause dead lock as there is a divergent
-          // branch with a warp sync call inside.
-          //
-          PrimExpr other = WarpShuffle(builtin::tvm_warp_shuffle_down(), mask_var, val, offset);
-          const AllocateNode* repl = local_vars[i].as<AllocateNode>();
-          Stmt s = Store(repl->buffer_var, other, index, pred);
-          seq.push_back(s);
-
-          PrimExpr load = Load(types[i], repl->buffer_var, index, pred);
-          b.push_back(load);
+          Var staging("red_buf_staging" + std::to_string(i), PointerType(PrimType(types[i])));
+          stage_stores.push_back(Store(staging, Load(types[i], shared_bufs[i], index, pred),
+                                       group_base + warp, pred));
+          stage_inits.push_back(Store(shared_bufs[i], inits[i], index, pred));
+          stage_loads.push_back(Store(
+              shared_bufs[i], Load(types[i], staging, group_base + lane, pred), index, pred));
+          shared_vars.push_back(Allocate(staging, types[i], {PrimExpr(group_extent * num_warps)},
+                                         pred, Evaluate(0)));
         }
-
-        // Do reductions.
-        Array<PrimExpr> ret = (*combiner)(a, b);
-
-        // Store the reduction result to itself.
-        std::vector<Stmt> stores(size);
-        for (size_t i = 0; i < size; ++i) {
-          Var var = shared_bufs[i];
-          PrimExpr pred = const_true(types[i].lanes());
-          stores[i] = Store(var, ret[i], index, pred);
-        }
-        seq.push_back(SeqStmt::Flatten(stores));
+        // This sync is necessary because there might be incomplete read of
+        // previous iteration on the same buffer.
+        seq.emplace_back(SyncThread("shared"));
+        seq.emplace_back(IfThenElse(lane == 0, SeqStmt::Flatten(stage_stores)));
+        seq.emplace_back(SyncThread("shared"));
+        seq.insert(seq.end(), stage_inits.begin(), stage_inits.end());
+        seq.emplace_back(IfThenElse(lane < num_warps, SeqStmt::Flatten(stage_loads)));
+        EmitWarpReduce(combiner, types, shared_bufs, local_vars, mask_var, num_warps, warp_width,
+                       &seq);
       }
 
       // Broadcast the reduction result from lane 0 to all other lanes.
@@ -305,7 +298,7 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         Var var = shared_bufs[i];
         PrimExpr pred = const_true(types[i].lanes());
         PrimExpr val = Load(types[i], var, index, pred);
-        PrimExpr splat = WarpShuffle(builtin::tvm_warp_shuffle(), mask_var, val, 0);
+        PrimExpr splat = WarpShuffle(builtin::tvm_warp_shuffle(), mask_var, val, 0, warp_width);
         seq.push_back(Store(var, splat, index, pred));
       }
 
@@ -369,10 +362,70 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         body = AttrStmt(repl->buffer_var, attr::storage_scope, StringImm("local"), body);
       }
     }
+    for (auto var : shared_vars) {
+      const AllocateNode* repl = var.as<AllocateNode>();
+      body = Allocate(repl->buffer_var, repl->dtype, repl->extents, repl->condition, body);
+      body = AttrStmt(repl->buffer_var, attr::storage_scope, StringImm("shared"), body);
+    }
 
     return body;
   }
 
+  // Emit the shuffle reduction of the values of bufs over reduce_extent lanes, in
+  // segments of width lanes. The temps are the local allocations of the shuffled values.
+  void EmitWarpReduce(const CommReducerNode* combiner, const std::vector<DataType>& types,
+                      const std::vector<Var>& bufs, const std::vector<Stmt>& temps,
+                      const Var& mask_var, int reduce_extent, int width, std::vector<Stmt>* seq) {
+    int reduce_align = 1;
+    while (reduce_extent > reduce_align) {
+      reduce_align = reduce_align << 1;
+    }
+    PrimExpr index(0);
+    for (int offset = reduce_align / 2; offset > 0; offset /= 2) {
+      // Load reduction values, no synchronization needed.
+      Array<PrimExpr> a, b;
+      for (size_t i = 0; i < bufs.size(); ++i) {
+        Var var = bufs[i];
+        PrimExpr pred = const_true(types[i].lanes());
+        PrimExpr val = Load(types[i], var, index, pred);
+        a.push_back(val);
+
+        // __shfl_*sync calls shall not appear in if_then_else expressions
+        // as this is causing extra divergency. E.g.
+        //
+        // v1 = (v2 < v3) ? v3 : __shfl_sync(mask, v1, 0);
+        //
+        // behaves differently from
+        //
+        // int t = __shfl_sync(mask, v1, 0);
+        // v1 = (v2 < v3) ? v3 : t;
+        //
+        // The former may cause dead lock as there is a divergent
+        // branch with a warp sync call inside.
+        //
+        PrimExpr other =
+            WarpShuffle(builtin::tvm_warp_shuffle_down(), mask_var, val, offset, width);
+        const AllocateNode* repl = temps[i].as<AllocateNode>();
+        seq->push_back(Store(repl->buffer_var, other, index, pred));
+
+        PrimExpr load = Load(types[i], repl->buffer_var, index, pred);
+        b.push_back(load);
+      }
+
+      // Do reductions.
+      Array<PrimExpr> ret = (*combiner)(a, b);
+
+      // Store the reduction result to itself.
+      std::vector<Stmt> stores(bufs.size());
+      for (size_t i = 0; i < bufs.size(); ++i) {
+        Var var = bufs[i];
+        PrimExpr pred = const_true(types[i].lanes());
+        stores[i] = Store(var, ret[i], index, pred);
+      }
+      seq->push_back(SeqStmt::Flatten(stores));
+    }
+  }
+
   // make allreduce.
   Stmt MakeBufAllreduce(const CommReducerNode* combiner, const std::vector<DataType>& types,
                         const Array<Var>& shared_bufs, PrimExpr reduce_index, PrimExpr group_index,
@@ -508,32 +561,54 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   }
 
   // Emit warp shuffle  calls.
-  PrimExpr WarpShuffle(const Op& op, Var mask_var, PrimExpr val, int delta_or_lane) {
+  PrimExpr WarpShuffle(const Op& op, Var mask_var, PrimExpr val, int delta_or_lane,
+                       int width) {
     PrimExpr pred = const_true(1);
     PrimExpr index(0);
     PrimExpr mask = Load(DataType::UInt(32), mask_var, index, pred);
-    PrimExpr width = IntImm(DataType::Int(32), warp_size_);
-    Array<PrimExpr> args{mask, val, IntImm(DataType::Int(32), delta_or_lane), width, width};
+    Array<PrimExpr> args{mask, val, IntImm(DataType::Int(32), delta_or_lane),
+                         IntImm(DataType::Int(32), width), IntImm(DataType::Int(32), warp_size_)};
     return Call(val.dtype(), op, args);
   }
 
-  // Check if this is a reduction on threadIdx.x and its extent matches
-  // the warp size.
+  // The width of the warp shuffles of a reduction on threadIdx.x, 0 if it is
+  // not done with warp shuffles. The reduction extent is either a power of two
+  // up to the warp size, or a multiple of the warp size up to its square, the
+  // warps then combining their results through shared memory.
   //
-  // TODO(tvm-team) reduction with a sub-warp of 8 or 16 threads.
   // Note: The ROCm backend will only have warp reductions for now.
   // Also, the warp/wavefront size differs (64 on rocm, 32 on cuda).
-  bool is_warp_reduction(const std::vector<DataType>& types) const {
-    // Only cuda target supports warp reductions.
-    if ((target_->kind->name != "cuda") && (target_->kind->name != "rocm")) return false;
+  int WarpReductionWidth(const std::vector<DataType>& types, const std::vector<ThreadEntry>& vred,
+                         int reduce_extent) const {
+    // Only cuda, rocm and vulkan targets support warp reductions.
+    bool is_vulkan = target_->kind->name == "vulkan";
+    if ((target_->kind->name != "cuda") && (target_->kind->name != "rocm") && !is_vulkan) {
+      return 0;
+    }
+
+    // vulkan needs the shuffle, relative shuffle and ballot subgroup
+    // operations of Vulkan 1.1. The lanes of the subgroups are assumed to
+    // be the consecutive threadIdx.x, as done by the drivers for the
+    // workgroups whose x extent is a multiple of the subgroup size.
+    if (is_vulkan) {
+      // VK_SUBGROUP_FEATURE_BALLOT_BIT | _SHUFFLE_BIT | _SHUFFLE_RELATIVE_BIT
+      const int64_t required_ops = 0x8 | 0x10 | 0x20;
+      // VK_API_VERSION_1_1
+      const int64_t vulkan_1_1 = (1 << 22) | (1 << 12);
+      int64_t ops = target_->GetAttr<Integer>("supported_subgroup_operations", 0).value();
+      int64_t api_version = target_->GetAttr<Integer>("vulkan_api_version", 0).value();
+      if ((ops & required_ops) != required_ops || api_version < vulkan_1_1 || warp_size_ > 32) {
+        return 0;
+      }
+    }
 
-    // rocm only supports 32 bit operands for shuffling at the moment
-    if ((target_->kind->name == "rocm") &&
+    // rocm and vulkan only support 32 bit operands for shuffling at the moment
+    if ((target_->kind->name == "rocm" || is_vulkan) &&
         (std::any_of(types.begin(), types.end(), [](DataType ty) {
           if (ty.is_vector()) return true;
           return ty.bits() != 32;
         }))) {
-      return false;
+      return 0;
     }
 
     // Supported types:
@@ -543,24 +618,21 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
           if (ty.is_vector()) return true;
           return ty.bytes() < 4 || ty.bytes() > 8;
         })) {
-      return false;
+      return 0;
     }
-    if (thread_extents_.empty()) {
-      return false;
+    // A reduction over threadIdx.x only, the lanes of a warp being consecutive.
+    if (vred.size() != 1 || vred[0].scope.dim_index != 0 || vred[0].scope.rank != 1) {
+      return 0;
     }
-
-    const AttrStmtNode* op = thread_extents_.back();
-    DCHECK_EQ(op->attr_key, attr::thread_extent);
-
-    IterVar iv = Downcast<IterVar>(op->node);
-    ThreadEntry e;
-    e.scope = runtime::ThreadScope::Create(iv->thread_tag);
-    e.extent = 0;
-    if (auto ptr = op->value.as<IntImmNode>()) {
-      e.extent = static_cast<int>(ptr->value);
+    if (reduce_extent <= warp_size_) {
+      bool power_of_two = (reduce_extent & (reduce_extent - 1)) == 0;
+      return reduce_extent > 1 && power_of_two && warp_size_ % reduce_extent == 0 ? reduce_extent
+                                                                                  : 0;
     }
-
-    return e.extent == warp_size_ && e.scope.dim_index == 0 && e.scope.rank == 1;
+    if (reduce_extent % warp_size_ == 0 && reduce_extent / warp_size_ <= warp_size_) {
+      return warp_size_;
+    }
+    return 0;
   }
 
   // The target.
@@ -0,0 +1,332 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file pad_shared_memory.cc
+ * \brief Pad the rows of the shared buffers whose warp accesses conflict on the banks.
+ *
+ *  The accesses are evaluated on the realized buffers, before StorageFlatten, for the 32 lanes
+ *  of the first warp, the other variables being 0. A bank holds the 4-byte words of index
+ *  word % 32, and the conflict degree of an access is the largest number of distinct words of
+ *  a bank it touches. The padding of the rows is given to StorageFlatten as a buffer_dim_align.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+
+static constexpr int kWarpSize = 32;
+static constexpr int kNumBanks = 32;
+static constexpr int kBankBytes = 4;
+
+/*! \brief The accesses of the lanes of a warp to a shared buffer. */
+struct SharedBufferAccesses {
+  /*! \brief The extents of the realized buffer. */
+  std::vector<int64_t> shape;
+  /*! \brief The buffer_dim_align of each dimension, as (factor, offset), 0 for none. */
+  std::vector<std::pair<int64_t, int64_t>> align;
+  /*! \brief The indices relative to the realize of each access, one per lane. */
+  std::vector<std::vector<std::vector<int64_t>>> accesses;
+  /*! \brief The element size in bytes. */
+  int elem_bytes;
+};
+
+/*! \brief The strides of the buffer, as computed from buffer_dim_align by StorageFlatten. */
+static std::vector<int64_t> BufferStrides(const SharedBufferAccesses& info) {
+  std::vector<int64_t> strides(info.shape.size());
+  int64_t stride = 1;
+  for (size_t i = info.shape.size(); i != 0; --i) {
+    size_t dim = i - 1;
+    int64_t factor = info.align[dim].first;
+    if (factor != 0) {
+      int64_t offset = info.align[dim].second;
+      stride += ((factor + offset - stride % factor) % factor + factor) % factor;
+    }
+    strides[dim] = stride;
+    stride *= info.shape[dim];
+  }
+  return strides;
+}
+
+/*! \brief The sum over the accesses of their bank conflict degree, and the worst degree. */
+static std::pair<int64_t, int64_t> ConflictDegree(const SharedBufferAccesses& info) {
+  std::vector<int64_t> strides = BufferStrides(info);
+  int64_t total = 0, worst = 0;
+  for (const auto& lanes : info.accesses) {
+    std::unordered_map<int64_t, std::unordered_set<int64_t>> words_of_bank;
+    int64_t degree = 0;
+    for (const auto& index : lanes) {
+      int64_t offset = 0;
+      for (size_t dim = 0; dim < index.size(); ++dim) {
+        offset += index[dim] * strides[dim];
+      }
+      int64_t word = offset * info.elem_bytes / kBankBytes;
+      int64_t bank = ((word % kNumBanks) + kNumBanks) % kNumBanks;
+      auto& words = words_of_bank[bank];
+      words.insert(word);
+      degree = std::max(degree, static_cast<int64_t>(words.size()));
+    }
+    total += degree;
+    worst = std::max(worst, degree);
+  }
+  return {total, worst};
+}
+
+/*! \brief Collect the warp accesses of the shared buffers of realize. */
+class SharedAccessCollector : public StmtExprVisitor {
+ public:
+  static std::unordered_map<Buffer, SharedBufferAccesses, ObjectPtrHash, ObjectPtrEqual> Collect(
+      const Stmt& body) {
+    SharedAccessCollector collector;
+    collector(body);
+    return collector.Evaluate();
+  }
+
+ private:
+  void VisitStmt_(const AttrStmtNode* op) final {
+    if (op->attr_key == attr::thread_extent) {
+      IterVar iv = Downcast<IterVar>(op->node);
+      const auto* extent = op->value.as<IntImmNode>();
+      if (extent && std::string(iv->thread_tag).rfind("threadIdx.", 0) == 0) {
+        threads_[iv->thread_tag] = {iv->var, extent->value};
+      }
+    } else if (op->attr_key == attr::realize_scope) {
+      if (const auto* buffer = op->node.as<BufferNode>()) {
+        if (op->value.as<StringImmNode>()->value == "shared") {
+          shared_.insert(buffer);
+        }
+      }
+    } else if (op->attr_key == attr::buffer_dim_align) {
+      if (const auto* buffer = op->node.as<BufferNode>()) {
+        const auto* tuple = op->value.as<CallNode>();
+        ICHECK(tuple && tuple->op.same_as(builtin::tvm_tuple()));
+        int64_t dim = Downcast<Integer>(tuple->args[0])->value;
+        auto& align = align_[buffer];
+        if (static_cast<size_t>(dim) >= align.size()) align.resize(dim + 1);
+        align[dim] = {Downcast<Integer>(tuple->args[1])->value,
+                      Downcast<Integer>(tuple->args[2])->value};
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const BufferRealizeNode* op) final {
+    if (shared_.count(op->buffer.get())) {
+      std::vector<int64_t> shape;
+      for (const Range& range : op->bounds) {
+        const auto* extent = range->extent.as<IntImmNode>();
+        if (extent == nullptr) {
+          shape.clear();
+          break;
+        }
+        shape.push_back(extent->value);
+      }
+      if (!shape.empty()) {
+        auto& realize = realizes_[op->buffer];
+        realize.first = op;
+        realize.second = std::move(shape);
+      }
+    }
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    RecordAccess(op->buffer, op->indices);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void RecordAccess(const Buffer& buffer, const Array<PrimExpr>& indices) {
+    auto it = realizes_.find(buffer);
+    if (it == realizes_.end() || indices.size() != it->second.second.size()) return;
+    Array<PrimExpr> relative;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      relative.push_back(indices[i] - it->second.first->bounds[i]->min);
+    }
+    accesses_[buffer].push_back(relative);
+  }
+
+  std::unordered_map<Buffer, SharedBufferAccesses, ObjectPtrHash, ObjectPtrEqual> Evaluate() {
+    std::unordered_map<Buffer, SharedBufferAccesses, ObjectPtrHash, ObjectPtrEqual> result;
+    // The thread indices of the lanes of the first warp.
+    std::vector<std::pair<Var, int64_t>> threads;
+    int64_t num_threads = 1;
+    for (const char* tag : {"threadIdx.x", "threadIdx.y", "threadIdx.z"}) {
+      auto it = threads_.find(tag);
+      if (it != threads_.end()) {
+        threads.push_back(it->second);
+        num_threads *= it->second.second;
+      }
+    }
+    int64_t num_lanes = std::min<int64_t>(num_threads, kWarpSize);
+    if (num_lanes < 2) return result;
+
+    arith::Analyzer analyzer;
+    for (const auto& kv : accesses_) {
+      const Buffer& buffer = kv.first;
+      SharedBufferAccesses info;
+      info.shape = realizes_.at(buffer).second;
+      info.align = align_[buffer.get()];
+      info.align.resize(info.shape.size());
+      info.elem_bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+      for (const Array<PrimExpr>& indices : kv.second) {
+        bool uses_thread = std::any_of(indices.begin(), indices.end(), [&](const PrimExpr& e) {
+          return ExprUseVar(e, [&](const VarNode* v) {
+            return std::any_of(threads.begin(), threads.end(),
+                               [&](const auto& t) { return t.first.get() == v; });
+          });
+        });
+        // The accesses of the same address by the whole warp are broadcast.
+        if (!uses_thread) continue;
+        std::vector<std::vector<int64_t>> lanes;
+        for (int64_t lane = 0; lane < num_lanes; ++lane) {
+          std::unordered_map<const VarNode*, int64_t> value;
+          int64_t rest = lane;
+          for (const auto& thread : threads) {
+            value[thread.first.get()] = rest % thread.second;
+            rest /= thread.second;
+          }
+          auto vmap = [&](const Var& var) -> Optional<PrimExpr> {
+            auto it = value.find(var.get());
+            return make_const(var.dtype(), it != value.end() ? it->second : 0);
+          };
+          std::vector<int64_t> index;
+          for (const PrimExpr& e : indices) {
+            const auto* imm = analyzer.Simplify(Substitute(e, vmap)).as<IntImmNode>();
+            if (imm == nullptr) break;
+            index.push_back(imm->value);
+          }
+          if (index.size() != indices.size()) {
+            lanes.clear();
+            break;
+          }
+          lanes.push_back(std::move(index));
+        }
+        if (!lanes.empty()) info.accesses.push_back(std::move(lanes));
+      }
+      if (!info.accesses.empty()) result[buffer] = std::move(info);
+    }
+    return result;
+  }
+
+  std::unordered_map<std::string, std::pair<Var, int64_t>> threads_;
+  std::unordered_set<const BufferNode*> shared_;
+  std::unordered_map<const BufferNode*, std::vector<std::pair<int64_t, int64_t>>> align_;
+  std::unordered_map<Buffer, std::pair<const BufferRealizeNode*, std::vector<int64_t>>,
+                     ObjectPtrHash, ObjectPtrEqual>
+      realizes_;
+  std::unordered_map<Buffer, std::vector<Array<PrimExpr>>, ObjectPtrHash, ObjectPtrEqual>
+      accesses_;
+};
+
+Map<Buffer, Integer> SharedMemoryBankConflicts(const PrimFunc& func) {
+  Map<Buffer, Integer> result;
+  for (const auto& kv : SharedAccessCollector::Collect(func->body)) {
+    result.Set(kv.first, Integer(ConflictDegree(kv.second).second));
+  }
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("tir.analysis.shared_memory_bank_conflicts")
+    .set_body_typed(SharedMemoryBankConflicts);
+
+/*! \brief Align the rows of the shared buffers to the padding of least bank conflicts. */
+class SharedMemoryPadder : public StmtMutator {
+ public:
+  explicit SharedMemoryPadder(const PrimFunc& func) {
+    for (auto& kv : SharedAccessCollector::Collect(func->body)) {
+      SharedBufferAccesses& info = kv.second;
+      size_t ndim = info.shape.size();
+      bool aligned = std::any_of(info.align.begin(), info.align.end(),
+                                 [](const auto& a) { return a.first != 0; });
+      // The buffers aligned by the schedule keep their layout.
+      if (ndim < 2 || aligned) continue;
+      int64_t width = info.shape[ndim - 1];
+      // The factor of the rows, a full round of the banks.
+      int64_t factor = std::max<int64_t>(kNumBanks * kBankBytes / info.elem_bytes, 1);
+      // The rows grow by at most an eighth.
+      int64_t max_pad = std::min(factor - 1, std::max<int64_t>(width / 8, 1));
+      int64_t best_pad = 0;
+      int64_t best = ConflictDegree(info).first;
+      for (int64_t pad = 1; pad <= max_pad; ++pad) {
+        info.align[ndim - 2] = {factor, (width + pad) % factor};
+        int64_t degree = ConflictDegree(info).first;
+        if (degree < best) {
+          best = degree;
+          best_pad = pad;
+        }
+      }
+      if (best_pad != 0) {
+        align_[kv.first.get()] = {static_cast<int>(ndim - 2), factor, (width + best_pad) % factor};
+      }
+    }
+  }
+
+  Stmt VisitStmt_(const BufferRealizeNode* op) final {
+    Stmt stmt = StmtMutator::VisitStmt_(op);
+    auto it = align_.find(op->buffer.get());
+    if (it == align_.end()) return stmt;
+    int dim;
+    int64_t factor, offset;
+    std::tie(dim, factor, offset) = it->second;
+    PrimExpr tuple = Call(DataType::Handle(), builtin::tvm_tuple(),
+                          {Integer(dim), Integer(factor), Integer(offset)});
+    return AttrStmt(op->buffer, attr::buffer_dim_align, tuple, stmt);
+  }
+
+ private:
+  std::unordered_map<const BufferNode*, std::tuple<int, int64_t, int64_t>> align_;
+};
+
+namespace transform {
+
+Pass PadSharedMemory() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    SharedMemoryPadder padder(f);
+    auto* n = f.CopyOnWrite();
+    n->body = padder(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.PadSharedMemory", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.PadSharedMemory").set_body_typed(PadSharedMemory);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
@@ -32,6 +32,9 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <limits>
+#include <list>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
@@ -343,8 +346,9 @@ class StoragePlanRewriter : public StmtExprMutator {
   using StmtEntry = LinearAccessPatternFinder::StmtEntry;
   using AllocEntry = LinearAccessPatternFinder::AllocEntry;
 
-  Stmt Rewrite(Stmt stmt, bool detect_inplace) {
+  Stmt Rewrite(Stmt stmt, bool detect_inplace, bool pack_shared = false) {
     detect_inplace_ = detect_inplace;
+    pack_shared_ = pack_shared;
     // plan the rewrite
     LinearAccessPatternFinder finder;
     finder(stmt);
@@ -481,6 +485,11 @@ class StoragePlanRewriter : public StmtExprMutator {
     // This allows effective sharing among different types as long as their alignment
     // requirement fits into the max_simd_bits.
     uint64_t bits_offset{0};
+    // The first and the last positions in the linear sequence where the entry is alive.
+    size_t live_begin{std::numeric_limits<size_t>::max()};
+    size_t live_end{0};
+    // Whether the entry is packed in a shared memory arena, see PackSharedArena.
+    bool packed{false};
   };
 
   // Alllocate entry of node.
@@ -520,6 +529,9 @@ class StoragePlanRewriter : public StmtExprMutator {
     for (auto& kv : attach_map_) {
       // find the element with the most amount of bytes.
       std::vector<StorageEntry*>& vec = kv.second;
+      if (pack_shared_ && kv.first != nullptr) {
+        PackSharedArena(vec);
+      }
       // try to find merge, for tagged memory
       for (size_t i = 0; i < vec.size(); ++i) {
         StorageEntry* e = vec[i];
@@ -537,7 +549,7 @@ class StoragePlanRewriter : public StmtExprMutator {
       for (size_t i = 0; i < vec.size(); ++i) {
         StorageEntry* e = vec[i];
         // already merged
-        if (e->bits_offset != 0) continue;
+        if (e->bits_offset != 0 || e->packed) continue;
         if (e->merged_children.size() != 0) {
           NewAllocTagMerged(e);
           continue;
@@ -645,6 +657,69 @@ class StoragePlanRewriter : public StmtExprMutator {
           << "Allocation exceed bound of memory tag " << e->scope.to_string();
     }
   }
+  /*!
+   * \brief Pack the constant size shared memory entries of a thread scope into one arena.
+   *
+   * The entries are placed in the order of decreasing size, each at the lowest offset where
+   * it overlaps none of the entries already placed that are alive at the same time. This is
+   * a first fit coloring of the interval graph of the lifetimes, the entries can have
+   * different element types: the offsets are aligned to the widest access of the entries
+   * and to 128 bits, the width of the vector loads of the GPUs.
+   */
+  void PackSharedArena(const std::vector<StorageEntry*>& vec) {
+    std::vector<StorageEntry*> entries;
+    for (StorageEntry* e : vec) {
+      if (e->scope.rank != StorageRank::kShared || e->scope.tag.length() != 0) continue;
+      if (e->const_nbits == 0 || e->allocs.empty() || e->merged_children.size() != 0) continue;
+      bool packable = true;
+      for (const AllocateNode* op : e->allocs) {
+        packable = packable && !op->dtype.is_handle() && is_one(op->condition);
+      }
+      if (packable) entries.push_back(e);
+    }
+    if (entries.size() < 2) return;
+    std::stable_sort(entries.begin(), entries.end(), [](StorageEntry* a, StorageEntry* b) {
+      return a->const_nbits > b->const_nbits;
+    });
+    auto align_up = [](uint64_t value, uint64_t align) {
+      return (value + align - 1) / align * align;
+    };
+    uint64_t total_bits = 0;
+    std::vector<StorageEntry*> placed;
+    for (StorageEntry* e : entries) {
+      uint64_t align = 128;
+      for (const AllocateNode* op : e->allocs) {
+        align = std::max(align, static_cast<uint64_t>(op->dtype.bits() * op->dtype.lanes()));
+      }
+      // the ranges of the entries alive at the same time, by offset.
+      std::vector<std::pair<uint64_t, uint64_t>> busy;
+      for (StorageEntry* other : placed) {
+        if (other->live_end < e->live_begin || e->live_end < other->live_begin) continue;
+        busy.emplace_back(other->bits_offset, other->bits_offset + other->const_nbits);
+      }
+      std::sort(busy.begin(), busy.end());
+      uint64_t offset = 0;
+      for (const auto& range : busy) {
+        if (offset + e->const_nbits <= range.first) break;
+        offset = std::max(offset, align_up(range.second, align));
+      }
+      e->bits_offset = offset;
+      e->packed = true;
+      placed.push_back(e);
+      total_bits = std::max(total_bits, offset + e->const_nbits);
+    }
+    // The first entry is at offset zero, its buffer becomes the arena.
+    StorageEntry* host = entries[0];
+    host->alloc_var = host->allocs[0]->buffer_var;
+    for (StorageEntry* e : entries) {
+      e->alloc_var = host->alloc_var;
+    }
+    uint64_t type_bits = host->elem_type.bits() * host->elem_type.lanes();
+    PrimExpr alloc_size =
+        make_const(host->allocs[0]->extents[0].dtype(), (total_bits + type_bits - 1) / type_bits);
+    host->new_alloc =
+        Allocate(host->alloc_var, host->elem_type, {alloc_size}, const_true(), Evaluate(0));
+  }
   // Liveness analysis to find gen and kill point of each variable.
   void LivenessAnalysis(const std::vector<StmtEntry>& seq) {
     // find kill point, do a reverse linear scan.
@@ -747,6 +822,7 @@ class StoragePlanRewriter : public StmtExprMutator {
             dst_entry = FindAlloc(ae.alloc, thread_scope_, ae.storage_scope);
           }
           dst_entry->allocs.emplace_back(ae.alloc);
+          dst_entry->live_begin = std::min(dst_entry->live_begin, i);
           alloc_map_[var] = dst_entry;
         }
       }
@@ -773,6 +849,10 @@ class StoragePlanRewriter : public StmtExprMutator {
       // In both cases, we need to handle the kill event correctly
       if (it != event_map_.end() && seq[i].scope_pair_offset <= 0) {
         for (const VarNode* var : it->second.kill) {
+          auto entry = alloc_map_.find(var);
+          if (entry != alloc_map_.end()) {
+            entry->second->live_end = std::max(entry->second->live_end, i);
+          }
           // skip space which are already replaced by inplace
           if (!inplace_flag.count(var)) {
             this->Free(var);
@@ -880,6 +960,8 @@ class StoragePlanRewriter : public StmtExprMutator {
   const Object* thread_scope_{nullptr};
   // whether enable inplace detection.
   bool detect_inplace_{false};
+  // whether pack the shared memory of a thread scope into one arena.
+  bool pack_shared_{false};
   // Locations of free ops.
   std::unordered_map<const Object*, EventEntry> event_map_;
   // constant size free map.
@@ -1002,10 +1084,13 @@ PrimFunc PointerValueTypeRewrite(PrimFunc f) {
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.pack_shared_memory", Bool);
+
 Pass StorageRewrite() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    bool pack_shared = ctx->GetConfig<Bool>("tir.pack_shared_memory", Bool(false)).value();
     auto* n = f.CopyOnWrite();
-    n->body = StoragePlanRewriter().Rewrite(std::move(n->body), true);
+    n->body = StoragePlanRewriter().Rewrite(std::move(n->body), true, pack_shared);
     return PointerValueTypeRewrite(std::move(f));
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.StorageRewrite", {});
@@ -31,6 +31,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -100,7 +101,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool predicate_tail = false)
+      : var_(var), var_lanes_(var_lanes), predicate_tail_(predicate_tail) {
     ramp_ = Ramp(0, 1, var_lanes);
   }
 
@@ -300,12 +302,13 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr VisitExpr_(const LoadNode* op) final {
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
-    if (index.same_as(op->index) && pred.same_as(op->predicate)) {
+    if (index.same_as(op->index) && pred.same_as(op->predicate) && !predicate_.defined()) {
       return GetRef<PrimExpr>(op);
     } else {
       int lanes = std::max(index.dtype().lanes(), pred.dtype().lanes());
+      lanes = std::max(lanes, predicate_.defined() ? predicate_.dtype().lanes() : 1);
       return Load(op->dtype.with_lanes(lanes), op->buffer_var, BroadcastTo(index, lanes),
-                  BroadcastTo(pred, lanes));
+                  CombinePredicate(pred, lanes));
     }
   }
   // Let
@@ -341,13 +344,14 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     PrimExpr value = this->VisitExpr(op->value);
     PrimExpr index = this->VisitExpr(op->index);
     PrimExpr pred = this->VisitExpr(op->predicate);
-    if (value.same_as(op->value) && index.same_as(op->index)) {
+    if (value.same_as(op->value) && index.same_as(op->index) && !predicate_.defined()) {
       return GetRef<Stmt>(op);
     } else {
       int lanes = std::max(value.dtype().lanes(), index.dtype().lanes());
       lanes = std::max(lanes, pred.dtype().lanes());
+      lanes = std::max(lanes, predicate_.defined() ? predicate_.dtype().lanes() : 1);
       return Store(op->buffer_var, BroadcastTo(value, lanes), BroadcastTo(index, lanes),
-                   BroadcastTo(pred, lanes));
+                   CombinePredicate(pred, lanes));
     }
   }
   // For
@@ -374,6 +378,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (predicate_tail_ && !op->else_case.defined() && IsPredicable(op->then_case)) {
+        return PredicateStores(condition, op);
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -439,6 +446,7 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
   // scalarize the statment
   Stmt Scalarize(Stmt stmt) {
+    ++num_scalarized_;
     Var idx(var_->name_hint + ".s", var_->dtype);
     Map<Var, PrimExpr> values{{var_, idx}};
     stmt = Substitute(stmt, values);
@@ -451,6 +459,46 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   }
 
  private:
+  // Whether the stores of stmt can be masked by a predicate instead of a branch.
+  static bool IsPredicable(const Stmt& stmt) {
+    if (stmt.as<StoreNode>()) {
+      return true;
+    } else if (const auto* seq = stmt.as<SeqStmtNode>()) {
+      return std::all_of(seq->seq.begin(), seq->seq.end(), IsPredicable);
+    } else if (const auto* op = stmt.as<IfThenElseNode>()) {
+      return !op->else_case.defined() && IsPredicable(op->then_case);
+    }
+    return false;
+  }
+  // Vectorize the then case of op with the vector condition as the predicate of its loads and
+  // stores, e.g. the bound check of a split that does not divide the loop extent.
+  Stmt PredicateStores(PrimExpr condition, const IfThenElseNode* op) {
+    if (const auto* call = condition.as<CallNode>()) {
+      if (call->op.same_as(builtin::likely())) {
+        condition = call->args[0];
+      }
+    }
+    PrimExpr outer_predicate = predicate_;
+    predicate_ = outer_predicate.defined() ? outer_predicate && condition : condition;
+    int num_scalarized = num_scalarized_;
+    Stmt then_case = this->VisitStmt(op->then_case);
+    predicate_ = outer_predicate;
+    if (num_scalarized_ != num_scalarized) {
+      // A part of the body is scalarized, it needs the condition as a branch.
+      return Scalarize(GetRef<Stmt>(op));
+    }
+    return then_case;
+  }
+  // Combine the predicate of a load or store with the predicate of the enclosing conditions.
+  PrimExpr CombinePredicate(PrimExpr pred, int lanes) {
+    if (!predicate_.defined()) {
+      return BroadcastTo(pred, lanes);
+    } else if (is_one(pred)) {
+      return BroadcastTo(predicate_, lanes);
+    }
+    return BroadcastTo(pred, lanes) && BroadcastTo(predicate_, lanes);
+  }
+
   // analyzer
   arith::Analyzer analyzer_;
   // deep equal
@@ -463,6 +511,12 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // Whether to predicate the stores under vector conditions instead of scalarizing them.
+  bool predicate_tail_;
+  // The predicate of the enclosing vector conditions, undefined outside of them.
+  PrimExpr predicate_;
+  // The number of scalarized statements.
+  int num_scalarized_{0};
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
   // vectorizable property
@@ -530,18 +584,34 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool scalable = false, bool predicate_tail = false)
+      : scalable_(scalable), predicate_tail_(predicate_tail) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
-    if (op->kind == ForKind::kVectorized) {
+    if (op->kind == ForKind::kVectorized && scalable_) {
+      // Leave the loop to the vectorizer of the backend, which picks the vector length at
+      // runtime and predicates the tail.
+      Stmt body = this->VisitStmt(op->body);
+      Map<String, ObjectRef> annotations = op->annotations;
+      annotations.Set(attr::scalable_vectorize, Integer(1));
+      return For(op->loop_var, op->min, op->extent, ForKind::kSerial, body, op->thread_binding,
+                 annotations, op->span);
+    } else if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
       auto* extent_as_int = op->extent.as<IntImmNode>();
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        predicate_tail_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool scalable_;
+  bool predicate_tail_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -563,12 +633,18 @@ Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.vectorize_scalable", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.vectorize_predicate_tail", Bool);
+
 // TODO(tvm-team): Make it as a target property.
 Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      bool scalable = ctx->GetConfig<Bool>("tir.vectorize_scalable", Bool(false)).value();
+      bool predicate_tail =
+          ctx->GetConfig<Bool>("tir.vectorize_predicate_tail", Bool(false)).value();
+      n->body = LoopVectorizer(scalable, predicate_tail)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -29,6 +29,8 @@
 #include <tvm/topi/nn/dense.h>
 #include <tvm/topi/nn/dilate.h>
 #include <tvm/topi/nn/flatten.h>
+#include <tvm/topi/nn/implicit_gemm.h>
+#include <tvm/topi/nn/layer_norm.h>
 #include <tvm/topi/nn/local_response_norm.h>
 #include <tvm/topi/nn/mapping.h>
 #include <tvm/topi/nn/pooling.h>
@@ -148,6 +150,39 @@ TVM_REGISTER_GLOBAL("topi.nn.lrn").set_body([](TVMArgs args, TVMRetValue* rv) {
                 static_cast<double>(args[4]), static_cast<double>(args[5]));
 });
 
+/* Ops from nn/layer_norm.h */
+TVM_REGISTER_GLOBAL("topi.nn.layer_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::layer_norm(args[0], args[1], args[2], args[3], static_cast<double>(args[4]), args[5],
+                       args[6]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.rms_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::rms_norm(args[0], args[1], args[2], static_cast<double>(args[3]), args[4]);
+});
+
+/* Ops from nn/implicit_gemm.h */
+TVM_REGISTER_GLOBAL("topi.nn.implicit_gemm_patch").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::implicit_gemm_patch(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                                args[7], args[8]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.implicit_gemm_weight").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::implicit_gemm_weight(args[0], args[1], args[2], args[3], args[4]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.implicit_gemm_output").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::implicit_gemm_output(args[0], args[1], args[2]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.conv_output_spatial").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::conv_output_spatial(args[0], args[1], args[2], args[3], args[4], args[5]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.conv_implicit_gemm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::conv_implicit_gemm(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                               args[7], args[8]);
+});
+
 /* Ops from nn/bnn.h */
 TVM_REGISTER_GLOBAL("topi.nn.binarize_pack").set_body([](TVMArgs args, TVMRetValue* rv) {
   *rv = nn::binarize_pack(args[0], args[1]);
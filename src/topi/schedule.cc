@@ -46,6 +46,7 @@
 #include <tvm/topi/x86/bnn.h>
 #include <tvm/topi/x86/default.h>
 #include <tvm/topi/x86/injective.h>
+#include <tvm/topi/x86/normalization.h>
 
 namespace tvm {
 namespace topi {
@@ -105,6 +106,10 @@ TVM_REGISTER_GLOBAL("topi.x86.schedule_injective_from_existing")
       *rv = topi::x86::schedule_injective_from_existing(args[0], args[1]);
     });
 
+TVM_REGISTER_GLOBAL("topi.x86.schedule_layer_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = topi::x86::schedule_layer_norm(args[0], args[1]);
+});
+
 /* ROCm schedules */
 TVM_REGISTER_GLOBAL("topi.rocm.dense_cuda").set_body([](TVMArgs args, TVMRetValue* rv) {
   *rv = rocm::dense_rocm(args[0], args[1], args[2], args[3], args[4]);
@@ -181,6 +186,10 @@ TVM_REGISTER_GLOBAL("topi.cuda.schedule_lrn").set_body([](TVMArgs args, TVMRetVa
   *rv = topi::cuda::schedule_lrn(args[0]);
 });
 
+TVM_REGISTER_GLOBAL("topi.cuda.schedule_layer_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = topi::cuda::schedule_layer_norm(args[0], args[1]);
+});
+
 /* Utility functions */
 TVM_REGISTER_GLOBAL("topi.utils.is_empty_shape").set_body([](TVMArgs args, TVMRetValue* rv) {
   *rv = topi::detail::is_empty_shape(args[0]);
@@ -255,6 +264,11 @@ TVM_REGISTER_GENERIC_FUNC(schedule_reduce)
     .register_func({"cpu"}, WrapSchedule(topi::x86::default_schedule_auto_inline))
     .register_func({"cuda", "gpu"}, WrapSchedule(topi::cuda::schedule_reduce));
 
+TVM_REGISTER_GENERIC_FUNC(schedule_layer_norm)
+    .set_default(WrapSchedule(topi::generic::default_schedule_auto_inline))
+    .register_func({"cpu"}, WrapSchedule(topi::x86::schedule_layer_norm))
+    .register_func({"cuda", "gpu"}, WrapSchedule(topi::cuda::schedule_layer_norm));
+
 TVM_REGISTER_GENERIC_FUNC(schedule_binarize_pack)
     .set_default(WrapSchedule(topi::generic::default_schedule))
     .register_func({"cpu"}, WrapSchedule(topi::x86::schedule_binarize_pack));
@@ -53,6 +53,26 @@ TEST(Simplify, Mod) {
   auto es = ana.canonical_simplify(mod - x);
   ICHECK(tvm::tir::is_zero(es));
 }
+
+TEST(Simplify, CacheFollowsContext) {
+  tvm::arith::Analyzer ana;
+  auto x = tvm::te::var("x");
+  auto e = x < 4;
+  // cached without knowledge of x.
+  ICHECK(!tvm::tir::is_one(ana.rewrite_simplify(e)));
+  ICHECK(!tvm::tir::is_one(ana.canonical_simplify(e)));
+  {
+    tvm::With<tvm::arith::ConstraintContext> ctx(&ana, x >= 0 && x < 4);
+    ICHECK(tvm::tir::is_one(ana.rewrite_simplify(e)));
+    ICHECK(tvm::tir::is_one(ana.canonical_simplify(e)));
+  }
+  ICHECK(!tvm::tir::is_one(ana.rewrite_simplify(e)));
+  // a new bound of x drops the cached results.
+  ana.Bind(x, tvm::Range::FromMinExtent(0, 4));
+  ICHECK(tvm::tir::is_one(ana.rewrite_simplify(e)));
+  ICHECK(tvm::tir::is_one(ana.canonical_simplify(e)));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief Throughput benchmark of the auto_scheduler search inner loop.
+ *
+ * Times sketch generation, SampleInitPopulation, EvolutionarySearch, InferBound and the feature
+ * extraction (without and with the feature cache) on conv2d, dense and softmax tasks built from
+ * the TOPI computes, and writes the timings as JSON to the file named by the
+ * TVM_AUTO_SCHEDULER_BENCHMARK_JSON environment variable, or to stdout:
+ *
+ *   {"benchmarks": [{"task": "dense", "phase": "infer_bound", "seconds": 0.12, "states": 128},
+ *                   ...]}
+ */
+#include <dmlc/json.h>
+#include <gtest/gtest.h>
+#include <tvm/auto_scheduler/compute_dag.h>
+#include <tvm/auto_scheduler/cost_model.h>
+#include <tvm/auto_scheduler/feature.h>
+#include <tvm/auto_scheduler/search_task.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/te/operation.h>
+#include <tvm/topi/nn.h>
+#include <tvm/topi/nn/dense.h>
+#include <tvm/topi/nn/softmax.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../src/auto_scheduler/search_policy/sketch_policy.h"
+
+namespace tvm {
+namespace auto_scheduler {
+
+// The random cost model calls this function, registered in Python otherwise.
+TVM_REGISTER_GLOBAL("auto_scheduler.cost_model.random_fill_float")
+    .set_body([](runtime::TVMArgs args, runtime::TVMRetValue* rv) {
+      size_t n = static_cast<int64_t>(args[0]);
+      float* data = static_cast<float*>(static_cast<void*>(args[1]));
+      std::mt19937 gen(0);
+      std::uniform_real_distribution<float> dist(0, 1);
+      for (size_t i = 0; i < n; ++i) data[i] = dist(gen);
+    });
+
+namespace {
+
+// The number of states evolved, kept small so that the benchmark runs as a test.
+constexpr int kPopulation = 128;
+constexpr int kNumIters = 2;
+constexpr int kMaxNBufs = 5;
+
+struct BenchmarkRecord {
+  std::string task;
+  std::string phase;
+  double seconds;
+  int states;
+
+  void Save(dmlc::JSONWriter* writer) const {
+    writer->BeginObject();
+    writer->WriteObjectKeyValue("task", task);
+    writer->WriteObjectKeyValue("phase", phase);
+    writer->WriteObjectKeyValue("seconds", seconds);
+    writer->WriteObjectKeyValue("states", states);
+    writer->EndObject();
+  }
+};
+
+double Time(const std::function<void()>& f) {
+  auto tic = std::chrono::high_resolution_clock::now();
+  f();
+  auto toc = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(toc - tic).count();
+}
+
+Map<String, ObjectRef> SketchParams() {
+  return {
+      {"eps_greedy", FloatImm(DataType::Float(64), 0.05)},
+      {"retry_search_one_round_on_empty", Integer(1)},
+      {"sample_init_min_population", Integer(kPopulation)},
+      {"sample_init_use_measured_ratio", FloatImm(DataType::Float(64), 0.2)},
+      {"evolutionary_search_population", Integer(kPopulation)},
+      {"evolutionary_search_num_iters", Integer(kNumIters)},
+      {"evolutionary_search_mutation_prob", FloatImm(DataType::Float(64), 0.85)},
+      {"evolutionary_search_predict_batch_size", Integer(kPopulation)},
+      {"cpu_multi_level_tiling_structure", String("SSRSRS")},
+      {"gpu_multi_level_tiling_structure", String("SSSRRSRS")},
+      {"max_innermost_split_factor", Integer(64)},
+      {"max_vectorize_size", Integer(16)},
+      {"disable_change_compute_location", Integer(0)},
+  };
+}
+
+Array<te::Tensor> Conv2d() {
+  te::Tensor data = te::placeholder({1, 64, 56, 56}, DataType::Float(32), "data");
+  te::Tensor kernel = te::placeholder({64, 64, 3, 3}, DataType::Float(32), "kernel");
+  te::Tensor conv = topi::conv2d_nchw(data, kernel, 1, 1, 1, 1);
+  return {data, kernel, topi::relu<float>(conv)};
+}
+
+Array<te::Tensor> Dense() {
+  te::Tensor data = te::placeholder({128, 512}, DataType::Float(32), "data");
+  te::Tensor weight = te::placeholder({512, 512}, DataType::Float(32), "weight");
+  return {data, weight, topi::nn::dense(data, weight, te::Tensor(), DataType::Float(32))};
+}
+
+Array<te::Tensor> Softmax() {
+  te::Tensor data = te::placeholder({128, 1024}, DataType::Float(32), "data");
+  return {data, topi::nn::softmax(data, 1)};
+}
+
+void BenchmarkTask(const std::string& name, const Array<te::Tensor>& tensors,
+                   std::vector<BenchmarkRecord>* records) {
+  ComputeDAG dag(tensors);
+  SearchTask task(dag, name, Target("llvm"), Target("llvm"), NullOpt,
+                  LayoutRewriteOption::NoRewrite, {});
+  SketchPolicy policy(task, RandomModel(), SketchParams(), 0, 0, NullOpt);
+  auto record = [&](const std::string& phase, double seconds, size_t states) {
+    records->push_back({name, phase, seconds, static_cast<int>(states)});
+  };
+
+  Array<State> sketches;
+  record("generate_sketches", Time([&]() { sketches = policy->GenerateSketches(); }),
+         sketches.size());
+  ASSERT_GT(sketches.size(), 0);
+  Array<State> population;
+  record("sample_init_population",
+         Time([&]() { population = policy->SampleInitPopulation(sketches); }), population.size());
+  ASSERT_GT(population.size(), 0);
+  Array<State> states;
+  record("evolutionary_search",
+         Time([&]() { states = policy->EvolutionarySearch(population, kPopulation); }),
+         states.size());
+  ASSERT_GT(states.size(), 0);
+
+  // A fresh DAG of the same tensors, so that none of the bounds is cached yet.
+  ComputeDAG fresh_dag(tensors);
+  Array<State> bound_states;
+  record("infer_bound", Time([&]() { bound_states = fresh_dag.InferBound(states); }),
+         states.size());
+  ASSERT_EQ(bound_states.size(), states.size());
+
+  const auto* reset_cache = runtime::Registry::Get("auto_scheduler.ResetFeatureCache");
+  ICHECK(reset_cache);
+  (*reset_cache)(1 << 16);
+  std::vector<std::vector<float>> features;
+  record("features", Time([&]() {
+           GetPerStoreFeaturesFromStates(states, task, 0, kMaxNBufs, &features);
+         }),
+         states.size());
+  ASSERT_EQ(features.size(), states.size());
+  std::vector<std::vector<float>> cached_features;
+  record("features_cached", Time([&]() {
+           GetPerStoreFeaturesFromStates(states, task, 0, kMaxNBufs, &cached_features);
+         }),
+         states.size());
+  EXPECT_EQ(cached_features, features);
+}
+
+}  // namespace
+
+TEST(AutoSchedulerBenchmark, SearchInnerLoop) {
+  std::vector<BenchmarkRecord> records;
+  BenchmarkTask("conv2d", Conv2d(), &records);
+  BenchmarkTask("dense", Dense(), &records);
+  BenchmarkTask("softmax", Softmax(), &records);
+
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.BeginObject();
+  writer.WriteObjectKeyValue("benchmarks", records);
+  writer.EndObject();
+  const char* path = std::getenv("TVM_AUTO_SCHEDULER_BENCHMARK_JSON");
+  if (path != nullptr) {
+    std::ofstream(path) << os.str() << std::endl;
+  } else {
+    std::cout << os.str() << std::endl;
+  }
+}
+
+}  // namespace auto_scheduler
+}  // namespace tvm
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../src/runtime/meta_data.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A submodule recording the constants and the loader it is initialized with. */
+class ConstsRecorderNode : public ModuleNode {
+ public:
+  const char* type_key() const final { return "consts_recorder"; }
+
+  PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
+    for (const std::string symbol : {"a", "b"}) {
+      if (name == "__init_" + symbol) {
+        return PackedFunc([this, symbol](TVMArgs args, TVMRetValue* rv) {
+          consts[symbol] = args[0];
+          *rv = 0;
+        });
+      } else if (name == "__const_loader_" + symbol) {
+        return PackedFunc([this](TVMArgs args, TVMRetValue* rv) { loader = args[0]; });
+      } else if (name == symbol) {
+        return PackedFunc([](TVMArgs args, TVMRetValue* rv) {});
+      }
+    }
+    return PackedFunc(nullptr);
+  }
+
+  std::unordered_map<std::string, Array<NDArray>> consts;
+  PackedFunc loader;
+};
+
+static NDArray Filled(float value) {
+  NDArray arr = NDArray::Empty({4}, DataType::Float(32), Device{kDLCPU, 0});
+  std::vector<float> data(4, value);
+  arr.CopyFromBytes(data.data(), data.size() * sizeof(float));
+  return arr;
+}
+
+TEST(MetadataModule, SharedConstants) {
+  std::unordered_map<std::string, NDArray> metadata = {
+      {"a_const_0", Filled(1)}, {"a_const_1", Filled(2)}, {"b_const_0", Filled(1)}};
+  Module mod = MetadataModuleCreate(metadata, {{"a", {"a_const_0", "a_const_1"}},
+                                               {"b", {"b_const_0"}}});
+  auto recorder = make_object<ConstsRecorderNode>();
+  ConstsRecorderNode* node = recorder.get();
+  mod.Import(Module(recorder));
+
+  ASSERT_NE(mod.GetFunction("a"), nullptr);
+  ASSERT_NE(mod.GetFunction("b"), nullptr);
+  ASSERT_EQ(node->consts["a"].size(), 2U);
+  ASSERT_EQ(node->consts["b"].size(), 1U);
+  // The weights with the same content are one array.
+  EXPECT_EQ(node->consts["a"][0].get(), node->consts["b"][0].get());
+  EXPECT_NE(node->consts["a"][0].get(), node->consts["a"][1].get());
+
+  // The copies to a device are made once. The CPU stands in for a device here.
+  ASSERT_NE(node->loader, nullptr);
+  NDArray weight = node->consts["a"][1];
+  NDArray first = node->loader(weight, Device{kDLCPU, 1});
+  NDArray second = node->loader(weight, Device{kDLCPU, 1});
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_NE(first.get(), weight.get());
+  NDArray on_cpu = node->loader(weight, Device{kDLCPU, 0});
+  EXPECT_EQ(on_cpu.get(), weight.get());
+}
+
+}  // namespace runtime
+}  // namespace tvm
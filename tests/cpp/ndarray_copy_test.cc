@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+namespace {
+
+NDArray Iota(std::vector<int64_t> shape) {
+  NDArray array = NDArray::Empty(shape, DataType::Float(32), Device{kDLCPU, 0});
+  float* data = static_cast<float*>(array->data);
+  for (size_t i = 0; i < GetDataSize(*array.operator->()) / sizeof(float); ++i) {
+    data[i] = static_cast<float>(i);
+  }
+  return array;
+}
+
+/*! \brief A view of a sub-region of a contiguous CPU array, with explicit strides. */
+struct StridedView {
+  StridedView(const NDArray& array, std::vector<int64_t> shape, std::vector<int64_t> begin)
+      : shape(shape), strides(shape.size()) {
+    tensor = *array.operator->();
+    int64_t stride = 1;
+    size_t offset = 0;
+    for (int i = array->ndim - 1; i >= 0; --i) {
+      strides[i] = stride;
+      offset += begin[i] * stride;
+      stride *= array->shape[i];
+    }
+    tensor.shape = this->shape.data();
+    tensor.strides = strides.data();
+    tensor.byte_offset = offset * sizeof(float);
+  }
+  std::vector<int64_t> shape, strides;
+  DLTensor tensor;
+};
+
+}  // namespace
+
+TEST(NDArrayCopy, GatherColumns) {
+  NDArray src = Iota({4, 6});
+  NDArray dst = NDArray::Empty({4, 2}, DataType::Float(32), Device{kDLCPU, 0});
+  StridedView view(src, {4, 2}, {0, 3});
+  NDArray::CopyFromTo(&view.tensor, const_cast<DLTensor*>(dst.operator->()));
+  const float* out = static_cast<const float*>(dst->data);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      EXPECT_EQ(out[i * 2 + j], static_cast<float>(i * 6 + 3 + j));
+    }
+  }
+}
+
+TEST(NDArrayCopy, ScatterIntoBatch) {
+  // Copy an input into its slot of a batch, the slot being strided in the innermost dimensions.
+  NDArray batch = NDArray::Empty({3, 2, 5}, DataType::Float(32), Device{kDLCPU, 0});
+  std::fill(static_cast<float*>(batch->data), static_cast<float*>(batch->data) + 30, -1.0f);
+  NDArray input = Iota({1, 2, 3});
+  StridedView slot(batch, {1, 2, 3}, {1, 0, 1});
+  NDArray::CopyFromTo(input.operator->(), &slot.tensor);
+  const float* out = static_cast<const float*>(batch->data);
+  for (int b = 0; b < 3; ++b) {
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        float expected = (b == 1 && j >= 1 && j < 4) ? static_cast<float>(i * 3 + j - 1) : -1.0f;
+        EXPECT_EQ(out[(b * 2 + i) * 5 + j], expected);
+      }
+    }
+  }
+}
+
+TEST(NDArrayCopy, StridedToStrided) {
+  NDArray src = Iota({2, 3, 4, 5});
+  NDArray dst = NDArray::Empty({2, 3, 4, 5}, DataType::Float(32), Device{kDLCPU, 0});
+  std::fill(static_cast<float*>(dst->data), static_cast<float*>(dst->data) + 120, -1.0f);
+  StridedView from(src, {2, 2, 3, 2}, {0, 1, 1, 2});
+  StridedView to(dst, {2, 2, 3, 2}, {0, 0, 0, 0});
+  NDArray::CopyFromTo(&from.tensor, &to.tensor);
+  const float* out = static_cast<const float*>(dst->data);
+  for (int a = 0; a < 2; ++a) {
+    for (int b = 0; b < 2; ++b) {
+      for (int c = 0; c < 3; ++c) {
+        for (int d = 0; d < 2; ++d) {
+          int src_index = ((a * 3 + b + 1) * 4 + c + 1) * 5 + d + 2;
+          EXPECT_EQ(out[((a * 3 + b) * 4 + c) * 5 + d], static_cast<float>(src_index));
+        }
+      }
+    }
+  }
+  // The elements outside of the region are untouched.
+  EXPECT_EQ(out[4], -1.0f);
+}
+
+TEST(NDArrayCopy, ShapeMismatch) {
+  NDArray src = Iota({4, 6});
+  NDArray dst = NDArray::Empty({2, 4}, DataType::Float(32), Device{kDLCPU, 0});
+  StridedView view(src, {4, 2}, {0, 0});
+  EXPECT_ANY_THROW(NDArray::CopyFromTo(&view.tensor, const_cast<DLTensor*>(dst.operator->())));
+}
+
+TEST(NDArrayCopy, DefaultEvent) {
+  Device dev{kDLCPU, 0};
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  TVMEventHandle event = api->CreateEvent(dev);
+  api->RecordEvent(dev, event, nullptr);
+  api->EventSync(dev, event);
+  api->FreeEvent(dev, event);
+}
+
+}  // namespace runtime
+}  // namespace tvm
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/object.h>
+#include <tvm/support/parallel_for.h>
+
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace test {
+
+using namespace tvm::runtime;
+
+class ArenaTestObj : public Object {
+ public:
+  explicit ArenaTestObj(int value) : value(value) { ++num_live; }
+  ~ArenaTestObj() { --num_live; }
+
+  int value;
+  static int num_live;
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "test.ArenaTestObj";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ArenaTestObj, Object);
+};
+
+int ArenaTestObj::num_live = 0;
+
+TVM_REGISTER_OBJECT_TYPE(ArenaTestObj);
+
+}  // namespace test
+}  // namespace tvm
+
+TEST(ObjectArena, Alloc) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+  void* data = ObjectArenaAlloc(16, 8);
+  EXPECT_EQ(data, nullptr);
+  {
+    ObjectArenaScope arena_scope;
+    void* a = ObjectArenaAlloc(24, 8);
+    void* b = ObjectArenaAlloc(24, 16);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0);
+    EXPECT_GE(static_cast<char*>(b) - static_cast<char*>(a), 24);
+    // The large objects are left to the default allocator.
+    EXPECT_EQ(ObjectArenaAlloc(1 << 20, 8), nullptr);
+    ObjectArenaFree(a);
+    ObjectArenaFree(b);
+  }
+}
+
+TEST(ObjectArena, EscapeScope) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+  std::vector<ObjectPtr<ArenaTestObj>> escaped;
+  tvm::Array<tvm::String> strings;
+  {
+    ObjectArenaScope arena_scope;
+    // Span several chunks, and free most of the objects in the scope.
+    for (int i = 0; i < 100000; ++i) {
+      auto obj = make_object<ArenaTestObj>(i);
+      if (i % 1000 == 0) {
+        escaped.push_back(obj);
+        strings.push_back(std::to_string(i));
+      }
+    }
+  }
+  EXPECT_EQ(ArenaTestObj::num_live, 100);
+  for (size_t i = 0; i < escaped.size(); ++i) {
+    EXPECT_EQ(escaped[i]->value, static_cast<int>(i) * 1000);
+    EXPECT_EQ(strings[i], std::to_string(i * 1000));
+  }
+  // The objects outliving the scope can be freed from any thread.
+  std::thread free_thread([&escaped]() { escaped.clear(); });
+  free_thread.join();
+  EXPECT_EQ(ArenaTestObj::num_live, 0);
+}
+
+TEST(ObjectArena, NestedScope) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+  ObjectPtr<ArenaTestObj> outer;
+  {
+    ObjectArenaScope outer_scope;
+    {
+      ObjectArenaScope inner_scope;
+      outer = make_object<ArenaTestObj>(1);
+    }
+    void* data = ObjectArenaAlloc(8, 8);
+    EXPECT_NE(data, nullptr);
+    ObjectArenaFree(data);
+  }
+  EXPECT_EQ(ObjectArenaAlloc(8, 8), nullptr);
+  EXPECT_EQ(outer->value, 1);
+}
+
+TEST(ObjectArena, ThreadConfined) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+  std::vector<ObjectPtr<ArenaTestObj>> escaped;
+  {
+    ObjectArenaScope arena_scope(true);
+    EXPECT_TRUE(ObjectArenaIsThreadConfined());
+    for (int i = 0; i < 10000; ++i) {
+      auto obj = make_object<ArenaTestObj>(i);
+      auto copy = obj;
+      EXPECT_EQ(obj.use_count(), 2);
+      if (i % 100 == 0) {
+        escaped.push_back(obj);
+      }
+    }
+    EXPECT_EQ(ArenaTestObj::num_live, 100);
+    // The tasks of parallel_for run on this thread.
+    std::thread::id this_id = std::this_thread::get_id();
+    tvm::support::parallel_for(0, 16, [this_id](int i) {
+      EXPECT_EQ(std::this_thread::get_id(), this_id);
+    });
+  }
+  EXPECT_FALSE(ObjectArenaIsThreadConfined());
+  // The objects outliving the scope are shared between threads.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&escaped]() {
+      for (int k = 0; k < 1000; ++k) {
+        for (const auto& obj : escaped) {
+          ObjectPtr<ArenaTestObj> copy = obj;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& obj : escaped) {
+    EXPECT_EQ(obj.use_count(), 1);
+  }
+  escaped.clear();
+  EXPECT_EQ(ArenaTestObj::num_live, 0);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
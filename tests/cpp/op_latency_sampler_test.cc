@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../src/runtime/op_latency_sampler.h"
+
+namespace tvm {
+namespace runtime {
+
+TEST(LatencyHistogram, Quantiles) {
+  LatencyHistogram hist;
+  EXPECT_EQ(hist.count(), 0);
+  EXPECT_EQ(hist.QuantileNanos(0.5), 0);
+  for (int i = 0; i < 99; ++i) hist.Record(1000);
+  hist.Record(1000000);
+  EXPECT_EQ(hist.count(), 100);
+  EXPECT_NEAR(hist.MeanNanos(), (99 * 1000 + 1000000) / 100.0, 1e-6);
+  // The buckets are within 12.5% of the recorded values.
+  EXPECT_NEAR(hist.QuantileNanos(0.5), 1000, 125);
+  EXPECT_NEAR(hist.QuantileNanos(0.98), 1000, 125);
+  EXPECT_NEAR(hist.QuantileNanos(1.0), 1000000, 125000);
+}
+
+TEST(LatencyHistogram, SmallAndHugeValues) {
+  LatencyHistogram hist;
+  hist.Record(-5);
+  hist.Record(3);
+  hist.Record(int64_t(1) << 50);
+  EXPECT_LT(hist.QuantileNanos(0), 1);
+  EXPECT_NEAR(hist.QuantileNanos(0.5), 3.5, 1e-6);
+  EXPECT_GE(hist.QuantileNanos(1.0), static_cast<double>(int64_t(1) << 39));
+}
+
+TEST(LatencyHistogram, ConcurrentRecord) {
+  LatencyHistogram hist;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&hist]() {
+      for (int i = 0; i < 1000; ++i) hist.Record(100 + i);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(hist.count(), 4000);
+}
+
+TEST(OpLatencySampler, SampleEveryNth) {
+  OpLatencySampler sampler;
+  EXPECT_FALSE(sampler.BeginInvocation());
+  sampler.Configure(3, {"input", "add", "relu"});
+  Device dev{kDLCPU, 0};
+  int sampled = 0;
+  for (int i = 0; i < 7; ++i) {
+    if (!sampler.BeginInvocation()) continue;
+    ++sampled;
+    for (size_t op = 1; op < 3; ++op) {
+      sampler.StartOp(op, dev);
+      sampler.StopOp();
+    }
+    sampler.EndInvocation();
+  }
+  EXPECT_EQ(sampled, 3);
+  std::string stats = sampler.StatsJSON();
+  EXPECT_NE(stats.find("\"interval\": 3, \"invocations\": 7"), std::string::npos) << stats;
+  EXPECT_NE(stats.find("\"total\": {\"count\": 3,"), std::string::npos) << stats;
+  EXPECT_NE(stats.find("{\"name\": \"add\", \"latency\": {\"count\": 3,"), std::string::npos)
+      << stats;
+  // Ops which are never timed are left out.
+  EXPECT_EQ(stats.find("input"), std::string::npos) << stats;
+
+  sampler.Configure(0, {});
+  EXPECT_FALSE(sampler.BeginInvocation());
+  EXPECT_NE(sampler.StatsJSON().find("\"ops\": []"), std::string::npos);
+}
+
+}  // namespace runtime
+}  // namespace tvm
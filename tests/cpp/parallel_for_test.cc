@@ -22,6 +22,7 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/support/parallel_for.h>
 
+#include <thread>
 #include <vector>
 
 TEST(ParallelFor, Basic) {
@@ -119,6 +120,19 @@ TEST(ParallelFor, Exception) {
   ICHECK(exception);
 }
 
+TEST(ParallelFor, ConcurrentThreads) {
+  using tvm::support::parallel_for;
+
+  std::vector<int> a(100, 0), b(100, 0);
+  std::thread other([&a]() { parallel_for(0, 100, [&a](int i) { a[i] = i; }); });
+  parallel_for(0, 100, [&b](int i) { b[i] = 2 * i; });
+  other.join();
+  for (int i = 0; i < 100; i++) {
+    ICHECK_EQ(a[i], i);
+    ICHECK_EQ(b[i], 2 * i);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
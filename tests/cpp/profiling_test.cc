@@ -18,9 +18,11 @@
  */
 
 #include <gtest/gtest.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/profiling.h>
 
 #include <chrono>
+#include <string>
 #include <thread>
 
 namespace tvm {
@@ -37,6 +39,97 @@ TEST(DefaultTimer, Basic) {
   int64_t elapsed = t->SyncAndGetElapsedNanos();
   CHECK_GT(elapsed, 9 * 1e6);
 }
+
+/*! \brief Counts the regions it is started for. */
+class RegionCounterNode : public profiling::MetricCollectorNode {
+ public:
+  void Init(const std::vector<Device>& devs) final { num_devices = devs.size(); }
+  ObjectRef Start(Device dev) final {
+    num_started += 1;
+    return ObjectRef(make_object<profiling::CountNode>(num_started));
+  }
+  Map<String, ObjectRef> Stop(ObjectRef obj) final { return {{"Region", obj}}; }
+
+  size_t num_devices{0};
+  int64_t num_started{0};
+
+  static constexpr const char* _type_key = "test.RegionCounter";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RegionCounterNode, profiling::MetricCollectorNode);
+};
+
+TEST(Profiler, MetricCollector) {
+  auto counter = make_object<RegionCounterNode>();
+  profiling::Profiler prof({profiling::MetricCollector(counter)});
+  Device dev{kDLCPU, 0};
+  prof.Start({dev});
+  prof.StartCall("a", dev);
+  prof.StopCall();
+  prof.StartCall("b", dev);
+  prof.StopCall();
+  prof.Stop();
+  EXPECT_EQ(counter->num_devices, 1U);
+  EXPECT_EQ(counter->num_started, 3);
+
+  profiling::Report report = prof.Report();
+  ASSERT_EQ(report->calls.size(), 2U);
+  EXPECT_EQ(report->calls[0]["Region"].as<profiling::CountNode>()->value, 2);
+  EXPECT_EQ(report->calls[1]["Region"].as<profiling::CountNode>()->value, 3);
+  auto total = report->device_metrics["cpu0"];
+  EXPECT_EQ(total["Region"].as<profiling::CountNode>()->value, 1);
+}
+
+TEST(Profiler, Timeline) {
+  profiling::Profiler prof({}, true);
+  Device dev{kDLCPU, 0};
+  prof.Start({dev});
+  prof.StartCall("parallel_op", dev);
+  TVMBackendParallelLaunch(
+      [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return 0;
+      },
+      nullptr, 2);
+  prof.StopCall();
+  prof.Stop();
+  // Not recorded, the profiler is stopped.
+  profiling::RecordTimelineEvent("late", profiling::TimelineNanos(), profiling::TimelineNanos());
+
+  profiling::Report report = prof.Report();
+  ASSERT_GE(report->timeline.size(), 2U);
+  EXPECT_EQ(Downcast<String>(report->timeline[0]["Name"]), "parallel_op");
+  EXPECT_EQ(Downcast<String>(report->timeline[0]["Category"]), "call");
+  double op_start = report->timeline[0]["Start (us)"].as<profiling::DurationNode>()->microseconds;
+  double op_end =
+      op_start + report->timeline[0]["Duration (us)"].as<profiling::DurationNode>()->microseconds;
+  for (size_t i = 1; i < report->timeline.size(); ++i) {
+    auto event = report->timeline[i];
+    EXPECT_EQ(Downcast<String>(event["Category"]), "thread");
+    EXPECT_EQ(std::string(Downcast<String>(event["Name"])).rfind("task ", 0), 0U);
+    double start = event["Start (us)"].as<profiling::DurationNode>()->microseconds;
+    EXPECT_GE(start, op_start);
+    EXPECT_LE(start, op_end);
+  }
+
+  std::string trace = report->AsChromeTrace();
+  EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"parallel_op\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\": \"task 0/"), std::string::npos);
+  EXPECT_EQ(trace.find("late"), std::string::npos);
+  std::string perfetto = report->AsPerfetto();
+  EXPECT_NE(perfetto.find("parallel_op"), std::string::npos);
+  // Every packet is a length delimited field 1 of the Trace message.
+  EXPECT_EQ(perfetto[0], 0x0a);
+}
+
+TEST(Profiler, NoTimeline) {
+  profiling::Profiler prof;
+  Device dev{kDLCPU, 0};
+  prof.Start({dev});
+  prof.StartCall("op", dev);
+  prof.StopCall();
+  prof.Stop();
+  EXPECT_EQ(prof.Report()->timeline.size(), 0U);
+}
 }  // namespace runtime
 }  // namespace tvm
 
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(Registry, Handle) {
+  using namespace tvm::runtime;
+  Registry::Handle handle = Registry::GetHandle("testing.registry_handle");
+  EXPECT_EQ(handle.name(), "testing.registry_handle");
+  EXPECT_TRUE(handle.Get() == nullptr);
+
+  Registry::Register("testing.registry_handle").set_body_typed([]() { return 1; });
+  ASSERT_TRUE(handle.Get() != nullptr);
+  EXPECT_EQ((*handle.Get())().operator int(), 1);
+  EXPECT_EQ(Registry::Get("testing.registry_handle"), handle.Get());
+
+  Registry::Register("testing.registry_handle", true).set_body_typed([]() { return 2; });
+  EXPECT_EQ((*handle.Get())().operator int(), 2);
+
+  EXPECT_TRUE(Registry::Remove("testing.registry_handle"));
+  EXPECT_FALSE(Registry::Remove("testing.registry_handle"));
+  EXPECT_TRUE(handle.Get() == nullptr);
+  EXPECT_TRUE(Registry::Get("testing.registry_handle") == nullptr);
+  for (const std::string& name : Registry::ListNames()) {
+    EXPECT_NE(name, "testing.registry_handle");
+  }
+
+  Registry::Register("testing.registry_handle").set_body_typed([]() { return 3; });
+  EXPECT_EQ((*handle.Get())().operator int(), 3);
+  Registry::Remove("testing.registry_handle");
+}
+
+TEST(Registry, ConcurrentGet) {
+  using namespace tvm::runtime;
+  Registry::Register("testing.registry_concurrent").set_body_typed([]() { return 1; });
+  // The lookups run while the table of the registry grows under the registrations.
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      do {
+        const PackedFunc* f = Registry::Get("testing.registry_concurrent");
+        if (f == nullptr || (*f)().operator int() != 1) {
+          ++failures;
+        }
+      } while (!done.load());
+    });
+  }
+  const int num_funcs = 4096;
+  for (int i = 0; i < num_funcs; ++i) {
+    Registry::Register("testing.registry_concurrent_" + std::to_string(i))
+        .set_body_typed([i]() { return i; });
+  }
+  done.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+  for (int i = 0; i < num_funcs; ++i) {
+    std::string name = "testing.registry_concurrent_" + std::to_string(i);
+    ASSERT_TRUE(Registry::Get(name) != nullptr);
+    EXPECT_EQ((*Registry::Get(name))().operator int(), i);
+    Registry::Remove(name);
+  }
+  Registry::Remove("testing.registry_concurrent");
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
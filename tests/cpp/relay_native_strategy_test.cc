@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/ir/module.h>
+#include <tvm/relay/analysis.h>
+#include <tvm/relay/attrs/nn.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/op.h>
+#include <tvm/relay/type.h>
+#include <tvm/runtime/executor_info.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace tvm;
+using namespace tvm::relay;
+
+// No "relay.backend.lower_call" is registered in this test, so the operators are lowered with
+// their native strategies.
+TEST(Relay, NativeStrategyBuild) {
+  const int batch = 2, in_dim = 4, units = 3;
+  auto data = relay::Var("data", relay::TensorType({batch, in_dim}, DataType::Float(32)));
+  auto weight = relay::Var("weight", relay::TensorType({units, in_dim}, DataType::Float(32)));
+  auto dense_attrs = make_object<DenseAttrs>();
+  dense_attrs->units = units;
+  auto dense = relay::Call(relay::Op::Get("nn.dense"), {data, weight}, Attrs(dense_attrs), {});
+  auto softmax_attrs = make_object<SoftmaxAttrs>();
+  softmax_attrs->axis = -1;
+  auto softmax = relay::Call(relay::Op::Get("nn.softmax"), {dense}, Attrs(softmax_attrs), {});
+  auto out = relay::Call(relay::Op::Get("add"), {softmax, data}, Attrs(), {});
+  auto func = relay::Function({data, weight}, out, relay::Type(), {});
+
+  auto A = runtime::NDArray::Empty({batch, in_dim}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  auto W = runtime::NDArray::Empty({units, in_dim}, {kDLFloat, 32, 1}, {kDLCPU, 0});
+  auto pA = static_cast<float*>(A->data);
+  auto pW = static_cast<float*>(W->data);
+  for (int i = 0; i < batch * in_dim; ++i) {
+    pA[i] = 0.1f * i;
+  }
+  for (int i = 0; i < units * in_dim; ++i) {
+    pW[i] = 0.05f * (i % 5) - 0.1f;
+  }
+  // build
+  auto pfb = runtime::Registry::Get("relay.build_module._BuildModule");
+  ICHECK(pfb);
+  runtime::Module build_mod = (*pfb)();
+  auto build_f = build_mod.GetFunction("build", false);
+  auto json_f = build_mod.GetFunction("get_graph_json", false);
+  auto mod_f = build_mod.GetFunction("get_module", false);
+  Map<Integer, Target> targets;
+  Target llvm_tgt = Target("llvm");
+  targets.Set(0, llvm_tgt);
+  build_f(IRModule::FromExpr(func), targets, llvm_tgt, runtime::kTvmExecutorGraph, "");
+  std::string json = json_f();
+  runtime::Module mod = mod_f();
+  // run
+  auto pfr = runtime::Registry::Get("tvm.graph_executor.create");
+  ICHECK(pfr);
+  runtime::Module run_mod = (*pfr)(json, mod, static_cast<int>(kDLCPU), 0);
+  run_mod.GetFunction("set_input", false)("data", A);
+  run_mod.GetFunction("set_input", false)("weight", W);
+  run_mod.GetFunction("run", false)();
+  runtime::NDArray Y = run_mod.GetFunction("get_output", false)(0);
+  auto pY = static_cast<float*>(Y->data);
+  // check against a reference
+  for (int i = 0; i < batch; ++i) {
+    std::vector<float> row(units);
+    float max_value = -INFINITY;
+    for (int j = 0; j < units; ++j) {
+      row[j] = 0;
+      for (int k = 0; k < in_dim; ++k) {
+        row[j] += pA[i * in_dim + k] * pW[j * in_dim + k];
+      }
+      max_value = std::max(max_value, row[j]);
+    }
+    float sum = 0;
+    for (int j = 0; j < units; ++j) {
+      row[j] = std::exp(row[j] - max_value);
+      sum += row[j];
+    }
+    for (int j = 0; j < units; ++j) {
+      ICHECK_LT(std::fabs(pY[i * units + j] - (row[j] / sum + pA[i * in_dim + j])), 1e-4);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
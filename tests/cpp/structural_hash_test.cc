@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/relay/expr.h>
+#include <tvm/relay/function.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <chrono>
+#include <functional>
+
+using namespace tvm;
+
+namespace {
+
+relay::Constant MakeWeight(int64_t rows, int64_t cols, float value) {
+  runtime::NDArray data = runtime::NDArray::Empty({rows, cols}, DataType::Float(32), {kDLCPU, 0});
+  float* ptr = static_cast<float*>(data->data);
+  for (int64_t i = 0; i < rows * cols; ++i) ptr[i] = value + i % 7;
+  return relay::Constant(data);
+}
+
+/*!
+ * \brief A function with the shape of a BERT encoder: per layer, the query, key,
+ *  value and output projections and the two feed forward matmuls, with constant
+ *  weights. Calls go to global vars so that no operator needs to be registered.
+ */
+relay::Function MakeEncoder(int num_layers, int64_t hidden, int64_t intermediate) {
+  relay::Var x("x", TensorType({128, static_cast<int>(hidden)}, DataType::Float(32)));
+  GlobalVar dense("dense"), add("add"), softmax("softmax"), gelu("gelu");
+  relay::Expr y = x;
+  for (int i = 0; i < num_layers; ++i) {
+    relay::Expr q = relay::Call(dense, {y, MakeWeight(hidden, hidden, i)});
+    relay::Expr k = relay::Call(dense, {y, MakeWeight(hidden, hidden, i + 1)});
+    relay::Expr v = relay::Call(dense, {y, MakeWeight(hidden, hidden, i + 2)});
+    relay::Expr attn = relay::Call(dense, {relay::Call(softmax, {relay::Call(dense, {q, k})}), v});
+    attn = relay::Call(dense, {attn, MakeWeight(hidden, hidden, i + 3)});
+    y = relay::Call(add, {y, attn});
+    relay::Expr ffn = relay::Call(dense, {y, MakeWeight(hidden, intermediate, i)});
+    ffn = relay::Call(gelu, {ffn});
+    ffn = relay::Call(dense, {ffn, MakeWeight(intermediate, hidden, i)});
+    y = relay::Call(add, {y, ffn});
+  }
+  return relay::Function({x}, y, Type(), {});
+}
+
+size_t HashWithCache(const ObjectRef& obj, const SHashCache& cache) {
+  With<SHashCache> scope(cache);
+  return StructuralHash()(obj);
+}
+
+}  // namespace
+
+TEST(SHashCache, MatchesUncachedHash) {
+  relay::Function func = MakeEncoder(2, 16, 64);
+  size_t expected = StructuralHash()(func);
+  SHashCache cache = SHashCache::Create();
+  EXPECT_EQ(HashWithCache(func, cache), expected);
+  EXPECT_GT(cache->size(), 0U);
+  EXPECT_EQ(cache->hits, 0);
+  EXPECT_EQ(HashWithCache(func, cache), expected);
+  EXPECT_GT(cache->hits, 0);
+  // Functions differing by the binding of their variables keep distinct hashes.
+  relay::Var a("a", Type()), b("b", Type());
+  relay::Constant w = MakeWeight(4, 4, 1);
+  relay::Function f0({a, b}, relay::Call(GlobalVar("dense"), {a, w}), Type(), {});
+  relay::Function f1({a, b}, relay::Call(GlobalVar("dense"), {b, w}), Type(), {});
+  EXPECT_EQ(HashWithCache(f0, cache), StructuralHash()(f0));
+  EXPECT_EQ(HashWithCache(f1, cache), StructuralHash()(f1));
+  EXPECT_NE(HashWithCache(f0, cache), HashWithCache(f1, cache));
+}
+
+TEST(SHashCache, CopyOnWrite) {
+  SHashCache cache = SHashCache::Create();
+  Array<ObjectRef> arr{String("a"), MakeWeight(8, 8, 0)->data};
+  size_t before = HashWithCache(arr, cache);
+  // The cache holds a reference, the mutation copies the array.
+  const Object* node = arr.get();
+  arr.Set(0, String("b"));
+  EXPECT_NE(arr.get(), node);
+  EXPECT_EQ(HashWithCache(arr, cache), StructuralHash()(arr));
+  EXPECT_NE(HashWithCache(arr, cache), before);
+}
+
+TEST(SHashCache, Benchmark) {
+  // BERT-base has 12 layers, a hidden size of 768 and an intermediate size of 3072,
+  // a third of the sizes keeps the test fast with the same structure.
+  relay::Function func = MakeEncoder(12, 256, 1024);
+  auto time = [](std::function<size_t()> f, size_t* hash) {
+    auto begin = std::chrono::steady_clock::now();
+    *hash = f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin)
+        .count();
+  };
+  size_t uncached_hash, first_hash, cached_hash;
+  double uncached = time([&]() { return StructuralHash()(func); }, &uncached_hash);
+  SHashCache cache = SHashCache::Create();
+  double first = time([&]() { return HashWithCache(func, cache); }, &first_hash);
+  // A function sharing the weights, such as the same module after a pass.
+  relay::Function updated = relay::Function(func->params, func->body, Type(), {});
+  double cached = time([&]() { return HashWithCache(updated, cache); }, &cached_hash);
+  EXPECT_EQ(first_hash, uncached_hash);
+  EXPECT_EQ(cached_hash, uncached_hash);
+  LOG(INFO) << "StructuralHash of a BERT-shaped function: " << uncached << " ms uncached, "
+            << first << " ms filling the cache, " << cached << " ms cached";
+  EXPECT_LT(cached, uncached);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
@@ -19,10 +19,16 @@
 
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
+#include <vector>
 
 constexpr size_t N = 128;
 
@@ -64,6 +70,112 @@ TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
   }
 }
 
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  const tvm::runtime::PackedFunc* config =
+      tvm::runtime::Registry::Get("runtime.config_threadpool");
+  ASSERT_TRUE(config != nullptr);
+  for (int chunks_per_worker : {1, 4}) {
+    (*config)(1, 0, "work_stealing", chunks_per_worker);
+    // default number of tasks and more tasks than workers.
+    for (int num_task : {0, 3, 64}) {
+      std::atomic<size_t> acc(0);
+      EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, num_task), 0);
+      EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    }
+  }
+  (*config)(1, 0, "static");
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNested) {
+  const tvm::runtime::PackedFunc* config =
+      tvm::runtime::Registry::Get("runtime.config_threadpool_nested");
+  const tvm::runtime::PackedFunc* stats = tvm::runtime::Registry::Get("runtime.threadpool_stats");
+  ASSERT_TRUE(config != nullptr && stats != nullptr);
+  static FTVMParallelLambda outer_task = [](int task_id, TVMParallelGroupEnv* penv,
+                                            void* cdata) -> int {
+    // only the first outer task launches an inner region.
+    if (task_id != 0) return 0;
+    return TVMBackendParallelLaunch(atomic_add_task_id, cdata, 0);
+  };
+  for (bool nested : {false, true}) {
+    (*config)(nested);
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(outer_task, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  (*config)(false);
+  tvm::runtime::Map<tvm::runtime::String, tvm::runtime::ObjectRef> result = (*stats)();
+  EXPECT_EQ(result.count("nested_launches"), 1U);
+  EXPECT_EQ(result.count("serialized_launches"), 1U);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchAdaptiveIdle) {
+  const tvm::runtime::PackedFunc* config =
+      tvm::runtime::Registry::Get("runtime.config_threadpool_idle");
+  const tvm::runtime::PackedFunc* stats = tvm::runtime::Registry::Get("runtime.threadpool_stats");
+  ASSERT_TRUE(config != nullptr && stats != nullptr);
+  (*config)("adaptive", 50000);
+  for (int i = 0; i < 16; ++i) {
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+    if (i % 4 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  tvm::runtime::Map<tvm::runtime::String, tvm::runtime::ObjectRef> result = (*stats)();
+  for (const char* key : {"wakeups", "wakeup_latency_ns", "parks", "wasted_spin_ns"}) {
+    EXPECT_EQ(result.count(key), 1U) << key;
+  }
+  (*config)("fixed", 0);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNamedPool) {
+  tvm::runtime::threading::CreateThreadPool("test_pool", {0, 0});
+  static FTVMParallelLambda record_thread = [](int task_id, TVMParallelGroupEnv* penv,
+                                               void* cdata) -> int {
+    reinterpret_cast<std::thread::id*>(cdata)[task_id] = std::this_thread::get_id();
+    return 0;
+  };
+  std::thread::id ids[2];
+  {
+    tvm::runtime::threading::ThreadPoolScope scope("test_pool");
+    EXPECT_EQ(TVMBackendParallelLaunch(record_thread, ids, 0), 0);
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  // all tasks of a named pool run on its own workers.
+  if (tvm::runtime::threading::MaxConcurrency() > 1) {
+    EXPECT_NE(ids[0], std::this_thread::get_id());
+    EXPECT_NE(ids[1], std::this_thread::get_id());
+  }
+}
+
+TEST(ThreadingBackend, NUMAAllocNode) {
+  using tvm::runtime::threading::GetAllocNUMANode;
+  EXPECT_GE(tvm::runtime::threading::NUMANodeCount(), 1);
+  EXPECT_EQ(GetAllocNUMANode(), -1);
+  EXPECT_EQ(tvm::runtime::threading::SetAllocNUMANode(0), -1);
+  // The allocations bound to a node are usable as any other.
+  tvm::runtime::NDArray arr =
+      tvm::runtime::NDArray::Empty({1 << 16}, DLDataType{kDLFloat, 32, 1}, DLDevice{kDLCPU, 0});
+  float* data = static_cast<float*>(arr->data);
+  std::fill(data, data + (1 << 16), 1.0f);
+  EXPECT_EQ(data[(1 << 16) - 1], 1.0f);
+  EXPECT_EQ(tvm::runtime::threading::SetAllocNUMANode(-1), 0);
+
+  std::vector<unsigned int> cpus = tvm::runtime::threading::NUMANodeCPUs(0);
+  if (cpus.empty()) return;
+  tvm::runtime::threading::CreateThreadPool("test_numa_pool", cpus, 0);
+  {
+    tvm::runtime::threading::ThreadPoolScope scope("test_numa_pool");
+    EXPECT_EQ(GetAllocNUMANode(), 0);
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  EXPECT_EQ(GetAllocNUMANode(), -1);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
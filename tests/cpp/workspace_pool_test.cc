@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include <thread>
+
+#include "../../src/runtime/workspace_pool.h"
+
+namespace tvm {
+namespace runtime {
+
+// Each test uses its own device id, since the counters are shared by all pools of a device.
+static Device TestDevice(int id) { return Device{kDLCPU, id}; }
+
+TEST(WorkspacePool, ReuseSameClass) {
+  Device dev = TestDevice(11);
+  DeviceAPI* api = DeviceAPI::Get(Device{kDLCPU, 0});
+  WorkspacePool pool(kDLCPU, api);
+  void* a = pool.AllocWorkspace(dev, 1000);
+  pool.FreeWorkspace(dev, a);
+  // Rounded to the same page as the first request.
+  void* b = pool.AllocWorkspace(dev, 4000);
+  EXPECT_EQ(a, b);
+  // A larger class is not served by the cached block.
+  void* c = pool.AllocWorkspace(dev, 5000);
+  EXPECT_NE(b, c);
+  pool.FreeWorkspace(dev, b);
+  pool.FreeWorkspace(dev, c);
+
+  WorkspacePoolStats stats = GetWorkspacePoolStats(dev);
+  EXPECT_EQ(stats.device_allocs, 2U);
+  EXPECT_EQ(stats.live_bytes, 0U);
+  EXPECT_EQ(stats.cached_bytes, 3U * 4096);
+  EXPECT_EQ(stats.peak_live_bytes, 3U * 4096);
+}
+
+TEST(WorkspacePool, LargeSizeClasses) {
+  Device dev = TestDevice(12);
+  DeviceAPI* api = DeviceAPI::Get(Device{kDLCPU, 0});
+  WorkspacePool pool(kDLCPU, api);
+  // 100 pages lies in (64, 128] pages, whose classes are 16 pages apart.
+  void* a = pool.AllocWorkspace(dev, 100 * 4096);
+  pool.FreeWorkspace(dev, a);
+  void* b = pool.AllocWorkspace(dev, 112 * 4096);
+  EXPECT_EQ(a, b);
+  pool.FreeWorkspace(dev, b);
+  void* c = pool.AllocWorkspace(dev, 113 * 4096);
+  EXPECT_NE(a, c);
+  pool.FreeWorkspace(dev, c);
+  EXPECT_EQ(GetWorkspacePoolStats(dev).cached_bytes, (112U + 128U) * 4096);
+}
+
+TEST(WorkspacePool, CrossThreadFree) {
+  Device dev = TestDevice(13);
+  DeviceAPI* api = DeviceAPI::Get(Device{kDLCPU, 0});
+  WorkspacePool pool(kDLCPU, api);
+  void* a = pool.AllocWorkspace(dev, 4096);
+  std::thread([&]() {
+    WorkspacePool other(kDLCPU, api);
+    other.FreeWorkspace(dev, a);
+  }).join();
+  EXPECT_EQ(GetWorkspacePoolStats(dev).remote_frees, 1U);
+  // The owner takes the block back on its next call.
+  void* b = pool.AllocWorkspace(dev, 4096);
+  EXPECT_EQ(a, b);
+  pool.FreeWorkspace(dev, b);
+  WorkspacePoolStats stats = GetWorkspacePoolStats(dev);
+  EXPECT_EQ(stats.device_allocs, 1U);
+  EXPECT_EQ(stats.live_bytes, 0U);
+}
+
+TEST(WorkspacePool, ResetPeak) {
+  Device dev = TestDevice(14);
+  DeviceAPI* api = DeviceAPI::Get(Device{kDLCPU, 0});
+  WorkspacePool pool(kDLCPU, api);
+  void* a = pool.AllocWorkspace(dev, 8 * 4096);
+  void* b = pool.AllocWorkspace(dev, 4096);
+  pool.FreeWorkspace(dev, a);
+  EXPECT_EQ(GetWorkspacePoolStats(dev).peak_live_bytes, 9U * 4096);
+  ResetWorkspacePoolPeak(dev);
+  EXPECT_EQ(GetWorkspacePoolStats(dev).peak_live_bytes, 4096U);
+  pool.FreeWorkspace(dev, b);
+}
+
+}  // namespace runtime
+}  // namespace tvm
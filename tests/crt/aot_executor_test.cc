@@ -20,6 +20,7 @@
 #include <dlpack/dlpack.h>
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/aot_profiler.h>
 #include <tvm/runtime/crt/internal/aot_executor/aot_executor.h>
 
 int test_run_func(TVMValue* args, int* arg_type_ids, int num_args, TVMValue* out_ret_value,
@@ -171,8 +172,82 @@ TEST(AOTRuntime, MultipleOutputs) {
   ASSERT_EQ(outputs2[0], 500);
 }
 
+int32_t workspace_pool_run_func(TVMValue* args, int* arg_type_ids, int32_t num_args,
+                                TVMValue* out_ret_value, int* out_ret_tcode,
+                                void* resource_handle) {
+  void* arg0 = (((TVMValue*)args)[0].v_handle);
+  void* arg1 = (((TVMValue*)args)[1].v_handle);
+  void* pool = (((TVMValue*)args)[2].v_handle);
+  void* placeholder = (((DLTensor*)arg0)[0].data);
+  void* T_add = (((DLTensor*)arg1)[0].data);
+  ((uint32_t*)pool)[(0)] = ((uint32_t*)placeholder)[(0)] + ((uint32_t*)placeholder)[(1)];
+  ((uint32_t*)T_add)[(0)] = ((uint32_t*)pool)[(0)];
+  return kTvmErrorNoError;
+}
+
+TEST(AOTRuntime, WorkspacePool) {
+  const tvm_model_t workspace_pool_model = {
+      .num_input_tensors = 1,
+      .num_output_tensors = 1,
+      .num_workspace_pools = 1,
+      .run_func = &workspace_pool_run_func,
+  };
+
+  uint32_t inputs1[2] = {404, 500};
+  void* inputs[] = {inputs1};
+  uint32_t outputs1[1];
+  void* outputs[] = {outputs1};
+  uint32_t pool1[1];
+  void* pools[] = {pool1};
+
+  ASSERT_EQ(kTvmErrorFunctionCallNumArguments,
+            tvm_runtime_run(&workspace_pool_model, inputs, outputs));
+  ASSERT_EQ(kTvmErrorNoError,
+            tvm_runtime_run_with_pools(&workspace_pool_model, inputs, outputs, pools));
+  ASSERT_EQ(pool1[0], 904);
+  ASSERT_EQ(outputs1[0], 904);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   testing::FLAGS_gtest_death_test_style = "threadsafe";
   return RUN_ALL_TESTS();
 }
+
+int32_t profiled_run_func(TVMValue* args, int* arg_type_ids, int32_t num_args,
+                          TVMValue* out_ret_value, int* out_ret_tcode, void* resource_handle) {
+  int32_t num_calls = args[0].v_int64;
+  for (int32_t i = 0; i < num_calls; ++i) {
+    TVMBackendProfileBegin(i);
+    TVMBackendProfileEnd(i, i == 0 ? "op_a" : "op_b");
+  }
+  return kTvmErrorNoError;
+}
+
+TEST(AOTRuntime, Profiler) {
+  const tvm_model_t profiled_model = {
+      .num_input_tensors = 0,
+      .num_output_tensors = 0,
+      .num_workspace_pools = 0,
+      .run_func = &profiled_run_func,
+  };
+  TVMValue num_calls;
+  int32_t tcode = kTVMArgInt;
+
+  num_calls.v_int64 = 2;
+  ASSERT_EQ(kTvmErrorNoError, profiled_model.run_func(&num_calls, &tcode, 1, NULL, 0, NULL));
+  ASSERT_EQ(2, TVMAotProfiler_GetNumCalls());
+  const char* name;
+  uint64_t cycles;
+  ASSERT_EQ(kTvmErrorNoError, TVMAotProfiler_GetCall(1, &name, &cycles));
+  EXPECT_STREQ("op_b", name);
+  EXPECT_EQ(10, cycles);
+
+  // The next run starts over.
+  num_calls.v_int64 = 1;
+  ASSERT_EQ(kTvmErrorNoError, profiled_model.run_func(&num_calls, &tcode, 1, NULL, 0, NULL));
+  ASSERT_EQ(1, TVMAotProfiler_GetNumCalls());
+  ASSERT_EQ(kTvmErrorNoError, TVMAotProfiler_GetCall(0, &name, &cycles));
+  EXPECT_STREQ("op_a", name);
+  EXPECT_EQ(kTvmErrorFunctionIndexInvalid, TVMAotProfiler_GetCall(1, &name, &cycles));
+}
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "platform.cc"
+
+extern "C" {
+#include <tvm/runtime/crt/internal/common/ndarray.h>
+}
+
+namespace {
+
+// Serialize a float32 tensor like NDArray::Save, with the given data size.
+std::string SaveTensor(const std::vector<int64_t>& shape, int64_t data_byte_size) {
+  std::string blob;
+  auto append = [&blob](const void* data, size_t size) {
+    blob.append(static_cast<const char*>(data), size);
+  };
+  uint64_t header = kTVMNDArrayMagic;
+  uint64_t reserved = 0;
+  DLDevice dev = {kDLCPU, 0};
+  int32_t ndim = static_cast<int32_t>(shape.size());
+  DLDataType dtype = {kDLFloat, 32, 1};
+  append(&header, sizeof(header));
+  append(&reserved, sizeof(reserved));
+  append(&dev, sizeof(dev));
+  append(&ndim, sizeof(ndim));
+  append(&dtype, sizeof(dtype));
+  for (int64_t dim : shape) {
+    append(&dim, sizeof(dim));
+  }
+  append(&data_byte_size, sizeof(data_byte_size));
+  blob.append(static_cast<size_t>(data_byte_size), '\0');
+  return blob;
+}
+
+}  // namespace
+
+TEST(NDArray, Skip) {
+  std::string blob = SaveTensor({2, 3}, 2 * 3 * 4) + "next";
+  const char* ptr = blob.data();
+  ASSERT_EQ(0, TVMNDArray_Skip(&ptr));
+  EXPECT_EQ(std::string(ptr, 4), "next");
+}
+
+TEST(NDArray, SkipInvalidSize) {
+  std::string blob = SaveTensor({2, 3}, 20);
+  const char* ptr = blob.data();
+  EXPECT_NE(0, TVMNDArray_Skip(&ptr));
+}
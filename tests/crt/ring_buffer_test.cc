@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/rpc_common/ring_buffer.h>
+
+#include <string>
+
+using ::tvm::runtime::micro_rpc::RingBuffer;
+
+class RingBufferTest : public ::testing::Test {
+ protected:
+  uint8_t storage_[8];
+  RingBuffer ring_{storage_, sizeof(storage_)};
+
+  std::string ReadAll() {
+    std::string contents;
+    const uint8_t* region;
+    size_t region_size_bytes;
+    while ((region_size_bytes = ring_.ReadRegion(&region)) > 0) {
+      contents.append(reinterpret_cast<const char*>(region), region_size_bytes);
+      ring_.CommitRead(region_size_bytes);
+    }
+    return contents;
+  }
+};
+
+TEST_F(RingBufferTest, WriteRead) {
+  EXPECT_EQ(5u, ring_.Write(reinterpret_cast<const uint8_t*>("hello"), 5));
+  EXPECT_EQ(5u, ring_.ReadAvailable());
+  EXPECT_EQ(3u, ring_.WriteAvailable());
+  EXPECT_EQ("hello", ReadAll());
+  EXPECT_EQ(0u, ring_.ReadAvailable());
+}
+
+TEST_F(RingBufferTest, WriteFull) {
+  EXPECT_EQ(8u, ring_.Write(reinterpret_cast<const uint8_t*>("0123456789"), 10));
+  EXPECT_EQ(0u, ring_.WriteAvailable());
+  uint8_t* region;
+  EXPECT_EQ(0u, ring_.WriteRegion(&region));
+  EXPECT_EQ("01234567", ReadAll());
+}
+
+TEST_F(RingBufferTest, RegionsWrapAround) {
+  EXPECT_EQ(6u, ring_.Write(reinterpret_cast<const uint8_t*>("abcdef"), 6));
+  const uint8_t* read_region;
+  EXPECT_EQ(6u, ring_.ReadRegion(&read_region));
+  ring_.CommitRead(4);
+
+  // The free space is split by the end of the storage.
+  uint8_t* write_region;
+  EXPECT_EQ(2u, ring_.WriteRegion(&write_region));
+  EXPECT_EQ(&storage_[6], write_region);
+  write_region[0] = 'g';
+  write_region[1] = 'h';
+  ring_.CommitWrite(2);
+  EXPECT_EQ(4u, ring_.WriteRegion(&write_region));
+  EXPECT_EQ(&storage_[0], write_region);
+  write_region[0] = 'i';
+  ring_.CommitWrite(1);
+
+  EXPECT_EQ(4u, ring_.ReadRegion(&read_region));
+  EXPECT_EQ(&storage_[4], read_region);
+  EXPECT_EQ("efghi", ReadAll());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  return RUN_ALL_TESTS();
+}
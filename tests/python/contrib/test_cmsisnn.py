@@ -0,0 +1,119 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""CMSIS-NN partitioning and codegen tests."""
+import numpy as np
+import pytest
+
+import tvm
+from tvm import relay
+from tvm.relay.op.contrib import cmsisnn
+
+
+def make_qnn_conv2d(kernel_shape, groups=1, kernel_layout="HWIO", padding=(0, 0), kernel_zp=0):
+    """A quantized convolution of a (1, 8, 8, 4) input like the ones of the TFLite frontend."""
+    rng = np.random.default_rng(0)
+    shape = (1, 8, 8, 4)
+    out_channels = kernel_shape[2] * kernel_shape[3] if groups != 1 else kernel_shape[3]
+    x = relay.var("x", shape=shape, dtype="int8")
+    w = relay.const(rng.integers(-128, 127, kernel_shape, dtype="int8"))
+    y = relay.qnn.op.conv2d(
+        x,
+        w,
+        input_zero_point=relay.const(-1),
+        kernel_zero_point=relay.const(kernel_zp),
+        input_scale=relay.const(0.5),
+        kernel_scale=relay.const(0.03),
+        kernel_size=kernel_shape[:2],
+        channels=out_channels,
+        groups=groups,
+        padding=padding,
+        data_layout="NHWC",
+        kernel_layout=kernel_layout,
+    )
+    bias = relay.const(rng.integers(-1000, 1000, out_channels, dtype="int32"))
+    y = relay.nn.bias_add(y, bias, axis=3)
+    y = relay.qnn.op.requantize(
+        y,
+        input_scale=relay.const(np.full(out_channels, 0.015, "float32")),
+        input_zero_point=relay.const(0),
+        output_scale=relay.const(0.1),
+        output_zero_point=relay.const(3),
+        out_dtype="int8",
+    )
+    y = relay.clip(y, a_min=3, a_max=127)
+    return tvm.IRModule.from_expr(relay.Function([x], y))
+
+
+def get_partitions(mod):
+    """The composite functions offloaded to CMSIS-NN by name."""
+    composites = []
+    for gv in mod.get_global_vars():
+        func = mod[gv]
+        if func.attrs and func.attrs.get("Compiler") == "cmsisnn":
+            composites.append(func.body.op.attrs["Composite"])
+    return sorted(composites)
+
+
+def test_partition_conv2d():
+    mod = cmsisnn.partition_for_cmsisnn(make_qnn_conv2d((3, 3, 4, 8)))
+    assert get_partitions(mod) == ["cmsisnn.qnn_conv2d"]
+
+    mod = cmsisnn.partition_for_cmsisnn(
+        make_qnn_conv2d((3, 3, 4, 2), groups=4, kernel_layout="HWOI")
+    )
+    assert get_partitions(mod) == ["cmsisnn.qnn_conv2d"]
+
+    # The kernels take symmetric weights only.
+    mod = cmsisnn.partition_for_cmsisnn(make_qnn_conv2d((3, 3, 4, 8), kernel_zp=1))
+    assert get_partitions(mod) == []
+
+
+def test_partition_pool2d():
+    x = relay.var("x", shape=(1, 8, 8, 4), dtype="int8")
+    y = relay.nn.max_pool2d(x, pool_size=(2, 2), strides=(2, 2), layout="NHWC")
+    y = relay.cast(y, "int32")
+    y = relay.nn.avg_pool2d(y, pool_size=(2, 2), layout="NHWC")
+    y = relay.cast(y, "int8")
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    mod = cmsisnn.partition_for_cmsisnn(mod)
+    assert get_partitions(mod) == ["cmsisnn.qnn_avg_pool2d", "cmsisnn.qnn_max_pool2d"]
+
+    x = relay.var("x", shape=(1, 8, 8, 4), dtype="float32")
+    y = relay.nn.max_pool2d(x, pool_size=(2, 2), layout="NHWC")
+    mod = cmsisnn.partition_for_cmsisnn(tvm.IRModule.from_expr(relay.Function([x], y)))
+    assert get_partitions(mod) == []
+
+
+@pytest.mark.skipif(not cmsisnn.enabled(), reason="The CMSIS-NN codegen is not built")
+def test_codegen_conv2d():
+    mod = cmsisnn.partition_for_cmsisnn(make_qnn_conv2d((3, 3, 4, 8), padding=(1, 1)))
+    func = [mod[gv] for gv in mod.get_global_vars() if gv.name_hint != "main"][0]
+    source = tvm.get_global_func("relay.ext.cmsisnn")(func).get_source()
+    assert "arm_convolve_wrapper_s8(&ctx, &conv_params" in source
+    assert "conv_params.input_offset = 1;" in source
+    assert "conv_params.output_offset = 3;" in source
+    assert "conv_params.padding.h = 1;" in source
+    assert "conv_params.activation.min = 3;" in source
+    assert "cmsis_nn_dims filter_dims = {8, 3, 3, 4};" in source
+    # 0.015 / 0.1 is 0.6 * 2^-2, in Q31 with a shift.
+    assert str(round(0.6 * 2 ** 31)) in source
+    assert "-2, -2" in source
+    assert "if (ctx.size > 0)" in source
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
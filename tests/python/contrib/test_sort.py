@@ -16,7 +16,7 @@
 # under the License.
 import tvm
 import tvm.testing
-from tvm import te
+from tvm import te, topi
 from tvm.topi.cuda import sort_by_key
 import numpy as np
 
@@ -91,6 +91,66 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def _build_sort(fcompute, shape, dtype):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    outs = fcompute(data)
+    outs = outs if isinstance(outs, list) else [outs]
+    s = te.create_schedule([out.op for out in outs])
+    f = tvm.build(s, [data] + outs, "llvm")
+    dev = tvm.cpu(0)
+
+    def run(np_data):
+        args = [tvm.nd.array(np_data, dev)]
+        args += [tvm.nd.empty([int(d) for d in out.shape], out.dtype, dev) for out in outs]
+        f(*args)
+        return [arg.numpy() for arg in args[1:]]
+
+    return run
+
+
+def _stable_argsort(np_data, axis, is_ascend):
+    keys = np_data if is_ascend else -np_data
+    return np.argsort(keys, axis=axis, kind="stable")
+
+
+def test_argsort_stable():
+    # The long rows are radix sorted, the short ones are sorted by comparison; both keep the
+    # equal keys in the order of their indices.
+    for dtype in ["float32", "float64", "int32", "int64"]:
+        for shape, axis in [((3, 1000), 1), ((500, 4), 0), ((2, 7, 3), 1)]:
+            np_data = np.random.randint(-20, 20, size=shape).astype(dtype)
+            for is_ascend in [True, False]:
+                run = _build_sort(
+                    lambda data: topi.argsort(data, axis=axis, is_ascend=is_ascend, dtype="int64"),
+                    shape,
+                    dtype,
+                )
+                ref = _stable_argsort(np_data, axis, is_ascend)
+                tvm.testing.assert_allclose(run(np_data)[0], ref)
+
+
+def test_sort_signed_zero():
+    np_data = np.array([[0.0, -0.0, -1.0, 0.0, -0.0] * 100], dtype="float32")
+    run = _build_sort(lambda data: topi.argsort(data, dtype="int32"), np_data.shape, "float32")
+    tvm.testing.assert_allclose(run(np_data)[0], _stable_argsort(np_data, -1, True))
+
+
+def test_topk_long_row():
+    # A long row is split across the threads when it is selected from.
+    n = 1 << 17
+    np_data = np.random.randint(0, n // 4, size=(1, n)).astype("float32")
+    for k, is_ascend in [(10, False), (10, True), (n // 2, False)]:
+        run = _build_sort(
+            lambda data: topi.topk(data, k=k, is_ascend=is_ascend, dtype="int32"),
+            np_data.shape,
+            "float32",
+        )
+        values, indices = run(np_data)
+        ref = _stable_argsort(np_data, -1, is_ascend)[:, :k]
+        tvm.testing.assert_allclose(indices, ref)
+        tvm.testing.assert_allclose(values, np.take_along_axis(np_data, ref, axis=-1))
+
+
 def test_sort_by_key_gpu():
     size = 6
     keys = te.placeholder((size,), name="keys", dtype="int32")
@@ -126,4 +186,7 @@ def test_sort_by_key_gpu():
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_argsort_stable()
+    test_sort_signed_zero()
+    test_topk_long_row()
     test_sort_by_key_gpu()
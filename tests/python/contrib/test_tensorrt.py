@@ -14,10 +14,12 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import os
 import numpy as np
 import time
 import pytest
 import itertools
+import threading
 
 import tvm
 import tvm.relay.testing
@@ -230,6 +232,44 @@ def test_tensorrt_simple_cpu_io():
     run_and_verify_func(get_graph(), target="llvm")
 
 
+def test_tensorrt_concurrent_runs():
+    if skip_codegen_test():
+        return
+    x_shape = (4, 32, 8, 8)
+    k_shape = (16, 32, 3, 3)
+    x = relay.var("x", shape=x_shape, dtype="float32")
+    kernel = relay.var("kernel", shape=k_shape, dtype="float32")
+    out = relay.nn.relu(relay.nn.conv2d(x, kernel, channels=16, kernel_size=(3, 3)))
+    mod = tvm.IRModule.from_expr(relay.Function([x, kernel], out))
+    params = {"kernel": np.random.uniform(-1, 1, k_shape).astype("float32")}
+    mod, config = tensorrt.partition_for_tensorrt(mod, params)
+    with tvm.transform.PassContext(opt_level=3, config={"relay.ext.tensorrt.options": config}):
+        lib = relay.build(mod, target="cuda", params=params)
+    if skip_runtime_test():
+        return
+
+    # The executors share the TensorRT module, each thread runs on its own execution context.
+    dev = tvm.cuda(0)
+    inputs = [np.random.uniform(-1, 1, x_shape).astype("float32") for _ in range(4)]
+    outputs = [None] * len(inputs)
+    ref = graph_executor.GraphModule(lib["default"](dev))
+
+    def run(i):
+        gmod = graph_executor.GraphModule(lib["default"](dev))
+        for _ in range(10):
+            gmod.run(x=inputs[i])
+        outputs[i] = gmod.get_output(0).numpy()
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(inputs))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for x_data, result in zip(inputs, outputs):
+        ref.run(x=x_data)
+        tvm.testing.assert_allclose(result, ref.get_output(0).numpy(), rtol=1e-5, atol=1e-5)
+
+
 def test_tensorrt_not_compatible():
     if skip_codegen_test():
         return
@@ -1280,6 +1320,96 @@ def test_tensorrt_dynamic_batch_conv():
                 assert_result_dict_holds(result_arr[i][target])
 
 
+def test_tensorrt_optimization_profiles():
+    if skip_codegen_test():
+        return
+    batches_to_test = [1, 4, 2, 8, 3, 16]
+    x_shape = (relay.Any(), 32, 8, 8)
+    x_data = np.random.uniform(-1, 1, [max(batches_to_test)] + list(x_shape)[1:]).astype("float32")
+    k_shape = (16, 32, 3, 3)
+    params = {"kernel": np.random.uniform(-1, 1, k_shape).astype("float32")}
+    profiles = {"x": [(1, 32, 8, 8), (4, 32, 8, 8), (8, 32, 8, 8)]}
+    result_arr = [{} for _ in range(len(batches_to_test))]
+    for use_trt in [True, False]:
+        x = relay.var("x", shape=x_shape, dtype="float32")
+        kernel = relay.var("kernel", shape=k_shape, dtype="float32")
+        out = relay.nn.conv2d(x, kernel, channels=16, kernel_size=(3, 3), groups=1)
+        f = relay.Function([x, kernel], relay.nn.relu(out))
+        mod = tvm.IRModule()
+        mod["main"] = f
+        config = {}
+        if use_trt:
+            mod, config = tensorrt.partition_for_tensorrt(
+                mod, params, use_implicit_batch=False, optimization_profiles=profiles
+            )
+            # The input of main is the first input of the subgraph.
+            assert list(config["optimization_profiles"].values()) == [
+                [[1, 32, 8, 8], [4, 32, 8, 8], [8, 32, 8, 8]]
+            ]
+
+        if not skip_runtime_test():
+            with tvm.transform.PassContext(
+                opt_level=3, config={"relay.ext.tensorrt.options": config}
+            ):
+                relay_exec = relay.create_executor("vm", mod=mod, device=tvm.cpu(0), target="llvm")
+
+            # The batch of 16 is outside of the profile and gets an engine of its own.
+            for i, batch_size in enumerate(batches_to_test):
+                result_arr[i][use_trt] = relay_exec.evaluate()(x_data[:batch_size, ...])
+
+    if not skip_runtime_test():
+        for i in range(len(batches_to_test)):
+            assert_result_dict_holds(result_arr[i])
+
+    with pytest.raises(ValueError):
+        tensorrt.partition_for_tensorrt(mod, optimization_profiles=profiles)
+
+
+def test_tensorrt_int8_calibration_cache():
+    if skip_codegen_test():
+        return
+    x_shape = (2, 32, 8, 8)
+    k_shape = (16, 32, 3, 3)
+    x_data = np.random.uniform(-1, 1, x_shape).astype("float32")
+    params = {"kernel": np.random.uniform(-1, 1, k_shape).astype("float32")}
+    x = relay.var("x", shape=x_shape, dtype="float32")
+    kernel = relay.var("kernel", shape=k_shape, dtype="float32")
+    out = relay.nn.conv2d(x, kernel, channels=16, kernel_size=(3, 3))
+    mod = tvm.IRModule.from_expr(relay.Function([x, kernel], relay.nn.relu(out)))
+    tmpdir = utils.tempdir()
+    cache_dir = tmpdir.relpath("cache")
+    os.makedirs(cache_dir)
+
+    def build_and_run(**kwargs):
+        trt_mod, config = tensorrt.partition_for_tensorrt(mod, params, use_int8=True, **kwargs)
+        with tvm.transform.PassContext(opt_level=3, config={"relay.ext.tensorrt.options": config}):
+            lib = relay.build(trt_mod, target="cuda", params=params)
+        if skip_runtime_test():
+            return None
+        module = graph_executor.GraphModule(lib["default"](tvm.cuda(0)))
+        # The first run calibrates, the second runs the INT8 engine.
+        for _ in range(2):
+            module.run(x=x_data)
+        return module.get_output(0).numpy()
+
+    with pytest.raises(ValueError):
+        tensorrt.partition_for_tensorrt(mod, params, int8_calibration_dir=cache_dir)
+
+    os.environ["TVM_TENSORRT_CACHE_DIR"] = cache_dir
+    try:
+        calibrated = build_and_run()
+    finally:
+        del os.environ["TVM_TENSORRT_CACHE_DIR"]
+    if skip_runtime_test():
+        return
+    tables = [name for name in os.listdir(cache_dir) if name.endswith("_int8.calib")]
+    assert len(tables) == 1
+
+    # The table of the calibration run is embedded at build time, no calibration at runtime.
+    precalibrated = build_and_run(int8_calibration_dir=cache_dir)
+    tvm.testing.assert_allclose(precalibrated, calibrated, rtol=0.1, atol=0.1)
+
+
 def test_maskrcnn_resnet50() -> None:
     """
     This function tests the working of pytorch maskrcnn with resnet50 as backbone with
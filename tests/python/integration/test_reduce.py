@@ -524,6 +524,37 @@ def test_warp_reduction2():
     check_target("rocm")
 
 
+@tvm.testing.requires_gpu
+def test_sub_and_multi_warp_reduction():
+    def check_target(device, nthx, m=8, n=2048):
+        dev = tvm.device(device, 0)
+        if not tvm.testing.device_enabled(device):
+            print("skip because %s is not enabled.." % device)
+            return
+
+        nthy = max(1, 64 // nthx)
+        A = te.placeholder((m, n), name="A")
+        k = te.reduce_axis((0, n))
+        B = te.compute((m,), lambda i: te.sum(A[i][k], axis=k), name="B")
+        s = te.create_schedule(B.op)
+        ko, _ = s[B].split(s[B].op.reduce_axis[0], nparts=nthx)
+        s[B].bind(ko, te.thread_axis((0, nthx), "threadIdx.x"))
+        xo, xi = s[B].split(s[B].op.axis[0], factor=nthy)
+        s[B].bind(xi, te.thread_axis((0, nthy), "threadIdx.y"))
+        s[B].bind(xo, te.thread_axis("blockIdx.x"))
+
+        func = tvm.build(s, [A, B], device, name="reduction")
+        a_np = np.random.uniform(size=(m, n)).astype(A.dtype)
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.array(np.zeros((m,), dtype=B.dtype), dev)
+        func(a, b)
+        tvm.testing.assert_allclose(b.numpy(), np.sum(a_np, axis=1), rtol=1e-4)
+
+    for nthx in [8, 16, 64, 128, 1024]:
+        check_target("cuda", nthx)
+        check_target("rocm", nthx)
+
+
 if __name__ == "__main__":
     test_rfactor_elemwise_threads()
     test_rfactor_threads()
@@ -534,6 +565,7 @@ if __name__ == "__main__":
     test_rfactor_argmax()
     test_warp_reduction1()
     test_warp_reduction2()
+    test_sub_and_multi_warp_reduction()
     test_init()
     test_init_imm()
     test_rfactor_init()
@@ -140,7 +140,7 @@ def emit_main_data(main_file, input_list, output_list, mod_name):
         main_file.write(f'#include "{mangle_name(mod_name,"output_data")}{i}.h"\n')
 
 
-def emit_main_run(main_file, input_list, output_list, mod_name):
+def emit_main_run(main_file, input_list, output_list, mod_name, workspace_pools=None):
     num_outputs = len(output_list)
     num_inputs = len(input_list)
 
@@ -154,6 +154,20 @@ def emit_main_run(main_file, input_list, output_list, mod_name):
     for i in range(0, len(output_list)):
         main_file.write(f'{mangle_name(mod_name,"output_data")}{i}, ')
     main_file.write("};\n")
+    if workspace_pools:
+        for pool in workspace_pools:
+            pool_name = mangle_name(mod_name, f"pool_{pool.pool_name}")
+            main_file.write(
+                f"static uint8_t {pool_name}[{int(pool.size_bytes)}] __attribute__((aligned(16)));\n"
+            )
+        main_file.write(f'void* {mangle_name(mod_name,"pools")}[{len(workspace_pools)}] = {{ ')
+        for pool in workspace_pools:
+            main_file.write(f'{mangle_name(mod_name, f"pool_{pool.pool_name}")}, ')
+        main_file.write("};\n")
+        main_file.write(
+            f'tvm_runtime_run_with_pools(&{mangle_name(mod_name,"network")}, {mangle_name(mod_name,"inputs")}, {mangle_name(mod_name,"outputs")}, {mangle_name(mod_name,"pools")});'
+        )
+        return
     main_file.write(
         f'tvm_runtime_run(&{mangle_name(mod_name,"network")}, {mangle_name(mod_name,"inputs")}, {mangle_name(mod_name,"outputs")});'
     )
@@ -191,7 +205,9 @@ def emit_main_common_includes(main_file):
     main_file.write('#include "tvm/runtime/crt/stack_allocator.h"\n')
 
 
-def create_main(test_name, input_list_map, output_list_map, output_path, workspace_bytes):
+def create_main(
+    test_name, input_list_map, output_list_map, output_path, workspace_bytes, workspace_pools=None
+):
     file_path = pathlib.Path(f"{output_path}/" + test_name).resolve()
     # create header file
     raw_path = file_path.with_suffix(".c").resolve()
@@ -209,7 +225,7 @@ def create_main(test_name, input_list_map, output_list_map, output_path, workspa
         emit_main_init_memory_manager(main_file)
 
         for k in input_list_map:
-            emit_main_run(main_file, input_list_map[k], output_list_map[k], k)
+            emit_main_run(main_file, input_list_map[k], output_list_map[k], k, workspace_pools)
 
         for k in input_list_map:
             emit_main_compare(main_file, output_list_map[k], k)
@@ -262,6 +278,8 @@ def compile_and_run(
     workspace_byte_alignment=8,
     mod_name=None,
     enable_op_fusion=True,
+    workspace_pools=None,
+    enable_inplace=False,
 ):
     """
     This method verifies the generated source
@@ -276,6 +294,10 @@ def compile_and_run(
     config = {"tir.disable_vectorize": True}
     if not enable_op_fusion:
         config["relay.FuseOps.max_depth"] = 1
+    if workspace_pools:
+        config["relay.backend.workspace_pools"] = workspace_pools
+    if enable_inplace:
+        config["relay.backend.enable_inplace"] = True
 
     with tvm.transform.PassContext(opt_level=3, config=config):
         lib = tvm.relay.build(mod, target, target_host=target, params=params, mod_name=mod_name)
@@ -310,7 +332,12 @@ def compile_and_run(
         )
 
     create_main(
-        "test.c", {mod_name: input_list}, {mod_name: output_list}, build_path, workspace_bytes
+        "test.c",
+        {mod_name: input_list},
+        {mod_name: output_list},
+        build_path,
+        workspace_bytes,
+        workspace_pools,
     )
 
     # Verify that compiles fine
@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import aot_executor, utils
+
+
+def conv_model():
+    x = relay.var("x", shape=(1, 3, 8, 8), dtype="float32")
+    w = relay.var("w", shape=(4, 3, 3, 3), dtype="float32")
+    b = relay.var("b", shape=(4,), dtype="float32")
+    y = relay.nn.bias_add(relay.nn.conv2d(x, w, padding=(1, 1)), b)
+    func = relay.Function([x, w, b], relay.Tuple([relay.nn.relu(y), relay.add(x, x)]))
+    params = {
+        "w": np.random.uniform(size=(4, 3, 3, 3)).astype("float32"),
+        "b": np.random.uniform(size=(4,)).astype("float32"),
+    }
+    return tvm.IRModule.from_expr(func), params
+
+
+def reference(mod, params, x):
+    ref = relay.create_executor("graph", mod=mod, target="llvm").evaluate()
+    return [out.numpy() for out in ref(x, **params)]
+
+
+@tvm.testing.requires_llvm
+def test_cpp_aot():
+    mod, params = conv_model()
+    x = np.random.uniform(size=(1, 3, 8, 8)).astype("float32")
+    expected = reference(mod, params, x)
+
+    lib = relay.build(mod, "llvm --executor=aot", params=params)
+    amod = aot_executor.AotModule(lib["default"](tvm.cpu()))
+    assert amod.get_num_outputs() == 2
+    # the second run reuses the arena and the packed arguments
+    for _ in range(2):
+        amod.run(x=x)
+        for i, out in enumerate(expected):
+            tvm.testing.assert_allclose(amod.get_output(i).numpy(), out, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_cpp_aot_export():
+    mod, params = conv_model()
+    x = np.random.uniform(size=(1, 3, 8, 8)).astype("float32")
+    expected = reference(mod, params, x)
+
+    lib = relay.build(mod, "llvm --executor=aot", params=params)
+    tmp = utils.tempdir()
+    path = tmp.relpath("lib.so")
+    lib.export_library(path)
+    loaded = tvm.runtime.load_module(path)
+    amod = aot_executor.AotModule(loaded["default"](tvm.cpu()))
+    amod.set_input("x", x)
+    amod.run()
+    tvm.testing.assert_allclose(amod.get_output(0).numpy(), expected[0], rtol=1e-5)
+
+    # the executor created from the config takes the params as a blob
+    amod = aot_executor.create(lib.get_executor_config(), lib.get_lib(), tvm.cpu())
+    amod.load_params(tvm.runtime.save_param_dict(lib.get_params()))
+    amod.run(x=x)
+    tvm.testing.assert_allclose(amod.get_output(1).numpy(), expected[1], rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_cpp_aot()
+    test_cpp_aot_export()
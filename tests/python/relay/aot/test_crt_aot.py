@@ -16,6 +16,7 @@
 # under the License.
 
 import os
+import re
 import io
 import struct
 import numpy as np
@@ -513,5 +514,130 @@ def test_transpose(target_options):
     compile_and_run(func, input_list, output_list, target_options, True, enable_op_fusion=False)
 
 
+@pytest.mark.parametrize("target_options", ["--unpacked-api=0", "--unpacked-api=1"])
+def test_workspace_reuse(target_options):
+    """Test that the intermediates which are not live at the same time share the arena."""
+
+    dtype = "float32"
+    x = relay.var("x", shape=(1, 256), dtype=dtype)
+    y = x
+    for op in [relay.negative, relay.abs, relay.sqrt, relay.negative]:
+        y = op(y)
+    func = relay.Function([x], y)
+    x_data = np.random.rand(1, 256).astype(dtype)
+    inputs = {"x": x_data}
+
+    # Three intermediates of 1024 bytes, the first and the third one share their bytes.
+    target = f"c -runtime=c --link-params --executor=aot {target_options}"
+    config = {"tir.disable_vectorize": True, "relay.FuseOps.max_depth": 1}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = tvm.relay.build(func, target, target_host=target)
+    main_metadata = lib.function_metadata["__tvm_main__"]
+    workspace_sizes = [int(size) for size in main_metadata.workspace_sizes.values()]
+    assert max(workspace_sizes) == 2 * 1024
+
+    output_list = generate_ref_data(func, inputs)
+    compile_and_run(func, [x_data], output_list, target_options, True, enable_op_fusion=False)
+
+
+@pytest.mark.parametrize("target_options", ["--unpacked-api=0", "--unpacked-api=1"])
+def test_workspace_inplace(target_options):
+    """Test that the elementwise operators write their output over a dead argument."""
+
+    dtype = "float32"
+    x = relay.var("x", shape=(1, 256), dtype=dtype)
+    y = x
+    for op in [relay.negative, relay.abs, relay.sqrt, relay.negative]:
+        y = op(y)
+    func = relay.Function([x], y)
+    x_data = np.random.rand(1, 256).astype(dtype)
+    inputs = {"x": x_data}
+
+    # The three intermediates of 1024 bytes are computed in the same bytes.
+    target = f"c -runtime=c --link-params --executor=aot {target_options}"
+    config = {
+        "tir.disable_vectorize": True,
+        "relay.FuseOps.max_depth": 1,
+        "relay.backend.enable_inplace": True,
+    }
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = tvm.relay.build(func, target, target_host=target)
+    main_metadata = lib.function_metadata["__tvm_main__"]
+    workspace_sizes = [int(size) for size in main_metadata.workspace_sizes.values()]
+    assert max(workspace_sizes) == 1024
+
+    output_list = generate_ref_data(func, inputs)
+    compile_and_run(
+        func,
+        [x_data],
+        output_list,
+        target_options,
+        True,
+        enable_op_fusion=False,
+        enable_inplace=True,
+    )
+
+
+@pytest.mark.parametrize("target_options", ["--unpacked-api=0", "--unpacked-api=1"])
+def test_workspace_pools(target_options):
+    """Test that the buffers are placed in the workspace pools at compile time."""
+
+    dtype = "float32"
+    x = relay.var("x", shape=(1, 3, 16, 16), dtype=dtype)
+    w = relay.var("w", shape=(8, 3, 3, 3), dtype=dtype)
+    y = relay.nn.conv2d(x, w, padding=(1, 1), kernel_size=(3, 3))
+    y = relay.nn.conv2d(relay.nn.relu(y), relay.const(np.ones((8, 8, 3, 3), dtype)), padding=(1, 1))
+    func = relay.Function([x, w], y)
+    x_data = np.random.rand(1, 3, 16, 16).astype(dtype)
+    w_data = np.random.rand(8, 3, 3, 3).astype(dtype)
+    inputs = {"x": x_data, "w": w_data}
+    pools = [
+        relay.backend.PoolInfo("dram", 1 << 20, access_cost=10),
+        relay.backend.PoolInfo("sram", 4096, access_cost=1),
+    ]
+
+    target = f"c -runtime=c --link-params --executor=aot {target_options}"
+    config = {"tir.disable_vectorize": True, "relay.backend.workspace_pools": pools}
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = tvm.relay.build(func, target, target_host=target)
+    pool_sizes = lib.function_metadata["__tvm_main__"].workspace_pool_sizes
+    assert set(pool_sizes.keys()) == {"dram", "sram"}
+    assert 0 < pool_sizes["dram"] <= 1 << 20
+    assert pool_sizes["sram"] <= 4096
+    # Nothing is left to allocate at run time.
+    for func_name, finfo in lib.function_metadata.items():
+        assert all(int(size) == 0 for size in finfo.workspace_sizes.values()), func_name
+
+    output_list = generate_ref_data(func, inputs)
+    input_list = [x_data, w_data]
+    compile_and_run(func, input_list, output_list, target_options, True, workspace_pools=pools)
+
+
+@pytest.mark.parametrize("target_options", ["--unpacked-api=0", "--unpacked-api=1"])
+def test_operator_profile(target_options):
+    """Test that the cycle counter is read around each operator call when profiling."""
+
+    dtype = "float32"
+    x = relay.var("x", shape=(1, 256), dtype=dtype)
+    func = relay.Function([x], relay.abs(relay.negative(x)))
+
+    target = f"c -runtime=c --link-params --executor=aot {target_options}"
+    config = {
+        "tir.disable_vectorize": True,
+        "relay.FuseOps.max_depth": 1,
+        "relay.backend.aot_profile": True,
+    }
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = tvm.relay.build(func, target, target_host=target)
+    source = lib.get_lib().get_source()
+    assert source.count("TVMBackendProfileBegin(") == 2
+    ends = re.findall(r'TVMBackendProfileEnd\([^,]*, "(\w+)"\)', source)
+    assert ends == ["tvmgen_default_fused_negative", "tvmgen_default_fused_abs"]
+
+    with tvm.transform.PassContext(opt_level=3, config={"tir.disable_vectorize": True}):
+        lib = tvm.relay.build(func, target, target_host=target)
+    assert "TVMBackendProfileBegin" not in lib.get_lib().get_source()
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
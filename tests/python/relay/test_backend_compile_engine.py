@@ -21,6 +21,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor, utils
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
 import tvm.testing
@@ -259,6 +260,48 @@ def test_compile_nhwc_pack():
     relay.build(mod, target="llvm")
 
 
+def _build_and_run_conv_net(config):
+    x = relay.var("x", shape=(1, 3, 16, 16))
+    w = relay.var("w", shape=(8, 3, 3, 3))
+    y = relay.nn.relu(relay.nn.conv2d(x, w, padding=(1, 1)))
+    y = relay.nn.max_pool2d(y, pool_size=(2, 2), strides=(2, 2))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], relay.exp(y) + relay.sigmoid(y)))
+    x_np = np.random.uniform(size=(1, 3, 16, 16)).astype("float32")
+    w_np = np.random.uniform(size=(8, 3, 3, 3)).astype("float32")
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = relay.build(mod, target="llvm", params={"w": w_np})
+    module = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    module.set_input("x", x_np)
+    module.run()
+    return module.get_output(0).numpy()
+
+
+def test_parallel_lowering():
+    np.random.seed(0)
+    expected = _build_and_run_conv_net({})
+    np.random.seed(0)
+    actual = _build_and_run_conv_net({"relay.backend.parallel_lowering": True})
+    tvm.testing.assert_allclose(actual, expected, rtol=1e-5)
+
+
+def test_te_compiler_disk_cache():
+    cache_dir = utils.tempdir()
+    config = {"relay.backend.te_compiler_cache_dir": cache_dir.temp_dir}
+    np.random.seed(0)
+    expected = _build_and_run_conv_net({})
+    np.random.seed(0)
+    first = _build_and_run_conv_net(config)
+    entries = sorted(cache_dir.listdir())
+    assert entries and all(e.endswith(".bin") for e in entries)
+    # The second build reads the lowered functions back from the cache.
+    np.random.seed(0)
+    config["relay.backend.parallel_lowering"] = True
+    second = _build_and_run_conv_net(config)
+    assert sorted(cache_dir.listdir()) == entries
+    tvm.testing.assert_allclose(first, expected, rtol=1e-5)
+    tvm.testing.assert_allclose(second, expected, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -268,3 +311,5 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_parallel_lowering()
+    test_te_compiler_disk_cache()
@@ -158,6 +158,141 @@ def test_plan_memory():
     )
 
 
+def test_plan_memory_inplace():
+    x = relay.var("x", shape=(10,))
+    z = relay.exp(x)
+    z = relay.nn.relu(z)
+    z = relay.add(z, x)
+    func = relay.Function([x], z)
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.transform.FuseOps(0)(mod)
+    mod = relay.transform.InferType()(mod)
+
+    def num_storage_ids(enable_inplace):
+        config = {"relay.backend.enable_inplace": enable_inplace}
+        with tvm.transform.PassContext(config=config):
+            memory_plan = relay.backend._backend.GraphPlanMemory(mod["main"])
+        storage_ids = set()
+        for v in memory_plan.expr_to_storage_info.values():
+            storage_ids.update(v.storage_ids)
+        return len(storage_ids)
+
+    # relu and add overwrite the output of exp, the parameter x is never overwritten.
+    assert num_storage_ids(False) == 3
+    assert num_storage_ids(True) == 2
+
+    config = {"relay.backend.enable_inplace": True}
+    with tvm.transform.PassContext(opt_level=0, config=config):
+        lib = relay.build(func, "llvm")
+    m = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+    data = np.random.uniform(-1, 1, size=(10,)).astype("float32")
+    m.set_input("x", data)
+    m.run()
+    tvm.testing.assert_allclose(m.get_output(0).numpy(), np.exp(data) + data, rtol=1e-5)
+
+
+def test_plan_memory_offsets():
+    x = relay.var("x", shape=(1024,))
+    e1 = relay.exp(relay.strided_slice(x, [0], [256]))
+    e2 = relay.exp(relay.strided_slice(x, [256], [512]))
+    c = relay.concatenate([e1, e2], axis=0)
+    func = relay.Function([x], relay.exp(c))
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.transform.FuseOps(0)(mod)
+    mod = relay.transform.InferType()(mod)
+
+    def planned_bytes(planner):
+        config = {"relay.backend.graph_memory_planner": planner}
+        with tvm.transform.PassContext(config=config):
+            memory_plan = relay.backend._backend.GraphPlanMemory(mod["main"])
+        storage_bytes = {}
+        for v in memory_plan.expr_to_storage_info.values():
+            for sid, size, offset in zip(v.storage_ids, v.storage_sizes, v.storage_offsets):
+                assert offset % 128 == 0
+                storage_bytes[sid] = max(storage_bytes.get(sid, 0), offset + size)
+        return sum(storage_bytes.values())
+
+    # The free list grows a 1KB storage id for the concatenate and another one for the output,
+    # keeping a third one for exp. The arena holds the 4KB live at the end, its peak.
+    x_bytes = 4096
+    assert planned_bytes("") == x_bytes + 5120
+    assert planned_bytes("greedy_by_size") == x_bytes + 4096
+    assert planned_bytes("best_fit") >= x_bytes + 4096
+
+    data = np.random.uniform(-1, 1, size=(1024,)).astype("float32")
+    expected = np.exp(np.exp(data[:512]))
+    for planner in ["greedy_by_size", "best_fit"]:
+        config = {"relay.backend.graph_memory_planner": planner}
+        with tvm.transform.PassContext(opt_level=0, config=config):
+            lib = relay.build(func, "llvm")
+        assert "storage_offset" in lib.get_graph_json()
+        m = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        m.run(x=data)
+        tvm.testing.assert_allclose(m.get_output(0).numpy(), expected, rtol=1e-5)
+
+
+def fused_with_output_scope(func, scope):
+    """Fuse each op of func into its own primitive function, whose outputs are in scope."""
+
+    class AnnotateScope(relay.ExprMutator):
+        def visit_call(self, call):
+            new_call = super().visit_call(call)
+            if isinstance(new_call.op, relay.Function):
+                fn = new_call.op.with_attr("relay.output_storage_scope", scope)
+                return relay.Call(fn, new_call.args, new_call.attrs)
+            return new_call
+
+    mod = tvm.IRModule.from_expr(func)
+    mod = relay.transform.InferType()(mod)
+    mod = relay.transform.FuseOps(0)(mod)
+    mod = tvm.IRModule.from_expr(AnnotateScope().visit(mod["main"]))
+    return relay.transform.InferType()(mod)
+
+
+def test_plan_memory_texture():
+    # The images of the NCHW4c tensors are (N*C*H, W, 4): (32, 8, 4) and (32, 4, 4).
+    x = relay.var("x", shape=(1, 4, 8, 8, 4))
+    y = relay.exp(relay.exp(relay.exp(x)))
+    y = relay.strided_slice(y, begin=[0, 0, 0, 0, 0], end=[1, 4, 8, 4, 4])
+    y = relay.exp(relay.exp(y))
+    mod = fused_with_output_scope(relay.Function([x], y), "global.texture")
+    memory_plan = relay.backend._backend.GraphPlanMemory(mod["main"])
+
+    scopes = {}
+    sizes = {}
+    for v in memory_plan.expr_to_storage_info.values():
+        for sid, scope, size in zip(v.storage_ids, v.storage_scopes, v.storage_sizes):
+            scopes[int(sid)] = scope
+            sizes[int(sid)] = int(size)
+    # The parameter is in flat memory, the exps alternate between two images that the
+    # sliced tensors reuse without growing them.
+    assert sorted(scopes.values()) == ["global", "global.texture", "global.texture"]
+    assert sorted(sizes.values()) == [4096, 4096, 4096]
+
+    with tvm.transform.PassContext(opt_level=0):
+        graph = json.loads(relay.build(mod, "llvm").get_graph_json())
+    storage_scope = graph["attrs"]["storage_scope"][1]
+    assert storage_scope[0] == "global"
+    assert set(storage_scope[1:]) == {"global.texture"}
+
+
+def test_plan_memory_texture_dtype():
+    x = relay.var("x", shape=(1, 4, 8, 8, 4))
+    y = relay.cast(relay.exp(x), "float16")
+    y = relay.cast(relay.exp(y), "float32")
+    y = relay.exp(y)
+    mod = fused_with_output_scope(relay.Function([x], y), "global.texture")
+    memory_plan = relay.backend._backend.GraphPlanMemory(mod["main"])
+    storage_ids = set()
+    for v in memory_plan.expr_to_storage_info.values():
+        storage_ids.update(int(sid) for sid in v.storage_ids)
+    # The float16 images are not shared with the float32 ones, two images of each data type
+    # and the parameter.
+    assert len(storage_ids) == 5
+
+
 def test_reshape_nop():
     # test that reshape can be turned into nop
     x = relay.var("x", shape=(10, 4))
@@ -287,5 +422,32 @@ def test_graph_executor_nested_tuples():
     tvm.testing.assert_allclose(out[1][1][1].numpy(), data[3])
 
 
+def test_graph_executor_if():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    shared = relay.exp(x)
+    # an early exit head, and a deeper branch using an expression shared with the output
+    cond = relay.greater(relay.sum(x), relay.const(0.0))
+    deep = relay.nn.relu(relay.multiply(shared, relay.const(3.0))) - x
+    out = relay.If(cond, relay.multiply(x, relay.const(2.0)), deep)
+    func = relay.Function([x], relay.Tuple([out, shared]))
+
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(tvm.IRModule.from_expr(func), target="llvm")
+    nodes = json.loads(lib.get_graph_json())["nodes"]
+    func_names = [node["attrs"]["func_name"] for node in nodes if node["op"] == "tvm_op"]
+    assert func_names.count("__if") == 1
+    # the shared exp is needed by the output, it is not guarded
+    guarded = [node["name"] for node in nodes if "branch_guard" in node.get("attrs", {})]
+    assert guarded and all("exp" not in name for name in guarded)
+
+    mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    for sign in [1, -1]:
+        x_np = sign * np.random.uniform(0.1, 1, size=(4, 8)).astype("float32")
+        mod.run(x=x_np)
+        expected = x_np * 2 if sign > 0 else np.maximum(np.exp(x_np) * 3, 0) - x_np
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+        tvm.testing.assert_allclose(mod.get_output(1).numpy(), np.exp(x_np), rtol=1e-5)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([file] + sys.argv[1:]))
@@ -233,6 +233,23 @@ def test_tuple_passing():
     tvm.testing.assert_allclose(out.numpy(), np.array(11))
 
 
+def test_parallel_independent_calls():
+    x = relay.var("x", shape=(16, 8), dtype="float32")
+    # Without fusion, each op is a primitive call, and the branches are independent.
+    branches = [relay.exp(x), relay.sigmoid(x), relay.log(x + relay.const(2.0)), relay.negative(x)]
+    func = relay.Function([x], relay.Tuple([relay.sum(b) + b for b in branches]))
+    x_np = np.random.uniform(size=(16, 8)).astype("float32")
+    expected = [np.exp(x_np), 1 / (1 + np.exp(-x_np)), np.log(x_np + 2), -x_np]
+    for parallel in [False, True]:
+        with tvm.transform.PassContext(config={"relay.Interpreter.parallel": parallel}):
+            intrp = create_executor(mod=tvm.IRModule.from_expr(func), target="llvm")
+            # The second evaluation runs the primitives compiled by the first one.
+            for _ in range(2):
+                result = intrp.evaluate()(x_np)
+                for value, ref in zip(result, expected):
+                    tvm.testing.assert_allclose(value.numpy(), np.sum(ref) + ref, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_id()
     test_add_const()
@@ -247,3 +264,4 @@ if __name__ == "__main__":
     test_tuple_getitem()
     test_function_taking_adt_ref_tuple()
     test_tuple_passing()
+    test_parallel_independent_calls()
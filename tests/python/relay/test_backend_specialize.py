@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import os
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.contrib import utils
+from tvm.relay.backend.specialize import SpecializingExecutor, specialize_input_shapes
+
+
+def dynamic_model():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    y = relay.var("y", shape=(4,), dtype="float32")
+    zeros = relay.zeros(relay.shape_of(x), "float32")
+    return tvm.IRModule.from_expr(relay.Function([x, y], zeros + x * y))
+
+
+def test_specialize_input_shapes():
+    mod = specialize_input_shapes(relay.transform.InferType()(dynamic_model()), {"x": (3, 4)})
+    func = mod["main"]
+    assert tvm.ir.structural_equal(func.params[0].checked_type, relay.TensorType((3, 4)))
+    assert tvm.ir.structural_equal(func.ret_type, relay.TensorType((3, 4)))
+    # the dynamic zeros is static once the shape of x is
+    assert "dyn.zeros" not in func.astext()
+
+
+@tvm.testing.requires_llvm
+def test_specializing_executor():
+    y = np.arange(4).astype("float32")
+    executor = SpecializingExecutor(
+        dynamic_model(), "llvm", tvm.cpu(), params={"y": y}, background=False
+    )
+    for n in [3, 5, 3]:
+        x = np.random.uniform(size=(n, 4)).astype("float32")
+        tvm.testing.assert_allclose(executor(x).numpy(), x * y, rtol=1e-6)
+    assert sorted(executor.specialized_shapes) == [((3, 4),), ((5, 4),)]
+
+
+@tvm.testing.requires_llvm
+def test_specializing_executor_background_cache():
+    tmp = utils.tempdir()
+    cache_dir = tmp.relpath("cache")
+    y = np.arange(4).astype("float32")
+    x = np.random.uniform(size=(2, 4)).astype("float32")
+
+    executor = SpecializingExecutor(dynamic_model(), "llvm", tvm.cpu(), cache_dir=cache_dir)
+    # the first run is on the dynamic model, while the specialization is built
+    tvm.testing.assert_allclose(executor(x, y).numpy(), x * y, rtol=1e-6)
+    executor.wait()
+    assert executor.specialized_shapes == [((2, 4), (4,))]
+    tvm.testing.assert_allclose(executor(x, y=y).numpy(), x * y, rtol=1e-6)
+    assert len(os.listdir(cache_dir)) == 1
+
+    # the next executor loads the cached build
+    executor = SpecializingExecutor(
+        dynamic_model(), "llvm", tvm.cpu(), cache_dir=cache_dir, background=False
+    )
+    tvm.testing.assert_allclose(executor(x, y).numpy(), x * y, rtol=1e-6)
+    assert len(os.listdir(cache_dir)) == 1
+
+
+if __name__ == "__main__":
+    test_specialize_input_shapes()
+    test_specializing_executor()
+    test_specializing_executor_background_cache()
@@ -967,6 +967,40 @@ def test_func_attrs():
     assert_parses_as(func.astext(), func)
 
 
+
+def test_indentation_and_comments():
+    program = """
+    def @main(%x: float32) -> float32 {
+    \t  // a line comment
+        /* a /* nested */ comment */
+        add(%x,     1f)
+    }
+    """
+    x = relay.var("x", shape=(), dtype="float32")
+    func = relay.Function([x], relay.add(x, relay.const(1.0)), relay.TensorType((), "float32"))
+    expected = relay.transform.InferType()(tvm.IRModule.from_expr(func))
+    assert_graph_equal(parse_module(program), expected)
+
+
+def test_meta_table_aside(tmpdir):
+    x = relay.var("x", shape=(2, 3), dtype="float32")
+    weight = relay.const(np.random.uniform(size=(2, 3)).astype("float32"))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.add(x, weight)))
+    mod = relay.transform.InferType()(mod)
+
+    text, meta_table = mod.astext_with_meta_table()
+    assert "#[metadata]" not in text
+    assert "meta[relay.Constant][0]" in text
+    assert len(meta_table["relay.Constant"]) == 1
+    tvm.ir.assert_structural_equal(tvm.parser.parse(text, init_meta_table=meta_table), mod)
+
+    path = str(tmpdir.join("mod.txt"))
+    tvm.parser.save(mod, path)
+    for use_mmap in [True, False]:
+        loaded = tvm.parser.load(path, use_mmap=use_mmap)
+        tvm.ir.assert_structural_equal(loaded, mod)
+
+
 if __name__ == "__main__":
     import sys
 
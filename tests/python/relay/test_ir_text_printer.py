@@ -293,5 +293,29 @@ def test_slash_in_identifier():
     assert "base/y" in txt
 
 
+def test_save_text(tmpdir):
+    mod = tvm.IRModule()
+    for i in range(8):
+        x = relay.var("x", shape=(2, 3))
+        weight = relay.const(np.full((2, 3), i, dtype="float32"))
+        mod["f%d" % i] = relay.Function([x], relay.add(x, weight))
+    mod = relay.transform.InferType()(mod)
+
+    path = str(tmpdir.join("mod.txt"))
+    mod.save_text(path, num_threads=4)
+    with open(path) as f:
+        text = f.read()
+    assert text.startswith(SEMVER)
+    for i in range(8):
+        assert "meta[relay.Constant][%d]" % i in text
+    tvm.ir.assert_structural_equal(tvm.parser.fromtext(text), mod)
+
+    mod.save_text(path, elide_constant_bytes=16)
+    with open(path) as f:
+        text = f.read()
+    assert text.count("meta[relay.Constant][elided]") == 8
+    assert "#[metadata]" not in text
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
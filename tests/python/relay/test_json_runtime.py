@@ -661,6 +661,112 @@ def test_partial_constant():
     check_result(mod, ref_mod, {"in_2": data2, "in_4": data4}, (10, 10), tol=1e-5)
 
 
+def get_two_partitions(ishape, wshape, dtype="float32"):
+    """Two DNNL partitions, conv2d + relu and conv2d, the second reading the first."""
+    mod = tvm.IRModule()
+    data = relay.var("data", shape=ishape, dtype=dtype)
+    w1 = relay.var("w1", shape=wshape, dtype=dtype)
+    w2 = relay.var("w2", shape=wshape, dtype=dtype)
+
+    data0 = relay.var("dnnl_0_i0", shape=ishape, dtype=dtype)
+    weight0 = relay.var("dnnl_0_i1", shape=wshape, dtype=dtype)
+    out = relay.nn.relu(relay.nn.conv2d(data0, weight0, kernel_size=(3, 3), padding=(1, 1)))
+    func = set_func_attr(relay.Function([data0, weight0], out), "dnnl", "tvmgen_default_dnnl_0")
+    glb_var0 = relay.GlobalVar("tvmgen_default_dnnl_0")
+    mod[glb_var0] = func
+
+    data1 = relay.var("dnnl_1_i0", shape=ishape, dtype=dtype)
+    weight1 = relay.var("dnnl_1_i1", shape=wshape, dtype=dtype)
+    out = relay.nn.conv2d(data1, weight1, kernel_size=(3, 3), padding=(1, 1))
+    func = set_func_attr(relay.Function([data1, weight1], out), "dnnl", "tvmgen_default_dnnl_1")
+    glb_var1 = relay.GlobalVar("tvmgen_default_dnnl_1")
+    mod[glb_var1] = func
+    mod = transform.InferType()(mod)
+
+    mod["main"] = relay.Function([data, w1, w2], glb_var1(glb_var0(data, w1), w2))
+    mod = transform.InferType()(mod)
+
+    out = relay.nn.relu(relay.nn.conv2d(data, w1, kernel_size=(3, 3), padding=(1, 1)))
+    out = relay.nn.conv2d(out, w2, kernel_size=(3, 3), padding=(1, 1))
+    ref_mod = tvm.IRModule.from_expr(relay.Function([data, w1, w2], out))
+    ref_mod = transform.InferType()(ref_mod)
+    return mod, ref_mod
+
+
+def test_propagate_blocked_layouts():
+    """Test the marking of the tensors exchanged between DNNL partitions."""
+    from tvm.relay.op.contrib.dnnl import propagate_blocked_layouts
+
+    mod, _ = get_two_partitions((1, 32, 14, 14), (32, 32, 3, 3))
+    mod = propagate_blocked_layouts(mod)
+    producer = mod["tvmgen_default_dnnl_0"]
+    consumer = mod["tvmgen_default_dnnl_1"]
+    assert [int(i) for i in producer.attrs["dnnl_blocked_outputs"]] == [0]
+    assert "dnnl_blocked_inputs" not in producer.attrs
+    assert [int(i) for i in consumer.attrs["dnnl_blocked_inputs"]] == [0]
+    # The output of main stays plain.
+    assert "dnnl_blocked_outputs" not in consumer.attrs
+
+    # An output also read by a TVM op stays plain.
+    mod, _ = get_two_partitions((1, 32, 14, 14), (32, 32, 3, 3))
+    body = mod["main"].body
+    mod["main"] = relay.Function(mod["main"].params, relay.add(body, body.args[0]))
+    mod = propagate_blocked_layouts(transform.InferType()(mod))
+    assert "dnnl_blocked_outputs" not in mod["tvmgen_default_dnnl_0"].attrs
+    assert "dnnl_blocked_inputs" not in mod["tvmgen_default_dnnl_1"].attrs
+
+def test_blocked_layouts():
+    """Test two DNNL partitions exchanging a tensor in a blocked layout."""
+    if not tvm.get_global_func("runtime.DNNLJSONRuntimeCreate", True):
+        print("skip because DNNL codegen is not available")
+        return
+    from tvm.relay.op.contrib.dnnl import propagate_blocked_layouts
+
+    dtype = "float32"
+    ishape = (1, 32, 14, 14)
+    wshape = (32, 32, 3, 3)
+    mod, ref_mod = get_two_partitions(ishape, wshape, dtype)
+    mod = propagate_blocked_layouts(mod)
+    inputs = {
+        "data": np.random.uniform(0, 1, ishape).astype(dtype),
+        "w1": np.random.uniform(0, 1, wshape).astype(dtype),
+        "w2": np.random.uniform(0, 1, wshape).astype(dtype),
+    }
+    check_result(mod, ref_mod, inputs, ishape, tol=1e-4)
+
+
+def test_dynamic_batch():
+    """Test a DNNL subgraph run with several batch sizes."""
+    if not tvm.get_global_func("runtime.DNNLJSONRuntimeCreate", True):
+        print("skip because DNNL codegen is not available")
+        return
+
+    dtype = "float32"
+    wshape = (16, 8)
+    data0 = relay.var("data", shape=(relay.Any(), 8), dtype=dtype)
+    weight0 = relay.var("weight", shape=wshape, dtype=dtype)
+    func = relay.Function([data0, weight0], relay.nn.dense(data0, weight0))
+    func = set_func_attr(func, "dnnl", "tvmgen_default_dnnl_0")
+    glb_var = relay.GlobalVar("tvmgen_default_dnnl_0")
+    mod = tvm.IRModule()
+    mod[glb_var] = func
+    mod = transform.InferType()(mod)
+    data = relay.var("data", shape=(relay.Any(), 8), dtype=dtype)
+    weight = relay.var("weight", shape=wshape, dtype=dtype)
+    mod["main"] = relay.Function([data, weight], glb_var(data, weight))
+    mod = transform.InferType()(mod)
+
+    with tvm.transform.PassContext(opt_level=3):
+        exe = relay.vm.compile(mod, target="llvm")
+    vm = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    w_data = np.random.uniform(0, 1, wshape).astype(dtype)
+    # The second run of a batch size reuses the primitives built by the first.
+    for batch in [1, 4, 1, 7, 4]:
+        i_data = np.random.uniform(0, 1, (batch, 8)).astype(dtype)
+        out = vm.run(i_data, w_data)
+        tvm.testing.assert_allclose(out.numpy(), np.dot(i_data, w_data.T), rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_conv2d()
     test_add()
@@ -671,3 +777,6 @@ if __name__ == "__main__":
     test_composite()
     test_constant()
     test_partial_constant()
+    test_propagate_blocked_layouts()
+    test_blocked_layouts()
+    test_dynamic_batch()
@@ -245,6 +245,56 @@ def test_softmax():
             np.testing.assert_allclose(op_res.numpy(), ref_res, rtol=1e-5)
 
 
+@tvm.testing.uses_gpu
+def test_layer_norm():
+    shape = (4, 10, 64)
+    dtype = "float32"
+    x = relay.var("x", shape=shape, dtype=dtype)
+    r = relay.var("r", shape=shape, dtype=dtype)
+    gamma = relay.var("gamma", shape=(64,), dtype=dtype)
+    beta = relay.var("beta", shape=(64,), dtype=dtype)
+    y = relay.nn.layer_norm(relay.add(x, r), gamma, beta, axis=-1)
+    yy = run_infer_type(y)
+    assert yy.checked_type == relay.TensorType(shape, dtype)
+    func = relay.Function([x, r, gamma, beta], y)
+    x_data = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    r_data = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    gamma_data = np.random.uniform(size=(64,)).astype(dtype)
+    beta_data = np.random.uniform(size=(64,)).astype(dtype)
+    ref_res = tvm.topi.testing.layer_norm_python(x_data + r_data, gamma_data, beta_data, -1)
+    for target, dev in tvm.testing.enabled_targets():
+        # Both the decomposed form and the fused kernel
+        for keep_norm in [False, True]:
+            config = {"relay.SimplifyInference.keep_norm": keep_norm}
+            with tvm.transform.PassContext(config=config):
+                intrp = relay.create_executor("graph", device=dev, target=target)
+                op_res = intrp.evaluate(func)(x_data, r_data, gamma_data, beta_data)
+            np.testing.assert_allclose(op_res.numpy(), ref_res, rtol=1e-5, atol=1e-5)
+
+
+@tvm.testing.uses_gpu
+def test_rms_norm():
+    shape = (3, 5, 128)
+    dtype = "float32"
+    x = relay.var("x", shape=shape, dtype=dtype)
+    gamma = relay.var("gamma", shape=(128,), dtype=dtype)
+    y = relay.nn.rms_norm(x, gamma, axis=-1, epsilon=1e-6)
+    assert "nn.rms_norm" in y.astext()
+    yy = run_infer_type(y)
+    assert yy.checked_type == relay.TensorType(shape, dtype)
+    func = relay.Function([x, gamma], y)
+    x_data = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    gamma_data = np.random.uniform(size=(128,)).astype(dtype)
+    ref_res = tvm.topi.testing.rms_norm_python(x_data, gamma_data, -1, 1e-6)
+    for target, dev in tvm.testing.enabled_targets():
+        for keep_norm in [False, True]:
+            config = {"relay.SimplifyInference.keep_norm": keep_norm}
+            with tvm.transform.PassContext(config=config):
+                intrp = relay.create_executor("graph", device=dev, target=target)
+                op_res = intrp.evaluate(func)(x_data, gamma_data)
+            np.testing.assert_allclose(op_res.numpy(), ref_res, rtol=1e-5, atol=1e-5)
+
+
 @tvm.testing.uses_gpu
 def test_log_softmax():
     for dtype in ["float16", "float32"]:
@@ -563,6 +613,8 @@ if __name__ == "__main__":
     test_expand_dims_infer_type()
     test_expand_dims()
     test_softmax()
+    test_layer_norm()
+    test_rms_norm()
     test_log_softmax()
     test_dropout()
     test_batch_norm()
@@ -638,6 +638,44 @@ def test_nll_loss(dev, target):
     _verify((10, 5), dtype="float64")
 
 
+@tvm.testing.parametrize_targets
+def test_attention(dev, target):
+    def _verify(batch, q_seq, kv_seq, dim, value_dim, scale=None, causal=False, lengths=None):
+        dtype = "float32"
+        query = relay.var("query", relay.TensorType((batch, q_seq, dim), dtype))
+        key = relay.var("key", relay.TensorType((batch, kv_seq, dim), dtype))
+        value = relay.var("value", relay.TensorType((batch, kv_seq, value_dim), dtype))
+        params = [query, key, value]
+        valid_length = None
+        if lengths is not None:
+            valid_length = relay.var("valid_length", relay.TensorType((batch,), "int32"))
+            params.append(valid_length)
+        out = relay.nn.attention(query, key, value, valid_length, scale=scale, causal=causal)
+        checked = run_infer_type(out)
+        assert checked.checked_type == relay.ty.TensorType((batch, q_seq, value_dim), dtype)
+        func = relay.Function(params, out)
+
+        query_np = np.random.uniform(-1, 1, size=(batch, q_seq, dim)).astype(dtype)
+        key_np = np.random.uniform(-1, 1, size=(batch, kv_seq, dim)).astype(dtype)
+        value_np = np.random.uniform(-1, 1, size=(batch, kv_seq, value_dim)).astype(dtype)
+        args = [query_np, key_np, value_np]
+        if lengths is not None:
+            args.append(np.array(lengths, dtype="int32"))
+        out_np = tvm.topi.testing.attention_python(
+            query_np, key_np, value_np, args[3] if lengths is not None else None, scale, causal
+        )
+
+        intrp = relay.create_executor("graph", device=dev, target=target)
+        out_relay = intrp.evaluate(func)(*args)
+        tvm.testing.assert_allclose(out_relay.asnumpy(), out_np, rtol=1e-5, atol=1e-5)
+
+    _verify(2, 16, 16, 32, 32)
+    _verify(2, 7, 130, 16, 24, scale=0.5)
+    _verify(1, 33, 33, 64, 64, causal=True)
+    _verify(3, 5, 70, 8, 8, lengths=[70, 1, 35])
+    _verify(2, 9, 20, 8, 4, causal=True, lengths=[20, 15])
+
+
 if __name__ == "__main__":
     test_adaptive_pool()
     test_collapse_sum_like()
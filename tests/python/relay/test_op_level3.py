@@ -2015,5 +2015,107 @@ def test_unique():
             verify_unique(10, dtype, is_dyn, is_sorted, return_counts)
 
 
+
+def _embedding_bag_ref(weight, indices, offsets, per_sample_weights, mode):
+    bounds = list(offsets) + [len(indices)]
+    out = np.zeros((len(offsets), weight.shape[1]), weight.dtype)
+    for b in range(len(offsets)):
+        rows = weight[indices[bounds[b] : bounds[b + 1]]]
+        if per_sample_weights is not None:
+            rows = rows * per_sample_weights[bounds[b] : bounds[b + 1], None]
+        if len(rows) == 0:
+            continue
+        out[b] = {"sum": np.sum, "mean": np.mean, "max": np.max}[mode](rows, axis=0)
+    return out
+
+
+@tvm.testing.uses_gpu
+def test_embedding_bag():
+    def verify_embedding_bag(num_embeddings, dim, offsets, num_indices, mode, weighted):
+        weight = relay.var("weight", relay.TensorType((num_embeddings, dim), "float32"))
+        indices = relay.var("indices", relay.TensorType((num_indices,), "int32"))
+        offs = relay.var("offsets", relay.TensorType((len(offsets),), "int32"))
+        args = [weight, indices, offs]
+        psw = None
+        if weighted:
+            psw = relay.var("per_sample_weights", relay.TensorType((num_indices,), "float32"))
+            args.append(psw)
+        z = relay.embedding_bag(weight, indices, offs, psw, mode=mode)
+        zz = run_infer_type(z)
+        assert zz.checked_type == relay.TensorType((len(offsets), dim), "float32")
+        func = relay.Function(args, z)
+
+        weight_np = np.random.uniform(-1, 1, size=(num_embeddings, dim)).astype("float32")
+        indices_np = np.random.randint(0, num_embeddings, size=num_indices).astype("int32")
+        offsets_np = np.array(offsets, "int32")
+        inputs = [weight_np, indices_np, offsets_np]
+        psw_np = None
+        if weighted:
+            psw_np = np.random.uniform(0, 1, size=num_indices).astype("float32")
+            inputs.append(psw_np)
+        ref_res = _embedding_bag_ref(weight_np, indices_np, offsets_np, psw_np, mode)
+
+        for target, dev in tvm.testing.enabled_targets():
+            for kind in ["graph", "debug"]:
+                intrp = relay.create_executor(kind, device=dev, target=target)
+                op_res = intrp.evaluate(func)(*inputs)
+                tvm.testing.assert_allclose(op_res.numpy(), ref_res, rtol=1e-5, atol=1e-6)
+
+    # The second and the last bags are empty.
+    offsets = [0, 3, 3, 7, 12]
+    for mode in ["sum", "mean", "max"]:
+        verify_embedding_bag(20, 16, offsets, 12, mode, False)
+        verify_embedding_bag(1000, 70, offsets, 16, mode, False)
+    verify_embedding_bag(20, 16, offsets, 12, "sum", True)
+    verify_embedding_bag(1000, 70, [0], 16, "sum", True)
+
+    weight = relay.var("weight", relay.TensorType((10, 4), "float32"))
+    indices = relay.var("indices", relay.TensorType((6,), "int32"))
+    offsets = relay.var("offsets", relay.TensorType((2,), "int32"))
+    psw = relay.var("per_sample_weights", relay.TensorType((6,), "float32"))
+    with pytest.raises(tvm.error.TVMError):
+        run_infer_type(relay.embedding_bag(weight, indices, offsets, psw, mode="max"))
+
+
+
+@tvm.testing.uses_gpu
+def test_einsum():
+    def verify_einsum(equation, shapes, legalized_ops):
+        xs = [relay.var("x%d" % i, relay.TensorType(s, "float32")) for i, s in enumerate(shapes)]
+        z = relay.einsum(xs, equation)
+        np_inputs = [np.random.uniform(-1, 1, size=shape).astype("float32") for shape in shapes]
+        ref_res = np.einsum(equation, *np_inputs)
+        zz = run_infer_type(z)
+        assert zz.checked_type == relay.TensorType(ref_res.shape, "float32")
+        func = relay.Function(xs, z)
+
+        # An einsum of several operands is lowered as pairwise contractions.
+        mod = transform.Legalize()(tvm.IRModule.from_expr(func))
+        ops = set()
+        relay.analysis.post_order_visit(
+            mod["main"], lambda e: ops.add(e.op.name) if isinstance(e, relay.Call) else None
+        )
+        assert ops.issuperset(legalized_ops), ops
+        assert legalized_ops == set() or "einsum" not in ops
+
+        for target, dev in tvm.testing.enabled_targets():
+            for kind in ["graph", "debug"]:
+                intrp = relay.create_executor(kind, device=dev, target=target)
+                op_res = intrp.evaluate(func)(*np_inputs)
+                tvm.testing.assert_allclose(op_res.numpy(), ref_res, rtol=1e-5, atol=1e-5)
+
+    verify_einsum("ij->ji", [(3, 4)], set())
+    verify_einsum("ii->i", [(4, 4)], set())
+    verify_einsum("ij,jk->ik", [(2, 3), (3, 4)], {"nn.dense"})
+    verify_einsum("ij,jk,kl->il", [(20, 10), (10, 30), (30, 3)], {"nn.dense"})
+    verify_einsum("bhqd,bhkd->bhqk", [(2, 3, 4, 8), (2, 3, 5, 8)], {"nn.batch_matmul"})
+    verify_einsum("bij,bjk->bki", [(2, 3, 4), (2, 4, 5)], {"nn.batch_matmul"})
+    verify_einsum("ij,ij->i", [(3, 4), (3, 4)], {"nn.batch_matmul"})
+    verify_einsum("i,j->ij", [(3,), (4,)], {"multiply"})
+    verify_einsum("abc,cd,de,b->ae", [(2, 3, 4), (4, 5), (5, 2), (3,)], {"nn.dense"})
+    # Broadcast labels are left to the einsum compute.
+    verify_einsum("ij,ij->i", [(1, 4), (2, 4)], set())
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+from tvm import relay
+import tvm.testing
+
+
+def pack_int4_ref(weight):
+    nibbles = weight.astype("uint8") & 0xF
+    return nibbles[..., 0::2] | (nibbles[..., 1::2] << 4)
+
+
+def dense_int4_ref(data, weight, scale):
+    if scale.ndim == 1:
+        scale = scale[:, None]
+    elif scale.ndim == 2:
+        scale = np.repeat(scale, weight.shape[1] // scale.shape[1], axis=1)
+    return np.dot(data, (weight * scale).T)
+
+
+def get_weights(units, in_dim, groups):
+    weight = np.random.randint(-8, 8, (units, in_dim)).astype("int8")
+    if groups is None:
+        scale = np.random.uniform(0.01, 0.1, (units,)).astype("float32")
+    else:
+        scale = np.random.uniform(0.01, 0.1, (units, groups)).astype("float32")
+    return weight, scale
+
+
+def test_pack_int4():
+    np.random.seed(0)
+    weight = np.random.randint(-8, 8, (6, 16)).astype("int8")
+    mod = tvm.IRModule.from_expr(relay.qnn.op.pack_int4(relay.const(weight)))
+    mod = relay.transform.FoldConstant()(mod)
+    packed = mod["main"].body
+    assert isinstance(packed, relay.Constant)
+    assert packed.data.dtype == "uint8"
+    np.testing.assert_equal(packed.data.numpy(), pack_int4_ref(weight))
+
+
+def test_type_inference():
+    data = relay.var("data", shape=(4, 32))
+    packed = relay.var("packed", shape=(8, 16), dtype="uint8")
+    for scale_shape in [(), (8,), (8, 4)]:
+        scale = relay.var("scale", shape=scale_shape)
+        func = relay.Function([data, packed, scale], relay.qnn.op.dense_int4(data, packed, scale))
+        mod = relay.transform.InferType()(tvm.IRModule.from_expr(func))
+        assert mod["main"].body.checked_type == relay.TensorType((4, 8), "float32")
+
+    # The groups must cover whole bytes.
+    scale = relay.var("scale", shape=(8, 32))
+    func = relay.Function([data, packed, scale], relay.qnn.op.dense_int4(data, packed, scale))
+    with pytest.raises(tvm.TVMError):
+        relay.transform.InferType()(tvm.IRModule.from_expr(func))
+
+
+def verify_dense_int4(target, dev, batch, units, in_dim, groups):
+    np.random.seed(0)
+    weight, scale = get_weights(units, in_dim, groups)
+    data = np.random.uniform(-1, 1, (batch, in_dim)).astype("float32")
+    x = relay.var("x", shape=(batch, in_dim))
+    packed = relay.qnn.op.pack_int4(relay.const(weight))
+    y = relay.qnn.op.dense_int4(x, packed, relay.const(scale))
+    y = relay.nn.relu(y)
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target)
+    gmod = tvm.contrib.graph_executor.GraphModule(lib["default"](dev))
+    gmod.run(x=data)
+    expected = np.maximum(dense_int4_ref(data, weight, scale), 0)
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected, rtol=1e-4, atol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_dense_int4_cpu():
+    verify_dense_int4("llvm", tvm.cpu(), 1, 16, 64, None)
+    verify_dense_int4("llvm", tvm.cpu(), 3, 24, 128, 4)
+
+
+@tvm.testing.requires_cuda
+def test_dense_int4_cuda():
+    verify_dense_int4("cuda", tvm.cuda(), 1, 16, 256, None)
+    verify_dense_int4("cuda", tvm.cuda(), 2, 32, 512, 8)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
@@ -17,6 +17,7 @@
 import os
 import numpy as np
 import tvm
+import tvm.testing
 from tvm import te, runtime
 import json
 import base64
@@ -39,6 +40,105 @@ def test_save_load():
     np.testing.assert_equal(param2["y"].numpy(), y)
 
 
+def test_save_load_mapped():
+    params = {
+        "x": np.random.uniform(size=(10, 2)).astype("float32"),
+        "y": np.arange(7).astype("int8"),
+        "z": np.random.uniform(size=(3, 5)).astype("float64"),
+    }
+    temp = utils.tempdir()
+    path = temp.relpath("params.bin")
+    runtime.save_mapped_param_dict(params, path)
+    loaded = runtime.load_mapped_param_dict(path)
+    assert len(loaded) == 3
+    for name, value in params.items():
+        assert loaded[name].device == tvm.cpu(0)
+        np.testing.assert_equal(loaded[name].numpy(), value)
+    # The mapping is copy-on-write, writes do not reach the file.
+    loaded["x"].copyfrom(np.zeros((10, 2), "float32"))
+    np.testing.assert_equal(runtime.load_mapped_param_dict(path)["x"].numpy(), params["x"])
+
+
+@tvm.testing.requires_llvm
+def test_graph_executor_mapped_params():
+    x = relay.var("x", shape=(4, 8))
+    w = relay.var("w", shape=(16, 8))
+    b = relay.var("b", shape=(16,))
+    func = relay.Function([x, w, b], relay.nn.relu(relay.nn.bias_add(relay.nn.dense(x, w), b)))
+    params = {
+        "w": np.random.uniform(-1, 1, size=(16, 8)).astype("float32"),
+        "b": np.random.uniform(-1, 1, size=(16,)).astype("float32"),
+    }
+    graph, lib, _ = relay.build(func, target="llvm")
+    temp = utils.tempdir()
+    path = temp.relpath("params.bin")
+    runtime.save_mapped_param_dict(params, path)
+
+    data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    expected = np.maximum(data.dot(params["w"].T) + params["b"], 0)
+    for _ in range(2):
+        mod = graph_executor.create(graph, lib, tvm.cpu(0))
+        mod.load_mapped_params(path)
+        mod.run(x=data)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+        np.testing.assert_equal(mod.get_input("w").numpy(), params["w"])
+
+
+@tvm.testing.requires_llvm
+def test_graph_executor_mapped_embedding_table():
+    # The embedding tables stay graph parameters, so that they can be used in place from the
+    # mapped file, only the gathered rows being read.
+    weight = relay.var("weight", shape=(1000, 32))
+    indices = relay.var("indices", shape=(10,), dtype="int32")
+    offsets = relay.var("offsets", shape=(3,), dtype="int32")
+    func = relay.Function([weight, indices, offsets], relay.embedding_bag(weight, indices, offsets))
+    params = {"weight": np.random.uniform(-1, 1, size=(1000, 32)).astype("float32")}
+    graph, lib, _ = relay.build(func, target="llvm")
+    temp = utils.tempdir()
+    path = temp.relpath("params.bin")
+    runtime.save_mapped_param_dict(params, path)
+
+    indices_np = np.random.randint(0, 1000, size=10).astype("int32")
+    offsets_np = np.array([0, 4, 7], "int32")
+    rows = params["weight"][indices_np]
+    expected = np.stack([rows[0:4].sum(0), rows[4:7].sum(0), rows[7:10].sum(0)])
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.load_mapped_params(path)
+    mod.run(indices=indices_np, offsets=offsets_np)
+    tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_graph_executor_shared_params():
+    x = relay.var("x", shape=(4, 8))
+    w = relay.var("w", shape=(16, 8))
+    b = relay.var("b", shape=(16,))
+    func = relay.Function([x, w, b], relay.nn.relu(relay.nn.bias_add(relay.nn.dense(x, w), b)))
+    graph, lib, _ = relay.build(func, target="llvm")
+    w_np = np.random.uniform(-1, 1, size=(16, 8)).astype("float32")
+    variants = [
+        {"w": w_np, "b": np.random.uniform(-1, 1, size=(16,)).astype("float32")} for _ in range(3)
+    ]
+
+    runtime.prune_constant_store()
+    num_arrays, _ = runtime.constant_store_stats()
+    data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    mods = []
+    for params in variants:
+        mod = graph_executor.create(graph, lib, tvm.cpu(0))
+        mod.load_params(runtime.save_param_dict(params), share=True)
+        mod.run(x=data)
+        expected = np.maximum(data.dot(params["w"].T) + params["b"], 0)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+        mods.append(mod)
+    # The variants share their weight and each has its own bias.
+    assert runtime.constant_store_stats()[0] == num_arrays + 1 + len(variants)
+
+    del mods, mod
+    runtime.prune_constant_store()
+    assert runtime.constant_store_stats()[0] == num_arrays
+
+
 def test_ndarray_reflection():
     # Make two `NDArrayWrapper`s that point to the same underlying array.
     np_array = np.random.uniform(size=(10, 2)).astype("float32")
@@ -91,5 +191,9 @@ def test_bigendian_rpc_param():
 
 if __name__ == "__main__":
     test_save_load()
+    test_save_load_mapped()
+    test_graph_executor_mapped_params()
+    test_graph_executor_mapped_embedding_table()
+    test_graph_executor_shared_params()
     test_ndarray_reflection()
     test_bigendian_rpc_param()
@@ -0,0 +1,125 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+import tvm.testing
+
+CPU = tvm.cpu().device_type
+GPU = tvm.cuda().device_type
+
+
+def get_model():
+    x = relay.var("x", shape=(64, 64))
+    w = relay.var("w", shape=(64, 64))
+    y = relay.exp(x)
+    y = relay.nn.dense(y, w)
+    y = relay.nn.dense(y, w)
+    return tvm.IRModule.from_expr(relay.Function([x, w], relay.log(y)))
+
+
+def dense_is_fast_on_gpu(call, device_type):
+    if call.op.name == "nn.dense":
+        return 100.0 if device_type == CPU else 1.0
+    return 1.0 if device_type == CPU else 5.0
+
+
+def placed_ops(mod):
+    placed = []
+
+    def visit(expr):
+        if isinstance(expr, relay.Call) and expr.op.name == "on_device":
+            placed.append((expr.args[0].op.name, expr.attrs.device_type))
+
+    relay.analysis.post_order_visit(mod["main"], visit)
+    return placed
+
+
+def test_place_expensive_ops():
+    mod = transform.AutoDevicePlacement(
+        "cuda", cost_fn=dense_is_fast_on_gpu, transfer_latency_us=0.1
+    )(get_model())
+    assert placed_ops(mod) == [("nn.dense", GPU), ("nn.dense", GPU)]
+    # Two copies cost more than running exp and log on the GPU.
+    mod = transform.AutoDevicePlacement("cuda", cost_fn=dense_is_fast_on_gpu)(get_model())
+    assert [name for name, _ in placed_ops(mod)] == ["exp", "nn.dense", "nn.dense", "log"]
+
+
+def test_copies_outweigh_speedup():
+    def log_on_cpu(call, device_type):
+        if call.op.name == "log" and device_type == GPU:
+            return float("inf")
+        return dense_is_fast_on_gpu(call, device_type)
+
+    mod = transform.AutoDevicePlacement("cuda", cost_fn=log_on_cpu, transfer_latency_us=1000.0)(
+        get_model()
+    )
+    assert placed_ops(mod) == []
+
+
+def test_unsupported_on_device():
+    def only_dense_on_gpu(call, device_type):
+        if call.op.name == "nn.dense":
+            return 10.0 if device_type == CPU else 1.0
+        return 2.0 if device_type == CPU else float("inf")
+
+    mod = transform.AutoDevicePlacement("cuda", cost_fn=only_dense_on_gpu, transfer_latency_us=0.1)(
+        get_model()
+    )
+    assert placed_ops(mod) == [("nn.dense", GPU), ("nn.dense", GPU)]
+
+
+def test_keep_annotations():
+    x = relay.var("x", shape=(64, 64))
+    w = relay.var("w", shape=(64, 64))
+    y = relay.annotation.on_device(relay.nn.dense(x, w), tvm.cpu())
+    y = relay.nn.dense(y, w)
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], y))
+    mod = transform.AutoDevicePlacement("cuda", cost_fn=dense_is_fast_on_gpu)(mod)
+    assert sorted(placed_ops(mod)) == [("nn.dense", CPU), ("nn.dense", GPU)]
+
+
+def test_default_cost_model():
+    x = relay.var("x", shape=(1024, 1024))
+    w = relay.var("w", shape=(1024, 1024))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], relay.nn.dense(x, w)))
+    mod = transform.InferType()(mod)
+    call = mod["main"].body
+    assert transform.estimate_op_cost(call, GPU) < transform.estimate_op_cost(call, CPU)
+    assert transform.estimate_op_cost(call, 15) == float("inf")
+
+
+@tvm.testing.requires_llvm
+@tvm.testing.requires_cuda
+def test_build_placed():
+    np.random.seed(0)
+    x = np.random.uniform(0, 1, (64, 64)).astype("float32")
+    w = np.random.uniform(0, 1, (64, 64)).astype("float32")
+    mod = transform.AutoDevicePlacement("cuda", cost_fn=dense_is_fast_on_gpu)(get_model())
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, {"cpu": "llvm", "cuda": "cuda"}, params={"w": w})
+    gmod = tvm.contrib.graph_executor.GraphModule(lib["default"](tvm.cpu(), tvm.cuda()))
+    gmod.run(x=x)
+    expected = np.log(np.dot(np.dot(np.exp(x), w.T), w.T))
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), expected, rtol=1e-4)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
@@ -136,6 +136,31 @@ def test_calibrate_percentile():
         relay.quantize.quantize(mod, params, dataset)
 
 
+def test_collect_histograms():
+    from tvm.relay.quantize import _calibrate
+
+    mod, params = testing.synthetic.get_workload()
+    dataset = get_calibration_dataset(mod, "data")
+    mod = relay.quantize.prerequisite_optimize(mod, params)
+    with relay.quantize.qconfig(calibrate_mode="kl_divergence"):
+        mod = tvm.transform.Sequential([relay.quantize.partition(), relay.quantize.annotate()])(mod)
+        samples = next(_calibrate.collect_stats(mod, dataset))
+        stats = _calibrate.collect_histograms(mod, dataset)
+
+    assert len(stats) == len(samples)
+    for (hist, edges), sample in zip(stats, samples):
+        thres = np.max(np.abs(sample))
+        np.testing.assert_allclose(edges[-1], thres, rtol=1e-6)
+        assert hist.sum() == sample.size
+        ref, _ = np.histogram(sample, bins=hist.size, range=(-thres, thres))
+        # Only the values on the bin edges may fall on the other side in float32.
+        assert np.abs(hist - ref).sum() <= 2e-3 * sample.size
+
+        exact = np.partition(np.abs(sample), int(sample.size * 0.99))[int(sample.size * 0.99)]
+        approx = _calibrate._percentile_scale_from_hist((hist, edges), 0.99)
+        assert abs(approx - exact) <= 2 * (edges[1] - edges[0])
+
+
 ####################################
 # Quant/Dequant Partitioning Tests #
 ####################################
@@ -0,0 +1,73 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relay
+from tvm.relay import transform
+
+
+def get_masked_model():
+    x = relay.var("x", shape=(2, relay.Any()), dtype="float32")
+    mask = relay.var("mask", shape=(2, relay.Any()), dtype="float32")
+    y = (x * relay.const(2.0) + relay.const(1.0)) * mask
+    out = relay.Tuple([y, relay.sum(y, axis=1)])
+    return tvm.IRModule.from_expr(relay.Function([x, mask], out))
+
+
+def test_bucket_functions():
+    mod = get_masked_model()
+    bucketed = transform.BucketDynamicShape({"x": 1, "mask": -1}, [8, 4])(mod)
+    bucketed = transform.InferType()(bucketed)
+
+    for bucket in [4, 8]:
+        func = bucketed["main_bucket_%d" % bucket]
+        for param in func.params:
+            assert list(param.checked_type.shape) == [2, bucket]
+    # The dispatching main keeps the type of the generic main.
+    mod = transform.InferType()(mod)
+    assert tvm.ir.structural_equal(bucketed["main"].checked_type, mod["main"].checked_type)
+
+
+def test_bucket_unsliceable_output():
+    x = relay.var("x", shape=(relay.Any(),), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.concatenate([x, x], axis=0)))
+    # The output extent is twice the bucket extent, it can't be sliced back.
+    bucketed = transform.BucketDynamicShape({"x": 0}, [4])(mod)
+    assert [gv.name_hint for gv in bucketed.get_global_vars()] == ["main"]
+
+
+def test_bucket_vm():
+    exe = relay.vm.compile(
+        get_masked_model(), target="llvm", shape_buckets=({"x": 1, "mask": 1}, [4, 8])
+    )
+    vm = tvm.runtime.vm.VirtualMachine(exe, tvm.cpu())
+    # Extents within, at the bound of and beyond the buckets.
+    for n in [1, 3, 4, 5, 8, 11]:
+        x = np.random.uniform(size=(2, n)).astype("float32")
+        mask = (np.random.uniform(size=(2, n)) > 0.5).astype("float32")
+        y, s = vm.invoke("main", x, mask)
+        ref = (x * 2 + 1) * mask
+        tvm.testing.assert_allclose(y.numpy(), ref, rtol=1e-5)
+        tvm.testing.assert_allclose(s.numpy(), ref.sum(axis=1), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_bucket_functions()
+    test_bucket_unsliceable_output()
+    test_bucket_vm()
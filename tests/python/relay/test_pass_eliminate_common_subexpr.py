@@ -116,6 +116,103 @@ def test_tuple_get_time():
     assert tvm.ir.structural_equal(z, expected())
 
 
+def test_commutative():
+    def before():
+        x = relay.var("x", shape=(1, 16))
+        y = relay.var("y", shape=(1, 16))
+        y1 = relay.add(x, y)
+        y2 = relay.add(y, x)
+        y3 = relay.subtract(x, y)
+        y4 = relay.subtract(y, x)
+        f = relay.Function([x, y], relay.Tuple([relay.multiply(y1, y2), y3, y4]))
+        return f
+
+    def expected():
+        x = relay.var("x", shape=(1, 16))
+        y = relay.var("y", shape=(1, 16))
+        y1 = relay.add(x, y)
+        y3 = relay.subtract(x, y)
+        y4 = relay.subtract(y, x)
+        f = relay.Function([x, y], relay.Tuple([relay.multiply(y1, y1), y3, y4]))
+        return run_opt_pass(f, transform.InferType())
+
+    z = run_opt_pass(before(), transform.InferType())
+    z = run_opt_pass(z, transform.EliminateCommonSubexpr())
+    assert tvm.ir.structural_equal(z, expected())
+
+
+def test_equivalent_layout_transforms():
+    def before():
+        x = relay.var("x", shape=(2, 4))
+        r1 = relay.reshape(x, newshape=(8,))
+        r2 = relay.reshape(x, newshape=(-1,))
+        e1 = relay.expand_dims(x, axis=0)
+        e2 = relay.reshape(x, newshape=(1, 2, 4))
+        t1 = relay.transpose(x)
+        t2 = relay.transpose(x, axes=(-1, 0))
+        t3 = relay.transpose(x, axes=(0, 1))
+        f = relay.Function([x], relay.Tuple([r1, r2, e1, e2, t1, t2, t3]))
+        return f
+
+    def expected():
+        x = relay.var("x", shape=(2, 4))
+        r = relay.reshape(x, newshape=(8,))
+        e = relay.expand_dims(x, axis=0)
+        t = relay.transpose(x)
+        t3 = relay.transpose(x, axes=(0, 1))
+        f = relay.Function([x], relay.Tuple([r, r, e, e, t, t, t3]))
+        return run_opt_pass(f, transform.InferType())
+
+    z = run_opt_pass(before(), transform.InferType())
+    z = run_opt_pass(z, transform.EliminateCommonSubexpr())
+    assert tvm.ir.structural_equal(z, expected())
+
+
+def test_fused_functions():
+    def fused(op):
+        p = relay.var("p", shape=(1, 16))
+        q = relay.var("q", shape=(1, 16))
+        body = op(relay.exp(p), relay.exp(q))
+        return relay.Function([p, q], body).with_attr("Primitive", 1)
+
+    def before():
+        x = relay.var("x", shape=(1, 16))
+        y = relay.var("y", shape=(1, 16))
+        y1 = relay.Call(fused(relay.add), [x, y])
+        y2 = relay.Call(fused(relay.add), [x, y])
+        y3 = relay.Call(fused(relay.multiply), [x, y])
+        return relay.Function([x, y], relay.Tuple([y1, y2, y3]))
+
+    def expected():
+        x = relay.var("x", shape=(1, 16))
+        y = relay.var("y", shape=(1, 16))
+        y1 = relay.Call(fused(relay.add), [x, y])
+        y3 = relay.Call(fused(relay.multiply), [x, y])
+        f = relay.Function([x, y], relay.Tuple([y1, y1, y3]))
+        return run_opt_pass(f, transform.InferType())
+
+    z = run_opt_pass(before(), transform.InferType())
+    z = run_opt_pass(z, transform.EliminateCommonSubexpr())
+    assert tvm.ir.structural_equal(z, expected())
+
+    # the bodies of the fused functions are visited
+    p = relay.var("p", shape=(1, 16))
+    body = relay.add(relay.exp(p), relay.exp(p))
+    f = relay.Function([p], body).with_attr("Primitive", 1)
+    x = relay.var("x", shape=(1, 16))
+    z = run_opt_pass(relay.Function([x], relay.Call(f, [x])), transform.InferType())
+    z = run_opt_pass(z, transform.EliminateCommonSubexpr())
+    p = relay.var("p", shape=(1, 16))
+    e = relay.exp(p)
+    f = relay.Function([p], relay.add(e, e)).with_attr("Primitive", 1)
+    x = relay.var("x", shape=(1, 16))
+    expected_func = run_opt_pass(relay.Function([x], relay.Call(f, [x])), transform.InferType())
+    assert tvm.ir.structural_equal(z, expected_func)
+
+
 if __name__ == "__main__":
     test_simple()
     test_callback()
+    test_commutative()
+    test_equivalent_layout_transforms()
+    test_fused_functions()
@@ -298,6 +298,35 @@ def test_fold_dropout():
     assert tvm.ir.structural_equal(run_infer_type(before_mod["main"]), after_mod["main"])
 
 
+def test_fold_independent_subgraphs():
+    t = relay.TensorType([4, 8], "float32")
+    weights = [np.random.uniform(size=(4, 8)).astype("float32") for _ in range(6)]
+
+    def before():
+        x = relay.var("x", t)
+        y = x
+        for w in weights:
+            c = relay.const(w)
+            # The same folded ops on each weight, the kernels are shared.
+            folded = relay.nn.relu(relay.multiply(relay.add(c, c), relay.const(0.5)))
+            folded = relay.concatenate(relay.split(folded, 2, axis=1), axis=1)
+            y = relay.add(y, folded)
+        return relay.Function([x], y)
+
+    def expected():
+        x = relay.var("x", t)
+        y = x
+        for w in weights:
+            y = relay.add(y, relay.const(np.maximum((w + w) * 0.5, 0)))
+        return relay.Function([x], y)
+
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    for parallel in [False, True]:
+        with tvm.transform.PassContext(config={"relay.FoldConstant.parallel": parallel}):
+            zz = run_opt_pass(before(), transform.FoldConstant())
+        tvm.ir.assert_structural_equal(zz, zexpected)
+
+
 if __name__ == "__main__":
     test_fold_const()
     test_fold_let()
@@ -307,3 +336,4 @@ if __name__ == "__main__":
     test_fold_batch_norm()
     test_fold_ndarray_size()
     test_fold_dropout()
+    test_fold_independent_subgraphs()
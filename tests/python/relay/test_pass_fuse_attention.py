@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+import tvm.topi.testing
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.testing import run_opt_pass
+
+
+def _composed(batch, q_seq, kv_seq, dim, scale=None, divide=False, transpose_value=True):
+    query = relay.var("query", shape=(batch, q_seq, dim), dtype="float32")
+    key = relay.var("key", shape=(batch, kv_seq, dim), dtype="float32")
+    value_shape = (batch, kv_seq, dim) if transpose_value else (batch, dim, kv_seq)
+    value = relay.var("value", shape=value_shape, dtype="float32")
+    scores = relay.nn.batch_matmul(query, key)
+    if scale is not None:
+        if divide:
+            scores = relay.divide(scores, relay.const(scale, "float32"))
+        else:
+            scores = relay.multiply(scores, relay.const(scale, "float32"))
+    probs = relay.nn.softmax(scores, axis=-1)
+    value_t = relay.transpose(value, axes=(0, 2, 1)) if transpose_value else value
+    out = relay.nn.batch_matmul(probs, value_t)
+    return relay.Function([query, key, value], out)
+
+
+def _find_attention(func):
+    calls = []
+
+    def _visit(expr):
+        if isinstance(expr, relay.Call) and expr.op == relay.op.get("nn.attention"):
+            calls.append(expr)
+
+    relay.analysis.post_order_visit(func, _visit)
+    return calls
+
+
+def test_fuse_attention_rewrite():
+    func = run_opt_pass(_composed(2, 8, 8, 16, scale=0.25), transform.FuseAttention())
+    calls = _find_attention(func)
+    assert len(calls) == 1
+    assert abs(calls[0].attrs.scale - 0.25) < 1e-6
+    assert not calls[0].attrs.causal
+    # The transpose of the values is folded into the operator
+    assert isinstance(calls[0].args[2], relay.Var)
+
+    func = run_opt_pass(_composed(2, 8, 8, 16, scale=4.0, divide=True), transform.FuseAttention())
+    calls = _find_attention(func)
+    assert len(calls) == 1
+    assert abs(calls[0].attrs.scale - 0.25) < 1e-6
+
+    func = run_opt_pass(_composed(2, 8, 8, 16), transform.FuseAttention())
+    calls = _find_attention(func)
+    assert len(calls) == 1
+    assert calls[0].attrs.scale == 1.0
+
+
+def test_fuse_attention_no_match():
+    # The softmax is not over the keys
+    query = relay.var("query", shape=(2, 8, 16), dtype="float32")
+    key = relay.var("key", shape=(2, 8, 16), dtype="float32")
+    value = relay.var("value", shape=(2, 16, 8), dtype="float32")
+    probs = relay.nn.softmax(relay.nn.batch_matmul(query, key), axis=1)
+    func = relay.Function([query, key, value], relay.nn.batch_matmul(probs, value))
+    func = run_opt_pass(func, transform.FuseAttention())
+    assert not _find_attention(func)
+
+
+@tvm.testing.parametrize_targets
+def test_fuse_attention_result(dev, target):
+    for transpose_value in [True, False]:
+        func = _composed(2, 12, 40, 16, scale=0.125, transpose_value=transpose_value)
+        fused = run_opt_pass(func, transform.FuseAttention())
+        assert len(_find_attention(fused)) == 1
+
+        shape = (2, 40, 16) if transpose_value else (2, 16, 40)
+        query_np = np.random.uniform(-1, 1, size=(2, 12, 16)).astype("float32")
+        key_np = np.random.uniform(-1, 1, size=(2, 40, 16)).astype("float32")
+        value_np = np.random.uniform(-1, 1, size=shape).astype("float32")
+        args = [query_np, key_np, value_np]
+        ref = relay.create_executor("graph", device=dev, target=target).evaluate(func)(*args)
+        out = relay.create_executor("graph", device=dev, target=target).evaluate(fused)(*args)
+        tvm.testing.assert_allclose(out.asnumpy(), ref.asnumpy(), rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    test_fuse_attention_rewrite()
+    test_fuse_attention_no_match()
@@ -784,6 +784,88 @@ def test_fuse_dynamic_squeeze_slice_take():
     assert np.allclose(result.numpy(), np_result)
 
 
+def test_fuse_cost_model():
+    """Test fusion driven by a cost model"""
+
+    def before():
+        x = relay.var("x", shape=(10, 20))
+        y = relay.add(x, relay.const(1, "float32"))
+        z = relay.exp(y)
+        w = relay.squeeze(z)
+        return relay.Function([x], w)
+
+    def expected():
+        x = relay.var("p", shape=(10, 20))
+        y = relay.add(x, relay.const(1, "float32"))
+        z = relay.exp(y)
+        f1 = relay.Function([x], z)
+        f1 = f1.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+        x = relay.var("p", shape=(10, 20))
+        w = relay.squeeze(x)
+        f2 = relay.Function([x], w)
+        f2 = f2.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+        x = relay.var("x", shape=(10, 20))
+        y = relay.Call(f2, [relay.Call(f1, [x])])
+        return relay.Function([x], y)
+
+    candidates = []
+
+    @tvm.register_func("relay.testing.fuse_ops_pair_cost", override=True)
+    def pair_cost(nodes):
+        # Groups of more than two nodes are too expensive.
+        candidates.append(len(nodes))
+        return 0.0 if len(nodes) <= 2 else 1e9
+
+    with tvm.transform.PassContext(
+        config={"relay.FuseOps.cost_model": "relay.testing.fuse_ops_pair_cost"}
+    ):
+        zz = run_opt_pass(before(), transform.FuseOps())
+    after = run_opt_pass(expected(), transform.InferType())
+    assert candidates
+    assert tvm.ir.structural_equal(zz, after)
+
+    # The analytical model keeps the fusion of the simple chain.
+    with tvm.transform.PassContext(
+        config={"relay.FuseOps.cost_model": "relay.FuseOps.AnalyticalCost"}
+    ):
+        zz = run_opt_pass(before(), transform.FuseOps())
+    with tvm.transform.PassContext():
+        default = run_opt_pass(before(), transform.FuseOps())
+    assert tvm.ir.structural_equal(zz, default)
+
+
+def test_fuse_residual_layer_norm():
+    """The residual add is fused into layer_norm, a reduction"""
+
+    def before():
+        x = relay.var("x", shape=(8, 64))
+        r = relay.var("r", shape=(8, 64))
+        gamma = relay.var("gamma", shape=(64,))
+        beta = relay.var("beta", shape=(64,))
+        y = relay.nn.layer_norm(relay.add(x, r), gamma, beta)
+        return relay.Function([x, r, gamma, beta], y)
+
+    def expected():
+        p0 = relay.var("p0", shape=(8, 64))
+        p1 = relay.var("p1", shape=(8, 64))
+        p2 = relay.var("p2", shape=(64,))
+        p3 = relay.var("p3", shape=(64,))
+        y = relay.nn.layer_norm(relay.add(p0, p1), p2, p3)
+        f0 = relay.Function([p0, p1, p2, p3], y)
+        f0 = f0.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+
+        x = relay.var("x", shape=(8, 64))
+        r = relay.var("r", shape=(8, 64))
+        gamma = relay.var("gamma", shape=(64,))
+        beta = relay.var("beta", shape=(64,))
+        return relay.Function([x, r, gamma, beta], relay.Call(f0, [x, r, gamma, beta]))
+
+    z = before()
+    zz = run_opt_pass(z, transform.FuseOps(fuse_opt_level=2))
+    after = run_opt_pass(expected(), transform.InferType())
+    assert tvm.ir.structural_equal(zz, after)
+
+
 if __name__ == "__main__":
     test_fuse_simple()
     test_conv2d_fuse()
@@ -804,3 +886,5 @@ if __name__ == "__main__":
     test_fuse_gather_nd()
     test_fuse_bcast_reduce_scalar()
     test_fuse_max_diamond()
+    test_fuse_cost_model()
+    test_fuse_residual_layer_norm()
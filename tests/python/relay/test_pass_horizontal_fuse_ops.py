@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay import transform
+from tvm.relay.testing import run_opt_pass
+import tvm.testing
+
+
+def run_horizontal_fuse(func, horizontal_fusion=True):
+    mod = tvm.IRModule.from_expr(func)
+    mod = transform.InferType()(mod)
+    mod = transform.FuseOps()(mod)
+    if horizontal_fusion:
+        mod = transform.HorizontalFuseOps()(mod)
+    mod = transform.InferType()(mod)
+    return mod["main"]
+
+
+def test_pack_independent_functions():
+    def before():
+        x = relay.var("x", shape=(10, 20))
+        y = relay.var("y", shape=(10, 20))
+        a = relay.exp(x)
+        b = relay.nn.relu(y)
+        return relay.Function([x, y], relay.Tuple([a, b]))
+
+    def expected():
+        p0 = relay.var("p0", shape=(10, 20))
+        p1 = relay.var("p0", shape=(10, 20))
+        f = relay.Function([p0, p1], relay.Tuple([relay.exp(p0), relay.nn.relu(p1)]))
+        f = f.with_attr("Primitive", tvm.tir.IntImm("int32", 1))
+        f = f.with_attr("HorizontalFusion", tvm.tir.IntImm("int32", 1))
+        x = relay.var("x", shape=(10, 20))
+        y = relay.var("y", shape=(10, 20))
+        z = relay.Call(f, [x, y])
+        out = relay.Tuple([relay.TupleGetItem(z, 0), relay.TupleGetItem(z, 1)])
+        return relay.Function([x, y], out)
+
+    fused = run_horizontal_fuse(before())
+    after = run_opt_pass(expected(), transform.InferType())
+    assert tvm.ir.structural_equal(fused, after)
+
+
+def test_keep_dependent_functions():
+    x = relay.var("x", shape=(10, 20))
+    a = relay.exp(x)
+    # The softmax is not injective, so exp and the add end up in different levels.
+    b = relay.nn.softmax(a)
+    c = relay.add(b, relay.const(1.0))
+    func = relay.Function([x], relay.Tuple([a, c]))
+    fused = run_horizontal_fuse(func, horizontal_fusion=False)
+    packed = run_horizontal_fuse(func)
+    assert tvm.ir.structural_equal(fused, packed)
+
+
+@tvm.testing.uses_gpu
+def test_horizontal_fusion_build():
+    shape = (8, 32)
+    towers = []
+    inputs = {}
+    for i in range(6):
+        x = relay.var("x%d" % i, shape=shape)
+        inputs["x%d" % i] = np.random.uniform(-1, 1, size=shape).astype("float32")
+        towers.append(relay.sigmoid(relay.add(x, relay.const(float(i)))))
+        towers.append(relay.nn.relu(x))
+    func = relay.Function(relay.analysis.free_vars(relay.Tuple(towers)), relay.Tuple(towers))
+    mod = tvm.IRModule.from_expr(func)
+
+    for target, dev in tvm.testing.enabled_targets():
+        with tvm.transform.PassContext(opt_level=3, required_pass=["HorizontalFuseOps"]):
+            lib = relay.build(mod, target=target)
+        m = graph_executor.GraphModule(lib["default"](dev))
+        m.set_input(**inputs)
+        m.run()
+        for i in range(6):
+            x = inputs["x%d" % i]
+            expected = [1 / (1 + np.exp(-(x + i))), np.maximum(x, 0)]
+            for j in range(2):
+                out = m.get_output(2 * i + j).numpy()
+                tvm.testing.assert_allclose(out, expected[j], rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    test_pack_independent_functions()
+    test_keep_dependent_functions()
+    test_horizontal_fusion_build()
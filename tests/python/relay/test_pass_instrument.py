@@ -16,11 +16,12 @@
 # under the License.
 """ Instrument test cases.
 """
+import json
 import pytest
 import tvm
 import tvm.relay
 from tvm.relay import op
-from tvm.ir.instrument import PassTimingInstrument, pass_instrument
+from tvm.ir.instrument import PassProfiler, PassTimingInstrument, pass_instrument
 
 
 def get_test_model():
@@ -59,6 +60,38 @@ def test_pass_timing_instrument():
     assert profiles == ""
 
 
+
+def test_pass_profiler():
+    profiler = PassProfiler()
+    mod = get_test_model()
+    with tvm.transform.PassContext(opt_level=3, instruments=[profiler]):
+        seq = tvm.transform.Sequential(
+            [tvm.relay.transform.InferType(), tvm.relay.transform.FoldConstant()]
+        )
+        mod = seq(mod)
+        tvm.relay.build(mod, "llvm")
+
+    # The records are kept after exiting the pass context.
+    profile = profiler.render()
+    assert "InferType" in profile
+    assert "FoldConstant" in profile
+    assert "Pass (by self time)" in profile
+    # The passes of the lowered primitive functions are recorded as well.
+    assert "tir." in profile
+
+    events = json.loads(profiler.chrome_trace())["traceEvents"]
+    assert events
+    assert all(event["ph"] == "X" and event["dur"] >= 0 for event in events)
+    names = [event["name"] for event in events]
+    assert "sequential" in names
+    assert "FoldConstant" in names
+
+    # Entering a new context starts a new profile.
+    with tvm.transform.PassContext(instruments=[profiler]):
+        tvm.relay.transform.InferType()(get_test_model())
+    names = [event["name"] for event in json.loads(profiler.chrome_trace())["traceEvents"]]
+    assert names == ["InferType"]
+
 def test_custom_instrument():
     @pass_instrument
     class MyTest:
@@ -585,5 +585,38 @@ def test_print_debug_callback():
     assert pass_counter.get_counts() == 0
 
 
+def test_function_pass_num_threads():
+    shape = (1, 2, 3)
+    tp = relay.TensorType(shape, "float32")
+
+    def get_mod():
+        mod = tvm.IRModule()
+        for i in range(8):
+            x = relay.var("x", tp)
+            c = relay.const(np.full(shape, i, "float32"))
+            body = relay.add(x, relay.multiply(c, relay.const(2.0)))
+            mod["func_%d" % i] = relay.Function([x], body)
+        return mod
+
+    seq = tvm.transform.Sequential([_transform.FoldConstant(), _transform.SimplifyExpr()])
+    with tvm.transform.PassContext(opt_level=3):
+        expected = seq(get_mod())
+    with tvm.transform.PassContext(opt_level=3, config={"relay.FunctionPass.num_threads": 4}):
+        actual = seq(get_mod())
+    tvm.ir.assert_structural_equal(actual, expected)
+
+    # The function passes written in Python are still applied to every function.
+    visited = []
+
+    @_transform.function_pass(opt_level=1)
+    def count(func, mod, ctx):
+        visited.append(func)
+        return func
+
+    with tvm.transform.PassContext(config={"relay.FunctionPass.num_threads": 4}):
+        count(get_mod())
+    assert len(visited) == 8
+
+
 if __name__ == "__main__":
     pytest.main()
@@ -0,0 +1,115 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the pass minimizing the layout transforms"""
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+import tvm.testing
+
+
+def run_opt_pass(expr, passes):
+    passes = passes if isinstance(passes, list) else [passes]
+    mod = tvm.IRModule.from_expr(expr)
+    seq = tvm.transform.Sequential(passes)
+    with tvm.transform.PassContext(opt_level=3):
+        mod = seq(mod)
+    return mod["main"]
+
+
+def test_remove_transform_pair():
+    def before():
+        x = relay.var("x", shape=(1, 2, 8, 8, 4))
+        y = relay.layout_transform(x, "NCHW4c", "NCHW")
+        y = relay.nn.relu(y)
+        y = relay.add(y, relay.const(1.0))
+        y = relay.layout_transform(y, "NCHW", "NCHW4c")
+        return relay.Function([x], y)
+
+    def expected():
+        x = relay.var("x", shape=(1, 2, 8, 8, 4))
+        y = relay.nn.relu(x)
+        y = relay.add(y, relay.const(1.0))
+        return relay.Function([x], y)
+
+    a = run_opt_pass(before(), transform.MinimizeLayoutTransform())
+    b = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(a, b)
+
+
+def test_transform_other_inputs_and_outputs():
+    def before():
+        x = relay.var("x", shape=(1, 2, 8, 8, 4))
+        w = relay.var("w", shape=(1, 8, 8, 8))
+        y = relay.layout_transform(x, "NCHW4c", "NCHW")
+        y = relay.add(y, w)
+        z = relay.sigmoid(y)
+        y = relay.layout_transform(y, "NCHW", "NCHW4c")
+        z = relay.layout_transform(z, "NCHW", "NCHW4c")
+        return relay.Function([x, w], relay.Tuple([y, z]))
+
+    def expected():
+        x = relay.var("x", shape=(1, 2, 8, 8, 4))
+        w = relay.var("w", shape=(1, 8, 8, 8))
+        y = relay.add(x, relay.layout_transform(w, "NCHW", "NCHW4c"))
+        z = relay.sigmoid(y)
+        return relay.Function([x, w], relay.Tuple([y, z]))
+
+    a = run_opt_pass(before(), transform.MinimizeLayoutTransform())
+    b = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(a, b)
+
+
+def test_keep_unprofitable_region():
+    def before():
+        x = relay.var("x", shape=(1, 2, 8, 8, 4))
+        y = relay.layout_transform(x, "NCHW4c", "NCHW")
+        y = relay.nn.relu(y)
+        return relay.Function([x], y)
+
+    a = run_opt_pass(before(), transform.MinimizeLayoutTransform())
+    b = run_opt_pass(before(), transform.InferType())
+    tvm.ir.assert_structural_equal(a, b)
+
+
+def test_region_used_outside():
+    x = relay.var("x", shape=(1, 2, 8, 8, 4))
+    y = relay.layout_transform(x, "NCHW4c", "NCHW")
+    y = relay.nn.relu(y)
+    z = relay.exp(y)
+    z = relay.layout_transform(z, "NCHW", "NCHW4c")
+    func = relay.Function([x], relay.Tuple([y, z]))
+
+    mod = tvm.IRModule.from_expr(func)
+    with tvm.transform.PassContext(opt_level=3):
+        opt_mod = transform.MinimizeLayoutTransform()(mod)
+    # The region is moved, and the output used in the original layout is transformed back.
+    assert opt_mod["main"].body.fields[1].op.name == "exp"
+
+    x_data = np.random.uniform(size=(1, 2, 8, 8, 4)).astype("float32")
+    expected = relay.create_executor("graph", mod=mod).evaluate()(x_data)
+    actual = relay.create_executor("graph", mod=opt_mod).evaluate()(x_data)
+    for e, a in zip(expected, actual):
+        tvm.testing.assert_allclose(e.numpy(), a.numpy(), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_remove_transform_pair()
+    test_transform_other_inputs_and_outputs()
+    test_keep_unprofitable_region()
+    test_region_used_outside()
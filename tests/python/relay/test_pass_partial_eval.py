@@ -87,6 +87,45 @@ def test_const_inline():
     assert tvm.ir.structural_equal(dcpe(orig), const(8.0))
 
 
+def pe_with_config(expr, config):
+    mod = tvm.IRModule.from_expr(expr)
+    passes = [
+        transform.PartialEvaluate(),
+        transform.InferType(),
+        transform.DeadCodeElimination(inline_once=True),
+        transform.InferType(),
+    ]
+    with tvm.transform.PassContext(opt_level=3, config={"relay.PartialEval": config}):
+        mod = tvm.transform.Sequential(passes)(mod)
+    func = mod["main"]
+    report = [str(line) for line in func.attrs["relay.partial_eval_specializations"]]
+    return func.body, report
+
+
+def test_memoize():
+    t = relay.TensorType([], "float32")
+    d = Var("d", t)
+    double = Var("double")
+    body = Let(double, Function([d], d + d), double(const(4.0)) + double(const(4.0)))
+    res, report = pe_with_config(body, {"memoize": True, "record_specializations": True})
+    assert tvm.ir.structural_equal(res, const(16.0))
+    assert any(line.startswith("fn#") and "1 memoized" in line for line in report)
+
+
+def test_inline_budget():
+    t = relay.TensorType([], "float32")
+    d = Var("d", t)
+    double = Var("double")
+    body = Let(double, Function([d], d + d), double(const(4.0)))
+    res, report = pe_with_config(body, {"max_inlines": 0, "record_specializations": True})
+    assert not tvm.ir.structural_equal(res, const(8.0))
+    assert any(line.startswith("fn#") and "1 over budget" in line for line in report)
+    res, report = pe_with_config(body, {"max_inline_size": 2, "record_specializations": True})
+    assert not tvm.ir.structural_equal(res, const(8.0))
+    res, report = pe_with_config(body, {"record_specializations": True})
+    assert tvm.ir.structural_equal(res, const(8.0))
+
+
 def test_ref():
     t = relay.TensorType([], "float32")
     d = relay.Var("d", t)
@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+from tvm.relay.op.contrib.register import get_pattern_table
+from tvm.relay.transform.device_placement import DeviceSpec
+from tvm.relay.transform.prune_partitions import BackendSpec
+
+# The DNNL partitions standing in for a codegen on a GPU, their inputs and outputs are copied.
+ON_GPU = {"dnnl": BackendSpec(DeviceSpec(gflops=10000.0, gbps=300.0, launch_us=50.0), "cuda")}
+
+
+def partition(mod, compiler, patterns=None):
+    passes = [transform.InferType()]
+    if patterns is not None:
+        passes.append(transform.MergeComposite(patterns))
+    passes += [
+        transform.AnnotateTarget(compiler),
+        transform.MergeCompilerRegions(),
+        transform.PartitionGraph(),
+        transform.InferType(),
+    ]
+    return tvm.transform.Sequential(passes)(mod)
+
+
+def partitions(mod):
+    return sorted(
+        gvar.name_hint
+        for gvar, func in mod.functions.items()
+        if func.attrs is not None and "Compiler" in func.attrs
+    )
+
+
+def get_model(size):
+    x = relay.var("x", shape=(1, 8, size, size))
+    w = relay.var("w", shape=(8, 8, 3, 3))
+    y = relay.nn.relu(relay.nn.conv2d(x, w, kernel_size=(3, 3), padding=(1, 1)))
+    return tvm.IRModule.from_expr(relay.Function([x, w], relay.exp(y)))
+
+
+def test_small_partition_returns_to_tvm():
+    mod = partition(get_model(4), "dnnl")
+    assert len(partitions(mod)) == 1
+    # The copies to the GPU and its launch cost more than the small conv2d on the CPU.
+    pruned = transform.PruneUnprofitablePartitions(backend_specs=ON_GPU)(mod)
+    assert partitions(pruned) == []
+    assert tvm.ir.structural_equal(pruned["main"], transform.InferType()(get_model(4))["main"])
+
+
+def test_large_partition_kept():
+    mod = partition(get_model(256), "dnnl")
+    pruned = transform.PruneUnprofitablePartitions(backend_specs=ON_GPU)(mod)
+    assert len(partitions(pruned)) == 1
+
+
+def test_cost_fn():
+    mod = partition(get_model(4), "dnnl", get_pattern_table("dnnl"))
+    assert len(partitions(mod)) == 1
+
+    def offload_is_free(func, compiler):
+        return 0.0 if compiler else 1.0
+
+    def offload_is_slow(func, compiler):
+        return 2.0 if compiler else 1.0
+
+    assert len(partitions(transform.PruneUnprofitablePartitions(offload_is_free)(mod))) == 1
+    pruned = transform.PruneUnprofitablePartitions(offload_is_slow)(mod)
+    assert partitions(pruned) == []
+    # The composite functions are inlined with their partition.
+    assert tvm.ir.structural_equal(pruned["main"], transform.InferType()(get_model(4))["main"])
+
+
+def test_estimate_partition_cost():
+    mod = partition(get_model(64), "dnnl")
+    func = mod[partitions(mod)[0]]
+    native = transform.estimate_partition_cost(func, None)
+    assert transform.estimate_partition_cost(func, "dnnl") < native
+    # The codegens without a spec cost as much as TVM.
+    assert transform.estimate_partition_cost(func, "unknown") == native
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
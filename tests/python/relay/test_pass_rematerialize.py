@@ -0,0 +1,81 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+from tvm import relay
+from tvm.relay import transform
+import tvm.testing
+
+
+def count_calls(expr, op_name):
+    calls = []
+
+    def visit(node):
+        if isinstance(node, relay.Call) and node.op == relay.op.get(op_name):
+            calls.append(node)
+
+    relay.analysis.post_order_visit(expr, visit)
+    return len(calls)
+
+
+def get_forward_backward():
+    # a and b are kept alive across the chain, as activations read by a backward pass.
+    # With 40 bytes per tensor, 4 tensors are live at the peak: a, b, c and d.
+    x = relay.var("x", shape=(10,), dtype="float32")
+    a = relay.exp(x)
+    b = relay.exp(a)
+    c = relay.exp(b)
+    d = relay.exp(c)
+    e = relay.add(d, b)
+    f = relay.add(e, a)
+    return tvm.IRModule.from_expr(relay.Function([x], f))
+
+
+def test_rematerialize_under_budget():
+    mod = transform.InferType()(get_forward_backward())
+    remat = transform.Rematerialize(3 * 40)(mod)
+    remat = transform.InferType()(remat)
+    # one of the activations is recomputed before its late use
+    assert count_calls(remat["main"], "exp") == 5
+    assert tvm.ir.structural_equal(remat["main"].checked_type, mod["main"].checked_type)
+
+    x_data = np.random.uniform(-1, 1, size=(10,)).astype("float32")
+    expected = relay.create_executor("debug", mod=mod).evaluate()(x_data)
+    actual = relay.create_executor("debug", mod=remat).evaluate()(x_data)
+    tvm.testing.assert_allclose(actual.numpy(), expected.numpy(), rtol=1e-5)
+
+
+def test_rematerialize_within_budget():
+    mod = transform.InferType()(get_forward_backward())
+    remat = transform.Rematerialize(4 * 40)(mod)
+    assert tvm.ir.structural_equal(remat["main"], mod["main"])
+
+
+def test_rematerialize_build():
+    mod = get_forward_backward()
+    with tvm.transform.PassContext(
+        opt_level=3, config={"relay.backend.remat_memory_budget": 3 * 40}
+    ):
+        lib = relay.build(mod, target="llvm")
+    assert lib.get_graph_json()
+
+
+if __name__ == "__main__":
+    test_rematerialize_under_budget()
+    test_rematerialize_within_budget()
+    test_rematerialize_build()
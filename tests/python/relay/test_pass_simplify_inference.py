@@ -14,6 +14,7 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import tvm
 from tvm.ir import IRModule, structural_equal
 from tvm import relay as rly
 from tvm.relay.transform import SimplifyInference, InferType
@@ -79,6 +80,36 @@ def test_simplify_batchnorm(dtype="float32"):
     check(4, 0, 3)
 
 
+def test_simplify_keep_norm():
+    def before():
+        x = rly.var("x", shape=(4, 16))
+        gamma = rly.var("gamma", shape=(16,))
+        beta = rly.var("beta", shape=(16,))
+        y = rly.nn.layer_norm(x, gamma, beta)
+        return IRModule.from_expr(rly.nn.rms_norm(y, gamma))
+
+    def has_op(mod, name):
+        found = []
+
+        def visit(expr):
+            if isinstance(expr, rly.Call) and expr.op == rly.op.get(name):
+                found.append(expr)
+
+        rly.analysis.post_order_visit(mod["main"], visit)
+        return bool(found)
+
+    mod = SimplifyInference()(InferType()(before()))
+    assert not has_op(mod, "nn.layer_norm")
+    assert not has_op(mod, "nn.rms_norm")
+    assert has_op(mod, "mean")
+
+    with tvm.transform.PassContext(config={"relay.SimplifyInference.keep_norm": True}):
+        mod = SimplifyInference()(InferType()(before()))
+    assert has_op(mod, "nn.layer_norm")
+    assert has_op(mod, "nn.rms_norm")
+
+
 if __name__ == "__main__":
     test_simplify_batchnorm(dtype="float32")
     test_simplify_batchnorm(dtype="float16")
+    test_simplify_keep_norm()
@@ -0,0 +1,102 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor
+from tvm.relay import transform
+import tvm.testing
+
+
+def causal_model(num_frames):
+    x = relay.var("x", shape=(1, 4, num_frames))
+    w0 = relay.var("w0", shape=(8, 4, 3))
+    b0 = relay.var("b0", shape=(8,))
+    w1 = relay.var("w1", shape=(4, 8, 3))
+    y = relay.nn.conv1d(x, w0, padding=(4, 0), dilation=2)
+    y = relay.nn.relu(relay.nn.bias_add(y, b0))
+    y = relay.nn.avg_pool1d(y, pool_size=2, strides=2)
+    y = relay.nn.conv1d(y, w1, padding=(2, 0))
+    y = relay.nn.max_pool1d(relay.sigmoid(y), pool_size=2, strides=2)
+    return tvm.IRModule.from_expr(relay.Function([x, w0, b0, w1], y))
+
+
+def test_states():
+    mod = transform.InferType()(causal_model(32))
+    mod = transform.ToStreaming(8)(mod)
+    params = [p.name_hint for p in mod["main"].params]
+    assert params == ["x", "w0", "b0", "w1", "stream_state_0", "stream_state_1"]
+    shapes = [[int(d) for d in p.checked_type.shape] for p in mod["main"].params[4:]]
+    assert shapes == [[1, 4, 4], [1, 8, 2]]
+    ret_type = mod["main"].checked_type.ret_type
+    shapes = [[int(d) for d in t.shape] for t in ret_type.fields]
+    assert shapes == [[1, 4, 2], [1, 4, 4], [1, 8, 2]]
+
+
+@tvm.testing.requires_llvm
+def test_stream_matches_offline():
+    num_frames, hop = 32, 8
+    np.random.seed(0)
+    x = np.random.uniform(-1, 1, (1, 4, num_frames)).astype("float32")
+    params = {
+        "w0": np.random.uniform(-1, 1, (8, 4, 3)).astype("float32"),
+        "b0": np.random.uniform(-1, 1, (8,)).astype("float32"),
+        "w1": np.random.uniform(-1, 1, (4, 8, 3)).astype("float32"),
+    }
+    dev = tvm.cpu()
+
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(causal_model(num_frames), "llvm", params=params)
+    offline = graph_executor.GraphModule(lib["default"](dev))
+    offline.run(x=x)
+    expected = offline.get_output(0).numpy()
+
+    mod = transform.ToStreaming(hop)(transform.InferType()(causal_model(num_frames)))
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, "llvm", params=params)
+    stream = graph_executor.GraphModule(lib["default"](dev))
+    for i, name in enumerate(["stream_state_0", "stream_state_1"]):
+        shape = [int(d) for d in mod["main"].params[4 + i].checked_type.shape]
+        stream.set_input(name, np.zeros(shape, "float32"))
+        stream.link_output(i + 1, name)
+    chunks = []
+    for start in range(0, num_frames, hop):
+        stream.set_input("x", x[:, :, start : start + hop])
+        stream.run()
+        chunks.append(stream.get_output(0).numpy())
+    tvm.testing.assert_allclose(np.concatenate(chunks, axis=2), expected, rtol=1e-5, atol=1e-5)
+
+
+def test_non_causal_conv():
+    x = relay.var("x", shape=(1, 4, 16))
+    w = relay.var("w", shape=(4, 4, 3))
+    mod = tvm.IRModule.from_expr(relay.Function([x, w], relay.nn.conv1d(x, w, padding=(1, 1))))
+    with pytest.raises(tvm.TVMError):
+        transform.ToStreaming(4)(mod)
+
+
+def test_time_dependent_op():
+    x = relay.var("x", shape=(1, 4, 16))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.sum(x, axis=2, keepdims=True)))
+    with pytest.raises(tvm.TVMError):
+        transform.ToStreaming(4)(mod)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
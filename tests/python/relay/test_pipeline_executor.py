@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+from tvm import relay
+from tvm.contrib import graph_executor, pipeline_executor
+import tvm.testing
+
+
+STAGE_OF_OP = {"nn.dense": 0, "nn.relu": 0, "sigmoid": 1, "tanh": 1, "multiply": 1, "add": 2}
+
+
+def stage_key(call):
+    return STAGE_OF_OP[call.op.name]
+
+
+def get_model():
+    x = relay.var("x", shape=(4, 16))
+    w = relay.var("w", shape=(16, 16))
+    h = relay.nn.relu(relay.nn.dense(x, w))
+    y = relay.multiply(relay.sigmoid(h), relay.tanh(x))
+    return tvm.IRModule.from_expr(relay.Function([x, w], relay.add(y, h)))
+
+
+def test_split():
+    stages = pipeline_executor.split(get_model(), stage_key)
+    assert len(stages.mods) == 3
+    assert stages.input_names == ["x", "w"]
+    # x is read by the first two stages, h by the last two.
+    assert [[n for n, _ in inps] for inps in stages.stage_inputs] == [
+        ["x", "w"],
+        ["value_2", "x"],
+        ["value_3", "value_2"],
+    ]
+    assert stages.stage_outputs == [[2], [3], [4]]
+    assert stages.outputs == [4]
+
+
+def test_split_by_backend():
+    x = relay.var("x", shape=(8,))
+    y = relay.exp(x)
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.log(y)))
+    # A single host stage without partitioned functions.
+    stages = pipeline_executor.split(mod)
+    assert len(stages.mods) == 1
+    assert stages.stage_outputs == [[1]]
+
+
+@pytest.mark.skipif(
+    not pipeline_executor.pipeline_executor_enabled(), reason="pipeline executor not enabled"
+)
+@tvm.testing.requires_llvm
+def test_pipeline():
+    np.random.seed(0)
+    params = {"w": np.random.uniform(-1, 1, (16, 16)).astype("float32")}
+    dev = tvm.cpu()
+
+    lib = relay.build(get_model(), "llvm", params=params)
+    ref = graph_executor.GraphModule(lib["default"](dev))
+
+    stages = pipeline_executor.split(get_model(), stage_key)
+    pmod = pipeline_executor.build(stages, ["llvm"] * 3, [dev] * 3, params=params)
+    assert pmod.num_stages == 3
+
+    inputs = [np.random.uniform(-1, 1, (4, 16)).astype("float32") for _ in range(8)]
+    # Queue more requests than the queues hold, the outputs come back in order.
+    for x in inputs[:4]:
+        pmod.run(x=x)
+    outputs = [pmod.get_output() for _ in range(4)]
+    for x in inputs[4:]:
+        pmod.run(x=x)
+        outputs.append(pmod.get_output())
+
+    for x, out in zip(inputs, outputs):
+        ref.run(x=x)
+        tvm.testing.assert_allclose(out[0].numpy(), ref.get_output(0).numpy(), rtol=1e-5)
+
+    stats = pmod.get_stats()
+    assert [s["runs"] for s in stats["stages"]] == [8, 8, 8]
+    assert 0 <= stats["bottleneck"] < 3
+    assert 1.0 <= stats["balance"] <= 3.0
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
@@ -86,5 +86,64 @@ def test_bsr_sparse_dense():
     np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
 
 
+def test_select_block_size():
+    from tvm.relay.analysis.sparse_dense import select_block_size
+
+    np.random.seed(0)
+    w = random_bsr_matrix(256, 128, 16, 1, 0.1).todense()
+    assert select_block_size(np.asarray(w)) == (16, 1)
+    # Scattered nonzeros are stored as CSR.
+    w = np.zeros((256, 128), dtype="float32")
+    w[np.arange(0, 256, 7), np.arange(0, 256, 7) % 128] = 1.0
+    assert select_block_size(w) == (1, 1)
+
+
+def test_bsr_sparse_dense_auto_block_size():
+    data = relay.var("data", shape=(1, 128), dtype="float32")
+    w = relay.var("weight", shape=(768, 128), dtype="float32")
+    func = relay.Function([data, w], relay.nn.dense(data, w))
+    params = {"weight": tvm.nd.array(random_bsr_matrix(768, 128, 8, 1, 0.1).todense())}
+
+    x_np = np.random.randn(1, 128).astype("float32")
+    dense_output = run_func(func, dict(params), x_np)
+    sparse_func, params = relay.data_dep_optimization.bsr_dense.convert(func, params, None, 0.2)
+    assert params["weight.data"].shape[1:] == (8, 1)
+    sparse_output = run_func(sparse_func, params, x_np)
+    np.testing.assert_allclose(sparse_output, dense_output, atol=1e-5, rtol=1e-5)
+
+
+def test_structured_sparse_2_4():
+    from tvm.relay.data_dep_optimization import structured_sparse
+
+    np.random.seed(0)
+    w_np = np.random.randn(64, 128).astype("float32")
+    assert not structured_sparse.is_2_4_sparse(w_np)
+    pruned = structured_sparse.prune_2_4(w_np)
+    assert structured_sparse.is_2_4_sparse(pruned)
+    groups = np.abs(w_np.reshape(64, 32, 4))
+    kept = np.abs(pruned.reshape(64, 32, 4)) > 0
+    # The two largest magnitudes of each group are kept.
+    np.testing.assert_allclose(
+        np.sort(groups, axis=2)[:, :, 2:].sum(axis=2), (groups * kept).sum(axis=2), rtol=1e-6
+    )
+
+    values, metadata = structured_sparse.compress_2_4(pruned)
+    assert values.shape == (64, 64) and metadata.shape == (64, 8)
+    assert metadata.dtype == "uint16"
+    np.testing.assert_equal(structured_sparse.decompress_2_4(values, metadata), pruned)
+
+    data = relay.var("data", shape=(1, 128), dtype="float32")
+    w = relay.var("weight", shape=(64, 128), dtype="float32")
+    func = relay.Function([data, w], relay.nn.dense(data, w))
+    _, names = structured_sparse.prune(func, {"weight": tvm.nd.array(w_np)})
+    assert names == []
+    params, names = structured_sparse.prune(func, {"weight": tvm.nd.array(w_np)}, True)
+    assert names == ["weight"]
+    np.testing.assert_equal(params["weight"].numpy(), pruned)
+
+
 if __name__ == "__main__":
     test_bsr_sparse_dense()
+    test_select_block_size()
+    test_bsr_sparse_dense_auto_block_size()
+    test_structured_sparse_2_4()
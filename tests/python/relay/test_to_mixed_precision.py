@@ -22,7 +22,9 @@ import pytest
 import tvm
 from tvm import relay
 from tvm.relay.testing import lstm
+from tvm.relay import transform
 from tvm.relay.transform import InferType, ToMixedPrecision, mixed_precision
+from tvm.relay.transform import mixed_precision_search
 
 
 def run_module(mod: tvm.runtime.Module, mod_params: Dict[str, Any]) -> List:
@@ -436,5 +438,51 @@ def test_batch_matmul_simple():
     assert tvm.ir.structural_equal(expected_mod, output_mod)
 
 
+def test_call_categories():
+    """The category of a call can be overridden, regardless of its op."""
+    data = relay.var("data", shape=(1, 3, 8, 8))
+    weight = relay.var("weight", shape=(4, 3, 3, 3))
+    conv = relay.nn.conv2d(data, weight, padding=(1, 1))
+    mod = InferType()(tvm.IRModule.from_expr(relay.Function([data, weight], relay.exp(conv))))
+    exp = mod["main"].body
+    conv = exp.args[0]
+
+    categories = {conv: mixed_precision.MIXED_PRECISION_NEVER}
+    output_mod = ToMixedPrecision("float16", call_categories=categories)(mod)
+    assert tvm.ir.structural_equal(output_mod["main"].body, mod["main"].body)
+
+    categories = {exp: mixed_precision.MIXED_PRECISION_ALWAYS}
+    output_mod = ToMixedPrecision("float16", call_categories=categories)(mod)
+    assert output_mod["main"].body.checked_type.dtype == "float16"
+
+
+def test_auto_mixed_precision():
+    np.random.seed(0)
+    data = relay.var("data", shape=(4, 16))
+    weight = relay.var("weight", shape=(16, 16))
+    body = relay.exp(relay.nn.relu(relay.nn.dense(data, weight)))
+    mod = InferType()(tvm.IRModule.from_expr(relay.Function([data, weight], body)))
+    params = {"weight": np.random.uniform(-0.1, 0.1, (16, 16)).astype("float32")}
+    dataset = [{"data": np.random.uniform(-1, 1, (4, 16)).astype("float32")} for _ in range(2)]
+
+    output_mod, report = transform.auto_mixed_precision(mod, dataset, params, "float16", 1.0)
+    assert [r.op for r in report] == ["nn.dense", "nn.relu", "exp"]
+    assert all(r.lowered for r in report)
+    assert all(r.speedup > 1 for r in report)
+    # The outputs keep their type.
+    assert output_mod["main"].checked_type.ret_type.dtype == "float32"
+
+    output_mod, report = transform.auto_mixed_precision(mod, dataset, params, "float16", 0.0)
+    assert not any(r.lowered for r in report)
+    assert all(r.error > 0 for r in report)
+
+
+def test_default_mixed_precision_type():
+    default_type = mixed_precision_search.default_mixed_precision_type
+    assert default_type("llvm") == "float16"
+    assert default_type("llvm -mcpu=sapphirerapids") == "bfloat16"
+    assert default_type("llvm -mtriple=aarch64-linux-gnu -mattr=+bf16") == "bfloat16"
+    assert default_type("cuda") == "float16"
+
 if __name__ == "__main__":
     pytest.main([__file__])
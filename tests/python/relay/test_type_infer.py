@@ -545,6 +545,41 @@ def test_repeat_register():
         assert "Operator custom_log3 is registered before" in str(cm.execption)
 
 
+def test_incremental_reuse():
+    x = relay.var("x", shape=(3, 4), dtype="float32")
+    f = relay.Function([x], relay.nn.relu(relay.add(x, x)))
+    typed = transform.InferType()(IRModule.from_expr(f))["main"]
+    # A rewrite around the typed body only re-infers the new call.
+    rewritten = relay.Function(typed.params, relay.cast(typed.body, "float16"))
+    for incremental in [True, False]:
+        with tvm.transform.PassContext(config={"relay.InferType.incremental": incremental}):
+            func = transform.InferType()(IRModule.from_expr(rewritten))["main"]
+        assert func.checked_type.ret_type == relay.TensorType((3, 4), "float16")
+        assert func.body.args[0].checked_type == relay.TensorType((3, 4), "float32")
+        if incremental:
+            assert func.body.args[0].same_as(typed.body)
+            assert func.params[0].same_as(typed.params[0])
+
+
+def test_incremental_type_error():
+    x = relay.var("x", shape=(3, 4), dtype="float32")
+    typed = transform.InferType()(IRModule.from_expr(relay.Function([x], relay.nn.relu(x))))
+    typed = typed["main"]
+    rewritten = relay.Function(typed.params, relay.add(typed.body, relay.ones((5,), "float32")))
+    with pytest.raises(tvm.error.TVMError):
+        transform.InferType()(IRModule.from_expr(rewritten))
+
+
+def test_incremental_reannotated_var():
+    # A subexpression typed before is re-inferred when its variable changed its type.
+    x = relay.var("x", shape=(3, 4), dtype="float32")
+    typed = transform.InferType()(IRModule.from_expr(relay.Function([x], relay.exp(x))))["main"]
+    y = relay.var("x", shape=(2,), dtype="float32")
+    rewritten = relay.Function([y], relay.bind(typed.body, {typed.params[0]: y}))
+    func = transform.InferType()(IRModule.from_expr(rewritten))["main"]
+    assert func.checked_type.ret_type == relay.TensorType((2,), "float32")
+
+
 if __name__ == "__main__":
     import sys
 
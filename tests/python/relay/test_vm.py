@@ -16,6 +16,7 @@
 # under the License.
 import numpy as np
 import pytest
+import threading
 import time
 
 import tvm
@@ -703,6 +704,28 @@ def test_vm_optimize_dynamic():
     assert "shape_func" in opt_mod.astext(False)
 
 
+def test_vm_optimize_dynamic_same_shape():
+    dtype = "float32"
+    x = relay.var("x", shape=(relay.Any(), 4), dtype=dtype)
+    y = relay.var("y", shape=(1, 4), dtype=dtype)
+    # The output has the shape of x, which needs no shape function.
+    out = relay.nn.relu(x + y) * relay.const(2.0)
+    mod = tvm.IRModule()
+    mod["main"] = relay.Function([x, y], out)
+    comp = relay.vm.VMCompiler()
+    opt_mod, _ = comp.optimize(mod, target="llvm")
+    assert "shape_func" not in opt_mod.astext(False)
+
+    x_data = np.random.uniform(size=(3, 4)).astype(dtype)
+    y_data = np.random.uniform(size=(1, 4)).astype(dtype)
+    check_result([x_data, y_data], np.maximum(x_data + y_data, 0) * 2, mod=mod)
+
+    # The output of concatenate has a shape of its own.
+    mod["main"] = relay.Function([x], relay.concatenate([x, x], axis=0))
+    opt_mod, _ = comp.optimize(mod, target="llvm")
+    assert "shape_func" in opt_mod.astext(False)
+
+
 def test_vm_optimize():
     mod, params = testing.synthetic.get_workload()
     comp = relay.vm.VMCompiler()
@@ -915,5 +938,266 @@ def test_get_output_multiple():
     np.testing.assert_allclose(outputs[1].numpy(), inp)
 
 
+@tvm.testing.requires_llvm
+def test_plan_static_memory():
+    x = relay.var("x", shape=(4, 16), dtype="float32")
+    y = x
+    for i in range(6):
+        y = relay.nn.relu(relay.add(y, relay.const(float(i))))
+        y = relay.exp(relay.negative(y))
+    mod = tvm.IRModule.from_expr(relay.Function([x], y))
+    data = np.random.uniform(size=(4, 16)).astype("float32")
+
+    def run(plan):
+        # Disable fusion so that each op gets its own intermediate storage.
+        config = {"relay.vm.plan_static_memory": plan}
+        with tvm.transform.PassContext(opt_level=0, config=config):
+            exe = relay.vm.compile(mod, target="llvm")
+        res = runtime.vm.VirtualMachine(exe, tvm.cpu()).invoke("main", data)
+        return exe.bytecode.count("alloc_storage"), res.numpy()
+
+    num_alloc, ref = run(False)
+    num_planned_alloc, res = run(True)
+    tvm.testing.assert_allclose(res, ref)
+    assert num_planned_alloc < num_alloc
+
+
+@tvm.testing.requires_llvm
+def test_size_class_allocator():
+    x = relay.var("x", shape=(relay.Any(), 3), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.nn.relu(x + relay.const(1.0))))
+    exe = relay.vm.compile(mod, target="llvm")
+    # Allocators are global per device, use one no other test has created an allocator for.
+    dev = tvm.cpu(1)
+    vm_exec = runtime.vm.VirtualMachine(exe, dev, memory_cfg="size_class")
+    for batch in [1, 7, 33, 7, 1]:
+        data = np.random.uniform(-1, 1, size=(batch, 3)).astype("float32")
+        res = vm_exec.invoke("main", data)
+        tvm.testing.assert_allclose(res.numpy(), np.maximum(data + 1, 0))
+    stats = runtime.vm.size_class_allocator_stats(dev)
+    assert stats["used_bytes"] >= stats["pooled_bytes"]
+    assert stats["rounded_bytes"] >= stats["requested_bytes"] > 0
+    assert 0 <= stats["internal_fragmentation"] < 0.25
+
+
+@tvm.testing.requires_llvm
+def test_request_batcher():
+    import threading
+
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.Tuple([x * relay.const(2.0), x + x])))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    batcher = runtime.vm.RequestBatcher(vm_exec, "main", max_batch_size=8, timeout_us=20000)
+
+    inputs = [np.random.uniform(size=(1 + i % 2, 4)).astype("float32") for i in range(6)]
+    results = [None] * len(inputs)
+
+    def request(i):
+        results[i] = batcher.submit(inputs[i])
+
+    threads = [threading.Thread(target=request, args=(i,)) for i in range(len(inputs))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    for data, res in zip(inputs, results):
+        tvm.testing.assert_allclose(res[0].numpy(), data * 2)
+        tvm.testing.assert_allclose(res[1].numpy(), data + data)
+    stats = batcher.stats()
+    assert stats["requests"] == len(inputs)
+    assert 1 <= stats["batches"] <= len(inputs)
+
+
+def test_configure_dispatch():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    y = relay.var("y", shape=(4,), dtype="float32")
+    cond = relay.var("c", shape=(), dtype="bool")
+    z = relay.nn.relu(x + y) * relay.const(3.0)
+    out = relay.If(cond, relay.sum(z, axis=0), relay.sum(x - y, axis=0))
+    mod = tvm.IRModule.from_expr(relay.Function([x, y, cond], out))
+    with tvm.transform.PassContext(opt_level=0):
+        exe = relay.vm.compile(mod, target="llvm")
+
+    x_np = np.random.uniform(-1, 1, size=(5, 4)).astype("float32")
+    y_np = np.random.uniform(-1, 1, size=(4,)).astype("float32")
+    for flag in [True, False]:
+        expected = (
+            (np.maximum(x_np + y_np, 0) * 3).sum(axis=0) if flag else (x_np - y_np).sum(axis=0)
+        )
+        for superinstructions in [False, True]:
+            for threaded in [False, True]:
+                vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+                vm_exec.configure_dispatch(superinstructions, threaded)
+                res = vm_exec.invoke("main", x_np, y_np, np.array(flag))
+                tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-5)
+
+
+def test_sampling_stats():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.exp(relay.nn.relu(x))))
+    exe = relay.vm.compile(mod, target="llvm")
+    x_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    assert vm_exec.get_sampling_stats()["invocations"] == 0
+    vm_exec.set_sampling_interval(2)
+    for _ in range(5):
+        res = vm_exec.invoke("main", x_np)
+        tvm.testing.assert_allclose(res.numpy(), np.exp(np.maximum(x_np, 0)), rtol=1e-5)
+    stats = vm_exec.get_sampling_stats()
+    assert stats["invocations"] == 5 and stats["total"]["count"] == 3
+    assert [op["name"] for op in stats["ops"]] == list(exe.primitive_ops)
+    assert all(op["latency"]["count"] == 3 for op in stats["ops"])
+
+
+def test_result_cache():
+    mod = tvm.IRModule()
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    encoder = relay.GlobalVar("encoder")
+    mod[encoder] = relay.Function([x], relay.exp(relay.nn.relu(x)))
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    y = relay.var("y", shape=(4, 8), dtype="float32")
+    mod["main"] = relay.Function([x, y], encoder(x) + y)
+    exe = relay.vm.compile(mod, target="llvm")
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    vm_exec.set_result_cache(1 << 20, ["encoder"])
+
+    x_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    for _ in range(3):
+        y_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        res = vm_exec.invoke("main", x_np, y_np)
+        tvm.testing.assert_allclose(res.numpy(), np.exp(np.maximum(x_np, 0)) + y_np, rtol=1e-5)
+    # The cached result is returned as is.
+    first = vm_exec.invoke("encoder", x_np)
+    assert first.same_as(vm_exec.invoke("encoder", x_np))
+    stats = vm_exec.get_result_cache_stats()
+    assert stats["misses"] == 1 and stats["hits"] == 4 and stats["entries"] == 1
+
+    vm_exec.set_result_cache(0, ["encoder"])
+    vm_exec.invoke("main", x_np, y_np)
+    assert vm_exec.get_result_cache_stats()["hits"] == 0
+
+
+def test_set_outputs():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    out = relay.Tuple([relay.exp(x), relay.nn.relu(x) * relay.const(2.0)])
+    mod = tvm.IRModule.from_expr(relay.Function([x], out))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+
+    outs = [tvm.nd.empty((4, 8), "float32") for _ in range(2)]
+    vm_exec.set_outputs("main", *outs)
+    for _ in range(2):
+        x_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        res = vm_exec.invoke("main", x_np)
+        assert all(r.same_as(o) for r, o in zip(res, outs))
+        tvm.testing.assert_allclose(outs[0].numpy(), np.exp(x_np), rtol=1e-5)
+        tvm.testing.assert_allclose(outs[1].numpy(), np.maximum(x_np, 0) * 2, rtol=1e-5)
+
+    vm_exec.set_outputs("main")
+    res = vm_exec.invoke("main", x_np)
+    assert not res[0].same_as(outs[0])
+    with pytest.raises(tvm.TVMError):
+        vm_exec.set_outputs("main", outs[0])
+
+    # The parameters returned as is cannot be bound.
+    mod = tvm.IRModule.from_expr(relay.Function([x], x))
+    vm_exec = runtime.vm.VirtualMachine(relay.vm.compile(mod, target="llvm"), tvm.cpu())
+    with pytest.raises(tvm.TVMError):
+        vm_exec.set_outputs("main", outs[0])
+
+
+def test_vm_clone_threads():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    w_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.exp(x) * relay.const(w_np)))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    clones = [vm_exec.clone() for _ in range(4)]
+    inputs = [np.random.uniform(-1, 1, size=(4, 8)).astype("float32") for _ in clones]
+    results = [None] * len(clones)
+
+    def _run(i):
+        for _ in range(8):
+            results[i] = clones[i].invoke("main", inputs[i]).numpy()
+
+    threads = [threading.Thread(target=_run, args=(i,)) for i in range(len(clones))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for x_np, res in zip(inputs, results):
+        tvm.testing.assert_allclose(res, np.exp(x_np) * w_np, rtol=1e-5)
+    # the clones keep their own inputs and outputs
+    res = vm_exec.invoke("main", inputs[0])
+    tvm.testing.assert_allclose(res.numpy(), np.exp(inputs[0]) * w_np, rtol=1e-5)
+
+
+def test_vm_invoke_async():
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    y = relay.var("y", shape=(4, 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x, y], relay.exp(x) + y))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm_exec = runtime.vm.VirtualMachine(exe, tvm.cpu())
+    vm_exec.set_async_depth(1)
+    xs = [np.random.uniform(-1, 1, size=(4, 8)).astype("float32") for _ in range(4)]
+    y_np = np.ones((4, 8), "float32")
+    futures = [vm_exec.run_async(x_np, y=y_np, callback=lambda out: out.numpy()) for x_np in xs]
+    for x_np, future in zip(xs, futures):
+        tvm.testing.assert_allclose(future.result(), np.exp(x_np) + y_np, rtol=1e-5)
+    vm_exec.wait_async()
+    # the queue has room again once the requests completed
+    assert vm_exec.invoke_async("main", xs[0], y_np, block=False) is not None
+
+
+def test_kv_cache():
+    # a decoding step returns the key of the new token and attends to the past keys
+    past = relay.var("past", shape=(relay.Any(), 8), dtype="float32")
+    x = relay.var("x", shape=(1, 8), dtype="float32")
+    key = x * relay.const(2.0)
+    out = relay.sum(relay.concatenate([past, key], axis=0), axis=0, keepdims=True)
+    mod = tvm.IRModule.from_expr(relay.Function([past, x], relay.Tuple([key, out])))
+    vm_exec = runtime.vm.VirtualMachine(relay.vm.compile(mod, target="llvm"), tvm.cpu())
+
+    cache = runtime.vm.KVCache(np.zeros((0, 8), "float32"), 2)
+    history = np.zeros((0, 8), "float32")
+    for _ in range(5):
+        x_np = np.random.uniform(-1, 1, size=(1, 8)).astype("float32")
+        new_key, res = vm_exec.invoke("main", cache, x_np)
+        history = np.concatenate([history, x_np * 2])
+        tvm.testing.assert_allclose(res.numpy(), history.sum(axis=0, keepdims=True), rtol=1e-5)
+        cache.append(new_key)
+        tvm.testing.assert_allclose(cache.view().numpy(), history, rtol=1e-5)
+    assert len(cache) == 5 and cache.capacity == 8
+
+    cache.reset()
+    assert len(cache) == 0 and cache.view().shape == (0, 8)
+    with pytest.raises(tvm.TVMError):
+        cache.append(np.zeros((1, 4), "float32"))
+
+
+@tvm.testing.requires_cudagraph
+def test_vm_cuda_graph():
+    from tvm.contrib.cuda_graph import cuda_graph_vm
+
+    x = relay.var("x", shape=(relay.Any(), 8), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.nn.relu(x * relay.const(2.0)) + x))
+    exe = relay.vm.compile(mod, target="cuda")
+    dev = tvm.cuda()
+    vm_exec = cuda_graph_vm.VirtualMachineCudaGraph(exe, dev, cache_size=2)
+
+    for rows in [3, 5, 3, 3, 7, 3]:
+        data = np.random.uniform(-1, 1, size=(rows, 8)).astype("float32")
+        res = vm_exec.invoke("main", tvm.nd.array(data, dev))
+        tvm.testing.assert_allclose(res.numpy(), np.maximum(data * 2, 0) + data, rtol=1e-5)
+
+    stats = vm_exec.stats()
+    assert stats["captures"] + stats["fallbacks"] >= 3
+    # 7 rows evicted the graph of 5 rows, 3 rows is the most recently used.
+    assert stats["size"] == 2 and stats["evictions"] == 1
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -316,5 +316,39 @@ def test_dynamic_bcast():
         tvm.testing.assert_allclose(res.numpy(), res_np)
 
 
+def test_lazy_load():
+    mod = tvm.IRModule()
+    x = relay.var("x", shape=(10, 10), dtype="float32")
+    c1 = relay.const(np.random.uniform(size=(10, 10)).astype("float32"))
+    c2 = relay.const(np.random.uniform(size=(10, 10)).astype("float32"))
+    mod["first"] = relay.Function([x], x + c1)
+    y = relay.var("y", shape=(10, 10), dtype="float32")
+    mod["second"] = relay.Function([y], y * c2)
+    z = relay.var("z", shape=(10, 10), dtype="float32")
+    mod["main"] = relay.Function([z], z - c1)
+    exe = create_exec(mod)
+    num_functions = len(exe.globals)
+    code, lib = exe.save()
+
+    des_exec = _vm.Executable.load_exec(code, lib)
+    # Nothing is deserialized until it is used.
+    assert des_exec.num_loaded_sections == (0, 0)
+    des_vm = _vm.VirtualMachine(des_exec, tvm.cpu())
+    data = np.random.uniform(size=(10, 10)).astype("float32")
+    res = des_vm.invoke("second", data)
+    tvm.testing.assert_allclose(res.numpy(), data * c2.data.numpy())
+    num_constants, loaded_functions = des_exec.num_loaded_sections
+    assert loaded_functions == 1
+    assert num_constants <= 1
+
+    # Printing the bytecode or saving again loads everything.
+    assert des_exec.bytecode == exe.bytecode
+    assert des_exec.num_loaded_sections[1] == num_functions
+    code2, _ = des_exec.save()
+    assert code2 == code
+    res = des_vm.invoke("first", data)
+    tvm.testing.assert_allclose(res.numpy(), data + c1.data.numpy())
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -33,6 +33,7 @@ _conv2d_nchw_winograd_implement = {
     "arm_cpu": (topi.arm_cpu.conv2d_nchw_winograd, topi.arm_cpu.schedule_conv2d_nchw_winograd),
     "cuda": (topi.cuda.conv2d_nchw_winograd, topi.cuda.schedule_conv2d_nchw_winograd),
     "mali": (topi.mali.conv2d_nchw_winograd, topi.mali.schedule_conv2d_nchw_winograd),
+    "cpu": (topi.x86.conv2d_nchw_winograd, topi.x86.schedule_conv2d_nchw_winograd),
 }
 
 
@@ -170,6 +171,39 @@ def test_conv2d_nchw():
     verify_conv2d_nchw(1, 48, 35, 48, 5, 1, "VALID", devices=["cuda"])
 
 
+def test_conv2d_nchw_x86():
+    verify_conv2d_nchw(1, 64, 56, 64, 3, 1, 1, devices=["llvm"])
+    verify_conv2d_nchw(1, 256, 14, 256, 3, 1, 1, devices=["llvm"])
+    verify_conv2d_nchw(2, 13, 71, 59, 3, 1, 1, devices=["llvm"])
+    verify_conv2d_nchw(1, 48, 7, 48, 3, 1, "SAME", add_relu=True, add_bias=True, devices=["llvm"])
+
+
+@tvm.testing.requires_llvm
+def test_conv2d_nchw_x86_tile_sizes():
+    """Every output tile size in the search space of the x86 template"""
+    A = te.placeholder((1, 32, 26, 26), name="A")
+    W = te.placeholder((32, 32, 3, 3), name="W")
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    c_np = tvm.topi.testing.conv2d_nchw_python(a_np, w_np, 1, 1)
+
+    task = autotvm.task.create(
+        "conv2d_nchw_winograd.x86", args=(A, W, 1, 1, 1, "float32"), target="llvm"
+    )
+    # The tile size is the first knob, so the first configs enumerate it.
+    tile_sizes = topi.x86.conv2d_winograd.WINOGRAD_TILE_SIZES
+    for index, tile_size in enumerate(tile_sizes):
+        cfg = task.config_space.get(index)
+        assert cfg["tile_size"].val == tile_size
+        with tvm.target.Target("llvm"):
+            s, args = task.instantiate(cfg)
+        func = tvm.build(s, args, "llvm")
+        dev = tvm.cpu(0)
+        c = tvm.nd.array(np.zeros(get_const_tuple(args[-1].shape), dtype="float32"), dev)
+        func(tvm.nd.array(a_np, dev), tvm.nd.array(w_np, dev), c)
+        tvm.testing.assert_allclose(c.numpy(), c_np, rtol=1e-3)
+
+
 def verify_conv2d_nhwc(
     batch,
     in_channel,
@@ -246,3 +280,5 @@ def test_conv2d_nhwc():
 if __name__ == "__main__":
     test_conv2d_nchw()
     test_conv2d_nhwc()
+    test_conv2d_nchw_x86()
+    test_conv2d_nchw_x86_tile_sizes()
@@ -0,0 +1,167 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the convolutions computed as implicit GEMMs"""
+import sys
+
+import numpy as np
+import pytest
+
+import tvm
+from tvm import te
+from tvm import topi
+from tvm.topi.utils import get_const_tuple
+import tvm.topi.testing
+import tvm.testing
+
+
+def _schedule_inline_patch(out):
+    """A naive schedule computing the patch and the weight matrices on the fly"""
+    s = te.create_schedule(out.op)
+
+    def _inline(tensor):
+        for t in tensor.op.input_tensors:
+            if t.op.tag in ("implicit_gemm_patch", "implicit_gemm_weight"):
+                s[t].compute_inline()
+            _inline(t)
+
+    _inline(out)
+    return s
+
+
+def _verify(A, W, out, a_np, w_np, ref_np, target="llvm", schedule=None):
+    dev = tvm.device(target, 0)
+    s = _schedule_inline_patch(out) if schedule is None else schedule
+    f = tvm.build(s, [A, W, out], target)
+    a = tvm.nd.array(a_np, dev)
+    w = tvm.nd.array(w_np, dev)
+    o = tvm.nd.array(np.zeros(get_const_tuple(out.shape), dtype=out.dtype), dev)
+    f(a, w, o)
+    tvm.testing.assert_allclose(o.numpy(), ref_np, rtol=1e-3, atol=1e-3)
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("stride,padding,dilation", [(1, 1, 1), (2, 1, 1), (1, 2, 2), (2, 0, 1)])
+def test_conv2d_nhwc_implicit_gemm(stride, padding, dilation):
+    A = te.placeholder((2, 13, 13, 8), name="A")
+    W = te.placeholder((3, 3, 8, 12), name="W")
+    out = topi.nn.conv2d_implicit_gemm(A, W, stride, padding, dilation, "NHWC", "HWIO")
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    dw_np = tvm.topi.testing.dilate_python(w_np, (dilation, dilation, 1, 1))
+    ref_np = tvm.topi.testing.conv2d_nhwc_python(a_np, dw_np, stride, padding)
+    _verify(A, W, out, a_np, w_np, ref_np)
+
+
+@tvm.testing.requires_llvm
+def test_conv2d_nchw_implicit_gemm():
+    A = te.placeholder((1, 8, 10, 12), name="A")
+    W = te.placeholder((16, 8, 3, 5), name="W")
+    out = topi.nn.conv2d_implicit_gemm(A, W, (1, 2), (1, 2), 1, "NCHW", "OIHW")
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    ref_np = tvm.topi.testing.conv2d_nchw_python(a_np, w_np, (1, 2), (1, 2))
+    _verify(A, W, out, a_np, w_np, ref_np)
+
+
+@tvm.testing.requires_llvm
+def test_conv3d_ndhwc_implicit_gemm():
+    A = te.placeholder((1, 6, 8, 8, 4), name="A")
+    W = te.placeholder((3, 3, 3, 4, 8), name="W")
+    out = topi.nn.conv3d_implicit_gemm(A, W, 1, 1, 1, "NDHWC", "DHWIO")
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    ref_np = tvm.topi.testing.conv3d_ndhwc_python(a_np, w_np, 1, 1)
+    _verify(A, W, out, a_np, w_np, ref_np)
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize(
+    "stride,padding,output_padding", [(1, 1, (0, 0)), (2, 1, (1, 1)), (3, 0, (2, 1))]
+)
+def test_conv2d_transpose_implicit_gemm(stride, padding, output_padding):
+    A = te.placeholder((1, 8, 7, 7), name="A")
+    W = te.placeholder((8, 4, 3, 3), name="W")
+    strides = (stride, stride)
+    out = topi.nn.conv2d_transpose_implicit_gemm(
+        A, W, strides, padding, "float32", output_padding
+    )
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    ref_np = tvm.topi.testing.conv2d_transpose_nchw_python(
+        a_np, w_np, strides, padding, output_padding
+    )
+    _verify(A, W, out, a_np, w_np, ref_np)
+
+
+@tvm.testing.requires_llvm
+def test_implicit_gemm_patch_not_materialized():
+    """The patch matrix is folded into the GEMM, no buffer of its size is allocated"""
+    A = te.placeholder((1, 56, 56, 64), name="A")
+    W = te.placeholder((3, 3, 64, 64), name="W")
+    out = topi.nn.conv2d_implicit_gemm(A, W, 1, 1, 1, "NHWC", "HWIO")
+    s = _schedule_inline_patch(out)
+    mod = tvm.lower(s, [A, W, out])
+    allocations = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda stmt: allocations.append(stmt) if isinstance(stmt, tvm.tir.Allocate) else None,
+    )
+    assert all("patch" not in alloc.buffer_var.name for alloc in allocations)
+
+
+@tvm.testing.requires_llvm
+def test_conv2d_nhwc_implicit_gemm_vnni():
+    if tvm.target.codegen.llvm_version_major() < 8:
+        pytest.skip("VNNI requires LLVM 8 or later")
+    target = "llvm -mcpu=cascadelake"
+    A = te.placeholder((1, 14, 14, 30), name="A", dtype="uint8")
+    W = te.placeholder((3, 3, 30, 24), name="W", dtype="int8")
+    with tvm.target.Target(target):
+        out = topi.x86.conv2d_nhwc_implicit_gemm_vnni(A, W, 1, 1, 1, "int32")
+        s = topi.x86.schedule_conv2d_nhwc_implicit_gemm_vnni([out])
+    f = tvm.build(s, [A, W, out], target)
+    assert "vpdpbusd" in f.get_source("asm")
+
+    with open("/proc/cpuinfo") as cpuinfo:
+        if not any(line.startswith("flags") and "avx512_vnni" in line for line in cpuinfo):
+            return
+    a_np = np.random.randint(low=0, high=255, size=get_const_tuple(A.shape)).astype("uint8")
+    w_np = np.random.randint(low=-128, high=127, size=get_const_tuple(W.shape)).astype("int8")
+    ref_np = tvm.topi.testing.conv2d_nhwc_python(
+        a_np.astype("int32"), w_np.astype("int32"), 1, 1
+    )
+    _verify(A, W, out, a_np, w_np, ref_np, schedule=s)
+
+
+@tvm.testing.requires_tensorcore
+@pytest.mark.parametrize("batch", [1, 3])
+def test_conv2d_nhwc_implicit_gemm_tensorcore(batch):
+    A = te.placeholder((batch, 14, 14, 32), name="A", dtype="float16")
+    W = te.placeholder((3, 3, 32, 48), name="W", dtype="float16")
+    with tvm.target.Target("cuda"):
+        out = topi.cuda.conv2d_nhwc_implicit_gemm_tensorcore(A, W, 1, 1, 1, "float32")
+        s = topi.cuda.schedule_conv2d_nhwc_implicit_gemm_tensorcore([out])
+    a_np = np.random.uniform(size=get_const_tuple(A.shape)).astype(A.dtype)
+    w_np = np.random.uniform(size=get_const_tuple(W.shape)).astype(W.dtype)
+    ref_np = tvm.topi.testing.conv2d_nhwc_python(
+        a_np.astype("float32"), w_np.astype("float32"), 1, 1
+    )
+    _verify(A, W, out, a_np, w_np, ref_np, target="cuda", schedule=s)
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main(sys.argv))
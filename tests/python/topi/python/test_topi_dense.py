@@ -165,5 +165,63 @@ def test_dense_cuda_int8(
         )
 
 
+def _host_has_cpu_flag(flag):
+    try:
+        with open("/proc/cpuinfo") as cpuinfo:
+            return any(
+                line.startswith("flags") and flag in line.split() for line in cpuinfo.readlines()
+            )
+    except OSError:
+        return False
+
+
+def _verify_dense_int8_x86(mcpu, compute, schedule, asm_instr, cpu_flag, M=32, N=64, K=256):
+    target = "llvm -mcpu=%s" % mcpu
+    A = te.placeholder((M, K), name="A", dtype="uint8")
+    B = te.placeholder((N, K), name="B", dtype="int8")
+    bias = te.placeholder((N,), name="bias", dtype="int32")
+    with tvm.target.Target(target):
+        C = compute(A, B, bias, "int32")
+        s = schedule([C])
+    f = tvm.build(s, [A, B, bias, C], target)
+    assert asm_instr in f.get_source("asm")
+
+    if not _host_has_cpu_flag(cpu_flag):
+        return
+    if cpu_flag == "amx_int8" and not topi.x86.utils.amx_init():
+        return
+    a_np = np.random.randint(low=0, high=255, size=(M, K)).astype("uint8")
+    b_np = np.random.randint(low=-128, high=127, size=(N, K)).astype("int8")
+    bias_np = np.random.randint(low=-128, high=127, size=(N,)).astype("int32")
+    c_np = np.dot(a_np.astype("int32"), b_np.T.astype("int32")) + bias_np
+    dev = tvm.cpu()
+    a, b, d = tvm.nd.array(a_np, dev), tvm.nd.array(b_np, dev), tvm.nd.array(bias_np, dev)
+    c = tvm.nd.array(np.zeros((M, N), dtype="int32"), dev)
+    f(a, b, d, c)
+    tvm.testing.assert_allclose(c.numpy(), c_np)
+
+
+@tvm.testing.requires_llvm
+def test_dense_vnni():
+    if tvm.target.codegen.llvm_version_major() < 8:
+        pytest.skip("VNNI requires LLVM 8 or later")
+    _verify_dense_int8_x86(
+        "cascadelake", topi.x86.dense_vnni, topi.x86.schedule_dense_vnni, "vpdpbusd", "avx512_vnni"
+    )
+
+
+@tvm.testing.requires_llvm
+def test_dense_amx_int8():
+    if tvm.target.codegen.llvm_version_major() < 12:
+        pytest.skip("AMX requires LLVM 12 or later")
+    _verify_dense_int8_x86(
+        "sapphirerapids",
+        topi.x86.dense_amx_int8,
+        topi.x86.schedule_dense_amx_int8,
+        "tdpbusd",
+        "amx_int8",
+    )
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(sys.argv))
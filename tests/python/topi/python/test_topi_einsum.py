@@ -74,5 +74,21 @@ def test_einsum():
     verify_einsum("ij,jk,km->im", [(2, 3), (3, 4), (4, 5)])
 
 
+def test_einsum_path():
+    # The contraction of the two big matrices costs 1e8 FLOPs, of the small one 3e5.
+    assert topi.einsum_path("ij,jk,kl->il", [(1000, 100), (100, 1000), (1000, 3)]) == [
+        (1, 2),
+        (0, 1),
+    ]
+    assert topi.einsum_path("ij,jk,kl->il", [(2, 100), (100, 1000), (1000, 3)]) == [
+        (0, 1),
+        (0, 1),
+    ]
+    # The path of many operands is built greedily.
+    shapes = [(2, 3), (3, 4), (4, 5), (5, 6), (6, 7), (7, 8)]
+    assert len(topi.einsum_path("ab,bc,cd,de,ef,fg->ag", shapes)) == 5
+
+
 if __name__ == "__main__":
     test_einsum()
+    test_einsum_path()
@@ -0,0 +1,109 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test code for layer normalization and RMS normalization"""
+import numpy as np
+import tvm
+from tvm import te
+from tvm import topi
+import tvm.topi.testing
+import tvm.testing
+
+_layer_norm_schedule = {
+    "generic": topi.generic.schedule_layer_norm,
+    "cpu": topi.x86.schedule_layer_norm,
+    "gpu": topi.cuda.schedule_layer_norm,
+}
+
+
+def verify_layer_norm(shape, axis, dtype="float32", residual=False, rms=False):
+    A = te.placeholder(shape, name="A", dtype=dtype)
+    gamma = te.placeholder((shape[axis],), name="gamma", dtype=dtype)
+    beta = te.placeholder((shape[axis],), name="beta", dtype=dtype)
+    R = te.placeholder(shape, name="R", dtype=dtype)
+    data = topi.add(A, R) if residual else A
+    if rms:
+        B = topi.nn.rms_norm(data, gamma, axis, 1e-5)
+        args = [A, R, gamma, B] if residual else [A, gamma, B]
+    else:
+        B = topi.nn.layer_norm(data, gamma, beta, axis, 1e-5)
+        args = [A, R, gamma, beta, B] if residual else [A, gamma, beta, B]
+
+    a_np = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    r_np = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    gamma_np = np.random.uniform(0.5, 1.5, size=(shape[axis],)).astype(dtype)
+    beta_np = np.random.uniform(-1, 1, size=(shape[axis],)).astype(dtype)
+    data_np = a_np + r_np if residual else a_np
+    if rms:
+        b_np = tvm.topi.testing.rms_norm_python(data_np, gamma_np, axis, 1e-5)
+        args_np = [a_np, r_np, gamma_np] if residual else [a_np, gamma_np]
+    else:
+        b_np = tvm.topi.testing.layer_norm_python(data_np, gamma_np, beta_np, axis, 1e-5)
+        args_np = [a_np, r_np, gamma_np, beta_np] if residual else [a_np, gamma_np, beta_np]
+
+    for target, dev in tvm.testing.enabled_targets():
+        with tvm.target.Target(target):
+            s_func = tvm.topi.testing.dispatch(target, _layer_norm_schedule)
+            s = s_func([B])
+        f = tvm.build(s, args, target)
+        nd_args = [tvm.nd.array(x, dev) for x in args_np]
+        b = tvm.nd.array(np.zeros(shape, dtype=dtype), dev)
+        f(*nd_args, b)
+        tol = 1e-2 if dtype == "float16" else 1e-5
+        tvm.testing.assert_allclose(b.numpy(), b_np, rtol=tol, atol=tol)
+
+
+@tvm.testing.uses_gpu
+def test_layer_norm():
+    verify_layer_norm((4, 768), -1)
+    verify_layer_norm((2, 7, 100), -1)
+    verify_layer_norm((3, 16, 5, 5), 1)
+    verify_layer_norm((1000,), 0)
+    verify_layer_norm((8, 512), -1, residual=True)
+
+
+@tvm.testing.uses_gpu
+def test_rms_norm():
+    verify_layer_norm((4, 768), -1, rms=True)
+    verify_layer_norm((3, 16, 5, 5), 1, rms=True)
+    verify_layer_norm((8, 512), -1, residual=True, rms=True)
+
+
+def test_layer_norm_large_mean():
+    # A single-pass sum of squares loses the variance of data with a large mean in float32,
+    # Welford's algorithm does not.
+    shape = (2, 4096)
+    A = te.placeholder(shape, name="A")
+    gamma = te.placeholder((shape[1],), name="gamma")
+    beta = te.placeholder((shape[1],), name="beta")
+    B = topi.nn.layer_norm(A, gamma, beta, -1, 1e-5)
+    with tvm.target.Target("llvm"):
+        s = topi.x86.schedule_layer_norm([B])
+    f = tvm.build(s, [A, gamma, beta, B], "llvm")
+    a_np = (1000.0 + np.random.uniform(-1, 1, size=shape)).astype("float32")
+    gamma_np = np.ones((shape[1],), dtype="float32")
+    beta_np = np.zeros((shape[1],), dtype="float32")
+    dev = tvm.cpu(0)
+    b = tvm.nd.array(np.zeros(shape, dtype="float32"), dev)
+    f(tvm.nd.array(a_np, dev), tvm.nd.array(gamma_np, dev), tvm.nd.array(beta_np, dev), b)
+    b_np = tvm.topi.testing.layer_norm_python(a_np, gamma_np, beta_np, -1, 1e-5)
+    tvm.testing.assert_allclose(b.numpy(), b_np, rtol=1e-3, atol=1e-3)
+
+
+if __name__ == "__main__":
+    test_layer_norm()
+    test_rms_norm()
+    test_layer_norm_large_mean()
@@ -23,23 +23,27 @@ import numpy as np
 
 def threefry_split(target, dev, gen):
     gen_placeholder = tvm.te.placeholder(gen.shape, name="gen", dtype="uint64")
-    left_placeholder, right_placeholder = tvm.topi.random.threefry_split(gen_placeholder)
-    s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
-    f = tvm.build(s, [gen_placeholder, left_placeholder, right_placeholder])
-    left = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"))
-    right = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"))
-    f(tvm.nd.array(gen), left, right)
+    with tvm.target.Target(target):
+        left_placeholder, right_placeholder = tvm.topi.random.threefry_split(gen_placeholder)
+        s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
+    f = tvm.build(s, [gen_placeholder, left_placeholder, right_placeholder], target=target)
+    left = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"), dev)
+    right = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"), dev)
+    f(tvm.nd.array(gen, dev), left, right)
     return left.numpy(), right.numpy()
 
 
 def threefry_generate(target, dev, gen, size):
     gen_placeholder = tvm.te.placeholder(gen.shape, name="gen", dtype="uint64")
-    left_placeholder, right_placeholder = tvm.topi.random.threefry_generate(gen_placeholder, size)
-    s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
-    f = tvm.build(s, [gen_placeholder, left_placeholder, right_placeholder])
-    out_gen = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"))
-    rands = tvm.nd.array(np.zeros(size, dtype="uint64"))
-    f(tvm.nd.array(gen), out_gen, rands)
+    with tvm.target.Target(target):
+        left_placeholder, right_placeholder = tvm.topi.random.threefry_generate(
+            gen_placeholder, size
+        )
+        s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
+    f = tvm.build(s, [gen_placeholder, left_placeholder, right_placeholder], target=target)
+    out_gen = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"), dev)
+    rands = tvm.nd.array(np.zeros(size, dtype="uint64"), dev)
+    f(tvm.nd.array(gen, dev), out_gen, rands)
     return out_gen.numpy(), rands.numpy()
 
 
@@ -47,19 +51,43 @@ def uniform(target, dev, gen, low, high, size, dtype):
     gen_placeholder = tvm.te.placeholder(gen.shape, name="gen", dtype="uint64")
     low_placeholder = tvm.te.placeholder(low.shape, name="low", dtype=dtype)
     high_placeholder = tvm.te.placeholder(high.shape, name="high", dtype=dtype)
-    left_placeholder, right_placeholder = tvm.topi.random.uniform(
-        gen_placeholder, low_placeholder, high_placeholder, size, dtype
-    )
-    s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
+    with tvm.target.Target(target):
+        left_placeholder, right_placeholder = tvm.topi.random.uniform(
+            gen_placeholder, low_placeholder, high_placeholder, size, dtype
+        )
+        s = tvm.topi.generic.schedule_extern([left_placeholder, right_placeholder])
     f = tvm.build(
-        s, [gen_placeholder, low_placeholder, high_placeholder, left_placeholder, right_placeholder]
+        s,
+        [gen_placeholder, low_placeholder, high_placeholder, left_placeholder, right_placeholder],
+        target=target,
     )
-    out_gen = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"))
-    rands = tvm.nd.array(np.zeros(size, dtype=dtype))
-    f(tvm.nd.array(gen), tvm.nd.array(low), tvm.nd.array(high), out_gen, rands)
+    out_gen = tvm.nd.array(np.zeros(gen.shape, dtype="uint64"), dev)
+    rands = tvm.nd.array(np.zeros(size, dtype=dtype), dev)
+    f(tvm.nd.array(gen, dev), tvm.nd.array(low, dev), tvm.nd.array(high, dev), out_gen, rands)
     return out_gen.asnumpy(), rands.asnumpy()
 
 
+def threefry_ref(key, counter):
+    """Threefry of a block of 4 counter words, as the kernels implement it"""
+    mask = (1 << 64) - 1
+    rotations = tvm.topi.random.kernel._ROTATIONS[4]
+    permutation = tvm.topi.random.kernel._PERMUTATIONS[4]
+    full_key = [int(k) for k in key] + [0x1BD11BDAA9FC1A22]
+    for k in key:
+        full_key[4] ^= int(k)
+    block = [int(c) for c in counter]
+    for i in range(5):
+        for j in range(4):
+            block[j] = (block[j] + full_key[(i + j) % 5] + (i if j == 3 else 0)) & mask
+        for k in range(4):
+            for j in range(2):
+                a, b, r = block[j * 2], block[j * 2 + 1], rotations[(i * 4 + k) % 8][j]
+                block[j * 2] = (a + b) & mask
+                block[j * 2 + 1] = block[j * 2] ^ (((b << r) | (b >> (64 - r))) & mask)
+            block = [block[p] for p in permutation]
+    return block
+
+
 @tvm.testing.parametrize_targets
 def test_threefry_split(target, dev):
     # test that results of split do not equal eachother or the input
@@ -134,6 +162,31 @@ def test_threefry_generate(target, dev):
     ).any(), "Overflowing counter with no space left in path should change state"
 
 
+@tvm.testing.parametrize_targets
+def test_threefry_generate_reference(target, dev):
+    gen = tvm.relay.random.threefry_key(7).data.numpy()
+    gen[7] = 5  # a used counter
+    for size in [(7,), (3, 4), (1029,)]:
+        out_gen, rands = threefry_generate(target, dev, gen, size)
+        n = int(np.prod(size))
+        expected = []
+        for block in range(n // 4):
+            expected += threefry_ref(gen[0:4], [int(c) + block for c in gen[4:8]])
+        if n % 4 != 0:
+            counter = [int(c) for c in gen[4:8]]
+            counter[3] += n // 4 * 4
+            expected += threefry_ref(gen[0:4], counter)[: n % 4]
+        assert rands.flatten().tolist() == expected
+        assert out_gen[7] == gen[7] + (n + 3) // 4 * 4
+
+    # The uniform samples are made of the same random bits.
+    low, high = np.array(-2.0, dtype="float64"), np.array(3.0, dtype="float64")
+    _, rands = threefry_generate(target, dev, gen, (1029,))
+    _, values = uniform(target, dev, gen, low, high, (1029,), "float64")
+    mantissa = (rands >> np.uint64(12)) | np.uint64(1023 << 52)
+    tvm.testing.assert_allclose(values, (mantissa.view("float64") - 1.0) * 5.0 - 2.0)
+
+
 @tvm.testing.parametrize_targets
 def test_threefry_wrapping(target, dev):
     assert tvm.topi.random.threefry_test_wrapping(
@@ -160,5 +213,6 @@ def test_uniform(target, dev):
 if __name__ == "__main__":
     test_threefry_split(tvm.target.Target("llvm"), tvm.device("cpu"))
     test_threefry_generate(tvm.target.Target("llvm"), tvm.device("cpu"))
+    test_threefry_generate_reference(tvm.target.Target("llvm"), tvm.device("cpu"))
     test_threefry_wrapping(tvm.target.Target("llvm"), tvm.device("cpu"))
     test_uniform(tvm.target.Target("llvm"), tvm.device("cpu"))
@@ -899,6 +899,24 @@ def test_transpose_unfused_schedule(target, dev):
     tvm.testing.assert_allclose(ex.evaluate()(r, r).asnumpy(), np.transpose(r + r))
 
 
+@tvm.testing.parametrize_targets("llvm", "cuda", "rocm")
+def test_transpose_tiled_schedule(target, dev):
+    # Extents not a multiple of the tile, so that the tiles at the boundary are partial.
+    for shape, axes in [((67, 45), None), ((2, 37, 5, 70), (0, 2, 3, 1)), ((3, 33, 40), (2, 0, 1))]:
+        x = relay.var("x", relay.TensorType(shape, "float32"))
+        mod = tvm.IRModule.from_expr(relay.Function([x], relay.transpose(x, axes)))
+        r = np.random.rand(*shape).astype("float32")
+        ex = relay.create_executor(kind="graph", mod=mod, device=dev, target=target)
+        tvm.testing.assert_allclose(ex.evaluate()(r).asnumpy(), np.transpose(r, axes))
+
+    shape = (1, 48, 9, 40)
+    x = relay.var("x", relay.TensorType(shape, "float32"))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.layout_transform(x, "NCHW", "NHWC")))
+    r = np.random.rand(*shape).astype("float32")
+    ex = relay.create_executor(kind="graph", mod=mod, device=dev, target=target)
+    tvm.testing.assert_allclose(ex.evaluate()(r).asnumpy(), r.transpose(0, 2, 3, 1))
+
+
 @tvm.testing.uses_gpu
 def test_reshape():
     verify_reshape((1, 2, 3, 4), (2, 3, 4))
@@ -292,6 +292,104 @@ def test_non_max_suppression():
     )
 
 
+def _nms_indices_ref(np_data, max_output_size, iou_threshold, force_suppress, top_k):
+    """The indices of the boxes selected by a greedy NMS, for boxes [class_id, score, x1, y1, x2,
+    y2] which are all valid"""
+    batch, num_anchors, _ = np_data.shape
+    result = np.full((batch, num_anchors), -1, "int32")
+    for i in range(batch):
+        order = np.argsort(-np_data[i, :, 1], kind="stable")
+        if 0 < top_k < num_anchors:
+            order = order[:top_k]
+        boxes = np_data[i, order]
+        l = np.minimum(boxes[:, 2], boxes[:, 4])
+        t = np.minimum(boxes[:, 3], boxes[:, 5])
+        r = np.maximum(boxes[:, 2], boxes[:, 4])
+        b = np.maximum(boxes[:, 3], boxes[:, 5])
+        areas = (r - l) * (b - t)
+        suppressed = np.zeros(len(order), "bool")
+        num_selected = 0
+        for j in range(len(order)):
+            if suppressed[j]:
+                continue
+            if 0 < max_output_size <= num_selected:
+                break
+            result[i, num_selected] = order[j]
+            num_selected += 1
+            w = np.maximum(0, np.minimum(r[j], r) - np.maximum(l[j], l))
+            h = np.maximum(0, np.minimum(b[j], b) - np.maximum(t[j], t))
+            inter = w * h
+            iou = inter / (areas[j] + areas - inter)
+            overlaps = iou >= iou_threshold
+            if not force_suppress:
+                overlaps &= boxes[:, 0] == boxes[j, 0]
+            overlaps[: j + 1] = False
+            suppressed |= overlaps
+    return result
+
+
+@tvm.testing.uses_gpu
+def test_non_max_suppression_random():
+    def verify(batch, num_anchors, max_output_size, iou_threshold, force_suppress, top_k):
+        np.random.seed(0)
+        corners = np.random.uniform(0, 100, size=(batch, num_anchors, 2))
+        sizes = np.random.uniform(5, 30, size=(batch, num_anchors, 2))
+        np_data = np.concatenate(
+            [
+                np.random.randint(0, 3, size=(batch, num_anchors, 1)),
+                np.random.uniform(0.05, 1, size=(batch, num_anchors, 1)),
+                corners,
+                corners + sizes,
+            ],
+            axis=2,
+        ).astype("float32")
+        np_valid_count = np.full((batch,), num_anchors, "int32")
+        np_indices = np.tile(np.arange(num_anchors, dtype="int32"), (batch, 1))
+        np_result = _nms_indices_ref(np_data, max_output_size, iou_threshold, force_suppress, top_k)
+
+        data = te.placeholder(np_data.shape, name="data")
+        valid_count = te.placeholder((batch,), dtype="int32", name="valid_count")
+        indices = te.placeholder((batch, num_anchors), dtype="int32", name="indices")
+
+        for target, dev in tvm.testing.enabled_targets():
+            with tvm.target.Target(target):
+                fcompute, fschedule = tvm.topi.testing.dispatch(target, _nms_implement)
+                out = fcompute(
+                    data,
+                    valid_count,
+                    indices,
+                    max_output_size,
+                    iou_threshold,
+                    force_suppress,
+                    top_k,
+                    coord_start=2,
+                    score_index=1,
+                    id_index=0,
+                    return_indices=True,
+                )
+                s = fschedule(out)
+            f = tvm.build(s, [data, valid_count, indices, out[0], out[1]], target)
+            tvm_out = tvm.nd.array(np.zeros((batch, num_anchors), "int32"), dev)
+            tvm_num = tvm.nd.array(np.zeros((batch, 1), "int32"), dev)
+            f(
+                tvm.nd.array(np_data, dev),
+                tvm.nd.array(np_valid_count, dev),
+                tvm.nd.array(np_indices, dev),
+                tvm_out,
+                tvm_num,
+            )
+            num_selected = tvm_num.numpy()[:, 0]
+            np.testing.assert_equal(num_selected, (np_result >= 0).sum(axis=1))
+            for i in range(batch):
+                n = num_selected[i]
+                np.testing.assert_equal(tvm_out.numpy()[i, :n], np_result[i, :n])
+
+    # More boxes than the 64 covered by a word of the GPU suppression bitmask.
+    verify(2, 300, -1, 0.5, False, -1)
+    verify(2, 300, -1, 0.3, True, 100)
+    verify(1, 1000, 50, 0.5, False, -1)
+
+
 def verify_multibox_prior(
     dshape, sizes=(1,), ratios=(1,), steps=(-1, -1), offsets=(0.5, 0.5), clip=False
 ):
@@ -742,4 +840,5 @@ if __name__ == "__main__":
     test_roi_pool()
     test_proposal()
     test_non_max_suppression()
+    test_non_max_suppression_random()
     test_all_class_non_max_suppression()
@@ -153,6 +153,17 @@ def zero_rank_reduce_auto_scheduler_test(N):
     return [A, B]
 
 
+@auto_scheduler.register_workload
+def sparse_dense_bsr_auto_scheduler_test(M, N, K, BS_R, BS_C, nnz_blocks):
+    X = te.placeholder((M, K), name="X")
+    W_data = te.placeholder((nnz_blocks, BS_R, BS_C), name="W_data")
+    W_indices = te.placeholder((nnz_blocks,), name="W_indices", dtype="int32")
+    W_indptr = te.placeholder((N // BS_R + 1,), name="W_indptr", dtype="int32")
+    out = topi.nn.relu(topi.nn.sparse_dense(X, W_data, W_indices, W_indptr))
+
+    return [X, W_data, W_indices, W_indptr, out]
+
+
 @auto_scheduler.register_workload
 def zero_rank_compute_auto_scheduler_test(N):
     A = tvm.te.placeholder((N,), name="A")
@@ -43,6 +43,25 @@ def test_infer_bound():
     s = dag.infer_bound_from_state(s)
 
 
+def test_infer_bound_from_states():
+    dag, s = get_tiled_matmul()
+    C = dag.tensors[-1]
+    s_cache = dag.get_init_state()
+    C_local = s_cache.cache_write(C, "local")
+    its = s_cache.split(C, s_cache[C].iters[0], [16])
+    s_cache.compute_at(C_local, C, its[0])
+
+    expected = [str(dag.infer_bound_from_state(x)) for x in [s, s_cache]]
+    # The states inferred before hit the cache, including the ones replaying new ops
+    for _ in range(2):
+        states = dag.infer_bound_from_states([s, s_cache, s])
+        assert [str(x) for x in states] == [expected[0], expected[1], expected[0]]
+    # The inferred bounds are not shared with a state of different steps
+    s_other = dag.get_init_state()
+    s_other.split(C, s_other[C].iters[0], [16])
+    assert str(dag.infer_bound_from_states([s_other])[0]) != expected[0]
+
+
 def test_estimate_flop():
     N = 512
     A, B, C = matmul_auto_scheduler_test(N, N, N)
@@ -147,6 +166,7 @@ def test_invalid_compute_dag():
 if __name__ == "__main__":
     test_apply_steps()
     test_infer_bound()
+    test_infer_bound_from_states()
     test_estimate_flop()
     test_stage_order()
     test_invalid_compute_dag()
@@ -0,0 +1,78 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+""" Test distributed tuning """
+
+import tempfile
+import threading
+from multiprocessing.connection import Client
+
+import tvm
+import tvm.testing
+from tvm import auto_scheduler
+from tvm.auto_scheduler.distributed import DEFAULT_AUTHKEY
+
+from test_auto_scheduler_common import matmul_auto_scheduler_test
+
+
+@tvm.testing.requires_llvm
+def test_distributed_tuning():
+    tasks = [
+        auto_scheduler.SearchTask(func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm")
+        for n in [8, 16]
+    ]
+
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+        num_trials_per_task = 2
+
+        coordinator = auto_scheduler.TuningCoordinator(
+            tasks, num_trials_per_task, log_file, address=("localhost", 0)
+        )
+        thread = threading.Thread(target=coordinator.run)
+        thread.start()
+
+        # A worker which dies after receiving a task, the task is given back.
+        conn = Client(coordinator.address, authkey=DEFAULT_AUTHKEY)
+        conn.send(("hello", "lost"))
+        assert conn.recv()[0] == "welcome"
+        conn.send(("request",))
+        assert conn.recv()[0] == "task"
+        conn.close()
+
+        worker = auto_scheduler.TuningWorker(
+            coordinator.address, cost_model="random", num_measures_per_round=1, verbose=0
+        )
+        worker.run()
+        thread.join()
+
+        counters = {task.workload_key: 0 for task in tasks}
+        for inp, _ in auto_scheduler.load_records(log_file):
+            counters[inp.task.workload_key] += 1
+        for task in tasks:
+            assert counters[task.workload_key] == num_trials_per_task
+
+        # The records of the log file count toward the trials, nothing is left to tune.
+        coordinator = auto_scheduler.TuningCoordinator(
+            tasks, num_trials_per_task, log_file, address=("localhost", 0)
+        )
+        for i in range(len(tasks)):
+            assert coordinator.num_measured(i) == num_trials_per_task
+        coordinator.run()
+
+
+if __name__ == "__main__":
+    test_distributed_tuning()
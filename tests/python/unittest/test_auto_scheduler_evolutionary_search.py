@@ -116,6 +116,41 @@ def test_mutate_parallel():
     assert found
 
 
+def test_predict_in_batches():
+    """The mutated states are sent to the cost model in batches."""
+
+    class MockCostModel(PythonBasedModel):
+        def __init__(self):
+            super().__init__()
+            self.batch_sizes = []
+
+        def predict(self, task, states):
+            self.batch_sizes.append(len(states))
+            return [len(str(state)) for state in states]
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(64, 64, 64), target="llvm"
+    )
+    cost_model = MockCostModel()
+    params = {
+        "evolutionary_search_population": 256,
+        "evolutionary_search_predict_batch_size": 64,
+        "evolutionary_search_num_iters": 2,
+    }
+    policy = auto_scheduler.SketchPolicy(
+        task, program_cost_model=cost_model, params=params, verbose=0
+    )
+    states = policy.sample_initial_population()[:50]
+    cost_model.batch_sizes = []
+    new_states = policy.evolutionary_search(states, 50)
+    assert len(new_states) > 0
+    # The initial population is predicted at once, then each generation in batches.
+    assert cost_model.batch_sizes[0] == len(states)
+    assert len(cost_model.batch_sizes) >= 1 + 2 * 256 // 64
+    assert all(size <= 64 for size in cost_model.batch_sizes[1:])
+
+
 if __name__ == "__main__":
     test_mutate_tile_size()
     test_mutate_parallel()
+    test_predict_in_batches()
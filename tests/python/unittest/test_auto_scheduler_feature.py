@@ -91,6 +91,40 @@ def test_cpu_matmul():
     assert fequal(fea_dict["parallel_prod"], math.log2((512 * 512 / 16 / 8) + 1))
 
 
+def test_feature_cache():
+    dag = auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(128, 128, 128))
+    s = dag.get_init_state()
+    C = s.stage_ops[2]
+    i, j, k = s[C].iters
+    io, ii = s.split(C, i, [16])
+    s.parallel(C, io)
+
+    target = tvm.target.Target("llvm")
+    task = auto_scheduler.SearchTask(compute_dag=dag, workload_key="test", target=target)
+    states = [dag.get_init_state(), s, s]
+    auto_scheduler.feature.reset_feature_cache()
+    cached = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    cached_again = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    auto_scheduler.feature.reset_feature_cache(0)
+    uncached = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    auto_scheduler.feature.reset_feature_cache()
+
+    for i in range(len(states)):
+        assert (cached[i] == uncached[i]).all()
+        assert (cached_again[i] == uncached[i]).all()
+    assert not (uncached[0].shape == uncached[1].shape and (uncached[0] == uncached[1]).all())
+
+    # A task of another DAG under the same workload key does not hit the cache.
+    other_dag = auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(64, 64, 64))
+    other_task = auto_scheduler.SearchTask(
+        compute_dag=other_dag, workload_key="test", target=target
+    )
+    other = auto_scheduler.feature.get_per_store_features_from_states(
+        [other_dag.get_init_state()], other_task
+    )
+    assert not (other[0].shape == cached[0].shape and (other[0] == cached[0]).all())
+
+
 def test_cpu_fusion():
     def fusion_test(N, M):
         A = te.placeholder((N, M), name="A")
@@ -202,5 +236,6 @@ def test_gpu_feature():
 
 if __name__ == "__main__":
     test_cpu_matmul()
+    test_feature_cache()
     test_cpu_fusion()
     test_gpu_feature()
@@ -26,6 +26,7 @@ from tvm import te, auto_scheduler
 import tempfile
 import tvm.testing
 import pickle
+import pytest
 from test_auto_scheduler_common import matmul_auto_scheduler_test
 from tvm.auto_scheduler import workload_registry
 
@@ -203,6 +204,52 @@ def test_recover_measure_input():
         assert str(correct_inp.state) == str(inp.state)
 
 
+def test_record_database():
+    tasks = [
+        auto_scheduler.SearchTask(func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm")
+        for n in [64, 128]
+    ]
+    inputs, results = [], []
+    for task in tasks:
+        for cost in [0.5, 0.2, 0.4, 0.1, 0.3]:
+            inputs.append(auto_scheduler.measure.MeasureInput(task, task.compute_dag.init_state))
+            results.append(auto_scheduler.measure.MeasureResult([cost], 0, "", 0.2, 1))
+        # A failed measurement is stored, but not indexed.
+        inputs.append(auto_scheduler.measure.MeasureInput(task, task.compute_dag.init_state))
+        results.append(auto_scheduler.measure.MeasureResult([0.01], 2, "", 0.2, 1))
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = tmpdir + "/records.db"
+        database = auto_scheduler.RecordDatabase(path, top_k=3)
+        database.append(inputs[:6], results[:6])
+        # Another writer appends to the same database.
+        auto_scheduler.RecordDatabase(path, top_k=3).append(inputs[6:], results[6:])
+
+        for task in tasks:
+            top = database.get_top_k(task.workload_key, task.target, 3)
+            assert [res.costs[0].value for _, res in top] == pytest.approx([0.1, 0.2, 0.3])
+            assert top[0][0].task.workload_key == task.workload_key
+        assert len(database.best_records()) == len(tasks)
+
+        # The saved index is loaded, and the later entries are scanned.
+        database.save_index()
+        database.append(inputs[:1], [auto_scheduler.measure.MeasureResult([0.05], 0, "", 0.2, 1)])
+        reopened = auto_scheduler.RecordDatabase(path, top_k=2)
+        top = reopened.get_top_k(tasks[0].workload_key, tasks[0].target, 2)
+        assert [res.costs[0].value for _, res in top] == pytest.approx([0.05, 0.1])
+
+        compact_path = tmpdir + "/compact.db"
+        reopened.compact(compact_path)
+        compacted = auto_scheduler.RecordDatabase(compact_path, top_k=2)
+        for task in tasks:
+            assert len(compacted.get_top_k(task.workload_key, task.target, 2)) == 2
+
+        # The best records are applied at compile time.
+        with auto_scheduler.ApplyHistoryBest(compacted) as context:
+            for task in tasks:
+                assert context._query_inside(task.target, task.workload_key, "main") is not None
+
+
 def test_workload_dis_factor():
     calc = auto_scheduler.utils.calc_workload_dis_factor
     decode = auto_scheduler.utils.decode_workload_key
@@ -256,6 +303,32 @@ def test_measure_local_builder_runner():
         mress = local_runner.run([minp], bress)
         assert mress[0].error_no == 0
 
+    # repeat until the confidence interval is narrow enough
+    local_runner = auto_scheduler.LocalRunner(timeout=60, repeat=3, max_repeat=20, max_rel_ci=0.05)
+    bress = local_builder.build([minp])
+    mress = local_runner.run([minp], bress)
+    assert mress[0].error_no == 0
+    assert 1 <= len(mress[0].costs) <= 20
+
+
+def test_measure_local_builder_runner_in_memory():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(128, 128, 128), target="llvm"
+    )
+
+    minp = auto_scheduler.MeasureInput(task, task.compute_dag.init_state)
+    local_builder = auto_scheduler.LocalBuilder(build_func="jit")
+    local_runner = auto_scheduler.LocalRunner(timeout=60)
+
+    bress = local_builder.build([minp])
+    assert bress[0].error_no == 0
+    assert bress[0].filename == "" and bress[0].module_ir
+    mress = local_runner.run([minp], bress)
+    assert mress[0].error_no == 0
+
 
 def test_dag_measure_local_builder_runner():
     if not tvm.testing.device_enabled("llvm"):
@@ -317,6 +390,28 @@ def test_measure_local_builder_rpc_runner():
         del measure_ctx
 
 
+@tvm.testing.requires_llvm
+def test_measure_local_builder_rpc_runner_batch():
+    task = auto_scheduler.SearchTask(
+        func=matmul_auto_scheduler_test, args=(128, 128, 128), target="llvm"
+    )
+    state = task.compute_dag.init_state
+    minps = [auto_scheduler.MeasureInput(task, state) for _ in range(5)]
+    local_builder = auto_scheduler.LocalBuilder()
+    measure_ctx = auto_scheduler.LocalRPCMeasureContext(timeout=60, n_parallel=2, batch_size=2)
+    rpc_runner = measure_ctx.runner
+
+    bress = local_builder.build(minps)
+    assert all(bres.error_no == 0 for bres in bress)
+    mress = rpc_runner.run(minps, bress)
+    assert len(mress) == len(minps)
+    for mres in mress:
+        assert mres.error_no == 0
+        assert 0 < mres.costs[0].value < 1e10
+
+    del measure_ctx
+
+
 def measure_local_builder_rpc_runner_spawn():
     assert multiprocessing.get_start_method(False) == "spawn"
     test_measure_local_builder_rpc_runner()
@@ -420,10 +515,13 @@ if __name__ == "__main__":
     test_record_follow_split_follow_fused_split()
     test_record_pragma_storage_align_rfactor()
     test_recover_measure_input()
+    test_record_database()
     test_workload_dis_factor()
     test_measure_local_builder_runner()
+    test_measure_local_builder_runner_in_memory()
     test_dag_measure_local_builder_runner()
     test_measure_local_builder_rpc_runner()
+    test_measure_local_builder_rpc_runner_batch()
     test_measure_target_host()
     test_measure_special_inputs_map_by_name_local_runner()
     test_measure_special_inputs_map_by_name_rpc_runner()
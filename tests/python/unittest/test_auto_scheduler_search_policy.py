@@ -209,6 +209,32 @@ def test_sketch_search_policy_custom_sketch():
     )
 
 
+@tvm.testing.requires_llvm
+def test_sketch_search_policy_preload_similar_states():
+    with tempfile.NamedTemporaryFile() as fp:
+        log_file = fp.name
+
+        # Records of the same compute function with other shapes
+        for n in [32, 128]:
+            task = auto_scheduler.SearchTask(
+                func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+            )
+            tuning_options = auto_scheduler.TuningOptions(
+                num_measure_trials=4,
+                num_measures_per_round=2,
+                runner="local",
+                measure_callbacks=[auto_scheduler.RecordToFile(log_file)],
+                verbose=0,
+            )
+            task.tune(tuning_options=tuning_options)
+
+        search_common(
+            cost_model=auto_scheduler.XGBModel(num_warmup_sample=1),
+            num_measure_trials=4,
+            init_search_callbacks=[auto_scheduler.PreloadSimilarStates(log_file)],
+        )
+
+
 if __name__ == "__main__":
     test_workload_registry_empty_policy()
     test_sketch_search_policy_basic()
@@ -218,3 +244,4 @@ if __name__ == "__main__":
     test_sketch_search_policy_cuda_xgbmodel_rpc_runner()
     test_sketch_search_policy_zero_rank()
     test_sketch_search_policy_custom_sketch()
+    test_sketch_search_policy_preload_similar_states()
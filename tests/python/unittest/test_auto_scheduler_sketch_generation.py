@@ -37,6 +37,7 @@ from test_auto_scheduler_common import (
     softmax_abcd_auto_scheduler_test,
     conv2d_winograd_nhwc_auto_scheduler_test,
     zero_rank_reduce_auto_scheduler_test,
+    sparse_dense_bsr_auto_scheduler_test,
 )
 
 
@@ -310,6 +311,21 @@ def test_cpu_custom_sketch():
     assert sketches[1].stages[2].iters[4].range.extent == 512
 
 
+def test_cpu_sparse_dense_sketch():
+    sketches = generate_sketches(
+        sparse_dense_bsr_auto_scheduler_test,
+        (8, 512, 256, 16, 1, 128),
+        "llvm",
+        init_search_callbacks=[auto_scheduler.sparse_dense_sketch_rule()],
+    )
+    assert len(sketches) == 1
+    # The BSR blocks are tiled at the tiles of the relu, the sparse dense is inlined.
+    assert_compute_at_condition(sketches[0].stages[4], "iter")
+    assert len(sketches[0].stages[4].iters) == 8
+    assert_compute_at_condition(sketches[0].stages[5], "inlined")
+    assert_is_tiled(sketches[0].stages[6])
+
+
 @tvm.testing.requires_cuda
 def test_cuda_matmul_sketch():
     sketches = generate_sketches(matmul_auto_scheduler_test, (512, 512, 512), "cuda")
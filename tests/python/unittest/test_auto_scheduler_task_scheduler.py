@@ -139,7 +139,36 @@ def test_task_scheduler_gradient():
         del measure_ctx
 
 
+@tvm.testing.requires_llvm
+def test_task_scheduler_merge_models():
+    def make_tasks(sizes):
+        return [
+            auto_scheduler.SearchTask(
+                func=matmul_auto_scheduler_test, args=(n, n, n), target="llvm"
+            )
+            for n in sizes
+        ]
+
+    # two models sharing the 4x4 workload, called twice in the first one
+    model_a, model_b = make_tasks([2, 4]), make_tasks([4, 8])
+    task_scheduler = auto_scheduler.TaskScheduler(
+        model_a + model_b, task_weights=[1, 2, 3, 1], callbacks=[]
+    )
+
+    assert len(task_scheduler.tasks) == 3
+    shared = task_scheduler.task_index(model_b[0])
+    assert shared == task_scheduler.task_index(model_a[1])
+    assert task_scheduler.task_weights[shared] == 5
+    assert task_scheduler.task_weights == [1, 5, 1]
+    assert task_scheduler.task_index(make_tasks([16])[0]) is None
+
+    # the objective is the weighted sum of the latencies over all the models
+    task_scheduler.best_costs = [1.0, 2.0, 3.0]
+    assert abs(task_scheduler.cur_score - 14.0) < 1e-9
+
+
 if __name__ == "__main__":
     test_task_scheduler_round_robin()
     test_task_scheduler_round_robin_spawn()
     test_task_scheduler_gradient()
+    test_task_scheduler_merge_models()
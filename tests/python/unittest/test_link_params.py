@@ -346,6 +346,35 @@ def test_c_link_params():
             np.testing.assert_allclose(unlinked_output.numpy(), linked_output.numpy())
 
 
+def test_c_link_params_blob():
+    temp_dir = utils.tempdir()
+    for dtype in ["int8", "float32", "uint64"]:
+        mod, param_init = _make_mod_and_params(dtype)
+        target = "c --link-params"
+        config = {"tir.disable_vectorize": True, "tir.c_link_params_blob_min_bytes": 0}
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = tvm.relay.build(mod, target, params=param_init)
+
+        # the parameters are written as string literals of their bytes
+        src = lib.lib.get_source()
+        param = lib.params["p0"].numpy()
+        param_def = f"static const uint8_t __tvm_param__p0[{param.nbytes + 1}] TVM_PARAM_ALIGNED("
+        assert param_def in src, src
+        body = src[src.index(param_def) :]
+        body = body[body.index("=\n") + 2 : body.index(";\n")]
+        data = b"".join(
+            bytes.fromhex(line.strip().strip('"').replace("\\x", "")) for line in body.splitlines()
+        )
+        assert data == param.tobytes()
+
+        lib_path = temp_dir.relpath(f"test-{dtype}-blob.so")
+        lib["remove_params"]().export_library(lib_path)
+        lib_mod = tvm.runtime.load_module(lib_path)
+        graph = json.loads(lib.graph_json)
+        for p in lib.params:
+            _verify_linked_param(dtype, lib, lib_mod, graph, p)
+
+
 @tvm.testing.requires_micro
 def test_crt_link_params():
     import tvm.micro
@@ -0,0 +1,95 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import random
+
+import tvm
+from tvm import meta_schedule as ms
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def matmul(a: ty.handle, b: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    with tir.block([128, 128, tir.reduce_axis(0, 128)], "C") as [vi, vj, vk]:
+        with tir.init():
+            C[vi, vj] = 0.0
+        C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def _schedule_matmul(sch):
+    i, j, _ = sch.get_loops(sch.get_block("C"))
+    i_0, i_1 = sch.split(i, factors=[8, 16])
+    j_0, j_1 = sch.split(j, factors=[4, 32])
+    sch.reorder(i_0, j_0, i_1, j_1)
+
+
+def _split_factors(trace):
+    return [
+        [int(factor) for factor in inst.inputs[1:]] for inst in trace.insts if inst.kind == "Split"
+    ]
+
+
+def test_schedule_fn():
+    (sch,) = ms.ScheduleFn(_schedule_matmul).generate(tvm.IRModule({"main": matmul}))
+    assert _split_factors(sch.trace) == [[8, 16], [4, 32]]
+
+
+def test_space_generator_union():
+    space = ms.SpaceGeneratorUnion(
+        [ms.ScheduleFn(_schedule_matmul), ms.ScheduleFn(lambda sch: None)]
+    )
+    design_space = space.generate(tvm.IRModule({"main": matmul}))
+    assert [len(sch.trace.insts) for sch in design_space] == [5, 0]
+
+
+def test_mutate_tile_size():
+    (sch,) = ms.ScheduleFn(_schedule_matmul).generate(tvm.IRModule({"main": matmul}))
+    rand_state = random.Random(0)
+    mutator = ms.MutateTileSize()
+    for _ in range(16):
+        new_trace = mutator.apply(sch.trace, rand_state)
+        new_factors = _split_factors(new_trace)
+        assert [factors[0] * factors[1] for factors in new_factors] == [128, 128]
+        assert new_factors != [[8, 16], [4, 32]]
+        # The mutated trace is replayed on a fresh schedule
+        new_sch = tir.Schedule(matmul, traced=True)
+        new_trace.apply_to_schedule(new_sch)
+    # The original trace is untouched
+    assert _split_factors(sch.trace) == [[8, 16], [4, 32]]
+
+
+def test_mutate_tile_size_no_candidate():
+    sch = tir.Schedule(matmul, traced=True)
+    i, _, _ = sch.get_loops(sch.get_block("C"))
+    sch.split(i, factors=[None, 16])
+    assert ms.MutateTileSize().apply(sch.trace, random.Random(0)) is None
+
+
+if __name__ == "__main__":
+    test_schedule_fn()
+    test_space_generator_union()
+    test_mutate_tile_size()
+    test_mutate_tile_size_no_candidate()
@@ -0,0 +1,92 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import tempfile
+
+import pytest
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (256, 256))
+    B = tir.match_buffer(b, (256, 256))
+    with tir.block([256, 256], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def _schedule_elementwise(sch):
+    i, j = sch.get_loops(sch.get_block("B"))
+    i_0, _ = sch.split(i, factors=[16, 16])
+    sch.parallel(i_0)
+    sch.vectorize(j)
+
+
+def test_database():
+    mod = tvm.IRModule({"main": elementwise})
+    (sch,) = ms.ScheduleFn(_schedule_elementwise).generate(mod)
+    workload = ms.workload_key(mod)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = tmpdir + "/records.json"
+        database = ms.JSONDatabase(path)
+        for run_secs in [[0.3], [0.1, 0.2], [0.2]]:
+            database.commit(ms.TuningRecord(sch.trace, run_secs, workload, "llvm"))
+        assert len(database) == 3
+        assert database.get_top_k(workload, "cuda", 1) == []
+
+        reopened = ms.JSONDatabase(path)
+        top = reopened.get_top_k(workload, "llvm", 2)
+        assert [record.mean_run_secs for record in top] == pytest.approx([0.15, 0.2])
+        # The trace survives the round trip through the log file
+        best = ms.apply_best(elementwise, "llvm", reopened)
+        tvm.ir.assert_structural_equal(best.mod, sch.mod)
+
+
+@tvm.testing.requires_llvm
+def test_tune_tir():
+    database = ms.JSONDatabase()
+    sch = ms.tune_tir(
+        elementwise,
+        "llvm",
+        ms.ScheduleFn(_schedule_elementwise),
+        num_trials=4,
+        batch_size=2,
+        database=database,
+        runner=ms.LocalRunner(number=1, min_repeat_ms=0),
+        seed=0,
+        verbose=0,
+    )
+    assert sch is not None
+    assert 1 <= len(database) <= 4
+    # The best schedule keeps a perfect tiling of the outer loop
+    i_0, i_1, _ = sch.get_loops(sch.get_block("B"))
+    assert sch.get(i_0).extent * sch.get(i_1).extent == 256
+    tvm.build(sch.mod["main"], target="llvm")
+
+
+if __name__ == "__main__":
+    test_database()
+    test_tune_tir()
@@ -99,6 +99,50 @@ def validate_graph_json(extract_dir, factory):
         assert len(graph["nodes"]) == 4
         assert "attrs" in graph
 
+    with open(os.path.join(extract_dir, "runtime-config", "graph", "graph_descriptor.c")) as f:
+        descriptor = f.read()
+        name = f"tvmgen_{factory.libmod_name}_graph"
+        assert f"const TVMGraphExecutorGraphDescriptor {name} = {{" in descriptor
+
+
+@tvm.testing.requires_micro
+def test_graph_descriptor():
+    import tvm.micro as micro
+
+    graph = {
+        "nodes": [
+            {"op": "null", "name": "x", "inputs": []},
+            {
+                "op": "tvm_op",
+                "name": "fused_add",
+                "attrs": {
+                    "func_name": "fused_add",
+                    "num_inputs": "1",
+                    "num_outputs": "1",
+                    "flatten_data": "0",
+                },
+                "inputs": [[0, 0, 0]],
+            },
+        ],
+        "arg_nodes": [0],
+        "node_row_ptr": [0, 1, 2],
+        "heads": [[1, 0, 0]],
+        "attrs": {
+            "storage_id": ["list_int", [0, 1]],
+            "dltype": ["list_str", ["float32", "float32"]],
+            "shape": ["list_shape", [[1, 10], [10]]],
+        },
+    }
+    src = micro.generate_graph_descriptor(json.dumps(graph), "test_graph")
+    assert '{"null", "x", NULL, 0, 0, 0, NULL, 0},' in src
+    assert '{"tvm_op", "fused_add", "fused_add", 1, 1, 0, test_graph_node1_inputs, 1},' in src
+    assert "static const uint32_t test_graph_ndim[] = {\n    2, 1,\n};" in src
+    assert "static const int64_t test_graph_shape[] = {\n    1, 10, 10,\n};" in src
+    assert src.rstrip().endswith(
+        "test_graph_storage_id,\n    test_graph_dltype,\n    test_graph_ndim,\n"
+        "    test_graph_shape,\n    2,\n};"
+    )
+
 
 @tvm.testing.requires_micro
 @pytest.mark.parametrize(
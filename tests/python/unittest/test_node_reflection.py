@@ -14,9 +14,11 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
 import tvm
 import pytest
 from tvm import te
+from tvm.contrib import utils
 
 
 def test_const_saveload_json():
@@ -160,6 +162,37 @@ def test_dict():
     assert set(dir(x.__class__)) <= set(dir(x))
 
 
+def test_saveload_binary():
+    x = te.var("x")
+    data = tvm.nd.array(np.arange(256, dtype="float32").reshape(16, 16))
+    tensor = te.placeholder((16, 16), name="A")
+    node = tvm.runtime.convert(
+        {
+            "expr": x * 2 + tvm.tir.const(1.5, "float32").astype("int32"),
+            "tensor": tensor,
+            "data": data,
+            "names": ["a", "b"],
+            "inf": tvm.tir.const(float("inf"), "float64"),
+        }
+    )
+    blob = tvm.ir.save_binary(node)
+    assert len(blob) < len(tvm.ir.save_json(node))
+    loaded = tvm.ir.load_binary(blob)
+    tvm.ir.assert_structural_equal(loaded, node, map_free_vars=True)
+    np.testing.assert_equal(loaded["data"].numpy(), data.numpy())
+
+    temp = utils.tempdir()
+    path = temp.relpath("node.bin")
+    tvm.ir.save_binary_file(node, path)
+    for use_mmap in [True, False]:
+        loaded = tvm.ir.load_binary_file(path, use_mmap)
+        tvm.ir.assert_structural_equal(loaded, node, map_free_vars=True)
+        np.testing.assert_equal(loaded["data"].numpy(), data.numpy())
+
+    with pytest.raises(tvm.error.TVMError):
+        tvm.ir.load_binary(bytearray(blob[: len(blob) // 2]))
+
+
 if __name__ == "__main__":
     test_string()
     test_env_func()
@@ -171,3 +204,4 @@ if __name__ == "__main__":
     test_dict()
     test_infinity_value()
     test_minmax_value()
+    test_saveload_binary()
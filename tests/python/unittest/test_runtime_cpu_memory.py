@@ -0,0 +1,60 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.runtime import cpu_memory, thread_pool
+
+
+def test_huge_pages():
+    size = 8 << 20
+    for mode in ["madvise", "hugetlb"]:
+        before = cpu_memory.huge_page_stats()
+        cpu_memory.config_huge_pages(mode)
+        try:
+            # The tensors are usable whether the system grants huge pages or not.
+            data = np.random.uniform(size=size // 4).astype("float32")
+            arr = tvm.nd.array(data)
+            tvm.testing.assert_allclose(arr.numpy(), data)
+            small = tvm.nd.array(data[:16])
+            tvm.testing.assert_allclose(small.numpy(), data[:16])
+        finally:
+            cpu_memory.config_huge_pages("off")
+        after = cpu_memory.huge_page_stats()
+        allocated = sum(
+            after[key] - before[key] for key in ["hugetlb_bytes", "madvise_bytes", "fallback_bytes"]
+        )
+        assert allocated >= size
+        del arr
+
+    before = cpu_memory.huge_page_stats()
+    tvm.nd.empty((size // 4,), "float32")
+    assert cpu_memory.huge_page_stats()["madvise_bytes"] == before["madvise_bytes"]
+
+
+def test_numa_alloc_scope():
+    assert thread_pool.numa_node_count() >= 1
+    data = np.random.uniform(size=(1 << 16,)).astype("float32")
+    with thread_pool.NUMAAllocScope(0):
+        arr = tvm.nd.array(data)
+    tvm.testing.assert_allclose(arr.numpy(), data)
+
+
+if __name__ == "__main__":
+    test_huge_pages()
+    test_numa_alloc_scope()
@@ -19,6 +19,7 @@ import tvm.testing
 from tvm import te, runtime
 import numpy as np
 import json
+import pytest
 from tvm import rpc
 from tvm import relay
 from tvm.contrib import utils, graph_executor
@@ -139,6 +140,273 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+@tvm.testing.requires_llvm
+def test_inter_op_parallelism():
+    x = relay.var("x", shape=(8, 16))
+    branches = [relay.nn.relu(relay.add(x, relay.const(float(i)))) for i in range(4)]
+    y = relay.concatenate([relay.exp(b) for b in branches], axis=0)
+    z = relay.sum(relay.multiply(y, y), axis=1)
+    func = relay.Function([x], relay.Tuple([y, z]))
+    with tvm.transform.PassContext(opt_level=0):
+        graph, lib, _ = relay.build(func, target="llvm")
+
+    data = np.random.uniform(-2, 2, size=(8, 16)).astype("float32")
+    ref = graph_executor.create(graph, lib, tvm.cpu(0))
+    ref.run(x=data)
+
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.set_inter_op_parallelism(4)
+    for _ in range(3):
+        mod.run(x=data)
+        for i in range(2):
+            tvm.testing.assert_allclose(mod.get_output(i).numpy(), ref.get_output(i).numpy())
+
+
+def test_multi_stream():
+    x = relay.var("x", shape=(8, 16))
+    branches = [relay.tanh(relay.multiply(x, relay.const(float(i + 1)))) for i in range(3)]
+    y = relay.add(relay.add(branches[0], branches[1]), branches[2])
+    func = relay.Function([x], relay.nn.relu(y))
+    data = np.random.uniform(-2, 2, size=(8, 16)).astype("float32")
+
+    for target, dev in tvm.testing.enabled_targets():
+        with tvm.transform.PassContext(opt_level=0):
+            graph, lib, _ = relay.build(func, target=target)
+        ref = graph_executor.create(graph, lib, dev)
+        ref.run(x=data)
+
+        mod = graph_executor.create(graph, lib, dev)
+        mod.set_num_streams(3)
+        streams = list(mod.module["get_stream_assignment"]())
+        op_streams = [s for node, s in zip(json.loads(graph)["nodes"], streams) if node["op"] != "null"]
+        # The independent branches start on distinct streams.
+        assert len(set(op_streams)) == 3
+        for _ in range(3):
+            mod.run(x=data)
+            tvm.testing.assert_allclose(mod.get_output(0).numpy(), ref.get_output(0).numpy())
+
+
+def test_async_io():
+    x = relay.var("x", shape=(4, 8))
+    func = relay.Function([x], relay.nn.relu(relay.multiply(x, relay.const(2.0))))
+    inputs = [np.random.uniform(-1, 1, size=(4, 8)).astype("float32") for _ in range(4)]
+
+    for target, dev in tvm.testing.enabled_targets():
+        graph, lib, _ = relay.build(func, target=target)
+        mod = graph_executor.create(graph, lib, dev)
+        stream = dev.create_raw_stream()
+        out = tvm.nd.empty((4, 8), "float32", dev)
+        for data in inputs:
+            mod.set_input_async("x", data, stream)
+            dev.sync(stream)
+            mod.run()
+            mod.get_output_async(0, out, stream)
+            dev.sync(stream)
+            tvm.testing.assert_allclose(out.numpy(), np.maximum(data * 2, 0))
+        dev.free_raw_stream(stream)
+
+        mod.set_double_buffered_inputs(True)
+        mod.set_input(x=inputs[0])
+        mod.run()
+        for i, data in enumerate(inputs):
+            # Upload the next input while the current run executes.
+            if i + 1 < len(inputs):
+                mod.set_input("x", inputs[i + 1])
+            tvm.testing.assert_allclose(mod.get_output(0).numpy(), np.maximum(data * 2, 0))
+            tvm.testing.assert_allclose(mod.get_input("x").numpy(), data)
+            if i + 1 < len(inputs):
+                mod.run()
+        mod.set_double_buffered_inputs(False)
+
+
+@tvm.testing.requires_llvm
+def test_sampling_stats():
+    x = relay.var("x", shape=(8, 16))
+    func = relay.Function([x], relay.nn.relu(relay.exp(relay.add(x, relay.const(1.0)))))
+    with tvm.transform.PassContext(opt_level=0):
+        graph, lib, _ = relay.build(func, target="llvm")
+    data = np.random.uniform(-1, 1, size=(8, 16)).astype("float32")
+
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.set_sampling_interval(4)
+    for _ in range(10):
+        mod.run(x=data)
+        tvm.testing.assert_allclose(
+            mod.get_output(0).numpy(), np.maximum(np.exp(data + 1), 0), rtol=1e-5
+        )
+    stats = mod.get_sampling_stats()
+    assert stats["interval"] == 4 and stats["invocations"] == 10
+    # Runs 0, 4 and 8 are sampled.
+    assert stats["total"]["count"] == 3
+    assert len(stats["ops"]) == 3
+    for op in stats["ops"]:
+        assert op["latency"]["count"] == 3
+        assert 0 < op["latency"]["p50_us"] <= op["latency"]["p99_us"]
+
+    mod.set_sampling_interval(0)
+    mod.run(x=data)
+    assert mod.get_sampling_stats()["ops"] == []
+
+
+@tvm.testing.requires_llvm
+def test_bind_by_handle():
+    x = relay.var("x", shape=(4, 8))
+    y = relay.var("y", shape=(4, 8))
+    out = relay.Tuple([relay.add(x, y), relay.nn.relu(relay.subtract(x, y))])
+    func = relay.Function([x, y], out)
+    graph, lib, _ = relay.build(func, target="llvm")
+    dev = tvm.cpu(0)
+    mod = graph_executor.create(graph, lib, dev)
+
+    handles = mod.resolve_inputs(["y", "x"])
+    assert list(handles) == [1, 0]
+    outs = [tvm.nd.empty((4, 8), "float32", dev) for _ in range(2)]
+    mod.bind_outputs([0, 1], outs)
+    for zero_copy in [False, True, False]:
+        data_x = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        data_y = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        mod.bind_inputs(handles, [tvm.nd.array(data_y, dev), tvm.nd.array(data_x, dev)], zero_copy)
+        mod.run()
+        tvm.testing.assert_allclose(outs[0].numpy(), data_x + data_y)
+        tvm.testing.assert_allclose(outs[1].numpy(), np.maximum(data_x - data_y, 0))
+
+    # The bound outputs are returned by get_output.
+    assert mod.get_output(0).same_as(outs[0])
+    mod.set_output_zero_copy(0, None)
+    mod.run()
+    assert not mod.get_output(0).same_as(outs[0])
+    tvm.testing.assert_allclose(mod.get_output(0).numpy(), data_x + data_y)
+
+    with pytest.raises(tvm.TVMError):
+        mod.resolve_inputs(["z"])
+    with pytest.raises(tvm.TVMError):
+        mod.bind_outputs([0], [tvm.nd.empty((4, 4), "float32", dev)])
+
+
+@tvm.testing.requires_llvm
+def test_set_output_zero_copy_reshape():
+    x = relay.var("x", shape=(4, 8))
+    func = relay.Function([x], relay.reshape(relay.exp(x), (8, 4)))
+    # Without fusion, the reshape runs as a "__nop" aliasing the output of exp.
+    with tvm.transform.PassContext(opt_level=0):
+        graph, lib, _ = relay.build(func, target="llvm")
+    assert "__nop" in graph
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    out = tvm.nd.empty((8, 4), "float32")
+    mod.set_output_zero_copy(0, out)
+    data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    mod.run(x=data)
+    tvm.testing.assert_allclose(out.numpy(), np.exp(data).reshape(8, 4), rtol=1e-5)
+
+    # The parameters returned as is cannot be bound.
+    graph, lib, _ = relay.build(relay.Function([x], x), target="llvm")
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    with pytest.raises(tvm.TVMError):
+        mod.set_output_zero_copy(0, tvm.nd.empty((4, 8), "float32"))
+
+
+@tvm.testing.requires_llvm
+def test_activation_arena():
+    def build(shape, scale):
+        x = relay.var("x", shape=shape)
+        y = relay.nn.relu(relay.multiply(relay.exp(x), relay.const(scale)))
+        # Without fusion, the intermediate results are placed in the arena.
+        with tvm.transform.PassContext(opt_level=0):
+            graph, lib, _ = relay.build(relay.Function([x], relay.add(y, x)), target="llvm")
+        return graph_executor.create(graph, lib, tvm.cpu(0))
+
+    def expected(data, scale):
+        return np.maximum(np.exp(data) * scale, 0) + data
+
+    arena = graph_executor.ActivationArena()
+    models = [(build((4, 8), 2.0), 2.0), (build((16, 16), 3.0), 3.0)]
+    for mod, _ in models:
+        mod.set_activation_arena(arena)
+    # Sized to the largest plan, not the sum of the plans.
+    largest = graph_executor.ActivationArena()
+    build((16, 16), 3.0).set_activation_arena(largest)
+    assert arena.reserved_bytes == largest.reserved_bytes > 0
+
+    for _ in range(2):
+        for mod, scale in models:
+            data = np.random.uniform(-1, 1, size=mod.get_input(0).shape).astype("float32")
+            mod.run(x=data)
+            assert mod.owns_activation_arena()
+            tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected(data, scale), rtol=1e-5)
+        # The outputs outlive the runs of the other executors.
+        tvm.testing.assert_allclose(
+            models[0][0].get_output(0).numpy(),
+            expected(models[0][0].get_input(0).numpy(), 2.0),
+            rtol=1e-5,
+        )
+    assert not models[0][0].owns_activation_arena()
+    models[0][0].acquire_activation_arena()
+    assert models[0][0].owns_activation_arena()
+
+    with pytest.raises(tvm.TVMError):
+        models[0][0].set_activation_arena(arena)
+
+
+@tvm.testing.requires_llvm
+def test_result_cache():
+    x = relay.var("x", shape=(4, 8))
+    y = relay.var("y", shape=(4, 8))
+    encoded = relay.nn.relu(relay.exp(relay.add(x, relay.const(1.0))))
+    with tvm.transform.PassContext(opt_level=0):
+        graph, lib, _ = relay.build(relay.Function([x, y], relay.add(encoded, y)), target="llvm")
+    relu = [node["name"] for node in json.loads(graph)["nodes"] if "relu" in node["name"]]
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.set_result_cache(1 << 20, relu, ["x"])
+
+    xs = [np.random.uniform(-1, 1, size=(4, 8)).astype("float32") for _ in range(2)]
+    for x_np in [xs[0], xs[0], xs[1], xs[0]]:
+        y_np = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+        mod.run(x=x_np, y=y_np)
+        expected = np.maximum(np.exp(x_np + 1), 0) + y_np
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+    stats = mod.get_result_cache_stats()
+    assert stats["hits"] == 2 and stats["misses"] == 2 and stats["entries"] == 2
+
+    # An entry holds its input and output, the budget of one evicts the other.
+    mod.set_result_cache(2 * 4 * 8 * 4, relu, ["x"])
+    for x_np in [xs[0], xs[1], xs[0]]:
+        mod.run(x=x_np, y=xs[1])
+        expected = np.maximum(np.exp(x_np + 1), 0) + xs[1]
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+    stats = mod.get_result_cache_stats()
+    assert stats["hits"] == 0 and stats["evictions"] == 2 and stats["entries"] == 1
+
+
+def test_run_async():
+    x = relay.var("x", shape=(4, 8))
+    graph, lib, _ = relay.build(relay.Function([x], relay.exp(x)), target="llvm")
+    mod = graph_executor.create(graph, lib, tvm.cpu(0))
+    mod.set_async_depth(2)
+    xs = [np.random.uniform(-1, 1, size=(4, 8)).astype("float32") for _ in range(8)]
+    done = []
+    futures = [mod.run_async(callback=lambda out: done.append(out[0].numpy()), x=v) for v in xs]
+    mod.wait_async()
+    # the requests complete in order, each with its own outputs
+    assert len(done) == len(xs)
+    for x_np, out, future in zip(xs, done, futures):
+        tvm.testing.assert_allclose(out, np.exp(x_np), rtol=1e-5)
+        assert future.done() and future.exception() is None
+
+    # the failure of a request is the exception of its future
+    future = mod.run_async(x=np.zeros((2, 2), "float32"))
+    with pytest.raises(tvm.TVMError):
+        future.result()
+
+
 if __name__ == "__main__":
     test_graph_simple()
     test_load_unexpected_params()
+    test_inter_op_parallelism()
+    test_multi_stream()
+    test_async_io()
+    test_sampling_stats()
+    test_bind_by_handle()
+    test_set_output_zero_copy_reshape()
+    test_activation_arena()
+    test_result_cache()
+    test_run_async()
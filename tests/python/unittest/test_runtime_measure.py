@@ -56,5 +56,85 @@ def test_min_repeat_ms():
     assert ct > 10 + 2
 
 
+def test_adaptive_repeat():
+    tmp = tempdir()
+    filename = tmp.relpath("log")
+
+    @tvm.register_func
+    def my_debug(filename):
+        """one call lasts for 10 ms and writes one character to a file"""
+        time.sleep(0.01)
+        with open(filename, "a") as fout:
+            fout.write("c")
+
+    X = te.compute((), lambda: tvm.tir.call_packed("my_debug", filename))
+    s = te.create_schedule(X.op)
+    func = tvm.build(s, [X])
+
+    x = tvm.nd.empty((), dtype="int32")
+    ftimer = func.time_evaluator(
+        func.entry_name,
+        tvm.cpu(),
+        number=1,
+        repeat=3,
+        max_repeat=20,
+        max_rel_ci=0.5,
+        warmup=2,
+        f_preproc="cache_flush_cpu_buffer",
+    )
+    res = ftimer(x)
+
+    with open(filename, "r") as fin:
+        ct = len(fin.readline())
+
+    # the two warm-up calls, then between repeat and max_repeat measurements
+    num_costs = len(res.results) + len(res.outliers)
+    assert ct == 2 + num_costs
+    assert 3 <= num_costs <= 20
+    assert res.percentiles[10] <= res.median <= res.percentiles[90]
+
+
+def test_cutoff():
+    tmp = tempdir()
+    filename = tmp.relpath("log")
+
+    @tvm.register_func
+    def my_debug(filename):
+        """one call lasts for 10 ms and writes one character to a file"""
+        time.sleep(0.01)
+        with open(filename, "a") as fout:
+            fout.write("c")
+
+    X = te.compute((), lambda: tvm.tir.call_packed("my_debug", filename))
+    s = te.create_schedule(X.op)
+    func = tvm.build(s, [X])
+
+    x = tvm.nd.empty((), dtype="int32")
+    ftimer = func.time_evaluator(
+        func.entry_name, tvm.cpu(), number=1, repeat=10, min_repeat_ms=1000, cutoff=0.001
+    )
+    res = ftimer(x)
+
+    with open(filename, "r") as fin:
+        ct = len(fin.readline())
+
+    # the warm-up call, then a single measurement over the cutoff
+    assert ct == 2
+    assert len(res.results) + len(res.outliers) == 1
+    assert res.results[0] > 0.001
+
+
+def test_robust_profile_result():
+    res = tvm.runtime.module.robust_profile_result([1.0, 1.1, 0.9, 1.0, 10.0])
+    assert res.outliers == (10.0,)
+    assert res.results == (1.0, 1.1, 0.9, 1.0)
+    assert abs(res.mean - 1.0) < 1e-9
+    assert res.median == 1.0
+    assert res.rel_ci < 0.1
+
+
 if __name__ == "__main__":
     test_min_repeat_ms()
+    test_adaptive_repeat()
+    test_cutoff()
+    test_robust_profile_result()
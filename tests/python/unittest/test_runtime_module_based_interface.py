@@ -609,6 +609,45 @@ def test_multiple_imported_modules():
     module_main.get_function("func_b", query_imports=True)
 
 
+def test_executor_pool():
+    if not tvm.testing.device_enabled("llvm"):
+        print("Skip because llvm is not enabled")
+        return
+    mod, params = relay.testing.synthetic.get_workload()
+    with relay.build_config(opt_level=3):
+        complied_graph_lib = relay.build_module.build(mod, "llvm", params=params)
+    dev = tvm.cpu()
+    executors = graph_executor.create_pool(complied_graph_lib, 3, dev)
+    assert len(executors) == 3
+
+    # the params are shared, not copied
+    param_name = next(iter(complied_graph_lib.get_params()))
+    shared = [e.get_input(param_name) for e in executors]
+    for p in shared[1:]:
+        assert p.handle.contents.data == shared[0].handle.contents.data
+
+    # concurrent runs with different inputs
+    import threading
+
+    datas = [
+        np.random.uniform(-1, 1, size=input_shape(mod)).astype("float32") for _ in executors
+    ]
+    outs = [None] * len(executors)
+
+    def run(i):
+        executors[i].set_input("data", datas[i])
+        executors[i].run()
+        outs[i] = executors[i].get_output(0).numpy()
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(executors))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    for data, out in zip(datas, outs):
+        tvm.testing.assert_allclose(out, verify(data), atol=1e-5)
+
+
 if __name__ == "__main__":
     test_legacy_compatibility()
     test_cpu()
@@ -617,3 +656,4 @@ if __name__ == "__main__":
     test_remove_package_params()
     test_debug_graph_executor()
     test_multiple_imported_modules()
+    test_executor_pool()
@@ -225,5 +225,63 @@ def test_mod_export():
     verify_multi_c_mod_export()
 
 
+def verify_import_load(compression_level):
+    if not tvm.testing.device_enabled("llvm"):
+        print("skip because llvm is not enabled...")
+        return
+    from tvm.contrib import utils
+    import os
+
+    temp = utils.tempdir()
+    subgraph_path = temp.relpath("subgraph.examplejson")
+    with open(subgraph_path, "w") as f:
+        f.write(
+            "json_rt_0\n"
+            + "input 0 10 10\n"
+            + "input 1 10 10\n"
+            + "add 2 inputs: 0 1 shape: 10 10"
+        )
+
+    A = te.placeholder((1024,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    lib = tvm.build(s, [A, B], "llvm", name="myadd")
+    try:
+        for _ in range(4):
+            lib.import_module(tvm.runtime.load_module(subgraph_path, "examplejson"))
+    except:
+        print("skip because Loader of examplejson is not presented")
+        return
+    path_lib = temp.relpath("deploy_lib.so")
+    lib.export_library(path_lib, compression_level=compression_level)
+
+    def verify_load():
+        loaded_lib = tvm.runtime.load_module(path_lib)
+        assert loaded_lib.type_key == "library"
+        assert [m.type_key for m in loaded_lib.imported_modules] == ["examplejson"] * 4
+        assert loaded_lib.get_function("myadd", True) is not None
+
+    verify_load()
+    # The serial loading gives the same modules.
+    os.environ["TVM_NUM_MODULE_LOAD_THREADS"] = "1"
+    try:
+        verify_load()
+    finally:
+        del os.environ["TVM_NUM_MODULE_LOAD_THREADS"]
+
+
+def test_parallel_import_load():
+    verify_import_load(0)
+
+
+def test_compressed_import_load():
+    if tvm.support.libinfo().get("USE_ZSTD", "OFF") in ["OFF", "NOT-FOUND"]:
+        print("skip because zstd is not enabled...")
+        return
+    verify_import_load(3)
+
+
 if __name__ == "__main__":
     test_mod_export()
+    test_parallel_import_load()
+    test_compressed_import_load()
@@ -18,12 +18,14 @@ import numpy as np
 import pytest
 from io import StringIO
 import csv
+import json
 
 import tvm.testing
 from tvm.runtime import profiler_vm
 from tvm import relay
 from tvm.relay.testing import mlp
 from tvm.contrib.debugger import debug_executor
+from tvm.runtime import profiling
 
 
 @pytest.mark.skipif(not profiler_vm.enabled(), reason="VM Profiler not enabled")
@@ -61,3 +63,88 @@ def test_graph_executor(target, dev):
     assert "fused_nn_softmax" in str(report)
     assert "Total" in str(report)
     assert "Hash" in str(report)
+
+
+def test_perf_event_collector():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = gr.profile(data=data, collectors=[profiling.PerfEventCollector(["instructions"])])
+    assert "fused_nn_softmax" in str(report)
+    if "instructions" not in str(report):
+        pytest.skip("perf events are not available")
+    assert "instructions" in report.csv()
+
+
+@pytest.mark.skipif(not profiler_vm.enabled(), reason="VM Profiler not enabled")
+def test_vm_perf_event_collector():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.vm.compile(mod, "llvm", params=params)
+    vm = profiler_vm.VirtualMachineProfiler(exe, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    collector = profiling.PerfEventCollector(["instructions", "branch-misses"])
+    report = vm.profile(data, func_name="main", collectors=[collector])
+    assert "fused_nn_softmax" in str(report)
+
+
+def test_graph_executor_timeline():
+    mod, params = mlp.get_workload(1)
+
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = gr.profile(data=data, timeline=True)
+    trace = json.loads(report.chrome_trace())
+    slices = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert any(e["name"].startswith("fused_nn_softmax") for e in slices)
+    assert all(e["dur"] >= 0 for e in slices)
+    assert isinstance(report.perfetto(), bytes)
+
+    report = gr.profile(data=data)
+    assert json.loads(report.chrome_trace())["traceEvents"] == []
+
+
+def test_perf_event_collector_unknown_event():
+    with pytest.raises(tvm.TVMError):
+        profiling.PerfEventCollector(["not-an-event"])
+
+
+def _cpu_usage(category=None, executor=None):
+    usage = profiling.device_memory_usage().get("cpu(0)", {})
+    if category:
+        usage = usage.get("by_category", {}).get(category, {})
+    elif executor:
+        usage = usage.get("by_executor", {}).get(executor, {})
+    else:
+        usage = usage.get("total", {})
+    return usage.get("live_bytes", 0), usage.get("peak_bytes", 0)
+
+
+@tvm.testing.requires_llvm
+def test_device_memory_usage():
+    live, _ = _cpu_usage("ndarray")
+    arr = tvm.nd.empty((1024,), "float32")
+    assert _cpu_usage("ndarray")[0] == live + 4096
+    del arr
+    assert _cpu_usage("ndarray")[0] == live
+    assert _cpu_usage("ndarray")[1] >= live + 4096
+    profiling.reset_device_memory_peak()
+    assert _cpu_usage("ndarray")[1] == live
+
+    mod, params = mlp.get_workload(1)
+    exe = relay.build(mod, "llvm", params=params)
+    gr = debug_executor.create(exe.get_graph_json(), exe.lib, tvm.cpu())
+    assert _cpu_usage("activations")[0] > 0
+    assert _cpu_usage(executor="graph_executor")[0] > 0
+    data = np.random.rand(1, 1, 28, 28).astype("float32")
+    report = gr.profile(data=data)
+    assert "Memory Peak (B)" in str(report)
+
+if __name__ == "__main__":
+    pytest.main([__file__])
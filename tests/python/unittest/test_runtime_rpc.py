@@ -138,6 +138,35 @@ def test_rpc_large_array():
     np.testing.assert_equal(b.numpy(), b_np)
 
 
+@tvm.testing.requires_rpc
+def test_rpc_bulk_array():
+    # more than the copy packets in flight, with a partial last packet
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    dev = remote.cpu(0)
+    a_np = np.random.randint(0, 255, size=(27 << 20) + 7).astype("uint8")
+    a = tvm.nd.array(a_np, dev)
+    np.testing.assert_equal(a.numpy(), a_np)
+    b = tvm.nd.empty(a_np.shape, "uint8", dev)
+    a.copyto(b)
+    np.testing.assert_equal(b.numpy(), a_np)
+
+
+@tvm.testing.requires_rpc
+def test_rpc_shm_session():
+    if tvm.get_global_func("rpc.CreateShmClient", allow_missing=True) is None:
+        return
+    # small rings, the arrays wrap around them many times
+    remote = rpc.ShmSession(capacity=1 << 16)
+    fecho = remote.get_function("testing.echo")
+    assert fecho(100, 2, 3) == 100
+    assert fecho("xyz") == "xyz"
+    dev = remote.cpu(0)
+    a_np = np.random.randint(0, 255, size=(5 << 20) + 7).astype("uint8")
+    a = tvm.nd.array(a_np, dev)
+    np.testing.assert_equal(a.numpy(), a_np)
+
+
 @tvm.testing.requires_rpc
 def test_rpc_echo():
     def check(remote):
@@ -182,6 +211,40 @@ def test_rpc_echo():
     check_minrpc()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_call_async():
+    def check(remote):
+        faddone = remote.get_function("rpc.test.addone")
+        fexcept = remote.get_function("rpc.test.except")
+        futures = [remote.call_async(faddone, i) for i in range(100)]
+        ferror = remote.call_async(fexcept, "abc")
+        fstr = remote.call_async(remote.get_function("testing.echo"), "xyz")
+        # waiting for a later call receives the earlier returns
+        assert fstr.get() == "xyz"
+        assert [f.get() for f in futures] == list(range(1, 101))
+        with pytest.raises(tvm._ffi.base.TVMError):
+            ferror.get()
+        # a synchronous call receives the calls in flight first
+        future = remote.call_async(faddone, 1)
+        assert faddone(2) == 3
+        assert future.get() == 2
+        with pytest.raises(ValueError):
+            remote.call_async(lambda x: x, 1)
+
+    server = rpc.Server()
+    check(rpc.connect("127.0.0.1", server.port))
+    check(rpc.LocalSession())
+
+    if tvm.get_global_func("rpc.CreatePipeClient", allow_missing=True) is not None:
+        temp = utils.tempdir()
+        minrpc_exec = temp.relpath("minrpc")
+        tvm.rpc.with_minrpc(cc.create_executable)(minrpc_exec, [])
+        sess = rpc.PopenSession(minrpc_exec)
+        fecho = sess.get_function("testing.echo")
+        futures = [sess.call_async(fecho, i) for i in range(10)]
+        assert [f.get() for f in futures] == list(range(10))
+
+
 @tvm.testing.requires_rpc
 def test_rpc_file_exchange():
     server = rpc.Server()
@@ -469,6 +532,48 @@ def _target(host, port, device_key, timeout):
     remote.cpu()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_tracker_load_and_preempt():
+    tracker = Tracker(port=9000, port_end=10000)
+    device_key = "test_device"
+    server = rpc.Server(
+        port=9000,
+        port_end=10000,
+        key=device_key,
+        tracker_addr=("127.0.0.1", tracker.port),
+    )
+    client = rpc.connect_tracker("127.0.0.1", tracker.port)
+
+    def server_load():
+        (info,) = [x for x in client.summary()["server_info"] if x["key"].endswith(device_key)]
+        return info["addr"], info.get("load", {})
+
+    remote = client.request(device_key)
+    del remote
+    time.sleep(1)
+    addr, load = server_load()
+    assert load["sessions"] == 1 and load["failures"] == 0
+
+    # a stuck session is killed on request, and counts as a failure
+    proc = multiprocessing.Process(
+        target=_target, args=("127.0.0.1", tracker.port, device_key, 200)
+    )
+    proc.start()
+    time.sleep(1)
+    assert client.summary()["queue_info"][device_key]["busy"] == 1
+    assert client.preempt(addr)
+    assert not client.preempt(("no_such_server", 0))
+    time.sleep(4)
+    _, load = server_load()
+    assert load["sessions"] == 2 and load["failures"] == 1
+    assert client.summary()["queue_info"][device_key]["free"] == 1
+
+    proc.terminate()
+    proc.join()
+    server.terminate()
+    tracker.terminate()
+
+
 @tvm.testing.requires_rpc
 def test_rpc_tracker_request():
     # test concurrent request
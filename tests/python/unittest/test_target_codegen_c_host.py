@@ -227,6 +227,36 @@ def test_call_packed():
     check_global_packed_func()
 
 
+def test_vector_restrict_align():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.placeholder((n,), name="B")
+    C = te.compute(A.shape, lambda i: A[i] * B[i] + 1.0, name="C")
+    s = te.create_schedule(C.op)
+    _, xi = s[C].split(C.op.axis[0], factor=4)
+    s[C].vectorize(xi)
+
+    mhost = tvm.build(s, [A, B, C], "c -includes=stdint.h", name="test_fmuladd")
+    src = mhost.get_source()
+    assert "#include <stdint.h>" in src
+    # the vector types are GNU vector extensions
+    assert "typedef float float4 __attribute__((vector_size(16), aligned(4)));" in src
+    # the buffer data are typed, do not alias and are aligned
+    assert "float* TVM_RESTRICT C = (float*)" in src
+    assert "C = (float*)TVM_ASSUME_ALIGNED(C, 64);" in src
+
+    temp = utils.tempdir()
+    path_dso = temp.relpath("temp.so")
+    mhost.export_library(path_dso)
+    m = tvm.runtime.load_module(path_dso)
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+    b = tvm.nd.array(np.random.uniform(size=n).astype(B.dtype), dev)
+    c = tvm.nd.array(np.zeros(n, dtype=C.dtype), dev)
+    m["test_fmuladd"](a, b, c)
+    tvm.testing.assert_allclose(c.numpy(), a.numpy() * b.numpy() + 1.0, rtol=1e-6)
+
+
 if __name__ == "__main__":
     test_add()
     test_add_pipeline()
@@ -235,3 +265,4 @@ if __name__ == "__main__":
     test_floor()
     test_round()
     test_call_packed()
+    test_vector_restrict_align()
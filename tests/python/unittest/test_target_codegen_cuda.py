@@ -995,6 +995,164 @@ def test_unrolled_vectorization():
     tvm.testing.assert_allclose(c_np, N * np.ones((N, N)))
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_ptx_mma_sp():
+    def ptx_mma_sp_ir(a, b, meta, c):
+        ib = tvm.tir.ir_builder.create()
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(tx, "thread_extent", 32)
+        ap, bp, ep, cp = [ib.buffer_ptr(buf) for buf in (a, b, meta, c)]
+        A = ib.allocate("float16", 4, name="A", scope="local")
+        B = ib.allocate("float16", 4, name="B", scope="local")
+        C = ib.allocate("float32", 4, name="C", scope="local")
+        E = ib.allocate("uint32", 1, name="E", scope="local")
+        for i in range(4):
+            A[i] = ap[tx, i]
+            B[i] = bp[tx, i]
+            C[i] = tvm.tir.const(0, "float32")
+        E[0] = ep[tx]
+        ib.emit(
+            tvm.tir.call_intrin(
+                "handle",
+                "tir.ptx_mma_sp",
+                "m16n8k16",
+                "row",
+                "col",
+                "fp16",
+                "fp16",
+                "fp32",
+                A.asobject(),
+                0,
+                B.asobject(),
+                0,
+                C.asobject(),
+                0,
+                E.asobject(),
+                0,
+                0,
+            )
+        )
+        for i in range(4):
+            cp[tx, i] = C[i]
+        return ib.get()
+
+    a = te.placeholder((32, 4), name="a", dtype="float16")
+    b = te.placeholder((32, 4), name="b", dtype="float16")
+    meta = te.placeholder((32,), name="meta", dtype="uint32")
+    c = te.extern(
+        (32, 4), [a, b, meta], lambda ins, outs: ptx_mma_sp_ir(*ins, outs[0]), dtype="float32"
+    )
+    s = te.create_schedule(c.op)
+    mod = tvm.build(s, [a, b, meta, c], "cuda -arch=sm_80")
+    source = mod.imported_modules[0].get_source()
+    assert "mma.sp.sync.aligned.m16n8k16.row.col.f32.f16.f16.f32" in source
+
+    dev = tvm.cuda(0)
+    if float(dev.compute_version) < 8.0:
+        print("skip running ptx_mma_sp, the sparse tensor cores need sm_80")
+        return
+    # Every group of four keeps its columns 0 and 1, the metadata of each row is 0x4444.
+    lanes = np.arange(32)
+    group, tig = lanes // 4, lanes % 4
+    a_full = np.zeros((16, 16), dtype="float16")
+    a_full[:, np.arange(16) % 4 < 2] = np.random.uniform(-1, 1, (16, 8))
+    a_comp = a_full[:, np.arange(16) % 4 < 2]
+    b_np = np.random.uniform(-1, 1, (16, 8)).astype("float16")
+    cols = tig[:, None] * 2 + np.array([0, 1, 0, 1])
+    rows = group[:, None] + np.array([0, 0, 8, 8])
+    ks = tig[:, None] * 2 + np.array([0, 1, 8, 9])
+    a_frag = a_comp[rows, cols]
+    b_frag = b_np[ks, group[:, None]]
+    meta_np = np.full((32,), 0x44444444, dtype="uint32")
+    c_tvm = tvm.nd.empty((32, 4), "float32", dev)
+    mod(tvm.nd.array(a_frag, dev), tvm.nd.array(b_frag, dev), tvm.nd.array(meta_np, dev), c_tvm)
+    expected = np.dot(a_full.astype("float32"), b_np.astype("float32"))[rows, cols]
+    tvm.testing.assert_allclose(c_tvm.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_cuda_ptx_ldmatrix_mma():
+    def ldmatrix_mma_ir(a, b, c):
+        ib = tvm.tir.ir_builder.create()
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(tx, "thread_extent", 32)
+        ap, bp, cp = [ib.buffer_ptr(buf) for buf in (a, b, c)]
+        AS = ib.allocate("float16", 256, name="AS", scope="shared")
+        A = ib.allocate("float16", 8, name="A", scope="local")
+        B = ib.allocate("float16", 4, name="B", scope="local")
+        C = ib.allocate("float32", 4, name="C", scope="local")
+        for i in range(8):
+            AS[tx * 8 + i] = ap[tx * 8 + i]
+        ib.emit(tvm.tir.call_intrin("int32", "tir.tvm_storage_sync", "shared"))
+        # Lane l gives the row l % 16 of the columns (l // 16) * 8 of the 16x16 tile of A.
+        ib.emit(
+            tvm.tir.call_intrin(
+                "handle",
+                "tir.ptx_ldmatrix",
+                False,
+                4,
+                A.asobject(),
+                0,
+                AS.asobject(),
+                tvm.tir.indexmod(tx, 16) * 16 + tvm.tir.indexdiv(tx, 16) * 8,
+            )
+        )
+        for i in range(4):
+            B[i] = bp[tx, i]
+            C[i] = tvm.tir.const(0, "float32")
+        ib.emit(
+            tvm.tir.call_intrin(
+                "handle",
+                "tir.ptx_mma",
+                "m16n8k16",
+                "row",
+                "col",
+                "fp16",
+                "fp16",
+                "fp32",
+                A.asobject(),
+                0,
+                B.asobject(),
+                0,
+                C.asobject(),
+                0,
+            )
+        )
+        for i in range(4):
+            cp[tx, i] = C[i]
+        return ib.get()
+
+    a = te.placeholder((256,), name="a", dtype="float16")
+    b = te.placeholder((32, 4), name="b", dtype="float16")
+    c = te.extern(
+        (32, 4), [a, b], lambda ins, outs: ldmatrix_mma_ir(*ins, outs[0]), dtype="float32"
+    )
+    s = te.create_schedule(c.op)
+    mod = tvm.build(s, [a, b, c], "cuda -arch=sm_80")
+    source = mod.imported_modules[0].get_source()
+    assert "ldmatrix.sync.aligned.m8n8.x4.shared.b16" in source
+    assert "mma.sync.aligned.m16n8k16.row.col.f32.f16.f16.f32" in source
+
+    dev = tvm.cuda(0)
+    if float(dev.compute_version) < 8.0:
+        print("skip running ptx_mma, m16n8k16 needs sm_80")
+        return
+    lanes = np.arange(32)
+    group, tig = lanes // 4, lanes % 4
+    a_np = np.random.uniform(-1, 1, (16, 16)).astype("float16")
+    b_np = np.random.uniform(-1, 1, (16, 8)).astype("float16")
+    ks = tig[:, None] * 2 + np.array([0, 1, 8, 9])
+    b_frag = b_np[ks, group[:, None]]
+    c_tvm = tvm.nd.empty((32, 4), "float32", dev)
+    mod(tvm.nd.array(a_np.reshape(256), dev), tvm.nd.array(b_frag, dev), c_tvm)
+    rows = group[:, None] + np.array([0, 0, 8, 8])
+    cols = tig[:, None] * 2 + np.array([0, 1, 0, 1])
+    expected = np.dot(a_np.astype("float32"), b_np.astype("float32"))[rows, cols]
+    tvm.testing.assert_allclose(c_tvm.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
 if __name__ == "__main__":
     test_cuda_vectorize_add()
     test_cuda_bf16_vectorize_add()
@@ -1021,3 +1179,5 @@ if __name__ == "__main__":
     test_vectorized_cooperative_fetching_x()
     test_vectorized_cooperative_fetching_xy()
     test_unrolled_vectorization()
+    test_cuda_ptx_mma_sp()
+    test_cuda_ptx_ldmatrix_mma()
@@ -107,7 +107,57 @@ def test_alloc_vtcm():
     assert "HexagonBackendFreeVTCM" in calls
 
 
+def test_tensorize_vrmpy():
+    if not check_prereq_and_setup():
+        return
+    target = tvm.target.hexagon("v66", hvx=128)
+
+    N, K = 64, 16
+    A = tvm.te.placeholder((K,), name="A", dtype="uint8")
+    W = tvm.te.placeholder((N // 32, K // 4, 32, 4), name="W", dtype="int8")
+    k = tvm.te.reduce_axis((0, K), name="k")
+    C = tvm.te.compute(
+        (N,),
+        lambda i: tvm.te.sum(
+            A[k].astype("int32") * W[i // 32, k // 4, i % 32, k % 4].astype("int32"), axis=k
+        ),
+        name="C",
+    )
+    s = tvm.te.create_schedule(C.op)
+    io, ii = s[C].split(C.op.axis[0], factor=32)
+    ko, ki = s[C].split(C.op.reduce_axis[0], factor=4)
+    s[C].reorder(io, ko, ii, ki)
+    s[C].tensorize(ii, tvm.topi.hexagon.dot_32x1x4_uint8_int8_int32_hvx())
+
+    m = tvm.build(s, [A, W, C], target=tvm.target.Target(target, target), name="dot_vrmpy")
+    asm = m.get_source("s")
+    assert re.findall(r"vrmpy\(", asm)
+
+
+def test_alloc_vtcm_bytes():
+    if not check_prereq_and_setup():
+        return
+    target = tvm.target.hexagon("v66")
+
+    buf_len = 512
+    A = tvm.te.placeholder((buf_len,), name="A", dtype="int32")
+    A_buf = tvm.te.compute((buf_len,), lambda *i: A(*i), "A_buf")
+    C = tvm.te.compute((buf_len,), lambda *i: A_buf(*i) + 1, name="C")
+    s = tvm.te.create_schedule(C.op)
+    s[A_buf].set_scope("local.vtcm")
+
+    config = {"tir.add_lower_pass": hexagon.ir_lower_vtcm_pass()}
+    with tvm.transform.PassContext(config=config):
+        irmod = tvm.lower(s, [A, C], name="alloc_vtcm_bytes")
+
+    # The VTCM allocations are sized in bytes.
+    sizes = re.findall(r'"HexagonBackendAllocateVTCM", ([0-9]+)', str(irmod["alloc_vtcm_bytes"]))
+    assert sizes == [str(buf_len * 4)]
+
+
 if __name__ == "__main__":
     test_basic()
     test_llvm_target_features()
     test_alloc_vtcm()
+    test_tensorize_vrmpy()
+    test_alloc_vtcm_bytes()
@@ -818,5 +818,128 @@ def test_llvm_gpu_lower_atomic():
         tvm.testing.assert_allclose(a.numpy(), ref, rtol=1e-5)
 
 
+@tvm.testing.requires_llvm
+def test_llvm_pgo():
+    if tvm.target.codegen.llvm_version_major() < 9:
+        return
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: tvm.tir.if_then_else(A[i] > 0, A[i] * 2, A[i] - 1), name="B")
+    s = te.create_schedule(B.op)
+
+    a_np = np.random.uniform(-1, 1, size=n).astype(A.dtype)
+    ref = np.where(a_np > 0, a_np * 2, a_np - 1)
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+
+    with tvm.transform.PassContext(config={"tir.llvm_pgo_instrument": True}):
+        f = tvm.build(s, [A, B], "llvm")
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), ref)
+
+    temp = utils.tempdir()
+    profile = temp.relpath("kernel.profdata")
+    tvm.target.codegen.llvm_write_pgo_profile(f, profile)
+
+    with tvm.transform.PassContext(config={"tir.llvm_pgo_profile": profile}):
+        f = tvm.build(s, [A, B], "llvm")
+    assert "function_entry_count" in f.get_source()
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), ref)
+
+
+@tvm.testing.requires_llvm
+def test_llvm_pipeline_options():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2 + 1, name="B")
+    s = te.create_schedule(B.op)
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    dev = tvm.cpu(0)
+
+    for options in [
+        "-opt-level=0",
+        "-opt-level=2 -loop-vectorize=0 -slp-vectorize=0 -loop-unroll=0",
+        "-vectorize-width=4 -interleave-count=2 -unroll-count=2",
+        "-loop-interchange=1",
+    ]:
+        f = tvm.build(s, [A, B], "llvm " + options)
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np * 2 + 1)
+
+    with pytest.raises(tvm.TVMError):
+        tvm.build(s, [A, B], "llvm -opt-level=4")
+
+
+@tvm.testing.requires_llvm
+def test_llvm_orc_jit():
+    if tvm.target.codegen.llvm_version_major() < 13:
+        return
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2 + 1, name="B")
+    C = te.compute((n,), lambda i: A[i] * A[i], name="C")
+    s = te.create_schedule([B.op, C.op])
+    s[B].parallel(B.op.axis[0])
+    mod = tvm.lower(s, [A, B], name="scale")
+    mod.update(tvm.lower(s, [A, C], name="square"))
+
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    dev = tvm.cpu(0)
+    # Modules of the same target share a JIT session but define the same symbols.
+    for _ in range(2):
+        f = tvm.build(mod, target="llvm -jit=orc")
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        c = tvm.nd.array(np.zeros(n, dtype=C.dtype), dev)
+        f["square"](a, c)
+        f["scale"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np * 2 + 1)
+        tvm.testing.assert_allclose(c.numpy(), a_np * a_np)
+
+    with pytest.raises(tvm.TVMError):
+        tvm.build(mod, target="llvm -jit=interp")["scale"]
+
+
+@tvm.testing.requires_llvm
+def test_llvm_compile_units():
+    n = 1024
+    A = te.placeholder((n,), name="A")
+    mod = tvm.IRModule()
+    for i in range(4):
+        B = te.compute((n,), lambda j: A[j] * (i + 2) + 1, name="B")
+        s = te.create_schedule(B.op)
+        s[B].parallel(B.op.axis[0])
+        mod.update(tvm.lower(s, [A, B], name="scale%d" % i))
+
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    dev = tvm.cpu(0)
+    temp = utils.tempdir()
+
+    def check(f, num_files):
+        assert len(f.get_function("save_compile_units")(temp.relpath("lib.o"))) == num_files
+        path = temp.relpath("lib%d.so" % num_files)
+        f.export_library(path)
+        for m in [f, tvm.runtime.load_module(path)]:
+            for i in range(4):
+                a = tvm.nd.array(a_np, dev)
+                b = tvm.nd.array(np.zeros(n, dtype=A.dtype), dev)
+                m["scale%d" % i](a, b)
+                tvm.testing.assert_allclose(b.numpy(), a_np * (i + 2) + 1, rtol=1e-6)
+
+    with tvm.transform.PassContext(config={"tir.llvm_num_compile_units": 3}):
+        f = tvm.build(mod, target="llvm")
+    check(f, 3)
+    # the small functions are kept together, in one unit
+    config = {"tir.llvm_num_compile_units": 3, "tir.llvm_min_compile_unit_size": 1 << 20}
+    with tvm.transform.PassContext(config=config):
+        f = tvm.build(mod, target="llvm")
+    check(f, 0)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -130,9 +130,52 @@ def test_rocm_vectorize_add():
     check_rocm("float16", 64, 2)
 
 
+def test_mfma_fragment_layout():
+    from tvm.topi.rocm import tensor_intrin
+
+    for _, shape in tensor_intrin.MFMA_INTRINSICS:
+        m, n, k = shape
+        a_elems, b_elems, c_elems = tensor_intrin.mfma_num_elems(shape)
+        lanes = range(tensor_intrin.WAVEFRONT_SIZE)
+        a = sorted(tensor_intrin.mfma_a_index(l, i, shape) for l in lanes for i in range(a_elems))
+        b = sorted(tensor_intrin.mfma_b_index(l, i, shape) for l in lanes for i in range(b_elems))
+        c = sorted(tensor_intrin.mfma_c_index(l, j, shape) for l in lanes for j in range(c_elems))
+        # Each element of the tiles is held by one lane.
+        assert a == [(r, i) for r in range(m) for i in range(k)]
+        assert b == [(i, col) for i in range(k) for col in range(n)]
+        assert c == [(r, col) for r in range(m) for col in range(n)]
+
+
+@tvm.testing.requires_rocm
+def test_rocm_dense_mfma():
+    batch, in_dim, out_dim = 64, 128, 96
+    target = tvm.target.Target("rocm -mcpu=gfx908")
+    data = te.placeholder((batch, in_dim), name="data", dtype="float16")
+    weight = te.placeholder((out_dim, in_dim), name="weight", dtype="float16")
+    with target:
+        assert tvm.topi.rocm.can_use_mfma(data, weight, "float32", target)
+        out = tvm.topi.rocm.dense_mfma(data, weight, None, "float32")
+        s = tvm.topi.rocm.schedule_dense_mfma([out])
+    func = tvm.build(s, [data, weight, out], target)
+    assert "llvm.amdgcn.mfma.f32.32x32x8f16" in func.imported_modules[0].get_source("llvm")
+
+    dev = tvm.rocm(0)
+    if dev.compute_version.replace(".", "") not in ["908", "90a", "940", "941", "942"]:
+        print("skip running dense_mfma, the GPU has no matrix cores")
+        return
+    a_np = np.random.uniform(-1, 1, (batch, in_dim)).astype("float16")
+    w_np = np.random.uniform(-1, 1, (out_dim, in_dim)).astype("float16")
+    c = tvm.nd.empty((batch, out_dim), "float32", dev)
+    func(tvm.nd.array(a_np, dev), tvm.nd.array(w_np, dev), c)
+    expected = np.dot(a_np.astype("float32"), w_np.astype("float32").T)
+    tvm.testing.assert_allclose(c.numpy(), expected, rtol=1e-2, atol=1e-2)
+
+
 if __name__ == "__main__":
     test_rocm_cross_thread_reduction()
     test_rocm_inf_nan()
     test_rocm_reduction_binding()
     test_rocm_copy()
     test_rocm_vectorize_add()
+    test_mfma_fragment_layout()
+    test_rocm_dense_mfma()
@@ -122,7 +122,49 @@ def test_vm_parallel():
     run_jit(mod, check)
 
 
+def test_stack_vm_superinstructions():
+    calls = []
+
+    @tvm.register_func("tvm_stack_vm_record", override=True)
+    def record(i, shape0):
+        calls.append((i, shape0))
+
+    dtype = "int64"
+    n = te.size_var("n")
+    Ab = tvm.tir.decl_buffer((n,), dtype)
+    ib = tvm.tir.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n - 1, "i") as i:
+        A[i + 1] = A[i] + 1
+        ib.emit(tvm.tir.call_packed("tvm_stack_vm_record", i, Ab.shape[0]))
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([Ab], ib.get()).with_attr("global_symbol", "f"))
+
+    set_threaded = tvm.get_global_func("runtime.StackVMSetThreadedDispatch")
+    sources = []
+    try:
+        for superinstructions, threaded in [(False, False), (True, False), (True, True)]:
+            config = {"tir.stackvm_superinstructions": superinstructions}
+            with tvm.transform.PassContext(config=config):
+                f = tvm.driver.build(mod, target="stackvm")
+            set_threaded(threaded)
+            a = tvm.nd.array(np.zeros(10, dtype=dtype))
+            del calls[:]
+            f(a)
+            np.testing.assert_equal(a.numpy(), np.arange(10))
+            assert calls == [(i, 10) for i in range(9)]
+            sources.append(f.get_source())
+    finally:
+        set_threaded(True)
+
+    assert "HEAP_" not in sources[0]
+    # the argument unpacking and the packed call setup read their handles from the heap
+    for opcode in ["HEAP_STRUCT_GET", "HEAP_STRUCT_SET", "HEAP_ARRAY_STORE_IMM_INT32"]:
+        assert opcode in sources[1]
+    assert "HEAP_CALL_PACKED_FUNC" in sources[1]
+    assert len(sources[1].splitlines()) < len(sources[0].splitlines())
+
 if __name__ == "__main__":
+    test_stack_vm_superinstructions()
     test_vm_parallel()
     test_stack_vm_loop()
     test_stack_vm_basic()
@@ -433,5 +433,27 @@ def test_vulkan_local_threadidx(target, dev):
     tvm.testing.assert_allclose(b.numpy(), a_np)
 
 
+@tvm.testing.requires_vulkan
+def test_vulkan_suballocation():
+    dev = tvm.vulkan(0)
+    stats = tvm.get_global_func("device_api.vulkan.memory_stats")
+    used_bytes = stats(dev, "used_bytes")
+    num_blocks = stats(dev, "num_blocks")
+    arrays = [tvm.nd.array(np.full((256,), i, "float32"), dev) for i in range(1000)]
+    if stats(dev, "num_blocks") == 0:
+        pytest.skip("The buffers do not use sub-allocated memory")
+    # The small arrays share a few blocks of device memory.
+    assert stats(dev, "num_blocks") - num_blocks < 10
+    for i in range(0, len(arrays), 2):
+        arrays[i] = None
+    arrays = [arr for arr in arrays if arr is not None]
+    for i, arr in enumerate(arrays):
+        tvm.testing.assert_allclose(arr.numpy(), np.full((256,), 2 * i + 1, "float32"))
+
+    arrays = None
+    tvm.get_global_func("device_api.vulkan.release_unused_memory")(dev)
+    assert stats(dev, "used_bytes") == used_bytes
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(sys.argv))
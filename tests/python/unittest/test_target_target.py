@@ -149,6 +149,15 @@ def test_target_tag_1():
     assert tgt.attrs["registers_per_block"] == 32768
 
 
+def test_target_tag_wasm():
+    tgt = tvm.target.Target("webassembly/simd128")
+    assert tgt.kind.name == "llvm"
+    assert tgt.attrs["mtriple"] == "wasm32-unknown-unknown-wasm"
+    assert list(tgt.attrs["mattr"]) == ["+simd128"]
+    tgt = tvm.target.Target("webassembly/simd128-threads")
+    assert list(tgt.attrs["mattr"]) == ["+simd128", "+atomics", "+bulk-memory"]
+
+
 def test_list_kinds():
     targets = tvm.target.Target.list_kinds()
     assert len(targets) != 0
@@ -334,6 +334,29 @@ def test_stride_dilation():
     check_grad(Y, [X])
 
 
+def test_direct_gradient():
+    np.random.seed(0)
+    A = te.placeholder((4, 5), name="A")
+    B = te.placeholder((6, 5), name="B")
+    k = te.reduce_axis((0, 5), name="k")
+    C = te.compute((4, 6), lambda i, j: te.sum(A[i, k] * B[j, k], axis=k), name="C")
+    dA, dB = te.gradient(C, [A, B], head=topi.full_like(C, 1.0))
+    # the gradients sum the head over the axes the inputs are not read at
+    assert [int(iv.dom.extent) for iv in dA.op.body[0].axis] == [6]
+    assert [int(iv.dom.extent) for iv in dB.op.body[0].axis] == [4]
+    check_grad(C, [A, B])
+
+    # shifted reads are transposed under the range of the output axis
+    X = te.placeholder((10,), name="X")
+    E = te.compute((8,), lambda i: X[i + 2] * X[i + 2], name="E")
+    check_grad(E, X)
+
+    X = te.placeholder((1, 2, 10, 10), name="X")
+    W = te.placeholder((2, 2, 3, 3), name="W")
+    Y = topi.nn.conv2d(X, W, 1, 0, 1)
+    check_grad(Y, [X, W])
+
+
 @pytest.mark.xfail
 def test_reduction_init():
     np.random.seed(0)
@@ -349,3 +372,4 @@ if __name__ == "__main__":
     test_basic_operation()
     test_topi()
     test_stride_dilation()
+    test_direct_gradient()
@@ -0,0 +1,141 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_cache_read(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    B_local = tir.alloc_buffer((128, 128), scope="local")
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    for ax0, ax1 in tir.grid(128, 128):
+        with tir.block([128, 128], "B_local") as [v0, v1]:
+            tir.bind(v0, ax0)
+            tir.bind(v1, ax1)
+            B_local[v0, v1] = B[v0, v1]
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B_local[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_cache_write(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    B_local = tir.alloc_buffer((128, 128), scope="local")
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B_local[vi, vj] = A[vi, vj] * 2.0
+    for ax0, ax1 in tir.grid(128, 128):
+        with tir.block([128, 128], "B_local") as [v0, v1]:
+            tir.bind(v0, ax0)
+            tir.bind(v1, ax1)
+            B[v0, v1] = B_local[v0, v1]
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_partial_read(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    C = tir.match_buffer(c, (64, 128))
+    with tir.block([64, 128], "C") as [vi, vj]:
+        C[vi, vj] = A[vi + 32, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_multi_writer(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    with tir.block([128, 128], "B0") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    with tir.block([128, 128], "B1") as [vi, vj]:
+        B[vi, vj] = B[vi, vj] * 2.0
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vi, vj] + 1.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def test_cache_read():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    block_c = sch.get_block("C")
+    cached = sch.cache_read(block_c, 0, "local")
+    assert sch.get(cached).name_hint == "B_local"
+    tvm.ir.assert_structural_equal(elementwise_cache_read, sch.mod["main"])
+
+
+def test_cache_write():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    block_b = sch.get_block("B")
+    cached = sch.cache_write(block_b, 0, "local")
+    assert sch.get(cached).name_hint == "B_local"
+    tvm.ir.assert_structural_equal(elementwise_cache_write, sch.mod["main"])
+
+
+def test_cache_read_partial_region():
+    sch = tir.Schedule(elementwise_partial_read, debug_mode=True)
+    block_c = sch.get_block("C")
+    cached = sch.cache_read(block_c, 0, "shared")
+    # only the rows the consumer reads are cached
+    ax0, ax1 = sch.get_loops(cached)
+    assert sch.get(ax0).extent == 64
+    assert sch.get(ax1).extent == 128
+    assert sch.get(cached).iter_vars[0].dom.min == 32
+
+
+def test_cache_read_fail_index_out_of_bound():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    block_c = sch.get_block("C")
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.cache_read(block_c, 1, "local")
+
+
+def test_cache_write_fail_multi_writer():
+    sch = tir.Schedule(elementwise_multi_writer, debug_mode=True)
+    block_b = sch.get_block("B0")
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.cache_write(block_b, 0, "local")
+
+
+if __name__ == "__main__":
+    test_cache_read()
+    test_cache_write()
+    test_cache_read_partial_region()
+    test_cache_read_fail_index_out_of_bound()
+    test_cache_write_fail_multi_writer()
@@ -0,0 +1,154 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_compute_at(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    for i in tir.serial(0, 128):
+        for ax0 in tir.serial(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, ax0)
+                B[vi, vj] = A[vi, vj] * 2.0
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "C") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                C[vi, vj] = B[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_reverse_compute_at(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    for i in tir.serial(0, 128):
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+        for ax0 in tir.serial(0, 128):
+            with tir.block([128, 128], "C") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, ax0)
+                C[vi, vj] = B[vi, vj] + 1.0
+
+
+@tvm.script.tir
+def elementwise_multi_consumer(a: ty.handle, c: ty.handle, d: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    D = tir.match_buffer(d, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vi, vj] + 1.0
+    with tir.block([128, 128], "D") as [vi, vj]:
+        D[vi, vj] = B[vi, vj] + 2.0
+
+
+@tvm.script.tir
+def transpose_consumer(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+    with tir.block([128, 128], "C") as [vi, vj]:
+        C[vi, vj] = B[vj, vi] + B[vi, vj]
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def test_compute_at():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("C"))
+    sch.compute_at(sch.get_block("B"), i)
+    tvm.ir.assert_structural_equal(elementwise_compute_at, sch.mod["main"])
+
+
+def test_compute_at_tiled():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    block_b = sch.get_block("B")
+    i, _ = sch.get_loops(sch.get_block("C"))
+    i_outer, _ = sch.split(i, factors=[8, 16])
+    sch.compute_at(block_b, i_outer)
+    # the producer computes the 16 rows a tile of the consumer reads
+    loops = sch.get_loops(block_b)
+    assert [sch.get(loop).extent for loop in loops] == [8, 16, 128]
+
+
+def test_reverse_compute_at():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.reverse_compute_at(sch.get_block("C"), i)
+    tvm.ir.assert_structural_equal(elementwise_reverse_compute_at, sch.mod["main"])
+
+
+def test_compute_at_fail_consumer_not_under_loop():
+    sch = tir.Schedule(elementwise_multi_consumer, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("C"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.compute_at(sch.get_block("B"), i)
+
+
+def test_compute_at_fail_loop_is_ancestor():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    block_b = sch.get_block("B")
+    i, _ = sch.get_loops(block_b)
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.compute_at(block_b, i)
+
+
+def test_reverse_compute_at_fail_not_pure_index():
+    sch = tir.Schedule(transpose_consumer, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.reverse_compute_at(sch.get_block("C"), i)
+
+
+if __name__ == "__main__":
+    test_compute_at()
+    test_compute_at_tiled()
+    test_reverse_compute_at()
+    test_compute_at_fail_consumer_not_under_loop()
+    test_compute_at_fail_loop_is_ancestor()
+    test_reverse_compute_at_fail_not_pure_index()
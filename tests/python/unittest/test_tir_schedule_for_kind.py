@@ -0,0 +1,144 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_parallelized(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i in tir.parallel(0, 128):
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_vectorized(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i in tir.serial(0, 128):
+        for j in tir.vectorized(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_bound(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i in tir.thread_binding(0, 128, thread="blockIdx.x"):
+        for j in tir.thread_binding(0, 128, thread="threadIdx.x"):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_unrolled(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i in tir.unroll(0, 128):
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def rowsum(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128,))
+    with tir.block([128, tir.reduce_axis(0, 128)], "B") as [vi, vk]:
+        with tir.init():
+            B[vi] = 0.0
+        B[vi] = B[vi] + A[vi, vk]
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def test_parallel():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.parallel(i)
+    tvm.ir.assert_structural_equal(elementwise_parallelized, sch.mod["main"])
+
+
+def test_vectorize():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    _, j = sch.get_loops(sch.get_block("B"))
+    sch.vectorize(j)
+    tvm.ir.assert_structural_equal(elementwise_vectorized, sch.mod["main"])
+
+
+def test_bind():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.bind(i, "blockIdx.x")
+    sch.bind(j, "threadIdx.x")
+    tvm.ir.assert_structural_equal(elementwise_bound, sch.mod["main"])
+
+
+def test_unroll():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.unroll(i)
+    tvm.ir.assert_structural_equal(elementwise_unrolled, sch.mod["main"])
+
+
+def test_parallel_fail_on_reduction_loop():
+    sch = tir.Schedule(rowsum, debug_mode=True)
+    _, k = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.parallel(k)
+
+
+def test_bind_fail_on_reduction_loop():
+    sch = tir.Schedule(rowsum, debug_mode=True)
+    _, k = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.bind(k, "threadIdx.x")
+
+
+if __name__ == "__main__":
+    test_parallel()
+    test_vectorize()
+    test_bind()
+    test_unroll()
+    test_parallel_fail_on_reduction_loop()
+    test_bind_fail_on_reduction_loop()
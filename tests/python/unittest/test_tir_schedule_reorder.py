@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128, 128))
+    B = tir.match_buffer(b, (128, 128, 128))
+    with tir.block([128, 128, 128], "B") as [vi, vj, vk]:
+        B[vi, vj, vk] = A[vi, vj, vk] * 2.0
+
+
+@tvm.script.tir
+def elementwise_reordered(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128, 128))
+    B = tir.match_buffer(b, (128, 128, 128))
+    for k, j, i in tir.grid(128, 128, 128):
+        with tir.block([128, 128, 128], "B") as [vi, vj, vk]:
+            tir.bind(vi, i)
+            tir.bind(vj, j)
+            tir.bind(vk, k)
+            B[vi, vj, vk] = A[vi, vj, vk] * 2.0
+
+
+@tvm.script.tir
+def elementwise_non_single_branch(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128, 128))
+    C = tir.alloc_buffer((128, 128, 128))
+    B = tir.match_buffer(b, (128, 128, 128))
+    for i, j in tir.grid(128, 128):
+        for k in tir.serial(0, 128):
+            with tir.block([128, 128, 128], "C") as [vi, vj, vk]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                tir.bind(vk, k)
+                C[vi, vj, vk] = A[vi, vj, vk] * 2.0
+        for k in tir.serial(0, 128):
+            with tir.block([128, 128, 128], "B") as [vi, vj, vk]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                tir.bind(vk, k)
+                B[vi, vj, vk] = C[vi, vj, vk] * 2.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def test_reorder():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j, k = sch.get_loops(sch.get_block("B"))
+    sch.reorder(k, i)
+    tvm.ir.assert_structural_equal(elementwise_reordered, sch.mod["main"])
+
+
+def test_reorder_full_permutation():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j, k = sch.get_loops(sch.get_block("B"))
+    sch.reorder(k, j, i)
+    tvm.ir.assert_structural_equal(elementwise_reordered, sch.mod["main"])
+
+
+def test_reorder_fail_with_duplicated_loops():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j, k = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.reorder(k, i, i)
+
+
+def test_reorder_fail_not_a_chain():
+    sch = tir.Schedule(elementwise_non_single_branch, debug_mode=True)
+    i, j, k_c = sch.get_loops(sch.get_block("C"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.reorder(k_c, i)
+
+
+if __name__ == "__main__":
+    test_reorder()
+    test_reorder_full_permutation()
+    test_reorder_fail_with_duplicated_loops()
+    test_reorder_fail_not_a_chain()
@@ -0,0 +1,157 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import pytest
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_split(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i0, i1, j in tir.grid(2, 64, 128):
+        with tir.block([128, 128], "B") as [vi, vj]:
+            tir.bind(vi, i0 * 64 + i1)
+            tir.bind(vj, j)
+            B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_split_with_predicate(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for i0, i1, j in tir.grid(13, 10, 128):
+        with tir.block([128, 128], "B") as [vi, vj]:
+            tir.where(i0 * 10 + i1 < 128)
+            tir.bind(vi, i0 * 10 + i1)
+            tir.bind(vj, j)
+            B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_fused(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    for fused in tir.serial(0, 16384):
+        with tir.block([128, 128], "B") as [vi, vj]:
+            tir.bind(vi, tir.floordiv(fused, 128))
+            tir.bind(vj, tir.floormod(fused, 128))
+            B[vi, vj] = A[vi, vj] * 2.0
+
+
+@tvm.script.tir
+def elementwise_with_seq(a: ty.handle, c: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.alloc_buffer((128, 128))
+    C = tir.match_buffer(c, (128, 128))
+    for i in tir.serial(0, 128):
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "B") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                B[vi, vj] = A[vi, vj] * 2.0
+        for j in tir.serial(0, 128):
+            with tir.block([128, 128], "C") as [vi, vj]:
+                tir.bind(vi, i)
+                tir.bind(vj, j)
+                C[vi, vj] = B[vi, vj] * 2.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def test_split():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.split(i, factors=[2, 64])
+    tvm.ir.assert_structural_equal(elementwise_split, sch.mod["main"])
+
+
+def test_split_with_inferred_factor():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.split(i, factors=[None, 64])
+    tvm.ir.assert_structural_equal(elementwise_split, sch.mod["main"])
+
+
+def test_split_with_predicate():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    sch.split(i, factors=[None, 10])
+    tvm.ir.assert_structural_equal(elementwise_split_with_predicate, sch.mod["main"])
+
+
+def test_split_fail_multiple_inferred_factors():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.split(i, factors=[None, None, 8])
+
+
+def test_split_fail_small_factor_product():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, _ = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.split(i, factors=[2, 8])
+
+
+def test_fuse():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.fuse(i, j)
+    tvm.ir.assert_structural_equal(elementwise_fused, sch.mod["main"])
+
+
+def test_fuse_split_roundtrip():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    i, j = sch.get_loops(sch.get_block("B"))
+    fused = sch.fuse(i, j)
+    i0, i1, j = sch.split(fused, factors=[2, 64, 128])
+    assert sch.get(i0).extent == 2
+    assert sch.get(i1).extent == 64
+    assert sch.get(j).extent == 128
+
+
+def test_fuse_fail_not_only_child():
+    sch = tir.Schedule(elementwise_with_seq, debug_mode=True)
+    block_b = sch.get_block("B")
+    i, j = sch.get_loops(block_b)
+    with pytest.raises(tvm.tir.ScheduleError):
+        sch.fuse(i, j)
+
+
+if __name__ == "__main__":
+    test_split()
+    test_split_with_inferred_factor()
+    test_split_with_predicate()
+    test_split_fail_multiple_inferred_factors()
+    test_split_fail_small_factor_product()
+    test_fuse()
+    test_fuse_split_roundtrip()
+    test_fuse_fail_not_only_child()
@@ -0,0 +1,84 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import tvm
+from tvm import tir
+from tvm.script import ty
+
+# pylint: disable=no-member,invalid-name,unused-variable
+
+
+@tvm.script.tir
+def elementwise(a: ty.handle, b: ty.handle) -> None:
+    A = tir.match_buffer(a, (128, 128))
+    B = tir.match_buffer(b, (128, 128))
+    with tir.block([128, 128], "B") as [vi, vj]:
+        B[vi, vj] = A[vi, vj] * 2.0
+
+
+# pylint: enable=no-member,invalid-name,unused-variable
+
+
+def _schedule_elementwise(sch):
+    block_b = sch.get_block("B")
+    i, j = sch.get_loops(block_b)
+    i_outer, i_inner = sch.split(i, factors=[None, 64])
+    sch.reorder(i_inner, i_outer)
+    sch.parallel(i_inner)
+    sch.vectorize(j)
+
+
+def test_trace_as_python():
+    sch = tir.Schedule(elementwise, debug_mode=True, traced=True)
+    _schedule_elementwise(sch)
+    assert sch.trace.as_python() == [
+        'b0 = sch.get_block(name="B", func_name="main")',
+        "l1, l2 = sch.get_loops(block=b0)",
+        "l3, l4 = sch.split(loop=l1, factors=[None, 64])",
+        "sch.reorder(l4, l3)",
+        "sch.parallel(loop=l4)",
+        "sch.vectorize(loop=l2)",
+    ]
+
+
+def test_trace_apply_to_schedule():
+    sch = tir.Schedule(elementwise, debug_mode=True, traced=True)
+    _schedule_elementwise(sch)
+    new_sch = tir.Schedule(elementwise, debug_mode=True)
+    sch.trace.apply_to_schedule(new_sch)
+    tvm.ir.assert_structural_equal(sch.mod, new_sch.mod)
+
+
+def test_trace_copy():
+    sch = tir.Schedule(elementwise, debug_mode=True, traced=True)
+    block_b = sch.get_block("B")
+    sch_copy = sch.copy()
+    sch_copy.get_loops(block_b)
+    assert len(sch.trace.insts) == 1
+    assert len(sch_copy.trace.insts) == 2
+
+
+def test_concrete_schedule_has_no_trace():
+    sch = tir.Schedule(elementwise, debug_mode=True)
+    assert sch.trace is None
+
+
+if __name__ == "__main__":
+    test_trace_as_python()
+    test_trace_apply_to_schedule()
+    test_trace_copy()
+    test_concrete_schedule_has_no_trace()
@@ -181,6 +181,26 @@ def test_buffer_load_store():
     assert not consistent_equal(sy, sz)
 
 
+def test_hash_cache():
+    x = te.var("x")
+    data = tvm.nd.array(np.arange(64, dtype="float32"))
+    arr = tvm.runtime.convert([data, tvm.tir.const(1, "int32"), x + 1])
+    expected = tvm.ir.structural_hash(arr)
+    cache = tvm.ir.StructuralHashCache()
+    with cache:
+        assert tvm.ir.structural_hash(arr) == expected
+        assert cache.size > 0 and cache.hits == 0
+        assert tvm.ir.structural_hash(arr) == expected
+        assert cache.hits > 0
+        # Subtrees with free variables are never cached.
+        assert tvm.ir.structural_hash(x + 1, map_free_vars=True) == tvm.ir.structural_hash(
+            te.var("y") + 1, map_free_vars=True
+        )
+    assert tvm.ir.structural_hash(arr) == expected
+    cache.clear()
+    assert cache.size == 0
+
+
 if __name__ == "__main__":
     test_exprs()
     test_prim_func()
@@ -189,3 +209,4 @@ if __name__ == "__main__":
     test_env_func()
     test_stmt()
     test_buffer_load_store()
+    test_hash_cache()
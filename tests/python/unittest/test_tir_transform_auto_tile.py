@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _matmul(n, m, k):
+    A = te.placeholder((n, k), name="A")
+    B = te.placeholder((k, m), name="B")
+    r = te.reduce_axis((0, k), name="r")
+    C = te.compute((n, m), lambda i, j: te.sum(A[i, r] * B[r, j], axis=r), name="C")
+    return te.create_schedule(C.op), [A, B, C]
+
+
+def _auto_tile(s, args, target="llvm"):
+    mod = tvm.lower(s, args)
+    mod = tvm.IRModule(
+        {gv: f.with_attr("target", tvm.target.Target(target)) for gv, f in mod.functions.items()}
+    )
+    return tvm.tir.transform.AutoTile()(mod)
+
+
+def _loops(mod):
+    loops = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body, lambda n: loops.append(n) if isinstance(n, tvm.tir.For) else None
+    )
+    return loops
+
+
+def test_matmul():
+    s, args = _matmul(512, 512, 512)
+    loops = _loops(_auto_tile(s, args))
+    names = [loop.loop_var.name for loop in loops]
+    assert any(name.endswith(".l1") for name in names)
+    assert "r.o" in names and "r.i" in names
+    vectorized = [loop for loop in loops if loop.kind == tvm.tir.ForKind.VECTORIZED]
+    # the init and the update of the unit stride loop j.
+    assert len(vectorized) == 2
+    assert all(loop.loop_var.name == "j.i" for loop in vectorized)
+
+
+def test_cache_size():
+    s, args = _matmul(512, 512, 512)
+    small = _loops(_auto_tile(s, args, "llvm -l1-cache-size=4096"))
+    large = _loops(_auto_tile(s, args, "llvm -l1-cache-size=1048576"))
+    inner = lambda loops: [l.extent.value for l in loops if l.loop_var.name == "j.i"][0]
+    assert inner(small) < inner(large)
+
+
+def test_skip():
+    # too small.
+    s, args = _matmul(8, 8, 8)
+    assert len(_loops(_auto_tile(s, args))) == 3
+    # already scheduled.
+    s, args = _matmul(512, 512, 512)
+    C = args[2]
+    s[C].parallel(C.op.axis[0])
+    assert len(_loops(_auto_tile(s, args))) == 3
+    # not a CPU function.
+    s, args = _matmul(512, 512, 512)
+    assert len(_loops(_auto_tile(s, args, "cuda"))) == 3
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    n, m, k = 128, 96, 200
+    s, args = _matmul(n, m, k)
+    with tvm.transform.PassContext(config={"tir.enable_auto_tile": True}):
+        func = tvm.build(s, args, "llvm")
+    a = tvm.nd.array(np.random.uniform(size=(n, k)).astype("float32"))
+    b = tvm.nd.array(np.random.uniform(size=(k, m)).astype("float32"))
+    c = tvm.nd.array(np.zeros((n, m), dtype="float32"))
+    func(a, b, c)
+    tvm.testing.assert_allclose(c.numpy(), np.dot(a.numpy(), b.numpy()), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_matmul()
+    test_cache_size()
+    test_skip()
+    test_build()
@@ -0,0 +1,140 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+from tvm.contrib import utils
+
+
+def _cse(stmt, params, **config):
+    func = tvm.tir.PrimFunc(params, stmt)
+    mod = tvm.IRModule.from_expr(func)
+    config = {"tir.CommonSubexprElim": dict(record_stats=True, **config)}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.CommonSubexprElim()(mod)
+    return mod["main"]
+
+
+def _bindings(stmt):
+    values = []
+    while isinstance(stmt, tvm.tir.LetStmt):
+        values.append(stmt.value)
+        stmt = stmt.body
+    return values, stmt
+
+
+def test_within_statement():
+    ib = tvm.tir.ir_builder.create()
+    x, y, z = te.var("x"), te.var("y"), te.var("z")
+    A = ib.pointer("int32", name="A")
+    A[0] = (x * y + z) * (x * y + z)
+    func = _cse(ib.get(), [A.asobject(), x, y, z])
+    values, store = _bindings(func.body)
+    assert len(values) == 1
+    tvm.ir.assert_structural_equal(values[0], x * y + z)
+    var = func.body.var
+    tvm.ir.assert_structural_equal(store.value, var * var)
+    assert func.attrs["tir.cse_removed_ops"].value == 2
+
+
+def test_cross_statement():
+    ib = tvm.tir.ir_builder.create()
+    x, y, z = te.var("x"), te.var("y"), te.var("z")
+    A = ib.pointer("int32", name="A")
+    A[0] = x * y + z
+    A[1] = (x * y + z) + 1
+    stmt, params = ib.get(), [A.asobject(), x, y, z]
+    values, seq = _bindings(_cse(stmt, params).body)
+    assert len(values) == 1
+    assert isinstance(seq, tvm.tir.SeqStmt)
+    values, _ = _bindings(_cse(stmt, params, cross_statement=False).body)
+    assert not values
+
+
+def test_largest_first():
+    ib = tvm.tir.ir_builder.create()
+    x, y, z = te.var("x"), te.var("y"), te.var("z")
+    A = ib.pointer("int32", name="A")
+    A[0] = (x * y + z) * 3
+    A[1] = (x * y + z) * 3
+    A[2] = x * y + z
+    func = _cse(ib.get(), [A.asobject(), x, y, z])
+    values, seq = _bindings(func.body)
+    # x * y + z is bound first, as it is used by the binding of (x * y + z) * 3
+    assert len(values) == 2
+    tvm.ir.assert_structural_equal(values[0], x * y + z)
+    tvm.ir.assert_structural_equal(values[1], func.body.var * 3)
+    assert seq[0].value.same_as(seq[1].value)
+
+
+def test_keep_loads_and_trapping():
+    ib = tvm.tir.ir_builder.create()
+    x, y = te.var("x"), te.var("y")
+    A = ib.pointer("int32", name="A")
+    B = ib.pointer("int32", name="B")
+    A[0] = B[0] * 2 + 1
+    A[1] = B[0] * 2 + 1
+    A[2] = tvm.tir.floordiv(x, y) + 1
+    A[3] = tvm.tir.floordiv(x, y) + 1
+    func = _cse(ib.get(), [A.asobject(), B.asobject(), x, y])
+    assert isinstance(func.body, tvm.tir.SeqStmt)
+    assert func.attrs["tir.cse_removed_ops"].value == 0
+
+
+def test_loop_scope():
+    ib = tvm.tir.ir_builder.create()
+    n = te.var("n")
+    A = ib.pointer("int32", name="A")
+    with ib.for_range(0, n, name="i") as i:
+        A[i * 2] = (i * n + 1) * 2
+        A[i * 2 + 1] = (i * n + 1) * 3
+    func = _cse(ib.get(), [A.asobject(), n])
+    loop = func.body
+    assert isinstance(loop, tvm.tir.For)
+    values, _ = _bindings(loop.body)
+    assert len(values) == 1
+    tvm.ir.assert_structural_equal(values[0], loop.loop_var * n + 1)
+
+
+def test_c_source():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: (A[i] * 2.0 + 1.0) * (A[i] * 2.0 + 1.0), name="B")
+    s = te.create_schedule(B.op)
+    with tvm.transform.PassContext(config={"tir.disable_cse": True}):
+        source = tvm.build(s, [A, B], "c").get_source()
+    assert "cse" not in source
+    # The loads are not eliminated, the arithmetic on them is left to the C compiler
+    mod = tvm.build(s, [A, B], "c", name="square")
+    temp = utils.tempdir()
+    path_dso = temp.relpath("temp.so")
+    mod.export_library(path_dso)
+    func = tvm.runtime.load_module(path_dso)["square"]
+    a = tvm.nd.array(np.random.uniform(size=n).astype("float32"))
+    b = tvm.nd.array(np.zeros(n, dtype="float32"))
+    func(a, b)
+    tvm.testing.assert_allclose(b.numpy(), (a.numpy() * 2 + 1) ** 2, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_within_statement()
+    test_cross_statement()
+    test_largest_first()
+    test_keep_loads_and_trapping()
+    test_loop_scope()
+    test_c_source()
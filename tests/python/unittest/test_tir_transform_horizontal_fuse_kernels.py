@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def _lower(tensors, outputs, num_threads, horizontal_fusion=True):
+    s = te.create_schedule([t.op for t in outputs])
+    for t, nthreads in zip(outputs, num_threads):
+        bx, tx = s[t].split(t.op.axis[0], factor=nthreads)
+        s[t].bind(bx, te.thread_axis("blockIdx.x"))
+        s[t].bind(tx, te.thread_axis("threadIdx.x"))
+    mod = tvm.lower(s, tensors + outputs)
+    if horizontal_fusion:
+        mod = tvm.tir.transform.Apply(lambda f: f.with_attr("tir.horizontal_fusion", 1))(mod)
+    return tvm.tir.transform.HorizontalFuseKernels()(mod)
+
+
+def _thread_extents(mod):
+    extents = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.AttrStmt) and op.attr_key == "thread_extent":
+            extents.append((op.node.thread_tag, op.value.value))
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    return sorted(extents)
+
+
+def test_pack_independent_kernels():
+    A = te.placeholder((1024,), name="A")
+    B = te.placeholder((256,), name="B")
+    C = te.compute(A.shape, lambda i: A[i] + 1, name="C")
+    D = te.compute(B.shape, lambda i: B[i] * 2, name="D")
+    mod = _lower([A, B], [C, D], [64, 32])
+    # 16 blocks of 64 threads and 8 blocks of 32 threads.
+    assert _thread_extents(mod) == [("blockIdx.x", 24), ("threadIdx.x", 64)]
+
+    # Functions not lowered from a horizontal fusion are left alone.
+    mod = _lower([A, B], [C, D], [64, 32], horizontal_fusion=False)
+    assert len(_thread_extents(mod)) == 4
+
+
+def test_keep_dependent_kernels():
+    A = te.placeholder((1024,), name="A")
+    C = te.compute(A.shape, lambda i: A[i] + 1, name="C")
+    D = te.compute(A.shape, lambda i: C[i] * 2, name="D")
+    # Both are outputs, D reads the result of the first kernel.
+    mod = _lower([A], [C, D], [64, 64])
+    assert len(_thread_extents(mod)) == 4
+
+
+if __name__ == "__main__":
+    test_pack_independent_kernels()
+    test_keep_dependent_kernels()
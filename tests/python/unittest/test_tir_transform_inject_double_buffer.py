@@ -61,5 +61,57 @@ def test_double_buffer():
     assert count[0] == 4
 
 
+def _pipelined_copy(num_stages):
+    n = 100
+    m = 4
+    tx = te.thread_axis("threadIdx.x")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    C = ib.pointer("float32", name="C")
+    ib.scope_attr(tx, "thread_extent", 1)
+    with ib.for_range(0, n) as i:
+        B = ib.allocate("float32", m, name="B", scope="shared")
+        with ib.new_scope():
+            ib.scope_attr(B.asobject(), "double_buffer_scope", num_stages)
+            with ib.for_range(0, m) as j:
+                B[j] = A[i * 4 + j]
+        with ib.for_range(0, m) as j:
+            C[j] = B[j] + 1
+    return tvm.IRModule({"db": tvm.tir.PrimFunc([A.asobject(), C.asobject()], ib.get())})
+
+
+def _calls(stmt, name):
+    calls = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get(name)):
+            calls.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, visit)
+    return calls
+
+
+def test_multi_stage_buffer():
+    mod = tvm.tir.transform.InjectDoubleBuffer()(_pipelined_copy(3))
+    stmt = mod["db"].body
+    assert isinstance(stmt.body.body, tvm.tir.Allocate)
+    assert stmt.body.body.extents[0].value == 3
+    assert not _calls(stmt, "tir.ptx_cp_async")
+
+
+def test_async_copy():
+    config = {"tir.InjectDoubleBuffer": {"use_async_copy": True}}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.InjectDoubleBuffer()(_pipelined_copy(3))
+    stmt = mod["db"].body
+    # The two fetches before the loop, and the one in the loop.
+    assert len(_calls(stmt, "tir.ptx_cp_async")) == 3
+    assert len(_calls(stmt, "tir.ptx_commit_group")) == 3
+    waits = _calls(stmt, "tir.ptx_wait_group")
+    assert len(waits) == 1 and waits[0].args[0].value == 2
+
+
 if __name__ == "__main__":
     test_double_buffer()
+    test_multi_stage_buffer()
+    test_async_copy()
@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _column_sum(n, stride, target="llvm"):
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    C = ib.pointer("float32", name="C")
+    with ib.for_range(0, n, name="i") as i:
+        # A is read down a column, B along a row.
+        C[i] = A[i * stride] + B[i]
+    func = tvm.tir.PrimFunc([A.asobject(), B.asobject(), C.asobject()], ib.get())
+    return tvm.IRModule.from_expr(func.with_attr("target", tvm.target.Target(target)))
+
+
+def _prefetches(mod):
+    calls = []
+
+    def visit(n):
+        if isinstance(n, tvm.tir.Call) and n.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            calls.append(n)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    return calls
+
+
+def test_strided_load():
+    mod = _column_sum(256, 32)
+    with tvm.transform.PassContext(config={"tir.InjectSoftwarePrefetch": {"distance": 4}}):
+        mod = tvm.tir.transform.InjectSoftwarePrefetch()(mod)
+    calls = _prefetches(mod)
+    # B advances by 4 bytes per iteration, the hardware prefetchers follow it.
+    assert len(calls) == 1
+    load = calls[0].args[0].args[0]
+    assert load.buffer_var.name == "A"
+    i = mod["main"].body.loop_var
+    tvm.ir.assert_structural_equal(load.index, i * 32 + 128)
+
+
+def test_derived_distance():
+    mod = tvm.tir.transform.InjectSoftwarePrefetch()(_column_sum(1024, 32))
+    calls = _prefetches(mod)
+    assert len(calls) == 1
+    i = mod["main"].body.loop_var
+    distance = tvm.arith.Analyzer().simplify((calls[0].args[0].args[0].index - i * 32) // 32)
+    assert distance.value > 1
+
+
+def test_skip():
+    # too short to hide the latency.
+    mod = tvm.tir.transform.InjectSoftwarePrefetch()(_column_sum(8, 32))
+    assert not _prefetches(mod)
+    # contiguous.
+    mod = tvm.tir.transform.InjectSoftwarePrefetch()(_column_sum(1024, 1))
+    assert not _prefetches(mod)
+    # not a CPU function.
+    mod = tvm.tir.transform.InjectSoftwarePrefetch()(_column_sum(1024, 32, "cuda"))
+    assert not _prefetches(mod)
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    n, stride = 1024, 16
+    A = te.placeholder((n, stride), name="A")
+    B = te.compute((n,), lambda i: A[i, 0] * 2, name="B")
+    s = te.create_schedule(B.op)
+    with tvm.transform.PassContext(config={"tir.enable_software_prefetch": True}):
+        func = tvm.build(s, [A, B], "llvm")
+    a = tvm.nd.array(np.random.uniform(size=(n, stride)).astype("float32"))
+    b = tvm.nd.array(np.zeros((n,), dtype="float32"))
+    func(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy()[:, 0] * 2)
+
+
+if __name__ == "__main__":
+    test_strided_load()
+    test_derived_distance()
+    test_skip()
+    test_build()
@@ -0,0 +1,117 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import te
+
+
+def _licm(stmt, params, **config):
+    func = tvm.tir.PrimFunc(params, stmt)
+    mod = tvm.IRModule.from_expr(func)
+    config = {"tir.LoopInvariantCodeMotion": dict(record_stats=True, **config)}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.LoopInvariantCodeMotion()(mod)
+    return mod["main"]
+
+
+def test_hoist_to_outermost_loop():
+    ib = tvm.tir.ir_builder.create()
+    n = te.var("n")
+    scale = te.var("scale", dtype="float32")
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 8, name="i") as i:
+        with ib.for_range(0, 16, name="j") as j:
+            # n * 16 is invariant in both loops, i * n * 16 in j only.
+            A[i * (n * 16) + j] = A[i * (n * 16) + j] * (scale * 2.0)
+    func = _licm(ib.get(), [A.asobject(), n, scale])
+
+    body = func.body
+    # The bindings of the invariants of the outer loop come first.
+    outer = []
+    while isinstance(body, tvm.tir.LetStmt):
+        outer.append(body.value)
+        body = body.body
+    assert isinstance(body, tvm.tir.For) and body.loop_var.name == "i"
+    assert len(outer) == 2
+    tvm.ir.assert_structural_equal(outer[0], n * 16)
+    tvm.ir.assert_structural_equal(outer[1], scale * 2.0)
+    inner = body.body
+    assert isinstance(inner, tvm.tir.LetStmt)
+    tvm.ir.assert_structural_equal(inner.value, body.loop_var * func.body.var)
+    assert isinstance(inner.body, tvm.tir.For) and inner.body.loop_var.name == "j"
+    assert func.attrs["tir.licm_removed_ops"].value > 0
+
+
+def test_keep_impure_and_trapping():
+    ib = tvm.tir.ir_builder.create()
+    n = te.var("n")
+    A = ib.pointer("int32", name="A")
+    B = ib.pointer("int32", name="B")
+    with ib.for_range(0, 16, name="i") as i:
+        # A load may be changed by the loop, and a division by n may trap when n is 0.
+        A[i] = B[0] + tvm.tir.floordiv(i, n) + tvm.tir.floordiv(B[1], n)
+    func = _licm(ib.get(), [A.asobject(), B.asobject(), n])
+    assert isinstance(func.body, tvm.tir.For)
+    assert func.attrs["tir.licm_removed_ops"].value == 0
+
+
+def test_min_ops():
+    ib = tvm.tir.ir_builder.create()
+    n = te.var("n")
+    A = ib.pointer("int32", name="A")
+    with ib.for_range(0, 16, name="i") as i:
+        A[i] = i + (n + 1)
+    assert isinstance(_licm(ib.get(), [A.asobject(), n]).body, tvm.tir.LetStmt)
+    assert isinstance(_licm(ib.get(), [A.asobject(), n], min_ops=2).body, tvm.tir.For)
+
+
+def test_merge_duplicated_invariants():
+    ib = tvm.tir.ir_builder.create()
+    n = te.var("n")
+    A = ib.pointer("int32", name="A")
+    with ib.for_range(0, 4, name="i") as i:
+        with ib.for_range(0, 16, name="j") as j:
+            A[j] = j * (n * 3)
+        with ib.for_range(0, 16, name="k") as k:
+            A[k] = A[k] + k * (n * 3)
+    func = _licm(ib.get(), [A.asobject(), n])
+    assert isinstance(func.body, tvm.tir.LetStmt)
+    assert isinstance(func.body.body, tvm.tir.For)
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    n = 64
+    A = te.placeholder((n, n), name="A")
+    s = te.var("s", dtype="float32")
+    B = te.compute((n, n), lambda i, j: A[i, j] * (s * s + 1.0), name="B")
+    sch = te.create_schedule(B.op)
+    with tvm.transform.PassContext(config={"tir.enable_loop_invariant_code_motion": True}):
+        func = tvm.build(sch, [A, B, s], "llvm")
+    a = tvm.nd.array(np.random.uniform(size=(n, n)).astype("float32"))
+    b = tvm.nd.array(np.zeros((n, n), dtype="float32"))
+    func(a, b, 3.0)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() * 10.0, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    test_hoist_to_outermost_loop()
+    test_keep_impure_and_trapping()
+    test_min_ops()
+    test_merge_duplicated_invariants()
+    test_build()
@@ -538,6 +538,72 @@ def test_simple_rfactor():
     assert not tvm.ir.structural_equal(stmt1.body, stmt2.body)
 
 
+def _padded_double():
+    from tvm import topi
+
+    data = te.placeholder((1, 4, 8, 8), name="data")
+    pad = topi.nn.pad(data, (0, 0, 1, 1), (0, 0, 1, 1), name="pad")
+    out = te.compute(pad.shape, lambda n, c, h, w: pad[n, c, h, w] * 2, name="out")
+    s = te.create_schedule(out.op)
+    s[pad].compute_inline()
+    bounds = tvm.te.schedule.InferBound(s)
+    stmt = tvm.te.schedule.ScheduleOps(s, bounds)
+    return tvm.IRModule.from_expr(tvm.tir.PrimFunc([], stmt))
+
+
+def _count_if_then_else(stmt):
+    return collect_visit(
+        stmt, lambda x: isinstance(x, tvm.tir.Call) and x.op.name == "tir.if_then_else"
+    ).count(True)
+
+
+def test_partition_if_then_else():
+    mod = _padded_double()
+    decisions = []
+
+    @tvm.instrument.pass_instrument
+    class RecordDecisions:
+        def run_after_pass(self, mod, info):
+            if info.name == "tir.LoopPartition":
+                decisions.extend(str(d) for d in mod["main"].attrs["tir.loop_partition_decisions"])
+
+    config = {
+        "tir.LoopPartition": {
+            "partition_const_loop": True,
+            "partition_if_then_else": True,
+            "record_decisions": True,
+        }
+    }
+    with tvm.transform.PassContext(config=config, instruments=[RecordDecisions()]):
+        mod = tvm.tir.transform.LoopPartition()(mod)
+        stmt = tvm.tir.transform.Simplify()(mod)["main"].body
+
+    # h and w are split into their interior and their two boundaries, the padding checks
+    # of each region folding to constants.
+    assert _count_if_then_else(stmt) == 0
+    assert any(d.startswith("h: split at 1 9") for d in decisions)
+    assert any(d.startswith("w: split at 1 9") for d in decisions)
+
+
+def test_partition_code_growth():
+    config = {
+        "tir.LoopPartition": {
+            "partition_const_loop": True,
+            "partition_if_then_else": True,
+            "max_code_growth": 1.0,
+            "record_decisions": True,
+        }
+    }
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.LoopPartition()(_padded_double())
+        stmt = tvm.tir.transform.Simplify()(mod)["main"].body
+    decisions = [str(d) for d in mod["main"].attrs["tir.loop_partition_decisions"]]
+
+    # no growth is allowed, every loop keeps its checks.
+    assert _count_if_then_else(stmt) == 1
+    assert decisions and all("kept" in d for d in decisions)
+
+
 if __name__ == "__main__":
     test_basic()
     test_const_loop()
@@ -559,3 +625,5 @@ if __name__ == "__main__":
     test_double_splitting_with_indivisible_factors()
     test_multilevel_splitting_with_indivisble_factors()
     test_simple_rfactor()
+    test_partition_if_then_else()
+    test_partition_code_growth()
@@ -0,0 +1,106 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def lower_row_max(nthx, nthy=2, m=8, n=1024, target="cuda"):
+    A = te.placeholder((m, n), name="A")
+    k = te.reduce_axis((0, n))
+    B = te.compute((m,), lambda i: te.max(A[i, k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    ko, _ = s[B].split(s[B].op.reduce_axis[0], nparts=nthx)
+    s[B].bind(ko, te.thread_axis((0, nthx), "threadIdx.x"))
+    xo, xi = s[B].split(s[B].op.axis[0], factor=nthy)
+    s[B].bind(xi, te.thread_axis((0, nthy), "threadIdx.y"))
+    s[B].bind(xo, te.thread_axis("blockIdx.x"))
+    mod = tvm.lower(s, [A, B])
+    mod = tvm.tir.transform.Apply(lambda f: f.with_attr("target", tvm.target.Target(target)))(mod)
+    return tvm.tir.transform.LowerThreadAllreduce()(mod)["main"]
+
+
+def collect(func):
+    shuffles = {"tir.tvm_warp_shuffle_down": 0, "tir.tvm_warp_shuffle": 0}
+    shared = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.name in shuffles:
+            shuffles[op.op.name] += 1
+        elif isinstance(op, tvm.tir.AttrStmt) and op.attr_key == "storage_scope":
+            if op.value.value == "shared":
+                shared.append(op.body)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, visit)
+    return shuffles, shared
+
+
+def test_warp_reduction():
+    shuffles, shared = collect(lower_row_max(32))
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 5, "tir.tvm_warp_shuffle": 1}
+    assert not shared
+
+
+def test_sub_warp_reduction():
+    func = lower_row_max(16)
+    shuffles, shared = collect(func)
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 4, "tir.tvm_warp_shuffle": 1}
+    assert not shared
+
+    widths = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.name == "tir.tvm_warp_shuffle_down":
+            widths.append(op.args[3].value)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, visit)
+    assert widths == [16] * 4
+
+
+def test_multi_warp_reduction():
+    shuffles, shared = collect(lower_row_max(128))
+    # Five steps within each warp, then two over the results of the four warps.
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 7, "tir.tvm_warp_shuffle": 1}
+    assert len(shared) == 1
+    assert shared[0].extents[0].value == 2 * 4
+
+
+def test_shared_memory_reduction():
+    # Neither a power of two below a warp nor a multiple of the warp size.
+    shuffles, shared = collect(lower_row_max(48))
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 0, "tir.tvm_warp_shuffle": 0}
+    assert len(shared) == 1
+
+
+def test_vulkan_subgroup_reduction():
+    vulkan = "vulkan -thread_warp_size=32 -vulkan_api_version=%d" % ((1 << 22) | (1 << 12))
+    # ballot, shuffle and relative shuffle
+    target = vulkan + " -supported_subgroup_operations=56"
+    shuffles, shared = collect(lower_row_max(64, target=target))
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 6, "tir.tvm_warp_shuffle": 1}
+    assert len(shared) == 1
+
+    # without subgroup shuffles, the reduction is in shared memory
+    shuffles, _ = collect(lower_row_max(64, target=vulkan + " -supported_subgroup_operations=1"))
+    assert shuffles == {"tir.tvm_warp_shuffle_down": 0, "tir.tvm_warp_shuffle": 0}
+
+
+if __name__ == "__main__":
+    test_warp_reduction()
+    test_sub_warp_reduction()
+    test_multi_warp_reduction()
+    test_shared_memory_reduction()
+    test_vulkan_subgroup_reduction()
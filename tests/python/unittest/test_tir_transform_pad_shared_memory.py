@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+from tvm import te
+
+
+def transpose_through_shared(transposed=True, align=False):
+    n = 32
+    A = te.placeholder((n, n), name="A")
+    if transposed:
+        B = te.compute((n, n), lambda i, j: A[j, i], name="B")
+    else:
+        B = te.compute((n, n), lambda i, j: A[i, j], name="B")
+    s = te.create_schedule(B.op)
+    AS = s.cache_read(A, "shared", [B])
+    if align:
+        s[AS].storage_align(AS.op.axis[0], 32, 2)
+    s[B].bind(B.op.axis[1], te.thread_axis("threadIdx.x"))
+    return s, [A, B]
+
+
+def shared_degree(func):
+    degrees = tvm.tir.analysis.shared_memory_bank_conflicts(func)
+    assert len(degrees) == 1
+    return list(degrees.values())[0].value
+
+
+def shared_allocation_size(mod):
+    sizes = []
+
+    def visit(op):
+        if isinstance(op, tvm.tir.Allocate):
+            size = 1
+            for extent in op.extents:
+                size *= extent.value
+            sizes.append(size)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, visit)
+    assert len(sizes) == 1
+    return sizes[0]
+
+
+def test_pad_transposed_access():
+    s, args = transpose_through_shared()
+    mod = tvm.driver.build_module.schedule_to_module(s, args, "main", None)
+    assert shared_degree(mod["main"]) == 32
+    mod = tvm.tir.transform.PadSharedMemory()(mod)
+    assert shared_degree(mod["main"]) == 1
+
+    # The padding is applied by default when lowering.
+    assert shared_allocation_size(tvm.lower(s, args)) == 32 * 33
+    with tvm.transform.PassContext(config={"tir.disable_shared_memory_padding": True}):
+        assert shared_allocation_size(tvm.lower(s, args)) == 32 * 32
+
+
+def test_keep_conflict_free_layout():
+    s, args = transpose_through_shared(transposed=False)
+    mod = tvm.driver.build_module.schedule_to_module(s, args, "main", None)
+    assert shared_degree(mod["main"]) == 1
+    assert shared_allocation_size(tvm.lower(s, args)) == 32 * 32
+
+
+def test_keep_storage_align():
+    s, args = transpose_through_shared(align=True)
+    mod = tvm.driver.build_module.schedule_to_module(s, args, "main", None)
+    # The rows of 34 words still conflict by pairs of lanes.
+    assert shared_degree(mod["main"]) == 2
+    assert shared_allocation_size(tvm.lower(s, args)) == 32 * 34
+
+
+if __name__ == "__main__":
+    test_pad_transposed_access()
+    test_keep_conflict_free_layout()
+    test_keep_storage_align()
@@ -681,6 +681,51 @@ def test_large_input():
     tvm.tir.stmt_functor.post_order_visit(stmt, verify)
 
 
+def test_pack_shared_memory():
+    def make_func():
+        ib = tvm.tir.ir_builder.create()
+        out = ib.pointer("float32", name="out")
+        tx = te.thread_axis("threadIdx.x")
+        ib.scope_attr(tx, "thread_extent", 64)
+        A = ib.allocate("float32", 64, name="A", scope="shared")
+        A[tx] = 1.0
+        out[tx] = A[tx]
+        # B takes over A, C is alive at the same time as B.
+        B = ib.allocate("float16", 64, name="B", scope="shared")
+        B[tx] = tvm.tir.const(1, "float16")
+        C = ib.allocate("int8", 64, name="C", scope="shared")
+        C[tx] = tvm.tir.const(1, "int8")
+        out[tx] = B[tx].astype("float32") + C[tx].astype("float32")
+        return tvm.IRModule.from_expr(tvm.tir.PrimFunc([out.asobject()], ib.get()))
+
+    def allocs(pack):
+        with tvm.transform.PassContext(config={"tir.pack_shared_memory": pack}):
+            body = tvm.tir.transform.StorageRewrite()(make_func())["main"].body
+        result = []
+        tvm.tir.stmt_functor.post_order_visit(
+            body, lambda n: result.append(n) if isinstance(n, tvm.tir.Allocate) else None
+        )
+        return result, body
+
+    unpacked, _ = allocs(False)
+    assert len(unpacked) == 2
+
+    packed, body = allocs(True)
+    assert len(packed) == 1
+    # 64 float32 for A and B, then the 64 int8 of C.
+    assert packed[0].dtype == "float32"
+    assert packed[0].extents[0].value == 80
+    stores = []
+    tvm.tir.stmt_functor.post_order_visit(
+        body, lambda n: stores.append(n) if isinstance(n, tvm.tir.Store) else None
+    )
+    int8_stores = [st for st in stores if st.value.dtype == "int8"]
+    assert len(int8_stores) == 1
+    assert int8_stores[0].buffer_var.same_as(packed[0].buffer_var)
+    index = int8_stores[0].index
+    assert isinstance(index, tvm.tir.Add) and index.a.value == 256
+
+
 if __name__ == "__main__":
     test_storage_share()
     test_alloc_seq()
@@ -700,3 +745,4 @@ if __name__ == "__main__":
     test_reuse_small_buffer()
     test_replace_dataflow()
     test_large_input()
+    test_pack_shared_memory()
@@ -14,7 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
+
 import tvm
+import tvm.testing
 from tvm import te
 
 
@@ -205,6 +208,83 @@ def test_vectorize_while_fail():
         assert expected in error_msg
 
 
+def test_vectorize_scalable():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, n) as i:
+        with ib.for_range(0, 16, kind="vectorize") as j:
+            A[i * 16 + j] = tvm.tir.const(1, A.dtype)
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
+    with tvm.transform.PassContext(config={"tir.vectorize_scalable": True}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    # The loop is left to the backend vectorizer.
+    assert isinstance(stmt.body, tvm.tir.For)
+    assert stmt.body.kind == tvm.tir.ForKind.SERIAL
+    assert "tir.scalable_vectorize" in stmt.body.annotations
+    assert not isinstance(stmt.body.body.index, tvm.tir.Ramp)
+
+
+@tvm.testing.requires_llvm
+def test_vectorize_scalable_llvm():
+    n = 1000
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2, name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=64)
+    s[B].vectorize(xi)
+
+    with tvm.transform.PassContext(config={"tir.vectorize_scalable": True}):
+        f = tvm.build(s, [A, B], "llvm")
+
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    a = tvm.nd.array(a_np)
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype))
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a_np * 2)
+
+
+def test_vectorize_predicate_tail():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = A[i] + 1
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
+    with tvm.transform.PassContext(config={"tir.vectorize_predicate_tail": True}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt, tvm.tir.Store)
+    assert isinstance(stmt.index, tvm.tir.Ramp)
+    assert stmt.predicate.dtype == "bool4"
+    assert not tvm.tir.analysis.expr_deep_equal(stmt.predicate, tvm.tir.const(1, "bool"))
+
+
+@tvm.testing.requires_llvm
+def test_vectorize_predicate_tail_llvm():
+    n = 1000
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2, name="B")
+    s = te.create_schedule(B.op)
+    _, xi = s[B].split(B.op.axis[0], factor=16)
+    s[B].vectorize(xi)
+
+    with tvm.transform.PassContext(config={"tir.vectorize_predicate_tail": True}):
+        f = tvm.build(s, [A, B], "llvm")
+
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    a = tvm.nd.array(a_np)
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype))
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a_np * 2)
+
+
 if __name__ == "__main__":
     test_vectorize_vector()
     test_vectorize_with_if()
@@ -214,3 +294,7 @@ if __name__ == "__main__":
     test_vectorize_with_ge_cond()
     test_vectorize_let()
     test_vectorize_while_fail()
+    test_vectorize_scalable()
+    test_vectorize_scalable_llvm()
+    test_vectorize_predicate_tail()
+    test_vectorize_predicate_tail_llvm()
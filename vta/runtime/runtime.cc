@@ -35,7 +35,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -373,8 +375,10 @@ template <class T>
 class BaseQueue {
  public:
   virtual ~BaseQueue() {
-    if (fpga_buff_ != nullptr) {
-      VTAMemFree(fpga_buff_);
+    for (void* buff : fpga_buffs_) {
+      if (buff != nullptr) {
+        VTAMemFree(buff);
+      }
     }
   }
   /*! \return Content of DRAM buffer. */
@@ -391,11 +395,26 @@ class BaseQueue {
     coherent_ = coherent;
     always_cache_ = always_cache;
     elem_bytes_ = elem_bytes;
-    // Allocate buffer ahead of time
-    fpga_buff_ = static_cast<char*>(VTAMemAlloc(max_bytes, coherent_ || always_cache_));
-    CHECK(fpga_buff_ != nullptr);
-    fpga_buff_phy_ = VTAMemGetPhyAddr(fpga_buff_);
+    // Allocate buffers ahead of time
+    for (int i = 0; i < kNumFpgaBuffs; ++i) {
+      fpga_buffs_[i] = static_cast<char*>(VTAMemAlloc(max_bytes, coherent_ || always_cache_));
+      CHECK(fpga_buffs_[i] != nullptr);
+      fpga_buff_phys_[i] = VTAMemGetPhyAddr(fpga_buffs_[i]);
+    }
+    fpga_buff_ = fpga_buffs_[0];
+    fpga_buff_phy_ = fpga_buff_phys_[0];
   }
+  /*!
+   * \brief Switch to the other FPGA buffer, so that the contents of the current one are kept
+   *  for the accelerator while the next contents are written.
+   */
+  void SwapFpgaBuffer() {
+    fpga_buff_index_ = (fpga_buff_index_ + 1) % kNumFpgaBuffs;
+    fpga_buff_ = fpga_buffs_[fpga_buff_index_];
+    fpga_buff_phy_ = fpga_buff_phys_[fpga_buff_index_];
+  }
+  /*! \brief The number of FPGA buffers, used in turn by the submitted runs. */
+  static constexpr int kNumFpgaBuffs = 2;
   /*!
    * \brief Reset the pointer of the buffer.
    *  Set SRAM pointer to be the current end.
@@ -425,6 +444,12 @@ class BaseQueue {
   void* fpga_buff_{NULL};
   // Physical address of the FPGA buffer
   vta_phy_addr_t fpga_buff_phy_{0};
+  // The FPGA accessible buffers, the current one being fpga_buff_
+  void* fpga_buffs_[kNumFpgaBuffs] = {nullptr, nullptr};
+  // Physical addresses of the FPGA buffers
+  vta_phy_addr_t fpga_buff_phys_[kNumFpgaBuffs] = {0, 0};
+  // Index of the current FPGA buffer
+  int fpga_buff_index_{0};
 };
 
 /*!
@@ -1007,7 +1032,17 @@ class CommandQueue {
     CHECK(device_ != nullptr);
   }
 
-  ~CommandQueue() { VTADeviceFree(device_); }
+  ~CommandQueue() {
+    if (worker_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+      }
+      run_cv_.notify_one();
+      worker_.join();
+    }
+    VTADeviceFree(device_);
+  }
 
   uint32_t GetElemBytes(uint32_t memory_id) {
     uint32_t elem_bytes = 0;
@@ -1100,6 +1135,15 @@ class CommandQueue {
   }
 
   void Synchronize(uint32_t wait_cycles) {
+    this->Submit(wait_cycles);
+    this->Wait();
+  }
+
+  /*!
+   * \brief Commit the pushed instructions. In the asynchronous mode they are run by the worker
+   *  thread, and the queues switch to their other FPGA buffers for the next instructions.
+   */
+  void Submit(uint32_t wait_cycles) {
     // Insert dependences to force serialization
     if (debug_flag_ & VTA_DEBUG_FORCE_SERIAL) {
       insn_queue_.RewriteForceSerial();
@@ -1117,6 +1161,8 @@ class CommandQueue {
     CHECK(!insn_queue_.PendingPop());
     // Check if there are no instruction to execute at all
     if (insn_queue_.count() == 0) return;
+    // The FPGA buffers are rewritten below, wait for the run still reading them
+    if (async_) this->WaitForFreeBuffers();
     // Synchronization for the queues
     uop_queue_.AutoReadBarrier();
     insn_queue_.AutoReadBarrier();
@@ -1130,14 +1176,42 @@ class CommandQueue {
 
     // Make sure that we don't exceed contiguous physical memory limits
     CHECK(insn_queue_.count() * sizeof(VTAGenericInsn) <= VTA_MAX_XFER);
-    int timeout =
-        VTADeviceRun(device_, insn_queue_.dram_phy_addr(), insn_queue_.count(), wait_cycles);
-    CHECK_EQ(timeout, 0);
+    if (!async_) {
+      int timeout =
+          VTADeviceRun(device_, insn_queue_.dram_phy_addr(), insn_queue_.count(), wait_cycles);
+      CHECK_EQ(timeout, 0);
+    } else {
+      this->Enqueue({insn_queue_.dram_phy_addr(), insn_queue_.count(), wait_cycles});
+      uop_queue_.SwapFpgaBuffer();
+      insn_queue_.SwapFpgaBuffer();
+    }
     // Reset buffers
     uop_queue_.Reset();
     insn_queue_.Reset();
   }
 
+  /*! \brief Wait until all the submitted runs have finished. */
+  void Wait() {
+    if (!worker_.joinable()) return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return num_inflight_ == 0; });
+    CHECK_EQ(num_timeouts_, 0) << "VTA device run timed out";
+  }
+
+  /*! \return Whether all the submitted runs have finished. */
+  bool Poll() {
+    if (!worker_.joinable()) return true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_EQ(num_timeouts_, 0) << "VTA device run timed out";
+    return num_inflight_ == 0;
+  }
+
+  // Set asynchronous mode
+  void SetAsyncMode(bool async) {
+    if (!async) this->Wait();
+    async_ = async;
+  }
+
   // Get record kernel
   UopKernel* record_kernel() const {
     CHECK(record_kernel_ != nullptr);
@@ -1282,11 +1356,57 @@ class CommandQueue {
       this->AutoSync();
     }
   }
-  // Auto sync when instruction overflow
-  void AutoSync() { this->Synchronize(1 << 31); }
+  // Auto sync when instruction overflow, overlapping the run with the next instructions
+  // in the asynchronous mode
+  void AutoSync() { this->Submit(1 << 31); }
+
+  // A run of the instructions committed to the worker thread
+  struct Run {
+    vta_phy_addr_t insn_phy_addr;
+    uint32_t insn_count;
+    uint32_t wait_cycles;
+  };
+
+  // The buffers of a run are reused by the second next one, so at most one other run may be
+  // in flight when the current buffers are written.
+  void WaitForFreeBuffers() {
+    if (!worker_.joinable()) return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return num_inflight_ < BaseQueue<VTAUop>::kNumFpgaBuffs; });
+  }
+
+  void Enqueue(Run run) {
+    if (!worker_.joinable()) {
+      worker_ = std::thread([this]() { this->WorkerLoop(); });
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      runs_.push_back(run);
+      ++num_inflight_;
+    }
+    run_cv_.notify_one();
+  }
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      run_cv_.wait(lock, [this]() { return shutdown_ || !runs_.empty(); });
+      if (runs_.empty()) return;
+      Run run = runs_.front();
+      runs_.pop_front();
+      lock.unlock();
+      int timeout = VTADeviceRun(device_, run.insn_phy_addr, run.insn_count, run.wait_cycles);
+      lock.lock();
+      if (timeout != 0) ++num_timeouts_;
+      --num_inflight_;
+      done_cv_.notify_all();
+    }
+  }
 
   // Internal debug flag
   int debug_flag_{0};
+  // Whether the runs are submitted to the worker thread
+  bool async_{false};
   // The kernel we are currently recording
   UopKernel* record_kernel_{nullptr};
   // Micro op queue
@@ -1295,6 +1415,22 @@ class CommandQueue {
   InsnQueue<VTA_MAX_XFER, kBufferCoherent, kAlwaysCache> insn_queue_;
   // Device handle
   VTADeviceHandle device_{nullptr};
+  // The worker thread running the submitted instructions, started by the first submission
+  std::thread worker_;
+  // Protects the fields below, shared with the worker thread
+  std::mutex mutex_;
+  // Notifies the worker thread of a new run or of the shutdown
+  std::condition_variable run_cv_;
+  // Notifies the host thread of a finished run
+  std::condition_variable done_cv_;
+  // The runs waiting for the worker thread
+  std::deque<Run> runs_;
+  // The number of submitted runs not finished yet
+  int num_inflight_{0};
+  // The number of runs that timed out
+  int num_timeouts_{0};
+  // Whether the worker thread should exit once the queued runs are done
+  bool shutdown_{false};
 };
 
 }  // namespace vta
@@ -1338,6 +1474,10 @@ void VTASetDebugMode(VTACommandHandle cmd, int debug_flag) {
   static_cast<vta::CommandQueue*>(cmd)->SetDebugFlag(debug_flag);
 }
 
+void VTASetAsyncMode(VTACommandHandle cmd, int async) {
+  static_cast<vta::CommandQueue*>(cmd)->SetAsyncMode(async != 0);
+}
+
 void* VTABufferCPUPtr(VTACommandHandle cmd, void* buffer) {
   auto data_buf = vta::DataBuffer::FromHandle(buffer);
   if (data_buf) {
@@ -1410,3 +1550,9 @@ int VTADepPop(VTACommandHandle cmd, int from_qid, int to_qid) {
 void VTASynchronize(VTACommandHandle cmd, uint32_t wait_cycles) {
   static_cast<vta::CommandQueue*>(cmd)->Synchronize(wait_cycles);
 }
+
+void VTASubmit(VTACommandHandle cmd, uint32_t wait_cycles) {
+  static_cast<vta::CommandQueue*>(cmd)->Submit(wait_cycles);
+}
+
+int VTAPoll(VTACommandHandle cmd) { return static_cast<vta::CommandQueue*>(cmd)->Poll(); }
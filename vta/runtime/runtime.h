@@ -118,6 +118,16 @@ TVM_DLL void VTAReadBarrier(VTACommandHandle cmd, void* buffer, uint32_t elem_bi
  */
 TVM_DLL void VTASetDebugMode(VTACommandHandle cmd, int debug_flag);
 
+/*!
+ * \brief Set whether the command handle runs the instructions asynchronously.
+ *  In the asynchronous mode, the instructions committed by VTASubmit, or when the
+ *  instruction or micro-op buffer is full, are run by a worker thread while the next
+ *  instructions are pushed into a second pair of buffers. The runs stay in order.
+ * \param cmd The VTA command handle.
+ * \param async Whether to run the instructions asynchronously.
+ */
+TVM_DLL void VTASetAsyncMode(VTACommandHandle cmd, int async);
+
 /*!
  * \brief Perform a 2D data load from DRAM.
  *  Sizes are measured in units of vector elements.
@@ -255,6 +265,22 @@ TVM_DLL int VTADepPop(VTACommandHandle cmd, int from_qid, int to_qid);
  */
 TVM_DLL void VTASynchronize(VTACommandHandle cmd, uint32_t wait_cycles);
 
+/*!
+ * \brief Commit all the instructions to VTA without waiting for them to finish.
+ *  The outputs of the instructions may only be read after VTASynchronize, or once
+ *  VTAPoll returns 1. Same as VTASynchronize unless the asynchronous mode is set.
+ * \param cmd The VTA command handle.
+ * \param wait_cycles The limit of poll cycles.
+ */
+TVM_DLL void VTASubmit(VTACommandHandle cmd, uint32_t wait_cycles);
+
+/*!
+ * \brief Check whether all the committed instructions have finished.
+ * \param cmd The VTA command handle.
+ * \return 1 if the accelerator has finished all the runs committed so far, 0 otherwise.
+ */
+TVM_DLL int VTAPoll(VTACommandHandle cmd);
+
 #ifdef __cplusplus
 }
 #endif
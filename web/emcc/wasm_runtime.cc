@@ -54,6 +54,12 @@
 
 // --- Implementations of backend and wasm runtime API. ---
 
+#ifdef __EMSCRIPTEN_PTHREADS__
+// Built with -pthread, the std::threads of the thread pool run on Web Workers
+// sharing the memory of the module through a SharedArrayBuffer.
+#include "src/runtime/thread_pool.cc"
+#include "src/runtime/threading_backend.cc"
+#else
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
@@ -62,6 +68,7 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
 }
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
+#endif
 
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
@@ -36,6 +36,8 @@
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../../src/runtime/meta_data.h"
 #include "../../src/runtime/vulkan/vulkan_shader.h"
@@ -56,6 +58,8 @@ class WebGPUThreadEntry {
 };
 
 // All the implementations are redirectly to the JS side.
+// Freed buffers are kept in a pool of size classes and reused by the later allocations,
+// as creating a GPU buffer goes through the JS bridge and the browser.
 class WebGPUDeviceAPI : public DeviceAPI {
  public:
   WebGPUDeviceAPI() {
@@ -77,11 +81,35 @@ class WebGPUDeviceAPI : public DeviceAPI {
   }
 
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
-    double ptr_number = alloc_space_(nbytes);
-    return reinterpret_cast<void*>(static_cast<int64_t>(ptr_number));
+    size_t size = PooledSize(nbytes);
+    std::vector<void*>& free_list = free_buffers_[size];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      return ptr;
+    }
+    double ptr_number = alloc_space_(size);
+    void* ptr = reinterpret_cast<void*>(static_cast<int64_t>(ptr_number));
+    buffer_sizes_[ptr] = size;
+    return ptr;
+  }
+
+  void FreeDataSpace(Device dev, void* ptr) final {
+    auto it = buffer_sizes_.find(ptr);
+    CHECK(it != buffer_sizes_.end()) << "Free a buffer not allocated by the WebGPU device API";
+    free_buffers_[it->second].push_back(ptr);
   }
 
-  void FreeDataSpace(Device dev, void* ptr) final { return free_space_(ptr); }
+  /*! \brief Destroy the buffers kept in the pool. */
+  void ReleasePool() {
+    for (auto& kv : free_buffers_) {
+      for (void* ptr : kv.second) {
+        buffer_sizes_.erase(ptr);
+        free_space_(ptr);
+      }
+      kv.second.clear();
+    }
+  }
 
  protected:
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
@@ -141,6 +169,26 @@ class WebGPUDeviceAPI : public DeviceAPI {
   }
 
  private:
+  /*!
+   * \brief The size class of an allocation: a power of two up to kPoolLinearBytes, then a
+   *  multiple of kPoolLinearBytes, so that a pooled buffer wastes at most half of its size.
+   */
+  static size_t PooledSize(size_t nbytes) {
+    if (nbytes > kPoolLinearBytes) {
+      return (nbytes + kPoolLinearBytes - 1) / kPoolLinearBytes * kPoolLinearBytes;
+    }
+    size_t size = kPoolMinBytes;
+    while (size < nbytes) size <<= 1;
+    return size;
+  }
+  // The smallest size class, also the alignment of the storage buffer bindings.
+  static constexpr size_t kPoolMinBytes = 256;
+  // The size from which the size classes are linear.
+  static constexpr size_t kPoolLinearBytes = 1 << 20;
+  // The size class of each buffer allocated from the JS side.
+  std::unordered_map<void*, size_t> buffer_sizes_;
+  // The free buffers of each size class.
+  std::unordered_map<size_t, std::vector<void*>> free_buffers_;
   // NOTE: js return number as double.
   TypedPackedFunc<double(int64_t nbytes)> alloc_space_;
   TypedPackedFunc<void(void* ptr)> free_space_;
@@ -229,5 +277,9 @@ TVM_REGISTER_GLOBAL("device_api.webgpu").set_body([](TVMArgs args, TVMRetValue*
   *rv = static_cast<void*>(ptr);
 });
 
+TVM_REGISTER_GLOBAL("device_api.webgpu.release_pool").set_body_typed([]() {
+  WebGPUDeviceAPI::Global()->ReleasePool();
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -55,6 +55,8 @@ export class WebGPUContext {
   private bufferTableFreeId: Array<number> = [];
   private pendingRead: Promise<void> = Promise.resolve();
   private numPendingReads = 0;
+  // The commands recorded since the last submit, e.g. the dispatches of a graph run.
+  private pendingEncoder?: GPUCommandEncoder = undefined;
 
   constructor(memory: Memory, device: GPUDevice) {
     this.memory = memory;
@@ -65,6 +67,7 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     const fence = this.device.defaultQueue.createFence();
     this.device.defaultQueue.signal(fence, 1);
     if (this.numPendingReads != 0) {
@@ -130,8 +133,8 @@ export class WebGPUContext {
     }
 
     const submitShader = (...args: Array<GPUPointer | number>): void => {
-      const commandEncoder = this.device.createCommandEncoder();
-      const compute = commandEncoder.beginComputePass();
+      // The dispatch is recorded with the pending commands, submitted all at once.
+      const compute = this.getPendingEncoder().beginComputePass();
       compute.setPipeline(pipeline);
       const bindGroupEntries: Array<GPUBindGroupEntry> = [];
       assert(args.length == layoutEntries.length + dispatchToDim.length);
@@ -155,8 +158,6 @@ export class WebGPUContext {
       }
       compute.dispatch(wl[0], wl[1], wl[2]);
       compute.endPass();
-      const command = commandEncoder.finish();
-      this.device.defaultQueue.submit([command]);
     };
 
     return submitShader;
@@ -225,6 +226,8 @@ export class WebGPUContext {
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
+    // The pending commands may use the buffer.
+    this.flushCommands();
     buffer.destroy();
   }
 
@@ -247,6 +250,7 @@ export class WebGPUContext {
     viewU8.set(this.memory.loadRawBytes(from, nbytes));
     gpuTemp.unmap();
 
+    this.flushCommands();
     const copyEncoder = this.device.createCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       gpuTemp,
@@ -272,6 +276,7 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
+    this.flushCommands();
     const copyEncoder = this.device.createCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
@@ -309,16 +314,31 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
-    copyEncoder.copyBufferToBuffer(
+    this.getPendingEncoder().copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
       this.gpuBufferFromPtr(to),
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.defaultQueue.submit([copyCommands]);
+  }
+
+  private getPendingEncoder(): GPUCommandEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+    }
+    return this.pendingEncoder;
+  }
+
+  /**
+   * Submit the pending commands, before the commands submitted on their own.
+   */
+  private flushCommands(): void {
+    if (this.pendingEncoder !== undefined) {
+      const commands = this.pendingEncoder.finish();
+      this.pendingEncoder = undefined;
+      this.device.defaultQueue.submit([commands]);
+    }
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {